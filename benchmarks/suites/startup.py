@@ -68,6 +68,78 @@ def startup(target: machine.Machine,
     return timer.elapsed() / float(count)
 
 
+def _docker(target: machine.Machine, *args) -> str:
+  """Runs a docker command on target and returns its trimmed output."""
+  stdout, _ = target.run(" ".join(("docker",) + args))
+  return stdout.strip()
+
+
+def restore(target: machine.Machine,
+            workload: str,
+            port: int,
+            count: int = 5,
+            runtime: str = "runc",
+            **kwargs):
+  """Time the restore of some workload from a template checkpoint.
+
+  The workload is started once and checkpointed as soon as it is available on
+  port, after which each container is restored from that checkpoint rather
+  than booted. This is the startup path of sandboxes cloned from a pre-warmed
+  template; with runsc, the runtime should be configured with
+  --checkpoint-template so that restores read application memory directly
+  from a shared pages file.
+
+  Args:
+    target: A machine object.
+    workload: The workload to run.
+    port: The port to check for liveness.
+    count: Number of containers to restore.
+    runtime: The container runtime to use.
+    **kwargs: Ignored.
+
+  Returns:
+    The mean restore time in seconds.
+  """
+  # Load and create the template before timing.
+  image = target.pull(workload)
+  netcat = target.pull("netcat")
+  count = int(count)
+  port = int(port)
+  host = machine.get_address(target)
+
+  def wait_available(container_id: str):
+    # "docker port" prints the bound address, e.g. "0.0.0.0:32768".
+    host_port = _docker(target, "port", container_id,
+                        "%d/tcp" % port).rsplit(":", 1)[1]
+    target.container(netcat).run(host=host, port=host_port)
+
+  checkpoint_dir, _ = target.run("mktemp -d")
+  checkpoint_dir = checkpoint_dir.strip()
+  template = _docker(target, "run", "--detach", "--runtime=" + runtime,
+                     "--publish=%d" % port, image)
+  try:
+    wait_available(template)
+    _docker(target, "checkpoint", "create",
+            "--checkpoint-dir=" + checkpoint_dir, template, "template")
+  finally:
+    _docker(target, "rm", "--force", template)
+
+  try:
+    with helpers.Timer() as timer:
+      for _ in range(count):
+        container_id = _docker(target, "create", "--runtime=" + runtime,
+                               "--publish=%d" % port, image)
+        try:
+          _docker(target, "start", "--checkpoint-dir=" + checkpoint_dir,
+                  "--checkpoint=template", container_id)
+          wait_available(container_id)
+        finally:
+          _docker(target, "rm", "--force", container_id)
+      return timer.elapsed() / float(count)
+  finally:
+    target.run("rm -rf " + checkpoint_dir)
+
+
 @suites.benchmark(metrics=[startup_time_ms], machines=1)
 def empty(target: machine.Machine, **kwargs) -> float:
   """Time the startup of a trivial container.
@@ -108,3 +180,35 @@ def ruby(target: machine.Machine, **kwargs) -> float:
     The time to run the container.
   """
   return startup(target, workload="ruby", port=3000, **kwargs)
+
+
+@suites.benchmark(metrics=[startup_time_ms], machines=1)
+def node_restore(target: machine.Machine, **kwargs) -> float:
+  """Time the restore of the node container from a template checkpoint.
+
+  Compare with node, which boots the container.
+
+  Args:
+    target: A machine object.
+    **kwargs: Additional restore options.
+
+  Returns:
+    The time to restore the container.
+  """
+  return restore(target, workload="node", port=8080, **kwargs)
+
+
+@suites.benchmark(metrics=[startup_time_ms], machines=1)
+def ruby_restore(target: machine.Machine, **kwargs) -> float:
+  """Time the restore of the ruby container from a template checkpoint.
+
+  Compare with ruby, which boots the container.
+
+  Args:
+    target: A machine object.
+    **kwargs: Additional restore options.
+
+  Returns:
+    The time to restore the container.
+  """
+  return restore(target, workload="ruby", port=3000, **kwargs)
@@ -44,6 +44,12 @@ const (
 	FD_CLOEXEC = 00000001
 )
 
+// Flags for close_range(2), from linux/close_range.h.
+const (
+	CLOSE_RANGE_UNSHARE = 1 << 1
+	CLOSE_RANGE_CLOEXEC = 1 << 2
+)
+
 // Flock is the lock structure for F_SETLK.
 type Flock struct {
 	Type   int16
@@ -357,6 +357,12 @@ var fileType = abi.ValueSet{
 const (
 	MFD_CLOEXEC       = 0x0001
 	MFD_ALLOW_SEALING = 0x0002
+	MFD_HUGETLB       = 0x0004
+
+	// MFD_HUGE_SHIFT and MFD_HUGE_MASK encode the log2 of the huge page
+	// size in flags, if MFD_HUGETLB is set. 0 selects the default size.
+	MFD_HUGE_SHIFT = 26
+	MFD_HUGE_MASK  = 0x3f
 )
 
 // Constants related to file seals. Source: include/uapi/{asm-generic,linux}/fcntl.h
@@ -22,8 +22,10 @@ var (
 
 // Flags from net/if_tun.h
 const (
-	IFF_TUN      = 0x0001
-	IFF_TAP      = 0x0002
-	IFF_NO_PI    = 0x1000
-	IFF_NOFILTER = 0x1000
+	IFF_TUN         = 0x0001
+	IFF_TAP         = 0x0002
+	IFF_MULTI_QUEUE = 0x0100
+	IFF_NO_PI       = 0x1000
+	IFF_NOFILTER    = 0x1000
+	IFF_VNET_HDR    = 0x4000
 )
@@ -68,6 +68,7 @@ const (
 	MADV_SEQUENTIAL   = 2
 	MADV_WILLNEED     = 3
 	MADV_DONTNEED     = 4
+	MADV_FREE         = 8
 	MADV_REMOVE       = 9
 	MADV_DONTFORK     = 10
 	MADV_DOFORK       = 11
@@ -77,6 +78,8 @@ const (
 	MADV_NOHUGEPAGE   = 15
 	MADV_DONTDUMP     = 16
 	MADV_DODUMP       = 17
+	MADV_COLD         = 20
+	MADV_PAGEOUT      = 21
 	MADV_HWPOISON     = 100
 	MADV_SOFT_OFFLINE = 101
 	MADV_NOMAJFAULT   = 200
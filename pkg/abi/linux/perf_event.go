@@ -0,0 +1,182 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package linux
+
+// Event types for PerfEventAttr.Type, from include/uapi/linux/perf_event.h.
+const (
+	PERF_TYPE_HARDWARE   = 0
+	PERF_TYPE_SOFTWARE   = 1
+	PERF_TYPE_TRACEPOINT = 2
+	PERF_TYPE_HW_CACHE   = 3
+	PERF_TYPE_RAW        = 4
+	PERF_TYPE_BREAKPOINT = 5
+)
+
+// Software events for PerfEventAttr.Config with PERF_TYPE_SOFTWARE, from
+// include/uapi/linux/perf_event.h.
+const (
+	PERF_COUNT_SW_CPU_CLOCK        = 0
+	PERF_COUNT_SW_TASK_CLOCK       = 1
+	PERF_COUNT_SW_PAGE_FAULTS      = 2
+	PERF_COUNT_SW_CONTEXT_SWITCHES = 3
+	PERF_COUNT_SW_CPU_MIGRATIONS   = 4
+	PERF_COUNT_SW_PAGE_FAULTS_MIN  = 5
+	PERF_COUNT_SW_PAGE_FAULTS_MAJ  = 6
+	PERF_COUNT_SW_ALIGNMENT_FAULTS = 7
+	PERF_COUNT_SW_EMULATION_FAULTS = 8
+	PERF_COUNT_SW_DUMMY            = 9
+)
+
+// Bits in PerfEventAttr.SampleType, from include/uapi/linux/perf_event.h.
+const (
+	PERF_SAMPLE_IP         = 1 << 0
+	PERF_SAMPLE_TID        = 1 << 1
+	PERF_SAMPLE_TIME       = 1 << 2
+	PERF_SAMPLE_ADDR       = 1 << 3
+	PERF_SAMPLE_READ       = 1 << 4
+	PERF_SAMPLE_CALLCHAIN  = 1 << 5
+	PERF_SAMPLE_ID         = 1 << 6
+	PERF_SAMPLE_CPU        = 1 << 7
+	PERF_SAMPLE_PERIOD     = 1 << 8
+	PERF_SAMPLE_STREAM_ID  = 1 << 9
+	PERF_SAMPLE_RAW        = 1 << 10
+	PERF_SAMPLE_IDENTIFIER = 1 << 16
+)
+
+// Bits in PerfEventAttr.ReadFormat, from include/uapi/linux/perf_event.h.
+const (
+	PERF_FORMAT_TOTAL_TIME_ENABLED = 1 << 0
+	PERF_FORMAT_TOTAL_TIME_RUNNING = 1 << 1
+	PERF_FORMAT_ID                 = 1 << 2
+	PERF_FORMAT_GROUP              = 1 << 3
+)
+
+// Bits in PerfEventAttr.Flags, from the bitfield in struct perf_event_attr in
+// include/uapi/linux/perf_event.h.
+const (
+	PERF_ATTR_FLAG_DISABLED       = 1 << 0
+	PERF_ATTR_FLAG_INHERIT        = 1 << 1
+	PERF_ATTR_FLAG_PINNED         = 1 << 2
+	PERF_ATTR_FLAG_EXCLUSIVE      = 1 << 3
+	PERF_ATTR_FLAG_EXCLUDE_USER   = 1 << 4
+	PERF_ATTR_FLAG_EXCLUDE_KERNEL = 1 << 5
+	PERF_ATTR_FLAG_EXCLUDE_HV     = 1 << 6
+	PERF_ATTR_FLAG_EXCLUDE_IDLE   = 1 << 7
+	PERF_ATTR_FLAG_MMAP           = 1 << 8
+	PERF_ATTR_FLAG_COMM           = 1 << 9
+	PERF_ATTR_FLAG_FREQ           = 1 << 10
+	PERF_ATTR_FLAG_INHERIT_STAT   = 1 << 11
+	PERF_ATTR_FLAG_ENABLE_ON_EXEC = 1 << 12
+	PERF_ATTR_FLAG_TASK           = 1 << 13
+	PERF_ATTR_FLAG_WATERMARK      = 1 << 14
+	PERF_ATTR_FLAG_PRECISE_IP     = 3 << 15
+	PERF_ATTR_FLAG_MMAP_DATA      = 1 << 17
+	PERF_ATTR_FLAG_SAMPLE_ID_ALL  = 1 << 18
+	PERF_ATTR_FLAG_EXCLUDE_HOST   = 1 << 19
+	PERF_ATTR_FLAG_EXCLUDE_GUEST  = 1 << 20
+)
+
+// Sizes of published versions of struct perf_event_attr, from
+// include/uapi/linux/perf_event.h.
+const (
+	PERF_ATTR_SIZE_VER0 = 64
+	PERF_ATTR_SIZE_VER5 = 112
+)
+
+// Flags for perf_event_open(2), from include/uapi/linux/perf_event.h.
+const (
+	PERF_FLAG_FD_NO_GROUP = 1 << 0
+	PERF_FLAG_FD_OUTPUT   = 1 << 1
+	PERF_FLAG_PID_CGROUP  = 1 << 2
+	PERF_FLAG_FD_CLOEXEC  = 1 << 3
+)
+
+// Perf event ioctl numbers, from include/uapi/linux/perf_event.h.
+const (
+	PERF_EVENT_IOC_ENABLE  = 0x2400
+	PERF_EVENT_IOC_DISABLE = 0x2401
+	PERF_EVENT_IOC_REFRESH = 0x2402
+	PERF_EVENT_IOC_RESET   = 0x2403
+	PERF_EVENT_IOC_PERIOD  = 0x40082404
+	PERF_EVENT_IOC_ID      = 0x80082407
+)
+
+// Record types and flags in PerfEventHeader, from
+// include/uapi/linux/perf_event.h.
+const (
+	PERF_RECORD_SAMPLE = 9
+
+	PERF_RECORD_MISC_USER = 2
+)
+
+// Offsets of fields in struct perf_event_mmap_page, the first page of a perf
+// event's ring buffer mapping, from include/uapi/linux/perf_event.h.
+const (
+	PERF_MMAP_PAGE_CAPABILITIES = 40
+	PERF_MMAP_PAGE_DATA_HEAD    = 1024
+	PERF_MMAP_PAGE_DATA_TAIL    = 1032
+	PERF_MMAP_PAGE_DATA_OFFSET  = 1040
+	PERF_MMAP_PAGE_DATA_SIZE    = 1048
+)
+
+// PERF_MMAP_CAP_BIT0_IS_DEPRECATED is the bit in struct
+// perf_event_mmap_page.capabilities that Linux always sets.
+const PERF_MMAP_CAP_BIT0_IS_DEPRECATED = 1 << 1
+
+// PerfEventAttr is struct perf_event_attr, from
+// include/uapi/linux/perf_event.h, up to PERF_ATTR_SIZE_VER5.
+//
+// +marshal
+// +stateify savable
+type PerfEventAttr struct {
+	Type   uint32
+	Size   uint32
+	Config uint64
+
+	// SamplePeriod is sample_freq if Flags contains PERF_ATTR_FLAG_FREQ.
+	SamplePeriod uint64
+
+	SampleType uint64
+	ReadFormat uint64
+
+	// Flags holds the bitfield following read_format.
+	Flags uint64
+
+	// WakeupEvents is wakeup_watermark if Flags contains
+	// PERF_ATTR_FLAG_WATERMARK.
+	WakeupEvents uint32
+
+	BPType           uint32
+	Config1          uint64
+	Config2          uint64
+	BranchSampleType uint64
+	SampleRegsUser   uint64
+	SampleStackUser  uint32
+	ClockID          int32
+	SampleRegsIntr   uint64
+	AuxWatermark     uint32
+	SampleMaxStack   uint16
+	_                uint16
+}
+
+// PerfEventHeader is struct perf_event_header, from
+// include/uapi/linux/perf_event.h.
+//
+// +marshal
+type PerfEventHeader struct {
+	Type uint32
+	Misc uint16
+	Size uint16
+}
@@ -43,6 +43,7 @@ const (
 	PTRACE_SETSIGMASK           = 0x420b
 	PTRACE_SECCOMP_GET_FILTER   = 0x420c
 	PTRACE_SECCOMP_GET_METADATA = 0x420d
+	PTRACE_GET_SYSCALL_INFO     = 0x420e
 )
 
 // ptrace commands from arch/x86/include/uapi/asm/ptrace-abi.h.
@@ -74,6 +75,13 @@ const (
 	PTRACE_EVENT_STOP       = 128
 )
 
+// ptrace event messages for syscall-enter-stop and syscall-exit-stop, from
+// include/uapi/linux/ptrace.h.
+const (
+	PTRACE_EVENTMSG_SYSCALL_ENTRY = 1
+	PTRACE_EVENTMSG_SYSCALL_EXIT  = 2
+)
+
 // PTRACE_SETOPTIONS options from include/uapi/linux/ptrace.h.
 const (
 	PTRACE_O_TRACESYSGOOD    = 1
@@ -87,3 +95,47 @@ const (
 	PTRACE_O_EXITKILL        = 1 << 20
 	PTRACE_O_SUSPEND_SECCOMP = 1 << 21
 )
+
+// Values for PtraceSyscallInfo.Op, from include/uapi/linux/ptrace.h.
+const (
+	PTRACE_SYSCALL_INFO_NONE    = 0
+	PTRACE_SYSCALL_INFO_ENTRY   = 1
+	PTRACE_SYSCALL_INFO_EXIT    = 2
+	PTRACE_SYSCALL_INFO_SECCOMP = 3
+)
+
+// PtraceSyscallInfo is struct ptrace_syscall_info, from
+// include/uapi/linux/ptrace.h.
+//
+// +marshal
+type PtraceSyscallInfo struct {
+	Op                 uint8
+	_                  uint8
+	_                  uint16
+	Arch               uint32
+	InstructionPointer uint64
+	StackPointer       uint64
+
+	// Data is the union of the entry, exit and seccomp members, depending on
+	// Op:
+	//
+	// - For PTRACE_SYSCALL_INFO_ENTRY, Data[0] is the syscall number and
+	// Data[1:7] are its arguments.
+	//
+	// - For PTRACE_SYSCALL_INFO_EXIT, Data[0] is the return value, and the
+	// first byte of Data[1] is 1 if it is an error and 0 otherwise.
+	//
+	// - For PTRACE_SYSCALL_INFO_SECCOMP, Data[0:7] are as for
+	// PTRACE_SYSCALL_INFO_ENTRY, and the first 4 bytes of Data[7] are the
+	// SECCOMP_RET_DATA portion of the filter's return value.
+	Data [8]uint64
+}
+
+// Sizes of the prefix of PtraceSyscallInfo that is meaningful for each
+// PTRACE_SYSCALL_INFO_* op, as returned by PTRACE_GET_SYSCALL_INFO.
+const (
+	SizeOfPtraceSyscallInfoNone    = 24
+	SizeOfPtraceSyscallInfoEntry   = 80
+	SizeOfPtraceSyscallInfoExit    = 33
+	SizeOfPtraceSyscallInfoSeccomp = 84
+)
@@ -30,6 +30,11 @@ const (
 	SHM_LOCKED    = 02000  // Segment will not be swapped.
 	SHM_HUGETLB   = 04000  // Segment will use huge TLB pages.
 	SHM_NORESERVE = 010000 // Don't check for reservations.
+
+	// SHM_HUGE_SHIFT and SHM_HUGE_MASK encode the log2 of the huge page size
+	// in shmget(2) flags, if SHM_HUGETLB is set. 0 selects the default size.
+	SHM_HUGE_SHIFT = 26
+	SHM_HUGE_MASK  = 0x3f
 )
 
 // Additional Linux-only flags for shmctl(2). Source: include/uapi/linux/shm.h
@@ -22,6 +22,9 @@ const (
 	SFD_CLOEXEC = 02000000
 )
 
+// SizeOfSignalfdSiginfo is the size of a struct signalfd_siginfo.
+const SizeOfSignalfdSiginfo = 128
+
 // SignalfdSiginfo is the siginfo encoding for signalfds.
 type SignalfdSiginfo struct {
 	Signo   uint32
@@ -0,0 +1,142 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package linux
+
+// Flags for userfaultfd(2).
+const (
+	UFFD_CLOEXEC  = O_CLOEXEC
+	UFFD_NONBLOCK = O_NONBLOCK
+)
+
+// UFFD_API is the userfaultfd API version, from
+// include/uapi/linux/userfaultfd.h.
+const UFFD_API = 0xAA
+
+// Userfaultfd ioctl numbers, from include/uapi/linux/userfaultfd.h.
+const (
+	UFFDIO_API        = 0xc018aa3f
+	UFFDIO_REGISTER   = 0xc020aa00
+	UFFDIO_UNREGISTER = 0x8010aa01
+	UFFDIO_WAKE       = 0x8010aa02
+	UFFDIO_COPY       = 0xc028aa03
+	UFFDIO_ZEROPAGE   = 0xc020aa04
+)
+
+// Bits in UffdioAPI.Ioctls and UffdioRegister.Ioctls, indexed by ioctl
+// number.
+const (
+	UFFDIO_REGISTER_BIT   = 1 << 0x00
+	UFFDIO_UNREGISTER_BIT = 1 << 0x01
+	UFFDIO_WAKE_BIT       = 1 << 0x02
+	UFFDIO_COPY_BIT       = 1 << 0x03
+	UFFDIO_ZEROPAGE_BIT   = 1 << 0x04
+	UFFDIO_API_BIT        = 1 << 0x3f
+
+	// UFFD_API_IOCTLS are the ioctls supported on a userfaultfd.
+	UFFD_API_IOCTLS = UFFDIO_REGISTER_BIT | UFFDIO_UNREGISTER_BIT | UFFDIO_API_BIT
+
+	// UFFD_API_RANGE_IOCTLS are the ioctls supported on a registered range.
+	UFFD_API_RANGE_IOCTLS = UFFDIO_WAKE_BIT | UFFDIO_COPY_BIT | UFFDIO_ZEROPAGE_BIT
+)
+
+// Modes for UffdioRegister.Mode.
+const (
+	UFFDIO_REGISTER_MODE_MISSING = 1 << 0
+	UFFDIO_REGISTER_MODE_WP      = 1 << 1
+)
+
+// Modes for UffdioCopy.Mode and UffdioZeropage.Mode.
+const (
+	UFFDIO_COPY_MODE_DONTWAKE     = 1 << 0
+	UFFDIO_ZEROPAGE_MODE_DONTWAKE = 1 << 0
+)
+
+// UFFD_EVENT_PAGEFAULT is the UffdMsg.Event for page faults.
+const UFFD_EVENT_PAGEFAULT = 0x12
+
+// Flags for UffdMsg.Flags.
+const (
+	UFFD_PAGEFAULT_FLAG_WRITE = 1 << 0
+	UFFD_PAGEFAULT_FLAG_WP    = 1 << 1
+)
+
+// UffdioAPI is struct uffdio_api, from include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioAPI struct {
+	API      uint64
+	Features uint64
+	Ioctls   uint64
+}
+
+// UffdioRange is struct uffdio_range, from include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioRange struct {
+	Start uint64
+	Len   uint64
+}
+
+// UffdioRegister is struct uffdio_register, from
+// include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioRegister struct {
+	Range  UffdioRange
+	Mode   uint64
+	Ioctls uint64
+}
+
+// UffdioCopy is struct uffdio_copy, from include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioCopy struct {
+	Dst  uint64
+	Src  uint64
+	Len  uint64
+	Mode uint64
+
+	// Copy is the number of bytes copied, or a negated errno.
+	Copy int64
+}
+
+// UffdioZeropage is struct uffdio_zeropage, from
+// include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioZeropage struct {
+	Range UffdioRange
+	Mode  uint64
+
+	// Zeropage is the number of bytes zeroed, or a negated errno.
+	Zeropage int64
+}
+
+// UffdMsg is struct uffd_msg, from include/uapi/linux/userfaultfd.h, for
+// UFFD_EVENT_PAGEFAULT, the only event reported by gVisor.
+//
+// +marshal
+type UffdMsg struct {
+	Event   uint8
+	_       uint8
+	_       uint16
+	_       uint32
+	Flags   uint64
+	Address uint64
+	_       uint64
+}
+
+// SizeOfUffdMsg is the size of a UffdMsg.
+const SizeOfUffdMsg = 32
@@ -21,26 +21,77 @@ package buffer
 
 import (
 	"sync"
+	"sync/atomic"
 )
 
 const bufferSize = 8144 // See below.
 
-// buffer encapsulates a queueable byte buffer.
+// chunk holds the data of one or more buffers.
 //
 // Note that the total size is slightly less than two pages. This is done
-// intentionally to ensure that the buffer object aligns with runtime
+// intentionally to ensure that the chunk object aligns with runtime
 // internals. We have no hard size or alignment requirements. This two page
 // size will effectively minimize internal fragmentation, but still have a
 // large enough chunk to limit excessive segmentation.
 //
 // +stateify savable
+type chunk struct {
+	// refs is the number of buffers referring to the chunk. Chunks referred
+	// to by more than one buffer are shared by Views, and are not written
+	// to.
+	//
+	// refs is accessed atomically, since buffers in different Views may be
+	// released concurrently.
+	refs int32
+
+	data [bufferSize]byte
+}
+
+// buffer encapsulates a queueable byte buffer.
+//
+// +stateify savable
 type buffer struct {
-	data  [bufferSize]byte
+	chunk *chunk
 	read  int
 	write int
 	bufferEntry
 }
 
+// newBuffer returns an empty buffer with a chunk of its own.
+func newBuffer() *buffer {
+	b := bufferPool.Get().(*buffer)
+	b.chunk = chunkPool.Get().(*chunk)
+	atomic.StoreInt32(&b.chunk.refs, 1)
+	return b
+}
+
+// clone returns a new buffer referring to the same data as b. b and the new
+// buffer can no longer be written to while both exist.
+func (b *buffer) clone() *buffer {
+	atomic.AddInt32(&b.chunk.refs, 1)
+	c := bufferPool.Get().(*buffer)
+	c.chunk = b.chunk
+	c.read = b.read
+	c.write = b.write
+	return c
+}
+
+// release returns b, and its chunk if b is the last buffer referring to it,
+// to their pools.
+func (b *buffer) release() {
+	if atomic.AddInt32(&b.chunk.refs, -1) == 0 {
+		chunkPool.Put(b.chunk)
+	}
+	b.chunk = nil
+	b.Reset()
+	bufferPool.Put(b)
+}
+
+// shared returns true if b's chunk may be referred to by other buffers.
+func (b *buffer) shared() bool {
+	return atomic.LoadInt32(&b.chunk.refs) > 1
+}
+
 // reset resets internal data.
 //
 // This must be called before returning the buffer to the pool.
@@ -51,9 +102,10 @@ func (b *buffer) Reset() {
 
 // Full indicates the buffer is full.
 //
-// This indicates there is no capacity left to write.
+// This indicates there is no capacity left to write. Shared buffers are
+// always full.
 func (b *buffer) Full() bool {
-	return b.write == len(b.data)
+	return b.write == len(b.chunk.data) || b.shared()
 }
 
 // ReadSize returns the number of bytes available for reading.
@@ -68,12 +120,14 @@ func (b *buffer) ReadMove(n int) {
 
 // ReadSlice returns the read slice for this buffer.
 func (b *buffer) ReadSlice() []byte {
-	return b.data[b.read:b.write]
+	return b.chunk.data[b.read:b.write]
 }
 
 // WriteSize returns the number of bytes available for writing.
+//
+// Precondition: b must not be shared.
 func (b *buffer) WriteSize() int {
-	return len(b.data) - b.write
+	return len(b.chunk.data) - b.write
 }
 
 // WriteMove advances the write index by the given amount.
@@ -82,8 +136,10 @@ func (b *buffer) WriteMove(n int) {
 }
 
 // WriteSlice returns the write slice for this buffer.
+//
+// Precondition: b must not be shared.
 func (b *buffer) WriteSlice() []byte {
-	return b.data[b.write:]
+	return b.chunk.data[b.write:]
 }
 
 // bufferPool is a pool for buffers.
@@ -92,3 +148,10 @@ var bufferPool = sync.Pool{
 		return new(buffer)
 	},
 }
+
+// chunkPool is a pool for chunks.
+var chunkPool = sync.Pool{
+	New: func() interface{} {
+		return new(chunk)
+	},
+}
@@ -41,10 +41,10 @@ func (v *View) WriteFromSafememReader(r safemem.Reader, count uint64) (uint64, e
 		blocks []safemem.Block
 	)
 
-	// Need at least one buffer.
+	// Need at least one buffer that can be written to.
 	firstBuf := v.data.Back()
-	if firstBuf == nil {
-		firstBuf = bufferPool.Get().(*buffer)
+	if firstBuf == nil || firstBuf.Full() {
+		firstBuf = v.newBuffer()
 		v.data.PushBack(firstBuf)
 	}
 
@@ -56,7 +56,7 @@ func (v *View) WriteFromSafememReader(r safemem.Reader, count uint64) (uint64, e
 		count -= l
 		blocks = append(blocks, firstBuf.WriteBlock())
 		for count > 0 {
-			emptyBuf := bufferPool.Get().(*buffer)
+			emptyBuf := v.newBuffer()
 			v.data.PushBack(emptyBuf)
 			block := emptyBuf.WriteBlock().TakeFirst64(count)
 			count -= uint64(block.Len())
@@ -27,6 +27,51 @@ import (
 type View struct {
 	data bufferList
 	size int64
+
+	// spare holds empty buffers drained by reads, which are reused by later
+	// writes before new buffers are allocated. spareCount is the number of
+	// buffers in spare, which is at most maxSpare.
+	spare      bufferList `state:"nosave"`
+	spareCount int        `state:"nosave"`
+	maxSpare   int
+}
+
+// SetMaxSpare sets the number of bytes of drained buffers that v keeps for
+// reuse by later writes, instead of returning them to the shared pool.
+//
+// Owners of Views that are repeatedly filled and drained, such as pipes,
+// should set this to the capacity of the View.
+func (v *View) SetMaxSpare(bytes int64) {
+	v.maxSpare = int((bytes + bufferSize - 1) / bufferSize)
+	for v.spareCount > v.maxSpare {
+		buf := v.spare.Front()
+		v.spare.Remove(buf)
+		v.spareCount--
+		buf.release()
+	}
+}
+
+// newBuffer returns an empty buffer for writing, reusing a spare one if
+// possible.
+func (v *View) newBuffer() *buffer {
+	if buf := v.spare.Front(); buf != nil {
+		v.spare.Remove(buf)
+		v.spareCount--
+		return buf
+	}
+	return newBuffer()
+}
+
+// releaseBuffer releases buf, which has been removed from v.data, keeping it
+// as a spare buffer if possible.
+func (v *View) releaseBuffer(buf *buffer) {
+	if v.spareCount < v.maxSpare && !buf.shared() {
+		buf.Reset()
+		v.spare.PushBack(buf)
+		v.spareCount++
+		return
+	}
+	buf.release()
 }
 
 // TrimFront removes the first count bytes from the buffer.
@@ -80,8 +125,7 @@ func (v *View) advanceRead(count int64) {
 		oldBuf := buf
 		buf = buf.Next() // Iterate.
 		v.data.Remove(oldBuf)
-		oldBuf.Reset()
-		bufferPool.Put(oldBuf)
+		v.releaseBuffer(oldBuf)
 
 		// Update counts.
 		count -= sz
@@ -117,8 +161,7 @@ func (v *View) Truncate(length int64) {
 
 		// Drop the buffer completely; see above.
 		v.data.Remove(buf)
-		buf.Reset()
-		bufferPool.Put(buf)
+		v.releaseBuffer(buf)
 		v.size -= sz
 	}
 }
@@ -137,7 +180,7 @@ func (v *View) Grow(length int64, zero bool) {
 
 		// Is there some space in the last buffer?
 		if buf == nil || buf.Full() {
-			buf = bufferPool.Get().(*buffer)
+			buf = v.newBuffer()
 			v.data.PushBack(buf)
 		}
 
@@ -151,7 +194,7 @@ func (v *View) Grow(length int64, zero bool) {
 		// specifically recognized and optimized by the compiler.
 		if zero {
 			for i := buf.write; i < buf.write+sz; i++ {
-				buf.data[i] = 0
+				buf.chunk.data[i] = 0
 			}
 		}
 
@@ -164,7 +207,7 @@ func (v *View) Grow(length int64, zero bool) {
 // Prepend prepends the given data.
 func (v *View) Prepend(data []byte) {
 	// Is there any space in the first buffer?
-	if buf := v.data.Front(); buf != nil && buf.read > 0 {
+	if buf := v.data.Front(); buf != nil && buf.read > 0 && !buf.shared() {
 		// Fill up before the first write.
 		avail := buf.read
 		bStart := 0
@@ -173,7 +216,7 @@ func (v *View) Prepend(data []byte) {
 			bStart = avail - len(data)
 			dStart = 0
 		}
-		n := copy(buf.data[bStart:], data[dStart:])
+		n := copy(buf.chunk.data[bStart:], data[dStart:])
 		data = data[:dStart]
 		v.size += int64(n)
 		buf.read -= n
@@ -181,11 +224,11 @@ func (v *View) Prepend(data []byte) {
 
 	for len(data) > 0 {
 		// Do we need an empty buffer?
-		buf := bufferPool.Get().(*buffer)
+		buf := v.newBuffer()
 		v.data.PushFront(buf)
 
 		// The buffer is empty; copy last chunk.
-		avail := len(buf.data)
+		avail := len(buf.chunk.data)
 		bStart := 0
 		dStart := len(data) - avail
 		if avail > len(data) {
@@ -196,11 +239,11 @@ func (v *View) Prepend(data []byte) {
 		// We have to put the data at the end of the current
 		// buffer in order to ensure that the next prepend will
 		// correctly fill up the beginning of this buffer.
-		n := copy(buf.data[bStart:], data[dStart:])
+		n := copy(buf.chunk.data[bStart:], data[dStart:])
 		data = data[:dStart]
 		v.size += int64(n)
-		buf.read = len(buf.data) - n
-		buf.write = len(buf.data)
+		buf.read = len(buf.chunk.data) - n
+		buf.write = len(buf.chunk.data)
 	}
 }
 
@@ -211,7 +254,7 @@ func (v *View) Append(data []byte) {
 
 		// Ensure there's a buffer with space.
 		if buf == nil || buf.Full() {
-			buf = bufferPool.Get().(*buffer)
+			buf = v.newBuffer()
 			v.data.PushBack(buf)
 		}
 
@@ -282,6 +325,50 @@ func (v *View) Merge(other *View) {
 	other.size = 0
 }
 
+// Move moves up to count bytes from the front of src to the end of v, and
+// returns the number of bytes moved. Buffers in src whose data is moved
+// entirely are moved to v without copying their data.
+func (v *View) Move(src *View, count int64) int64 {
+	var done int64
+	for buf := src.data.Front(); buf != nil && done < count; buf = src.data.Front() {
+		sz := int64(buf.ReadSize())
+		if left := count - done; sz > left {
+			// Copy the part of the buffer that is moved.
+			v.Append(buf.ReadSlice()[:left])
+			src.advanceRead(left)
+			done += left
+			break
+		}
+		src.data.Remove(buf)
+		src.size -= sz
+		v.data.PushBack(buf)
+		v.size += sz
+		done += sz
+	}
+	return done
+}
+
+// Tee appends up to count bytes from the front of src to the end of v,
+// without removing them from src, and returns the number of bytes appended.
+// Buffers in src whose data is appended entirely are shared with v rather
+// than copied, after which neither View writes to them.
+func (v *View) Tee(src *View, count int64) int64 {
+	var done int64
+	for buf := src.data.Front(); buf != nil && done < count; buf = buf.Next() {
+		sz := int64(buf.ReadSize())
+		if left := count - done; sz > left {
+			// Copy the part of the buffer that is appended.
+			v.Append(buf.ReadSlice()[:left])
+			done += left
+			break
+		}
+		v.data.PushBack(buf.clone())
+		v.size += sz
+		done += sz
+	}
+	return done
+}
+
 // WriteFromReader writes to the buffer from an io.Reader.
 //
 // A minimum read size equal to unsafe.Sizeof(unintptr) is enforced,
@@ -297,7 +384,7 @@ func (v *View) WriteFromReader(r io.Reader, count int64) (int64, error) {
 
 		// Ensure we have an empty buffer.
 		if buf == nil || buf.Full() {
-			buf = bufferPool.Get().(*buffer)
+			buf = v.newBuffer()
 			v.data.PushBack(buf)
 		}
 
@@ -65,6 +65,28 @@ func testReadAt(t *testing.T, v *View, offset int64, n int, wantStr string, want
 	}
 }
 
+func testMove(t *testing.T, dst, src *View, n int64, wantDst string) {
+	t.Helper()
+	want := int64(len(wantDst)) - dst.Size()
+	if got := dst.Move(src, n); got != want {
+		t.Errorf("got Move(%d) = %d, want %d", n, got, want)
+	}
+	if got := string(dst.Flatten()); got != wantDst {
+		t.Errorf("got destination %q, want %q", got, wantDst)
+	}
+}
+
+func testTee(t *testing.T, dst, src *View, n int64, wantDst string) {
+	t.Helper()
+	want := int64(len(wantDst)) - dst.Size()
+	if got := dst.Tee(src, n); got != want {
+		t.Errorf("got Tee(%d) = %d, want %d", n, got, want)
+	}
+	if got := string(dst.Flatten()); got != wantDst {
+		t.Errorf("got destination %q, want %q", got, wantDst)
+	}
+}
+
 func TestView(t *testing.T) {
 	testCases := []struct {
 		name   string
@@ -412,6 +434,83 @@ func TestView(t *testing.T) {
 			output: strings.Repeat("0", bufferSize+1) + "12",
 			op:     func(t *testing.T, v *View) { testReadAt(t, v, bufferSize+1, 2, "12", io.EOF) },
 		},
+
+		// Move.
+		{
+			name:   "move",
+			input:  "hello world",
+			output: "world",
+			op: func(t *testing.T, v *View) {
+				var dst View
+				dst.Append([]byte("why "))
+				testMove(t, &dst, v, 6, "why hello ")
+			},
+		},
+		{
+			name:   "move-all",
+			input:  "hello world",
+			output: "",
+			op: func(t *testing.T, v *View) {
+				var dst View
+				testMove(t, &dst, v, 100, "hello world")
+			},
+		},
+		{
+			name:   "move-second-buffer",
+			input:  strings.Repeat("0", bufferSize+1) + "12",
+			output: "12",
+			op: func(t *testing.T, v *View) {
+				var dst View
+				testMove(t, &dst, v, bufferSize+1, strings.Repeat("0", bufferSize+1))
+			},
+		},
+
+		// Tee.
+		{
+			name:   "tee",
+			input:  "hello world",
+			output: "hello world",
+			op: func(t *testing.T, v *View) {
+				var dst View
+				testTee(t, &dst, v, 5, "hello")
+			},
+		},
+		{
+			name:   "tee-append-src",
+			input:  "hello world",
+			output: "hello world!",
+			op: func(t *testing.T, v *View) {
+				var dst View
+				testTee(t, &dst, v, v.Size(), "hello world")
+				v.Append([]byte("!"))
+				if got, want := string(dst.Flatten()), "hello world"; got != want {
+					t.Errorf("got tee destination %q after appending to source, want %q", got, want)
+				}
+			},
+		},
+		{
+			name:   "tee-append-dst",
+			input:  "hello world",
+			output: "hello world",
+			op: func(t *testing.T, v *View) {
+				var dst View
+				testTee(t, &dst, v, v.Size(), "hello world")
+				dst.Append([]byte("!"))
+				dst.Prepend([]byte("!"))
+				if got, want := string(dst.Flatten()), "!hello world!"; got != want {
+					t.Errorf("got tee destination %q after appending to it, want %q", got, want)
+				}
+			},
+		},
+		{
+			name:   "tee-second-buffer",
+			input:  strings.Repeat("0", bufferSize+1) + "12",
+			output: strings.Repeat("0", bufferSize+1) + "12",
+			op: func(t *testing.T, v *View) {
+				var dst View
+				testTee(t, &dst, v, bufferSize+2, strings.Repeat("0", bufferSize+1)+"1")
+			},
+		},
 	}
 
 	for _, tc := range testCases {
@@ -465,3 +564,40 @@ func TestView(t *testing.T) {
 		}
 	}
 }
+
+func TestViewSpare(t *testing.T) {
+	var v View
+	v.SetMaxSpare(bufferSize)
+
+	// A drained buffer is reused by the next write.
+	v.Append([]byte("hello"))
+	first := v.data.Front()
+	v.TrimFront(5)
+	v.Append([]byte("world"))
+	if got := v.data.Front(); got != first {
+		t.Errorf("got new buffer %p after draining, want reused buffer %p", got, first)
+	}
+	if got := string(v.Flatten()); got != "world" {
+		t.Errorf("got %q, want %q", got, "world")
+	}
+
+	// A drained buffer shared with another View is not reused.
+	var other View
+	other.Tee(&v, 5)
+	shared := v.data.Front().chunk
+	v.TrimFront(5)
+	v.Append([]byte("again"))
+	if got := v.data.Front().chunk; got == shared {
+		t.Errorf("got shared chunk %p reused after draining", got)
+	}
+	if got := string(other.Flatten()); got != "world" {
+		t.Errorf("got %q in other View, want %q", got, "world")
+	}
+
+	// Spare buffers beyond the limit are released.
+	v.TrimFront(5)
+	v.SetMaxSpare(0)
+	if v.spareCount != 0 {
+		t.Errorf("got %d spare buffers, want 0", v.spareCount)
+	}
+}
@@ -566,6 +566,11 @@ func (c *Client) Version() uint32 {
 	return c.version
 }
 
+// PayloadSize returns the maximum payload size of a read, write or readdir.
+func (c *Client) PayloadSize() uint32 {
+	return c.payloadSize
+}
+
 // Close closes the underlying socket and channels.
 func (c *Client) Close() {
 	// unet.Socket.Shutdown() has no effect if unet.Socket.Close() has already
@@ -119,6 +119,68 @@ func (c *clientFile) WalkGetAttr(components []string) ([]QID, File, AttrMask, At
 	return rwalkgetattr.QIDs, c.client.newFile(FID(fid)), rwalkgetattr.Valid, rwalkgetattr.Attr, nil
 }
 
+// MultiWalkGetAttr implements File.MultiWalkGetAttr.
+func (c *clientFile) MultiWalkGetAttr(names []string) ([]FullStat, []File, error) {
+	if atomic.LoadUint32(&c.closed) != 0 {
+		return nil, nil, syscall.EBADF
+	}
+
+	if !versionSupportsTmultiwalkgetattr(c.client.version) {
+		// Walk one component per round trip.
+		var (
+			stats []FullStat
+			files []File
+		)
+		var from File = c
+		for _, name := range names {
+			qids, file, valid, attr, err := from.WalkGetAttr([]string{name})
+			if err != nil {
+				if len(files) == 0 {
+					return nil, nil, err
+				}
+				break
+			}
+			stats = append(stats, FullStat{QID: qids[0], Valid: valid, Attr: attr})
+			files = append(files, file)
+			from = file
+		}
+		return stats, files, nil
+	}
+
+	fids := make([]FID, 0, len(names))
+	for range names {
+		fid, ok := c.client.fidPool.Get()
+		if !ok {
+			for _, fid := range fids {
+				c.client.fidPool.Put(uint64(fid))
+			}
+			return nil, nil, ErrOutOfFIDs
+		}
+		fids = append(fids, FID(fid))
+	}
+
+	rmultiwalkgetattr := Rmultiwalkgetattr{}
+	if err := c.client.sendRecv(&Tmultiwalkgetattr{FID: c.fid, NewFIDs: fids, Names: names}, &rmultiwalkgetattr); err != nil {
+		for _, fid := range fids {
+			c.client.fidPool.Put(uint64(fid))
+		}
+		return nil, nil, err
+	}
+
+	// Return new client files for the FIDs that were installed, and
+	// release the rest.
+	stats := rmultiwalkgetattr.Stats
+	files := make([]File, 0, len(stats))
+	for i, fid := range fids {
+		if i < len(stats) {
+			files = append(files, c.client.newFile(fid))
+		} else {
+			c.client.fidPool.Put(uint64(fid))
+		}
+	}
+	return stats, files, nil
+}
+
 // StatFS implements File.StatFS.
 func (c *clientFile) StatFS() (FSStat, error) {
 	if atomic.LoadUint32(&c.closed) != 0 {
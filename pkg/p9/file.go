@@ -73,6 +73,18 @@ type File interface {
 	// On the server, WalkGetAttr has a read concurrency guarantee.
 	WalkGetAttr([]string) ([]QID, File, AttrMask, Attr, error)
 
+	// MultiWalkGetAttr walks to each of the path components given in names
+	// in turn, and returns a File and the maximal set of attributes for
+	// every file walked to.
+	//
+	// The walk stops at the first component that cannot be walked, in
+	// which case fewer Files are returned than names were passed in. An
+	// error is returned only if the first component cannot be walked.
+	//
+	// Server-side p9.Files may return syscall.ENOSYS; the server satisfies
+	// this request with WalkGetAttr.
+	MultiWalkGetAttr(names []string) ([]FullStat, []File, error)
+
 	// StatFS returns information about the file system associated with
 	// this file.
 	//
@@ -286,3 +298,12 @@ type DefaultWalkGetAttr struct{}
 func (DefaultWalkGetAttr) WalkGetAttr([]string) ([]QID, File, AttrMask, Attr, error) {
 	return nil, nil, AttrMask{}, Attr{}, syscall.ENOSYS
 }
+
+// DefaultMultiWalkGetAttr implements File.MultiWalkGetAttr to return ENOSYS
+// for server-side Files.
+type DefaultMultiWalkGetAttr struct{}
+
+// MultiWalkGetAttr implements File.MultiWalkGetAttr.
+func (DefaultMultiWalkGetAttr) MultiWalkGetAttr([]string) ([]FullStat, []File, error) {
+	return nil, nil, syscall.ENOSYS
+}
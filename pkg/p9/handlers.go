@@ -1289,6 +1289,37 @@ func (t *Twalkgetattr) handle(cs *connState) message {
 	return &Rwalkgetattr{QIDs: qids, Valid: valid, Attr: attr}
 }
 
+// handle implements handler.handle.
+func (t *Tmultiwalkgetattr) handle(cs *connState) message {
+	if len(t.NewFIDs) != len(t.Names) || len(t.Names) == 0 {
+		return newErr(syscall.EINVAL)
+	}
+	ref, ok := cs.LookupFID(t.FID)
+	if !ok {
+		return newErr(syscall.EBADF)
+	}
+
+	defer func() { ref.DecRef() }()
+
+	// Walk one element at a time, installing a FID for each, and stop at
+	// the first failure. Only a failure on the first element is an error.
+	stats := make([]FullStat, 0, len(t.Names))
+	for i, name := range t.Names {
+		qids, newRef, valid, attr, err := doWalk(cs, ref, []string{name}, true)
+		if err != nil {
+			if i == 0 {
+				return newErr(err)
+			}
+			break
+		}
+		ref.DecRef()
+		ref = newRef
+		cs.InsertFID(t.NewFIDs[i], newRef)
+		stats = append(stats, FullStat{QID: qids[0], Valid: valid, Attr: attr})
+	}
+	return &Rmultiwalkgetattr{Stats: stats}
+}
+
 // handle implements handler.handle.
 func (t *Tucreate) handle(cs *connState) message {
 	rlcreate, err := t.Tlcreate.do(cs, t.UID)
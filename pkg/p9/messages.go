@@ -2200,6 +2200,95 @@ func (r *Rwalkgetattr) String() string {
 	return fmt.Sprintf("Rwalkgetattr{Valid: %s, Attr: %s, QIDs: %v}", r.Valid, r.Attr, r.QIDs)
 }
 
+// Tmultiwalkgetattr is a walk request that returns a new FID and the
+// attributes of every file walked through.
+type Tmultiwalkgetattr struct {
+	// FID is the FID to be walked.
+	FID FID
+
+	// NewFIDs are the resulting FIDs, one for each name.
+	NewFIDs []FID
+
+	// Names are the set of names to be walked.
+	Names []string
+}
+
+// decode implements encoder.decode.
+func (t *Tmultiwalkgetattr) decode(b *buffer) {
+	t.FID = b.ReadFID()
+	n := b.Read16()
+	t.NewFIDs = t.NewFIDs[:0]
+	for i := 0; i < int(n); i++ {
+		t.NewFIDs = append(t.NewFIDs, b.ReadFID())
+	}
+	n = b.Read16()
+	t.Names = t.Names[:0]
+	for i := 0; i < int(n); i++ {
+		t.Names = append(t.Names, b.ReadString())
+	}
+}
+
+// encode implements encoder.encode.
+func (t *Tmultiwalkgetattr) encode(b *buffer) {
+	b.WriteFID(t.FID)
+	b.Write16(uint16(len(t.NewFIDs)))
+	for _, fid := range t.NewFIDs {
+		b.WriteFID(fid)
+	}
+	b.Write16(uint16(len(t.Names)))
+	for _, name := range t.Names {
+		b.WriteString(name)
+	}
+}
+
+// Type implements message.Type.
+func (*Tmultiwalkgetattr) Type() MsgType {
+	return MsgTmultiwalkgetattr
+}
+
+// String implements fmt.Stringer.
+func (t *Tmultiwalkgetattr) String() string {
+	return fmt.Sprintf("Tmultiwalkgetattr{FID: %d, NewFIDs: %v, Names: %v}", t.FID, t.NewFIDs, t.Names)
+}
+
+// Rmultiwalkgetattr is a multi-component walk response.
+//
+// Stats may be shorter than the request's Names if the walk stopped early, in
+// which case only the first len(Stats) NewFIDs were installed.
+type Rmultiwalkgetattr struct {
+	// Stats are the QIDs and attributes of each file walked to.
+	Stats []FullStat
+}
+
+// decode implements encoder.decode.
+func (r *Rmultiwalkgetattr) decode(b *buffer) {
+	n := b.Read16()
+	r.Stats = r.Stats[:0]
+	for i := 0; i < int(n); i++ {
+		var fs FullStat
+		fs.decode(b)
+		r.Stats = append(r.Stats, fs)
+	}
+}
+
+// encode implements encoder.encode.
+func (r *Rmultiwalkgetattr) encode(b *buffer) {
+	b.Write16(uint16(len(r.Stats)))
+	for i := range r.Stats {
+		r.Stats[i].encode(b)
+	}
+}
+
+// Type implements message.Type.
+func (*Rmultiwalkgetattr) Type() MsgType {
+	return MsgRmultiwalkgetattr
+}
+
+// String implements fmt.Stringer.
+func (r *Rmultiwalkgetattr) String() string {
+	return fmt.Sprintf("Rmultiwalkgetattr{Stats: %v}", r.Stats)
+}
+
 // Tucreate is a Tlcreate message that includes a UID.
 type Tucreate struct {
 	Tlcreate
@@ -2657,6 +2746,8 @@ func init() {
 	msgRegistry.register(MsgRlconnect, func() message { return &Rlconnect{} })
 	msgRegistry.register(MsgTallocate, func() message { return &Tallocate{} })
 	msgRegistry.register(MsgRallocate, func() message { return &Rallocate{} })
+	msgRegistry.register(MsgTmultiwalkgetattr, func() message { return &Tmultiwalkgetattr{} })
+	msgRegistry.register(MsgRmultiwalkgetattr, func() message { return &Rmultiwalkgetattr{} })
 	msgRegistry.register(MsgTchannel, func() message { return &Tchannel{} })
 	msgRegistry.register(MsgRchannel, func() message { return &Rchannel{} })
 }
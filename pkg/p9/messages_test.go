@@ -325,6 +325,16 @@ func TestEncodeDecode(t *testing.T) {
 			Valid: AttrMask{Mode: true},
 			Attr:  Attr{Mode: Write},
 		},
+		&Tmultiwalkgetattr{
+			FID:     1,
+			NewFIDs: []FID{2, 3},
+			Names:   []string{"a", "b"},
+		},
+		&Rmultiwalkgetattr{
+			Stats: []FullStat{
+				{QID: QID{Type: 1}, Valid: AttrMask{Mode: true}, Attr: Attr{Mode: Write}},
+			},
+		},
 		&Tucreate{
 			Tlcreate: Tlcreate{
 				FID:         1,
@@ -315,86 +315,88 @@ type MsgType uint8
 
 // MsgType declarations.
 const (
-	MsgTlerror      MsgType = 6
-	MsgRlerror              = 7
-	MsgTstatfs              = 8
-	MsgRstatfs              = 9
-	MsgTlopen               = 12
-	MsgRlopen               = 13
-	MsgTlcreate             = 14
-	MsgRlcreate             = 15
-	MsgTsymlink             = 16
-	MsgRsymlink             = 17
-	MsgTmknod               = 18
-	MsgRmknod               = 19
-	MsgTrename              = 20
-	MsgRrename              = 21
-	MsgTreadlink            = 22
-	MsgRreadlink            = 23
-	MsgTgetattr             = 24
-	MsgRgetattr             = 25
-	MsgTsetattr             = 26
-	MsgRsetattr             = 27
-	MsgTlistxattr           = 28
-	MsgRlistxattr           = 29
-	MsgTxattrwalk           = 30
-	MsgRxattrwalk           = 31
-	MsgTxattrcreate         = 32
-	MsgRxattrcreate         = 33
-	MsgTgetxattr            = 34
-	MsgRgetxattr            = 35
-	MsgTsetxattr            = 36
-	MsgRsetxattr            = 37
-	MsgTremovexattr         = 38
-	MsgRremovexattr         = 39
-	MsgTreaddir             = 40
-	MsgRreaddir             = 41
-	MsgTfsync               = 50
-	MsgRfsync               = 51
-	MsgTlink                = 70
-	MsgRlink                = 71
-	MsgTmkdir               = 72
-	MsgRmkdir               = 73
-	MsgTrenameat            = 74
-	MsgRrenameat            = 75
-	MsgTunlinkat            = 76
-	MsgRunlinkat            = 77
-	MsgTversion             = 100
-	MsgRversion             = 101
-	MsgTauth                = 102
-	MsgRauth                = 103
-	MsgTattach              = 104
-	MsgRattach              = 105
-	MsgTflush               = 108
-	MsgRflush               = 109
-	MsgTwalk                = 110
-	MsgRwalk                = 111
-	MsgTread                = 116
-	MsgRread                = 117
-	MsgTwrite               = 118
-	MsgRwrite               = 119
-	MsgTclunk               = 120
-	MsgRclunk               = 121
-	MsgTremove              = 122
-	MsgRremove              = 123
-	MsgTflushf              = 124
-	MsgRflushf              = 125
-	MsgTwalkgetattr         = 126
-	MsgRwalkgetattr         = 127
-	MsgTucreate             = 128
-	MsgRucreate             = 129
-	MsgTumkdir              = 130
-	MsgRumkdir              = 131
-	MsgTumknod              = 132
-	MsgRumknod              = 133
-	MsgTusymlink            = 134
-	MsgRusymlink            = 135
-	MsgTlconnect            = 136
-	MsgRlconnect            = 137
-	MsgTallocate            = 138
-	MsgRallocate            = 139
-	MsgTchannel             = 250
-	MsgRchannel             = 251
+	MsgTlerror           MsgType = 6
+	MsgRlerror                   = 7
+	MsgTstatfs                   = 8
+	MsgRstatfs                   = 9
+	MsgTlopen                    = 12
+	MsgRlopen                    = 13
+	MsgTlcreate                  = 14
+	MsgRlcreate                  = 15
+	MsgTsymlink                  = 16
+	MsgRsymlink                  = 17
+	MsgTmknod                    = 18
+	MsgRmknod                    = 19
+	MsgTrename                   = 20
+	MsgRrename                   = 21
+	MsgTreadlink                 = 22
+	MsgRreadlink                 = 23
+	MsgTgetattr                  = 24
+	MsgRgetattr                  = 25
+	MsgTsetattr                  = 26
+	MsgRsetattr                  = 27
+	MsgTlistxattr                = 28
+	MsgRlistxattr                = 29
+	MsgTxattrwalk                = 30
+	MsgRxattrwalk                = 31
+	MsgTxattrcreate              = 32
+	MsgRxattrcreate              = 33
+	MsgTgetxattr                 = 34
+	MsgRgetxattr                 = 35
+	MsgTsetxattr                 = 36
+	MsgRsetxattr                 = 37
+	MsgTremovexattr              = 38
+	MsgRremovexattr              = 39
+	MsgTreaddir                  = 40
+	MsgRreaddir                  = 41
+	MsgTfsync                    = 50
+	MsgRfsync                    = 51
+	MsgTlink                     = 70
+	MsgRlink                     = 71
+	MsgTmkdir                    = 72
+	MsgRmkdir                    = 73
+	MsgTrenameat                 = 74
+	MsgRrenameat                 = 75
+	MsgTunlinkat                 = 76
+	MsgRunlinkat                 = 77
+	MsgTversion                  = 100
+	MsgRversion                  = 101
+	MsgTauth                     = 102
+	MsgRauth                     = 103
+	MsgTattach                   = 104
+	MsgRattach                   = 105
+	MsgTflush                    = 108
+	MsgRflush                    = 109
+	MsgTwalk                     = 110
+	MsgRwalk                     = 111
+	MsgTread                     = 116
+	MsgRread                     = 117
+	MsgTwrite                    = 118
+	MsgRwrite                    = 119
+	MsgTclunk                    = 120
+	MsgRclunk                    = 121
+	MsgTremove                   = 122
+	MsgRremove                   = 123
+	MsgTflushf                   = 124
+	MsgRflushf                   = 125
+	MsgTwalkgetattr              = 126
+	MsgRwalkgetattr              = 127
+	MsgTucreate                  = 128
+	MsgRucreate                  = 129
+	MsgTumkdir                   = 130
+	MsgRumkdir                   = 131
+	MsgTumknod                   = 132
+	MsgRumknod                   = 133
+	MsgTusymlink                 = 134
+	MsgRusymlink                 = 135
+	MsgTlconnect                 = 136
+	MsgRlconnect                 = 137
+	MsgTallocate                 = 138
+	MsgRallocate                 = 139
+	MsgTmultiwalkgetattr         = 140
+	MsgRmultiwalkgetattr         = 141
+	MsgTchannel                  = 250
+	MsgRchannel                  = 251
 )
 
 // QIDType represents the file type for QIDs.
@@ -818,6 +820,37 @@ func (a *Attr) decode(b *buffer) {
 	a.DataVersion = b.Read64()
 }
 
+// FullStat is a file's QID together with its attributes.
+type FullStat struct {
+	// QID is the file's QID.
+	QID QID
+
+	// Valid indicates which fields are valid in Attr.
+	Valid AttrMask
+
+	// Attr is the set of attributes for the file.
+	Attr Attr
+}
+
+// String implements fmt.Stringer.
+func (f FullStat) String() string {
+	return fmt.Sprintf("FullStat{QID: %v, Valid: %v, Attr: %v}", f.QID, f.Valid, f.Attr)
+}
+
+// encode implements encoder.encode.
+func (f *FullStat) encode(b *buffer) {
+	f.QID.encode(b)
+	f.Valid.encode(b)
+	f.Attr.encode(b)
+}
+
+// decode implements encoder.decode.
+func (f *FullStat) decode(b *buffer) {
+	f.QID.decode(b)
+	f.Valid.decode(b)
+	f.Attr.decode(b)
+}
+
 // StatToAttr converts a Linux syscall stat structure to an Attr.
 func StatToAttr(s *syscall.Stat_t, req AttrMask) (Attr, AttrMask) {
 	attr := Attr{
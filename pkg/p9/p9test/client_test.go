@@ -112,6 +112,54 @@ func TestWalkAttach(t *testing.T) {
 	}
 }
 
+func TestMultiWalkGetAttr(t *testing.T) {
+	h, c := NewHarness(t)
+	defer h.Finish()
+
+	_, root := newRoot(h, c)
+	defer root.Close()
+
+	// Walk all the way to a file.
+	stats, files, err := root.MultiWalkGetAttr([]string{"one", "two", "file"})
+	if err != nil {
+		t.Fatalf("MultiWalkGetAttr got err %v, want nil", err)
+	}
+	for _, f := range files {
+		defer f.Close()
+	}
+	if len(stats) != 3 || len(files) != 3 {
+		t.Fatalf("MultiWalkGetAttr got %d stats and %d files, want 3", len(stats), len(files))
+	}
+	for i, mode := range []p9.FileMode{p9.ModeDirectory, p9.ModeDirectory, p9.ModeRegular} {
+		if got := stats[i].Attr.Mode.FileType(); got != mode {
+			t.Errorf("got mode %v for component %d, want %v", got, i, mode)
+		}
+		if qid, _, _, err := files[i].GetAttr(p9.AttrMaskAll()); err != nil || qid != stats[i].QID {
+			t.Errorf("GetAttr on component %d got (%v, %v), want (%v, nil)", i, qid, err, stats[i].QID)
+		}
+	}
+
+	// A walk that fails part of the way through returns what it found.
+	stats, files, err = root.MultiWalkGetAttr([]string{"one", "other", "file"})
+	if err != nil {
+		t.Fatalf("MultiWalkGetAttr got err %v, want nil", err)
+	}
+	for _, f := range files {
+		defer f.Close()
+	}
+	if len(stats) != 1 || len(files) != 1 {
+		t.Errorf("MultiWalkGetAttr got %d stats and %d files, want 1", len(stats), len(files))
+	}
+
+	// A walk that fails at the first component returns an error.
+	if _, _, err := root.MultiWalkGetAttr([]string{"other", "file"}); err != syscall.ENOENT {
+		t.Errorf("MultiWalkGetAttr got err %v, want ENOENT", err)
+	}
+	if _, _, err := root.MultiWalkGetAttr([]string{"..", "file"}); err != syscall.EINVAL {
+		t.Errorf("MultiWalkGetAttr got err %v, want EINVAL", err)
+	}
+}
+
 // newTypeMap returns a new type map dictionary.
 func newTypeMap(h *Harness) map[string]Generator {
 	return map[string]Generator{
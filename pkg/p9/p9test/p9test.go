@@ -52,6 +52,7 @@ type Generator func(parent *Mock) *Mock
 // Mock is a common mock element.
 type Mock struct {
 	p9.DefaultWalkGetAttr
+	p9.DefaultMultiWalkGetAttr
 	*MockFile
 	parent   *Mock
 	closed   bool
@@ -142,6 +143,12 @@ func (m *Mock) WalkGetAttr(names []string) ([]p9.QID, p9.File, p9.AttrMask, p9.A
 	return m.DefaultWalkGetAttr.WalkGetAttr(names)
 }
 
+// MultiWalkGetAttr calls the default implementation; this is a client-side
+// optimization.
+func (m *Mock) MultiWalkGetAttr(names []string) ([]p9.FullStat, []p9.File, error) {
+	return m.DefaultMultiWalkGetAttr.MultiWalkGetAttr(names)
+}
+
 // Pop pops off the most recently created Mock and assert that this mock
 // represents the same file passed in. If nil is passed in, no check is
 // performed.
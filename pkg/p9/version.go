@@ -26,7 +26,7 @@ const (
 	//
 	// Clients are expected to start requesting this version number and
 	// to continuously decrement it until a Tversion request succeeds.
-	highestSupportedVersion uint32 = 11
+	highestSupportedVersion uint32 = 12
 
 	// lowestSupportedVersion is the lowest supported version X in a
 	// version string of the format 9P2000.L.Google.X.
@@ -173,3 +173,10 @@ func versionSupportsGetSetXattr(v uint32) bool {
 func versionSupportsListRemoveXattr(v uint32) bool {
 	return v >= 11
 }
+
+// versionSupportsTmultiwalkgetattr returns true if version v supports the
+// Tmultiwalkgetattr message. This predicate must be checked by clients before
+// attempting to make a Tmultiwalkgetattr request.
+func versionSupportsTmultiwalkgetattr(v uint32) bool {
+	return v >= 12
+}
@@ -48,12 +48,28 @@ func (r *reader) Read(p []byte) (int, error) {
 
 // bufferedReader implements a threadsafe buffered io.Reader.
 type bufferedReader struct {
+	// rd is the unbuffered reader. It is safe for concurrent use.
+	rd io.Reader
+
 	mu sync.Mutex
 	r  *bufio.Reader
 }
 
+func newBufferedReader(rd io.Reader) *bufferedReader {
+	return &bufferedReader{
+		rd: rd,
+		r:  bufio.NewReader(rd),
+	}
+}
+
 // Read implements io.Reader.Read.
 func (b *bufferedReader) Read(p []byte) (int, error) {
+	if len(p) >= b.r.Size() {
+		// Buffering gains nothing for reads at least as large as the
+		// buffer, so read directly, without serializing with other
+		// readers.
+		return b.rd.Read(p)
+	}
 	b.mu.Lock()
 	n, err := b.r.Read(p)
 	b.mu.Unlock()
@@ -61,7 +77,7 @@ func (b *bufferedReader) Read(p []byte) (int, error) {
 }
 
 // Reader is the default reader.
-var Reader io.Reader = &bufferedReader{r: bufio.NewReader(&reader{})}
+var Reader io.Reader = newBufferedReader(&reader{})
 
 // Read reads from the default reader.
 func Read(b []byte) (int, error) {
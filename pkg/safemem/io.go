@@ -207,6 +207,62 @@ func (r FromIOReader) readToBlock(dst Block, buf []byte) (int, []byte, error) {
 	return wbn, buf, rerr
 }
 
+// fromIOReaderFullBufLen is the maximum length of FromIOReaderFull's
+// intermediate buffer.
+const fromIOReaderFullBufLen = 64 << 10
+
+// FromIOReaderFull implements Reader for an io.Reader that can always fill
+// the slices it is given, such as a random number generator. Unlike
+// FromIOReader, it invokes io.Reader.Read repeatedly until each Block is full,
+// and reads Blocks that require safecopy through an intermediate buffer of
+// bounded size, so that large reads don't need an equally large allocation.
+// This is not thread-safe.
+type FromIOReaderFull struct {
+	Reader io.Reader
+}
+
+// ReadToBlocks implements Reader.ReadToBlocks.
+func (r FromIOReaderFull) ReadToBlocks(dsts BlockSeq) (uint64, error) {
+	var buf []byte
+	var done uint64
+	for !dsts.IsEmpty() {
+		dst := dsts.Head()
+		dsts = dsts.Tail()
+		if !dst.NeedSafecopy() {
+			n, err := io.ReadFull(r.Reader, dst.ToSlice())
+			done += uint64(n)
+			if err != nil {
+				return done, err
+			}
+			continue
+		}
+		for dst.Len() > 0 {
+			if buf == nil {
+				bufLen := uint64(dst.Len()) + dsts.NumBytes()
+				if bufLen > fromIOReaderFullBufLen {
+					bufLen = fromIOReaderFullBufLen
+				}
+				buf = make([]byte, bufLen)
+			}
+			chunk := buf
+			if len(chunk) > dst.Len() {
+				chunk = chunk[:dst.Len()]
+			}
+			rn, rerr := io.ReadFull(r.Reader, chunk)
+			wn, werr := Copy(dst, BlockFromSafeSlice(chunk[:rn]))
+			done += uint64(wn)
+			if werr != nil {
+				return done, werr
+			}
+			if rerr != nil {
+				return done, rerr
+			}
+			dst = dst.DropFirst(wn)
+		}
+	}
+	return done, nil
+}
+
 // FromIOReaderAt implements Reader for an io.ReaderAt. Does not repeatedly
 // invoke io.ReaderAt.ReadAt because ReadAt is more strict than Read. A partial
 // read indicates an error. This is not thread-safe.
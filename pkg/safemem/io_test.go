@@ -113,6 +113,42 @@ func TestReadFullToBlocks(t *testing.T) {
 	}
 }
 
+func TestFromIOReaderFull(t *testing.T) {
+	// Make the blocks large enough that reading them into unsafe blocks
+	// takes several passes through FromIOReaderFull's buffer.
+	src := make([]byte, 3*fromIOReaderFullBufLen+5)
+	for i := range src {
+		src[i] = byte(i * 7)
+	}
+	r := FromIOReaderFull{singleByteReader{bytes.NewBuffer(src)}}
+	bufs := [][]byte{make([]byte, 3), make([]byte, 2*fromIOReaderFullBufLen+1), make([]byte, fromIOReaderFullBufLen+1)}
+	dsts := []Block{BlockFromSafeSlice(bufs[0]), BlockFromUnsafeSlice(bufs[1]), BlockFromUnsafeSlice(bufs[2])}
+	n, err := r.ReadToBlocks(BlockSeqFromSlice(dsts))
+	// FromIOReaderFull should keep reading from the singleByteReader
+	// until dsts is exhausted.
+	if wantN := uint64(len(src)); n != wantN || err != nil {
+		t.Errorf("ReadToBlocks: got (%v, %v), wanted (%v, nil)", n, err, wantN)
+	}
+	if got := bytes.Join(bufs, nil); !bytes.Equal(got, src) {
+		t.Errorf("ReadToBlocks read the wrong bytes")
+	}
+}
+
+func TestFromIOReaderFullShortRead(t *testing.T) {
+	r := FromIOReaderFull{bytes.NewBufferString("foob")}
+	bufs := [][]byte{make([]byte, 3), make([]byte, 3)}
+	dsts := []Block{BlockFromSafeSlice(bufs[0]), BlockFromUnsafeSlice(bufs[1])}
+	n, err := r.ReadToBlocks(BlockSeqFromSlice(dsts))
+	if wantN := uint64(4); n != wantN || err != io.ErrUnexpectedEOF {
+		t.Errorf("ReadToBlocks: got (%v, %v), wanted (%v, %v)", n, err, wantN, io.ErrUnexpectedEOF)
+	}
+	for i, want := range [][]byte{[]byte("foo"), []byte("b\x00\x00")} {
+		if got := bufs[i]; !bytes.Equal(got, want) {
+			t.Errorf("bufs[%d]: got %q, wanted %q", i, got, want)
+		}
+	}
+}
+
 func TestFromIOWriterFullWrite(t *testing.T) {
 	srcs := makeBlocks([]byte("foo"), []byte("bar"))
 	var dst bytes.Buffer
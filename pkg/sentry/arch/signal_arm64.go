@@ -25,6 +25,8 @@ import (
 
 // SignalContext64 is equivalent to struct sigcontext, the type passed as the
 // second argument to signal handlers set by signal(2).
+//
+// +marshal
 type SignalContext64 struct {
 	FaultAddr uint64
 	Regs      [31]uint64
@@ -36,6 +38,10 @@ type SignalContext64 struct {
 	Reserved  [3568]uint8
 }
 
+// aarch64Ctx is equivalent to struct _aarch64_ctx on arm64
+// (arch/arm64/include/uapi/asm/sigcontext.h).
+//
+// +marshal
 type aarch64Ctx struct {
 	Magic uint32
 	Size  uint32
@@ -43,6 +49,8 @@ type aarch64Ctx struct {
 
 // FpsimdContext is equivalent to struct fpsimd_context on arm64
 // (arch/arm64/include/uapi/asm/sigcontext.h).
+//
+// +marshal
 type FpsimdContext struct {
 	Head  aarch64Ctx
 	Fpsr  uint32
@@ -51,13 +59,16 @@ type FpsimdContext struct {
 }
 
 // UContext64 is equivalent to ucontext on arm64(arch/arm64/include/uapi/asm/ucontext.h).
+//
+// +marshal
 type UContext64 struct {
 	Flags  uint64
 	Link   uint64
 	Stack  SignalStack
 	Sigset linux.SignalSet
-	// glibc uses a 1024-bit sigset_t
-	_pad [(1024 - 64) / 8]byte
+	// glibc uses a 1024-bit sigset_t: (1024 - 64) / 8 bytes of padding.
+	// go_marshal requires a literal size.
+	_pad [120]byte
 	// sigcontext must be aligned to 16-byte
 	_pad2 [8]byte
 	// last for future expansion
@@ -20,6 +20,7 @@ import (
 
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/tools/go_marshal/marshal"
 )
 
 // Stack is a simple wrapper around a usermem.IO and an address.
@@ -39,8 +40,23 @@ type Stack struct {
 // Push pushes the given values on to the stack.
 //
 // (This method supports Addrs and treats them as native types.)
+//
+// Values that implement marshal.Marshallable, such as the signal frame, are
+// copied without reflection.
 func (s *Stack) Push(vals ...interface{}) (usermem.Addr, error) {
 	for _, v := range vals {
+		if m, ok := v.(marshal.Marshallable); ok {
+			c := m.SizeBytes()
+			buf := make([]byte, c)
+			m.MarshalUnsafe(buf)
+			n, err := s.IO.CopyOut(context.Background(), s.Bottom-usermem.Addr(c), buf, usermem.IOOpts{})
+			if err != nil || c != n {
+				return 0, err
+			}
+
+			s.Bottom -= usermem.Addr(n)
+			continue
+		}
 
 		// We convert some types to well-known serializable quanities.
 		var norm interface{}
@@ -111,6 +127,9 @@ func (s *Stack) Push(vals ...interface{}) (usermem.Addr, error) {
 // Pop pops the given values off the stack.
 //
 // (This method supports Addrs and treats them as native types.)
+//
+// Values that implement marshal.Marshallable, such as the signal frame, are
+// copied without reflection.
 func (s *Stack) Pop(vals ...interface{}) (usermem.Addr, error) {
 	for _, v := range vals {
 
@@ -122,6 +141,12 @@ func (s *Stack) Pop(vals ...interface{}) (usermem.Addr, error) {
 			value := s.Arch.Native(uintptr(0))
 			n, err = usermem.CopyObjectIn(context.Background(), s.IO, s.Bottom, value, usermem.IOOpts{})
 			*vaddr = usermem.Addr(s.Arch.Value(value))
+		} else if m, ok := v.(marshal.Marshallable); ok {
+			buf := make([]byte, m.SizeBytes())
+			n, err = s.IO.CopyIn(context.Background(), s.Bottom, buf, usermem.IOOpts{})
+			if err == nil {
+				m.UnmarshalUnsafe(buf)
+			}
 		} else {
 			n, err = usermem.CopyObjectIn(context.Background(), s.IO, s.Bottom, v, usermem.IOOpts{})
 		}
@@ -16,6 +16,7 @@ package control
 
 import (
 	"errors"
+	"os"
 
 	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
@@ -26,7 +27,7 @@ import (
 
 // ErrInvalidFiles is returned when the urpc call to Save does not include an
 // appropriate file payload (e.g. there is no output file!).
-var ErrInvalidFiles = errors.New("exactly one file must be provided")
+var ErrInvalidFiles = errors.New("one or two files must be provided")
 
 // State includes state-related functions.
 type State struct {
@@ -42,21 +43,30 @@ type SaveOpts struct {
 	// Metadata is the set of metadata to prepend to the state file.
 	Metadata map[string]string `json:"metadata"`
 
-	// FilePayload contains the destination for the state.
+	// FilePayload contains the destination for the state, optionally
+	// followed by a file to which the contents of application memory are
+	// saved separately, as for kernel.Kernel.SaveTo.
 	urpc.FilePayload
 }
 
 // Save saves the running system.
 func (s *State) Save(o *SaveOpts, _ *struct{}) error {
 	// Create an output stream.
-	if len(o.FilePayload.Files) != 1 {
+	if len(o.FilePayload.Files) != 1 && len(o.FilePayload.Files) != 2 {
 		return ErrInvalidFiles
 	}
-	defer o.FilePayload.Files[0].Close()
+	for _, f := range o.FilePayload.Files {
+		defer f.Close()
+	}
+	var pages *os.File
+	if len(o.FilePayload.Files) == 2 {
+		pages = o.FilePayload.Files[1]
+	}
 
 	// Save to the first provided stream.
 	saveOpts := state.SaveOpts{
 		Destination: o.FilePayload.Files[0],
+		Pages:       pages,
 		Key:         o.Key,
 		Metadata:    o.Metadata,
 		Callback: func(err error) {
@@ -78,6 +78,14 @@ func (fd *zeroFD) Seek(ctx context.Context, offset int64, whence int32) (int64,
 
 // ConfigureMMap implements vfs.FileDescriptionImpl.ConfigureMMap.
 func (fd *zeroFD) ConfigureMMap(ctx context.Context, opts *memmap.MMapOpts) error {
+	if opts.Private {
+		// Private mappings of /dev/zero are private anonymous memory, which
+		// is allocated as it is faulted in rather than up front. Linux:
+		// drivers/char/mem.c:mmap_zero().
+		opts.MappingIdentity = &fd.vfsfd
+		fd.vfsfd.IncRef()
+		return nil
+	}
 	m, err := mm.NewSharedAnonMappable(opts.Length, pgalloc.MemoryFileProviderFromContext(ctx))
 	if err != nil {
 		return err
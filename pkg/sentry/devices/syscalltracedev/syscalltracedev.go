@@ -0,0 +1,92 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package syscalltracedev implements /dev/syscall_trace, a gVisor-specific
+// device that may be mapped read-only to observe the kernel's syscall trace
+// buffer. Syscalls are recorded while the device is open. See package
+// syscalltrace for the buffer's layout.
+package syscalltracedev
+
+import (
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/sentry/fsimpl/devtmpfs"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/syscalltrace"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/vfs"
+	"gvisor.dev/gvisor/pkg/syserror"
+)
+
+// Register registers the syscall trace device in vfsObj.
+func Register(vfsObj *vfs.VirtualFilesystem) error {
+	return vfsObj.RegisterDevice(vfs.CharDevice, syscalltrace.DevMajor, syscalltrace.DevMinor, syscallTraceDevice{}, &vfs.RegisterDeviceOptions{
+		GroupName: "misc",
+	})
+}
+
+// CreateDevtmpfsFiles creates the syscall trace device special file in dev.
+func CreateDevtmpfsFiles(ctx context.Context, dev *devtmpfs.Accessor) error {
+	return dev.CreateDeviceFile(ctx, "syscall_trace", vfs.CharDevice, syscalltrace.DevMajor, syscalltrace.DevMinor, 0400 /* mode */)
+}
+
+// syscallTraceDevice implements vfs.Device for /dev/syscall_trace.
+type syscallTraceDevice struct{}
+
+// Open implements vfs.Device.Open.
+func (syscallTraceDevice) Open(ctx context.Context, mnt *vfs.Mount, vfsd *vfs.Dentry, opts vfs.OpenOptions) (*vfs.FileDescription, error) {
+	// The buffer is shared by the whole sandbox, so it may only be read, and
+	// only by a sufficiently privileged agent.
+	if opts.Flags&linux.O_ACCMODE != linux.O_RDONLY {
+		return nil, syserror.EACCES
+	}
+	creds := auth.CredentialsFromContext(ctx)
+	if !creds.HasCapabilityIn(linux.CAP_SYS_ADMIN, creds.UserNamespace.Root()) {
+		return nil, syserror.EPERM
+	}
+	k := kernel.KernelFromContext(ctx)
+	buf, err := k.StartSyscallTrace()
+	if err != nil {
+		return nil, err
+	}
+	fd := &syscallTraceFD{k: k, buf: buf}
+	if err := fd.vfsfd.Init(fd, opts.Flags, mnt, vfsd, &vfs.FileDescriptionOptions{
+		UseDentryMetadata: true,
+	}); err != nil {
+		k.StopSyscallTrace()
+		return nil, err
+	}
+	return &fd.vfsfd, nil
+}
+
+// syscallTraceFD implements vfs.FileDescriptionImpl for /dev/syscall_trace.
+type syscallTraceFD struct {
+	vfsfd vfs.FileDescription
+	vfs.FileDescriptionDefaultImpl
+	vfs.DentryMetadataFileDescriptionImpl
+
+	k   *kernel.Kernel
+	buf *syscalltrace.Buffer
+}
+
+// Release implements vfs.FileDescriptionImpl.Release.
+func (fd *syscallTraceFD) Release() {
+	fd.k.StopSyscallTrace()
+}
+
+// ConfigureMMap implements vfs.FileDescriptionImpl.ConfigureMMap.
+func (fd *syscallTraceFD) ConfigureMMap(ctx context.Context, opts *memmap.MMapOpts) error {
+	return vfs.GenericConfigureMMap(&fd.vfsfd, fd.buf, opts)
+}
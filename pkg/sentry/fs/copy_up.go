@@ -88,15 +88,30 @@ import (
 // panics. If copyUp fails because any step (above) fails, a generic
 // error is returned.
 //
-// copyUp currently makes no attempt to optimize copying up file content.
-// For large files, this means that copyUp blocks until the entire file
-// is copied synchronously.
+// copyUp skips holes in file content, but otherwise makes no attempt to
+// optimize copying it up. For large files, this means that copyUp blocks
+// until the entire file is copied synchronously. Operations that only
+// change the metadata of a file should use copyUpMetadata instead.
 func copyUp(ctx context.Context, d *Dirent) error {
 	renameMu.RLock()
 	defer renameMu.RUnlock()
 	return copyUpLockedForRename(ctx, d)
 }
 
+// copyUpMetadata is the same as copyUp, except that for a regular file it
+// copies up only the file's metadata, and defers copying its content until
+// the next copyUp. In the meantime, the upper file is marked with
+// XattrOverlayMetacopy and has the size of the lower file, and the file's
+// content is still read from the lower filesystem.
+//
+// If the upper filesystem does not support XattrOverlayMetacopy,
+// copyUpMetadata copies up the whole file.
+func copyUpMetadata(ctx context.Context, d *Dirent) error {
+	renameMu.RLock()
+	defer renameMu.RUnlock()
+	return copyUpPathLocked(ctx, d, true /* metadataOnly */)
+}
+
 // copyUpLockedForRename is the same as copyUp except that it does not lock
 // renameMu.
 //
@@ -110,12 +125,19 @@ func copyUp(ctx context.Context, d *Dirent) error {
 // Preconditions:
 // - d.Inode.overlay is non-nil.
 func copyUpLockedForRename(ctx context.Context, d *Dirent) error {
+	return copyUpPathLocked(ctx, d, false /* metadataOnly */)
+}
+
+// copyUpPathLocked implements copyUpLockedForRename and copyUpMetadata.
+//
+// Preconditions: renameMu must be locked.
+func copyUpPathLocked(ctx context.Context, d *Dirent, metadataOnly bool) error {
 	for {
 		// Did we race with another copy up or does there
 		// already exist something in the upper filesystem
 		// for d?
 		d.Inode.overlay.copyMu.RLock()
-		if d.Inode.overlay.upper != nil {
+		if d.Inode.overlay.upper != nil && (metadataOnly || !d.Inode.overlay.lowerData) {
 			d.Inode.overlay.copyMu.RUnlock()
 			// Done, d is in the upper filesystem.
 			return nil
@@ -127,7 +149,7 @@ func copyUpLockedForRename(ctx context.Context, d *Dirent) error {
 		next := findNextCopyUp(ctx, d)
 
 		// Attempt to copy.
-		if err := doCopyUp(ctx, next); err != nil {
+		if err := doCopyUp(ctx, next, metadataOnly); err != nil {
 			return err
 		}
 	}
@@ -155,7 +177,7 @@ func findNextCopyUp(ctx context.Context, d *Dirent) *Dirent {
 	}
 }
 
-func doCopyUp(ctx context.Context, d *Dirent) error {
+func doCopyUp(ctx context.Context, d *Dirent, metadataOnly bool) error {
 	// Fail fast on Inode types we won't be able to copy up anyways. These
 	// Inodes may block in GetFile while holding copyMu for reading. If we
 	// then try to take copyMu for writing here, we'd deadlock.
@@ -168,15 +190,21 @@ func doCopyUp(ctx context.Context, d *Dirent) error {
 	d.Inode.overlay.copyMu.Lock()
 	defer d.Inode.overlay.copyMu.Unlock()
 	if d.Inode.overlay.upper != nil {
-		// We raced with another doCopyUp, no problem.
-		return nil
+		if metadataOnly || !d.Inode.overlay.lowerData {
+			// We raced with another doCopyUp, no problem.
+			return nil
+		}
+		// Only the metadata of d has been copied up so far.
+		return copyUpDataLocked(ctx, d)
 	}
 
 	// Perform the copy.
-	return copyUpLocked(ctx, d.parent, d)
+	return copyUpLocked(ctx, d.parent, d, metadataOnly && t == RegularFile)
 }
 
-// copyUpLocked creates a copy of next in the upper filesystem of parent.
+// copyUpLocked creates a copy of next in the upper filesystem of parent. If
+// metadataOnly is true, the content of next is not copied (see
+// copyUpMetadata).
 //
 // copyUpLocked must be called with d.Inode.overlay.copyMu locked.
 //
@@ -189,7 +217,7 @@ func doCopyUp(ctx context.Context, d *Dirent) error {
 // - next.Inode.overlay.lower.StableAttr.Type must be RegularFile, Directory,
 //   or Symlink.
 // - upper filesystem must support setting file ownership and timestamps.
-func copyUpLocked(ctx context.Context, parent *Dirent, next *Dirent) error {
+func copyUpLocked(ctx context.Context, parent *Dirent, next *Dirent, metadataOnly bool) error {
 	// Extract the attributes of the file we wish to copy.
 	attrs, err := next.Inode.overlay.lower.UnstableAttr(ctx)
 	if err != nil {
@@ -253,17 +281,32 @@ func copyUpLocked(ctx context.Context, parent *Dirent, next *Dirent) error {
 		panic(fmt.Sprintf("copy up of invalid type %v on %+v", next.Inode.StableAttr.Type, next))
 	}
 
-	// Bring file attributes up to date. This does not include size, which will be
-	// brought up to date with copyContentsLocked.
-	if err := copyAttributesLocked(ctx, childUpperInode, next.Inode.overlay.lower); err != nil {
-		werr := fmt.Errorf("copy up failed to copy up attributes: %v", err)
-		cleanupUpper(ctx, parentUpper, next.name, werr)
-		return syserror.EIO
+	if metadataOnly {
+		// Give the upper file the size of the lower file without
+		// allocating its content, and mark it as a metadata-only copy.
+		// Fall back to copying the entire file if the upper filesystem
+		// can't do either.
+		if err := childUpperInode.InodeOperations.Truncate(ctx, childUpperInode, attrs.Size); err != nil {
+			metadataOnly = false
+		} else if err := childUpperInode.InodeOperations.SetXattr(ctx, childUpperInode, XattrOverlayMetacopy, "y", 0 /* flags */); err != nil {
+			metadataOnly = false
+		}
+	}
+
+	// Copy the entire file. This is done before copying attributes, since
+	// writing the content updates the upper file's timestamps.
+	if !metadataOnly {
+		if err := copyContentsLocked(ctx, childUpperInode, next.Inode.overlay.lower, attrs.Size); err != nil {
+			werr := fmt.Errorf("copy up failed to copy up contents: %v", err)
+			cleanupUpper(ctx, parentUpper, next.name, werr)
+			return syserror.EIO
+		}
 	}
 
-	// Copy the entire file.
-	if err := copyContentsLocked(ctx, childUpperInode, next.Inode.overlay.lower, attrs.Size); err != nil {
-		werr := fmt.Errorf("copy up failed to copy up contents: %v", err)
+	// Bring file attributes up to date. This does not include size, which
+	// was brought up to date above.
+	if err := copyAttributesLocked(ctx, childUpperInode, next.Inode.overlay.lower); err != nil {
+		werr := fmt.Errorf("copy up failed to copy up attributes: %v", err)
 		cleanupUpper(ctx, parentUpper, next.name, werr)
 		return syserror.EIO
 	}
@@ -276,13 +319,84 @@ func copyUpLocked(ctx context.Context, parent *Dirent, next *Dirent) error {
 		return syserror.EIO
 	}
 
+	if metadataOnly {
+		// Take a reference on the upper Inode (transferred to
+		// next.Inode.overlay.upper). Memory mappings continue to use
+		// the lower Inode until the file's content is copied up.
+		next.Inode.overlay.mapsMu.Lock()
+		next.Inode.overlay.dataMu.Lock()
+		childUpperInode.IncRef()
+		next.Inode.overlay.upper = childUpperInode
+		next.Inode.overlay.lowerData = true
+		next.Inode.overlay.dataMu.Unlock()
+		next.Inode.overlay.mapsMu.Unlock()
+		return nil
+	}
+
+	return commitCopyUpLocked(ctx, next.Inode.overlay, childUpperInode, lowerMappable, upperMappable)
+}
+
+// copyUpDataLocked copies up the content of d, whose metadata has already
+// been copied up by copyUpMetadata.
+//
+// Returns a generic error on failure, in which case d remains a
+// metadata-only copy.
+//
+// Preconditions:
+// - d.Inode.overlay.copyMu must be locked writable.
+// - d.Inode.overlay.upper must be non-nil, and d.Inode.overlay.lowerData must
+//   be true.
+func copyUpDataLocked(ctx context.Context, d *Dirent) error {
+	o := d.Inode.overlay
+	lowerAttrs, err := o.lower.UnstableAttr(ctx)
+	if err != nil {
+		log.Warningf("copy up failed to get lower attributes: %v", err)
+		return syserror.EIO
+	}
+	upperAttrs, err := o.upper.UnstableAttr(ctx)
+	if err != nil {
+		log.Warningf("copy up failed to get upper attributes: %v", err)
+		return syserror.EIO
+	}
+
+	if err := copyContentsLocked(ctx, o.upper, o.lower, lowerAttrs.Size); err != nil {
+		log.Warningf("copy up failed to copy up contents: %v", err)
+		return syserror.EIO
+	}
+
+	// Restore the timestamps that were copied up (or set) with the
+	// file's metadata.
+	if err := o.upper.InodeOperations.SetTimestamps(ctx, o.upper, TimeSpec{
+		ATime: upperAttrs.AccessTime,
+		MTime: upperAttrs.ModificationTime,
+	}); err != nil {
+		log.Warningf("copy up failed to restore timestamps: %v", err)
+		return syserror.EIO
+	}
+	if err := o.upper.InodeOperations.RemoveXattr(ctx, o.upper, XattrOverlayMetacopy); err != nil {
+		log.Warningf("copy up failed to remove metacopy marker: %v", err)
+		return syserror.EIO
+	}
+
+	return commitCopyUpLocked(ctx, o, o.upper, o.lower.Mappable(), o.upper.Mappable())
+}
+
+// commitCopyUpLocked makes o use upper for its content, transferring any
+// memory mappings of lower to upper.
+//
+// Preconditions:
+// - o.copyMu must be locked writable.
+// - upper must be the upper Inode of o, or the new upper Inode of o if o has
+//   none yet.
+// - If lowerMappable is non-nil, upperMappable must be non-nil.
+func commitCopyUpLocked(ctx context.Context, o *overlayEntry, upper *Inode, lowerMappable, upperMappable memmap.Mappable) error {
 	// Propagate memory mappings to the upper Inode.
-	next.Inode.overlay.mapsMu.Lock()
-	defer next.Inode.overlay.mapsMu.Unlock()
+	o.mapsMu.Lock()
+	defer o.mapsMu.Unlock()
 	if upperMappable != nil {
 		// Remember which mappings we added so we can remove them on failure.
 		allAdded := make(map[memmap.MappableRange]memmap.MappingsOfRange)
-		for seg := next.Inode.overlay.mappings.FirstSegment(); seg.Ok(); seg = seg.NextSegment() {
+		for seg := o.mappings.FirstSegment(); seg.Ok(); seg = seg.NextSegment() {
 			added := make(memmap.MappingsOfRange)
 			for m := range seg.Value() {
 				if err := upperMappable.AddMapping(ctx, m.MappingSpace, m.AddrRange, seg.Start(), m.Writable); err != nil {
@@ -302,19 +416,22 @@ func copyUpLocked(ctx context.Context, parent *Dirent, next *Dirent) error {
 		}
 	}
 
-	// Take a reference on the upper Inode (transferred to
-	// next.Inode.overlay.upper) and make new translations use it.
-	next.Inode.overlay.dataMu.Lock()
-	childUpperInode.IncRef()
-	next.Inode.overlay.upper = childUpperInode
-	next.Inode.overlay.dataMu.Unlock()
+	// Take a reference on the upper Inode (transferred to o.upper), if o
+	// doesn't already hold one, and make new translations use it.
+	o.dataMu.Lock()
+	if o.upper == nil {
+		upper.IncRef()
+		o.upper = upper
+	}
+	o.lowerData = false
+	o.dataMu.Unlock()
 
 	// Invalidate existing translations through the lower Inode.
-	next.Inode.overlay.mappings.InvalidateAll(memmap.InvalidateOpts{})
+	o.mappings.InvalidateAll(memmap.InvalidateOpts{})
 
 	// Remove existing memory mappings from the lower Inode.
 	if lowerMappable != nil {
-		for seg := next.Inode.overlay.mappings.FirstSegment(); seg.Ok(); seg = seg.NextSegment() {
+		for seg := o.mappings.FirstSegment(); seg.Ok(); seg = seg.NextSegment() {
 			for m := range seg.Value() {
 				lowerMappable.RemoveMapping(ctx, m.MappingSpace, m.AddrRange, seg.Start(), m.Writable)
 			}
@@ -339,8 +456,8 @@ func cleanupUpper(ctx context.Context, parent *Inode, name string, copyUpErr err
 // size is the same used by io.Copy.
 var copyUpBuffers = sync.Pool{New: func() interface{} { return make([]byte, 8*usermem.PageSize) }}
 
-// copyContentsLocked copies the contents of lower to upper. It panics if
-// less than size bytes can be copied.
+// copyContentsLocked copies the contents of lower to upper, and truncates
+// upper to size. It panics if less than size bytes can be copied.
 func copyContentsLocked(ctx context.Context, upper *Inode, lower *Inode, size int64) error {
 	// We don't support copying up for anything other than regular files.
 	if lower.StableAttr.Type != RegularFile {
@@ -365,6 +482,10 @@ func copyContentsLocked(ctx context.Context, upper *Inode, lower *Inode, size in
 	buf := copyUpBuffers.Get().([]byte)
 	defer copyUpBuffers.Put(buf)
 
+	// Give upper its final size up front. Then ranges of lower that read as
+	// zeroes, such as holes, need not be written to upper at all.
+	sparse := upper.InodeOperations.Truncate(ctx, upper, size) == nil
+
 	// Transfer the contents.
 	//
 	// One might be able to optimize this by doing parallel reads, parallel writes and reads, larger
@@ -384,6 +505,10 @@ func copyContentsLocked(ctx context.Context, upper *Inode, lower *Inode, size in
 			}
 			return nil
 		}
+		if sparse && isZeroes(buf[:nr]) {
+			offset += nr
+			continue
+		}
 		nw, err := upperFile.FileOperations.Write(ctx, upperFile, usermem.BytesIOSequence(buf[:nr]), offset)
 		if err != nil {
 			return err
@@ -392,6 +517,16 @@ func copyContentsLocked(ctx context.Context, upper *Inode, lower *Inode, size in
 	}
 }
 
+// isZeroes returns true if buf contains only zeroes.
+func isZeroes(buf []byte) bool {
+	for _, b := range buf {
+		if b != 0 {
+			return false
+		}
+	}
+	return true
+}
+
 // copyAttributesLocked copies a subset of lower's attributes to upper,
 // specifically owner, timestamps (except of status change time), and
 // extended attributes. Notably no attempt is made to copy link count.
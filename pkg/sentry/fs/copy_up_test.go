@@ -87,6 +87,48 @@ func TestConcurrentCopyUp(t *testing.T) {
 	}
 }
 
+// TestMetadataCopyUp checks that the content of a file whose metadata has
+// been copied up is still read from the lower filesystem, and that the
+// content is copied up when the file is modified.
+func TestMetadataCopyUp(t *testing.T) {
+	ctx := contexttest.Context(t)
+	o := makeOverlayTestFiles(t)[0]
+	d := o.File.Dirent
+
+	perms := fs.FilePermsFromMode(0600)
+	if !d.Inode.SetPermissions(ctx, d, perms) {
+		t.Fatalf("failed to set permissions")
+	}
+	if _, err := d.Inode.GetXattr(ctx, fs.XattrOverlayMetacopy, 1); err == nil {
+		t.Errorf("overlay extended attribute %q is visible", fs.XattrOverlayMetacopy)
+	}
+
+	checkContent := func(want []byte) {
+		got := make([]byte, origFileSize)
+		n, err := o.File.Preadv(ctx, usermem.BytesIOSequence(got), 0)
+		if err != nil && err != io.EOF {
+			t.Fatalf("read got error %v, want nil", err)
+		}
+		if !bytes.Equal(got[:n], want) {
+			t.Fatalf("file content is %v, want %v", got[:n], want)
+		}
+	}
+	checkContent(o.content)
+
+	if err := d.Inode.Truncate(ctx, d, truncateFileSize); err != nil {
+		t.Fatalf("failed to copy up: %v", err)
+	}
+	checkContent(o.content[:truncateFileSize])
+
+	attr, err := d.Inode.UnstableAttr(ctx)
+	if err != nil {
+		t.Fatalf("failed to get attributes: %v", err)
+	}
+	if attr.Perms != perms {
+		t.Errorf("got permissions %v, want %v", attr.Perms, perms)
+	}
+}
+
 type overlayTestFile struct {
 	File    *fs.File
 	name    string
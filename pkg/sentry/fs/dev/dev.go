@@ -23,6 +23,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/fs/ramfs"
 	"gvisor.dev/gvisor/pkg/sentry/fs/tmpfs"
 	"gvisor.dev/gvisor/pkg/sentry/inet"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/syscalltrace"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
 
@@ -125,6 +126,8 @@ func New(ctx context.Context, msrc *fs.MountSource) *fs.Inode {
 		"ptmx": newSymlink(ctx, "pts/ptmx", msrc),
 
 		"tty": newCharacterDevice(ctx, newTTYDevice(ctx, fs.RootOwner, 0666), msrc, ttyDevMajor, ttyDevMinor),
+
+		"syscall_trace": newCharacterDevice(ctx, newSyscallTraceDevice(ctx, fs.RootOwner, 0400), msrc, syscalltrace.DevMajor, syscalltrace.DevMinor),
 	}
 
 	if isNetTunSupported(inet.StackFromContext(ctx)) {
@@ -121,6 +121,14 @@ var _ fs.FileOperations = (*zeroFileOperations)(nil)
 
 // ConfigureMMap implements fs.FileOperations.ConfigureMMap.
 func (*zeroFileOperations) ConfigureMMap(ctx context.Context, file *fs.File, opts *memmap.MMapOpts) error {
+	if opts.Private {
+		// Private mappings of /dev/zero are private anonymous memory, which
+		// is allocated as it is faulted in rather than up front. Linux:
+		// drivers/char/mem.c:mmap_zero().
+		opts.MappingIdentity = file
+		file.IncRef()
+		return nil
+	}
 	m, err := mm.NewSharedAnonMappable(opts.Length, pgalloc.MemoryFileProviderFromContext(ctx))
 	if err != nil {
 		return err
@@ -75,5 +75,5 @@ var _ fs.FileOperations = (*randomFileOperations)(nil)
 
 // Read implements fs.FileOperations.Read.
 func (*randomFileOperations) Read(ctx context.Context, _ *fs.File, dst usermem.IOSequence, _ int64) (int64, error) {
-	return dst.CopyOutFrom(ctx, safemem.FromIOReader{rand.Reader})
+	return dst.CopyOutFrom(ctx, safemem.FromIOReaderFull{rand.Reader})
 }
@@ -173,3 +173,30 @@ type FifoSizer interface {
 	// The new size is returned (which may be capped).
 	SetFifoSize(size int64) (int64, error)
 }
+
+// Readaheader is an interface for files that can read data into a cache ahead
+// of accesses to it.
+type Readaheader interface {
+	// Readahead reads up to length bytes of file starting at offset into the
+	// cache, as requested by readahead(2) or posix_fadvise(2). It is only a
+	// hint and may do nothing.
+	Readahead(ctx context.Context, file *File, offset, length int64)
+}
+
+// HostFileBacked is an interface for regular files whose data is read and
+// written directly from a host file, without a cache in the sentry.
+type HostFileBacked interface {
+	// HostFD returns the host file descriptor holding file's data. It returns
+	// false if file's data may be cached in the sentry, in which case the host
+	// file may be stale.
+	HostFD(file *File) (int, bool)
+}
+
+// WriteBackStarter is an interface for files that buffer written data and can
+// start writing it back without waiting for it to complete.
+type WriteBackStarter interface {
+	// StartWriteBack starts writing back buffered data in [start, end) of
+	// file, as requested by sync_file_range(2). ctx is used after
+	// StartWriteBack returns, by another goroutine.
+	StartWriteBack(ctx context.Context, file *File, start, end int64)
+}
@@ -236,8 +236,9 @@ func (f *overlayFileOperations) onTop(ctx context.Context, file *File, fn func(*
 	file.Dirent.Inode.overlay.copyMu.RLock()
 	defer file.Dirent.Inode.overlay.copyMu.RUnlock()
 
-	// Only lower layer is available.
-	if file.Dirent.Inode.overlay.upper == nil {
+	// Only lower layer is available, or only the metadata of the file has
+	// been copied up.
+	if o := file.Dirent.Inode.overlay; o.upper == nil || o.lowerData {
 		return fn(f.lower, f.lower.FileOperations)
 	}
 
@@ -444,6 +445,26 @@ func (f *overlayFileOperations) SetFifoSize(size int64) (rv int64, err error) {
 	return sz.SetFifoSize(size)
 }
 
+// Readahead implements Readaheader.Readahead.
+func (f *overlayFileOperations) Readahead(ctx context.Context, overlayFile *File, offset, length int64) {
+	f.onTop(ctx, overlayFile, func(file *File, ops FileOperations) error {
+		if ra, ok := ops.(Readaheader); ok {
+			ra.Readahead(ctx, file, offset, length)
+		}
+		return nil
+	})
+}
+
+// StartWriteBack implements WriteBackStarter.StartWriteBack.
+func (f *overlayFileOperations) StartWriteBack(ctx context.Context, overlayFile *File, start, end int64) {
+	f.onTop(ctx, overlayFile, func(file *File, ops FileOperations) error {
+		if wb, ok := ops.(WriteBackStarter); ok {
+			wb.StartWriteBack(ctx, file, start, end)
+		}
+		return nil
+	})
+}
+
 // readdirEntries returns a sorted map of directory entries from the
 // upper and/or lower filesystem.
 func readdirEntries(ctx context.Context, o *overlayEntry) (*SortedDentryMap, error) {
@@ -18,8 +18,10 @@ import (
 	"fmt"
 	"sort"
 	"strings"
+	"time"
 
 	"gvisor.dev/gvisor/pkg/context"
+	ktime "gvisor.dev/gvisor/pkg/sentry/kernel/time"
 	"gvisor.dev/gvisor/pkg/sync"
 )
 
@@ -136,6 +138,12 @@ type MountSourceFlags struct {
 	// the filesystem should not update access time in-place.
 	NoAtime bool
 
+	// StrictAtime corresponds to mount(2)'s "MS_STRICTATIME" and indicates
+	// that the filesystem should update access time on every access. If
+	// neither NoAtime nor StrictAtime is set, access time is updated as for
+	// "MS_RELATIME", which is the default in Linux.
+	StrictAtime bool
+
 	// ForcePageCache causes all filesystem I/O operations to use the page
 	// cache, even when the platform supports direct mapped I/O. This
 	// doesn't correspond to any Linux mount options.
@@ -146,6 +154,26 @@ type MountSourceFlags struct {
 	NoExec bool
 }
 
+// relatimeInterval is the age beyond which access time is updated on access
+// even if the file hasn't been modified since it was last accessed, for
+// MountSourceFlags without NoAtime or StrictAtime.
+const relatimeInterval = 24 * time.Hour
+
+// NeedsAccessTimeUpdate returns true if an access at time now to a file with
+// the given access, modification and status change times, on a mount with
+// flags f, should update the file's access time.
+//
+// Compare Linux's fs/inode.c:atime_needs_update() => relatime_need_update().
+func (f MountSourceFlags) NeedsAccessTimeUpdate(atime, mtime, ctime, now ktime.Time) bool {
+	if f.NoAtime {
+		return false
+	}
+	if f.StrictAtime {
+		return true
+	}
+	return !mtime.Before(atime) || !ctime.Before(atime) || now.Sub(atime) >= relatimeInterval
+}
+
 // GenericMountSourceOptions splits a string containing comma separated tokens of the
 // format 'key=value' or 'key' into a map of keys and values. For example:
 //
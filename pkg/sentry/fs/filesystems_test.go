@@ -0,0 +1,87 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package fs
+
+import (
+	"testing"
+	"time"
+
+	ktime "gvisor.dev/gvisor/pkg/sentry/kernel/time"
+)
+
+func TestNeedsAccessTimeUpdate(t *testing.T) {
+	now := ktime.FromSeconds(1000000)
+	recent := now.Add(-time.Minute)
+	old := now.Add(-2 * relatimeInterval)
+	older := old.Add(-time.Minute)
+
+	for _, test := range []struct {
+		name                string
+		flags               MountSourceFlags
+		atime, mtime, ctime ktime.Time
+		want                bool
+	}{
+		{
+			name:  "relatime unmodified since access",
+			atime: recent,
+			mtime: older,
+			ctime: older,
+			want:  false,
+		},
+		{
+			name:  "relatime modified since access",
+			atime: recent,
+			mtime: recent,
+			ctime: older,
+			want:  true,
+		},
+		{
+			name:  "relatime changed since access",
+			atime: recent,
+			mtime: older,
+			ctime: now,
+			want:  true,
+		},
+		{
+			name:  "relatime accessed long ago",
+			atime: old,
+			mtime: older,
+			ctime: older,
+			want:  true,
+		},
+		{
+			name:  "strictatime",
+			flags: MountSourceFlags{StrictAtime: true},
+			atime: recent,
+			mtime: older,
+			ctime: older,
+			want:  true,
+		},
+		{
+			name:  "noatime",
+			flags: MountSourceFlags{NoAtime: true, StrictAtime: true},
+			atime: old,
+			mtime: now,
+			ctime: now,
+			want:  false,
+		},
+	} {
+		t.Run(test.name, func(t *testing.T) {
+			if got := test.flags.NeedsAccessTimeUpdate(test.atime, test.mtime, test.ctime, now); got != test.want {
+				t.Errorf("NeedsAccessTimeUpdate got %t, want %t", got, test.want)
+			}
+		})
+	}
+}
@@ -211,6 +211,29 @@ func SyncDirtyAll(ctx context.Context, cache *FileRangeSet, dirty *DirtySet, max
 
 // Preconditions: mr must be page-aligned.
 func syncDirtyRange(ctx context.Context, mr memmap.MappableRange, cache *FileRangeSet, max uint64, mem platform.File, writeAt func(ctx context.Context, srcs safemem.BlockSeq, offset uint64) (uint64, error)) error {
+	// Cache segments that are contiguous in the file, but not in mem (e.g.
+	// because they were filled by separate writes), are passed to writeAt
+	// together, so that dirty data is written back in as few calls as
+	// possible.
+	var (
+		blocks []safemem.Block
+		start  uint64
+		end    uint64
+	)
+	flush := func() error {
+		ims := safemem.BlockSeqFromSlice(blocks)
+		offset := start
+		for !ims.IsEmpty() {
+			n, err := writeAt(ctx, ims, offset)
+			if err != nil {
+				return err
+			}
+			offset += n
+			ims = ims.DropFirst64(n)
+		}
+		blocks = blocks[:0]
+		return nil
+	}
 	for cseg := cache.LowerBoundSegment(mr.Start); cseg.Ok() && cseg.Start() < mr.End; cseg = cseg.NextSegment() {
 		wbr := cseg.Range().Intersect(mr)
 		if max < wbr.Start {
@@ -222,16 +245,23 @@ func syncDirtyRange(ctx context.Context, mr memmap.MappableRange, cache *FileRan
 		}
 		if max < wbr.End {
 			ims = ims.TakeFirst64(max - wbr.Start)
+			wbr.End = max
 		}
-		offset := wbr.Start
-		for !ims.IsEmpty() {
-			n, err := writeAt(ctx, ims, offset)
-			if err != nil {
+		if len(blocks) != 0 && wbr.Start != end {
+			if err := flush(); err != nil {
 				return err
 			}
-			offset += n
-			ims = ims.DropFirst64(n)
 		}
+		if len(blocks) == 0 {
+			start = wbr.Start
+		}
+		for ; !ims.IsEmpty(); ims = ims.Tail() {
+			blocks = append(blocks, ims.Head())
+		}
+		end = wbr.End
+	}
+	if len(blocks) != 0 {
+		return flush()
 	}
 	return nil
 }
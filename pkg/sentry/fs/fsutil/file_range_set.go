@@ -140,6 +140,23 @@ func (frs *FileRangeSet) Fill(ctx context.Context, required, optional memmap.Map
 	return nil
 }
 
+// HugeFillRange returns optional expanded to huge page boundaries, but not
+// past pgend, for use as the optional range passed to FileRangeSet.Fill by
+// files whose memory should be allocated in huge pages. Memory allocated for
+// whole huge pages is aligned by pgalloc.MemoryFile.Allocate so that it can be
+// backed by host huge pages.
+//
+// Preconditions: optional must be page-aligned. optional.End <= pgend.
+func HugeFillRange(optional memmap.MappableRange, pgend uint64) memmap.MappableRange {
+	optional.Start = uint64(usermem.Addr(optional.Start).HugeRoundDown())
+	if end, ok := usermem.Addr(optional.End).HugeRoundUp(); ok && uint64(end) < pgend {
+		optional.End = uint64(end)
+	} else {
+		optional.End = pgend
+	}
+	return optional
+}
+
 // Drop removes segments for memmap.Mappable offsets in mr, freeing the
 // corresponding platform.FileRanges.
 //
@@ -17,6 +17,7 @@ package fsutil
 import (
 	"fmt"
 	"io"
+	"math"
 
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/log"
@@ -112,6 +113,21 @@ type CachingInodeOperations struct {
 	//
 	// refs is protected by dataMu.
 	refs FrameRefSet
+
+	// readaheadNext is the offset following the last data read from cache,
+	// and readaheadWindow is the number of bytes filled by the last cache
+	// miss. A cache miss at readaheadNext continues a sequential read, and
+	// doubles the readahead window up to maxReadahead.
+	//
+	// readaheadNext and readaheadWindow are protected by dataMu.
+	readaheadNext   int64  `state:"nosave"`
+	readaheadWindow uint64 `state:"nosave"`
+
+	// writeBackPending is the number of bytes written to the cache by writes
+	// since dirty data was last written back by a write.
+	//
+	// writeBackPending is protected by dataMu.
+	writeBackPending uint64 `state:"nosave"`
 }
 
 // CachingInodeOperationsOptions configures a CachingInodeOperations.
@@ -126,6 +142,11 @@ type CachingInodeOperationsOptions struct {
 	// host file descriptor mappings returned by
 	// CachingInodeOperations.Translate().
 	LimitHostFDTranslation bool
+
+	// If WriteBack is true, small writes to the end of the file are buffered
+	// in the sentry page cache and written back to the backing file in
+	// batches, rather than written through to it.
+	WriteBack bool
 }
 
 // CachedFileObject is a file that may require caching.
@@ -207,7 +228,9 @@ func (c *CachingInodeOperations) Release() {
 	mf := c.mfp.MemoryFile()
 	mf.MarkAllUnevictable(c)
 	if err := SyncDirtyAll(context.Background(), &c.cache, &c.dirty, uint64(c.attr.Size), mf, c.backingFile.WriteFromBlocksAt); err != nil {
-		panic(fmt.Sprintf("Failed to writeback cached data: %v", err))
+		// As in Linux, errors writing back data that was never synced can
+		// only be logged.
+		log.Warningf("Failed to writeback cached data: %v", err)
 	}
 	c.cache.DropAll(mf)
 	c.dirty.RemoveAll()
@@ -429,15 +452,23 @@ func (c *CachingInodeOperations) DecLinks(ctx context.Context) {
 }
 
 // TouchAccessTime updates the cached access time in-place to the
-// current time. It does not update status change time in-place. See
-// mm/filemap.c:do_generic_file_read -> include/linux/h:file_accessed.
+// current time, if the mount's atime flags require it. It does not update
+// status change time in-place. See mm/filemap.c:do_generic_file_read ->
+// include/linux/h:file_accessed.
+//
+// Since the updated access time is only written back with other dirty
+// attributes, skipping updates that the mount doesn't require avoids writing
+// back attributes for files that are only read.
 func (c *CachingInodeOperations) TouchAccessTime(ctx context.Context, inode *fs.Inode) {
 	if inode.MountSource.Flags.NoAtime {
 		return
 	}
 
+	now := ktime.NowFromContext(ctx)
 	c.attrMu.Lock()
-	c.touchAccessTimeLocked(ktime.NowFromContext(ctx))
+	if inode.MountSource.Flags.NeedsAccessTimeUpdate(c.attr.AccessTime, c.attr.ModificationTime, c.attr.StatusChangeTime, now) {
+		c.touchAccessTimeLocked(now)
+	}
 	c.attrMu.Unlock()
 }
 
@@ -628,6 +659,9 @@ func (rw *inodeReadWriter) ReadToBlocks(dsts safemem.BlockSeq) (uint64, error) {
 			done += n
 			rw.offset += int64(n)
 			dsts = dsts.DropFirst64(n)
+			if fillCache {
+				rw.c.readaheadNext = rw.offset
+			}
 			if err != nil {
 				unlock()
 				return done, err
@@ -646,7 +680,8 @@ func (rw *inodeReadWriter) ReadToBlocks(dsts safemem.BlockSeq) (uint64, error) {
 					End:   fs.OffsetPageEnd(int64(gapMR.End)),
 				}
 				optMR := gap.Range()
-				err := rw.c.cache.Fill(rw.ctx, reqMR, maxFillRange(reqMR, optMR), mem, usage.PageCache, rw.c.backingFile.ReadToBlocksAt)
+				fillMR := rw.c.readaheadRangeLocked(rw.offset, reqMR, optMR)
+				err := rw.c.cache.Fill(rw.ctx, reqMR, fillMR, mem, usage.PageCache, rw.c.backingFile.ReadToBlocksAt)
 				mem.MarkEvictable(rw.c, pgalloc.EvictableRange{optMR.Start, optMR.End})
 				seg, gap = rw.c.cache.Find(uint64(rw.offset))
 				if !seg.Ok() {
@@ -738,6 +773,9 @@ func (rw *inodeReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, error
 			rw.offset += int64(n)
 			srcs = srcs.DropFirst64(n)
 			rw.c.dirty.MarkDirty(segMR)
+			if rw.c.opts.WriteBack {
+				rw.c.writeBackPending += n
+			}
 			if err != nil {
 				rw.maybeGrowFile()
 				rw.c.dataMu.Unlock()
@@ -748,11 +786,17 @@ func (rw *inodeReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, error
 			seg, gap = seg.NextNonEmpty()
 
 		case gap.Ok() && gap.Start() < mr.End:
-			// Write directly to the backing file. At present, we never fill
-			// the cache when writing, since doing so can convert small writes
-			// into inefficient read-modify-write cycles, and we have no
-			// mechanism for detecting or avoiding this.
 			gapmr := gap.Range().Intersect(mr)
+			if rw.maybeCacheWrite(gap, gapmr) {
+				// Re-enter the loop to write to the cache.
+				seg, gap = rw.c.cache.Find(uint64(rw.offset))
+				continue
+			}
+
+			// Write directly to the backing file. We never fill the cache
+			// for writes to existing data, since doing so can convert small
+			// writes into inefficient read-modify-write cycles, and we have
+			// no mechanism for detecting or avoiding this.
 			src := srcs.TakeFirst64(gapmr.Length())
 			n, err := rw.c.backingFile.WriteFromBlocksAt(rw.ctx, src, gapmr.Start)
 			done += n
@@ -773,10 +817,101 @@ func (rw *inodeReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, error
 		}
 	}
 	rw.maybeGrowFile()
+	rw.maybeWriteBack()
 	rw.c.dataMu.Unlock()
 	return done, nil
 }
 
+// maybeCacheWrite inserts pages for a write to gapmr into the cache, so that
+// the write is buffered there and written back to the backing file later, and
+// returns true if it did so.
+//
+// Only small writes after the existing data in the file, as made by logs, are
+// buffered. Since pages past the end of the file are known to be zeroed, only
+// the last page of existing data may need to be read first, once.
+//
+// Preconditions: rw.c.dataMu must be locked. gapmr must be a non-empty subset
+// of gap.Range().
+func (rw *inodeReadWriter) maybeCacheWrite(gap FileRangeGapIterator, gapmr memmap.MappableRange) bool {
+	c := rw.c
+	mf := c.mfp.MemoryFile()
+	if !c.opts.WriteBack || c.useHostPageCache() || !mf.ShouldCacheEvictable() || gapmr.Length() > maxBufferedWrite {
+		return false
+	}
+	lastPage := uint64(usermem.Addr(c.attr.Size).RoundDown())
+	if gapmr.Start < lastPage {
+		return false
+	}
+	mr := memmap.MappableRange{
+		Start: lastPage,
+		End:   lastPage + usermem.PageSize,
+	}
+	if gapmr.Start >= mr.End || lastPage == uint64(c.attr.Size) {
+		// No existing data is overwritten.
+		mr = memmap.MappableRange{
+			Start: uint64(usermem.Addr(gapmr.Start).RoundDown()),
+			End:   fs.OffsetPageEnd(int64(gapmr.End)),
+		}
+		fr, err := mf.Allocate(mr.Length(), usage.PageCache)
+		if err != nil {
+			return false
+		}
+		c.cache.Insert(gap, mr, fr.Start)
+	} else if err := c.cache.Fill(rw.ctx, mr, mr, mf, usage.PageCache, c.backingFile.ReadToBlocksAt); err != nil && !c.cache.FindSegment(mr.Start).Ok() {
+		return false
+	}
+	mf.MarkEvictable(c, pgalloc.EvictableRange{mr.Start, mr.End})
+	return true
+}
+
+// maybeWriteBack writes back all dirty data once enough has been written to
+// the cache since the last write back, bounding the amount of buffered data
+// while batching it into large writes to the backing file.
+//
+// Preconditions: rw.c.dataMu must be locked.
+func (rw *inodeReadWriter) maybeWriteBack() {
+	if rw.c.writeBackPending < maxWriteBackPending {
+		return
+	}
+	rw.c.writeBackPending = 0
+	if err := SyncDirtyAll(rw.ctx, &rw.c.cache, &rw.c.dirty, uint64(rw.c.attr.Size), rw.c.mfp.MemoryFile(), rw.c.backingFile.WriteFromBlocksAt); err != nil {
+		// The data remains dirty, so WriteOut will retry writing it back
+		// and return the error if it persists.
+		log.Warningf("Failed to writeback cached data: %v", err)
+	}
+}
+
+// StartWriteBack begins writing back dirty data in [start, end) on another
+// goroutine, for sync_file_range(SYNC_FILE_RANGE_WRITE). ctx must be usable
+// from that goroutine. Errors are dropped; the data remains dirty, so WriteOut
+// will retry writing it back and return the error if it persists.
+func (c *CachingInodeOperations) StartWriteBack(ctx context.Context, start, end int64) {
+	c.dataMu.RLock()
+	clean := c.dirty.IsEmpty()
+	c.dataMu.RUnlock()
+	if clean {
+		return
+	}
+	fs.Async(func() {
+		c.dataMu.Lock()
+		defer c.dataMu.Unlock()
+		size := c.attr.Size
+		if end > size {
+			end = size
+		}
+		if start >= end {
+			return
+		}
+		mr := memmap.MappableRange{
+			Start: uint64(usermem.Addr(start).RoundDown()),
+			End:   fs.OffsetPageEnd(end),
+		}
+		if err := SyncDirty(ctx, mr, &c.cache, &c.dirty, uint64(size), c.mfp.MemoryFile(), c.backingFile.WriteFromBlocksAt); err != nil {
+			log.Warningf("Failed to writeback cached data %v: %v", mr, err)
+		}
+	})
+}
+
 // useHostPageCache returns true if c uses c.backingFile.FD() for all file I/O
 // and memory mappings, and false if c.cache may contain data cached from
 // c.backingFile.
@@ -916,22 +1051,104 @@ func (c *CachingInodeOperations) Translate(ctx context.Context, required, option
 	return ts, nil
 }
 
+const (
+	// defaultReadahead is the number of bytes filled by cache misses that do
+	// not continue a sequential read.
+	defaultReadahead = 64 << 10 // 64 KB, chosen arbitrarily
+
+	// maxReadahead is the largest number of bytes filled by a cache miss
+	// during a sequential read.
+	maxReadahead = 2 << 20 // 2 MB, chosen arbitrarily
+
+	// maxBufferedWrite is the largest write that may be buffered in the cache
+	// if CachingInodeOperationsOptions.WriteBack is true. Larger writes are
+	// efficient enough when written through.
+	maxBufferedWrite = 64 << 10
+
+	// maxWriteBackPending is the number of bytes that may be written to the
+	// cache before dirty data is written back by a write.
+	maxWriteBackPending = 4 << 20
+)
+
 func maxFillRange(required, optional memmap.MappableRange) memmap.MappableRange {
-	const maxReadahead = 64 << 10 // 64 KB, chosen arbitrarily
-	if required.Length() >= maxReadahead {
+	return fillRange(required, optional, defaultReadahead)
+}
+
+// fillRange returns the subset of optional to fill for a cache miss in
+// required, reading at most readahead bytes unless required is longer.
+func fillRange(required, optional memmap.MappableRange, readahead uint64) memmap.MappableRange {
+	if required.Length() >= readahead {
 		return required
 	}
-	if optional.Length() <= maxReadahead {
+	if optional.Length() <= readahead {
 		return optional
 	}
 	optional.Start = required.Start
-	if optional.Length() <= maxReadahead {
+	if optional.Length() <= readahead {
 		return optional
 	}
-	optional.End = optional.Start + maxReadahead
+	optional.End = optional.Start + readahead
 	return optional
 }
 
+// readaheadRangeLocked returns the subset of optional to fill for a read at
+// offset that missed the cache in required. Sequential reads grow the
+// readahead window exponentially, as Linux's mm/readahead.c does, so that
+// streaming a file makes few large reads from the backing file instead of
+// one per defaultReadahead bytes.
+//
+// Preconditions: c.dataMu must be locked for writing.
+func (c *CachingInodeOperations) readaheadRangeLocked(offset int64, required, optional memmap.MappableRange) memmap.MappableRange {
+	if offset != c.readaheadNext || c.readaheadWindow == 0 {
+		c.readaheadWindow = defaultReadahead
+	} else if c.readaheadWindow < maxReadahead {
+		c.readaheadWindow *= 2
+	}
+	return fillRange(required, optional, c.readaheadWindow)
+}
+
+// Readahead fills the cache with up to length bytes of the file starting at
+// offset, for readahead(2) and posix_fadvise(POSIX_FADV_WILLNEED). It does
+// nothing if reads bypass the cache. As with Linux, readahead is only a hint,
+// so errors are dropped.
+func (c *CachingInodeOperations) Readahead(ctx context.Context, offset, length int64) {
+	mem := c.mfp.MemoryFile()
+	if c.useHostPageCache() || !mem.ShouldCacheEvictable() || offset < 0 {
+		return
+	}
+	end := offset + length
+	if end < offset {
+		end = math.MaxInt64
+	}
+	// Fill at most maxReadahead bytes at a time, so that reads of the file
+	// are not blocked behind the whole readahead.
+	for offset < end {
+		c.dataMu.Lock()
+		if end > c.attr.Size {
+			end = c.attr.Size
+		}
+		if offset >= end {
+			c.dataMu.Unlock()
+			return
+		}
+		chunkEnd := end
+		if chunkEnd-offset > maxReadahead {
+			chunkEnd = offset + maxReadahead
+		}
+		mr := memmap.MappableRange{
+			Start: uint64(usermem.Addr(offset).RoundDown()),
+			End:   fs.OffsetPageEnd(chunkEnd),
+		}
+		err := c.cache.Fill(ctx, mr, mr, mem, usage.PageCache, c.backingFile.ReadToBlocksAt)
+		mem.MarkEvictable(c, pgalloc.EvictableRange{mr.Start, mr.End})
+		c.dataMu.Unlock()
+		if err != nil {
+			return
+		}
+		offset = chunkEnd
+	}
+}
+
 // InvalidateUnsavable implements memmap.Mappable.InvalidateUnsavable.
 func (c *CachingInodeOperations) InvalidateUnsavable(ctx context.Context) error {
 	// Whether we have a host fd (and consequently what platform.File is
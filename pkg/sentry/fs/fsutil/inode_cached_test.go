@@ -17,14 +17,17 @@ package fsutil
 import (
 	"bytes"
 	"io"
+	"os"
 	"testing"
 
 	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/memutil"
 	"gvisor.dev/gvisor/pkg/safemem"
 	"gvisor.dev/gvisor/pkg/sentry/contexttest"
 	"gvisor.dev/gvisor/pkg/sentry/fs"
 	ktime "gvisor.dev/gvisor/pkg/sentry/kernel/time"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
 	"gvisor.dev/gvisor/pkg/syserror"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
@@ -387,3 +390,89 @@ func TestWrite(t *testing.T) {
 		t.Errorf("File contents are %v, want %v", buf, want)
 	}
 }
+
+type countingBackingFile struct {
+	*sliceBackingFile
+	writes int
+}
+
+func (f *countingBackingFile) WriteFromBlocksAt(ctx context.Context, srcs safemem.BlockSeq, offset uint64) (uint64, error) {
+	f.writes++
+	return f.sliceBackingFile.WriteFromBlocksAt(ctx, srcs, offset)
+}
+
+type testMemoryFileProvider struct {
+	mf *pgalloc.MemoryFile
+}
+
+// MemoryFile implements pgalloc.MemoryFileProvider.MemoryFile.
+func (p testMemoryFileProvider) MemoryFile() *pgalloc.MemoryFile {
+	return p.mf
+}
+
+func TestWriteBack(t *testing.T) {
+	ctx := contexttest.Context(t)
+
+	// Construct a file of 1.5 pages, with room to grow to 4 pages.
+	buf := make([]byte, 4*usermem.PageSize)
+	copy(buf, pagesOf('a', 'a')[:3*usermem.PageSize/2])
+	orig := append([]byte(nil), buf...)
+	backing := &countingBackingFile{sliceBackingFile: newSliceBackingFile(buf)}
+	inode := anonInode(ctx)
+	uattr := fs.UnstableAttr{
+		Size: 3 * usermem.PageSize / 2,
+	}
+
+	// Writes are only buffered if the cache can hold evictable data until it
+	// is needed, which contexttest's MemoryFile does not.
+	const memfileName = "writeback-test-memory"
+	memfd, err := memutil.CreateMemFD(memfileName, 0)
+	if err != nil {
+		t.Fatalf("CreateMemFD got %v, want nil", err)
+	}
+	mf, err := pgalloc.NewMemoryFile(os.NewFile(uintptr(memfd), memfileName), pgalloc.MemoryFileOpts{
+		DelayedEviction: pgalloc.DelayedEvictionManual,
+	})
+	if err != nil {
+		t.Fatalf("NewMemoryFile got %v, want nil", err)
+	}
+	defer mf.Destroy()
+
+	iops := NewCachingInodeOperations(ctx, backing, uattr, CachingInodeOperationsOptions{WriteBack: true})
+	defer iops.Release()
+	iops.mfp = testMemoryFileProvider{mf}
+
+	// Append 1.5 pages in small writes.
+	want := append([]byte(nil), orig...)
+	const writeSize = 128
+	for off := uattr.Size; off < 3*usermem.PageSize; off += writeSize {
+		wbuf := bytes.Repeat([]byte{'b'}, writeSize)
+		n, err := iops.Write(ctx, usermem.BytesIOSequence(wbuf), off)
+		if n != writeSize || err != nil {
+			t.Fatalf("Write got (%d, %v), want (%d, nil)", n, err, writeSize)
+		}
+		copy(want[off:], wbuf)
+	}
+
+	// The writes should have been buffered in the cache.
+	if backing.writes != 0 {
+		t.Errorf("got %d writes to the backing file, want 0", backing.writes)
+	}
+	if !bytes.Equal(buf, orig) {
+		t.Errorf("File contents are %v, want %v", buf, orig)
+	}
+	if got, want := iops.attr.Size, int64(3*usermem.PageSize); got != want {
+		t.Errorf("Size got %d, want %d", got, want)
+	}
+
+	// Sync back to the "backing file" with one write.
+	if err := iops.WriteOut(ctx, inode); err != nil {
+		t.Errorf("Sync got %v, want nil", err)
+	}
+	if backing.writes != 1 {
+		t.Errorf("got %d writes to the backing file, want 1", backing.writes)
+	}
+	if !bytes.Equal(buf, want) {
+		t.Errorf("File contents are %v, want %v", buf, want)
+	}
+}
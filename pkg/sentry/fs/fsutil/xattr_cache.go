@@ -0,0 +1,125 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package fsutil
+
+import (
+	"gvisor.dev/gvisor/pkg/sync"
+	"gvisor.dev/gvisor/pkg/syserror"
+)
+
+// XattrCache caches the extended attributes of a single remote file, so that
+// repeated getxattr and listxattr calls don't each require a round trip. It is
+// only correct if no other client can change the file's extended attributes.
+//
+// The zero value of XattrCache is an empty cache. XattrCache is not savable;
+// users should not save it, so that it is empty after restore.
+type XattrCache struct {
+	mu sync.Mutex
+
+	// gen is incremented by Invalidate, so that results fetched concurrently
+	// with an invalidation are not cached.
+	gen uint64
+
+	// values maps attribute names to the results of fetching them.
+	values map[string]xattrResult
+
+	// names is the result of listing attributes. It is valid only if
+	// namesCached is true.
+	names       map[string]struct{}
+	namesCached bool
+}
+
+type xattrResult struct {
+	value string
+	err   error
+}
+
+// cacheableXattrError returns true if err is a result of fetching an extended
+// attribute that doesn't depend on the size of the caller's buffer.
+func cacheableXattrError(err error) bool {
+	return err == nil || err == syserror.ENODATA || err == syserror.EOPNOTSUPP
+}
+
+// Get returns the value of the named attribute, calling fetch to get it from
+// the remote file if it isn't cached.
+func (c *XattrCache) Get(name string, fetch func() (string, error)) (string, error) {
+	c.mu.Lock()
+	if r, ok := c.values[name]; ok {
+		c.mu.Unlock()
+		return r.value, r.err
+	}
+	gen := c.gen
+	c.mu.Unlock()
+
+	value, err := fetch()
+	if !cacheableXattrError(err) {
+		return value, err
+	}
+	c.mu.Lock()
+	if c.gen == gen {
+		if c.values == nil {
+			c.values = make(map[string]xattrResult)
+		}
+		c.values[name] = xattrResult{value, err}
+	}
+	c.mu.Unlock()
+	return value, err
+}
+
+// List returns the names of the file's attributes, calling fetch to get them
+// from the remote file if they aren't cached. The returned map is owned by the
+// caller.
+func (c *XattrCache) List(fetch func() (map[string]struct{}, error)) (map[string]struct{}, error) {
+	c.mu.Lock()
+	if c.namesCached {
+		names := copyXattrNames(c.names)
+		c.mu.Unlock()
+		return names, nil
+	}
+	gen := c.gen
+	c.mu.Unlock()
+
+	names, err := fetch()
+	if err != nil {
+		return names, err
+	}
+	c.mu.Lock()
+	if c.gen == gen {
+		c.names = copyXattrNames(names)
+		c.namesCached = true
+	}
+	c.mu.Unlock()
+	return names, nil
+}
+
+// Invalidate discards all cached attributes. It must be called after every
+// attempt to set or remove an attribute of the file, whether or not it
+// succeeded.
+func (c *XattrCache) Invalidate() {
+	c.mu.Lock()
+	c.gen++
+	c.values = nil
+	c.names = nil
+	c.namesCached = false
+	c.mu.Unlock()
+}
+
+func copyXattrNames(names map[string]struct{}) map[string]struct{} {
+	cp := make(map[string]struct{}, len(names))
+	for name := range names {
+		cp[name] = struct{}{}
+	}
+	return cp
+}
@@ -0,0 +1,90 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package fsutil
+
+import (
+	"testing"
+
+	"gvisor.dev/gvisor/pkg/syserror"
+)
+
+func TestXattrCacheGet(t *testing.T) {
+	var c XattrCache
+	fetches := 0
+	get := func(name string, value string, err error) (string, error) {
+		return c.Get(name, func() (string, error) {
+			fetches++
+			return value, err
+		})
+	}
+
+	for _, test := range []struct {
+		name        string
+		err         error
+		wantFetches int
+	}{
+		{"user.value", nil, 1},
+		{"user.missing", syserror.ENODATA, 1},
+		{"user.unsupported", syserror.EOPNOTSUPP, 1},
+		// ERANGE depends on the caller's size hint and must not be cached.
+		{"user.large", syserror.ERANGE, 2},
+	} {
+		fetches = 0
+		for i := 0; i < 2; i++ {
+			if _, err := get(test.name, "x", test.err); err != test.err {
+				t.Errorf("Get(%q) returned error %v, want %v", test.name, err, test.err)
+			}
+		}
+		if fetches != test.wantFetches {
+			t.Errorf("Get(%q) twice fetched %d times, want %d", test.name, fetches, test.wantFetches)
+		}
+	}
+
+	c.Invalidate()
+	fetches = 0
+	if v, err := get("user.value", "y", nil); v != "y" || err != nil || fetches != 1 {
+		t.Errorf("Get after Invalidate = (%q, %v) with %d fetches, want (\"y\", nil) with 1 fetch", v, err, fetches)
+	}
+}
+
+func TestXattrCacheList(t *testing.T) {
+	var c XattrCache
+	fetches := 0
+	list := func() (map[string]struct{}, error) {
+		return c.List(func() (map[string]struct{}, error) {
+			fetches++
+			return map[string]struct{}{"user.a": {}, "user.b": {}}, nil
+		})
+	}
+
+	names, err := list()
+	if err != nil || len(names) != 2 {
+		t.Fatalf("List = (%v, %v), want 2 names", names, err)
+	}
+	// The caller owns the returned map.
+	delete(names, "user.a")
+	names, err = list()
+	if err != nil || len(names) != 2 {
+		t.Errorf("List after deleting from a previous result = (%v, %v), want 2 names", names, err)
+	}
+	if fetches != 1 {
+		t.Errorf("List twice fetched %d times, want 1", fetches)
+	}
+
+	c.Invalidate()
+	if _, err := list(); err != nil || fetches != 2 {
+		t.Errorf("List after Invalidate fetched %d times in total (err %v), want 2", fetches, err)
+	}
+}
@@ -90,6 +90,11 @@ func (cp cachePolicy) cacheReaddir() bool {
 	return cp == cacheAll || cp == cacheAllWritethrough
 }
 
+// cacheXattrs determines whether extended attributes should be cached.
+func (cp cachePolicy) cacheXattrs() bool {
+	return cp == cacheAll || cp == cacheAllWritethrough
+}
+
 // useCachingInodeOps determines whether the page cache should be used for the
 // given inode. If the remote filesystem donates host FDs to the sentry, then
 // the host kernel's page cache will be used, otherwise we will use a
@@ -64,6 +64,12 @@ type fileOperations struct {
 
 	// flags are the flags used to open handles.
 	flags fs.FileFlags `state:"wait"`
+
+	// readdirCache holds the directory entries fetched when this file last
+	// read the directory from its start, if the cache policy doesn't allow
+	// caching them on the inode. It is protected by
+	// inodeOperations.readdirMu.
+	readdirCache *fs.SortedDentryMap `state:"nosave"`
 }
 
 // fileOperations implements fs.FileOperations.
@@ -141,19 +147,33 @@ func (f *fileOperations) IterateDir(ctx context.Context, d *fs.Dirent, dirCtx *f
 	f.inodeOperations.readdirMu.Lock()
 	defer f.inodeOperations.readdirMu.Unlock()
 
-	// Fetch directory entries if needed.
-	if !f.inodeOperations.session().cachePolicy.cacheReaddir() || f.inodeOperations.readdirCache == nil {
-		entries, err := f.readdirAll(ctx)
+	// Fetch directory entries if needed. If they can't be cached on the
+	// inode, fetch them when reading from the start of the directory (after
+	// "." and "..") and keep them on the file for the rest of the listing, so
+	// that each getdents call doesn't fetch the whole directory again.
+	var entries *fs.SortedDentryMap
+	if f.inodeOperations.session().cachePolicy.cacheReaddir() {
+		entries = f.inodeOperations.readdirCache
+	} else if offset > 2 {
+		entries = f.readdirCache
+	}
+	if entries == nil {
+		m, err := f.readdirAll(ctx)
 		if err != nil {
 			return offset, err
 		}
 
 		// Cache the readdir result.
-		f.inodeOperations.readdirCache = fs.NewSortedDentryMap(entries)
+		entries = fs.NewSortedDentryMap(m)
+		if f.inodeOperations.session().cachePolicy.cacheReaddir() {
+			f.inodeOperations.readdirCache = entries
+		} else {
+			f.readdirCache = entries
+		}
 	}
 
 	// Serialize the entries.
-	n, err := fs.GenericReaddir(dirCtx, f.inodeOperations.readdirCache)
+	n, err := fs.GenericReaddir(dirCtx, entries)
 	return offset + n, err
 }
 
@@ -162,9 +182,9 @@ func (f *fileOperations) readdirAll(ctx context.Context) (map[string]fs.DentAttr
 	entries := make(map[string]fs.DentAttr)
 	var readOffset uint64
 	for {
-		// We choose some arbitrary high number of directory entries (64k) and call
+		// Fetch as many directory entries per RPC as fit in a message, and call
 		// Readdir until we've exhausted them all.
-		dirents, err := f.handles.File.readdir(ctx, readOffset, 64*1024)
+		dirents, err := f.handles.File.readdir(ctx, readOffset, f.inodeOperations.session().client.PayloadSize())
 		if err != nil {
 			return nil, err
 		}
@@ -308,6 +328,36 @@ func (f *fileOperations) Read(ctx context.Context, file *fs.File, dst usermem.IO
 	return n, err
 }
 
+// Readahead implements fs.Readaheader.Readahead.
+func (f *fileOperations) Readahead(ctx context.Context, file *fs.File, offset, length int64) {
+	if f.inodeOperations.session().cachePolicy.useCachingInodeOps(file.Dirent.Inode) {
+		f.inodeOperations.cachingInodeOps.Readahead(ctx, offset, length)
+	}
+}
+
+// StartWriteBack implements fs.WriteBackStarter.StartWriteBack.
+func (f *fileOperations) StartWriteBack(ctx context.Context, file *fs.File, start, end int64) {
+	if f.inodeOperations.session().cachePolicy.useCachingInodeOps(file.Dirent.Inode) {
+		f.inodeOperations.cachingInodeOps.StartWriteBack(ctx, start, end)
+	}
+}
+
+// HostFD implements fs.HostFileBacked.HostFD.
+func (f *fileOperations) HostFD(file *fs.File) (int, bool) {
+	// Write syncs data written to files opened with O_SYNC, O_DSYNC or
+	// O_DIRECT, which copies made by the host would skip.
+	flags := file.Flags()
+	if flags.Sync || flags.DSync || flags.Direct {
+		return -1, false
+	}
+	// Only files whose reads and writes go straight to the host FD qualify;
+	// see Read and Write.
+	if f.inodeOperations.session().cachePolicy.useCachingInodeOps(file.Dirent.Inode) || f.inodeOperations.fileState.hostMappable != nil || f.handles.Host == nil {
+		return -1, false
+	}
+	return f.handles.Host.FD(), true
+}
+
 // Fsync implements fs.FileOperations.Fsync.
 func (f *fileOperations) Fsync(ctx context.Context, file *fs.File, start, end int64, syncType fs.SyncType) error {
 	switch syncType {
@@ -25,6 +25,7 @@ import (
 	"gvisor.dev/gvisor/pkg/safemem"
 	"gvisor.dev/gvisor/pkg/secio"
 	"gvisor.dev/gvisor/pkg/sentry/fs"
+	"gvisor.dev/gvisor/pkg/sentry/hostfd"
 )
 
 // handles are the open handles of a gofer file. They are reference counted to
@@ -109,13 +110,20 @@ func (h *handles) readWriterAt(ctx context.Context, offset int64) *handleReadWri
 
 // ReadToBlocks implements safemem.Reader.ReadToBlocks.
 func (rw *handleReadWriter) ReadToBlocks(dsts safemem.BlockSeq) (uint64, error) {
-	var r io.Reader
+	if dsts.IsEmpty() {
+		return 0, nil
+	}
 	if rw.h.Host != nil {
-		r = secio.NewOffsetReader(rw.h.Host, rw.off)
-	} else {
-		r = &p9.ReadWriterFile{File: rw.h.File.file, Offset: uint64(rw.off)}
+		// Read directly into dsts with a single host syscall, rather than
+		// through a bounce buffer one block at a time.
+		rw.ctx.UninterruptibleSleepStart(false)
+		n, err := hostfd.Preadv2(int32(rw.h.Host.FD()), dsts, rw.off, 0 /* flags */)
+		rw.ctx.UninterruptibleSleepFinish(false)
+		rw.off += int64(n)
+		return n, err
 	}
 
+	r := &p9.ReadWriterFile{File: rw.h.File.file, Offset: uint64(rw.off)}
 	rw.ctx.UninterruptibleSleepStart(false)
 	defer rw.ctx.UninterruptibleSleepFinish(false)
 	n, err := safemem.FromIOReader{r}.ReadToBlocks(dsts)
@@ -134,7 +142,51 @@ func (rw *handleReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, erro
 
 	rw.ctx.UninterruptibleSleepStart(false)
 	defer rw.ctx.UninterruptibleSleepFinish(false)
-	n, err := safemem.FromIOWriter{w}.WriteFromBlocks(srcs)
+	var (
+		n   uint64
+		err error
+	)
+	if srcs.NumBlocks() > 1 {
+		// Gather multiple blocks, such as dirty pages written back from the
+		// page cache, into one write rather than making a host syscall or
+		// gofer RPC for each.
+		n, err = writeGathered(w, srcs)
+	} else {
+		n, err = safemem.FromIOWriter{w}.WriteFromBlocks(srcs)
+	}
 	rw.off += int64(n)
 	return n, err
 }
+
+// maxGatheredWrite is the largest write made by writeGathered.
+const maxGatheredWrite = 1 << 20
+
+// writeGathered writes srcs to w, copying them into a buffer so that each call
+// to w.Write writes up to maxGatheredWrite bytes.
+func writeGathered(w io.Writer, srcs safemem.BlockSeq) (uint64, error) {
+	var (
+		buf  []byte
+		done uint64
+	)
+	for !srcs.IsEmpty() {
+		chunk := srcs.TakeFirst64(maxGatheredWrite)
+		if buf == nil {
+			buf = make([]byte, chunk.NumBytes())
+		}
+		dst := buf[:chunk.NumBytes()]
+		cn, cerr := safemem.CopySeq(safemem.BlockSeqOf(safemem.BlockFromSafeSlice(dst)), chunk)
+		wn, werr := w.Write(dst[:cn])
+		done += uint64(wn)
+		if werr != nil {
+			return done, werr
+		}
+		if cerr != nil {
+			return done, cerr
+		}
+		if uint64(wn) != chunk.NumBytes() {
+			return done, nil
+		}
+		srcs = srcs.DropFirst64(uint64(wn))
+	}
+	return done, nil
+}
@@ -57,6 +57,9 @@ type inodeOperations struct {
 	// Starts out as nil, and is initialized under readdirMu lazily;
 	// invalidating the cache means setting it to nil.
 	readdirCache *fs.SortedDentryMap `state:"nosave"`
+
+	// xattrCache caches extended attributes if the cache policy allows it.
+	xattrCache fsutil.XattrCache `state:"nosave"`
 }
 
 // inodeFileState implements fs.CachedFileObject and otherwise fully
@@ -605,21 +608,33 @@ func (i *inodeOperations) Truncate(ctx context.Context, inode *fs.Inode, length
 
 // GetXattr implements fs.InodeOperations.GetXattr.
 func (i *inodeOperations) GetXattr(ctx context.Context, _ *fs.Inode, name string, size uint64) (string, error) {
-	return i.fileState.file.getXattr(ctx, name, size)
+	if !i.session().cachePolicy.cacheXattrs() {
+		return i.fileState.file.getXattr(ctx, name, size)
+	}
+	return i.xattrCache.Get(name, func() (string, error) {
+		return i.fileState.file.getXattr(ctx, name, size)
+	})
 }
 
 // SetXattr implements fs.InodeOperations.SetXattr.
 func (i *inodeOperations) SetXattr(ctx context.Context, _ *fs.Inode, name string, value string, flags uint32) error {
+	defer i.xattrCache.Invalidate()
 	return i.fileState.file.setXattr(ctx, name, value, flags)
 }
 
 // ListXattr implements fs.InodeOperations.ListXattr.
 func (i *inodeOperations) ListXattr(ctx context.Context, _ *fs.Inode, size uint64) (map[string]struct{}, error) {
-	return i.fileState.file.listXattr(ctx, size)
+	if !i.session().cachePolicy.cacheXattrs() {
+		return i.fileState.file.listXattr(ctx, size)
+	}
+	return i.xattrCache.List(func() (map[string]struct{}, error) {
+		return i.fileState.file.listXattr(ctx, size)
+	})
 }
 
 // RemoveXattr implements fs.InodeOperations.RemoveXattr.
 func (i *inodeOperations) RemoveXattr(ctx context.Context, _ *fs.Inode, name string) error {
+	defer i.xattrCache.Invalidate()
 	return i.fileState.file.removeXattr(ctx, name)
 }
 
@@ -278,6 +278,7 @@ func newInodeOperations(ctx context.Context, s *session, file contextFile, qid p
 		cachingInodeOps: fsutil.NewCachingInodeOperations(ctx, fileState, uattr, fsutil.CachingInodeOperationsOptions{
 			ForcePageCache:         s.superBlockFlags.ForcePageCache,
 			LimitHostFDTranslation: s.limitHostFDTranslation,
+			WriteBack:              s.cachePolicy == cacheAll,
 		}),
 	}
 }
@@ -250,6 +250,14 @@ func (f *fileOperations) Read(ctx context.Context, file *fs.File, dst usermem.IO
 	return f.iops.cachingInodeOps.Read(ctx, file, dst, offset)
 }
 
+// HostFD implements fs.HostFileBacked.HostFD.
+func (f *fileOperations) HostFD(file *fs.File) (int, bool) {
+	if f.iops.ReturnsWouldBlock() || file.Dirent.Inode.MountSource.Flags.ForcePageCache {
+		return -1, false
+	}
+	return f.iops.fileState.FD(), true
+}
+
 // Fsync implements fs.FileOperations.Fsync.
 func (f *fileOperations) Fsync(ctx context.Context, file *fs.File, start int64, end int64, syncType fs.SyncType) error {
 	switch syncType {
@@ -324,3 +324,13 @@ type InodeOperations interface {
 	// it will), then ENOSYS should be returned.
 	StatFS(context.Context) (Info, error)
 }
+
+// TmpfileCreator is an interface for directories that can create unnamed
+// regular files, as requested by open(O_TMPFILE).
+type TmpfileCreator interface {
+	// CreateTmpfile creates a regular file with no links in the directory
+	// dir, and returns it opened with flags. If linkable is true, the file
+	// may later be given a name with linkat(2); otherwise, as for
+	// O_TMPFILE|O_EXCL, it is discarded when its last reference is dropped.
+	CreateTmpfile(ctx context.Context, dir *Inode, flags FileFlags, perms FilePermissions, linkable bool) (*File, error)
+}
@@ -16,7 +16,6 @@ package fs
 
 import (
 	"fmt"
-	"strings"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/context"
@@ -30,6 +29,11 @@ func overlayHasWhiteout(ctx context.Context, parent *Inode, name string) bool {
 	return err == nil && s == "y"
 }
 
+func overlayHasMetacopy(ctx context.Context, inode *Inode) bool {
+	s, err := inode.GetXattr(ctx, XattrOverlayMetacopy, 1)
+	return err == nil && s == "y"
+}
+
 func overlayCreateWhiteout(ctx context.Context, parent *Inode, name string) error {
 	return parent.InodeOperations.SetXattr(ctx, parent, XattrOverlayWhiteout(name), "y", 0 /* flags */)
 }
@@ -171,6 +175,7 @@ func overlayLookup(ctx context.Context, parent *overlayEntry, inode *Inode, name
 	// Did we find a lower Inode? Remember this because we may decide we don't
 	// actually need the lower Inode (see below).
 	lowerExists := lowerInode != nil
+	lowerData := false
 
 	// If we found something in the upper filesystem and the lower filesystem,
 	// use the stable attributes from the lower filesystem. If we don't do this,
@@ -181,8 +186,11 @@ func overlayLookup(ctx context.Context, parent *overlayEntry, inode *Inode, name
 
 		// For non-directories, the lower filesystem resource is strictly
 		// unnecessary because we don't need to copy-up and we will always
-		// operate (e.g. read/write) on the upper Inode.
-		if !IsDir(upperInode.StableAttr) {
+		// operate (e.g. read/write) on the upper Inode, unless only the
+		// metadata of a regular file has been copied up.
+		if upperInode.StableAttr.Type == RegularFile && overlayHasMetacopy(ctx, upperInode) {
+			lowerData = true
+		} else if !IsDir(upperInode.StableAttr) {
 			lowerInode.DecRef()
 			lowerInode = nil
 		}
@@ -202,6 +210,7 @@ func overlayLookup(ctx context.Context, parent *overlayEntry, inode *Inode, name
 		parent.copyMu.RUnlock()
 		return nil, false, err
 	}
+	entry.lowerData = lowerData
 	d, err := NewDirent(ctx, newOverlayInode(ctx, entry, inode.MountSource), name), nil
 	parent.copyMu.RUnlock()
 	return d, upperInode != nil, err
@@ -489,7 +498,7 @@ func overlayGetFile(ctx context.Context, o *overlayEntry, d *Dirent, flags FileF
 
 	o.copyMu.RLock()
 
-	if o.upper != nil {
+	if o.upper != nil && !o.lowerData {
 		upper, err := overlayFile(ctx, o.upper, flags)
 		if err != nil {
 			o.copyMu.RUnlock()
@@ -539,7 +548,7 @@ func overlayGetXattr(ctx context.Context, o *overlayEntry, name string, size uin
 
 	// Don't forward the value of the extended attribute if it would
 	// unexpectedly change the behavior of a wrapping overlay layer.
-	if strings.HasPrefix(XattrOverlayPrefix, name) {
+	if isXattrOverlay(name) {
 		return "", syserror.ENODATA
 	}
 
@@ -555,7 +564,7 @@ func overlayGetXattr(ctx context.Context, o *overlayEntry, name string, size uin
 
 func overlaySetxattr(ctx context.Context, o *overlayEntry, d *Dirent, name, value string, flags uint32) error {
 	// Don't allow changes to overlay xattrs through a setxattr syscall.
-	if strings.HasPrefix(XattrOverlayPrefix, name) {
+	if isXattrOverlay(name) {
 		return syserror.EPERM
 	}
 
@@ -578,7 +587,7 @@ func overlayListXattr(ctx context.Context, o *overlayEntry, size uint64) (map[st
 	for name := range names {
 		// Same as overlayGetXattr, we shouldn't forward along
 		// overlay attributes.
-		if strings.HasPrefix(XattrOverlayPrefix, name) {
+		if isXattrOverlay(name) {
 			delete(names, name)
 		}
 	}
@@ -587,7 +596,7 @@ func overlayListXattr(ctx context.Context, o *overlayEntry, size uint64) (map[st
 
 func overlayRemoveXattr(ctx context.Context, o *overlayEntry, d *Dirent, name string) error {
 	// Don't allow changes to overlay xattrs through a removexattr syscall.
-	if strings.HasPrefix(XattrOverlayPrefix, name) {
+	if isXattrOverlay(name) {
 		return syserror.EPERM
 	}
 
@@ -611,21 +620,21 @@ func overlayCheck(ctx context.Context, o *overlayEntry, p PermMask) error {
 }
 
 func overlaySetPermissions(ctx context.Context, o *overlayEntry, d *Dirent, f FilePermissions) bool {
-	if err := copyUp(ctx, d); err != nil {
+	if err := copyUpMetadata(ctx, d); err != nil {
 		return false
 	}
 	return o.upper.InodeOperations.SetPermissions(ctx, o.upper, f)
 }
 
 func overlaySetOwner(ctx context.Context, o *overlayEntry, d *Dirent, owner FileOwner) error {
-	if err := copyUp(ctx, d); err != nil {
+	if err := copyUpMetadata(ctx, d); err != nil {
 		return err
 	}
 	return o.upper.InodeOperations.SetOwner(ctx, o.upper, owner)
 }
 
 func overlaySetTimestamps(ctx context.Context, o *overlayEntry, d *Dirent, ts TimeSpec) error {
-	if err := copyUp(ctx, d); err != nil {
+	if err := copyUpMetadata(ctx, d); err != nil {
 		return err
 	}
 	return o.upper.InodeOperations.SetTimestamps(ctx, o.upper, ts)
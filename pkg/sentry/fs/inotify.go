@@ -29,6 +29,11 @@ import (
 	"gvisor.dev/gvisor/pkg/waiter"
 )
 
+// maxQueuedEvents is the maximum number of events queued by an inotify
+// instance, after which an IN_Q_OVERFLOW event is queued. This is the default
+// value of Linux's /proc/sys/fs/inotify/max_queued_events.
+const maxQueuedEvents = 16384
+
 // Inotify represents an inotify instance created by inotify_init(2) or
 // inotify_init1(2). Inotify implements the FileOperations interface.
 //
@@ -53,6 +58,11 @@ type Inotify struct {
 	// A list of pending events for this inotify instance. Protected by evMu.
 	events eventList
 
+	// numEvents is the number of events in events, and eventsSize is their
+	// total size as read by read(2). Protected by evMu.
+	numEvents  int
+	eventsSize int
+
 	// A scratch buffer, use to serialize inotify events. Use allocate this
 	// ahead of time and reuse performance. Protected by evMu.
 	scratch []byte
@@ -162,6 +172,8 @@ func (i *Inotify) Read(ctx context.Context, _ *File, dst usermem.IOSequence, _ i
 		// buffer space to copy it out, even if the copy below fails. Emulate
 		// this behaviour.
 		i.events.Remove(event)
+		i.numEvents--
+		i.eventsSize -= event.sizeOf()
 
 		// Buffer has enough space, copy event to the read buffer.
 		n, err := event.CopyTo(ctx, i.scratch, dst)
@@ -211,12 +223,8 @@ func (i *Inotify) Ioctl(ctx context.Context, _ *File, io usermem.IO, args arch.S
 	case linux.FIONREAD:
 		i.evMu.Lock()
 		defer i.evMu.Unlock()
-		var n uint32
-		for e := i.events.Front(); e != nil; e = e.Next() {
-			n += uint32(e.sizeOf())
-		}
 		var buf [4]byte
-		usermem.ByteOrder.PutUint32(buf[:], n)
+		usermem.ByteOrder.PutUint32(buf[:], uint32(i.eventsSize))
 		_, err := io.CopyOut(ctx, args[2].Pointer(), buf[:], usermem.IOOpts{})
 		return 0, err
 
@@ -225,22 +233,42 @@ func (i *Inotify) Ioctl(ctx context.Context, _ *File, io usermem.IO, args arch.S
 	}
 }
 
-func (i *Inotify) queueEvent(ev *Event) {
+// queueEvent queues an event for watch descriptor wd with the given name, mask
+// and cookie.
+//
+// As in Linux, the event is dropped if it is identical to the last queued
+// event, and a single IN_Q_OVERFLOW event is queued in place of events past
+// maxQueuedEvents.
+func (i *Inotify) queueEvent(wd int32, name string, mask, cookie uint32) {
 	i.evMu.Lock()
 
-	// Check if we should coalesce the event we're about to queue with the last
-	// one currently in the queue. Events are coalesced if they are identical.
-	if last := i.events.Back(); last != nil {
-		if ev.equals(last) {
-			// "Coalesce" the two events by simply not queuing the new one. We
-			// don't need to raise a waiter.EventIn notification because no new
-			// data is available for reading.
+	if i.numEvents >= maxQueuedEvents {
+		if i.numEvents > maxQueuedEvents {
+			// The overflow event has already been queued.
 			i.evMu.Unlock()
 			return
 		}
+		// Queue an overflow event instead, unless one is already last in
+		// the queue.
+		wd, name, mask, cookie = -1, "", linux.IN_Q_OVERFLOW, 0
+	}
+
+	// Check if we should coalesce the event we're about to queue with the last
+	// one currently in the queue. This is checked before allocating the event,
+	// since watchers that fall behind see long runs of identical events, such
+	// as IN_MODIFY for each write to a file.
+	if last := i.events.Back(); last != nil && last.matches(wd, name, mask, cookie) {
+		// "Coalesce" the two events by simply not queuing the new one. We
+		// don't need to raise a waiter.EventIn notification because no new
+		// data is available for reading.
+		i.evMu.Unlock()
+		return
 	}
 
+	ev := newEvent(wd, name, mask, cookie)
 	i.events.PushBack(ev)
+	i.numEvents++
+	i.eventsSize += ev.sizeOf()
 
 	// Release mutex before notifying waiters because we don't control what they
 	// can do.
@@ -282,7 +310,7 @@ func (i *Inotify) targetDestroyed(w *Watch) {
 	i.mu.Unlock()
 
 	if found {
-		i.queueEvent(newEvent(w.wd, "", linux.IN_IGNORED, 0))
+		i.queueEvent(w.wd, "", linux.IN_IGNORED, 0)
 	}
 }
 
@@ -343,7 +371,7 @@ func (i *Inotify) RmWatch(wd int32) error {
 	i.mu.Unlock()
 
 	// Generate the event for the removal.
-	i.queueEvent(newEvent(watch.wd, "", linux.IN_IGNORED, 0))
+	i.queueEvent(watch.wd, "", linux.IN_IGNORED, 0)
 
 	// Remove all pins.
 	watch.destroy()
@@ -15,7 +15,6 @@
 package fs
 
 import (
-	"bytes"
 	"fmt"
 
 	"gvisor.dev/gvisor/pkg/context"
@@ -130,10 +129,15 @@ func (e *Event) CopyTo(ctx context.Context, buf []byte, dst usermem.IOSequence)
 	return int64(writeLen), nil
 }
 
-func (e *Event) equals(other *Event) bool {
-	return e.wd == other.wd &&
-		e.mask == other.mask &&
-		e.cookie == other.cookie &&
-		e.len == other.len &&
-		bytes.Equal(e.name, other.name)
+// matches returns true if e is identical to the event that would be returned
+// by newEvent(wd, name, mask, cookie).
+func (e *Event) matches(wd int32, name string, mask, cookie uint32) bool {
+	if e.wd != wd || e.mask != mask || e.cookie != cookie {
+		return false
+	}
+	if name == "" {
+		return e.len == 0
+	}
+	// e.name is null-terminated and padded with null bytes.
+	return len(e.name) > len(name) && e.name[len(name)] == 0 && string(e.name[:len(name)]) == name
 }
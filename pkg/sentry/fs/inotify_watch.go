@@ -87,7 +87,7 @@ func (w *Watch) Notify(name string, events uint32, cookie uint32) {
 	unmaskableBits := ^uint32(0) &^ linux.IN_ALL_EVENTS
 	effectiveMask := unmaskableBits | mask
 	matchedEvents := effectiveMask & events
-	w.owner.queueEvent(newEvent(w.wd, name, matchedEvents, cookie))
+	w.owner.queueEvent(w.wd, name, matchedEvents, cookie)
 }
 
 // Pin acquires a new ref on dirent, which pins the dirent in memory while
@@ -55,7 +55,6 @@ import (
 	"syscall"
 
 	"gvisor.dev/gvisor/pkg/sync"
-	"gvisor.dev/gvisor/pkg/waiter"
 )
 
 // LockType is a type of regional file lock.
@@ -84,7 +83,7 @@ const (
 const LockEOF = math.MaxUint64
 
 // Lock is a regional file lock.  It consists of either a single writer
-// or a set of readers.
+// or a set of readers. Readers may be nil if there are no readers.
 //
 // A Lock may be upgraded from a read lock to a write lock only if there
 // is a single reader and that reader has the same uid as the write lock.
@@ -117,8 +116,19 @@ type Locks struct {
 	// locks is the set of region locks currently held on an Inode.
 	locks LockSet
 
-	// blockedQueue is the queue of waiters that are waiting on a lock.
-	blockedQueue waiter.Queue `state:"zerovalue"`
+	// blocked is the set of blocked LockRegion calls. Blocked calls are
+	// interrupted before saving, so blocked is always empty when saved.
+	blocked map[*lockWaiter]struct{} `state:"nosave"`
+}
+
+// lockWaiter is a LockRegion call blocked on a conflicting lock.
+type lockWaiter struct {
+	// r is the range that the call is trying to lock. r is immutable.
+	r LockRange
+
+	// ch is notified when a lock that may conflict with r is released or
+	// downgraded. ch is immutable.
+	ch chan struct{}
 }
 
 // Blocker is the interface used for blocking locks. Passing a nil Blocker
@@ -127,13 +137,6 @@ type Blocker interface {
 	Block(C <-chan struct{}) error
 }
 
-const (
-	// EventMaskAll is the mask we will always use for locks, by using the
-	// same mask all the time we can wake up everyone anytime the lock
-	// changes state.
-	EventMaskAll waiter.EventMask = 0xFFFF
-)
-
 // LockRegion attempts to acquire a typed lock for the uid on a region
 // of a file. Returns true if successful in locking the region. If false
 // is returned, the caller should normally interpret this as "try again later" if
@@ -141,25 +144,38 @@ const (
 // Blocker is the interface used to provide blocking behavior, passing a nil Blocker
 // will result in non-blocking behavior.
 func (l *Locks) LockRegion(uid UniqueID, t LockType, r LockRange, block Blocker) bool {
+	var w *lockWaiter
 	for {
 		l.mu.Lock()
 
-		// Blocking locks must run in a loop because we'll be woken up whenever an unlock event
-		// happens for this lock. We will then attempt to take the lock again and if it fails
-		// continue blocking.
+		// Blocking locks must run in a loop because we'll be woken up whenever a
+		// conflicting lock is released. We will then attempt to take the lock
+		// again and if it fails continue blocking.
 		res := l.locks.lock(uid, t, r)
 		if !res && block != nil {
-			e, ch := waiter.NewChannelEntry(nil)
-			l.blockedQueue.EventRegister(&e, EventMaskAll)
+			if w == nil {
+				w = &lockWaiter{r: r, ch: make(chan struct{}, 1)}
+				if l.blocked == nil {
+					l.blocked = make(map[*lockWaiter]struct{})
+				}
+				l.blocked[w] = struct{}{}
+			}
 			l.mu.Unlock()
-			if err := block.Block(ch); err != nil {
+			if err := block.Block(w.ch); err != nil {
 				// We were interrupted, the caller can translate this to EINTR if applicable.
-				l.blockedQueue.EventUnregister(&e)
+				l.removeWaiter(w)
 				return false
 			}
-			l.blockedQueue.EventUnregister(&e)
 			continue // Try again now that someone has unlocked.
 		}
+		if w != nil {
+			delete(l.blocked, w)
+		}
+		if res && t == ReadLock {
+			// Taking a read lock downgrades any write lock held by uid
+			// on r, which may allow other readers to proceed.
+			l.notifyLocked(r)
+		}
 
 		l.mu.Unlock()
 		return res
@@ -174,24 +190,49 @@ func (l *Locks) UnlockRegion(uid UniqueID, r LockRange) {
 	defer l.mu.Unlock()
 	l.locks.unlock(uid, r)
 
-	// Now that we've released the lock, we need to wake up any waiters.
-	l.blockedQueue.Notify(EventMaskAll)
+	// Now that we've released the lock, we need to wake up any waiters
+	// that it may have been blocking.
+	l.notifyLocked(r)
+}
+
+// removeWaiter removes w from l.blocked.
+func (l *Locks) removeWaiter(w *lockWaiter) {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	delete(l.blocked, w)
+}
+
+// notifyLocked wakes blocked LockRegion calls whose ranges overlap r. Calls
+// blocked on other ranges can't have been blocked by locks in r, so they are
+// left asleep.
+//
+// Preconditions: l.mu must be locked.
+func (l *Locks) notifyLocked(r LockRange) {
+	for w := range l.blocked {
+		if !w.r.Overlaps(r) {
+			continue
+		}
+		select {
+		case w.ch <- struct{}{}:
+		default:
+		}
+	}
 }
 
 // makeLock returns a new typed Lock that has either uid as its only reader
 // or uid as its only writer.
 func makeLock(uid UniqueID, t LockType) Lock {
-	value := Lock{Readers: make(map[UniqueID]bool)}
 	switch t {
 	case ReadLock:
-		value.Readers[uid] = true
+		return Lock{Readers: map[UniqueID]bool{uid: true}}
 	case WriteLock:
-		value.HasWriter = true
-		value.Writer = uid
+		// Write locks have no readers, so they don't need a map; this
+		// avoids an allocation per segment for workloads that take many
+		// write locks.
+		return Lock{HasWriter: true, Writer: uid}
 	default:
 		panic(fmt.Sprintf("makeLock: invalid lock type %d", t))
 	}
-	return value
 }
 
 // isHeld returns true if uid is a holder of Lock.
@@ -242,7 +283,7 @@ func (l *Lock) lock(uid UniqueID, t LockType) {
 			}
 		}
 		// Ensure that there is only a writer.
-		l.Readers = make(map[UniqueID]bool)
+		l.Readers = nil
 		l.HasWriter = true
 		l.Writer = uid
 	default:
@@ -58,9 +58,12 @@ func (lockSetFunctions) Merge(r1 LockRange, val1 Lock, r2 LockRange, val2 Lock)
 func (lockSetFunctions) Split(r LockRange, val Lock, split uint64) (Lock, Lock) {
 	// Copy the segment so that split segments don't contain map references
 	// to other segments.
-	val0 := Lock{Readers: make(map[UniqueID]bool)}
-	for k, v := range val.Readers {
-		val0.Readers[k] = v
+	val0 := Lock{}
+	if val.Readers != nil {
+		val0.Readers = make(map[UniqueID]bool, len(val.Readers))
+		for k, v := range val.Readers {
+			val0.Readers[k] = v
+		}
 	}
 	val0.HasWriter = val.HasWriter
 	val0.Writer = val.Writer
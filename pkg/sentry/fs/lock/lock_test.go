@@ -17,6 +17,7 @@ package lock
 import (
 	"reflect"
 	"testing"
+	"time"
 )
 
 type entry struct {
@@ -1057,3 +1058,56 @@ func TestUnlock(t *testing.T) {
 		}
 	}
 }
+
+// testBlocker is a Blocker that reports each time it blocks and is woken.
+type testBlocker struct {
+	blocked chan struct{}
+	woken   chan struct{}
+}
+
+// Block implements Blocker.Block.
+func (b *testBlocker) Block(ch <-chan struct{}) error {
+	b.blocked <- struct{}{}
+	<-ch
+	b.woken <- struct{}{}
+	return nil
+}
+
+// TestLockRegionWakeup checks that releasing a lock only wakes blocked
+// LockRegion calls whose ranges overlap it.
+func TestLockRegionWakeup(t *testing.T) {
+	var l Locks
+	if !l.LockRegion(1, WriteLock, LockRange{0, 10}, nil) {
+		t.Fatalf("LockRegion(1, WriteLock, [0, 10)) failed")
+	}
+	if !l.LockRegion(1, WriteLock, LockRange{20, 30}, nil) {
+		t.Fatalf("LockRegion(1, WriteLock, [20, 30)) failed")
+	}
+
+	b := &testBlocker{
+		blocked: make(chan struct{}, 1),
+		woken:   make(chan struct{}, 1),
+	}
+	done := make(chan bool)
+	go func() {
+		done <- l.LockRegion(2, WriteLock, LockRange{20, 30}, b)
+	}()
+	<-b.blocked
+
+	// Releasing an unrelated lock must not wake the blocked call.
+	l.UnlockRegion(1, LockRange{0, 10})
+	select {
+	case <-b.woken:
+		t.Fatalf("LockRegion blocked on [20, 30) woken by unlock of [0, 10)")
+	case <-time.After(100 * time.Millisecond):
+	}
+
+	l.UnlockRegion(1, LockRange{20, 30})
+	<-b.woken
+	if !<-done {
+		t.Errorf("LockRegion(2, WriteLock, [20, 30)) failed after unlock")
+	}
+	if len(l.blocked) != 0 {
+		t.Errorf("got %d blocked calls after locking, want 0", len(l.blocked))
+	}
+}
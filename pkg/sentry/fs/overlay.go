@@ -68,6 +68,11 @@ const (
 	// XattrOverlayWhiteoutPrefix is the prefix for extended attributes
 	// that indicate that a whiteout exists.
 	XattrOverlayWhiteoutPrefix = XattrOverlayPrefix + "whiteout."
+
+	// XattrOverlayMetacopy is an extended attribute that indicates that a
+	// regular file in the upper filesystem holds only the metadata of the
+	// file, and that its data must still be read from the lower filesystem.
+	XattrOverlayMetacopy = XattrOverlayPrefix + "metacopy"
 )
 
 // XattrOverlayWhiteout returns an extended attribute that indicates a
@@ -197,6 +202,14 @@ type overlayEntry struct {
 	// is required to mutate it.
 	upper *Inode
 
+	// lowerData is true if upper is a metadata-only copy of a regular file
+	// whose data has not yet been copied up, in which case the file's data
+	// is still read from lower. lowerData only ever changes from true to
+	// false.
+	//
+	// lowerData is protected by the same locks as upper.
+	lowerData bool
+
 	// dirCacheMu protects dirCache.
 	dirCacheMu sync.RWMutex `state:"nosave"`
 
@@ -253,7 +266,7 @@ func overlayUpperMountSource(overlayMountSource *MountSource) *MountSource {
 
 // Preconditions: At least one of o.copyMu, o.mapsMu, or o.dataMu must be locked.
 func (o *overlayEntry) inodeLocked() *Inode {
-	if o.upper != nil {
+	if o.upper != nil && !o.lowerData {
 		return o.upper
 	}
 	return o.lower
@@ -16,7 +16,7 @@ package proc
 
 import (
 	"fmt"
-	"sort"
+	"math"
 	"strconv"
 
 	"gvisor.dev/gvisor/pkg/context"
@@ -53,35 +53,43 @@ func walkDescriptors(t *kernel.Task, p string, toInode func(*fs.File, kernel.FDF
 	return toInode(file, fdFlags), nil
 }
 
+// readDescriptorsBatch is the maximum number of fds fetched from the FD table
+// at once by readDescriptors.
+const readDescriptorsBatch = 128
+
 // readDescriptors reads fds in the task starting at offset, and calls the
 // toDentAttr callback for each to get a DentAttr, which it then emits. This is
 // a helper for implementing fs.InodeOperations.Readdir.
 func readDescriptors(t *kernel.Task, c *fs.DirCtx, offset int64, toDentAttr func(int) fs.DentAttr) (int64, error) {
-	var fds []int32
-	t.WithMuLocked(func(t *kernel.Task) {
-		if fdTable := t.FDTable(); fdTable != nil {
-			fds = fdTable.GetFDs()
-		}
-	})
-
-	// Find the appropriate starting point.
-	idx := sort.Search(len(fds), func(i int) bool { return fds[i] >= int32(offset) })
-	if idx == len(fds) {
+	if offset > math.MaxInt32 {
 		return offset, nil
 	}
-	fds = fds[idx:]
-
-	// Serialize all FDs.
-	for _, fd := range fds {
-		name := strconv.FormatUint(uint64(fd), 10)
-		if err := c.DirEmit(name, toDentAttr(int(fd))); err != nil {
-			// Returned offset is the next fd to serialize.
-			return int64(fd), err
+	next := int32(offset)
+	for {
+		// Fetch the fds in batches, so that each readdir costs time
+		// proportional to the number of entries it emits rather than
+		// the size of the table.
+		var fds []int32
+		t.WithMuLocked(func(t *kernel.Task) {
+			if fdTable := t.FDTable(); fdTable != nil {
+				fds = fdTable.GetFDsFrom(next, readDescriptorsBatch)
+			}
+		})
+		if len(fds) == 0 {
+			return int64(next), nil
+		}
+
+		for _, fd := range fds {
+			name := strconv.FormatUint(uint64(fd), 10)
+			if err := c.DirEmit(name, toDentAttr(int(fd))); err != nil {
+				// Returned offset is the next fd to serialize.
+				return int64(fd), err
+			}
 		}
+		// We serialized them all. Next offset should be higher than last
+		// serialized fd.
+		next = fds[len(fds)-1] + 1
 	}
-	// We serialized them all.  Next offset should be higher than last
-	// serialized fd.
-	return int64(fds[len(fds)-1] + 1), nil
 }
 
 // fd implements fs.InodeOperations for a file in /proc/TID/fd/.
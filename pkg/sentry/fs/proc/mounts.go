@@ -134,12 +134,14 @@ func (mif *mountInfoFile) ReadSeqFileData(ctx context.Context, handle seqfile.Se
 		if flags.ReadOnly {
 			opts = "ro"
 		}
-		if flags.NoAtime {
-			opts += ",noatime"
-		}
 		if flags.NoExec {
 			opts += ",noexec"
 		}
+		if flags.NoAtime {
+			opts += ",noatime"
+		} else if !flags.StrictAtime {
+			opts += ",relatime"
+		}
 		fmt.Fprintf(&buf, "%s ", opts)
 
 		// (7) Optional fields: zero or more fields of the form "tag[:value]".
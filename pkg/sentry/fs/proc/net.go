@@ -551,133 +551,155 @@ func writeInetAddr(w io.Writer, family int, i linux.SockAddr) {
 	}
 }
 
-func commonReadSeqFileDataTCP(ctx context.Context, n seqfile.SeqHandle, k *kernel.Kernel, h seqfile.SeqHandle, fa int, header []byte) ([]seqfile.SeqData, int64) {
+// netTCPBatch is the number of sockets read from the socket table for each
+// call to ReadSeqFileData for /proc/net/tcp and /proc/net/tcp6. Like Linux's
+// seq_file, which generates at most a page of records per read(2), this keeps
+// the cost of each read independent of the number of sockets, rather than
+// formatting every socket each time the file is read. Lines are about 150
+// bytes long.
+const netTCPBatch = usermem.PageSize / 150
+
+// commonReadSeqFileDataTCP returns the header and first sockets if h is nil,
+// or the sockets following the socket table entry h otherwise. Each socket is
+// its own record, with its *kernel.SocketEntry as its handle.
+func commonReadSeqFileDataTCP(ctx context.Context, k *kernel.Kernel, h seqfile.SeqHandle, fa int, header []byte) ([]seqfile.SeqData, int64) {
 	// t may be nil here if our caller is not part of a task goroutine. This can
 	// happen for example if we're here for "sentryctl cat". When t is nil,
 	// degrade gracefully and retrieve what we can.
 	t := kernel.TaskFromContext(ctx)
 
-	if h != nil {
-		return nil, 0
+	var data []seqfile.SeqData
+	var after *kernel.SocketEntry
+	if h == nil {
+		// The header's handle is a nil *kernel.SocketEntry, so that the
+		// records following it start at the front of the socket table.
+		data = append(data, seqfile.SeqData{Buf: header, Handle: after})
+	} else {
+		after = h.(*kernel.SocketEntry)
 	}
 
-	var buf bytes.Buffer
-	for _, se := range k.ListSockets() {
-		s := se.Sock.Get()
-		if s == nil {
-			log.Debugf("Couldn't resolve weakref with ID %v in socket table, racing with destruction?", se.ID)
-			continue
-		}
-		sfile := s.(*fs.File)
-		sops, ok := sfile.FileOperations.(socket.Socket)
-		if !ok {
-			panic(fmt.Sprintf("Found non-socket file in socket table: %+v", sfile))
-		}
-		if family, stype, _ := sops.Type(); !(family == fa && stype == linux.SOCK_STREAM) {
-			s.DecRef()
-			// Not tcp4 sockets.
-			continue
+	for len(data) < netTCPBatch {
+		ses := k.ListSocketsAfter(after, netTCPBatch)
+		if len(ses) == 0 {
+			break
 		}
-
-		// Linux's documentation for the fields below can be found at
-		// https://www.kernel.org/doc/Documentation/networking/proc_net_tcp.txt.
-		// For Linux's implementation, see net/ipv4/tcp_ipv4.c:get_tcp4_sock().
-		// Note that the header doesn't contain labels for all the fields.
-
-		// Field: sl; entry number.
-		fmt.Fprintf(&buf, "%4d: ", se.ID)
-
-		// Field: local_adddress.
-		var localAddr linux.SockAddr
-		if t != nil {
-			if local, _, err := sops.GetSockName(t); err == nil {
-				localAddr = local
-			}
-		}
-		writeInetAddr(&buf, fa, localAddr)
-
-		// Field: rem_address.
-		var remoteAddr linux.SockAddr
-		if t != nil {
-			if remote, _, err := sops.GetPeerName(t); err == nil {
-				remoteAddr = remote
+		after = ses[len(ses)-1]
+		for _, se := range ses {
+			if buf, ok := readTCPSocket(ctx, t, se, fa); ok {
+				data = append(data, seqfile.SeqData{Buf: buf, Handle: se})
 			}
 		}
-		writeInetAddr(&buf, fa, remoteAddr)
-
-		// Field: state; socket state.
-		fmt.Fprintf(&buf, "%02X ", sops.State())
+	}
+	return data, 0
+}
 
-		// Field: tx_queue, rx_queue; number of packets in the transmit and
-		// receive queue. Unimplemented.
-		fmt.Fprintf(&buf, "%08X:%08X ", 0, 0)
+// readTCPSocket returns the line of /proc/net/tcp or /proc/net/tcp6 for the
+// socket recorded in se, or false if it is not a TCP socket of family fa.
+func readTCPSocket(ctx context.Context, t *kernel.Task, se *kernel.SocketEntry, fa int) ([]byte, bool) {
+	s := se.Sock.Get()
+	if s == nil {
+		log.Debugf("Couldn't resolve weakref with ID %v in socket table, racing with destruction?", se.ID)
+		return nil, false
+	}
+	sfile := s.(*fs.File)
+	sops, ok := sfile.FileOperations.(socket.Socket)
+	if !ok {
+		panic(fmt.Sprintf("Found non-socket file in socket table: %+v", sfile))
+	}
+	if family, stype, _ := sops.Type(); !(family == fa && stype == linux.SOCK_STREAM) {
+		s.DecRef()
+		// Not tcp4 sockets.
+		return nil, false
+	}
 
-		// Field: tr, tm->when; timer active state and number of jiffies
-		// until timer expires. Unimplemented.
-		fmt.Fprintf(&buf, "%02X:%08X ", 0, 0)
+	// Linux's documentation for the fields below can be found at
+	// https://www.kernel.org/doc/Documentation/networking/proc_net_tcp.txt.
+	// For Linux's implementation, see net/ipv4/tcp_ipv4.c:get_tcp4_sock().
+	// Note that the header doesn't contain labels for all the fields.
+	var buf bytes.Buffer
 
-		// Field: retrnsmt; number of unrecovered RTO timeouts.
-		// Unimplemented.
-		fmt.Fprintf(&buf, "%08X ", 0)
+	// Field: sl; entry number.
+	fmt.Fprintf(&buf, "%4d: ", se.ID)
 
-		// Field: uid.
-		uattr, err := sfile.Dirent.Inode.UnstableAttr(ctx)
-		if err != nil {
-			log.Warningf("Failed to retrieve unstable attr for socket file: %v", err)
-			fmt.Fprintf(&buf, "%5d ", 0)
-		} else {
-			creds := auth.CredentialsFromContext(ctx)
-			fmt.Fprintf(&buf, "%5d ", uint32(uattr.Owner.UID.In(creds.UserNamespace).OrOverflow()))
+	// Field: local_adddress.
+	var localAddr linux.SockAddr
+	if t != nil {
+		if local, _, err := sops.GetSockName(t); err == nil {
+			localAddr = local
 		}
+	}
+	writeInetAddr(&buf, fa, localAddr)
 
-		// Field: timeout; number of unanswered 0-window probes.
-		// Unimplemented.
-		fmt.Fprintf(&buf, "%8d ", 0)
+	// Field: rem_address.
+	var remoteAddr linux.SockAddr
+	if t != nil {
+		if remote, _, err := sops.GetPeerName(t); err == nil {
+			remoteAddr = remote
+		}
+	}
+	writeInetAddr(&buf, fa, remoteAddr)
+
+	// Field: state; socket state.
+	fmt.Fprintf(&buf, "%02X ", sops.State())
+
+	// Field: tx_queue, rx_queue; number of packets in the transmit and
+	// receive queue. Unimplemented.
+	fmt.Fprintf(&buf, "%08X:%08X ", 0, 0)
+
+	// Field: tr, tm->when; timer active state and number of jiffies
+	// until timer expires. Unimplemented.
+	fmt.Fprintf(&buf, "%02X:%08X ", 0, 0)
+
+	// Field: retrnsmt; number of unrecovered RTO timeouts.
+	// Unimplemented.
+	fmt.Fprintf(&buf, "%08X ", 0)
+
+	// Field: uid.
+	uattr, err := sfile.Dirent.Inode.UnstableAttr(ctx)
+	if err != nil {
+		log.Warningf("Failed to retrieve unstable attr for socket file: %v", err)
+		fmt.Fprintf(&buf, "%5d ", 0)
+	} else {
+		creds := auth.CredentialsFromContext(ctx)
+		fmt.Fprintf(&buf, "%5d ", uint32(uattr.Owner.UID.In(creds.UserNamespace).OrOverflow()))
+	}
 
-		// Field: inode.
-		fmt.Fprintf(&buf, "%8d ", sfile.InodeID())
+	// Field: timeout; number of unanswered 0-window probes.
+	// Unimplemented.
+	fmt.Fprintf(&buf, "%8d ", 0)
 
-		// Field: refcount. Don't count the ref we obtain while deferencing
-		// the weakref to this socket.
-		fmt.Fprintf(&buf, "%d ", sfile.ReadRefs()-1)
+	// Field: inode.
+	fmt.Fprintf(&buf, "%8d ", sfile.InodeID())
 
-		// Field: Socket struct address. Redacted due to the same reason as
-		// the 'Num' field in /proc/net/unix, see netUnix.ReadSeqFileData.
-		fmt.Fprintf(&buf, "%#016p ", (*socket.Socket)(nil))
+	// Field: refcount. Don't count the ref we obtain while deferencing
+	// the weakref to this socket.
+	fmt.Fprintf(&buf, "%d ", sfile.ReadRefs()-1)
 
-		// Field: retransmit timeout. Unimplemented.
-		fmt.Fprintf(&buf, "%d ", 0)
+	// Field: Socket struct address. Redacted due to the same reason as
+	// the 'Num' field in /proc/net/unix, see netUnix.ReadSeqFileData.
+	fmt.Fprintf(&buf, "%#016p ", (*socket.Socket)(nil))
 
-		// Field: predicted tick of soft clock (delayed ACK control data).
-		// Unimplemented.
-		fmt.Fprintf(&buf, "%d ", 0)
+	// Field: retransmit timeout. Unimplemented.
+	fmt.Fprintf(&buf, "%d ", 0)
 
-		// Field: (ack.quick<<1)|ack.pingpong, Unimplemented.
-		fmt.Fprintf(&buf, "%d ", 0)
+	// Field: predicted tick of soft clock (delayed ACK control data).
+	// Unimplemented.
+	fmt.Fprintf(&buf, "%d ", 0)
 
-		// Field: sending congestion window, Unimplemented.
-		fmt.Fprintf(&buf, "%d ", 0)
+	// Field: (ack.quick<<1)|ack.pingpong, Unimplemented.
+	fmt.Fprintf(&buf, "%d ", 0)
 
-		// Field: Slow start size threshold, -1 if threshold >= 0xFFFF.
-		// Unimplemented, report as large threshold.
-		fmt.Fprintf(&buf, "%d", -1)
+	// Field: sending congestion window, Unimplemented.
+	fmt.Fprintf(&buf, "%d ", 0)
 
-		fmt.Fprintf(&buf, "\n")
+	// Field: Slow start size threshold, -1 if threshold >= 0xFFFF.
+	// Unimplemented, report as large threshold.
+	fmt.Fprintf(&buf, "%d", -1)
 
-		s.DecRef()
-	}
+	fmt.Fprintf(&buf, "\n")
 
-	data := []seqfile.SeqData{
-		{
-			Buf:    header,
-			Handle: n,
-		},
-		{
-			Buf:    buf.Bytes(),
-			Handle: n,
-		},
-	}
-	return data, 0
+	s.DecRef()
+	return buf.Bytes(), true
 }
 
 // netTCP implements seqfile.SeqSource for /proc/net/tcp.
@@ -695,7 +717,7 @@ func (*netTCP) NeedsUpdate(generation int64) bool {
 // ReadSeqFileData implements seqfile.SeqSource.ReadSeqFileData.
 func (n *netTCP) ReadSeqFileData(ctx context.Context, h seqfile.SeqHandle) ([]seqfile.SeqData, int64) {
 	header := []byte("  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode                                                     \n")
-	return commonReadSeqFileDataTCP(ctx, n, n.k, h, linux.AF_INET, header)
+	return commonReadSeqFileDataTCP(ctx, n.k, h, linux.AF_INET, header)
 }
 
 // netTCP6 implements seqfile.SeqSource for /proc/net/tcp6.
@@ -713,7 +735,7 @@ func (*netTCP6) NeedsUpdate(generation int64) bool {
 // ReadSeqFileData implements seqfile.SeqSource.ReadSeqFileData.
 func (n *netTCP6) ReadSeqFileData(ctx context.Context, h seqfile.SeqHandle) ([]seqfile.SeqData, int64) {
 	header := []byte("  sl  local_address                         remote_address                        st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode\n")
-	return commonReadSeqFileDataTCP(ctx, n, n.k, h, linux.AF_INET6, header)
+	return commonReadSeqFileDataTCP(ctx, n.k, h, linux.AF_INET6, header)
 }
 
 // netUDP implements seqfile.SeqSource for /proc/net/udp.
@@ -113,6 +113,13 @@ type SeqFile struct {
 	source     []SeqData
 	generation int64
 	lastRead   int64
+
+	// source[hintIndex] starts at file offset hintOffset. This is the record
+	// found by the last call to findIndexAndOffsetLocked, from which the
+	// next search starts, so that sequential reads of files with many
+	// records don't rescan all preceding records.
+	hintIndex  int
+	hintOffset int64
 }
 
 var _ fs.InodeOperations = (*SeqFile)(nil)
@@ -166,6 +173,23 @@ func findIndexAndOffset(data []SeqData, offset int64) (int, int64) {
 	return len(data), offset
 }
 
+// findIndexAndOffsetLocked is equivalent to findIndexAndOffset(s.source,
+// offset).
+//
+// Preconditions: s.mu must be locked.
+func (s *SeqFile) findIndexAndOffsetLocked(offset int64) (int, int64) {
+	start, startOffset := 0, int64(0)
+	if s.hintIndex <= len(s.source) && s.hintOffset <= offset {
+		start, startOffset = s.hintIndex, s.hintOffset
+	}
+	i, recordOffset := findIndexAndOffset(s.source[start:], offset-startOffset)
+	i += start
+	if i < len(s.source) {
+		s.hintIndex, s.hintOffset = i, offset-recordOffset
+	}
+	return i, recordOffset
+}
+
 // updateSourceLocked requires that s.mu is held.
 func (s *SeqFile) updateSourceLocked(ctx context.Context, record int) {
 	var h SeqHandle
@@ -176,6 +200,9 @@ func (s *SeqFile) updateSourceLocked(ctx context.Context, record int) {
 	}
 	// Save what we have previously read.
 	s.source = s.source[:record]
+	if s.hintIndex > record {
+		s.hintIndex, s.hintOffset = 0, 0
+	}
 	var newSource []SeqData
 	newSource, s.generation = s.SeqSource.ReadSeqFileData(ctx, h)
 	s.source = append(s.source, newSource...)
@@ -217,7 +244,7 @@ func (sfo *seqFileOperations) Read(ctx context.Context, file *fs.File, dst userm
 	updated := false
 
 	// Try to find where we should start reading this file.
-	i, recordOffset := findIndexAndOffset(sfo.seqFile.source, offset)
+	i, recordOffset := sfo.seqFile.findIndexAndOffsetLocked(offset)
 	if i == len(sfo.seqFile.source) {
 		// Ok, we're at EOF. Let's first check to see if there might be
 		// more data available to us. If there is more data, add it to
@@ -98,9 +98,11 @@ func (p *proc) newTaskDir(t *kernel.Task, msrc *fs.MountSource, isThreadGroup bo
 		"oom_score":     newOOMScore(t, msrc),
 		"oom_score_adj": newOOMScoreAdj(t, msrc),
 		"smaps":         newSmaps(t, msrc),
+		"smaps_rollup":  newSmapsRollup(t, msrc),
 		"stat":          newTaskStat(t, msrc, isThreadGroup, p.pidns),
 		"statm":         newStatm(t, msrc),
 		"status":        newStatus(t, msrc, p.pidns),
+		"syscall_stats": newSyscallStats(t, msrc, isThreadGroup),
 		"uid_map":       newUIDMap(t, msrc),
 	}
 	if isThreadGroup {
@@ -435,6 +437,42 @@ func (sd *smapsData) ReadSeqFileData(ctx context.Context, h seqfile.SeqHandle) (
 	return []seqfile.SeqData{}, 0
 }
 
+// smapsRollupData implements seqfile.SeqSource for /proc/[pid]/smaps_rollup.
+//
+// +stateify savable
+type smapsRollupData struct {
+	t *kernel.Task
+}
+
+func newSmapsRollup(t *kernel.Task, msrc *fs.MountSource) *fs.Inode {
+	return newProcInode(t, seqfile.NewSeqFile(t, &smapsRollupData{t}), msrc, fs.SpecialFile, t)
+}
+
+// NeedsUpdate implements seqfile.SeqSource.NeedsUpdate.
+func (sd *smapsRollupData) NeedsUpdate(generation int64) bool {
+	return true
+}
+
+// ReadSeqFileData implements seqfile.SeqSource.ReadSeqFileData.
+func (sd *smapsRollupData) ReadSeqFileData(ctx context.Context, h seqfile.SeqHandle) ([]seqfile.SeqData, int64) {
+	if h != nil {
+		return nil, 0
+	}
+
+	var tmm *mm.MemoryManager
+	sd.t.WithMuLocked(func(t *kernel.Task) {
+		// No additional reference is taken on mm here; see smapsData.mm.
+		tmm = t.MemoryManager()
+	})
+	if tmm == nil {
+		return nil, 0
+	}
+
+	var buf bytes.Buffer
+	tmm.ReadSmapsRollupDataInto(ctx, &buf)
+	return []seqfile.SeqData{{Buf: buf.Bytes(), Handle: (*smapsRollupData)(nil)}}, 0
+}
+
 // +stateify savable
 type taskStatData struct {
 	t *kernel.Task
@@ -675,6 +713,63 @@ func (i *ioData) ReadSeqFileData(ctx context.Context, h seqfile.SeqHandle) ([]se
 	return []seqfile.SeqData{{Buf: buf.Bytes(), Handle: (*ioData)(nil)}}, 0
 }
 
+// syscallStatsSource is the /proc/<pid>/syscall_stats and
+// /proc/<pid>/task/<tid>/syscall_stats data provider.
+type syscallStatsSource interface {
+	// SyscallStats returns per-syscall statistics.
+	SyscallStats() []kernel.SyscallStat
+}
+
+// syscallStatsData is the gVisor-specific syscall_stats file, which reports
+// the number of times each syscall has been executed and the time spent
+// executing it in the sentry.
+//
+// +stateify savable
+type syscallStatsData struct {
+	syscallStatsSource
+
+	// t is used to look up syscall names.
+	t *kernel.Task
+}
+
+func newSyscallStats(t *kernel.Task, msrc *fs.MountSource, isThreadGroup bool) *fs.Inode {
+	s := &syscallStatsData{syscallStatsSource: t, t: t}
+	if isThreadGroup {
+		s.syscallStatsSource = t.ThreadGroup()
+	}
+	return newProcInode(t, seqfile.NewSeqFile(t, s), msrc, fs.SpecialFile, t)
+}
+
+// NeedsUpdate returns whether the generation is old or not.
+func (s *syscallStatsData) NeedsUpdate(generation int64) bool {
+	return true
+}
+
+// ReadSeqFileData returns data for the SeqFile reader.
+// SeqData, the current generation and where in the file the handle corresponds to.
+func (s *syscallStatsData) ReadSeqFileData(ctx context.Context, h seqfile.SeqHandle) ([]seqfile.SeqData, int64) {
+	if h != nil {
+		return nil, 0
+	}
+
+	var table *kernel.SyscallTable
+	s.t.WithMuLocked(func(t *kernel.Task) {
+		table = t.SyscallTable()
+	})
+
+	var buf bytes.Buffer
+	fmt.Fprintf(&buf, "sysno name count sentry_ns\n")
+	for _, stat := range s.SyscallStats() {
+		name := fmt.Sprintf("sys_%d", stat.Sysno)
+		if table != nil {
+			name = table.LookupName(stat.Sysno)
+		}
+		fmt.Fprintf(&buf, "%d %s %d %d\n", stat.Sysno, name, stat.Count, stat.SentryTime.Nanoseconds())
+	}
+
+	return []seqfile.SeqData{{Buf: buf.Bytes(), Handle: (*syscallStatsData)(nil)}}, 0
+}
+
 // comm is a file containing the command name for a task.
 //
 // On Linux, /proc/[pid]/comm is writable, and writing to the comm file changes
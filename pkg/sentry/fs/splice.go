@@ -18,10 +18,15 @@ import (
 	"io"
 	"sync/atomic"
 
+	"golang.org/x/sys/unix"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/syserror"
 )
 
+// maxSpliceBufferSize is the maximum size of the buffer used by Splice to copy
+// data through the sentry.
+const maxSpliceBufferSize = 1 << 20
+
 // Splice moves data to this file, directly from another.
 //
 // Offsets are updated only if DstOffset and SrcOffset are set.
@@ -137,8 +142,19 @@ func Splice(ctx context.Context, dst *File, src *File, opts SpliceOpts) (int64,
 		Offset: opts.SrcStart,
 	}
 
+	// Between host-backed regular files, let the host copy the data, which
+	// avoids copying it through the sentry and may share extents on
+	// filesystems that support reflinks.
+	var n int64
+	err = syserror.ENOSYS
+	if !srcPipe && !dstPipe && !opts.Dup {
+		n, err = hostSplice(dst, src, opts.DstStart, opts.SrcStart, opts.Length)
+	}
+
 	// Attempt to do a WriteTo; this is likely the most efficient.
-	n, err := src.FileOperations.WriteTo(ctx, src, w, opts.Length, opts.Dup)
+	if n == 0 && err == syserror.ENOSYS {
+		n, err = src.FileOperations.WriteTo(ctx, src, w, opts.Length, opts.Dup)
+	}
 	if n == 0 && err == syserror.ENOSYS && !opts.Dup {
 		// Attempt as a ReadFrom. If a WriteTo, a ReadFrom may also be
 		// more efficient than a copy if buffers are cached or readily
@@ -152,11 +168,19 @@ func Splice(ctx context.Context, dst *File, src *File, opts SpliceOpts) (int64,
 	// not a pipe then reading is not destructive; if the destination
 	// is a regular file, then it is guaranteed not to block writing.
 	if n == 0 && err == syserror.ENOSYS && !opts.Dup && (!dstPipe || !srcPipe) {
-		// Fallback to an in-kernel copy.
-		n, err = io.Copy(w, &io.LimitedReader{
+		// Fallback to an in-kernel copy. Use a buffer large enough that
+		// copies of large files aren't dominated by per-chunk overhead.
+		bufSize := opts.Length
+		if bufSize > maxSpliceBufferSize {
+			bufSize = maxSpliceBufferSize
+		}
+		if bufSize < 1 {
+			bufSize = 1
+		}
+		n, err = io.CopyBuffer(w, &io.LimitedReader{
 			R: r,
 			N: opts.Length,
-		})
+		}, make([]byte, bufSize))
 	}
 
 	// Update offsets, if required.
@@ -179,3 +203,53 @@ func Splice(ctx context.Context, dst *File, src *File, opts SpliceOpts) (int64,
 
 	return n, err
 }
+
+// hostSplice copies up to length bytes from src at srcOff to dst at dstOff
+// using the host's copy_file_range(2), if both files are HostFileBacked. If the
+// copy can't be offloaded to the host, hostSplice returns ENOSYS, and nothing
+// has been copied.
+//
+// Preconditions: src and dst are regular files.
+func hostSplice(dst, src *File, dstOff, srcOff, length int64) (int64, error) {
+	dstHFB, ok := dst.FileOperations.(HostFileBacked)
+	if !ok {
+		return 0, syserror.ENOSYS
+	}
+	srcHFB, ok := src.FileOperations.(HostFileBacked)
+	if !ok {
+		return 0, syserror.ENOSYS
+	}
+	dstFD, ok := dstHFB.HostFD(dst)
+	if !ok {
+		return 0, syserror.ENOSYS
+	}
+	srcFD, ok := srcHFB.HostFD(src)
+	if !ok {
+		return 0, syserror.ENOSYS
+	}
+
+	var total int64
+	for total < length {
+		n, err := unix.CopyFileRange(srcFD, &srcOff, dstFD, &dstOff, int(length-total), 0)
+		if err == unix.EINTR {
+			continue
+		}
+		if err != nil {
+			if total == 0 {
+				// The host may not support copy_file_range between these
+				// files, e.g. because they're on different filesystems
+				// and the host kernel is older than 5.3. Fall back to
+				// copying through the sentry, which also reports any
+				// error that wasn't specific to the host copy.
+				return 0, syserror.ENOSYS
+			}
+			return total, nil
+		}
+		if n == 0 {
+			// End of file.
+			break
+		}
+		total += int64(n)
+	}
+	return total, nil
+}
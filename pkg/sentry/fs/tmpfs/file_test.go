@@ -22,6 +22,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/fs"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/contexttest"
 	"gvisor.dev/gvisor/pkg/sentry/usage"
+	"gvisor.dev/gvisor/pkg/syserror"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
 
@@ -70,3 +71,66 @@ func TestGrow(t *testing.T) {
 		t.Fatalf("Read %v, want %v", rbuf, want)
 	}
 }
+
+// Fill a size-limited file, then truncate it.
+func TestSizeLimit(t *testing.T) {
+	ctx := contexttest.Context(t)
+	f := newFile(ctx)
+	defer f.DecRef()
+	inode := f.Dirent.Inode
+	limit := &spaceLimit{max: 2 * usermem.PageSize}
+	inode.InodeOperations.(*fileInodeOperations).limit = limit
+
+	if err := inode.Allocate(ctx, f.Dirent, 0, usermem.PageSize); err != nil {
+		t.Fatalf("Allocate got %v want nil", err)
+	}
+	buf := bytes.Repeat([]byte{'a'}, usermem.PageSize)
+	if n, err := f.Pwritev(ctx, usermem.BytesIOSequence(buf), usermem.PageSize); n != int64(len(buf)) || err != nil {
+		t.Fatalf("Pwritev got (%d, %v) want (%d, nil)", n, err, len(buf))
+	}
+	if got, want := limit.used, uint64(2*usermem.PageSize); got != want {
+		t.Errorf("got %d bytes used want %d", got, want)
+	}
+
+	// The file is full.
+	if n, err := f.Pwritev(ctx, usermem.BytesIOSequence(buf), 2*usermem.PageSize); n != 0 || err != syserror.ENOSPC {
+		t.Errorf("Pwritev got (%d, %v) want (0, %v)", n, err, syserror.ENOSPC)
+	}
+	if err := inode.Allocate(ctx, f.Dirent, 2*usermem.PageSize, usermem.PageSize); err != syserror.ENOSPC {
+		t.Errorf("Allocate got %v want %v", err, syserror.ENOSPC)
+	}
+	if info, err := inode.StatFS(ctx); err != nil || info.TotalBlocks != 2 || info.FreeBlocks != 0 {
+		t.Errorf("StatFS got (%+v, %v) want 2 total and 0 free blocks", info, err)
+	}
+
+	if err := inode.Truncate(ctx, f.Dirent, 0); err != nil {
+		t.Fatalf("Truncate got %v want nil", err)
+	}
+	if limit.used != 0 {
+		t.Errorf("got %d bytes used after truncation want 0", limit.used)
+	}
+}
+
+func TestParseSize(t *testing.T) {
+	for _, test := range []struct {
+		size string
+		want uint64
+	}{
+		{"0", 0},
+		{"1", usermem.PageSize},
+		{"4096", 4096},
+		{"64k", 64 << 10},
+		{"2M", 2 << 20},
+		{"1g", 1 << 30},
+		{"1T", 1 << 40},
+	} {
+		if got, err := parseSize(test.size); got != test.want || err != nil {
+			t.Errorf("parseSize(%q) got (%d, %v) want (%d, nil)", test.size, got, err, test.want)
+		}
+	}
+	for _, size := range []string{"", "k", "1%", "-1", "16777216T"} {
+		if _, err := parseSize(size); err == nil {
+			t.Errorf("parseSize(%q) got nil error", size)
+		}
+	}
+}
@@ -16,12 +16,14 @@ package tmpfs
 
 import (
 	"fmt"
+	"math"
 	"strconv"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/sentry/fs"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
+	"gvisor.dev/gvisor/pkg/usermem"
 )
 
 const (
@@ -34,6 +36,9 @@ const (
 	// GID for the root directory.
 	rootGIDKey = "gid"
 
+	// sizeKey sets the maximum size of the files in the mount.
+	sizeKey = "size"
+
 	// cacheKey sets the caching policy for the mount.
 	cacheKey = "cache"
 
@@ -129,6 +134,20 @@ func (f *Filesystem) Mount(ctx context.Context, device string, flags fs.MountSou
 		delete(options, rootGIDKey)
 	}
 
+	// Parse the size limit, which may have a binary suffix as in Linux's
+	// lib/cmdline.c:memparse(). A size of 0 means no limit.
+	var limit *spaceLimit
+	if sizestr, ok := options[sizeKey]; ok {
+		size, err := parseSize(sizestr)
+		if err != nil {
+			return nil, fmt.Errorf("size value not parsable 'size=%s': %v", sizestr, err)
+		}
+		if size != 0 {
+			limit = &spaceLimit{max: size}
+		}
+		delete(options, sizeKey)
+	}
+
 	// Construct a mount which will follow the cache options provided.
 	//
 	// TODO(gvisor.dev/issue/179): There should be no reason to disable
@@ -151,5 +170,38 @@ func (f *Filesystem) Mount(ctx context.Context, device string, flags fs.MountSou
 	}
 
 	// Construct the tmpfs root.
-	return NewDir(ctx, nil, owner, perms, msrc), nil
+	return newDir(ctx, nil, owner, perms, msrc, limit), nil
+}
+
+// parseSize parses a size in bytes with an optional k, m, g or t suffix, and
+// rounds it up to a whole number of pages.
+func parseSize(s string) (uint64, error) {
+	shift := uint(0)
+	if len(s) > 0 {
+		switch s[len(s)-1] {
+		case 'k', 'K':
+			shift = 10
+		case 'm', 'M':
+			shift = 20
+		case 'g', 'G':
+			shift = 30
+		case 't', 'T':
+			shift = 40
+		}
+		if shift != 0 {
+			s = s[:len(s)-1]
+		}
+	}
+	size, err := strconv.ParseUint(s, 10, 64)
+	if err != nil {
+		return 0, err
+	}
+	if size > math.MaxUint64>>shift {
+		return 0, strconv.ErrRange
+	}
+	pgend, ok := usermem.Addr(size << shift).RoundUp()
+	if !ok {
+		return 0, strconv.ErrRange
+	}
+	return uint64(pgend), nil
 }
@@ -64,6 +64,16 @@ type fileInodeOperations struct {
 	// memUsage is the default memory usage that will be reported by this file.
 	memUsage usage.MemoryKind
 
+	// hugetlb is true if memory for mappings of the file should be allocated
+	// in huge pages, as requested by memfd_create(MFD_HUGETLB).
+	//
+	// hugetlb is immutable.
+	hugetlb bool
+
+	// limit is the size limit of the tmpfs mount containing the file, which
+	// is charged for the memory in data. limit is immutable.
+	limit *spaceLimit
+
 	attrMu sync.Mutex `state:"nosave"`
 
 	// attr contains the unstable metadata for the file.
@@ -73,6 +83,13 @@ type fileInodeOperations struct {
 	// it requires locking both.
 	attr fs.UnstableAttr
 
+	// linkable is true if the file may be linked into a directory while it
+	// has no links, which is only the case for files created by
+	// open(O_TMPFILE) without O_EXCL that haven't been linked yet.
+	//
+	// linkable is protected by attrMu.
+	linkable bool
+
 	mapsMu sync.Mutex `state:"nosave"`
 
 	// mappings tracks mappings of the file into memmap.MappingSpaces.
@@ -118,8 +135,8 @@ func NewInMemoryFile(ctx context.Context, usage usage.MemoryKind, uattr fs.Unsta
 }
 
 // NewMemfdInode creates a new inode backing a memfd. Memory used by the memfd
-// is backed by platform memory.
-func NewMemfdInode(ctx context.Context, allowSeals bool) *fs.Inode {
+// is backed by platform memory, allocated in huge pages if hugetlb is true.
+func NewMemfdInode(ctx context.Context, allowSeals, hugetlb bool) *fs.Inode {
 	// Per Linux, mm/shmem.c:__shmem_file_setup(), memfd inodes are set up with
 	// S_IRWXUGO.
 	perms := fs.PermMask{Read: true, Write: true, Execute: true}
@@ -129,11 +146,16 @@ func NewMemfdInode(ctx context.Context, allowSeals bool) *fs.Inode {
 	if allowSeals {
 		iops.seals = 0
 	}
+	iops.hugetlb = hugetlb
+	blockSize := int64(usermem.PageSize)
+	if hugetlb {
+		blockSize = usermem.HugePageSize
+	}
 	return fs.NewInode(ctx, iops, fs.NewNonCachingMountSource(ctx, nil, fs.MountSourceFlags{}), fs.StableAttr{
 		Type:      fs.RegularFile,
 		DeviceID:  tmpfsDevice.DeviceID(),
 		InodeID:   tmpfsDevice.NextIno(),
-		BlockSize: usermem.PageSize,
+		BlockSize: blockSize,
 	})
 }
 
@@ -141,6 +163,7 @@ func NewMemfdInode(ctx context.Context, allowSeals bool) *fs.Inode {
 func (f *fileInodeOperations) Release(context.Context) {
 	f.dataMu.Lock()
 	defer f.dataMu.Unlock()
+	f.limit.uncharge(f.data.Span())
 	f.data.DropAll(f.kernel.MemoryFile())
 }
 
@@ -255,7 +278,9 @@ func (f *fileInodeOperations) Truncate(ctx context.Context, _ *fs.Inode, size in
 	// and can remove them.
 	f.dataMu.Lock()
 	defer f.dataMu.Unlock()
+	span := f.data.Span()
 	f.data.Truncate(uint64(size), f.kernel.MemoryFile())
+	f.limit.uncharge(span - f.data.Span())
 
 	return nil
 }
@@ -269,15 +294,28 @@ func (f *fileInodeOperations) Allocate(ctx context.Context, _ *fs.Inode, offset,
 	f.dataMu.Lock()
 	defer f.dataMu.Unlock()
 
-	if newSize <= f.attr.Size {
-		return nil
-	}
-
 	// Check if current seals allow growth.
-	if f.seals&linux.F_SEAL_GROW != 0 {
+	if newSize > f.attr.Size && f.seals&linux.F_SEAL_GROW != 0 {
 		return syserror.EPERM
 	}
 
+	// Allocate memory for the range, as in Linux's
+	// mm/shmem.c:shmem_fallocate(), so that running out of space is reported
+	// now rather than by a later write or page fault. The range is allocated
+	// as a single extent where possible, so truncating it is cheap.
+	pgstart := usermem.Addr(offset).RoundDown()
+	pgend, ok := usermem.Addr(newSize).RoundUp()
+	if !ok {
+		return syserror.EFBIG
+	}
+	mr := memmap.MappableRange{uint64(pgstart), uint64(pgend)}
+	if err := f.fillLocked(ctx, mr, mr); err != nil {
+		return err
+	}
+
+	if newSize <= f.attr.Size {
+		return nil
+	}
 	f.attr.Size = newSize
 
 	now := ktime.NowFromContext(ctx)
@@ -294,6 +332,22 @@ func (f *fileInodeOperations) AddLink() {
 	f.attrMu.Unlock()
 }
 
+// beginLink returns true if a new link to the file may be created. As in
+// Linux's fs/namei.c:vfs_link(), a file with no links may only be linked if
+// it was created by open(O_TMPFILE) without O_EXCL, and only once.
+func (f *fileInodeOperations) beginLink() bool {
+	f.attrMu.Lock()
+	defer f.attrMu.Unlock()
+	if f.attr.Links != 0 {
+		return true
+	}
+	if !f.linkable {
+		return false
+	}
+	f.linkable = false
+	return true
+}
+
 // DropLink implements fs.InodeOperations.DropLink.
 func (f *fileInodeOperations) DropLink() {
 	f.attrMu.Lock()
@@ -314,8 +368,8 @@ func (*fileInodeOperations) IsVirtual() bool {
 }
 
 // StatFS implements fs.InodeOperations.StatFS.
-func (*fileInodeOperations) StatFS(context.Context) (fs.Info, error) {
-	return fsInfo, nil
+func (f *fileInodeOperations) StatFS(context.Context) (fs.Info, error) {
+	return f.limit.info(), nil
 }
 
 func (f *fileInodeOperations) read(ctx context.Context, file *fs.File, dst usermem.IOSequence, offset int64) (int64, error) {
@@ -348,10 +402,13 @@ func (f *fileInodeOperations) read(ctx context.Context, file *fs.File, dst userm
 	}
 
 	n, err := dst.CopyOutFrom(ctx, &fileReadWriter{f, offset})
-	if !file.Dirent.Inode.MountSource.Flags.NoAtime {
+	if flags := file.Dirent.Inode.MountSource.Flags; !flags.NoAtime {
 		// Compare Linux's mm/filemap.c:do_generic_file_read() => file_accessed().
+		now := ktime.NowFromContext(ctx)
 		f.attrMu.Lock()
-		f.attr.AccessTime = ktime.NowFromContext(ctx)
+		if flags.NeedsAccessTimeUpdate(f.attr.AccessTime, f.attr.ModificationTime, f.attr.StatusChangeTime, now) {
+			f.attr.AccessTime = now
+		}
 		f.attrMu.Unlock()
 	}
 	fs.IncrementWait(readWait, start)
@@ -525,8 +582,12 @@ func (rw *fileReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, error)
 		case gap.Ok():
 			// Allocate memory for the write.
 			gapMR := gap.Range().Intersect(pgMR)
+			if !rw.f.limit.charge(gapMR.Length()) {
+				return done, syserror.ENOSPC
+			}
 			fr, err := mf.Allocate(gapMR.Length(), rw.f.memUsage)
 			if err != nil {
+				rw.f.limit.uncharge(gapMR.Length())
 				return done, err
 			}
 
@@ -612,11 +673,13 @@ func (f *fileInodeOperations) Translate(ctx context.Context, required, optional
 		optional.End = pgend
 	}
 
+	fillOptional := optional
+	if f.hugetlb {
+		fillOptional = fsutil.HugeFillRange(optional, pgend)
+	}
+
 	mf := f.kernel.MemoryFile()
-	cerr := f.data.Fill(ctx, required, optional, mf, f.memUsage, func(_ context.Context, dsts safemem.BlockSeq, _ uint64) (uint64, error) {
-		// Newly-allocated pages are zeroed, so we don't need to do anything.
-		return dsts.NumBytes(), nil
-	})
+	cerr := f.fillLocked(ctx, required, fillOptional)
 
 	var ts []memmap.Translation
 	var translatedEnd uint64
@@ -642,6 +705,30 @@ func (f *fileInodeOperations) Translate(ctx context.Context, required, optional
 	return ts, nil
 }
 
+// fillLocked allocates memory for the file, which is zeroed, as for
+// fsutil.FileRangeSet.Fill. The memory is charged to f.limit; if the limit
+// does not allow optional to be filled, only required is.
+//
+// Preconditions: f.dataMu must be locked for writing.
+func (f *fileInodeOperations) fillLocked(ctx context.Context, required, optional memmap.MappableRange) error {
+	charged := optional.Length() - f.data.SpanRange(optional)
+	if !f.limit.charge(charged) {
+		optional = required
+		charged = required.Length() - f.data.SpanRange(required)
+		if !f.limit.charge(charged) {
+			return syserror.ENOSPC
+		}
+	}
+	span := f.data.Span()
+	err := f.data.Fill(ctx, required, optional, f.kernel.MemoryFile(), f.memUsage, func(_ context.Context, dsts safemem.BlockSeq, _ uint64) (uint64, error) {
+		// Newly-allocated pages are zeroed, so we don't need to do anything.
+		return dsts.NumBytes(), nil
+	})
+	// Return the charge for any memory that Fill failed to allocate.
+	f.limit.uncharge(charged - (f.data.Span() - span))
+	return err
+}
+
 // InvalidateUnsavable implements memmap.Mappable.InvalidateUnsavable.
 func (f *fileInodeOperations) InvalidateUnsavable(ctx context.Context) error {
 	return nil
@@ -16,6 +16,9 @@
 package tmpfs
 
 import (
+	"fmt"
+	"sync/atomic"
+
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/sentry/fs"
@@ -32,11 +35,62 @@ import (
 var fsInfo = fs.Info{
 	Type: linux.TMPFS_MAGIC,
 
-	// TODO(b/29637826): allow configuring a tmpfs size and enforce it.
+	// A tmpfs without a size limit reports no blocks, like Linux's with
+	// size=0.
 	TotalBlocks: 0,
 	FreeBlocks:  0,
 }
 
+// spaceLimit limits the memory used by the regular files of a tmpfs mount, as
+// configured by the size mount option. A nil *spaceLimit imposes no limit.
+//
+// +stateify savable
+type spaceLimit struct {
+	// max is the maximum number of bytes of memory used by the mount's files.
+	// max is immutable.
+	max uint64
+
+	// used is the number of bytes of memory used by the mount's files. used
+	// is accessed using atomic memory operations.
+	used uint64
+}
+
+// charge accounts for n more bytes of memory used by the mount's files. It
+// returns false, accounting for nothing, if this would exceed the limit.
+func (l *spaceLimit) charge(n uint64) bool {
+	if l == nil {
+		return true
+	}
+	for {
+		used := atomic.LoadUint64(&l.used)
+		if n > l.max-used {
+			return false
+		}
+		if atomic.CompareAndSwapUint64(&l.used, used, used+n) {
+			return true
+		}
+	}
+}
+
+// uncharge accounts for n fewer bytes of memory used by the mount's files.
+func (l *spaceLimit) uncharge(n uint64) {
+	if l == nil {
+		return
+	}
+	atomic.AddUint64(&l.used, ^(n - 1))
+}
+
+// info returns the fs.Info of a mount with limit l.
+func (l *spaceLimit) info() fs.Info {
+	if l == nil {
+		return fsInfo
+	}
+	info := fsInfo
+	info.TotalBlocks = l.max / usermem.PageSize
+	info.FreeBlocks = (l.max - atomic.LoadUint64(&l.used)) / usermem.PageSize
+	return info
+}
+
 // rename implements fs.InodeOperations.Rename for tmpfs nodes.
 func rename(ctx context.Context, oldParent *fs.Inode, oldName string, newParent *fs.Inode, newName string, replacement bool) error {
 	// Don't allow renames across different mounts.
@@ -74,15 +128,25 @@ type Dir struct {
 
 	// kernel is used to allocate memory as storage for tmpfs Files.
 	kernel *kernel.Kernel
+
+	// limit is the size limit of the mount containing the directory, which
+	// applies to files created in it. limit is immutable.
+	limit *spaceLimit
 }
 
 var _ fs.InodeOperations = (*Dir)(nil)
 
 // NewDir returns a new directory.
 func NewDir(ctx context.Context, contents map[string]*fs.Inode, owner fs.FileOwner, perms fs.FilePermissions, msrc *fs.MountSource) *fs.Inode {
+	return newDir(ctx, contents, owner, perms, msrc, nil /* limit */)
+}
+
+// newDir returns a new directory in a mount with the given size limit.
+func newDir(ctx context.Context, contents map[string]*fs.Inode, owner fs.FileOwner, perms fs.FilePermissions, msrc *fs.MountSource, limit *spaceLimit) *fs.Inode {
 	d := &Dir{
 		ramfsDir: ramfs.NewDir(ctx, contents, owner, perms),
 		kernel:   kernel.KernelFromContext(ctx),
+		limit:    limit,
 	}
 
 	// Manually set the CreateOps.
@@ -134,9 +198,33 @@ func (d *Dir) CreateLink(ctx context.Context, dir *fs.Inode, oldname, newname st
 
 // CreateHardLink implements fs.InodeOperations.CreateHardLink.
 func (d *Dir) CreateHardLink(ctx context.Context, dir *fs.Inode, target *fs.Inode, name string) error {
+	// Check the name before beginLink, which can't be undone.
+	if len(name) > linux.NAME_MAX {
+		return syserror.ENAMETOOLONG
+	}
+	if iops, ok := target.InodeOperations.(*fileInodeOperations); ok && !iops.beginLink() {
+		return syserror.ENOENT
+	}
 	return d.ramfsDir.CreateHardLink(ctx, dir, target, name)
 }
 
+// CreateTmpfile implements fs.TmpfileCreator.CreateTmpfile.
+func (d *Dir) CreateTmpfile(ctx context.Context, dir *fs.Inode, flags fs.FileFlags, perms fs.FilePermissions, linkable bool) (*fs.File, error) {
+	inode, err := d.ramfsDir.CreateOps.NewFile(ctx, dir, perms)
+	if err != nil {
+		return nil, err
+	}
+	// inode isn't visible to anyone else yet, so there's no need to lock
+	// attrMu.
+	inode.InodeOperations.(*fileInodeOperations).linkable = linkable
+
+	// The file has no name; as in Linux, name its dirent after its inode
+	// number. The dirent takes ownership of the inode reference.
+	dirent := fs.NewDirent(ctx, inode, fmt.Sprintf("#%d", inode.StableAttr.InodeID))
+	defer dirent.DecRef()
+	return inode.GetFile(ctx, dirent, flags)
+}
+
 // CreateDirectory implements fs.InodeOperations.CreateDirectory.
 func (d *Dir) CreateDirectory(ctx context.Context, dir *fs.Inode, name string, perms fs.FilePermissions) error {
 	return d.ramfsDir.CreateDirectory(ctx, dir, name, perms)
@@ -211,7 +299,7 @@ func (d *Dir) SetTimestamps(ctx context.Context, i *fs.Inode, ts fs.TimeSpec) er
 func (d *Dir) newCreateOps() *ramfs.CreateOps {
 	return &ramfs.CreateOps{
 		NewDir: func(ctx context.Context, dir *fs.Inode, perms fs.FilePermissions) (*fs.Inode, error) {
-			return NewDir(ctx, nil, fs.FileOwnerFromContext(ctx), perms, dir.MountSource), nil
+			return newDir(ctx, nil, fs.FileOwnerFromContext(ctx), perms, dir.MountSource, d.limit), nil
 		},
 		NewFile: func(ctx context.Context, dir *fs.Inode, perms fs.FilePermissions) (*fs.Inode, error) {
 			uattr := fs.WithCurrentTime(ctx, fs.UnstableAttr{
@@ -220,7 +308,8 @@ func (d *Dir) newCreateOps() *ramfs.CreateOps {
 				// Always start unlinked.
 				Links: 0,
 			})
-			iops := NewInMemoryFile(ctx, usage.Tmpfs, uattr)
+			iops := NewInMemoryFile(ctx, usage.Tmpfs, uattr).(*fileInodeOperations)
+			iops.limit = d.limit
 			return fs.NewInode(ctx, iops, dir.MountSource, fs.StableAttr{
 				DeviceID:  tmpfsDevice.DeviceID(),
 				InodeID:   tmpfsDevice.NextIno(),
@@ -246,8 +335,8 @@ func (d *Dir) Rename(ctx context.Context, inode *fs.Inode, oldParent *fs.Inode,
 }
 
 // StatFS implements fs.InodeOperations.StatFS.
-func (*Dir) StatFS(context.Context) (fs.Info, error) {
-	return fsInfo, nil
+func (d *Dir) StatFS(context.Context) (fs.Info, error) {
+	return d.limit.info(), nil
 }
 
 // Allocate implements fs.InodeOperations.Allocate.
@@ -284,6 +284,20 @@ func (*outputQueueTransformer) transform(l *lineDiscipline, q *queue, buf []byte
 
 	var ret int
 	for len(buf) > 0 {
+		// Characters other than those handled below are copied unchanged
+		// and advance the column by one, so copy runs of them in bulk.
+		if n := plainOutputLen(buf); n > 0 {
+			if l.termios.IEnabled(linux.IUTF8) {
+				l.column += utf8.RuneCount(buf[:n])
+			} else {
+				l.column += n
+			}
+			q.readBuf = append(q.readBuf, buf[:n]...)
+			ret += n
+			buf = buf[n:]
+			continue
+		}
+
 		size := l.peek(buf)
 		cBytes := append([]byte{}, buf[:size]...)
 		ret += size
@@ -359,8 +373,22 @@ func (*inputQueueTransformer) transform(l *lineDiscipline, q *queue, buf []byte)
 		maxBytes = canonMaxBytes
 	}
 
+	// In noncanonical mode without echo, characters other than those
+	// handled below are copied unchanged, so runs of them are copied in
+	// bulk.
+	bulk := !l.termios.LEnabled(linux.ICANON) && !l.termios.LEnabled(linux.ECHO)
+
 	var ret int
 	for len(buf) > 0 && len(q.readBuf) < canonMaxBytes {
+		if bulk {
+			if n := l.plainInputLen(buf, maxBytes-len(q.readBuf)); n > 0 {
+				q.readBuf = append(q.readBuf, buf[:n]...)
+				ret += n
+				buf = buf[n:]
+				continue
+			}
+		}
+
 		size := l.peek(buf)
 		cBytes := append([]byte{}, buf[:size]...)
 		// We're guaranteed that cBytes has at least one element.
@@ -435,6 +463,39 @@ func (l *lineDiscipline) shouldDiscard(q *queue, cBytes []byte) bool {
 	return l.termios.LEnabled(linux.ICANON) && len(q.readBuf)+len(cBytes) >= canonMaxBytes && !l.termios.IsTerminating(cBytes)
 }
 
+// plainOutputLen returns the length of the longest prefix of buf that contains
+// no characters with special meaning to output processing.
+func plainOutputLen(buf []byte) int {
+	for i, c := range buf {
+		switch c {
+		case '\n', '\r', '\t', '\b':
+			return i
+		}
+	}
+	return len(buf)
+}
+
+// plainInputLen returns the length of the longest prefix of buf, no longer than
+// room, that contains no characters with special meaning to noncanonical input
+// processing and does not end in the middle of a character.
+//
+// Precondition:
+// * l.termiosMu must be held for reading.
+func (l *lineDiscipline) plainInputLen(buf []byte, room int) int {
+	n := 0
+	for n < len(buf) && n < room && buf[n] != '\r' && buf[n] != '\n' {
+		n++
+	}
+	if n < len(buf) && l.termios.IEnabled(linux.IUTF8) {
+		// Leave a partial rune at the end to the slow path, which
+		// won't split it.
+		for n > 0 && !utf8.RuneStart(buf[n]) {
+			n--
+		}
+	}
+	return n
+}
+
 // peek returns the size in bytes of the next character to process. As long as
 // b isn't empty, peek returns a value of at least 1.
 func (l *lineDiscipline) peek(b []byte) int {
@@ -40,6 +40,9 @@ type File interface {
 	// Type returns the file type, e.g. linux.S_IFREG.
 	Type(context.Context) (linux.FileMode, error)
 
+	// Identity returns the identity of the file's current contents.
+	Identity(context.Context) (FileIdentity, error)
+
 	// IncRef increments reference.
 	IncRef()
 
@@ -47,6 +50,24 @@ type File interface {
 	DecRef()
 }
 
+// FileIdentity identifies a file and a version of its contents, so that
+// information derived from the contents can be cached. Modifying a file
+// changes its ctime, so two equal FileIdentities refer to the same contents
+// unless the file's inode number was reused within a single ctime tick.
+type FileIdentity struct {
+	// Dev and Ino are the file's device and inode numbers.
+	Dev uint64
+	Ino uint64
+
+	// Size is the file's size in bytes.
+	Size uint64
+
+	// Mtime and Ctime are the file's modification and status change times
+	// in nanoseconds.
+	Mtime int64
+	Ctime int64
+}
+
 // Lookup provides a common interface to open files.
 type Lookup interface {
 	// OpenPath opens a file.
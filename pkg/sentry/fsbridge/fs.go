@@ -81,6 +81,22 @@ func (f *fsFile) Type(context.Context) (linux.FileMode, error) {
 	return linux.FileMode(f.file.Dirent.Inode.StableAttr.Type.LinuxType()), nil
 }
 
+// Identity implements File.
+func (f *fsFile) Identity(ctx context.Context) (FileIdentity, error) {
+	inode := f.file.Dirent.Inode
+	uattr, err := inode.UnstableAttr(ctx)
+	if err != nil {
+		return FileIdentity{}, err
+	}
+	return FileIdentity{
+		Dev:   inode.StableAttr.DeviceID,
+		Ino:   inode.StableAttr.InodeID,
+		Size:  uint64(uattr.Size),
+		Mtime: uattr.ModificationTime.Nanoseconds(),
+		Ctime: uattr.StatusChangeTime.Nanoseconds(),
+	}, nil
+}
+
 // IncRef implements File.
 func (f *fsFile) IncRef() {
 	f.file.IncRef()
@@ -23,6 +23,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
+	"gvisor.dev/gvisor/pkg/syserror"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
 
@@ -80,6 +81,26 @@ func (f *VFSFile) Type(ctx context.Context) (linux.FileMode, error) {
 	return linux.FileMode(stat.Mode).FileType(), nil
 }
 
+// Identity implements File.
+func (f *VFSFile) Identity(ctx context.Context) (FileIdentity, error) {
+	const mask = linux.STATX_INO | linux.STATX_SIZE | linux.STATX_MTIME | linux.STATX_CTIME
+	stat, err := f.file.Stat(ctx, vfs.StatOptions{Mask: mask})
+	if err != nil {
+		return FileIdentity{}, err
+	}
+	if stat.Mask&mask != mask {
+		// The identity must not be cached if it is incomplete.
+		return FileIdentity{}, syserror.EOPNOTSUPP
+	}
+	return FileIdentity{
+		Dev:   uint64(linux.MakeDeviceID(uint16(stat.DevMajor), stat.DevMinor)),
+		Ino:   stat.Ino,
+		Size:  stat.Size,
+		Mtime: stat.Mtime.ToNsecCapped(),
+		Ctime: stat.Ctime.ToNsecCapped(),
+	}, nil
+}
+
 // IncRef implements File.
 func (f *VFSFile) IncRef() {
 	f.file.IncRef()
@@ -54,3 +54,28 @@ func TestSimpleMasterToSlave(t *testing.T) {
 		t.Fatalf("written and read strings do not match: got %q, want %q", outStr, inStr)
 	}
 }
+
+func TestSlaveToMasterOutputProcessing(t *testing.T) {
+	ld := newLineDiscipline(linux.DefaultSlaveTermios)
+	ctx := contexttest.Context(t)
+	// Runs of plain characters are processed in bulk, and must not affect
+	// the processing of the characters between them.
+	inBytes := []byte("hello\r\ttty\nbye\n")
+	want := "hello\r\ttty\r\nbye\r\n"
+	outBytes := make([]byte, 32)
+
+	if _, err := ld.outputQueueWrite(ctx, usermem.BytesIOSequence(inBytes)); err != nil {
+		t.Fatalf("error writing to output queue: %v", err)
+	}
+	nr, err := ld.outputQueueRead(ctx, usermem.BytesIOSequence(outBytes))
+	if err != nil {
+		t.Fatalf("error reading from output queue: %v", err)
+	}
+	if got := string(outBytes[:nr]); got != want {
+		t.Errorf("got %q, want %q", got, want)
+	}
+	// The cursor is back at the start of the line after the last '\n'.
+	if ld.column != 0 {
+		t.Errorf("got column %d, want 0", ld.column)
+	}
+}
@@ -18,6 +18,7 @@ package eventfd
 import (
 	"math"
 	"sync"
+	"sync/atomic"
 	"syscall"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
@@ -42,19 +43,29 @@ type EventFileDescription struct {
 	// becomes readable or writable.
 	queue waiter.Queue `state:"zerovalue"`
 
-	// mu protects the fields below.
-	mu sync.Mutex `state:"nosave"`
-
-	// val is the current value of the event counter.
+	// val is the current value of the event counter, or hostedVal if the
+	// eventfd is passed through to the host. val is accessed using atomic
+	// memory operations, so that reads and writes of sentry-internal eventfds
+	// don't need to lock mu.
 	val uint64
 
-	// semMode specifies whether the event is in "semaphore" mode.
+	// semMode specifies whether the event is in "semaphore" mode. semMode is
+	// immutable.
 	semMode bool
 
+	// mu protects hostfd, and serializes transitions of val to and from
+	// hostedVal.
+	mu sync.Mutex `state:"nosave"`
+
 	// hostfd indicates whether this eventfd is passed through to the host.
 	hostfd int
 }
 
+// hostedVal is the value of EventFileDescription.val for eventfds that are
+// passed through to the host. The counter can't otherwise reach it, since
+// writes that would take it above math.MaxUint64-1 block.
+const hostedVal = math.MaxUint64
+
 var _ vfs.FileDescriptionImpl = (*EventFileDescription)(nil)
 
 // New creates a new event fd.
@@ -89,8 +100,12 @@ func (efd *EventFileDescription) HostFD() (int, error) {
 		flags |= linux.EFD_SEMAPHORE
 	}
 
-	fd, _, errno := syscall.Syscall(syscall.SYS_EVENTFD2, uintptr(efd.val), uintptr(flags), 0)
+	// Take the counter's value, and divert concurrent reads and writes to
+	// the slow path, which waits for mu.
+	val := atomic.SwapUint64(&efd.val, hostedVal)
+	fd, _, errno := syscall.Syscall(syscall.SYS_EVENTFD2, uintptr(val), uintptr(flags), 0)
 	if errno != 0 {
+		atomic.StoreUint64(&efd.val, val)
 		return -1, errno
 	}
 
@@ -98,6 +113,7 @@ func (efd *EventFileDescription) HostFD() (int, error) {
 		if closeErr := syscall.Close(int(fd)); closeErr != nil {
 			log.Warningf("close(%d) eventfd failed: %v", fd, closeErr)
 		}
+		atomic.StoreUint64(&efd.val, val)
 		return -1, err
 	}
 
@@ -154,31 +170,39 @@ func (efd *EventFileDescription) hostReadLocked(ctx context.Context, dst usermem
 }
 
 func (efd *EventFileDescription) read(ctx context.Context, dst usermem.IOSequence) error {
-	efd.mu.Lock()
-	if efd.hostfd >= 0 {
-		defer efd.mu.Unlock()
-		return efd.hostReadLocked(ctx, dst)
-	}
+	var val uint64
+	for {
+		cur := atomic.LoadUint64(&efd.val)
+		if cur == hostedVal {
+			efd.mu.Lock()
+			if efd.hostfd >= 0 {
+				defer efd.mu.Unlock()
+				return efd.hostReadLocked(ctx, dst)
+			}
+			// HostFD failed and restored the counter.
+			efd.mu.Unlock()
+			continue
+		}
 
-	// We can't complete the read if the value is currently zero.
-	if efd.val == 0 {
-		efd.mu.Unlock()
-		return syserror.ErrWouldBlock
-	}
+		// We can't complete the read if the value is currently zero.
+		if cur == 0 {
+			return syserror.ErrWouldBlock
+		}
 
-	// Update the value based on the mode the event is operating in.
-	var val uint64
-	if efd.semMode {
-		val = 1
-		// Consistent with Linux, this is done even if writing to memory fails.
-		efd.val--
-	} else {
-		val = efd.val
-		efd.val = 0
+		// Update the value based on the mode the event is operating in.
+		// Consistent with Linux, this is done even if writing to memory
+		// fails.
+		next := uint64(0)
+		val = cur
+		if efd.semMode {
+			next = cur - 1
+			val = 1
+		}
+		if atomic.CompareAndSwapUint64(&efd.val, cur, next) {
+			break
+		}
 	}
 
-	efd.mu.Unlock()
-
 	// Notify writers. We do this even if we were already writable because
 	// it is possible that a writer is waiting to write the maximum value
 	// to the event.
@@ -217,24 +241,32 @@ func (efd *EventFileDescription) Signal(val uint64) error {
 		return syscall.EINVAL
 	}
 
-	efd.mu.Lock()
-
-	if efd.hostfd >= 0 {
-		defer efd.mu.Unlock()
-		return efd.hostWriteLocked(val)
-	}
+	for {
+		cur := atomic.LoadUint64(&efd.val)
+		if cur == hostedVal {
+			efd.mu.Lock()
+			if efd.hostfd >= 0 {
+				defer efd.mu.Unlock()
+				return efd.hostWriteLocked(val)
+			}
+			// HostFD failed and restored the counter.
+			efd.mu.Unlock()
+			continue
+		}
 
-	// We only allow writes that won't cause the value to go over the max
-	// uint64 minus 1.
-	if val > math.MaxUint64-1-efd.val {
-		efd.mu.Unlock()
-		return syserror.ErrWouldBlock
+		// We only allow writes that won't cause the value to go over the
+		// max uint64 minus 1.
+		if val > math.MaxUint64-1-cur {
+			return syserror.ErrWouldBlock
+		}
+		if atomic.CompareAndSwapUint64(&efd.val, cur, cur+val) {
+			break
+		}
 	}
 
-	efd.val += val
-	efd.mu.Unlock()
-
-	// Always trigger a notification.
+	// Always trigger a notification, even if the counter was already
+	// non-zero: edge-triggered epoll waiters expect an event for each
+	// write, as on Linux.
 	efd.queue.Notify(waiter.EventIn)
 
 	return nil
@@ -242,19 +274,22 @@ func (efd *EventFileDescription) Signal(val uint64) error {
 
 // Readiness implements waiter.Waitable.Readiness.
 func (efd *EventFileDescription) Readiness(mask waiter.EventMask) waiter.EventMask {
-	efd.mu.Lock()
-	defer efd.mu.Unlock()
-
-	if efd.hostfd >= 0 {
-		return fdnotifier.NonBlockingPoll(int32(efd.hostfd), mask)
+	val := atomic.LoadUint64(&efd.val)
+	if val == hostedVal {
+		efd.mu.Lock()
+		defer efd.mu.Unlock()
+		if efd.hostfd >= 0 {
+			return fdnotifier.NonBlockingPoll(int32(efd.hostfd), mask)
+		}
+		val = atomic.LoadUint64(&efd.val)
 	}
 
 	ready := waiter.EventMask(0)
-	if efd.val > 0 {
+	if val > 0 {
 		ready |= waiter.EventIn
 	}
 
-	if efd.val < math.MaxUint64-1 {
+	if val < math.MaxUint64-1 {
 		ready |= waiter.EventOut
 	}
 
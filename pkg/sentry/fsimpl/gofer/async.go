@@ -0,0 +1,188 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package gofer
+
+import (
+	"sync"
+
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/log"
+	"gvisor.dev/gvisor/pkg/sentry/fs"
+)
+
+// maxAsyncMetadataOps is the maximum number of asynchronous metadata
+// operations that may be outstanding on a filesystem at a time.
+const maxAsyncMetadataOps = 128
+
+// asyncMetadataOps tracks metadata operations (unlinks and renames) that have
+// been applied to the dentry tree but whose RPCs to the remote filesystem are
+// still outstanding.
+//
+// Under InteropModeExclusive, the dentry tree is authoritative, so once the
+// client has checked that an operation will succeed and has updated the
+// dentry tree, the operation is visible to applications, and the RPC only
+// needs to reach the remote filesystem before any later RPC that depends on
+// it. This allows the round trips of independent operations, such as renames
+// of different temporary files by different threads, to overlap.
+//
+// Ordering is preserved by tracking the directory entries and dentries that
+// each outstanding operation affects:
+//
+// - Before issuing an RPC that involves a name in a directory (walk, create,
+// unlink, or rename), the client waits for outstanding operations on the same
+// name with waitName().
+//
+// - Before issuing an RPC that depends on the complete contents of a
+// directory (readdir or rmdir), or clunking a dentry's fid, the client waits
+// for outstanding operations involving the dentry with waitDentry().
+//
+// Operations on distinct names never conflict, since 9P fids (and the host
+// file descriptors that fsgofer uses to implement them) identify files rather
+// than paths.
+type asyncMetadataOps struct {
+	mu   sync.Mutex
+	cond sync.Cond
+
+	// inflight is the number of outstanding operations.
+	inflight int
+
+	// names maps each directory entry to the number of outstanding
+	// operations that affect it.
+	names map[dentryName]int
+
+	// dentries maps each dentry to the number of outstanding operations that
+	// use its fid or affect its children.
+	dentries map[*dentry]int
+
+	// err is the first error returned by an asynchronous operation since the
+	// last call to takeErr().
+	err error
+}
+
+// dentryName identifies a directory entry.
+type dentryName struct {
+	parent *dentry
+	name   string
+}
+
+// init must be called before first use of ops.
+func (ops *asyncMetadataOps) init() {
+	ops.cond.L = &ops.mu
+	ops.names = make(map[dentryName]int)
+	ops.dentries = make(map[*dentry]int)
+}
+
+// waitName blocks until there are no outstanding operations affecting the
+// directory entry with the given name in parent.
+func (ops *asyncMetadataOps) waitName(parent *dentry, name string) {
+	key := dentryName{parent, name}
+	ops.mu.Lock()
+	for ops.names[key] != 0 {
+		ops.cond.Wait()
+	}
+	ops.mu.Unlock()
+}
+
+// waitDentry blocks until there are no outstanding operations involving d.
+func (ops *asyncMetadataOps) waitDentry(d *dentry) {
+	ops.mu.Lock()
+	for ops.dentries[d] != 0 {
+		ops.cond.Wait()
+	}
+	ops.mu.Unlock()
+}
+
+// waitAll blocks until there are no outstanding operations.
+func (ops *asyncMetadataOps) waitAll() {
+	ops.mu.Lock()
+	for ops.inflight != 0 {
+		ops.cond.Wait()
+	}
+	ops.mu.Unlock()
+}
+
+// takeErr returns and clears the first error returned by an asynchronous
+// operation since the last call to takeErr.
+//
+// Preconditions: There are no outstanding operations, e.g. because the caller
+// has just called ops.waitAll().
+func (ops *asyncMetadataOps) takeErr() error {
+	ops.mu.Lock()
+	defer ops.mu.Unlock()
+	err := ops.err
+	ops.err = nil
+	return err
+}
+
+// start waits for outstanding operations affecting any of the given directory
+// entries to complete, then issues rpc asynchronously. dentries are the
+// dentries whose fids rpc uses or whose children it affects; they must not be
+// destroyed until rpc completes, which dentry.destroyLocked() ensures.
+//
+// Preconditions: The caller must have checked that rpc will succeed and have
+// already applied its effects to the dentry tree.
+func (ops *asyncMetadataOps) start(names []dentryName, dentries []*dentry, rpc func(ctx context.Context) error) {
+	ops.mu.Lock()
+	for {
+		ready := ops.inflight < maxAsyncMetadataOps
+		for _, key := range names {
+			if ops.names[key] != 0 {
+				ready = false
+				break
+			}
+		}
+		if ready {
+			break
+		}
+		ops.cond.Wait()
+	}
+	ops.inflight++
+	for _, key := range names {
+		ops.names[key]++
+	}
+	for _, d := range dentries {
+		ops.dentries[d]++
+	}
+	ops.mu.Unlock()
+
+	fs.Async(func() {
+		// rpc doesn't run on the caller's task goroutine, so it can't use
+		// the caller's context.
+		err := rpc(context.Background())
+		if err != nil {
+			log.Warningf("gofer: asynchronous metadata operation failed: %v", err)
+		}
+
+		ops.mu.Lock()
+		if err != nil && ops.err == nil {
+			ops.err = err
+		}
+		ops.inflight--
+		for _, key := range names {
+			ops.names[key]--
+			if ops.names[key] == 0 {
+				delete(ops.names, key)
+			}
+		}
+		for _, d := range dentries {
+			ops.dentries[d]--
+			if ops.dentries[d] == 0 {
+				delete(ops.dentries, d)
+			}
+		}
+		ops.cond.Broadcast()
+		ops.mu.Unlock()
+	})
+}
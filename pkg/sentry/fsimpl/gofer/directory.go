@@ -44,15 +44,18 @@ func (d *dentry) cacheNewChildLocked(child *dentry, name string) {
 		d.children = make(map[string]*dentry)
 	}
 	d.children[name] = child
+	delete(d.negativeChildrenExpiry, name)
 }
 
 // Preconditions: d.dirMu must be locked. d.isDir().
 func (d *dentry) cacheNegativeLookupLocked(name string) {
-	// Don't cache negative lookups if InteropModeShared is in effect (since
-	// this makes remote lookup unavoidable), or if d.isSynthetic() (in which
-	// case the only files in the directory are those for which a dentry exists
-	// in d.children). Instead, just delete any previously-cached dentry.
-	if d.fs.opts.interop == InteropModeShared || d.isSynthetic() {
+	// Don't cache negative lookups if InteropModeShared is in effect without
+	// a negative lookup timeout (since this makes remote lookup unavoidable),
+	// or if d.isSynthetic() (in which case the only files in the directory are
+	// those for which a dentry exists in d.children). Instead, just delete any
+	// previously-cached dentry.
+	shared := d.fs.opts.interop == InteropModeShared
+	if (shared && d.fs.opts.negativeLookupTimeout == 0) || d.isSynthetic() {
 		delete(d.children, name)
 		return
 	}
@@ -60,6 +63,12 @@ func (d *dentry) cacheNegativeLookupLocked(name string) {
 		d.children = make(map[string]*dentry)
 	}
 	d.children[name] = nil
+	if shared {
+		if d.negativeChildrenExpiry == nil {
+			d.negativeChildrenExpiry = make(map[string]int64)
+		}
+		d.negativeChildrenExpiry[name] = d.fs.clock.Now().Nanoseconds() + d.fs.opts.negativeLookupTimeout.Nanoseconds()
+	}
 }
 
 type createSyntheticOpts struct {
@@ -200,8 +209,11 @@ func (d *dentry) getDirents(ctx context.Context) ([]vfs.Dirent, error) {
 			// duplicate entries for synthetic children.
 			realChildren = make(map[string]struct{})
 		}
+		// Entries must reflect unlinks and renames in d.
+		d.fs.asyncOps.waitDentry(d)
 		off := uint64(0)
-		const count = 64 * 1024 // for consistency with the vfs1 client
+		// Fetch as many entries per RPC as fit in a message.
+		count := d.fs.client.PayloadSize()
 		d.handleMu.RLock()
 		if !d.handleReadable {
 			// This should not be possible because a readable handle should
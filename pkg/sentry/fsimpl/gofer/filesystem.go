@@ -48,8 +48,10 @@ func (fs *filesystem) Sync(ctx context.Context) error {
 	fs.syncMu.Unlock()
 
 	// Return the first error we encounter, but sync everything we can
-	// regardless.
-	var retErr error
+	// regardless. This includes errors from asynchronous unlinks and renames,
+	// which have otherwise not been reported to the application.
+	fs.asyncOps.waitAll()
+	retErr := fs.asyncOps.takeErr()
 
 	// Sync regular files.
 	for _, d := range ds {
@@ -158,6 +160,11 @@ afterSymlink:
 		rp.Advance()
 		return d.parent, nil
 	}
+	if _, ok := d.children[name]; !ok && fs.opts.interop != InteropModeShared && !d.isSynthetic() {
+		if err := fs.prefetchChildrenLocked(ctx, rp, d, ds); err != nil {
+			return nil, err
+		}
+	}
 	child, err := fs.getChildLocked(ctx, rp.VirtualFilesystem(), d, name, ds)
 	if err != nil {
 		return nil, err
@@ -200,6 +207,11 @@ func (fs *filesystem) getChildLocked(ctx context.Context, vfsObj *vfs.VirtualFil
 		// assumed to be correct.
 		return child, nil
 	}
+	if ok && child == nil && fs.clock.Now().Nanoseconds() < parent.negativeChildrenExpiry[name] {
+		// InteropModeShared is in effect, but the negative lookup hasn't
+		// timed out yet.
+		return nil, nil
+	}
 	// We either don't have cached information or need to verify that it's
 	// still correct, either of which requires a remote lookup. Check if this
 	// name is valid before performing the lookup.
@@ -208,6 +220,7 @@ func (fs *filesystem) getChildLocked(ctx context.Context, vfsObj *vfs.VirtualFil
 
 // Preconditions: As for getChildLocked. !parent.isSynthetic().
 func (fs *filesystem) revalidateChildLocked(ctx context.Context, vfsObj *vfs.VirtualFilesystem, parent *dentry, name string, child *dentry, ds **[]*dentry) (*dentry, error) {
+	fs.asyncOps.waitName(parent, name)
 	qid, file, attrMask, attr, err := parent.file.walkGetAttrOne(ctx, name)
 	if err != nil && err != syserror.ENOENT {
 		return nil, err
@@ -264,6 +277,75 @@ func (fs *filesystem) revalidateChildLocked(ctx context.Context, vfsObj *vfs.Vir
 	return child, nil
 }
 
+// maxPrefetchComponents is the maximum number of path components that
+// prefetchChildrenLocked walks in a single round trip to the remote
+// filesystem.
+const maxPrefetchComponents = 64
+
+// prefetchChildrenLocked caches dentries for rp.Component() and as many of the
+// path components that follow it as possible, with a single remote walk,
+// rather than walking one component per round trip.
+//
+// Dentries are cached without checking that the caller may search the
+// directories containing them; stepLocked checks permissions on each cached
+// dentry as usual when it reaches it. If fewer than two components can be
+// walked together, prefetchChildrenLocked does nothing and getChildLocked
+// walks to the component alone.
+//
+// Preconditions: As for stepLocked. fs.opts.interop != InteropModeShared.
+// !parent.isSynthetic(). parent.children does not contain rp.Component().
+func (fs *filesystem) prefetchChildrenLocked(ctx context.Context, rp *vfs.ResolvingPath, parent *dentry, ds **[]*dentry) error {
+	var namesArr [maxPrefetchComponents]string
+	names := rp.PeekComponents(namesArr[:0], maxPrefetchComponents)
+	for i, name := range names {
+		if name == "." || name == ".." || len(name) > maxFilenameLen {
+			names = names[:i]
+			break
+		}
+	}
+	if len(names) < 2 {
+		return nil
+	}
+
+	fs.asyncOps.waitName(parent, names[0])
+	stats, files, err := parent.file.multiWalkGetAttr(ctx, names)
+	if err != nil {
+		if err == syserror.ENOENT {
+			parent.cacheNegativeLookupLocked(names[0])
+			return nil
+		}
+		return err
+	}
+	children := make([]*dentry, 0, len(files))
+	for i, file := range files {
+		child, err := fs.newDentry(ctx, file, stats[i].QID, stats[i].Valid, &stats[i].Attr)
+		if err != nil {
+			for _, file := range files[i:] {
+				file.close(ctx)
+			}
+			break
+		}
+		children = append(children, child)
+	}
+	if len(children) == 0 {
+		return nil
+	}
+
+	// Link the new dentries together from the deepest up, so that none of
+	// them is reachable until all of them are linked; this is why their
+	// dirMus need not be locked. For now, the deepest dentry has 0
+	// references, so our caller should call checkCachingLocked() on all of
+	// them.
+	for i := len(children) - 1; i > 0; i-- {
+		children[i-1].cacheNewChildLocked(children[i], names[i])
+	}
+	parent.cacheNewChildLocked(children[0], names[0])
+	for _, child := range children {
+		*ds = appendDentry(*ds, child)
+	}
+	return nil
+}
+
 // walkParentDirLocked resolves all but the last path component of rp to an
 // existing directory, starting from the given directory (which is usually
 // rp.Start().Impl().(*dentry)). It does not check that the returned directory
@@ -373,6 +455,7 @@ func (fs *filesystem) doCreateAt(ctx context.Context, rp *vfs.ResolvingPath, dir
 		parent.dirents = nil
 		return nil
 	}
+	fs.asyncOps.waitName(parent, name)
 	if fs.opts.interop == InteropModeShared {
 		// The existence of a dentry at name would be inconclusive because the
 		// file it represents may have been deleted from the remote filesystem,
@@ -381,7 +464,15 @@ func (fs *filesystem) doCreateAt(ctx context.Context, rp *vfs.ResolvingPath, dir
 		// will fail with EEXIST like we would have. If the RPC succeeds, and a
 		// stale dentry exists, the dentry will fail revalidation next time
 		// it's used.
-		return createInRemoteDir(parent, name)
+		if err := createInRemoteDir(parent, name); err != nil {
+			return err
+		}
+		if child, ok := parent.children[name]; ok && child == nil {
+			// Delete the now-stale negative dentry.
+			delete(parent.children, name)
+			delete(parent.negativeChildrenExpiry, name)
+		}
+		return nil
 	}
 	if child := parent.children[name]; child != nil {
 		return syserror.EEXIST
@@ -518,7 +609,20 @@ func (fs *filesystem) unlinkAt(ctx context.Context, rp *vfs.ResolvingPath, dir b
 		if child == nil {
 			return syserror.ENOENT
 		}
+	} else if fs.opts.interop == InteropModeExclusive && !dir && child != nil && !child.isSynthetic() {
+		// child is known to exist and not to be a directory, so the unlink
+		// can only fail due to an error on the remote filesystem, which
+		// will be reported by syncfs(2). Don't wait for it.
+		parentFile := parent.file
+		fs.asyncOps.start([]dentryName{{parent, name}}, []*dentry{parent}, func(ctx context.Context) error {
+			return parentFile.unlinkAt(ctx, name, flags)
+		})
 	} else {
+		fs.asyncOps.waitName(parent, name)
+		if child != nil && dir {
+			// The directory must be empty on the remote filesystem.
+			fs.asyncOps.waitDentry(child)
+		}
 		err = parent.file.unlinkAt(ctx, name, flags)
 		if err != nil {
 			if child != nil {
@@ -925,6 +1029,9 @@ func (d *dentry) createAndOpenChildLocked(ctx context.Context, rp *vfs.Resolving
 	}
 	defer mnt.EndWrite()
 
+	creds := rp.Credentials()
+	name := rp.Component()
+	d.fs.asyncOps.waitName(d, name)
 	// 9P2000.L's lcreate takes a fid representing the parent directory, and
 	// converts it into an open fid representing the created file, so we need
 	// to duplicate the directory fid first.
@@ -932,8 +1039,6 @@ func (d *dentry) createAndOpenChildLocked(ctx context.Context, rp *vfs.Resolving
 	if err != nil {
 		return nil, err
 	}
-	creds := rp.Credentials()
-	name := rp.Component()
 	// Filter file creation flags and O_LARGEFILE out; the create RPC already
 	// has the semantics of O_CREAT|O_EXCL, while some servers will choke on
 	// O_LARGEFILE.
@@ -1129,7 +1234,21 @@ func (fs *filesystem) RenameAt(ctx context.Context, rp *vfs.ResolvingPath, oldPa
 	}
 
 	// Update the remote filesystem.
-	if !renamed.isSynthetic() {
+	if !renamed.isSynthetic() && !renamed.isDir() && fs.opts.interop == InteropModeExclusive {
+		// All checks that the rename may fail have been done above, so it
+		// can only fail due to an error on the remote filesystem, which will
+		// be reported by syncfs(2). Don't wait for it.
+		renamedFile, newParentFile := renamed.file, newParent.file
+		fs.asyncOps.start([]dentryName{{oldParent, oldName}, {newParent, newName}}, []*dentry{renamed, oldParent, newParent}, func(ctx context.Context) error {
+			return renamedFile.rename(ctx, newParentFile, newName)
+		})
+	} else if !renamed.isSynthetic() {
+		fs.asyncOps.waitName(oldParent, oldName)
+		fs.asyncOps.waitName(newParent, newName)
+		if replaced != nil && replaced.isDir() {
+			// The replaced directory must be empty on the remote filesystem.
+			fs.asyncOps.waitDentry(replaced)
+		}
 		if err := renamed.file.rename(ctx, newParent.file, newName); err != nil {
 			vfsObj.AbortRenameDentry(&renamed.vfsd, replacedVFSD)
 			return err
@@ -1140,7 +1259,9 @@ func (fs *filesystem) RenameAt(ctx context.Context, rp *vfs.ResolvingPath, oldPa
 		flags := uint32(0)
 		if replaced.isDir() {
 			flags = linux.AT_REMOVEDIR
+			fs.asyncOps.waitDentry(replaced)
 		}
+		fs.asyncOps.waitName(newParent, newName)
 		if err := newParent.file.unlinkAt(ctx, newName, flags); err != nil {
 			vfsObj.AbortRenameDentry(&renamed.vfsd, replacedVFSD)
 			return err
@@ -20,6 +20,7 @@
 //     filesystem.renameMu
 //       dentry.dirMu
 //         filesystem.syncMu
+//         asyncMetadataOps.mu
 //         dentry.metadataMu
 //           *** "memmap.Mappable locks" below this point
 //           dentry.mapsMu
@@ -39,6 +40,7 @@ import (
 	"sync"
 	"sync/atomic"
 	"syscall"
+	"time"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/context"
@@ -109,6 +111,10 @@ type filesystem struct {
 	syncMu           sync.Mutex
 	syncableDentries map[*dentry]struct{}
 	specialFileFDs   map[*specialFileFD]struct{}
+
+	// asyncOps tracks outstanding asynchronous unlinks and renames, which are
+	// only used under InteropModeExclusive.
+	asyncOps asyncMetadataOps
 }
 
 type filesystemOptions struct {
@@ -125,6 +131,13 @@ type filesystemOptions struct {
 	// retained by the client.
 	maxCachedDentries uint64
 
+	// If InteropModeShared is in effect, negativeLookupTimeout is how long
+	// the client may assume that a file found not to exist still doesn't
+	// exist before it must ask the server again. If negativeLookupTimeout is
+	// 0, negative lookups are not cached. In other interop modes, negative
+	// lookups are cached until the dentry is evicted.
+	negativeLookupTimeout time.Duration
+
 	// If forcePageCache is true, host FDs may not be used for application
 	// memory mappings even if available; instead, the client must perform its
 	// own caching of regular file pages. This is primarily useful for testing.
@@ -376,6 +389,17 @@ func (fstype FilesystemType) GetFilesystem(ctx context.Context, vfsObj *vfs.Virt
 		fsopts.maxCachedDentries = maxCachedDentries
 	}
 
+	// Parse the negative lookup timeout.
+	if str, ok := mopts["negative_lookup_timeout"]; ok {
+		delete(mopts, "negative_lookup_timeout")
+		timeout, err := time.ParseDuration(str)
+		if err != nil || timeout < 0 {
+			ctx.Warningf("gofer.FilesystemType.GetFilesystem: invalid negative lookup timeout: negative_lookup_timeout=%s", str)
+			return nil, nil, syserror.EINVAL
+		}
+		fsopts.negativeLookupTimeout = timeout
+	}
+
 	// Handle simple flags.
 	if _, ok := mopts["force_page_cache"]; ok {
 		delete(mopts, "force_page_cache")
@@ -455,6 +479,7 @@ func (fstype FilesystemType) GetFilesystem(ctx context.Context, vfsObj *vfs.Virt
 		syncableDentries: make(map[*dentry]struct{}),
 		specialFileFDs:   make(map[*specialFileFD]struct{}),
 	}
+	fs.asyncOps.init()
 	fs.vfsfs.Init(vfsObj, &fstype, fs)
 
 	// Construct the root dentry.
@@ -478,6 +503,8 @@ func (fs *filesystem) Release() {
 	ctx := context.Background()
 	mf := fs.mfp.MemoryFile()
 
+	fs.asyncOps.waitAll()
+
 	fs.syncMu.Lock()
 	for d := range fs.syncableDentries {
 		d.handleMu.Lock()
@@ -564,12 +591,19 @@ type dentry struct {
 	// - Mappings of child filenames to dentries representing those children.
 	//
 	// - Mappings of child filenames that are known not to exist to nil
-	// dentries (only if InteropModeShared is not in effect and the directory
-	// is not synthetic).
+	// dentries (only if the directory is not synthetic, and, if
+	// InteropModeShared is in effect, only if
+	// filesystemOptions.negativeLookupTimeout is non-zero).
 	//
 	// children is protected by dirMu.
 	children map[string]*dentry
 
+	// If this dentry represents a directory and InteropModeShared is in
+	// effect, negativeChildrenExpiry maps the names of nil entries in children
+	// to the time, according to filesystem.clock, after which they must be
+	// revalidated. negativeChildrenExpiry is protected by dirMu.
+	negativeChildrenExpiry map[string]int64
+
 	// If this dentry represents a directory, syntheticChildren is the number
 	// of child dentries for which dentry.isSynthetic() == true.
 	// syntheticChildren is protected by dirMu.
@@ -581,6 +615,10 @@ type dentry struct {
 	// returned by the server. dirents is protected by dirMu.
 	dirents []vfs.Dirent
 
+	// If dentry.cachedMetadataAuthoritative() == true, xattrCache caches the
+	// file's extended attributes.
+	xattrCache fsutil.XattrCache
+
 	// Cached metadata; protected by metadataMu and accessed using atomic
 	// memory operations unless otherwise specified.
 	metadataMu sync.Mutex
@@ -646,6 +684,11 @@ type dentry struct {
 	// tracks dirty segments in cache. dirty is protected by dataMu.
 	dirty fsutil.DirtySet
 
+	// writeBackPending is the number of bytes written to cache by writes
+	// since dirty data was last written back by a write. writeBackPending is
+	// protected by dataMu.
+	writeBackPending uint64
+
 	// pf implements platform.File for mappings of handle.fd.
 	pf dentryPlatformFile
 
@@ -1166,6 +1209,8 @@ func (d *dentry) destroyLocked() {
 	d.handleMu.Unlock()
 
 	if !d.file.isNil() {
+		// Outstanding asynchronous operations may still be using d.file.
+		d.fs.asyncOps.waitDentry(d)
 		d.file.close(ctx)
 		d.file = p9file{}
 		// Remove d from the set of syncable dentries.
@@ -1198,7 +1243,7 @@ func (d *dentry) listxattr(ctx context.Context, creds *auth.Credentials, size ui
 	if d.file.isNil() {
 		return nil, nil
 	}
-	xattrMap, err := d.file.listXattr(ctx, size)
+	xattrMap, err := d.listxattrCached(ctx, size)
 	if err != nil {
 		return nil, err
 	}
@@ -1221,7 +1266,21 @@ func (d *dentry) getxattr(ctx context.Context, creds *auth.Credentials, opts *vf
 	if !strings.HasPrefix(opts.Name, linux.XATTR_USER_PREFIX) {
 		return "", syserror.EOPNOTSUPP
 	}
-	return d.file.getXattr(ctx, opts.Name, opts.Size)
+	if !d.cachedMetadataAuthoritative() {
+		return d.file.getXattr(ctx, opts.Name, opts.Size)
+	}
+	return d.xattrCache.Get(opts.Name, func() (string, error) {
+		return d.file.getXattr(ctx, opts.Name, opts.Size)
+	})
+}
+
+func (d *dentry) listxattrCached(ctx context.Context, size uint64) (map[string]struct{}, error) {
+	if !d.cachedMetadataAuthoritative() {
+		return d.file.listXattr(ctx, size)
+	}
+	return d.xattrCache.List(func() (map[string]struct{}, error) {
+		return d.file.listXattr(ctx, size)
+	})
 }
 
 func (d *dentry) setxattr(ctx context.Context, creds *auth.Credentials, opts *vfs.SetxattrOptions) error {
@@ -1234,6 +1293,7 @@ func (d *dentry) setxattr(ctx context.Context, creds *auth.Credentials, opts *vf
 	if !strings.HasPrefix(opts.Name, linux.XATTR_USER_PREFIX) {
 		return syserror.EOPNOTSUPP
 	}
+	defer d.xattrCache.Invalidate()
 	return d.file.setXattr(ctx, opts.Name, opts.Value, opts.Flags)
 }
 
@@ -1247,6 +1307,7 @@ func (d *dentry) removexattr(ctx context.Context, creds *auth.Credentials, name
 	if !strings.HasPrefix(name, linux.XATTR_USER_PREFIX) {
 		return syserror.EOPNOTSUPP
 	}
+	defer d.xattrCache.Invalidate()
 	return d.file.removeXattr(ctx, name)
 }
 
@@ -17,9 +17,11 @@ package gofer
 import (
 	"sync/atomic"
 	"testing"
+	"time"
 
 	"gvisor.dev/gvisor/pkg/p9"
 	"gvisor.dev/gvisor/pkg/sentry/contexttest"
+	ktime "gvisor.dev/gvisor/pkg/sentry/kernel/time"
 )
 
 func TestDestroyIdempotent(t *testing.T) {
@@ -61,3 +63,59 @@ func TestDestroyIdempotent(t *testing.T) {
 	child.checkCachingLocked()
 	child.checkCachingLocked()
 }
+
+// fakeClock is a ktime.Clock whose time only changes when set.
+type fakeClock struct {
+	ktime.WallRateClock
+	ktime.NoClockEvents
+	now int64
+}
+
+// Now implements ktime.Clock.Now.
+func (c *fakeClock) Now() ktime.Time {
+	return ktime.FromNanoseconds(c.now)
+}
+
+// unreachableFile is a non-nil p9.File that panics if the server is used.
+type unreachableFile struct {
+	p9.File
+}
+
+func TestNegativeLookupTimeout(t *testing.T) {
+	clock := &fakeClock{}
+	fs := filesystem{
+		syncableDentries: make(map[*dentry]struct{}),
+		clock:            clock,
+		opts: filesystemOptions{
+			interop:               InteropModeShared,
+			negativeLookupTimeout: time.Second,
+		},
+	}
+
+	ctx := contexttest.Context(t)
+	attr := &p9.Attr{
+		Mode: p9.ModeDirectory,
+	}
+	mask := p9.AttrMask{
+		Mode: true,
+	}
+	parent, err := fs.newDentry(ctx, p9file{unreachableFile{}}, p9.QID{}, mask, attr)
+	if err != nil {
+		t.Fatalf("fs.newDentry(): %v", err)
+	}
+	parent.cacheNegativeLookupLocked("missing")
+
+	// Before the timeout, the lookup is answered without revalidation, which
+	// would panic on unreachableFile.
+	var ds *[]*dentry
+	clock.now = int64(time.Second) - 1
+	child, err := fs.getChildLocked(ctx, nil, parent, "missing", &ds)
+	if child != nil || err != nil {
+		t.Fatalf("getChildLocked() = (%v, %v), want (nil, nil)", child, err)
+	}
+
+	// From the timeout on, the negative entry must be revalidated.
+	if got, want := parent.negativeChildrenExpiry["missing"], int64(time.Second); got != want {
+		t.Errorf("negative entry expires at %d, want %d", got, want)
+	}
+}
@@ -64,6 +64,28 @@ func (f p9file) walkGetAttrOne(ctx context.Context, name string) (p9.QID, p9file
 	return qids[0], p9file{newfile}, attrMask, attr, nil
 }
 
+// multiWalkGetAttr is a wrapper around p9.File.MultiWalkGetAttr.
+func (f p9file) multiWalkGetAttr(ctx context.Context, names []string) ([]p9.FullStat, []p9file, error) {
+	ctx.UninterruptibleSleepStart(false)
+	stats, newfiles, err := f.file.MultiWalkGetAttr(names)
+	ctx.UninterruptibleSleepFinish(false)
+	if err != nil {
+		return nil, nil, err
+	}
+	files := make([]p9file, len(newfiles))
+	for i, newfile := range newfiles {
+		files[i] = p9file{newfile}
+	}
+	if len(stats) != len(files) || len(files) > len(names) {
+		ctx.Warningf("p9.File.MultiWalkGetAttr returned %d stats and %d files for %d names, wanted at most %d of each", len(stats), len(files), len(names), len(names))
+		for _, file := range files {
+			file.close(ctx)
+		}
+		return nil, nil, syserror.EIO
+	}
+	return stats, files, nil
+}
+
 func (f p9file) statFS(ctx context.Context) (p9.FSStat, error) {
 	ctx.UninterruptibleSleepStart(false)
 	fsstat, err := f.file.StatFS()
@@ -120,21 +120,41 @@ func (fd *regularFileFD) Read(ctx context.Context, dst usermem.IOSequence, opts
 
 // PWrite implements vfs.FileDescriptionImpl.PWrite.
 func (fd *regularFileFD) PWrite(ctx context.Context, src usermem.IOSequence, offset int64, opts vfs.WriteOptions) (int64, error) {
+	n, _, err := fd.pwrite(ctx, src, offset, opts)
+	return n, err
+}
+
+// pwrite returns the file offset after the operation. If O_APPEND is in
+// effect, the write goes to the end of the file regardless of offset; since
+// d.metadataMu is locked from reading d.size until the write is complete,
+// appends by concurrent writers are never interleaved.
+func (fd *regularFileFD) pwrite(ctx context.Context, src usermem.IOSequence, offset int64, opts vfs.WriteOptions) (written, finalOff int64, err error) {
 	if offset < 0 {
-		return 0, syserror.EINVAL
+		return 0, offset, syserror.EINVAL
 	}
 	if opts.Flags != 0 {
-		return 0, syserror.EOPNOTSUPP
+		return 0, offset, syserror.EOPNOTSUPP
+	}
+
+	d := fd.dentry()
+	if fd.vfsfd.StatusFlags()&linux.O_APPEND != 0 && d.fs.opts.interop == InteropModeShared {
+		// d.size may be stale. Appends by other clients of the remote file
+		// can still be interleaved with this one, as in VFS1.
+		if err := d.updateFromGetattr(ctx); err != nil {
+			return 0, offset, err
+		}
+	}
+	d.metadataMu.Lock()
+	defer d.metadataMu.Unlock()
+	if fd.vfsfd.StatusFlags()&linux.O_APPEND != 0 {
+		offset = int64(d.size)
 	}
 	limit, err := vfs.CheckLimit(ctx, offset, src.NumBytes())
 	if err != nil {
-		return 0, err
+		return 0, offset, err
 	}
 	src = src.TakeFirst64(limit)
 
-	d := fd.dentry()
-	d.metadataMu.Lock()
-	defer d.metadataMu.Unlock()
 	if d.fs.opts.interop != InteropModeShared {
 		// Compare Linux's mm/filemap.c:__generic_file_write_iter() =>
 		// file_update_time(). This is d.touchCMtime(), but without locking
@@ -145,13 +165,13 @@ func (fd *regularFileFD) PWrite(ctx context.Context, src usermem.IOSequence, off
 		// Write dirty cached pages that will be touched by the write back to
 		// the remote file.
 		if err := d.writeback(ctx, offset, src.NumBytes()); err != nil {
-			return 0, err
+			return 0, offset, err
 		}
 		// Remove touched pages from the cache.
 		pgstart := usermem.PageRoundDown(uint64(offset))
 		pgend, ok := usermem.PageRoundUp(uint64(offset + src.NumBytes()))
 		if !ok {
-			return 0, syserror.EINVAL
+			return 0, offset, syserror.EINVAL
 		}
 		mr := memmap.MappableRange{pgstart, pgend}
 		var freed []platform.FileRange
@@ -184,21 +204,21 @@ func (fd *regularFileFD) PWrite(ctx context.Context, src usermem.IOSequence, off
 		// Write dirty cached pages touched by the write back to the remote
 		// file.
 		if err := d.writeback(ctx, offset, src.NumBytes()); err != nil {
-			return 0, err
+			return 0, offset, err
 		}
 		// Request the remote filesystem to sync the remote file.
 		if err := d.handle.file.fsync(ctx); err != nil {
-			return 0, err
+			return 0, offset, err
 		}
 	}
-	return n, err
+	return n, offset + n, err
 }
 
 // Write implements vfs.FileDescriptionImpl.Write.
 func (fd *regularFileFD) Write(ctx context.Context, src usermem.IOSequence, opts vfs.WriteOptions) (int64, error) {
 	fd.mu.Lock()
-	n, err := fd.PWrite(ctx, src, fd.off, opts)
-	fd.off += n
+	n, off, err := fd.pwrite(ctx, src, fd.off, opts)
+	fd.off = off
 	fd.mu.Unlock()
 	return n, err
 }
@@ -410,6 +430,9 @@ func (rw *dentryReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, erro
 			rw.off += n
 			srcs = srcs.DropFirst64(n)
 			rw.d.dirty.MarkDirty(segMR)
+			if rw.d.fs.opts.interop == InteropModeExclusive {
+				rw.d.writeBackPending += n
+			}
 			if err != nil {
 				retErr = err
 				goto exitLoop
@@ -419,11 +442,17 @@ func (rw *dentryReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, erro
 			seg, gap = seg.NextNonEmpty()
 
 		case gap.Ok():
-			// Write directly to the file. At present, we never fill the cache
-			// when writing, since doing so can convert small writes into
+			gapMR := gap.Range().Intersect(mr)
+			if rw.maybeCacheWrite(gap, gapMR) {
+				// Re-enter the loop to write to the cache.
+				seg, gap = rw.d.cache.Find(rw.off)
+				continue
+			}
+
+			// Write directly to the file. We never fill the cache for writes
+			// to existing data, since doing so can convert small writes into
 			// inefficient read-modify-write cycles, and we have no mechanism
 			// for detecting or avoiding this.
-			gapMR := gap.Range().Intersect(mr)
 			gapSrcs := srcs.TakeFirst64(gapMR.Length())
 			n, err := rw.d.handle.writeFromBlocksAt(rw.ctx, gapSrcs, gapMR.Start)
 			done += n
@@ -445,6 +474,7 @@ exitLoop:
 		// The remote file's size will implicitly be extended to the correct
 		// value when we write back to it.
 	}
+	rw.maybeWriteBack()
 	// If InteropModeWritethrough is in effect, flush written data back to the
 	// remote filesystem.
 	if rw.d.fs.opts.interop == InteropModeWritethrough && done != 0 {
@@ -463,6 +493,70 @@ exitLoop:
 	return done, retErr
 }
 
+// maybeCacheWrite inserts pages for a write to gapMR into the cache, so that
+// the write is buffered there and written back to the remote file later, and
+// returns true if it did so.
+//
+// As in VFS1, only small writes after the existing data in the file, as made
+// by logs, are buffered. Since pages past the end of the file are known to be
+// zeroed, only the last page of existing data may need to be read first, once.
+//
+// Preconditions: rw.d.metadataMu and rw.d.dataMu must be locked. gapMR must be
+// a non-empty subset of gap.Range().
+func (rw *dentryReadWriter) maybeCacheWrite(gap fsutil.FileRangeGapIterator, gapMR memmap.MappableRange) bool {
+	d := rw.d
+	mf := d.fs.mfp.MemoryFile()
+	if d.fs.opts.interop != InteropModeExclusive || !mf.ShouldCacheEvictable() || gapMR.Length() > maxBufferedWrite {
+		return false
+	}
+	lastPage := usermem.PageRoundDown(d.size)
+	if gapMR.Start < lastPage {
+		return false
+	}
+	mr := memmap.MappableRange{
+		Start: lastPage,
+		End:   lastPage + usermem.PageSize,
+	}
+	if gapMR.Start >= mr.End || lastPage == d.size {
+		// No existing data is overwritten.
+		end, ok := usermem.PageRoundUp(gapMR.End)
+		if !ok {
+			return false
+		}
+		mr = memmap.MappableRange{
+			Start: usermem.PageRoundDown(gapMR.Start),
+			End:   end,
+		}
+		fr, err := mf.Allocate(mr.Length(), usage.PageCache)
+		if err != nil {
+			return false
+		}
+		d.cache.Insert(gap, mr, fr.Start)
+	} else if err := d.cache.Fill(rw.ctx, mr, mr, mf, usage.PageCache, d.handle.readToBlocksAt); err != nil && !d.cache.FindSegment(mr.Start).Ok() {
+		return false
+	}
+	mf.MarkEvictable(d, pgalloc.EvictableRange{mr.Start, mr.End})
+	return true
+}
+
+// maybeWriteBack writes back all dirty data once enough has been written to
+// the cache since the last write back, bounding the amount of buffered data
+// while batching it into large writes to the remote file.
+//
+// Preconditions: rw.d.dataMu must be locked.
+func (rw *dentryReadWriter) maybeWriteBack() {
+	d := rw.d
+	if d.writeBackPending < maxWriteBackPending {
+		return
+	}
+	d.writeBackPending = 0
+	if err := fsutil.SyncDirtyAll(rw.ctx, &d.cache, &d.dirty, d.size, d.fs.mfp.MemoryFile(), d.handle.writeFromBlocksAt); err != nil {
+		// The data remains dirty, so it will be written back again by
+		// fsync or when the dentry is destroyed.
+		log.Warningf("Failed to writeback cached data: %v", err)
+	}
+}
+
 func (d *dentry) writeback(ctx context.Context, offset, size int64) error {
 	if size == 0 {
 		return nil
@@ -729,6 +823,17 @@ func (d *dentry) Translate(ctx context.Context, required, optional memmap.Mappab
 	return ts, nil
 }
 
+const (
+	// maxBufferedWrite is the largest write that may be buffered in the cache
+	// by dentryReadWriter.maybeCacheWrite. Larger writes are efficient enough
+	// when written through.
+	maxBufferedWrite = 64 << 10
+
+	// maxWriteBackPending is the number of bytes that may be written to the
+	// cache before dirty data is written back by a write.
+	maxWriteBackPending = 4 << 20
+)
+
 func maxFillRange(required, optional memmap.MappableRange) memmap.MappableRange {
 	const maxReadahead = 64 << 10 // 64 KB, chosen arbitrarily
 	if required.Length() >= maxReadahead {
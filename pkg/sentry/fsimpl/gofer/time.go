@@ -43,7 +43,9 @@ func (d *dentry) touchAtime(mnt *vfs.Mount) {
 	}
 	now := d.fs.clock.Now().Nanoseconds()
 	d.metadataMu.Lock()
-	atomic.StoreInt64(&d.atime, now)
+	if mnt.NeedsATimeUpdate(atomic.LoadInt64(&d.atime), atomic.LoadInt64(&d.mtime), atomic.LoadInt64(&d.ctime), now) {
+		atomic.StoreInt64(&d.atime, now)
+	}
 	d.metadataMu.Unlock()
 	mnt.EndWrite()
 }
@@ -0,0 +1,93 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package perfevent implements perf_event_open(2) file descriptions.
+package perfevent
+
+import (
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/vfs"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// PerfEventFileDescription implements FileDescriptionImpl for perf events.
+type PerfEventFileDescription struct {
+	vfsfd vfs.FileDescription
+	vfs.FileDescriptionDefaultImpl
+	vfs.DentryMetadataFileDescriptionImpl
+
+	event *kernel.PerfEvent
+}
+
+var _ vfs.FileDescriptionImpl = (*PerfEventFileDescription)(nil)
+
+// New creates a new perf event file description for e, which it takes
+// ownership of if it succeeds.
+func New(vfsObj *vfs.VirtualFilesystem, e *kernel.PerfEvent, flags uint32) (*vfs.FileDescription, error) {
+	vd := vfsObj.NewAnonVirtualDentry("[perf_event]")
+	defer vd.DecRef()
+	pfd := &PerfEventFileDescription{
+		event: e,
+	}
+	if err := pfd.vfsfd.Init(pfd, flags, vd.Mount(), vd.Dentry(), &vfs.FileDescriptionOptions{
+		UseDentryMetadata: true,
+		DenyPRead:         true,
+		DenyPWrite:        true,
+	}); err != nil {
+		return nil, err
+	}
+	return &pfd.vfsfd, nil
+}
+
+// Read implements FileDescriptionImpl.Read.
+func (pfd *PerfEventFileDescription) Read(ctx context.Context, dst usermem.IOSequence, _ vfs.ReadOptions) (int64, error) {
+	return pfd.event.Read(ctx, dst)
+}
+
+// Ioctl implements FileDescriptionImpl.Ioctl.
+func (pfd *PerfEventFileDescription) Ioctl(ctx context.Context, uio usermem.IO, args arch.SyscallArguments) (uintptr, error) {
+	return pfd.event.Ioctl(ctx, uio, args)
+}
+
+// ConfigureMMap implements FileDescriptionImpl.ConfigureMMap.
+func (pfd *PerfEventFileDescription) ConfigureMMap(ctx context.Context, opts *memmap.MMapOpts) error {
+	if err := pfd.event.ConfigureMMap(opts); err != nil {
+		return err
+	}
+	return vfs.GenericConfigureMMap(&pfd.vfsfd, pfd.event, opts)
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (pfd *PerfEventFileDescription) Readiness(mask waiter.EventMask) waiter.EventMask {
+	return pfd.event.Readiness(mask)
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (pfd *PerfEventFileDescription) EventRegister(e *waiter.Entry, mask waiter.EventMask) {
+	pfd.event.EventRegister(e, mask)
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (pfd *PerfEventFileDescription) EventUnregister(e *waiter.Entry) {
+	pfd.event.EventUnregister(e)
+}
+
+// Release implements FileDescriptionImpl.Release.
+func (pfd *PerfEventFileDescription) Release() {
+	pfd.event.Release()
+}
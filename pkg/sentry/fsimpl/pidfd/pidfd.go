@@ -0,0 +1,77 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package pidfd implements process file descriptions.
+package pidfd
+
+import (
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/vfs"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// PIDFileDescription implements FileDescriptionImpl for pidfds.
+type PIDFileDescription struct {
+	vfsfd vfs.FileDescription
+	vfs.FileDescriptionDefaultImpl
+	vfs.DentryMetadataFileDescriptionImpl
+
+	// tg is the thread group that the file refers to. tg is immutable.
+	tg *kernel.ThreadGroup
+}
+
+var _ vfs.FileDescriptionImpl = (*PIDFileDescription)(nil)
+
+// New creates a new pidfd referring to tg.
+func New(vfsObj *vfs.VirtualFilesystem, tg *kernel.ThreadGroup, flags uint32) (*vfs.FileDescription, error) {
+	vd := vfsObj.NewAnonVirtualDentry("[pidfd]")
+	defer vd.DecRef()
+	pfd := &PIDFileDescription{
+		tg: tg,
+	}
+	if err := pfd.vfsfd.Init(pfd, flags, vd.Mount(), vd.Dentry(), &vfs.FileDescriptionOptions{
+		UseDentryMetadata: true,
+		DenyPRead:         true,
+		DenyPWrite:        true,
+	}); err != nil {
+		return nil, err
+	}
+	return &pfd.vfsfd, nil
+}
+
+// ThreadGroup returns the thread group that the file refers to.
+func (pfd *PIDFileDescription) ThreadGroup() *kernel.ThreadGroup {
+	return pfd.tg
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (pfd *PIDFileDescription) Readiness(mask waiter.EventMask) waiter.EventMask {
+	if mask&waiter.EventIn != 0 && pfd.tg.Exited() {
+		return waiter.EventIn
+	}
+	return 0
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (pfd *PIDFileDescription) EventRegister(e *waiter.Entry, _ waiter.EventMask) {
+	pfd.tg.ExitEventRegister(e)
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (pfd *PIDFileDescription) EventUnregister(e *waiter.Entry) {
+	pfd.tg.ExitEventUnregister(e)
+}
+
+// Release implements FileDescriptionImpl.Release.
+func (pfd *PIDFileDescription) Release() {}
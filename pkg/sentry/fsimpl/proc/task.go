@@ -67,9 +67,11 @@ func (fs *filesystem) newTaskInode(task *kernel.Task, pidns *kernel.PIDNamespace
 		"oom_score":     fs.newTaskOwnedFile(task, fs.NextIno(), 0444, newStaticFile("0\n")),
 		"oom_score_adj": fs.newTaskOwnedFile(task, fs.NextIno(), 0644, &oomScoreAdj{task: task}),
 		"smaps":         fs.newTaskOwnedFile(task, fs.NextIno(), 0444, &smapsData{task: task}),
+		"smaps_rollup":  fs.newTaskOwnedFile(task, fs.NextIno(), 0444, &smapsRollupData{task: task}),
 		"stat":          fs.newTaskOwnedFile(task, fs.NextIno(), 0444, &taskStatData{task: task, pidns: pidns, tgstats: isThreadGroup}),
 		"statm":         fs.newTaskOwnedFile(task, fs.NextIno(), 0444, &statmData{task: task}),
 		"status":        fs.newTaskOwnedFile(task, fs.NextIno(), 0444, &statusData{task: task, pidns: pidns}),
+		"syscall_stats": fs.newTaskOwnedFile(task, fs.NextIno(), 0400, newSyscallStats(task, isThreadGroup)),
 		"uid_map":       fs.newTaskOwnedFile(task, fs.NextIno(), 0644, &idMapData{task: task, gids: false}),
 	}
 	if isThreadGroup {
@@ -217,6 +219,13 @@ func newIO(t *kernel.Task, isThreadGroup bool) *ioData {
 	return &ioData{ioUsage: t}
 }
 
+func newSyscallStats(t *kernel.Task, isThreadGroup bool) *syscallStatsData {
+	if isThreadGroup {
+		return &syscallStatsData{syscallStatsSource: t.ThreadGroup(), task: t}
+	}
+	return &syscallStatsData{syscallStatsSource: t, task: t}
+}
+
 // newCgroupData creates inode that shows cgroup information.
 // From man 7 cgroups: "For each cgroup hierarchy of which the process is a
 // member, there is one entry containing three colon-separated fields:
@@ -17,7 +17,7 @@ package proc
 import (
 	"bytes"
 	"fmt"
-	"sort"
+	"math"
 	"strconv"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
@@ -52,6 +52,10 @@ func taskFDExists(t *kernel.Task, fd int32) bool {
 	return true
 }
 
+// fdDirBatch is the maximum number of fds fetched from the FD table at once by
+// fdDir.IterDirents.
+const fdDirBatch = 128
+
 type fdDir struct {
 	fs   *filesystem
 	task *kernel.Task
@@ -63,37 +67,44 @@ type fdDir struct {
 
 // IterDirents implements kernfs.inodeDynamicLookup.
 func (i *fdDir) IterDirents(ctx context.Context, cb vfs.IterDirentsCallback, absOffset, relOffset int64) (int64, error) {
-	var fds []int32
-	i.task.WithMuLocked(func(t *kernel.Task) {
-		if fdTable := t.FDTable(); fdTable != nil {
-			fds = fdTable.GetFDs()
-		}
-	})
-
 	offset := absOffset + relOffset
-	typ := uint8(linux.DT_REG)
-	if i.produceSymlink {
-		typ = linux.DT_LNK
-	}
-
-	// Find the appropriate starting point.
-	idx := sort.Search(len(fds), func(i int) bool { return fds[i] >= int32(relOffset) })
-	if idx >= len(fds) {
+	if relOffset > math.MaxInt32 {
 		return offset, nil
 	}
-	for _, fd := range fds[idx:] {
-		dirent := vfs.Dirent{
-			Name:    strconv.FormatUint(uint64(fd), 10),
-			Type:    typ,
-			Ino:     i.fs.NextIno(),
-			NextOff: offset + 1,
+	typ := uint8(linux.DT_LNK)
+	if !i.produceSymlink {
+		typ = linux.DT_REG
+	}
+
+	next := int32(relOffset)
+	for {
+		// Fetch the fds in batches, so that each getdents costs time
+		// proportional to the number of entries it emits rather than the
+		// size of the table.
+		var fds []int32
+		i.task.WithMuLocked(func(t *kernel.Task) {
+			if fdTable := t.FDTable(); fdTable != nil {
+				fds = fdTable.GetFDsFrom(next, fdDirBatch)
+			}
+		})
+		if len(fds) == 0 {
+			return offset, nil
 		}
-		if err := cb.Handle(dirent); err != nil {
-			return offset, err
+
+		for _, fd := range fds {
+			dirent := vfs.Dirent{
+				Name:    strconv.FormatUint(uint64(fd), 10),
+				Type:    typ,
+				Ino:     i.fs.NextIno(),
+				NextOff: offset + 1,
+			}
+			if err := cb.Handle(dirent); err != nil {
+				return offset, err
+			}
+			offset++
 		}
-		offset++
+		next = fds[len(fds)-1] + 1
 	}
-	return offset, nil
 }
 
 // fdDirInode represents the inode for /proc/[pid]/fd directory.
@@ -346,6 +346,26 @@ func (d *smapsData) Generate(ctx context.Context, buf *bytes.Buffer) error {
 	return nil
 }
 
+// smapsRollupData implements vfs.DynamicBytesSource for
+// /proc/[pid]/smaps_rollup.
+//
+// +stateify savable
+type smapsRollupData struct {
+	kernfs.DynamicBytesFile
+
+	task *kernel.Task
+}
+
+var _ dynamicInode = (*smapsRollupData)(nil)
+
+// Generate implements vfs.DynamicBytesSource.Generate.
+func (d *smapsRollupData) Generate(ctx context.Context, buf *bytes.Buffer) error {
+	if mm := getMM(d.task); mm != nil {
+		mm.ReadSmapsRollupDataInto(ctx, buf)
+	}
+	return nil
+}
+
 // +stateify savable
 type taskStatData struct {
 	kernfs.DynamicBytesFile
@@ -538,6 +558,53 @@ func (i *ioData) Generate(ctx context.Context, buf *bytes.Buffer) error {
 	return nil
 }
 
+// syscallStatsSource is the /proc/[pid]/syscall_stats and
+// /proc/[pid]/task/[tid]/syscall_stats data provider.
+type syscallStatsSource interface {
+	// SyscallStats returns per-syscall statistics.
+	SyscallStats() []kernel.SyscallStat
+}
+
+// syscallStatsData implements vfs.DynamicBytesSource for
+// /proc/[pid]/syscall_stats and /proc/[pid]/task/[tid]/syscall_stats, which
+// are gVisor-specific files that report the number of times each syscall has
+// been executed and the time spent executing it in the sentry.
+//
+// +stateify savable
+type syscallStatsData struct {
+	kernfs.DynamicBytesFile
+
+	syscallStatsSource
+
+	// task is used to look up syscall names.
+	task *kernel.Task
+}
+
+var _ dynamicInode = (*syscallStatsData)(nil)
+
+// Generate implements vfs.DynamicBytesSource.Generate.
+func (s *syscallStatsData) Generate(ctx context.Context, buf *bytes.Buffer) error {
+	writeSyscallStats(buf, s.task, s.SyscallStats())
+	return nil
+}
+
+// writeSyscallStats writes stats to buf, one syscall per line, naming
+// syscalls using t's syscall table.
+func writeSyscallStats(buf *bytes.Buffer, t *kernel.Task, stats []kernel.SyscallStat) {
+	var table *kernel.SyscallTable
+	t.WithMuLocked(func(t *kernel.Task) {
+		table = t.SyscallTable()
+	})
+	fmt.Fprintf(buf, "sysno name count sentry_ns\n")
+	for _, stat := range stats {
+		name := fmt.Sprintf("sys_%d", stat.Sysno)
+		if table != nil {
+			name = table.LookupName(stat.Sysno)
+		}
+		fmt.Fprintf(buf, "%d %s %d %d\n", stat.Sysno, name, stat.Count, stat.SentryTime.Nanoseconds())
+	}
+}
+
 // oomScoreAdj is a stub of the /proc/<pid>/oom_score_adj file.
 //
 // +stateify savable
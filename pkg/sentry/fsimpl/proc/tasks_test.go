@@ -83,9 +83,11 @@ var (
 		"oom_score":     linux.DT_REG,
 		"oom_score_adj": linux.DT_REG,
 		"smaps":         linux.DT_REG,
+		"smaps_rollup":  linux.DT_REG,
 		"stat":          linux.DT_REG,
 		"statm":         linux.DT_REG,
 		"status":        linux.DT_REG,
+		"syscall_stats": linux.DT_REG,
 		"task":          linux.DT_DIR,
 		"uid_map":       linux.DT_REG,
 	}
@@ -84,26 +84,35 @@ func (sfd *SignalFileDescription) SetMask(mask linux.SignalSet) {
 
 // Read implements FileDescriptionImpl.Read.
 func (sfd *SignalFileDescription) Read(ctx context.Context, dst usermem.IOSequence, _ vfs.ReadOptions) (int64, error) {
-	// Attempt to dequeue relevant signals.
-	info, err := sfd.target.Sigtimedwait(sfd.Mask(), 0)
-	if err != nil {
+	// Dequeue as many relevant signals as fit in dst, as Linux does, so that
+	// callers draining a burst of signals need only one read.
+	max := int(dst.NumBytes() / linux.SizeOfSignalfdSiginfo)
+	if max == 0 {
+		return 0, syserror.EINVAL
+	}
+	infos := sfd.target.DequeueSignals(sfd.Mask(), max)
+	if len(infos) == 0 {
 		// There must be no signal available.
 		return 0, syserror.ErrWouldBlock
 	}
 
 	// Copy out the signal info using the specified format.
-	var buf [128]byte
-	binary.Marshal(buf[:0], usermem.ByteOrder, &linux.SignalfdSiginfo{
-		Signo:   uint32(info.Signo),
-		Errno:   info.Errno,
-		Code:    info.Code,
-		PID:     uint32(info.Pid()),
-		UID:     uint32(info.Uid()),
-		Status:  info.Status(),
-		Overrun: uint32(info.Overrun()),
-		Addr:    info.Addr(),
-	})
-	n, err := dst.CopyOut(ctx, buf[:])
+	buf := make([]byte, len(infos)*linux.SizeOfSignalfdSiginfo)
+	var one [linux.SizeOfSignalfdSiginfo]byte
+	for i, info := range infos {
+		b := binary.Marshal(one[:0], usermem.ByteOrder, &linux.SignalfdSiginfo{
+			Signo:   uint32(info.Signo),
+			Errno:   info.Errno,
+			Code:    info.Code,
+			PID:     uint32(info.Pid()),
+			UID:     uint32(info.Uid()),
+			Status:  info.Status(),
+			Overrun: uint32(info.Overrun()),
+			Addr:    info.Addr(),
+		})
+		copy(buf[i*linux.SizeOfSignalfdSiginfo:(i+1)*linux.SizeOfSignalfdSiginfo], b)
+	}
+	n, err := dst.CopyOut(ctx, buf)
 	return int64(n), err
 }
 
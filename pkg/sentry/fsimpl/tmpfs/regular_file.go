@@ -76,6 +76,12 @@ type regularFile struct {
 	// Protected by dataMu.
 	seals uint32
 
+	// hugetlb is true if memory for mappings of the file should be allocated
+	// in huge pages, as requested by memfd_create(MFD_HUGETLB).
+	//
+	// hugetlb is immutable.
+	hugetlb bool
+
 	// size is the size of data.
 	//
 	// Protected by both dataMu and inode.mu; reading it requires holding
@@ -227,7 +233,12 @@ func (rf *regularFile) Translate(ctx context.Context, required, optional memmap.
 		optional.End = pgend
 	}
 
-	cerr := rf.data.Fill(ctx, required, optional, rf.memFile, usage.Tmpfs, func(_ context.Context, dsts safemem.BlockSeq, _ uint64) (uint64, error) {
+	fillOptional := optional
+	if rf.hugetlb {
+		fillOptional = fsutil.HugeFillRange(optional, pgend)
+	}
+
+	cerr := rf.data.Fill(ctx, required, fillOptional, rf.memFile, usage.Tmpfs, func(_ context.Context, dsts safemem.BlockSeq, _ uint64) (uint64, error) {
 		// Newly-allocated pages are zeroed, so we don't need to do anything.
 		return dsts.NumBytes(), nil
 	})
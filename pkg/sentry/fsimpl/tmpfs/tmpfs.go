@@ -567,7 +567,9 @@ func (i *inode) touchAtime(mnt *vfs.Mount) {
 	}
 	now := i.fs.clock.Now().Nanoseconds()
 	i.mu.Lock()
-	atomic.StoreInt64(&i.atime, now)
+	if mnt.NeedsATimeUpdate(atomic.LoadInt64(&i.atime), atomic.LoadInt64(&i.mtime), atomic.LoadInt64(&i.ctime), now) {
+		atomic.StoreInt64(&i.atime, now)
+	}
 	i.mu.Unlock()
 	mnt.EndWrite()
 }
@@ -722,8 +724,9 @@ func (fd *fileDescription) Removexattr(ctx context.Context, name string) error {
 }
 
 // NewMemfd creates a new tmpfs regular file and file description that can back
-// an anonymous fd created by memfd_create.
-func NewMemfd(mount *vfs.Mount, creds *auth.Credentials, allowSeals bool, name string) (*vfs.FileDescription, error) {
+// an anonymous fd created by memfd_create. Memory for mappings of the file is
+// allocated in huge pages if hugetlb is true.
+func NewMemfd(mount *vfs.Mount, creds *auth.Credentials, allowSeals, hugetlb bool, name string) (*vfs.FileDescription, error) {
 	fs, ok := mount.Filesystem().Impl().(*filesystem)
 	if !ok {
 		panic("NewMemfd() called with non-tmpfs mount")
@@ -737,6 +740,7 @@ func NewMemfd(mount *vfs.Mount, creds *auth.Credentials, allowSeals bool, name s
 	if allowSeals {
 		rf.seals = 0
 	}
+	rf.hugetlb = hugetlb
 
 	d := fs.newDentry(inode)
 	defer d.DecRef()
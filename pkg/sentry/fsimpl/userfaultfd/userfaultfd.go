@@ -0,0 +1,85 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package userfaultfd implements userfaultfd(2) file descriptions.
+package userfaultfd
+
+import (
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/mm"
+	"gvisor.dev/gvisor/pkg/sentry/vfs"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// UserfaultFileDescription implements FileDescriptionImpl for userfaultfds.
+type UserfaultFileDescription struct {
+	vfsfd vfs.FileDescription
+	vfs.FileDescriptionDefaultImpl
+	vfs.DentryMetadataFileDescriptionImpl
+
+	// uffd reports faults in the MemoryManager of the task that created the
+	// file.
+	uffd *mm.Userfaultfd
+}
+
+var _ vfs.FileDescriptionImpl = (*UserfaultFileDescription)(nil)
+
+// New creates a new userfaultfd reporting faults in m.
+func New(vfsObj *vfs.VirtualFilesystem, m *mm.MemoryManager, flags uint32) (*vfs.FileDescription, error) {
+	vd := vfsObj.NewAnonVirtualDentry("[userfaultfd]")
+	defer vd.DecRef()
+	ufd := &UserfaultFileDescription{
+		uffd: mm.NewUserfaultfd(m),
+	}
+	if err := ufd.vfsfd.Init(ufd, flags, vd.Mount(), vd.Dentry(), &vfs.FileDescriptionOptions{
+		UseDentryMetadata: true,
+		DenyPRead:         true,
+		DenyPWrite:        true,
+	}); err != nil {
+		return nil, err
+	}
+	return &ufd.vfsfd, nil
+}
+
+// Read implements FileDescriptionImpl.Read.
+func (ufd *UserfaultFileDescription) Read(ctx context.Context, dst usermem.IOSequence, _ vfs.ReadOptions) (int64, error) {
+	return ufd.uffd.Read(ctx, dst)
+}
+
+// Ioctl implements FileDescriptionImpl.Ioctl.
+func (ufd *UserfaultFileDescription) Ioctl(ctx context.Context, uio usermem.IO, args arch.SyscallArguments) (uintptr, error) {
+	return ufd.uffd.Ioctl(ctx, uio, args)
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (ufd *UserfaultFileDescription) Readiness(mask waiter.EventMask) waiter.EventMask {
+	return ufd.uffd.Readiness(mask)
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (ufd *UserfaultFileDescription) EventRegister(e *waiter.Entry, mask waiter.EventMask) {
+	ufd.uffd.EventRegister(e, mask)
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (ufd *UserfaultFileDescription) EventUnregister(e *waiter.Entry) {
+	ufd.uffd.EventUnregister(e)
+}
+
+// Release implements FileDescriptionImpl.Release.
+func (ufd *UserfaultFileDescription) Release() {
+	ufd.uffd.Release()
+}
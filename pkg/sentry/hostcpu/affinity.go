@@ -0,0 +1,68 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package hostcpu
+
+import (
+	"syscall"
+	"unsafe"
+)
+
+// affinityMaskLen returns the number of uint64s in a CPU mask that can
+// represent all possible CPUs.
+func affinityMaskLen() (int, error) {
+	maxCPU, err := MaxPossibleCPU()
+	if err != nil {
+		return 0, err
+	}
+	return int(maxCPU)/64 + 1, nil
+}
+
+// AllowedCPUs returns the CPUs on which the calling thread may run, in
+// increasing order.
+func AllowedCPUs() ([]uint, error) {
+	n, err := affinityMaskLen()
+	if err != nil {
+		return nil, err
+	}
+	mask := make([]uint64, n)
+	if _, _, errno := syscall.RawSyscall(syscall.SYS_SCHED_GETAFFINITY, 0, uintptr(len(mask)*8), uintptr(unsafe.Pointer(&mask[0]))); errno != 0 {
+		return nil, errno
+	}
+	var cpus []uint
+	for cpu := uint(0); cpu < uint(len(mask)*64); cpu++ {
+		if mask[cpu/64]&(1<<(cpu%64)) != 0 {
+			cpus = append(cpus, cpu)
+		}
+	}
+	return cpus, nil
+}
+
+// SetAffinity restricts the calling thread to run on the given CPUs.
+func SetAffinity(cpus []uint) error {
+	n, err := affinityMaskLen()
+	if err != nil {
+		return err
+	}
+	mask := make([]uint64, n)
+	for _, cpu := range cpus {
+		if int(cpu/64) < len(mask) {
+			mask[cpu/64] |= 1 << (cpu % 64)
+		}
+	}
+	if _, _, errno := syscall.RawSyscall(syscall.SYS_SCHED_SETAFFINITY, 0, uintptr(len(mask)*8), uintptr(unsafe.Pointer(&mask[0]))); errno != 0 {
+		return errno
+	}
+	return nil
+}
@@ -0,0 +1,59 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package hostmm
+
+import (
+	"syscall"
+	"unsafe"
+)
+
+const (
+	// mpolFMemsAllowed is MPOL_F_MEMS_ALLOWED from Linux's
+	// include/uapi/linux/mempolicy.h.
+	mpolFMemsAllowed = 1 << 2
+
+	// maxNodemaskBits is the size of the nodemasks passed to the host. It
+	// must be at least the host's MAX_NUMNODES, which is at most 1 <<
+	// CONFIG_NODES_SHIFT = 1024.
+	maxNodemaskBits = 1024
+)
+
+// AllowedNUMANodes returns the mask of host NUMA nodes from which the calling
+// process may allocate memory, truncated to nodes 0-63.
+func AllowedNUMANodes() (uint64, error) {
+	var nodemask [maxNodemaskBits / 64]uint64
+	// Linux's mm/mempolicy.c:copy_nodes_to_user() uses maxnode-1 bits; see
+	// also set_mempolicy(2).
+	if _, _, errno := syscall.RawSyscall6(syscall.SYS_GET_MEMPOLICY, 0, uintptr(unsafe.Pointer(&nodemask[0])), maxNodemaskBits+1, 0, mpolFMemsAllowed, 0); errno != 0 {
+		return 0, errno
+	}
+	return nodemask[0], nil
+}
+
+// BindNUMAPolicy sets the NUMA memory policy for pages of the shared memory
+// mapped at [addr, addr+length) in the calling process, as for mbind(2) with
+// the given mode and nodemask (restricted to nodes 0-63). If the mapping is
+// of a tmpfs or memfd file, the policy is shared by all mappings of the file,
+// and applies to pages of the file allocated subsequently.
+func BindNUMAPolicy(addr, length uintptr, mode int32, nodemask uint64) error {
+	maxnode := uintptr(0)
+	if nodemask != 0 {
+		maxnode = 64 + 1
+	}
+	if _, _, errno := syscall.Syscall6(syscall.SYS_MBIND, addr, length, uintptr(mode), uintptr(unsafe.Pointer(&nodemask)), maxnode, 0); errno != 0 {
+		return errno
+	}
+	return nil
+}
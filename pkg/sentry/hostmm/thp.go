@@ -0,0 +1,51 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package hostmm
+
+import (
+	"fmt"
+	"io/ioutil"
+	"strings"
+)
+
+// shmemEnabledPath is the path to the host's transparent hugepage policy for
+// shared memory. See Linux's Documentation/admin-guide/mm/transhuge.rst.
+const shmemEnabledPath = "/sys/kernel/mm/transparent_hugepage/shmem_enabled"
+
+// ShmemHugepagesEnabled returns true if the host may back pages of tmpfs and
+// memfd files with transparent hugepages when they are mapped by mappings
+// advised with MADV_HUGEPAGE.
+func ShmemHugepagesEnabled() (bool, error) {
+	data, err := ioutil.ReadFile(shmemEnabledPath)
+	if err != nil {
+		return false, err
+	}
+	// The file contains all policies, with the current one in brackets, e.g.
+	// "always within_size [advise] never deny force".
+	for _, policy := range strings.Fields(string(data)) {
+		if !strings.HasPrefix(policy, "[") || !strings.HasSuffix(policy, "]") {
+			continue
+		}
+		switch policy[1 : len(policy)-1] {
+		case "always", "within_size", "advise", "force":
+			return true, nil
+		case "never", "deny":
+			return false, nil
+		default:
+			return false, fmt.Errorf("unknown policy %s in %s", policy, shmemEnabledPath)
+		}
+	}
+	return false, fmt.Errorf("no current policy in %s: %q", shmemEnabledPath, data)
+}
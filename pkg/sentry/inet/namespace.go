@@ -14,19 +14,25 @@
 
 package inet
 
+import (
+	"gvisor.dev/gvisor/pkg/sync"
+)
+
 // Namespace represents a network namespace. See network_namespaces(7).
 //
 // +stateify savable
 type Namespace struct {
+	// initOnce guards the creation of stack in non-root namespaces.
+	initOnce sync.Once `state:"nosave"`
+
 	// stack is the network stack implementation of this network namespace.
+	// In non-root namespaces, it is created on first use by Stack, so that
+	// creating a namespace that is never used for networking is cheap.
 	stack Stack `state:"nosave"`
 
 	// creator allows kernel to create new network stack for network namespaces.
 	// If nil, no networking will function if network is namespaced.
-	//
-	// At afterLoad(), creator will be used to create network stack. Stateify
-	// needs to wait for this field to be loaded before calling afterLoad().
-	creator NetworkStackCreator `state:"wait"`
+	creator NetworkStackCreator
 
 	// isRoot indicates whether this is the root network namespace.
 	isRoot bool
@@ -45,16 +51,15 @@ func NewRootNamespace(stack Stack, creator NetworkStackCreator) *Namespace {
 
 // NewNamespace creates a new network namespace from the root.
 func NewNamespace(root *Namespace) *Namespace {
-	n := &Namespace{
+	return &Namespace{
 		creator: root.creator,
 	}
-	n.init()
-	return n
 }
 
-// Stack returns the network stack of n. Stack may return nil if no network
-// stack is configured.
+// Stack returns the network stack of n, creating it if needed. Stack may
+// return nil if no network stack is configured.
 func (n *Namespace) Stack() Stack {
+	n.initOnce.Do(n.init)
 	return n.stack
 }
 
@@ -89,11 +94,6 @@ func (n *Namespace) init() {
 	}
 }
 
-// afterLoad is invoked by stateify.
-func (n *Namespace) afterLoad() {
-	n.init()
-}
-
 // NetworkStackCreator allows new instances of a network stack to be created. It
 // is used by the kernel to create new network namespaces when requested.
 type NetworkStackCreator interface {
@@ -38,6 +38,7 @@ type EntryFlags int
 const (
 	OneShot EntryFlags = 1 << iota
 	EdgeTriggered
+	Exclusive
 )
 
 // FileIdentifier identifies a file. We cannot use just the FD because it could
@@ -293,6 +294,15 @@ func (*readyCallback) Callback(w *waiter.Entry) {
 	e.listsMu.Unlock()
 }
 
+// CallbackExclusive implements waiter.ExclusiveEntryCallback.CallbackExclusive.
+func (r *readyCallback) CallbackExclusive(w *waiter.Entry) bool {
+	r.Callback(w)
+	// As in Linux, the event is queued on every EventPoll that is notified,
+	// but only one with waiters stops the notification of other exclusive
+	// waiters.
+	return !w.Context.(*pollEntry).epoll.Queue.IsEmpty()
+}
+
 // initEntryReadiness initializes the entry's state with regards to its
 // readiness by placing it in the appropriate list and registering for
 // notifications.
@@ -368,6 +378,12 @@ func (e *EventPoll) AddEntry(id FileIdentifier, flags EntryFlags, mask waiter.Ev
 		if ep.observes(e, 4) {
 			return syscall.ELOOP
 		}
+
+		// "An EINVAL error also occurs if EPOLLEXCLUSIVE is specified in
+		// events and fd refers to an epoll instance." - epoll_ctl(2)
+		if flags&Exclusive != 0 {
+			return syscall.EINVAL
+		}
 	}
 
 	// Create new entry and add it to map.
@@ -384,6 +400,7 @@ func (e *EventPoll) AddEntry(id FileIdentifier, flags EntryFlags, mask waiter.Ev
 		mask:     mask,
 	}
 	entry.waiter.Context = entry
+	entry.waiter.Exclusive = flags&Exclusive != 0
 	e.files[id] = entry
 	entry.file = refs.NewWeakRef(id.File, entry)
 
@@ -405,6 +422,13 @@ func (e *EventPoll) UpdateEntry(id FileIdentifier, flags EntryFlags, mask waiter
 		return syscall.ENOENT
 	}
 
+	// "EINVAL: op was EPOLL_CTL_MOD and events included EPOLLEXCLUSIVE.
+	// EINVAL: op was EPOLL_CTL_MOD and the EPOLLEXCLUSIVE flag has
+	// previously been applied to this epfd, fd pair." - epoll_ctl(2)
+	if flags&Exclusive != 0 || entry.flags&Exclusive != 0 {
+		return syscall.EINVAL
+	}
+
 	// Unregister the old mask and remove entry from the list it's in, so
 	// readyCallback is guaranteed to not be called on this entry anymore.
 	entry.id.File.EventUnregister(&entry.waiter)
@@ -23,6 +23,7 @@ import (
 func (p *pollEntry) afterLoad() {
 	p.waiter = waiter.Entry{Callback: &readyCallback{}}
 	p.waiter.Context = p
+	p.waiter.Exclusive = p.flags&Exclusive != 0
 	p.file = refs.NewWeakRef(p.id.File, p)
 	p.id.File.EventRegister(&p.waiter, p.mask)
 }
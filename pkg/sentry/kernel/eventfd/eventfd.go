@@ -18,6 +18,7 @@ package eventfd
 
 import (
 	"math"
+	"sync/atomic"
 	"syscall"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
@@ -48,23 +49,33 @@ type EventOperations struct {
 	fsutil.FileNoopFlush            `state:"nosave"`
 	fsutil.FileUseInodeUnstableAttr `state:"nosave"`
 
-	// Mutex that protects accesses to the fields of this event.
+	// Mutex that protects hostfd, and serializes transitions of val to and
+	// from hostedVal.
 	mu sync.Mutex `state:"nosave"`
 
 	// Queue is used to notify interested parties when the event object
 	// becomes readable or writable.
 	wq waiter.Queue `state:"zerovalue"`
 
-	// val is the current value of the event counter.
+	// val is the current value of the event counter, or hostedVal if the
+	// event is passed through to the host. val is accessed using atomic
+	// memory operations, so that reads and writes of sentry-internal events
+	// don't need to lock mu.
 	val uint64
 
-	// semMode specifies whether the event is in "semaphore" mode.
+	// semMode specifies whether the event is in "semaphore" mode. semMode is
+	// immutable.
 	semMode bool
 
 	// hostfd indicates whether this eventfd is passed through to the host.
 	hostfd int
 }
 
+// hostedVal is the value of EventOperations.val for events that are passed
+// through to the host. The counter can't otherwise reach it, since writes
+// that would take it above math.MaxUint64-1 block.
+const hostedVal = math.MaxUint64
+
 // New creates a new event object with the supplied initial value and mode.
 func New(ctx context.Context, initVal uint64, semMode bool) *fs.File {
 	// name matches fs/eventfd.c:eventfd_file_create.
@@ -91,13 +102,18 @@ func (e *EventOperations) HostFD() (int, error) {
 		flags |= linux.EFD_SEMAPHORE
 	}
 
-	fd, _, err := syscall.Syscall(syscall.SYS_EVENTFD2, uintptr(e.val), uintptr(flags), 0)
+	// Take the counter's value, and divert concurrent reads and writes to
+	// the slow path, which waits for mu.
+	val := atomic.SwapUint64(&e.val, hostedVal)
+	fd, _, err := syscall.Syscall(syscall.SYS_EVENTFD2, uintptr(val), uintptr(flags), 0)
 	if err != 0 {
+		atomic.StoreUint64(&e.val, val)
 		return -1, err
 	}
 
 	if err := fdnotifier.AddFD(int32(fd), &e.wq); err != nil {
 		syscall.Close(int(fd))
+		atomic.StoreUint64(&e.val, val)
 		return -1, err
 	}
 
@@ -154,32 +170,39 @@ func (e *EventOperations) hostRead(ctx context.Context, dst usermem.IOSequence)
 }
 
 func (e *EventOperations) read(ctx context.Context, dst usermem.IOSequence) error {
-	e.mu.Lock()
-
-	if e.hostfd >= 0 {
-		defer e.mu.Unlock()
-		return e.hostRead(ctx, dst)
-	}
+	var val uint64
+	for {
+		cur := atomic.LoadUint64(&e.val)
+		if cur == hostedVal {
+			e.mu.Lock()
+			if e.hostfd >= 0 {
+				defer e.mu.Unlock()
+				return e.hostRead(ctx, dst)
+			}
+			// HostFD failed and restored the counter.
+			e.mu.Unlock()
+			continue
+		}
 
-	// We can't complete the read if the value is currently zero.
-	if e.val == 0 {
-		e.mu.Unlock()
-		return syserror.ErrWouldBlock
-	}
+		// We can't complete the read if the value is currently zero.
+		if cur == 0 {
+			return syserror.ErrWouldBlock
+		}
 
-	// Update the value based on the mode the event is operating in.
-	var val uint64
-	if e.semMode {
-		val = 1
-		// Consistent with Linux, this is done even if writing to memory fails.
-		e.val--
-	} else {
-		val = e.val
-		e.val = 0
+		// Update the value based on the mode the event is operating in.
+		// Consistent with Linux, this is done even if writing to memory
+		// fails.
+		next := uint64(0)
+		val = cur
+		if e.semMode {
+			next = cur - 1
+			val = 1
+		}
+		if atomic.CompareAndSwapUint64(&e.val, cur, next) {
+			break
+		}
 	}
 
-	e.mu.Unlock()
-
 	// Notify writers. We do this even if we were already writable because
 	// it is possible that a writer is waiting to write the maximum value
 	// to the event.
@@ -218,24 +241,32 @@ func (e *EventOperations) Signal(val uint64) error {
 		return syscall.EINVAL
 	}
 
-	e.mu.Lock()
-
-	if e.hostfd >= 0 {
-		defer e.mu.Unlock()
-		return e.hostWrite(val)
-	}
+	for {
+		cur := atomic.LoadUint64(&e.val)
+		if cur == hostedVal {
+			e.mu.Lock()
+			if e.hostfd >= 0 {
+				defer e.mu.Unlock()
+				return e.hostWrite(val)
+			}
+			// HostFD failed and restored the counter.
+			e.mu.Unlock()
+			continue
+		}
 
-	// We only allow writes that won't cause the value to go over the max
-	// uint64 minus 1.
-	if val > math.MaxUint64-1-e.val {
-		e.mu.Unlock()
-		return syserror.ErrWouldBlock
+		// We only allow writes that won't cause the value to go over the
+		// max uint64 minus 1.
+		if val > math.MaxUint64-1-cur {
+			return syserror.ErrWouldBlock
+		}
+		if atomic.CompareAndSwapUint64(&e.val, cur, cur+val) {
+			break
+		}
 	}
 
-	e.val += val
-	e.mu.Unlock()
-
-	// Always trigger a notification.
+	// Always trigger a notification, even if the counter was already
+	// non-zero: edge-triggered epoll waiters expect an event for each
+	// write, as on Linux.
 	e.wq.Notify(waiter.EventIn)
 
 	return nil
@@ -243,21 +274,24 @@ func (e *EventOperations) Signal(val uint64) error {
 
 // Readiness returns the ready events for the event fd.
 func (e *EventOperations) Readiness(mask waiter.EventMask) waiter.EventMask {
-	e.mu.Lock()
-	if e.hostfd >= 0 {
+	val := atomic.LoadUint64(&e.val)
+	if val == hostedVal {
+		e.mu.Lock()
 		defer e.mu.Unlock()
-		return fdnotifier.NonBlockingPoll(int32(e.hostfd), mask)
+		if e.hostfd >= 0 {
+			return fdnotifier.NonBlockingPoll(int32(e.hostfd), mask)
+		}
+		val = atomic.LoadUint64(&e.val)
 	}
 
 	ready := waiter.EventMask(0)
-	if e.val > 0 {
+	if val > 0 {
 		ready |= waiter.EventIn
 	}
 
-	if e.val < math.MaxUint64-1 {
+	if val < math.MaxUint64-1 {
 		ready |= waiter.EventOut
 	}
-	e.mu.Unlock()
 
 	return mask & ready
 }
@@ -29,6 +29,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/limits"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 	"gvisor.dev/gvisor/pkg/sync"
+	"gvisor.dev/gvisor/pkg/waiter"
 )
 
 // FDFlags define flags for an individual descriptor.
@@ -73,6 +74,9 @@ type descriptor struct {
 	flags    FDFlags
 }
 
+// fdTableCacheLineSize is the assumed size of a CPU cache line.
+const fdTableCacheLineSize = 64
+
 // FDTable is used to manage File references and flags.
 //
 // +stateify savable
@@ -94,8 +98,20 @@ type FDTable struct {
 	// written).
 	used int32
 
-	// descriptorTable holds descriptors.
+	// The fields above are written by every open and close, while
+	// descriptorTable is read by every lookup. Keep them on different cache
+	// lines, so that threads doing I/O on existing file descriptors don't
+	// contend with threads that open and close others.
+	_ [fdTableCacheLineSize]byte
+
+	// descriptorTable holds descriptors. Lookups read it without locking
+	// mu; see FDTable.getAll.
 	descriptorTable `state:".(map[int32]descriptor)"`
+
+	// pollCaches is the set of PollCaches with entries that refer to file
+	// descriptors in the table. Such entries are invalidated when their file
+	// descriptors are closed or replaced.
+	pollCaches map[*PollCache]struct{} `state:"nosave"`
 }
 
 func (f *FDTable) saveDescriptorTable() map[int32]descriptor {
@@ -519,6 +535,22 @@ func (f *FDTable) GetVFS2(fd int32) (*vfs.FileDescription, FDFlags) {
 	}
 }
 
+// refersTo returns true if fd currently refers to file, which is an *fs.File
+// or a *vfs.FileDescription.
+func (f *FDTable) refersTo(fd int32, file waiter.Waitable) bool {
+	orig, origVFS2, _, ok := f.getAll(fd)
+	if !ok {
+		return false
+	}
+	switch {
+	case orig != nil:
+		return waiter.Waitable(orig) == file
+	case origVFS2 != nil:
+		return waiter.Waitable(origVFS2) == file
+	}
+	return false
+}
+
 // GetFDs returns a sorted list of valid fds.
 //
 // Precondition: The caller must be running on the task goroutine, or Task.mu
@@ -531,6 +563,26 @@ func (f *FDTable) GetFDs() []int32 {
 	return fds
 }
 
+// GetFDsFrom returns a sorted list of up to max valid fds greater than or
+// equal to start. Unlike GetFDs, it doesn't take references on the files, so
+// listing a large table in batches is cheap.
+func (f *FDTable) GetFDsFrom(start int32, max int) []int32 {
+	if start < 0 {
+		start = 0
+	}
+	var fds []int32
+	for fd := start; len(fds) < max; fd++ {
+		file, fileVFS2, _, ok := f.getAll(fd)
+		if !ok {
+			break
+		}
+		if file != nil || fileVFS2 != nil {
+			fds = append(fds, fd)
+		}
+	}
+	return fds
+}
+
 // GetRefs returns a stable slice of references to all files and bumps the
 // reference count on each. The caller must use DecRef on each reference when
 // they're done using the slice.
@@ -603,6 +655,70 @@ func (f *FDTable) Remove(fd int32) (*fs.File, *vfs.FileDescription) {
 	return orig, orig2
 }
 
+// RemoveRange removes all FDs in the range [first, last] and returns the
+// removed files.
+//
+// N.B. Callers are required to use DecRef on each returned file when they are
+// done.
+func (f *FDTable) RemoveRange(first, last int32) ([]*fs.File, []*vfs.FileDescription) {
+	if first < 0 || last < first {
+		return nil, nil
+	}
+
+	f.mu.Lock()
+	defer f.mu.Unlock()
+
+	// Update current available position.
+	if first < f.next {
+		f.next = first
+	}
+
+	var files []*fs.File
+	var filesVFS2 []*vfs.FileDescription
+	for fd := first; fd <= last; fd++ {
+		orig, orig2, _, ok := f.getAll(fd)
+		if !ok {
+			// No FDs are allocated past the end of the table, which
+			// also bounds the loop if last is math.MaxInt32.
+			break
+		}
+
+		// Add reference for caller.
+		switch {
+		case orig != nil:
+			orig.IncRef()
+			files = append(files, orig)
+		case orig2 != nil:
+			orig2.IncRef()
+			filesVFS2 = append(filesVFS2, orig2)
+		default:
+			continue
+		}
+		f.setAll(fd, nil, nil, FDFlags{}) // Zap entry.
+	}
+	return files, filesVFS2
+}
+
+// SetFlagsRange sets the flags of all FDs in the range [first, last].
+func (f *FDTable) SetFlagsRange(first, last int32, flags FDFlags) {
+	if first < 0 || last < first {
+		return
+	}
+
+	f.mu.Lock()
+	defer f.mu.Unlock()
+
+	for fd := first; fd <= last; fd++ {
+		file, fileVFS2, _, ok := f.getAll(fd)
+		if !ok {
+			break
+		}
+		if file != nil || fileVFS2 != nil {
+			f.setAll(fd, file, fileVFS2, flags)
+		}
+	}
+}
+
 // RemoveIf removes all FDs where cond is true.
 func (f *FDTable) RemoveIf(cond func(*fs.File, *vfs.FileDescription, FDFlags) bool) {
 	f.mu.Lock()
@@ -22,6 +22,12 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 )
 
+// descriptorTable is read without locks, in the style of RCU: readers load
+// the slice and then an element of it atomically, and never write either.
+// Writers, which hold FDTable.mu, replace elements with new, immutable
+// descriptors, and replace the slice with a larger copy when growing it.
+// Readers may therefore observe a descriptor that is concurrently being
+// replaced; they detect that its file has been released with TryIncRef.
 type descriptorTable struct {
 	// slice is a *[]unsafe.Pointer, where each element is actually
 	// *descriptor object, updated atomically.
@@ -145,6 +151,14 @@ func (f *FDTable) setAll(fd int32, file *fs.File, fileVFS2 *vfs.FileDescription,
 		}
 	}
 
+	// Invalidate cached poll waiters while the table still holds its
+	// reference on the original file.
+	if orig != nil && (desc == nil || desc.file != orig.file || desc.fileVFS2 != orig.fileVFS2) {
+		for c := range f.pollCaches {
+			c.invalidate(fd)
+		}
+	}
+
 	// Drop the table reference.
 	if orig != nil {
 		switch {
@@ -24,6 +24,7 @@
 //       TaskSet.mu
 //         SignalHandlers.mu
 //           Task.mu
+//             PerfEvent.mu
 //       runningTasksMu
 //
 // Locking SignalHandlers.mu in multiple SignalHandlers requires locking
@@ -35,6 +36,7 @@ import (
 	"errors"
 	"fmt"
 	"io"
+	"os"
 	"path/filepath"
 	"sync/atomic"
 	"time"
@@ -60,6 +62,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/kernel/epoll"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/futex"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/sched"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/syscalltrace"
 	ktime "gvisor.dev/gvisor/pkg/sentry/kernel/time"
 	"gvisor.dev/gvisor/pkg/sentry/limits"
 	"gvisor.dev/gvisor/pkg/sentry/loader"
@@ -118,12 +121,43 @@ type Kernel struct {
 	rootNetworkNamespace        *inet.Namespace
 	applicationCores            uint
 	useHostCores                bool
+	syscallTiming               bool
 	extraAuxv                   []arch.AuxEntry
 	vdso                        *loader.VDSO
 	rootUTSNamespace            *UTSNamespace
 	rootIPCNamespace            *IPCNamespace
 	rootAbstractSocketNamespace *AbstractSocketNamespace
 
+	// hostCPUs is the set of host CPUs on which tasks may run, in increasing
+	// order, if task CPU masks constrain the host threads that run tasks. If
+	// hostCPUs is nil, task CPU masks have no effect on the host.
+	hostCPUs []uint
+
+	// vdsoThreadClockEpoch is published to the VDSO, which only uses
+	// records in VDSO thread clock pages that were written in the same
+	// epoch. It is incremented on restore, since tasks' CPU clocks are
+	// published relative to the host's cycle counter.
+	vdsoThreadClockEpoch uint64
+
+	// syscallTraceMu serializes the creation of syscallTrace.
+	syscallTraceMu sync.Mutex `state:"nosave"`
+
+	// syscallTrace is the buffer in which syscalls are recorded while
+	// syscallTraceUsers is non-zero, or nil if it has not been created.
+	// syscallTrace is set at most once, with syscallTraceMu locked, before
+	// syscallTraceUsers first becomes non-zero.
+	syscallTrace *syscalltrace.Buffer
+
+	// syscallTraceUsers is the number of users of syscallTrace; see
+	// Kernel.StartSyscallTrace. syscallTraceUsers is accessed using atomic
+	// memory operations.
+	syscallTraceUsers int32
+
+	// perfSamplingEvents is the number of open perf events that take
+	// samples, which are checked at each CPU clock tick while it is non-zero.
+	// perfSamplingEvents is accessed using atomic memory operations.
+	perfSamplingEvents int32
+
 	// futexes is the "root" futex.Manager, from which all others are forked.
 	// This is necessary to ensure that shared futexes are coherent across all
 	// tasks, including those created by CreateProcess.
@@ -163,6 +197,16 @@ type Kernel struct {
 	// further protected by runningTasksMu (see incRunningTasks).
 	runningTasks int64
 
+	// schedProcs is the number of task goroutines that can run at once, as
+	// last sampled from runtime.GOMAXPROCS by cpuClockTicker. While no more
+	// than schedProcs tasks are running, sched_yield(2) has no effect.
+	//
+	// schedProcs is accessed using atomic memory operations.
+	schedProcs int64 `state:"nosave"`
+
+	// taskGoroutines runs task goroutines.
+	taskGoroutines taskGoroutinePool `state:"nosave"`
+
 	// cpuClock is incremented every linux.ClockTick. cpuClock is used to
 	// measure task CPU usage, since sampling monotonicClock twice on every
 	// syscall turns out to be unreasonably expensive. This is similar to how
@@ -304,6 +348,20 @@ type InitKernelArgs struct {
 	// will be overridden.
 	UseHostCores bool
 
+	// If HostAffinity is true, CPU masks set by sched_setaffinity(2) also
+	// constrain the host threads that run tasks. Application CPU i
+	// corresponds to the i'th host CPU on which the sandbox may run, modulo
+	// the number of such CPUs. HostAffinity has no effect if UseHostCores is
+	// true.
+	HostAffinity bool
+
+	// If SyscallTiming is true, the time that each task spends executing
+	// each syscall in the sentry is measured and reported, along with
+	// syscall counts, by /proc/[pid]/task/[tid]/syscall_stats. This requires
+	// reading the host's monotonic clock on every syscall, so it is disabled
+	// by default.
+	SyscallTiming bool
+
 	// ExtraAuxv contains additional auxiliary vector entries that are added to
 	// each process by the ELF loader.
 	ExtraAuxv []arch.AuxEntry
@@ -368,9 +426,22 @@ func (k *Kernel) Init(args InitKernelArgs) error {
 			log.Infof("UseHostCores enabled: increasing ApplicationCores from %d to %d", k.applicationCores, minAppCores)
 			k.applicationCores = minAppCores
 		}
+	} else if args.HostAffinity {
+		cpus, err := hostcpu.AllowedCPUs()
+		if err != nil {
+			return fmt.Errorf("Failed to get host CPU affinity: %v", err)
+		}
+		if len(cpus) == 0 {
+			return fmt.Errorf("host CPU affinity is empty")
+		}
+		k.hostCPUs = cpus
 	}
+	k.syscallTiming = args.SyscallTiming
 	k.extraAuxv = args.ExtraAuxv
 	k.vdso = args.Vdso
+	k.vdsoThreadClockEpoch = 1
+	k.updateVDSOGetcpu()
+	k.updateVDSOInfo()
 	k.realtimeClock = &timekeeperClock{tk: args.Timekeeper, c: sentrytime.Realtime}
 	k.monotonicClock = &timekeeperClock{tk: args.Timekeeper, c: sentrytime.Monotonic}
 	k.futexes = futex.NewManager()
@@ -419,10 +490,12 @@ func (k *Kernel) Init(args InitKernelArgs) error {
 	return nil
 }
 
-// SaveTo saves the state of k to w.
+// SaveTo saves the state of k to w. If pages is not nil, the contents of
+// application memory are saved to pages instead, as for
+// pgalloc.MemoryFile.SaveTo.
 //
 // Preconditions: The kernel must be paused throughout the call to SaveTo.
-func (k *Kernel) SaveTo(w io.Writer) error {
+func (k *Kernel) SaveTo(w io.Writer, pages *os.File) error {
 	saveStart := time.Now()
 	ctx := k.SupervisorContext()
 
@@ -450,6 +523,9 @@ func (k *Kernel) SaveTo(w io.Writer) error {
 	// we will need to re-establish these waiter objects after saving.
 	k.tasks.unregisterEpollWaiters()
 
+	// Likewise for waiters retained by poll(2) and select(2) between calls.
+	k.tasks.releasePollCaches()
+
 	// Clear the dirent cache before saving because Dirents must be Loaded in a
 	// particular order (parents before children), and Loading dirents from a cache
 	// breaks that order.
@@ -496,7 +572,7 @@ func (k *Kernel) SaveTo(w io.Writer) error {
 
 	// Save the memory file's state.
 	memoryStart := time.Now()
-	if err := k.mf.SaveTo(k.SupervisorContext(), w); err != nil {
+	if err := k.mf.SaveTo(k.SupervisorContext(), w, pages); err != nil {
 		return err
 	}
 	log.Infof("Memory save took [%s].", time.Since(memoryStart))
@@ -635,8 +711,9 @@ func (ts *TaskSet) unregisterEpollWaiters() {
 	}
 }
 
-// LoadFrom returns a new Kernel loaded from args.
-func (k *Kernel) LoadFrom(r io.Reader, net inet.Stack, clocks sentrytime.Clocks) error {
+// LoadFrom returns a new Kernel loaded from args. pages must be the pages file
+// passed to SaveTo, if any.
+func (k *Kernel) LoadFrom(r io.Reader, pages *os.File, net inet.Stack, clocks sentrytime.Clocks) error {
 	loadStart := time.Now()
 
 	initAppCores := k.applicationCores
@@ -675,7 +752,7 @@ func (k *Kernel) LoadFrom(r io.Reader, net inet.Stack, clocks sentrytime.Clocks)
 
 	// Load the memory file's state.
 	memoryStart := time.Now()
-	if err := k.mf.LoadFrom(k.SupervisorContext(), r); err != nil {
+	if err := k.mf.LoadFrom(k.SupervisorContext(), r, pages); err != nil {
 		return err
 	}
 	log.Infof("Memory load took [%s].", time.Since(memoryStart))
@@ -683,6 +760,9 @@ func (k *Kernel) LoadFrom(r io.Reader, net inet.Stack, clocks sentrytime.Clocks)
 	log.Infof("Overall load took [%s]", time.Since(loadStart))
 
 	k.Timekeeper().SetClocks(clocks)
+	k.vdsoThreadClockEpoch++
+	k.updateVDSOGetcpu()
+	k.updateVDSOInfo()
 	if net != nil {
 		net.Resume()
 	}
@@ -711,6 +791,51 @@ func (k *Kernel) LoadFrom(r io.Reader, net inet.Stack, clocks sentrytime.Clocks)
 	return nil
 }
 
+// updateVDSOGetcpu configures how the VDSO answers getcpu(2), based on how
+// Task.CPU() is computed.
+func (k *Kernel) updateVDSOGetcpu() {
+	switch {
+	case k.useHostCores && k.Platform.HostCPUVisibleToApplications():
+		// Task.CPU() is the CPU the task goroutine runs on, so the CPU
+		// the application itself runs on is at least as accurate.
+		k.timekeeper.setGetcpu(vdsoGetcpuTSCAux, 0)
+	case !k.useHostCores && k.applicationCores == 1:
+		// assignCPU can only ever pick CPU 0.
+		k.timekeeper.setGetcpu(vdsoGetcpuFixed, 0)
+	default:
+		k.timekeeper.setGetcpu(vdsoGetcpuSyscall, 0)
+	}
+}
+
+// updateVDSOInfo publishes system information served by the VDSO.
+func (k *Kernel) updateVDSOInfo() {
+	k.timekeeper.setInfo(vdsoInfo{
+		cpus:             uint64(k.applicationCores),
+		threadClockEpoch: k.vdsoThreadClockEpochIfEnabled(),
+	})
+}
+
+// vdsoThreadClockEpochIfEnabled returns the epoch of valid records in VDSO
+// thread clock pages, or 0 if the VDSO must not look for them.
+func (k *Kernel) vdsoThreadClockEpochIfEnabled() uint64 {
+	if !k.timekeeper.vdsoThreadCPUTime() {
+		return 0
+	}
+	return k.vdsoThreadClockEpoch
+}
+
+// SetVDSOThreadCPUTime sets whether tasks may publish their CPU clocks to the
+// VDSO, which then serves clock_gettime(CLOCK_THREAD_CPUTIME_ID) without a
+// system call. The VDSO finds the calling thread's clock by its thread pointer,
+// so this must only be enabled for applications that follow the TLS ABI and
+// don't switch thread pointers between threads.
+//
+// Preconditions: The Kernel must not have been started.
+func (k *Kernel) SetVDSOThreadCPUTime(enabled bool) {
+	k.timekeeper.setVDSOThreadCPUTime(enabled)
+	k.updateVDSOInfo()
+}
+
 // UniqueID returns a unique identifier.
 func (k *Kernel) UniqueID() uint64 {
 	id := atomic.AddUint64(&k.uniqueID, 1)
@@ -1086,6 +1211,7 @@ func (k *Kernel) pauseTimeLocked() {
 	for t := range k.tasks.Root.tids {
 		if t == t.tg.leader {
 			t.tg.itimerRealTimer.Pause()
+			t.tg.itimerProfTimer.Pause()
 			for _, it := range t.tg.timers {
 				it.PauseTimer()
 			}
@@ -1124,6 +1250,7 @@ func (k *Kernel) resumeTimeLocked() {
 	for t := range k.tasks.Root.tids {
 		if t == t.tg.leader {
 			t.tg.itimerRealTimer.Resume()
+			t.tg.itimerProfTimer.Resume()
 			for _, it := range t.tg.timers {
 				it.ResumeTimer()
 			}
@@ -1560,6 +1687,34 @@ func (k *Kernel) ListSockets() []*SocketEntry {
 	return socks
 }
 
+// ListSocketsAfter returns a snapshot of at most max sockets following after
+// in the socket table, or at the front of the table if after is nil. If after
+// has since been removed from the table, the snapshot starts at the first
+// socket recorded after it.
+//
+// ListSocketsAfter allows callers to walk the socket table in chunks, without
+// copying all of it each time.
+func (k *Kernel) ListSocketsAfter(after *SocketEntry, max int) []*SocketEntry {
+	k.extMu.Lock()
+	defer k.extMu.Unlock()
+	s := k.sockets.Front()
+	if after != nil {
+		if after.Prev() != nil || s == after {
+			s = after.Next()
+		} else {
+			// after is no longer in the table. Entries are ordered by ID.
+			for s != nil && s.ID <= after.ID {
+				s = s.Next()
+			}
+		}
+	}
+	var socks []*SocketEntry
+	for ; s != nil && len(socks) < max; s = s.Next() {
+		socks = append(socks, s)
+	}
+	return socks
+}
+
 // supervisorContext is a privileged context.
 type supervisorContext struct {
 	context.NoopSleeper
@@ -0,0 +1,173 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package mempressure implements the memory pressure controller, which
+// periodically compares the sandbox's memory usage with a limit set below the
+// host's, and reclaims memory before the host has to.
+//
+// When usage exceeds the limit, the controller first evicts the MemoryFile's
+// evictable allocations, i.e. cached file contents, which can be reread (or,
+// if dirty, are written back) on demand. The MemoryFile must have been created
+// with MemoryFileOpts.UseExternalPressure, so that these are cached until
+// then. If usage still exceeds the limit a period later, the controller kills
+// the thread group chosen by Kernel.OOMKill, which honors oom_score_adj, one
+// victim at a time. Otherwise, the host's OOM killer would kill the whole
+// sandbox.
+package mempressure
+
+import (
+	"time"
+
+	"gvisor.dev/gvisor/pkg/log"
+	"gvisor.dev/gvisor/pkg/metric"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
+	"gvisor.dev/gvisor/pkg/sync"
+)
+
+var evictions = metric.MustCreateNewUint64Metric("/memory_pressure/evictions", false /*sync*/, "Number of times cached file contents were evicted due to memory pressure.")
+var oomKills = metric.MustCreateNewUint64Metric("/memory_pressure/oom_kills", false /*sync*/, "Number of thread groups killed due to memory pressure.")
+
+// action is what the controller does in a period.
+type action int
+
+const (
+	// none means that usage is below the limit.
+	none action = iota
+
+	// evict means that cached file contents should be evicted.
+	evict
+
+	// oomKill means that a thread group should be killed.
+	oomKill
+
+	// wait means that usage is above the limit, but the last action may
+	// not have taken effect yet.
+	wait
+)
+
+// Controller is the memory pressure controller.
+type Controller struct {
+	k *kernel.Kernel
+
+	// total is the memory limit of the sandbox, in bytes.
+	total uint64
+
+	// limit is the usage, in bytes, above which memory is reclaimed.
+	limit uint64
+
+	// period is how often usage is checked.
+	period time.Duration
+
+	// Writing to this channel indicates the controller goroutine should stop.
+	stop chan struct{}
+
+	// done is used to signal when the controller goroutine has exited.
+	done sync.WaitGroup
+
+	// last is the action of the previous period. It is only accessed by
+	// the controller goroutine.
+	last action
+}
+
+// New creates a new Controller that reclaims memory when usage exceeds
+// threshold (a fraction between 0 and 1) of total bytes.
+func New(k *kernel.Kernel, total uint64, threshold float64, period time.Duration) *Controller {
+	return &Controller{
+		k:      k,
+		total:  total,
+		limit:  uint64(float64(total) * threshold),
+		period: period,
+		stop:   make(chan struct{}),
+	}
+}
+
+// Stop stops the controller goroutine. Stop must not be called concurrently
+// with Start and may only be called once.
+func (c *Controller) Stop() {
+	close(c.stop)
+	c.done.Wait()
+}
+
+// Start starts the controller goroutine. Start must not be called
+// concurrently with Stop and may only be called once.
+func (c *Controller) Start() {
+	if c.period == 0 || c.limit == 0 {
+		return
+	}
+	c.done.Add(1)
+	go c.run() // S/R-SAFE: doesn't interact with saved state.
+}
+
+func (c *Controller) run() {
+	defer c.done.Done()
+
+	ticker := time.NewTicker(c.period)
+	defer ticker.Stop()
+
+	for {
+		select {
+		case <-c.stop:
+			return
+		case <-ticker.C:
+			c.check()
+		}
+	}
+}
+
+// check compares usage with the limit, and reclaims memory if necessary.
+func (c *Controller) check() {
+	mf := c.k.MemoryFile()
+	total, err := mf.TotalUsage()
+	if err != nil {
+		log.Warningf("Failed to fetch memory usage for memory pressure: %v", err)
+		return
+	}
+	snapshot, _ := usage.MemoryAccounting.Copy()
+	total += snapshot.Mapped
+
+	c.last = next(c.last, total > c.limit)
+	switch c.last {
+	case evict:
+		log.Infof("Memory usage %d bytes exceeds %d bytes, evicting cached file contents", total, c.limit)
+		evictions.Increment()
+		mf.StartEvictions()
+	case oomKill:
+		if tg := c.k.OOMKill(c.total); tg == nil {
+			log.Warningf("Memory usage %d bytes exceeds %d bytes, but no process can be killed", total, c.limit)
+		} else {
+			oomKills.Increment()
+		}
+	}
+}
+
+// next returns the action that follows last, given whether usage is above
+// the limit.
+//
+// Evictions are started asynchronously, and a killed thread group only frees
+// its memory once it has exited, so each action is given a period to take
+// effect before the next one is taken.
+func next(last action, over bool) action {
+	if !over {
+		return none
+	}
+	switch last {
+	case none:
+		return evict
+	case evict, wait:
+		return oomKill
+	default:
+		return wait
+	}
+}
@@ -0,0 +1,32 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package mempressure
+
+import (
+	"testing"
+)
+
+func TestNext(t *testing.T) {
+	// Usage over the limit for several periods, then back under it.
+	over := []bool{false, true, true, true, true, true, false, true}
+	want := []action{none, evict, oomKill, wait, oomKill, wait, none, evict}
+	last := none
+	for i := range over {
+		last = next(last, over[i])
+		if last != want[i] {
+			t.Fatalf("period %d: got action %d, want %d", i, last, want[i])
+		}
+	}
+}
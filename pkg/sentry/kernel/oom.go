@@ -0,0 +1,107 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+// OOM killing.
+
+import (
+	"sync/atomic"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/log"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/usermem"
+)
+
+// oomBadness returns the OOM badness of a thread group with an address space
+// of rssPages resident pages and the given oom_score_adj, when totalPages
+// pages of memory are usable. It is Linux's oom_badness() (mm/oom_kill.c),
+// except that page tables and swap aren't counted. The thread group with the
+// highest badness is killed first; a badness of 0 means that it must never be
+// killed.
+func oomBadness(rssPages, totalPages uint64, adj int32) int64 {
+	if adj == -1000 {
+		return 0
+	}
+	// Each unit of oom_score_adj is worth 0.1% of usable memory.
+	points := int64(rssPages) + int64(adj)*int64(totalPages/1000)
+	if points <= 0 {
+		// Still killable, but last.
+		return 1
+	}
+	return points
+}
+
+// residentSetSizeLocked returns the resident set size of tg's address space,
+// in bytes. ok is false if none of tg's tasks has an address space, e.g.
+// because they have all exited.
+//
+// Preconditions: The TaskSet mutex must be locked.
+func (tg *ThreadGroup) residentSetSizeLocked() (rss uint64, ok bool) {
+	for t := tg.tasks.Front(); t != nil && !ok; t = t.Next() {
+		t.WithMuLocked(func(t *Task) {
+			if mm := t.MemoryManager(); mm != nil {
+				rss = mm.ResidentSetSize()
+				ok = true
+			}
+		})
+	}
+	return rss, ok
+}
+
+// OOMKill kills the thread group with the highest OOM badness, as Linux does
+// when it runs out of memory, and returns it. totalBytes is the amount of
+// memory usable by the sandbox, against which oom_score_adj is scaled. The
+// global init process, and thread groups with an oom_score_adj of -1000, are
+// never killed; if no other thread group remains, OOMKill returns nil.
+//
+// Since the thread group is killed with SIGKILL, its memory is only freed
+// once its tasks have exited.
+func (k *Kernel) OOMKill(totalBytes uint64) *ThreadGroup {
+	totalPages := totalBytes / usermem.PageSize
+	init := k.GlobalInit()
+
+	var (
+		victim  *ThreadGroup
+		badness int64
+		rss     uint64
+	)
+	k.tasks.mu.RLock()
+	k.tasks.forEachThreadGroupLocked(func(tg *ThreadGroup) {
+		if tg == init {
+			return
+		}
+		tgRSS, ok := tg.residentSetSizeLocked()
+		if !ok {
+			return
+		}
+		if b := oomBadness(tgRSS/usermem.PageSize, totalPages, atomic.LoadInt32(&tg.oomScoreAdj)); b > badness {
+			victim, badness, rss = tg, b, tgRSS
+		}
+	})
+	k.tasks.mu.RUnlock()
+	if victim == nil {
+		return nil
+	}
+
+	log.Warningf("Out of memory: killing thread group %d with RSS %d bytes and OOM badness %d", k.tasks.Root.IDOfThreadGroup(victim), rss, badness)
+	if err := victim.SendSignal(&arch.SignalInfo{
+		Signo: int32(linux.SIGKILL),
+		Code:  arch.SignalInfoKernel,
+	}); err != nil {
+		log.Warningf("Failed to send SIGKILL to OOM victim: %v", err)
+	}
+	return victim
+}
@@ -0,0 +1,42 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"testing"
+)
+
+func TestOOMBadness(t *testing.T) {
+	const totalPages = 1 << 20
+	for _, tc := range []struct {
+		name string
+		rss  uint64
+		adj  int32
+		want int64
+	}{
+		{name: "no adjustment", rss: 1000, adj: 0, want: 1000},
+		{name: "unkillable", rss: 1 << 19, adj: -1000, want: 0},
+		{name: "preferred", rss: 1000, adj: 500, want: 1000 + 500*(totalPages/1000)},
+		{name: "protected", rss: 1000, adj: -500, want: 1},
+		{name: "partly protected", rss: 1 << 19, adj: -100, want: 1<<19 - 100*(totalPages/1000)},
+		{name: "no memory", rss: 0, adj: 0, want: 1},
+	} {
+		t.Run(tc.name, func(t *testing.T) {
+			if got := oomBadness(tc.rss, totalPages, tc.adj); got != tc.want {
+				t.Errorf("oomBadness(%d, %d, %d) = %d, want %d", tc.rss, totalPages, tc.adj, got, tc.want)
+			}
+		})
+	}
+}
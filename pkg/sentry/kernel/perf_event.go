@@ -0,0 +1,781 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"fmt"
+	"sync/atomic"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/safemem"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/platform"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
+	"gvisor.dev/gvisor/pkg/sync"
+	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// perfSampleTypes is the set of PERF_SAMPLE_* fields that may be recorded in
+// samples.
+const perfSampleTypes = linux.PERF_SAMPLE_IDENTIFIER | linux.PERF_SAMPLE_IP | linux.PERF_SAMPLE_TID | linux.PERF_SAMPLE_TIME | linux.PERF_SAMPLE_ID | linux.PERF_SAMPLE_STREAM_ID | linux.PERF_SAMPLE_CPU | linux.PERF_SAMPLE_PERIOD
+
+// perfReadFormats is the set of PERF_FORMAT_* fields that may be returned by
+// read(2).
+const perfReadFormats = linux.PERF_FORMAT_TOTAL_TIME_ENABLED | linux.PERF_FORMAT_TOTAL_TIME_RUNNING | linux.PERF_FORMAT_ID
+
+// PerfEvent is a software event counter created by perf_event_open(2), which
+// counts events in a single task and may periodically record samples of the
+// task's state in a ring buffer mapped by the application.
+//
+// Samples are taken at CPU clock ticks, by which time the event's count may
+// have passed the sample period by more than one period; only one sample is
+// recorded per tick, and its PERF_SAMPLE_PERIOD is the number of events since
+// the previous sample. Samples are written by the task goroutine of the
+// counted task, so that they reflect its register state, the next time it
+// enters or leaves the sentry.
+//
+// PerfEvent implements memmap.Mappable for its ring buffer.
+//
+// +stateify savable
+type PerfEvent struct {
+	// k is the owning Kernel. k is immutable.
+	k *Kernel
+
+	// target is the counted task. target is immutable.
+	target *Task
+
+	// pidns is the PID namespace of the task that created the event, in
+	// which thread IDs in samples are reported. pidns is immutable.
+	pidns *PIDNamespace
+
+	// attr is the event's configuration. attr is immutable.
+	attr linux.PerfEventAttr
+
+	// id identifies the event in samples and read(2). id is immutable.
+	id uint64
+
+	// queue is notified when samples are recorded and when target exits.
+	queue waiter.Queue `state:"zerovalue"`
+
+	mu sync.Mutex `state:"nosave"`
+
+	// enabled is true if the event is counting. enabled is protected by mu.
+	enabled bool
+
+	// enableOnExec is true if the event should be enabled when target next
+	// calls execve(2). enableOnExec is protected by mu.
+	enableOnExec bool
+
+	// exited is true if target has exited, after which the event's count
+	// never changes. exited is protected by mu.
+	exited bool
+
+	// count is the event's count, excluding events since base if enabled is
+	// true. count is protected by mu.
+	count uint64
+
+	// If enabled is true, base is the value of perfEventSource(target) when
+	// the event was enabled or last reset. base is protected by mu.
+	base uint64
+
+	// timeEnabled is the time in nanoseconds for which the event has been
+	// enabled, excluding time since enabledAt if enabled is true.
+	// timeEnabled and enabledAt are protected by mu.
+	timeEnabled int64
+	enabledAt   int64
+
+	// period is the number of events between samples, or 0 if the event does
+	// not take samples. period is protected by mu.
+	period uint64
+
+	// lastSample is the count at the previous sample, and nextSample is the
+	// count at which the next sample is due. lastSample and nextSample are
+	// protected by mu.
+	lastSample uint64
+	nextSample uint64
+
+	// If samplePending is true, a sample is due to be written by target's
+	// task goroutine, with PERF_SAMPLE_PERIOD samplePeriod. samplePending
+	// and samplePeriod are protected by mu.
+	samplePending bool
+	samplePeriod  uint64
+
+	// refresh is the number of samples after which the event is disabled,
+	// as set by PERF_EVENT_IOC_REFRESH, or 0 if samples are unlimited.
+	// refresh is protected by mu.
+	refresh int64
+
+	// fr is the range of k.MemoryFile() holding the ring buffer, whose first
+	// page is a struct perf_event_mmap_page. fr is empty until the ring
+	// buffer is first mapped. fr is protected by mu.
+	fr platform.FileRange
+
+	// head is the number of bytes that have been written to the ring buffer,
+	// which is published as data_head. head is protected by mu.
+	head uint64
+
+	// overwrite is true if the ring buffer was mapped without PROT_WRITE, in
+	// which case the reader's data_tail is ignored and old records are
+	// overwritten. overwrite is protected by mu.
+	overwrite bool
+
+	// wakeupEvents is the number of samples, or bytes if attr has
+	// PERF_ATTR_FLAG_WATERMARK, recorded since the queue was last notified.
+	// wakeupEvents is protected by mu.
+	wakeupEvents uint32
+}
+
+// NewPerfEvent creates a PerfEvent counting events in target, as requested by
+// t.
+func NewPerfEvent(t, target *Task, attr linux.PerfEventAttr) (*PerfEvent, error) {
+	if attr.Type != linux.PERF_TYPE_SOFTWARE || attr.Config > linux.PERF_COUNT_SW_DUMMY {
+		// Linux returns ENOENT for events that the PMU doesn't support,
+		// which perf(1) uses to fall back to software events.
+		return nil, syserror.ENOENT
+	}
+	if attr.SampleType&^perfSampleTypes != 0 || attr.ReadFormat&^perfReadFormats != 0 {
+		return nil, syserror.EINVAL
+	}
+	period := attr.SamplePeriod
+	if attr.Flags&linux.PERF_ATTR_FLAG_FREQ != 0 {
+		if attr.SamplePeriod == 0 {
+			return nil, syserror.EINVAL
+		}
+		period = perfFreqToPeriod(attr.Config, attr.SamplePeriod)
+	}
+
+	e := &PerfEvent{
+		k:            t.k,
+		target:       target,
+		pidns:        t.PIDNamespace(),
+		attr:         attr,
+		id:           t.k.UniqueID(),
+		period:       period,
+		enableOnExec: attr.Flags&linux.PERF_ATTR_FLAG_ENABLE_ON_EXEC != 0,
+	}
+	if attr.Flags&linux.PERF_ATTR_FLAG_DISABLED == 0 {
+		e.enableLocked()
+	}
+
+	target.mu.Lock()
+	if target.perfEventsClosed {
+		target.mu.Unlock()
+		return nil, syserror.ESRCH
+	}
+	target.perfEvents = append(target.perfEvents, e)
+	target.mu.Unlock()
+	if period != 0 {
+		atomic.AddInt32(&t.k.perfSamplingEvents, 1)
+	}
+	return e, nil
+}
+
+// perfFreqToPeriod returns the sample period that approximates freq samples
+// per second of CPU time for the software event config. Linux adjusts the
+// period of other events at runtime to achieve freq; since gVisor samples at
+// most once per CPU clock tick, such events sample whenever they have
+// changed.
+func perfFreqToPeriod(config, freq uint64) uint64 {
+	switch config {
+	case linux.PERF_COUNT_SW_CPU_CLOCK, linux.PERF_COUNT_SW_TASK_CLOCK:
+		if freq >= 1e9 {
+			return 1
+		}
+		return 1e9 / freq
+	default:
+		return 1
+	}
+}
+
+// perfEventSource returns the monotonic value of target from which an event
+// counting config is derived.
+func perfEventSource(target *Task, config uint64) uint64 {
+	switch config {
+	case linux.PERF_COUNT_SW_CPU_CLOCK, linux.PERF_COUNT_SW_TASK_CLOCK:
+		stats := target.CPUStats()
+		return uint64((stats.UserTime + stats.SysTime).Nanoseconds())
+	case linux.PERF_COUNT_SW_PAGE_FAULTS, linux.PERF_COUNT_SW_PAGE_FAULTS_MIN:
+		// All page faults handled by the sentry are minor faults.
+		return atomic.LoadUint64(&target.faultCount)
+	case linux.PERF_COUNT_SW_CONTEXT_SWITCHES:
+		return atomic.LoadUint64(&target.yieldCount)
+	default:
+		// The sentry never observes other events.
+		return 0
+	}
+}
+
+// now returns the current time in nanoseconds on the application monotonic
+// clock.
+func (e *PerfEvent) now() int64 {
+	return e.k.MonotonicClock().Now().Nanoseconds()
+}
+
+// valueLocked returns the event's current count.
+//
+// Preconditions: e.mu must be locked.
+func (e *PerfEvent) valueLocked() uint64 {
+	if !e.enabled {
+		return e.count
+	}
+	return e.count + perfEventSource(e.target, e.attr.Config) - e.base
+}
+
+// timeEnabledLocked returns the time in nanoseconds for which the event has
+// been enabled.
+//
+// Preconditions: e.mu must be locked.
+func (e *PerfEvent) timeEnabledLocked() int64 {
+	if !e.enabled {
+		return e.timeEnabled
+	}
+	return e.timeEnabled + e.now() - e.enabledAt
+}
+
+// enableLocked starts counting.
+//
+// Preconditions: e.mu must be locked, or e must not yet be visible to other
+// goroutines.
+func (e *PerfEvent) enableLocked() {
+	if e.enabled || e.exited {
+		return
+	}
+	e.base = perfEventSource(e.target, e.attr.Config)
+	e.enabledAt = e.now()
+	e.enabled = true
+	e.lastSample = e.count
+	e.nextSample = e.count + e.period
+}
+
+// disableLocked stops counting.
+//
+// Preconditions: e.mu must be locked.
+func (e *PerfEvent) disableLocked() {
+	if !e.enabled {
+		return
+	}
+	e.count = e.valueLocked()
+	e.timeEnabled = e.timeEnabledLocked()
+	e.enabled = false
+}
+
+// Release must be called when the event is no longer in use.
+func (e *PerfEvent) Release() {
+	t := e.target
+	t.mu.Lock()
+	for i, other := range t.perfEvents {
+		if other == e {
+			t.perfEvents = append(t.perfEvents[:i], t.perfEvents[i+1:]...)
+			break
+		}
+	}
+	t.mu.Unlock()
+
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	if e.period != 0 {
+		atomic.AddInt32(&e.k.perfSamplingEvents, -1)
+	}
+	if e.fr.Length() != 0 {
+		e.k.MemoryFile().DecRef(e.fr)
+		e.fr = platform.FileRange{}
+	}
+}
+
+// Read implements the semantics of read(2) for the event, which returns its
+// count followed by the fields requested in its read_format.
+func (e *PerfEvent) Read(ctx context.Context, dst usermem.IOSequence) (int64, error) {
+	e.mu.Lock()
+	vals := []uint64{e.valueLocked()}
+	if e.attr.ReadFormat&linux.PERF_FORMAT_TOTAL_TIME_ENABLED != 0 {
+		vals = append(vals, uint64(e.timeEnabledLocked()))
+	}
+	if e.attr.ReadFormat&linux.PERF_FORMAT_TOTAL_TIME_RUNNING != 0 {
+		// Software events are never multiplexed, so they run whenever
+		// they are enabled.
+		vals = append(vals, uint64(e.timeEnabledLocked()))
+	}
+	if e.attr.ReadFormat&linux.PERF_FORMAT_ID != 0 {
+		vals = append(vals, e.id)
+	}
+	e.mu.Unlock()
+
+	buf := make([]byte, 8*len(vals))
+	if dst.NumBytes() < int64(len(buf)) {
+		return 0, syserror.ENOSPC
+	}
+	for i, v := range vals {
+		usermem.ByteOrder.PutUint64(buf[8*i:], v)
+	}
+	n, err := dst.CopyOut(ctx, buf)
+	return int64(n), err
+}
+
+// Ioctl implements the PERF_EVENT_IOC_* ioctls on the event.
+func (e *PerfEvent) Ioctl(ctx context.Context, io usermem.IO, args arch.SyscallArguments) (uintptr, error) {
+	switch cmd := args[1].Uint(); cmd {
+	case linux.PERF_EVENT_IOC_ENABLE:
+		e.mu.Lock()
+		e.enableLocked()
+		e.mu.Unlock()
+		return 0, nil
+
+	case linux.PERF_EVENT_IOC_DISABLE:
+		e.mu.Lock()
+		e.disableLocked()
+		e.mu.Unlock()
+		return 0, nil
+
+	case linux.PERF_EVENT_IOC_RESET:
+		e.mu.Lock()
+		if e.enabled {
+			e.base = perfEventSource(e.target, e.attr.Config)
+		}
+		e.count = 0
+		e.lastSample = 0
+		e.nextSample = e.period
+		e.mu.Unlock()
+		return 0, nil
+
+	case linux.PERF_EVENT_IOC_REFRESH:
+		n := args[2].Int()
+		if n <= 0 {
+			return 0, syserror.EINVAL
+		}
+		e.mu.Lock()
+		defer e.mu.Unlock()
+		if e.period == 0 {
+			return 0, syserror.EINVAL
+		}
+		e.refresh += int64(n)
+		e.enableLocked()
+		return 0, nil
+
+	case linux.PERF_EVENT_IOC_PERIOD:
+		var buf [8]byte
+		if _, err := io.CopyIn(ctx, args[2].Pointer(), buf[:], usermem.IOOpts{AddressSpaceActive: true}); err != nil {
+			return 0, err
+		}
+		period := usermem.ByteOrder.Uint64(buf[:])
+		if period == 0 {
+			return 0, syserror.EINVAL
+		}
+		if e.attr.Flags&linux.PERF_ATTR_FLAG_FREQ != 0 {
+			period = perfFreqToPeriod(e.attr.Config, period)
+		}
+		e.mu.Lock()
+		defer e.mu.Unlock()
+		if e.period == 0 {
+			// Whether the event samples was fixed when it was created.
+			return 0, syserror.EINVAL
+		}
+		e.period = period
+		e.nextSample = e.lastSample + period
+		return 0, nil
+
+	case linux.PERF_EVENT_IOC_ID:
+		var buf [8]byte
+		usermem.ByteOrder.PutUint64(buf[:], e.id)
+		_, err := io.CopyOut(ctx, args[2].Pointer(), buf[:], usermem.IOOpts{AddressSpaceActive: true})
+		return 0, err
+
+	default:
+		return 0, syserror.ENOTTY
+	}
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (e *PerfEvent) Readiness(mask waiter.EventMask) waiter.EventMask {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	var ready waiter.EventMask
+	if e.exited {
+		ready |= waiter.EventHUp
+	}
+	if hdr, ok := e.headerLocked(); ok {
+		if tail, err := perfLoadUint64(hdr.DropFirst(linux.PERF_MMAP_PAGE_DATA_TAIL)); err == nil && tail != e.head {
+			ready |= waiter.EventIn
+		}
+	}
+	return mask & ready
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (e *PerfEvent) EventRegister(entry *waiter.Entry, mask waiter.EventMask) {
+	e.queue.EventRegister(entry, mask)
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (e *PerfEvent) EventUnregister(entry *waiter.Entry) {
+	e.queue.EventUnregister(entry)
+}
+
+// ConfigureMMap prepares the event's ring buffer to be mapped as described by
+// opts. The mapping must be shared, and consist of the header page followed
+// by zero or a power of 2 data pages. All mappings of the event share the
+// same ring buffer, so they must have the same length.
+func (e *PerfEvent) ConfigureMMap(opts *memmap.MMapOpts) error {
+	if opts.Private || opts.Offset != 0 || opts.Length%usermem.PageSize != 0 {
+		return syserror.EINVAL
+	}
+	dataPages := opts.Length/usermem.PageSize - 1
+	if opts.Length == 0 || dataPages&(dataPages-1) != 0 {
+		return syserror.EINVAL
+	}
+
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	if e.fr.Length() != 0 {
+		if e.fr.Length() != opts.Length {
+			return syserror.EINVAL
+		}
+		return nil
+	}
+	mf := e.k.MemoryFile()
+	fr, err := mf.Allocate(opts.Length, usage.Anonymous)
+	if err != nil {
+		return err
+	}
+	e.fr = fr
+	e.overwrite = !opts.Perms.Write
+	hdr, ok := e.headerLocked()
+	if ok {
+		for _, f := range []struct {
+			off uint64
+			val uint64
+		}{
+			{linux.PERF_MMAP_PAGE_CAPABILITIES, linux.PERF_MMAP_CAP_BIT0_IS_DEPRECATED},
+			{linux.PERF_MMAP_PAGE_DATA_OFFSET, usermem.PageSize},
+			{linux.PERF_MMAP_PAGE_DATA_SIZE, dataPages * usermem.PageSize},
+		} {
+			if _, err := safemem.SwapUint64(hdr.DropFirst64(f.off), f.val); err != nil {
+				ok = false
+				break
+			}
+		}
+	}
+	if !ok {
+		mf.DecRef(fr)
+		e.fr = platform.FileRange{}
+		return syserror.ENOMEM
+	}
+	return nil
+}
+
+// headerLocked returns a mapping of the header page of the event's ring
+// buffer. It returns false if the ring buffer has not been mapped.
+//
+// Preconditions: e.mu must be locked.
+func (e *PerfEvent) headerLocked() (safemem.Block, bool) {
+	if e.fr.Length() == 0 {
+		return safemem.Block{}, false
+	}
+	bs, err := e.k.MemoryFile().MapInternal(platform.FileRange{e.fr.Start, e.fr.Start + usermem.PageSize}, usermem.ReadWrite)
+	if err != nil {
+		return safemem.Block{}, false
+	}
+	return bs.Head(), true
+}
+
+// perfLoadUint64 loads a uint64 from b, which the application may store to
+// concurrently.
+func perfLoadUint64(b safemem.Block) (uint64, error) {
+	for {
+		hi, err := safemem.LoadUint32(b.DropFirst(4))
+		if err != nil {
+			return 0, err
+		}
+		lo, err := safemem.LoadUint32(b)
+		if err != nil {
+			return 0, err
+		}
+		// Check that lo did not wrap between the loads.
+		if hi2, err := safemem.LoadUint32(b.DropFirst(4)); err != nil || hi2 == hi {
+			return uint64(hi)<<32 | uint64(lo), err
+		}
+	}
+}
+
+// writeRecordLocked appends rec to the event's ring buffer. It returns false
+// if rec was dropped because the ring buffer is not mapped or is full.
+//
+// Preconditions: e.mu must be locked.
+func (e *PerfEvent) writeRecordLocked(rec []byte) bool {
+	hdr, ok := e.headerLocked()
+	if !ok {
+		return false
+	}
+	size := uint64(len(rec))
+	dataSize := e.fr.Length() - usermem.PageSize
+	if size > dataSize {
+		return false
+	}
+	if !e.overwrite {
+		tail, err := perfLoadUint64(hdr.DropFirst(linux.PERF_MMAP_PAGE_DATA_TAIL))
+		if err != nil || e.head-tail+size > dataSize {
+			return false
+		}
+	}
+	data, err := e.k.MemoryFile().MapInternal(platform.FileRange{e.fr.Start + usermem.PageSize, e.fr.End}, usermem.ReadWrite)
+	if err != nil {
+		return false
+	}
+	// Records wrap around the end of the data area.
+	off := e.head % dataSize
+	first := dataSize - off
+	if first > size {
+		first = size
+	}
+	if _, err := safemem.CopySeq(data.DropFirst64(off), safemem.BlockSeqOf(safemem.BlockFromSafeSlice(rec[:first]))); err != nil {
+		return false
+	}
+	if first < size {
+		if _, err := safemem.CopySeq(data, safemem.BlockSeqOf(safemem.BlockFromSafeSlice(rec[first:]))); err != nil {
+			return false
+		}
+	}
+	e.head += size
+	// The swap orders the record before data_head for readers.
+	if _, err := safemem.SwapUint64(hdr.DropFirst(linux.PERF_MMAP_PAGE_DATA_HEAD), e.head); err != nil {
+		return false
+	}
+	return true
+}
+
+// tickLocked checks whether a sample is due, and returns true if one is
+// pending.
+//
+// Preconditions: e.mu must be locked.
+func (e *PerfEvent) tickLocked() bool {
+	if !e.enabled || e.period == 0 {
+		return false
+	}
+	if v := e.valueLocked(); v >= e.nextSample {
+		e.samplePeriod += v - e.lastSample
+		e.lastSample = v
+		e.nextSample = v + e.period
+		e.samplePending = true
+	}
+	return e.samplePending
+}
+
+// writeSample writes the event's pending sample, if any, describing t.
+//
+// Preconditions: The caller must be running on t's task goroutine. t must be
+// e.target.
+func (e *PerfEvent) writeSample(t *Task) {
+	e.mu.Lock()
+	if !e.samplePending {
+		e.mu.Unlock()
+		return
+	}
+	e.samplePending = false
+	period := e.samplePeriod
+	e.samplePeriod = 0
+
+	st := e.attr.SampleType
+	rec := make([]byte, 8, 64)
+	put64 := func(v uint64) {
+		rec = append(rec, 0, 0, 0, 0, 0, 0, 0, 0)
+		usermem.ByteOrder.PutUint64(rec[len(rec)-8:], v)
+	}
+	put32x2 := func(hi, lo uint32) {
+		put64(uint64(hi)<<32 | uint64(lo))
+	}
+	if st&linux.PERF_SAMPLE_IDENTIFIER != 0 {
+		put64(e.id)
+	}
+	if st&linux.PERF_SAMPLE_IP != 0 {
+		put64(uint64(t.Arch().IP()))
+	}
+	if st&linux.PERF_SAMPLE_TID != 0 {
+		put32x2(uint32(e.pidns.IDOfTask(t)), uint32(e.pidns.IDOfThreadGroup(t.tg)))
+	}
+	if st&linux.PERF_SAMPLE_TIME != 0 {
+		put64(uint64(e.now()))
+	}
+	if st&linux.PERF_SAMPLE_ID != 0 {
+		put64(e.id)
+	}
+	if st&linux.PERF_SAMPLE_STREAM_ID != 0 {
+		put64(e.id)
+	}
+	if st&linux.PERF_SAMPLE_CPU != 0 {
+		put32x2(0, uint32(t.CPU()))
+	}
+	if st&linux.PERF_SAMPLE_PERIOD != 0 {
+		put64(period)
+	}
+	hdr := linux.PerfEventHeader{
+		Type: linux.PERF_RECORD_SAMPLE,
+		Misc: linux.PERF_RECORD_MISC_USER,
+		Size: uint16(len(rec)),
+	}
+	hdr.MarshalBytes(rec[:8])
+	e.writeRecordLocked(rec)
+
+	if e.refresh > 0 {
+		e.refresh--
+		if e.refresh == 0 {
+			e.disableLocked()
+		}
+	}
+	// Readers are woken every wakeup_events samples, or every
+	// wakeup_watermark bytes (by default, half of the ring buffer).
+	threshold := e.attr.WakeupEvents
+	if e.attr.Flags&linux.PERF_ATTR_FLAG_WATERMARK != 0 {
+		e.wakeupEvents += uint32(len(rec))
+		if threshold == 0 {
+			threshold = uint32((e.fr.Length() - usermem.PageSize) / 2)
+		}
+	} else {
+		e.wakeupEvents++
+	}
+	wakeup := e.wakeupEvents >= threshold
+	if wakeup {
+		e.wakeupEvents = 0
+	}
+	e.mu.Unlock()
+	if wakeup {
+		e.queue.Notify(waiter.EventIn)
+	}
+}
+
+// String implements fmt.Stringer.String.
+func (e *PerfEvent) String() string {
+	return fmt.Sprintf("perf event %d (type %d, config %d)", e.id, e.attr.Type, e.attr.Config)
+}
+
+// AddMapping implements memmap.Mappable.AddMapping.
+func (*PerfEvent) AddMapping(context.Context, memmap.MappingSpace, usermem.AddrRange, uint64, bool) error {
+	return nil
+}
+
+// RemoveMapping implements memmap.Mappable.RemoveMapping.
+func (*PerfEvent) RemoveMapping(context.Context, memmap.MappingSpace, usermem.AddrRange, uint64, bool) {
+}
+
+// CopyMapping implements memmap.Mappable.CopyMapping.
+func (*PerfEvent) CopyMapping(context.Context, memmap.MappingSpace, usermem.AddrRange, usermem.AddrRange, uint64, bool) error {
+	return nil
+}
+
+// Translate implements memmap.Mappable.Translate.
+func (e *PerfEvent) Translate(ctx context.Context, required, optional memmap.MappableRange, at usermem.AccessType) ([]memmap.Translation, error) {
+	e.mu.Lock()
+	fr := e.fr
+	e.mu.Unlock()
+	var err error
+	if required.End > fr.Length() {
+		err = &memmap.BusError{syserror.EFAULT}
+	}
+	if source := optional.Intersect(memmap.MappableRange{0, fr.Length()}); source.Length() != 0 {
+		return []memmap.Translation{
+			{
+				Source: source,
+				File:   e.k.MemoryFile(),
+				Offset: fr.Start + source.Start,
+				Perms:  usermem.AnyAccess,
+			},
+		}, err
+	}
+	return nil, err
+}
+
+// InvalidateUnsavable implements memmap.Mappable.InvalidateUnsavable.
+func (*PerfEvent) InvalidateUnsavable(context.Context) error {
+	return nil
+}
+
+// tickPerfEvents checks all sampling perf events for samples that are due,
+// and interrupts the tasks that must write them.
+func (k *Kernel) tickPerfEvents() {
+	k.tasks.mu.RLock()
+	defer k.tasks.mu.RUnlock()
+	for t := range k.tasks.Root.tids {
+		t.mu.Lock()
+		pending := false
+		for _, e := range t.perfEvents {
+			e.mu.Lock()
+			if e.tickLocked() {
+				pending = true
+			}
+			e.mu.Unlock()
+		}
+		t.mu.Unlock()
+		if !pending {
+			continue
+		}
+		atomic.StoreUint32(&t.perfSamplePending, 1)
+		if t.TaskGoroutineSchedInfo().State == TaskGoroutineRunningApp {
+			// Make the task goroutine write the sample now, rather than
+			// when the task next enters the sentry by itself.
+			t.p.Interrupt()
+		}
+	}
+}
+
+// writePerfSamples writes pending samples for perf events counting t.
+//
+// Preconditions: The caller must be running on the task goroutine, and t must
+// not be executing application code.
+func (t *Task) writePerfSamples() {
+	atomic.StoreUint32(&t.perfSamplePending, 0)
+	t.mu.Lock()
+	events := append([]*PerfEvent(nil), t.perfEvents...)
+	t.mu.Unlock()
+	for _, e := range events {
+		e.writeSample(t)
+	}
+}
+
+// enablePerfEventsOnExec enables perf events counting t that were created
+// with enable_on_exec, when t calls execve(2).
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (t *Task) enablePerfEventsOnExec() {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	for _, e := range t.perfEvents {
+		e.mu.Lock()
+		if e.enableOnExec {
+			e.enableOnExec = false
+			e.enableLocked()
+		}
+		e.mu.Unlock()
+	}
+}
+
+// closePerfEvents stops perf events counting t, which is exiting.
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (t *Task) closePerfEvents() {
+	t.mu.Lock()
+	events := t.perfEvents
+	t.perfEvents = nil
+	t.perfEventsClosed = true
+	t.mu.Unlock()
+	for _, e := range events {
+		e.mu.Lock()
+		e.disableLocked()
+		e.exited = true
+		e.mu.Unlock()
+		e.queue.Notify(waiter.EventHUp)
+	}
+}
@@ -0,0 +1,92 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package perfevent provides an implementation of perf_event_open(2) files.
+package perfevent
+
+import (
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/fs"
+	"gvisor.dev/gvisor/pkg/sentry/fs/anon"
+	"gvisor.dev/gvisor/pkg/sentry/fs/fsutil"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// PerfEventOperations represent a file with perf event semantics.
+//
+// +stateify savable
+type PerfEventOperations struct {
+	fsutil.FilePipeSeek             `state:"nosave"`
+	fsutil.FileNotDirReaddir        `state:"nosave"`
+	fsutil.FileNoFsync              `state:"nosave"`
+	fsutil.FileNoSplice             `state:"nosave"`
+	fsutil.FileNoWrite              `state:"nosave"`
+	fsutil.FileNoopFlush            `state:"nosave"`
+	fsutil.FileUseInodeUnstableAttr `state:"nosave"`
+
+	event *kernel.PerfEvent
+}
+
+// New creates a new perf event file for e, which it takes ownership of.
+func New(ctx context.Context, e *kernel.PerfEvent) *fs.File {
+	// name matches kernel/events/core.c:SYSCALL_DEFINE5(perf_event_open).
+	dirent := fs.NewDirent(ctx, anon.NewInode(ctx), "anon_inode:[perf_event]")
+	// Release the initial dirent reference after NewFile takes a reference.
+	defer dirent.DecRef()
+	return fs.NewFile(ctx, dirent, fs.FileFlags{Read: true, Write: true}, &PerfEventOperations{
+		event: e,
+	})
+}
+
+// Release implements fs.FileOperations.Release.
+func (p *PerfEventOperations) Release() {
+	p.event.Release()
+}
+
+// Read implements fs.FileOperations.Read.
+func (p *PerfEventOperations) Read(ctx context.Context, _ *fs.File, dst usermem.IOSequence, _ int64) (int64, error) {
+	return p.event.Read(ctx, dst)
+}
+
+// Ioctl implements fs.FileOperations.Ioctl.
+func (p *PerfEventOperations) Ioctl(ctx context.Context, _ *fs.File, io usermem.IO, args arch.SyscallArguments) (uintptr, error) {
+	return p.event.Ioctl(ctx, io, args)
+}
+
+// ConfigureMMap implements fs.FileOperations.ConfigureMMap.
+func (p *PerfEventOperations) ConfigureMMap(ctx context.Context, file *fs.File, opts *memmap.MMapOpts) error {
+	if err := p.event.ConfigureMMap(opts); err != nil {
+		return err
+	}
+	return fsutil.GenericConfigureMMap(file, p.event, opts)
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (p *PerfEventOperations) Readiness(mask waiter.EventMask) waiter.EventMask {
+	return p.event.Readiness(mask)
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (p *PerfEventOperations) EventRegister(e *waiter.Entry, mask waiter.EventMask) {
+	p.event.EventRegister(e, mask)
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (p *PerfEventOperations) EventUnregister(e *waiter.Entry) {
+	p.event.EventUnregister(e)
+}
@@ -0,0 +1,79 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package pidfd provides an implementation of process file descriptors.
+package pidfd
+
+import (
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/sentry/fs"
+	"gvisor.dev/gvisor/pkg/sentry/fs/anon"
+	"gvisor.dev/gvisor/pkg/sentry/fs/fsutil"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// PIDOperations represent a file with pidfd semantics.
+//
+// +stateify savable
+type PIDOperations struct {
+	fsutil.FileNoopRelease          `state:"nosave"`
+	fsutil.FilePipeSeek             `state:"nosave"`
+	fsutil.FileNotDirReaddir        `state:"nosave"`
+	fsutil.FileNoIoctl              `state:"nosave"`
+	fsutil.FileNoFsync              `state:"nosave"`
+	fsutil.FileNoMMap               `state:"nosave"`
+	fsutil.FileNoSplice             `state:"nosave"`
+	fsutil.FileNoRead               `state:"nosave"`
+	fsutil.FileNoWrite              `state:"nosave"`
+	fsutil.FileNoopFlush            `state:"nosave"`
+	fsutil.FileUseInodeUnstableAttr `state:"nosave"`
+
+	// tg is the thread group that the file refers to. tg is immutable.
+	tg *kernel.ThreadGroup
+}
+
+// New creates a new pidfd referring to tg.
+func New(ctx context.Context, tg *kernel.ThreadGroup) *fs.File {
+	// name matches kernel/pid.c:pidfd_create().
+	dirent := fs.NewDirent(ctx, anon.NewInode(ctx), "anon_inode:[pidfd]")
+	// Release the initial dirent reference after NewFile takes a reference.
+	defer dirent.DecRef()
+	return fs.NewFile(ctx, dirent, fs.FileFlags{Read: true, Write: true}, &PIDOperations{
+		tg: tg,
+	})
+}
+
+// ThreadGroup returns the thread group that the file refers to.
+func (p *PIDOperations) ThreadGroup() *kernel.ThreadGroup {
+	return p.tg
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (p *PIDOperations) Readiness(mask waiter.EventMask) waiter.EventMask {
+	if mask&waiter.EventIn != 0 && p.tg.Exited() {
+		return waiter.EventIn
+	}
+	return 0
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (p *PIDOperations) EventRegister(e *waiter.Entry, _ waiter.EventMask) {
+	p.tg.ExitEventRegister(e)
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (p *PIDOperations) EventUnregister(e *waiter.Entry) {
+	p.tg.ExitEventUnregister(e)
+}
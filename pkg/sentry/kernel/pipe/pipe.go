@@ -71,7 +71,9 @@ type Pipe struct {
 	// mu protects all pipe internal state below.
 	mu sync.Mutex `state:"nosave"`
 
-	// view is the underlying set of buffers.
+	// view is the underlying set of buffers. Up to max bytes of buffers
+	// drained by readers are kept by view for reuse by writers, so that a
+	// pipe in steady use cycles through the same buffers.
 	//
 	// This is protected by mu.
 	view buffer.View
@@ -128,6 +130,7 @@ func initPipe(pipe *Pipe, isNamed bool, sizeBytes, atomicIOBytes int64) {
 	pipe.isNamed = isNamed
 	pipe.max = sizeBytes
 	pipe.atomicIOBytes = atomicIOBytes
+	pipe.view.SetMaxSpare(sizeBytes)
 }
 
 // NewConnectedPipe initializes a pipe and returns a pair of objects
@@ -415,5 +418,6 @@ func (p *Pipe) SetFifoSize(size int64) (int64, error) {
 		return 0, syserror.EBUSY
 	}
 	p.max = size
+	p.view.SetMaxSpare(size)
 	return size, nil
 }
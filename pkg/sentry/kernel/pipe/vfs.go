@@ -431,11 +431,12 @@ func spliceOrTee(ctx context.Context, dst, src *VFSPipeFD, count int64, removeFr
 					count = l
 				},
 				read: func(srcView *buffer.View) (int64, error) {
-					n, err := srcView.ReadToSafememWriter(dstView, uint64(count))
-					if n > 0 && removeFromSrc {
-						srcView.TrimFront(int64(n))
+					// Whole buffers are moved or shared between the
+					// pipes rather than copied.
+					if removeFromSrc {
+						return dstView.Move(srcView, count), nil
 					}
-					return int64(n), err
+					return dstView.Tee(srcView, count), nil
 				},
 			})
 		},
@@ -0,0 +1,237 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"gvisor.dev/gvisor/pkg/sync"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// PollCache retains the waiter registrations made by a task's calls to
+// poll(2), ppoll(2), select(2) and pselect(2) between calls, so that a task
+// that repeatedly polls the same file descriptors registers with each file
+// once rather than on every call.
+//
+// A PollCache does not hold references on files. Instead, each entry is
+// invalidated by the FDTable, while it still holds its own reference on the
+// file, when the entry's file descriptor is closed or replaced.
+//
+// Lock order: FDTable.mu -> PollCache.mu
+type PollCache struct {
+	// fdTable is the FDTable whose file descriptors the cache's entries
+	// refer to. fdTable is immutable.
+	fdTable *FDTable
+
+	// ch is notified by all of the cache's waiters. ch is immutable.
+	ch chan struct{}
+
+	// mu protects the following fields.
+	mu sync.Mutex
+
+	// entries maps file descriptors to their registrations. A file
+	// descriptor may have more than one registration if it appears more
+	// than once, with different events, in a call's fd set.
+	entries map[int32][]*pollCacheEntry
+
+	// gen is incremented by each call to Begin.
+	gen uint64
+
+	// inCall is true between calls to Begin and End.
+	inCall bool
+
+	// stale holds entries that were invalidated during the current call
+	// while in use by it. They are unregistered by End, while the caller
+	// still holds its references on their files.
+	stale []*pollCacheEntry
+}
+
+// pollCacheEntry is a waiter registration in a PollCache.
+type pollCacheEntry struct {
+	// file is the registered file, which is an *fs.File or a
+	// *vfs.FileDescription.
+	file waiter.Waitable
+
+	// mask is the mask with which waiter is registered.
+	mask waiter.EventMask
+
+	// waiter is registered with file, and notifies PollCache.ch.
+	waiter waiter.Entry
+
+	// gen is the value of PollCache.gen at the last call that used the
+	// entry.
+	gen uint64
+}
+
+func (e *pollCacheEntry) unregister() {
+	e.file.EventUnregister(&e.waiter)
+}
+
+// PollCache returns t's PollCache, creating it if necessary.
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (t *Task) PollCache() *PollCache {
+	if c := t.pollCache; c != nil && c.fdTable == t.fdTable {
+		return c
+	}
+	t.releasePollCache()
+	c := &PollCache{
+		fdTable: t.fdTable,
+		ch:      make(chan struct{}, 1),
+		entries: make(map[int32][]*pollCacheEntry),
+	}
+	t.fdTable.mu.Lock()
+	if t.fdTable.pollCaches == nil {
+		t.fdTable.pollCaches = make(map[*PollCache]struct{})
+	}
+	t.fdTable.pollCaches[c] = struct{}{}
+	t.fdTable.mu.Unlock()
+	t.pollCache = c
+	return c
+}
+
+// releasePollCache unregisters all of t's cached poll waiters.
+//
+// Preconditions: The caller must be running on the task goroutine, or t must
+// be stopped.
+func (t *Task) releasePollCache() {
+	c := t.pollCache
+	if c == nil {
+		return
+	}
+	t.pollCache = nil
+	f := c.fdTable
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	delete(f.pollCaches, c)
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	for fd, es := range c.entries {
+		for _, e := range es {
+			e.unregister()
+		}
+		delete(c.entries, fd)
+	}
+}
+
+// Begin starts a poll call that uses c, and returns the channel that is
+// notified when a file registered during the call has events.
+//
+// Preconditions: The caller must be running on the task goroutine of the task
+// that owns c.
+func (c *PollCache) Begin() chan struct{} {
+	// Discard notifications from before the call; the caller checks
+	// readiness after registration.
+	select {
+	case <-c.ch:
+	default:
+	}
+	c.mu.Lock()
+	c.gen++
+	c.inCall = true
+	c.mu.Unlock()
+	return c.ch
+}
+
+// Register ensures that file, to which fd referred when the caller obtained
+// its reference on file, is registered for events in mask.
+//
+// Preconditions: The caller must be between calls to Begin and End, and must
+// hold a reference on file until End returns.
+func (c *PollCache) Register(fd int32, file waiter.Waitable, mask waiter.EventMask) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	for _, e := range c.entries[fd] {
+		if e.file == file && e.mask == mask {
+			e.gen = c.gen
+			return
+		}
+	}
+	e := &pollCacheEntry{
+		file: file,
+		mask: mask,
+		gen:  c.gen,
+	}
+	e.waiter, _ = waiter.NewChannelEntry(c.ch)
+	file.EventRegister(&e.waiter, mask)
+
+	// If fd has been closed or replaced since the caller looked it up, the
+	// FDTable has already invalidated it, so the registration can't outlive
+	// the call.
+	if !c.fdTable.refersTo(fd, file) {
+		c.stale = append(c.stale, e)
+		return
+	}
+	c.entries[fd] = append(c.entries[fd], e)
+}
+
+// End ends a poll call that uses c. Entries that were not used by the call are
+// unregistered, so the cache only retains the registrations of the most recent
+// call.
+//
+// Preconditions: The caller must be running on the task goroutine of the task
+// that owns c.
+func (c *PollCache) End() {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.inCall = false
+	for _, e := range c.stale {
+		e.unregister()
+	}
+	c.stale = nil
+	for fd, es := range c.entries {
+		kept := es[:0]
+		for _, e := range es {
+			if e.gen == c.gen {
+				kept = append(kept, e)
+			} else {
+				e.unregister()
+			}
+		}
+		if len(kept) == 0 {
+			delete(c.entries, fd)
+		} else {
+			c.entries[fd] = kept
+		}
+	}
+}
+
+// invalidate unregisters the entries for fd, if any.
+//
+// Preconditions: c.fdTable.mu must be locked. c.fdTable must still hold its
+// reference on the entry's file.
+func (c *PollCache) invalidate(fd int32) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	for _, e := range c.entries[fd] {
+		if c.inCall && e.gen == c.gen {
+			// The polling task holds a reference on the file until End.
+			c.stale = append(c.stale, e)
+		} else {
+			e.unregister()
+		}
+	}
+	delete(c.entries, fd)
+}
+
+// releasePollCaches unregisters the cached poll waiters of all tasks. This is
+// necessary before saving, since waiter queues must be empty.
+func (ts *TaskSet) releasePollCaches() {
+	ts.mu.RLock()
+	defer ts.mu.RUnlock()
+	for t := range ts.Root.tids {
+		// We can skip locking Task.mu here since the kernel is paused.
+		t.releasePollCache()
+	}
+}
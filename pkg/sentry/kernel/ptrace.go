@@ -561,11 +561,11 @@ func (t *Task) ptraceSyscallEnter() (taskRunState, bool) {
 		return nil, false
 	case ptraceSyscallIntercept:
 		t.Debugf("Entering syscall-enter-stop from PTRACE_SYSCALL")
-		t.ptraceSyscallStopLocked()
+		t.ptraceSyscallStopLocked(linux.PTRACE_EVENTMSG_SYSCALL_ENTRY)
 		return (*runSyscallAfterSyscallEnterStop)(nil), true
 	case ptraceSyscallEmu:
 		t.Debugf("Entering syscall-enter-stop from PTRACE_SYSEMU")
-		t.ptraceSyscallStopLocked()
+		t.ptraceSyscallStopLocked(linux.PTRACE_EVENTMSG_SYSCALL_ENTRY)
 		return (*runSyscallAfterSysemuStop)(nil), true
 	}
 	panic(fmt.Sprintf("Unknown ptraceSyscallMode: %v", t.ptraceSyscallMode))
@@ -583,11 +583,17 @@ func (t *Task) ptraceSyscallExit() {
 		return
 	}
 	t.Debugf("Entering syscall-exit-stop")
-	t.ptraceSyscallStopLocked()
+	t.ptraceSyscallStopLocked(linux.PTRACE_EVENTMSG_SYSCALL_EXIT)
 }
 
+// ptraceSyscallStopLocked enters syscall-enter-stop or syscall-exit-stop. msg
+// is PTRACE_EVENTMSG_SYSCALL_ENTRY or PTRACE_EVENTMSG_SYSCALL_EXIT
+// respectively, and is reported by PTRACE_GETEVENTMSG as in Linux 5.3 and
+// later.
+//
 // Preconditions: The TaskSet mutex must be locked.
-func (t *Task) ptraceSyscallStopLocked() {
+func (t *Task) ptraceSyscallStopLocked(msg uint64) {
+	t.ptraceEventMsg = msg
 	code := int32(linux.SIGTRAP)
 	if t.ptraceOpts.SysGood {
 		code |= 0x80
@@ -857,6 +863,46 @@ func (t *Task) ptraceSetOptionsLocked(opts uintptr) error {
 	return nil
 }
 
+// ptraceFreezeTracee checks that target is a ptrace-stopped tracee of t,
+// freezes its ptrace-stop, and waits for its task goroutine to stop. If
+// ptraceFreezeTracee returns nil, the caller must either end the ptrace-stop
+// or call target.ptraceUnfreeze.
+func (t *Task) ptraceFreezeTracee(target *Task) error {
+	t.tg.pidns.owner.mu.RLock()
+	if target.Tracer() != t {
+		t.tg.pidns.owner.mu.RUnlock()
+		return syserror.ESRCH
+	}
+	if !target.ptraceFreeze() {
+		t.tg.pidns.owner.mu.RUnlock()
+		// "Most ptrace commands (all except PTRACE_ATTACH, PTRACE_SEIZE,
+		// PTRACE_TRACEME, PTRACE_INTERRUPT, and PTRACE_KILL) require the
+		// tracee to be in a ptrace-stop, otherwise they fail with ESRCH." -
+		// ptrace(2)
+		return syserror.ESRCH
+	}
+	t.tg.pidns.owner.mu.RUnlock()
+	// Even if the target has a ptrace-stop active, the tracee's task goroutine
+	// may not yet have reached Task.doStop; wait for it to do so. This is safe
+	// because there's no way for target to initiate a ptrace-stop and then
+	// block (by calling Task.block) before entering it.
+	//
+	// Usually the tracee has stopped by the time the tracer has observed the
+	// stop and made a ptrace request, in which case skip deactivating our
+	// address space, which is expensive on some platforms, and tracers make
+	// several requests per stop.
+	//
+	// Caveat: If tasks were just restored, the tracee's first call to
+	// Task.Activate (in Task.run) occurs before its first call to Task.doStop,
+	// which may block if the tracer's address space is active.
+	if !target.goroutineIsStoppedOrExited() {
+		t.UninterruptibleSleepStart(true)
+		target.waitGoroutineStoppedOrExited()
+		t.UninterruptibleSleepFinish(true)
+	}
+	return nil
+}
+
 // Ptrace implements the ptrace system call.
 func (t *Task) Ptrace(req int64, pid ThreadID, addr, data usermem.Addr) error {
 	// PTRACE_TRACEME ignores all other arguments.
@@ -889,31 +935,9 @@ func (t *Task) Ptrace(req int64, pid ThreadID, addr, data usermem.Addr) error {
 	}
 	// All other ptrace requests require that the target is a ptrace-stopped
 	// tracee, and freeze the ptrace-stop so the tracee can be operated on.
-	t.tg.pidns.owner.mu.RLock()
-	if target.Tracer() != t {
-		t.tg.pidns.owner.mu.RUnlock()
-		return syserror.ESRCH
-	}
-	if !target.ptraceFreeze() {
-		t.tg.pidns.owner.mu.RUnlock()
-		// "Most ptrace commands (all except PTRACE_ATTACH, PTRACE_SEIZE,
-		// PTRACE_TRACEME, PTRACE_INTERRUPT, and PTRACE_KILL) require the
-		// tracee to be in a ptrace-stop, otherwise they fail with ESRCH." -
-		// ptrace(2)
-		return syserror.ESRCH
+	if err := t.ptraceFreezeTracee(target); err != nil {
+		return err
 	}
-	t.tg.pidns.owner.mu.RUnlock()
-	// Even if the target has a ptrace-stop active, the tracee's task goroutine
-	// may not yet have reached Task.doStop; wait for it to do so. This is safe
-	// because there's no way for target to initiate a ptrace-stop and then
-	// block (by calling Task.block) before entering it.
-	//
-	// Caveat: If tasks were just restored, the tracee's first call to
-	// Task.Activate (in Task.run) occurs before its first call to Task.doStop,
-	// which may block if the tracer's address space is active.
-	t.UninterruptibleSleepStart(true)
-	target.waitGoroutineStoppedOrExited()
-	t.UninterruptibleSleepFinish(true)
 
 	// Resuming commands end the ptrace stop, but only if successful.
 	// PTRACE_LISTEN ends the ptrace stop if trapNotifyPending is already set on the
@@ -1117,3 +1141,75 @@ func (t *Task) Ptrace(req int64, pid ThreadID, addr, data usermem.Addr) error {
 		return t.ptraceArch(target, req, addr, data)
 	}
 }
+
+// PtraceGetSyscallInfo implements ptrace(PTRACE_GET_SYSCALL_INFO, pid, size,
+// data). It copies up to size bytes of a struct ptrace_syscall_info describing
+// the tracee's current stop to data, and returns the number of bytes of the
+// struct that are meaningful.
+func (t *Task) PtraceGetSyscallInfo(pid ThreadID, size uint64, data usermem.Addr) (uintptr, error) {
+	target := t.tg.pidns.TaskWithID(pid)
+	if target == nil {
+		return 0, syserror.ESRCH
+	}
+	if err := t.ptraceFreezeTracee(target); err != nil {
+		return 0, err
+	}
+	defer target.ptraceUnfreeze()
+
+	t.tg.pidns.owner.mu.RLock()
+	var code int32
+	if target.ptraceSiginfo != nil {
+		code = target.ptraceSiginfo.Code
+	}
+	msg := target.ptraceEventMsg
+	t.tg.pidns.owner.mu.RUnlock()
+
+	// The target's task goroutine is stopped, so reading its registers is
+	// safe.
+	ac := target.Arch()
+	info := linux.PtraceSyscallInfo{
+		Op:                 linux.PTRACE_SYSCALL_INFO_NONE,
+		Arch:               target.SyscallTable().AuditNumber,
+		InstructionPointer: uint64(ac.IP()),
+		StackPointer:       uint64(ac.Stack()),
+	}
+	n := uint64(linux.SizeOfPtraceSyscallInfoNone)
+	// As in Linux, syscall stops are only distinguishable from other
+	// SIGTRAPs with PTRACE_O_TRACESYSGOOD.
+	switch {
+	case code == int32(linux.SIGTRAP)|0x80 && msg == linux.PTRACE_EVENTMSG_SYSCALL_ENTRY:
+		info.Op = linux.PTRACE_SYSCALL_INFO_ENTRY
+		info.Data[0] = uint64(ac.SyscallNo())
+		for i, arg := range ac.SyscallArgs() {
+			info.Data[1+i] = uint64(arg.Value)
+		}
+		n = linux.SizeOfPtraceSyscallInfoEntry
+	case code == int32(linux.SIGTRAP)|0x80 && msg == linux.PTRACE_EVENTMSG_SYSCALL_EXIT:
+		info.Op = linux.PTRACE_SYSCALL_INFO_EXIT
+		rval := int64(ac.Return())
+		info.Data[0] = uint64(rval)
+		// Compare Linux's IS_ERR_VALUE(), with MAX_ERRNO = 4095.
+		if rval < 0 && rval >= -4095 {
+			info.Data[1] = 1
+		}
+		n = linux.SizeOfPtraceSyscallInfoExit
+	case code == int32(linux.SIGTRAP)|(linux.PTRACE_EVENT_SECCOMP<<8):
+		info.Op = linux.PTRACE_SYSCALL_INFO_SECCOMP
+		info.Data[0] = uint64(ac.SyscallNo())
+		for i, arg := range ac.SyscallArgs() {
+			info.Data[1+i] = uint64(arg.Value)
+		}
+		info.Data[7] = uint64(uint32(msg))
+		n = linux.SizeOfPtraceSyscallInfoSeccomp
+	}
+
+	buf := make([]byte, info.SizeBytes())
+	info.MarshalBytes(buf)
+	if size > n {
+		size = n
+	}
+	if _, err := t.CopyOutBytes(data, buf[:size]); err != nil {
+		return 0, err
+	}
+	return uintptr(n), nil
+}
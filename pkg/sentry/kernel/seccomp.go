@@ -27,6 +27,15 @@ import (
 
 const maxSyscallFilterInstructions = 1 << 15
 
+// seccompStaticSyscalls is the number of syscall numbers, starting from 0, for
+// which the results of seccomp-bpf filters are precomputed. This covers every
+// syscall number that is currently defined on amd64 and arm64.
+const seccompStaticSyscalls = 512
+
+// seccompStaticDataLen is the length of the prefix of seccompData (nr and arch)
+// that is known when the results of seccomp-bpf filters are precomputed.
+const seccompStaticDataLen = 8
+
 // seccompData is equivalent to struct seccomp_data, which contains the data
 // passed to seccomp-bpf filters.
 type seccompData struct {
@@ -48,6 +57,159 @@ func (d *seccompData) asBPFInput() bpf.Input {
 	return bpf.InputBytes{binary.Marshal(nil, usermem.ByteOrder, d), usermem.ByteOrder}
 }
 
+// seccompStaticInput implements bpf.Input for a seccompData whose nr and arch
+// are known, and records whether a filter loads any other part of it.
+type seccompStaticInput struct {
+	bpf.InputBytes
+
+	// dynamic is true if the filter has loaded data beyond
+	// seccompStaticDataLen.
+	dynamic bool
+}
+
+func (i *seccompStaticInput) check(off, size uint32) {
+	if uint64(off)+uint64(size) > seccompStaticDataLen {
+		i.dynamic = true
+	}
+}
+
+// Load32 implements bpf.Input.Load32.
+func (i *seccompStaticInput) Load32(off uint32) (uint32, bool) {
+	i.check(off, 4)
+	return i.InputBytes.Load32(off)
+}
+
+// Load16 implements bpf.Input.Load16.
+func (i *seccompStaticInput) Load16(off uint32) (uint16, bool) {
+	i.check(off, 2)
+	return i.InputBytes.Load16(off)
+}
+
+// Load8 implements bpf.Input.Load8.
+func (i *seccompStaticInput) Load8(off uint32) (uint8, bool) {
+	i.check(off, 1)
+	return i.InputBytes.Load8(off)
+}
+
+// seccompStaticResult is the precomputed result of a task's seccomp-bpf
+// filters for a syscall number.
+type seccompStaticResult struct {
+	// ret is the combined return value of all filters. ret is only valid if
+	// ok is true.
+	ret uint32
+
+	// ok is true if no filter's result for the syscall number depends on
+	// anything but the syscall number and architecture.
+	ok bool
+}
+
+// syscallFilters is all seccomp-bpf syscall filters applicable to a task,
+// along with their precomputed results.
+//
+// Most filters (e.g. those generated by libseccomp, Chrome and container
+// runtimes) select an action for most syscalls based only on the syscall
+// number and architecture, so these results are computed once when each
+// filter is installed, by running it on every syscall number in
+// [0, seccompStaticSyscalls). Syscalls for which any filter inspects their
+// arguments or instruction pointer are still interpreted on every call.
+//
+// syscallFilters is immutable, and may be shared between tasks.
+type syscallFilters struct {
+	// programs is all filters, in the order in which they were installed.
+	programs []bpf.Program
+
+	// auditNumber is the AUDIT_ARCH_* value for which static was computed.
+	auditNumber uint32
+
+	// static contains the results of programs for each syscall number in
+	// [0, seccompStaticSyscalls) on auditNumber.
+	static []seccompStaticResult
+}
+
+// seccompPrecedence returns whichever of seccomp-bpf return values a and b
+// takes precedence, preferring a if their actions are the same.
+//
+// "If multiple filters exist, the return value for the evaluation of a given
+// system call will always use the highest precedent value." -
+// Documentation/prctl/seccomp_filter.txt
+//
+// (Note that this contradicts prctl(2): "If the filters permit prctl() calls,
+// then additional filters can be added; they are run in order until the first
+// non-allow result is seen." prctl(2) is incorrect.)
+//
+// "The ordering ensures that a min_t() over composed return values always
+// selects the least permissive choice." - include/uapi/linux/seccomp.h
+func seccompPrecedence(a, b uint32) uint32 {
+	if (b & linux.SECCOMP_RET_ACTION) < (a & linux.SECCOMP_RET_ACTION) {
+		return b
+	}
+	return a
+}
+
+// appendFilter returns a syscallFilters containing the filters in f, which may
+// be nil, followed by p, with results precomputed for auditNumber.
+func (f *syscallFilters) appendFilter(p bpf.Program, auditNumber uint32) *syscallFilters {
+	nf := &syscallFilters{
+		auditNumber: auditNumber,
+		static:      make([]seccompStaticResult, seccompStaticSyscalls),
+	}
+	if f != nil {
+		nf.programs = append(nf.programs, f.programs...)
+	}
+	nf.programs = append(nf.programs, p)
+
+	// If f's results were computed for a different architecture, they must
+	// be recomputed for all filters.
+	first := len(nf.programs) - 1
+	if f != nil && f.auditNumber != auditNumber {
+		first = 0
+	}
+	for i := range nf.static {
+		nf.static[i].ret = uint32(linux.SECCOMP_RET_ALLOW)
+		nf.static[i].ok = true
+		if first != 0 {
+			nf.static[i] = f.static[i]
+		}
+	}
+
+	data := seccompData{arch: auditNumber}
+	in := seccompStaticInput{InputBytes: data.asBPFInput().(bpf.InputBytes)}
+	// Filters are evaluated in reverse order, as in evaluateSyscallFilters,
+	// so each new filter's results are composed before those of older
+	// filters.
+	for sysno := range nf.static {
+		usermem.ByteOrder.PutUint32(in.Data, uint32(sysno))
+		r := &nf.static[sysno]
+		ret := uint32(linux.SECCOMP_RET_ALLOW)
+		for i := len(nf.programs) - 1; i >= first && r.ok; i-- {
+			in.dynamic = false
+			thisRet, err := bpf.Exec(nf.programs[i], &in)
+			if in.dynamic {
+				r.ok = false
+				break
+			}
+			if err != nil {
+				thisRet = uint32(linux.SECCOMP_RET_KILL_THREAD)
+			}
+			ret = seccompPrecedence(ret, thisRet)
+		}
+		if r.ok {
+			r.ret = seccompPrecedence(ret, r.ret)
+		}
+	}
+	return nf
+}
+
+// lookup returns the precomputed result of f for syscall sysno on auditNumber,
+// if there is one.
+func (f *syscallFilters) lookup(sysno int32, auditNumber uint32) (uint32, bool) {
+	if auditNumber != f.auditNumber || sysno < 0 || int(sysno) >= len(f.static) {
+		return 0, false
+	}
+	r := f.static[sysno]
+	return r.ret, r.ok
+}
+
 func seccompSiginfo(t *Task, errno, sysno int32, ip usermem.Addr) *arch.SignalInfo {
 	si := &arch.SignalInfo{
 		Signo: int32(linux.SIGSYS),
@@ -112,6 +274,16 @@ func (t *Task) checkSeccompSyscall(sysno int32, args arch.SyscallArguments, ip u
 }
 
 func (t *Task) evaluateSyscallFilters(sysno int32, args arch.SyscallArguments, ip usermem.Addr) uint32 {
+	ret := uint32(linux.SECCOMP_RET_ALLOW)
+	sf := t.syscallFilters.Load()
+	if sf == nil {
+		return ret
+	}
+	f := sf.(*syscallFilters)
+	if r, ok := f.lookup(sysno, t.tc.st.AuditNumber); ok {
+		return r
+	}
+
 	data := seccompData{
 		nr:                 sysno,
 		arch:               t.tc.st.AuditNumber,
@@ -127,34 +299,15 @@ func (t *Task) evaluateSyscallFilters(sysno int32, args arch.SyscallArguments, i
 	}
 	input := data.asBPFInput()
 
-	ret := uint32(linux.SECCOMP_RET_ALLOW)
-	f := t.syscallFilters.Load()
-	if f == nil {
-		return ret
-	}
-
 	// "Every filter successfully installed will be evaluated (in reverse
 	// order) for each system call the task makes." - kernel/seccomp.c
-	for i := len(f.([]bpf.Program)) - 1; i >= 0; i-- {
-		thisRet, err := bpf.Exec(f.([]bpf.Program)[i], input)
+	for i := len(f.programs) - 1; i >= 0; i-- {
+		thisRet, err := bpf.Exec(f.programs[i], input)
 		if err != nil {
 			t.Debugf("seccomp-bpf filter %d returned error: %v", i, err)
 			thisRet = uint32(linux.SECCOMP_RET_KILL_THREAD)
 		}
-		// "If multiple filters exist, the return value for the evaluation of a
-		// given system call will always use the highest precedent value." -
-		// Documentation/prctl/seccomp_filter.txt
-		//
-		// (Note that this contradicts prctl(2): "If the filters permit prctl()
-		// calls, then additional filters can be added; they are run in order
-		// until the first non-allow result is seen." prctl(2) is incorrect.)
-		//
-		// "The ordering ensures that a min_t() over composed return values
-		// always selects the least permissive choice." -
-		// include/uapi/linux/seccomp.h
-		if (thisRet & linux.SECCOMP_RET_ACTION) < (ret & linux.SECCOMP_RET_ACTION) {
-			ret = thisRet
-		}
+		ret = seccompPrecedence(ret, thisRet)
 	}
 
 	return ret
@@ -174,30 +327,27 @@ func (t *Task) AppendSyscallFilter(p bpf.Program, syncAll bool) error {
 	// instructions per filter beyond the first) to maxSyscallFilterInstructions.
 	// This restriction is inherited from Linux.
 	totalLength := p.Length()
-	var newFilters []bpf.Program
+	var oldFilters *syscallFilters
 
 	if sf := t.syscallFilters.Load(); sf != nil {
-		oldFilters := sf.([]bpf.Program)
-		for _, f := range oldFilters {
+		oldFilters = sf.(*syscallFilters)
+		for _, f := range oldFilters.programs {
 			totalLength += f.Length() + 4
 		}
-		newFilters = append(newFilters, oldFilters...)
 	}
 
 	if totalLength > maxSyscallFilterInstructions {
 		return syserror.ENOMEM
 	}
 
-	newFilters = append(newFilters, p)
+	newFilters := oldFilters.appendFilter(p, t.tc.st.AuditNumber)
 	t.syscallFilters.Store(newFilters)
 
 	if syncAll {
 		// Note: No new privs is always assumed to be set.
 		for ot := t.tg.tasks.Front(); ot != nil; ot = ot.Next() {
 			if ot != t {
-				var copiedFilters []bpf.Program
-				copiedFilters = append(copiedFilters, newFilters...)
-				ot.syscallFilters.Store(copiedFilters)
+				ot.syscallFilters.Store(newFilters)
 			}
 		}
 	}
@@ -210,7 +360,7 @@ func (t *Task) AppendSyscallFilter(p bpf.Program, syncAll bool) error {
 // and /proc/[pid]/status.
 func (t *Task) SeccompMode() int {
 	f := t.syscallFilters.Load()
-	if f != nil && len(f.([]bpf.Program)) > 0 {
+	if f != nil && len(f.(*syscallFilters).programs) > 0 {
 		return linux.SECCOMP_MODE_FILTER
 	}
 	return linux.SECCOMP_MODE_NONE
@@ -0,0 +1,113 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"testing"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/bpf"
+)
+
+const testAuditNumber = linux.AUDIT_ARCH_X86_64
+
+func mustCompile(t *testing.T, insns []linux.BPFInstruction) bpf.Program {
+	p, err := bpf.Compile(insns)
+	if err != nil {
+		t.Fatalf("bpf.Compile(%v) failed: %v", insns, err)
+	}
+	return p
+}
+
+// interpretSyscallFilters returns the result of programs for the given
+// seccompData, in the same way as Task.evaluateSyscallFilters.
+func interpretSyscallFilters(programs []bpf.Program, data seccompData) uint32 {
+	ret := uint32(linux.SECCOMP_RET_ALLOW)
+	for i := len(programs) - 1; i >= 0; i-- {
+		thisRet, err := bpf.Exec(programs[i], data.asBPFInput())
+		if err != nil {
+			thisRet = uint32(linux.SECCOMP_RET_KILL_THREAD)
+		}
+		ret = seccompPrecedence(ret, thisRet)
+	}
+	return ret
+}
+
+// TestSyscallFiltersStatic checks that precomputed results match
+// interpretation, and that syscalls whose results depend on their arguments
+// are not precomputed.
+func TestSyscallFiltersStatic(t *testing.T) {
+	const argSyscall = 3
+	programs := []bpf.Program{
+		// Kill on the wrong architecture, fail syscall 1 with EPERM, and
+		// allow everything else.
+		mustCompile(t, []linux.BPFInstruction{
+			bpf.Stmt(bpf.Ld|bpf.Abs|bpf.W, 4),
+			bpf.Jump(bpf.Jmp|bpf.Jeq|bpf.K, testAuditNumber, 1, 0),
+			bpf.Stmt(bpf.Ret|bpf.K, uint32(linux.SECCOMP_RET_KILL_THREAD)),
+			bpf.Stmt(bpf.Ld|bpf.Abs|bpf.W, 0),
+			bpf.Jump(bpf.Jmp|bpf.Jeq|bpf.K, 1, 0, 1),
+			bpf.Stmt(bpf.Ret|bpf.K, uint32(linux.SECCOMP_RET_ERRNO)|1),
+			bpf.Stmt(bpf.Ret|bpf.K, uint32(linux.SECCOMP_RET_ALLOW)),
+		}),
+		// Trap syscalls >= 100, and fail argSyscall with EINVAL if its
+		// first argument is 0.
+		mustCompile(t, []linux.BPFInstruction{
+			bpf.Stmt(bpf.Ld|bpf.Abs|bpf.W, 0),
+			bpf.Jump(bpf.Jmp|bpf.Jge|bpf.K, 100, 0, 1),
+			bpf.Stmt(bpf.Ret|bpf.K, uint32(linux.SECCOMP_RET_TRAP)),
+			bpf.Jump(bpf.Jmp|bpf.Jeq|bpf.K, argSyscall, 0, 3),
+			bpf.Stmt(bpf.Ld|bpf.Abs|bpf.W, 16),
+			bpf.Jump(bpf.Jmp|bpf.Jeq|bpf.K, 0, 0, 1),
+			bpf.Stmt(bpf.Ret|bpf.K, uint32(linux.SECCOMP_RET_ERRNO)|22),
+			bpf.Stmt(bpf.Ret|bpf.K, uint32(linux.SECCOMP_RET_ALLOW)),
+		}),
+	}
+
+	var f *syscallFilters
+	for _, p := range programs {
+		f = f.appendFilter(p, testAuditNumber)
+	}
+	if len(f.programs) != len(programs) {
+		t.Fatalf("got %d programs, want %d", len(f.programs), len(programs))
+	}
+
+	for sysno := int32(-1); sysno <= seccompStaticSyscalls; sysno++ {
+		ret, ok := f.lookup(sysno, testAuditNumber)
+		wantOK := sysno >= 0 && sysno < seccompStaticSyscalls && sysno != argSyscall
+		if ok != wantOK {
+			t.Errorf("syscall %d: got precomputed %t, want %t", sysno, ok, wantOK)
+			continue
+		}
+		if !ok {
+			continue
+		}
+		if want := interpretSyscallFilters(programs, seccompData{nr: sysno, arch: testAuditNumber}); ret != want {
+			t.Errorf("syscall %d: got precomputed result %#x, want %#x", sysno, ret, want)
+		}
+	}
+
+	if _, ok := f.lookup(1, linux.AUDIT_ARCH_AARCH64); ok {
+		t.Errorf("got precomputed result for a different architecture")
+	}
+
+	// Recomputing for a different architecture must apply to all filters.
+	g := f.appendFilter(mustCompile(t, []linux.BPFInstruction{
+		bpf.Stmt(bpf.Ret|bpf.K, uint32(linux.SECCOMP_RET_ALLOW)),
+	}), linux.AUDIT_ARCH_AARCH64)
+	if ret, ok := g.lookup(1, linux.AUDIT_ARCH_AARCH64); !ok || ret != uint32(linux.SECCOMP_RET_KILL_THREAD) {
+		t.Errorf("got result (%#x, %t) on wrong architecture, want (%#x, true)", ret, ok, uint32(linux.SECCOMP_RET_KILL_THREAD))
+	}
+}
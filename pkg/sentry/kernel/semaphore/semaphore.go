@@ -104,7 +104,13 @@ type waiter struct {
 
 	// value represents how much resource the waiter needs to wake up.
 	value int16
-	ch    chan struct{}
+
+	// offset is the net change that the waiter's earlier operations in the
+	// same call make to the semaphore. The waiter can make progress once the
+	// semaphore's value plus offset satisfies value.
+	offset int16
+
+	ch chan struct{}
 }
 
 // NewRegistry creates a new semaphore set registry.
@@ -433,23 +439,23 @@ func (s *Set) ExecuteOps(ctx context.Context, ops []linux.Sembuf, creds *auth.Cr
 }
 
 func (s *Set) executeOps(ctx context.Context, ops []linux.Sembuf, pid int32) (chan struct{}, int32, error) {
-	// Changes to semaphores go to this slice temporarily until they all succeed.
-	tmpVals := make([]int16, len(s.sems))
-	for i := range s.sems {
-		tmpVals[i] = s.sems[i].value
-	}
+	// Changes to semaphores go to this slice temporarily until they all
+	// succeed. Only the semaphores that ops refer to are tracked, so that the
+	// cost of an operation doesn't grow with the size of the set.
+	tmpVals := make([]semVal, 0, len(ops))
 
 	for _, op := range ops {
 		sem := &s.sems[op.SemNum]
+		tmpVal := findOrAddSemVal(&tmpVals, op.SemNum, sem.value)
 		if op.SemOp == 0 {
 			// Handle 'wait for zero' operation.
-			if tmpVals[op.SemNum] != 0 {
+			if *tmpVal != 0 {
 				// Semaphore isn't 0, must wait.
 				if op.SemFlg&linux.IPC_NOWAIT != 0 {
 					return nil, 0, syserror.ErrWouldBlock
 				}
 
-				w := newWaiter(op.SemOp)
+				w := newWaiter(op.SemOp, *tmpVal-sem.value)
 				sem.waiters.PushBack(w)
 				return w.ch, int32(op.SemNum), nil
 			}
@@ -459,38 +465,64 @@ func (s *Set) executeOps(ctx context.Context, ops []linux.Sembuf, pid int32) (ch
 				if -op.SemOp > valueMax {
 					return nil, 0, syserror.ERANGE
 				}
-				if -op.SemOp > tmpVals[op.SemNum] {
+				if -op.SemOp > *tmpVal {
 					// Not enough resources, must wait.
 					if op.SemFlg&linux.IPC_NOWAIT != 0 {
 						return nil, 0, syserror.ErrWouldBlock
 					}
 
-					w := newWaiter(op.SemOp)
+					w := newWaiter(op.SemOp, *tmpVal-sem.value)
 					sem.waiters.PushBack(w)
 					return w.ch, int32(op.SemNum), nil
 				}
 			} else {
 				// op.SemOp > 0: Handle 'signal' operation.
-				if tmpVals[op.SemNum] > valueMax-op.SemOp {
+				if *tmpVal > valueMax-op.SemOp {
 					return nil, 0, syserror.ERANGE
 				}
 			}
 
-			tmpVals[op.SemNum] += op.SemOp
+			*tmpVal += op.SemOp
 		}
 	}
 
-	// All operations succeeded, apply them.
+	// All operations succeeded, apply them. Only waiters on semaphores whose
+	// values changed need to be looked at.
 	// TODO(gvisor.dev/issue/137): handle undo operations.
-	for i, v := range tmpVals {
-		s.sems[i].value = v
-		s.sems[i].wakeWaiters()
-		s.sems[i].pid = pid
+	for _, v := range tmpVals {
+		sem := &s.sems[v.num]
+		changed := sem.value != v.value
+		sem.value = v.value
+		sem.pid = pid
+		if changed {
+			sem.wakeWaiters()
+		}
 	}
 	s.opTime = ktime.NowFromContext(ctx)
 	return nil, 0, nil
 }
 
+// semVal is the pending value of a semaphore in executeOps.
+type semVal struct {
+	num   uint16
+	value int16
+}
+
+// findOrAddSemVal returns the pending value of semaphore num in vals, adding
+// it with the given initial value if it isn't there yet.
+//
+// Most operations refer to a handful of semaphores, so a linear search is
+// cheaper than a map.
+func findOrAddSemVal(vals *[]semVal, num uint16, value int16) *int16 {
+	for i := range *vals {
+		if (*vals)[i].num == num {
+			return &(*vals)[i].value
+		}
+	}
+	*vals = append(*vals, semVal{num: num, value: value})
+	return &(*vals)[len(*vals)-1].value
+}
+
 // AbortWait notifies that a waiter is giving up and will not wait on the
 // channel anymore.
 func (s *Set) AbortWait(num int32, ch chan struct{}) {
@@ -548,11 +580,12 @@ func (s *Set) destroy() {
 	}
 }
 
-// wakeWaiters goes over all waiters and checks which of them can be notified.
+// wakeWaiters goes over all waiters and notifies the ones whose operation can
+// now make progress. The rest are left alone, so that waiters are not woken
+// up just to find that they must block again.
 func (s *sem) wakeWaiters() {
-	// Note that this will release all waiters waiting for 0 too.
 	for w := s.waiters.Front(); w != nil; {
-		if s.value < w.value {
+		if !w.ready(s.value) {
 			// Still blocked, skip it.
 			w = w.Next()
 			continue
@@ -564,9 +597,21 @@ func (s *sem) wakeWaiters() {
 	}
 }
 
-func newWaiter(val int16) *waiter {
+// ready returns true if the waiter's operation can make progress when the
+// semaphore's value is val.
+func (w *waiter) ready(val int16) bool {
+	v := int32(val) + int32(w.offset)
+	if w.value == 0 {
+		// Waiting for zero.
+		return v == 0
+	}
+	return v >= -int32(w.value)
+}
+
+func newWaiter(val, offset int16) *waiter {
 	return &waiter{
-		value: val,
-		ch:    make(chan struct{}, 1),
+		value:  val,
+		offset: offset,
+		ch:     make(chan struct{}, 1),
 	}
 }
@@ -113,6 +113,49 @@ func TestWaitForZero(t *testing.T) {
 	}
 }
 
+func TestTargetedWakeup(t *testing.T) {
+	ctx := contexttest.Context(t)
+	set := &Set{ID: 123, sems: make([]sem, 3)}
+	executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 1, SemOp: 1}}, false)
+
+	// Wait for 2 on semaphore 0, for zero on semaphore 1, and for 1 on
+	// semaphore 2 after adding 1 to it in the same call.
+	chDec := executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 0, SemOp: -2}}, true)
+	chZero := executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 1, SemOp: 0}}, true)
+	chOffset := executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 2, SemOp: 1}, {SemNum: 2, SemOp: -2}}, true)
+
+	// Not enough for the decrement yet.
+	executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 0, SemOp: 1}}, false)
+	if signalled(chDec) {
+		t.Fatalf("decrement waiter woken up with too small a value, set: %+v", set)
+	}
+
+	executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 0, SemOp: 1}}, false)
+	if !signalled(chDec) {
+		t.Fatalf("decrement waiter should have been woken up, set: %+v", set)
+	}
+	if signalled(chZero) || signalled(chOffset) {
+		t.Fatalf("waiters on other semaphores should not have been woken up, set: %+v", set)
+	}
+
+	// Changing semaphore 1 to another non-zero value doesn't help the zero
+	// waiter.
+	executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 1, SemOp: 1}}, false)
+	if signalled(chZero) {
+		t.Fatalf("zero waiter woken up with a non-zero value, set: %+v", set)
+	}
+	executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 1, SemOp: -2}}, false)
+	if !signalled(chZero) {
+		t.Fatalf("zero waiter should have been woken up, set: %+v", set)
+	}
+
+	// The waiter's own increment counts towards its decrement.
+	executeOps(ctx, t, set, []linux.Sembuf{{SemNum: 2, SemOp: 1}}, false)
+	if !signalled(chOffset) {
+		t.Fatalf("waiter should have been woken up, set: %+v", set)
+	}
+}
+
 func TestNoWait(t *testing.T) {
 	ctx := contexttest.Context(t)
 	set := &Set{ID: 123, sems: make([]sem, 1)}
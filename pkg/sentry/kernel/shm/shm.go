@@ -19,9 +19,9 @@
 // - SHM_LOCK/SHM_UNLOCK are no-ops. The sentry currently doesn't implement
 //   memory locking in general.
 //
-// - SHM_HUGETLB and related flags for shmget(2) are ignored. There's no easy
-//   way to implement hugetlb support on a per-map basis, and it has no impact
-//   on correctness.
+// - SHM_HUGETLB for shmget(2) only rounds the segment up to huge pages and
+//   allocates it on a huge page boundary, so that the host may back it with
+//   huge pages. Only the default huge page size is supported.
 //
 // - SHM_NORESERVE for shmget(2) is ignored, the sentry doesn't implement swap
 //   so it's meaningless to reserve space for swap.
@@ -137,10 +137,11 @@ func (r *Registry) dissociateKey(s *Shm) {
 }
 
 // FindOrCreate looks up or creates a segment in the registry. It's functionally
-// analogous to open(2).
+// analogous to open(2). If hugetlb is true, a new segment is allocated in huge
+// pages.
 //
 // FindOrCreate returns a reference on Shm.
-func (r *Registry) FindOrCreate(ctx context.Context, pid int32, key Key, size uint64, mode linux.FileMode, private, create, exclusive bool) (*Shm, error) {
+func (r *Registry) FindOrCreate(ctx context.Context, pid int32, key Key, size uint64, mode linux.FileMode, private, create, exclusive, hugetlb bool) (*Shm, error) {
 	if (create || private) && (size < linux.SHMMIN || size > linux.SHMMAX) {
 		// "A new segment was to be created and size is less than SHMMIN or
 		// greater than SHMMAX." - man shmget(2)
@@ -198,10 +199,8 @@ func (r *Registry) FindOrCreate(ctx context.Context, pid int32, key Key, size ui
 		}
 	}
 
-	var sizeAligned uint64
-	if val, ok := usermem.Addr(size).RoundUp(); ok {
-		sizeAligned = uint64(val)
-	} else {
+	sizeAligned, ok := roundSegmentSize(size, hugetlb)
+	if !ok {
 		return nil, syserror.EINVAL
 	}
 
@@ -215,7 +214,7 @@ func (r *Registry) FindOrCreate(ctx context.Context, pid int32, key Key, size ui
 	// Need to create a new segment.
 	creator := fs.FileOwnerFromContext(ctx)
 	perms := fs.FilePermsFromMode(mode)
-	s, err := r.newShm(ctx, pid, key, creator, perms, size)
+	s, err := r.newShm(ctx, pid, key, creator, perms, size, sizeAligned)
 	if err != nil {
 		return nil, err
 	}
@@ -225,16 +224,29 @@ func (r *Registry) FindOrCreate(ctx context.Context, pid int32, key Key, size ui
 	return s, nil
 }
 
+// roundSegmentSize returns the size of a segment of the given size, rounded up
+// to a page or a huge page boundary. ok is false if rounding up overflows.
+func roundSegmentSize(size uint64, hugetlb bool) (uint64, bool) {
+	if hugetlb {
+		// MemoryFile.Allocate aligns allocations of whole huge pages on
+		// huge page boundaries.
+		val, ok := usermem.Addr(size).HugeRoundUp()
+		return uint64(val), ok
+	}
+	val, ok := usermem.Addr(size).RoundUp()
+	return uint64(val), ok
+}
+
 // newShm creates a new segment in the registry.
 //
-// Precondition: Caller must hold r.mu.
-func (r *Registry) newShm(ctx context.Context, pid int32, key Key, creator fs.FileOwner, perms fs.FilePermissions, size uint64) (*Shm, error) {
+// Precondition: Caller must hold r.mu. effectiveSize must be a multiple of
+// usermem.PageSize.
+func (r *Registry) newShm(ctx context.Context, pid int32, key Key, creator fs.FileOwner, perms fs.FilePermissions, size, effectiveSize uint64) (*Shm, error) {
 	mfp := pgalloc.MemoryFileProviderFromContext(ctx)
 	if mfp == nil {
 		panic(fmt.Sprintf("context.Context %T lacks non-nil value for key %T", ctx, pgalloc.CtxMemoryFileProvider))
 	}
 
-	effectiveSize := uint64(usermem.Addr(size).MustRoundUp())
 	fr, err := mfp.MemoryFile().Allocate(effectiveSize, usage.Anonymous)
 	if err != nil {
 		return nil, err
@@ -363,7 +375,7 @@ type Shm struct {
 	size uint64
 
 	// effectiveSize of the segment, rounding up to the next page
-	// boundary. Immutable.
+	// boundary, or huge page boundary for SHM_HUGETLB segments. Immutable.
 	//
 	// Invariant: effectiveSize must be a multiple of usermem.PageSize.
 	effectiveSize uint64
@@ -0,0 +1,170 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"sort"
+	"sync/atomic"
+	"time"
+
+	"gvisor.dev/gvisor/pkg/sync"
+)
+
+const (
+	// syscallStatsChunkShift is log2 of the number of consecutive syscall
+	// numbers whose statistics are allocated together.
+	syscallStatsChunkShift = 6
+
+	// syscallStatsChunkSize is the number of consecutive syscall numbers
+	// whose statistics are allocated together.
+	syscallStatsChunkSize = 1 << syscallStatsChunkShift
+
+	// syscallStatsChunks is the number of chunks of syscall statistics per
+	// task. Statistics are not kept for syscall numbers of
+	// syscallStatsChunks*syscallStatsChunkSize or more.
+	syscallStatsChunks = 16
+)
+
+// SyscallStat holds statistics for a syscall number.
+type SyscallStat struct {
+	// Sysno is the syscall number.
+	Sysno uintptr
+
+	// Count is the number of times the syscall has been executed.
+	Count uint64
+
+	// SentryTime is the total time spent executing the syscall in the
+	// sentry, excluding time spent blocked or stopped. SentryTime is only
+	// measured if InitKernelArgs.SyscallTiming is true, and is 0 otherwise.
+	SentryTime time.Duration
+}
+
+// syscallStatsChunk holds statistics for syscallStatsChunkSize consecutive
+// syscall numbers.
+//
+// Fields are only mutated by the task goroutine, and are accessed by other
+// goroutines using atomic memory operations.
+type syscallStatsChunk struct {
+	counts [syscallStatsChunkSize]uint64
+	nanos  [syscallStatsChunkSize]uint64
+}
+
+// taskSyscallStats holds a task's per-syscall statistics. Statistics are
+// allocated in chunks as syscalls are first used, since most tasks use few
+// distinct syscalls.
+type taskSyscallStats struct {
+	// mu serializes the allocation of chunks with readers on other
+	// goroutines.
+	mu sync.Mutex
+
+	// chunks[i] holds statistics for syscall numbers starting at
+	// i*syscallStatsChunkSize, or is nil if none of them have been executed.
+	//
+	// chunks is mutated only by the task goroutine, with mu locked.
+	chunks [syscallStatsChunks]*syscallStatsChunk
+}
+
+// syscallStatsEpoch is the time from which syscall timing is measured.
+var syscallStatsEpoch = time.Now()
+
+// syscallStatsNow returns the current time in nanoseconds since
+// syscallStatsEpoch, as measured by the host's monotonic clock.
+func syscallStatsNow() int64 {
+	return int64(time.Since(syscallStatsEpoch))
+}
+
+// record adds an execution of syscall sysno, which took the given number of
+// nanoseconds in the sentry, to s.
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (s *taskSyscallStats) record(sysno uintptr, nanos int64) {
+	i := sysno >> syscallStatsChunkShift
+	if i >= syscallStatsChunks {
+		return
+	}
+	c := s.chunks[i]
+	if c == nil {
+		c = &syscallStatsChunk{}
+		s.mu.Lock()
+		s.chunks[i] = c
+		s.mu.Unlock()
+	}
+	j := sysno % syscallStatsChunkSize
+	// Only the task goroutine mutates c, so atomic read-modify-write
+	// operations are not required.
+	atomic.StoreUint64(&c.counts[j], c.counts[j]+1)
+	if nanos > 0 {
+		atomic.StoreUint64(&c.nanos[j], c.nanos[j]+uint64(nanos))
+	}
+}
+
+// accumulate adds the statistics in s to stats, which is indexed by syscall
+// number.
+func (s *taskSyscallStats) accumulate(stats map[uintptr]*SyscallStat) {
+	s.mu.Lock()
+	chunks := s.chunks
+	s.mu.Unlock()
+	for i, c := range chunks {
+		if c == nil {
+			continue
+		}
+		for j := range c.counts {
+			count := atomic.LoadUint64(&c.counts[j])
+			if count == 0 {
+				continue
+			}
+			sysno := uintptr(i<<syscallStatsChunkShift + j)
+			stat := stats[sysno]
+			if stat == nil {
+				stat = &SyscallStat{Sysno: sysno}
+				stats[sysno] = stat
+			}
+			stat.Count += count
+			stat.SentryTime += time.Duration(atomic.LoadUint64(&c.nanos[j]))
+		}
+	}
+}
+
+// sortedSyscallStats returns the statistics in stats, in increasing order of
+// syscall number.
+func sortedSyscallStats(stats map[uintptr]*SyscallStat) []SyscallStat {
+	sorted := make([]SyscallStat, 0, len(stats))
+	for _, stat := range stats {
+		sorted = append(sorted, *stat)
+	}
+	sort.Slice(sorted, func(i, j int) bool { return sorted[i].Sysno < sorted[j].Sysno })
+	return sorted
+}
+
+// SyscallStats returns statistics for each syscall that t has executed, in
+// increasing order of syscall number. Statistics are not preserved across
+// save/restore.
+func (t *Task) SyscallStats() []SyscallStat {
+	stats := make(map[uintptr]*SyscallStat)
+	t.syscallStats.accumulate(stats)
+	return sortedSyscallStats(stats)
+}
+
+// SyscallStats returns statistics for each syscall that the live tasks in tg
+// have executed, in increasing order of syscall number.
+func (tg *ThreadGroup) SyscallStats() []SyscallStat {
+	stats := make(map[uintptr]*SyscallStat)
+	tg.pidns.owner.mu.RLock()
+	defer tg.pidns.owner.mu.RUnlock()
+	for t := tg.tasks.Front(); t != nil; t = t.Next() {
+		t.syscallStats.accumulate(stats)
+	}
+	return sortedSyscallStats(stats)
+}
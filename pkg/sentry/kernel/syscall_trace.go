@@ -0,0 +1,72 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"sync/atomic"
+
+	"gvisor.dev/gvisor/pkg/sentry/kernel/syscalltrace"
+)
+
+// StartSyscallTrace returns the kernel's syscall trace buffer, creating it if
+// necessary, and starts recording syscalls in it. Syscalls are recorded until
+// each call to StartSyscallTrace is balanced by a call to StopSyscallTrace.
+func (k *Kernel) StartSyscallTrace() (*syscalltrace.Buffer, error) {
+	k.syscallTraceMu.Lock()
+	defer k.syscallTraceMu.Unlock()
+	if k.syscallTrace == nil {
+		b, err := syscalltrace.New(k, k.applicationCores)
+		if err != nil {
+			return nil, err
+		}
+		k.syscallTrace = b
+	}
+	atomic.AddInt32(&k.syscallTraceUsers, 1)
+	return k.syscallTrace, nil
+}
+
+// StopSyscallTrace balances a previous successful call to StartSyscallTrace.
+func (k *Kernel) StopSyscallTrace() {
+	if atomic.AddInt32(&k.syscallTraceUsers, -1) < 0 {
+		panic("StopSyscallTrace called without StartSyscallTrace")
+	}
+}
+
+// syscallTracing returns true if syscalls should be recorded in
+// t.k.syscallTrace.
+func (t *Task) syscallTracing() bool {
+	return atomic.LoadInt32(&t.k.syscallTraceUsers) != 0
+}
+
+// recordSyscallTrace records a syscall that began at start, in nanoseconds on
+// the application monotonic clock, in t.k.syscallTrace.
+//
+// Preconditions: The caller must be running on the task goroutine.
+// t.syscallTracing() must have returned true.
+func (t *Task) recordSyscallTrace(sysno uintptr, start int64, rval uintptr, ctrl *SyscallControl, err error) {
+	e := syscalltrace.Event{
+		Start:    start,
+		Duration: t.k.MonotonicClock().Now().Nanoseconds() - start,
+		Rval:     int64(rval),
+		Sysno:    uint32(sysno),
+		TID:      int32(t.rootTID),
+	}
+	// As in Task.doSyscallInvoke, err is ignored if ctrl is not nil.
+	if ctrl == nil && err != nil {
+		e.Rval = 0
+		e.Errno = int32(ExtractErrno(err, int(sysno)))
+	}
+	t.k.syscallTrace.Record(t.CPU(), &e)
+}
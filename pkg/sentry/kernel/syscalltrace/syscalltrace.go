@@ -0,0 +1,297 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package syscalltrace implements a buffer of syscall events that is written
+// by the sentry without locks and that may be mapped read-only by
+// applications.
+//
+// The buffer consists of a header page followed by one ring of events per
+// CPU. All fields are little-endian. The header contains the following
+// uint32s, in order:
+//
+//	magic            Magic
+//	version          Version
+//	rings            number of rings
+//	entries_per_ring number of entries in each ring, a power of 2
+//	entry_size       EntrySize
+//	header_size      HeaderSize; ring i starts at
+//	                 header_size + i*entries_per_ring*entry_size
+//
+// Each entry has the following layout:
+//
+//	offset  0 uint64 seq         0 if the entry is being written, otherwise
+//	                             n+1 where n is the entry's position in its
+//	                             ring's stream of events
+//	offset  8 int64  start_ns    CLOCK_MONOTONIC at syscall entry
+//	offset 16 int64  duration_ns time from syscall entry to exit
+//	offset 24 int64  rval        syscall return value, if errno is 0
+//	offset 32 uint32 sysno       syscall number
+//	offset 36 int32  tid         thread ID in the root PID namespace
+//	offset 40 int32  errno       error returned by the syscall, or 0
+//	offset 44                    reserved
+//
+// Event n of a ring is stored in entry n % entries_per_ring. Rings are
+// overwritten when full, so readers never slow down the sandbox; a reader
+// that falls behind observes entries whose seq is greater than expected. To
+// read event n, readers load seq, copy the entry, and load seq again; the copy
+// is valid if both loads returned n+1.
+package syscalltrace
+
+import (
+	"fmt"
+	"sync/atomic"
+
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/safemem"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
+	"gvisor.dev/gvisor/pkg/sentry/platform"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
+	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
+)
+
+const (
+	// Magic is the first word of the buffer's header.
+	Magic = 0x74737667 // "gvst"
+
+	// Version is the version of the buffer's layout.
+	Version = 1
+
+	// HeaderSize is the size of the buffer's header in bytes.
+	HeaderSize = usermem.PageSize
+
+	// EntrySize is the size of each entry in bytes.
+	EntrySize = 64
+
+	// EntriesPerRing is the number of entries in each ring.
+	EntriesPerRing = 4096
+
+	// cacheLineSize is the assumed size of a CPU cache line.
+	cacheLineSize = 64
+)
+
+// DevMajor and DevMinor are the device numbers of the syscall trace device,
+// through which applications map the buffer. DevMajor is Linux's major
+// device number for miscellaneous character devices, for which Linux
+// reserves minor device numbers 240-254 for local use.
+const (
+	DevMajor = 10
+	DevMinor = 240
+)
+
+// Event is a syscall event.
+type Event struct {
+	// Start is the value of CLOCK_MONOTONIC, in nanoseconds, at syscall
+	// entry.
+	Start int64
+
+	// Duration is the time from syscall entry to exit in nanoseconds.
+	Duration int64
+
+	// Rval is the syscall's return value.
+	Rval int64
+
+	// Sysno is the syscall number.
+	Sysno uint32
+
+	// TID is the calling thread's ID in the root PID namespace.
+	TID int32
+
+	// Errno is the error returned by the syscall, or 0 if it succeeded.
+	Errno int32
+}
+
+// ring is the writer state of a ring.
+//
+// +stateify savable
+type ring struct {
+	// next is the position of the next event in the ring's stream of
+	// events. next is accessed using atomic memory operations.
+	next uint64
+
+	// Rings are written concurrently by tasks on different CPUs.
+	_ [cacheLineSize - 8]byte
+}
+
+// Buffer is a syscall trace buffer. Buffer implements memmap.Mappable.
+//
+// +stateify savable
+type Buffer struct {
+	// mfp is used to access the buffer's memory. mfp is immutable.
+	mfp pgalloc.MemoryFileProvider
+
+	// fr is the range of mfp.MemoryFile() holding the buffer. fr is
+	// immutable.
+	fr platform.FileRange
+
+	// rings is the writer state of each ring. The slice is immutable.
+	rings []ring
+}
+
+// New returns a Buffer with a ring for each of cpus CPUs, allocated from
+// mfp.MemoryFile().
+func New(mfp pgalloc.MemoryFileProvider, cpus uint) (*Buffer, error) {
+	if cpus == 0 {
+		cpus = 1
+	}
+	size := HeaderSize + uint64(cpus)*EntriesPerRing*EntrySize
+	mf := mfp.MemoryFile()
+	fr, err := mf.Allocate(size, usage.System)
+	if err != nil {
+		return nil, err
+	}
+	b := &Buffer{
+		mfp:   mfp,
+		fr:    fr,
+		rings: make([]ring, cpus),
+	}
+
+	var hdr [6 * 4]byte
+	for i, v := range []uint32{Magic, Version, uint32(cpus), EntriesPerRing, EntrySize, HeaderSize} {
+		usermem.ByteOrder.PutUint32(hdr[i*4:], v)
+	}
+	bs, err := mf.MapInternal(platform.FileRange{fr.Start, fr.Start + HeaderSize}, usermem.Write)
+	if err == nil {
+		_, err = safemem.CopySeq(bs, safemem.BlockSeqOf(safemem.BlockFromSafeSlice(hdr[:])))
+	}
+	if err != nil {
+		mf.DecRef(fr)
+		return nil, err
+	}
+	return b, nil
+}
+
+// Size returns the size of the buffer in bytes.
+func (b *Buffer) Size() uint64 {
+	return b.fr.Length()
+}
+
+// entry returns a mapping of the entry that holds event n of ring r.
+func (b *Buffer) entry(r, n uint64) (safemem.Block, error) {
+	off := b.fr.Start + HeaderSize + (r*EntriesPerRing+n%EntriesPerRing)*EntrySize
+	// Entries never span pages, so the mapping is always a single block.
+	bs, err := b.mfp.MemoryFile().MapInternal(platform.FileRange{off, off + EntrySize}, usermem.ReadWrite)
+	if err != nil {
+		return safemem.Block{}, err
+	}
+	return bs.Head(), nil
+}
+
+// Record appends e to the ring for the given CPU. Record may be called
+// concurrently from any goroutine, and never blocks.
+func (b *Buffer) Record(cpu int32, e *Event) {
+	r := uint64(uint32(cpu)) % uint64(len(b.rings))
+	n := atomic.AddUint64(&b.rings[r].next, 1) - 1
+	ent, err := b.entry(r, n)
+	if err != nil {
+		// The event is lost; readers will observe a gap in the stream.
+		return
+	}
+
+	var buf [EntrySize - 8]byte
+	usermem.ByteOrder.PutUint64(buf[0:], uint64(e.Start))
+	usermem.ByteOrder.PutUint64(buf[8:], uint64(e.Duration))
+	usermem.ByteOrder.PutUint64(buf[16:], uint64(e.Rval))
+	usermem.ByteOrder.PutUint32(buf[24:], e.Sysno)
+	usermem.ByteOrder.PutUint32(buf[28:], uint32(e.TID))
+	usermem.ByteOrder.PutUint32(buf[32:], uint32(e.Errno))
+
+	// The swaps order the writes to the entry with respect to readers; see
+	// the package comment.
+	if _, err := safemem.SwapUint64(ent, 0); err != nil {
+		return
+	}
+	if _, err := safemem.Copy(ent.DropFirst(8), safemem.BlockFromSafeSlice(buf[:])); err != nil {
+		return
+	}
+	safemem.SwapUint64(ent, n+1)
+}
+
+// Read returns a copy of event n of the ring for the given CPU. It returns
+// false if the event has not yet been written, has been overwritten, or is
+// being written.
+//
+// Read uses the same protocol as application readers, but compares only the
+// low 32 bits of seq, so it may return an event that was overwritten 1<<32
+// events later.
+func (b *Buffer) Read(cpu int32, n uint64) (Event, bool) {
+	r := uint64(uint32(cpu)) % uint64(len(b.rings))
+	ent, err := b.entry(r, n)
+	if err != nil {
+		return Event{}, false
+	}
+	if seq, err := safemem.LoadUint32(ent); err != nil || seq != uint32(n+1) {
+		return Event{}, false
+	}
+	var buf [EntrySize]byte
+	if _, err := safemem.Copy(safemem.BlockFromSafeSlice(buf[:]), ent); err != nil {
+		return Event{}, false
+	}
+	// Check that the entry was not rewritten while it was copied.
+	if seq, err := safemem.LoadUint32(ent); err != nil || seq != uint32(n+1) {
+		return Event{}, false
+	}
+	return Event{
+		Start:    int64(usermem.ByteOrder.Uint64(buf[8:])),
+		Duration: int64(usermem.ByteOrder.Uint64(buf[16:])),
+		Rval:     int64(usermem.ByteOrder.Uint64(buf[24:])),
+		Sysno:    usermem.ByteOrder.Uint32(buf[32:]),
+		TID:      int32(usermem.ByteOrder.Uint32(buf[36:])),
+		Errno:    int32(usermem.ByteOrder.Uint32(buf[40:])),
+	}, true
+}
+
+// AddMapping implements memmap.Mappable.AddMapping.
+func (*Buffer) AddMapping(context.Context, memmap.MappingSpace, usermem.AddrRange, uint64, bool) error {
+	return nil
+}
+
+// RemoveMapping implements memmap.Mappable.RemoveMapping.
+func (*Buffer) RemoveMapping(context.Context, memmap.MappingSpace, usermem.AddrRange, uint64, bool) {
+}
+
+// CopyMapping implements memmap.Mappable.CopyMapping.
+func (*Buffer) CopyMapping(context.Context, memmap.MappingSpace, usermem.AddrRange, usermem.AddrRange, uint64, bool) error {
+	return nil
+}
+
+// Translate implements memmap.Mappable.Translate.
+func (b *Buffer) Translate(ctx context.Context, required, optional memmap.MappableRange, at usermem.AccessType) ([]memmap.Translation, error) {
+	var err error
+	if required.End > b.fr.Length() {
+		err = &memmap.BusError{syserror.EFAULT}
+	}
+	if source := optional.Intersect(memmap.MappableRange{0, b.fr.Length()}); source.Length() != 0 {
+		return []memmap.Translation{
+			{
+				Source: source,
+				File:   b.mfp.MemoryFile(),
+				Offset: b.fr.Start + source.Start,
+				Perms:  usermem.AnyAccess,
+			},
+		}, err
+	}
+	return nil, err
+}
+
+// InvalidateUnsavable implements memmap.Mappable.InvalidateUnsavable.
+func (*Buffer) InvalidateUnsavable(context.Context) error {
+	return nil
+}
+
+// String implements fmt.Stringer.String.
+func (b *Buffer) String() string {
+	return fmt.Sprintf("syscall trace buffer %v with %d rings", b.fr, len(b.rings))
+}
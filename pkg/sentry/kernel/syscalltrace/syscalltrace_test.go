@@ -0,0 +1,113 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package syscalltrace
+
+import (
+	"testing"
+
+	"gvisor.dev/gvisor/pkg/sentry/contexttest"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
+	"gvisor.dev/gvisor/pkg/sync"
+	"gvisor.dev/gvisor/pkg/usermem"
+)
+
+func newTestBuffer(t *testing.T, cpus uint) *Buffer {
+	ctx := contexttest.Context(t)
+	b, err := New(pgalloc.MemoryFileProviderFromContext(ctx), cpus)
+	if err != nil {
+		t.Fatalf("New failed: %v", err)
+	}
+	return b
+}
+
+// TestHeader checks the header that readers use to find the rings.
+func TestHeader(t *testing.T) {
+	b := newTestBuffer(t, 3)
+	bs, err := b.mfp.MemoryFile().MapInternal(b.fr, usermem.Read)
+	if err != nil {
+		t.Fatalf("MapInternal failed: %v", err)
+	}
+	hdr := bs.Head().ToSlice()
+	for i, want := range []uint32{Magic, Version, 3, EntriesPerRing, EntrySize, HeaderSize} {
+		if got := usermem.ByteOrder.Uint32(hdr[i*4:]); got != want {
+			t.Errorf("header word %d: got %#x, want %#x", i, got, want)
+		}
+	}
+	if want := uint64(HeaderSize + 3*EntriesPerRing*EntrySize); b.Size() != want {
+		t.Errorf("Size: got %d, want %d", b.Size(), want)
+	}
+}
+
+// TestRecordRead checks that recorded events can be read back until they are
+// overwritten.
+func TestRecordRead(t *testing.T) {
+	b := newTestBuffer(t, 2)
+	const events = EntriesPerRing + 10
+	for i := 0; i < events; i++ {
+		b.Record(1, &Event{Start: int64(i), Duration: 2, Rval: -1, Sysno: 39, TID: 7, Errno: 4})
+	}
+	if _, ok := b.Read(0, 0); ok {
+		t.Errorf("read event from ring with no events")
+	}
+	for n := uint64(0); n < events; n++ {
+		e, ok := b.Read(1, n)
+		if n < events-EntriesPerRing {
+			if ok {
+				t.Errorf("read overwritten event %d", n)
+			}
+			continue
+		}
+		want := Event{Start: int64(n), Duration: 2, Rval: -1, Sysno: 39, TID: 7, Errno: 4}
+		if !ok || e != want {
+			t.Errorf("event %d: got %+v, %t, want %+v, true", n, e, ok, want)
+		}
+	}
+	if _, ok := b.Read(1, events); ok {
+		t.Errorf("read event that was never written")
+	}
+}
+
+// TestRecordConcurrent checks that concurrent writers to a ring do not lose
+// events.
+func TestRecordConcurrent(t *testing.T) {
+	b := newTestBuffer(t, 1)
+	const writers = 8
+	const perWriter = EntriesPerRing / writers
+	var wg sync.WaitGroup
+	for w := 0; w < writers; w++ {
+		wg.Add(1)
+		go func(w int) {
+			defer wg.Done()
+			for i := 0; i < perWriter; i++ {
+				b.Record(0, &Event{TID: int32(w), Start: int64(i)})
+			}
+		}(w)
+	}
+	wg.Wait()
+
+	var counts [writers]int
+	for n := uint64(0); n < writers*perWriter; n++ {
+		e, ok := b.Read(0, n)
+		if !ok {
+			t.Fatalf("event %d missing", n)
+		}
+		counts[e.TID]++
+	}
+	for w, c := range counts {
+		if c != perWriter {
+			t.Errorf("writer %d: got %d events, want %d", w, c, perWriter)
+		}
+	}
+}
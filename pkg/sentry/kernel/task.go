@@ -18,6 +18,7 @@ import (
 	gocontext "context"
 	"runtime/trace"
 	"sync/atomic"
+	"time"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/bpf"
@@ -97,6 +98,35 @@ type Task struct {
 	// owned by the task goroutine.
 	yieldCount uint64
 
+	// faultCount is the number of application page faults that the task
+	// goroutine has handled, as counted by PERF_COUNT_SW_PAGE_FAULTS.
+	//
+	// faultCount is accessed using atomic memory operations. faultCount is
+	// owned by the task goroutine.
+	faultCount uint64
+
+	// syscallStats holds per-syscall statistics for the task. syscallStats
+	// is not saved; statistics restart from zero after restore.
+	syscallStats taskSyscallStats `state:"nosave"`
+
+	// If Kernel.syscallTiming is true, syscallBlockStart is the time, in
+	// nanoseconds since syscallStatsEpoch, at which the task goroutine last
+	// blocked or stopped, and syscallBlockedNanos is the time that the task
+	// goroutine has spent blocked or stopped during the current syscall.
+	// Both are excluded from SyscallStat.SentryTime.
+	//
+	// syscallBlockStart and syscallBlockedNanos are exclusive to the task
+	// goroutine.
+	syscallBlockStart   int64 `state:"nosave"`
+	syscallBlockedNanos int64 `state:"nosave"`
+
+	// rootTID is the task's thread ID in the root PID namespace, which is
+	// recorded in syscall trace events without locking the TaskSet.
+	//
+	// rootTID is set before the task goroutine starts, and thereafter is
+	// exclusive to the task goroutine.
+	rootTID ThreadID
+
 	// pendingSignals is the set of pending signals that may be handled only by
 	// this task.
 	//
@@ -257,6 +287,11 @@ type Task struct {
 	// fdTable is protected by mu, and is owned by the task goroutine.
 	fdTable *FDTable
 
+	// pollCache retains the task's poll waiter registrations between calls.
+	//
+	// pollCache is exclusive to the task goroutine.
+	pollCache *PollCache `state:"nosave"`
+
 	// If vforkParent is not nil, it is the task that created this task with
 	// vfork() or clone(CLONE_VFORK), and should have its vforkStop ended when
 	// this TaskContext is released.
@@ -305,6 +340,12 @@ type Task struct {
 	// exited.
 	goroutineStopped sync.WaitGroup `state:"nosave"`
 
+	// goroutineStoppedOrExited is 1 if goroutineStopped's counter value is
+	// known to be 0, such that waiting on it would not block, and 0
+	// otherwise. goroutineStoppedOrExited is accessed using atomic memory
+	// operations.
+	goroutineStoppedOrExited int32 `state:"nosave"`
+
 	// ptraceTracer is the task that is ptrace-attached to this one. If
 	// ptraceTracer is nil, this task is not being traced. Note that due to
 	// atomic.Value limitations (atomic.Value.Store(nil) panics), a nil
@@ -436,8 +477,8 @@ type Task struct {
 	parentDeathSignal linux.Signal
 
 	// syscallFilters is all seccomp-bpf syscall filters applicable to the
-	// task, in the order in which they were installed. The type of the atomic
-	// is []bpf.Program. Writing needs to be protected by the signal mutex.
+	// task. The type of the atomic is *syscallFilters. Writing needs to be
+	// protected by the signal mutex.
 	//
 	// syscallFilters is owned by the task goroutine.
 	syscallFilters atomic.Value `state:".([]bpf.Program)"`
@@ -464,6 +505,19 @@ type Task struct {
 	// cpu is accessed using atomic memory operations.
 	cpu int32
 
+	// hostCPUMaskChanged is non-zero if allowedCPUMask may have changed since
+	// it was last applied to the host thread running the task goroutine. It
+	// is only used if Kernel.hostCPUs is non-nil.
+	//
+	// hostCPUMaskChanged is accessed using atomic memory operations.
+	hostCPUMaskChanged uint32 `state:"nosave"`
+
+	// hostThreadLocked is true if the task goroutine is locked to its host
+	// thread because the thread's affinity is constrained by allowedCPUMask.
+	//
+	// hostThreadLocked is exclusive to the task goroutine.
+	hostThreadLocked bool `state:"nosave"`
+
 	// This is used to keep track of changes made to a process' priority/niceness.
 	// It is mostly used to provide some reasonable return value from
 	// getpriority(2) after a call to setpriority(2) has been made.
@@ -474,6 +528,16 @@ type Task struct {
 	// niceness is protected by mu.
 	niceness int
 
+	// timerSlack is the amount of time by which the expirations of the
+	// task's blocking timeouts and sleeps may be delayed so that they can be
+	// coalesced with other wakeups, as set by prctl(PR_SET_TIMERSLACK).
+	// defaultTimerSlack is the value to which PR_SET_TIMERSLACK with an
+	// argument of 0 resets timerSlack.
+	//
+	// timerSlack and defaultTimerSlack are exclusive to the task goroutine.
+	timerSlack        time.Duration
+	defaultTimerSlack time.Duration
+
 	// This is used to track the numa policy for the current thread. This can be
 	// modified through a set_mempolicy(2) syscall. Since we always report a
 	// single numa node, all policies are no-ops. We only track this information
@@ -530,6 +594,26 @@ type Task struct {
 	// rseqSignature is exclusive to the task goroutine.
 	rseqSignature uint32
 
+	// vdsoClock is the state of the task's CPU clock published to the VDSO.
+	// Published clocks are invalidated by save/restore, so it is not saved.
+	//
+	// vdsoClock is exclusive to the task goroutine.
+	vdsoClock taskVDSOThreadClock `state:"nosave"`
+
+	// perfEvents is the set of perf_event_open(2) events counting the task.
+	// perfEventsClosed is true once the task has exited, after which no
+	// events may be added to perfEvents.
+	//
+	// perfEvents and perfEventsClosed are protected by mu.
+	perfEvents       []*PerfEvent
+	perfEventsClosed bool
+
+	// perfSamplePending is non-zero if an event in perfEvents may have a
+	// sample to be written by the task goroutine.
+	//
+	// perfSamplePending is accessed using atomic memory operations.
+	perfSamplePending uint32
+
 	// copyScratchBuffer is a buffer available to CopyIn/CopyOut
 	// implementations that require an intermediate buffer to copy data
 	// into/out of. It prevents these buffers from being allocated/zeroed in
@@ -550,6 +634,12 @@ type Task struct {
 	// futexWaiter is exclusive to the task goroutine.
 	futexWaiter *futex.Waiter `state:"nosave"`
 
+	// random buffers random bytes for getrandom(2). It is not saved, so
+	// that restored tasks don't reuse bytes from before the checkpoint.
+	//
+	// random is exclusive to the task goroutine.
+	random *taskRandom `state:"nosave"`
+
 	// startTime is the real time at which the task started. It is set when
 	// a Task is created or invokes execve(2).
 	//
@@ -567,13 +657,17 @@ func (t *Task) loadPtraceTracer(tracer *Task) {
 
 func (t *Task) saveSyscallFilters() []bpf.Program {
 	if f := t.syscallFilters.Load(); f != nil {
-		return f.([]bpf.Program)
+		return f.(*syscallFilters).programs
 	}
 	return nil
 }
 
 func (t *Task) loadSyscallFilters(filters []bpf.Program) {
-	t.syscallFilters.Store(filters)
+	// Precomputed results are not saved; afterLoad recomputes them once the
+	// task's syscall table is available.
+	if len(filters) != 0 {
+		t.syscallFilters.Store(&syscallFilters{programs: filters})
+	}
 }
 
 // afterLoad is invoked by stateify.
@@ -588,6 +682,13 @@ func (t *Task) afterLoad() {
 	t.p = t.k.Platform.NewContext()
 	t.rseqPreempted = true
 	t.futexWaiter = futex.NewWaiter()
+	if sf := t.syscallFilters.Load(); sf != nil {
+		var f *syscallFilters
+		for _, p := range sf.(*syscallFilters).programs {
+			f = f.appendFilter(p, t.tc.st.AuditNumber)
+		}
+		t.syscallFilters.Store(f)
+	}
 }
 
 // copyScratchBufferLen is the length of Task.copyScratchBuffer.
@@ -658,6 +759,9 @@ func (t *Task) Value(key interface{}) interface{} {
 		return t.k.mf
 	case pgalloc.CtxMemoryFileProvider:
 		return t.k
+	case pgalloc.CtxNUMAPolicy:
+		policy, nodemask := t.NumaPolicy()
+		return pgalloc.NUMAPolicy{Mode: policy, Nodemask: nodemask}
 	case platform.CtxPlatform:
 		return t.k
 	case uniqueid.CtxGlobalUniqueID:
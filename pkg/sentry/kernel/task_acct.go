@@ -87,10 +87,13 @@ func (t *Task) Setitimer(id int32, newitv linux.ItimerVal) (linux.ItimerVal, err
 		}
 	case linux.ITIMER_PROF:
 		c := t.tg.CPUClock()
-		var err error
+		var (
+			news ktime.Setting
+			err  error
+		)
+		t.tg.timerMu.Lock()
 		t.k.cpuClockTicker.Atomically(func() {
 			tm = c.Now()
-			var news ktime.Setting
 			news, err = ktime.SettingFromSpecAt(newitv.Value.ToDuration(), newitv.Interval.ToDuration(), tm)
 			if err != nil {
 				return
@@ -101,6 +104,14 @@ func (t *Task) Setitimer(id int32, newitv linux.ItimerVal) (linux.ItimerVal, err
 			t.tg.updateCPUTimersEnabledLocked()
 			t.tg.signalHandlers.mu.Unlock()
 		})
+		if err == nil {
+			samplerSetting := ktime.Setting{}
+			if itimerProfSampled(news) {
+				samplerSetting, err = ktime.SettingFromSpec(newitv.Value.ToDuration(), newitv.Interval.ToDuration(), t.tg.itimerProfTimer.Clock())
+			}
+			t.tg.itimerProfTimer.Swap(samplerSetting)
+		}
+		t.tg.timerMu.Unlock()
 		if err != nil {
 			return linux.ItimerVal{}, err
 		}
@@ -114,6 +125,15 @@ func (t *Task) Setitimer(id int32, newitv linux.ItimerVal) (linux.ItimerVal, err
 	}, nil
 }
 
+// itimerProfSampled returns true if SIGPROF for the ITIMER_PROF setting s is
+// delivered by ThreadGroup.itimerProfTimer rather than by
+// kernelCPUClockTicker, which is the case for periodic timers with an
+// interval shorter than linux.ClockTick, the resolution of CPU time
+// accounting.
+func itimerProfSampled(s ktime.Setting) bool {
+	return s.Enabled && s.Period != 0 && s.Period < linux.ClockTick
+}
+
 // IOUsage returns the io usage of the thread.
 func (t *Task) IOUsage() *usage.IO {
 	return t.ioUsage
@@ -23,6 +23,26 @@ import (
 	"gvisor.dev/gvisor/pkg/syserror"
 )
 
+// TimerSlack returns the amount of time by which the expirations of t's
+// blocking timeouts and sleeps may be delayed.
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (t *Task) TimerSlack() time.Duration {
+	return t.timerSlack
+}
+
+// SetTimerSlack sets t's timer slack to slack, or to its default if slack is
+// 0.
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (t *Task) SetTimerSlack(slack time.Duration) {
+	if slack == 0 {
+		slack = t.defaultTimerSlack
+	}
+	t.timerSlack = slack
+	t.blockingTimer.SetSlack(slack)
+}
+
 // BlockWithTimeout blocks t until an event is received from C, the application
 // monotonic clock indicates that timeout has elapsed (only if haveTimeout is true),
 // or t is interrupted. It returns:
@@ -209,6 +209,12 @@ func (r *runSyscallAfterExecStop) execute(t *Task) taskRunState {
 	// See fs/exec.c:setup_new_exec.
 	r.tc.MemoryManager.SetDumpability(mm.UserDumpable)
 
+	// The task's CPU clock is published to the VDSO in the old MM.
+	t.releaseVDSOThreadClock()
+
+	// Start perf events created with enable_on_exec.
+	t.enablePerfEventsOnExec()
+
 	// Switch to the new process.
 	t.MemoryManager().Deactivate()
 	t.mu.Lock()
@@ -256,7 +262,8 @@ func (t *Task) promoteLocked() {
 	t.mu.Unlock()
 
 	t.tg.leader = t
-	t.Infof("Becoming TID %d (in root PID namespace)", t.tg.pidns.owner.Root.tids[t])
+	t.rootTID = t.tg.pidns.owner.Root.tids[t]
+	t.Infof("Becoming TID %d (in root PID namespace)", t.rootTID)
 	t.updateInfoLocked()
 	// Reap the original leader. If it has a tracer, detach it instead of
 	// waiting for it to acknowledge the original leader's death.
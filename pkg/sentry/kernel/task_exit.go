@@ -253,12 +253,35 @@ func (*runExitMain) execute(t *Task) taskRunState {
 		}
 	}
 
+	// Another thread may reuse the task's thread pointer, so it must not
+	// find the task's CPU clock in the VDSO.
+	t.releaseVDSOThreadClock()
+
+	// Stop perf events counting the task, so that their readers see that it
+	// has exited.
+	t.closePerfEvents()
+
 	// Deactivate the address space and update max RSS before releasing the
 	// task's MM.
 	t.Deactivate()
 	t.tg.pidns.owner.mu.Lock()
 	t.updateRSSLocked()
 	t.tg.pidns.owner.mu.Unlock()
+
+	t.fsContext.DecRef()
+	t.releasePollCache()
+
+	// If the task holds the last reference on its FD table, closing its files
+	// can take as long as releasing a large MM; do both at once.
+	var fdTableReleased chan struct{}
+	if t.fdTable.ReadRefs() == 1 {
+		fdTableReleased = make(chan struct{})
+		go func() { // S/R-SAFE: t waits for this goroutine before it can stop.
+			t.fdTable.DecRef()
+			close(fdTableReleased)
+		}()
+	}
+
 	t.mu.Lock()
 	t.tc.release()
 	t.mu.Unlock()
@@ -266,8 +289,11 @@ func (*runExitMain) execute(t *Task) taskRunState {
 	// Releasing the MM unblocks a blocked CLONE_VFORK parent.
 	t.unstopVforkParent()
 
-	t.fsContext.DecRef()
-	t.fdTable.DecRef()
+	if fdTableReleased != nil {
+		<-fdTableReleased
+	} else {
+		t.fdTable.DecRef()
+	}
 
 	t.mu.Lock()
 	if t.mountNamespaceVFS2 != nil {
@@ -420,6 +446,9 @@ func (t *Task) reparentLocked(parent *Task) {
 	if oldParent != nil && parent != nil && oldParent.tg == parent.tg {
 		return
 	}
+	if oldParent != nil {
+		delete(oldParent.tg.zombieChildren, t)
+	}
 	t.tg.terminationSignal = linux.SIGCHLD
 	if t.exitParentNotified && !t.exitParentAcked {
 		t.exitParentNotified = false
@@ -655,6 +684,12 @@ func (t *Task) exitNotifyLocked(fromPtraceDetach bool) {
 			}
 		}
 	}
+	if t == t.tg.leader && t.parent != nil && t.exitParentNotified && !t.exitParentAcked {
+		if t.parent.tg.zombieChildren == nil {
+			t.parent.tg.zombieChildren = make(map[*Task]struct{})
+		}
+		t.parent.tg.zombieChildren[t] = struct{}{}
+	}
 	if t.exitTracerAcked && t.exitParentAcked {
 		t.advanceExitStateLocked(TaskExitZombie, TaskExitDead)
 		for ns := t.tg.pidns; ns != nil; ns = ns.parent {
@@ -681,9 +716,14 @@ func (t *Task) exitNotifyLocked(fromPtraceDetach bool) {
 		}
 		if t.parent != nil {
 			delete(t.parent.children, t)
+			delete(t.parent.tg.zombieChildren, t)
 			t.parent = nil
 		}
 	}
+	if t == t.tg.leader && t.tg.tasksCount <= 1 {
+		// The thread group has exited.
+		t.tg.exitQueue.Notify(waiter.EventIn)
+	}
 }
 
 // Preconditions: The TaskSet mutex must be locked.
@@ -727,6 +767,27 @@ func (tg *ThreadGroup) ExitStatus() ExitStatus {
 	return tg.leader.exitStatus
 }
 
+// Exited returns true if every task in tg has exited, such that tg's leader
+// is a zombie or has been reaped. This is the condition under which a pidfd
+// referring to tg becomes readable.
+func (tg *ThreadGroup) Exited() bool {
+	ts := tg.TaskSet()
+	ts.mu.RLock()
+	defer ts.mu.RUnlock()
+	return tg.leader.exitState >= TaskExitZombie && tg.tasksCount <= 1
+}
+
+// ExitEventRegister registers e to be notified with waiter.EventIn when tg
+// exits, as defined by Exited.
+func (tg *ThreadGroup) ExitEventRegister(e *waiter.Entry) {
+	tg.exitQueue.EventRegister(e, waiter.EventIn)
+}
+
+// ExitEventUnregister unregisters e from notification of tg's exit.
+func (tg *ThreadGroup) ExitEventUnregister(e *waiter.Entry) {
+	tg.exitQueue.EventUnregister(e)
+}
+
 // TerminationSignal returns the thread group's termination signal.
 func (tg *ThreadGroup) TerminationSignal() linux.Signal {
 	tg.pidns.owner.mu.RLock()
@@ -885,6 +946,15 @@ func (t *Task) waitOnce(opts *WaitOptions) (*WaitResult, error) {
 	t.tg.pidns.owner.mu.Lock()
 	defer t.tg.pidns.owner.mu.Unlock()
 
+	// Reapers of many children typically wait for any child. Check children
+	// that are known to have exited first, so that collecting an exit doesn't
+	// require scanning every child.
+	if opts.Events&EventExit != 0 && opts.SpecificTID == 0 {
+		if wr := t.waitZombieChildLocked(opts); wr != nil {
+			return wr, nil
+		}
+	}
+
 	if opts.SiblingChildren {
 		// We can wait on the children and tracees of any task in the
 		// same thread group.
@@ -910,83 +980,161 @@ func (t *Task) waitOnce(opts *WaitOptions) (*WaitResult, error) {
 	return nil, syserror.ECHILD
 }
 
+// waitZombieChildLocked collects the exit of a zombie child of t's thread
+// group (or of t, if opts.SiblingChildren is false) that is eligible to be
+// waited for under opts. If there is no such child, waitZombieChildLocked
+// returns nil; this does not imply that no other child is waitable.
+//
 // Preconditions: The TaskSet mutex must be locked for writing.
-func (t *Task) waitParentLocked(opts *WaitOptions, parent *Task) (*WaitResult, bool) {
-	anyWaitableTasks := false
-
-	for child := range parent.children {
-		if !opts.matchesTask(child, parent.tg.pidns, false) {
+func (t *Task) waitZombieChildLocked(opts *WaitOptions) *WaitResult {
+	for child := range t.tg.zombieChildren {
+		if child.parent == nil || child.parent.tg != t.tg || child != child.tg.leader || child.exitParentAcked {
+			// Stale; see threadGroupNode.zombieChildren.
+			delete(t.tg.zombieChildren, child)
 			continue
 		}
-		// Non-leaders don't notify parents on exit and aren't eligible to
-		// be waited on.
-		if opts.Events&EventExit != 0 && child == child.tg.leader && !child.exitParentAcked {
-			anyWaitableTasks = true
-			if wr := t.waitCollectZombieLocked(child, opts, false); wr != nil {
-				return wr, anyWaitableTasks
-			}
-		}
-		// Check for group stops and continues. Tasks that have passed
-		// TaskExitInitiated can no longer participate in group stops.
-		if opts.Events&(EventChildGroupStop|EventGroupContinue) == 0 {
+		if !opts.SiblingChildren && child.parent != t {
 			continue
 		}
-		if child.exitState >= TaskExitInitiated {
+		if !opts.matchesTask(child, t.tg.pidns, false) {
 			continue
 		}
-		// If the waiter is in the same thread group as the task's
-		// tracer, do not report its group stops; they will be reported
-		// as ptrace stops instead. This also skips checking for group
-		// continues, but they'll be checked for when scanning tracees
-		// below. (Per kernel/exit.c:wait_consider_task(): "If a
-		// ptracer wants to distinguish the two events for its own
-		// children, it should create a separate process which takes
-		// the role of real parent.")
-		if tracer := child.Tracer(); tracer != nil && tracer.tg == parent.tg {
-			continue
+		if wr := t.waitCollectZombieLocked(child, opts, false); wr != nil {
+			return wr
 		}
-		anyWaitableTasks = true
-		if opts.Events&EventChildGroupStop != 0 {
-			if wr := t.waitCollectChildGroupStopLocked(child, opts); wr != nil {
-				return wr, anyWaitableTasks
+	}
+	return nil
+}
+
+// Preconditions: The TaskSet mutex must be locked for writing.
+func (t *Task) waitParentLocked(opts *WaitOptions, parent *Task) (*WaitResult, bool) {
+	if opts.SpecificTID != 0 {
+		// At most one task can match, so look it up rather than scanning all
+		// of parent's children and tracees.
+		target := parent.tg.pidns.tasks[opts.SpecificTID]
+		if target == nil {
+			return nil, false
+		}
+		anyWaitableTasks := false
+		if _, ok := parent.children[target]; ok {
+			wr, any := t.waitChildLocked(opts, parent, target)
+			if wr != nil {
+				return wr, true
 			}
+			anyWaitableTasks = any
 		}
-		if opts.Events&EventGroupContinue != 0 {
-			if wr := t.waitCollectGroupContinueLocked(child, opts); wr != nil {
-				return wr, anyWaitableTasks
+		if _, ok := parent.ptraceTracees[target]; ok {
+			wr, any := t.waitTraceeLocked(opts, parent, target)
+			if wr != nil {
+				return wr, true
 			}
+			anyWaitableTasks = anyWaitableTasks || any
 		}
+		return nil, anyWaitableTasks
+	}
+
+	anyWaitableTasks := false
+	for child := range parent.children {
+		wr, any := t.waitChildLocked(opts, parent, child)
+		if wr != nil {
+			return wr, true
+		}
+		anyWaitableTasks = anyWaitableTasks || any
 	}
 	for tracee := range parent.ptraceTracees {
-		if !opts.matchesTask(tracee, parent.tg.pidns, true) {
-			continue
+		wr, any := t.waitTraceeLocked(opts, parent, tracee)
+		if wr != nil {
+			return wr, true
 		}
-		// Non-leaders do notify tracers on exit.
-		if opts.Events&EventExit != 0 && !tracee.exitTracerAcked {
-			anyWaitableTasks = true
-			if wr := t.waitCollectZombieLocked(tracee, opts, true); wr != nil {
-				return wr, anyWaitableTasks
-			}
+		anyWaitableTasks = anyWaitableTasks || any
+	}
+	return nil, anyWaitableTasks
+}
+
+// waitChildLocked checks child, a child of parent, for a waitable event. It
+// returns the event, if any, and whether child may produce a waitable event.
+//
+// Preconditions: The TaskSet mutex must be locked for writing.
+func (t *Task) waitChildLocked(opts *WaitOptions, parent, child *Task) (*WaitResult, bool) {
+	if !opts.matchesTask(child, parent.tg.pidns, false) {
+		return nil, false
+	}
+	anyWaitableTasks := false
+	// Non-leaders don't notify parents on exit and aren't eligible to
+	// be waited on.
+	if opts.Events&EventExit != 0 && child == child.tg.leader && !child.exitParentAcked {
+		anyWaitableTasks = true
+		if wr := t.waitCollectZombieLocked(child, opts, false); wr != nil {
+			return wr, anyWaitableTasks
 		}
-		if opts.Events&(EventTraceeStop|EventGroupContinue) == 0 {
-			continue
+	}
+	// Check for group stops and continues. Tasks that have passed
+	// TaskExitInitiated can no longer participate in group stops.
+	if opts.Events&(EventChildGroupStop|EventGroupContinue) == 0 {
+		return nil, anyWaitableTasks
+	}
+	if child.exitState >= TaskExitInitiated {
+		return nil, anyWaitableTasks
+	}
+	// If the waiter is in the same thread group as the task's
+	// tracer, do not report its group stops; they will be reported
+	// as ptrace stops instead. This also skips checking for group
+	// continues, but they'll be checked for when scanning tracees
+	// below. (Per kernel/exit.c:wait_consider_task(): "If a
+	// ptracer wants to distinguish the two events for its own
+	// children, it should create a separate process which takes
+	// the role of real parent.")
+	if tracer := child.Tracer(); tracer != nil && tracer.tg == parent.tg {
+		return nil, anyWaitableTasks
+	}
+	anyWaitableTasks = true
+	if opts.Events&EventChildGroupStop != 0 {
+		if wr := t.waitCollectChildGroupStopLocked(child, opts); wr != nil {
+			return wr, anyWaitableTasks
 		}
-		if tracee.exitState >= TaskExitInitiated {
-			continue
+	}
+	if opts.Events&EventGroupContinue != 0 {
+		if wr := t.waitCollectGroupContinueLocked(child, opts); wr != nil {
+			return wr, anyWaitableTasks
 		}
+	}
+	return nil, anyWaitableTasks
+}
+
+// waitTraceeLocked checks tracee, a ptrace tracee of parent, for a waitable
+// event. It returns the event, if any, and whether tracee may produce a
+// waitable event.
+//
+// Preconditions: The TaskSet mutex must be locked for writing.
+func (t *Task) waitTraceeLocked(opts *WaitOptions, parent, tracee *Task) (*WaitResult, bool) {
+	if !opts.matchesTask(tracee, parent.tg.pidns, true) {
+		return nil, false
+	}
+	anyWaitableTasks := false
+	// Non-leaders do notify tracers on exit.
+	if opts.Events&EventExit != 0 && !tracee.exitTracerAcked {
 		anyWaitableTasks = true
-		if opts.Events&EventTraceeStop != 0 {
-			if wr := t.waitCollectTraceeStopLocked(tracee, opts); wr != nil {
-				return wr, anyWaitableTasks
-			}
+		if wr := t.waitCollectZombieLocked(tracee, opts, true); wr != nil {
+			return wr, anyWaitableTasks
 		}
-		if opts.Events&EventGroupContinue != 0 {
-			if wr := t.waitCollectGroupContinueLocked(tracee, opts); wr != nil {
-				return wr, anyWaitableTasks
-			}
+	}
+	if opts.Events&(EventTraceeStop|EventGroupContinue) == 0 {
+		return nil, anyWaitableTasks
+	}
+	if tracee.exitState >= TaskExitInitiated {
+		return nil, anyWaitableTasks
+	}
+	anyWaitableTasks = true
+	if opts.Events&EventTraceeStop != 0 {
+		if wr := t.waitCollectTraceeStopLocked(tracee, opts); wr != nil {
+			return wr, anyWaitableTasks
+		}
+	}
+	if opts.Events&EventGroupContinue != 0 {
+		if wr := t.waitCollectGroupContinueLocked(tracee, opts); wr != nil {
+			return wr, anyWaitableTasks
 		}
 	}
-
 	return nil, anyWaitableTasks
 }
 
@@ -0,0 +1,67 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"io"
+
+	"gvisor.dev/gvisor/pkg/rand"
+)
+
+// taskRandomBufLen is the length of a task's buffer of random bytes. It is
+// large enough to serve a typical cryptographic handshake's worth of small
+// getrandom(2) calls from a single refill.
+const taskRandomBufLen = 512
+
+// taskRandom is a buffer of random bytes read from rand.Reader, which is
+// shared by all tasks and locked on every read.
+type taskRandom struct {
+	buf [taskRandomBufLen]byte
+
+	// off is the offset of the first unused byte in buf.
+	off int
+}
+
+// Read implements io.Reader.Read.
+func (r *taskRandom) Read(dst []byte) (int, error) {
+	if len(dst) > len(r.buf)/2 {
+		// Large reads gain little from buffering.
+		return rand.Reader.Read(dst)
+	}
+	if len(r.buf)-r.off < len(dst) {
+		if _, err := io.ReadFull(rand.Reader, r.buf[:]); err != nil {
+			return 0, err
+		}
+		r.off = 0
+	}
+	n := copy(dst, r.buf[r.off:])
+	// Don't retain bytes that have been handed out.
+	for i := r.off; i < r.off+n; i++ {
+		r.buf[i] = 0
+	}
+	r.off += n
+	return n, nil
+}
+
+// RandomReader returns an io.Reader of cryptographically secure random bytes
+// that buffers reads from the host for t.
+//
+// The returned io.Reader may only be used on t's task goroutine.
+func (t *Task) RandomReader() io.Reader {
+	if t.random == nil {
+		t.random = &taskRandom{off: taskRandomBufLen}
+	}
+	return t.random
+}
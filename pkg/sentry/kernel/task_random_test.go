@@ -0,0 +1,48 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"bytes"
+	"testing"
+)
+
+// TestTaskRandom checks that taskRandom never returns the same bytes twice,
+// and doesn't retain the bytes it returns.
+func TestTaskRandom(t *testing.T) {
+	r := &taskRandom{off: taskRandomBufLen}
+	var prev []byte
+	// Enough reads to refill the buffer several times, with sizes that
+	// don't divide its length.
+	for i := 0; i < 4*taskRandomBufLen/24; i++ {
+		b := make([]byte, 24)
+		n, err := r.Read(b)
+		if err != nil || n != len(b) {
+			t.Fatalf("Read: got (%d, %v), want (%d, nil)", n, err, len(b))
+		}
+		if bytes.Equal(b, prev) {
+			t.Fatalf("Read returned %x twice", b)
+		}
+		if !bytes.Equal(r.buf[:r.off], make([]byte, r.off)) {
+			t.Fatalf("buffer retains returned bytes")
+		}
+		prev = b
+	}
+
+	big := make([]byte, taskRandomBufLen)
+	if n, err := r.Read(big); err != nil || n != len(big) {
+		t.Fatalf("Read: got (%d, %v), want (%d, nil)", n, err, len(big))
+	}
+}
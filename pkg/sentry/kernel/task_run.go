@@ -61,9 +61,16 @@ func (t *Task) run(threadID uintptr) {
 	// kernel.timekeeper.SetClocks() hasn't been called yet.
 	blockingTimerNotifier, blockingTimerChan := ktime.NewChannelNotifier()
 	t.blockingTimer = ktime.NewTimer(t.k.MonotonicClock(), blockingTimerNotifier)
+	t.blockingTimer.SetSlack(t.timerSlack)
 	defer t.blockingTimer.Destroy()
 	t.blockingTimerChan = blockingTimerChan
 
+	// A new task goroutine must apply its CPU mask to its host thread, whether
+	// the task is new or was restored.
+	if t.k.hostCPUs != nil {
+		atomic.StoreUint32(&t.hostCPUMaskChanged, 1)
+	}
+
 	// Activate our address space.
 	t.Activate()
 	// The corresponding t.Deactivate occurs in the exit path
@@ -93,6 +100,7 @@ func (t *Task) run(threadID uintptr) {
 		if t.runState == nil {
 			t.accountTaskGoroutineEnter(TaskGoroutineNonexistent)
 			t.goroutineStopped.Done()
+			atomic.StoreInt32(&t.goroutineStoppedOrExited, 1)
 			t.tg.liveGoroutines.Done()
 			t.tg.pidns.owner.liveGoroutines.Done()
 			t.tg.pidns.owner.runningGoroutines.Done()
@@ -121,10 +129,12 @@ func (t *Task) doStop() {
 	t.tg.pidns.owner.runningGoroutines.Add(-1)
 	defer t.tg.pidns.owner.runningGoroutines.Add(1)
 	t.goroutineStopped.Add(-1)
-	defer t.goroutineStopped.Add(1)
+	atomic.StoreInt32(&t.goroutineStoppedOrExited, 1)
 	for t.stopCount > 0 {
 		t.endStopCond.Wait()
 	}
+	atomic.StoreInt32(&t.goroutineStoppedOrExited, 0)
+	t.goroutineStopped.Add(1)
 }
 
 func (*runApp) handleCPUIDInstruction(t *Task) error {
@@ -243,6 +253,18 @@ func (app *runApp) execute(t *Task) taskRunState {
 		t.tg.pidns.owner.mu.RUnlock()
 	}
 
+	if t.k.hostCPUs != nil {
+		t.applyHostCPUMask()
+	}
+
+	if t.vdsoClock.registered {
+		t.publishVDSOThreadClock()
+	}
+
+	if atomic.LoadUint32(&t.perfSamplePending) != 0 {
+		t.writePerfSamples()
+	}
+
 	region := trace.StartRegion(t.traceContext, runRegion)
 	t.accountTaskGoroutineEnter(TaskGoroutineRunningApp)
 	info, at, err := t.p.Switch(t.MemoryManager().AddressSpace(), t.Arch(), t.rseqCPU)
@@ -283,17 +305,13 @@ func (app *runApp) execute(t *Task) taskRunState {
 		// an application-generated signal and we should continue execution
 		// normally.
 		if at.Any() {
-			region := trace.StartRegion(t.traceContext, faultRegion)
 			addr := usermem.Addr(info.Addr())
-			err := t.MemoryManager().HandleUserFault(t, addr, at, usermem.Addr(t.Arch().Stack()))
-			region.End()
-			if err == nil {
-				// The fault was handled appropriately.
-				// We can resume running the application.
-				return (*runApp)(nil)
-			}
 
-			// Is this a vsyscall that we need emulate?
+			// Is this a vsyscall that we need emulate? Vsyscall
+			// addresses are outside of the application address
+			// space, so the fault can't be handled by the
+			// MemoryManager; check for them first to avoid its
+			// locking and lookups on every vsyscall.
 			//
 			// Note that we don't track vsyscalls as part of a
 			// specific trace region. This is because regions don't
@@ -306,6 +324,16 @@ func (app *runApp) execute(t *Task) taskRunState {
 				}
 			}
 
+			atomic.AddUint64(&t.faultCount, 1)
+			region := trace.StartRegion(t.traceContext, faultRegion)
+			err := t.MemoryManager().HandleUserFault(t, addr, at, usermem.Addr(t.Arch().Stack()))
+			region.End()
+			if err == nil {
+				// The fault was handled appropriately.
+				// We can resume running the application.
+				return (*runApp)(nil)
+			}
+
 			// Faults are common, log only at debug level.
 			t.Debugf("Unhandled user fault: addr=%x ip=%x access=%v err=%v", addr, t.Arch().IP(), at, err)
 			t.DebugDumpState()
@@ -322,12 +350,8 @@ func (app *runApp) execute(t *Task) taskRunState {
 
 		switch sig {
 		case linux.SIGILL, linux.SIGSEGV, linux.SIGBUS, linux.SIGFPE, linux.SIGTRAP:
-			// Synchronous signal. Send it to ourselves. Assume the signal is
-			// legitimate and force it (work around the signal being ignored or
-			// blocked) like Linux does. Conveniently, this is even the correct
-			// behavior for SIGTRAP from single-stepping.
-			t.forceSignal(linux.Signal(sig), false /* unconditional */)
-			t.SendSignal(info)
+			// Synchronous signal. Send it to ourselves.
+			return t.deliverSynchronousSignal(info)
 
 		case platform.SignalInterrupt:
 			// Assume that a call to platform.Context.Interrupt() misfired.
@@ -364,6 +388,13 @@ func (t *Task) waitGoroutineStoppedOrExited() {
 	t.goroutineStopped.Wait()
 }
 
+// goroutineIsStoppedOrExited returns true if t's task goroutine is known to be
+// stopped or exited, such that waitGoroutineStoppedOrExited would return
+// immediately.
+func (t *Task) goroutineIsStoppedOrExited() bool {
+	return atomic.LoadInt32(&t.goroutineStoppedOrExited) != 0
+}
+
 // WaitExited blocks until all task goroutines in tg have exited.
 //
 // WaitExited does not correspond to anything in Linux; it's provided so that
@@ -373,8 +404,12 @@ func (tg *ThreadGroup) WaitExited() {
 	tg.liveGoroutines.Wait()
 }
 
-// Yield yields the processor for the calling task.
+// Yield yields the processor for the calling task, unless no other task is
+// waiting to run.
 func (t *Task) Yield() {
+	if atomic.LoadInt64(&t.k.runningTasks) <= atomic.LoadInt64(&t.k.schedProcs) {
+		return
+	}
 	atomic.AddUint64(&t.yieldCount, 1)
 	runtime.Gosched()
 }
@@ -19,6 +19,7 @@ package kernel
 import (
 	"fmt"
 	"math/rand"
+	"runtime"
 	"sync/atomic"
 	"time"
 
@@ -130,6 +131,12 @@ func (t *Task) accountTaskGoroutineEnter(state TaskGoroutineState) {
 	if state != TaskGoroutineRunningApp {
 		// Task is blocking/stopping.
 		t.k.decRunningTasks()
+		if t.vdsoClock.registered {
+			t.pauseVDSOThreadClock()
+		}
+		if t.k.syscallTiming {
+			t.syscallBlockStart = syscallStatsNow()
+		}
 	}
 }
 
@@ -140,6 +147,12 @@ func (t *Task) accountTaskGoroutineLeave(state TaskGoroutineState) {
 	if state != TaskGoroutineRunningApp {
 		// Task is unblocking/continuing.
 		t.k.incRunningTasks()
+		if t.vdsoClock.registered {
+			t.resumeVDSOThreadClock()
+		}
+		if t.k.syscallTiming {
+			t.syscallBlockedNanos += syscallStatsNow() - t.syscallBlockStart
+		}
 	}
 
 	now := t.k.CPUClockNow()
@@ -411,7 +424,7 @@ func (ticker *kernelCPUClockTicker) Notify(exp uint64, setting ktime.Setting) (k
 			// ITIMER_PROF
 			newItimerProfSetting, exp := tg.itimerProfSetting.At(tgProfNow)
 			tg.itimerProfSetting = newItimerProfSetting
-			if exp != 0 {
+			if exp != 0 && !itimerProfSampled(newItimerProfSetting) {
 				profReceiver.sendSignalLocked(SignalInfoPriv(linux.SIGPROF), true)
 			}
 			// RLIMIT_CPU soft limit
@@ -437,8 +450,18 @@ func (ticker *kernelCPUClockTicker) Notify(exp uint64, setting ktime.Setting) (k
 	}
 	ticker.tgs = tgs[:0]
 
-	// If nothing is running, we can disable the timer.
+	if atomic.LoadInt32(&ticker.k.perfSamplingEvents) != 0 {
+		ticker.k.tickPerfEvents()
+	}
+
+	// Sample whether tasks may be waiting to run, for sched_yield(2) in the
+	// sentry and the VDSO.
+	procs := int64(runtime.GOMAXPROCS(0))
+	atomic.StoreInt64(&ticker.k.schedProcs, procs)
 	tasks := atomic.LoadInt64(&ticker.k.runningTasks)
+	ticker.k.timekeeper.setSchedContended(tasks > procs)
+
+	// If nothing is running, we can disable the timer.
 	if tasks == 0 {
 		ticker.k.runningTasksMu.Lock()
 		defer ticker.k.runningTasksMu.Unlock()
@@ -604,9 +627,62 @@ func (t *Task) SetCPUMask(mask sched.CPUSet) error {
 	defer t.mu.Unlock()
 	t.allowedCPUMask = mask
 	atomic.StoreInt32(&t.cpu, assignCPU(mask, rootTID))
+	if t.k.hostCPUs != nil {
+		// The new mask takes effect in the host the next time t enters
+		// application code.
+		atomic.StoreUint32(&t.hostCPUMaskChanged, 1)
+	}
 	return nil
 }
 
+// applyHostCPUMask restricts the host thread running t's task goroutine to
+// the host CPUs corresponding to t's allowed CPU mask. While the mask excludes
+// any host CPU, the task goroutine is locked to the thread, so that no other
+// goroutine inherits its affinity; if the task goroutine exits while locked,
+// the Go runtime terminates the thread.
+//
+// Preconditions: The caller must be running on the task goroutine.
+// t.k.hostCPUs != nil.
+func (t *Task) applyHostCPUMask() {
+	if atomic.SwapUint32(&t.hostCPUMaskChanged, 0) == 0 {
+		return
+	}
+	hostCPUs := t.k.hostCPUs
+	allowed := make([]bool, len(hostCPUs))
+	t.CPUMask().ForEachCPU(func(cpu uint) {
+		allowed[cpu%uint(len(hostCPUs))] = true
+	})
+	var cpus []uint
+	for i, ok := range allowed {
+		if ok {
+			cpus = append(cpus, hostCPUs[i])
+		}
+	}
+
+	if len(cpus) == len(hostCPUs) {
+		if t.hostThreadLocked {
+			if err := hostcpu.SetAffinity(hostCPUs); err != nil {
+				// Leave the thread locked, since other goroutines must not
+				// run with its affinity.
+				t.Warningf("Failed to reset host CPU affinity: %v", err)
+				return
+			}
+			runtime.UnlockOSThread()
+			t.hostThreadLocked = false
+		}
+		return
+	}
+	if !t.hostThreadLocked {
+		runtime.LockOSThread()
+		t.hostThreadLocked = true
+	}
+	if err := hostcpu.SetAffinity(cpus); err != nil {
+		// This may happen if the host's CPUs have changed since the sandbox
+		// started; the mask remains advisory in that case.
+		t.Debugf("Failed to set host CPU affinity to %v: %v", cpus, err)
+	}
+}
+
 // CPU returns the cpu id for a given task.
 func (t *Task) CPU() int32 {
 	if t.k.useHostCores {
@@ -291,6 +291,52 @@ func (t *Task) deliverSignalToHandler(info *arch.SignalInfo, act arch.SignalAct)
 	return nil
 }
 
+// deliverSynchronousSignal delivers a synchronous signal (SIGSEGV, SIGBUS,
+// etc.) caused by t's execution of application code, and returns the
+// following run state.
+//
+// If t has a handler for the signal, does not block it, is not traced, and has
+// no pending group stop, ptrace stop or exit, the signal is delivered directly
+// to the handler. This has the same effect as queueing the signal and
+// dequeueing it in runInterrupt, since Linux also delivers synchronous signals
+// before any others that are pending, but avoids the queue, the TaskSet mutex
+// and a second acquisition of the signal mutex. Otherwise, the signal is forced
+// and queued as by Linux's force_sig_info().
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (t *Task) deliverSynchronousSignal(info *arch.SignalInfo) taskRunState {
+	sig := linux.Signal(info.Signo)
+	sigset := linux.SignalSetOf(sig)
+	t.tg.signalHandlers.mu.Lock()
+	act := t.tg.signalHandlers.actions[sig]
+	if act.Handler == arch.SignalActDefault ||
+		act.Handler == arch.SignalActIgnore ||
+		sigset&t.signalMask != 0 ||
+		(t.pendingSignals.pendingSet|t.tg.pendingSignals.pendingSet)&(sigset|linux.SignalSetOf(linux.SIGKILL)) != 0 ||
+		t.groupStopPending || t.trapStopPending || t.trapNotifyPending ||
+		t.tg.groupContNotify || t.tg.exiting || t.hasTracer() {
+		t.tg.signalHandlers.mu.Unlock()
+		// Assume the signal is legitimate and force it (work around the
+		// signal being ignored or blocked) like Linux does. Conveniently,
+		// this is even the correct behavior for SIGTRAP from
+		// single-stepping.
+		t.forceSignal(sig, false /* unconditional */)
+		t.SendSignal(info)
+		return (*runApp)(nil)
+	}
+	act = t.tg.signalHandlers.dequeueAction(sig)
+	t.tg.signalHandlers.mu.Unlock()
+
+	t.Debugf("Signal %d: delivering synchronously to handler", info.Signo)
+	if err := t.deliverSignalToHandler(info, act); err != nil {
+		// As in deliverSignal.
+		t.Debugf("Failed to deliver signal %+v to user handler: %v", info, err)
+		t.forceSignal(linux.SIGSEGV, sig == linux.SIGSEGV /* unconditional */)
+		t.SendSignal(SignalInfoPriv(linux.SIGSEGV))
+	}
+	return (*runApp)(nil)
+}
+
 var ctrlResume = &SyscallControl{ignoreReturn: true}
 
 // SignalReturn implements sigreturn(2) (if rt is false) or rt_sigreturn(2) (if
@@ -357,6 +403,29 @@ func (t *Task) Sigtimedwait(set linux.SignalSet, timeout time.Duration) (*arch.S
 	return nil, err
 }
 
+// DequeueSignals dequeues up to max pending signals in set, without blocking,
+// and returns them in the order in which they would be delivered. Signals are
+// dequeued with the signal mutex locked once for the whole batch, so that
+// readers draining many queued signals, such as signalfd, do not pay for a
+// lock round trip per signal.
+//
+// Preconditions: max > 0.
+func (t *Task) DequeueSignals(set linux.SignalSet, max int) []*arch.SignalInfo {
+	mask := ^(set &^ UnblockableSignals)
+
+	t.tg.signalHandlers.mu.Lock()
+	defer t.tg.signalHandlers.mu.Unlock()
+	var infos []*arch.SignalInfo
+	for len(infos) < max {
+		info := t.dequeueSignalLocked(mask)
+		if info == nil {
+			break
+		}
+		infos = append(infos, info)
+	}
+	return infos
+}
+
 // SendSignal sends the given signal to t.
 //
 // The following errors may be returned:
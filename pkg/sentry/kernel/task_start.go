@@ -15,6 +15,8 @@
 package kernel
 
 import (
+	"time"
+
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/inet"
@@ -23,6 +25,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/kernel/sched"
 	"gvisor.dev/gvisor/pkg/sentry/usage"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
+	"gvisor.dev/gvisor/pkg/sync"
 	"gvisor.dev/gvisor/pkg/syserror"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
@@ -66,6 +69,11 @@ type TaskConfig struct {
 	// Niceness is the niceness of the new task.
 	Niceness int
 
+	// TimerSlack is the timer slack of the new task, which is also the value
+	// to which the task's timer slack is reset by prctl(PR_SET_TIMERSLACK,
+	// 0). If TimerSlack is 0, DefaultTimerSlack is used.
+	TimerSlack time.Duration
+
 	// NetworkNamespace is the network namespace to be used for the new task.
 	NetworkNamespace *inet.Namespace
 
@@ -95,6 +103,10 @@ type TaskConfig struct {
 	ContainerID string
 }
 
+// DefaultTimerSlack is the timer slack of tasks that do not inherit it, as in
+// Linux.
+const DefaultTimerSlack = 50 * time.Microsecond
+
 // NewTask creates a new task defined by cfg.
 //
 // NewTask does not start the returned task; the caller must call Task.Start.
@@ -117,6 +129,10 @@ func (ts *TaskSet) NewTask(cfg *TaskConfig) (*Task, error) {
 func (ts *TaskSet) newTask(cfg *TaskConfig) (*Task, error) {
 	tg := cfg.ThreadGroup
 	tc := cfg.TaskContext
+	timerSlack := cfg.TimerSlack
+	if timerSlack == 0 {
+		timerSlack = DefaultTimerSlack
+	}
 	t := &Task{
 		taskNode: taskNode{
 			tg:       tg,
@@ -136,6 +152,8 @@ func (ts *TaskSet) newTask(cfg *TaskConfig) (*Task, error) {
 		allowedCPUMask:     cfg.AllowedCPUMask.Copy(),
 		ioUsage:            &usage.IO{},
 		niceness:           cfg.Niceness,
+		timerSlack:         timerSlack,
+		defaultTimerSlack:  timerSlack,
 		netns:              cfg.NetworkNamespace,
 		utsns:              cfg.UTSNamespace,
 		ipcns:              cfg.IPCNamespace,
@@ -207,7 +225,8 @@ func (ts *TaskSet) newTask(cfg *TaskConfig) (*Task, error) {
 	t.mu.Lock()
 	defer t.mu.Unlock()
 
-	t.cpu = assignCPU(t.allowedCPUMask, ts.Root.tids[t])
+	t.rootTID = ts.Root.tids[t]
+	t.cpu = assignCPU(t.allowedCPUMask, t.rootTID)
 
 	t.startTime = t.k.RealtimeClock().Now()
 
@@ -315,5 +334,104 @@ func (t *Task) Start(tid ThreadID) {
 	t.accountTaskGoroutineLeave(TaskGoroutineNonexistent)
 
 	// Use the task's TID in the root PID namespace to make it visible in stack dumps.
-	go t.run(uintptr(tid)) // S/R-SAFE: synchronizes with saving through stops
+	t.k.taskGoroutines.start(func() bool {
+		t.run(uintptr(tid)) // S/R-SAFE: synchronizes with saving through stops
+
+		// A goroutine whose host thread is still locked by applyHostCPUMask
+		// must exit, so that the thread is destroyed along with its
+		// affinity.
+		return !t.hostThreadLocked
+	})
+}
+
+const (
+	// maxIdleTaskGoroutines is the maximum number of goroutines that
+	// taskGoroutinePool keeps waiting for tasks.
+	maxIdleTaskGoroutines = 256
+
+	// taskGoroutineIdleTimeout is the time after which a goroutine waiting
+	// in taskGoroutinePool for a task exits.
+	taskGoroutineIdleTimeout = 10 * time.Second
+)
+
+// taskGoroutinePool keeps goroutines that have finished running a task so
+// that they can run later tasks.
+//
+// Creating a goroutine is cheap, but a task goroutine's stack is grown, by
+// copying, several times as the task runs through the syscall and memory
+// management paths, and each new goroutine repeats this. Goroutines that have
+// already grown their stacks run new tasks without doing so again, which
+// matters to applications that create many short-lived threads.
+//
+// The zero value of taskGoroutinePool is an empty pool.
+type taskGoroutinePool struct {
+	mu sync.Mutex
+
+	// idle contains a channel for each goroutine waiting for a task, in the
+	// order in which they became idle. A new task is sent to the most
+	// recently idle goroutine, whose stack is most likely to be cached.
+	//
+	// idle is protected by mu.
+	idle []chan func() bool
+}
+
+// start runs fn on an idle goroutine, or on a new goroutine if none is idle.
+// If fn returns true, its goroutine may run later calls to start.
+func (p *taskGoroutinePool) start(fn func() bool) {
+	p.mu.Lock()
+	if n := len(p.idle); n > 0 {
+		ch := p.idle[n-1]
+		p.idle[n-1] = nil
+		p.idle = p.idle[:n-1]
+		p.mu.Unlock()
+		ch <- fn
+		return
+	}
+	p.mu.Unlock()
+	go p.run(fn)
+}
+
+// run is the body of each goroutine in the pool.
+func (p *taskGoroutinePool) run(fn func() bool) {
+	var ch chan func() bool
+	for fn() {
+		if ch == nil {
+			ch = make(chan func() bool, 1)
+		}
+		if fn = p.wait(ch); fn == nil {
+			return
+		}
+	}
+}
+
+// wait waits for a task to be sent on ch, and returns it. If the pool is full,
+// or no task is sent before taskGoroutineIdleTimeout, wait returns nil.
+func (p *taskGoroutinePool) wait(ch chan func() bool) func() bool {
+	p.mu.Lock()
+	if len(p.idle) >= maxIdleTaskGoroutines {
+		p.mu.Unlock()
+		return nil
+	}
+	p.idle = append(p.idle, ch)
+	p.mu.Unlock()
+
+	timer := time.NewTimer(taskGoroutineIdleTimeout)
+	defer timer.Stop()
+	select {
+	case fn := <-ch:
+		return fn
+	case <-timer.C:
+	}
+
+	p.mu.Lock()
+	for i, idle := range p.idle {
+		if idle == ch {
+			p.idle = append(p.idle[:i], p.idle[i+1:]...)
+			p.mu.Unlock()
+			return nil
+		}
+	}
+	p.mu.Unlock()
+	// start took ch concurrently with the timeout, and will send on it.
+	return <-ch
 }
@@ -22,6 +22,7 @@ import (
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/bits"
+	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/metric"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
@@ -165,6 +166,16 @@ func (t *Task) executeSyscall(sysno uintptr, args arch.SyscallArguments) (rval u
 		if trace.IsEnabled() {
 			region = trace.StartRegion(t.traceContext, s.LookupName(sysno))
 		}
+		var start int64
+		if t.k.syscallTiming {
+			start = syscallStatsNow()
+			t.syscallBlockedNanos = 0
+		}
+		tracing := t.syscallTracing()
+		var traceStart int64
+		if tracing {
+			traceStart = t.k.MonotonicClock().Now().Nanoseconds()
+		}
 		if fn != nil {
 			// Call our syscall implementation.
 			rval, ctrl, err = fn(t, args)
@@ -172,6 +183,14 @@ func (t *Task) executeSyscall(sysno uintptr, args arch.SyscallArguments) (rval u
 			// Use the missing function if not found.
 			rval, err = t.SyscallTable().Missing(t, sysno, args)
 		}
+		var nanos int64
+		if t.k.syscallTiming {
+			nanos = syscallStatsNow() - start - t.syscallBlockedNanos
+		}
+		t.syscallStats.record(sysno, nanos)
+		if tracing {
+			t.recordSyscallTrace(sysno, traceStart, rval, ctrl, err)
+		}
 		if region != nil {
 			region.End()
 		}
@@ -420,7 +439,11 @@ func (t *Task) doVsyscallInvoke(sysno uintptr, args arch.SyscallArguments, calle
 		// Set the return value. The stack has already been adjusted.
 		t.Arch().SetReturn(0)
 	} else if err == nil {
-		t.Debugf("vsyscall %d, caller %x: successfully emulated syscall", sysno, t.Arch().Value(caller))
+		// Legacy binaries may make vsyscalls very frequently, so avoid
+		// formatting the caller unless it will be logged.
+		if t.IsLogging(log.Debug) {
+			t.Debugf("vsyscall %d, caller %x: successfully emulated syscall", sysno, t.Arch().Value(caller))
+		}
 		// Set the return value. The stack has already been adjusted.
 		t.Arch().SetReturn(uintptr(rval))
 	} else {
@@ -16,6 +16,7 @@ package kernel
 
 import (
 	"testing"
+	"time"
 
 	"gvisor.dev/gvisor/pkg/sentry/kernel/sched"
 )
@@ -67,3 +68,47 @@ func TestTaskCPU(t *testing.T) {
 	}
 
 }
+
+// idleTaskGoroutines waits for p to have want idle goroutines, and returns
+// the number it has.
+func idleTaskGoroutines(p *taskGoroutinePool, want int) int {
+	for deadline := time.Now().Add(10 * time.Second); ; {
+		p.mu.Lock()
+		n := len(p.idle)
+		p.mu.Unlock()
+		if n == want || time.Now().After(deadline) {
+			return n
+		}
+		time.Sleep(time.Millisecond)
+	}
+}
+
+func TestTaskGoroutinePoolReuse(t *testing.T) {
+	var p taskGoroutinePool
+	done := make(chan struct{})
+	for i := 0; i < 3; i++ {
+		p.start(func() bool {
+			done <- struct{}{}
+			return true
+		})
+		<-done
+		if n := idleTaskGoroutines(&p, 1); n != 1 {
+			t.Fatalf("after task %d: got %d idle goroutines, want 1", i, n)
+		}
+	}
+}
+
+func TestTaskGoroutinePoolNoReuse(t *testing.T) {
+	var p taskGoroutinePool
+	exited := make(chan struct{})
+	p.start(func() bool {
+		defer close(exited)
+		return false
+	})
+	<-exited
+	// The goroutine may not have exited yet, but must never become idle.
+	time.Sleep(10 * time.Millisecond)
+	if n := idleTaskGoroutines(&p, 0); n != 0 {
+		t.Errorf("got %d idle goroutines, want 0", n)
+	}
+}
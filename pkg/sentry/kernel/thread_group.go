@@ -15,6 +15,7 @@
 package kernel
 
 import (
+	"math/rand"
 	"sync/atomic"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
@@ -158,11 +159,17 @@ type ThreadGroup struct {
 	// restarted by Task.Start.
 	liveGoroutines sync.WaitGroup `state:"nosave"`
 
+	// timerMu also serializes changes to ITIMER_PROF, so that
+	// itimerProfSetting and itimerProfTimer are updated together.
 	timerMu sync.Mutex `state:"nosave"`
 
 	// itimerRealTimer implements ITIMER_REAL for the thread group.
 	itimerRealTimer *ktime.Timer
 
+	// itimerProfTimer delivers SIGPROF for ITIMER_PROF if
+	// itimerProfSampled(itimerProfSetting). See itimerProfListener.
+	itimerProfTimer *ktime.Timer
+
 	// itimerVirtSetting is the ITIMER_VIRTUAL setting for the thread group.
 	//
 	// itimerVirtSetting is protected by the signal mutex.
@@ -279,6 +286,7 @@ func (k *Kernel) NewThreadGroup(mntns *fs.MountNamespace, pidns *PIDNamespace, s
 		mounts:            mntns,
 	}
 	tg.itimerRealTimer = ktime.NewTimer(k.monotonicClock, &itimerRealListener{tg: tg})
+	tg.itimerProfTimer = ktime.NewTimer(k.monotonicClock, &itimerProfListener{tg: tg})
 	tg.timers = make(map[linux.TimerID]*IntervalTimer)
 	tg.oldRSeqCritical.Store(&OldRSeqCriticalRegion{})
 	return tg
@@ -312,6 +320,7 @@ func (tg *ThreadGroup) release() {
 	// Timers must be destroyed without holding the TaskSet or signal mutexes
 	// since timers send signals with Timer.mu locked.
 	tg.itimerRealTimer.Destroy()
+	tg.itimerProfTimer.Destroy()
 	var its []*IntervalTimer
 	tg.pidns.owner.mu.Lock()
 	tg.signalHandlers.mu.Lock()
@@ -528,3 +537,52 @@ func (l *itimerRealListener) Notify(exp uint64, setting ktime.Setting) (ktime.Se
 // Destroy implements ktime.TimerListener.Destroy.
 func (l *itimerRealListener) Destroy() {
 }
+
+// itimerProfListener implements ktime.Listener for ITIMER_PROF expirations
+// at intervals shorter than linux.ClockTick.
+//
+// kernelCPUClockTicker can send at most one SIGPROF per linux.ClockTick, so
+// profilers sampling at a higher rate receive fewer samples than they expect
+// and overweight each one. Instead, itimerProfListener samples the thread
+// group every interval of wall time, and sends SIGPROF to one of its running
+// tasks, if any. While a thread group has a single running task, this
+// delivers SIGPROF at the rate that it uses CPU time, as in Linux.
+//
+// +stateify savable
+type itimerProfListener struct {
+	tg *ThreadGroup
+}
+
+// Notify implements ktime.TimerListener.Notify.
+func (l *itimerProfListener) Notify(exp uint64, setting ktime.Setting) (ktime.Setting, bool) {
+	tg := l.tg
+	tg.pidns.owner.mu.RLock()
+	defer tg.pidns.owner.mu.RUnlock()
+
+	// Randomly select a running task using reservoir sampling, as
+	// kernelCPUClockTicker.Notify does.
+	var receiver *Task
+	var n int32
+	for t := tg.tasks.Front(); t != nil; t = t.Next() {
+		switch t.TaskGoroutineSchedInfo().State {
+		case TaskGoroutineRunningApp, TaskGoroutineRunningSys:
+			n++
+			if rand.Int31n(n) == 0 {
+				receiver = t
+			}
+		}
+	}
+	if receiver == nil {
+		return ktime.Setting{}, false
+	}
+	tg.signalHandlers.mu.Lock()
+	if itimerProfSampled(tg.itimerProfSetting) {
+		receiver.sendSignalLocked(SignalInfoPriv(linux.SIGPROF), true)
+	}
+	tg.signalHandlers.mu.Unlock()
+	return ktime.Setting{}, false
+}
+
+// Destroy implements ktime.TimerListener.Destroy.
+func (l *itimerProfListener) Destroy() {
+}
@@ -300,6 +300,20 @@ type threadGroupNode struct {
 	// to the wait sourced from Exec().
 	eventQueue waiter.Queue `state:"nosave"`
 
+	// exitQueue is notified with waiter.EventIn when the thread group exits,
+	// as defined by ThreadGroup.Exited. It is used by pidfds.
+	exitQueue waiter.Queue `state:"zerovalue"`
+
+	// zombieChildren contains the leaders of child thread groups of this
+	// thread group whose exits have been reported to their parent but not
+	// yet acknowledged, i.e. zombies that may be collected by Task.Wait.
+	// This allows Task.Wait to find an exited child without scanning every
+	// child. Entries for children that have since been reaped or reparented
+	// are removed lazily, so each entry must be rechecked before use.
+	//
+	// zombieChildren is protected by the TaskSet mutex.
+	zombieChildren map[*Task]struct{}
+
 	// leader is the thread group's leader, which is the oldest task in the
 	// thread group; usually the last task in the thread group to call
 	// execve(), or if no such task exists then the first task in the thread
@@ -227,7 +227,7 @@ type Clock interface {
 	//
 	// WallTimeUntil is used to determine when associated Timers should next
 	// check for expirations. Returning too small a value may result in
-	// spurious Timer goroutine wakeups, while returning too large a value may
+	// spurious Timer ticks, while returning too large a value may
 	// result in late expirations. Implementations should usually err on the
 	// side of underestimating.
 	WallTimeUntil(t, now Time) time.Duration
@@ -426,26 +426,36 @@ type Timer struct {
 	// paused is true if the Timer is paused. paused is protected by mu.
 	paused bool
 
-	// kicker is used to wake the Timer goroutine. The kicker pointer is
-	// immutable, but its state is protected by mu.
-	kicker *time.Timer `state:"nosave"`
+	// slack is the amount of time by which expirations may be delayed so
+	// that they can be coalesced with those of other Timers. slack is
+	// protected by mu.
+	slack time.Duration
+
+	// kicker schedules calls to Tick in a timerWheel. kicker is nil until
+	// init is called; it is then immutable, but its state is protected by
+	// mu.
+	kicker *timerWheelEntry `state:"nosave"`
 
 	// entry is registered with clock.EventRegister. entry is immutable.
 	//
 	// Per comment in Clock, entry must be re-registered after restore; per
 	// comment in Timer.Load, this is done in Timer.Resume.
 	entry waiter.Entry `state:"nosave"`
-
-	// events is the channel that will be notified whenever entry receives an
-	// event. It is also closed by Timer.Destroy to instruct the Timer
-	// goroutine to exit.
-	events chan struct{} `state:"nosave"`
 }
 
-// timerTickEvents are Clock events that require the Timer goroutine to Tick
+// timerTickEvents are Clock events that require the Timer to Tick
 // prematurely.
 const timerTickEvents = ClockEventSet | ClockEventRateIncrease
 
+// timerEventCallback is the waiter.EntryCallback for Timer.entry.
+type timerEventCallback struct{}
+
+// Callback implements waiter.EntryCallback.Callback.
+func (*timerEventCallback) Callback(e *waiter.Entry) {
+	// The Clock's queue is locked, so Tick must not be called here.
+	e.Context.(*Timer).kicker.schedule(0, 0)
+}
+
 // NewTimer returns a new Timer that will obtain time from clock and send
 // expirations to listener. The Timer is initially stopped and has no first
 // expiration or period configured.
@@ -486,44 +496,31 @@ func (t *Timer) init() {
 	if t.kicker != nil {
 		return
 	}
-	// If t.kicker is nil, the Timer goroutine can't be running, so we can't
-	// race with it.
-	t.kicker = time.NewTimer(0)
-	t.entry, t.events = waiter.NewChannelEntry(nil)
+	// If t.kicker is nil, no Tick can be scheduled, so we can't race with
+	// one.
+	kicker := newTimerWheelEntry(t)
+	t.kicker = &kicker
+	t.entry = waiter.Entry{Context: t, Callback: &timerEventCallback{}}
 	t.clock.EventRegister(&t.entry, timerTickEvents)
-	go t.runGoroutine() // S/R-SAFE: synchronized by t.mu
+	t.kicker.schedule(0, 0)
 }
 
 // Destroy releases resources owned by the Timer. A Destroyed Timer must not be
 // used again; in particular, a Destroyed Timer should not be Saved.
 func (t *Timer) Destroy() {
-	// Stop the Timer, ensuring that the Timer goroutine will not call
-	// t.kicker.Reset, before calling t.kicker.Stop.
+	// Stop the Timer, ensuring that Tick will not reschedule t.kicker,
+	// before cancelling t.kicker. A Tick that is already running will not
+	// generate expirations.
 	t.mu.Lock()
 	t.setting.Enabled = false
 	t.mu.Unlock()
-	t.kicker.Stop()
-	// Unregister t.entry, ensuring that the Clock will not send to t.events,
-	// before closing t.events to instruct the Timer goroutine to exit.
+	// Unregister t.entry, ensuring that Clock events will not reschedule
+	// t.kicker.
 	t.clock.EventUnregister(&t.entry)
-	close(t.events)
+	t.kicker.cancel()
 	t.listener.Destroy()
 }
 
-func (t *Timer) runGoroutine() {
-	for {
-		select {
-		case <-t.kicker.C:
-		case _, ok := <-t.events:
-			if !ok {
-				// Channel closed by Destroy.
-				return
-			}
-		}
-		t.Tick()
-	}
-}
-
 // Tick requests that the Timer immediately check for expirations and
 // re-evaluate when it should next check for expirations.
 func (t *Timer) Tick() {
@@ -552,7 +549,7 @@ func (t *Timer) Pause() {
 	t.paused = true
 	// t.kicker may be nil if we were restored but never resumed.
 	if t.kicker != nil {
-		t.kicker.Stop()
+		t.kicker.cancel()
 	}
 }
 
@@ -569,13 +566,13 @@ func (t *Timer) Resume() {
 	// Lazily initialize the Timer. We can't call Timer.init until Timer.Resume
 	// because save/restore will restore Timers before
 	// kernel.Timekeeper.SetClocks() has been called, so if t.clock is backed
-	// by a kernel.Timekeeper then the Timer goroutine will panic if it calls
+	// by a kernel.Timekeeper then Tick will panic when it calls
 	// t.clock.Now().
 	t.init()
 
-	// Kick the Timer goroutine in case it was already initialized, but the
-	// Timer goroutine was sleeping.
-	t.kicker.Reset(0)
+	// Tick in case t was already initialized, since Pause cancelled any
+	// scheduled Tick.
+	t.kicker.schedule(0, 0)
 }
 
 // Get returns a snapshot of the Timer's current Setting and the time
@@ -645,6 +642,16 @@ func (t *Timer) SwapAnd(s Setting, f func()) (Time, Setting) {
 	return now, oldS
 }
 
+// SetSlack sets the amount of time by which t's expirations may be delayed so
+// that they can be coalesced with those of other Timers, as for Linux's timer
+// slack (see prctl(2), PR_SET_TIMERSLACK). SetSlack takes effect the next time
+// t is set.
+func (t *Timer) SetSlack(slack time.Duration) {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	t.slack = slack
+}
+
 // Atomically invokes f atomically with respect to expirations of t; that is, t
 // cannot generate expirations while f is being called.
 //
@@ -660,14 +667,13 @@ func (t *Timer) Atomically(f func()) {
 func (t *Timer) resetKickerLocked(now Time) {
 	if t.setting.Enabled {
 		// Clock.WallTimeUntil may return a negative value. This is fine;
-		// time.when treats negative Durations as 0.
-		t.kicker.Reset(t.clock.WallTimeUntil(t.setting.Next, now))
+		// timerWheelEntry.schedule treats negative Durations as 0.
+		t.kicker.schedule(t.clock.WallTimeUntil(t.setting.Next, now), t.slack)
+	} else {
+		// Cancelling is O(1), so do so eagerly rather than leave a
+		// spurious Tick in the wheel.
+		t.kicker.cancel()
 	}
-	// We don't call t.kicker.Stop if !t.setting.Enabled because in most cases
-	// resetKickerLocked will be called from the Timer goroutine itself, in
-	// which case t.kicker has already fired and t.kicker.Stop will be an
-	// expensive no-op (time.Timer.Stop => time.stopTimer => runtime.stopTimer
-	// => runtime.deltimer).
 }
 
 // Clock returns the Clock used by t.
@@ -0,0 +1,377 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package time
+
+import (
+	"math"
+	"math/bits"
+	"runtime"
+	"sync/atomic"
+	"time"
+
+	"gvisor.dev/gvisor/pkg/sync"
+)
+
+const (
+	// timerWheelTickShift is log2 of the duration, in nanoseconds, of a
+	// timer wheel tick (about 1ms).
+	timerWheelTickShift = 20
+
+	// timerWheelLevelShift is log2 of the number of slots in each level of a
+	// timer wheel.
+	timerWheelLevelShift = 6
+
+	// timerWheelSlots is the number of slots in each level of a timer wheel.
+	timerWheelSlots = 1 << timerWheelLevelShift
+
+	// timerWheelLevels is the number of levels in a timer wheel, which is
+	// sufficient to represent any non-negative int64 deadline.
+	timerWheelLevels = (63 - timerWheelTickShift + timerWheelLevelShift - 1) / timerWheelLevelShift
+)
+
+// timerWheelEpoch is the time from which timer wheel deadlines are measured.
+var timerWheelEpoch = time.Now()
+
+// timerWheelNow returns the current time, in nanoseconds since
+// timerWheelEpoch, as measured by the host's monotonic clock.
+func timerWheelNow() int64 {
+	return int64(time.Since(timerWheelEpoch))
+}
+
+// timerWheel is a hierarchical timing wheel that runs Timer.Tick for each
+// Timer at the wall time at which the Timer next needs to check for
+// expirations.
+//
+// Compared to a runtime timer and goroutine per Timer, scheduling and
+// cancelling a Tick is O(1), and Ticks that are due at the same time are run
+// in a single batch by the timerWheel's goroutine.
+//
+// Each entry may be run at any time between its deadline and its latest
+// time, which differ by the Timer's slack.
+//
+// Time is divided into ticks of 1<<timerWheelTickShift nanoseconds. Each
+// level of the wheel has timerWheelSlots slots, and each slot in level L
+// spans timerWheelSlots^L ticks. An entry whose latest time is in tick t is
+// stored at the highest level L at which the digit (of t, in base
+// timerWheelSlots) differs from that of now, in the slot given by that digit;
+// entries in the current tick are stored in level 0 at now's digit. When now
+// reaches the start of a slot in a level above 0, the slot's entries are
+// redistributed to lower levels.
+//
+// The wheel's goroutine wakes at the earliest latest time of the entries in
+// the current tick, rather than at a tick boundary, so the tick duration
+// affects only the wheel's efficiency. When it wakes, it runs every entry in
+// the current tick whose deadline has passed, so that entries whose windows
+// overlap share a wakeup.
+//
+// The zero value of timerWheel is an empty wheel.
+type timerWheel struct {
+	// mu protects the following fields, and the fields of all
+	// timerWheelEntries in the wheel.
+	mu sync.Mutex
+
+	// now is the tick up to which the wheel has advanced.
+	now uint64
+
+	// slots contains the entries in each slot.
+	slots [timerWheelLevels][timerWheelSlots]*timerWheelEntry
+
+	// occupied[L] has bit s set iff slots[L][s] is not empty.
+	occupied [timerWheelLevels]uint64
+
+	// wake is the time at which the wheel's goroutine will next run, or -1
+	// if it will not run.
+	wake int64
+
+	// kicker wakes the wheel's goroutine. kicker is nil if the goroutine has
+	// not been started.
+	kicker *time.Timer
+}
+
+// timerWheelEntry represents a Timer in a timerWheel.
+type timerWheelEntry struct {
+	// timer is the Timer to Tick. timer is immutable.
+	timer *Timer
+
+	// wheel is the timerWheel in which the entry is scheduled. wheel is
+	// immutable.
+	wheel *timerWheel
+
+	// The following fields are protected by wheel.mu.
+
+	// scheduled is true if the entry is in wheel.
+	scheduled bool
+
+	// deadline and latest are the earliest and latest times, in nanoseconds
+	// since timerWheelEpoch, at which timer should be ticked.
+	deadline int64
+	latest   int64
+
+	// level and slot are the entry's location in the wheel.
+	level int
+	slot  int
+
+	// prev and next link the entries in a slot.
+	prev *timerWheelEntry
+	next *timerWheelEntry
+}
+
+var (
+	// timerWheels are shared by all Timers, which are assigned to them in
+	// turn so that Ticks are run in parallel.
+	timerWheels     []timerWheel
+	timerWheelsOnce sync.Once
+
+	// nextTimerWheel is the index into timerWheels of the next Timer's wheel.
+	// nextTimerWheel is accessed using atomic memory operations.
+	nextTimerWheel uint32
+)
+
+// newTimerWheelEntry returns an unscheduled timerWheelEntry for t.
+func newTimerWheelEntry(t *Timer) timerWheelEntry {
+	timerWheelsOnce.Do(func() {
+		timerWheels = make([]timerWheel, runtime.GOMAXPROCS(0))
+	})
+	i := atomic.AddUint32(&nextTimerWheel, 1)
+	return timerWheelEntry{
+		timer: t,
+		wheel: &timerWheels[i%uint32(len(timerWheels))],
+	}
+}
+
+// timerWheelDeadline returns the time, in nanoseconds since timerWheelEpoch,
+// d after now.
+func timerWheelDeadline(now int64, d time.Duration) int64 {
+	if d < 0 {
+		return now
+	}
+	if d < time.Duration(math.MaxInt64-now) {
+		return now + int64(d)
+	}
+	return math.MaxInt64
+}
+
+// schedule arranges for e.timer to be ticked after d elapses, or up to slack
+// later, replacing any previously scheduled tick.
+func (e *timerWheelEntry) schedule(d, slack time.Duration) {
+	now := timerWheelNow()
+	deadline := timerWheelDeadline(now, d)
+	latest := timerWheelDeadline(deadline, slack)
+
+	w := e.wheel
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	if e.scheduled {
+		w.removeLocked(e)
+	}
+	e.deadline = deadline
+	e.latest = latest
+	w.insertLocked(e)
+	if w.wake < 0 || w.kicker == nil || latest < w.wake {
+		w.wakeAtLocked(latest, now)
+	}
+}
+
+// cancel cancels any scheduled tick of e.timer. A tick that is already
+// running, or about to run, is not cancelled.
+func (e *timerWheelEntry) cancel() {
+	w := e.wheel
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	if e.scheduled {
+		w.removeLocked(e)
+	}
+}
+
+// insertLocked adds e to w.
+//
+// Preconditions: w.mu must be locked. e must not be scheduled.
+func (w *timerWheel) insertLocked(e *timerWheelEntry) {
+	tick := uint64(e.latest) >> timerWheelTickShift
+	level := 0
+	if tick > w.now {
+		level = (bits.Len64(tick^w.now) - 1) / timerWheelLevelShift
+	} else {
+		tick = w.now
+	}
+	slot := int(tick>>(level*timerWheelLevelShift)) % timerWheelSlots
+
+	e.scheduled = true
+	e.level = level
+	e.slot = slot
+	e.prev = nil
+	e.next = w.slots[level][slot]
+	if e.next != nil {
+		e.next.prev = e
+	}
+	w.slots[level][slot] = e
+	w.occupied[level] |= 1 << uint(slot)
+}
+
+// removeLocked removes e from w.
+//
+// Preconditions: w.mu must be locked. e must be scheduled in w.
+func (w *timerWheel) removeLocked(e *timerWheelEntry) {
+	if e.prev != nil {
+		e.prev.next = e.next
+	} else {
+		w.slots[e.level][e.slot] = e.next
+		if e.next == nil {
+			w.occupied[e.level] &^= 1 << uint(e.slot)
+		}
+	}
+	if e.next != nil {
+		e.next.prev = e.prev
+	}
+	e.prev = nil
+	e.next = nil
+	e.scheduled = false
+}
+
+// takeSlotLocked removes all entries from slot s of level L, and returns
+// them as a list linked by next.
+//
+// Preconditions: w.mu must be locked.
+func (w *timerWheel) takeSlotLocked(level, slot int) *timerWheelEntry {
+	head := w.slots[level][slot]
+	w.slots[level][slot] = nil
+	w.occupied[level] &^= 1 << uint(slot)
+	for e := head; e != nil; e = e.next {
+		e.scheduled = false
+	}
+	return head
+}
+
+// nextEventLocked returns the first tick after w.now at which a slot in w
+// becomes current.
+//
+// Preconditions: w.mu must be locked.
+func (w *timerWheel) nextEventLocked() (uint64, bool) {
+	for level := 0; level < timerWheelLevels; level++ {
+		shift := uint(level * timerWheelLevelShift)
+		digit := (w.now >> shift) % timerWheelSlots
+		// Slots at or before digit are empty, except for the current
+		// slot in level 0, which is not an event.
+		later := w.occupied[level] &^ (2<<digit - 1)
+		if later == 0 {
+			continue
+		}
+		slot := uint64(bits.TrailingZeros64(later))
+		base := w.now >> (shift + timerWheelLevelShift) << (shift + timerWheelLevelShift)
+		return base | slot<<shift, true
+	}
+	return 0, false
+}
+
+// advanceLocked advances w to now, appends entries whose deadlines have
+// passed to expired, and schedules the next run of w's goroutine.
+//
+// Preconditions: w.mu must be locked.
+func (w *timerWheel) advanceLocked(now int64, expired []*timerWheelEntry) []*timerWheelEntry {
+	target := uint64(now) >> timerWheelTickShift
+	for w.now < target {
+		// Every entry in the current tick has expired.
+		for e := w.takeSlotLocked(0, int(w.now%timerWheelSlots)); e != nil; {
+			next := e.next
+			e.prev, e.next = nil, nil
+			expired = append(expired, e)
+			e = next
+		}
+
+		tick, ok := w.nextEventLocked()
+		if !ok || tick > target {
+			w.now = target
+			break
+		}
+		w.now = tick
+
+		// Redistribute the entries in slots that start at tick.
+		for level := timerWheelLevels - 1; level > 0; level-- {
+			shift := uint(level * timerWheelLevelShift)
+			if tick&(1<<shift-1) != 0 {
+				continue
+			}
+			slot := int(tick>>shift) % timerWheelSlots
+			if w.occupied[level]&(1<<uint(slot)) == 0 {
+				continue
+			}
+			for e := w.takeSlotLocked(level, slot); e != nil; {
+				next := e.next
+				e.prev, e.next = nil, nil
+				w.insertLocked(e)
+				e = next
+			}
+		}
+	}
+
+	// Expire entries in the current tick whose deadlines have passed, and
+	// find the earliest latest time of those that remain.
+	slot := int(w.now % timerWheelSlots)
+	wake := int64(-1)
+	for e := w.slots[0][slot]; e != nil; {
+		next := e.next
+		if e.deadline <= now {
+			w.removeLocked(e)
+			expired = append(expired, e)
+		} else if wake < 0 || e.latest < wake {
+			wake = e.latest
+		}
+		e = next
+	}
+	if wake < 0 {
+		if tick, ok := w.nextEventLocked(); ok {
+			wake = int64(tick << timerWheelTickShift)
+		}
+	}
+	if wake >= 0 {
+		w.wakeAtLocked(wake, now)
+	} else {
+		w.wake = -1
+	}
+	return expired
+}
+
+// wakeAtLocked arranges for w's goroutine to run at deadline.
+//
+// Preconditions: w.mu must be locked.
+func (w *timerWheel) wakeAtLocked(deadline, now int64) {
+	w.wake = deadline
+	d := time.Duration(deadline - now)
+	if w.kicker == nil {
+		w.kicker = time.NewTimer(d)
+		go w.run() // S/R-SAFE: Timers are paused, and not scheduled, during save.
+		return
+	}
+	// If the kicker has already fired, but w's goroutine has not yet received
+	// from its channel, the goroutine will run early; this is harmless.
+	w.kicker.Reset(d)
+}
+
+// run is the body of w's goroutine.
+func (w *timerWheel) run() {
+	var expired []*timerWheelEntry
+	for range w.kicker.C {
+		w.mu.Lock()
+		expired = w.advanceLocked(timerWheelNow(), expired[:0])
+		w.mu.Unlock()
+		// Ticks are run without w.mu locked, so they may reschedule their
+		// Timers. A Timer that was rescheduled or cancelled concurrently
+		// will be ticked spuriously, which is harmless.
+		for i, e := range expired {
+			e.timer.Tick()
+			expired[i] = nil
+		}
+	}
+}
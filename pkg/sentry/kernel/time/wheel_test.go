@@ -0,0 +1,167 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package time
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+	"time"
+)
+
+// newTestTimerWheel returns a timerWheel whose goroutine is never started, so
+// that tests can advance it explicitly.
+func newTestTimerWheel() *timerWheel {
+	return &timerWheel{kicker: time.NewTimer(time.Hour)}
+}
+
+// insertTestEntry schedules a new entry in w with the given deadline and no
+// slack.
+func insertTestEntry(w *timerWheel, deadline int64) *timerWheelEntry {
+	e := &timerWheelEntry{wheel: w, deadline: deadline, latest: deadline}
+	w.insertLocked(e)
+	return e
+}
+
+// TestTimerWheelExpiry checks that entries expire when the wheel advances past
+// their deadlines, and not before, for deadlines at every level.
+func TestTimerWheelExpiry(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+	w := newTestTimerWheel()
+	pending := make(map[*timerWheelEntry]struct{})
+	for i := 0; i < 1000; i++ {
+		// Deadlines from nanoseconds to days away, at every scale.
+		deadline := rng.Int63n(int64(1) << uint(rng.Intn(47)))
+		pending[insertTestEntry(w, deadline)] = struct{}{}
+	}
+	// An entry whose deadline is at the end of time.
+	pending[insertTestEntry(w, math.MaxInt64)] = struct{}{}
+
+	for now := int64(0); len(pending) > 1; {
+		expired := w.advanceLocked(now, nil)
+		for _, e := range expired {
+			if _, ok := pending[e]; !ok {
+				t.Fatalf("entry with deadline %d expired twice", e.deadline)
+			}
+			if e.deadline > now {
+				t.Fatalf("entry with deadline %d expired early at %d", e.deadline, now)
+			}
+			if e.scheduled {
+				t.Fatalf("expired entry with deadline %d is still scheduled", e.deadline)
+			}
+			delete(pending, e)
+		}
+		for e := range pending {
+			if e.deadline <= now {
+				t.Fatalf("entry with deadline %d did not expire at %d", e.deadline, now)
+			}
+			if e.deadline < w.wake {
+				t.Fatalf("entry with deadline %d is before wake time %d", e.deadline, w.wake)
+			}
+		}
+		// Advance either to the wake time, or by a random amount that may
+		// skip past it.
+		if rng.Intn(2) == 0 {
+			now = w.wake
+		} else {
+			now += rng.Int63n(int64(1) << uint(rng.Intn(40)))
+		}
+	}
+}
+
+// TestTimerWheelCancel checks that cancelled entries do not expire.
+func TestTimerWheelCancel(t *testing.T) {
+	w := newTestTimerWheel()
+	var entries []*timerWheelEntry
+	for i := int64(0); i < 1000; i++ {
+		entries = append(entries, insertTestEntry(w, i*int64(time.Millisecond)))
+	}
+	for i, e := range entries {
+		if i%2 == 1 {
+			w.removeLocked(e)
+		}
+	}
+	expired := w.advanceLocked(int64(time.Second), nil)
+	if len(expired) != len(entries)/2 {
+		t.Errorf("got %d expired entries, want %d", len(expired), len(entries)/2)
+	}
+	for _, e := range expired {
+		if (e.deadline/int64(time.Millisecond))%2 == 1 {
+			t.Errorf("cancelled entry with deadline %d expired", e.deadline)
+		}
+	}
+	if w.wake != -1 {
+		t.Errorf("got wake time %d for empty wheel, want -1", w.wake)
+	}
+	for level, occupied := range w.occupied {
+		if occupied != 0 {
+			t.Errorf("level %d of empty wheel has occupied slots %#x", level, occupied)
+		}
+	}
+}
+
+// TestTimerWheelSlack checks that entries with slack expire together when
+// their windows overlap, and no later than their latest times otherwise.
+func TestTimerWheelSlack(t *testing.T) {
+	w := newTestTimerWheel()
+	const ms = int64(time.Millisecond)
+	// a and b overlap, so they should both expire at a's latest time.
+	a := &timerWheelEntry{wheel: w, deadline: 10 * ms, latest: 10*ms + 200*1000}
+	b := &timerWheelEntry{wheel: w, deadline: 10*ms + 100*1000, latest: 10*ms + 300*1000}
+	// c does not overlap a or b.
+	c := &timerWheelEntry{wheel: w, deadline: 20 * ms, latest: 20*ms + 100*1000}
+	for _, e := range []*timerWheelEntry{a, b, c} {
+		w.insertLocked(e)
+	}
+
+	var wakes []int64
+	var batches [][]*timerWheelEntry
+	for now := int64(0); len(wakes) < 10; now = w.wake {
+		if expired := w.advanceLocked(now, nil); len(expired) != 0 {
+			wakes = append(wakes, now)
+			batches = append(batches, expired)
+		}
+		if w.wake < 0 {
+			break
+		}
+	}
+	if len(batches) != 2 || len(batches[0]) != 2 || len(batches[1]) != 1 || batches[1][0] != c {
+		t.Fatalf("got expiry batches %v, want [[a b] [c]]", batches)
+	}
+	if wakes[0] != a.latest {
+		t.Errorf("a and b expired at %d, want %d", wakes[0], a.latest)
+	}
+	if wakes[1] != c.latest {
+		t.Errorf("c expired at %d, want %d", wakes[1], c.latest)
+	}
+}
+
+// BenchmarkTimerWheelSchedule measures rescheduling an entry in a wheel that
+// contains b.N other entries.
+func BenchmarkTimerWheelSchedule(b *testing.B) {
+	w := newTestTimerWheel()
+	rng := rand.New(rand.NewSource(1))
+	for i := 0; i < b.N; i++ {
+		insertTestEntry(w, rng.Int63n(int64(time.Hour)))
+	}
+	e := insertTestEntry(w, 0)
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		w.removeLocked(e)
+		e.deadline = rng.Int63n(int64(time.Hour))
+		e.latest = e.deadline
+		w.insertLocked(e)
+	}
+}
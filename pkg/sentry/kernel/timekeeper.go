@@ -76,6 +76,41 @@ type Timekeeper struct {
 	// params manages the parameter page.
 	params *VDSOParamPage
 
+	// getcpuMode and getcpuCPU are published to the VDSO along with the
+	// clock parameters. See vdsoFlags. They depend on the Platform, so
+	// they are set by the Kernel after Init and Load, by setGetcpu.
+	//
+	// They are accessed using atomic memory operations.
+	getcpuMode uint64 `state:"nosave"`
+	getcpuCPU  uint64 `state:"nosave"`
+
+	// cycleClockMode is published to the VDSO along with the clock
+	// parameters. It depends on the host, so it is not saved; it is set
+	// by SetClocks.
+	cycleClockMode uint64 `state:"nosave"`
+
+	// spinSleepMax is published to the VDSO along with the clock
+	// parameters. It is runtime configuration, so it is not saved; it is
+	// set by SetVDSOSpinSleep.
+	//
+	// It is accessed using atomic memory operations.
+	spinSleepMax int64 `state:"nosave"`
+
+	// cyclesMult is the multiplier converting cycles to nanoseconds, with
+	// shift vdsoCyclesShift, of the monotonic clock published to the VDSO.
+	// It is 0 if the clock is not ready. It is used by tasks publishing
+	// their CPU clocks to the VDSO.
+	//
+	// It is accessed using atomic memory operations.
+	cyclesMult uint64 `state:"nosave"`
+
+	// threadCPUTime is non-zero if tasks may publish their CPU clocks to
+	// the VDSO. It is runtime configuration, so it is not saved; it is set
+	// by Kernel.SetVDSOThreadCPUTime.
+	//
+	// It is accessed using atomic memory operations.
+	threadCPUTime uint32 `state:"nosave"`
+
 	// mu protects destruction with stop and wg.
 	mu sync.Mutex `state:"nosave"`
 
@@ -119,6 +154,7 @@ func (t *Timekeeper) SetClocks(c sentrytime.Clocks) {
 	}
 
 	t.clocks = c
+	t.cycleClockMode = vdsoCycleClockMode()
 
 	// Compute the offset of the monotonic clock from the base Clocks.
 	//
@@ -153,6 +189,17 @@ func (t *Timekeeper) SetClocks(c sentrytime.Clocks) {
 
 	t.monotonicOffset = wantMonotonic - nowMonotonic
 
+	// The VDSO applies the offset itself, so that the monotonic clock
+	// parameters describe the host clock alone. CLOCK_BOOTTIME is the same
+	// as CLOCK_MONOTONIC, since the sandbox is never suspended; time spent
+	// saved is already included in monotonicOffset.
+	if err := t.params.SetTimens(vdsoTimens{
+		monotonicOffset: t.monotonicOffset,
+		boottimeOffset:  t.monotonicOffset,
+	}); err != nil {
+		panic("unable to set VDSO clock offsets: " + err.Error())
+	}
+
 	if t.restored == nil {
 		// Hold on to the initial "boot" time.
 		t.bootTime = ktime.FromNanoseconds(nowRealtime)
@@ -198,18 +245,24 @@ func (t *Timekeeper) startUpdater() {
 
 				var p vdsoParams
 				if monotonicOk {
-					p.monotonicReady = 1
-					p.monotonicBaseCycles = int64(monotonicParams.BaseCycles)
-					p.monotonicBaseRef = int64(monotonicParams.BaseRef) + t.monotonicOffset
-					p.monotonicFrequency = monotonicParams.Frequency
+					p.monotonic.ready = 1
+					p.monotonic.baseCycles = int64(monotonicParams.BaseCycles)
+					p.monotonic.baseRef = int64(monotonicParams.BaseRef)
+					p.monotonic.mult, p.monotonic.shift = cyclesToNSParams(monotonicParams.Frequency)
 				}
+				atomic.StoreUint64(&t.cyclesMult, p.monotonic.mult)
 				if realtimeOk {
-					p.realtimeReady = 1
-					p.realtimeBaseCycles = int64(realtimeParams.BaseCycles)
-					p.realtimeBaseRef = int64(realtimeParams.BaseRef)
-					p.realtimeFrequency = realtimeParams.Frequency
+					p.realtime.ready = 1
+					p.realtime.baseCycles = int64(realtimeParams.BaseCycles)
+					p.realtime.baseRef = int64(realtimeParams.BaseRef)
+					p.realtime.mult, p.realtime.shift = cyclesToNSParams(realtimeParams.Frequency)
 				}
 
+				p.flags.getcpuMode = atomic.LoadUint64(&t.getcpuMode)
+				p.flags.getcpuCPU = atomic.LoadUint64(&t.getcpuCPU)
+				p.flags.cycleClockMode = t.cycleClockMode
+				p.flags.spinSleepMaxNS = uint64(atomic.LoadInt64(&t.spinSleepMax))
+
 				log.Debugf("Updating VDSO parameters: %+v", p)
 
 				return p
@@ -227,6 +280,62 @@ func (t *Timekeeper) startUpdater() {
 	}()
 }
 
+// setGetcpu sets the getcpu(2) parameters published to the VDSO. They take
+// effect at the next parameter update.
+func (t *Timekeeper) setGetcpu(mode, cpu uint64) {
+	atomic.StoreUint64(&t.getcpuCPU, cpu)
+	atomic.StoreUint64(&t.getcpuMode, mode)
+}
+
+// SetVDSOSpinSleep sets the longest sleep that the VDSO performs by spinning
+// on the clock rather than by trapping to the sandbox kernel. Spinning is
+// disabled if max is not positive. It takes effect at the next parameter
+// update.
+func (t *Timekeeper) SetVDSOSpinSleep(max time.Duration) {
+	if max < 0 {
+		max = 0
+	}
+	atomic.StoreInt64(&t.spinSleepMax, max.Nanoseconds())
+}
+
+// setVDSOThreadCPUTime sets whether tasks may publish their CPU clocks to the
+// VDSO.
+func (t *Timekeeper) setVDSOThreadCPUTime(enabled bool) {
+	var v uint32
+	if enabled {
+		v = 1
+	}
+	atomic.StoreUint32(&t.threadCPUTime, v)
+}
+
+// vdsoThreadCPUTime returns true if tasks may publish their CPU clocks to the
+// VDSO.
+func (t *Timekeeper) vdsoThreadCPUTime() bool {
+	return atomic.LoadUint32(&t.threadCPUTime) != 0
+}
+
+// vdsoCyclesMult returns the multiplier converting cycles to nanoseconds, with
+// shift vdsoCyclesShift, or 0 if it is unknown.
+func (t *Timekeeper) vdsoCyclesMult() uint64 {
+	return atomic.LoadUint64(&t.cyclesMult)
+}
+
+// setSchedContended publishes to the VDSO whether tasks may be waiting to
+// run. Calls to setSchedContended must be serialized.
+func (t *Timekeeper) setSchedContended(contended bool) {
+	if err := t.params.SetSchedContended(contended); err != nil {
+		log.Warningf("Unable to update VDSO sched parameters: %v", err)
+	}
+}
+
+// setInfo publishes system information to the VDSO. Calls to setInfo must be
+// serialized.
+func (t *Timekeeper) setInfo(info vdsoInfo) {
+	if err := t.params.SetInfo(info); err != nil {
+		log.Warningf("Unable to update VDSO info parameters: %v", err)
+	}
+}
+
 // stopUpdater stops the update goroutine, blocking until it exits.
 //
 // mu must be held.
@@ -0,0 +1,86 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package userfaultfd provides an implementation of userfaultfd(2) files.
+package userfaultfd
+
+import (
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/fs"
+	"gvisor.dev/gvisor/pkg/sentry/fs/anon"
+	"gvisor.dev/gvisor/pkg/sentry/fs/fsutil"
+	"gvisor.dev/gvisor/pkg/sentry/mm"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// UserfaultOperations represent a file with userfaultfd semantics.
+//
+// +stateify savable
+type UserfaultOperations struct {
+	fsutil.FilePipeSeek             `state:"nosave"`
+	fsutil.FileNotDirReaddir        `state:"nosave"`
+	fsutil.FileNoFsync              `state:"nosave"`
+	fsutil.FileNoMMap               `state:"nosave"`
+	fsutil.FileNoSplice             `state:"nosave"`
+	fsutil.FileNoWrite              `state:"nosave"`
+	fsutil.FileNoopFlush            `state:"nosave"`
+	fsutil.FileUseInodeUnstableAttr `state:"nosave"`
+
+	// uffd reports faults in the MemoryManager of the task that created the
+	// file.
+	uffd *mm.Userfaultfd
+}
+
+// New creates a new userfaultfd reporting faults in m.
+func New(ctx context.Context, m *mm.MemoryManager) *fs.File {
+	// name matches fs/userfaultfd.c:SYSCALL_DEFINE1(userfaultfd).
+	dirent := fs.NewDirent(ctx, anon.NewInode(ctx), "anon_inode:[userfaultfd]")
+	// Release the initial dirent reference after NewFile takes a reference.
+	defer dirent.DecRef()
+	return fs.NewFile(ctx, dirent, fs.FileFlags{Read: true, Write: true}, &UserfaultOperations{
+		uffd: mm.NewUserfaultfd(m),
+	})
+}
+
+// Release implements fs.FileOperations.Release.
+func (u *UserfaultOperations) Release() {
+	u.uffd.Release()
+}
+
+// Read implements fs.FileOperations.Read.
+func (u *UserfaultOperations) Read(ctx context.Context, _ *fs.File, dst usermem.IOSequence, _ int64) (int64, error) {
+	return u.uffd.Read(ctx, dst)
+}
+
+// Ioctl implements fs.FileOperations.Ioctl.
+func (u *UserfaultOperations) Ioctl(ctx context.Context, _ *fs.File, io usermem.IO, args arch.SyscallArguments) (uintptr, error) {
+	return u.uffd.Ioctl(ctx, io, args)
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (u *UserfaultOperations) Readiness(mask waiter.EventMask) waiter.EventMask {
+	return u.uffd.Readiness(mask)
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (u *UserfaultOperations) EventRegister(e *waiter.Entry, mask waiter.EventMask) {
+	u.uffd.EventRegister(e, mask)
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (u *UserfaultOperations) EventUnregister(e *waiter.Entry) {
+	u.uffd.EventUnregister(e)
+}
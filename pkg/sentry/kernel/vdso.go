@@ -16,6 +16,7 @@ package kernel
 
 import (
 	"fmt"
+	"time"
 
 	"gvisor.dev/gvisor/pkg/binary"
 	"gvisor.dev/gvisor/pkg/safemem"
@@ -27,17 +28,138 @@ import (
 // vdsoParams are the parameters exposed to the VDSO.
 //
 // They are exposed to the VDSO via a parameter page managed by VDSOParamPage,
-// which also includes a sequence counter.
+// which also includes a sequence counter for each section.
+//
+// Rather than the cycle clock frequency, the VDSO is given a multiplier and
+// shift computed by cyclesToNSParams, so that converting cycles to
+// nanoseconds does not require a division.
+//
+// +stateify savable
 type vdsoParams struct {
-	monotonicReady      uint64
-	monotonicBaseCycles int64
-	monotonicBaseRef    int64
-	monotonicFrequency  uint64
+	monotonic vdsoClockParams
+	realtime  vdsoClockParams
+	flags     vdsoFlags
+}
 
-	realtimeReady      uint64
-	realtimeBaseCycles int64
-	realtimeBaseRef    int64
-	realtimeFrequency  uint64
+// vdsoClockParams are the parameters of a single clock.
+//
+// +stateify savable
+type vdsoClockParams struct {
+	ready      uint64
+	baseCycles int64
+	baseRef    int64
+	mult       uint64
+	shift      uint64
+}
+
+// vdsoFlags are the parameters that are not specific to a clock. They change
+// rarely, if ever, after the clocks are set.
+//
+// +stateify savable
+type vdsoFlags struct {
+	// getcpuMode is one of the vdsoGetcpu* constants below, and determines
+	// how the VDSO answers getcpu(2).
+	getcpuMode uint64
+	getcpuCPU  uint64
+
+	// cycleClockMode selects the cycle clock implementation used by the
+	// VDSO. See vdsoCycleClockMode.
+	cycleClockMode uint64
+
+	// spinSleepMaxNS is the longest sleep, in nanoseconds, that the VDSO
+	// performs by spinning on the clock rather than by trapping to the
+	// sandbox kernel. If zero, the VDSO never spins.
+	spinSleepMaxNS uint64
+}
+
+// vdsoInfo is system information that applications otherwise query with
+// system calls. It is the same for all tasks, and changes rarely, if ever,
+// after the Kernel is initialized.
+//
+// +stateify savable
+type vdsoInfo struct {
+	// cpus is the number of CPUs visible to applications, as returned by
+	// get_nprocs(3).
+	cpus uint64
+
+	// threadClockEpoch is the epoch of valid records in VDSO thread clock
+	// pages. See Kernel.vdsoThreadClockEpoch.
+	threadClockEpoch uint64
+}
+
+// vdsoTimens are the offsets of the application's CLOCK_MONOTONIC and
+// CLOCK_BOOTTIME from the monotonic clock in vdsoParams, as with the clock
+// offsets of a Linux time namespace. They are only changed when the clocks are
+// set, while no tasks are running.
+//
+// +stateify savable
+type vdsoTimens struct {
+	monotonicOffset int64
+	boottimeOffset  int64
+}
+
+// Possible values of vdsoFlags.getcpuMode.
+//
+// These must be kept in sync with kGetcpu* in vdso/vdso_time.cc.
+const (
+	// vdsoGetcpuSyscall indicates that the VDSO must invoke getcpu(2).
+	vdsoGetcpuSyscall = 0
+
+	// vdsoGetcpuFixed indicates that all tasks run on CPU
+	// vdsoFlags.getcpuCPU.
+	vdsoGetcpuFixed = 1
+
+	// vdsoGetcpuTSCAux indicates that Task.CPU() is the host CPU, and that
+	// the VDSO may read it from IA32_TSC_AUX using RDTSCP.
+	vdsoGetcpuTSCAux = 2
+)
+
+// vdsoCyclesShift is the shift used for all VDSO cycles to nanoseconds
+// conversions.
+//
+// For any frequency above 1Hz, (NanosecondsPerSecond << 32) / frequency fits
+// in 64 bits, and 32 bits of fraction bound the conversion error to less than
+// a nanosecond per (2^32 / frequency) seconds of cycles.
+const vdsoCyclesShift = 32
+
+// cyclesToNSParams returns the multiplier and shift that the VDSO uses to
+// convert cycles of a clock running at frequency to nanoseconds:
+//
+// ns = (cycles * mult) >> shift
+//
+// The multiplication is performed with 128-bit intermediate precision.
+func cyclesToNSParams(frequency uint64) (mult, shift uint64) {
+	if frequency == 0 {
+		return 0, 0
+	}
+	return (uint64(time.Second.Nanoseconds()) << vdsoCyclesShift) / frequency, vdsoCyclesShift
+}
+
+// vdsoSection identifies a section of the parameter page.
+type vdsoSection int
+
+// Sections of the parameter page.
+const (
+	vdsoFlagsSection vdsoSection = iota
+	vdsoMonotonicSection
+	vdsoRealtimeSection
+	vdsoSchedSection
+	vdsoInfoSection
+	vdsoTimensSection
+
+	vdsoSections
+)
+
+// vdsoSectionSize is the size and alignment of each section of the parameter
+// page, which is the cache line size.
+//
+// Each section has its own sequence counter, so that writing one section does
+// not invalidate the cache lines read by VDSO users of the others.
+const vdsoSectionSize = 64
+
+// offset returns the offset of the section into the parameter page.
+func (s vdsoSection) offset() uint64 {
+	return uint64(s) * vdsoSectionSize
 }
 
 // VDSOParamPage manages a VDSO parameter page.
@@ -45,12 +167,40 @@ type vdsoParams struct {
 // Its memory layout looks like:
 //
 // type page struct {
-//	// seq is a sequence counter that protects the fields below.
-//	seq uint64
-//	vdsoParams
+//	flags struct {
+//		// seq is a sequence counter that protects the fields below.
+//		seq uint64
+//		vdsoFlags
+//	}
+//	monotonic struct {
+//		seq uint64
+//		vdsoClockParams
+//	}
+//	realtime struct {
+//		seq uint64
+//		vdsoClockParams
+//	}
+//	sched struct {
+//		// contended is non-zero if tasks may be waiting to run, such
+//		// that sched_yield(2) may allow another task to run. It is a
+//		// single word, so its sequence counter is unused.
+//		seq       uint64
+//		contended uint64
+//	}
+//	info struct {
+//		seq uint64
+//		vdsoInfo
+//	}
+//	timens struct {
+//		// Offsets only change while no tasks are running, so the
+//		// sequence counter is unused by the VDSO.
+//		seq uint64
+//		vdsoTimens
+//	}
 // }
 //
-// Everything in the struct is 8 bytes for easy alignment.
+// Each struct is aligned to vdsoSectionSize, and everything in the structs is
+// 8 bytes for easy alignment.
 //
 // It must be kept in sync with params in vdso/vdso_time.cc.
 //
@@ -60,14 +210,30 @@ type VDSOParamPage struct {
 	mfp pgalloc.MemoryFileProvider
 	fr  platform.FileRange
 
-	// seq is the current sequence count written to the page.
+	// seq is the current sequence count written to each section of the
+	// page.
 	//
 	// A write is in progress if bit 1 of the counter is set.
 	//
 	// Timekeeper's updater goroutine may call Write before equality is
 	// checked in state_test_util tests, causing this field to change across
 	// save / restore.
-	seq uint64
+	seq [vdsoSections]uint64
+
+	// last is the last set of parameters written to the page. Sections that
+	// have not changed since are not rewritten.
+	last vdsoParams
+
+	// schedContended is the last value written to the sched section by
+	// SetSchedContended.
+	schedContended bool
+
+	// info is the last value written to the info section by SetInfo.
+	info vdsoInfo
+
+	// timens is the last value written to the timens section by
+	// SetTimens.
+	timens vdsoTimens
 }
 
 // NewVDSOParamPage returns a VDSOParamPage.
@@ -97,26 +263,48 @@ func (v *VDSOParamPage) access() (safemem.Block, error) {
 	return bs.Head(), nil
 }
 
-// incrementSeq increments the sequence counter in the param page.
-func (v *VDSOParamPage) incrementSeq(paramPage safemem.Block) error {
-	next := v.seq + 1
-	old, err := safemem.SwapUint64(paramPage, next)
+// incrementSeq increments the sequence counter of section s in the param
+// page.
+func (v *VDSOParamPage) incrementSeq(paramPage safemem.Block, s vdsoSection) error {
+	next := v.seq[s] + 1
+	old, err := safemem.SwapUint64(paramPage.DropFirst64(s.offset()), next)
 	if err != nil {
 		return err
 	}
 
-	if old != v.seq {
-		return fmt.Errorf("unexpected VDSOParamPage seq value: got %d expected %d. Application may hang or get incorrect time from the VDSO.", old, v.seq)
+	if old != v.seq[s] {
+		return fmt.Errorf("unexpected VDSOParamPage seq value for section %d: got %d expected %d. Application may hang or get incorrect time from the VDSO.", s, old, v.seq[s])
 	}
 
-	v.seq = next
+	v.seq[s] = next
 	return nil
 }
 
+// writeBegin starts a write block on section s.
+func (v *VDSOParamPage) writeBegin(paramPage safemem.Block, s vdsoSection) error {
+	next := v.seq[s] + 1
+	if next%2 != 1 {
+		panic("Out-of-order sequence count")
+	}
+	return v.incrementSeq(paramPage, s)
+}
+
+// writeSection writes the parameters p to section s. It must be called within
+// a write block on s.
+func (v *VDSOParamPage) writeSection(paramPage safemem.Block, s vdsoSection, p interface{}) {
+	buf := binary.Marshal(nil, usermem.ByteOrder, p)
+
+	// Skip the sequence counter.
+	if _, err := safemem.Copy(paramPage.DropFirst64(s.offset()+8), safemem.BlockFromSafeSlice(buf)); err != nil {
+		panic(fmt.Sprintf("Unable to get set VDSO parameters: %v", err))
+	}
+}
+
 // Write updates the VDSO parameters.
 //
-// Write starts a write block, calls f to get the new parameters, writes
-// out the new parameters, then ends the write block.
+// Write starts a write block on both clocks, calls f to get the new
+// parameters, writes out the clocks whose parameters changed, then ends the
+// write blocks. The flags section is only written if the flags changed.
 func (v *VDSOParamPage) Write(f func() vdsoParams) error {
 	paramPage, err := v.access()
 	if err != nil {
@@ -124,25 +312,112 @@ func (v *VDSOParamPage) Write(f func() vdsoParams) error {
 	}
 
 	// Write begin.
-	next := v.seq + 1
-	if next%2 != 1 {
-		panic("Out-of-order sequence count")
+	//
+	// Both clocks must be in a write block while f runs, as f may update
+	// the clocks used by the sandbox kernel.
+	if err := v.writeBegin(paramPage, vdsoMonotonicSection); err != nil {
+		return err
 	}
-
-	err = v.incrementSeq(paramPage)
-	if err != nil {
+	if err := v.writeBegin(paramPage, vdsoRealtimeSection); err != nil {
 		return err
 	}
 
 	// Get the new params.
 	p := f()
-	buf := binary.Marshal(nil, usermem.ByteOrder, p)
 
-	// Skip the sequence counter.
-	if _, err := safemem.Copy(paramPage.DropFirst(8), safemem.BlockFromSafeSlice(buf)); err != nil {
-		panic(fmt.Sprintf("Unable to get set VDSO parameters: %v", err))
+	if p.monotonic != v.last.monotonic {
+		v.writeSection(paramPage, vdsoMonotonicSection, p.monotonic)
+	}
+	if p.realtime != v.last.realtime {
+		v.writeSection(paramPage, vdsoRealtimeSection, p.realtime)
 	}
 
 	// Write end.
-	return v.incrementSeq(paramPage)
+	if err := v.incrementSeq(paramPage, vdsoMonotonicSection); err != nil {
+		return err
+	}
+	if err := v.incrementSeq(paramPage, vdsoRealtimeSection); err != nil {
+		return err
+	}
+
+	if p.flags != v.last.flags {
+		if err := v.writeBegin(paramPage, vdsoFlagsSection); err != nil {
+			return err
+		}
+		v.writeSection(paramPage, vdsoFlagsSection, p.flags)
+		if err := v.incrementSeq(paramPage, vdsoFlagsSection); err != nil {
+			return err
+		}
+	}
+
+	v.last = p
+	return nil
+}
+
+// SetSchedContended updates the sched section of the page to indicate whether
+// tasks may be waiting to run.
+//
+// SetSchedContended is independent of Write, but calls to SetSchedContended
+// must be serialized.
+func (v *VDSOParamPage) SetSchedContended(contended bool) error {
+	if contended == v.schedContended {
+		return nil
+	}
+	paramPage, err := v.access()
+	if err != nil {
+		return err
+	}
+	var val uint64
+	if contended {
+		val = 1
+	}
+	if _, err := safemem.SwapUint64(paramPage.DropFirst64(vdsoSchedSection.offset()+8), val); err != nil {
+		return err
+	}
+	v.schedContended = contended
+	return nil
+}
+
+// SetInfo updates the info section of the page.
+//
+// SetInfo is independent of Write, but calls to SetInfo must be serialized.
+func (v *VDSOParamPage) SetInfo(info vdsoInfo) error {
+	if info == v.info {
+		return nil
+	}
+	paramPage, err := v.access()
+	if err != nil {
+		return err
+	}
+	if err := v.writeBegin(paramPage, vdsoInfoSection); err != nil {
+		return err
+	}
+	v.writeSection(paramPage, vdsoInfoSection, info)
+	if err := v.incrementSeq(paramPage, vdsoInfoSection); err != nil {
+		return err
+	}
+	v.info = info
+	return nil
+}
+
+// SetTimens updates the timens section of the page.
+//
+// SetTimens is independent of Write, but calls to SetTimens must be serialized.
+func (v *VDSOParamPage) SetTimens(timens vdsoTimens) error {
+	if timens == v.timens {
+		return nil
+	}
+	paramPage, err := v.access()
+	if err != nil {
+		return err
+	}
+	if err := v.writeBegin(paramPage, vdsoTimensSection); err != nil {
+		return err
+	}
+	v.writeSection(paramPage, vdsoTimensSection, timens)
+	if err := v.incrementSeq(paramPage, vdsoTimensSection); err != nil {
+		return err
+	}
+	v.timens = timens
+	return nil
 }
@@ -0,0 +1,56 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// +build amd64
+
+package kernel
+
+import (
+	"gvisor.dev/gvisor/pkg/cpuid"
+)
+
+// Possible values of vdsoFlags.cycleClockMode.
+//
+// These must be kept in sync with kCycleClock* in vdso/cycle_clock.h.
+const (
+	// vdsoCycleClockLFence orders RDTSC with a preceding LFENCE, which is
+	// sufficient on Intel, and on AMD family 10h and later, where Linux
+	// makes LFENCE dispatch serializing.
+	vdsoCycleClockLFence = 0
+
+	// vdsoCycleClockMFence orders RDTSC with a preceding MFENCE.
+	vdsoCycleClockMFence = 1
+
+	// vdsoCycleClockRDTSCP uses RDTSCP, which waits for all prior
+	// instructions without a separate fence.
+	vdsoCycleClockRDTSCP = 2
+)
+
+// vdsoCycleClockMode returns the cycle clock implementation that the VDSO
+// should use on this host. It follows the preference order of Linux's
+// rdtsc_ordered().
+func vdsoCycleClockMode() uint64 {
+	fs := cpuid.HostFeatureSet()
+	if fs.HasFeature(cpuid.X86FeatureRDTSCP) {
+		return vdsoCycleClockRDTSCP
+	}
+	family := fs.Family
+	if family == 0xf {
+		family += fs.ExtendedFamily
+	}
+	if fs.AMD() && family < 0x10 {
+		return vdsoCycleClockMFence
+	}
+	return vdsoCycleClockLFence
+}
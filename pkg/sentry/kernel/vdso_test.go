@@ -0,0 +1,274 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"math/big"
+	"testing"
+	"time"
+
+	"gvisor.dev/gvisor/pkg/binary"
+	"gvisor.dev/gvisor/pkg/sentry/contexttest"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
+	"gvisor.dev/gvisor/pkg/usermem"
+)
+
+// TestCyclesToNSParams checks that the VDSO's multiply and shift conversion
+// agrees with an exact division by the frequency.
+func TestCyclesToNSParams(t *testing.T) {
+	for _, frequency := range []uint64{
+		19200000,   // Common arm64 generic timer.
+		100000000,  // Common arm64 generic timer.
+		1000000000, // 1GHz.
+		2593992000, // Typical x86 TSC.
+		4000000000, // Fast x86 TSC.
+	} {
+		mult, shift := cyclesToNSParams(frequency)
+		// Cover more than the update interval, as updates may be late.
+		for _, cycles := range []uint64{0, 1, frequency / 1000, frequency, 10 * frequency} {
+			got := new(big.Int).SetUint64(cycles)
+			got.Mul(got, new(big.Int).SetUint64(mult))
+			got.Rsh(got, uint(shift))
+
+			want := new(big.Int).SetUint64(cycles)
+			want.Mul(want, big.NewInt(time.Second.Nanoseconds()))
+			want.Div(want, new(big.Int).SetUint64(frequency))
+
+			diff := new(big.Int).Sub(want, got)
+			if diff.Sign() < 0 || diff.Cmp(big.NewInt(int64(cycles/frequency)+1)) > 0 {
+				t.Errorf("frequency %d cycles %d: got %v ns, want %v ns", frequency, cycles, got, want)
+			}
+		}
+	}
+}
+
+// TestCyclesToNSParamsNotReady checks that a zero (not calibrated) frequency
+// does not panic.
+func TestCyclesToNSParamsNotReady(t *testing.T) {
+	if mult, shift := cyclesToNSParams(0); mult != 0 || shift != 0 {
+		t.Errorf("cyclesToNSParams(0) = %d, %d, want 0, 0", mult, shift)
+	}
+}
+
+// TestVDSOParamSectionSize checks that each section of the parameter page,
+// including its sequence counter, fits in a single cache line.
+func TestVDSOParamSectionSize(t *testing.T) {
+	for _, tc := range []struct {
+		name   string
+		params interface{}
+	}{
+		{"flags", vdsoFlags{}},
+		{"clock", vdsoClockParams{}},
+	} {
+		if size := 8 + binary.Size(tc.params); size > vdsoSectionSize {
+			t.Errorf("%s section is %d bytes, want at most %d", tc.name, size, vdsoSectionSize)
+		}
+	}
+}
+
+// TestVDSOParamPageWriteChanged checks that Write only rewrites the flags
+// section when the flags change.
+func TestVDSOParamPageWriteChanged(t *testing.T) {
+	ctx := contexttest.Context(t)
+	mfp := pgalloc.MemoryFileProviderFromContext(ctx)
+	fr, err := mfp.MemoryFile().Allocate(usermem.PageSize, usage.Anonymous)
+	if err != nil {
+		t.Fatalf("failed to allocate memory: %v", err)
+	}
+	v := NewVDSOParamPage(mfp, fr)
+
+	readSeq := func(s vdsoSection) uint64 {
+		b, err := v.access()
+		if err != nil {
+			t.Fatalf("access failed: %v", err)
+		}
+		return usermem.ByteOrder.Uint64(b.ToSlice()[s.offset():])
+	}
+
+	p := vdsoParams{
+		monotonic: vdsoClockParams{ready: 1, baseRef: 1},
+		realtime:  vdsoClockParams{ready: 1, baseRef: 2},
+		flags:     vdsoFlags{getcpuMode: vdsoGetcpuFixed},
+	}
+	for i, want := range []struct {
+		flags, monotonic, realtime uint64
+	}{
+		// The first write changes every section.
+		{flags: 2, monotonic: 2, realtime: 2},
+		// Only the clocks are written without changes to the flags.
+		{flags: 2, monotonic: 4, realtime: 4},
+	} {
+		if err := v.Write(func() vdsoParams { return p }); err != nil {
+			t.Fatalf("Write #%d failed: %v", i, err)
+		}
+		if got := readSeq(vdsoFlagsSection); got != want.flags {
+			t.Errorf("Write #%d: flags seq got %d want %d", i, got, want.flags)
+		}
+		if got := readSeq(vdsoMonotonicSection); got != want.monotonic {
+			t.Errorf("Write #%d: monotonic seq got %d want %d", i, got, want.monotonic)
+		}
+		if got := readSeq(vdsoRealtimeSection); got != want.realtime {
+			t.Errorf("Write #%d: realtime seq got %d want %d", i, got, want.realtime)
+		}
+	}
+}
+
+// TestVDSOParamPageSetSchedContended checks that SetSchedContended writes the
+// sched section without touching the clock sections.
+func TestVDSOParamPageSetSchedContended(t *testing.T) {
+	ctx := contexttest.Context(t)
+	mfp := pgalloc.MemoryFileProviderFromContext(ctx)
+	fr, err := mfp.MemoryFile().Allocate(usermem.PageSize, usage.Anonymous)
+	if err != nil {
+		t.Fatalf("failed to allocate memory: %v", err)
+	}
+	v := NewVDSOParamPage(mfp, fr)
+
+	readWord := func(off uint64) uint64 {
+		b, err := v.access()
+		if err != nil {
+			t.Fatalf("access failed: %v", err)
+		}
+		return usermem.ByteOrder.Uint64(b.ToSlice()[off:])
+	}
+
+	for _, contended := range []bool{true, true, false} {
+		if err := v.SetSchedContended(contended); err != nil {
+			t.Fatalf("SetSchedContended(%t) failed: %v", contended, err)
+		}
+		var want uint64
+		if contended {
+			want = 1
+		}
+		if got := readWord(vdsoSchedSection.offset() + 8); got != want {
+			t.Errorf("SetSchedContended(%t): contended got %d want %d", contended, got, want)
+		}
+		if got := readWord(vdsoMonotonicSection.offset()); got != 0 {
+			t.Errorf("SetSchedContended(%t): monotonic seq got %d want 0", contended, got)
+		}
+	}
+}
+
+// TestVDSOParamPageSetInfo checks that SetInfo writes the info section within
+// a write block, and only when the information changes.
+func TestVDSOParamPageSetInfo(t *testing.T) {
+	ctx := contexttest.Context(t)
+	mfp := pgalloc.MemoryFileProviderFromContext(ctx)
+	fr, err := mfp.MemoryFile().Allocate(usermem.PageSize, usage.Anonymous)
+	if err != nil {
+		t.Fatalf("failed to allocate memory: %v", err)
+	}
+	v := NewVDSOParamPage(mfp, fr)
+
+	readWord := func(off uint64) uint64 {
+		b, err := v.access()
+		if err != nil {
+			t.Fatalf("access failed: %v", err)
+		}
+		return usermem.ByteOrder.Uint64(b.ToSlice()[off:])
+	}
+
+	for i, tc := range []struct {
+		cpus    uint64
+		wantSeq uint64
+	}{
+		{cpus: 4, wantSeq: 2},
+		{cpus: 4, wantSeq: 2},
+		{cpus: 8, wantSeq: 4},
+	} {
+		if err := v.SetInfo(vdsoInfo{cpus: tc.cpus}); err != nil {
+			t.Fatalf("SetInfo #%d failed: %v", i, err)
+		}
+		if got := readWord(vdsoInfoSection.offset() + 8); got != tc.cpus {
+			t.Errorf("SetInfo #%d: cpus got %d want %d", i, got, tc.cpus)
+		}
+		if got := readWord(vdsoInfoSection.offset()); got != tc.wantSeq {
+			t.Errorf("SetInfo #%d: seq got %d want %d", i, got, tc.wantSeq)
+		}
+		if got := readWord(vdsoFlagsSection.offset()); got != 0 {
+			t.Errorf("SetInfo #%d: flags seq got %d want 0", i, got)
+		}
+	}
+}
+
+// TestVDSOParamPageSetTimens checks that SetTimens writes the offsets to the
+// timens section, where the VDSO expects them.
+func TestVDSOParamPageSetTimens(t *testing.T) {
+	ctx := contexttest.Context(t)
+	mfp := pgalloc.MemoryFileProviderFromContext(ctx)
+	fr, err := mfp.MemoryFile().Allocate(usermem.PageSize, usage.Anonymous)
+	if err != nil {
+		t.Fatalf("failed to allocate memory: %v", err)
+	}
+	v := NewVDSOParamPage(mfp, fr)
+
+	want := vdsoTimens{monotonicOffset: -5, boottimeOffset: 7}
+	if err := v.SetTimens(want); err != nil {
+		t.Fatalf("SetTimens failed: %v", err)
+	}
+	b, err := v.access()
+	if err != nil {
+		t.Fatalf("access failed: %v", err)
+	}
+	section := b.ToSlice()[vdsoTimensSection.offset():]
+	if got := int64(usermem.ByteOrder.Uint64(section[8:])); got != want.monotonicOffset {
+		t.Errorf("monotonic offset got %d want %d", got, want.monotonicOffset)
+	}
+	if got := int64(usermem.ByteOrder.Uint64(section[16:])); got != want.boottimeOffset {
+		t.Errorf("boottime offset got %d want %d", got, want.boottimeOffset)
+	}
+	if got := vdsoTimensSection.offset(); got != 320 {
+		t.Errorf("timens section offset got %d want 320", got)
+	}
+}
+
+// TestVDSOThreadClockLayout checks that each record fits in its slot of the
+// VDSO thread clock page, and that a thread pointer's probes are distinct.
+func TestVDSOThreadClockLayout(t *testing.T) {
+	if size := binary.Size(vdsoThreadClock{}); size > vdsoThreadClockSize {
+		t.Errorf("vdsoThreadClock size got %d want <= %d", size, vdsoThreadClockSize)
+	}
+
+	for _, tls := range []uint64{0x7f0000001000, 0x7f0000001700, 0x7fffffffe040} {
+		seen := make(map[int]bool)
+		for probe := 0; probe < vdsoThreadClockProbes; probe++ {
+			slot := vdsoThreadClockSlot(tls, probe)
+			if slot < 0 || slot >= usermem.PageSize/vdsoThreadClockSize {
+				t.Errorf("vdsoThreadClockSlot(%#x, %d) got %d, out of range", tls, probe, slot)
+			}
+			if seen[slot] {
+				t.Errorf("vdsoThreadClockSlot(%#x, %d) got %d, already probed", tls, probe, slot)
+			}
+			seen[slot] = true
+		}
+	}
+}
+
+// TestVDSOCyclesToNS checks that vdsoCyclesToNS agrees with the conversion
+// parameters, including for cycle counts whose product overflows 64 bits.
+func TestVDSOCyclesToNS(t *testing.T) {
+	mult, _ := cyclesToNSParams(1000000000)
+	for _, cycles := range []int64{-1, 0, 1000, 1 << 40} {
+		want := cycles
+		if want < 0 {
+			want = 0
+		}
+		// mult may be rounded down by a part in 2^32.
+		if got := vdsoCyclesToNS(mult, cycles); got > want || got < want-want>>31-1 {
+			t.Errorf("vdsoCyclesToNS(%d, %d) got %d want ~%d", mult, cycles, got, want)
+		}
+	}
+}
@@ -0,0 +1,275 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package kernel
+
+import (
+	"math/bits"
+	"time"
+
+	"gvisor.dev/gvisor/pkg/binary"
+	"gvisor.dev/gvisor/pkg/sentry/mm"
+	sentrytime "gvisor.dev/gvisor/pkg/sentry/time"
+	"gvisor.dev/gvisor/pkg/usermem"
+)
+
+// vdsoThreadClock is a record of the CPU clock of one task in the VDSO thread
+// clock page of its MemoryManager.
+//
+// A task's record is only written by its task goroutine, while the task is not
+// executing application code, so that the VDSO needs no sequence counter to
+// read it.
+//
+// It must be kept in sync with struct thread_clock in vdso/vdso_time.cc.
+type vdsoThreadClock struct {
+	// tls is the task's thread pointer, by which the VDSO finds the calling
+	// thread's record.
+	tls uint64
+
+	// tid is the task's thread ID in its own PID namespace, which is encoded
+	// in the clock IDs returned by pthread_getcpuclockid(3).
+	tid uint64
+
+	// epoch is the Kernel.vdsoThreadClockEpoch in which the record was
+	// written.
+	epoch uint64
+
+	// The task's CPU time was baseNS at baseCycles, and advances with the
+	// cycle counter, converted to nanoseconds with mult and shift.
+	baseNS     int64
+	baseCycles int64
+	mult       uint64
+	shift      uint64
+}
+
+// vdsoThreadClockSize is the size and alignment of each record in the VDSO
+// thread clock page, which is the cache line size.
+const vdsoThreadClockSize = usermem.PageSize / mm.VDSOThreadClocks
+
+// vdsoThreadClockProbes is the number of records that may hold a task's clock.
+//
+// It must be kept in sync with kThreadClockProbes in vdso/vdso_time.cc.
+const vdsoThreadClockProbes = 4
+
+// vdsoThreadClockSlot returns the index of the probe'th record that may hold
+// the clock of the task with thread pointer tls.
+//
+// It must be kept in sync with thread_clock_slot in vdso/vdso_time.cc.
+func vdsoThreadClockSlot(tls uint64, probe int) int {
+	hash := (tls >> 6) * 0x9e3779b97f4a7c15
+	return int((hash>>58 + uint64(probe)) & (mm.VDSOThreadClocks - 1))
+}
+
+// vdsoCyclesToNS converts cycles to nanoseconds with multiplier mult and shift
+// vdsoCyclesShift, as cycles_to_ns does in the VDSO.
+func vdsoCyclesToNS(mult uint64, cycles int64) int64 {
+	if cycles <= 0 {
+		return 0
+	}
+	hi, lo := bits.Mul64(uint64(cycles), mult)
+	return int64(hi<<(64-vdsoCyclesShift) | lo>>vdsoCyclesShift)
+}
+
+// taskVDSOThreadClock is the state of a task's CPU clock published to the
+// VDSO.
+//
+// A task's clock is registered the first time the task reads it with
+// clock_gettime(2), after which the task's CPU time is measured with the cycle
+// counter rather than sampled at CPU clock ticks. It is considered to advance
+// whenever the task goroutine is not blocked or stopped, as with
+// TaskGoroutineSchedInfo.
+type taskVDSOThreadClock struct {
+	// registered is true if the task's clock is measured with the cycle
+	// counter. All other fields are only meaningful if registered is true.
+	registered bool
+
+	// slot is the index of the task's record in its MemoryManager's VDSO
+	// thread clock page, or -1 if it has none.
+	slot int
+
+	// owner identifies the task to its MemoryManager as the owner of slot,
+	// for mm.MemoryManager.ClaimVDSOThreadClock.
+	owner uint64
+
+	// tls is the thread pointer that the task's clock was last published
+	// for.
+	tls uint64
+
+	// If running is true, the task's CPU time was ns at cycles. Otherwise,
+	// the task's CPU time is ns.
+	ns      int64
+	cycles  int64
+	mult    uint64
+	running bool
+
+	// dirty is true if the task's record must be rewritten before it next
+	// executes application code.
+	dirty bool
+}
+
+// ThreadCPUClock returns t's precise CPU time, and begins publishing t's CPU
+// clock to the VDSO so that subsequent reads need not make a system call. It
+// returns false if precise CPU time is unavailable, in which case callers
+// should use t.CPUStats().
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (t *Task) ThreadCPUClock() (time.Duration, bool) {
+	if !t.k.timekeeper.vdsoThreadCPUTime() {
+		return 0, false
+	}
+	c := &t.vdsoClock
+	if !c.registered {
+		mult := t.k.timekeeper.vdsoCyclesMult()
+		if mult == 0 {
+			return 0, false
+		}
+		// Continue from the CPU time sampled so far, so that the clock
+		// never goes backwards.
+		stats := t.CPUStats()
+		*c = taskVDSOThreadClock{
+			registered: true,
+			slot:       -1,
+			ns:         (stats.UserTime + stats.SysTime).Nanoseconds(),
+			cycles:     int64(sentrytime.Rdtsc()),
+			mult:       mult,
+			running:    true,
+			dirty:      true,
+		}
+	}
+	return time.Duration(c.ns + vdsoCyclesToNS(c.mult, int64(sentrytime.Rdtsc())-c.cycles)), true
+}
+
+// pauseVDSOThreadClock stops t's CPU clock when t blocks or stops.
+//
+// Preconditions: The caller must be running on the task goroutine.
+// t.vdsoClock.registered must be true.
+func (t *Task) pauseVDSOThreadClock() {
+	c := &t.vdsoClock
+	if !c.running {
+		return
+	}
+	c.ns += vdsoCyclesToNS(c.mult, int64(sentrytime.Rdtsc())-c.cycles)
+	c.running = false
+}
+
+// resumeVDSOThreadClock restarts t's CPU clock after
+// t.pauseVDSOThreadClock().
+//
+// Preconditions: The caller must be running on the task goroutine.
+// t.vdsoClock.registered must be true.
+func (t *Task) resumeVDSOThreadClock() {
+	c := &t.vdsoClock
+	if c.running {
+		return
+	}
+	// Pick up changes in the cycle counter's measured frequency.
+	if mult := t.k.timekeeper.vdsoCyclesMult(); mult != 0 {
+		c.mult = mult
+	}
+	c.cycles = int64(sentrytime.Rdtsc())
+	c.running = true
+	c.dirty = true
+}
+
+// publishVDSOThreadClock writes t's record in the VDSO thread clock page, if
+// it is out of date.
+//
+// Preconditions: The caller must be running on the task goroutine, and t must
+// not be executing application code. t.vdsoClock.registered must be true.
+func (t *Task) publishVDSOThreadClock() {
+	c := &t.vdsoClock
+	tls := uint64(t.Arch().TLS())
+	if !c.dirty && tls == c.tls {
+		return
+	}
+	c.dirty = false
+
+	if tls != c.tls {
+		// The record for the old thread pointer would otherwise be
+		// found by whichever thread uses it next.
+		t.clearVDSOThreadClock()
+		c.tls = tls
+		if tls == 0 || t.MemoryManager().VDSOThreadClocks() == 0 {
+			return
+		}
+		// The task's thread ID may change in execve(2), so the owner is
+		// determined each time a record is claimed.
+		c.owner = uint64(t.k.tasks.Root.IDOfTask(t))
+		for probe := 0; probe < vdsoThreadClockProbes; probe++ {
+			if slot := vdsoThreadClockSlot(tls, probe); t.MemoryManager().ClaimVDSOThreadClock(slot, c.owner) {
+				c.slot = slot
+				break
+			}
+		}
+	}
+	if c.slot < 0 {
+		// All records that t's thread pointer may occupy are in use;
+		// t reads its clock with clock_gettime(2).
+		return
+	}
+
+	rec := vdsoThreadClock{
+		tls:        c.tls,
+		tid:        uint64(t.ThreadID()),
+		epoch:      t.k.vdsoThreadClockEpoch,
+		baseNS:     c.ns,
+		baseCycles: c.cycles,
+		mult:       c.mult,
+		shift:      vdsoCyclesShift,
+	}
+	t.writeVDSOThreadClock(binary.Marshal(nil, usermem.ByteOrder, rec))
+}
+
+// clearVDSOThreadClock clears and releases t's record in the VDSO thread clock
+// page, if it has one.
+//
+// Preconditions: As for publishVDSOThreadClock.
+func (t *Task) clearVDSOThreadClock() {
+	c := &t.vdsoClock
+	if c.slot < 0 {
+		return
+	}
+	t.writeVDSOThreadClock(make([]byte, binary.Size(vdsoThreadClock{})))
+	t.MemoryManager().ReleaseVDSOThreadClock(c.slot, c.owner)
+	c.slot = -1
+}
+
+// writeVDSOThreadClock writes buf to t's record in the VDSO thread clock page.
+//
+// Preconditions: As for publishVDSOThreadClock. t.vdsoClock.slot >= 0.
+func (t *Task) writeVDSOThreadClock(buf []byte) {
+	addr := t.MemoryManager().VDSOThreadClocks() + usermem.Addr(t.vdsoClock.slot*vdsoThreadClockSize)
+	if _, err := t.MemoryManager().CopyOut(t, addr, buf, usermem.IOOpts{IgnorePermissions: true}); err != nil {
+		// The application unmapped the page, so the VDSO can't read the
+		// record either.
+		t.Debugf("Failed to write VDSO thread clock: %v", err)
+	}
+}
+
+// releaseVDSOThreadClock releases t's record in the VDSO thread clock page,
+// before t exits or its MemoryManager is replaced by execve(2). t's CPU clock
+// continues to be measured with the cycle counter, and is published again
+// before t next executes application code.
+//
+// Preconditions: The caller must be running on the task goroutine. t's
+// MemoryManager must not have been released.
+func (t *Task) releaseVDSOThreadClock() {
+	c := &t.vdsoClock
+	if !c.registered {
+		return
+	}
+	t.clearVDSOThreadClock()
+	c.tls = 0
+	c.dirty = true
+}
@@ -88,6 +88,12 @@ type elfInfo struct {
 
 	// sharedObject is true if the ELF represents a shared object.
 	sharedObject bool
+
+	// interpPaths maps the index in phdrs of each PT_INTERP segment with a
+	// valid size to the segment's contents. It is nil for segments that
+	// could not be read. interpPaths is read along with the headers so
+	// that the entire elfInfo can be cached.
+	interpPaths map[int][]byte
 }
 
 // parseHeader parse the ELF header, verifying that this is a supported ELF
@@ -214,6 +220,25 @@ func parseHeader(ctx context.Context, f fsbridge.File) (elfInfo, error) {
 		}
 	}
 
+	// Errors reading PT_INTERP are reported by loadParsedELF, in order
+	// with its other checks.
+	var interpPaths map[int][]byte
+	for i := range phdrs {
+		phdr := &phdrs[i]
+		if phdr.Type != elf.PT_INTERP || phdr.Filesz < 2 || phdr.Filesz > linux.PATH_MAX {
+			continue
+		}
+		if interpPaths == nil {
+			interpPaths = make(map[int][]byte)
+		}
+		path := make([]byte, phdr.Filesz)
+		if _, err := f.ReadFull(ctx, usermem.BytesIOSequence(path), int64(phdr.Off)); err != nil {
+			log.Infof("Error reading PT_INTERP path: %v", err)
+			path = nil
+		}
+		interpPaths[i] = path
+	}
+
 	return elfInfo{
 		os:           os,
 		arch:         a,
@@ -222,6 +247,7 @@ func parseHeader(ctx context.Context, f fsbridge.File) (elfInfo, error) {
 		phdrOff:      hdr.Phoff,
 		phdrSize:     prog64Size,
 		sharedObject: sharedObject,
+		interpPaths:  interpPaths,
 	}, nil
 }
 
@@ -399,7 +425,7 @@ func loadParsedELF(ctx context.Context, m *mm.MemoryManager, f fsbridge.File, in
 	first := true
 	var start, end usermem.Addr
 	var interpreter string
-	for _, phdr := range info.phdrs {
+	for i, phdr := range info.phdrs {
 		switch phdr.Type {
 		case elf.PT_LOAD:
 			vaddr := usermem.Addr(phdr.Vaddr)
@@ -430,11 +456,10 @@ func loadParsedELF(ctx context.Context, m *mm.MemoryManager, f fsbridge.File, in
 				return loadedELF{}, syserror.ENOEXEC
 			}
 
-			path := make([]byte, phdr.Filesz)
-			_, err := f.ReadFull(ctx, usermem.BytesIOSequence(path), int64(phdr.Off))
-			if err != nil {
+			// parseHeader has already read the path.
+			path := info.interpPaths[i]
+			if path == nil {
 				// If an interpreter was specified, it should exist.
-				ctx.Infof("Error reading PT_INTERP path: %v", err)
 				return loadedELF{}, syserror.ENOEXEC
 			}
 
@@ -565,7 +590,7 @@ func loadParsedELF(ctx context.Context, m *mm.MemoryManager, f fsbridge.File, in
 //  * f is an ELF file
 //  * f is the first ELF loaded into m
 func loadInitialELF(ctx context.Context, m *mm.MemoryManager, fs *cpuid.FeatureSet, f fsbridge.File) (loadedELF, arch.Context, error) {
-	info, err := parseHeader(ctx, f)
+	info, err := parseHeaderCached(ctx, f)
 	if err != nil {
 		ctx.Infof("Failed to parse initial ELF: %v", err)
 		return loadedELF{}, nil, err
@@ -603,7 +628,7 @@ func loadInitialELF(ctx context.Context, m *mm.MemoryManager, fs *cpuid.FeatureS
 // Preconditions:
 //  * f is an ELF file
 func loadInterpreterELF(ctx context.Context, m *mm.MemoryManager, f fsbridge.File, initial loadedELF) (loadedELF, error) {
-	info, err := parseHeader(ctx, f)
+	info, err := parseHeaderCached(ctx, f)
 	if err != nil {
 		if err == syserror.ENOEXEC {
 			// Bad interpreter.
@@ -0,0 +1,80 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package loader
+
+import (
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/sentry/fsbridge"
+	"gvisor.dev/gvisor/pkg/sync"
+)
+
+// elfCacheSize is the maximum number of entries in elfCache.
+const elfCacheSize = 128
+
+// elfCache caches the parsed headers of recently loaded ELF files, which are
+// usually the same few binaries and interpreters exec'd over and over.
+//
+// Cached elfInfos are shared, and must not be mutated.
+var elfCache struct {
+	mu sync.Mutex
+
+	// infos maps the identity of each cached file to its parsed headers.
+	// infos is protected by mu.
+	infos map[fsbridge.FileIdentity]elfInfo
+}
+
+// parseHeaderCached is equivalent to parseHeader, but returns the cached
+// result if f has been parsed before and has not changed since.
+func parseHeaderCached(ctx context.Context, f fsbridge.File) (elfInfo, error) {
+	id, err := f.Identity(ctx)
+	if err != nil {
+		// Files whose identity can't be determined aren't cached.
+		return parseHeader(ctx, f)
+	}
+
+	elfCache.mu.Lock()
+	info, ok := elfCache.infos[id]
+	elfCache.mu.Unlock()
+	if ok {
+		return info, nil
+	}
+
+	info, err = parseHeader(ctx, f)
+	if err != nil {
+		return elfInfo{}, err
+	}
+	for _, path := range info.interpPaths {
+		if path == nil {
+			// Don't cache what may be a transient read error.
+			return info, nil
+		}
+	}
+
+	elfCache.mu.Lock()
+	defer elfCache.mu.Unlock()
+	if elfCache.infos == nil {
+		elfCache.infos = make(map[fsbridge.FileIdentity]elfInfo)
+	}
+	if len(elfCache.infos) >= elfCacheSize {
+		// Evict an arbitrary entry. Entries for files that have changed
+		// are never hit again, so the cache must be bounded.
+		for victim := range elfCache.infos {
+			delete(elfCache.infos, victim)
+			break
+		}
+	}
+	elfCache.infos[id] = info
+	return info, nil
+}
@@ -326,9 +326,10 @@ func loadVDSO(ctx context.Context, m *mm.MemoryManager, v *VDSO, bin loadedELF)
 		return 0, syserror.ENOEXEC
 	}
 
-	// Reserve address space for the VDSO and its parameter page, which is
-	// mapped just before the VDSO.
-	mapSize := v.vdso.Length() + v.ParamPage.Length()
+	// Reserve address space for the VDSO, its parameter page, which is
+	// mapped just before the VDSO, and the thread clock page, which is mapped
+	// just before the parameter page.
+	mapSize := v.vdso.Length() + v.ParamPage.Length() + usermem.PageSize
 	addr, err := m.MMap(ctx, memmap.MMapOpts{
 		Length:  mapSize,
 		Private: true,
@@ -338,12 +339,31 @@ func loadVDSO(ctx context.Context, m *mm.MemoryManager, v *VDSO, bin loadedELF)
 		return 0, err
 	}
 
+	// Map the thread clock page. Unlike the param page, it is private to m:
+	// the sentry writes the CPU clocks of m's tasks to it, bypassing its
+	// permissions.
+	_, err = m.MMap(ctx, memmap.MMapOpts{
+		Length:   usermem.PageSize,
+		Addr:     addr,
+		Fixed:    true,
+		Unmap:    true,
+		Private:  true,
+		Perms:    usermem.Read,
+		MaxPerms: usermem.Read,
+	})
+	if err != nil {
+		ctx.Infof("Unable to map VDSO thread clock page: %v", err)
+		return 0, err
+	}
+	m.SetVDSOThreadClocks(addr)
+
 	// Now map the param page.
+	paramAddr := addr + usermem.PageSize
 	_, err = m.MMap(ctx, memmap.MMapOpts{
 		Length:          v.ParamPage.Length(),
 		MappingIdentity: v.ParamPage,
 		Mappable:        v.ParamPage,
-		Addr:            addr,
+		Addr:            paramAddr,
 		Fixed:           true,
 		Unmap:           true,
 		Private:         true,
@@ -356,9 +376,9 @@ func loadVDSO(ctx context.Context, m *mm.MemoryManager, v *VDSO, bin loadedELF)
 	}
 
 	// Now map the VDSO itself.
-	vdsoAddr, ok := addr.AddLength(v.ParamPage.Length())
+	vdsoAddr, ok := paramAddr.AddLength(v.ParamPage.Length())
 	if !ok {
-		panic(fmt.Sprintf("Part of mapped range overflows? %#x + %#x", addr, v.ParamPage.Length()))
+		panic(fmt.Sprintf("Part of mapped range overflows? %#x + %#x", paramAddr, v.ParamPage.Length()))
 	}
 	_, err = m.MMap(ctx, memmap.MMapOpts{
 		Length:          v.vdso.Length(),
@@ -273,9 +273,9 @@ const (
 	// similar. Pages in the mapping should be made, and kept, resident in
 	// physical memory as soon as possible.
 	//
-	// As of this writing, MLockEager does not cause memory-locking to be
-	// requested from the host; it only affects the sentry's memory management
-	// behavior.
+	// MLockEager populates the mapping, and requests that the host keep the
+	// mapping's pages resident if they are allocated by the sentry's
+	// MemoryFile. Pages of other files are only populated.
 	//
 	// MLockEager is analogous to Linux's VM_LOCKED.
 	MLockEager
@@ -284,9 +284,10 @@ const (
 	// similar. Pages in the mapping should be kept resident in physical memory
 	// once they have been made resident due to e.g. a page fault.
 	//
-	// As of this writing, MLockLazy does not cause memory-locking to be
-	// requested from the host; in fact, it has virtually no effect, except for
-	// interactions between mlocked pages and other syscalls.
+	// As of this writing, MLockLazy only causes memory-locking to be requested
+	// from the host for pages copied to break copy-on-write; otherwise, it has
+	// virtually no effect, except for interactions between mlocked pages and
+	// other syscalls.
 	//
 	// MLockLazy is analogous to Linux's VM_LOCKED | VM_LOCKONFAULT.
 	MLockLazy
@@ -234,3 +234,48 @@ func (mm *MemoryManager) unmapASLocked(ar usermem.AddrRange) {
 	// spaces.
 	mm.as.Unmap(ar.Start, uint64(ar.Length()))
 }
+
+// writeProtectASLocked ensures that addresses in ar are not writable through
+// mm.as, as for unmapASLocked, but tries to keep them readable so that reading
+// them doesn't fault. It is used when pmas in ar have become copy-on-write.
+//
+// Preconditions: mm.activeMu must be locked for writing. ar must be
+// page-aligned, and pmas must exist for all addresses in ar.
+func (mm *MemoryManager) writeProtectASLocked(ar usermem.AddrRange) {
+	// Linux write-protects page table entries when pages become
+	// copy-on-write, rather than discarding them. Get the same effect by
+	// remapping the pmas without write permission, if doing so costs the same
+	// regardless of how many pages are mapped.
+	if mm.as == nil || mm.p.MapUnit() != 0 {
+		mm.unmapASLocked(ar)
+		return
+	}
+	// Addresses that can't be remapped are unmapped in contiguous runs.
+	var unmapAR usermem.AddrRange
+	for pseg := mm.pmas.LowerBoundSegment(ar.Start); pseg.Ok() && pseg.Start() < ar.End; pseg = pseg.NextSegment() {
+		pma := pseg.ValuePtr()
+		pmaAR := pseg.Range().Intersect(ar)
+		perms := pma.effectivePerms
+		if pma.needCOW {
+			perms.Write = false
+		}
+		// pmas freed by MADV_FREE must fault before they're used again.
+		if perms.Any() && !pma.lazyFree {
+			if err := mm.as.MapFile(pmaAR.Start, pma.file, pseg.fileRangeOf(pmaAR), perms, false); err == nil {
+				continue
+			}
+			// The existing mapping may still be writable.
+		}
+		if unmapAR.Length() != 0 && unmapAR.End == pmaAR.Start {
+			unmapAR.End = pmaAR.End
+			continue
+		}
+		if unmapAR.Length() != 0 {
+			mm.unmapASLocked(unmapAR)
+		}
+		unmapAR = pmaAR
+	}
+	if unmapAR.Length() != 0 {
+		mm.unmapASLocked(unmapAR)
+	}
+}
@@ -471,6 +471,11 @@ func (mm *MemoryManager) handleASIOFault(ctx context.Context, addr usermem.Addr,
 	if pendaddr := pend.Start(); pendaddr < ar.End {
 		if pendaddr <= ar.Start {
 			mm.activeMu.Unlock()
+			if uerr, ok := asUserfaultError(err); ok {
+				// The caller will retry the I/O once the page is provided.
+				uerr.wait(ctx)
+				return nil
+			}
 			return translateIOError(ctx, err)
 		}
 		ar.End = pendaddr
@@ -525,6 +530,11 @@ func (mm *MemoryManager) withInternalMappings(ctx context.Context, ar usermem.Ad
 	if pendaddr := pend.Start(); pendaddr < ar.End {
 		if pendaddr <= ar.Start {
 			mm.activeMu.Unlock()
+			if uerr, ok := asUserfaultError(perr); ok {
+				// Retry once the page is provided.
+				uerr.wait(ctx)
+				return mm.withInternalMappings(ctx, ar, at, ignorePermissions, f)
+			}
 			return 0, translateIOError(ctx, perr)
 		}
 		ar.End = pendaddr
@@ -597,6 +607,11 @@ func (mm *MemoryManager) withVecInternalMappings(ctx context.Context, ars userme
 	mm.mappingMu.RUnlock()
 	if pars.NumBytes() == 0 {
 		mm.activeMu.Unlock()
+		if uerr, ok := asUserfaultError(perr); ok {
+			// Retry once the page is provided.
+			uerr.wait(ctx)
+			return mm.withVecInternalMappings(ctx, ars, at, ignorePermissions, f)
+		}
 		return 0, translateIOError(ctx, perr)
 	}
 	imars, imerr := mm.getVecPMAInternalMappingsLocked(pars)
@@ -19,6 +19,7 @@ import (
 	"sync/atomic"
 
 	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/limits"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
@@ -57,6 +58,31 @@ func (mm *MemoryManager) SetMmapLayout(ac arch.Context, r *limits.LimitSet) (arc
 // Fork creates a copy of mm with 1 user, as for Linux syscalls fork() or
 // clone() (without CLONE_VM).
 func (mm *MemoryManager) Fork(ctx context.Context) (*MemoryManager, error) {
+	mm2, err := mm.fork(ctx)
+	if err != nil {
+		return nil, err
+	}
+
+	// The VDSO thread clock page describes threads that don't exist in mm2.
+	// In particular, the thread that called fork has a record with the
+	// same thread pointer as mm2's first thread, so records must not be
+	// inherited.
+	mm.metadataMu.Lock()
+	used := mm.vdsoThreadClocksUsed
+	mm.metadataMu.Unlock()
+	if used {
+		zeroes := make([]byte, usermem.PageSize)
+		if _, err := mm2.CopyOut(ctx, mm2.vdsoThreadClocksAddr, zeroes, usermem.IOOpts{IgnorePermissions: true}); err != nil {
+			// The application unmapped the page, so the VDSO can't
+			// read the stale records either.
+			log.Debugf("Failed to clear VDSO thread clocks: %v", err)
+		}
+	}
+	return mm2, nil
+}
+
+// fork implements Fork, except for the VDSO thread clock page.
+func (mm *MemoryManager) fork(ctx context.Context) (*MemoryManager, error) {
 	mm.metadataMu.Lock()
 	defer mm.metadataMu.Unlock()
 	mm.mappingMu.RLock()
@@ -85,6 +111,10 @@ func (mm *MemoryManager) Fork(ctx context.Context) (*MemoryManager, error) {
 		aioManager:         aioManager{contexts: make(map[uint64]*AIOContext)},
 		sleepForActivation: mm.sleepForActivation,
 		vdsoSigReturnAddr:  mm.vdsoSigReturnAddr,
+
+		// Records in the VDSO thread clock page are owned by tasks
+		// using mm, so none are owned in mm2.
+		vdsoThreadClocksAddr: mm.vdsoThreadClocksAddr,
 	}
 
 	// Copy vmas.
@@ -115,6 +145,9 @@ func (mm *MemoryManager) Fork(ctx context.Context) (*MemoryManager, error) {
 			vma.id.IncRef()
 		}
 		vma.mlockMode = memmap.MLockNone
+		// Without UFFD_FEATURE_EVENT_FORK, which we don't support, Linux
+		// doesn't register the child's vmas.
+		vma.userfaultfd = nil
 		dstvgap = mm2.vmas.Insert(dstvgap, vmaAR, vma).NextGap()
 		// We don't need to update mm2.usageAS since we copied it from mm
 		// above.
@@ -137,7 +170,9 @@ func (mm *MemoryManager) Fork(ctx context.Context) (*MemoryManager, error) {
 	}
 	srcvseg := mm.vmas.FirstSegment()
 	dstpgap := mm2.pmas.FirstGap()
-	var unmapAR usermem.AddrRange
+	var protectAR usermem.AddrRange
+	var refFile platform.File
+	var refFR platform.FileRange
 	for srcpseg := mm.pmas.FirstSegment(); srcpseg.Ok(); srcpseg = srcpseg.NextSegment() {
 		pma := srcpseg.ValuePtr()
 		if !pma.private {
@@ -167,33 +202,51 @@ func (mm *MemoryManager) Fork(ctx context.Context) (*MemoryManager, error) {
 		if !pma.needCOW {
 			pma.needCOW = true
 			if pma.effectivePerms.Write {
-				// We don't want to unmap the whole address space, even though
-				// doing so would reduce calls to unmapASLocked(), because mm
-				// will most likely continue to be used after the fork, so
-				// unmapping pmas unnecessarily will result in extra page
-				// faults. But we do want to merge consecutive AddrRanges
-				// across pma boundaries.
-				if unmapAR.End == srcpseg.Start() {
-					unmapAR.End = srcpseg.End()
+				// We don't want to write-protect the whole address space,
+				// even though doing so would reduce calls to
+				// writeProtectASLocked(), because mm will most likely
+				// continue to be used after the fork, so unmapping pmas
+				// unnecessarily (on platforms that can't write-protect them
+				// cheaply) will result in extra page faults. But we do want
+				// to merge consecutive AddrRanges across pma boundaries.
+				if protectAR.End == srcpseg.Start() {
+					protectAR.End = srcpseg.End()
 				} else {
-					if unmapAR.Length() != 0 {
-						mm.unmapASLocked(unmapAR)
+					if protectAR.Length() != 0 {
+						mm.writeProtectASLocked(protectAR)
 					}
-					unmapAR = srcpseg.Range()
+					protectAR = srcpseg.Range()
 				}
 				pma.effectivePerms.Write = false
 			}
 			pma.maxPerms.Write = false
 		}
+		// Take references on the pma's memory in batches, since consecutive
+		// private pmas are usually backed by contiguous memory, and the cost
+		// of doing so per pma would otherwise grow with mm's RSS.
 		fr := srcpseg.fileRange()
-		mm2.incPrivateRef(fr)
-		srcpseg.ValuePtr().file.IncRef(fr)
+		if refFile == pma.file && refFR.End == fr.Start {
+			refFR.End = fr.End
+		} else {
+			if refFR.Length() != 0 {
+				mm2.incPrivateRef(refFR)
+				refFile.IncRef(refFR)
+			}
+			refFile, refFR = pma.file, fr
+		}
 		addrRange := srcpseg.Range()
 		mm2.addRSSLocked(addrRange)
-		dstpgap = mm2.pmas.Insert(dstpgap, addrRange, *pma).NextGap()
+		dstpma := *pma
+		// Only mm marked the pma's memory as evictable.
+		dstpma.lazyFree = false
+		dstpgap = mm2.pmas.Insert(dstpgap, addrRange, dstpma).NextGap()
+	}
+	if protectAR.Length() != 0 {
+		mm.writeProtectASLocked(protectAR)
 	}
-	if unmapAR.Length() != 0 {
-		mm.unmapASLocked(unmapAR)
+	if refFR.Length() != 0 {
+		mm2.incPrivateRef(refFR)
+		refFile.IncRef(refFR)
 	}
 
 	// Between when we call memmap.Mappable.AddMapping while copying vmas and
@@ -275,9 +328,17 @@ func (mm *MemoryManager) DecUsers(ctx context.Context) {
 
 	mm.mappingMu.Lock()
 	defer mm.mappingMu.Unlock()
+	// Release pmas before unmapping, so that the memory they hold can be
+	// freed off of the exiting task's critical path.
+	mm.activeMu.Lock()
+	mm.releasePMAsLocked()
+	mm.activeMu.Unlock()
 	// If mm is being dropped before mm.SetMmapLayout was called,
 	// mm.applicationAddrRange() will be empty.
 	if ar := mm.applicationAddrRange(); ar.Length() != 0 {
 		mm.unmapLocked(ctx, ar)
 	}
+	// Forget memory freed by MADV_FREE, so that the MemoryFile doesn't retain
+	// mm.
+	mm.mfp.MemoryFile().MarkAllUnevictable(mm)
 }
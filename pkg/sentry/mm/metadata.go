@@ -181,3 +181,45 @@ func (mm *MemoryManager) SetVDSOSigReturn(addr uint64) {
 	defer mm.metadataMu.Unlock()
 	mm.vdsoSigReturnAddr = addr
 }
+
+// VDSOThreadClocks is the number of records in the VDSO thread clock page.
+const VDSOThreadClocks = 64
+
+// VDSOThreadClocks returns the address of the VDSO thread clock page, or 0 if
+// there is none.
+func (mm *MemoryManager) VDSOThreadClocks() usermem.Addr {
+	mm.metadataMu.Lock()
+	defer mm.metadataMu.Unlock()
+	return mm.vdsoThreadClocksAddr
+}
+
+// SetVDSOThreadClocks sets the address of the VDSO thread clock page.
+func (mm *MemoryManager) SetVDSOThreadClocks(addr usermem.Addr) {
+	mm.metadataMu.Lock()
+	defer mm.metadataMu.Unlock()
+	mm.vdsoThreadClocksAddr = addr
+}
+
+// ClaimVDSOThreadClock claims record slot in the VDSO thread clock page for
+// owner, which must be non-zero. It returns false if the record is owned by
+// another owner.
+func (mm *MemoryManager) ClaimVDSOThreadClock(slot int, owner uint64) bool {
+	mm.metadataMu.Lock()
+	defer mm.metadataMu.Unlock()
+	if cur := mm.vdsoThreadClockOwners[slot]; cur != 0 && cur != owner {
+		return false
+	}
+	mm.vdsoThreadClockOwners[slot] = owner
+	mm.vdsoThreadClocksUsed = true
+	return true
+}
+
+// ReleaseVDSOThreadClock releases record slot in the VDSO thread clock page,
+// if it is owned by owner.
+func (mm *MemoryManager) ReleaseVDSOThreadClock(slot int, owner uint64) {
+	mm.metadataMu.Lock()
+	defer mm.metadataMu.Unlock()
+	if mm.vdsoThreadClockOwners[slot] == owner {
+		mm.vdsoThreadClockOwners[slot] = 0
+	}
+}
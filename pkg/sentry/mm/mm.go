@@ -235,6 +235,26 @@ type MemoryManager struct {
 
 	// vdsoSigReturnAddr is the address of 'vdso_sigreturn'.
 	vdsoSigReturnAddr uint64
+
+	// vdsoThreadClocksAddr is the address of the VDSO thread clock page,
+	// which holds VDSOThreadClocks records of the CPU clocks of tasks using
+	// the MemoryManager. It is 0 if there is no such page.
+	//
+	// vdsoThreadClocksAddr is protected by metadataMu.
+	vdsoThreadClocksAddr usermem.Addr
+
+	// vdsoThreadClockOwners contains the owner of each record in the VDSO
+	// thread clock page, or 0 for records that are free. Records are
+	// invalidated by save/restore, so owners are not saved.
+	//
+	// vdsoThreadClockOwners is protected by metadataMu.
+	vdsoThreadClockOwners [VDSOThreadClocks]uint64 `state:"nosave"`
+
+	// vdsoThreadClocksUsed is true if any record in the VDSO thread clock
+	// page has ever been claimed.
+	//
+	// vdsoThreadClocksUsed is protected by metadataMu.
+	vdsoThreadClocksUsed bool
 }
 
 // vma represents a virtual memory area.
@@ -292,6 +312,11 @@ type vma struct {
 	// numaNodemask is the NUMA nodemask for this vma set by mbind().
 	numaNodemask uint64
 
+	// If userfaultfd is not nil, this is a private anonymous vma registered
+	// with it by UFFDIO_REGISTER, and missing pages are reported to it rather
+	// than allocated.
+	userfaultfd *Userfaultfd
+
 	// If id is not nil, it controls the lifecycle of mappable and provides vma
 	// metadata shown in /proc/[pid]/maps, and the vma holds a reference.
 	id memmap.MappingIdentity
@@ -435,6 +460,13 @@ type pma struct {
 	// corresponding vma's memmap.Mappable.Translate.
 	private bool
 
+	// If lazyFree is true, the pma's memory was freed by madvise(MADV_FREE)
+	// and hasn't been accessed since, so it may be decommitted by
+	// MemoryManager.Evict. lazyFree is only set for private, uniquely-owned
+	// pmas of private anonymous vmas, and is cleared by getPMAsLocked before
+	// the pma is used again.
+	lazyFree bool
+
 	// If internalMappings is not empty, it is the cached return value of
 	// file.MapInternal for the platform.FileRange mapped by this pma.
 	internalMappings safemem.BlockSeq `state:"nosave"`
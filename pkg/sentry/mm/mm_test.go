@@ -137,6 +137,33 @@ func TestBrkDataLimitUpdates(t *testing.T) {
 	}
 }
 
+// TestBrkGrowsHeapInPlace ensures that growing the brk extends the heap vma
+// rather than adding vmas, and that address space accounting keeps up.
+func TestBrkGrowsHeapInPlace(t *testing.T) {
+	ctx := contexttest.Context(t)
+	mm := testMemoryManager(ctx)
+	defer mm.DecUsers(ctx)
+
+	mm.BrkSetup(ctx, mm.layout.MinAddr+0x100000)
+	start, _ := mm.Brk(ctx, 0)
+	for i := 1; i <= 8; i++ {
+		want := start + usermem.Addr(i)*usermem.PageSize/2
+		if got, err := mm.Brk(ctx, want); err != nil || got != want {
+			t.Fatalf("Brk(%#x) got (%#x, %v) want (%#x, nil)", want, got, err, want)
+		}
+	}
+
+	if n := mm.vmas.countSegments(); n != 1 {
+		t.Errorf("got %d vmas after growing the brk, want 1", n)
+	}
+	if realUsage := mm.realUsageAS(); mm.usageAS != realUsage {
+		t.Errorf("usageAS believes %v bytes are mapped; %v bytes are actually mapped", mm.usageAS, realUsage)
+	}
+	if realDataAS := mm.realDataAS(); mm.dataAS != realDataAS {
+		t.Errorf("dataAS believes %v bytes are mapped; %v bytes are actually mapped", mm.dataAS, realDataAS)
+	}
+}
+
 // TestIOAfterUnmap ensures that IO fails after unmap.
 func TestIOAfterUnmap(t *testing.T) {
 	ctx := contexttest.Context(t)
@@ -21,6 +21,7 @@ import (
 	"gvisor.dev/gvisor/pkg/safecopy"
 	"gvisor.dev/gvisor/pkg/safemem"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
 	"gvisor.dev/gvisor/pkg/sentry/platform"
 	"gvisor.dev/gvisor/pkg/sentry/usage"
 	"gvisor.dev/gvisor/pkg/syserror"
@@ -54,6 +55,10 @@ func (mm *MemoryManager) existingPMAsLocked(ar usermem.AddrRange, at usermem.Acc
 		if needInternalMappings && pma.internalMappings.IsEmpty() {
 			return pmaIterator{}
 		}
+		if pma.lazyFree {
+			// getPMAsLocked must cancel MADV_FREE before the pma is used.
+			return pmaIterator{}
+		}
 
 		if ar.End <= pseg.End() {
 			return first
@@ -222,8 +227,32 @@ func (mm *MemoryManager) getPMAsInternalLocked(ctx context.Context, vseg vmaIter
 					}
 				}
 				if vma.mappable == nil {
+					if vma.userfaultfd != nil {
+						// Missing pages of registered vmas are provided by
+						// the Userfaultfd's reader instead.
+						addr := optAR.Start
+						if addr < ar.Start {
+							addr = ar.Start
+						}
+						return pstart, pgap, &userfaultError{
+							uffd:  vma.userfaultfd,
+							addr:  addr,
+							write: at.Write,
+						}
+					}
 					// Private anonymous mappings get pmas by allocating.
 					allocAR := optAR.Intersect(maskAR)
+					// Allocations of a hugepage or more are hugepage-aligned
+					// in the file. If allocAR isn't hugepage-aligned, end it
+					// at the next hugepage boundary instead, so that
+					// following allocations are aligned identically in the
+					// file and address space and can be mapped by host
+					// hugepages.
+					if allocAR.Length() >= usermem.HugePageSize {
+						if start, ok := allocAR.Start.HugeRoundUp(); ok && start != allocAR.Start {
+							allocAR.End = start
+						}
+					}
 					fr, err := mf.Allocate(uint64(allocAR.Length()), usage.Anonymous)
 					if err != nil {
 						return pstart, pgap, err
@@ -233,6 +262,9 @@ func (mm *MemoryManager) getPMAsInternalLocked(ctx context.Context, vseg vmaIter
 							panic(fmt.Sprintf("Allocate(%v) returned invalid FileRange %v", allocAR.Length(), fr))
 						}
 					}
+					if mf.NUMAEnabled() {
+						mf.SetNUMAPolicy(fr, vma.numaPolicyForLocked(ctx))
+					}
 					mm.addRSSLocked(allocAR)
 					mm.incPrivateRef(fr)
 					mf.IncRef(fr)
@@ -311,6 +343,12 @@ func (mm *MemoryManager) getPMAsInternalLocked(ctx context.Context, vseg vmaIter
 
 			case pseg.Ok() && pseg.Start() < vsegAR.End:
 				oldpma := pseg.ValuePtr()
+				if oldpma.lazyFree {
+					// Accessing memory freed by MADV_FREE cancels the free;
+					// its contents must be preserved from now on.
+					oldpma.lazyFree = false
+					mf.MarkUnevictable(mm, pgalloc.EvictableRange{Start: uint64(pseg.Start()), End: uint64(pseg.End())})
+				}
 				if at.Write && mm.isPMACopyOnWriteLocked(vseg, pseg) {
 					// Break copy-on-write by copying.
 					if checkInvariants {
@@ -372,6 +410,10 @@ func (mm *MemoryManager) getPMAsInternalLocked(ctx context.Context, vseg vmaIter
 					oldpma.file.DecRef(pseg.fileRange())
 					mm.incPrivateRef(fr)
 					mf.IncRef(fr)
+					if vma.mlockMode != memmap.MLockNone {
+						// The copy is already resident; keep it so.
+						mf.Pin(fr)
+					}
 					oldpma.file = mf
 					oldpma.off = fr.Start
 					oldpma.translatePerms = usermem.AnyAccess
@@ -579,6 +621,7 @@ func (mm *MemoryManager) invalidateLocked(ar usermem.AddrRange, invalidatePrivat
 	}
 
 	var didUnmapAS bool
+	var refs pmaRefRun
 	pseg := mm.pmas.LowerBoundSegment(ar.Start)
 	for pseg.Ok() && pseg.Start() < ar.End {
 		pma := pseg.ValuePtr()
@@ -592,16 +635,88 @@ func (mm *MemoryManager) invalidateLocked(ar usermem.AddrRange, invalidatePrivat
 				mm.unmapASLocked(ar)
 				didUnmapAS = true
 			}
-			if pma.private {
-				mm.decPrivateRef(pseg.fileRange())
-			}
 			mm.removeRSSLocked(pseg.Range())
-			pma.file.DecRef(pseg.fileRange())
+			// Release references on runs of contiguous memory at once, since
+			// adjacent pmas are usually backed by contiguous memory even when
+			// they belong to different vmas.
+			if !refs.extend(pma, pseg.fileRange()) {
+				mm.decPMARefs(refs)
+				refs = pmaRefRun{pma.file, pseg.fileRange(), pma.private}
+			}
 			pseg = mm.pmas.Remove(pseg).NextSegment()
 		} else {
 			pseg = pseg.NextSegment()
 		}
 	}
+	mm.decPMARefs(refs)
+}
+
+// releasePMAsLocked removes all pmas, as when mm loses its last user.
+// References on MemoryFile are released asynchronously: an exiting process
+// can take a long time to release a large address space, and nothing can
+// observe when its memory is actually freed.
+//
+// Preconditions: mm.activeMu must be locked for writing. mm.as must be nil.
+func (mm *MemoryManager) releasePMAsLocked() {
+	var frs []platform.FileRange
+	var refs pmaRefRun
+	for pseg := mm.pmas.FirstSegment(); pseg.Ok(); pseg = pseg.NextSegment() {
+		pma := pseg.ValuePtr()
+		if !refs.extend(pma, pseg.fileRange()) {
+			frs = mm.releasePMARefs(refs, frs)
+			refs = pmaRefRun{pma.file, pseg.fileRange(), pma.private}
+		}
+	}
+	frs = mm.releasePMARefs(refs, frs)
+	mm.pmas.RemoveAll()
+	mm.curRSS = 0
+	mm.mfp.MemoryFile().DecRefAsync(frs)
+}
+
+// pmaRefRun is a range of a platform.File referenced by one or more pmas.
+type pmaRefRun struct {
+	file    platform.File
+	fr      platform.FileRange
+	private bool
+}
+
+// extend tries to add the reference held by a pma with the given file range
+// to r, and returns true if successful.
+func (r *pmaRefRun) extend(pma *pma, fr platform.FileRange) bool {
+	if r.fr.Length() == 0 || r.file != pma.file || r.private != pma.private || r.fr.End != fr.Start {
+		return false
+	}
+	r.fr.End = fr.End
+	return true
+}
+
+// decPMARefs releases the references held on r by removed pmas.
+//
+// Preconditions: AddressSpace mappings of r must have been removed.
+func (mm *MemoryManager) decPMARefs(r pmaRefRun) {
+	if r.fr.Length() == 0 {
+		return
+	}
+	if r.private {
+		mm.decPrivateRef(r.fr)
+	}
+	r.file.DecRef(r.fr)
+}
+
+// releasePMARefs is equivalent to decPMARefs, except that references on
+// MemoryFile are appended to frs for the caller to release instead.
+func (mm *MemoryManager) releasePMARefs(r pmaRefRun, frs []platform.FileRange) []platform.FileRange {
+	if r.fr.Length() == 0 {
+		return frs
+	}
+	if r.private {
+		frs = mm.releasePrivateRef(r.fr, frs)
+	}
+	if r.file == mm.mfp.MemoryFile() {
+		return append(frs, r.fr)
+	}
+	r.file.DecRef(r.fr)
+	return frs
 }
 
 // Pin returns the platform.File ranges currently mapped by addresses in ar in
@@ -640,6 +755,11 @@ func (mm *MemoryManager) Pin(ctx context.Context, ar usermem.AddrRange, at userm
 	if pendaddr := pend.Start(); pendaddr < ar.End {
 		if pendaddr <= ar.Start {
 			mm.activeMu.Unlock()
+			if uerr, ok := asUserfaultError(perr); ok {
+				// Retry once the page is provided.
+				uerr.wait(ctx)
+				return mm.Pin(ctx, ar, at, ignorePermissions)
+			}
 			return nil, perr
 		}
 		ar.End = pendaddr
@@ -662,6 +782,11 @@ func (mm *MemoryManager) Pin(ctx context.Context, ar usermem.AddrRange, at userm
 	mm.activeMu.Unlock()
 
 	// Return the first error in order of progress through ar.
+	if _, ok := asUserfaultError(perr); ok {
+		// Report partial success as for other errors; callers that retry
+		// the remainder of ar will then wait for the missing page.
+		return prs, syserror.EFAULT
+	}
 	if perr != nil {
 		return prs, perr
 	}
@@ -740,6 +865,27 @@ func (mm *MemoryManager) movePMAsLocked(oldAR, newAR usermem.AddrRange) {
 	}
 
 	mm.unmapASLocked(oldAR)
+
+	// Linux moves page table entries along with the pages they map, so moved
+	// memory doesn't have to be faulted in again page by page. Get the same
+	// effect by mapping the moved pmas at newAR, if doing so costs the same
+	// regardless of how many pages are mapped.
+	if mm.as != nil && mm.p.MapUnit() == 0 {
+		for pseg := mm.pmas.LowerBoundSegment(newAR.Start); pseg.Ok() && pseg.Start() < newAR.End; pseg = pseg.NextSegment() {
+			pma := pseg.ValuePtr()
+			perms := pma.effectivePerms
+			if pma.needCOW {
+				perms.Write = false
+			}
+			// pmas freed by MADV_FREE must fault before they're used again.
+			if !perms.Any() || pma.lazyFree {
+				continue
+			}
+			// Errors are harmless, since the application will fault on the
+			// pma instead.
+			mm.as.MapFile(pseg.Start(), pma.file, pseg.fileRange(), perms, false)
+		}
+	}
 }
 
 // getPMAInternalMappingsLocked ensures that pmas for all addresses in ar have
@@ -879,8 +1025,16 @@ func (mm *MemoryManager) incPrivateRef(fr platform.FileRange) {
 
 // decPrivateRef releases a reference on private pages in fr.
 func (mm *MemoryManager) decPrivateRef(fr platform.FileRange) {
-	var freed []platform.FileRange
+	mf := mm.mfp.MemoryFile()
+	for _, fr := range mm.releasePrivateRef(fr, nil) {
+		mf.DecRef(fr)
+	}
+}
 
+// releasePrivateRef releases a reference on private pages in fr, and appends
+// the ranges whose last reference was released to freed. The caller must
+// release the corresponding references on MemoryFile.
+func (mm *MemoryManager) releasePrivateRef(fr platform.FileRange, freed []platform.FileRange) []platform.FileRange {
 	mm.privateRefs.mu.Lock()
 	refSet := &mm.privateRefs.refs
 	seg := refSet.LowerBoundSegment(fr.Start)
@@ -896,10 +1050,25 @@ func (mm *MemoryManager) decPrivateRef(fr platform.FileRange) {
 	}
 	refSet.MergeAdjacent(fr)
 	mm.privateRefs.mu.Unlock()
+	return freed
+}
 
+// pinPMAsLocked requests that the host keep the pages of MemoryFile-backed
+// pmas in ar resident, as for mlock(2), or stops doing so if pin is false.
+//
+// Preconditions: mm.activeMu must be locked. ar.Length() != 0.
+func (mm *MemoryManager) pinPMAsLocked(ar usermem.AddrRange, pin bool) {
 	mf := mm.mfp.MemoryFile()
-	for _, fr := range freed {
-		mf.DecRef(fr)
+	for pseg := mm.pmas.LowerBoundSegment(ar.Start); pseg.Ok() && pseg.Start() < ar.End; pseg = pseg.NextSegment() {
+		if pseg.ValuePtr().file != mf {
+			continue
+		}
+		fr := pseg.fileRangeOf(pseg.Range().Intersect(ar))
+		if pin {
+			mf.Pin(fr)
+		} else {
+			mf.Unpin(fr)
+		}
 	}
 }
 
@@ -945,7 +1114,8 @@ func (pmaSetFunctions) Merge(ar1 usermem.AddrRange, pma1 pma, ar2 usermem.AddrRa
 		pma1.effectivePerms != pma2.effectivePerms ||
 		pma1.maxPerms != pma2.maxPerms ||
 		pma1.needCOW != pma2.needCOW ||
-		pma1.private != pma2.private {
+		pma1.private != pma2.private ||
+		pma1.lazyFree != pma2.lazyFree {
 		return pma{}, false
 	}
 
@@ -16,8 +16,7 @@ package mm
 
 import (
 	"bytes"
-	"fmt"
-	"strings"
+	"strconv"
 
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/sentry/fs/proc/seqfile"
@@ -26,6 +25,10 @@ import (
 )
 
 const (
+	// maxSeqFileDataBytes is the number of bytes of vma entries after which
+	// readSeqFileData stops generating more.
+	maxSeqFileDataBytes = 16 * usermem.PageSize
+
 	// devMinorBits is the number of minor bits in a device number. Linux:
 	// include/linux/kdev_t.h:MINORBITS
 	devMinorBits = 20
@@ -86,36 +89,56 @@ func (mm *MemoryManager) ReadMapsDataInto(ctx context.Context, buf *bytes.Buffer
 // ReadMapsSeqFileData is called by fs/proc.mapsData.ReadSeqFileData to
 // implement /proc/[pid]/maps.
 func (mm *MemoryManager) ReadMapsSeqFileData(ctx context.Context, handle seqfile.SeqHandle) ([]seqfile.SeqData, int64) {
+	return mm.readSeqFileData(ctx, handle, mm.appendVMAMapsEntryLocked, vsyscallMapsEntry)
+}
+
+// readSeqFileData returns seqfile.SeqData for the entries following handle in
+// a file with one entry per vma, followed by vsyscallEntry. appendEntry
+// appends the entry for a vma to a buffer.
+//
+// seqfile.SeqFile regenerates all entries following the read offset on each
+// read, so to avoid making reads of a process with many vmas quadratic in the
+// number of vmas, readSeqFileData stops after about maxSeqFileDataBytes; the
+// SeqFile asks for more once it has returned them. Compare Linux's
+// fs/seq_file.c:seq_read(), which only generates entries that fit in its
+// buffer.
+func (mm *MemoryManager) readSeqFileData(ctx context.Context, handle seqfile.SeqHandle, appendEntry func(context.Context, vmaIterator, *bytes.Buffer), vsyscallEntry string) ([]seqfile.SeqData, int64) {
 	mm.mappingMu.RLock()
 	defer mm.mappingMu.RUnlock()
-	var data []seqfile.SeqData
 	var start usermem.Addr
 	if handle != nil {
 		start = *handle.(*usermem.Addr)
 	}
-	for vseg := mm.vmas.LowerBoundSegment(start); vseg.Ok(); vseg = vseg.NextSegment() {
-		vmaAddr := vseg.End()
-		data = append(data, seqfile.SeqData{
-			Buf:    mm.vmaMapsEntryLocked(ctx, vseg),
-			Handle: &vmaAddr,
-		})
+
+	// Generate all entries into a single buffer, and slice it up once its
+	// final size is known.
+	var buf bytes.Buffer
+	var ends []int
+	var handles []usermem.Addr
+	vseg := mm.vmas.LowerBoundSegment(start)
+	for ; vseg.Ok() && buf.Len() < maxSeqFileDataBytes; vseg = vseg.NextSegment() {
+		appendEntry(ctx, vseg, &buf)
+		ends = append(ends, buf.Len())
+		handles = append(handles, vseg.End())
 	}
 
-	// We always emulate vsyscall, so advertise it here. Everything about a
-	// vsyscall region is static, so just hard code the maps entry since we
-	// don't have a real vma backing it. The vsyscall region is at the end of
-	// the virtual address space so nothing should be mapped after it (if
-	// something is really mapped in the tiny ~10 MiB segment afterwards, we'll
-	// get the sorting on the maps file wrong at worst; but that's not possible
-	// on any current platform).
-	//
-	// Artifically adjust the seqfile handle so we only output vsyscall entry once.
-	if start != vsyscallEnd {
-		vmaAddr := vsyscallEnd
-		data = append(data, seqfile.SeqData{
-			Buf:    []byte(vsyscallMapsEntry),
-			Handle: &vmaAddr,
-		})
+	// We always emulate vsyscall, so advertise it here, once every vma has
+	// been returned. See ReadMapsDataInto for additional commentary.
+	if !vseg.Ok() && start != vsyscallEnd {
+		buf.WriteString(vsyscallEntry)
+		ends = append(ends, buf.Len())
+		handles = append(handles, vsyscallEnd)
+	}
+
+	bs := buf.Bytes()
+	data := make([]seqfile.SeqData, len(ends))
+	prevEnd := 0
+	for i, end := range ends {
+		data[i] = seqfile.SeqData{
+			Buf:    bs[prevEnd:end:end],
+			Handle: &handles[i],
+		}
+		prevEnd = end
 	}
 	return data, 1
 }
@@ -133,9 +156,9 @@ func (mm *MemoryManager) vmaMapsEntryLocked(ctx context.Context, vseg vmaIterato
 // Preconditions: mm.mappingMu must be locked.
 func (mm *MemoryManager) appendVMAMapsEntryLocked(ctx context.Context, vseg vmaIterator, b *bytes.Buffer) {
 	vma := vseg.ValuePtr()
-	private := "p"
+	private := byte('p')
 	if !vma.private {
-		private = "s"
+		private = 's'
 	}
 
 	var dev, ino uint64
@@ -148,8 +171,28 @@ func (mm *MemoryManager) appendVMAMapsEntryLocked(ctx context.Context, vseg vmaI
 
 	// Do not include the guard page: fs/proc/task_mmu.c:show_map_vma() =>
 	// stack_guard_page_start().
-	lineLen, _ := fmt.Fprintf(b, "%08x-%08x %s%s %08x %02x:%02x %d ",
-		vseg.Start(), vseg.End(), vma.realPerms, private, vma.off, devMajor, devMinor, ino)
+	//
+	// This is equivalent to formatting with fmt.Fprintf and
+	// "%08x-%08x %s%c %08x %02x:%02x %d ", which is too slow for processes
+	// with many vmas.
+	lineStart := b.Len()
+	writeHex(b, uint64(vseg.Start()), 8)
+	b.WriteByte('-')
+	writeHex(b, uint64(vseg.End()), 8)
+	b.WriteByte(' ')
+	b.WriteString(vma.realPerms.String())
+	b.WriteByte(private)
+	b.WriteByte(' ')
+	writeHex(b, vma.off, 8)
+	b.WriteByte(' ')
+	writeHex(b, uint64(devMajor), 2)
+	b.WriteByte(':')
+	writeHex(b, uint64(devMinor), 2)
+	b.WriteByte(' ')
+	var digits [20]byte
+	b.Write(strconv.AppendUint(digits[:0], ino, 10))
+	b.WriteByte(' ')
+	lineLen := b.Len() - lineStart
 
 	// Figure out our filename or hint.
 	var s string
@@ -165,9 +208,7 @@ func (mm *MemoryManager) appendVMAMapsEntryLocked(ctx context.Context, vseg vmaI
 	}
 	if s != "" {
 		// Per linux, we pad until the 74th character.
-		if pad := 73 - lineLen; pad > 0 {
-			b.WriteString(strings.Repeat(" ", pad))
-		}
+		writePadding(b, 73-lineLen)
 		b.WriteString(s)
 	}
 	b.WriteString("\n")
@@ -194,99 +235,112 @@ func (mm *MemoryManager) ReadSmapsDataInto(ctx context.Context, buf *bytes.Buffe
 // ReadSmapsSeqFileData is called by fs/proc.smapsData.ReadSeqFileData to
 // implement /proc/[pid]/smaps.
 func (mm *MemoryManager) ReadSmapsSeqFileData(ctx context.Context, handle seqfile.SeqHandle) ([]seqfile.SeqData, int64) {
-	mm.mappingMu.RLock()
-	defer mm.mappingMu.RUnlock()
-	var data []seqfile.SeqData
-	var start usermem.Addr
-	if handle != nil {
-		start = *handle.(*usermem.Addr)
-	}
-	for vseg := mm.vmas.LowerBoundSegment(start); vseg.Ok(); vseg = vseg.NextSegment() {
-		vmaAddr := vseg.End()
-		data = append(data, seqfile.SeqData{
-			Buf:    mm.vmaSmapsEntryLocked(ctx, vseg),
-			Handle: &vmaAddr,
-		})
-	}
+	return mm.readSeqFileData(ctx, handle, mm.vmaSmapsEntryIntoLocked, vsyscallSmapsEntry)
+}
 
-	// We always emulate vsyscall, so advertise it here. See
-	// ReadMapsSeqFileData for additional commentary.
-	if start != vsyscallEnd {
-		vmaAddr := vsyscallEnd
-		data = append(data, seqfile.SeqData{
-			Buf:    []byte(vsyscallSmapsEntry),
-			Handle: &vmaAddr,
-		})
-	}
-	return data, 1
+// smapsStats holds the memory usage of a vma, or of all vmas, as reported by
+// /proc/[pid]/smaps and /proc/[pid]/smaps_rollup. All fields are in bytes.
+type smapsStats struct {
+	// rss is the size of the vma's pmas.
+	rss uint64
+
+	// anon is the size of the vma's private pmas.
+	anon uint64
+
+	// clean is the size of pmas that are reported as clean.
+	clean uint64
+
+	// locked is the size of pmas in mlocked vmas.
+	locked uint64
+
+	// anonHuge is the size of private pmas that may be backed by host
+	// transparent hugepages.
+	anonHuge uint64
 }
 
-// vmaSmapsEntryLocked returns a /proc/[pid]/smaps entry for the vma iterated
-// by vseg, including the trailing newline.
-//
-// Preconditions: mm.mappingMu must be locked.
-func (mm *MemoryManager) vmaSmapsEntryLocked(ctx context.Context, vseg vmaIterator) []byte {
-	var b bytes.Buffer
-	mm.vmaSmapsEntryIntoLocked(ctx, vseg, &b)
-	return b.Bytes()
+// add adds the usage in other to s.
+func (s *smapsStats) add(other smapsStats) {
+	s.rss += other.rss
+	s.anon += other.anon
+	s.clean += other.clean
+	s.locked += other.locked
+	s.anonHuge += other.anonHuge
 }
 
-func (mm *MemoryManager) vmaSmapsEntryIntoLocked(ctx context.Context, vseg vmaIterator, b *bytes.Buffer) {
-	mm.appendVMAMapsEntryLocked(ctx, vseg, b)
+// vmaSmapsStatsLocked returns the memory usage of the vma iterated by vseg.
+//
+// Preconditions: mm.mappingMu must be locked.
+func (mm *MemoryManager) vmaSmapsStatsLocked(vseg vmaIterator) smapsStats {
 	vma := vseg.ValuePtr()
 
-	// We take mm.activeMu here in each call to vmaSmapsEntryLocked, instead of
+	// We take mm.activeMu here in each call to vmaSmapsStatsLocked, instead of
 	// requiring it to be locked as a precondition, to reduce the latency
 	// impact of reading /proc/[pid]/smaps on concurrent performance-sensitive
 	// operations requiring activeMu for writing like faults.
 	mm.activeMu.RLock()
-	var rss uint64
-	var anon uint64
+	var s smapsStats
+	hugepages := mm.mfp.MemoryFile().HugepagesEnabled()
 	vsegAR := vseg.Range()
 	for pseg := mm.pmas.LowerBoundSegment(vsegAR.Start); pseg.Ok() && pseg.Start() < vsegAR.End; pseg = pseg.NextSegment() {
 		psegAR := pseg.Range().Intersect(vsegAR)
 		size := uint64(psegAR.Length())
-		rss += size
+		s.rss += size
 		if pseg.ValuePtr().private {
-			anon += size
+			s.anon += size
+			if hugepages {
+				s.anonHuge += hugepageBytes(psegAR, pseg.fileRangeOf(psegAR).Start)
+			}
 		}
 	}
 	mm.activeMu.RUnlock()
 
-	fmt.Fprintf(b, "Size:           %8d kB\n", vseg.Range().Length()/1024)
-	fmt.Fprintf(b, "Rss:            %8d kB\n", rss/1024)
+	// Pretend that all pages are dirty if the vma is writable, and clean otherwise.
+	if !vma.effectivePerms.Write {
+		s.clean = s.rss
+	}
+	if vma.mlockMode != memmap.MLockNone {
+		s.locked = s.rss
+	}
+	return s
+}
+
+// writeSmapsStats writes the fields of /proc/[pid]/smaps and
+// /proc/[pid]/smaps_rollup that describe memory usage, other than Size.
+func writeSmapsStats(b *bytes.Buffer, s smapsStats) {
+	writeSmapsField(b, "Rss:            ", 8, s.rss/1024)
 	// Currently we report PSS = RSS, i.e. we pretend each page mapped by a pma
 	// is only mapped by that pma. This avoids having to query memmap.Mappables
 	// for reference count information on each page. As a corollary, all pages
 	// are accounted as "private" whether or not the vma is private; compare
 	// Linux's fs/proc/task_mmu.c:smaps_account().
-	fmt.Fprintf(b, "Pss:            %8d kB\n", rss/1024)
-	fmt.Fprintf(b, "Shared_Clean:   %8d kB\n", 0)
-	fmt.Fprintf(b, "Shared_Dirty:   %8d kB\n", 0)
-	// Pretend that all pages are dirty if the vma is writable, and clean otherwise.
-	clean := rss
-	if vma.effectivePerms.Write {
-		clean = 0
-	}
-	fmt.Fprintf(b, "Private_Clean:  %8d kB\n", clean/1024)
-	fmt.Fprintf(b, "Private_Dirty:  %8d kB\n", (rss-clean)/1024)
+	writeSmapsField(b, "Pss:            ", 8, s.rss/1024)
+	writeSmapsField(b, "Shared_Clean:   ", 8, 0)
+	writeSmapsField(b, "Shared_Dirty:   ", 8, 0)
+	writeSmapsField(b, "Private_Clean:  ", 8, s.clean/1024)
+	writeSmapsField(b, "Private_Dirty:  ", 8, (s.rss-s.clean)/1024)
 	// Pretend that all pages are "referenced" (recently touched).
-	fmt.Fprintf(b, "Referenced:     %8d kB\n", rss/1024)
-	fmt.Fprintf(b, "Anonymous:      %8d kB\n", anon/1024)
-	// Hugepages (hugetlb and THP) are not implemented.
-	fmt.Fprintf(b, "AnonHugePages:  %8d kB\n", 0)
-	fmt.Fprintf(b, "Shared_Hugetlb: %8d kB\n", 0)
-	fmt.Fprintf(b, "Private_Hugetlb: %7d kB\n", 0)
+	writeSmapsField(b, "Referenced:     ", 8, s.rss/1024)
+	writeSmapsField(b, "Anonymous:      ", 8, s.anon/1024)
+	// Private pmas may be backed by host THP. hugetlb is not implemented.
+	writeSmapsField(b, "AnonHugePages:  ", 8, s.anonHuge/1024)
+	writeSmapsField(b, "Shared_Hugetlb: ", 8, 0)
+	writeSmapsField(b, "Private_Hugetlb: ", 7, 0)
 	// Swap is not implemented.
-	fmt.Fprintf(b, "Swap:           %8d kB\n", 0)
-	fmt.Fprintf(b, "SwapPss:        %8d kB\n", 0)
-	fmt.Fprintf(b, "KernelPageSize: %8d kB\n", usermem.PageSize/1024)
-	fmt.Fprintf(b, "MMUPageSize:    %8d kB\n", usermem.PageSize/1024)
-	locked := rss
-	if vma.mlockMode == memmap.MLockNone {
-		locked = 0
-	}
-	fmt.Fprintf(b, "Locked:         %8d kB\n", locked/1024)
+	writeSmapsField(b, "Swap:           ", 8, 0)
+	writeSmapsField(b, "SwapPss:        ", 8, 0)
+}
+
+// Preconditions: mm.mappingMu must be locked.
+func (mm *MemoryManager) vmaSmapsEntryIntoLocked(ctx context.Context, vseg vmaIterator, b *bytes.Buffer) {
+	mm.appendVMAMapsEntryLocked(ctx, vseg, b)
+	vma := vseg.ValuePtr()
+	s := mm.vmaSmapsStatsLocked(vseg)
+
+	writeSmapsField(b, "Size:           ", 8, uint64(vseg.Range().Length())/1024)
+	writeSmapsStats(b, s)
+	writeSmapsField(b, "KernelPageSize: ", 8, usermem.PageSize/1024)
+	writeSmapsField(b, "MMUPageSize:    ", 8, usermem.PageSize/1024)
+	writeSmapsField(b, "Locked:         ", 8, s.locked/1024)
 
 	b.WriteString("VmFlags: ")
 	if vma.realPerms.Read {
@@ -327,3 +381,81 @@ func (mm *MemoryManager) vmaSmapsEntryIntoLocked(ctx context.Context, vseg vmaIt
 	}
 	b.WriteString("\n")
 }
+
+// ReadSmapsRollupDataInto is called by fsimpl/proc.smapsRollupData.Generate
+// and fs/proc.smapsRollupData.ReadSeqFileData to implement
+// /proc/[pid]/smaps_rollup.
+func (mm *MemoryManager) ReadSmapsRollupDataInto(ctx context.Context, buf *bytes.Buffer) {
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+
+	var s smapsStats
+	var ar usermem.AddrRange
+	if first := mm.vmas.FirstSegment(); first.Ok() {
+		ar = usermem.AddrRange{first.Start(), mm.vmas.LastSegment().End()}
+	}
+	for vseg := mm.vmas.FirstSegment(); vseg.Ok(); vseg = vseg.NextSegment() {
+		s.add(mm.vmaSmapsStatsLocked(vseg))
+	}
+
+	// Linux: fs/proc/task_mmu.c:show_smaps_rollup() describes the range
+	// spanned by all vmas, excluding the vsyscall page.
+	lineStart := buf.Len()
+	writeHex(buf, uint64(ar.Start), 8)
+	buf.WriteByte('-')
+	writeHex(buf, uint64(ar.End), 8)
+	buf.WriteString(" ---p 00000000 00:00 0 ")
+	writePadding(buf, 73-(buf.Len()-lineStart))
+	buf.WriteString("[rollup]\n")
+	writeSmapsStats(buf, s)
+	writeSmapsField(buf, "Locked:         ", 8, s.locked/1024)
+}
+
+// hugepageBytes returns the number of bytes in ar that are in hugepage-aligned
+// hugepages entirely within ar, if ar maps a file range starting at off such
+// that the host can map them using hugepages, and 0 otherwise. Whether the host
+// actually does so isn't known, so this is an upper bound.
+func hugepageBytes(ar usermem.AddrRange, off uint64) uint64 {
+	if uint64(ar.Start)&(usermem.HugePageSize-1) != off&(usermem.HugePageSize-1) {
+		return 0
+	}
+	start, ok := ar.Start.HugeRoundUp()
+	if !ok {
+		return 0
+	}
+	end := ar.End.HugeRoundDown()
+	if end <= start {
+		return 0
+	}
+	return uint64(end - start)
+}
+
+// writeHex writes v to b in lowercase hexadecimal, zero-padded to at least
+// width digits, as for fmt's "%0*x".
+func writeHex(b *bytes.Buffer, v uint64, width int) {
+	var digits [16]byte
+	bs := strconv.AppendUint(digits[:0], v, 16)
+	for i := len(bs); i < width; i++ {
+		b.WriteByte('0')
+	}
+	b.Write(bs)
+}
+
+// writeSmapsField writes a /proc/[pid]/smaps field with the given name, which
+// includes any padding, and value in kB right-aligned to width digits, as for
+// fmt's "%s%*d kB\n".
+func writeSmapsField(b *bytes.Buffer, name string, width int, kb uint64) {
+	b.WriteString(name)
+	var digits [20]byte
+	bs := strconv.AppendUint(digits[:0], kb, 10)
+	writePadding(b, width-len(bs))
+	b.Write(bs)
+	b.WriteString(" kB\n")
+}
+
+// writePadding writes n spaces to b, or nothing if n <= 0.
+func writePadding(b *bytes.Buffer, n int) {
+	for ; n > 0; n-- {
+		b.WriteByte(' ')
+	}
+}
@@ -20,6 +20,7 @@ import (
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/futex"
 	"gvisor.dev/gvisor/pkg/sentry/limits"
@@ -58,6 +59,11 @@ func (mm *MemoryManager) HandleUserFault(ctx context.Context, addr usermem.Addr,
 	mm.mappingMu.RUnlock()
 	if err != nil {
 		mm.activeMu.Unlock()
+		if uerr, ok := asUserfaultError(err); ok {
+			// Retry the faulting access once the page is provided.
+			uerr.wait(ctx)
+			return nil
+		}
 		return err
 	}
 
@@ -198,6 +204,10 @@ func (mm *MemoryManager) populateVMA(ctx context.Context, vseg vmaIterator, ar u
 	// anymore.
 	mm.activeMu.DowngradeLock()
 
+	if vseg.ValuePtr().mlockMode == memmap.MLockEager {
+		mm.pinPMAsLocked(ar, true)
+	}
+
 	// As above, errors are silently ignored.
 	mm.mapASLocked(pseg, ar, precommit)
 	mm.activeMu.RUnlock()
@@ -230,6 +240,7 @@ func (mm *MemoryManager) populateVMAAndUnlock(ctx context.Context, vseg vmaItera
 	// mm.mappingMu doesn't need to be write-locked for getPMAsLocked, and it
 	// isn't needed at all for mapASLocked.
 	mm.mappingMu.DowngradeLock()
+	pin := vseg.ValuePtr().mlockMode == memmap.MLockEager
 	pseg, _, err := mm.getPMAsLocked(ctx, vseg, ar, usermem.NoAccess)
 	mm.mappingMu.RUnlock()
 	if err != nil {
@@ -238,6 +249,9 @@ func (mm *MemoryManager) populateVMAAndUnlock(ctx context.Context, vseg vmaItera
 	}
 
 	mm.activeMu.DowngradeLock()
+	if pin {
+		mm.pinPMAsLocked(ar, true)
+	}
 	mm.mapASLocked(pseg, ar, precommit)
 	mm.activeMu.RUnlock()
 }
@@ -744,6 +758,15 @@ func (mm *MemoryManager) Brk(ctx context.Context, addr usermem.Addr) (usermem.Ad
 
 	switch {
 	case oldbrkpg < newbrkpg:
+		if ok, err := mm.extendBrkVMALocked(ctx, oldbrkpg, newbrkpg); ok || err != nil {
+			if err == nil {
+				mm.brk.End = addr
+			} else {
+				addr = mm.brk.End
+			}
+			mm.mappingMu.Unlock()
+			return addr, err
+		}
 		vseg, ar, err := mm.createVMALocked(ctx, memmap.MMapOpts{
 			Length: uint64(newbrkpg - oldbrkpg),
 			Addr:   oldbrkpg,
@@ -782,6 +805,57 @@ func (mm *MemoryManager) Brk(ctx context.Context, addr usermem.Addr) (usermem.Ad
 	return addr, nil
 }
 
+// extendBrkVMALocked grows the heap from oldbrkpg to newbrkpg by extending the
+// vma that ends at oldbrkpg in place, if that vma is the heap's. This is the
+// common case for programs that grow the heap a little at a time, and it
+// avoids inserting a vma only to merge it into its predecessor. It returns
+// false if the heap must be grown by creating a vma instead.
+//
+// Preconditions: mm.mappingMu must be locked for writing. oldbrkpg and
+// newbrkpg are page-aligned, and oldbrkpg < newbrkpg.
+func (mm *MemoryManager) extendBrkVMALocked(ctx context.Context, oldbrkpg, newbrkpg usermem.Addr) (bool, error) {
+	// Heaps that are locked into memory need to be populated as they grow;
+	// leave them to the slow path.
+	if mm.defMLockMode != memmap.MLockNone {
+		return false, nil
+	}
+	brkStart, _ := mm.brk.Start.RoundUp()
+	if oldbrkpg <= brkStart {
+		return false, nil
+	}
+	vseg := mm.vmas.FindSegment(oldbrkpg - 1)
+	if !vseg.Ok() || vseg.End() != oldbrkpg {
+		return false, nil
+	}
+	// The vma must be exactly what Brk would have created, as would be
+	// required to merge a new one into it.
+	ar := usermem.AddrRange{oldbrkpg, newbrkpg}
+	brkVMA := vma{
+		realPerms:      usermem.ReadWrite,
+		effectivePerms: usermem.ReadWrite.Effective(),
+		maxPerms:       usermem.AnyAccess,
+		private:        true,
+		mlockMode:      mm.defMLockMode,
+		numaPolicy:     linux.MPOL_DEFAULT,
+		hint:           "[heap]",
+	}
+	if _, ok := (vmaSetFunctions{}).Merge(vseg.Range(), vseg.Value(), ar, brkVMA); !ok {
+		return false, nil
+	}
+	if !mm.applicationAddrRange().IsSupersetOf(ar) || !vseg.NextGap().availableRange().IsSupersetOf(ar) {
+		// Something is mapped in the way; let createVMALocked fail.
+		return false, nil
+	}
+	length := uint64(ar.Length())
+	if limitAS := limits.FromContext(ctx).Get(limits.AS).Cur; mm.usageAS+length > limitAS {
+		return false, syserror.ENOMEM
+	}
+	vseg.SetEndUnchecked(newbrkpg)
+	mm.usageAS += length
+	mm.dataAS += length
+	return true, nil
+}
+
 // MLock implements the semantics of Linux's mlock()/mlock2()/munlock(),
 // depending on mode.
 func (mm *MemoryManager) MLock(ctx context.Context, addr usermem.Addr, length uint64, mode memmap.MLockMode) error {
@@ -860,6 +934,11 @@ func (mm *MemoryManager) MLock(ctx context.Context, addr usermem.Addr, length ui
 				return syserror.ENOMEM
 			}
 			_, _, err := mm.getPMAsLocked(ctx, vseg, vseg.Range().Intersect(ar), usermem.NoAccess)
+			if _, ok := asUserfaultError(err); ok {
+				// Leave missing pages of vmas registered with a
+				// Userfaultfd to be provided when they're accessed.
+				continue
+			}
 			if err != nil {
 				mm.activeMu.Unlock()
 				mm.mappingMu.RUnlock()
@@ -874,20 +953,29 @@ func (mm *MemoryManager) MLock(ctx context.Context, addr usermem.Addr, length ui
 			}
 		}
 
-		// Map pmas into the active AddressSpace, if we have one.
+		// Ask the host to keep the pmas resident, so that touching them
+		// doesn't fault even if the host is short of memory.
 		mm.mappingMu.RUnlock()
+		mm.activeMu.DowngradeLock()
+		mm.pinPMAsLocked(ar, true)
+
+		// Map pmas into the active AddressSpace, if we have one.
 		if mm.as != nil {
-			mm.activeMu.DowngradeLock()
 			err := mm.mapASLocked(mm.pmas.LowerBoundSegment(ar.Start), ar, true /* precommit */)
 			mm.activeMu.RUnlock()
 			if err != nil {
 				return err
 			}
 		} else {
-			mm.activeMu.Unlock()
+			mm.activeMu.RUnlock()
 		}
 	} else {
 		mm.mappingMu.Unlock()
+		if mode == memmap.MLockNone {
+			mm.activeMu.RLock()
+			mm.pinPMAsLocked(ar, false)
+			mm.activeMu.RUnlock()
+		}
 	}
 
 	return nil
@@ -958,17 +1046,22 @@ func (mm *MemoryManager) MLockAll(ctx context.Context, opts MLockAllOpts) error
 			}
 		}
 
-		// Map all pmas into the active AddressSpace, if we have one.
 		mm.mappingMu.RUnlock()
+		mm.activeMu.DowngradeLock()
+		mm.pinPMAsLocked(mm.applicationAddrRange(), true)
+
+		// Map all pmas into the active AddressSpace, if we have one.
 		if mm.as != nil {
-			mm.activeMu.DowngradeLock()
 			mm.mapASLocked(mm.pmas.FirstSegment(), mm.applicationAddrRange(), true /* precommit */)
-			mm.activeMu.RUnlock()
-		} else {
-			mm.activeMu.Unlock()
 		}
+		mm.activeMu.RUnlock()
 	} else {
 		mm.mappingMu.Unlock()
+		if opts.Current && opts.Mode == memmap.MLockNone {
+			mm.activeMu.RLock()
+			mm.pinPMAsLocked(mm.applicationAddrRange(), false)
+			mm.activeMu.RUnlock()
+		}
 	}
 	return nil
 }
@@ -1093,7 +1186,9 @@ func (mm *MemoryManager) Decommit(addr usermem.Addr, length uint64) error {
 			pma := pseg.ValuePtr()
 			if pma.private && !mm.isPMACopyOnWriteLocked(vseg, pseg) {
 				psegAR := pseg.Range().Intersect(ar)
-				if vsegAR.IsSupersetOf(psegAR) && vma.mappable == nil {
+				// Pages of vmas registered with a Userfaultfd must become
+				// missing, so that accessing them is reported again.
+				if vsegAR.IsSupersetOf(psegAR) && vma.mappable == nil && vma.userfaultfd == nil {
 					if err := mf.Decommit(pseg.fileRangeOf(psegAR)); err == nil {
 						pseg = pseg.NextSegment()
 						continue
@@ -1130,6 +1225,100 @@ func (mm *MemoryManager) Decommit(addr usermem.Addr, length uint64) error {
 	return nil
 }
 
+// FreeLazily implements the semantics of Linux's madvise(MADV_FREE).
+//
+// Rather than decommitting memory immediately, as Decommit does, FreeLazily
+// marks uniquely-owned pmas of private anonymous vmas as evictable, so that
+// they are only decommitted (by MemoryManager.Evict) when the MemoryFile
+// needs the memory back. Touching the memory again before then cancels the
+// free and preserves its contents, so allocators that repeatedly free and
+// reuse the same memory avoid refaulting zeroed pages.
+func (mm *MemoryManager) FreeLazily(addr usermem.Addr, length uint64) error {
+	ar, ok := addr.ToRange(length)
+	if !ok {
+		return syserror.EINVAL
+	}
+
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+
+	// Linux's mm/madvise.c:madvise_free_single_vma() rejects vmas that aren't
+	// private anonymous, and madvise_vma() rejects locked vmas.
+	for vseg := mm.vmas.LowerBoundSegment(ar.Start); vseg.Ok() && vseg.Start() < ar.End; vseg = vseg.NextSegment() {
+		vma := vseg.ValuePtr()
+		if vma.mappable != nil || !vma.private || vma.mlockMode != memmap.MLockNone {
+			return syserror.EINVAL
+		}
+	}
+
+	mm.activeMu.Lock()
+	defer mm.activeMu.Unlock()
+
+	mf := mm.mfp.MemoryFile()
+	var didUnmapAS bool
+	pseg := mm.pmas.LowerBoundSegment(ar.Start)
+	for vseg := mm.vmas.LowerBoundSegment(ar.Start); vseg.Ok() && vseg.Start() < ar.End; vseg = vseg.NextSegment() {
+		vsegAR := vseg.Range().Intersect(ar)
+		for pseg.Ok() && pseg.Start() < vsegAR.End {
+			pma := pseg.ValuePtr()
+			// Pages shared with another MemoryManager by fork may not be
+			// freed; Linux skips them in madvise_free_pte_range() as well.
+			if !pma.private || pma.lazyFree || mm.isPMACopyOnWriteLocked(vseg, pseg) {
+				pseg = pseg.NextSegment()
+				continue
+			}
+			pseg = mm.pmas.Isolate(pseg, vsegAR)
+			pma = pseg.ValuePtr()
+			if !didUnmapAS {
+				// Unmap all of ar, so that the next application access to
+				// the pma faults and cancels the free.
+				mm.unmapASLocked(ar)
+				didUnmapAS = true
+			}
+			pma.lazyFree = true
+			mf.MarkEvictable(mm, pgalloc.EvictableRange{Start: uint64(pseg.Start()), End: uint64(pseg.End())})
+			pseg = pseg.NextSegment()
+		}
+	}
+
+	if mm.vmas.SpanRange(ar) != ar.Length() {
+		return syserror.ENOMEM
+	}
+	return nil
+}
+
+// Evict implements pgalloc.EvictableMemoryUser.Evict. It decommits memory
+// freed by FreeLazily that hasn't been touched since.
+func (mm *MemoryManager) Evict(ctx context.Context, er pgalloc.EvictableRange) {
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+	mm.activeMu.Lock()
+	defer mm.activeMu.Unlock()
+
+	ar := usermem.AddrRange{usermem.Addr(er.Start), usermem.Addr(er.End)}
+	mf := mm.mfp.MemoryFile()
+	for pseg := mm.pmas.LowerBoundSegment(ar.Start); pseg.Ok() && pseg.Start() < ar.End; pseg = pseg.NextSegment() {
+		// Per pgalloc.EvictableMemoryUser.Evict, er may have been marked
+		// unevictable since Evict was called, in which case the pmas it
+		// covers are no longer lazyFree.
+		if !pseg.ValuePtr().lazyFree {
+			continue
+		}
+		vseg := mm.vmas.FindSegment(pseg.Start())
+		pseg = mm.pmas.Isolate(pseg, ar)
+		pma := pseg.ValuePtr()
+		pma.lazyFree = false
+		// The pma may have been shared by fork since FreeLazily.
+		if mm.isPMACopyOnWriteLocked(vseg, pseg) {
+			continue
+		}
+		if err := mf.Decommit(pseg.fileRange()); err != nil {
+			log.Warningf("Failed to decommit memory freed by MADV_FREE at %v: %v", pseg.Range(), err)
+		}
+	}
+	mm.pmas.MergeRange(ar)
+}
+
 // MSyncOpts holds options to MSync.
 type MSyncOpts struct {
 	// Sync has the semantics of MS_SYNC.
@@ -1264,6 +1453,39 @@ func (mm *MemoryManager) VirtualMemorySizeRange(ar usermem.AddrRange) uint64 {
 	return uint64(mm.vmas.SpanRange(ar))
 }
 
+// Mincore implements the semantics of Linux's mincore(2) for the
+// page-aligned range ar. It stores the residency of each page in ar in the
+// corresponding byte of vec, which must have length ar.Length() /
+// usermem.PageSize: 1 if the page is mapped by a pma, and 0 otherwise.
+//
+// The sandbox does not know which pages are resident in host memory, so pmas
+// stand in for the set of resident pages. Residency is filled in one pma at a
+// time, so the cost of Mincore scales with the number of pmas in ar rather
+// than the number of pages.
+func (mm *MemoryManager) Mincore(ar usermem.AddrRange, vec []byte) error {
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+
+	// "ENOMEM: addr to addr + length contained unmapped memory." - mincore(2)
+	if mm.vmas.SpanRange(ar) != ar.Length() {
+		return syserror.ENOMEM
+	}
+
+	mm.activeMu.RLock()
+	defer mm.activeMu.RUnlock()
+	for i := range vec {
+		vec[i] = 0
+	}
+	for pseg := mm.pmas.LowerBoundSegment(ar.Start); pseg.Ok() && pseg.Start() < ar.End; pseg = pseg.NextSegment() {
+		par := pseg.Range().Intersect(ar)
+		resident := vec[(par.Start-ar.Start)/usermem.PageSize : (par.End-ar.Start)/usermem.PageSize]
+		for i := range resident {
+			resident[i] = 1
+		}
+	}
+	return nil
+}
+
 // ResidentSetSize returns the value advertised as mm's RSS in bytes.
 func (mm *MemoryManager) ResidentSetSize() uint64 {
 	mm.activeMu.RLock()
@@ -0,0 +1,573 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package mm
+
+import (
+	"fmt"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/safemem"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/platform"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
+	"gvisor.dev/gvisor/pkg/sync"
+	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+	"gvisor.dev/gvisor/tools/go_marshal/marshal"
+)
+
+// Userfaultfd implements the state of a userfaultfd(2) file for a
+// MemoryManager. Accesses to missing pages of private anonymous vmas
+// registered with a Userfaultfd are reported to the application, which reads
+// them from the file, instead of being satisfied by allocating zeroed pages.
+// The faulting task blocks until the missing pages are provided by
+// UFFDIO_COPY or UFFDIO_ZEROPAGE, or it is woken by UFFDIO_WAKE.
+//
+// Only UFFDIO_REGISTER_MODE_MISSING is supported, and no features (such as
+// fork or remap events) may be requested by UFFDIO_API.
+//
+// +stateify savable
+type Userfaultfd struct {
+	// Queue is notified with EventIn when faults become readable.
+	waiter.Queue `state:"zerovalue"`
+
+	// mm is the MemoryManager whose faults are reported. mm is immutable.
+	mm *MemoryManager
+
+	// mu protects the following fields.
+	mu sync.Mutex `state:"nosave"`
+
+	// ready is true after a successful UFFDIO_API.
+	ready bool
+
+	// released is true after Release is called.
+	released bool
+
+	// pending is the queue of faults that have not yet been read.
+	//
+	// Faults are not saved, since blocked tasks are interrupted by
+	// checkpointing and will fault again after restore.
+	pending []*userfault `state:"nosave"`
+
+	// faults is the set of all faults whose tasks are blocked, including
+	// those in pending.
+	faults map[*userfault]struct{} `state:"nosave"`
+}
+
+// userfault is a fault reported by a Userfaultfd.
+type userfault struct {
+	// addr is the address of the missing page.
+	addr usermem.Addr
+
+	// write is true if the fault was caused by a write.
+	write bool
+
+	// done is closed when the faulting task should retry the access.
+	done chan struct{}
+}
+
+// userfaultError is returned by getPMAsLocked if it can't get a pma for addr
+// because addr is in a vma registered with uffd.
+type userfaultError struct {
+	uffd  *Userfaultfd
+	addr  usermem.Addr
+	write bool
+}
+
+// Error implements error.Error.
+func (e *userfaultError) Error() string {
+	return fmt.Sprintf("missing page at %#x registered with userfaultfd", e.addr)
+}
+
+// asUserfaultError returns err as a *userfaultError, if it is one.
+func asUserfaultError(err error) (*userfaultError, bool) {
+	uerr, ok := err.(*userfaultError)
+	return uerr, ok
+}
+
+// NewUserfaultfd returns a Userfaultfd reporting faults in mm.
+func NewUserfaultfd(mm *MemoryManager) *Userfaultfd {
+	return &Userfaultfd{
+		mm:     mm,
+		faults: make(map[*userfault]struct{}),
+	}
+}
+
+// Release unregisters all vmas registered with u, and wakes all tasks blocked
+// on faults reported by u, as when the last reference on a userfaultfd is
+// dropped.
+func (u *Userfaultfd) Release() {
+	mm := u.mm
+	mm.mappingMu.Lock()
+	for vseg := mm.vmas.FirstSegment(); vseg.Ok(); vseg = vseg.NextSegment() {
+		if vma := vseg.ValuePtr(); vma.userfaultfd == u {
+			vma.userfaultfd = nil
+		}
+	}
+	mm.vmas.MergeRange(mm.applicationAddrRange())
+	mm.mappingMu.Unlock()
+
+	u.mu.Lock()
+	u.released = true
+	u.mu.Unlock()
+	u.wake(mm.applicationAddrRange())
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (u *Userfaultfd) Readiness(mask waiter.EventMask) waiter.EventMask {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	if len(u.pending) != 0 {
+		return mask & waiter.EventIn
+	}
+	return 0
+}
+
+// Read implements read(2) for a userfaultfd, copying as many unread faults to
+// dst as fit, as linux.UffdMsgs. If there are no unread faults, it returns
+// syserror.ErrWouldBlock.
+func (u *Userfaultfd) Read(ctx context.Context, dst usermem.IOSequence) (int64, error) {
+	if dst.NumBytes() < linux.SizeOfUffdMsg {
+		return 0, syserror.EINVAL
+	}
+	u.mu.Lock()
+	if !u.ready {
+		u.mu.Unlock()
+		return 0, syserror.EINVAL
+	}
+	n := int(dst.NumBytes() / linux.SizeOfUffdMsg)
+	if n > len(u.pending) {
+		n = len(u.pending)
+	}
+	if n == 0 {
+		u.mu.Unlock()
+		return 0, syserror.ErrWouldBlock
+	}
+	buf := make([]byte, n*linux.SizeOfUffdMsg)
+	for i, f := range u.pending[:n] {
+		msg := linux.UffdMsg{
+			Event:   linux.UFFD_EVENT_PAGEFAULT,
+			Address: uint64(f.addr),
+		}
+		if f.write {
+			msg.Flags = linux.UFFD_PAGEFAULT_FLAG_WRITE
+		}
+		msg.MarshalBytes(buf[i*linux.SizeOfUffdMsg:])
+	}
+	u.pending = append(u.pending[:0], u.pending[n:]...)
+	u.mu.Unlock()
+
+	written, err := dst.CopyOut(ctx, buf)
+	return int64(written), err
+}
+
+// Ioctl implements ioctl(2) for a userfaultfd. io is the IO for the calling
+// task's address space, from which arguments are copied and to which results
+// are copied.
+func (u *Userfaultfd) Ioctl(ctx context.Context, io usermem.IO, args arch.SyscallArguments) (uintptr, error) {
+	addr := args[2].Pointer()
+	cmd := args[1].Uint()
+
+	if cmd == linux.UFFDIO_API {
+		var api linux.UffdioAPI
+		if err := copyInUffdio(ctx, io, addr, &api); err != nil {
+			return 0, err
+		}
+		// Don't hold u.mu while copying, since the copy may fault on a
+		// page registered with u.
+		u.mu.Lock()
+		ok := !u.ready && api.API == linux.UFFD_API && api.Features == 0
+		u.ready = u.ready || ok
+		u.mu.Unlock()
+		if !ok {
+			// Linux zeroes the reply if the handshake fails.
+			api = linux.UffdioAPI{}
+			if err := copyOutUffdio(ctx, io, addr, &api); err != nil {
+				return 0, err
+			}
+			return 0, syserror.EINVAL
+		}
+		api.Ioctls = linux.UFFD_API_IOCTLS
+		return 0, copyOutUffdio(ctx, io, addr, &api)
+	}
+
+	u.mu.Lock()
+	ready := u.ready
+	u.mu.Unlock()
+	if !ready {
+		return 0, syserror.EINVAL
+	}
+
+	switch cmd {
+	case linux.UFFDIO_REGISTER:
+		var reg linux.UffdioRegister
+		if err := copyInUffdio(ctx, io, addr, &reg); err != nil {
+			return 0, err
+		}
+		if reg.Mode != linux.UFFDIO_REGISTER_MODE_MISSING {
+			return 0, syserror.EINVAL
+		}
+		ar, err := uffdioAddrRange(reg.Range)
+		if err != nil {
+			return 0, err
+		}
+		if err := u.register(ar); err != nil {
+			return 0, err
+		}
+		reg.Ioctls = linux.UFFD_API_RANGE_IOCTLS
+		return 0, copyOutUffdio(ctx, io, addr, &reg)
+
+	case linux.UFFDIO_UNREGISTER:
+		var rng linux.UffdioRange
+		if err := copyInUffdio(ctx, io, addr, &rng); err != nil {
+			return 0, err
+		}
+		ar, err := uffdioAddrRange(rng)
+		if err != nil {
+			return 0, err
+		}
+		return 0, u.unregister(ar)
+
+	case linux.UFFDIO_WAKE:
+		var rng linux.UffdioRange
+		if err := copyInUffdio(ctx, io, addr, &rng); err != nil {
+			return 0, err
+		}
+		ar, err := uffdioAddrRange(rng)
+		if err != nil {
+			return 0, err
+		}
+		u.wake(ar)
+		return 0, nil
+
+	case linux.UFFDIO_COPY:
+		var cp linux.UffdioCopy
+		if err := copyInUffdio(ctx, io, addr, &cp); err != nil {
+			return 0, err
+		}
+		if cp.Mode&^linux.UFFDIO_COPY_MODE_DONTWAKE != 0 {
+			return 0, syserror.EINVAL
+		}
+		ar, err := uffdioAddrRange(linux.UffdioRange{Start: cp.Dst, Len: cp.Len})
+		if err != nil {
+			return 0, err
+		}
+		srcAR, ok := usermem.Addr(cp.Src).ToRange(cp.Len)
+		if !ok {
+			return 0, syserror.EINVAL
+		}
+		src := usermem.IOSequence{
+			IO:    io,
+			Addrs: usermem.AddrRangeSeqOf(srcAR),
+			Opts: usermem.IOOpts{
+				AddressSpaceActive: true,
+			},
+		}
+		n, err := u.fill(ctx, ar, &src, cp.Mode&linux.UFFDIO_COPY_MODE_DONTWAKE == 0)
+		return 0, uffdioResult(ctx, io, addr, &cp, &cp.Copy, n, cp.Len, err)
+
+	case linux.UFFDIO_ZEROPAGE:
+		var zp linux.UffdioZeropage
+		if err := copyInUffdio(ctx, io, addr, &zp); err != nil {
+			return 0, err
+		}
+		if zp.Mode&^linux.UFFDIO_ZEROPAGE_MODE_DONTWAKE != 0 {
+			return 0, syserror.EINVAL
+		}
+		ar, err := uffdioAddrRange(zp.Range)
+		if err != nil {
+			return 0, err
+		}
+		n, err := u.fill(ctx, ar, nil, zp.Mode&linux.UFFDIO_ZEROPAGE_MODE_DONTWAKE == 0)
+		return 0, uffdioResult(ctx, io, addr, &zp, &zp.Zeropage, n, zp.Range.Len, err)
+
+	default:
+		return 0, syserror.ENOTTY
+	}
+}
+
+// copyInUffdio copies a userfaultfd ioctl argument from addr.
+func copyInUffdio(ctx context.Context, io usermem.IO, addr usermem.Addr, v marshal.Marshallable) error {
+	buf := make([]byte, v.SizeBytes())
+	if _, err := io.CopyIn(ctx, addr, buf, usermem.IOOpts{AddressSpaceActive: true}); err != nil {
+		return err
+	}
+	v.UnmarshalBytes(buf)
+	return nil
+}
+
+// copyOutUffdio copies a userfaultfd ioctl result to addr.
+func copyOutUffdio(ctx context.Context, io usermem.IO, addr usermem.Addr, v marshal.Marshallable) error {
+	buf := make([]byte, v.SizeBytes())
+	v.MarshalBytes(buf)
+	_, err := io.CopyOut(ctx, addr, buf, usermem.IOOpts{AddressSpaceActive: true})
+	return err
+}
+
+// uffdioAddrRange returns the AddrRange described by rng, which must be
+// non-empty and page-aligned.
+func uffdioAddrRange(rng linux.UffdioRange) (usermem.AddrRange, error) {
+	ar, ok := usermem.Addr(rng.Start).ToRange(rng.Len)
+	if !ok || ar.Length() == 0 || !ar.IsPageAligned() {
+		return usermem.AddrRange{}, syserror.EINVAL
+	}
+	return ar, nil
+}
+
+// uffdioResult reports the result of UFFDIO_COPY or UFFDIO_ZEROPAGE, which
+// provided n of length bytes, in *result and copies v, which contains result,
+// out to addr. As in Linux, if some but not all bytes were provided, the
+// ioctl fails with EAGAIN.
+func uffdioResult(ctx context.Context, io usermem.IO, addr usermem.Addr, v marshal.Marshallable, result *int64, n, length uint64, err error) error {
+	if n == 0 && err != nil {
+		if errno, ok := syserror.TranslateError(err); ok {
+			*result = -int64(errno)
+		}
+	} else {
+		*result = int64(n)
+	}
+	if cerr := copyOutUffdio(ctx, io, addr, v); cerr != nil {
+		return cerr
+	}
+	if n == 0 {
+		return err
+	}
+	if n != length {
+		return syserror.EAGAIN
+	}
+	return nil
+}
+
+// register implements UFFDIO_REGISTER with UFFDIO_REGISTER_MODE_MISSING for
+// ar, which must be page-aligned.
+func (u *Userfaultfd) register(ar usermem.AddrRange) error {
+	mm := u.mm
+	mm.mappingMu.Lock()
+	defer mm.mappingMu.Unlock()
+
+	// Check that all vmas in ar can be registered before modifying any.
+	found := false
+	for vseg := mm.vmas.LowerBoundSegment(ar.Start); vseg.Ok() && vseg.Start() < ar.End; vseg = vseg.NextSegment() {
+		vma := vseg.ValuePtr()
+		// Linux also supports shared memory and hugetlbfs mappings.
+		if vma.mappable != nil || !vma.private {
+			return syserror.EINVAL
+		}
+		if vma.userfaultfd != nil && vma.userfaultfd != u {
+			return syserror.EBUSY
+		}
+		found = true
+	}
+	if !found {
+		return syserror.EINVAL
+	}
+
+	for vseg := mm.vmas.LowerBoundSegment(ar.Start); vseg.Ok() && vseg.Start() < ar.End; vseg = vseg.NextSegment() {
+		vseg = mm.vmas.Isolate(vseg, ar)
+		vseg.ValuePtr().userfaultfd = u
+	}
+	mm.vmas.MergeRange(ar)
+	mm.vmas.MergeAdjacent(ar)
+	return nil
+}
+
+// unregister implements UFFDIO_UNREGISTER for ar, which must be page-aligned.
+func (u *Userfaultfd) unregister(ar usermem.AddrRange) error {
+	mm := u.mm
+	mm.mappingMu.Lock()
+	for vseg := mm.vmas.LowerBoundSegment(ar.Start); vseg.Ok() && vseg.Start() < ar.End; vseg = vseg.NextSegment() {
+		if vseg.ValuePtr().userfaultfd != u {
+			continue
+		}
+		vseg = mm.vmas.Isolate(vseg, ar)
+		vseg.ValuePtr().userfaultfd = nil
+	}
+	mm.vmas.MergeRange(ar)
+	mm.vmas.MergeAdjacent(ar)
+	mm.mappingMu.Unlock()
+
+	// Blocked tasks will no longer get faults reported when they retry.
+	u.wake(ar)
+	return nil
+}
+
+// fill implements UFFDIO_COPY, if src is not nil, and UFFDIO_ZEROPAGE, if src
+// is nil. It provides pages for the missing addresses at the start of ar,
+// which must be page-aligned and within a single vma registered with u,
+// filled from src or zeroed respectively. It returns the number of bytes
+// provided, stopping at the first address that already has a page. If wake is
+// true, it then wakes tasks blocked on faults on the provided pages.
+func (u *Userfaultfd) fill(ctx context.Context, ar usermem.AddrRange, src *usermem.IOSequence, wake bool) (uint64, error) {
+	mm := u.mm
+	mf := mm.mfp.MemoryFile()
+
+	// Fill new memory before locking mm, since src may be in mm.
+	var fr platform.FileRange
+	var err error
+	if src != nil {
+		fr, err = mf.AllocateAndFill(uint64(ar.Length()), usage.Anonymous, safemem.FromIOReader{src.Reader(ctx)})
+		if err != nil {
+			if fr.Length() != 0 {
+				mf.DecRef(fr)
+			}
+			return 0, syserror.EFAULT
+		}
+	} else {
+		fr, err = mf.Allocate(uint64(ar.Length()), usage.Anonymous)
+		if err != nil {
+			return 0, err
+		}
+	}
+
+	mm.mappingMu.RLock()
+	mm.activeMu.Lock()
+	vseg := mm.vmas.FindSegment(ar.Start)
+	if !vseg.Ok() || vseg.End() < ar.End || vseg.ValuePtr().userfaultfd != u {
+		mm.activeMu.Unlock()
+		mm.mappingMu.RUnlock()
+		mf.DecRef(fr)
+		return 0, syserror.ENOENT
+	}
+	vma := vseg.ValuePtr()
+	pseg, pgap := mm.pmas.Find(ar.Start)
+	if pseg.Ok() {
+		mm.activeMu.Unlock()
+		mm.mappingMu.RUnlock()
+		mf.DecRef(fr)
+		return 0, syserror.EEXIST
+	}
+	fillAR := ar
+	if pgap.End() < fillAR.End {
+		fillAR.End = pgap.End()
+	}
+	fillFR := platform.FileRange{fr.Start, fr.Start + uint64(fillAR.Length())}
+	// As in getPMAsInternalLocked, mm's private reference takes over the
+	// reference returned by Allocate, and the pma holds another.
+	mm.addRSSLocked(fillAR)
+	mm.incPrivateRef(fillFR)
+	mf.IncRef(fillFR)
+	mm.pmas.Insert(pgap, fillAR, pma{
+		file:           mf,
+		off:            fillFR.Start,
+		translatePerms: usermem.AnyAccess,
+		effectivePerms: vma.effectivePerms,
+		maxPerms:       vma.maxPerms,
+		private:        true,
+	})
+	mm.activeMu.Unlock()
+	mm.mappingMu.RUnlock()
+	if fillFR.End != fr.End {
+		mf.DecRef(platform.FileRange{fillFR.End, fr.End})
+	}
+
+	if wake {
+		u.wake(fillAR)
+	}
+	return uint64(fillAR.Length()), nil
+}
+
+// wake wakes tasks blocked on faults in ar, which will retry their accesses.
+func (u *Userfaultfd) wake(ar usermem.AddrRange) {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	for f := range u.faults {
+		if ar.Contains(f.addr) {
+			close(f.done)
+			delete(u.faults, f)
+		}
+	}
+	pending := u.pending[:0]
+	for _, f := range u.pending {
+		if !ar.Contains(f.addr) {
+			pending = append(pending, f)
+		}
+	}
+	u.pending = pending
+}
+
+// remove stops reporting f without waking its task.
+func (u *Userfaultfd) remove(f *userfault) {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	delete(u.faults, f)
+	for i, pf := range u.pending {
+		if pf == f {
+			u.pending = append(u.pending[:i], u.pending[i+1:]...)
+			break
+		}
+	}
+}
+
+// wait reports the fault described by e, then blocks until the fault is
+// resolved, woken, or interrupted. When wait returns, the faulting access
+// should be retried.
+//
+// Preconditions: mm.mappingMu and mm.activeMu must be unlocked.
+func (e *userfaultError) wait(ctx context.Context) {
+	u := e.uffd
+	f := &userfault{
+		addr:  e.addr.RoundDown(),
+		write: e.write,
+		done:  make(chan struct{}),
+	}
+	u.mu.Lock()
+	if u.released {
+		u.mu.Unlock()
+		return
+	}
+	if u.faults == nil {
+		u.faults = make(map[*userfault]struct{})
+	}
+	u.faults[f] = struct{}{}
+	u.pending = append(u.pending, f)
+	u.mu.Unlock()
+
+	// The page may have been provided, or its vma unregistered, between
+	// getPMAsLocked and f being queued above. Since fill and unregister
+	// update mm before waking, checking again after queueing f ensures that
+	// either we observe the update or it wakes f.
+	if !u.mm.isUserfaultMissing(u, f.addr) {
+		u.remove(f)
+		return
+	}
+	u.Notify(waiter.EventIn)
+
+	cancel := ctx.SleepStart()
+	select {
+	case <-f.done:
+		ctx.SleepFinish(true)
+	case <-cancel:
+		ctx.SleepFinish(false)
+		// Withdraw the fault; the access will fault again after the
+		// interruption is handled.
+		u.remove(f)
+	}
+}
+
+// isUserfaultMissing returns true if the page at addr has no pma and is in a
+// vma registered with u.
+func (mm *MemoryManager) isUserfaultMissing(u *Userfaultfd, addr usermem.Addr) bool {
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+	vseg := mm.vmas.FindSegment(addr)
+	if !vseg.Ok() || vseg.ValuePtr().userfaultfd != u {
+		return false
+	}
+	mm.activeMu.RLock()
+	defer mm.activeMu.RUnlock()
+	return !mm.pmas.FindSegment(addr).Ok()
+}
@@ -23,6 +23,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
 	"gvisor.dev/gvisor/pkg/sentry/limits"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
 	"gvisor.dev/gvisor/pkg/syserror"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
@@ -412,6 +413,18 @@ func (vma *vma) isPrivateDataLocked() bool {
 	return vma.realPerms.Write && vma.private && !vma.growsDown
 }
 
+// numaPolicyForLocked returns the NUMA policy governing memory allocated for
+// vma on behalf of ctx: vma's own policy if set by mbind(2), or the calling
+// thread's policy otherwise.
+//
+// Preconditions: mm.mappingMu must be locked.
+func (vma *vma) numaPolicyForLocked(ctx context.Context) pgalloc.NUMAPolicy {
+	if policy := (pgalloc.NUMAPolicy{Mode: vma.numaPolicy, Nodemask: vma.numaNodemask}); !policy.IsDefault() {
+		return policy
+	}
+	return pgalloc.NUMAPolicyFromContext(ctx)
+}
+
 // vmaSetFunctions implements segment.Functions for vmaSet.
 type vmaSetFunctions struct{}
 
@@ -440,6 +453,7 @@ func (vmaSetFunctions) Merge(ar1 usermem.AddrRange, vma1 vma, ar2 usermem.AddrRa
 		vma1.numaPolicy != vma2.numaPolicy ||
 		vma1.numaNodemask != vma2.numaNodemask ||
 		vma1.dontfork != vma2.dontfork ||
+		vma1.userfaultfd != vma2.userfaultfd ||
 		vma1.id != vma2.id ||
 		vma1.hint != vma2.hint {
 		return vma{}, false
@@ -27,6 +27,10 @@ const (
 
 	// CtxMemoryFileProvider is a Context.Value key for a MemoryFileProvider.
 	CtxMemoryFileProvider
+
+	// CtxNUMAPolicy is a Context.Value key for the NUMAPolicy of the thread
+	// on whose behalf memory is allocated.
+	CtxNUMAPolicy
 )
 
 // MemoryFileFromContext returns the MemoryFile used by ctx, or nil if no such
@@ -0,0 +1,121 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package pgalloc
+
+import (
+	"fmt"
+	"sync/atomic"
+	"syscall"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/log"
+	"gvisor.dev/gvisor/pkg/sentry/hostmm"
+	"gvisor.dev/gvisor/pkg/sentry/platform"
+)
+
+// NUMAPolicy is a NUMA memory policy, as set by set_mempolicy(2) or mbind(2).
+// The zero value of NUMAPolicy is MPOL_DEFAULT.
+type NUMAPolicy struct {
+	// Mode is the policy mode, including mode flags.
+	Mode linux.NumaPolicy
+
+	// Nodemask is the set of NUMA nodes used by the policy.
+	Nodemask uint64
+}
+
+// IsDefault returns true if p is MPOL_DEFAULT.
+func (p NUMAPolicy) IsDefault() bool {
+	return p.Mode&^linux.MPOL_MODE_FLAGS == linux.MPOL_DEFAULT
+}
+
+// NUMAPolicyFromContext returns the NUMA memory policy of the thread on whose
+// behalf memory is allocated by ctx, or MPOL_DEFAULT if ctx has none.
+func NUMAPolicyFromContext(ctx context.Context) NUMAPolicy {
+	if v := ctx.Value(CtxNUMAPolicy); v != nil {
+		return v.(NUMAPolicy)
+	}
+	return NUMAPolicy{}
+}
+
+// initNUMA initializes f.numaNodes.
+func (f *MemoryFile) initNUMA() {
+	f.numaNodes = 1
+	if !f.opts.NUMA {
+		return
+	}
+	nodes, err := hostmm.AllowedNUMANodes()
+	if err != nil {
+		log.Warningf("Failed to get host NUMA nodes, reporting a single node: %v", err)
+		return
+	}
+	if nodes == 0 {
+		log.Warningf("No host NUMA nodes below 64 are allowed, reporting a single node")
+		return
+	}
+	f.numaNodes = nodes
+}
+
+// NUMANodes returns the set of NUMA nodes that memory allocated from f may be
+// placed on. Unless MemoryFileOpts.NUMA is true, this is always node 0 alone.
+func (f *MemoryFile) NUMANodes() uint64 {
+	return f.numaNodes
+}
+
+// NUMAEnabled returns true if SetNUMAPolicy may have an effect.
+func (f *MemoryFile) NUMAEnabled() bool {
+	return f.opts.NUMA && f.numaNodes&(f.numaNodes-1) != 0
+}
+
+// SetNUMAPolicy requests that pages of fr that are committed after the call
+// are placed on host NUMA nodes according to policy. fr must have been
+// allocated by a call to Allocate that is not yet followed by a write to fr.
+// The policy remains in effect until fr is freed.
+func (f *MemoryFile) SetNUMAPolicy(fr platform.FileRange, policy NUMAPolicy) {
+	if !f.NUMAEnabled() || policy.IsDefault() {
+		return
+	}
+	atomic.StoreUint32(&f.numaPolicySet, 1)
+	if err := f.bindNUMAPolicy(fr, policy); err != nil {
+		log.Warningf("Failed to set NUMA policy %+v for %v: %v", policy, fr, err)
+	}
+}
+
+// resetNUMAPolicy restores the default NUMA policy for fr, which must be
+// reclaimable, so that its policy isn't inherited by its next allocation.
+func (f *MemoryFile) resetNUMAPolicy(fr platform.FileRange) {
+	if atomic.LoadUint32(&f.numaPolicySet) == 0 {
+		return
+	}
+	if err := f.bindNUMAPolicy(fr, NUMAPolicy{}); err != nil {
+		log.Warningf("Failed to reset NUMA policy for %v: %v", fr, err)
+	}
+}
+
+// bindNUMAPolicy sets the shared policy of fr in the host, which applies to
+// all mappings of f. A temporary mapping of fr is used, rather than f's
+// internal mappings, since setting the policy for part of a mapping splits it
+// in the host.
+func (f *MemoryFile) bindNUMAPolicy(fr platform.FileRange, policy NUMAPolicy) error {
+	addr, _, errno := syscall.Syscall6(syscall.SYS_MMAP, 0, uintptr(fr.Length()), syscall.PROT_READ, syscall.MAP_SHARED, f.file.Fd(), uintptr(fr.Start))
+	if errno != 0 {
+		return fmt.Errorf("failed to map %v: %v", fr, errno)
+	}
+	err := hostmm.BindNUMAPolicy(addr, uintptr(fr.Length()), int32(policy.Mode), policy.Nodemask)
+	if _, _, errno := syscall.Syscall(syscall.SYS_MUNMAP, addr, uintptr(fr.Length()), 0); errno != 0 {
+		panic(fmt.Sprintf("failed to unmap %v at %#x: %v", fr, addr, errno))
+	}
+	return err
+}
@@ -25,6 +25,7 @@ import (
 	"fmt"
 	"math"
 	"os"
+	"runtime"
 	"sync/atomic"
 	"syscall"
 	"time"
@@ -90,6 +91,14 @@ type MemoryFile struct {
 	// usage is protected by mu.
 	usage usageSet
 
+	// uncommitted contains exactly the ranges in usage whose knownCommitted
+	// is false, so that UpdateUsage can scan them without walking all of
+	// usage, which has a segment for each of the many small allocations made
+	// by applications with many mappings.
+	//
+	// uncommitted is protected by mu.
+	uncommitted uncommittedSet
+
 	// The UpdateUsage function scans all segments with knownCommitted set
 	// to false, sees which pages are committed and creates corresponding
 	// segments with knownCommitted set to true.
@@ -153,9 +162,15 @@ type MemoryFile struct {
 	minReclaimablePage uint64
 
 	// reclaimCond is signaled (with mu locked) when reclaimable or destroyed
-	// transitions from false to true.
+	// transitions from false to true, or when pendingDecRefs becomes
+	// non-empty.
 	reclaimCond sync.Cond
 
+	// pendingDecRefs holds ranges passed to DecRefAsync on which the
+	// reclaimer goroutine has yet to release a reference. pendingDecRefs is
+	// protected by mu.
+	pendingDecRefs []platform.FileRange
+
 	// evictable maps EvictableMemoryUsers to eviction state.
 	//
 	// evictable is protected by mu.
@@ -164,6 +179,27 @@ type MemoryFile struct {
 	// evictionWG counts the number of goroutines currently performing evictions.
 	evictionWG sync.WaitGroup
 
+	// numaNodes is the set of NUMA nodes returned by NUMANodes. numaNodes is
+	// immutable.
+	numaNodes uint64
+
+	// numaPolicySet is non-zero if SetNUMAPolicy has ever set a policy, such
+	// that reclaimed pages must have their policy reset. numaPolicySet is
+	// accessed using atomic memory operations.
+	numaPolicySet uint32
+
+	// pinned is non-zero if Pin has ever been called, such that reclaimed
+	// pages must be unpinned. pinned is accessed using atomic memory
+	// operations.
+	pinned uint32
+
+	// pinWarnOnce is used to log the first failure to pin memory in the host.
+	pinWarnOnce sync.Once
+
+	// hugepages is true if the host may back f with transparent hugepages.
+	// hugepages is immutable.
+	hugepages bool
+
 	// stopNotifyPressure stops memory cgroup pressure level
 	// notifications used to drive eviction. stopNotifyPressure is
 	// immutable.
@@ -181,10 +217,36 @@ type MemoryFileOpts struct {
 	// no effect unless DelayedEviction is DelayedEvictionEnabled.
 	UseHostMemcgPressure bool
 
+	// If UseExternalPressure is true, evictions are delayed until
+	// MemoryFile.StartEvictions() is called by a memory pressure controller
+	// that watches the sandbox's usage (see
+	// pkg/sentry/kernel/mempressure). This option has no effect unless
+	// DelayedEviction is DelayedEvictionEnabled.
+	UseExternalPressure bool
+
 	// If ManualZeroing is true, MemoryFile must not assume that new pages
 	// obtained from the host are zero-filled, such that MemoryFile must manually
 	// zero newly-allocated pages.
 	ManualZeroing bool
+
+	// If NUMA is true, MemoryFile reports the host NUMA nodes that the
+	// calling process may allocate memory from, and honors NUMA policies
+	// passed to SetNUMAPolicy. Otherwise, MemoryFile reports a single node.
+	NUMA bool
+
+	// DecommitBatchSize is the maximum number of bytes of freed pages that
+	// the reclaimer goroutine decommits between acquisitions of the
+	// MemoryFile's lock. Larger batches amortize locking over more freed
+	// ranges; smaller batches return the lowest freed pages for allocation
+	// sooner. If DecommitBatchSize is 0, defaultDecommitBatchSize is used.
+	DecommitBatchSize uint64
+
+	// DecommitDelay is the time that the idle reclaimer goroutine waits after
+	// pages are freed before decommitting them, so that ranges freed in
+	// quick succession (e.g. by the munmap of many small allocations) are
+	// decommitted in the same batch. If DecommitDelay is 0, freed pages are
+	// decommitted as soon as possible.
+	DecommitDelay time.Duration
 }
 
 // DelayedEvictionType is the type of MemoryFileOpts.DelayedEviction.
@@ -208,6 +270,9 @@ const (
 	// - If UseHostMemcgPressure is true, evictions are delayed until memory
 	// pressure is indicated.
 	//
+	// - If UseExternalPressure is true, evictions are delayed until
+	// StartEvictions is called.
+	//
 	// - Otherwise, evictions are only delayed until the reclaimer goroutine
 	// is out of work (pages to reclaim).
 	DelayedEvictionEnabled
@@ -279,6 +344,15 @@ const (
 
 	initialSize = chunkSize
 
+	// defaultDecommitBatchSize is the default value of
+	// MemoryFileOpts.DecommitBatchSize.
+	defaultDecommitBatchSize = 4 * chunkSize
+
+	// pendingDecRefsBatch is the maximum number of ranges passed to
+	// DecRefAsync that the reclaimer goroutine releases without unlocking
+	// MemoryFile.mu.
+	pendingDecRefsBatch = 1024
+
 	// maxPage is the highest 64-bit page.
 	maxPage = math.MaxUint64 &^ (usermem.PageSize - 1)
 )
@@ -292,11 +366,22 @@ func NewMemoryFile(file *os.File, opts MemoryFileOpts) (*MemoryFile, error) {
 		opts.DelayedEviction = DelayedEvictionEnabled
 	case DelayedEvictionDisabled, DelayedEvictionManual:
 		opts.UseHostMemcgPressure = false
+		opts.UseExternalPressure = false
 	case DelayedEvictionEnabled:
 		// ok
 	default:
 		return nil, fmt.Errorf("invalid MemoryFileOpts.DelayedEviction: %v", opts.DelayedEviction)
 	}
+	if opts.DecommitBatchSize == 0 {
+		opts.DecommitBatchSize = defaultDecommitBatchSize
+	}
+	if opts.DecommitBatchSize < usermem.PageSize {
+		return nil, fmt.Errorf("invalid MemoryFileOpts.DecommitBatchSize: %d is smaller than a page", opts.DecommitBatchSize)
+	}
+	opts.DecommitBatchSize &^= usermem.PageSize - 1
+	if opts.DecommitDelay < 0 {
+		return nil, fmt.Errorf("invalid MemoryFileOpts.DecommitDelay: %v", opts.DecommitDelay)
+	}
 
 	// Truncate the file to 0 bytes first to ensure that it's empty.
 	if err := file.Truncate(0); err != nil {
@@ -316,6 +401,13 @@ func NewMemoryFile(file *os.File, opts MemoryFileOpts) (*MemoryFile, error) {
 	}
 	f.mappings.Store(make([]uintptr, initialSize/chunkSize))
 	f.reclaimCond.L = &f.mu
+	f.initNUMA()
+
+	if hugepages, err := hostmm.ShmemHugepagesEnabled(); err != nil {
+		log.Debugf("Failed to get host shmem hugepage policy, assuming hugepages are disabled: %v", err)
+	} else {
+		f.hugepages = hugepages
+	}
 
 	if f.opts.DelayedEviction == DelayedEvictionEnabled && f.opts.UseHostMemcgPressure {
 		stop, err := hostmm.NotifyCurrentMemcgPressureCallback(func() {
@@ -452,6 +544,9 @@ func (f *MemoryFile) Allocate(length uint64, kind usage.MemoryKind) (platform.Fi
 	}) {
 		panic(fmt.Sprintf("allocating %v: failed to insert into usage set:\n%v", fr, &f.usage))
 	}
+	if !f.uncommitted.Add(fr, uncommittedSetValue{}) {
+		panic(fmt.Sprintf("allocating %v: failed to insert into uncommitted set:\n%v", fr, &f.uncommitted))
+	}
 
 	if minUnallocatedPage < start {
 		f.minUnallocatedPage = minUnallocatedPage
@@ -542,24 +637,30 @@ func (f *MemoryFile) Decommit(fr platform.FileRange) error {
 		panic(fmt.Sprintf("invalid range: %v", fr))
 	}
 
+	if err := f.decommitFile(fr); err != nil {
+		return err
+	}
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	f.markDecommittedLocked(fr)
+	return nil
+}
+
+// decommitFile releases the host's resources for the given pages of the
+// backing file, without updating usage.
+func (f *MemoryFile) decommitFile(fr platform.FileRange) error {
 	// "After a successful call, subsequent reads from this range will
 	// return zeroes. The FALLOC_FL_PUNCH_HOLE flag must be ORed with
 	// FALLOC_FL_KEEP_SIZE in mode ..." - fallocate(2)
-	err := syscall.Fallocate(
+	return syscall.Fallocate(
 		int(f.file.Fd()),
 		_FALLOC_FL_PUNCH_HOLE|_FALLOC_FL_KEEP_SIZE,
 		int64(fr.Start),
 		int64(fr.Length()))
-	if err != nil {
-		return err
-	}
-	f.markDecommitted(fr)
-	return nil
 }
 
-func (f *MemoryFile) markDecommitted(fr platform.FileRange) {
-	f.mu.Lock()
-	defer f.mu.Unlock()
+// Preconditions: f.mu must be locked.
+func (f *MemoryFile) markDecommittedLocked(fr platform.FileRange) {
 	// Since we're changing the knownCommitted attribute, we need to merge
 	// across the entire range to ensure that the usage tree is minimal.
 	gap := f.usage.ApplyContiguous(fr, func(seg usageIterator) {
@@ -570,6 +671,7 @@ func (f *MemoryFile) markDecommitted(fr platform.FileRange) {
 			usage.MemoryAccounting.Dec(amount, val.kind)
 			f.usageExpected -= amount
 			val.knownCommitted = false
+			f.uncommitted.Add(seg.Range(), uncommittedSetValue{})
 		}
 	})
 	if gap.Ok() {
@@ -578,6 +680,57 @@ func (f *MemoryFile) markDecommitted(fr platform.FileRange) {
 	f.usage.MergeRange(fr)
 }
 
+// Pin requests that the host keep the pages in fr resident, as by mlock(2),
+// until they are unpinned by Unpin or freed. Pins are not counted: a single
+// call to Unpin unpins pages however many times they have been pinned.
+//
+// Pin is best-effort. The host may refuse to pin memory, e.g. due to its
+// RLIMIT_MEMLOCK, in which case Pin has no effect.
+//
+// Preconditions: fr must be page-aligned and allocated.
+func (f *MemoryFile) Pin(fr platform.FileRange) {
+	if !fr.WellFormed() || fr.Length() == 0 || fr.Start%usermem.PageSize != 0 || fr.End%usermem.PageSize != 0 {
+		panic(fmt.Sprintf("invalid range: %v", fr))
+	}
+	atomic.StoreUint32(&f.pinned, 1)
+	var err error
+	if merr := f.forEachMappingSlice(fr, func(bs []byte) {
+		if err == nil {
+			err = syscall.Mlock(bs)
+		}
+	}); merr != nil {
+		err = merr
+	}
+	if err != nil {
+		f.pinWarnOnce.Do(func() {
+			log.Warningf("Failed to pin %v in host memory, mlocked memory may not be resident: %v", fr, err)
+		})
+	}
+}
+
+// Unpin reverses the effect of previous calls to Pin on fr.
+//
+// Preconditions: fr must be page-aligned and allocated.
+func (f *MemoryFile) Unpin(fr platform.FileRange) {
+	if !fr.WellFormed() || fr.Length() == 0 || fr.Start%usermem.PageSize != 0 || fr.End%usermem.PageSize != 0 {
+		panic(fmt.Sprintf("invalid range: %v", fr))
+	}
+	if atomic.LoadUint32(&f.pinned) == 0 {
+		return
+	}
+	if err := f.forEachMappingSlice(fr, func(bs []byte) {
+		syscall.Munlock(bs)
+	}); err != nil {
+		log.Warningf("Failed to unpin %v: %v", fr, err)
+	}
+}
+
+// HugepagesEnabled returns true if the host may back ranges allocated by f
+// whose start and end are hugepage-aligned with transparent hugepages.
+func (f *MemoryFile) HugepagesEnabled() bool {
+	return f.hugepages
+}
+
 // IncRef implements platform.File.IncRef.
 func (f *MemoryFile) IncRef(fr platform.FileRange) {
 	if !fr.WellFormed() || fr.Length() == 0 || fr.Start%usermem.PageSize != 0 || fr.End%usermem.PageSize != 0 {
@@ -603,11 +756,35 @@ func (f *MemoryFile) DecRef(fr platform.FileRange) {
 		panic(fmt.Sprintf("invalid range: %v", fr))
 	}
 
-	var freed bool
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	f.decRefLocked(fr)
+}
+
+// DecRefAsync releases a reference on each range in frs, as if by DecRef, but
+// may do so after it returns, from the reclaimer goroutine. It is intended for
+// callers that release a large amount of memory at once, such as the
+// teardown of an exiting process's address space, and would rather not wait
+// for it.
+func (f *MemoryFile) DecRefAsync(frs []platform.FileRange) {
+	if len(frs) == 0 {
+		return
+	}
+	for _, fr := range frs {
+		if !fr.WellFormed() || fr.Length() == 0 || fr.Start%usermem.PageSize != 0 || fr.End%usermem.PageSize != 0 {
+			panic(fmt.Sprintf("invalid range: %v", fr))
+		}
+	}
 
 	f.mu.Lock()
 	defer f.mu.Unlock()
+	f.pendingDecRefs = append(f.pendingDecRefs, frs...)
+	f.reclaimCond.Signal()
+}
 
+// Preconditions: f.mu must be locked.
+func (f *MemoryFile) decRefLocked(fr platform.FileRange) {
+	var freed bool
 	for seg := f.usage.FindSegment(fr.Start); seg.Ok() && seg.Start() < fr.End; seg = seg.NextSegment() {
 		seg = f.usage.Isolate(seg, fr)
 		val := seg.ValuePtr()
@@ -710,6 +887,11 @@ func (f *MemoryFile) getChunkMapping(chunk int) ([]uintptr, uintptr, error) {
 	if errno != 0 {
 		return nil, 0, errno
 	}
+	// Allow the host to back the chunk with transparent hugepages if its
+	// shmem hugepage policy is "advise"; Allocate aligns allocations of a
+	// hugepage or more so that they can be backed by whole hugepages. This
+	// is unnecessary under other policies, so errors are ignored.
+	syscall.Syscall(syscall.SYS_MADVISE, m, chunkSize, syscall.MADV_HUGEPAGE)
 	atomic.StoreUintptr(&mappings[chunk], m)
 	return mappings, m, nil
 }
@@ -741,7 +923,7 @@ func (f *MemoryFile) MarkEvictable(user EvictableMemoryUser, er EvictableRange)
 			// Kick off eviction immediately.
 			f.startEvictionGoroutineLocked(user, info)
 		case DelayedEvictionEnabled:
-			if !f.opts.UseHostMemcgPressure {
+			if f.evictsWhenIdle() {
 				// Ensure that the reclaimer goroutine is running, so that it
 				// can start eviction when necessary.
 				f.reclaimCond.Signal()
@@ -799,7 +981,14 @@ func (f *MemoryFile) MarkAllUnevictable(user EvictableMemoryUser) {
 // evictable memory. The value returned by ShouldCacheEvictable may change
 // between calls.
 func (f *MemoryFile) ShouldCacheEvictable() bool {
-	return f.opts.DelayedEviction == DelayedEvictionManual || f.opts.UseHostMemcgPressure
+	return f.opts.DelayedEviction == DelayedEvictionManual || f.opts.UseHostMemcgPressure || f.opts.UseExternalPressure
+}
+
+// evictsWhenIdle returns true if evictable allocations are evicted whenever
+// the reclaimer goroutine runs out of work, rather than when memory pressure
+// is indicated.
+func (f *MemoryFile) evictsWhenIdle() bool {
+	return f.opts.DelayedEviction == DelayedEvictionEnabled && !f.opts.UseHostMemcgPressure && !f.opts.UseExternalPressure
 }
 
 // UpdateUsage ensures that the memory usage statistics in
@@ -876,106 +1065,114 @@ func (f *MemoryFile) updateUsageLocked(currentUsage uint64, checkCommitted func(
 	// Reused mincore buffer, will generally be <= 4096 bytes.
 	var buf []byte
 
-	// Iterate over all usage data. There will only be usage segments
-	// present when there is an associated reference.
-	for seg := f.usage.FirstSegment(); seg.Ok(); seg = seg.NextSegment() {
-		val := seg.Value()
+	// Iterate over all usage data that is not known to be committed. There
+	// will only be usage segments present when there is an associated
+	// reference.
+	for useg := f.uncommitted.FirstSegment(); useg.Ok(); {
+		ur := useg.Range()
+		for seg := f.usage.FindSegment(ur.Start); seg.Ok() && seg.Start() < ur.End; seg = seg.NextSegment() {
+			val := seg.Value()
 
-		// Already known to be committed; ignore.
-		if val.knownCommitted {
-			continue
-		}
-
-		// Assume that reclaimable pages (that aren't already known to be
-		// committed) are not committed. This isn't necessarily true, even
-		// after the reclaimer does Decommit(), because the kernel may
-		// subsequently back the hugepage-sized region containing the
-		// decommitted page with a hugepage. However, it's consistent with our
-		// treatment of unallocated pages, which have the same property.
-		if val.refs == 0 {
-			continue
-		}
-
-		// Get the range for this segment. As we touch slices, the
-		// Start value will be walked along.
-		r := seg.Range()
-
-		var checkErr error
-		err := f.forEachMappingSlice(r, func(s []byte) {
-			if checkErr != nil {
-				return
+			// Already known to be committed; ignore.
+			if val.knownCommitted {
+				continue
 			}
 
-			// Ensure that we have sufficient buffer for the call
-			// (one byte per page). The length of each slice must
-			// be page-aligned.
-			bufLen := len(s) / usermem.PageSize
-			if len(buf) < bufLen {
-				buf = make([]byte, bufLen)
+			// Assume that reclaimable pages (that aren't already known to be
+			// committed) are not committed. This isn't necessarily true, even
+			// after the reclaimer does Decommit(), because the kernel may
+			// subsequently back the hugepage-sized region containing the
+			// decommitted page with a hugepage. However, it's consistent with our
+			// treatment of unallocated pages, which have the same property.
+			if val.refs == 0 {
+				continue
 			}
 
-			// Query for new pages in core.
-			if err := checkCommitted(s, buf); err != nil {
-				checkErr = err
-				return
-			}
+			// Get the range for this segment. As we touch slices, the
+			// Start value will be walked along.
+			r := seg.Range()
+
+			var checkErr error
+			err := f.forEachMappingSlice(r, func(s []byte) {
+				if checkErr != nil {
+					return
+				}
+
+				// Ensure that we have sufficient buffer for the call
+				// (one byte per page). The length of each slice must
+				// be page-aligned.
+				bufLen := len(s) / usermem.PageSize
+				if len(buf) < bufLen {
+					buf = make([]byte, bufLen)
+				}
 
-			// Scan each page and switch out segments.
-			populatedRun := false
-			populatedRunStart := 0
-			for i := 0; i <= bufLen; i++ {
-				// We run past the end of the slice here to
-				// simplify the logic and only set populated if
-				// we're still looking at elements.
-				populated := false
-				if i < bufLen {
-					populated = buf[i]&0x1 != 0
+				// Query for new pages in core.
+				if err := checkCommitted(s, buf); err != nil {
+					checkErr = err
+					return
 				}
 
-				switch {
-				case populated == populatedRun:
-					// Keep the run going.
-					continue
-				case populated && !populatedRun:
-					// Begin the run.
-					populatedRun = true
-					populatedRunStart = i
-					// Keep going.
-					continue
-				case !populated && populatedRun:
-					// Finish the run by changing this segment.
-					runRange := platform.FileRange{
-						Start: r.Start + uint64(populatedRunStart*usermem.PageSize),
-						End:   r.Start + uint64(i*usermem.PageSize),
+				// Scan each page and switch out segments.
+				populatedRun := false
+				populatedRunStart := 0
+				for i := 0; i <= bufLen; i++ {
+					// We run past the end of the slice here to
+					// simplify the logic and only set populated if
+					// we're still looking at elements.
+					populated := false
+					if i < bufLen {
+						populated = buf[i]&0x1 != 0
 					}
-					seg = f.usage.Isolate(seg, runRange)
-					seg.ValuePtr().knownCommitted = true
-					// Advance the segment only if we still
-					// have work to do in the context of
-					// the original segment from the for
-					// loop. Otherwise, the for loop itself
-					// will advance the segment
-					// appropriately.
-					if runRange.End != r.End {
-						seg = seg.NextSegment()
+
+					switch {
+					case populated == populatedRun:
+						// Keep the run going.
+						continue
+					case populated && !populatedRun:
+						// Begin the run.
+						populatedRun = true
+						populatedRunStart = i
+						// Keep going.
+						continue
+					case !populated && populatedRun:
+						// Finish the run by changing this segment.
+						runRange := platform.FileRange{
+							Start: r.Start + uint64(populatedRunStart*usermem.PageSize),
+							End:   r.Start + uint64(i*usermem.PageSize),
+						}
+						seg = f.usage.Isolate(seg, runRange)
+						seg.ValuePtr().knownCommitted = true
+						f.uncommitted.RemoveRange(runRange)
+						// Advance the segment only if we still
+						// have work to do in the context of
+						// the original segment from the for
+						// loop. Otherwise, the for loop itself
+						// will advance the segment
+						// appropriately.
+						if runRange.End != r.End {
+							seg = seg.NextSegment()
+						}
+						amount := runRange.Length()
+						usage.MemoryAccounting.Inc(amount, val.kind)
+						f.usageExpected += amount
+						changedAny = true
+						populatedRun = false
 					}
-					amount := runRange.Length()
-					usage.MemoryAccounting.Inc(amount, val.kind)
-					f.usageExpected += amount
-					changedAny = true
-					populatedRun = false
 				}
-			}
 
-			// Advance r.Start.
-			r.Start += uint64(len(s))
-		})
-		if checkErr != nil {
-			return checkErr
-		}
-		if err != nil {
-			return err
+				// Advance r.Start.
+				r.Start += uint64(len(s))
+			})
+			if checkErr != nil {
+				return checkErr
+			}
+			if err != nil {
+				return err
+			}
 		}
+		// The loop above may have removed committed ranges from
+		// f.uncommitted, invalidating useg.
+		useg = f.uncommitted.LowerBoundSegment(ur.End)
 	}
 
 	return nil
@@ -1029,27 +1226,33 @@ func (f *MemoryFile) String() string {
 // reclaimable pages in order to reduce memory usage and make them available
 // for allocation.
 func (f *MemoryFile) runReclaim() {
+	var frs []platform.FileRange
 	for {
-		fr, ok := f.findReclaimable()
+		var ok bool
+		frs, ok = f.findReclaimable(frs[:0])
 		if !ok {
 			break
 		}
 
-		if err := f.Decommit(fr); err != nil {
-			log.Warningf("Reclaim failed to decommit %v: %v", fr, err)
-			// Zero the pages manually. This won't reduce memory usage, but at
-			// least ensures that the pages will be zero when reallocated.
-			f.forEachMappingSlice(fr, func(bs []byte) {
-				for i := range bs {
-					bs[i] = 0
-				}
-			})
-			// Pretend the pages were decommitted even though they weren't,
-			// since the memory accounting implementation has no idea how to
-			// deal with this.
-			f.markDecommitted(fr)
+		for _, fr := range frs {
+			f.resetNUMAPolicy(fr)
+			f.Unpin(fr)
+			if err := f.decommitFile(fr); err != nil {
+				log.Warningf("Reclaim failed to decommit %v: %v", fr, err)
+				// Zero the pages manually. This won't reduce memory usage, but
+				// at least ensures that the pages will be zero when
+				// reallocated. markReclaimed will pretend the pages were
+				// decommitted even though they weren't, since the memory
+				// accounting implementation has no idea how to deal with
+				// this.
+				f.forEachMappingSlice(fr, func(bs []byte) {
+					for i := range bs {
+						bs[i] = 0
+					}
+				})
+			}
 		}
-		f.markReclaimed(fr)
+		f.markReclaimed(frs)
 	}
 
 	// We only get here if findReclaimable finds f.destroyed set and returns
@@ -1085,32 +1288,45 @@ func (f *MemoryFile) runReclaim() {
 	}
 }
 
-func (f *MemoryFile) findReclaimable() (platform.FileRange, bool) {
+// findReclaimable appends to frs the next batch of reclaimable pages, waiting
+// for pages to become reclaimable if there are none. It returns false if f has
+// been destroyed.
+func (f *MemoryFile) findReclaimable(frs []platform.FileRange) ([]platform.FileRange, bool) {
 	f.mu.Lock()
 	defer f.mu.Unlock()
 	for {
 		for {
 			if f.destroyed {
-				return platform.FileRange{}, false
+				return nil, false
 			}
-			if f.reclaimable {
+			if f.reclaimable || len(f.pendingDecRefs) != 0 {
 				break
 			}
-			if f.opts.DelayedEviction == DelayedEvictionEnabled && !f.opts.UseHostMemcgPressure {
+			if f.evictsWhenIdle() {
 				// No work to do. Evict any pending evictable allocations to
 				// get more reclaimable pages before going to sleep.
 				f.startEvictionsLocked()
 			}
 			f.reclaimCond.Wait()
+			if f.opts.DecommitDelay != 0 && f.reclaimable && !f.destroyed {
+				// Let pages freed shortly after these join the same batch.
+				f.mu.Unlock()
+				time.Sleep(f.opts.DecommitDelay)
+				f.mu.Lock()
+			}
+		}
+		if len(f.pendingDecRefs) != 0 {
+			f.releasePendingDecRefsLocked()
+			continue
 		}
 		// Allocate returns the first usable range in offset order and is
 		// currently a linear scan, so reclaiming from the beginning of the
 		// file minimizes the expected latency of Allocate.
-		for seg := f.usage.LowerBoundSegment(f.minReclaimablePage); seg.Ok(); seg = seg.NextSegment() {
-			if seg.ValuePtr().refs == 0 {
-				f.minReclaimablePage = seg.End()
-				return seg.Range(), true
-			}
+		var next uint64
+		frs, next = findReclaimableRanges(&f.usage, f.minReclaimablePage, f.opts.DecommitBatchSize, frs)
+		if len(frs) != 0 {
+			f.minReclaimablePage = next
+			return frs, true
 		}
 		// No pages are reclaimable.
 		f.reclaimable = false
@@ -1118,32 +1334,87 @@ func (f *MemoryFile) findReclaimable() (platform.FileRange, bool) {
 	}
 }
 
-func (f *MemoryFile) markReclaimed(fr platform.FileRange) {
+// releasePendingDecRefsLocked releases the references deferred by
+// DecRefAsync. It unlocks f.mu between batches so that it doesn't hold up
+// allocations for long.
+//
+// Preconditions: f.mu must be locked.
+func (f *MemoryFile) releasePendingDecRefsLocked() {
+	for len(f.pendingDecRefs) != 0 {
+		frs := f.pendingDecRefs
+		if len(frs) > pendingDecRefsBatch {
+			frs = frs[:pendingDecRefsBatch]
+		}
+		for _, fr := range frs {
+			f.decRefLocked(fr)
+		}
+		f.pendingDecRefs = f.pendingDecRefs[len(frs):]
+		f.mu.Unlock()
+		runtime.Gosched()
+		f.mu.Lock()
+	}
+	f.pendingDecRefs = nil
+}
+
+// findReclaimableRanges appends to frs the reclaimable ranges in usage at or
+// after page start, in offset order, up to a total of batchSize bytes. It
+// returns the extended frs and the page at which the next search should
+// begin.
+//
+// Preconditions: batchSize must be page-aligned and non-zero.
+func findReclaimableRanges(usage *usageSet, start, batchSize uint64, frs []platform.FileRange) ([]platform.FileRange, uint64) {
+	var total uint64
+	for seg := usage.LowerBoundSegment(start); seg.Ok() && total < batchSize; seg = seg.NextSegment() {
+		if seg.ValuePtr().refs != 0 {
+			continue
+		}
+		// A previous batch may have ended within seg.
+		fr := seg.Range()
+		if fr.Start < start {
+			fr.Start = start
+		}
+		if fr.Length() > batchSize-total {
+			fr.End = fr.Start + (batchSize - total)
+		}
+		frs = append(frs, fr)
+		total += fr.Length()
+		start = fr.End
+	}
+	return frs, start
+}
+
+// markReclaimed deallocates the pages in frs, which were returned by
+// findReclaimable and have been decommitted by the caller.
+func (f *MemoryFile) markReclaimed(frs []platform.FileRange) {
 	f.mu.Lock()
 	defer f.mu.Unlock()
-	seg := f.usage.FindSegment(fr.Start)
-	// All of fr should be mapped to a single uncommitted reclaimable segment
-	// accounted to System.
-	if !seg.Ok() {
-		panic(fmt.Sprintf("reclaimed pages %v include unreferenced pages:\n%v", fr, &f.usage))
-	}
-	if !seg.Range().IsSupersetOf(fr) {
-		panic(fmt.Sprintf("reclaimed pages %v are not entirely contained in segment %v with state %v:\n%v", fr, seg.Range(), seg.Value(), &f.usage))
-	}
-	if got, want := seg.Value(), (usageInfo{
-		kind:           usage.System,
-		knownCommitted: false,
-		refs:           0,
-	}); got != want {
-		panic(fmt.Sprintf("reclaimed pages %v in segment %v has incorrect state %v, wanted %v:\n%v", fr, seg.Range(), got, want, &f.usage))
-	}
-	// Deallocate reclaimed pages. Even though all of seg is reclaimable, the
-	// caller of markReclaimed may not have decommitted it, so we can only mark
-	// fr as reclaimed.
-	f.usage.Remove(f.usage.Isolate(seg, fr))
-	if fr.Start < f.minUnallocatedPage {
-		// We've deallocated at least one lower page.
-		f.minUnallocatedPage = fr.Start
+	for _, fr := range frs {
+		f.markDecommittedLocked(fr)
+		seg := f.usage.FindSegment(fr.Start)
+		// All of fr should be mapped to a single uncommitted reclaimable
+		// segment accounted to System.
+		if !seg.Ok() {
+			panic(fmt.Sprintf("reclaimed pages %v include unreferenced pages:\n%v", fr, &f.usage))
+		}
+		if !seg.Range().IsSupersetOf(fr) {
+			panic(fmt.Sprintf("reclaimed pages %v are not entirely contained in segment %v with state %v:\n%v", fr, seg.Range(), seg.Value(), &f.usage))
+		}
+		if got, want := seg.Value(), (usageInfo{
+			kind:           usage.System,
+			knownCommitted: false,
+			refs:           0,
+		}); got != want {
+			panic(fmt.Sprintf("reclaimed pages %v in segment %v has incorrect state %v, wanted %v:\n%v", fr, seg.Range(), got, want, &f.usage))
+		}
+		// Deallocate reclaimed pages. Even though all of seg is reclaimable,
+		// the caller of markReclaimed may not have decommitted it, so we can
+		// only mark fr as reclaimed.
+		f.usage.Remove(f.usage.Isolate(seg, fr))
+		f.uncommitted.RemoveRange(fr)
+		if fr.Start < f.minUnallocatedPage {
+			// We've deallocated at least one lower page.
+			f.minUnallocatedPage = fr.Start
+		}
 	}
 }
 
@@ -1232,6 +1503,30 @@ func (usageSetFunctions) Split(_ platform.FileRange, val usageInfo, _ uint64) (u
 	return val, val
 }
 
+// uncommittedSetValue is the value type of uncommittedSet.
+type uncommittedSetValue struct{}
+
+type uncommittedSetFunctions struct{}
+
+func (uncommittedSetFunctions) MinKey() uint64 {
+	return 0
+}
+
+func (uncommittedSetFunctions) MaxKey() uint64 {
+	return math.MaxUint64
+}
+
+func (uncommittedSetFunctions) ClearValue(val *uncommittedSetValue) {
+}
+
+func (uncommittedSetFunctions) Merge(_ platform.FileRange, _ uncommittedSetValue, _ platform.FileRange, _ uncommittedSetValue) (uncommittedSetValue, bool) {
+	return uncommittedSetValue{}, true
+}
+
+func (uncommittedSetFunctions) Split(_ platform.FileRange, _ uncommittedSetValue, _ uint64) (uncommittedSetValue, uncommittedSetValue) {
+	return uncommittedSetValue{}, uncommittedSetValue{}
+}
+
 // evictableRangeSetValue is the value type of evictableRangeSet.
 type evictableRangeSetValue struct{}
 
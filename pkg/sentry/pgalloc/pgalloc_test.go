@@ -15,8 +15,10 @@
 package pgalloc
 
 import (
+	"reflect"
 	"testing"
 
+	"gvisor.dev/gvisor/pkg/sentry/platform"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
 
@@ -166,3 +168,85 @@ func TestFindUnallocatedRange(t *testing.T) {
 		})
 	}
 }
+
+func TestFindReclaimableRanges(t *testing.T) {
+	for _, test := range []struct {
+		desc      string
+		usage     *usageSegmentDataSlices
+		start     uint64
+		batchSize uint64
+		want      []platform.FileRange
+		next      uint64
+	}{
+		{
+			desc:      "No reclaimable pages",
+			usage:     &usageSegmentDataSlices{},
+			start:     0,
+			batchSize: 4 * page,
+			want:      nil,
+			next:      0,
+		},
+		{
+			desc: "In-use pages are skipped",
+			usage: &usageSegmentDataSlices{
+				Start:  []uint64{0, page, 2 * page, 3 * page},
+				End:    []uint64{page, 2 * page, 3 * page, 4 * page},
+				Values: []usageInfo{{refs: 0}, {refs: 1}, {refs: 0}, {refs: 2}},
+			},
+			start:     0,
+			batchSize: 4 * page,
+			want:      []platform.FileRange{{0, page}, {2 * page, 3 * page}},
+			next:      3 * page,
+		},
+		{
+			desc: "Pages before start are skipped",
+			usage: &usageSegmentDataSlices{
+				Start:  []uint64{0, page, 2 * page},
+				End:    []uint64{page, 2 * page, 3 * page},
+				Values: []usageInfo{{refs: 0}, {refs: 1}, {refs: 0}},
+			},
+			start:     page,
+			batchSize: 4 * page,
+			want:      []platform.FileRange{{2 * page, 3 * page}},
+			next:      3 * page,
+		},
+		{
+			desc: "Batch ends within a segment",
+			usage: &usageSegmentDataSlices{
+				Start:  []uint64{0, 2 * page},
+				End:    []uint64{page, 8 * page},
+				Values: []usageInfo{{refs: 0}, {refs: 0}},
+			},
+			start:     0,
+			batchSize: 4 * page,
+			want:      []platform.FileRange{{0, page}, {2 * page, 5 * page}},
+			next:      5 * page,
+		},
+		{
+			desc: "Batch begins within a segment",
+			usage: &usageSegmentDataSlices{
+				Start:  []uint64{0},
+				End:    []uint64{8 * page},
+				Values: []usageInfo{{refs: 0}},
+			},
+			start:     5 * page,
+			batchSize: 4 * page,
+			want:      []platform.FileRange{{5 * page, 8 * page}},
+			next:      8 * page,
+		},
+	} {
+		t.Run(test.desc, func(t *testing.T) {
+			var usage usageSet
+			if err := usage.ImportSortedSlices(test.usage); err != nil {
+				t.Fatalf("Failed to initialize usage from %v: %v", test.usage, err)
+			}
+			got, next := findReclaimableRanges(&usage, test.start, test.batchSize, nil)
+			if !reflect.DeepEqual(got, test.want) {
+				t.Errorf("findReclaimableRanges(%v, %x, %x): got ranges %v, wanted %v", test.usage, test.start, test.batchSize, got, test.want)
+			}
+			if next != test.next {
+				t.Errorf("findReclaimableRanges(%v, %x, %x): got next %x, wanted %x", test.usage, test.start, test.batchSize, next, test.next)
+			}
+		})
+	}
+}
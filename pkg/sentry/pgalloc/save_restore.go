@@ -19,22 +19,28 @@ import (
 	"context"
 	"fmt"
 	"io"
+	"os"
 	"runtime"
 	"sync/atomic"
 	"syscall"
 
 	"gvisor.dev/gvisor/pkg/log"
+	"gvisor.dev/gvisor/pkg/sentry/platform"
 	"gvisor.dev/gvisor/pkg/sentry/usage"
 	"gvisor.dev/gvisor/pkg/state"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
 
-// SaveTo writes f's state to the given stream.
-func (f *MemoryFile) SaveTo(ctx context.Context, w io.Writer) error {
-	// Wait for reclaim.
+// SaveTo writes f's state to the given stream. If pages is not nil, the
+// contents of committed pages are written to pages, uncompressed and
+// page-aligned, instead of to w; such a checkpoint can be restored quickly by
+// many sandboxes, which read the pages file directly and share it in the host
+// page cache.
+func (f *MemoryFile) SaveTo(ctx context.Context, w io.Writer, pages *os.File) error {
+	// Wait for reclaim, including of memory released by DecRefAsync.
 	f.mu.Lock()
 	defer f.mu.Unlock()
-	for f.reclaimable {
+	for f.reclaimable || len(f.pendingDecRefs) != 0 {
 		f.reclaimCond.Signal()
 		f.mu.Unlock()
 		runtime.Gosched()
@@ -85,12 +91,36 @@ func (f *MemoryFile) SaveTo(ctx context.Context, w io.Writer) error {
 	if err := state.Save(ctx, w, &f.usage, nil); err != nil {
 		return err
 	}
+	separatePages := pages != nil
+	if err := state.Save(ctx, w, &separatePages, nil); err != nil {
+		return err
+	}
 
 	// Dump out committed pages.
+	var pagesOff int64
 	for seg := f.usage.FirstSegment(); seg.Ok(); seg = seg.NextSegment() {
 		if !seg.Value().knownCommitted {
 			continue
 		}
+		if pages != nil {
+			// Since segments are page-aligned, so is each segment's data in
+			// pages.
+			var ioErr error
+			err := f.forEachMappingSlice(seg.Range(), func(s []byte) {
+				if ioErr != nil {
+					return
+				}
+				_, ioErr = pages.WriteAt(s, pagesOff)
+				pagesOff += int64(len(s))
+			})
+			if ioErr != nil {
+				return ioErr
+			}
+			if err != nil {
+				return err
+			}
+			continue
+		}
 		// Write a header to distinguish from objects.
 		if err := state.WriteHeader(w, uint64(seg.Range().Length()), false); err != nil {
 			return err
@@ -114,8 +144,9 @@ func (f *MemoryFile) SaveTo(ctx context.Context, w io.Writer) error {
 	return nil
 }
 
-// LoadFrom loads MemoryFile state from the given stream.
-func (f *MemoryFile) LoadFrom(ctx context.Context, r io.Reader) error {
+// LoadFrom loads MemoryFile state from the given stream. pages must be the
+// pages file passed to SaveTo, if any.
+func (f *MemoryFile) LoadFrom(ctx context.Context, r io.Reader, pages *os.File) error {
 	// Load metadata.
 	if err := state.Load(ctx, r, &f.fileSize, nil); err != nil {
 		return err
@@ -128,6 +159,13 @@ func (f *MemoryFile) LoadFrom(ctx context.Context, r io.Reader) error {
 	if err := state.Load(ctx, r, &f.usage, nil); err != nil {
 		return err
 	}
+	var separatePages bool
+	if err := state.Load(ctx, r, &separatePages, nil); err != nil {
+		return err
+	}
+	if separatePages && pages == nil {
+		return fmt.Errorf("memory was saved to a separate pages file, which was not provided")
+	}
 
 	// Try to map committed chunks concurrently: For any given chunk, either
 	// this loop or the following one will mmap the chunk first and cache it in
@@ -152,9 +190,18 @@ func (f *MemoryFile) LoadFrom(ctx context.Context, r io.Reader) error {
 		<-mapperDone
 	}()
 
-	// Load committed pages.
+	// Load committed pages, and index the rest for UpdateUsage.
+	var pageLoads []pageLoad
+	var pagesOff int64
 	for seg := f.usage.FirstSegment(); seg.Ok(); seg = seg.NextSegment() {
 		if !seg.Value().knownCommitted {
+			f.uncommitted.Add(seg.Range(), uncommittedSetValue{})
+			continue
+		}
+		if separatePages {
+			pageLoads = append(pageLoads, pageLoad{seg.Range(), pagesOff})
+			pagesOff += int64(seg.Range().Length())
+			usage.MemoryAccounting.Inc(seg.Range().Length(), seg.Value().kind)
 			continue
 		}
 		// Verify header.
@@ -191,9 +238,77 @@ func (f *MemoryFile) LoadFrom(ctx context.Context, r io.Reader) error {
 		usage.MemoryAccounting.Inc(seg.End()-seg.Start(), seg.Value().kind)
 	}
 
+	if separatePages {
+		return f.loadPages(pages, pageLoads)
+	}
 	return nil
 }
 
+// pageLoad is a range of committed pages to be read from a pages file.
+type pageLoad struct {
+	fr  platform.FileRange
+	off int64
+}
+
+// loadPages reads the given ranges of pages from the pages file written by
+// SaveTo. Since pages are read directly rather than decompressed from the
+// state stream, loads are spread across all available CPUs.
+func (f *MemoryFile) loadPages(pages *os.File, loads []pageLoad) error {
+	// Split loads into pieces of at most a chunk, so that large segments
+	// are shared between loaders.
+	var pieces []pageLoad
+	for _, l := range loads {
+		for start := l.fr.Start; start < l.fr.End; {
+			end := (start + chunkSize) &^ chunkMask
+			if end > l.fr.End {
+				end = l.fr.End
+			}
+			pieces = append(pieces, pageLoad{platform.FileRange{start, end}, l.off + int64(start-l.fr.Start)})
+			start = end
+		}
+	}
+
+	var next int64
+	loaders := runtime.GOMAXPROCS(0)
+	errs := make(chan error, loaders)
+	for i := 0; i < loaders; i++ {
+		go func() { // S/R-SAFE: loadPages waits for all loaders.
+			for {
+				n := atomic.AddInt64(&next, 1) - 1
+				if n >= int64(len(pieces)) {
+					errs <- nil
+					return
+				}
+				// Each piece lies within a single chunk, so fn below is
+				// called exactly once.
+				p := pieces[n]
+				var ioErr error
+				err := f.forEachMappingSlice(p.fr, func(s []byte) {
+					if ioErr == nil {
+						_, ioErr = pages.ReadAt(s, p.off)
+					}
+				})
+				if ioErr != nil {
+					err = ioErr
+				}
+				if err != nil {
+					// Stop the other loaders.
+					atomic.StoreInt64(&next, int64(len(pieces)))
+					errs <- err
+					return
+				}
+			}
+		}()
+	}
+	var firstErr error
+	for i := 0; i < loaders; i++ {
+		if err := <-errs; err != nil && firstErr == nil {
+			firstErr = err
+		}
+	}
+	return firstErr
+}
+
 // MemoryFileProvider provides the MemoryFile method.
 //
 // This type exists to work around a save/restore defect. The only object in a
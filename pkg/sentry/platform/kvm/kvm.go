@@ -133,6 +133,13 @@ func (*KVM) CooperativelySchedulesAddressSpace() bool {
 	return false
 }
 
+// HostCPUVisibleToApplications implements platform.Platform.HostCPUVisibleToApplications.
+func (*KVM) HostCPUVisibleToApplications() bool {
+	// Application code runs in guest mode, where IA32_TSC_AUX is not
+	// maintained by the host kernel.
+	return false
+}
+
 // MapUnit implements platform.Platform.MapUnit.
 func (*KVM) MapUnit() uint64 {
 	// We greedily creates PTEs in MapFile, so extremely large mappings can
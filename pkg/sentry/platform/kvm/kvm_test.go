@@ -22,6 +22,7 @@ import (
 	"testing"
 	"time"
 
+	"gvisor.dev/gvisor/pkg/cpuid"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/platform"
 	"gvisor.dev/gvisor/pkg/sentry/platform/kvm/testutil"
@@ -286,6 +287,32 @@ func TestSegments(t *testing.T) {
 	})
 }
 
+func TestWriteFSBase(t *testing.T) {
+	if !cpuid.HostFeatureSet().HasFeature(cpuid.X86FeatureFSGSBase) {
+		t.Skip("FSGSBASE not supported")
+	}
+	applicationTest(t, true, testutil.WriteFSBase, func(c *vCPU, regs *arch.Registers, pt *pagetables.PageTables) bool {
+		testutil.SetTestFSBase(regs)
+		for {
+			var si arch.SignalInfo
+			if _, err := c.SwitchToUser(ring0.SwitchOpts{
+				Registers:          regs,
+				FloatingPointState: dummyFPState,
+				PageTables:         pt,
+			}, &si); err == platform.ErrContextInterrupt {
+				continue // Retry.
+			} else if err != nil {
+				t.Errorf("application FS base write got unexpected error: %v", err)
+			}
+			if err := testutil.CheckTestFSBase(regs); err != nil {
+				t.Errorf("application FS base write failed: %v", err)
+			}
+			break // Done.
+		}
+		return false
+	})
+}
+
 func TestBounce(t *testing.T) {
 	applicationTest(t, true, testutil.SpinLoop, func(c *vCPU, regs *arch.Registers, pt *pagetables.PageTables) bool {
 		go func() {
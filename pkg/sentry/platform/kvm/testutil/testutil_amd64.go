@@ -25,6 +25,9 @@ import (
 // TwiddleSegments reads segments into known registers.
 func TwiddleSegments()
 
+// WriteFSBase sets the FS base to the value of rbx using wrfsbase.
+func WriteFSBase()
+
 // SetTestTarget sets the rip appropriately.
 func SetTestTarget(regs *arch.Registers, fn func()) {
 	regs.Rip = uint64(reflect.ValueOf(fn).Pointer())
@@ -127,6 +130,19 @@ func SetTestSegments(regs *arch.Registers) {
 	regs.Gs_base = uint64(reflect.ValueOf(&gsData).Pointer())
 }
 
+// SetTestFSBase sets the FS base that WriteFSBase will write.
+func SetTestFSBase(regs *arch.Registers) {
+	regs.Rbx = uint64(reflect.ValueOf(&fsData).Pointer())
+}
+
+// CheckTestFSBase checks that the FS base was written per WriteFSBase.
+func CheckTestFSBase(regs *arch.Registers) (err error) {
+	if want := uint64(reflect.ValueOf(&fsData).Pointer()); regs.Fs_base != want {
+		err = addRegisterMismatch(err, "Fs_base", regs.Fs_base, want)
+	}
+	return
+}
+
 // CheckTestSegments checks that registers were twiddled per TwiddleSegments.
 func CheckTestSegments(regs *arch.Registers) (err error) {
 	if regs.Rax != fsData {
@@ -96,3 +96,8 @@ TEXT ·TwiddleSegments(SB),NOSPLIT,$0
 	READ_FS()
 	SYSCALL
 	RET // never reached
+
+TEXT ·WriteFSBase(SB),NOSPLIT,$0
+	BYTE $0xf3; BYTE $0x48; BYTE $0x0f; BYTE $0xae; BYTE $0xd3; // wrfsbase %rbx
+	SYSCALL
+	RET // never reached
@@ -51,6 +51,16 @@ type Platform interface {
 	// can reliably return ErrContextCPUPreempted.
 	DetectsCPUPreemption() bool
 
+	// HostCPUVisibleToApplications returns true if application code executed
+	// by Contexts returned by the Platform runs directly on host CPUs, and
+	// can identify the host CPU that it is running on without a system call
+	// (e.g. via RDTSCP on amd64, which reads IA32_TSC_AUX as maintained by
+	// the host kernel).
+	//
+	// The value returned by HostCPUVisibleToApplications is guaranteed to
+	// remain unchanged over the lifetime of the Platform.
+	HostCPUVisibleToApplications() bool
+
 	// MapUnit returns the alignment used for optional mappings into this
 	// platform's AddressSpaces. Higher values indicate lower per-page costs
 	// for AddressSpace.MapFile. As a special case, a MapUnit of 0 indicates
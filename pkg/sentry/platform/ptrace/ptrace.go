@@ -38,6 +38,15 @@
 //	The requested operation is performed in the traced subprocess thread
 //	(e.g. set registers, execute, return).
 //
+// Every application system call is therefore a full ptrace stop: the stub
+// thread stops, the sentry reads its registers (and floating point state),
+// handles the system call and resumes the stub with PTRACE_SYSEMU. The stub
+// cannot run several system calls per stop, since it only executes
+// application code and each system call needs the sentry to handle it; this
+// per-system call cost is visible in BM_Getpid and BM_FutexWakeNop, which
+// //test/perf:perf_vm_test_ptrace runs alongside the other platforms. Where
+// this cost matters, use the KVM platform.
+//
 // Lock order:
 //
 // subprocess.mu
@@ -217,6 +226,12 @@ func (*PTrace) CooperativelySchedulesAddressSpace() bool {
 	return false
 }
 
+// HostCPUVisibleToApplications implements platform.Platform.HostCPUVisibleToApplications.
+func (*PTrace) HostCPUVisibleToApplications() bool {
+	// Stub threads are ordinary host threads.
+	return hostCPUVisibleToApplications()
+}
+
 // MapUnit implements platform.Platform.MapUnit.
 func (*PTrace) MapUnit() uint64 {
 	// The host kernel manages page tables and arbitrary-sized mappings
@@ -16,6 +16,7 @@ package ptrace
 
 import (
 	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/cpuid"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 )
 
@@ -44,3 +45,10 @@ func (t *thread) getTLS(tls *uint64) error {
 func (t *thread) setTLS(tls *uint64) error {
 	return nil
 }
+
+// hostCPUVisibleToApplications returns true if stub threads can read the
+// current host CPU number from IA32_TSC_AUX, which Linux initializes on every
+// CPU that supports RDTSCP.
+func hostCPUVisibleToApplications() bool {
+	return cpuid.HostFeatureSet().HasFeature(cpuid.X86FeatureRDTSCP)
+}
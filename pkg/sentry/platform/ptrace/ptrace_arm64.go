@@ -27,3 +27,11 @@ func fpRegSet(_ bool) uintptr {
 func stackPointer(r *arch.Registers) uintptr {
 	return uintptr(r.Sp)
 }
+
+// hostCPUVisibleToApplications returns true if stub threads can determine the
+// current host CPU number without a system call.
+//
+// There is no unprivileged equivalent of IA32_TSC_AUX on arm64.
+func hostCPUVisibleToApplications() bool {
+	return false
+}
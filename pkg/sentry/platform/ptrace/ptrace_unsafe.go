@@ -80,6 +80,11 @@ func (t *thread) getFPRegs(fpState *arch.FloatingPointData, fpLen uint64, useXsa
 	return nil
 }
 
+// fpBytes returns the first fpLen bytes of fpState.
+func fpBytes(fpState *arch.FloatingPointData, fpLen uint64) []byte {
+	return (*[1 << 30]byte)(unsafe.Pointer(fpState))[:fpLen:fpLen]
+}
+
 // setFPRegs sets the floating-point data via the SETREGSET ptrace syscall.
 func (t *thread) setFPRegs(fpState *arch.FloatingPointData, fpLen uint64, useXsave bool) error {
 	iovec := syscall.Iovec{
@@ -15,6 +15,7 @@
 package ptrace
 
 import (
+	"bytes"
 	"fmt"
 	"os"
 	"runtime"
@@ -64,6 +65,12 @@ type thread struct {
 	//
 	// These are used for the register set for system calls.
 	initRegs arch.Registers
+
+	// fpState is a copy of the floating point state last retrieved from
+	// the thread, or nil if it has not been retrieved. Neither the stub nor
+	// the host change the thread's floating point state, so it need not be
+	// set again unless the sentry has changed it since.
+	fpState []byte
 }
 
 // threadPool is a collection of threads.
@@ -526,8 +533,11 @@ func (s *subprocess) switchToApp(c *context, ac arch.Context) bool {
 	if err := t.setRegs(regs); err != nil {
 		panic(fmt.Sprintf("ptrace set regs (%+v) failed: %v", regs, err))
 	}
-	if err := t.setFPRegs(fpState, uint64(fpLen), useXsave); err != nil {
-		panic(fmt.Sprintf("ptrace set fpregs (%+v) failed: %v", fpState, err))
+	fp := fpBytes(fpState, uint64(fpLen))
+	if !bytes.Equal(fp, t.fpState) {
+		if err := t.setFPRegs(fpState, uint64(fpLen), useXsave); err != nil {
+			panic(fmt.Sprintf("ptrace set fpregs (%+v) failed: %v", fpState, err))
+		}
 	}
 	if err := t.setTLS(&tls); err != nil {
 		panic(fmt.Sprintf("ptrace set tls (%+v) failed: %v", tls, err))
@@ -561,6 +571,7 @@ func (s *subprocess) switchToApp(c *context, ac arch.Context) bool {
 		if err := t.getFPRegs(fpState, uint64(fpLen), useXsave); err != nil {
 			panic(fmt.Sprintf("ptrace get fpregs failed: %v", err))
 		}
+		t.fpState = append(t.fpState[:0], fp...)
 		if err := t.getTLS(&tls); err != nil {
 			panic(fmt.Sprintf("ptrace get tls failed: %v", err))
 		}
@@ -202,8 +202,13 @@ func (c *CPU) SwitchToUser(switchOpts SwitchOpts) (vector Vector) {
 	} else {
 		vector = sysret(c, regs)
 	}
-	writeCR3(uintptr(kernelCR3))                     // Return to kernel address space.
-	jumpToUser()                                     // Return to lower half.
+	writeCR3(uintptr(kernelCR3)) // Return to kernel address space.
+	jumpToUser()                 // Return to lower half.
+	if hasFSGSBASE {
+		// The application may have changed FS with wrfsbase, which
+		// CR4.FSGSBASE permits without trapping.
+		regs.Fs_base = uint64(rdfsbase())
+	}
 	SaveFloatingPoint(switchOpts.FloatingPointState) // Copy out floating point.
 	WriteFS(uintptr(c.registers.Fs_base))            // Restore kernel FS.
 	return
@@ -52,6 +52,9 @@ func wrfsbase(addr uintptr)
 // wrfsmsr writes to the GS_BASE MSR.
 func wrfsmsr(addr uintptr)
 
+// rdfsbase reads the FS base address.
+func rdfsbase() uintptr
+
 // WriteGS sets the GS address (set by init).
 var WriteGS func(addr uintptr)
 
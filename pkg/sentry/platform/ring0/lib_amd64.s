@@ -91,6 +91,17 @@ TEXT ·wrfsbase(SB),NOSPLIT,$0-8
 	BYTE $0xf3; BYTE $0x48; BYTE $0x0f; BYTE $0xae; BYTE $0xd0;
 	RET
 
+// rdfsbase reads the FS base.
+//
+// The code corresponds to:
+//
+// 	rdfsbase %rax
+//
+TEXT ·rdfsbase(SB),NOSPLIT,$0-8
+	BYTE $0xf3; BYTE $0x48; BYTE $0x0f; BYTE $0xae; BYTE $0xc0;
+	MOVQ AX, ret+0(FP)
+	RET
+
 // wrfsmsr writes to the FSBASE MSR.
 //
 // The code corresponds to:
@@ -20,6 +20,10 @@ import (
 
 // PCIDs is a simple PCID database.
 //
+// When all PCIDs are assigned, the least recently used assignment is evicted,
+// so that switching between a few recently used page tables never requires a
+// flush.
+//
 // This is not protected by locks and is thus suitable for use only with a
 // single CPU at a time.
 type PCIDs struct {
@@ -31,6 +35,20 @@ type PCIDs struct {
 
 	// avail are available PCIDs.
 	avail []uint16
+
+	// start is the first PCID.
+	start uint16
+
+	// owners are the page tables assigned to each PCID, indexed by PCID -
+	// start, or nil if the PCID is available.
+	owners []*PageTables
+
+	// lastUse is the value of clock when each PCID was last assigned,
+	// indexed by PCID - start.
+	lastUse []uint64
+
+	// clock is incremented by each call to Assign.
+	clock uint64
 }
 
 // NewPCIDs returns a new PCID database.
@@ -45,7 +63,10 @@ func NewPCIDs(start, size uint16) *PCIDs {
 		return nil // See comment.
 	}
 	p := &PCIDs{
-		cache: make(map[*PageTables]uint16),
+		cache:   make(map[*PageTables]uint16),
+		start:   start,
+		owners:  make([]*PageTables, size),
+		lastUse: make([]uint64, size),
 	}
 	for pcid := start; pcid < start+size; pcid++ {
 		p.avail = append(p.avail, pcid)
@@ -59,7 +80,9 @@ func NewPCIDs(start, size uint16) *PCIDs {
 // true is returned to indicate that the PCID should be flushed.
 func (p *PCIDs) Assign(pt *PageTables) (uint16, bool) {
 	p.mu.Lock()
+	p.clock++
 	if pcid, ok := p.cache[pt]; ok {
+		p.lastUse[pcid-p.start] = p.clock
 		p.mu.Unlock()
 		return pcid, false // No flush.
 	}
@@ -68,7 +91,7 @@ func (p *PCIDs) Assign(pt *PageTables) (uint16, bool) {
 	if len(p.avail) > 0 {
 		pcid := p.avail[len(p.avail)-1]
 		p.avail = p.avail[:len(p.avail)-1]
-		p.cache[pt] = pcid
+		p.assignLocked(pt, pcid)
 
 		// We need to flush because while this is in the available
 		// pool, it may have been used previously.
@@ -76,10 +99,17 @@ func (p *PCIDs) Assign(pt *PageTables) (uint16, bool) {
 		return pcid, true
 	}
 
-	// Evict an existing table.
-	for old, pcid := range p.cache {
-		delete(p.cache, old)
-		p.cache[pt] = pcid
+	// Evict the least recently used table.
+	if len(p.owners) > 0 {
+		oldest := 0
+		for i := range p.lastUse {
+			if p.lastUse[i] < p.lastUse[oldest] {
+				oldest = i
+			}
+		}
+		pcid := p.start + uint16(oldest)
+		delete(p.cache, p.owners[oldest])
+		p.assignLocked(pt, pcid)
 
 		// A flush is definitely required in this case, these page
 		// tables may still be active. (They will just be assigned some
@@ -93,11 +123,21 @@ func (p *PCIDs) Assign(pt *PageTables) (uint16, bool) {
 	return 0, false
 }
 
+// assignLocked assigns pcid to pt.
+//
+// Preconditions: p.mu must be locked.
+func (p *PCIDs) assignLocked(pt *PageTables, pcid uint16) {
+	p.cache[pt] = pcid
+	p.owners[pcid-p.start] = pt
+	p.lastUse[pcid-p.start] = p.clock
+}
+
 // Drop drops references to a set of page tables.
 func (p *PCIDs) Drop(pt *PageTables) {
 	p.mu.Lock()
 	if pcid, ok := p.cache[pt]; ok {
 		delete(p.cache, pt)
+		p.owners[pcid-p.start] = nil
 		p.avail = append(p.avail, pcid)
 	}
 	p.mu.Unlock()
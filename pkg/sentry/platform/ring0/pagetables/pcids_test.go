@@ -0,0 +1,66 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package pagetables
+
+import (
+	"testing"
+)
+
+func TestPCIDsReuse(t *testing.T) {
+	p := NewPCIDs(1, 2)
+	pt := &PageTables{}
+
+	pcid, flush := p.Assign(pt)
+	if !flush {
+		t.Errorf("first Assign didn't require a flush")
+	}
+	if got, flush := p.Assign(pt); got != pcid || flush {
+		t.Errorf("second Assign got (%d, %t), want (%d, false)", got, flush, pcid)
+	}
+}
+
+func TestPCIDsEvictLeastRecentlyUsed(t *testing.T) {
+	p := NewPCIDs(1, 2)
+	a, b, c := &PageTables{}, &PageTables{}, &PageTables{}
+
+	pcidA, _ := p.Assign(a)
+	p.Assign(b)
+	// Use a again, so that b is the least recently used.
+	p.Assign(a)
+
+	if _, flush := p.Assign(c); !flush {
+		t.Errorf("Assign after eviction didn't require a flush")
+	}
+	if got, flush := p.Assign(a); got != pcidA || flush {
+		t.Errorf("Assign(a) got (%d, %t), want (%d, false)", got, flush, pcidA)
+	}
+	if _, flush := p.Assign(b); !flush {
+		t.Errorf("Assign(b) didn't require a flush after b was evicted")
+	}
+}
+
+func TestPCIDsDrop(t *testing.T) {
+	p := NewPCIDs(1, 1)
+	a, b := &PageTables{}, &PageTables{}
+
+	pcid, _ := p.Assign(a)
+	p.Drop(a)
+	if got, flush := p.Assign(b); got != pcid || !flush {
+		t.Errorf("Assign(b) got (%d, %t), want (%d, true)", got, flush, pcid)
+	}
+	if got, flush := p.Assign(b); got != pcid || flush {
+		t.Errorf("second Assign(b) got (%d, %t), want (%d, false)", got, flush, pcid)
+	}
+}
@@ -110,11 +110,25 @@ func (fs *RightsFiles) Release() {
 // rightsFDs gets up to the specified maximum number of FDs.
 func rightsFDs(t *kernel.Task, rights SCMRights, cloexec bool, max int) ([]int32, bool) {
 	files, trunc := rights.Files(t, max)
+	flags := kernel.FDFlags{
+		CloseOnExec: cloexec,
+	}
+
+	// Install all files with a single FD table update if they fit, rather
+	// than locking the table and searching for a free FD once per file.
+	if len(files) > 0 {
+		if fds, err := t.NewFDs(0, files, flags); err == nil {
+			for _, f := range files {
+				f.DecRef()
+			}
+			return fds, trunc
+		}
+	}
+
+	// Otherwise, install as many as possible.
 	fds := make([]int32, 0, len(files))
 	for i := 0; i < max && len(files) > 0; i++ {
-		fd, err := t.NewFDFrom(0, files[0], kernel.FDFlags{
-			CloseOnExec: cloexec,
-		})
+		fd, err := t.NewFDFrom(0, files[0], flags)
 		files[0].DecRef()
 		files = files[1:]
 		if err != nil {
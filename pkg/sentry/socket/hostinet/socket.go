@@ -48,6 +48,14 @@ const (
 	// maxControlLen is the maximum size of a control message buffer used in a
 	// recvmsg or sendmsg syscall.
 	maxControlLen = 1024
+
+	// maxBatchLen is the maximum total size of the buffers used by one
+	// sendmmsg or recvmmsg syscall. At least one message is always
+	// transferred.
+	maxBatchLen = 1 << 20
+
+	// maxDatagramLen is the size of the largest UDP datagram.
+	maxDatagramLen = 1 << 16
 )
 
 // LINT.IfChange
@@ -85,6 +93,8 @@ type socketOpsCommon struct {
 
 var _ = socket.Socket(&socketOperations{})
 
+var _ = socket.BatchSocket(&socketOpsCommon{})
+
 func newSocketFile(ctx context.Context, family int, stype linux.SockType, protocol int, fd int, nonblock bool) (*fs.File, *syserr.Error) {
 	s := &socketOperations{
 		socketOpsCommon: socketOpsCommon{
@@ -617,6 +627,175 @@ func (s *socketOpsCommon) SendMsg(t *kernel.Task, src usermem.IOSequence, to []b
 	return int(n), syserr.FromError(err)
 }
 
+// batchBufs returns buffers for the messages in a prefix of msgs, limited to
+// maxBatchLen bytes in total.
+func batchBufs(msgs []socket.BatchMessage) [][]byte {
+	total := 0
+	n := 0
+	for ; n < len(msgs); n++ {
+		size := int(msgs[n].Data.NumBytes())
+		if size > maxDatagramLen {
+			size = maxDatagramLen
+		}
+		if n > 0 && total+size > maxBatchLen {
+			break
+		}
+		total += size
+	}
+	buf := make([]byte, total)
+	bufs := make([][]byte, n)
+	for i := range bufs {
+		size := int(msgs[i].Data.NumBytes())
+		if size > maxDatagramLen {
+			size = maxDatagramLen
+		}
+		bufs[i], buf = buf[:size:size], buf[size:]
+	}
+	return bufs
+}
+
+// RecvMsgs implements socket.BatchSocket.RecvMsgs.
+//
+// Datagrams are received into sentry buffers with one host recvmmsg(2) and
+// then copied out, which is cheaper than one host syscall per datagram.
+func (s *socketOpsCommon) RecvMsgs(t *kernel.Task, msgs []socket.BatchMessage, flags int, haveDeadline bool, deadline ktime.Time) (int, *syserr.Error) {
+	// Whitelist flags.
+	if flags&^(syscall.MSG_DONTWAIT|syscall.MSG_TRUNC) != 0 {
+		return 0, syserr.ErrInvalidArgument
+	}
+
+	bufs := batchBufs(msgs)
+	hdrs := make([]mmsghdr, len(bufs))
+	iovs := make([]syscall.Iovec, len(bufs))
+	names := make([]byte, len(bufs)*sizeofSockaddr)
+	for i, buf := range bufs {
+		if len(buf) != 0 {
+			iovs[i].Base = &buf[0]
+			iovs[i].SetLen(len(buf))
+			hdrs[i].Hdr.Iov = &iovs[i]
+			hdrs[i].Hdr.Iovlen = 1
+		}
+		if msgs[i].SenderRequested {
+			hdrs[i].Hdr.Name = &names[i*sizeofSockaddr]
+			hdrs[i].Hdr.Namelen = sizeofSockaddr
+		}
+	}
+
+	// We always do a non-blocking recvmmsg(), and block until the first
+	// datagram arrives rather than once per datagram.
+	sysflags := flags | syscall.MSG_DONTWAIT
+	var ch chan struct{}
+	n, err := recvmmsg(s.fd, hdrs, sysflags)
+	if flags&syscall.MSG_DONTWAIT == 0 {
+		for err == syserror.ErrWouldBlock {
+			if ch != nil {
+				if err = t.BlockWithDeadline(ch, haveDeadline, deadline); err != nil {
+					break
+				}
+			} else {
+				var e waiter.Entry
+				e, ch = waiter.NewChannelEntry(nil)
+				s.EventRegister(&e, waiter.EventIn)
+				defer s.EventUnregister(&e)
+			}
+			n, err = recvmmsg(s.fd, hdrs, sysflags)
+		}
+	}
+	if err != nil {
+		return 0, syserr.FromError(err)
+	}
+
+	for i := 0; i < n; i++ {
+		hdr := &hdrs[i]
+		l := int(hdr.Len)
+		copyLen := l
+		if copyLen > len(bufs[i]) {
+			// MSG_TRUNC returns the real length of longer datagrams.
+			copyLen = len(bufs[i])
+		}
+		if _, err := msgs[i].Data.CopyOut(t, bufs[i][:copyLen]); err != nil {
+			if i == 0 {
+				return 0, syserr.FromError(err)
+			}
+			return i, nil
+		}
+		msgs[i].N = l
+		msgs[i].Flags = int(hdr.Hdr.Flags)
+		if msgs[i].SenderRequested {
+			name := names[i*sizeofSockaddr : i*sizeofSockaddr+int(hdr.Hdr.Namelen)]
+			msgs[i].Sender = socket.UnmarshalSockAddr(s.family, name)
+			msgs[i].SenderLen = hdr.Hdr.Namelen
+		}
+	}
+	return n, nil
+}
+
+// SendMsgs implements socket.BatchSocket.SendMsgs.
+//
+// Datagrams are copied into sentry buffers and then sent with one host
+// sendmmsg(2).
+func (s *socketOpsCommon) SendMsgs(t *kernel.Task, msgs []socket.BatchMessage, flags int, haveDeadline bool, deadline ktime.Time) (int, *syserr.Error) {
+	// Whitelist flags.
+	if flags&^(syscall.MSG_DONTWAIT|syscall.MSG_EOR|syscall.MSG_MORE|syscall.MSG_NOSIGNAL) != 0 {
+		return 0, syserr.ErrInvalidArgument
+	}
+
+	bufs := batchBufs(msgs)
+	hdrs := make([]mmsghdr, len(bufs))
+	iovs := make([]syscall.Iovec, len(bufs))
+	for i, buf := range bufs {
+		if _, err := msgs[i].Data.CopyIn(t, buf); err != nil {
+			if i == 0 {
+				return 0, syserr.FromError(err)
+			}
+			// Send the messages before the fault.
+			hdrs = hdrs[:i]
+			break
+		}
+		if len(buf) != 0 {
+			iovs[i].Base = &buf[0]
+			iovs[i].SetLen(len(buf))
+			hdrs[i].Hdr.Iov = &iovs[i]
+			hdrs[i].Hdr.Iovlen = 1
+		}
+		if to := msgs[i].To; len(to) != 0 {
+			hdrs[i].Hdr.Name = &to[0]
+			hdrs[i].Hdr.Namelen = uint32(len(to))
+		}
+	}
+
+	// We always do a non-blocking sendmmsg().
+	sysflags := flags | syscall.MSG_DONTWAIT
+	var ch chan struct{}
+	n, err := sendmmsg(s.fd, hdrs, sysflags)
+	if flags&syscall.MSG_DONTWAIT == 0 {
+		for err == syserror.ErrWouldBlock {
+			if ch != nil {
+				if err = t.BlockWithDeadline(ch, haveDeadline, deadline); err != nil {
+					if err == syserror.ETIMEDOUT {
+						err = syserror.ErrWouldBlock
+					}
+					break
+				}
+			} else {
+				var e waiter.Entry
+				e, ch = waiter.NewChannelEntry(nil)
+				s.EventRegister(&e, waiter.EventOut)
+				defer s.EventUnregister(&e)
+			}
+			n, err = sendmmsg(s.fd, hdrs, sysflags)
+		}
+	}
+	if err != nil {
+		return 0, syserr.FromError(err)
+	}
+
+	for i := 0; i < n; i++ {
+		msgs[i].N = int(hdrs[i].Len)
+	}
+	return n, nil
+}
+
 func translateIOSyscallError(err error) error {
 	if err == syscall.EAGAIN || err == syscall.EWOULDBLOCK {
 		return syserror.ErrWouldBlock
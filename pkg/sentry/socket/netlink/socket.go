@@ -17,10 +17,12 @@ package netlink
 
 import (
 	"math"
+	"sync/atomic"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/binary"
 	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/device"
 	"gvisor.dev/gvisor/pkg/sentry/fs"
@@ -51,6 +53,14 @@ const (
 
 	// maxBufferSize is the largest size a send buffer can grow to.
 	maxSendBufferSize = 4 << 20 // 4MB
+
+	// minDumpSize is the size of the datagrams of dump responses until the
+	// reader has passed a larger buffer to recvmsg. It approximates
+	// NLMSG_GOODSIZE.
+	minDumpSize = 4 << 10 // 4096 bytes.
+
+	// maxDumpSize is the largest size of the datagrams of dump responses.
+	maxDumpSize = 32 << 10 // 32KB
 )
 
 var errNoFilter = syserr.New("no filter attached", linux.ENOENT)
@@ -104,6 +114,11 @@ type socketOpsCommon struct {
 	// sent to userspace.
 	connection transport.ConnectedEndpoint
 
+	// maxRecvMsgLen is the size of the largest buffer passed to RecvMsg,
+	// capped at maxDumpSize. It sizes the datagrams of dump responses, like
+	// nlk->max_recvmsg_len in Linux. It is accessed atomically.
+	maxRecvMsgLen int64
+
 	// mu protects the fields below.
 	mu sync.Mutex `state:"nosave"`
 
@@ -125,6 +140,11 @@ type socketOpsCommon struct {
 	// TODO(gvisor.dev/issue/1119): We don't actually support filtering,
 	// this is just bookkeeping for tracking add/remove.
 	filter bool
+
+	// pending contains the datagrams of dump responses that did not fit in
+	// the receive buffer when they were generated, and will be sent as the
+	// reader drains it.
+	pending [][][]byte
 }
 
 var _ socket.Socket = (*Socket)(nil)
@@ -510,6 +530,14 @@ func (s *socketOpsCommon) RecvMsg(t *kernel.Task, dst usermem.IOSequence, flags
 
 	trunc := flags&linux.MSG_TRUNC != 0
 
+	if n := dst.NumBytes(); n > atomic.LoadInt64(&s.maxRecvMsgLen) {
+		if n > maxDumpSize {
+			n = maxDumpSize
+		}
+		atomic.StoreInt64(&s.maxRecvMsgLen, n)
+	}
+	defer s.sendPending()
+
 	r := unix.EndpointReader{
 		Ctx:      t,
 		Endpoint: s.ep,
@@ -576,6 +604,7 @@ func (s *Socket) Read(ctx context.Context, _ *fs.File, dst usermem.IOSequence, _
 	if dst.NumBytes() == 0 {
 		return 0, nil
 	}
+	defer s.sendPending()
 	return dst.CopyOutFrom(ctx, &unix.EndpointReader{
 		Endpoint: s.ep,
 	})
@@ -601,31 +630,100 @@ func (kernelSCM) Credentials(*kernel.Task) (kernel.ThreadID, auth.UID, auth.GID)
 // kernelCreds is the concrete version of kernelSCM used in all creds.
 var kernelCreds = &kernelSCM{}
 
-// sendResponse sends the response messages in ms back to userspace.
-func (s *socketOpsCommon) sendResponse(ctx context.Context, ms *MessageSet) *syserr.Error {
-	// Linux combines multiple netlink messages into a single datagram.
-	bufs := make([][]byte, 0, len(ms.Messages))
-	for _, m := range ms.Messages {
-		bufs = append(bufs, m.Finalize())
+// dumpSize returns the maximum size of a datagram of a dump response.
+func (s *socketOpsCommon) dumpSize() int {
+	if n := int(atomic.LoadInt64(&s.maxRecvMsgLen)); n > minDumpSize {
+		return n
 	}
+	return minDumpSize
+}
 
+// send sends a datagram containing bufs to userspace.
+func (s *socketOpsCommon) send(bufs [][]byte) *syserr.Error {
 	// All messages are from the kernel.
 	cms := transport.ControlMessages{
 		Credentials: kernelCreds,
 	}
+	// RecvMsg never receives the address, so we don't need to send one.
+	_, notify, err := s.connection.Send(bufs, cms, tcpip.FullAddress{})
+	if err != nil {
+		return err
+	}
+	if notify {
+		s.connection.SendNotify()
+	}
+	return nil
+}
 
-	if len(bufs) > 0 {
-		// RecvMsg never receives the address, so we don't need to send
-		// one.
-		_, notify, err := s.connection.Send(bufs, cms, tcpip.FullAddress{})
-		// If the buffer is full, we simply drop messages, just like
-		// Linux.
-		if err != nil && err != syserr.ErrWouldBlock {
+// sendPendingLocked sends the datagrams of dumps in s.pending, until the
+// receive buffer is full.
+//
+// Preconditions: s.mu must be locked.
+func (s *socketOpsCommon) sendPendingLocked() *syserr.Error {
+	for len(s.pending) > 0 {
+		err := s.send(s.pending[0])
+		if err == syserr.ErrWouldBlock {
+			return nil
+		}
+		s.pending[0] = nil
+		s.pending = s.pending[1:]
+		if err != nil {
 			return err
 		}
-		if notify {
-			s.connection.SendNotify()
+	}
+	s.pending = nil
+	return nil
+}
+
+// sendPending continues sending any dumps in progress, after the reader has
+// made room in the receive buffer. Compare Linux's
+// net/netlink/af_netlink.c:netlink_recvmsg() => netlink_dump().
+func (s *socketOpsCommon) sendPending() {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if err := s.sendPendingLocked(); err != nil {
+		log.Warningf("Failed to send netlink dump: %v", err)
+	}
+}
+
+// sendResponse sends the response messages in ms back to userspace.
+//
+// Preconditions: s.mu must be locked.
+func (s *socketOpsCommon) sendResponse(ctx context.Context, ms *MessageSet) *syserr.Error {
+	// Linux combines multiple netlink messages into a single datagram. The
+	// messages of a dump are split into datagrams no larger than the
+	// reader's buffer, so that readers don't need a buffer large enough
+	// for the whole dump. See net/netlink/af_netlink.c:netlink_dump.
+	limit := math.MaxInt32
+	if ms.Multi {
+		limit = s.dumpSize()
+	}
+	var dgrams [][][]byte
+	var bufs [][]byte
+	size := 0
+	for _, m := range ms.Messages {
+		b := m.Finalize()
+		if len(bufs) > 0 && size+len(b) > limit {
+			dgrams = append(dgrams, bufs)
+			bufs = nil
+			size = 0
+		}
+		bufs = append(bufs, b)
+		size += len(b)
+	}
+	if len(bufs) > 0 {
+		dgrams = append(dgrams, bufs)
+	}
+
+	if !ms.Multi {
+		for _, bufs := range dgrams {
+			// If the buffer is full, we simply drop messages, just
+			// like Linux.
+			if err := s.send(bufs); err != nil && err != syserr.ErrWouldBlock {
+				return err
+			}
 		}
+		return nil
 	}
 
 	// N.B. multi-part messages should still send NLMSG_DONE even if
@@ -633,27 +731,23 @@ func (s *socketOpsCommon) sendResponse(ctx context.Context, ms *MessageSet) *sys
 	//
 	// N.B. NLMSG_DONE is always sent in a different datagram. See
 	// net/netlink/af_netlink.c:netlink_dump.
-	if ms.Multi {
-		m := NewMessage(linux.NetlinkMessageHeader{
-			Type:   linux.NLMSG_DONE,
-			Flags:  linux.NLM_F_MULTI,
-			Seq:    ms.Seq,
-			PortID: uint32(ms.PortID),
-		})
-
-		// Add the dump_done_errno payload.
-		m.Put(int64(0))
-
-		_, notify, err := s.connection.Send([][]byte{m.Finalize()}, cms, tcpip.FullAddress{})
-		if err != nil && err != syserr.ErrWouldBlock {
-			return err
-		}
-		if notify {
-			s.connection.SendNotify()
-		}
-	}
+	m := NewMessage(linux.NetlinkMessageHeader{
+		Type:   linux.NLMSG_DONE,
+		Flags:  linux.NLM_F_MULTI,
+		Seq:    ms.Seq,
+		PortID: uint32(ms.PortID),
+	})
 
-	return nil
+	// Add the dump_done_errno payload.
+	m.Put(int64(0))
+	dgrams = append(dgrams, [][]byte{m.Finalize()})
+
+	// Unlike other responses, dumps aren't dropped when the receive buffer
+	// is full. Linux generates them incrementally as the reader drains the
+	// buffer; we queue what doesn't fit until then, so that large dumps
+	// (e.g. of sockets) are delivered in full.
+	s.pending = append(s.pending, dgrams...)
+	return s.sendPendingLocked()
 }
 
 func dumpErrorMesage(hdr linux.NetlinkMessageHeader, ms *MessageSet, err *syserr.Error) {
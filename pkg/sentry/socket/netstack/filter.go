@@ -0,0 +1,157 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package netstack
+
+import (
+	"encoding/binary"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/bpf"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/socket"
+	"gvisor.dev/gvisor/pkg/syserr"
+	"gvisor.dev/gvisor/pkg/tcpip"
+	"gvisor.dev/gvisor/pkg/tcpip/buffer"
+	"gvisor.dev/gvisor/pkg/usermem"
+)
+
+// sizeOfSockFprog is the size of struct sock_fprog on 64-bit architectures.
+const sizeOfSockFprog = 16
+
+// socketFilter is a classic BPF program attached to a socket with
+// SO_ATTACH_FILTER. It implements tcpip.SocketFilter.
+//
+// The program is validated once, when it is attached, and is then run over
+// each packet in place, without copying the packet.
+//
+// +stateify savable
+type socketFilter struct {
+	prog bpf.Program
+}
+
+// Filter implements tcpip.SocketFilter.Filter.
+func (f *socketFilter) Filter(pkt buffer.VectorisedView) int {
+	in := packetInput{views: pkt.Views(), size: pkt.Size()}
+	ret, err := bpf.Exec(f.prog, &in)
+	if err != nil {
+		// As in Linux, a program that fails, e.g. by loading past the
+		// end of the packet, drops the packet.
+		return 0
+	}
+	if uint64(ret) > uint64(in.size) {
+		return in.size
+	}
+	return int(ret)
+}
+
+// packetInput implements bpf.Input for a packet held in a VectorisedView.
+// Loads are in network byte order.
+type packetInput struct {
+	views []buffer.View
+	size  int
+}
+
+// load copies len(b) bytes of the packet starting at off into b. It returns
+// false if the packet is too short.
+func (in *packetInput) load(off uint32, b []byte) bool {
+	if uint64(off)+uint64(len(b)) > uint64(in.size) {
+		return false
+	}
+	o := int(off)
+	for _, v := range in.views {
+		if o >= len(v) {
+			o -= len(v)
+			continue
+		}
+		n := copy(b, v[o:])
+		if b = b[n:]; len(b) == 0 {
+			return true
+		}
+		o = 0
+	}
+	return false
+}
+
+// Load32 implements bpf.Input.Load32.
+func (in *packetInput) Load32(off uint32) (uint32, bool) {
+	var b [4]byte
+	if !in.load(off, b[:]) {
+		return 0, false
+	}
+	return binary.BigEndian.Uint32(b[:]), true
+}
+
+// Load16 implements bpf.Input.Load16.
+func (in *packetInput) Load16(off uint32) (uint16, bool) {
+	var b [2]byte
+	if !in.load(off, b[:]) {
+		return 0, false
+	}
+	return binary.BigEndian.Uint16(b[:]), true
+}
+
+// Load8 implements bpf.Input.Load8.
+func (in *packetInput) Load8(off uint32) (uint8, bool) {
+	var b [1]byte
+	if !in.load(off, b[:]) {
+		return 0, false
+	}
+	return b[0], true
+}
+
+// Length implements bpf.Input.Length.
+func (in *packetInput) Length() uint32 {
+	return uint32(in.size)
+}
+
+// attachFilter implements setsockopt(SO_ATTACH_FILTER). optVal holds a struct
+// sock_fprog.
+func attachFilter(t *kernel.Task, ep commonEndpoint, optVal []byte) *syserr.Error {
+	if len(optVal) < sizeOfSockFprog {
+		return syserr.ErrInvalidArgument
+	}
+	n := usermem.ByteOrder.Uint16(optVal[0:])
+	addr := usermem.Addr(usermem.ByteOrder.Uint64(optVal[8:]))
+	if n == 0 || n > bpf.MaxInstructions {
+		return syserr.ErrInvalidArgument
+	}
+	insns := make([]linux.BPFInstruction, int(n))
+	if _, err := t.CopyIn(addr, &insns); err != nil {
+		return syserr.FromError(err)
+	}
+	prog, err := bpf.Compile(insns)
+	if err != nil {
+		t.Debugf("Invalid socket filter: %v", err)
+		return syserr.ErrInvalidArgument
+	}
+	return setFilter(t, ep, linux.SO_ATTACH_FILTER, &socketFilter{prog})
+}
+
+// detachFilter implements setsockopt(SO_DETACH_FILTER).
+func detachFilter(t *kernel.Task, ep commonEndpoint) *syserr.Error {
+	return setFilter(t, ep, linux.SO_DETACH_FILTER, nil)
+}
+
+// setFilter attaches filter to ep, or detaches ep's filter if filter is nil.
+func setFilter(t *kernel.Task, ep commonEndpoint, name int, filter tcpip.SocketFilter) *syserr.Error {
+	var cur tcpip.SocketFilterOption
+	if err := ep.GetSockOpt(&cur); err != nil {
+		// Only packet and raw endpoints support filters. Keep the old
+		// behavior for others.
+		socket.SetSockOptEmitUnimplementedEvent(t, name)
+		return syserr.TranslateNetstackError(ep.SetSockOpt(struct{}{}))
+	}
+	return syserr.TranslateNetstackError(ep.SetSockOpt(tcpip.SocketFilterOption{Filter: filter}))
+}
@@ -1268,7 +1268,6 @@ func getSockOptTCP(t *kernel.Task, ep commonEndpoint, name, outLen int) (interfa
 		return ib, nil
 
 	case linux.TCP_CC_INFO,
-		linux.TCP_NOTSENT_LOWAT,
 		linux.TCP_ZEROCOPY_RECEIVE:
 
 		t.Kernel().EmitUnimplementedEvent(t)
@@ -1343,6 +1342,18 @@ func getSockOptTCP(t *kernel.Task, ep commonEndpoint, name, outLen int) (interfa
 			return nil, syserr.TranslateNetstackError(err)
 		}
 
+		return int32(v), nil
+
+	case linux.TCP_NOTSENT_LOWAT:
+		if outLen < sizeOfInt32 {
+			return nil, syserr.ErrInvalidArgument
+		}
+
+		v, err := ep.GetSockOptInt(tcpip.TCPNotsentLowatOption)
+		if err != nil {
+			return nil, syserr.TranslateNetstackError(err)
+		}
+
 		return int32(v), nil
 	default:
 		emitUnimplementedEventTCP(t, name)
@@ -1712,6 +1723,12 @@ func setSockOptSocket(t *kernel.Task, s socket.SocketOps, ep commonEndpoint, nam
 
 		return nil
 
+	case linux.SO_ATTACH_FILTER:
+		return attachFilter(t, ep, optVal)
+
+	case linux.SO_DETACH_FILTER:
+		return detachFilter(t, ep)
+
 	default:
 		socket.SetSockOptEmitUnimplementedEvent(t, name)
 	}
@@ -1829,6 +1846,14 @@ func setSockOptTCP(t *kernel.Task, ep commonEndpoint, name int, optVal []byte) *
 
 		return syserr.TranslateNetstackError(ep.SetSockOptInt(tcpip.TCPWindowClampOption, int(v)))
 
+	case linux.TCP_NOTSENT_LOWAT:
+		if len(optVal) < sizeOfInt32 {
+			return syserr.ErrInvalidArgument
+		}
+		v := usermem.ByteOrder.Uint32(optVal)
+
+		return syserr.TranslateNetstackError(ep.SetSockOptInt(tcpip.TCPNotsentLowatOption, int(v)))
+
 	case linux.TCP_REPAIR_OPTIONS:
 		t.Kernel().EmitUnimplementedEvent(t)
 
@@ -146,6 +146,50 @@ type SocketOps interface {
 	Type() (family int, skType linux.SockType, protocol int)
 }
 
+// BatchMessage is a message sent or received by a BatchSocket.
+type BatchMessage struct {
+	// Data is the message payload.
+	Data usermem.IOSequence
+
+	// To is the destination address of a sent message, in the same format as
+	// the to argument of SocketOps.SendMsg. It is nil if the socket's peer
+	// should be used.
+	To []byte
+
+	// SenderRequested is whether the sender of a received message should be
+	// returned in Sender and SenderLen.
+	SenderRequested bool
+
+	// N is the number of bytes sent or received.
+	N int
+
+	// Flags are the message flags of a received message.
+	Flags int
+
+	// Sender is the sender of a received message if SenderRequested is set.
+	// SenderLen is the address length to be returned to the application, as
+	// for SocketOps.RecvMsg.
+	Sender    linux.SockAddr
+	SenderLen uint32
+}
+
+// BatchSocket is implemented by datagram sockets that can transfer several
+// messages with one operation, e.g. hostinet sockets using the host's
+// sendmmsg(2) and recvmmsg(2). The sendmmsg(2) and recvmmsg(2) syscalls use it
+// for messages without control data.
+type BatchSocket interface {
+	// SendMsgs sends a prefix of msgs, setting N for each message sent. It
+	// blocks until at least one message is sent unless flags contains
+	// MSG_DONTWAIT. If n > 0, err is nil.
+	SendMsgs(t *kernel.Task, msgs []BatchMessage, flags int, haveDeadline bool, deadline ktime.Time) (n int, err *syserr.Error)
+
+	// RecvMsgs receives into a prefix of msgs, setting N, Flags and, if
+	// requested, Sender and SenderLen for each message received. It blocks
+	// until at least one message is received unless flags contains
+	// MSG_DONTWAIT. If n > 0, err is nil.
+	RecvMsgs(t *kernel.Task, msgs []BatchMessage, flags int, haveDeadline bool, deadline ktime.Time) (n int, err *syserr.Error)
+}
+
 // Provider is the interface implemented by providers of sockets for specific
 // address families (e.g., AF_INET).
 type Provider interface {
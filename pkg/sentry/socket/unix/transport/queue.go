@@ -112,29 +112,95 @@ func (q *queue) IsWritable() bool {
 // If notify is true, ReaderQueue.Notify must be called:
 // q.ReaderQueue.Notify(waiter.EventIn)
 func (q *queue) Enqueue(data [][]byte, c ControlMessages, from tcpip.FullAddress, discardEmpty bool, truncate bool) (l int64, notify bool, err *syserr.Error) {
+	for _, d := range data {
+		l += int64(len(d))
+	}
+
+	// Datagrams small enough that copying them is cheaper than an extra
+	// acquisition of q.mu are copied before checking for room, so that
+	// many concurrent writers (e.g. syslog(3) clients of /dev/log) each
+	// take q.mu once. Larger writes are checked first, so that a write
+	// that doesn't fit isn't copied for nothing.
+	if truncate || l > maxUncheckedCopy {
+		q.mu.Lock()
+
+		if q.closed {
+			q.mu.Unlock()
+			return 0, false, syserr.ErrClosedForSend
+		}
+
+		if discardEmpty && l == 0 {
+			q.mu.Unlock()
+			c.Release()
+			return 0, false, nil
+		}
+
+		l, err = q.fitLocked(l, truncate)
+		q.mu.Unlock()
+		if l == 0 && err != nil {
+			return 0, false, err
+		}
+	}
+
+	// Aggregate l bytes of data without holding q.mu, so that readers can
+	// keep draining the queue while large writes are copied. This will
+	// truncate the data if l is less than the total bytes held in data.
+	v := make([]byte, l)
+	for i, b := 0, v; i < len(data) && len(b) > 0; i++ {
+		n := copy(b, data[i])
+		b = b[n:]
+	}
+
 	q.mu.Lock()
 
+	// Readers only free space, but other writers may have raced with us
+	// for it, or the queue may have been closed.
 	if q.closed {
 		q.mu.Unlock()
 		return 0, false, syserr.ErrClosedForSend
 	}
-
-	for _, d := range data {
-		l += int64(len(d))
-	}
 	if discardEmpty && l == 0 {
 		q.mu.Unlock()
 		c.Release()
 		return 0, false, nil
 	}
+	if n, ferr := q.fitLocked(l, truncate); n == 0 && ferr != nil {
+		q.mu.Unlock()
+		return 0, false, ferr
+	} else if n < l {
+		l, v, err = n, v[:n], ferr
+	}
+
+	notify = q.dataList.Front() == nil
+	q.used += l
+	q.dataList.PushBack(&message{
+		Data:    buffer.View(v),
+		Control: c,
+		Address: from,
+	})
 
+	q.mu.Unlock()
+
+	return l, notify, err
+}
+
+// maxUncheckedCopy is the size of the largest datagram that Enqueue copies
+// before checking that it fits in the queue.
+const maxUncheckedCopy = 4096
+
+// fitLocked returns how many of l bytes can be enqueued right now. If the
+// message is truncated to fit, err is ErrWouldBlock. If nothing can be
+// enqueued, fitLocked returns 0 and a non-nil error.
+//
+// Preconditions: q.mu must be locked.
+func (q *queue) fitLocked(l int64, truncate bool) (int64, *syserr.Error) {
+	var err *syserr.Error
 	free := q.limit - q.used
 
 	if l > free && truncate {
 		if free == 0 {
 			// Message can't fit right now.
-			q.mu.Unlock()
-			return 0, false, syserr.ErrWouldBlock
+			return 0, syserr.ErrWouldBlock
 		}
 
 		l = free
@@ -143,35 +209,15 @@ func (q *queue) Enqueue(data [][]byte, c ControlMessages, from tcpip.FullAddress
 
 	if l > q.limit {
 		// Message is too big to ever fit.
-		q.mu.Unlock()
-		return 0, false, syserr.ErrMessageTooLong
+		return 0, syserr.ErrMessageTooLong
 	}
 
 	if l > free {
 		// Message can't fit right now, and could not be truncated.
-		q.mu.Unlock()
-		return 0, false, syserr.ErrWouldBlock
+		return 0, syserr.ErrWouldBlock
 	}
 
-	// Aggregate l bytes of data. This will truncate the data if l is less than
-	// the total bytes held in data.
-	v := make([]byte, l)
-	for i, b := 0, v; i < len(data) && len(b) > 0; i++ {
-		n := copy(b, data[i])
-		b = b[n:]
-	}
-
-	notify = q.dataList.Front() == nil
-	q.used += l
-	q.dataList.PushBack(&message{
-		Data:    buffer.View(v),
-		Control: c,
-		Address: from,
-	})
-
-	q.mu.Unlock()
-
-	return l, notify, err
+	return l, err
 }
 
 // Dequeue removes the first entry in the data queue, if one exists.
@@ -182,13 +228,7 @@ func (q *queue) Dequeue() (e *message, notify bool, err *syserr.Error) {
 	q.mu.Lock()
 
 	if q.dataList.Front() == nil {
-		err := syserr.ErrWouldBlock
-		if q.closed {
-			err = syserr.ErrClosedForReceive
-			if q.unread {
-				err = syserr.ErrConnectionReset
-			}
-		}
+		err := q.emptyErrorLocked()
 		q.mu.Unlock()
 
 		return nil, false, err
@@ -207,19 +247,62 @@ func (q *queue) Dequeue() (e *message, notify bool, err *syserr.Error) {
 	return e, notify, nil
 }
 
+// DequeueBatch removes up to len(ms) entries from the front of the data queue
+// and stores them in ms, acquiring q.mu only once, so that a reader draining
+// many small messages contends less with writers. n is the number of entries
+// removed; if there are none, err is the same as Dequeue's.
+//
+// If notify is true, WriterQueue.Notify must be called:
+// q.WriterQueue.Notify(waiter.EventOut)
+func (q *queue) DequeueBatch(ms []*message) (n int, notify bool, err *syserr.Error) {
+	q.mu.Lock()
+
+	if q.dataList.Front() == nil {
+		err := q.emptyErrorLocked()
+		q.mu.Unlock()
+
+		return 0, false, err
+	}
+
+	notify = !q.bufWritable()
+
+	for ; n < len(ms); n++ {
+		e := q.dataList.Front()
+		if e == nil {
+			break
+		}
+		q.dataList.Remove(e)
+		q.used -= e.Length()
+		ms[n] = e
+	}
+
+	notify = notify && q.bufWritable()
+
+	q.mu.Unlock()
+
+	return n, notify, nil
+}
+
+// emptyErrorLocked returns the error of reading from q when it is empty.
+//
+// Preconditions: q.mu must be locked.
+func (q *queue) emptyErrorLocked() *syserr.Error {
+	if !q.closed {
+		return syserr.ErrWouldBlock
+	}
+	if q.unread {
+		return syserr.ErrConnectionReset
+	}
+	return syserr.ErrClosedForReceive
+}
+
 // Peek returns the first entry in the data queue, if one exists.
 func (q *queue) Peek() (*message, *syserr.Error) {
 	q.mu.Lock()
 	defer q.mu.Unlock()
 
 	if q.dataList.Front() == nil {
-		err := syserr.ErrWouldBlock
-		if q.closed {
-			if err = syserr.ErrClosedForReceive; q.unread {
-				err = syserr.ErrConnectionReset
-			}
-		}
-		return nil, err
+		return nil, q.emptyErrorLocked()
 	}
 
 	return q.dataList.Front().Peek(), nil
@@ -124,6 +124,17 @@ type Endpoint interface {
 	// required by the caller.
 	RecvMsg(ctx context.Context, data [][]byte, creds bool, numRights int, peek bool, addr *tcpip.FullAddress) (recvLen, msgLen int64, cm ControlMessages, CMTruncated bool, err *syserr.Error)
 
+	// RecvMsgs removes up to len(msgs) whole messages from the endpoint and
+	// stores them in msgs, taking the endpoint's receive queue lock only
+	// once. It returns the number of messages removed. The caller takes
+	// ownership of their control messages. This method does not block if
+	// there is no data pending.
+	//
+	// RecvMsgs is only supported by datagram endpoints whose messages are
+	// queued in the sentry. Otherwise it returns ErrNotSupported, and
+	// messages must be received with RecvMsg.
+	RecvMsgs(ctx context.Context, msgs []Message) (int, *syserr.Error)
+
 	// SendMsg writes data and a control message to the endpoint's peer.
 	// This method does not block if the data cannot be written.
 	//
@@ -275,6 +286,19 @@ type message struct {
 	Address tcpip.FullAddress
 }
 
+// Message is a message received by Endpoint.RecvMsgs.
+type Message struct {
+	// Data is the message payload. It must not be modified.
+	Data []byte
+
+	// Control is the control message data sent with the message.
+	Control ControlMessages
+
+	// Address is the bound address of the endpoint that sent the message,
+	// as for message.Address.
+	Address tcpip.FullAddress
+}
+
 // Length returns number of bytes stored in the message.
 func (m *message) Length() int64 {
 	return int64(len(m.Data))
@@ -814,6 +838,43 @@ func (e *baseEndpoint) RecvMsg(ctx context.Context, data [][]byte, creds bool, n
 	return recvLen, msgLen, cms, cmt, nil
 }
 
+// RecvMsgs implements Endpoint.RecvMsgs.
+func (e *baseEndpoint) RecvMsgs(ctx context.Context, msgs []Message) (int, *syserr.Error) {
+	e.Lock()
+
+	if e.receiver == nil {
+		e.Unlock()
+		return 0, syserr.ErrNotConnected
+	}
+	// Stream sockets use streamQueueReceiver, and host sockets their own
+	// Receiver.
+	q, ok := e.receiver.(*queueReceiver)
+	if !ok {
+		e.Unlock()
+		return 0, syserr.ErrNotSupported
+	}
+
+	ms := make([]*message, len(msgs))
+	n, notify, err := q.readQueue.DequeueBatch(ms)
+	e.Unlock()
+	if err != nil {
+		return 0, err
+	}
+
+	if notify {
+		q.RecvNotify()
+	}
+
+	for i, m := range ms[:n] {
+		msgs[i] = Message{
+			Data:    m.Data,
+			Control: m.Control,
+			Address: m.Address,
+		}
+	}
+	return n, nil
+}
+
 // SendMsg writes data and a control message to the endpoint's peer.
 // This method does not block if the data cannot be written.
 func (e *baseEndpoint) SendMsg(ctx context.Context, data [][]byte, c ControlMessages, to BoundEndpoint) (int64, *syserr.Error) {
@@ -688,6 +688,131 @@ func (s *socketOpsCommon) RecvMsg(t *kernel.Task, dst usermem.IOSequence, flags
 	}
 }
 
+// RecvMsgs implements socket.BatchSocket.RecvMsgs.
+//
+// Datagrams are removed from the receive queue in batches with
+// transport.Endpoint.RecvMsgs, taking the queue's lock once per batch rather
+// than once per datagram. This matters when many writers contend for the
+// queue, as syslog(3) clients of /dev/log do.
+func (s *socketOpsCommon) RecvMsgs(t *kernel.Task, msgs []socket.BatchMessage, flags int, haveDeadline bool, deadline ktime.Time) (int, *syserr.Error) {
+	if flags&^(linux.MSG_DONTWAIT|linux.MSG_TRUNC) != 0 {
+		return s.recvMsgsSingly(t, msgs, flags, haveDeadline, deadline)
+	}
+
+	n, err := s.recvMsgsBatch(t, msgs, flags)
+	if err == syserr.ErrNotSupported {
+		return s.recvMsgsSingly(t, msgs, flags, haveDeadline, deadline)
+	}
+	if err != syserr.ErrWouldBlock || flags&linux.MSG_DONTWAIT != 0 {
+		return n, err
+	}
+
+	// We'll have to block. Register for notification and keep trying to
+	// receive.
+	e, ch := waiter.NewChannelEntry(nil)
+	s.EventRegister(&e, waiter.EventIn)
+	defer s.EventUnregister(&e)
+
+	for {
+		if n, err := s.recvMsgsBatch(t, msgs, flags); err != syserr.ErrWouldBlock {
+			return n, err
+		}
+
+		if err := t.BlockWithDeadline(ch, haveDeadline, deadline); err != nil {
+			if err == syserror.ETIMEDOUT {
+				return 0, syserr.ErrTryAgain
+			}
+			return 0, syserr.FromError(err)
+		}
+	}
+}
+
+// recvMsgsBatch receives a batch of datagrams into msgs without blocking, as
+// RecvMsg would with no control message buffer.
+func (s *socketOpsCommon) recvMsgsBatch(t *kernel.Task, msgs []socket.BatchMessage, flags int) (int, *syserr.Error) {
+	batch := make([]transport.Message, len(msgs))
+	n, err := s.ep.RecvMsgs(t, batch)
+	if err != nil {
+		return 0, err
+	}
+
+	// Release all control messages, including those of datagrams that
+	// won't be returned because of a copy error below.
+	passcred := s.Passcred()
+	for i := range batch[:n] {
+		msgs[i].Flags = 0
+		if passcred || !batch[i].Control.Empty() {
+			msgs[i].Flags |= linux.MSG_CTRUNC
+		}
+		batch[i].Control.Release()
+	}
+
+	for i := range batch[:n] {
+		m, msg := &batch[i], &msgs[i]
+		copied, err := msg.Data.CopyOut(t, m.Data)
+		if err != nil {
+			if i == 0 {
+				return 0, syserr.FromError(err)
+			}
+			return i, nil
+		}
+		msg.N = copied
+		if copied < len(m.Data) {
+			msg.Flags |= linux.MSG_TRUNC
+			if flags&linux.MSG_TRUNC != 0 {
+				msg.N = len(m.Data)
+			}
+		}
+		msg.Sender, msg.SenderLen = nil, 0
+		if msg.SenderRequested && len(m.Address.Addr) != 0 {
+			msg.Sender, msg.SenderLen = netstack.ConvertAddress(linux.AF_UNIX, m.Address)
+		}
+	}
+	return n, nil
+}
+
+// recvMsgsSingly receives into msgs with one RecvMsg per datagram, for flags
+// and endpoints that recvMsgsBatch doesn't support.
+func (s *socketOpsCommon) recvMsgsSingly(t *kernel.Task, msgs []socket.BatchMessage, flags int, haveDeadline bool, deadline ktime.Time) (int, *syserr.Error) {
+	for i := range msgs {
+		msg := &msgs[i]
+		n, msgFlags, sender, senderLen, cms, err := s.RecvMsg(t, msg.Data, flags, haveDeadline, deadline, msg.SenderRequested, 0)
+		if err != nil {
+			if i == 0 {
+				return 0, err
+			}
+			return i, nil
+		}
+		if !cms.Unix.Empty() {
+			msgFlags |= linux.MSG_CTRUNC
+			cms.Release()
+		}
+		msg.N, msg.Flags, msg.Sender, msg.SenderLen = n, msgFlags, sender, senderLen
+
+		// Only wait for the first datagram.
+		flags |= linux.MSG_DONTWAIT
+	}
+	return len(msgs), nil
+}
+
+// SendMsgs implements socket.BatchSocket.SendMsgs.
+//
+// Each datagram is sent with SendMsg, since the peer's receive queue is only
+// locked once per datagram anyway.
+func (s *socketOpsCommon) SendMsgs(t *kernel.Task, msgs []socket.BatchMessage, flags int, haveDeadline bool, deadline ktime.Time) (int, *syserr.Error) {
+	for i := range msgs {
+		n, err := s.SendMsg(t, msgs[i].Data, msgs[i].To, flags, haveDeadline, deadline, socket.ControlMessages{})
+		if err != nil {
+			if i == 0 {
+				return 0, err
+			}
+			return i, nil
+		}
+		msgs[i].N = n
+	}
+	return len(msgs), nil
+}
+
 // State implements socket.Socket.State.
 func (s *socketOpsCommon) State() uint32 {
 	return s.ep.State()
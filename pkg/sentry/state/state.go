@@ -18,6 +18,7 @@ package state
 import (
 	"fmt"
 	"io"
+	"os"
 
 	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/sentry/inet"
@@ -46,6 +47,10 @@ type SaveOpts struct {
 	// Destination is the save target.
 	Destination io.Writer
 
+	// Pages, if not nil, receives the contents of application memory, as for
+	// kernel.Kernel.SaveTo.
+	Pages *os.File
+
 	// Key is used for state integrity check.
 	Key []byte
 
@@ -78,7 +83,7 @@ func (opts SaveOpts) Save(k *kernel.Kernel, w *watchdog.Watchdog) error {
 		err = ErrStateFile{err}
 	} else {
 		// Save the kernel.
-		err = k.SaveTo(wc)
+		err = k.SaveTo(wc, opts.Pages)
 
 		// ENOSPC is a state file error. This error can only come from
 		// writing the state file, and not from fs.FileOperations.Fsync
@@ -100,6 +105,9 @@ type LoadOpts struct {
 	// Destination is the load source.
 	Source io.Reader
 
+	// Pages is the pages file saved with Source, if any.
+	Pages *os.File
+
 	// Key is used for state integrity check.
 	Key []byte
 }
@@ -115,5 +123,5 @@ func (opts LoadOpts) Load(k *kernel.Kernel, n inet.Stack, clocks time.Clocks) er
 	previousMetadata = m
 
 	// Restore the Kernel object graph.
-	return k.LoadFrom(r, n, clocks)
+	return k.LoadFrom(r, opts.Pages, n, clocks)
 }
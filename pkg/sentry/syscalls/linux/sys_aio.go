@@ -23,6 +23,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/kernel/eventfd"
 	ktime "gvisor.dev/gvisor/pkg/sentry/kernel/time"
 	"gvisor.dev/gvisor/pkg/sentry/mm"
+	"gvisor.dev/gvisor/pkg/sync"
 	"gvisor.dev/gvisor/pkg/syserror"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
@@ -307,6 +308,68 @@ func performCallback(t *kernel.Task, file *fs.File, cbAddr usermem.Addr, cb *ioC
 	}
 }
 
+// maxAIOWorkers is the maximum number of requests of an AIOContext that are
+// performed concurrently. Further requests are queued until a worker is free.
+const maxAIOWorkers = 64
+
+// aioQueue holds the requests of an AIOContext that have been submitted but
+// not yet started by a worker.
+type aioQueue struct {
+	pending []func()
+	workers int
+}
+
+// aioQueues maps each AIOContext with running workers to its aioQueue.
+var aioQueues = struct {
+	mu sync.Mutex
+	m  map[*mm.AIOContext]*aioQueue
+}{
+	m: make(map[*mm.AIOContext]*aioQueue),
+}
+
+// queueCallback queues fn to be performed by one of up to maxAIOWorkers
+// workers of ctx, so that requests submitted together are performed in
+// parallel without starting a goroutine for each of them.
+func queueCallback(ctx *mm.AIOContext, fn func()) {
+	aioQueues.mu.Lock()
+	q := aioQueues.m[ctx]
+	if q == nil {
+		q = &aioQueue{}
+		aioQueues.m[ctx] = q
+	}
+	q.pending = append(q.pending, fn)
+	if q.workers >= maxAIOWorkers {
+		aioQueues.mu.Unlock()
+		return
+	}
+	q.workers++
+	aioQueues.mu.Unlock()
+
+	fs.Async(func() { runCallbacks(ctx, q) })
+}
+
+// runCallbacks is the body of a worker of ctx. It performs requests from q
+// until q is empty.
+func runCallbacks(ctx *mm.AIOContext, q *aioQueue) {
+	for {
+		aioQueues.mu.Lock()
+		if len(q.pending) == 0 {
+			q.workers--
+			if q.workers == 0 {
+				delete(aioQueues.m, ctx)
+			}
+			aioQueues.mu.Unlock()
+			return
+		}
+		fn := q.pending[0]
+		q.pending[0] = nil
+		q.pending = q.pending[1:]
+		aioQueues.mu.Unlock()
+
+		fn()
+	}
+}
+
 // submitCallback processes a single callback.
 func submitCallback(t *kernel.Task, id uint64, cb *ioCallback, cbAddr usermem.Addr) error {
 	file := t.GetFile(cb.FD)
@@ -366,7 +429,7 @@ func submitCallback(t *kernel.Task, id uint64, cb *ioCallback, cbAddr usermem.Ad
 
 	// Perform the request asynchronously.
 	file.IncRef()
-	fs.Async(func() { performCallback(t, file, cbAddr, cb, ioseq, ctx, eventFile) })
+	queueCallback(ctx, func() { performCallback(t, file, cbAddr, cb, ioseq, ctx, eventFile) })
 
 	// All set.
 	return nil
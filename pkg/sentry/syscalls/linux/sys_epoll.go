@@ -83,6 +83,13 @@ func EpollCtl(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysc
 			flags |= epoll.EdgeTriggered
 		}
 
+		if e.Events&linux.EPOLLEXCLUSIVE != 0 {
+			if e.Events&^linux.EPOLLEXCLUSIVE_OK_BITS != 0 {
+				return 0, nil, syserror.EINVAL
+			}
+			flags |= epoll.Exclusive
+		}
+
 		mask = waiter.EventMaskFromLinux(e.Events)
 		data = e.Data
 	}
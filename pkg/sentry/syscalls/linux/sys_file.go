@@ -15,6 +15,7 @@
 package linux
 
 import (
+	"math"
 	"syscall"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
@@ -460,10 +461,73 @@ func createAt(t *kernel.Task, dirFD int32, addr usermem.Addr, flags uint, mode l
 	return fd, err // Use result in frame.
 }
 
+// tmpfileAt implements open(O_TMPFILE): it creates an unnamed regular file in
+// the directory at dirFD and addr.
+func tmpfileAt(t *kernel.Task, dirFD int32, addr usermem.Addr, flags uint, mode linux.FileMode) (fd uintptr, err error) {
+	// Linux's __O_TMPFILE (which we call linux.O_TMPFILE) must be specified
+	// with O_DIRECTORY and a writable access mode, so that it fails on kernels
+	// that don't support it, and can't be combined with O_CREAT.
+	if flags&linux.O_DIRECTORY == 0 || flags&linux.O_CREAT != 0 || flags&linux.O_ACCMODE == linux.O_RDONLY {
+		return 0, syserror.EINVAL
+	}
+
+	path, _, err := copyInPath(t, addr, false /* allowEmpty */)
+	if err != nil {
+		return 0, err
+	}
+
+	resolve := flags&linux.O_NOFOLLOW == 0
+	err = fileOpOn(t, dirFD, path, resolve, func(root *fs.Dirent, d *fs.Dirent, _ uint) error {
+		if !fs.IsDir(d.Inode.StableAttr) {
+			return syserror.ENOTDIR
+		}
+
+		// Creating the file requires the same permissions as creating a
+		// named file in the directory.
+		if err := d.Inode.CheckPermission(t, fs.PermMask{Write: true, Execute: true}); err != nil {
+			return err
+		}
+
+		// "EOPNOTSUPP: The filesystem containing pathname does not support
+		// O_TMPFILE." - open(2)
+		tc, ok := d.Inode.InodeOperations.(fs.TmpfileCreator)
+		if !ok {
+			return syserror.EOPNOTSUPP
+		}
+
+		fileFlags := linuxToFlags(flags)
+		// O_DIRECTORY applied to the directory, not the new file.
+		fileFlags.Directory = false
+		// Linux always adds the O_LARGEFILE flag when running in 64-bit mode.
+		fileFlags.LargeFile = true
+		perms := fs.FilePermsFromMode(mode &^ linux.FileMode(t.FSContext().Umask()))
+		file, err := tc.CreateTmpfile(t, d.Inode, fileFlags, perms, flags&linux.O_EXCL == 0 /* linkable */)
+		if err != nil {
+			return syserror.ConvertIntr(err, kernel.ERESTARTSYS)
+		}
+		defer file.DecRef()
+
+		newFD, err := t.NewFDFrom(0, file, kernel.FDFlags{
+			CloseOnExec: flags&linux.O_CLOEXEC != 0,
+		})
+		if err != nil {
+			return err
+		}
+		fd = uintptr(newFD)
+		return nil
+	})
+	return fd, err // Use result in frame.
+}
+
 // Open implements linux syscall open(2).
 func Open(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	addr := args[0].Pointer()
 	flags := uint(args[1].Uint())
+	if flags&linux.O_TMPFILE != 0 {
+		mode := linux.FileMode(args[2].ModeT())
+		n, err := tmpfileAt(t, linux.AT_FDCWD, addr, flags, mode)
+		return n, nil, err
+	}
 	if flags&linux.O_CREAT != 0 {
 		mode := linux.FileMode(args[2].ModeT())
 		n, err := createAt(t, linux.AT_FDCWD, addr, flags, mode)
@@ -478,6 +542,11 @@ func Openat(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscal
 	dirFD := args[0].Int()
 	addr := args[1].Pointer()
 	flags := uint(args[2].Uint())
+	if flags&linux.O_TMPFILE != 0 {
+		mode := linux.FileMode(args[3].ModeT())
+		n, err := tmpfileAt(t, dirFD, addr, flags, mode)
+		return n, nil, err
+	}
 	if flags&linux.O_CREAT != 0 {
 		mode := linux.FileMode(args[3].ModeT())
 		n, err := createAt(t, dirFD, addr, flags, mode)
@@ -797,6 +866,43 @@ func Close(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscall
 	return 0, nil, handleIOError(t, false /* partial */, err, syserror.EINTR, "close", file)
 }
 
+// CloseRange implements linux syscall close_range(2).
+func CloseRange(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	first := args[0].Uint()
+	last := args[1].Uint()
+	flags := args[2].Uint()
+
+	if flags&^(linux.CLOSE_RANGE_UNSHARE|linux.CLOSE_RANGE_CLOEXEC) != 0 || first > last {
+		return 0, nil, syserror.EINVAL
+	}
+	if first > math.MaxInt32 {
+		// No such file descriptors can exist.
+		return 0, nil, nil
+	}
+	if last > math.MaxInt32 {
+		last = math.MaxInt32
+	}
+
+	if flags&linux.CLOSE_RANGE_UNSHARE != 0 {
+		if err := t.Unshare(&kernel.SharingOptions{NewFiles: true}); err != nil {
+			return 0, nil, err
+		}
+	}
+
+	if flags&linux.CLOSE_RANGE_CLOEXEC != 0 {
+		t.FDTable().SetFlagsRange(int32(first), int32(last), kernel.FDFlags{CloseOnExec: true})
+		return 0, nil, nil
+	}
+
+	// Like Linux, ignore errors from closing the removed files.
+	files, _ := t.FDTable().RemoveRange(int32(first), int32(last))
+	for _, file := range files {
+		file.Flush(t)
+		file.DecRef()
+	}
+	return 0, nil, nil
+}
+
 // Dup implements linux syscall dup(2).
 func Dup(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	fd := args[0].Int()
@@ -1129,6 +1235,7 @@ const (
 // This implementation currently ignores the provided advice.
 func Fadvise64(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	fd := args[0].Int()
+	offset := args[1].Int64()
 	length := args[2].Int64()
 	advice := args[3].Int()
 
@@ -1153,6 +1260,13 @@ func Fadvise64(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sys
 	case _FADV_RANDOM:
 	case _FADV_SEQUENTIAL:
 	case _FADV_WILLNEED:
+		// A length of 0 means to the end of the file.
+		if length == 0 {
+			length = math.MaxInt64
+		}
+		if ra, ok := file.FileOperations.(fs.Readaheader); ok && fs.IsRegular(file.Dirent.Inode.StableAttr) && offset >= 0 {
+			ra.Readahead(t, file, offset, length)
+		}
 	case _FADV_DONTNEED:
 	case _FADV_NOREUSE:
 	default:
@@ -2225,6 +2339,14 @@ func MemfdCreate(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.S
 	addr := args[0].Pointer()
 	flags := args[1].Uint()
 
+	hugetlb := flags&linux.MFD_HUGETLB != 0
+	if hugetlb {
+		// Only the default huge page size is supported.
+		if size := (flags >> linux.MFD_HUGE_SHIFT) & linux.MFD_HUGE_MASK; size != 0 && size != usermem.HugePageShift {
+			return 0, nil, syserror.EINVAL
+		}
+		flags &^= linux.MFD_HUGETLB | linux.MFD_HUGE_MASK<<linux.MFD_HUGE_SHIFT
+	}
 	if flags&^memfdAllFlags != 0 {
 		// Unknown bits in flags.
 		return 0, nil, syserror.EINVAL
@@ -2242,7 +2364,7 @@ func MemfdCreate(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.S
 	}
 	name = memfdPrefix + name
 
-	inode := tmpfs.NewMemfdInode(t, allowSeals)
+	inode := tmpfs.NewMemfdInode(t, allowSeals, hugetlb)
 	dirent := fs.NewDirent(t, inode, name)
 	// Per Linux, mm/shmem.c:__shmem_file_setup(), memfd files are set up with
 	// FMODE_READ | FMODE_WRITE.
@@ -63,6 +63,7 @@ func futexWaitAbsolute(t *kernel.Task, clockRealtime bool, ts linux.Timespec, fo
 	} else if clockRealtime {
 		notifier, tchan := ktime.NewChannelNotifier()
 		timer := ktime.NewTimer(t.Kernel().RealtimeClock(), notifier)
+		timer.SetSlack(t.TimerSlack())
 		timer.Swap(ktime.Setting{
 			Enabled: true,
 			Next:    ktime.FromTimespec(ts),
@@ -140,6 +141,7 @@ func futexLockPI(t *kernel.Task, ts linux.Timespec, forever bool, addr usermem.A
 	} else {
 		notifier, tchan := ktime.NewChannelNotifier()
 		timer := ktime.NewTimer(t.Kernel().RealtimeClock(), notifier)
+		timer.SetSlack(t.TimerSlack())
 		timer.Swap(ktime.Setting{
 			Enabled: true,
 			Next:    ktime.FromTimespec(ts),
@@ -16,6 +16,7 @@ package linux
 
 import (
 	"fmt"
+	"math/bits"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
@@ -24,12 +25,13 @@ import (
 	"gvisor.dev/gvisor/pkg/usermem"
 )
 
-// We unconditionally report a single NUMA node. This also means that our
-// "nodemask_t" is a single unsigned long (uint64).
-const (
-	maxNodes        = 1
-	allowedNodemask = (1 << maxNodes) - 1
-)
+// allowedNodemask returns the set of NUMA nodes reported to applications.
+// Unless the sandbox is configured to expose the host's NUMA nodes, this is a
+// single node. Either way, only nodes 0-63 are reported, so our "nodemask_t"
+// is a single unsigned long (uint64).
+func allowedNodemask(t *kernel.Task) uint64 {
+	return t.Kernel().MemoryFile().NUMANodes()
+}
 
 func copyInNodemask(t *kernel.Task, addr usermem.Addr, maxnode uint32) (uint64, error) {
 	// "nodemask points to a bit mask of node IDs that contains up to maxnode
@@ -56,7 +58,7 @@ func copyInNodemask(t *kernel.Task, addr usermem.Addr, maxnode uint32) (uint64,
 	val := usermem.ByteOrder.Uint64(buf)
 	// Check that only allowed bits in the first unsigned long in the nodemask
 	// are set.
-	if val&^allowedNodemask != 0 {
+	if val&^allowedNodemask(t) != 0 {
 		return 0, syserror.EINVAL
 	}
 	// Check that all remaining bits in the nodemask are 0.
@@ -117,7 +119,7 @@ func GetMempolicy(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.
 
 	// "EINVAL: The value specified by maxnode is less than the number of node
 	// IDs supported by the system." - get_mempolicy(2)
-	if nodemask != 0 && maxnode < maxNodes {
+	if nodemask != 0 && maxnode < uint32(bits.Len64(allowedNodemask(t))) {
 		return 0, nil, syserror.EINVAL
 	}
 
@@ -131,7 +133,7 @@ func GetMempolicy(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.
 		if nodeFlag || addrFlag {
 			return 0, nil, syserror.EINVAL
 		}
-		if err := copyOutNodemask(t, nodemask, maxnode, allowedNodemask); err != nil {
+		if err := copyOutNodemask(t, nodemask, maxnode, allowedNodemask(t)); err != nil {
 			return 0, nil, err
 		}
 		return 0, nil, nil
@@ -162,7 +164,9 @@ func GetMempolicy(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.
 			if err != nil {
 				return 0, nil, err
 			}
-			policy = linux.MPOL_DEFAULT // maxNodes == 1
+			// The nodes of individual pages aren't tracked, so report the
+			// first node that pages may be allocated on.
+			policy = linux.NumaPolicy(bits.TrailingZeros64(allowedNodemask(t)))
 		}
 		if mode != 0 {
 			if _, err := policy.CopyOut(t, mode); err != nil {
@@ -199,7 +203,8 @@ func GetMempolicy(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.
 		if policy&^linux.MPOL_MODE_FLAGS != linux.MPOL_INTERLEAVE {
 			return 0, nil, syserror.EINVAL
 		}
-		policy = linux.MPOL_DEFAULT // maxNodes == 1
+		// The host chooses interleaved nodes, so report the first one.
+		policy = linux.NumaPolicy(bits.TrailingZeros64(nodemaskVal))
 	}
 	if mode != 0 {
 		if _, err := policy.CopyOut(t, mode); err != nil {
@@ -252,8 +257,9 @@ func Mbind(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscall
 		return 0, nil, err
 	}
 
-	// Since we claim to have only a single node, all flags can be ignored
-	// (since all pages must already be on that single node).
+	// The policy applies to pages allocated after the call. Existing pages
+	// are never migrated, so MPOL_MF_MOVE and MPOL_MF_MOVE_ALL are ignored, as
+	// is MPOL_MF_STRICT.
 	err = t.MemoryManager().SetNumaPolicy(addr, length, mode, nodemaskVal)
 	return 0, nil, err
 }
@@ -15,8 +15,6 @@
 package linux
 
 import (
-	"bytes"
-
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
@@ -183,6 +181,8 @@ func Madvise(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysca
 	switch adv {
 	case linux.MADV_DONTNEED:
 		return 0, nil, t.MemoryManager().Decommit(addr, length)
+	case linux.MADV_FREE:
+		return 0, nil, t.MemoryManager().FreeLazily(addr, length)
 	case linux.MADV_DOFORK:
 		return 0, nil, t.MemoryManager().SetDontFork(addr, length, false)
 	case linux.MADV_DONTFORK:
@@ -195,6 +195,10 @@ func Madvise(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysca
 		// TODO(b/72045799): Core dumping isn't implemented, so these are
 		// no-ops.
 		fallthrough
+	case linux.MADV_COLD, linux.MADV_PAGEOUT:
+		// There is no swap to page out to, and memory reclaim isn't
+		// driven by page age, so these are no-ops.
+		fallthrough
 	case linux.MADV_NORMAL, linux.MADV_RANDOM, linux.MADV_SEQUENTIAL, linux.MADV_WILLNEED:
 		// Do nothing, we totally ignore the suggestions above.
 		return 0, nil, nil
@@ -211,6 +215,10 @@ func Madvise(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysca
 	}
 }
 
+// mincoreChunkPages is the maximum number of pages whose residency Mincore
+// computes at a time.
+const mincoreChunkPages = 64 << 10
+
 // Mincore implements the syscall mincore(2).
 func Mincore(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	addr := args[0].Pointer()
@@ -232,15 +240,32 @@ func Mincore(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysca
 		return 0, nil, syserror.ENOMEM
 	}
 
-	// Pretend that all mapped pages are "resident in core".
-	mapped := t.MemoryManager().VirtualMemorySizeRange(ar)
-	// "ENOMEM: addr to addr + length contained unmapped memory."
-	if mapped != uint64(la) {
-		return 0, nil, syserror.ENOMEM
+	// Compute and copy out residency a chunk at a time, so that mincore over a
+	// huge mapping doesn't need a buffer as large as its vector. As in Linux,
+	// if a later chunk fails, earlier chunks have already been copied out.
+	pages := ar.Length() / usermem.PageSize
+	chunkPages := pages
+	if chunkPages > mincoreChunkPages {
+		chunkPages = mincoreChunkPages
 	}
-	resident := bytes.Repeat([]byte{1}, int(mapped/usermem.PageSize))
-	_, err := t.CopyOut(vec, resident)
-	return 0, nil, err
+	resident := make([]byte, chunkPages)
+	for pages > 0 {
+		n := pages
+		if n > chunkPages {
+			n = chunkPages
+		}
+		car := usermem.AddrRange{ar.Start, ar.Start + usermem.Addr(n*usermem.PageSize)}
+		if err := t.MemoryManager().Mincore(car, resident[:n]); err != nil {
+			return 0, nil, err
+		}
+		if _, err := t.CopyOutBytes(vec, resident[:n]); err != nil {
+			return 0, nil, err
+		}
+		ar.Start = car.End
+		vec += usermem.Addr(n)
+		pages -= n
+	}
+	return 0, nil, nil
 }
 
 // Msync implements Linux syscall msync(2).
@@ -76,7 +76,7 @@ func Mount(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscall
 	// Silently allow MS_NOSUID, since we don't implement set-id bits
 	// anyway.
 	const unsupportedFlags = linux.MS_NODEV |
-		linux.MS_NODIRATIME | linux.MS_STRICTATIME
+		linux.MS_NODIRATIME
 
 	// Linux just allows passing any flags to mount(2) - it won't fail when
 	// unknown or unsupported flags are passed. Since we don't implement
@@ -97,6 +97,10 @@ func Mount(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscall
 	if flags&linux.MS_NOATIME == linux.MS_NOATIME {
 		superFlags.NoAtime = true
 	}
+	// MS_RELATIME is the default unless MS_STRICTATIME is given.
+	if flags&linux.MS_STRICTATIME == linux.MS_STRICTATIME {
+		superFlags.StrictAtime = true
+	}
 	if flags&linux.MS_RDONLY == linux.MS_RDONLY {
 		superFlags.ReadOnly = true
 	}
@@ -0,0 +1,143 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package linux
+
+import (
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/perfevent"
+	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
+)
+
+// NewPerfEvent returns the event requested by perf_event_open(2) with the
+// given arguments, and the flags for its file descriptor.
+func NewPerfEvent(t *kernel.Task, args arch.SyscallArguments) (*kernel.PerfEvent, kernel.FDFlags, error) {
+	attrAddr := args[0].Pointer()
+	pid := kernel.ThreadID(args[1].Int())
+	cpu := args[2].Int()
+	groupFD := args[3].Int()
+	flags := args[4].Uint()
+
+	if flags&^(linux.PERF_FLAG_FD_NO_GROUP|linux.PERF_FLAG_FD_CLOEXEC) != 0 {
+		return nil, kernel.FDFlags{}, syserror.EINVAL
+	}
+	switch {
+	case pid < 0 && cpu < 0:
+		return nil, kernel.FDFlags{}, syserror.EINVAL
+	case pid < 0:
+		// Events that count a whole CPU require privileges that are
+		// never granted to sandboxed applications.
+		return nil, kernel.FDFlags{}, syserror.EACCES
+	case cpu != -1:
+		// Tasks don't run on fixed CPUs, so only events that follow
+		// the task are supported.
+		return nil, kernel.FDFlags{}, syserror.EINVAL
+	}
+	// Event groups are not supported.
+	if groupFD != -1 {
+		return nil, kernel.FDFlags{}, syserror.EINVAL
+	}
+
+	attr, err := copyInPerfEventAttr(t, attrAddr)
+	if err != nil {
+		return nil, kernel.FDFlags{}, err
+	}
+
+	target := t
+	if pid != 0 {
+		target = t.PIDNamespace().TaskWithID(pid)
+		if target == nil {
+			return nil, kernel.FDFlags{}, syserror.ESRCH
+		}
+		if !t.CanTrace(target, false) {
+			return nil, kernel.FDFlags{}, syserror.EACCES
+		}
+	}
+
+	e, err := kernel.NewPerfEvent(t, target, attr)
+	if err != nil {
+		return nil, kernel.FDFlags{}, err
+	}
+	return e, kernel.FDFlags{
+		CloseOnExec: flags&linux.PERF_FLAG_FD_CLOEXEC != 0,
+	}, nil
+}
+
+// copyInPerfEventAttr copies in the struct perf_event_attr at addr, whose size
+// is given by its size field. Fields unknown to gVisor must be zero.
+func copyInPerfEventAttr(t *kernel.Task, addr usermem.Addr) (linux.PerfEventAttr, error) {
+	var attr linux.PerfEventAttr
+	var sizeBuf [4]byte
+	if _, err := t.CopyInBytes(addr+4, sizeBuf[:]); err != nil {
+		return attr, err
+	}
+	size := int(usermem.ByteOrder.Uint32(sizeBuf[:]))
+	if size == 0 {
+		size = linux.PERF_ATTR_SIZE_VER0
+	}
+	if size < linux.PERF_ATTR_SIZE_VER0 || size > usermem.PageSize {
+		return attr, e2bigPerfEventAttr(t, addr)
+	}
+
+	buf := make([]byte, size)
+	if _, err := t.CopyInBytes(addr, buf); err != nil {
+		return attr, err
+	}
+	if size > attr.SizeBytes() {
+		for _, b := range buf[attr.SizeBytes():] {
+			if b != 0 {
+				return attr, e2bigPerfEventAttr(t, addr)
+			}
+		}
+		buf = buf[:attr.SizeBytes()]
+	} else {
+		buf = append(buf, make([]byte, attr.SizeBytes()-size)...)
+	}
+	attr.UnmarshalBytes(buf)
+	attr.Size = uint32(size)
+	return attr, nil
+}
+
+// e2bigPerfEventAttr returns E2BIG after writing the size of the struct
+// perf_event_attr that gVisor supports to the size field of the one at addr,
+// as Linux does.
+func e2bigPerfEventAttr(t *kernel.Task, addr usermem.Addr) error {
+	var sizeBuf [4]byte
+	usermem.ByteOrder.PutUint32(sizeBuf[:], linux.PERF_ATTR_SIZE_VER5)
+	if _, err := t.CopyOutBytes(addr+4, sizeBuf[:]); err != nil {
+		return err
+	}
+	return syserror.E2BIG
+}
+
+// PerfEventOpen implements linux syscall perf_event_open(2).
+func PerfEventOpen(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	e, fdFlags, err := NewPerfEvent(t, args)
+	if err != nil {
+		return 0, nil, err
+	}
+
+	file := perfevent.New(t, e)
+	defer file.DecRef()
+
+	fd, err := t.NewFDFrom(0, file, fdFlags)
+	if err != nil {
+		return 0, nil, err
+	}
+
+	return uintptr(fd), nil, nil
+}
@@ -0,0 +1,61 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package linux
+
+import (
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/pidfd"
+	"gvisor.dev/gvisor/pkg/syserror"
+)
+
+// PidfdThreadGroup returns the thread group to which pidfd_open(pid, flags)
+// refers.
+func PidfdThreadGroup(t *kernel.Task, pid kernel.ThreadID, flags uint32) (*kernel.ThreadGroup, error) {
+	if flags != 0 || pid <= 0 {
+		return nil, syserror.EINVAL
+	}
+	target := t.PIDNamespace().TaskWithID(pid)
+	if target == nil {
+		return nil, syserror.ESRCH
+	}
+	// Only thread group leaders can be referred to by pidfds.
+	tg := target.ThreadGroup()
+	if tg.Leader() != target {
+		return nil, syserror.EINVAL
+	}
+	return tg, nil
+}
+
+// PidfdOpen implements linux syscall pidfd_open(2).
+func PidfdOpen(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	tg, err := PidfdThreadGroup(t, kernel.ThreadID(args[0].Int()), args[1].Uint())
+	if err != nil {
+		return 0, nil, err
+	}
+
+	file := pidfd.New(t, tg)
+	defer file.DecRef()
+
+	// pidfds are always close-on-exec.
+	fd, err := t.NewFDFrom(0, file, kernel.FDFlags{
+		CloseOnExec: true,
+	})
+	if err != nil {
+		return 0, nil, err
+	}
+
+	return uintptr(fd), nil, nil
+}
@@ -47,17 +47,16 @@ const (
 	selectExceptEvents = linux.POLLPRI
 )
 
-// pollState tracks the associated file descriptor and waiter of a PollFD.
+// pollState tracks the associated file descriptor of a PollFD.
 type pollState struct {
-	file   *fs.File
-	waiter waiter.Entry
+	file *fs.File
 }
 
 // initReadiness gets the current ready mask for the file represented by the FD
-// stored in pfd.FD. If a channel is passed in, the waiter entry in "state" is
-// used to register with the file for event notifications, and a reference to
-// the file is stored in "state".
-func initReadiness(t *kernel.Task, pfd *linux.PollFD, state *pollState, ch chan struct{}) {
+// stored in pfd.FD. If a PollCache is passed in, it is used to register with
+// the file for event notifications, and a reference to the file is stored in
+// "state".
+func initReadiness(t *kernel.Task, pfd *linux.PollFD, state *pollState, cache *kernel.PollCache) {
 	if pfd.FD < 0 {
 		pfd.REvents = 0
 		return
@@ -69,12 +68,11 @@ func initReadiness(t *kernel.Task, pfd *linux.PollFD, state *pollState, ch chan
 		return
 	}
 
-	if ch == nil {
+	if cache == nil {
 		defer file.DecRef()
 	} else {
 		state.file = file
-		state.waiter, _ = waiter.NewChannelEntry(ch)
-		file.EventRegister(&state.waiter, waiter.EventMaskFromLinux(uint32(pfd.Events)))
+		cache.Register(pfd.FD, file, waiter.EventMaskFromLinux(uint32(pfd.Events)))
 	}
 
 	r := file.Readiness(waiter.EventMaskFromLinux(uint32(pfd.Events)))
@@ -85,7 +83,6 @@ func initReadiness(t *kernel.Task, pfd *linux.PollFD, state *pollState, ch chan
 func releaseState(state []pollState) {
 	for i := range state {
 		if state[i].file != nil {
-			state[i].file.EventUnregister(&state[i].waiter)
 			state[i].file.DecRef()
 		}
 	}
@@ -97,23 +94,27 @@ func releaseState(state []pollState) {
 // pollBlock returns the remaining timeout, which is always 0 on a timeout; and 0 or
 // positive if interrupted by a signal.
 func pollBlock(t *kernel.Task, pfd []linux.PollFD, timeout time.Duration) (time.Duration, uintptr, error) {
+	state := make([]pollState, len(pfd))
+	defer releaseState(state)
+
+	// Register for event notification in the files involved if we may
+	// block (timeout not zero). Registrations are retained by the task's
+	// PollCache after the call, so that a task that polls the same files
+	// repeatedly only registers with them once. The cache must be done with
+	// the files before releaseState drops our references on them.
+	var cache *kernel.PollCache
 	var ch chan struct{}
 	if timeout != 0 {
-		ch = make(chan struct{}, 1)
+		cache = t.PollCache()
+		ch = cache.Begin()
+		defer cache.End()
 	}
 
-	// Register for event notification in the files involved if we may
-	// block (timeout not zero). Once we find a file that has a non-zero
-	// result, we stop registering for events but still go through all files
-	// to get their ready masks.
-	state := make([]pollState, len(pfd))
-	defer releaseState(state)
 	n := uintptr(0)
 	for i := range pfd {
-		initReadiness(t, &pfd[i], &state[i], ch)
+		initReadiness(t, &pfd[i], &state[i], cache)
 		if pfd[i].REvents != 0 {
 			n++
-			ch = nil
 		}
 	}
 
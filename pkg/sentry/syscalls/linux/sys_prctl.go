@@ -16,6 +16,8 @@ package linux
 
 import (
 	"fmt"
+	"math"
+	"time"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
@@ -200,14 +202,23 @@ func Prctl(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscall
 		}
 		return 0, nil, t.DropBoundingCapability(cp)
 
+	case linux.PR_SET_TIMERSLACK:
+		// An argument of 0 resets the slack to its default.
+		slack := time.Duration(math.MaxInt64)
+		if ns := args[1].Uint64(); ns < math.MaxInt64 {
+			slack = time.Duration(ns)
+		}
+		t.SetTimerSlack(slack)
+
+	case linux.PR_GET_TIMERSLACK:
+		return uintptr(t.TimerSlack().Nanoseconds()), nil, nil
+
 	case linux.PR_GET_TIMING,
 		linux.PR_SET_TIMING,
 		linux.PR_GET_TSC,
 		linux.PR_SET_TSC,
 		linux.PR_TASK_PERF_EVENTS_DISABLE,
 		linux.PR_TASK_PERF_EVENTS_ENABLE,
-		linux.PR_GET_TIMERSLACK,
-		linux.PR_SET_TIMERSLACK,
 		linux.PR_MCE_KILL,
 		linux.PR_MCE_KILL_GET,
 		linux.PR_GET_TID_ADDRESS,
@@ -0,0 +1,169 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package linux
+
+import (
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/safemem"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/mm"
+	"gvisor.dev/gvisor/pkg/sentry/platform"
+	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
+)
+
+// processVMChunkSize is the maximum number of bytes of the remote address
+// space that process_vm_readv(2) and process_vm_writev(2) pin at a time.
+const processVMChunkSize = 2 << 20
+
+// ProcessVMReadv implements linux syscall process_vm_readv(2).
+func ProcessVMReadv(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	return processVMRW(t, args, false /* write */)
+}
+
+// ProcessVMWritev implements linux syscall process_vm_writev(2).
+func ProcessVMWritev(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	return processVMRW(t, args, true /* write */)
+}
+
+func processVMRW(t *kernel.Task, args arch.SyscallArguments, write bool) (uintptr, *kernel.SyscallControl, error) {
+	pid := kernel.ThreadID(args[0].Int())
+	lvec := args[1].Pointer()
+	liovcnt := args[2].Uint64()
+	rvec := args[3].Pointer()
+	riovcnt := args[4].Uint64()
+	flags := args[5].Uint64()
+
+	if flags != 0 {
+		return 0, nil, syserror.EINVAL
+	}
+	if liovcnt > linux.UIO_MAXIOV || riovcnt > linux.UIO_MAXIOV {
+		return 0, nil, syserror.EINVAL
+	}
+	local, err := t.IovecsIOSequence(lvec, int(liovcnt), usermem.IOOpts{
+		AddressSpaceActive: true,
+	})
+	if err != nil {
+		return 0, nil, err
+	}
+	remote, err := t.CopyInIovecs(rvec, int(riovcnt))
+	if err != nil {
+		return 0, nil, err
+	}
+
+	target := t.PIDNamespace().TaskWithID(pid)
+	if target == nil {
+		return 0, nil, syserror.ESRCH
+	}
+	// "Permission to read from or write to another process is governed by a
+	// ptrace access mode PTRACE_MODE_ATTACH_REALCREDS check" -
+	// process_vm_readv(2)
+	if !t.CanTrace(target, true /* attach */) {
+		return 0, nil, syserror.EPERM
+	}
+	var tmm *mm.MemoryManager
+	target.WithMuLocked(func(target *kernel.Task) {
+		tmm = target.MemoryManager()
+	})
+	if tmm == nil || !tmm.IncUsers() {
+		return 0, nil, syserror.ESRCH
+	}
+	defer tmm.DecUsers(t)
+
+	// Linux returns the number of bytes transferred before the first failure,
+	// or the failure if nothing was transferred.
+	n, err := processVMCopy(t, local, remote, tmm, write)
+	if n != 0 {
+		return uintptr(n), nil, nil
+	}
+	return 0, nil, err
+}
+
+// processVMCopy copies between local and remote in tmm, in the direction given
+// by write, until either is exhausted or an error occurs, and returns the
+// number of bytes copied.
+//
+// Rather than copying through both MemoryManagers at once, which would
+// require locking one while holding the other's locks, processVMCopy pins
+// chunks of remote and copies between local and their internal mappings, as
+// Linux's mm/process_vm_access.c does using get_user_pages().
+func processVMCopy(t *kernel.Task, local usermem.IOSequence, remote usermem.AddrRangeSeq, tmm *mm.MemoryManager, write bool) (int64, error) {
+	at := usermem.Read
+	if write {
+		at = usermem.Write
+	}
+	var done int64
+	for ; !remote.IsEmpty(); remote = remote.Tail() {
+		ar := remote.Head()
+		for ar.Length() != 0 {
+			if local.NumBytes() == 0 {
+				return done, nil
+			}
+			start := ar.Start.RoundDown()
+			end := ar.End
+			if end-start > processVMChunkSize {
+				end = start + processVMChunkSize
+			}
+			pinEnd, _ := end.RoundUp()
+			prs, perr := tmm.Pin(t, usermem.AddrRange{start, pinEnd}, at, false /* ignorePermissions */)
+			bs, merr := pinnedBlocks(prs, usermem.AddrRange{ar.Start, end}, at)
+			var n int64
+			var cerr error
+			if write {
+				n, cerr = local.CopyInTo(t, &safemem.BlockSeqWriter{bs})
+			} else {
+				n, cerr = local.CopyOutFrom(t, &safemem.BlockSeqReader{bs})
+			}
+			mm.Unpin(prs)
+			done += n
+			local = local.DropFirst64(n)
+			ar.Start += usermem.Addr(n)
+			if cerr != nil {
+				return done, cerr
+			}
+			if merr != nil {
+				return done, merr
+			}
+			if perr != nil {
+				return done, perr
+			}
+		}
+	}
+	return done, nil
+}
+
+// pinnedBlocks returns internal mappings of the addresses in ar, which must be
+// a subset of the addresses pinned by prs, for accesses of type at. If not all
+// pinned addresses can be mapped, it returns the mappings that precede the
+// failure along with a non-nil error.
+func pinnedBlocks(prs []mm.PinnedRange, ar usermem.AddrRange, at usermem.AccessType) (safemem.BlockSeq, error) {
+	var blocks []safemem.Block
+	for _, pr := range prs {
+		sar := pr.Source.Intersect(ar)
+		if sar.Length() == 0 {
+			continue
+		}
+		off := pr.Offset + uint64(sar.Start-pr.Source.Start)
+		ims, err := pr.File.MapInternal(platform.FileRange{off, off + uint64(sar.Length())}, at)
+		if err != nil {
+			return safemem.BlockSeqFromSlice(blocks), err
+		}
+		for ; !ims.IsEmpty(); ims = ims.Tail() {
+			blocks = append(blocks, ims.Head())
+		}
+	}
+	return safemem.BlockSeqFromSlice(blocks), nil
+}
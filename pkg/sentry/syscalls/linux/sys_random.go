@@ -18,7 +18,6 @@ import (
 	"io"
 	"math"
 
-	"gvisor.dev/gvisor/pkg/rand"
 	"gvisor.dev/gvisor/pkg/safemem"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
@@ -64,7 +63,7 @@ func GetRandom(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sys
 	if min > 256 {
 		min = 256
 	}
-	n, err := t.MemoryManager().CopyOutFrom(t, usermem.AddrRangeSeqOf(ar), safemem.FromIOReader{&randReader{-1, min}}, usermem.IOOpts{
+	n, err := t.MemoryManager().CopyOutFrom(t, usermem.AddrRangeSeqOf(ar), safemem.FromIOReader{&randReader{t.RandomReader(), -1, min}}, usermem.IOOpts{
 		AddressSpaceActive: true,
 	})
 	if n >= int64(min) {
@@ -73,8 +72,10 @@ func GetRandom(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sys
 	return 0, nil, err
 }
 
-// randReader is a io.Reader that handles partial reads from rand.Reader.
+// randReader is a io.Reader that handles partial reads from src, which is
+// rand.Reader or a Task.RandomReader.
 type randReader struct {
+	src  io.Reader
 	done int
 	min  int
 }
@@ -82,11 +83,11 @@ type randReader struct {
 // Read implements io.Reader.Read.
 func (r *randReader) Read(dst []byte) (int, error) {
 	if r.done >= r.min {
-		return rand.Reader.Read(dst)
+		return r.src.Read(dst)
 	}
 	min := r.min - r.done
 	if min > len(dst) {
 		min = len(dst)
 	}
-	return io.ReadAtLeast(rand.Reader, dst, min)
+	return io.ReadAtLeast(r.src, dst, min)
 }
@@ -101,10 +101,14 @@ func Readahead(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sys
 		return 0, nil, syserror.EINVAL
 	}
 
-	// Return EINVAL; if the underlying file type does not support readahead,
-	// then Linux will return EINVAL to indicate as much. In the future, we
-	// may extend this function to actually support readahead hints.
-	return 0, nil, syserror.EINVAL
+	// If the underlying file type does not support readahead, then Linux
+	// returns EINVAL to indicate as much.
+	ra, ok := file.FileOperations.(fs.Readaheader)
+	if !ok || !fs.IsRegular(file.Dirent.Inode.StableAttr) {
+		return 0, nil, syserror.EINVAL
+	}
+	ra.Readahead(t, file, offset, int64(size))
+	return 0, nil, nil
 }
 
 // Pread64 implements linux syscall pread64(2).
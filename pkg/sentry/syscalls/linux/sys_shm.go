@@ -20,6 +20,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/shm"
 	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
 )
 
 // Shmget implements shmget(2).
@@ -31,11 +32,19 @@ func Shmget(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscal
 	private := key == linux.IPC_PRIVATE
 	create := flag&linux.IPC_CREAT == linux.IPC_CREAT
 	exclusive := flag&linux.IPC_EXCL == linux.IPC_EXCL
+	hugetlb := flag&linux.SHM_HUGETLB == linux.SHM_HUGETLB
 	mode := linux.FileMode(flag & 0777)
 
+	if hugetlb {
+		// Only the default huge page size is supported.
+		if size := (flag >> linux.SHM_HUGE_SHIFT) & linux.SHM_HUGE_MASK; size != 0 && size != usermem.HugePageShift {
+			return 0, nil, syserror.EINVAL
+		}
+	}
+
 	pid := int32(t.ThreadGroup().ID())
 	r := t.IPCNamespace().ShmRegistry()
-	segment, err := r.FindOrCreate(t, pid, key, size, mode, private, create, exclusive)
+	segment, err := r.FindOrCreate(t, pid, key, size, mode, private, create, exclusive, hugetlb)
 	if err != nil {
 		return 0, nil, err
 	}
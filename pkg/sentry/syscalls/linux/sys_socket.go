@@ -667,10 +667,14 @@ func RecvMMsg(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysc
 	}
 
 	// Reject flags that we don't handle yet.
-	if flags & ^(baseRecvFlags|linux.MSG_CMSG_CLOEXEC|linux.MSG_ERRQUEUE) != 0 {
+	if flags & ^(baseRecvFlags|linux.MSG_CMSG_CLOEXEC|linux.MSG_ERRQUEUE|linux.MSG_WAITFORONE) != 0 {
 		return 0, nil, syserror.EINVAL
 	}
 
+	// MSG_WAITFORONE turns on MSG_DONTWAIT after the first message.
+	waitForOne := flags&linux.MSG_WAITFORONE != 0
+	flags &^= linux.MSG_WAITFORONE
+
 	// Get socket from the file descriptor.
 	file := t.GetFile(fd)
 	if file == nil {
@@ -711,6 +715,13 @@ func RecvMMsg(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysc
 		}
 	}
 
+	if count, batched, err := recvMMsgBatch(t, s, msgPtr, vlen, flags, waitForOne, haveDeadline, deadline); batched {
+		if count == 0 {
+			return 0, nil, err
+		}
+		return uintptr(count), nil, nil
+	}
+
 	var count uint32
 	var err error
 	for i := uint64(0); i < uint64(vlen); i++ {
@@ -732,6 +743,9 @@ func RecvMMsg(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysc
 			break
 		}
 		count++
+		if waitForOne {
+			flags |= linux.MSG_DONTWAIT
+		}
 	}
 
 	if count == 0 {
@@ -829,6 +843,113 @@ func recvSingleMsg(t *kernel.Task, s socket.Socket, msgPtr usermem.Addr, flags i
 	return uintptr(n), nil
 }
 
+// batchHeaders copies in the message headers of sendmmsg(2) or recvmmsg(2)
+// for socket.BatchSocket. It returns the headers and their addresses, which
+// are cut short at the first header that can't be copied in. batched is false
+// if the messages must be handled one at a time: s is not a datagram
+// socket.BatchSocket, there is only one message, or a message has control data.
+func batchHeaders(t *kernel.Task, s socket.Socket, msgPtr usermem.Addr, vlen uint32) (bs socket.BatchSocket, hdrs []MessageHeader64, ptrs []usermem.Addr, batched bool, err error) {
+	bs, ok := s.(socket.BatchSocket)
+	if !ok || vlen <= 1 {
+		return nil, nil, nil, false, nil
+	}
+	if _, stype, _ := s.Type(); stype != linux.SOCK_DGRAM {
+		return nil, nil, nil, false, nil
+	}
+	if vlen > linux.UIO_MAXIOV {
+		vlen = linux.UIO_MAXIOV
+	}
+
+	hdrs = make([]MessageHeader64, 0, vlen)
+	ptrs = make([]usermem.Addr, 0, vlen)
+	for i := uint64(0); i < uint64(vlen); i++ {
+		mp, ok := msgPtr.AddLength(i * multipleMessageHeader64Len)
+		if !ok {
+			return bs, hdrs, ptrs, true, syserror.EFAULT
+		}
+		var msg MessageHeader64
+		if err := CopyInMessageHeader64(t, mp, &msg); err != nil {
+			return bs, hdrs, ptrs, true, err
+		}
+		if msg.ControlLen != 0 {
+			return nil, nil, nil, false, nil
+		}
+		hdrs = append(hdrs, msg)
+		ptrs = append(ptrs, mp)
+	}
+	return bs, hdrs, ptrs, true, nil
+}
+
+// recvMMsgBatch implements recvmmsg(2) for messages without control data on a
+// socket.BatchSocket, receiving several datagrams per call to RecvMsgs. If
+// batched is false, nothing was received and the messages must be received
+// with recvSingleMsg.
+func recvMMsgBatch(t *kernel.Task, s socket.Socket, msgPtr usermem.Addr, vlen uint32, flags int32, waitForOne bool, haveDeadline bool, deadline ktime.Time) (count uint32, batched bool, err error) {
+	// FIXME(b/63594852): recvSingleMsg pretends we have an empty error queue.
+	if flags&linux.MSG_ERRQUEUE != 0 {
+		return 0, false, nil
+	}
+	bs, hdrs, ptrs, batched, err := batchHeaders(t, s, msgPtr, vlen)
+	if !batched || len(hdrs) == 0 {
+		return 0, batched, err
+	}
+
+	msgs := make([]socket.BatchMessage, len(hdrs))
+	for i, msg := range hdrs {
+		if msg.IovLen > linux.UIO_MAXIOV {
+			err = syserror.EMSGSIZE
+			msgs = msgs[:i]
+			break
+		}
+		dst, e := t.IovecsIOSequence(usermem.Addr(msg.Iov), int(msg.IovLen), usermem.IOOpts{
+			AddressSpaceActive: true,
+		})
+		if e != nil {
+			err = e
+			msgs = msgs[:i]
+			break
+		}
+		msgs[i] = socket.BatchMessage{
+			Data:            dst,
+			SenderRequested: msg.NameLen != 0,
+		}
+	}
+
+	// MSG_CMSG_CLOEXEC has no effect without control data.
+	flags &^= linux.MSG_CMSG_CLOEXEC
+	received := 0
+	for received < len(msgs) {
+		n, e := bs.RecvMsgs(t, msgs[received:], int(flags), haveDeadline, deadline)
+		if e != nil {
+			err = syserror.ConvertIntr(e.ToError(), kernel.ERESTARTSYS)
+			break
+		}
+		received += n
+		if waitForOne {
+			flags |= linux.MSG_DONTWAIT
+		}
+	}
+
+	for i := 0; i < received; i++ {
+		msg, mp := &msgs[i], ptrs[i]
+		if hdrs[i].NameLen != 0 {
+			if err := writeAddress(t, msg.Sender, msg.SenderLen, usermem.Addr(hdrs[i].Name), mp+nameLenOffset); err != nil {
+				return count, true, err
+			}
+		}
+		if int(hdrs[i].Flags) != msg.Flags {
+			if _, err := t.CopyOut(mp+flagsOffset, int32(msg.Flags)); err != nil {
+				return count, true, err
+			}
+		}
+		if _, err := t.CopyOut(mp+usermem.Addr(messageHeader64Len), uint32(msg.N)); err != nil {
+			return count, true, err
+		}
+		count++
+	}
+	return count, true, err
+}
+
 // recvFrom is the implementation of the recvfrom syscall. It is called by
 // recvfrom and recv syscall handlers.
 func recvFrom(t *kernel.Task, fd int32, bufPtr usermem.Addr, bufLen uint64, flags int32, namePtr usermem.Addr, nameLenPtr usermem.Addr) (uintptr, error) {
@@ -974,6 +1095,13 @@ func SendMMsg(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysc
 		flags |= linux.MSG_DONTWAIT
 	}
 
+	if count, batched, err := sendMMsgBatch(t, s, file, msgPtr, vlen, flags); batched {
+		if count == 0 {
+			return 0, nil, err
+		}
+		return uintptr(count), nil, nil
+	}
+
 	var count uint32
 	var err error
 	for i := uint64(0); i < uint64(vlen); i++ {
@@ -1066,6 +1194,72 @@ func sendSingleMsg(t *kernel.Task, s socket.Socket, file *fs.File, msgPtr userme
 	return uintptr(n), err
 }
 
+// sendMMsgBatch implements sendmmsg(2) for messages without control data on a
+// socket.BatchSocket, sending several datagrams per call to SendMsgs. If
+// batched is false, nothing was sent and the messages must be sent with
+// sendSingleMsg.
+func sendMMsgBatch(t *kernel.Task, s socket.Socket, file *fs.File, msgPtr usermem.Addr, vlen uint32, flags int32) (count uint32, batched bool, err error) {
+	bs, hdrs, ptrs, batched, err := batchHeaders(t, s, msgPtr, vlen)
+	if !batched || len(hdrs) == 0 {
+		return 0, batched, err
+	}
+
+	msgs := make([]socket.BatchMessage, len(hdrs))
+	for i, msg := range hdrs {
+		var to []byte
+		if msg.NameLen != 0 {
+			if to, err = CaptureAddress(t, usermem.Addr(msg.Name), msg.NameLen); err != nil {
+				msgs = msgs[:i]
+				break
+			}
+		}
+		if msg.IovLen > linux.UIO_MAXIOV {
+			err = syserror.EMSGSIZE
+			msgs = msgs[:i]
+			break
+		}
+		src, e := t.IovecsIOSequence(usermem.Addr(msg.Iov), int(msg.IovLen), usermem.IOOpts{
+			AddressSpaceActive: true,
+		})
+		if e != nil {
+			err = e
+			msgs = msgs[:i]
+			break
+		}
+		msgs[i] = socket.BatchMessage{
+			Data: src,
+			To:   to,
+		}
+	}
+
+	var haveDeadline bool
+	var deadline ktime.Time
+	if dl := s.SendTimeout(); dl > 0 {
+		deadline = t.Kernel().MonotonicClock().Now().Add(time.Duration(dl) * time.Nanosecond)
+		haveDeadline = true
+	} else if dl < 0 {
+		flags |= linux.MSG_DONTWAIT
+	}
+
+	sent := 0
+	for sent < len(msgs) {
+		n, e := bs.SendMsgs(t, msgs[sent:], int(flags), haveDeadline, deadline)
+		if e != nil {
+			err = handleIOError(t, false, e.ToError(), kernel.ERESTARTSYS, "sendmmsg", file)
+			break
+		}
+		sent += n
+	}
+
+	for i := 0; i < sent; i++ {
+		if _, err := t.CopyOut(ptrs[i]+usermem.Addr(messageHeader64Len), uint32(msgs[i].N)); err != nil {
+			return count, true, err
+		}
+		count++
+	}
+	return count, true, err
+}
+
 // sendTo is the implementation of the sendto syscall. It is called by sendto
 // and send syscall handlers.
 func sendTo(t *kernel.Task, fd int32, bufPtr usermem.Addr, bufLen uint64, flags int32, namePtr usermem.Addr, nameLen uint32) (uintptr, error) {
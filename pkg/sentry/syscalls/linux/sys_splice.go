@@ -20,6 +20,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/fs"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
 	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
 	"gvisor.dev/gvisor/pkg/waiter"
 )
 
@@ -173,6 +174,120 @@ func Sendfile(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Sysc
 	return uintptr(n), nil, handleIOError(t, false, err, kernel.ERESTARTSYS, "sendfile", inFile)
 }
 
+// CopyFileRange implements linux system call copy_file_range(2).
+func CopyFileRange(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	inFD := args[0].Int()
+	inOffsetAddr := args[1].Pointer()
+	outFD := args[2].Int()
+	outOffsetAddr := args[3].Pointer()
+	length := args[4].SizeT()
+	flags := args[5].Uint()
+
+	// As in Linux, cap the length so that the range checks below can't
+	// overflow.
+	if length > uint(kernel.MAX_RW_COUNT) {
+		length = uint(kernel.MAX_RW_COUNT)
+	}
+	count := int64(length)
+
+	// "flags: This argument is provided to allow for future extensions and
+	// currently must be set to 0." - copy_file_range(2)
+	if flags != 0 {
+		return 0, nil, syserror.EINVAL
+	}
+
+	// Get files.
+	inFile := t.GetFile(inFD)
+	if inFile == nil {
+		return 0, nil, syserror.EBADF
+	}
+	defer inFile.DecRef()
+
+	if !inFile.Flags().Read {
+		return 0, nil, syserror.EBADF
+	}
+
+	outFile := t.GetFile(outFD)
+	if outFile == nil {
+		return 0, nil, syserror.EBADF
+	}
+	defer outFile.DecRef()
+
+	// "EBADF: fd_out is not open for writing; or fd_out refers to a file
+	// opened with O_APPEND."
+	if !outFile.Flags().Write || outFile.Flags().Append {
+		return 0, nil, syserror.EBADF
+	}
+
+	// Both files must be regular files. See Linux's
+	// fs/read_write.c:generic_copy_file_checks().
+	inFileAttr := inFile.Dirent.Inode.StableAttr
+	outFileAttr := outFile.Dirent.Inode.StableAttr
+	if fs.IsDir(inFileAttr) || fs.IsDir(outFileAttr) {
+		return 0, nil, syserror.EISDIR
+	}
+	if !fs.IsRegular(inFileAttr) || !fs.IsRegular(outFileAttr) {
+		return 0, nil, syserror.EINVAL
+	}
+
+	opts := fs.SpliceOpts{
+		Length: count,
+	}
+	inOffset := inFile.Offset()
+	if inOffsetAddr != 0 {
+		if _, err := t.CopyIn(inOffsetAddr, &inOffset); err != nil {
+			return 0, nil, err
+		}
+		opts.SrcOffset = true
+		opts.SrcStart = inOffset
+	}
+	outOffset := outFile.Offset()
+	if outOffsetAddr != 0 {
+		if _, err := t.CopyIn(outOffsetAddr, &outOffset); err != nil {
+			return 0, nil, err
+		}
+		opts.DstOffset = true
+		opts.DstStart = outOffset
+	}
+	if inOffset < 0 || outOffset < 0 {
+		return 0, nil, syserror.EINVAL
+	}
+
+	// "EINVAL: fd_in and fd_out refer to the same file and the source and
+	// target ranges overlap."
+	if inFile.Dirent.Inode == outFile.Dirent.Inode && inOffset < outOffset+count && outOffset < inOffset+count {
+		return 0, nil, syserror.EINVAL
+	}
+
+	if count == 0 {
+		return 0, nil, nil
+	}
+
+	// Between host-backed files, fs.Splice offloads the copy to the host.
+	n, err := doSplice(t, outFile, inFile, opts, false /* nonBlocking */)
+
+	// Copy out the new offsets.
+	if inOffsetAddr != 0 {
+		if _, err := t.CopyOut(inOffsetAddr, inOffset+n); err != nil {
+			return 0, nil, err
+		}
+	}
+	if outOffsetAddr != 0 {
+		if _, err := t.CopyOut(outOffsetAddr, outOffset+n); err != nil {
+			return 0, nil, err
+		}
+	}
+
+	// copy_file_range only operates on regular files, so it can't lose
+	// any data.
+	if n != 0 {
+		err = nil
+	}
+
+	// See above; inFile is chosen arbitrarily here.
+	return uintptr(n), nil, handleIOError(t, false, err, kernel.ERESTARTSYS, "copy_file_range", inFile)
+}
+
 // Splice implements splice(2).
 func Splice(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	inFD := args[0].Int()
@@ -335,3 +450,88 @@ func Tee(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallCo
 	// See above; inFile is chosen arbitrarily here.
 	return uintptr(n), nil, handleIOError(t, false, err, kernel.ERESTARTSYS, "tee", inFile)
 }
+
+// Vmsplice implements vmsplice(2).
+//
+// Pipe buffers never reference application memory, so data is always copied
+// between the pipe and the iovecs, and SPLICE_F_GIFT has no effect.
+func Vmsplice(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	fd := args[0].Int()
+	addr := args[1].Pointer()
+	iovcnt := int(args[2].Int())
+	flags := args[3].Int()
+
+	// Check for invalid flags.
+	if flags&^(linux.SPLICE_F_MOVE|linux.SPLICE_F_NONBLOCK|linux.SPLICE_F_MORE|linux.SPLICE_F_GIFT) != 0 {
+		return 0, nil, syserror.EINVAL
+	}
+
+	// Get file.
+	file := t.GetFile(fd)
+	if file == nil {
+		return 0, nil, syserror.EBADF
+	}
+	defer file.DecRef()
+
+	// The file must be a pipe.
+	if !fs.IsPipe(file.Dirent.Inode.StableAttr) {
+		return 0, nil, syserror.EBADF
+	}
+
+	// The operation is non-blocking if anything is non-blocking, as for
+	// splice(2).
+	nonBlock := file.Flags().NonBlocking || (flags&linux.SPLICE_F_NONBLOCK != 0)
+
+	iovs, err := t.IovecsIOSequence(addr, iovcnt, usermem.IOOpts{
+		AddressSpaceActive: true,
+	})
+	if err != nil {
+		return 0, nil, err
+	}
+
+	// As in Linux, the iovecs are the source of the data if the pipe is
+	// writable, and the destination otherwise.
+	var n int64
+	if file.Flags().Write {
+		n, err = doVmsplice(t, file, EventMaskWrite, nonBlock, func() (int64, error) {
+			return file.Writev(t, iovs)
+		})
+	} else {
+		n, err = doVmsplice(t, file, EventMaskRead, nonBlock, func() (int64, error) {
+			return file.Readv(t, iovs)
+		})
+	}
+	if n != 0 {
+		// Like splice(2), vmsplice(2) returns as soon as any data has been
+		// moved.
+		err = nil
+	}
+	return uintptr(n), nil, handleIOError(t, n != 0, err, kernel.ERESTARTSYS, "vmsplice", file)
+}
+
+// doVmsplice calls op until it moves data, returns an error other than
+// ErrWouldBlock, or (unless nonBlock is true) file becomes ready for mask.
+func doVmsplice(t *kernel.Task, file *fs.File, mask waiter.EventMask, nonBlock bool, op func() (int64, error)) (int64, error) {
+	n, err := op()
+	if n != 0 || err != syserror.ErrWouldBlock || nonBlock {
+		return n, err
+	}
+
+	// Register for notifications.
+	w, ch := waiter.NewChannelEntry(nil)
+	file.EventRegister(&w, mask)
+	defer file.EventUnregister(&w)
+	for {
+		// Issue the request and break out if it completes with anything
+		// other than "would block".
+		n, err = op()
+		if n != 0 || err != syserror.ErrWouldBlock {
+			return n, err
+		}
+
+		// Wait for a notification that we should retry.
+		if err = t.Block(ch); err != nil {
+			return 0, err
+		}
+	}
+}
@@ -115,16 +115,19 @@ func SyncFileRange(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel
 	}
 
 	// SYNC_FILE_RANGE_WRITE initiates write-out of all dirty pages in the
-	// specified range which are not presently submitted write-out.
-	//
-	// It looks impossible to implement this functionality without a
-	// massive rework of the vfs subsystem. file.Fsync() take a file lock
-	// for the entire operation, so even if it is running in a go routing,
-	// it blocks other file operations instead of flushing data in the
-	// background.
-	//
-	// It should be safe to skipped this flag while nobody uses
-	// SYNC_FILE_RANGE_WAIT_BEFORE.
+	// specified range which are not presently submitted write-out. This is
+	// redundant with SYNC_FILE_RANGE_WAIT_AFTER below, which writes them out
+	// synchronously.
+	if uflags&linux.SYNC_FILE_RANGE_WRITE != 0 &&
+		uflags&linux.SYNC_FILE_RANGE_WAIT_AFTER == 0 {
+		if wb, ok := file.FileOperations.(fs.WriteBackStarter); ok {
+			end := offset + nbytes
+			if end < offset {
+				end = fs.FileMaxOffset
+			}
+			wb.StartWriteBack(t.AsyncContext(), file, offset, end)
+		}
+	}
 
 	// SYNC_FILE_RANGE_WAIT_AFTER waits upon write-out of all pages in the
 	// range after performing any write.
@@ -765,5 +765,11 @@ func Ptrace(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscal
 	addr := args[2].Pointer()
 	data := args[3].Pointer()
 
+	// PTRACE_GET_SYSCALL_INFO is the only request that returns a value other
+	// than 0 on success.
+	if req == linux.PTRACE_GET_SYSCALL_INFO {
+		n, err := t.PtraceGetSyscallInfo(pid, uint64(addr), data)
+		return n, nil, err
+	}
 	return 0, nil, t.Ptrace(req, pid, addr, data)
 }
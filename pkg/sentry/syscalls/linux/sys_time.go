@@ -120,7 +120,10 @@ func getClock(t *kernel.Task, clockID int32) (ktime.Clock, error) {
 	}
 
 	switch clockID {
-	case linux.CLOCK_REALTIME, linux.CLOCK_REALTIME_COARSE:
+	case linux.CLOCK_REALTIME, linux.CLOCK_REALTIME_COARSE, linux.CLOCK_TAI:
+		// CLOCK_TAI is offset from CLOCK_REALTIME by the TAI offset, which
+		// can only be changed by adjtimex(2). As in Linux, it starts at
+		// zero.
 		return t.Kernel().RealtimeClock(), nil
 	case linux.CLOCK_MONOTONIC, linux.CLOCK_MONOTONIC_COARSE,
 		linux.CLOCK_MONOTONIC_RAW, linux.CLOCK_BOOTTIME:
@@ -150,10 +153,27 @@ func ClockGettime(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.
 	if err != nil {
 		return 0, nil, err
 	}
+	if isOwnThreadCPUClock(t, clockID) {
+		// Measure the calling thread's CPU time precisely, which also
+		// allows the VDSO to serve subsequent calls.
+		if now, ok := t.ThreadCPUClock(); ok {
+			ts := linux.NsecToTimespec(now.Nanoseconds())
+			return 0, nil, copyTimespecOut(t, addr, &ts)
+		}
+	}
 	ts := c.Now().Timespec()
 	return 0, nil, copyTimespecOut(t, addr, &ts)
 }
 
+// isOwnThreadCPUClock returns true if clockID is a valid ID of t's CPU clock,
+// including user and system time.
+func isOwnThreadCPUClock(t *kernel.Task, clockID int32) bool {
+	if clockID == linux.CLOCK_THREAD_CPUTIME_ID {
+		return true
+	}
+	return clockID < 0 && isCPUClockPerThread(clockID) && whichCPUClock(clockID) != linux.CPUCLOCK_VIRT && targetTask(t, clockID) == t
+}
+
 // ClockSettime implements linux syscall clock_settime(2).
 func ClockSettime(*kernel.Task, arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	return 0, nil, syserror.EPERM
@@ -196,6 +216,7 @@ func (n *clockNanosleepRestartBlock) Restart(t *kernel.Task) (uintptr, error) {
 func clockNanosleepUntil(t *kernel.Task, c ktime.Clock, ts linux.Timespec) error {
 	notifier, tchan := ktime.NewChannelNotifier()
 	timer := ktime.NewTimer(c, notifier)
+	timer.SetSlack(t.TimerSlack())
 
 	// Turn on the timer.
 	timer.Swap(ktime.Setting{
@@ -221,7 +242,14 @@ func clockNanosleepUntil(t *kernel.Task, c ktime.Clock, ts linux.Timespec) error
 // If blocking is interrupted, the syscall is restarted with the remaining
 // duration timeout.
 func clockNanosleepFor(t *kernel.Task, c ktime.Clock, dur time.Duration, rem usermem.Addr) error {
-	timer, start, tchan := ktime.After(c, dur)
+	notifier, tchan := ktime.NewChannelNotifier()
+	timer := ktime.NewTimer(c, notifier)
+	timer.SetSlack(t.TimerSlack())
+	start := c.Now()
+	timer.Swap(ktime.Setting{
+		Enabled: true,
+		Next:    start.Add(dur),
+	})
 
 	err := t.BlockWithTimer(nil, tchan)
 
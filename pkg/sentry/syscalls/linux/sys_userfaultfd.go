@@ -0,0 +1,47 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package linux
+
+import (
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/fs"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/userfaultfd"
+	"gvisor.dev/gvisor/pkg/syserror"
+)
+
+// Userfaultfd implements linux syscall userfaultfd(2).
+func Userfaultfd(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	flags := args[0].Int()
+	if flags&^(linux.UFFD_CLOEXEC|linux.UFFD_NONBLOCK) != 0 {
+		return 0, nil, syserror.EINVAL
+	}
+
+	uffd := userfaultfd.New(t, t.MemoryManager())
+	uffd.SetFlags(fs.SettableFileFlags{
+		NonBlocking: flags&linux.UFFD_NONBLOCK != 0,
+	})
+	defer uffd.DecRef()
+
+	fd, err := t.NewFDFrom(0, uffd, kernel.FDFlags{
+		CloseOnExec: flags&linux.UFFD_CLOEXEC != 0,
+	})
+	if err != nil {
+		return 0, nil, err
+	}
+
+	return uintptr(fd), nil, nil
+}
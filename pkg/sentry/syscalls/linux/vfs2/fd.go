@@ -15,6 +15,8 @@
 package vfs2
 
 import (
+	"math"
+
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/fsimpl/tmpfs"
@@ -41,6 +43,43 @@ func Close(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.Syscall
 	return 0, nil, slinux.HandleIOErrorVFS2(t, false /* partial */, err, syserror.EINTR, "close", file)
 }
 
+// CloseRange implements Linux syscall close_range(2).
+func CloseRange(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	first := args[0].Uint()
+	last := args[1].Uint()
+	flags := args[2].Uint()
+
+	if flags&^(linux.CLOSE_RANGE_UNSHARE|linux.CLOSE_RANGE_CLOEXEC) != 0 || first > last {
+		return 0, nil, syserror.EINVAL
+	}
+	if first > math.MaxInt32 {
+		// No such file descriptors can exist.
+		return 0, nil, nil
+	}
+	if last > math.MaxInt32 {
+		last = math.MaxInt32
+	}
+
+	if flags&linux.CLOSE_RANGE_UNSHARE != 0 {
+		if err := t.Unshare(&kernel.SharingOptions{NewFiles: true}); err != nil {
+			return 0, nil, err
+		}
+	}
+
+	if flags&linux.CLOSE_RANGE_CLOEXEC != 0 {
+		t.FDTable().SetFlagsRange(int32(first), int32(last), kernel.FDFlags{CloseOnExec: true})
+		return 0, nil, nil
+	}
+
+	// Like Linux, ignore errors from closing the removed files.
+	_, files := t.FDTable().RemoveRange(int32(first), int32(last))
+	for _, file := range files {
+		file.OnClose(t)
+		file.DecRef()
+	}
+	return 0, nil, nil
+}
+
 // Dup implements Linux syscall dup(2).
 func Dup(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	fd := args[0].Int()
@@ -20,6 +20,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/fsimpl/tmpfs"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
 	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
 )
 
 const (
@@ -33,6 +34,14 @@ func MemfdCreate(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.S
 	addr := args[0].Pointer()
 	flags := args[1].Uint()
 
+	hugetlb := flags&linux.MFD_HUGETLB != 0
+	if hugetlb {
+		// Only the default huge page size is supported.
+		if size := (flags >> linux.MFD_HUGE_SHIFT) & linux.MFD_HUGE_MASK; size != 0 && size != usermem.HugePageShift {
+			return 0, nil, syserror.EINVAL
+		}
+		flags &^= linux.MFD_HUGETLB | linux.MFD_HUGE_MASK<<linux.MFD_HUGE_SHIFT
+	}
 	if flags&^memfdAllFlags != 0 {
 		// Unknown bits in flags.
 		return 0, nil, syserror.EINVAL
@@ -47,7 +56,7 @@ func MemfdCreate(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.S
 	}
 
 	shmMount := t.Kernel().ShmMount()
-	file, err := tmpfs.NewMemfd(shmMount, t.Credentials(), allowSeals, memfdPrefix+name)
+	file, err := tmpfs.NewMemfd(shmMount, t.Credentials(), allowSeals, hugetlb, memfdPrefix+name)
 	if err != nil {
 		return 0, nil, err
 	}
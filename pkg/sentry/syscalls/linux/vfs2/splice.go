@@ -19,8 +19,10 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/pipe"
+	slinux "gvisor.dev/gvisor/pkg/sentry/syscalls/linux"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 	"gvisor.dev/gvisor/pkg/syserror"
+	"gvisor.dev/gvisor/pkg/usermem"
 	"gvisor.dev/gvisor/pkg/waiter"
 )
 
@@ -289,3 +291,90 @@ func Tee(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallCo
 		}
 	}
 }
+
+// Vmsplice implements Linux syscall vmsplice(2).
+//
+// Pipe buffers never reference application memory, so data is always copied
+// between the pipe and the iovecs, and SPLICE_F_GIFT has no effect. (As in
+// Linux, the application may reuse gifted memory after vmsplice returns, but
+// doing so doesn't change the spliced data.)
+func Vmsplice(t *kernel.Task, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	fd := args[0].Int()
+	addr := args[1].Pointer()
+	iovcnt := int(args[2].Int())
+	flags := args[3].Int()
+
+	// Check for invalid flags.
+	if flags&^(linux.SPLICE_F_MOVE|linux.SPLICE_F_NONBLOCK|linux.SPLICE_F_MORE|linux.SPLICE_F_GIFT) != 0 {
+		return 0, nil, syserror.EINVAL
+	}
+
+	// Get file description.
+	file := t.GetFileVFS2(fd)
+	if file == nil {
+		return 0, nil, syserror.EBADF
+	}
+	defer file.DecRef()
+
+	// The file description must represent a pipe.
+	if _, ok := file.Impl().(*pipe.VFSPipeFD); !ok {
+		return 0, nil, syserror.EBADF
+	}
+
+	// The operation is non-blocking if anything is non-blocking, as for
+	// splice(2).
+	nonBlock := file.StatusFlags()&linux.O_NONBLOCK != 0 || flags&linux.SPLICE_F_NONBLOCK != 0
+
+	iovs, err := t.IovecsIOSequence(addr, iovcnt, usermem.IOOpts{
+		AddressSpaceActive: true,
+	})
+	if err != nil {
+		return 0, nil, err
+	}
+
+	// As in Linux, the iovecs are the source of the data if the pipe is
+	// writable, and the destination otherwise.
+	var n int64
+	if file.IsWritable() {
+		n, err = vmsplice(t, file, eventMaskWrite, nonBlock, func() (int64, error) {
+			return file.Write(t, iovs, vfs.WriteOptions{})
+		})
+	} else {
+		n, err = vmsplice(t, file, eventMaskRead, nonBlock, func() (int64, error) {
+			return file.Read(t, iovs, vfs.ReadOptions{})
+		})
+	}
+	if n != 0 {
+		// Like splice(2), vmsplice(2) returns as soon as any data has been
+		// moved.
+		err = nil
+	}
+	return uintptr(n), nil, slinux.HandleIOErrorVFS2(t, n != 0, err, kernel.ERESTARTSYS, "vmsplice", file)
+}
+
+// vmsplice calls op until it moves data, returns an error other than
+// ErrWouldBlock, or (unless nonBlock is true) file becomes ready for mask.
+func vmsplice(t *kernel.Task, file *vfs.FileDescription, mask waiter.EventMask, nonBlock bool, op func() (int64, error)) (int64, error) {
+	n, err := op()
+	if n != 0 || err != syserror.ErrWouldBlock || nonBlock {
+		return n, err
+	}
+
+	// Register for notifications.
+	w, ch := waiter.NewChannelEntry(nil)
+	file.EventRegister(&w, mask)
+	defer file.EventUnregister(&w)
+	for {
+		// Issue the request and break out if it completes with anything
+		// other than "would block".
+		n, err = op()
+		if n != 0 || err != syserror.ErrWouldBlock {
+			return n, err
+		}
+
+		// Wait for a notification that we should retry.
+		if err = t.Block(ch); err != nil {
+			return 0, err
+		}
+	}
+}
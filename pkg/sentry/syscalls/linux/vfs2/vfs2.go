@@ -137,6 +137,7 @@ func Override() {
 	s.Table[275] = syscalls.Supported("splice", Splice)
 	s.Table[276] = syscalls.Supported("tee", Tee)
 	s.Table[277] = syscalls.Supported("sync_file_range", SyncFileRange)
+	s.Table[278] = syscalls.PartiallySupported("vmsplice", Vmsplice, "Data is always copied; SPLICE_F_GIFT has no effect.", nil)
 	s.Table[280] = syscalls.Supported("utimensat", Utimensat)
 	s.Table[281] = syscalls.Supported("epoll_pwait", EpollPwait)
 	s.Table[282] = syscalls.Supported("signalfd", Signalfd)
@@ -154,19 +155,28 @@ func Override() {
 	s.Table[294] = syscalls.PartiallySupported("inotify_init1", InotifyInit1, "inotify events are only available inside the sandbox.", nil)
 	s.Table[295] = syscalls.Supported("preadv", Preadv)
 	s.Table[296] = syscalls.Supported("pwritev", Pwritev)
+	s.Table[298] = syscalls.PartiallySupported("perf_event_open", PerfEventOpen, "Only software events counting a single task are supported, without event groups or inheritance; samples are taken at CPU clock ticks.", nil)
 	s.Table[299] = syscalls.Supported("recvmmsg", RecvMMsg)
 	s.Table[306] = syscalls.Supported("syncfs", Syncfs)
 	s.Table[307] = syscalls.Supported("sendmmsg", SendMMsg)
 	s.Table[316] = syscalls.Supported("renameat2", Renameat2)
 	s.Table[319] = syscalls.Supported("memfd_create", MemfdCreate)
 	s.Table[322] = syscalls.Supported("execveat", Execveat)
+	s.Table[323] = syscalls.PartiallySupported("userfaultfd", Userfaultfd, "Only UFFDIO_REGISTER_MODE_MISSING on private anonymous memory is supported, with no optional features.", nil)
+	delete(s.Table, 326) // copy_file_range
 	s.Table[327] = syscalls.Supported("preadv2", Preadv2)
 	s.Table[328] = syscalls.Supported("pwritev2", Pwritev2)
 	s.Table[332] = syscalls.Supported("statx", Statx)
+	s.Table[434] = syscalls.Supported("pidfd_open", PidfdOpen)
+	s.Table[436] = syscalls.Supported("close_range", CloseRange)
 	s.Init()
 
 	// Override ARM64.
 	s = linux.ARM64
 	s.Table[63] = syscalls.Supported("read", Read)
+	s.Table[75] = syscalls.PartiallySupported("vmsplice", Vmsplice, "Data is always copied; SPLICE_F_GIFT has no effect.", nil)
+	s.Table[241] = syscalls.PartiallySupported("perf_event_open", PerfEventOpen, "Only software events counting a single task are supported, without event groups or inheritance; samples are taken at CPU clock ticks.", nil)
+	s.Table[434] = syscalls.Supported("pidfd_open", PidfdOpen)
+	s.Table[436] = syscalls.Supported("close_range", CloseRange)
 	s.Init()
 }
@@ -15,6 +15,8 @@
 package vfs
 
 import (
+	"sync/atomic"
+
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/sync"
@@ -80,9 +82,10 @@ type epollInterest struct {
 	// flags EPOLLET and EPOLLONESHOT. mask is protected by epoll.mu.
 	mask uint32
 
-	// ready is true if epollInterestEntry is linked into epoll.ready. ready
-	// and epollInterestEntry are protected by epoll.mu.
-	ready bool
+	// ready is 1 if epollInterestEntry is linked into epoll.ready. ready
+	// and epollInterestEntry are protected by epoll.mu; ready may also be
+	// loaded atomically without holding epoll.mu.
+	ready uint32
 	epollInterestEntry
 
 	// userData is the struct epoll_event::data associated with this
@@ -184,6 +187,13 @@ func (ep *EpollInstance) AddInterest(file *FileDescription, num int32, event lin
 		return syserror.EEXIST
 	}
 
+	// "EPOLLEXCLUSIVE ... An EINVAL error also occurs if EPOLLEXCLUSIVE is
+	// specified in events and fd refers to an epoll instance." Linux also
+	// rejects flags other than EPOLLEXCLUSIVE_OK_BITS.
+	if event.Events&linux.EPOLLEXCLUSIVE != 0 && (subep != nil || event.Events&^linux.EPOLLEXCLUSIVE_OK_BITS != 0) {
+		return syserror.EINVAL
+	}
+
 	// Register interest in file.
 	mask := event.Events | linux.EPOLLERR | linux.EPOLLRDHUP
 	epi := &epollInterest{
@@ -193,6 +203,7 @@ func (ep *EpollInstance) AddInterest(file *FileDescription, num int32, event lin
 		userData: event.Data,
 	}
 	epi.waiter.Callback = epi
+	epi.waiter.Exclusive = mask&linux.EPOLLEXCLUSIVE != 0
 	ep.interest[key] = epi
 	wmask := waiter.EventMaskFromLinux(mask)
 	file.EventRegister(&epi.waiter, wmask)
@@ -255,6 +266,15 @@ func (ep *EpollInstance) ModifyInterest(file *FileDescription, num int32, event
 		return syserror.ENOENT
 	}
 
+	// "EINVAL: An invalid event type was specified along with EPOLLEXCLUSIVE
+	// in events. EINVAL: op was EPOLL_CTL_MOD and events included
+	// EPOLLEXCLUSIVE. EINVAL: op was EPOLL_CTL_MOD and the EPOLLEXCLUSIVE
+	// flag has previously been applied to this epfd, fd pair." -
+	// epoll_ctl(2)
+	if event.Events&linux.EPOLLEXCLUSIVE != 0 || epi.waiter.Exclusive {
+		return syserror.EINVAL
+	}
+
 	// Update epi for the next call to ep.ReadEvents().
 	mask := event.Events | linux.EPOLLERR | linux.EPOLLRDHUP
 	ep.mu.Lock()
@@ -306,11 +326,33 @@ func (ep *EpollInstance) DeleteInterest(file *FileDescription, num int32) error
 
 // Callback implements waiter.EntryCallback.Callback.
 func (epi *epollInterest) Callback(*waiter.Entry) {
+	epi.markReady()
+}
+
+// CallbackExclusive implements waiter.ExclusiveEntryCallback.CallbackExclusive.
+func (epi *epollInterest) CallbackExclusive(*waiter.Entry) bool {
+	epi.markReady()
+	// As in Linux, the event is queued on every EpollInstance that is
+	// notified, but only one with waiters stops the notification of other
+	// exclusive waiters.
+	return !epi.epoll.q.IsEmpty()
+}
+
+// markReady links epi into its EpollInstance's ready list, and notifies the
+// EpollInstance's waiters, if epi is not already ready.
+func (epi *epollInterest) markReady() {
+	// Fast path: if epi is already ready, ReadEvents will check its file's
+	// readiness after clearing epi.ready, so the notification can't be lost.
+	// This avoids contending for epoll.mu when a file that has pending events
+	// is notified repeatedly.
+	if atomic.LoadUint32(&epi.ready) != 0 {
+		return
+	}
 	newReady := false
 	epi.epoll.mu.Lock()
-	if !epi.ready {
+	if epi.ready == 0 {
 		newReady = true
-		epi.ready = true
+		atomic.StoreUint32(&epi.ready, 1)
 		epi.epoll.ready.PushBack(epi)
 	}
 	epi.epoll.mu.Unlock()
@@ -323,8 +365,8 @@ func (epi *epollInterest) Callback(*waiter.Entry) {
 func (ep *EpollInstance) removeLocked(epi *epollInterest) {
 	delete(ep.interest, epi.key)
 	ep.mu.Lock()
-	if epi.ready {
-		epi.ready = false
+	if epi.ready != 0 {
+		atomic.StoreUint32(&epi.ready, 0)
 		ep.ready.Remove(epi)
 	}
 	ep.mu.Unlock()
@@ -343,13 +385,14 @@ func (ep *EpollInstance) ReadEvents(events []linux.EpollEvent) int {
 	for epi := ep.ready.Front(); epi != nil; epi = next {
 		next = epi.Next()
 		// Regardless of what else happens, epi is initially removed from the
-		// ready list.
+		// ready list. epi.ready must be cleared before checking readiness;
+		// see epollInterest.markReady.
 		ep.ready.Remove(epi)
+		atomic.StoreUint32(&epi.ready, 0)
 		wmask := waiter.EventMaskFromLinux(epi.mask)
 		ievents := epi.key.file.Readiness(wmask) & wmask
 		if ievents == 0 {
 			// Leave epi off the ready list.
-			epi.ready = false
 			continue
 		}
 		// Determine what we should do with epi.
@@ -361,9 +404,9 @@ func (ep *EpollInstance) ReadEvents(events []linux.EpollEvent) int {
 			fallthrough
 		case epi.mask&linux.EPOLLET != 0:
 			// Leave epi off the ready list.
-			epi.ready = false
 		default:
 			// Queue epi to be moved to the end of the ready list.
+			atomic.StoreUint32(&epi.ready, 1)
 			requeue.PushBack(epi)
 		}
 		// Report ievents.
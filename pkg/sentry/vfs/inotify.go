@@ -15,7 +15,6 @@
 package vfs
 
 import (
-	"bytes"
 	"fmt"
 	"sync/atomic"
 
@@ -33,6 +32,11 @@ import (
 // must be a power 2 for rounding below.
 const inotifyEventBaseSize = 16
 
+// maxQueuedEvents is the maximum number of events queued by an inotify
+// instance, after which an IN_Q_OVERFLOW event is queued. This is the default
+// value of Linux's /proc/sys/fs/inotify/max_queued_events.
+const maxQueuedEvents = 16384
+
 // EventType defines different kinds of inotfiy events.
 //
 // The way events are labelled appears somewhat arbitrary, but they must match
@@ -75,6 +79,11 @@ type Inotify struct {
 	// A list of pending events for this inotify instance. Protected by evMu.
 	events eventList
 
+	// numEvents is the number of events in events, and eventsSize is their
+	// total size as read by read(2). Protected by evMu.
+	numEvents  int
+	eventsSize int
+
 	// A scratch buffer, used to serialize inotify events. Allocate this
 	// ahead of time for the sake of performance. Protected by evMu.
 	scratch []byte
@@ -212,6 +221,8 @@ func (i *Inotify) Read(ctx context.Context, dst usermem.IOSequence, opts ReadOpt
 		// buffer space to copy it out, even if the copy below fails. Emulate
 		// this behaviour.
 		i.events.Remove(event)
+		i.numEvents--
+		i.eventsSize -= event.sizeOf()
 
 		// Buffer has enough space, copy event to the read buffer.
 		n, err := event.CopyTo(ctx, i.scratch, dst)
@@ -231,12 +242,8 @@ func (i *Inotify) Ioctl(ctx context.Context, uio usermem.IO, args arch.SyscallAr
 	case linux.FIONREAD:
 		i.evMu.Lock()
 		defer i.evMu.Unlock()
-		var n uint32
-		for e := i.events.Front(); e != nil; e = e.Next() {
-			n += uint32(e.sizeOf())
-		}
 		var buf [4]byte
-		usermem.ByteOrder.PutUint32(buf[:], n)
+		usermem.ByteOrder.PutUint32(buf[:], uint32(i.eventsSize))
 		_, err := uio.CopyOut(ctx, args[2].Pointer(), buf[:], usermem.IOOpts{})
 		return 0, err
 
@@ -245,22 +252,42 @@ func (i *Inotify) Ioctl(ctx context.Context, uio usermem.IO, args arch.SyscallAr
 	}
 }
 
-func (i *Inotify) queueEvent(ev *Event) {
+// queueEvent queues an event for watch descriptor wd with the given name, mask
+// and cookie.
+//
+// As in Linux, the event is dropped if it is identical to the last queued
+// event, and a single IN_Q_OVERFLOW event is queued in place of events past
+// maxQueuedEvents.
+func (i *Inotify) queueEvent(wd int32, name string, mask, cookie uint32) {
 	i.evMu.Lock()
 
-	// Check if we should coalesce the event we're about to queue with the last
-	// one currently in the queue. Events are coalesced if they are identical.
-	if last := i.events.Back(); last != nil {
-		if ev.equals(last) {
-			// "Coalesce" the two events by simply not queuing the new one. We
-			// don't need to raise a waiter.EventIn notification because no new
-			// data is available for reading.
+	if i.numEvents >= maxQueuedEvents {
+		if i.numEvents > maxQueuedEvents {
+			// The overflow event has already been queued.
 			i.evMu.Unlock()
 			return
 		}
+		// Queue an overflow event instead, unless one is already last in
+		// the queue.
+		wd, name, mask, cookie = -1, "", linux.IN_Q_OVERFLOW, 0
 	}
 
+	// Check if we should coalesce the event we're about to queue with the last
+	// one currently in the queue. This is checked before allocating the event,
+	// since watchers that fall behind see long runs of identical events, such
+	// as IN_MODIFY for each write to a file.
+	if last := i.events.Back(); last != nil && last.matches(wd, name, mask, cookie) {
+		// "Coalesce" the two events by simply not queuing the new one. We
+		// don't need to raise a waiter.EventIn notification because no new
+		// data is available for reading.
+		i.evMu.Unlock()
+		return
+	}
+
+	ev := newEvent(wd, name, mask, cookie)
 	i.events.PushBack(ev)
+	i.numEvents++
+	i.eventsSize += ev.sizeOf()
 
 	// Release mutex before notifying waiters because we don't control what they
 	// can do.
@@ -305,7 +332,7 @@ func (i *Inotify) handleDeletion(w *Watch) {
 	i.mu.Unlock()
 
 	if found {
-		i.queueEvent(newEvent(w.wd, "", linux.IN_IGNORED, 0))
+		i.queueEvent(w.wd, "", linux.IN_IGNORED, 0)
 	}
 }
 
@@ -356,7 +383,7 @@ func (i *Inotify) RmWatch(wd int32) error {
 	i.mu.Unlock()
 
 	// Generate the event for the removal.
-	i.queueEvent(newEvent(wd, "", linux.IN_IGNORED, 0))
+	i.queueEvent(wd, "", linux.IN_IGNORED, 0)
 
 	return nil
 }
@@ -532,7 +559,7 @@ func (w *Watch) Notify(name string, events uint32, cookie uint32) {
 	unmaskableBits := ^uint32(0) &^ linux.IN_ALL_EVENTS
 	effectiveMask := unmaskableBits | mask
 	matchedEvents := effectiveMask & events
-	w.owner.queueEvent(newEvent(w.wd, name, matchedEvents, cookie))
+	w.owner.queueEvent(w.wd, name, matchedEvents, cookie)
 }
 
 // handleDeletion handles the deletion of w's target.
@@ -644,12 +671,17 @@ func (e *Event) CopyTo(ctx context.Context, buf []byte, dst usermem.IOSequence)
 	return int64(writeLen), nil
 }
 
-func (e *Event) equals(other *Event) bool {
-	return e.wd == other.wd &&
-		e.mask == other.mask &&
-		e.cookie == other.cookie &&
-		e.len == other.len &&
-		bytes.Equal(e.name, other.name)
+// matches returns true if e is identical to the event that would be returned
+// by newEvent(wd, name, mask, cookie).
+func (e *Event) matches(wd int32, name string, mask, cookie uint32) bool {
+	if e.wd != wd || e.mask != mask || e.cookie != cookie {
+		return false
+	}
+	if name == "" {
+		return e.len == 0
+	}
+	// e.name is null-terminated and padded with null bytes.
+	return len(e.name) > len(name) && e.name[len(name)] == 0 && string(e.name[:len(name)]) == name
 }
 
 // InotifyEventFromStatMask generates the appropriate events for an operation
@@ -674,6 +674,26 @@ func (mnt *Mount) readOnly() bool {
 	return atomic.LoadInt64(&mnt.writers) < 0
 }
 
+// relatimeInterval is the maximum age of an atime that is not updated by an
+// access under relatime semantics, as in Linux's fs/inode.c:relatime_need_update().
+const relatimeInterval = 24 * 60 * 60 * 1e9 // 24 hours, in nanoseconds
+
+// NeedsATimeUpdate returns true if an access at time now through mnt should
+// update the atime of a file with the given atime, mtime, and ctime. All times
+// are in nanoseconds.
+//
+// Skipping updates that relatime semantics allow avoids dirtying the file's
+// metadata on every read.
+func (mnt *Mount) NeedsATimeUpdate(atime, mtime, ctime, now int64) bool {
+	if mnt.flags.NoATime {
+		return false
+	}
+	if mnt.flags.StrictATime {
+		return true
+	}
+	return mtime >= atime || ctime >= atime || now-atime >= relatimeInterval
+}
+
 // Filesystem returns the mounted Filesystem. It does not take a reference on
 // the returned Filesystem.
 func (mnt *Mount) Filesystem() *Filesystem {
@@ -744,6 +764,11 @@ func (vfs *VirtualFilesystem) GenerateProcMounts(ctx context.Context, taskRootDi
 		if mnt.flags.NoExec {
 			opts += ",noexec"
 		}
+		if mnt.flags.NoATime {
+			opts += ",noatime"
+		} else if !mnt.flags.StrictATime {
+			opts += ",relatime"
+		}
 
 		// Format:
 		// <special device or remote filesystem> <mount point> <filesystem type> <mount options> <needs dump> <fsck order>
@@ -829,8 +854,11 @@ func (vfs *VirtualFilesystem) GenerateProcMountInfo(ctx context.Context, taskRoo
 		if mnt.flags.NoExec {
 			opts += ",noexec"
 		}
-		// TODO(gvisor.dev/issue/1193): Add "noatime" if MS_NOATIME is
-		// set.
+		if mnt.flags.NoATime {
+			opts += ",noatime"
+		} else if !mnt.flags.StrictATime {
+			opts += ",relatime"
+		}
 		fmt.Fprintf(buf, "%s ", opts)
 
 		// (7) Optional fields: zero or more fields of the form "tag[:value]".
@@ -75,6 +75,14 @@ type MknodOptions struct {
 type MountFlags struct {
 	// NoExec is equivalent to MS_NOEXEC.
 	NoExec bool
+
+	// NoATime is equivalent to MS_NOATIME.
+	NoATime bool
+
+	// StrictATime is equivalent to MS_STRICTATIME. If neither NoATime nor
+	// StrictATime is set, atime is updated with relatime semantics, as if
+	// MS_RELATIME was given.
+	StrictATime bool
 }
 
 // MountOptions contains options to VirtualFilesystem.MountAt().
@@ -216,6 +216,20 @@ func (rp *ResolvingPath) Component() string {
 	return rp.pit.String()
 }
 
+// PeekComponents appends up to max path components to names, starting with
+// the current path component, without advancing the stream of path components
+// represented by rp. It stops at the end of the current path segment, so any
+// components that follow from a symlink target are not included.
+//
+// Preconditions: !rp.Done().
+func (rp *ResolvingPath) PeekComponents(names []string, max int) []string {
+	for it := rp.pit; it.Ok() && max > 0; it = it.Next() {
+		names = append(names, it.String())
+		max--
+	}
+	return names
+}
+
 // Advance advances the stream of path components represented by rp.
 //
 // Preconditions: !rp.Done().
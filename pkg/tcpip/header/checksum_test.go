@@ -161,6 +161,7 @@ func BenchmarkChecksum(b *testing.B) {
 					initial: uint16(rnd.Intn(65536)),
 				}
 				rnd.Read(tc.buf)
+				b.SetBytes(int64(bufSz))
 				b.ResetTimer()
 				for i := 0; i < b.N; i++ {
 					tc.csum = csumImpl.fn(tc.buf, tc.initial)
@@ -130,6 +130,10 @@ type endpoint struct {
 	// disabled.
 	gsoMaxSize uint32
 
+	// gro indicates whether received TCP segments are coalesced before they
+	// are delivered to the stack. See groPacket.
+	gro bool
+
 	// wg keeps track of running goroutines.
 	wg sync.WaitGroup
 }
@@ -180,6 +184,13 @@ type Options struct {
 	// RXChecksumOffload if true, indicates that this endpoints capability
 	// set should include CapabilityRXChecksumOffload.
 	RXChecksumOffload bool
+
+	// GROEnabled if true, indicates that consecutive TCP segments of a flow
+	// received in one batch should be coalesced before being delivered. It
+	// only applies to the RecvMMsg dispatch mode, and is ignored unless
+	// RXChecksumOffload is also set, because coalesced segments carry a
+	// stale TCP checksum.
+	GROEnabled bool
 }
 
 // fanoutID is used for AF_PACKET based endpoints to enable PACKET_FANOUT
@@ -231,6 +242,7 @@ func New(opts *Options) (stack.LinkEndpoint, error) {
 		addr:               opts.Address,
 		hdrSize:            hdrSize,
 		packetDispatchMode: opts.PacketDispatchMode,
+		gro:                opts.GROEnabled && opts.RXChecksumOffload,
 	}
 
 	// Create per channel dispatchers.
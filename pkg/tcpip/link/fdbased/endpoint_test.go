@@ -21,6 +21,9 @@ import (
 	"fmt"
 	"math/rand"
 	"reflect"
+	"runtime"
+	"sync"
+	"sync/atomic"
 	"syscall"
 	"testing"
 	"time"
@@ -500,3 +503,230 @@ func TestRecvMMsgDispatcherCapLength(t *testing.T) {
 
 	}
 }
+
+// groSegment returns an IPv4 TCP segment with the given sequence number,
+// flags and payload.
+func groSegment(seq uint32, flags uint8, payload []byte) stack.PacketBuffer {
+	hdr := buffer.NewView(header.IPv4MinimumSize + header.TCPMinimumSize)
+	ip := header.IPv4(hdr)
+	ip.Encode(&header.IPv4Fields{
+		IHL:         header.IPv4MinimumSize,
+		TotalLength: uint16(len(hdr) + len(payload)),
+		TTL:         64,
+		Protocol:    uint8(header.TCPProtocolNumber),
+		SrcAddr:     "\x0a\x00\x00\x01",
+		DstAddr:     "\x0a\x00\x00\x02",
+	})
+	ip.SetChecksum(^ip.CalculateChecksum())
+	header.TCP(hdr[header.IPv4MinimumSize:]).Encode(&header.TCPFields{
+		SrcPort:    1000,
+		DstPort:    2000,
+		SeqNum:     seq,
+		AckNum:     1,
+		DataOffset: header.TCPMinimumSize,
+		Flags:      flags,
+		WindowSize: 1000,
+	})
+	return stack.PacketBuffer{
+		Data: buffer.NewVectorisedView(len(hdr)+len(payload), []buffer.View{hdr, buffer.NewViewFromBytes(payload)}),
+	}
+}
+
+func TestGROCoalesce(t *testing.T) {
+	const ack = header.TCPFlagAck
+	for _, test := range []struct {
+		name  string
+		segs  []stack.PacketBuffer
+		sizes []int
+	}{
+		{
+			name: "in order",
+			segs: []stack.PacketBuffer{
+				groSegment(100, ack, []byte("abcd")),
+				groSegment(104, ack, []byte("efgh")),
+				groSegment(108, ack|header.TCPFlagPsh, []byte("ij")),
+			},
+			sizes: []int{10},
+		},
+		{
+			name: "out of order",
+			segs: []stack.PacketBuffer{
+				groSegment(100, ack, []byte("abcd")),
+				groSegment(108, ack, []byte("efgh")),
+			},
+			sizes: []int{4, 4},
+		},
+		{
+			name: "after short segment",
+			segs: []stack.PacketBuffer{
+				groSegment(100, ack, []byte("abcd")),
+				groSegment(104, ack, []byte("ef")),
+				groSegment(106, ack, []byte("gh")),
+			},
+			sizes: []int{6, 2},
+		},
+		{
+			name: "after push",
+			segs: []stack.PacketBuffer{
+				groSegment(100, ack|header.TCPFlagPsh, []byte("abcd")),
+				groSegment(104, ack, []byte("efgh")),
+			},
+			sizes: []int{4, 4},
+		},
+		{
+			name: "fin",
+			segs: []stack.PacketBuffer{
+				groSegment(100, ack, []byte("abcd")),
+				groSegment(104, ack|header.TCPFlagFin, []byte("efgh")),
+			},
+			sizes: []int{4, 4},
+		},
+	} {
+		t.Run(test.name, func(t *testing.T) {
+			c := &context{t: t, ch: make(chan packetInfo, len(test.segs))}
+			var pending groPacket
+			for i := range test.segs {
+				if i > 0 && pending.merge(raddr, laddr, header.IPv4ProtocolNumber, &test.segs[i]) {
+					continue
+				}
+				if i > 0 {
+					pending.deliver(c)
+				}
+				pending = newGROPacket(raddr, laddr, header.IPv4ProtocolNumber, test.segs[i])
+			}
+			pending.deliver(c)
+			close(c.ch)
+
+			var sizes []int
+			for p := range c.ch {
+				data := p.contents.Data.ToView()
+				ip := header.IPv4(data)
+				if !ip.IsValid(len(data)) || int(ip.TotalLength()) != len(data) {
+					t.Fatalf("got invalid IPv4 header %x for a %d byte packet", []byte(ip[:header.IPv4MinimumSize]), len(data))
+				}
+				if got := ip.CalculateChecksum(); got != 0xffff {
+					t.Errorf("got IPv4 checksum %#x, want 0xffff", got)
+				}
+				sizes = append(sizes, len(header.TCP(ip.Payload()).Payload()))
+			}
+			if !reflect.DeepEqual(sizes, test.sizes) {
+				t.Errorf("got payload sizes %v, want %v", sizes, test.sizes)
+			}
+		})
+	}
+}
+
+// countingDispatcher is a stack.NetworkDispatcher that counts the packets
+// delivered to it.
+type countingDispatcher struct {
+	// packets is accessed using atomic memory operations.
+	packets int64
+}
+
+func (d *countingDispatcher) DeliverNetworkPacket(remote tcpip.LinkAddress, local tcpip.LinkAddress, protocol tcpip.NetworkProtocolNumber, pkt stack.PacketBuffer) {
+	atomic.AddInt64(&d.packets, 1)
+}
+
+// udpFrame returns an Ethernet frame containing an IPv4 UDP datagram with the
+// given source port and payload length.
+func udpFrame(srcPort uint16, payloadLen int) []byte {
+	const hdrLen = header.EthernetMinimumSize + header.IPv4MinimumSize + header.UDPMinimumSize
+	frame := make([]byte, hdrLen+payloadLen)
+	header.Ethernet(frame).Encode(&header.EthernetFields{
+		SrcAddr: raddr,
+		DstAddr: laddr,
+		Type:    header.IPv4ProtocolNumber,
+	})
+	ip := header.IPv4(frame[header.EthernetMinimumSize:])
+	ip.Encode(&header.IPv4Fields{
+		IHL:         header.IPv4MinimumSize,
+		TotalLength: uint16(len(frame) - header.EthernetMinimumSize),
+		TTL:         64,
+		Protocol:    uint8(header.UDPProtocolNumber),
+		SrcAddr:     "\x0a\x00\x00\x01",
+		DstAddr:     "\x0a\x00\x00\x02",
+	})
+	ip.SetChecksum(^ip.CalculateChecksum())
+	header.UDP(frame[header.EthernetMinimumSize+header.IPv4MinimumSize:]).Encode(&header.UDPFields{
+		SrcPort: srcPort,
+		DstPort: 2000,
+		Length:  uint16(header.UDPMinimumSize + payloadLen),
+	})
+	return frame
+}
+
+// BenchmarkDeliverPacketChannels measures the rate at which an endpoint
+// receives packets from many concurrent flows, as the number of channels
+// (FDs) that the flows are spread over varies. Flows are assigned to channels
+// by hash, as PACKET_FANOUT_HASH does for AF_PACKET sockets.
+func BenchmarkDeliverPacketChannels(b *testing.B) {
+	const (
+		numFlows   = 16
+		payloadLen = 1000
+	)
+	for _, numChannels := range []int{1, 2, 4, 8, 16} {
+		b.Run(fmt.Sprintf("channels=%d", numChannels), func(b *testing.B) {
+			var peerFDs, epFDs []int
+			for i := 0; i < numChannels; i++ {
+				fds, err := syscall.Socketpair(syscall.AF_UNIX, syscall.SOCK_SEQPACKET, 0)
+				if err != nil {
+					b.Fatalf("Socketpair failed: %v", err)
+				}
+				peerFDs = append(peerFDs, fds[0])
+				epFDs = append(epFDs, fds[1])
+			}
+			done := make(chan struct{}, numChannels)
+			ep, err := New(&Options{
+				FDs:            epFDs,
+				MTU:            mtu,
+				EthernetHeader: true,
+				Address:        laddr,
+				ClosedFunc: func(*tcpip.Error) {
+					done <- struct{}{}
+				},
+			})
+			if err != nil {
+				b.Fatalf("Failed to create FD endpoint: %v", err)
+			}
+			d := &countingDispatcher{}
+			ep.Attach(d)
+
+			b.SetBytes(header.EthernetMinimumSize + header.IPv4MinimumSize + header.UDPMinimumSize + payloadLen)
+			b.ResetTimer()
+			var wg sync.WaitGroup
+			for f := 0; f < numFlows; f++ {
+				n := b.N / numFlows
+				if f < b.N%numFlows {
+					n++
+				}
+				frame := udpFrame(uint16(1000+f), payloadLen)
+				fd := peerFDs[f%numChannels]
+				wg.Add(1)
+				go func() {
+					defer wg.Done()
+					for i := 0; i < n; i++ {
+						if _, err := syscall.Write(fd, frame); err != nil {
+							b.Errorf("Write failed: %v", err)
+							return
+						}
+					}
+				}()
+			}
+			wg.Wait()
+			for !b.Failed() && atomic.LoadInt64(&d.packets) < int64(b.N) {
+				runtime.Gosched()
+			}
+			b.StopTimer()
+
+			for _, fd := range peerFDs {
+				syscall.Close(fd)
+			}
+			for range epFDs {
+				<-done
+			}
+			for _, fd := range epFDs {
+				syscall.Close(fd)
+			}
+		})
+	}
+}
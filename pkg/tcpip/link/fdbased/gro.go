@@ -0,0 +1,169 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// +build linux
+
+package fdbased
+
+import (
+	"bytes"
+
+	"gvisor.dev/gvisor/pkg/tcpip"
+	"gvisor.dev/gvisor/pkg/tcpip/header"
+	"gvisor.dev/gvisor/pkg/tcpip/stack"
+)
+
+// groMaxSize is the maximum size of an IPv4 packet built by coalescing
+// segments, which is bounded by the IPv4 total length field.
+const groMaxSize = 1<<16 - 1
+
+// groPacket is a received packet which later TCP segments of the same flow
+// may be coalesced into, as done by generic receive offload (GRO) in Linux.
+//
+// Only IPv4 TCP segments without IP options, carrying data and no flags other
+// than ACK and PSH are coalesced. A segment is appended if it immediately
+// follows in sequence space and its IP and TCP headers match except for the
+// length, sequence number and checksums. As in Linux, all segments but the
+// last have the size of the first one, and a segment with PSH ends the chain.
+//
+// The TCP checksum of a coalesced packet is not updated, so GRO must only be
+// used together with CapabilityRXChecksumOffload.
+type groPacket struct {
+	pkt           stack.PacketBuffer
+	protocol      tcpip.NetworkProtocolNumber
+	remote, local tcpip.LinkAddress
+
+	// ip and tcp are the headers of pkt. They are nil if pkt can't be
+	// coalesced with.
+	ip  header.IPv4
+	tcp header.TCP
+
+	// segSize is the payload size of the first segment of pkt.
+	segSize int
+
+	// coalesced is set if any segments were appended to pkt.
+	coalesced bool
+
+	// closed is set if no more segments can be appended to pkt.
+	closed bool
+}
+
+// groHeaders returns the IPv4 and TCP headers of pkt, and the size of its
+// TCP payload, if pkt is a segment that can be coalesced.
+func groHeaders(protocol tcpip.NetworkProtocolNumber, pkt *stack.PacketBuffer) (header.IPv4, header.TCP, int, bool) {
+	if protocol != header.IPv4ProtocolNumber {
+		return nil, nil, 0, false
+	}
+	hdr, ok := pkt.Data.PullUp(header.IPv4MinimumSize + header.TCPMinimumSize)
+	if !ok {
+		return nil, nil, 0, false
+	}
+	ip := header.IPv4(hdr[:header.IPv4MinimumSize])
+	if !ip.IsValid(pkt.Data.Size()) ||
+		int(ip.HeaderLength()) != header.IPv4MinimumSize ||
+		int(ip.TotalLength()) != pkt.Data.Size() ||
+		ip.TransportProtocol() != header.TCPProtocolNumber ||
+		ip.Flags()&header.IPv4FlagMoreFragments != 0 ||
+		ip.FragmentOffset() != 0 {
+		return nil, nil, 0, false
+	}
+	tcpHdrLen := int(header.TCP(hdr[header.IPv4MinimumSize:]).DataOffset())
+	if tcpHdrLen < header.TCPMinimumSize {
+		return nil, nil, 0, false
+	}
+	hdr, ok = pkt.Data.PullUp(header.IPv4MinimumSize + tcpHdrLen)
+	if !ok {
+		return nil, nil, 0, false
+	}
+	ip = header.IPv4(hdr[:header.IPv4MinimumSize])
+	tcp := header.TCP(hdr[header.IPv4MinimumSize:])
+	if flags := tcp.Flags(); flags&header.TCPFlagAck == 0 || flags&^(header.TCPFlagAck|header.TCPFlagPsh) != 0 {
+		return nil, nil, 0, false
+	}
+	payload := pkt.Data.Size() - len(hdr)
+	if payload == 0 {
+		return nil, nil, 0, false
+	}
+	return ip, tcp, payload, true
+}
+
+// newGROPacket returns a groPacket holding pkt.
+func newGROPacket(remote, local tcpip.LinkAddress, protocol tcpip.NetworkProtocolNumber, pkt stack.PacketBuffer) groPacket {
+	g := groPacket{
+		pkt:      pkt,
+		protocol: protocol,
+		remote:   remote,
+		local:    local,
+	}
+	if ip, tcp, payload, ok := groHeaders(protocol, &g.pkt); ok {
+		g.ip = ip
+		g.tcp = tcp
+		g.segSize = payload
+		g.closed = tcp.Flags()&header.TCPFlagPsh != 0
+	}
+	return g
+}
+
+// merge appends the payload of pkt to g if pkt is the next segment of the same
+// flow. It returns false, leaving g unchanged, if pkt can't be coalesced.
+func (g *groPacket) merge(remote, local tcpip.LinkAddress, protocol tcpip.NetworkProtocolNumber, pkt *stack.PacketBuffer) bool {
+	if g.ip == nil || g.closed || remote != g.remote || local != g.local {
+		return false
+	}
+	ip, tcp, payload, ok := groHeaders(protocol, pkt)
+	if !ok {
+		return false
+	}
+	gTOS, _ := g.ip.TOS()
+	tos, _ := ip.TOS()
+	gPayload := g.pkt.Data.Size() - header.IPv4MinimumSize - len(g.tcp)
+	if ip.SourceAddress() != g.ip.SourceAddress() ||
+		ip.DestinationAddress() != g.ip.DestinationAddress() ||
+		ip.TTL() != g.ip.TTL() ||
+		tos != gTOS ||
+		tcp.SourcePort() != g.tcp.SourcePort() ||
+		tcp.DestinationPort() != g.tcp.DestinationPort() ||
+		tcp.AckNumber() != g.tcp.AckNumber() ||
+		tcp.WindowSize() != g.tcp.WindowSize() ||
+		!bytes.Equal(tcp.Options(), g.tcp.Options()) ||
+		tcp.SequenceNumber() != g.tcp.SequenceNumber()+uint32(gPayload) ||
+		payload > g.segSize ||
+		g.pkt.Data.Size()+payload > groMaxSize {
+		return false
+	}
+
+	flags := tcp.Flags()
+	pkt.Data.TrimFront(header.IPv4MinimumSize + len(tcp))
+	g.pkt.Data.Append(pkt.Data)
+	g.coalesced = true
+	if flags&header.TCPFlagPsh != 0 {
+		g.tcp.SetFlags(g.tcp.Flags() | header.TCPFlagPsh)
+		g.closed = true
+	}
+	if payload < g.segSize {
+		g.closed = true
+	}
+	return true
+}
+
+// deliver fixes up the IPv4 header of a coalesced packet and delivers it to
+// dispatcher.
+func (g *groPacket) deliver(dispatcher stack.NetworkDispatcher) {
+	if g.coalesced {
+		g.ip.SetTotalLength(uint16(g.pkt.Data.Size()))
+		g.ip.SetChecksum(0)
+		g.ip.SetChecksum(^g.ip.CalculateChecksum())
+	}
+	dispatcher.DeliverNetworkPacket(g.remote, g.local, g.protocol, g.pkt)
+}
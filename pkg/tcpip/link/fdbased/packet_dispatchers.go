@@ -262,13 +262,19 @@ func (d *recvMMsgDispatcher) dispatch() (bool, *tcpip.Error) {
 	if err != nil {
 		return false, err
 	}
-	// Process each of received packets.
+	// Process each of received packets. With GRO, a packet is held back in
+	// pending until it is known that the next one can't be coalesced into it.
+	var pending groPacket
+	havePending := false
 	for k := 0; k < nMsgs; k++ {
 		n := int(d.msgHdrs[k].Len)
 		if d.e.Capabilities()&stack.CapabilityHardwareGSO != 0 {
 			n -= virtioNetHdrSize
 		}
 		if n <= d.e.hdrSize {
+			if havePending {
+				pending.deliver(d.e.dispatcher)
+			}
 			return false, nil
 		}
 
@@ -291,6 +297,9 @@ func (d *recvMMsgDispatcher) dispatch() (bool, *tcpip.Error) {
 			case header.IPv6Version:
 				p = header.IPv6ProtocolNumber
 			default:
+				if havePending {
+					pending.deliver(d.e.dispatcher)
+				}
 				return true, nil
 			}
 		}
@@ -301,7 +310,17 @@ func (d *recvMMsgDispatcher) dispatch() (bool, *tcpip.Error) {
 			LinkHeader: buffer.View(eth),
 		}
 		pkt.Data.TrimFront(d.e.hdrSize)
-		d.e.dispatcher.DeliverNetworkPacket(remote, local, p, pkt)
+		switch {
+		case !d.e.gro:
+			d.e.dispatcher.DeliverNetworkPacket(remote, local, p, pkt)
+		case havePending && pending.merge(remote, local, p, &pkt):
+		default:
+			if havePending {
+				pending.deliver(d.e.dispatcher)
+			}
+			pending = newGROPacket(remote, local, p, pkt)
+			havePending = true
+		}
 
 		// Prepare e.views for another packet: release used views.
 		for i := 0; i < used; i++ {
@@ -309,6 +328,10 @@ func (d *recvMMsgDispatcher) dispatch() (bool, *tcpip.Error) {
 		}
 	}
 
+	if havePending {
+		pending.deliver(d.e.dispatcher)
+	}
+
 	for k := 0; k < nMsgs; k++ {
 		d.msgHdrs[k].Len = 0
 	}
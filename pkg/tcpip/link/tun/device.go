@@ -85,10 +85,12 @@ func (d *Device) SetIff(s *stack.Stack, name string, flags uint16) error {
 		return syserror.EINVAL
 	}
 
-	// Input validations.
+	// Input validations. IFF_MULTI_QUEUE needs no special handling: all
+	// Devices attached to a NIC already share its queue of outbound packets,
+	// and each read takes the next one.
 	isTun := flags&linux.IFF_TUN != 0
 	isTap := flags&linux.IFF_TAP != 0
-	supportedFlags := uint16(linux.IFF_TUN | linux.IFF_TAP | linux.IFF_NO_PI)
+	supportedFlags := uint16(linux.IFF_TUN | linux.IFF_TAP | linux.IFF_NO_PI | linux.IFF_MULTI_QUEUE | linux.IFF_VNET_HDR)
 	if isTap && isTun || !isTap && !isTun || flags&^supportedFlags != 0 {
 		return syserror.EINVAL
 	}
@@ -184,6 +186,18 @@ func (d *Device) Write(data []byte) (int64, error) {
 		data = data[PacketInfoHeaderSize:]
 	}
 
+	// Virtio net header. Packets are injected one at a time, so GSO packets
+	// aren't supported.
+	if d.hasFlags(linux.IFF_VNET_HDR) {
+		if len(data) < VirtioNetHeaderSize {
+			return 0, syserror.EINVAL
+		}
+		if VirtioNetHeader(data[:VirtioNetHeaderSize]).GSOType() != VirtioNetHeaderGSONone {
+			return 0, syserror.EINVAL
+		}
+		data = data[VirtioNetHeaderSize:]
+	}
+
 	// Ethernet header (TAP only).
 	var ethHdr header.Ethernet
 	if d.hasFlags(linux.IFF_TAP) {
@@ -260,6 +274,12 @@ func (d *Device) encodePkt(info *channel.PacketInfo) (buffer.View, bool) {
 		vv.AppendView(buffer.View(hdr))
 	}
 
+	// Virtio net header. Outgoing packets are never GSO packets and their
+	// checksums are complete, so the header is all zeros.
+	if d.hasFlags(linux.IFF_VNET_HDR) {
+		vv.AppendView(buffer.NewView(VirtioNetHeaderSize))
+	}
+
 	// If the packet does not already have link layer header, and the route
 	// does not exist, we can't compute it. This is possibly a raw packet, tun
 	// device doesn't support this at the moment.
@@ -26,6 +26,16 @@ const (
 
 	offsetFlags    = 0
 	offsetProtocol = 2
+
+	// VirtioNetHeaderSize is the size of the virtio_net_hdr sent if the
+	// IFF_VNET_HDR flag is set.
+	VirtioNetHeaderSize = 10
+
+	offsetGSOType = 1
+
+	// VirtioNetHeaderGSONone is the virtio_net_hdr GSO type of a packet that
+	// is not a GSO packet.
+	VirtioNetHeaderGSONone = 0
 )
 
 // PacketInfoFields contains fields sent through the wire if IFF_NO_PI flag is
@@ -54,3 +64,12 @@ func (h PacketInfoHeader) Flags() uint16 {
 func (h PacketInfoHeader) Protocol() tcpip.NetworkProtocolNumber {
 	return tcpip.NetworkProtocolNumber(binary.BigEndian.Uint16(h[offsetProtocol:]))
 }
+
+// VirtioNetHeader is the wire representation of the virtio_net_hdr sent if the
+// IFF_VNET_HDR flag is set. See include/uapi/linux/virtio_net.h.
+type VirtioNetHeader []byte
+
+// GSOType returns the gso_type field in h.
+func (h VirtioNetHeader) GSOType() uint8 {
+	return h[offsetGSOType]
+}
@@ -32,6 +32,10 @@ const (
 	// Netstack.
 	numEphemeralPorts = math.MaxUint16 - FirstEphemeral + 1
 
+	// numHints is the number of entries in PortManager.hints. It must be a
+	// power of 2.
+	numHints = 256
+
 	anyIPAddress tcpip.Address = ""
 )
 
@@ -70,12 +74,17 @@ type PortManager struct {
 	mu             sync.RWMutex
 	allocatedPorts map[portDescriptor]bindAddresses
 
-	// hint is used to pick ports ephemeral ports in a stable order for
-	// a given port offset.
+	// hints is used to pick ephemeral ports in a stable order for a given
+	// port offset, as in RFC 6056 section 3.3.4 (Algorithm 4). Each offset
+	// maps to one entry, which is advanced past every port probed by
+	// PickEphemeralPortStable, so that successive picks for the same offset
+	// resume where the last one left off instead of probing the same
+	// (already allocated) ports again. Offsets that map to different entries
+	// don't perturb each other.
 	//
-	// hint must be accessed using the portHint/incPortHint helpers.
+	// hints must be accessed using the portHint/addPortHint helpers.
 	// TODO(gvisor.dev/issue/940): S/R this field.
-	hint uint32
+	hints [numHints]uint32
 }
 
 type reuseFlag int
@@ -231,50 +240,65 @@ func NewPortManager() *PortManager {
 // occurs.
 func (s *PortManager) PickEphemeralPort(testPort func(p uint16) (bool, *tcpip.Error)) (port uint16, err *tcpip.Error) {
 	offset := uint32(rand.Int31n(numEphemeralPorts))
-	return s.pickEphemeralPort(offset, numEphemeralPorts, testPort)
+	port, _, err = s.pickEphemeralPort(offset, numEphemeralPorts, testPort)
+	return port, err
+}
+
+// hintIndex returns the index into s.hints used for the given port offset.
+func hintIndex(offset uint32) uint32 {
+	// Use the high bits of offset, which are unrelated to the starting port
+	// offset % numEphemeralPorts.
+	return (offset >> 24) % numHints
 }
 
-// portHint atomically reads and returns the s.hint value.
-func (s *PortManager) portHint() uint32 {
-	return atomic.LoadUint32(&s.hint)
+// portHint atomically reads and returns the hint for the given port offset.
+func (s *PortManager) portHint(offset uint32) uint32 {
+	return atomic.LoadUint32(&s.hints[hintIndex(offset)])
 }
 
-// incPortHint atomically increments s.hint by 1.
-func (s *PortManager) incPortHint() {
-	atomic.AddUint32(&s.hint, 1)
+// addPortHint atomically advances the hint for the given port offset by n.
+func (s *PortManager) addPortHint(offset, n uint32) {
+	atomic.AddUint32(&s.hints[hintIndex(offset)], n)
 }
 
-// PickEphemeralPortStable starts at the specified offset + s.portHint and
-// iterates over all ephemeral ports, allowing the caller to decide whether a
-// given port is suitable for its needs and stopping when a port is found or an
-// error occurs.
+// PickEphemeralPortStable starts at the specified offset + s.portHint(offset)
+// and iterates over all ephemeral ports, allowing the caller to decide whether
+// a given port is suitable for its needs and stopping when a port is found or
+// an error occurs.
+//
+// On success, the hint for offset is advanced past every port that was probed,
+// so a subsequent call with the same offset starts probing at the port after
+// the one returned. Callers that repeatedly pick ports for the same offset,
+// e.g. clients making many connections to the same server, therefore probe
+// O(1) ports per call while ports are released in roughly the order they were
+// picked, rather than re-probing every port already in use.
 func (s *PortManager) PickEphemeralPortStable(offset uint32, testPort func(p uint16) (bool, *tcpip.Error)) (port uint16, err *tcpip.Error) {
-	p, err := s.pickEphemeralPort(s.portHint()+offset, numEphemeralPorts, testPort)
+	p, probes, err := s.pickEphemeralPort(s.portHint(offset)+offset, numEphemeralPorts, testPort)
 	if err == nil {
-		s.incPortHint()
+		s.addPortHint(offset, probes)
 	}
 	return p, err
-
 }
 
 // pickEphemeralPort starts at the offset specified from the FirstEphemeral port
 // and iterates over the number of ports specified by count and allows the
 // caller to decide whether a given port is suitable for its needs, and stopping
-// when a port is found or an error occurs.
-func (s *PortManager) pickEphemeralPort(offset, count uint32, testPort func(p uint16) (bool, *tcpip.Error)) (port uint16, err *tcpip.Error) {
+// when a port is found or an error occurs. It also returns the number of ports
+// that were probed.
+func (s *PortManager) pickEphemeralPort(offset, count uint32, testPort func(p uint16) (bool, *tcpip.Error)) (port uint16, probes uint32, err *tcpip.Error) {
 	for i := uint32(0); i < count; i++ {
 		port = uint16(FirstEphemeral + (offset+i)%count)
 		ok, err := testPort(port)
 		if err != nil {
-			return 0, err
+			return 0, i + 1, err
 		}
 
 		if ok {
-			return port, nil
+			return port, i + 1, nil
 		}
 	}
 
-	return 0, tcpip.ErrNoPortAvailable
+	return 0, count, tcpip.ErrNoPortAvailable
 }
 
 // IsPortAvailable tests if the given port is available on all given protocols.
@@ -400,3 +400,64 @@ func TestPickEphemeralPortStable(t *testing.T) {
 		})
 	}
 }
+
+func TestPickEphemeralPortStableAdvancesHint(t *testing.T) {
+	pm := NewPortManager()
+	portOffset := uint32(rand.Int31n(int32(numEphemeralPorts)))
+	used := make(map[uint16]struct{})
+	for i := 0; i < 1000; i++ {
+		probes := 0
+		port, err := pm.PickEphemeralPortStable(portOffset, func(port uint16) (bool, *tcpip.Error) {
+			probes++
+			if _, ok := used[port]; ok {
+				return false, nil
+			}
+			used[port] = struct{}{}
+			return true, nil
+		})
+		if err != nil {
+			t.Fatalf("PickEphemeralPortStable(%d, _) #%d failed: %v", portOffset, i, err)
+		}
+		// Every port picked so far for this offset should be skipped
+		// without being probed.
+		if probes != 1 {
+			t.Errorf("PickEphemeralPortStable(%d, _) #%d = %d probed %d ports; want 1", portOffset, i, port, probes)
+		}
+	}
+}
+
+// BenchmarkPickEphemeralPortStable measures the cost of picking ports for
+// connections to a single destination while 90% of the ephemeral port range
+// is in use, as for a client that opens and closes connections at a high rate.
+func BenchmarkPickEphemeralPortStable(b *testing.B) {
+	pm := NewPortManager()
+	networks := []tcpip.NetworkProtocolNumber{fakeNetworkNumber}
+	portOffset := uint32(rand.Int31n(int32(numEphemeralPorts)))
+	reserve := func(port uint16) (bool, *tcpip.Error) {
+		if _, err := pm.ReservePort(networks, fakeTransNumber, fakeIPAddress, port, Flags{}, 0 /* bindToDevice */); err != nil {
+			return false, nil
+		}
+		return true, nil
+	}
+
+	// Ports are released in the order they were picked, as connections
+	// with similar lifetimes are.
+	var inUse []uint16
+	for len(inUse) < numEphemeralPorts*9/10 {
+		port, err := pm.PickEphemeralPortStable(portOffset, reserve)
+		if err != nil {
+			b.Fatalf("PickEphemeralPortStable(%d, _) failed: %v", portOffset, err)
+		}
+		inUse = append(inUse, port)
+	}
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		port, err := pm.PickEphemeralPortStable(portOffset, reserve)
+		if err != nil {
+			b.Fatalf("PickEphemeralPortStable(%d, _) failed: %v", portOffset, err)
+		}
+		pm.ReleasePort(networks, fakeTransNumber, fakeIPAddress, inUse[0], Flags{}, 0 /* bindToDevice */)
+		inUse = append(inUse[1:], port)
+	}
+}
@@ -16,6 +16,7 @@ package stack
 
 import (
 	"fmt"
+	"sort"
 
 	"gvisor.dev/gvisor/pkg/tcpip"
 	"gvisor.dev/gvisor/pkg/tcpip/header"
@@ -252,9 +253,20 @@ func (it *IPTables) CheckPackets(hook Hook, pkts PacketBufferList, gso *GSO, r *
 // TODO(gvisor.dev/issue/170): pkt.NetworkHeader will always be set as a
 // precondition.
 func (it *IPTables) checkChain(hook Hook, pkt *PacketBuffer, table Table, ruleIdx int, gso *GSO, r *Route, address tcpip.Address, nicName string) chainVerdict {
+	var dst tcpip.Address
+	if table.dstRunOf != nil {
+		dst = ipv4Header(pkt).DestinationAddress()
+	}
+
 	// Start from ruleIdx and walk the list of rules until a rule gives us
 	// a verdict.
 	for ruleIdx < len(table.Rules) {
+		// Skip rules that can't match the packet's destination.
+		if next := table.nextCandidate(ruleIdx, dst); next != ruleIdx {
+			ruleIdx = next
+			continue
+		}
+
 		switch verdict, jumpTo := it.checkRule(hook, pkt, table, ruleIdx, gso, r, address, nicName); verdict {
 		case RuleAccept:
 			return chainAccept
@@ -301,19 +313,8 @@ func (it *IPTables) checkChain(hook Hook, pkt *PacketBuffer, table Table, ruleId
 func (it *IPTables) checkRule(hook Hook, pkt *PacketBuffer, table Table, ruleIdx int, gso *GSO, r *Route, address tcpip.Address, nicName string) (RuleVerdict, int) {
 	rule := table.Rules[ruleIdx]
 
-	// If pkt.NetworkHeader hasn't been set yet, it will be contained in
-	// pkt.Data.
-	if pkt.NetworkHeader == nil {
-		var ok bool
-		pkt.NetworkHeader, ok = pkt.Data.PullUp(header.IPv4MinimumSize)
-		if !ok {
-			// Precondition has been violated.
-			panic(fmt.Sprintf("iptables checks require IPv4 headers of at least %d bytes", header.IPv4MinimumSize))
-		}
-	}
-
 	// Check whether the packet matches the IP header filter.
-	if !rule.Filter.match(header.IPv4(pkt.NetworkHeader), hook, nicName) {
+	if !rule.Filter.match(ipv4Header(pkt), hook, nicName) {
 		// Continue on to the next rule.
 		return RuleJump, ruleIdx + 1
 	}
@@ -334,3 +335,86 @@ func (it *IPTables) checkRule(hook Hook, pkt *PacketBuffer, table Table, ruleIdx
 	// All the matchers matched, so run the target.
 	return rule.Target.Action(pkt, &it.connections, hook, gso, r, address)
 }
+
+// ipv4Header returns the IPv4 header of pkt.
+//
+// Precondition: pkt is a IPv4 packet of at least length header.IPv4MinimumSize.
+func ipv4Header(pkt *PacketBuffer) header.IPv4 {
+	// If pkt.NetworkHeader hasn't been set yet, it will be contained in
+	// pkt.Data.
+	if pkt.NetworkHeader == nil {
+		var ok bool
+		pkt.NetworkHeader, ok = pkt.Data.PullUp(header.IPv4MinimumSize)
+		if !ok {
+			// Precondition has been violated.
+			panic(fmt.Sprintf("iptables checks require IPv4 headers of at least %d bytes", header.IPv4MinimumSize))
+		}
+	}
+	return header.IPv4(pkt.NetworkHeader)
+}
+
+// minDstRun is the minimum length of a run of rules indexed by indexRules.
+// Shorter runs are as cheap to walk as to look up.
+const minDstRun = 8
+
+// A dstRun is a run of consecutive rules whose filters each match packets to
+// a single destination address, such as the per-service rules installed by
+// kube-proxy. A packet can only match the rules of the run for its own
+// destination, so all others can be skipped without evaluating them.
+type dstRun struct {
+	// end is the index of the first rule after the run.
+	end int
+
+	// rules maps each destination address to the ascending indices of the
+	// rules in the run that match it.
+	rules map[tcpip.Address][]int
+}
+
+// indexRules builds the index of runs of single destination rules used by
+// nextCandidate. It must be called whenever table.Rules changes.
+func (table *Table) indexRules() {
+	table.dstRuns = nil
+	table.dstRunOf = nil
+	for start := 0; start < len(table.Rules); {
+		end := start
+		for end < len(table.Rules) && table.Rules[end].Filter.singleDst() {
+			end++
+		}
+		if end-start >= minDstRun {
+			if table.dstRunOf == nil {
+				table.dstRunOf = make([]int, len(table.Rules))
+				for i := range table.dstRunOf {
+					table.dstRunOf[i] = -1
+				}
+			}
+			run := dstRun{
+				end:   end,
+				rules: make(map[tcpip.Address][]int),
+			}
+			for i := start; i < end; i++ {
+				dst := table.Rules[i].Filter.Dst
+				run.rules[dst] = append(run.rules[dst], i)
+				table.dstRunOf[i] = len(table.dstRuns)
+			}
+			table.dstRuns = append(table.dstRuns, run)
+		}
+		if end == start {
+			end++
+		}
+		start = end
+	}
+}
+
+// nextCandidate returns the index of the first rule at or after ruleIdx that
+// may match a packet with destination address dst.
+func (table *Table) nextCandidate(ruleIdx int, dst tcpip.Address) int {
+	if table.dstRunOf == nil || ruleIdx >= len(table.dstRunOf) || table.dstRunOf[ruleIdx] < 0 {
+		return ruleIdx
+	}
+	run := &table.dstRuns[table.dstRunOf[ruleIdx]]
+	rules := run.rules[dst]
+	if i := sort.SearchInts(rules, ruleIdx); i < len(rules) {
+		return rules[i]
+	}
+	return run.end
+}
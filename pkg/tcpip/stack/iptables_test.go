@@ -0,0 +1,99 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package stack
+
+import (
+	"testing"
+
+	"gvisor.dev/gvisor/pkg/tcpip"
+	"gvisor.dev/gvisor/pkg/tcpip/buffer"
+	"gvisor.dev/gvisor/pkg/tcpip/header"
+)
+
+// dstRules returns n rules dropping packets to 10.0.0.0 through 10.0.0.n-1,
+// followed by a rule accepting all packets.
+func dstRules(n int) Table {
+	var table Table
+	for i := 0; i < n; i++ {
+		table.Rules = append(table.Rules, Rule{
+			Filter: IPHeaderFilter{
+				Dst:     tcpip.Address([]byte{10, 0, 0, byte(i)}),
+				DstMask: "\xff\xff\xff\xff",
+			},
+			Target: DropTarget{},
+		})
+	}
+	table.Rules = append(table.Rules, Rule{Target: AcceptTarget{}})
+	return table
+}
+
+func ipv4Packet(dst tcpip.Address) *PacketBuffer {
+	hdr := buffer.NewView(header.IPv4MinimumSize)
+	header.IPv4(hdr).Encode(&header.IPv4Fields{
+		IHL:         header.IPv4MinimumSize,
+		TotalLength: header.IPv4MinimumSize,
+		TTL:         64,
+		Protocol:    uint8(header.UDPProtocolNumber),
+		SrcAddr:     "\x0a\x00\x01\x01",
+		DstAddr:     dst,
+	})
+	return &PacketBuffer{NetworkHeader: hdr}
+}
+
+func TestIndexRulesShortRun(t *testing.T) {
+	table := dstRules(minDstRun - 1)
+	table.indexRules()
+	if table.dstRunOf != nil {
+		t.Errorf("got dstRunOf = %v for a run of %d rules, want nil", table.dstRunOf, minDstRun-1)
+	}
+}
+
+func TestNextCandidate(t *testing.T) {
+	const n = 16
+	table := dstRules(n)
+	table.indexRules()
+
+	for _, tc := range []struct {
+		name    string
+		ruleIdx int
+		dst     tcpip.Address
+		want    int
+	}{
+		{"start of run", 0, "\x0a\x00\x00\x05", 5},
+		{"at matching rule", 5, "\x0a\x00\x00\x05", 5},
+		{"past matching rule", 6, "\x0a\x00\x00\x05", n},
+		{"no matching rule", 0, "\x0a\x00\x00\x63", n},
+		{"after run", n, "\x0a\x00\x00\x05", n},
+	} {
+		t.Run(tc.name, func(t *testing.T) {
+			if got := table.nextCandidate(tc.ruleIdx, tc.dst); got != tc.want {
+				t.Errorf("got nextCandidate(%d, %s) = %d, want = %d", tc.ruleIdx, tc.dst, got, tc.want)
+			}
+		})
+	}
+}
+
+func TestCheckChainIndexed(t *testing.T) {
+	table := dstRules(64)
+	table.indexRules()
+	var it IPTables
+
+	if got := it.checkChain(Output, ipv4Packet("\x0a\x00\x00\x2a"), table, 0, nil, nil, "", ""); got != chainDrop {
+		t.Errorf("got checkChain(10.0.0.42) = %d, want = %d", got, chainDrop)
+	}
+	if got := it.checkChain(Output, ipv4Packet("\x0a\x00\x01\x2a"), table, 0, nil, nil, "", ""); got != chainAccept {
+		t.Errorf("got checkChain(10.0.1.42) = %d, want = %d", got, chainAccept)
+	}
+}
@@ -109,6 +109,12 @@ type Table struct {
 	// Metadata holds information about the Table that is useful to users
 	// of IPTables, but not to the netstack IPTables code itself.
 	metadata interface{}
+
+	// dstRuns holds the runs of single destination rules in Rules, and
+	// dstRunOf maps each rule to the index of its run in dstRuns, or -1. Both
+	// are nil if Rules has no such runs. They are built by indexRules.
+	dstRuns  []dstRun
+	dstRunOf []int
 }
 
 // ValidHooks returns a bitmap of the builtin hooks for the given table.
@@ -223,6 +229,20 @@ func (fl IPHeaderFilter) match(hdr header.IPv4, hook Hook, nicName string) bool
 	return true
 }
 
+// singleDst returns whether the filter only matches packets to the single
+// destination address fl.Dst.
+func (fl IPHeaderFilter) singleDst() bool {
+	if fl.DstInvert || len(fl.Dst) == 0 || len(fl.DstMask) != len(fl.Dst) {
+		return false
+	}
+	for i := range fl.DstMask {
+		if fl.DstMask[i] != 0xff {
+			return false
+		}
+	}
+	return true
+}
+
 // filterAddress returns whether addr matches the filter.
 func filterAddress(addr, mask, filterAddr tcpip.Address, invert bool) bool {
 	matches := true
@@ -86,3 +86,32 @@ func (pk PacketBuffer) Clone() PacketBuffer {
 	pk.Data = pk.Data.Clone(nil)
 	return pk
 }
+
+// packetCloner hands out clones of a packet that is delivered to several
+// endpoints, e.g. a multicast datagram. Like Clone, the clones share the
+// packet's bytes; in addition, their Data views are carved out of a single
+// allocation, so that fanning a packet out to n endpoints costs one
+// allocation rather than n.
+type packetCloner struct {
+	pkt   PacketBuffer
+	views []buffer.View
+}
+
+// newPacketCloner returns a packetCloner that can make n clones of pkt.
+func newPacketCloner(pkt PacketBuffer, n int) packetCloner {
+	return packetCloner{
+		pkt:   pkt,
+		views: make([]buffer.View, n*len(pkt.Data.Views())),
+	}
+}
+
+// clone returns the next clone of the packet.
+func (c *packetCloner) clone() PacketBuffer {
+	pk := c.pkt
+	n := len(pk.Data.Views())
+	// Cap each clone's views so that appending to one clone can't clobber
+	// the next.
+	pk.Data = c.pkt.Data.Clone(c.views[:n:n])
+	c.views = c.views[n:]
+	return pk
+}
@@ -1750,6 +1750,15 @@ func (s *Stack) IPTables() IPTables {
 
 // SetIPTables sets the stack's iptables.
 func (s *Stack) SetIPTables(ipt IPTables) {
+	// Index the rules of each table in a new map, as ipt.Tables may be
+	// shared with the tables currently in use.
+	tables := make(map[string]Table, len(ipt.Tables))
+	for name, table := range ipt.Tables {
+		table.indexRules()
+		tables[name] = table
+	}
+	ipt.Tables = tables
+
 	s.tablesMu.Lock()
 	s.tables = ipt
 	s.tablesMu.Unlock()
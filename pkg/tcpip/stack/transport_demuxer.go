@@ -172,14 +172,18 @@ func (epsByNIC *endpointsByNIC) handlePacket(r *Route, id TransportEndpointID, p
 	}
 	// multiPortEndpoints are guaranteed to have at least one element.
 	transEP := selectEndpoint(id, mpep, epsByNIC.seed)
-	if queuedProtocol, mustQueue := mpep.demux.queuedProtocols[protocolIDs{mpep.netProto, mpep.transProto}]; mustQueue {
+	queuedProtocol, mustQueue := mpep.demux.queuedProtocols[protocolIDs{mpep.netProto, mpep.transProto}]
+	// Release the lock before delivering the packet, as findTransportEndpoint
+	// does. With SO_REUSEPORT, packets for every endpoint in mpep pass through
+	// epsByNIC.mu; holding it across delivery lets a pending bind or close of
+	// any one of them stall delivery to all of them.
+	epsByNIC.mu.RUnlock() // Don't use defer for performance reasons.
+
+	if mustQueue {
 		queuedProtocol.QueuePacket(r, transEP, id, pkt)
-		epsByNIC.mu.RUnlock()
 		return
 	}
-
 	transEP.HandlePacket(r, id, pkt)
-	epsByNIC.mu.RUnlock() // Don't use defer for performance reasons.
 }
 
 // HandleControlPacket implements stack.TransportEndpoint.HandleControlPacket.
@@ -384,11 +388,12 @@ func (ep *multiPortEndpoint) handlePacketAll(r *Route, id TransportEndpointID, p
 	queuedProtocol, mustQueue := ep.demux.queuedProtocols[protocolIDs{ep.netProto, ep.transProto}]
 	// HandlePacket takes ownership of pkt, so each endpoint needs
 	// its own copy except for the final one.
+	cloner := newPacketCloner(pkt, len(ep.endpoints)-1)
 	for _, endpoint := range ep.endpoints[:len(ep.endpoints)-1] {
 		if mustQueue {
-			queuedProtocol.QueuePacket(r, endpoint, id, pkt.Clone())
+			queuedProtocol.QueuePacket(r, endpoint, id, cloner.clone())
 		} else {
-			endpoint.HandlePacket(r, id, pkt.Clone())
+			endpoint.HandlePacket(r, id, cloner.clone())
 		}
 	}
 	if endpoint := ep.endpoints[len(ep.endpoints)-1]; mustQueue {
@@ -489,8 +494,9 @@ func (d *transportDemuxer) deliverPacket(r *Route, protocol tcpip.TransportProto
 		}
 		// handlePacket takes ownership of pkt, so each endpoint needs its own
 		// copy except for the final one.
+		cloner := newPacketCloner(pkt, len(destEPs)-1)
 		for _, ep := range destEPs[:len(destEPs)-1] {
-			ep.handlePacket(r, id, pkt.Clone())
+			ep.handlePacket(r, id, cloner.clone())
 		}
 		destEPs[len(destEPs)-1].handlePacket(r, id, pkt)
 		return true
@@ -700,6 +700,12 @@ const (
 	//
 	// NOTE: This option is currently only stubed out and is a no-op
 	TCPWindowClampOption
+
+	// TCPNotsentLowatOption is used by SetSockOpt/GetSockOpt to limit the
+	// number of bytes written to a TCP endpoint that have not been sent
+	// yet. The endpoint is only writable while fewer bytes are unsent. A
+	// zero value disables the limit.
+	TCPNotsentLowatOption
 )
 
 // ErrorOption is used in GetSockOpt to specify that the last error reported by
@@ -809,6 +815,22 @@ type RemoveMembershipOption MembershipOption
 // TCP out-of-band data is delivered along with the normal in-band data.
 type OutOfBandInlineOption int
 
+// SocketFilter decides which packets received by an endpoint are queued for
+// reading, as a BPF program attached with SO_ATTACH_FILTER does.
+type SocketFilter interface {
+	// Filter returns the number of leading bytes of pkt to queue, or 0 if
+	// the packet should be dropped. pkt holds the packet as it would be
+	// read from the endpoint, and must not be modified.
+	Filter(pkt buffer.VectorisedView) int
+}
+
+// SocketFilterOption is used by SetSockOpt/GetSockOpt to attach, detach or
+// query the SocketFilter of a packet or raw endpoint. Setting a nil Filter
+// detaches the current filter, and fails with ErrNoSuchFile if there is none.
+type SocketFilterOption struct {
+	Filter SocketFilter
+}
+
 // DefaultTTLOption is used by stack.(*Stack).NetworkProtocolOption to specify
 // a default TTL.
 type DefaultTTLOption uint8
@@ -70,6 +70,9 @@ type endpoint struct {
 	rcvBufSize    int
 	rcvClosed     bool
 
+	// filter is the filter attached with SO_ATTACH_FILTER, or nil.
+	filter tcpip.SocketFilter
+
 	// The following fields are protected by mu.
 	mu         sync.RWMutex `state:"nosave"`
 	sndBufSize int
@@ -265,11 +268,21 @@ func (ep *endpoint) Readiness(mask waiter.EventMask) waiter.EventMask {
 	return result
 }
 
-// SetSockOpt implements tcpip.Endpoint.SetSockOpt. Packet sockets cannot be
-// used with SetSockOpt, and this function always returns
-// tcpip.ErrNotSupported.
+// SetSockOpt implements tcpip.Endpoint.SetSockOpt.
 func (ep *endpoint) SetSockOpt(opt interface{}) *tcpip.Error {
-	return tcpip.ErrUnknownProtocolOption
+	switch v := opt.(type) {
+	case tcpip.SocketFilterOption:
+		ep.rcvMu.Lock()
+		defer ep.rcvMu.Unlock()
+		if v.Filter == nil && ep.filter == nil {
+			return tcpip.ErrNoSuchFile
+		}
+		ep.filter = v.Filter
+		return nil
+
+	default:
+		return tcpip.ErrUnknownProtocolOption
+	}
 }
 
 // SetSockOptBool implements tcpip.Endpoint.SetSockOptBool.
@@ -284,7 +297,16 @@ func (ep *endpoint) SetSockOptInt(opt tcpip.SockOptInt, v int) *tcpip.Error {
 
 // GetSockOpt implements tcpip.Endpoint.GetSockOpt.
 func (ep *endpoint) GetSockOpt(opt interface{}) *tcpip.Error {
-	return tcpip.ErrNotSupported
+	switch v := opt.(type) {
+	case *tcpip.SocketFilterOption:
+		ep.rcvMu.Lock()
+		v.Filter = ep.filter
+		ep.rcvMu.Unlock()
+		return nil
+
+	default:
+		return tcpip.ErrNotSupported
+	}
 }
 
 // GetSockOptBool implements tcpip.Endpoint.GetSockOptBool.
@@ -361,6 +383,22 @@ func (ep *endpoint) HandlePacket(nicID tcpip.NICID, localAddr tcpip.LinkAddress,
 		combinedVV.Append(pkt.Data)
 		packet.data = combinedVV
 	}
+
+	if ep.filter != nil {
+		n := ep.filter.Filter(packet.data)
+		if n <= 0 {
+			ep.rcvMu.Unlock()
+			return
+		}
+		if n < packet.data.Size() {
+			// packet.data shares its views with pkt.Data, which
+			// may be delivered to other endpoints, so truncate a
+			// copy.
+			packet.data = packet.data.Clone(nil)
+			packet.data.CapLength(n)
+		}
+	}
+
 	packet.timestampNS = ep.stack.NowNanoseconds()
 
 	ep.rcvList.PushBack(&packet)
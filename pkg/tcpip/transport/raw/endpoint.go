@@ -70,6 +70,11 @@ type endpoint struct {
 	rcvBufSize    int
 	rcvClosed     bool
 
+	// filter is the filter attached with SO_ATTACH_FILTER, or nil. It is
+	// protected by rcvMu rather than mu, since packets may be delivered
+	// while mu is held by Write.
+	filter tcpip.SocketFilter
+
 	// The following fields are protected by mu.
 	mu         sync.RWMutex `state:"nosave"`
 	sndBufSize int
@@ -518,7 +523,19 @@ func (e *endpoint) Readiness(mask waiter.EventMask) waiter.EventMask {
 
 // SetSockOpt implements tcpip.Endpoint.SetSockOpt.
 func (e *endpoint) SetSockOpt(opt interface{}) *tcpip.Error {
-	return tcpip.ErrUnknownProtocolOption
+	switch v := opt.(type) {
+	case tcpip.SocketFilterOption:
+		e.rcvMu.Lock()
+		defer e.rcvMu.Unlock()
+		if v.Filter == nil && e.filter == nil {
+			return tcpip.ErrNoSuchFile
+		}
+		e.filter = v.Filter
+		return nil
+
+	default:
+		return tcpip.ErrUnknownProtocolOption
+	}
 }
 
 // SetSockOptBool implements tcpip.Endpoint.SetSockOptBool.
@@ -533,10 +550,16 @@ func (e *endpoint) SetSockOptInt(opt tcpip.SockOptInt, v int) *tcpip.Error {
 
 // GetSockOpt implements tcpip.Endpoint.GetSockOpt.
 func (e *endpoint) GetSockOpt(opt interface{}) *tcpip.Error {
-	switch opt.(type) {
+	switch v := opt.(type) {
 	case tcpip.ErrorOption:
 		return nil
 
+	case *tcpip.SocketFilterOption:
+		e.rcvMu.Lock()
+		v.Filter = e.filter
+		e.rcvMu.Unlock()
+		return nil
+
 	default:
 		return tcpip.ErrUnknownProtocolOption
 	}
@@ -636,6 +659,22 @@ func (e *endpoint) HandlePacket(route *stack.Route, pkt stack.PacketBuffer) {
 	combinedVV := networkHeader.ToVectorisedView()
 	combinedVV.Append(pkt.Data)
 	packet.data = combinedVV
+
+	if e.filter != nil {
+		n := e.filter.Filter(packet.data)
+		if n <= 0 {
+			e.rcvMu.Unlock()
+			return
+		}
+		if n < packet.data.Size() {
+			// packet.data shares its views with pkt.Data, which
+			// may be delivered to other endpoints, so truncate a
+			// copy.
+			packet.data = packet.data.Clone(nil)
+			packet.data.CapLength(n)
+		}
+	}
+
 	packet.timestampNS = e.stack.NowNanoseconds()
 
 	e.rcvList.PushBack(packet)
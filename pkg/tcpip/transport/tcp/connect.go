@@ -1311,6 +1311,7 @@ func (e *endpoint) protocolMainLoop(handshake bool, wakerInitDone chan<- struct{
 
 		if e.snd != nil {
 			e.snd.resendTimer.cleanup()
+			e.snd.probeTimer.cleanup()
 		}
 
 		if closeTimer != nil {
@@ -1398,6 +1399,10 @@ func (e *endpoint) protocolMainLoop(handshake bool, wakerInitDone chan<- struct{
 				return nil
 			},
 		},
+		{
+			w: &e.snd.probeWaker,
+			f: e.snd.probeTimerExpired,
+		},
 		{
 			w: &e.newSegmentWaker,
 			f: func() *tcpip.Error {
@@ -15,6 +15,8 @@
 package tcp
 
 import (
+	"sync/atomic"
+
 	"gvisor.dev/gvisor/pkg/rand"
 	"gvisor.dev/gvisor/pkg/sleep"
 	"gvisor.dev/gvisor/pkg/sync"
@@ -161,6 +163,11 @@ func (p *processor) handleSegments() {
 type dispatcher struct {
 	processors []*processor
 	seed       uint32
+
+	// loopbackInline is non-zero if segments received over loopback may be
+	// processed inline by queuePacket. It is accessed using atomic memory
+	// operations.
+	loopbackInline uint32
 }
 
 func newDispatcher(nProcessors int) *dispatcher {
@@ -186,6 +193,18 @@ func (d *dispatcher) wait() {
 	}
 }
 
+func (d *dispatcher) setLoopbackInline(enabled bool) {
+	var v uint32
+	if enabled {
+		v = 1
+	}
+	atomic.StoreUint32(&d.loopbackInline, v)
+}
+
+func (d *dispatcher) loopbackInlineEnabled() bool {
+	return atomic.LoadUint32(&d.loopbackInline) != 0
+}
+
 func (d *dispatcher) queuePacket(r *stack.Route, stackEP stack.TransportEndpoint, id stack.TransportEndpointID, pkt stack.PacketBuffer) {
 	ep := stackEP.(*endpoint)
 	s := newSegment(r, id, pkt)
@@ -223,6 +242,29 @@ func (d *dispatcher) queuePacket(r *stack.Route, stackEP stack.TransportEndpoint
 		return
 	}
 
+	// A segment received over loopback was sent by another endpoint in
+	// this stack, on this goroutine, so processing it here (as a processor
+	// goroutine would) saves a goroutine handoff per segment. If the
+	// receiving endpoint is locked, e.g. by its user or because it is
+	// the endpoint whose processing sent this segment, let a processor
+	// handle it instead.
+	if r.Capabilities()&stack.CapabilityLoopback != 0 && d.loopbackInlineEnabled() && ep.mu.TryLock() {
+		if err := ep.handleSegments(true /* fastPath */); err != nil || ep.EndpointState() == StateClose {
+			// Send any active resets if required.
+			if err != nil {
+				ep.resetConnectionLocked(err)
+			}
+			ep.notifyProtocolGoroutine(notifyTickleWorker)
+			ep.mu.Unlock()
+			return
+		}
+		if !ep.segmentQueue.empty() {
+			d.selectProcessor(id).queueEndpoint(ep)
+		}
+		ep.mu.Unlock()
+		return
+	}
+
 	d.selectProcessor(id).queueEndpoint(ep)
 }
 
@@ -165,7 +165,8 @@ type rcvBufAutoTuneParams struct {
 	// rtt is the non-smoothed minimum RTT as measured by observing the time
 	// between when a byte is first acknowledged and the receipt of data
 	// that is at least one window beyond the sequence number that was
-	// acknowledged.
+	// acknowledged, or, if timestamps are in use, the time between sending
+	// a timestamp and receiving data that echoes it.
 	rtt time.Duration
 
 	// rttMeasureSeqNumber is the highest acceptable sequence number at the
@@ -176,6 +177,10 @@ type rcvBufAutoTuneParams struct {
 	// measurement period began.
 	rttMeasureTime time.Time `state:".(unixTime)"`
 
+	// rttLastTSEcr is the TSEcr of the last data segment received with
+	// timestamps.
+	rttLastTSEcr uint32
+
 	// disabled is true if an explicit receive buffer is set for the
 	// endpoint.
 	disabled bool
@@ -443,6 +448,20 @@ type endpoint struct {
 	// cork is a boolean (0 is false) and must be accessed atomically.
 	cork uint32
 
+	// more holds back segments until full because the last write had
+	// MSG_MORE set.
+	//
+	// more is a boolean (0 is false) and must be accessed atomically.
+	more uint32
+
+	// notsentLowat is the TCP_NOTSENT_LOWAT limit on unsent bytes, or 0 if
+	// there is no limit. It must be accessed atomically.
+	notsentLowat uint32
+
+	// sndBufNotSent is the number of bytes written to the endpoint that
+	// have not been sent yet. It must be accessed atomically.
+	sndBufNotSent int64
+
 	// scoreboard holds TCP SACK Scoreboard information for this endpoint.
 	scoreboard *SACKScoreboard
 
@@ -885,7 +904,7 @@ func (e *endpoint) Readiness(mask waiter.EventMask) waiter.EventMask {
 		// Determine if the endpoint is writable if requested.
 		if (mask & waiter.EventOut) != 0 {
 			e.sndBufMu.Lock()
-			if e.sndClosed || e.sndBufUsed < e.sndBufSize {
+			if e.sndClosed || (e.sndBufUsed < e.sndBufSize && e.belowNotsentLowat()) {
 				result |= waiter.EventOut
 			}
 			e.sndBufMu.Unlock()
@@ -1260,17 +1279,23 @@ func (e *endpoint) isEndpointWritableLocked() (int, *tcpip.Error) {
 	}
 
 	avail := e.sndBufSize - e.sndBufUsed
-	if avail <= 0 {
+	if avail <= 0 || !e.belowNotsentLowat() {
 		return 0, tcpip.ErrWouldBlock
 	}
 	return avail, nil
 }
 
+// belowNotsentLowat returns whether fewer bytes than TCP_NOTSENT_LOWAT have
+// not been sent yet, or TCP_NOTSENT_LOWAT is unset.
+func (e *endpoint) belowNotsentLowat() bool {
+	lowat := atomic.LoadUint32(&e.notsentLowat)
+	return lowat == 0 || atomic.LoadInt64(&e.sndBufNotSent) < int64(lowat)
+}
+
 // Write writes data to the endpoint's peer.
 func (e *endpoint) Write(p tcpip.Payloader, opts tcpip.WriteOptions) (int64, <-chan struct{}, *tcpip.Error) {
 	// Linux completely ignores any address passed to sendto(2) for TCP sockets
-	// (without the MSG_FASTOPEN flag). Corking is unimplemented, so opts.More
-	// and opts.EndOfRecord are also ignored.
+	// (without the MSG_FASTOPEN flag). opts.EndOfRecord is also ignored.
 
 	e.LockUser()
 	e.sndBufMu.Lock()
@@ -1309,9 +1334,18 @@ func (e *endpoint) Write(p tcpip.Payloader, opts tcpip.WriteOptions) (int64, <-c
 		s := newSegmentFromView(&e.route, e.ID, v)
 		e.sndBufUsed += len(v)
 		e.sndBufInQueue += seqnum.Size(len(v))
+		atomic.AddInt64(&e.sndBufNotSent, int64(len(v)))
 		e.sndQueue.PushBack(s)
 		e.sndBufMu.Unlock()
 
+		// Like MSG_MORE in Linux, hold back partial segments until a
+		// write without opts.More.
+		if opts.More {
+			atomic.StoreUint32(&e.more, 1)
+		} else {
+			atomic.StoreUint32(&e.more, 0)
+		}
+
 		// Do the work inline.
 		e.handleWrite()
 		e.UnlockUser()
@@ -1629,6 +1663,14 @@ func (e *endpoint) SetSockOptInt(opt tcpip.SockOptInt, v int) *tcpip.Error {
 		e.maxSynRetries = uint8(v)
 		e.UnlockUser()
 
+	case tcpip.TCPNotsentLowatOption:
+		if v < 0 {
+			return tcpip.ErrInvalidOptionValue
+		}
+		atomic.StoreUint32(&e.notsentLowat, uint32(v))
+		// A larger limit may make the endpoint writable.
+		e.waiterQueue.Notify(waiter.EventOut)
+
 	case tcpip.TCPWindowClampOption:
 		if v == 0 {
 			e.LockUser()
@@ -1886,6 +1928,9 @@ func (e *endpoint) GetSockOptInt(opt tcpip.SockOptInt) (int, *tcpip.Error) {
 		e.UnlockUser()
 		return v, nil
 
+	case tcpip.TCPNotsentLowatOption:
+		return int(atomic.LoadUint32(&e.notsentLowat)), nil
+
 	default:
 		return -1, tcpip.ErrUnknownProtocolOption
 	}
@@ -2512,6 +2557,19 @@ func (e *endpoint) updateSndBufferUsage(v int) {
 	}
 }
 
+// updateSndBufferNotSent is called by the protocol goroutine when v bytes of
+// new data have been sent.
+func (e *endpoint) updateSndBufferNotSent(v int) {
+	notSent := atomic.AddInt64(&e.sndBufNotSent, -int64(v))
+	lowat := int64(atomic.LoadUint32(&e.notsentLowat))
+	// As in Linux, writers waiting on TCP_NOTSENT_LOWAT are only woken once
+	// less than half of it is left unsent, so that they don't wake up to
+	// queue a few bytes.
+	if lowat != 0 && notSent<<1 < lowat && (notSent+int64(v))<<1 >= lowat {
+		e.waiterQueue.Notify(waiter.EventOut)
+	}
+}
+
 // readyToRead is called by the protocol goroutine when a new segment is ready
 // to be read, or when the connection is closed for receiving (in which case
 // s will be nil).
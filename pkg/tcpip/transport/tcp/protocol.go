@@ -77,6 +77,17 @@ type SACKEnabled bool
 // DelayEnabled option can be used to enable Nagle's algorithm in the TCP protocol.
 type DelayEnabled bool
 
+// RACKEnabled option can be used to enable RACK-TLP loss detection in the TCP
+// protocol. It only takes effect on connections that negotiate SACK. See:
+// https://tools.ietf.org/html/rfc8985.
+type RACKEnabled bool
+
+// LoopbackInlineEnabled option can be used to process segments received over
+// loopback on the goroutine that sent them, if the receiving endpoint is
+// connected and not otherwise busy, rather than handing them off to a
+// processor goroutine. Segments still undergo full TCP processing.
+type LoopbackInlineEnabled bool
+
 // SendBufferSizeOption allows the default, min and max send buffer sizes for
 // TCP endpoints to be queried or configured.
 type SendBufferSizeOption struct {
@@ -159,6 +170,7 @@ type protocol struct {
 	mu                         sync.RWMutex
 	sackEnabled                bool
 	delayEnabled               bool
+	rackEnabled                bool
 	sendBufferSize             SendBufferSizeOption
 	recvBufferSize             ReceiveBufferSizeOption
 	congestionControl          string
@@ -283,6 +295,16 @@ func (p *protocol) SetOption(option interface{}) *tcpip.Error {
 		p.mu.Unlock()
 		return nil
 
+	case RACKEnabled:
+		p.mu.Lock()
+		p.rackEnabled = bool(v)
+		p.mu.Unlock()
+		return nil
+
+	case LoopbackInlineEnabled:
+		p.dispatcher.setLoopbackInline(bool(v))
+		return nil
+
 	case SendBufferSizeOption:
 		if v.Min <= 0 || v.Default < v.Min || v.Default > v.Max {
 			return tcpip.ErrInvalidOptionValue
@@ -397,6 +419,16 @@ func (p *protocol) Option(option interface{}) *tcpip.Error {
 		p.mu.RUnlock()
 		return nil
 
+	case *RACKEnabled:
+		p.mu.RLock()
+		*v = RACKEnabled(p.rackEnabled)
+		p.mu.RUnlock()
+		return nil
+
+	case *LoopbackInlineEnabled:
+		*v = LoopbackInlineEnabled(p.dispatcher.loopbackInlineEnabled())
+		return nil
+
 	case *SendBufferSizeOption:
 		p.mu.RLock()
 		*v = p.sendBufferSize
@@ -0,0 +1,230 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package tcp
+
+import (
+	"time"
+
+	"gvisor.dev/gvisor/pkg/tcpip"
+	"gvisor.dev/gvisor/pkg/tcpip/seqnum"
+)
+
+// maxACKDelay is the worst case delay before a receiver acknowledges a single
+// segment, which the probe timeout allows for when only one segment is in
+// flight. See RFC 8985 section 7.2 (WCDelAckT).
+const maxACKDelay = 200 * time.Millisecond
+
+// rackControl holds the state of RACK-TLP loss detection, as described in
+// RFC 8985.
+//
+// RACK ("Recent ACKnowledgment") marks an outstanding segment lost once a
+// segment that was sent sufficiently later has been delivered, rather than
+// waiting for a number of duplicate ACKs. TLP ("Tail Loss Probe") sends a
+// probe segment when ACKs stop arriving, so that losses at the tail of a
+// flight, which would otherwise only be repaired by an RTO, elicit the SACK
+// information that RACK needs. Together, they repair tail losses in about one
+// round trip.
+//
+// RACK-TLP is only used on connections that permit SACK.
+//
+// +stateify savable
+type rackControl struct {
+	// enabled is true if RACK-TLP is enabled for the connection.
+	enabled bool
+
+	// xmitTime is the latest transmit time of any delivered segment
+	// (RACK.xmit_ts).
+	xmitTime time.Time `state:".(unixTime)"`
+
+	// endSequence is the ending sequence number of the delivered segment
+	// with transmit time xmitTime (RACK.end_seq).
+	endSequence seqnum.Value
+
+	// rtt is the RTT of the delivered segment with transmit time xmitTime
+	// (RACK.rtt).
+	rtt time.Duration
+
+	// minRTT is the minimum RTT observed by RACK. The reordering window is
+	// derived from it.
+	minRTT time.Duration
+
+	// tlpRxtOut is true while a probe retransmission sent by TLP is
+	// unacknowledged (TLP.is_retrans).
+	tlpRxtOut bool
+
+	// tlpHighRxt is the value of sndNxt when the probe retransmission was
+	// sent (TLP.end_seq).
+	tlpHighRxt seqnum.Value
+}
+
+// sentAfter returns true if a segment sent at time t1 and ending at sequence
+// number seq1 was sent after one sent at time t2 and ending at seq2. See RFC
+// 8985 section 6.2 step 2 (RACK_sent_after).
+func sentAfter(t1 time.Time, seq1 seqnum.Value, t2 time.Time, seq2 seqnum.Value) bool {
+	return t1.After(t2) || (t1.Equal(t2) && seq2.LessThan(seq1))
+}
+
+// update updates the RACK state with a segment that has just been delivered,
+// i.e. cumulatively or selectively acknowledged. See RFC 8985 section 6.2
+// steps 1 and 2.
+func (rc *rackControl) update(seg *segment, now time.Time) {
+	rtt := now.Sub(seg.xmitTime)
+	if seg.xmitCount > 1 && rtt < rc.minRTT {
+		// The ACK may have been for the original transmission rather
+		// than the retransmission, so it doesn't tell us when the
+		// delivered copy was sent.
+		return
+	}
+	if rc.minRTT == 0 || rtt < rc.minRTT {
+		rc.minRTT = rtt
+	}
+
+	endSeq := seg.sequenceNumber.Add(seg.logicalLen())
+	if sentAfter(seg.xmitTime, endSeq, rc.xmitTime, rc.endSequence) {
+		rc.rtt = rtt
+		rc.xmitTime = seg.xmitTime
+		rc.endSequence = endSeq
+	}
+}
+
+// reorderWindow returns the time that RACK waits after an outstanding segment
+// becomes eligible to be marked lost, to allow for reordering. See RFC 8985
+// section 6.2 step 4.
+func (rc *rackControl) reorderWindow(srtt time.Duration) time.Duration {
+	wnd := rc.minRTT / 4
+	if srtt != 0 && wnd > srtt {
+		wnd = srtt
+	}
+	return wnd
+}
+
+// rackActive returns true if RACK-TLP is in use on the connection.
+func (s *sender) rackActive() bool {
+	return s.rc.enabled && s.ep.sackPermitted
+}
+
+// rackUpdateSACKed updates the RACK state with every segment that is covered
+// by the SACK scoreboard.
+func (s *sender) rackUpdateSACKed(now time.Time) {
+	for seg := s.writeList.Front(); seg != nil && s.isAssignedSequenceNumber(seg) && seg.sequenceNumber.LessThan(s.sndNxt); seg = seg.Next() {
+		// Segments that were already SACKed don't change the state
+		// when they are passed to update again.
+		if s.ep.scoreboard.IsSACKED(seg.sackBlock()) {
+			s.rc.update(seg, now)
+		}
+	}
+}
+
+// rackDetectLoss marks as lost every outstanding segment that was sent more
+// than RACK.rtt plus the reordering window before the most recently delivered
+// segment was sent. It returns true if any segment was newly marked lost. See
+// RFC 8985 section 6.2 step 5.
+func (s *sender) rackDetectLoss(now time.Time) (lost bool) {
+	if s.rc.xmitTime.IsZero() {
+		return false
+	}
+
+	s.rtt.Lock()
+	srtt := s.rtt.srtt
+	s.rtt.Unlock()
+	wait := s.rc.rtt + s.rc.reorderWindow(srtt)
+
+	for seg := s.writeList.Front(); seg != nil && s.isAssignedSequenceNumber(seg) && seg.sequenceNumber.LessThan(s.sndNxt); seg = seg.Next() {
+		if seg.lost || s.ep.scoreboard.IsSACKED(seg.sackBlock()) {
+			continue
+		}
+		endSeq := seg.sequenceNumber.Add(seg.logicalLen())
+		if !sentAfter(s.rc.xmitTime, s.rc.endSequence, seg.xmitTime, endSeq) {
+			// Segments are ordered by sequence number rather than
+			// by transmit time, since some may have been
+			// retransmitted, so keep looking.
+			continue
+		}
+		if now.Sub(seg.xmitTime) >= wait {
+			seg.lost = true
+			lost = true
+		}
+	}
+	return lost
+}
+
+// schedulePTO arms the probe timer if a tail loss probe may be needed, and
+// disables it otherwise. See RFC 8985 section 7.2.
+func (s *sender) schedulePTO() {
+	if !s.rackActive() || s.sndUna == s.sndNxt || s.rc.tlpRxtOut || (s.state != Open && s.state != Disorder) {
+		s.probeTimer.disable()
+		return
+	}
+
+	s.rtt.Lock()
+	srtt, srttInited := s.rtt.srtt, s.rtt.srttInited
+	s.rtt.Unlock()
+	if !srttInited {
+		s.probeTimer.disable()
+		return
+	}
+
+	pto := 2 * srtt
+	if s.outstanding <= 1 {
+		pto += maxACKDelay
+	}
+	if pto >= s.rto {
+		// The retransmit timer will fire first.
+		s.probeTimer.disable()
+		return
+	}
+	s.probeTimer.enable(pto)
+}
+
+// probeTimerExpired sends a tail loss probe. See RFC 8985 section 7.3.
+func (s *sender) probeTimerExpired() *tcpip.Error {
+	// Check if the timer actually expired or if it's a spurious wake due
+	// to a previously orphaned runtime timer.
+	if !s.probeTimer.checkExpiration() {
+		return nil
+	}
+	if !s.rackActive() || s.sndUna == s.sndNxt || s.rc.tlpRxtOut || (s.state != Open && s.state != Disorder) {
+		return nil
+	}
+
+	// Prefer sending new data, which may also advance the connection.
+	if seg := s.writeNext; seg != nil {
+		end := s.sndUna.Add(s.sndWnd)
+		if s.maybeSendSegment(seg, s.maxPayloadSize, end) {
+			s.outstanding += s.pCount(seg)
+			s.writeNext = seg.Next()
+			s.resendTimer.enable(s.rto)
+			return nil
+		}
+	}
+
+	// Otherwise retransmit the last segment that was sent.
+	var last *segment
+	for seg := s.writeList.Front(); seg != nil && s.isAssignedSequenceNumber(seg) && seg.sequenceNumber.LessThan(s.sndNxt); seg = seg.Next() {
+		last = seg
+	}
+	if last == nil {
+		return nil
+	}
+	if size := last.data.Size(); size > s.maxPayloadSize {
+		s.splitSeg(last, size-s.maxPayloadSize)
+		last = last.Next()
+	}
+	s.rc.tlpRxtOut = true
+	s.rc.tlpHighRxt = s.sndNxt
+	s.sendSegment(last)
+	s.resendTimer.enable(s.rto)
+	return nil
+}
@@ -260,6 +260,60 @@ func (r *receiver) updateRTT() {
 	r.ep.rcvListMu.Unlock()
 }
 
+// updateRTTFromTS updates the receiver RTT measurement based on the timestamp
+// echoed by the received data segment, as Linux does in
+// tcp_rcv_rtt_measure_ts().
+//
+// Unlike updateRTT, which has to wait for a full window of data to arrive,
+// this yields an estimate within a round trip of the sender starting to send
+// data, so that receive buffer auto-tuning can start growing the window early
+// in the connection. This matters most on paths with a large
+// bandwidth-delay product, where a full window takes many round trips to
+// arrive while the sender is in slow start.
+func (r *receiver) updateRTTFromTS(s *segment) {
+	if !r.ep.sendTSOk || !s.parsedOptions.TS || s.parsedOptions.TSEcr == 0 {
+		return
+	}
+
+	r.ep.rcvListMu.Lock()
+	defer r.ep.rcvListMu.Unlock()
+
+	// Each timestamp we send is only sampled once, by the first data
+	// segment that echoes it. Segments sent by the peer before it received
+	// a later timestamp from us would otherwise yield samples inflated by
+	// the time between them.
+	//
+	// The first timestamp echoed in data is also skipped: it was sent
+	// during or just after the handshake, and the peer may not have had
+	// any data to send for an arbitrary period after receiving it.
+	tsEcr := s.parsedOptions.TSEcr
+	lastTSEcr := r.ep.rcvAutoParams.rttLastTSEcr
+	if tsEcr == lastTSEcr {
+		return
+	}
+	r.ep.rcvAutoParams.rttLastTSEcr = tsEcr
+	if lastTSEcr == 0 {
+		return
+	}
+
+	delta := int32(r.ep.timestamp() - tsEcr)
+	if delta < 0 {
+		// The peer echoed a timestamp that we haven't sent yet.
+		return
+	}
+	// Timestamps have millisecond granularity, so a delta of 0 means an
+	// RTT of less than 1ms.
+	if delta == 0 {
+		delta = 1
+	}
+	rtt := time.Duration(delta) * time.Millisecond
+
+	// As in updateRTT, only the minimum observed RTT is stored.
+	if r.ep.rcvAutoParams.rtt == 0 || rtt < r.ep.rcvAutoParams.rtt {
+		r.ep.rcvAutoParams.rtt = rtt
+	}
+}
+
 func (r *receiver) handleRcvdSegmentClosing(s *segment, state EndpointState, closed bool) (drop bool, err *tcpip.Error) {
 	r.ep.rcvListMu.Lock()
 	rcvClosed := r.ep.rcvClosed || r.closed
@@ -389,6 +443,7 @@ func (r *receiver) handleRcvdSegment(s *segment) (drop bool, err *tcpip.Error) {
 	// if required.
 	if segLen > 0 {
 		r.updateRTT()
+		r.updateRTTFromTS(s)
 	}
 
 	// By consuming the current segment, we may have filled a gap in the
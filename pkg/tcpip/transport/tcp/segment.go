@@ -58,6 +58,10 @@ type segment struct {
 	// xmitTime is the last transmit time of this segment.
 	xmitTime  time.Time `state:".(unixTime)"`
 	xmitCount uint32
+
+	// lost is true if RACK has marked this segment as lost since it was
+	// last transmitted.
+	lost bool
 }
 
 func newSegment(r *stack.Route, id stack.TransportEndpointID, pkt stack.PacketBuffer) *segment {
@@ -98,6 +102,7 @@ func (s *segment) clone() *segment {
 		rcvdTime:       s.rcvdTime,
 		xmitTime:       s.xmitTime,
 		xmitCount:      s.xmitCount,
+		lost:           s.lost,
 	}
 	t.data = s.data.Clone(t.views[:])
 	return t
@@ -157,6 +157,13 @@ type sender struct {
 	resendTimer timer       `state:"nosave"`
 	resendWaker sleep.Waker `state:"nosave"`
 
+	// probeTimer and probeWaker are used to send tail loss probes.
+	probeTimer timer       `state:"nosave"`
+	probeWaker sleep.Waker `state:"nosave"`
+
+	// rc has the fields needed for RACK-TLP loss detection.
+	rc rackControl
+
 	// rtt.srtt, rtt.rttvar, and rto are the "smoothed round-trip time",
 	// "round-trip time variation" and "retransmit timeout", as defined in
 	// section 2 of RFC 6298.
@@ -275,6 +282,7 @@ func newSender(ep *endpoint, iss, irs seqnum.Value, sndWnd seqnum.Size, mss uint
 	}
 
 	s.resendTimer.init(&s.resendWaker)
+	s.probeTimer.init(&s.probeWaker)
 
 	s.updateMaxPayloadSize(int(ep.route.MTU()), 0)
 
@@ -296,6 +304,12 @@ func newSender(ep *endpoint, iss, irs seqnum.Value, sndWnd seqnum.Size, mss uint
 	}
 	s.maxRTO = time.Duration(maxRTO)
 
+	var rackEnabled RACKEnabled
+	if err := ep.stack.TransportProtocolOption(ProtocolNumber, &rackEnabled); err != nil {
+		panic(fmt.Sprintf("unable to get RACKEnabled from stack: %s", err))
+	}
+	s.rc.enabled = bool(rackEnabled)
+
 	var maxRetries tcpip.TCPMaxRetriesOption
 	if err := ep.stack.TransportProtocolOption(ProtocolNumber, &maxRetries); err != nil {
 		panic(fmt.Sprintf("unable to get maxRetries from stack: %s", err))
@@ -664,7 +678,10 @@ func (s *sender) NextSeg(nextSegHint *segment) (nextSeg, hint *segment, rescueRt
 			if s.fr.highRxt.LessThan(segSeq) && segSeq.LessThan(s.ep.scoreboard.maxSACKED) {
 				// NextSeg():
 				//     (1.c) IsLost(S2) returns true.
-				if s.ep.scoreboard.IsLost(segSeq) {
+				//
+				// Segments marked lost by RACK are treated as
+				// if IsLost returned true.
+				if seg.lost || s.ep.scoreboard.IsLost(segSeq) {
 					return seg, seg.Next(), false
 				}
 
@@ -786,6 +803,12 @@ func (s *sender) maybeSendSegment(seg *segment, limit int, end seqnum.Value) (se
 					// Hold back the segment until full.
 					return false
 				}
+				if atomic.LoadUint32(&s.ep.more) != 0 && seg.Next() == nil {
+					// Hold back the segment until full or
+					// until a write without MSG_MORE, unless
+					// a FIN follows it.
+					return false
+				}
 			}
 		}
 
@@ -840,6 +863,9 @@ func (s *sender) maybeSendSegment(seg *segment, limit int, end seqnum.Value) (se
 	// Update sndNxt if we actually sent new data (as opposed to
 	// retransmitting some previously sent data).
 	if s.sndNxt.LessThan(segEnd) {
+		if seg.data.Size() != 0 {
+			s.ep.updateSndBufferNotSent(int(s.sndNxt.Size(segEnd)))
+		}
 		s.sndNxt = segEnd
 	}
 
@@ -1013,6 +1039,8 @@ func (s *sender) sendData() {
 	if s.sndUna == s.sndNxt {
 		s.ep.resetKeepaliveTimer(false)
 	}
+
+	s.schedulePTO()
 }
 
 func (s *sender) enterFastRecovery() {
@@ -1148,7 +1176,7 @@ func (s *sender) SetPipe() {
 			// NOTE: here we mark the whole segment as lost. We do not try
 			// and test every byte in our write buffer as we maintain our
 			// pipe in terms of oustanding packets and not bytes.
-			if !s.ep.scoreboard.IsRangeLost(sb) {
+			if !s1.lost && !s.ep.scoreboard.IsRangeLost(sb) {
 				pipe++
 			}
 			// SetPipe():
@@ -1214,9 +1242,11 @@ func (s *sender) checkDuplicateAck(seg *segment) (rtx bool) {
 // handleRcvdSegment is called when a segment is received; it is responsible for
 // updating the send-related state.
 func (s *sender) handleRcvdSegment(seg *segment) {
+	now := time.Now()
+
 	// Check if we can extract an RTT measurement from this ack.
 	if !seg.parsedOptions.TS && s.rttMeasureSeqNum.LessThan(seg.ackNumber) {
-		s.updateRTO(time.Now().Sub(s.rttMeasureTime))
+		s.updateRTO(now.Sub(s.rttMeasureTime))
 		s.rttMeasureSeqNum = s.sndNxt
 	}
 
@@ -1246,6 +1276,9 @@ func (s *sender) handleRcvdSegment(seg *segment) {
 			}
 		}
 		s.SetPipe()
+		if s.rackActive() && seg.hasNewSACKInfo {
+			s.rackUpdateSACKed(now)
+		}
 	}
 
 	// Count the duplicates and do the fast retransmit if needed.
@@ -1321,6 +1354,10 @@ func (s *sender) handleRcvdSegment(seg *segment) {
 				s.writeNext = seg.Next()
 			}
 
+			if s.rackActive() {
+				s.rc.update(seg, now)
+			}
+
 			s.writeList.Remove(seg)
 
 			// if SACK is enabled then Only reduce outstanding if
@@ -1364,8 +1401,25 @@ func (s *sender) handleRcvdSegment(seg *segment) {
 			// Reset firstRetransmittedSegXmitTime to the zero value.
 			s.firstRetransmittedSegXmitTime = time.Time{}
 			s.resendTimer.disable()
+			s.probeTimer.disable()
+		}
+
+		// The tail loss probe retransmission has been acknowledged, so
+		// another probe may be sent.
+		if s.rc.tlpRxtOut && s.rc.tlpHighRxt.LessThanEq(ack) {
+			s.rc.tlpRxtOut = false
 		}
 	}
+
+	// Mark segments lost using RACK and start recovery without waiting
+	// for nDupAckThreshold duplicate ACKs. See RFC 8985 section 6.2.
+	if s.rackActive() && !rtx && s.rackDetectLoss(now) && !s.fr.active && s.fr.last.LessThan(ack) {
+		s.cc.HandleNDupAcks()
+		s.enterFastRecovery()
+		s.dupAckCount = 0
+		rtx = true
+	}
+
 	// Now that we've popped all acknowledged data from the retransmit
 	// queue, retransmit if needed.
 	if rtx {
@@ -1392,6 +1446,7 @@ func (s *sender) sendSegment(seg *segment) *tcpip.Error {
 	}
 	seg.xmitTime = time.Now()
 	seg.xmitCount++
+	seg.lost = false
 	err := s.sendSegmentFromView(seg.data, seg.flags, seg.sequenceNumber)
 
 	// Every time a packet containing data is sent (including a
@@ -47,6 +47,7 @@ func (s *sender) loadRttMeasureTime(unix unixTime) {
 // afterLoad is invoked by stateify.
 func (s *sender) afterLoad() {
 	s.resendTimer.init(&s.resendWaker)
+	s.probeTimer.init(&s.probeWaker)
 }
 
 // saveFirstRetransmittedSegXmitTime is invoked by stateify.
@@ -58,3 +59,13 @@ func (s *sender) saveFirstRetransmittedSegXmitTime() unixTime {
 func (s *sender) loadFirstRetransmittedSegXmitTime(unix unixTime) {
 	s.firstRetransmittedSegXmitTime = time.Unix(unix.second, unix.nano)
 }
+
+// saveXmitTime is invoked by stateify.
+func (rc *rackControl) saveXmitTime() unixTime {
+	return unixTime{rc.xmitTime.Unix(), rc.xmitTime.UnixNano()}
+}
+
+// loadXmitTime is invoked by stateify.
+func (rc *rackControl) loadXmitTime(unix unixTime) {
+	rc.xmitTime = time.Unix(unix.second, unix.nano)
+}
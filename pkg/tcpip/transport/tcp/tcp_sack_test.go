@@ -587,3 +587,81 @@ func TestSACKRecovery(t *testing.T) {
 		expected++
 	}
 }
+
+// TestRACKTailLossRecovery tests that when the last few segments of a flight
+// are lost, the sender probes with the last segment and repairs the losses as
+// soon as that probe is SACKed, without waiting for the retransmit timer.
+func TestRACKTailLossRecovery(t *testing.T) {
+	const maxPayload = 10
+	// See: tcp.makeOptions for why tsOptionSize is set to 12 here.
+	const tsOptionSize = 12
+	// We increase the MTU by 40 bytes to account for SACK and Timestamp
+	// options.
+	const maxTCPOptionSize = 40
+
+	c := context.New(t, uint32(header.TCPMinimumSize+header.IPv4MinimumSize+maxTCPOptionSize+maxPayload))
+	defer c.Cleanup()
+
+	setStackSACKPermitted(t, c, true)
+	if err := c.Stack().SetTransportProtocolOption(tcp.ProtocolNumber, tcp.RACKEnabled(true)); err != nil {
+		t.Fatalf("c.s.SetTransportProtocolOption(tcp.ProtocolNumber, RACKEnabled(true)) = %v", err)
+	}
+	createConnectedWithSACKAndTS(c)
+
+	const numPackets = 5
+	data := buffer.NewView(numPackets * maxPayload)
+	for i := range data {
+		data[i] = byte(i)
+	}
+
+	if _, _, err := c.EP.Write(tcpip.SlicePayload(data), tcpip.WriteOptions{}); err != nil {
+		t.Fatalf("Write failed: %v", err)
+	}
+	for i := 0; i < numPackets; i++ {
+		c.ReceiveAndCheckPacketWithOptions(data, i*maxPayload, maxPayload, tsOptionSize)
+	}
+
+	// Acknowledge the first two packets, which gives the sender an RTT
+	// sample, and drop the remaining three.
+	const acked = 2 * maxPayload
+	c.SendAck(790, acked)
+
+	// The sender probes with the last segment after the probe timeout,
+	// which is much shorter than the retransmit timeout.
+	lastOffset := (numPackets - 1) * maxPayload
+	c.ReceiveAndCheckPacketWithOptions(data, lastOffset, maxPayload, tsOptionSize)
+
+	// SACK the probe. The probe has to take at least as long as the
+	// earlier RTT sample to be used by RACK, so delay the SACK a little.
+	time.Sleep(10 * time.Millisecond)
+	start := c.IRS.Add(seqnum.Size(1 + lastOffset))
+	c.SendAckWithSACK(790, acked, []header.SACKBlock{{start, start.Add(maxPayload)}})
+
+	// The remaining lost segments are retransmitted right away, even though
+	// there is only a single duplicate ACK.
+	for offset := acked; offset < lastOffset; offset += maxPayload {
+		c.ReceiveAndCheckPacketWithOptions(data, offset, maxPayload, tsOptionSize)
+	}
+
+	metricPollFn := func() error {
+		tcpStats := c.Stack().Stats().TCP
+		stats := []struct {
+			stat *tcpip.StatCounter
+			name string
+			want uint64
+		}{
+			{tcpStats.Retransmits, "stats.TCP.Retransmits", 3},
+			{tcpStats.SACKRecovery, "stats.TCP.SACKRecovery", 1},
+			{tcpStats.Timeouts, "stats.TCP.Timeouts", 0},
+		}
+		for _, s := range stats {
+			if got, want := s.stat.Value(), s.want; got != want {
+				return fmt.Errorf("got %s.Value() = %v, want = %v", s.name, got, want)
+			}
+		}
+		return nil
+	}
+	if err := testutil.Poll(metricPollFn, 1*time.Second); err != nil {
+		t.Error(err)
+	}
+}
@@ -4216,6 +4216,93 @@ func TestSelfConnect(t *testing.T) {
 	}
 }
 
+func TestLoopbackInline(t *testing.T) {
+	// This test checks that connected endpoints exchange data correctly over
+	// loopback when received segments are processed on the sending goroutine.
+	s, err := makeStack()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := s.SetTransportProtocolOption(tcp.ProtocolNumber, tcp.LoopbackInlineEnabled(true)); err != nil {
+		t.Fatalf("SetTransportProtocolOption(tcp, LoopbackInlineEnabled(true)) failed: %v", err)
+	}
+
+	var lwq waiter.Queue
+	listener, err := s.NewEndpoint(tcp.ProtocolNumber, ipv4.ProtocolNumber, &lwq)
+	if err != nil {
+		t.Fatalf("NewEndpoint failed: %v", err)
+	}
+	defer listener.Close()
+	if err := listener.Bind(tcpip.FullAddress{Port: context.StackPort}); err != nil {
+		t.Fatalf("Bind failed: %v", err)
+	}
+	if err := listener.Listen(1); err != nil {
+		t.Fatalf("Listen failed: %v", err)
+	}
+	acceptEntry, acceptCh := waiter.NewChannelEntry(nil)
+	lwq.EventRegister(&acceptEntry, waiter.EventIn)
+	defer lwq.EventUnregister(&acceptEntry)
+
+	var cwq waiter.Queue
+	client, err := s.NewEndpoint(tcp.ProtocolNumber, ipv4.ProtocolNumber, &cwq)
+	if err != nil {
+		t.Fatalf("NewEndpoint failed: %v", err)
+	}
+	defer client.Close()
+	connectEntry, connectCh := waiter.NewChannelEntry(nil)
+	cwq.EventRegister(&connectEntry, waiter.EventOut)
+	if err := client.Connect(tcpip.FullAddress{Addr: context.StackAddr, Port: context.StackPort}); err != tcpip.ErrConnectStarted {
+		t.Fatalf("got client.Connect(...) = %v, want = %v", err, tcpip.ErrConnectStarted)
+	}
+	<-connectCh
+	cwq.EventUnregister(&connectEntry)
+	if err := client.GetSockOpt(tcpip.ErrorOption{}); err != nil {
+		t.Fatalf("Connect failed: %v", err)
+	}
+
+	server, swq, err := listener.Accept()
+	if err == tcpip.ErrWouldBlock {
+		<-acceptCh
+		server, swq, err = listener.Accept()
+	}
+	if err != nil {
+		t.Fatalf("Accept failed: %v", err)
+	}
+	defer server.Close()
+	readEntry, readCh := waiter.NewChannelEntry(nil)
+	swq.EventRegister(&readEntry, waiter.EventIn)
+	defer swq.EventUnregister(&readEntry)
+
+	// Write more than one segment's worth of data.
+	data := make([]byte, 256<<10)
+	for i := range data {
+		data[i] = byte(i)
+	}
+	for written := 0; written < len(data); {
+		n, _, err := client.Write(tcpip.SlicePayload(buffer.NewViewFromBytes(data[written:])), tcpip.WriteOptions{})
+		if err != nil {
+			t.Fatalf("Write failed: %v", err)
+		}
+		written += int(n)
+	}
+
+	var got []byte
+	for len(got) < len(data) {
+		v, _, err := server.Read(nil)
+		if err == tcpip.ErrWouldBlock {
+			<-readCh
+			continue
+		}
+		if err != nil {
+			t.Fatalf("Read failed: %v", err)
+		}
+		got = append(got, v...)
+	}
+	if !bytes.Equal(got, data) {
+		t.Fatalf("got %d bytes that differ from the %d bytes written", len(got), len(data))
+	}
+}
+
 func TestConnectAvoidsBoundPorts(t *testing.T) {
 	addressTypes := func(t *testing.T, network string) []string {
 		switch network {
@@ -5920,6 +6007,59 @@ func TestReceiveBufferAutoTuning(t *testing.T) {
 	}
 }
 
+func TestReceiveBufferAutoTuningTimestampRTT(t *testing.T) {
+	c := context.New(t, defaultMTU)
+	defer c.Cleanup()
+
+	if err := c.Stack().SetTransportProtocolOption(tcp.ProtocolNumber, tcpip.ModerateReceiveBufferOption(true)); err != nil {
+		t.Fatalf("SetTransportProtocolOption failed: %v", err)
+	}
+
+	// The probe reports the endpoint's state before each segment is
+	// handled.
+	states := make(chan stack.TCPEndpointState, 100)
+	c.Stack().AddTCPProbe(func(state stack.TCPEndpointState) {
+		states <- state
+	})
+
+	rawEP := c.CreateConnectedWithOptions(header.TCPSynOptions{TS: true})
+
+	// Make sure that the timestamp on the ACK of the first segment differs
+	// from those sent during the handshake.
+	time.Sleep(2 * time.Millisecond)
+
+	// The first segment echoes a timestamp from the handshake, which is
+	// never sampled.
+	tsVal := rawEP.TSVal
+	tsVal++
+	rawEP.SendPacketWithTS([]byte{1}, tsVal)
+	rawEP.VerifyACKWithTS(tsVal)
+
+	// The second segment echoes the timestamp from the ACK of the first,
+	// which was sent at least rtt ago.
+	const rtt = 20 * time.Millisecond
+	time.Sleep(rtt)
+	tsVal++
+	rawEP.SendPacketWithTS([]byte{2}, tsVal)
+	rawEP.VerifyACKWithTS(tsVal)
+
+	// Send a third segment to observe the state after the second one was
+	// handled.
+	tsVal++
+	rawEP.SendPacketWithTS([]byte{3}, tsVal)
+	rawEP.VerifyACKWithTS(tsVal)
+
+	var state stack.TCPEndpointState
+	for len(states) > 0 {
+		state = <-states
+	}
+	// A full window hasn't been received, so the estimate can only have
+	// come from timestamps.
+	if got := state.RcvAutoParams.RTT; got < rtt {
+		t.Errorf("got RcvAutoParams.RTT = %s, want >= %s", got, rtt)
+	}
+}
+
 func TestDelayEnabled(t *testing.T) {
 	c := context.New(t, defaultMTU)
 	defer c.Cleanup()
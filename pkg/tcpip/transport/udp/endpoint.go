@@ -1281,38 +1281,19 @@ func (e *endpoint) HandlePacket(r *stack.Route, id stack.TransportEndpointID, pk
 
 	pkt.Data.TrimFront(header.UDPMinimumSize)
 
-	e.rcvMu.Lock()
 	e.stack.Stats().UDP.PacketsReceived.Increment()
 	e.stats.PacketsReceived.Increment()
 
-	// Drop the packet if our buffer is currently full.
-	if !e.rcvReady || e.rcvClosed {
-		e.rcvMu.Unlock()
-		e.stack.Stats().UDP.ReceiveBufferErrors.Increment()
-		e.stats.ReceiveErrors.ClosedReceiver.Increment()
-		return
-	}
-
-	if e.rcvBufSize >= e.rcvBufSizeMax {
-		e.rcvMu.Unlock()
-		e.stack.Stats().UDP.ReceiveBufferErrors.Increment()
-		e.stats.ReceiveErrors.ReceiveBufferOverflow.Increment()
-		return
-	}
-
-	wasEmpty := e.rcvBufSize == 0
-
-	// Push new packet into receive list and increment the buffer size.
+	// Build the packet before taking rcvMu, so that concurrent senders to
+	// this endpoint only contend on it to queue the packet.
 	packet := &udpPacket{
 		senderAddress: tcpip.FullAddress{
 			NIC:  r.NICID(),
 			Addr: id.RemoteAddress,
 			Port: header.UDP(hdr).SourcePort(),
 		},
+		data: pkt.Data,
 	}
-	packet.data = pkt.Data
-	e.rcvList.PushBack(packet)
-	e.rcvBufSize += pkt.Data.Size()
 
 	// Save any useful information from the network header to the packet.
 	switch r.NetProto {
@@ -1327,6 +1308,29 @@ func (e *endpoint) HandlePacket(r *stack.Route, id stack.TransportEndpointID, pk
 
 	packet.timestamp = e.stack.NowNanoseconds()
 
+	e.rcvMu.Lock()
+
+	// Drop the packet if our buffer is currently full.
+	if !e.rcvReady || e.rcvClosed {
+		e.rcvMu.Unlock()
+		e.stack.Stats().UDP.ReceiveBufferErrors.Increment()
+		e.stats.ReceiveErrors.ClosedReceiver.Increment()
+		return
+	}
+
+	if e.rcvBufSize >= e.rcvBufSizeMax {
+		e.rcvMu.Unlock()
+		e.stack.Stats().UDP.ReceiveBufferErrors.Increment()
+		e.stats.ReceiveErrors.ReceiveBufferOverflow.Increment()
+		return
+	}
+
+	wasEmpty := e.rcvBufSize == 0
+
+	// Push new packet into receive list and increment the buffer size.
+	e.rcvList.PushBack(packet)
+	e.rcvBufSize += pkt.Data.Size()
+
 	e.rcvMu.Unlock()
 
 	// Notify any waiters that there's data to be read now.
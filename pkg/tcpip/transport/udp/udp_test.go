@@ -861,6 +861,56 @@ func TestReadOnBoundToMulticast(t *testing.T) {
 	}
 }
 
+// TestMulticastFanOutSharesPayload checks that a multicast datagram delivered
+// to several endpoints reaches each of them intact, without the payload being
+// copied for each one.
+func TestMulticastFanOutSharesPayload(t *testing.T) {
+	const numEndpoints = 8
+
+	c := newDualTestContext(t, defaultMTU)
+	defer c.cleanup()
+
+	mcastAddr := multicastV4.getMcastAddr()
+	var eps [numEndpoints]tcpip.Endpoint
+	for i := range eps {
+		var wq waiter.Queue
+		ep, err := c.s.NewEndpoint(udp.ProtocolNumber, ipv4.ProtocolNumber, &wq)
+		if err != nil {
+			t.Fatalf("NewEndpoint failed: %s", err)
+		}
+		defer ep.Close()
+		if err := ep.SetSockOptBool(tcpip.ReusePortOption, true); err != nil {
+			t.Fatalf("SetSockOptBool(ReusePortOption, true) failed: %s", err)
+		}
+		if err := ep.Bind(tcpip.FullAddress{Addr: mcastAddr, Port: stackPort}); err != nil {
+			t.Fatalf("Bind failed: %s", err)
+		}
+		if err := ep.SetSockOpt(tcpip.AddMembershipOption{NIC: 1, MulticastAddr: mcastAddr}); err != nil {
+			t.Fatalf("SetSockOpt(AddMembershipOption) failed: %s", err)
+		}
+		eps[i] = ep
+	}
+
+	payload := newPayload()
+	c.injectPacket(multicastV4, payload)
+
+	var first buffer.View
+	for i, ep := range eps {
+		v, _, err := ep.Read(nil)
+		if err != nil {
+			t.Fatalf("endpoint %d: Read failed: %s", i, err)
+		}
+		if !bytes.Equal(v, payload) {
+			t.Fatalf("endpoint %d: got payload %x, want %x", i, v, payload)
+		}
+		if i == 0 {
+			first = v
+		} else if &v[0] != &first[0] {
+			t.Errorf("endpoint %d received a copy of the payload, want it shared with endpoint 0", i)
+		}
+	}
+}
+
 // TestV4ReadOnBoundToBroadcast checks that an endpoint can bind to a broadcast
 // address and can receive only broadcast data.
 func TestV4ReadOnBoundToBroadcast(t *testing.T) {
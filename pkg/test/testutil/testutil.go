@@ -18,6 +18,7 @@ package testutil
 import (
 	"bufio"
 	"context"
+	"crypto/rand"
 	"debug/elf"
 	"encoding/base32"
 	"encoding/json"
@@ -27,7 +28,6 @@ import (
 	"io/ioutil"
 	"log"
 	"math"
-	"math/rand"
 	"net/http"
 	"os"
 	"os/exec"
@@ -244,10 +244,13 @@ func writeSpec(dir string, spec *specs.Spec) error {
 }
 
 // RandomID returns 20 random bytes following the given prefix.
+//
+// The bytes come from crypto/rand rather than from an unseeded math/rand, so
+// that test processes running concurrently (e.g. packetimpact tests creating
+// Docker networks and containers) don't generate the same IDs.
 func RandomID(prefix string) string {
 	// Read 20 random bytes.
 	b := make([]byte, 20)
-	// "[Read] always returns len(p) and a nil error." --godoc
 	if _, err := rand.Read(b); err != nil {
 		panic("rand.Read failed: " + err.Error())
 	}
@@ -122,6 +122,15 @@ type EntryCallback interface {
 	Callback(e *Entry)
 }
 
+// ExclusiveEntryCallback may be implemented by the callbacks of exclusive
+// entries (see Entry.Exclusive).
+type ExclusiveEntryCallback interface {
+	// CallbackExclusive is called instead of EntryCallback.Callback when an
+	// exclusive entry is notified. It returns true if it woke up a waiter,
+	// in which case no further exclusive entries are notified.
+	CallbackExclusive(e *Entry) bool
+}
+
 // Entry represents a waiter that can be add to the a wait queue. It can
 // only be in one queue at a time, and is added "intrusively" to the queue with
 // no extra memory allocations.
@@ -137,6 +146,12 @@ type Entry struct {
 
 	Callback EntryCallback
 
+	// If Exclusive is true, then each notification is delivered to at most
+	// one exclusive entry in a queue that wakes up a waiter, as for Linux's
+	// add_wait_queue_exclusive(); non-exclusive entries are always notified.
+	// Exclusive must not be changed while the entry is in a queue.
+	Exclusive bool
+
 	// The following fields are protected by the queue lock.
 	mask EventMask
 	waiterEntry
@@ -194,13 +209,28 @@ func (q *Queue) EventUnregister(e *Entry) {
 	q.mu.Unlock()
 }
 
-// Notify notifies all waiters in the queue whose masks have at least one bit
-// in common with the notification mask.
+// Notify notifies all non-exclusive waiters in the queue whose masks have at
+// least one bit in common with the notification mask, and exclusive waiters
+// with such masks, in order, until one wakes up a waiter.
 func (q *Queue) Notify(mask EventMask) {
 	q.mu.RLock()
+	woke := false
 	for e := q.list.Front(); e != nil; e = e.Next() {
-		if mask&e.mask != 0 {
+		if mask&e.mask == 0 {
+			continue
+		}
+		if !e.Exclusive {
+			e.Callback.Callback(e)
+			continue
+		}
+		if woke {
+			continue
+		}
+		if ec, ok := e.Callback.(ExclusiveEntryCallback); ok {
+			woke = ec.CallbackExclusive(e)
+		} else {
 			e.Callback.Callback(e)
+			woke = true
 		}
 	}
 	q.mu.RUnlock()
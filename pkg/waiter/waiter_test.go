@@ -88,6 +88,65 @@ func TestMask(t *testing.T) {
 	}
 }
 
+type exclusiveCallbackStub struct {
+	f func(e *Entry) bool
+}
+
+// Callback implements EntryCallback.Callback.
+func (c *exclusiveCallbackStub) Callback(e *Entry) {
+	c.f(e)
+}
+
+// CallbackExclusive implements ExclusiveEntryCallback.CallbackExclusive.
+func (c *exclusiveCallbackStub) CallbackExclusive(e *Entry) bool {
+	return c.f(e)
+}
+
+func TestExclusive(t *testing.T) {
+	var q Queue
+	var shared, exclusive [3]int
+	// Only the second exclusive entry has a waiter to wake.
+	hasWaiter := [3]bool{false, true, true}
+	var entries []*Entry
+	for i := range exclusive {
+		i := i
+		e := &Entry{
+			Callback: &exclusiveCallbackStub{func(*Entry) bool {
+				exclusive[i]++
+				return hasWaiter[i]
+			}},
+			Exclusive: true,
+		}
+		entries = append(entries, e)
+		q.EventRegister(e, EventIn)
+		e = &Entry{Callback: &callbackStub{func(*Entry) { shared[i]++ }}}
+		entries = append(entries, e)
+		q.EventRegister(e, EventIn)
+	}
+
+	q.Notify(EventIn)
+	if want := [3]int{1, 1, 0}; exclusive != want {
+		t.Errorf("got exclusive callback counts %v, want %v", exclusive, want)
+	}
+	if want := [3]int{1, 1, 1}; shared != want {
+		t.Errorf("got non-exclusive callback counts %v, want %v", shared, want)
+	}
+
+	// Exclusive entries without an ExclusiveEntryCallback always count as
+	// having woken a waiter.
+	cnt := 0
+	e := Entry{Callback: &callbackStub{func(*Entry) { cnt++ }}, Exclusive: true}
+	var q2 Queue
+	q2.EventRegister(&e, EventIn)
+	q.EventUnregister(entries[0])
+	q2.EventRegister(entries[0], EventIn)
+	exclusive = [3]int{}
+	q2.Notify(EventIn)
+	if cnt != 1 || exclusive[0] != 0 {
+		t.Errorf("got callback counts %d, %d; want 1, 0", cnt, exclusive[0])
+	}
+}
+
 func TestConcurrentRegistration(t *testing.T) {
 	var q Queue
 	var cnt int
@@ -18,6 +18,7 @@ import (
 	"fmt"
 	"strconv"
 	"strings"
+	"time"
 
 	"gvisor.dev/gvisor/pkg/refs"
 	"gvisor.dev/gvisor/pkg/sentry/watchdog"
@@ -187,10 +188,17 @@ type Config struct {
 	// SoftwareGSO indicates that software segmentation offload is enabled.
 	SoftwareGSO bool
 
+	// GRO indicates that generic receive offload is enabled.
+	GRO bool
+
 	// QDisc indicates the type of queuening discipline to use by default
 	// for non-loopback interfaces.
 	QDisc QueueingDiscipline
 
+	// TCPLoopbackInline indicates that TCP segments received over loopback
+	// are processed on the goroutine that sent them.
+	TCPLoopbackInline bool
+
 	// LogPackets indicates that all network packets should be logged.
 	LogPackets bool
 
@@ -224,9 +232,14 @@ type Config struct {
 	// RestoreFile is the path to the saved container image
 	RestoreFile string
 
+	// RestorePagesFile is the path to the pages file saved with RestoreFile,
+	// if any.
+	RestorePagesFile string
+
 	// NumNetworkChannels controls the number of AF_PACKET sockets that map
 	// to the same underlying network device. This allows netstack to better
-	// scale for high throughput use cases.
+	// scale for high throughput use cases. If NumNetworkChannels is 0, one
+	// channel is used per CPU.
 	NumNetworkChannels int
 
 	// Rootless allows the sandbox to be started with a user that is not root.
@@ -268,6 +281,46 @@ type Config struct {
 
 	// Enables VFS2 (not plumbled through yet).
 	VFS2 bool
+
+	// NUMA exposes the host NUMA nodes available to the sandbox to
+	// applications, and places application memory on host nodes according
+	// to the applications' NUMA memory policies.
+	NUMA bool
+
+	// HostAffinity makes CPU affinity masks set by applications also
+	// constrain the host threads that run them, as for
+	// kernel.InitKernelArgs.HostAffinity.
+	HostAffinity bool
+
+	// SyscallTiming enables measurement of the time spent executing each
+	// syscall, as for kernel.InitKernelArgs.SyscallTiming.
+	SyscallTiming bool
+
+	// VDSOSpinSleep is the longest sleep that the VDSO performs by spinning
+	// on the CPU rather than by trapping to the sandbox kernel. Spinning is
+	// disabled if it is zero.
+	VDSOSpinSleep time.Duration
+
+	// VDSOThreadCPUTime allows the VDSO to serve the calling thread's CPU
+	// clock, as for kernel.Kernel.SetVDSOThreadCPUTime.
+	VDSOThreadCPUTime bool
+
+	// DecommitBatchSize and DecommitDelay control how freed sandbox memory
+	// is returned to the host, as for the fields of the same names in
+	// pgalloc.MemoryFileOpts.
+	DecommitBatchSize uint64
+	DecommitDelay     time.Duration
+
+	// OOMThreshold is the fraction of the sandbox's total memory above which
+	// the sandbox reclaims memory itself, by evicting cached file contents
+	// and then killing processes, as for package mempressure. It is disabled
+	// if it is zero, or if the sandbox has no memory limit.
+	OOMThreshold float64
+
+	// CheckpointTemplate saves application memory in checkpoints to a
+	// separate, uncompressed pages file, so that the checkpoint can be
+	// restored quickly into many sandboxes.
+	CheckpointTemplate bool
 }
 
 // ToFlags returns a slice of flags that correspond to the given Config.
@@ -299,8 +352,19 @@ func (c *Config) ToFlags() []string {
 		"--ref-leak-mode=" + refsLeakModeToString(c.ReferenceLeakMode),
 		"--gso=" + strconv.FormatBool(c.HardwareGSO),
 		"--software-gso=" + strconv.FormatBool(c.SoftwareGSO),
+		"--gro=" + strconv.FormatBool(c.GRO),
 		"--overlayfs-stale-read=" + strconv.FormatBool(c.OverlayfsStaleRead),
 		"--qdisc=" + c.QDisc.String(),
+		"--tcp-loopback-inline=" + strconv.FormatBool(c.TCPLoopbackInline),
+		"--vdso-spin-sleep=" + c.VDSOSpinSleep.String(),
+		"--numa=" + strconv.FormatBool(c.NUMA),
+		"--host-affinity=" + strconv.FormatBool(c.HostAffinity),
+		"--syscall-timing=" + strconv.FormatBool(c.SyscallTiming),
+		"--vdso-thread-cputime=" + strconv.FormatBool(c.VDSOThreadCPUTime),
+		"--decommit-batch-size=" + strconv.FormatUint(c.DecommitBatchSize, 10),
+		"--decommit-delay=" + c.DecommitDelay.String(),
+		"--oom-threshold=" + strconv.FormatFloat(c.OOMThreshold, 'g', -1, 64),
+		"--checkpoint-template=" + strconv.FormatBool(c.CheckpointTemplate),
 	}
 	if c.CPUNumFromQuota {
 		f = append(f, "--cpu-num-from-quota")
@@ -29,6 +29,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/socket/netstack"
 	"gvisor.dev/gvisor/pkg/sentry/state"
 	"gvisor.dev/gvisor/pkg/sentry/time"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
 	"gvisor.dev/gvisor/pkg/sentry/watchdog"
 	"gvisor.dev/gvisor/pkg/tcpip/stack"
 	"gvisor.dev/gvisor/pkg/urpc"
@@ -297,9 +298,14 @@ func (cm *containerManager) Pause(_, _ *struct{}) error {
 // RestoreOpts contains options related to restoring a container's file system.
 type RestoreOpts struct {
 	// FilePayload contains the state file to be restored, followed by the
-	// platform device file if necessary.
+	// platform device file if necessary, followed by the pages file if
+	// PagesFile is true.
 	urpc.FilePayload
 
+	// PagesFile is true if the state file's application memory was saved to
+	// a separate pages file, which is the last file in FilePayload.
+	PagesFile bool
+
 	// SandboxID contains the ID of the sandbox.
 	SandboxID string
 }
@@ -311,19 +317,27 @@ type RestoreOpts struct {
 func (cm *containerManager) Restore(o *RestoreOpts, _ *struct{}) error {
 	log.Debugf("containerManager.Restore")
 
-	var specFile, deviceFile *os.File
-	switch numFiles := len(o.FilePayload.Files); numFiles {
+	var specFile, deviceFile, pagesFile *os.File
+	files := o.FilePayload.Files
+	if o.PagesFile {
+		if len(files) == 0 {
+			return fmt.Errorf("pages file must be passed to Restore")
+		}
+		pagesFile = files[len(files)-1]
+		files = files[:len(files)-1]
+	}
+	switch numFiles := len(files); numFiles {
 	case 2:
 		// The device file is donated to the platform.
 		// Can't take ownership away from os.File. dup them to get a new FD.
-		fd, err := syscall.Dup(int(o.FilePayload.Files[1].Fd()))
+		fd, err := syscall.Dup(int(files[1].Fd()))
 		if err != nil {
 			return fmt.Errorf("failed to dup file: %v", err)
 		}
 		deviceFile = os.NewFile(uintptr(fd), "platform device")
 		fallthrough
 	case 1:
-		specFile = o.FilePayload.Files[0]
+		specFile = files[0]
 	case 0:
 		return fmt.Errorf("at least one file must be passed to Restore")
 	default:
@@ -340,7 +354,7 @@ func (cm *containerManager) Restore(o *RestoreOpts, _ *struct{}) error {
 	k := &kernel.Kernel{
 		Platform: p,
 	}
-	mf, err := createMemoryFile()
+	mf, err := createMemoryFile(cm.l.conf, cm.l.memPressure != nil)
 	if err != nil {
 		return fmt.Errorf("creating memory file: %v", err)
 	}
@@ -380,10 +394,15 @@ func (cm *containerManager) Restore(o *RestoreOpts, _ *struct{}) error {
 	}
 
 	// Load the state.
-	loadOpts := state.LoadOpts{Source: specFile}
+	loadOpts := state.LoadOpts{
+		Source: specFile,
+		Pages:  pagesFile,
+	}
 	if err := loadOpts.Load(k, networkStack, time.NewCalibratedClocks()); err != nil {
 		return err
 	}
+	k.Timekeeper().SetVDSOSpinSleep(cm.l.conf.VDSOSpinSleep)
+	k.SetVDSOThreadCPUTime(cm.l.conf.VDSOThreadCPUTime)
 
 	// Since we have a new kernel we also must make a new watchdog.
 	dogOpts := watchdog.DefaultOpts
@@ -393,6 +412,10 @@ func (cm *containerManager) Restore(o *RestoreOpts, _ *struct{}) error {
 	// Change the loader fields to reflect the changes made when restoring.
 	cm.l.k = k
 	cm.l.watchdog = dog
+	if cm.l.memPressure != nil {
+		// The total memory was set from the sandbox's memory limit.
+		cm.l.memPressure = newMemoryPressure(k, cm.l.conf, usage.MinimumTotalMemoryBytes)
+	}
 	cm.l.rootProcArgs = kernel.CreateProcessArgs{}
 	cm.l.restore = true
 
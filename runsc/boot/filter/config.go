@@ -39,7 +39,17 @@ var allowedSyscalls = seccomp.SyscallRules{
 		},
 	},
 	syscall.SYS_CLOSE: {},
-	syscall.SYS_DUP:   {},
+	unix.SYS_COPY_FILE_RANGE: []seccomp.Rule{
+		{
+			seccomp.AllowAny{},
+			seccomp.AllowAny{},
+			seccomp.AllowAny{},
+			seccomp.AllowAny{},
+			seccomp.AllowAny{},
+			seccomp.AllowValue(0),
+		},
+	},
+	syscall.SYS_DUP: {},
 	syscall.SYS_DUP3: []seccomp.Rule{
 		{
 			seccomp.AllowAny{},
@@ -174,18 +184,11 @@ var allowedSyscalls = seccomp.SyscallRules{
 	syscall.SYS_LSEEK:   {},
 	syscall.SYS_MADVISE: {},
 	syscall.SYS_MINCORE: {},
-	// Used by the Go runtime as a temporarily workaround for a Linux
-	// 5.2-5.4 bug.
-	//
-	// See src/runtime/os_linux_x86.go.
-	//
-	// TODO(b/148688965): Remove once this is gone from Go.
-	syscall.SYS_MLOCK: []seccomp.Rule{
-		{
-			seccomp.AllowAny{},
-			seccomp.AllowValue(4096),
-		},
-	},
+	// Used by pgalloc.MemoryFile.Pin to keep memory that is mlocked by the
+	// application resident in the host, and by the Go runtime as a
+	// temporary workaround for a Linux 5.2-5.4 bug (see
+	// src/runtime/os_linux_x86.go).
+	syscall.SYS_MLOCK: {},
 	syscall.SYS_MMAP: []seccomp.Rule{
 		{
 			seccomp.AllowAny{},
@@ -225,6 +228,7 @@ var allowedSyscalls = seccomp.SyscallRules{
 		},
 	},
 	syscall.SYS_MPROTECT:  {},
+	syscall.SYS_MUNLOCK:   {},
 	syscall.SYS_MUNMAP:    {},
 	syscall.SYS_NANOSLEEP: {},
 	syscall.SYS_PPOLL:     {},
@@ -427,7 +431,9 @@ func hostInetFilters() seccomp.SyscallRules {
 		syscall.SYS_LISTEN:   {},
 		syscall.SYS_READV:    {},
 		syscall.SYS_RECVFROM: {},
+		syscall.SYS_RECVMMSG: {},
 		syscall.SYS_RECVMSG:  {},
+		unix.SYS_SENDMMSG:    {},
 		syscall.SYS_SENDMSG:  {},
 		syscall.SYS_SENDTO:   {},
 		syscall.SYS_SETSOCKOPT: []seccomp.Rule{
@@ -535,6 +541,35 @@ func hostInetFilters() seccomp.SyscallRules {
 	}
 }
 
+// numaFilters returns extra syscalls made by pgalloc.MemoryFile to honor NUMA
+// memory policies.
+func numaFilters() seccomp.SyscallRules {
+	return seccomp.SyscallRules{
+		syscall.SYS_MBIND: []seccomp.Rule{
+			{
+				seccomp.AllowAny{},
+				seccomp.AllowAny{},
+				seccomp.AllowAny{},
+				seccomp.AllowAny{},
+				seccomp.AllowAny{},
+				seccomp.AllowValue(0),
+			},
+		},
+	}
+}
+
+// affinityFilters returns extra syscalls made by kernel.Task to apply
+// application CPU masks to the threads that run them.
+func affinityFilters() seccomp.SyscallRules {
+	return seccomp.SyscallRules{
+		unix.SYS_SCHED_SETAFFINITY: []seccomp.Rule{
+			{
+				seccomp.AllowValue(0),
+			},
+		},
+	}
+}
+
 func controlServerFilters(fd int) seccomp.SyscallRules {
 	return seccomp.SyscallRules{
 		syscall.SYS_ACCEPT: []seccomp.Rule{
@@ -28,6 +28,8 @@ type Options struct {
 	Platform      platform.Platform
 	HostNetwork   bool
 	ProfileEnable bool
+	NUMA          bool
+	HostAffinity  bool
 	ControllerFD  int
 }
 
@@ -49,6 +51,16 @@ func Install(opt Options) error {
 		s.Merge(profileFilters())
 	}
 
+	if opt.NUMA {
+		Report("NUMA memory policies enabled: syscall filters less restrictive!")
+		s.Merge(numaFilters())
+	}
+
+	if opt.HostAffinity {
+		Report("host CPU affinity enabled: syscall filters less restrictive!")
+		s.Merge(affinityFilters())
+	}
+
 	s.Merge(opt.Platform.SyscallFilters())
 
 	return seccomp.Install(s)
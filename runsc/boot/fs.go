@@ -65,6 +65,10 @@ const (
 // tmpfs has some extra supported options that we must pass through.
 var tmpfsAllowedData = []string{"mode", "uid", "gid"}
 
+// The VFS2 gofer filesystem has some extra supported options that we must pass
+// through for bind mounts.
+var goferAllowedData = []string{"dentry_cache_limit", "negative_lookup_timeout"}
+
 func addOverlay(ctx context.Context, conf *Config, lower *fs.Inode, name string, lowerFlags fs.MountSourceFlags) (*fs.Inode, error) {
 	// Upper layer uses the same flags as lower, but it must be read-write.
 	upperFlags := lowerFlags
@@ -220,6 +224,10 @@ func mountFlags(opts []string) fs.MountSourceFlags {
 			mf.ReadOnly = true
 		case "noatime":
 			mf.NoAtime = true
+		case "strictatime":
+			mf.StrictAtime = true
+		case "relatime":
+			mf.StrictAtime = false
 		case "noexec":
 			mf.NoExec = true
 		default:
@@ -231,7 +239,7 @@ func mountFlags(opts []string) fs.MountSourceFlags {
 
 func isSupportedMountFlag(fstype, opt string) bool {
 	switch opt {
-	case "rw", "ro", "noatime", "noexec":
+	case "rw", "ro", "noatime", "strictatime", "relatime", "noexec":
 		return true
 	}
 	if fstype == tmpfsvfs2.Name {
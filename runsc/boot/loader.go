@@ -42,6 +42,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/inet"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/mempressure"
 	"gvisor.dev/gvisor/pkg/sentry/loader"
 	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
 	"gvisor.dev/gvisor/pkg/sentry/platform"
@@ -72,6 +73,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/socket/hostinet"
 	_ "gvisor.dev/gvisor/pkg/sentry/socket/netlink"
 	_ "gvisor.dev/gvisor/pkg/sentry/socket/netlink/route"
+	_ "gvisor.dev/gvisor/pkg/sentry/socket/netlink/sockdiag"
 	_ "gvisor.dev/gvisor/pkg/sentry/socket/netlink/uevent"
 	"gvisor.dev/gvisor/pkg/sentry/socket/netstack"
 	_ "gvisor.dev/gvisor/pkg/sentry/socket/unix"
@@ -92,6 +94,10 @@ type Loader struct {
 
 	watchdog *watchdog.Watchdog
 
+	// memPressure reclaims memory when the sandbox nears its memory limit.
+	// It is nil if Config.OOMThreshold is disabled.
+	memPressure *mempressure.Controller
+
 	// stdioFDs contains stdin, stdout, and stderr.
 	stdioFDs []int
 
@@ -218,7 +224,7 @@ func New(args Args) (*Loader, error) {
 	}
 
 	// Create memory file.
-	mf, err := createMemoryFile()
+	mf, err := createMemoryFile(args.Conf, args.TotalMem > 0 && args.Conf.OOMThreshold > 0)
 	if err != nil {
 		return nil, fmt.Errorf("creating memory file: %v", err)
 	}
@@ -240,6 +246,7 @@ func New(args Args) (*Loader, error) {
 		return nil, fmt.Errorf("creating timekeeper: %v", err)
 	}
 	tk.SetClocks(time.NewCalibratedClocks())
+	tk.SetVDSOSpinSleep(args.Conf.VDSOSpinSleep)
 
 	if err := enableStrace(args.Conf); err != nil {
 		return nil, fmt.Errorf("enabling strace: %v", err)
@@ -291,6 +298,8 @@ func New(args Args) (*Loader, error) {
 		RootUserNamespace:           creds.UserNamespace,
 		RootNetworkNamespace:        netns,
 		ApplicationCores:            uint(args.NumCPU),
+		HostAffinity:                args.Conf.HostAffinity,
+		SyscallTiming:               args.Conf.SyscallTiming,
 		Vdso:                        vdso,
 		RootUTSNamespace:            kernel.NewUTSNamespace(args.Spec.Hostname, args.Spec.Hostname, creds.UserNamespace),
 		RootIPCNamespace:            kernel.NewIPCNamespace(creds.UserNamespace),
@@ -299,6 +308,7 @@ func New(args Args) (*Loader, error) {
 	}); err != nil {
 		return nil, fmt.Errorf("initializing kernel: %v", err)
 	}
+	k.SetVDSOThreadCPUTime(args.Conf.VDSOThreadCPUTime)
 
 	if err := adjustDirentCache(k); err != nil {
 		return nil, err
@@ -370,6 +380,7 @@ func New(args Args) (*Loader, error) {
 		conf:         args.Conf,
 		console:      args.Console,
 		watchdog:     dog,
+		memPressure:  newMemoryPressure(k, args.Conf, args.TotalMem),
 		spec:         args.Spec,
 		goferFDs:     args.GoferFDs,
 		stdioFDs:     stdioFDs,
@@ -449,6 +460,9 @@ func (l *Loader) Destroy() {
 		l.stopSignalForwarding()
 	}
 	l.watchdog.Stop()
+	if l.memPressure != nil {
+		l.memPressure.Stop()
+	}
 }
 
 func createPlatform(conf *Config, deviceFile *os.File) (platform.Platform, error) {
@@ -460,7 +474,25 @@ func createPlatform(conf *Config, deviceFile *os.File) (platform.Platform, error
 	return p.New(deviceFile)
 }
 
-func createMemoryFile() (*pgalloc.MemoryFile, error) {
+// memoryPressurePeriod is how often the memory pressure controller checks the
+// sandbox's memory usage.
+const memoryPressurePeriod = 100 * gtime.Millisecond
+
+// newMemoryPressure returns k's memory pressure controller for a sandbox
+// limited to totalMem bytes, or nil if conf.OOMThreshold is disabled or the
+// sandbox has no memory limit (totalMem is 0).
+func newMemoryPressure(k *kernel.Kernel, conf *Config, totalMem uint64) *mempressure.Controller {
+	if conf.OOMThreshold <= 0 || totalMem == 0 {
+		return nil
+	}
+	log.Infof("Reclaiming memory above %.2f GB", conf.OOMThreshold*float64(totalMem)/(1<<30))
+	return mempressure.New(k, totalMem, conf.OOMThreshold, memoryPressurePeriod)
+}
+
+// createMemoryFile creates the sandbox's memory file. If externalPressure is
+// true, evictable allocations are only evicted by the memory pressure
+// controller.
+func createMemoryFile(conf *Config, externalPressure bool) (*pgalloc.MemoryFile, error) {
 	const memfileName = "runsc-memory"
 	memfd, err := memutil.CreateMemFD(memfileName, 0)
 	if err != nil {
@@ -470,7 +502,12 @@ func createMemoryFile() (*pgalloc.MemoryFile, error) {
 	// We can't enable pgalloc.MemoryFileOpts.UseHostMemcgPressure even if
 	// there are memory cgroups specified, because at this point we're already
 	// in a mount namespace in which the relevant cgroupfs is not visible.
-	mf, err := pgalloc.NewMemoryFile(memfile, pgalloc.MemoryFileOpts{})
+	mf, err := pgalloc.NewMemoryFile(memfile, pgalloc.MemoryFileOpts{
+		NUMA:                conf.NUMA,
+		DecommitBatchSize:   conf.DecommitBatchSize,
+		DecommitDelay:       conf.DecommitDelay,
+		UseExternalPressure: externalPressure,
+	})
 	if err != nil {
 		memfile.Close()
 		return nil, fmt.Errorf("error creating pgalloc.MemoryFile: %v", err)
@@ -486,6 +523,8 @@ func (l *Loader) installSeccompFilters() error {
 			Platform:      l.k.Platform,
 			HostNetwork:   l.conf.Network == NetworkHost,
 			ProfileEnable: l.conf.ProfileEnable,
+			NUMA:          l.conf.NUMA,
+			HostAffinity:  l.conf.HostAffinity,
 			ControllerFD:  l.ctrl.srv.FD(),
 		}
 		if err := filter.Install(opts); err != nil {
@@ -647,6 +686,9 @@ func (l *Loader) run() error {
 
 	log.Infof("Process should have started...")
 	l.watchdog.Start()
+	if l.memPressure != nil {
+		l.memPressure.Start()
+	}
 	return l.k.Start()
 }
 
@@ -1011,13 +1053,14 @@ func newRootNetworkNamespace(conf *Config, clock tcpip.Clock, uniqueID stack.Uni
 		return inet.NewRootNamespace(hostinet.NewStack(), nil), nil
 
 	case NetworkNone, NetworkSandbox:
-		s, err := newEmptySandboxNetworkStack(clock, uniqueID)
+		s, err := newEmptySandboxNetworkStack(clock, uniqueID, conf.TCPLoopbackInline)
 		if err != nil {
 			return nil, err
 		}
 		creator := &sandboxNetstackCreator{
-			clock:    clock,
-			uniqueID: uniqueID,
+			clock:          clock,
+			uniqueID:       uniqueID,
+			loopbackInline: conf.TCPLoopbackInline,
 		}
 		return inet.NewRootNamespace(s, creator), nil
 
@@ -1027,7 +1070,7 @@ func newRootNetworkNamespace(conf *Config, clock tcpip.Clock, uniqueID stack.Uni
 
 }
 
-func newEmptySandboxNetworkStack(clock tcpip.Clock, uniqueID stack.UniqueID) (inet.Stack, error) {
+func newEmptySandboxNetworkStack(clock tcpip.Clock, uniqueID stack.UniqueID, loopbackInline bool) (inet.Stack, error) {
 	netProtos := []stack.NetworkProtocol{ipv4.NewProtocol(), ipv6.NewProtocol(), arp.NewProtocol()}
 	transProtos := []stack.TransportProtocol{tcp.NewProtocol(), udp.NewProtocol(), icmp.NewProtocol4()}
 	s := netstack.Stack{stack.New(stack.Options{
@@ -1047,6 +1090,12 @@ func newEmptySandboxNetworkStack(clock tcpip.Clock, uniqueID stack.UniqueID) (in
 		return nil, fmt.Errorf("failed to enable SACK: %v", err)
 	}
 
+	// Enable RACK-TLP loss detection, which only applies to connections
+	// that use SACK.
+	if err := s.Stack.SetTransportProtocolOption(tcp.ProtocolNumber, tcp.RACKEnabled(true)); err != nil {
+		return nil, fmt.Errorf("failed to enable RACK: %v", err)
+	}
+
 	// Set default TTLs as required by socket/netstack.
 	s.Stack.SetNetworkProtocolOption(ipv4.ProtocolNumber, tcpip.DefaultTTLOption(netstack.DefaultTTL))
 	s.Stack.SetNetworkProtocolOption(ipv6.ProtocolNumber, tcpip.DefaultTTLOption(netstack.DefaultTTL))
@@ -1056,6 +1105,12 @@ func newEmptySandboxNetworkStack(clock tcpip.Clock, uniqueID stack.UniqueID) (in
 		return nil, fmt.Errorf("SetTransportProtocolOption failed: %v", err)
 	}
 
+	if loopbackInline {
+		if err := s.Stack.SetTransportProtocolOption(tcp.ProtocolNumber, tcp.LoopbackInlineEnabled(true)); err != nil {
+			return nil, fmt.Errorf("SetTransportProtocolOption failed: %v", err)
+		}
+	}
+
 	s.FillDefaultIPTables()
 
 	return &s, nil
@@ -1067,11 +1122,14 @@ func newEmptySandboxNetworkStack(clock tcpip.Clock, uniqueID stack.UniqueID) (in
 type sandboxNetstackCreator struct {
 	clock    tcpip.Clock
 	uniqueID stack.UniqueID
+
+	// loopbackInline is Config.TCPLoopbackInline.
+	loopbackInline bool
 }
 
 // CreateStack implements kernel.NetworkStackCreator.CreateStack.
 func (f *sandboxNetstackCreator) CreateStack() (inet.Stack, error) {
-	s, err := newEmptySandboxNetworkStack(f.clock, f.uniqueID)
+	s, err := newEmptySandboxNetworkStack(f.clock, f.uniqueID, f.loopbackInline)
 	if err != nil {
 		return nil, err
 	}
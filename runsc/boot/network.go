@@ -123,6 +123,7 @@ type FDBasedLink struct {
 	Routes             []Route
 	GSOMaxSize         uint32
 	SoftwareGSOEnabled bool
+	GROEnabled         bool
 	LinkAddress        net.HardwareAddr
 	QDisc              QueueingDiscipline
 
@@ -236,6 +237,7 @@ func (n *Network) CreateLinksAndRoutes(args *CreateLinksAndRoutesArgs, _ *struct
 			PacketDispatchMode: fdbased.RecvMMsg,
 			GSOMaxSize:         link.GSOMaxSize,
 			SoftwareGSOEnabled: link.SoftwareGSOEnabled,
+			GROEnabled:         link.GROEnabled,
 			RXChecksumOffload:  true,
 		})
 		if err != nil {
@@ -26,6 +26,7 @@ import (
 	"gvisor.dev/gvisor/pkg/fspath"
 	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/sentry/devices/memdev"
+	"gvisor.dev/gvisor/pkg/sentry/devices/syscalltracedev"
 	"gvisor.dev/gvisor/pkg/sentry/fs/user"
 	"gvisor.dev/gvisor/pkg/sentry/fsimpl/devpts"
 	"gvisor.dev/gvisor/pkg/sentry/fsimpl/devtmpfs"
@@ -70,6 +71,9 @@ func registerFilesystems(ctx context.Context, vfsObj *vfs.VirtualFilesystem, cre
 	if err := memdev.Register(vfsObj); err != nil {
 		return fmt.Errorf("registering memdev: %w", err)
 	}
+	if err := syscalltracedev.Register(vfsObj); err != nil {
+		return fmt.Errorf("registering syscalltracedev: %w", err)
+	}
 	a, err := devtmpfs.NewAccessor(ctx, vfsObj, creds, devtmpfs.Name)
 	if err != nil {
 		return fmt.Errorf("creating devtmpfs accessor: %w", err)
@@ -82,6 +86,9 @@ func registerFilesystems(ctx context.Context, vfsObj *vfs.VirtualFilesystem, cre
 	if err := memdev.CreateDevtmpfsFiles(ctx, a); err != nil {
 		return fmt.Errorf("creating devtmpfs files: %w", err)
 	}
+	if err := syscalltracedev.CreateDevtmpfsFiles(ctx, a); err != nil {
+		return fmt.Errorf("creating devtmpfs files: %w", err)
+	}
 	return nil
 }
 
@@ -254,6 +261,12 @@ func (c *containerMounter) getMountNameAndOptionsVFS2(conf *Config, m *mountAndF
 		fsName = gofer.Name
 		data = p9MountData(m.fd, c.getMountAccessType(m.Mount), true /* vfs2 */)
 
+		goferData, err := parseAndFilterOptions(m.Options, goferAllowedData...)
+		if err != nil {
+			return "", nil, err
+		}
+		data = append(data, goferData...)
+
 	default:
 		log.Warningf("ignoring unknown filesystem type %q", m.Type)
 	}
@@ -272,7 +285,11 @@ func (c *containerMounter) getMountNameAndOptionsVFS2(conf *Config, m *mountAndF
 		case "ro":
 			opts.ReadOnly = true
 		case "noatime":
-			// TODO(gvisor.dev/issue/1193): Implement MS_NOATIME.
+			opts.Flags.NoATime = true
+		case "strictatime":
+			opts.Flags.StrictATime = true
+		case "relatime":
+			opts.Flags.StrictATime = false
 		case "noexec":
 			opts.Flags.NoExec = true
 		default:
@@ -31,6 +31,10 @@ import (
 // File containing the container's saved image/state within the given image-path's directory.
 const checkpointFileName = "checkpoint.img"
 
+// File containing the container's application memory within the given
+// image-path's directory, if it was saved with --checkpoint-template.
+const pagesFileName = "pages.img"
+
 // Checkpoint implements subcommands.Command for the "checkpoint" command.
 type Checkpoint struct {
 	imagePath    string
@@ -97,7 +101,19 @@ func (c *Checkpoint) Execute(_ context.Context, f *flag.FlagSet, args ...interfa
 	}
 	defer file.Close()
 
-	if err := cont.Checkpoint(file); err != nil {
+	var pagesFile *os.File
+	if conf.CheckpointTemplate {
+		fullPagesPath := filepath.Join(c.imagePath, pagesFileName)
+		pagesFile, err = os.OpenFile(fullPagesPath, os.O_CREATE|os.O_EXCL|os.O_RDWR, 0644)
+		if err != nil {
+			Fatalf("os.OpenFile(%q) failed: %v", fullPagesPath, err)
+		}
+		defer pagesFile.Close()
+		// Restore from the pages file below if leaveRunning is set.
+		conf.RestorePagesFile = fullPagesPath
+	}
+
+	if err := cont.Checkpoint(file, pagesFile); err != nil {
 		Fatalf("checkpoint failed: %v", err)
 	}
 
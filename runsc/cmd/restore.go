@@ -16,6 +16,7 @@ package cmd
 
 import (
 	"context"
+	"os"
 	"path/filepath"
 	"syscall"
 
@@ -99,6 +100,11 @@ func (r *Restore) Execute(_ context.Context, f *flag.FlagSet, args ...interface{
 	}
 
 	conf.RestoreFile = filepath.Join(r.imagePath, checkpointFileName)
+	// An image saved with --checkpoint-template includes a pages file.
+	pagesPath := filepath.Join(r.imagePath, pagesFileName)
+	if _, err := os.Stat(pagesPath); err == nil {
+		conf.RestorePagesFile = pagesPath
+	}
 
 	runArgs := container.Args{
 		ID:            id,
@@ -637,12 +637,14 @@ func (c *Container) ForwardSignals(pid int32, fgProcess bool) func() {
 
 // Checkpoint sends the checkpoint call to the container.
 // The statefile will be written to f, the file at the specified image-path.
-func (c *Container) Checkpoint(f *os.File) error {
+// If pages is not nil, application memory is written to pages, from which it
+// can be restored quickly into any number of containers.
+func (c *Container) Checkpoint(f, pages *os.File) error {
 	log.Debugf("Checkpoint container %q", c.ID)
 	if err := c.requireStatus("checkpoint", Created, Running, Paused); err != nil {
 		return err
 	}
-	return c.Sandbox.Checkpoint(c.ID, f)
+	return c.Sandbox.Checkpoint(c.ID, f, pages)
 }
 
 // Pause suspends the container and its kernel.
@@ -26,6 +26,9 @@ var (
 	Bool        = flag.Bool
 	Int         = flag.Int
 	Uint        = flag.Uint
+	Uint64      = flag.Uint64
+	Float64     = flag.Float64
+	Duration    = flag.Duration
 	CommandLine = flag.CommandLine
 	Parse       = flag.Parse
 )
@@ -202,6 +202,7 @@ func (a *attachPoint) makeQID(stat syscall.Stat_t) p9.QID {
 // multiple files are only being opened for read (esp. startup).
 type localFile struct {
 	p9.DefaultWalkGetAttr
+	p9.DefaultMultiWalkGetAttr
 
 	// attachPoint is the attachPoint that serves this localFile.
 	attachPoint *attachPoint
@@ -229,6 +230,11 @@ type localFile struct {
 	// repositioned. This is an important optimization because the caller must
 	// always make one extra call to detect EOF (empty result, no error).
 	lastDirentOffset uint64
+
+	// readDirPending holds the names read from the host directory by the last
+	// call to Readdir() that didn't fit in its response. They are returned
+	// first by the next call at lastDirentOffset.
+	readDirPending []string
 }
 
 var procSelfFD *fd.FD
@@ -958,6 +964,7 @@ func (l *localFile) Readdir(offset uint64, count uint32) ([]p9.Dirent, error) {
 			return nil, extractErrno(err)
 		}
 		skip = offset
+		l.readDirPending = nil
 	}
 
 	dirents, err := l.readDirent(l.file.FD(), offset, count, skip)
@@ -972,43 +979,54 @@ func (l *localFile) Readdir(offset uint64, count uint32) ([]p9.Dirent, error) {
 	return dirents, err
 }
 
+// direntBaseSize is the size of a 9P directory entry without its name: a
+// 13-byte QID, an 8-byte offset, a 1-byte type and the 2-byte name length.
+const direntBaseSize = 24
+
+// readDirent returns the entries of the host directory f, after skipping skip
+// entries, whose encoding fits in count bytes. Entries that are read from the
+// host but don't fit are kept in l.readDirPending for the next call.
+//
+// Preconditions: l.readDirMu must be locked.
 func (l *localFile) readDirent(f int, offset uint64, count uint32, skip uint64) ([]p9.Dirent, error) {
 	var dirents []p9.Dirent
 
-	// Limit 'count' to cap the slice size that is returned.
-	const maxCount = 100000
-	if count > maxCount {
-		count = maxCount
-	}
-
 	// Pre-allocate buffers that will be reused to get partial results.
 	direntsBuf := make([]byte, 8192)
-	names := make([]string, 0, 100)
+	names := l.readDirPending
+	l.readDirPending = nil
 
-	end := offset + uint64(count)
-	for offset < end {
-		dirSize, err := syscall.ReadDirent(f, direntsBuf)
-		if err != nil {
-			return dirents, err
-		}
-		if dirSize <= 0 {
-			return dirents, nil
-		}
-
-		names := names[:0]
-		_, _, names = syscall.ParseDirent(direntsBuf[:dirSize], -1, names)
-
-		// Skip over entries that the caller is not interested in.
-		if skip > 0 {
-			if skip > uint64(len(names)) {
-				skip -= uint64(len(names))
-				names = names[:0]
-			} else {
+	size := uint32(0)
+	for {
+		if len(names) == 0 {
+			dirSize, err := syscall.ReadDirent(f, direntsBuf)
+			if err != nil {
+				return dirents, err
+			}
+			if dirSize <= 0 {
+				return dirents, nil
+			}
+			_, _, names = syscall.ParseDirent(direntsBuf[:dirSize], -1, nil)
+
+			// Skip over entries that the caller is not interested in.
+			if skip > 0 {
+				if skip > uint64(len(names)) {
+					skip -= uint64(len(names))
+					names = nil
+					continue
+				}
 				names = names[skip:]
 				skip = 0
 			}
 		}
-		for _, name := range names {
+		for i, name := range names {
+			size += direntBaseSize + uint32(len(name))
+			if size > count && len(dirents) > 0 {
+				// The response is full. Don't stat the remaining entries
+				// until they are asked for.
+				l.readDirPending = names[i:]
+				return dirents, nil
+			}
 			stat, err := statAt(l.file.FD(), name)
 			if err != nil {
 				log.Warningf("Readdir is skipping file with failed stat %q, err: %v", l.hostPath, err)
@@ -1023,8 +1041,8 @@ func (l *localFile) readDirent(f int, offset uint64, count uint32, skip uint64)
 				Offset: offset,
 			})
 		}
+		names = nil
 	}
-	return dirents, nil
 }
 
 // Readlink implements p9.File.
@@ -526,12 +526,12 @@ func TestReaddir(t *testing.T) {
 			t.Fatalf("%v: Open(ReadOnly) failed, err: %v", s, err)
 		}
 
-		dirents, err := s.file.Readdir(0, 10)
+		dirents, err := s.file.Readdir(0, 1024)
 		if err != nil {
-			t.Fatalf("%v: Readdir(0, 10) failed, err: %v", s, err)
+			t.Fatalf("%v: Readdir(0, 1024) failed, err: %v", s, err)
 		}
 		if len(dirents) != 3 {
-			t.Fatalf("%v: Readdir(0, 10) wrong number of items, got: %v, expected: 3", s, len(dirents))
+			t.Fatalf("%v: Readdir(0, 1024) wrong number of items, got: %v, expected: 3", s, len(dirents))
 		}
 		var dir, symlink, file bool
 		for _, d := range dirents {
@@ -568,7 +568,53 @@ func TestReaddir(t *testing.T) {
 			}
 		}
 		if !dir || !symlink || !file {
-			t.Errorf("%v: Readdir(0, 10) wrong files returned, dir: %v, symlink: %v, file: %v", s, dir, symlink, file)
+			t.Errorf("%v: Readdir(0, 1024) wrong files returned, dir: %v, symlink: %v, file: %v", s, dir, symlink, file)
+		}
+	})
+}
+
+// Test that Readdir() returns only the entries that fit in count bytes, and
+// that continuing from the last offset returns each remaining entry once.
+func TestReaddirPartial(t *testing.T) {
+	runCustom(t, []fileType{directory}, rwConfs, func(t *testing.T, s state) {
+		const files = 10
+		for i := 0; i < files; i++ {
+			name := fmt.Sprintf("file%d", i)
+			_, f, _, _, err := s.file.Create(name, p9.ReadWrite, 0555, p9.UID(os.Getuid()), p9.GID(os.Getgid()))
+			if err != nil {
+				t.Fatalf("%v: createFile(root, %q) failed, err: %v", s, name, err)
+			}
+			f.Close()
+		}
+
+		if _, _, _, err := s.file.Open(p9.ReadOnly); err != nil {
+			t.Fatalf("%v: Open(ReadOnly) failed, err: %v", s, err)
+		}
+
+		// Each entry takes direntBaseSize+5 bytes, so 3 fit in a response.
+		const count = 3*(direntBaseSize+5) + 1
+		seen := make(map[string]bool)
+		for off := uint64(0); ; {
+			dirents, err := s.file.Readdir(off, count)
+			if err != nil {
+				t.Fatalf("%v: Readdir(%d, %d) failed, err: %v", s, off, count, err)
+			}
+			if len(dirents) == 0 {
+				break
+			}
+			if len(dirents) > 3 {
+				t.Errorf("%v: Readdir(%d, %d) returned %d entries, expected at most 3", s, off, count, len(dirents))
+			}
+			for _, d := range dirents {
+				if seen[d.Name] {
+					t.Errorf("%v: Readdir returned %q twice", s, d.Name)
+				}
+				seen[d.Name] = true
+			}
+			off = dirents[len(dirents)-1].Offset
+		}
+		if len(seen) != files {
+			t.Errorf("%v: Readdir returned %d entries, expected: %d", s, len(seen), files)
 		}
 	})
 }
@@ -72,7 +72,9 @@ var (
 	network            = flag.String("network", "sandbox", "specifies which network to use: sandbox (default), host, none. Using network inside the sandbox is more secure because it's isolated from the host network.")
 	hardwareGSO        = flag.Bool("gso", true, "enable hardware segmentation offload if it is supported by a network device.")
 	softwareGSO        = flag.Bool("software-gso", true, "enable software segmentation offload when hardware ofload can't be enabled.")
+	gro                = flag.Bool("gro", false, "enable generic receive offload, coalescing received TCP segments before they are processed by the network stack.")
 	qDisc              = flag.String("qdisc", "fifo", "specifies which queueing discipline to apply by default to the non loopback nics used by the sandbox.")
+	tcpLoopbackInline  = flag.Bool("tcp-loopback-inline", false, "process TCP segments sent over loopback inside the sandbox on the sending thread when the receiving socket is idle, rather than handing them to another goroutine. Reduces latency and CPU use for loopback TCP.")
 	fileAccess         = flag.String("file-access", "exclusive", "specifies which filesystem to use for the root mount: exclusive (default), shared. Volume mounts are always shared.")
 	fsGoferHostUDS     = flag.Bool("fsgofer-host-uds", false, "allow the gofer to mount Unix Domain Sockets.")
 	overlay            = flag.Bool("overlay", false, "wrap filesystem mounts with writable overlay. All modifications are stored in memory inside the sandbox.")
@@ -81,11 +83,20 @@ var (
 	panicSignal        = flag.Int("panic-signal", -1, "register signal handling that panics. Usually set to SIGUSR2(12) to troubleshoot hangs. -1 disables it.")
 	profile            = flag.Bool("profile", false, "prepares the sandbox to use Golang profiler. Note that enabling profiler loosens the seccomp protection added to the sandbox (DO NOT USE IN PRODUCTION).")
 	netRaw             = flag.Bool("net-raw", false, "enable raw sockets. When false, raw sockets are disabled by removing CAP_NET_RAW from containers (`runsc exec` will still be able to utilize raw sockets). Raw sockets allow malicious containers to craft packets and potentially attack the network.")
-	numNetworkChannels = flag.Int("num-network-channels", 1, "number of underlying channels(FDs) to use for network link endpoints.")
+	numNetworkChannels = flag.Int("num-network-channels", 1, "number of underlying channels(FDs) to use for network link endpoints. Inbound packets are distributed among channels by flow hash, and each channel is serviced by its own goroutine. 0 uses one channel per CPU.")
 	rootless           = flag.Bool("rootless", false, "it allows the sandbox to be started with a user that is not root. Sandbox and Gofer processes may run with same privileges as current user.")
 	referenceLeakMode  = flag.String("ref-leak-mode", "disabled", "sets reference leak check mode: disabled (default), log-names, log-traces.")
 	cpuNumFromQuota    = flag.Bool("cpu-num-from-quota", false, "set cpu number to cpu quota (least integer greater or equal to quota value, but not less than 2)")
 	vfs2Enabled        = flag.Bool("vfs2", false, "TEST ONLY; use while VFSv2 is landing. This uses the new experimental VFS layer.")
+	vdsoSpinSleep      = flag.Duration("vdso-spin-sleep", 0, "longest nanosleep or clock_nanosleep that the VDSO performs by spinning on the CPU instead of trapping to the sandbox kernel. 0 (default) disables spinning. Only applications that call the VDSO's sleep functions directly benefit.")
+	numa               = flag.Bool("numa", false, "expose the host NUMA nodes available to the sandbox and honor NUMA memory policies set by applications with set_mempolicy and mbind.")
+	hostAffinity       = flag.Bool("host-affinity", false, "make CPU affinity masks set by applications with sched_setaffinity also constrain the host threads that run them.")
+	syscallTiming      = flag.Bool("syscall-timing", false, "measure the time each syscall spends in the sandbox kernel, reported in /proc/[pid]/task/[tid]/syscall_stats. Adds a clock read to every syscall.")
+	decommitBatchSize  = flag.Uint64("decommit-batch-size", 0, "maximum bytes of freed sandbox memory returned to the host between acquisitions of the memory file lock. 0 (default) uses 64MB.")
+	decommitDelay      = flag.Duration("decommit-delay", 0, "time to wait after sandbox memory is freed before returning it to the host, so that memory freed in quick succession is returned in fewer batches. 0 (default) returns freed memory as soon as possible.")
+	oomThreshold       = flag.Float64("oom-threshold", 0, "fraction of the container's memory limit above which the sandbox evicts cached file contents, then kills the process with the highest oom_score, rather than being killed as a whole by the host. File contents are cached until then. 0 (default) disables this.")
+	checkpointTemplate = flag.Bool("checkpoint-template", false, "save application memory in checkpoints to a separate, uncompressed pages file next to the checkpoint image, so that the image can be used as a template restored quickly into many sandboxes, which share the pages file in the host page cache.")
+	vdsoThreadCPUTime  = flag.Bool("vdso-thread-cputime", false, "serve clock_gettime(CLOCK_THREAD_CPUTIME_ID) from the VDSO after a thread's first call. Only safe for applications whose threads keep their own thread pointers, as glibc and musl do; runtimes that move thread pointers between threads may read another thread's clock.")
 
 	// Test flags, not to be used outside tests, ever.
 	testOnlyAllowRunAsCurrentUserWithoutChroot = flag.Bool("TESTONLY-unsafe-nonroot", false, "TEST ONLY; do not ever use! This skips many security measures that isolate the host from the sandbox.")
@@ -190,8 +201,12 @@ func main() {
 		cmd.Fatalf("%v", err)
 	}
 
-	if *numNetworkChannels <= 0 {
-		cmd.Fatalf("num_network_channels must be > 0, got: %d", *numNetworkChannels)
+	if *numNetworkChannels < 0 {
+		cmd.Fatalf("num_network_channels must be >= 0, got: %d", *numNetworkChannels)
+	}
+
+	if *oomThreshold < 0 || *oomThreshold > 1 {
+		cmd.Fatalf("oom-threshold must be between 0 and 1, got: %v", *oomThreshold)
 	}
 
 	refsLeakMode, err := boot.MakeRefsLeakMode(*referenceLeakMode)
@@ -223,6 +238,7 @@ func main() {
 		Network:            netType,
 		HardwareGSO:        *hardwareGSO,
 		SoftwareGSO:        *softwareGSO,
+		GRO:                *gro,
 		LogPackets:         *logPackets,
 		Platform:           platformType,
 		Strace:             *strace,
@@ -238,7 +254,17 @@ func main() {
 		OverlayfsStaleRead: *overlayfsStaleRead,
 		CPUNumFromQuota:    *cpuNumFromQuota,
 		VFS2:               *vfs2Enabled,
+		VDSOSpinSleep:      *vdsoSpinSleep,
+		NUMA:               *numa,
+		HostAffinity:       *hostAffinity,
+		SyscallTiming:      *syscallTiming,
+		VDSOThreadCPUTime:  *vdsoThreadCPUTime,
+		DecommitBatchSize:  *decommitBatchSize,
+		DecommitDelay:      *decommitDelay,
+		OOMThreshold:       *oomThreshold,
+		CheckpointTemplate: *checkpointTemplate,
 		QDisc:              queueingDiscipline,
+		TCPLoopbackInline:  *tcpLoopbackInline,
 		TestOnlyAllowRunAsCurrentUserWithoutChroot: *testOnlyAllowRunAsCurrentUserWithoutChroot,
 		TestOnlyTestNameEnv:                        *testOnlyTestNameEnv,
 	}
@@ -256,6 +256,16 @@ func (s *Sandbox) Restore(cid string, spec *specs.Spec, conf *boot.Config, filen
 		opt.FilePayload.Files = append(opt.FilePayload.Files, deviceFile)
 	}
 
+	if conf.RestorePagesFile != "" {
+		pf, err := os.Open(conf.RestorePagesFile)
+		if err != nil {
+			return fmt.Errorf("opening pages file %q failed: %v", conf.RestorePagesFile, err)
+		}
+		defer pf.Close()
+		opt.FilePayload.Files = append(opt.FilePayload.Files, pf)
+		opt.PagesFile = true
+	}
+
 	conn, err := s.sandboxConnect()
 	if err != nil {
 		return err
@@ -880,8 +890,9 @@ func (s *Sandbox) SignalProcess(cid string, pid int32, sig syscall.Signal, fgPro
 }
 
 // Checkpoint sends the checkpoint call for a container in the sandbox.
-// The statefile will be written to f.
-func (s *Sandbox) Checkpoint(cid string, f *os.File) error {
+// The statefile will be written to f, and application memory to pages if it is
+// not nil.
+func (s *Sandbox) Checkpoint(cid string, f, pages *os.File) error {
 	log.Debugf("Checkpoint sandbox %q", s.ID)
 	conn, err := s.sandboxConnect()
 	if err != nil {
@@ -894,6 +905,9 @@ func (s *Sandbox) Checkpoint(cid string, f *os.File) error {
 			Files: []*os.File{f},
 		},
 	}
+	if pages != nil {
+		opt.FilePayload.Files = append(opt.FilePayload.Files, pages)
+	}
 
 	if err := conn.Call(boot.ContainerCheckpoint, &opt, nil); err != nil {
 		return fmt.Errorf("checkpointing container %q: %v", cid, err)
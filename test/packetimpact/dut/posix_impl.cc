@@ -0,0 +1,856 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at //
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/packetimpact/dut/posix_impl.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test/packetimpact/proto/posix_server.grpc.pb.h"
+#include "test/packetimpact/proto/posix_server.pb.h"
+
+namespace {
+
+// Converts a sockaddr_storage to a Sockaddr message.
+::grpc::Status sockaddr_to_proto(const sockaddr_storage &addr,
+                                 socklen_t addrlen,
+                                 posix_server::Sockaddr *sockaddr_proto) {
+  switch (addr.ss_family) {
+    case AF_INET: {
+      auto addr_in = reinterpret_cast<const sockaddr_in *>(&addr);
+      auto response_in = sockaddr_proto->mutable_in();
+      response_in->set_family(addr_in->sin_family);
+      response_in->set_port(ntohs(addr_in->sin_port));
+      response_in->mutable_addr()->assign(
+          reinterpret_cast<const char *>(&addr_in->sin_addr.s_addr), 4);
+      return ::grpc::Status::OK;
+    }
+    case AF_INET6: {
+      auto addr_in6 = reinterpret_cast<const sockaddr_in6 *>(&addr);
+      auto response_in6 = sockaddr_proto->mutable_in6();
+      response_in6->set_family(addr_in6->sin6_family);
+      response_in6->set_port(ntohs(addr_in6->sin6_port));
+      response_in6->set_flowinfo(ntohl(addr_in6->sin6_flowinfo));
+      response_in6->mutable_addr()->assign(
+          reinterpret_cast<const char *>(&addr_in6->sin6_addr.s6_addr), 16);
+      response_in6->set_scope_id(ntohl(addr_in6->sin6_scope_id));
+      return ::grpc::Status::OK;
+    }
+  }
+  return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Unknown Sockaddr");
+}
+
+::grpc::Status proto_to_sockaddr(const posix_server::Sockaddr &sockaddr_proto,
+                                 sockaddr_storage *addr, socklen_t *addr_len) {
+  switch (sockaddr_proto.sockaddr_case()) {
+    case posix_server::Sockaddr::SockaddrCase::kIn: {
+      auto proto_in = sockaddr_proto.in();
+      if (proto_in.addr().size() != 4) {
+        return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "IPv4 address must be 4 bytes");
+      }
+      auto addr_in = reinterpret_cast<sockaddr_in *>(addr);
+      addr_in->sin_family = proto_in.family();
+      addr_in->sin_port = htons(proto_in.port());
+      proto_in.addr().copy(reinterpret_cast<char *>(&addr_in->sin_addr.s_addr),
+                           4);
+      *addr_len = sizeof(*addr_in);
+      break;
+    }
+    case posix_server::Sockaddr::SockaddrCase::kIn6: {
+      auto proto_in6 = sockaddr_proto.in6();
+      if (proto_in6.addr().size() != 16) {
+        return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "IPv6 address must be 16 bytes");
+      }
+      auto addr_in6 = reinterpret_cast<sockaddr_in6 *>(addr);
+      addr_in6->sin6_family = proto_in6.family();
+      addr_in6->sin6_port = htons(proto_in6.port());
+      addr_in6->sin6_flowinfo = htonl(proto_in6.flowinfo());
+      proto_in6.addr().copy(
+          reinterpret_cast<char *>(&addr_in6->sin6_addr.s6_addr), 16);
+      addr_in6->sin6_scope_id = htonl(proto_in6.scope_id());
+      *addr_len = sizeof(*addr_in6);
+      break;
+    }
+    case posix_server::Sockaddr::SockaddrCase::SOCKADDR_NOT_SET:
+    default:
+      return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Unknown Sockaddr");
+  }
+  return ::grpc::Status::OK;
+}
+
+// SendMsgBuffers holds a msghdr built from a Msghdr message by
+// proto_to_msghdr. The iovecs point into the message, which must outlive it.
+// hdr points into the other fields, so it must not be moved once built.
+struct SendMsgBuffers {
+  sockaddr_storage addr;
+  std::vector<iovec> iov;
+  std::vector<char> control;
+  msghdr hdr = {};
+};
+
+::grpc::Status proto_to_msghdr(const posix_server::Msghdr &msg_proto,
+                               SendMsgBuffers *msg) {
+  if (msg_proto.has_name()) {
+    socklen_t addr_len;
+    auto err = proto_to_sockaddr(msg_proto.name(), &msg->addr, &addr_len);
+    if (!err.ok()) {
+      return err;
+    }
+    msg->hdr.msg_name = &msg->addr;
+    msg->hdr.msg_namelen = addr_len;
+  }
+
+  for (const auto &iov : msg_proto.iov()) {
+    msg->iov.push_back({const_cast<char *>(iov.data()), iov.size()});
+  }
+  msg->hdr.msg_iov = msg->iov.data();
+  msg->hdr.msg_iovlen = msg->iov.size();
+
+  size_t controllen = 0;
+  for (const auto &cmsg : msg_proto.control()) {
+    controllen += CMSG_SPACE(cmsg.data().size());
+  }
+  if (controllen == 0) {
+    return ::grpc::Status::OK;
+  }
+  msg->control.assign(controllen, 0);
+  msg->hdr.msg_control = msg->control.data();
+  msg->hdr.msg_controllen = controllen;
+  cmsghdr *cmsg = CMSG_FIRSTHDR(&msg->hdr);
+  for (const auto &cmsg_proto : msg_proto.control()) {
+    cmsg->cmsg_level = cmsg_proto.level();
+    cmsg->cmsg_type = cmsg_proto.type();
+    cmsg->cmsg_len = CMSG_LEN(cmsg_proto.data().size());
+    memcpy(CMSG_DATA(cmsg), cmsg_proto.data().data(), cmsg_proto.data().size());
+    cmsg = CMSG_NXTHDR(&msg->hdr, cmsg);
+  }
+  return ::grpc::Status::OK;
+}
+
+// RecvMsgBuffers holds the buffers for receiving one message with recvmsg() or
+// recvmmsg(). hdr points into the other fields, so it must not be moved once
+// initialized.
+struct RecvMsgBuffers {
+  sockaddr_storage addr;
+  std::vector<std::vector<char>> bufs;
+  std::vector<iovec> iov;
+  std::vector<char> control;
+  msghdr hdr = {};
+
+  template <typename Lens>
+  void Init(const Lens &iov_lens, int controllen) {
+    for (int len : iov_lens) {
+      bufs.emplace_back(len);
+      iov.push_back({bufs.back().data(), bufs.back().size()});
+    }
+    control.assign(controllen, 0);
+    hdr.msg_name = &addr;
+    hdr.msg_namelen = sizeof(addr);
+    hdr.msg_iov = iov.data();
+    hdr.msg_iovlen = iov.size();
+    hdr.msg_control = control.data();
+    hdr.msg_controllen = control.size();
+  }
+};
+
+// Converts a msghdr filled in by recvmsg() or recvmmsg(), which received len
+// bytes, to a Msghdr message.
+::grpc::Status msghdr_to_proto(msghdr *hdr, size_t len,
+                               posix_server::Msghdr *msg_proto) {
+  for (size_t i = 0; i < hdr->msg_iovlen && len > 0; i++) {
+    const size_t n = std::min(len, hdr->msg_iov[i].iov_len);
+    msg_proto->add_iov(hdr->msg_iov[i].iov_base, n);
+    len -= n;
+  }
+  for (cmsghdr *cmsg = CMSG_FIRSTHDR(hdr); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+    auto *cmsg_proto = msg_proto->add_control();
+    cmsg_proto->set_level(cmsg->cmsg_level);
+    cmsg_proto->set_type(cmsg->cmsg_type);
+    cmsg_proto->set_data(CMSG_DATA(cmsg), cmsg->cmsg_len - CMSG_LEN(0));
+  }
+  msg_proto->set_flags(hdr->msg_flags);
+  if (hdr->msg_namelen == 0) {
+    return ::grpc::Status::OK;
+  }
+  return sockaddr_to_proto(*static_cast<sockaddr_storage *>(hdr->msg_name),
+                           hdr->msg_namelen, msg_proto->mutable_name());
+}
+
+// SyscallTimer records CLOCK_MONOTONIC timestamps around a syscall: the
+// entry time when it is constructed, and the exit time when Stop is called.
+// errno is preserved.
+class SyscallTimer {
+ public:
+  explicit SyscallTimer(posix_server::Timestamps *timestamps)
+      : timestamps_(timestamps) {
+    timestamps_->set_entry_nanos(MonotonicNanos());
+  }
+
+  void Stop() {
+    const int saved_errno = errno;
+    timestamps_->set_exit_nanos(MonotonicNanos());
+    errno = saved_errno;
+  }
+
+ private:
+  static int64_t MonotonicNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+
+  posix_server::Timestamps *const timestamps_;
+};
+
+class PosixImpl final : public posix_server::Posix::Service {
+  ::grpc::Status Accept(grpc_impl::ServerContext *context,
+                        const ::posix_server::AcceptRequest *request,
+                        ::posix_server::AcceptResponse *response) override {
+    sockaddr_storage addr;
+    socklen_t addrlen = sizeof(addr);
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_fd(accept(request->sockfd(),
+                            reinterpret_cast<sockaddr *>(&addr), &addrlen));
+    timer.Stop();
+    response->set_errno_(errno);
+    return sockaddr_to_proto(addr, addrlen, response->mutable_addr());
+  }
+
+  ::grpc::Status Batch(grpc_impl::ServerContext *context,
+                       const ::posix_server::BatchRequest *request,
+                       ::posix_server::BatchResponse *response) override {
+    // The fd returned by each operation run so far, or -1 if it did not return
+    // one.
+    std::vector<int> fds;
+    for (const auto &op : request->ops()) {
+      int fd = -1;
+      if (op.has_fd()) {
+        const uint32_t i = op.fd().op();
+        if (i >= fds.size() || fds[i] < 0) {
+          return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                "fd placeholder must refer to an earlier "
+                                "successful Accept or Socket");
+        }
+        fd = fds[i];
+      }
+
+      auto *result = response->add_results();
+      ::grpc::Status status;
+      int ret;
+      int new_fd = -1;
+      switch (op.request_case()) {
+        case ::posix_server::BatchRequest::Operation::kAccept: {
+          auto req = op.accept();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = Accept(context, &req, result->mutable_accept());
+          ret = new_fd = result->accept().fd();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kBind: {
+          auto req = op.bind();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = Bind(context, &req, result->mutable_bind());
+          ret = result->bind().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kClose: {
+          auto req = op.close();
+          if (op.has_fd()) {
+            req.set_fd(fd);
+          }
+          status = Close(context, &req, result->mutable_close());
+          ret = result->close().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kConnect: {
+          auto req = op.connect();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = Connect(context, &req, result->mutable_connect());
+          ret = result->connect().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kFcntl: {
+          auto req = op.fcntl();
+          if (op.has_fd()) {
+            req.set_fd(fd);
+          }
+          status = Fcntl(context, &req, result->mutable_fcntl());
+          ret = result->fcntl().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kGetSockName: {
+          auto req = op.get_sock_name();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = GetSockName(context, &req, result->mutable_get_sock_name());
+          ret = result->get_sock_name().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kGetSockOpt: {
+          auto req = op.get_sock_opt();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = GetSockOpt(context, &req, result->mutable_get_sock_opt());
+          ret = result->get_sock_opt().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kListen: {
+          auto req = op.listen();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = Listen(context, &req, result->mutable_listen());
+          ret = result->listen().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kSend: {
+          auto req = op.send();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = Send(context, &req, result->mutable_send());
+          ret = result->send().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kSendTo: {
+          auto req = op.send_to();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = SendTo(context, &req, result->mutable_send_to());
+          ret = result->send_to().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kSetSockOpt: {
+          auto req = op.set_sock_opt();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = SetSockOpt(context, &req, result->mutable_set_sock_opt());
+          ret = result->set_sock_opt().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kRecv: {
+          auto req = op.recv();
+          if (op.has_fd()) {
+            req.set_sockfd(fd);
+          }
+          status = Recv(context, &req, result->mutable_recv());
+          ret = result->recv().ret();
+          break;
+        }
+        case ::posix_server::BatchRequest::Operation::kSocket:
+          if (op.has_fd()) {
+            return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                  "fd placeholder not allowed for Socket");
+          }
+          status = Socket(context, &op.socket(), result->mutable_socket());
+          ret = new_fd = result->socket().fd();
+          break;
+        default:
+          return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                "Unknown operation");
+      }
+      if (!status.ok()) {
+        return status;
+      }
+
+      fds.push_back(new_fd);
+      if (ret < 0 && request->stop_on_error()) {
+        break;
+      }
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Bind(grpc_impl::ServerContext *context,
+                      const ::posix_server::BindRequest *request,
+                      ::posix_server::BindResponse *response) override {
+    if (!request->has_addr()) {
+      return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Missing address");
+    }
+
+    sockaddr_storage addr;
+    socklen_t addr_len;
+    auto err = proto_to_sockaddr(request->addr(), &addr, &addr_len);
+    if (!err.ok()) {
+      return err;
+    }
+
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(
+        bind(request->sockfd(), reinterpret_cast<sockaddr *>(&addr), addr_len));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Close(grpc_impl::ServerContext *context,
+                       const ::posix_server::CloseRequest *request,
+                       ::posix_server::CloseResponse *response) override {
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(close(request->fd()));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Connect(grpc_impl::ServerContext *context,
+                         const ::posix_server::ConnectRequest *request,
+                         ::posix_server::ConnectResponse *response) override {
+    if (!request->has_addr()) {
+      return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Missing address");
+    }
+    sockaddr_storage addr;
+    socklen_t addr_len;
+    auto err = proto_to_sockaddr(request->addr(), &addr, &addr_len);
+    if (!err.ok()) {
+      return err;
+    }
+
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(connect(request->sockfd(),
+                              reinterpret_cast<sockaddr *>(&addr), addr_len));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status EpollCreate(
+      grpc_impl::ServerContext *context,
+      const ::posix_server::EpollCreateRequest *request,
+      ::posix_server::EpollCreateResponse *response) override {
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_fd(epoll_create(request->size()));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status EpollCtl(grpc_impl::ServerContext *context,
+                          const ::posix_server::EpollCtlRequest *request,
+                          ::posix_server::EpollCtlResponse *response) override {
+    struct epoll_event event = {};
+    event.events = request->events();
+    event.data.u64 = request->data();
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(
+        epoll_ctl(request->epfd(), request->op(), request->fd(), &event));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status EpollWait(
+      grpc_impl::ServerContext *context,
+      const ::posix_server::EpollWaitRequest *request,
+      ::posix_server::EpollWaitResponse *response) override {
+    if (request->maxevents() <= 0) {
+      return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "maxevents must be positive");
+    }
+    std::vector<struct epoll_event> events(request->maxevents());
+    response->set_ret(epoll_wait(request->epfd(), events.data(),
+                                 events.size(), request->timeout_millis()));
+    response->set_errno_(errno);
+    for (int i = 0; i < response->ret(); i++) {
+      auto *event = response->add_events();
+      event->set_events(events[i].events);
+      event->set_data(events[i].data.u64);
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Fcntl(grpc_impl::ServerContext *context,
+                       const ::posix_server::FcntlRequest *request,
+                       ::posix_server::FcntlResponse *response) override {
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(::fcntl(request->fd(), request->cmd(), request->arg()));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status GetSockName(
+      grpc_impl::ServerContext *context,
+      const ::posix_server::GetSockNameRequest *request,
+      ::posix_server::GetSockNameResponse *response) override {
+    sockaddr_storage addr;
+    socklen_t addrlen = sizeof(addr);
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(getsockname(
+        request->sockfd(), reinterpret_cast<sockaddr *>(&addr), &addrlen));
+    timer.Stop();
+    response->set_errno_(errno);
+    return sockaddr_to_proto(addr, addrlen, response->mutable_addr());
+  }
+
+  ::grpc::Status GetSockOpt(
+      grpc_impl::ServerContext *context,
+      const ::posix_server::GetSockOptRequest *request,
+      ::posix_server::GetSockOptResponse *response) override {
+    switch (request->type()) {
+      case ::posix_server::GetSockOptRequest::BYTES: {
+        socklen_t optlen = request->optlen();
+        std::vector<char> buf(optlen);
+        SyscallTimer timer(response->mutable_timestamps());
+        response->set_ret(::getsockopt(request->sockfd(), request->level(),
+                                       request->optname(), buf.data(),
+                                       &optlen));
+        timer.Stop();
+        if (optlen >= 0) {
+          response->mutable_optval()->set_bytesval(buf.data(), optlen);
+        }
+        break;
+      }
+      case ::posix_server::GetSockOptRequest::INT: {
+        int intval = 0;
+        socklen_t optlen = sizeof(intval);
+        SyscallTimer timer(response->mutable_timestamps());
+        response->set_ret(::getsockopt(request->sockfd(), request->level(),
+                                       request->optname(), &intval, &optlen));
+        timer.Stop();
+        response->mutable_optval()->set_intval(intval);
+        break;
+      }
+      case ::posix_server::GetSockOptRequest::TIME: {
+        timeval tv;
+        socklen_t optlen = sizeof(tv);
+        SyscallTimer timer(response->mutable_timestamps());
+        response->set_ret(::getsockopt(request->sockfd(), request->level(),
+                                       request->optname(), &tv, &optlen));
+        timer.Stop();
+        response->mutable_optval()->mutable_timeval()->set_seconds(tv.tv_sec);
+        response->mutable_optval()->mutable_timeval()->set_microseconds(
+            tv.tv_usec);
+        break;
+      }
+      default:
+        return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "Unknown SockOpt Type");
+    }
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Listen(grpc_impl::ServerContext *context,
+                        const ::posix_server::ListenRequest *request,
+                        ::posix_server::ListenResponse *response) override {
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(listen(request->sockfd(), request->backlog()));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Poll(grpc_impl::ServerContext *context,
+                      const ::posix_server::PollRequest *request,
+                      ::posix_server::PollResponse *response) override {
+    std::vector<struct pollfd> pfds(request->pfds_size());
+    for (int i = 0; i < request->pfds_size(); i++) {
+      pfds[i].fd = request->pfds(i).fd();
+      pfds[i].events = request->pfds(i).events();
+    }
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(
+        poll(pfds.data(), pfds.size(), request->timeout_millis()));
+    timer.Stop();
+    response->set_errno_(errno);
+    for (const auto &pfd : pfds) {
+      auto *response_pfd = response->add_pfds();
+      response_pfd->set_fd(pfd.fd);
+      response_pfd->set_events(pfd.events);
+      response_pfd->set_revents(pfd.revents);
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Send(::grpc::ServerContext *context,
+                      const ::posix_server::SendRequest *request,
+                      ::posix_server::SendResponse *response) override {
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(::send(request->sockfd(), request->buf().data(),
+                             request->buf().size(), request->flags()));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status SendMmsg(grpc_impl::ServerContext *context,
+                          const ::posix_server::SendMmsgRequest *request,
+                          ::posix_server::SendMmsgResponse *response) override {
+    std::vector<SendMsgBuffers> msgs(request->msgs_size());
+    std::vector<mmsghdr> mmsgs(request->msgs_size());
+    for (int i = 0; i < request->msgs_size(); i++) {
+      auto err = proto_to_msghdr(request->msgs(i), &msgs[i]);
+      if (!err.ok()) {
+        return err;
+      }
+      mmsgs[i].msg_hdr = msgs[i].hdr;
+    }
+
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(sendmmsg(request->sockfd(), mmsgs.data(), mmsgs.size(),
+                               request->flags()));
+    timer.Stop();
+    response->set_errno_(errno);
+    for (int i = 0; i < response->ret(); i++) {
+      response->add_msg_lens(mmsgs[i].msg_len);
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status SendMsg(grpc_impl::ServerContext *context,
+                         const ::posix_server::SendMsgRequest *request,
+                         ::posix_server::SendMsgResponse *response) override {
+    SendMsgBuffers msg;
+    auto err = proto_to_msghdr(request->msg(), &msg);
+    if (!err.ok()) {
+      return err;
+    }
+
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(sendmsg(request->sockfd(), &msg.hdr, request->flags()));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status SendStream(
+      ::grpc::ServerContext *context,
+      ::grpc::ServerReader<::posix_server::SendRequest> *reader,
+      ::posix_server::SendStreamResponse *response) override {
+    // Reuse the request, and so its buffer, for every message.
+    ::posix_server::SendRequest request;
+    while (reader->Read(&request)) {
+      SyscallTimer timer(response->mutable_timestamps());
+      response->set_ret(::send(request.sockfd(), request.buf().data(),
+                               request.buf().size(), request.flags()));
+      timer.Stop();
+      response->set_errno_(errno);
+      if (response->ret() < 0) {
+        break;
+      }
+      response->set_count(response->count() + 1);
+      response->set_bytes(response->bytes() + response->ret());
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status SendTo(::grpc::ServerContext *context,
+                        const ::posix_server::SendToRequest *request,
+                        ::posix_server::SendToResponse *response) override {
+    if (!request->has_dest_addr()) {
+      return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Missing address");
+    }
+    sockaddr_storage addr;
+    socklen_t addr_len;
+    auto err = proto_to_sockaddr(request->dest_addr(), &addr, &addr_len);
+    if (!err.ok()) {
+      return err;
+    }
+
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(::sendto(request->sockfd(), request->buf().data(),
+                               request->buf().size(), request->flags(),
+                               reinterpret_cast<sockaddr *>(&addr), addr_len));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status SetSockOpt(
+      grpc_impl::ServerContext *context,
+      const ::posix_server::SetSockOptRequest *request,
+      ::posix_server::SetSockOptResponse *response) override {
+    switch (request->optval().val_case()) {
+      case ::posix_server::SockOptVal::kBytesval: {
+        SyscallTimer timer(response->mutable_timestamps());
+        response->set_ret(setsockopt(request->sockfd(), request->level(),
+                                     request->optname(),
+                                     request->optval().bytesval().c_str(),
+                                     request->optval().bytesval().size()));
+        timer.Stop();
+        break;
+      }
+      case ::posix_server::SockOptVal::kIntval: {
+        int opt = request->optval().intval();
+        SyscallTimer timer(response->mutable_timestamps());
+        response->set_ret(::setsockopt(request->sockfd(), request->level(),
+                                       request->optname(), &opt, sizeof(opt)));
+        timer.Stop();
+        break;
+      }
+      case ::posix_server::SockOptVal::kTimeval: {
+        timeval tv = {.tv_sec = static_cast<__time_t>(
+                          request->optval().timeval().seconds()),
+                      .tv_usec = static_cast<__suseconds_t>(
+                          request->optval().timeval().microseconds())};
+        SyscallTimer timer(response->mutable_timestamps());
+        response->set_ret(setsockopt(request->sockfd(), request->level(),
+                                     request->optname(), &tv, sizeof(tv)));
+        timer.Stop();
+        break;
+      }
+      default:
+        return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "Unknown SockOpt Type");
+    }
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Socket(grpc_impl::ServerContext *context,
+                        const ::posix_server::SocketRequest *request,
+                        ::posix_server::SocketResponse *response) override {
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_fd(
+        socket(request->domain(), request->type(), request->protocol()));
+    timer.Stop();
+    response->set_errno_(errno);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Recv(::grpc::ServerContext *context,
+                      const ::posix_server::RecvRequest *request,
+                      ::posix_server::RecvResponse *response) override {
+    // Receive directly into the response rather than copying from a
+    // temporary buffer.
+    std::string *buf = response->mutable_buf();
+    buf->resize(request->len());
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(
+        recv(request->sockfd(), &(*buf)[0], buf->size(), request->flags()));
+    timer.Stop();
+    response->set_errno_(errno);
+    buf->resize(std::max(response->ret(), 0));
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status RecvStream(
+      ::grpc::ServerContext *context,
+      const ::posix_server::RecvStreamRequest *request,
+      ::grpc::ServerWriter<::posix_server::RecvResponse> *writer) override {
+    // Reuse the buffer and response for every call.
+    std::vector<char> buf(request->len());
+    ::posix_server::RecvResponse response;
+    for (int i = 0; request->count() == 0 || i < request->count(); i++) {
+      if (context->IsCancelled()) {
+        break;
+      }
+      SyscallTimer timer(response.mutable_timestamps());
+      response.set_ret(
+          recv(request->sockfd(), buf.data(), buf.size(), request->flags()));
+      timer.Stop();
+      response.set_errno_(errno);
+      if (response.ret() >= 0) {
+        response.set_buf(buf.data(), response.ret());
+      } else {
+        response.clear_buf();
+      }
+      if (!writer->Write(response)) {
+        break;  // The client has gone away.
+      }
+      if (response.ret() <= 0) {
+        break;
+      }
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status RecvMmsg(grpc_impl::ServerContext *context,
+                          const ::posix_server::RecvMmsgRequest *request,
+                          ::posix_server::RecvMmsgResponse *response) override {
+    if (request->vlen() < 0) {
+      return ::grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "vlen must not be negative");
+    }
+    std::vector<RecvMsgBuffers> msgs(request->vlen());
+    std::vector<mmsghdr> mmsgs(request->vlen());
+    for (int i = 0; i < request->vlen(); i++) {
+      msgs[i].Init(request->iov_lens(), request->controllen());
+      mmsgs[i].msg_hdr = msgs[i].hdr;
+    }
+    timespec timeout;
+    timespec *timeoutp = nullptr;
+    if (request->has_timeout()) {
+      timeout.tv_sec = request->timeout().seconds();
+      timeout.tv_nsec = request->timeout().microseconds() * 1000;
+      timeoutp = &timeout;
+    }
+
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(recvmmsg(request->sockfd(), mmsgs.data(), mmsgs.size(),
+                               request->flags(), timeoutp));
+    timer.Stop();
+    response->set_errno_(errno);
+    for (int i = 0; i < response->ret(); i++) {
+      auto err = msghdr_to_proto(&mmsgs[i].msg_hdr, mmsgs[i].msg_len,
+                                 response->add_msgs());
+      if (!err.ok()) {
+        return err;
+      }
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status RecvMsg(grpc_impl::ServerContext *context,
+                         const ::posix_server::RecvMsgRequest *request,
+                         ::posix_server::RecvMsgResponse *response) override {
+    RecvMsgBuffers msg;
+    msg.Init(request->iov_lens(), request->controllen());
+
+    SyscallTimer timer(response->mutable_timestamps());
+    response->set_ret(recvmsg(request->sockfd(), &msg.hdr, request->flags()));
+    timer.Stop();
+    response->set_errno_(errno);
+    if (response->ret() < 0) {
+      return ::grpc::Status::OK;
+    }
+    return msghdr_to_proto(&msg.hdr, response->ret(), response->mutable_msg());
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<posix_server::Posix::Service> NewPosixService() {
+  return std::make_unique<PosixImpl>();
+}
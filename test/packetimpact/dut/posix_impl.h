@@ -0,0 +1,25 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at //
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GVISOR_TEST_PACKETIMPACT_DUT_POSIX_IMPL_H_
+#define GVISOR_TEST_PACKETIMPACT_DUT_POSIX_IMPL_H_
+
+#include <memory>
+
+#include "test/packetimpact/proto/posix_server.grpc.pb.h"
+
+// Returns an implementation of the Posix service, which makes the requested
+// syscalls on this host.
+std::unique_ptr<posix_server::Posix::Service> NewPosixService();
+
+#endif  // GVISOR_TEST_PACKETIMPACT_DUT_POSIX_IMPL_H_
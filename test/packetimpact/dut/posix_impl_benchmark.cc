@@ -0,0 +1,186 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of the Posix service handlers, called directly rather than
+// through gRPC, to measure the cost of handling an RPC on the DUT beyond the
+// syscall itself: sockaddr conversion, buffer copies and message allocation.
+//
+// Each benchmark takes one argument: 0 to allocate the request and response on
+// the heap for every call, as the sync server does, or 1 to allocate them on
+// an arena.
+
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "include/grpcpp/server_context.h"
+#include "test/packetimpact/dut/posix_impl.h"
+#include "test/packetimpact/proto/posix_server.grpc.pb.h"
+#include "test/packetimpact/proto/posix_server.pb.h"
+
+namespace {
+
+// Size of the buffer sent and received by BM_SendRecv.
+constexpr int kBufSize = 1024;
+
+// Handler calls a Posix service handler with a request and response allocated
+// on the heap or on an arena, and fails the benchmark if it fails.
+class Handler {
+ public:
+  explicit Handler(const benchmark::State &state)
+      : use_arena_(state.range(0) != 0) {}
+
+  template <typename Request, typename Response, typename Fill,
+            typename Method>
+  Response *Call(Method method, Fill fill) {
+    Request *request;
+    Response *response;
+    if (use_arena_) {
+      request = google::protobuf::Arena::CreateMessage<Request>(&arena_);
+      response = google::protobuf::Arena::CreateMessage<Response>(&arena_);
+    } else {
+      heap_request_.reset(new Request);
+      heap_response_.reset(new Response);
+      request = static_cast<Request *>(heap_request_.get());
+      response = static_cast<Response *>(heap_response_.get());
+    }
+    fill(request);
+    ::grpc::Status status = (service_.get()->*method)(&context_, request,
+                                                       response);
+    if (!status.ok()) {
+      std::cerr << "RPC failed: " << status.error_message() << std::endl;
+      abort();
+    }
+    return response;
+  }
+
+  // Done frees the messages of the last calls.
+  void Done() {
+    if (use_arena_) {
+      arena_.Reset();
+    }
+  }
+
+ private:
+  const bool use_arena_;
+  const std::unique_ptr<posix_server::Posix::Service> service_ =
+      NewPosixService();
+  ::grpc::ServerContext context_;
+  google::protobuf::Arena arena_;
+  std::unique_ptr<google::protobuf::Message> heap_request_;
+  std::unique_ptr<google::protobuf::Message> heap_response_;
+};
+
+using Service = posix_server::Posix::Service;
+
+// BM_SocketClose measures a Socket RPC followed by a Close RPC.
+void BM_SocketClose(benchmark::State &state) {
+  Handler handler(state);
+  for (auto _ : state) {
+    auto *socket = handler.Call<posix_server::SocketRequest,
+                                posix_server::SocketResponse>(
+        &Service::Socket, [](posix_server::SocketRequest *request) {
+          request->set_domain(AF_INET);
+          request->set_type(SOCK_DGRAM);
+        });
+    const int fd = socket->fd();
+    if (fd < 0) {
+      state.SkipWithError("socket failed");
+      return;
+    }
+    handler.Call<posix_server::CloseRequest, posix_server::CloseResponse>(
+        &Service::Close,
+        [fd](posix_server::CloseRequest *request) { request->set_fd(fd); });
+    handler.Done();
+  }
+}
+
+BENCHMARK(BM_SocketClose)->Arg(0)->Arg(1);
+
+// BM_BindGetSockName measures a Bind RPC and a GetSockName RPC on an IPv6
+// socket, which convert a Sockaddr message to a sockaddr and back.
+void BM_BindGetSockName(benchmark::State &state) {
+  Handler handler(state);
+  for (auto _ : state) {
+    const int fd = socket(AF_INET6, SOCK_DGRAM, 0);
+    if (fd < 0) {
+      state.SkipWithError("socket failed");
+      return;
+    }
+    handler.Call<posix_server::BindRequest, posix_server::BindResponse>(
+        &Service::Bind, [fd](posix_server::BindRequest *request) {
+          request->set_sockfd(fd);
+          auto *in6 = request->mutable_addr()->mutable_in6();
+          in6->set_family(AF_INET6);
+          in6->set_addr(std::string(reinterpret_cast<const char *>(
+                                        &in6addr_loopback),
+                                    sizeof(in6addr_loopback)));
+        });
+    handler.Call<posix_server::GetSockNameRequest,
+                 posix_server::GetSockNameResponse>(
+        &Service::GetSockName,
+        [fd](posix_server::GetSockNameRequest *request) {
+          request->set_sockfd(fd);
+        });
+    close(fd);
+    handler.Done();
+  }
+}
+
+BENCHMARK(BM_BindGetSockName)->Arg(0)->Arg(1);
+
+// BM_SendRecv measures a Send RPC and a Recv RPC of kBufSize bytes over a Unix
+// domain socket pair.
+void BM_SendRecv(benchmark::State &state) {
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_DGRAM, 0, sv) != 0) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+  const std::string buf(kBufSize, 'a');
+  Handler handler(state);
+  for (auto _ : state) {
+    handler.Call<posix_server::SendRequest, posix_server::SendResponse>(
+        &Service::Send, [&](posix_server::SendRequest *request) {
+          request->set_sockfd(sv[0]);
+          request->set_buf(buf);
+        });
+    auto *recv =
+        handler.Call<posix_server::RecvRequest, posix_server::RecvResponse>(
+            &Service::Recv, [&](posix_server::RecvRequest *request) {
+              request->set_sockfd(sv[1]);
+              request->set_len(kBufSize);
+            });
+    if (recv->ret() != kBufSize) {
+      state.SkipWithError("recv failed");
+      break;
+    }
+    handler.Done();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(kBufSize) * state.iterations());
+  close(sv[0]);
+  close(sv[1]);
+}
+
+BENCHMARK(BM_SendRecv)->Arg(0)->Arg(1);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -17,10 +17,12 @@ package testbench
 import (
 	"context"
 	"flag"
+	"io"
 	"net"
 	"strconv"
 	"syscall"
 	"testing"
+	"time"
 
 	pb "gvisor.dev/gvisor/test/packetimpact/proto/posix_server_go_proto"
 
@@ -150,6 +152,15 @@ func (dut *DUT) CreateListener(typ, proto, backlog int32) (int32, uint16) {
 	return fd, remotePort
 }
 
+// timeoutMillis converts timeout to milliseconds for poll and epoll_wait,
+// where a negative timeout waits indefinitely.
+func timeoutMillis(timeout time.Duration) int32 {
+	if timeout < 0 {
+		return -1
+	}
+	return int32(timeout / time.Millisecond)
+}
+
 // All the functions that make gRPC calls to the POSIX service are below, sorted
 // alphabetically.
 
@@ -180,6 +191,24 @@ func (dut *DUT) AcceptWithErrno(ctx context.Context, sockfd int32) (int32, unix.
 	return resp.GetFd(), dut.protoToSockaddr(resp.GetAddr()), syscall.Errno(resp.GetErrno_())
 }
 
+// Batch runs ops on the DUT back to back in a single RPC, so that there is no
+// round trip between them, and returns the result of each operation run. If
+// stopOnError is set, operations after the first one that returns a negative
+// value are not run. Each operation may use the fd returned by an earlier
+// Accept or Socket in ops through its Fd placeholder.
+func (dut *DUT) Batch(ctx context.Context, ops []*pb.BatchRequest_Operation, stopOnError bool) []*pb.BatchResponse_Result {
+	dut.t.Helper()
+	req := pb.BatchRequest{
+		Ops:         ops,
+		StopOnError: stopOnError,
+	}
+	resp, err := dut.posixServer.Batch(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call Batch: %s", err)
+	}
+	return resp.GetResults()
+}
+
 // Bind calls bind on the DUT and causes a fatal test failure if it doesn't
 // succeed. If more control over the timeout or error handling is
 // needed, use BindWithErrno.
@@ -262,6 +291,94 @@ func (dut *DUT) ConnectWithErrno(ctx context.Context, fd int32, sa unix.Sockaddr
 	return resp.GetRet(), syscall.Errno(resp.GetErrno_())
 }
 
+// EpollCreate calls epoll_create on the DUT and causes a fatal test failure if
+// it doesn't succeed. If more control over the timeout or error handling is
+// needed, use EpollCreateWithErrno.
+func (dut *DUT) EpollCreate(size int32) int32 {
+	dut.t.Helper()
+	ctx, cancel := context.WithTimeout(context.Background(), RPCTimeout)
+	defer cancel()
+	fd, err := dut.EpollCreateWithErrno(ctx, size)
+	if fd < 0 {
+		dut.t.Fatalf("failed to epoll_create: %s", err)
+	}
+	return fd
+}
+
+// EpollCreateWithErrno calls epoll_create on the DUT.
+func (dut *DUT) EpollCreateWithErrno(ctx context.Context, size int32) (int32, error) {
+	dut.t.Helper()
+	req := pb.EpollCreateRequest{
+		Size: size,
+	}
+	resp, err := dut.posixServer.EpollCreate(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call EpollCreate: %s", err)
+	}
+	return resp.GetFd(), syscall.Errno(resp.GetErrno_())
+}
+
+// EpollCtl calls epoll_ctl on the DUT and causes a fatal test failure if it
+// doesn't succeed. Events on fd are reported with data. If more control over
+// the timeout or error handling is needed, use EpollCtlWithErrno.
+func (dut *DUT) EpollCtl(epfd, op, fd int32, events uint32, data uint64) {
+	dut.t.Helper()
+	ctx, cancel := context.WithTimeout(context.Background(), RPCTimeout)
+	defer cancel()
+	ret, err := dut.EpollCtlWithErrno(ctx, epfd, op, fd, events, data)
+	if ret != 0 {
+		dut.t.Fatalf("failed to epoll_ctl: %s", err)
+	}
+}
+
+// EpollCtlWithErrno calls epoll_ctl on the DUT.
+func (dut *DUT) EpollCtlWithErrno(ctx context.Context, epfd, op, fd int32, events uint32, data uint64) (int32, error) {
+	dut.t.Helper()
+	req := pb.EpollCtlRequest{
+		Epfd:   epfd,
+		Op:     op,
+		Fd:     fd,
+		Events: events,
+		Data:   data,
+	}
+	resp, err := dut.posixServer.EpollCtl(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call EpollCtl: %s", err)
+	}
+	return resp.GetRet(), syscall.Errno(resp.GetErrno_())
+}
+
+// EpollWait calls epoll_wait on the DUT, waiting up to timeout on the DUT, and
+// causes a fatal test failure if it doesn't succeed. timeout must not be
+// negative. If more control over the timeout or error handling is needed, use
+// EpollWaitWithErrno.
+func (dut *DUT) EpollWait(epfd, maxevents int32, timeout time.Duration) []*pb.EpollEvent {
+	dut.t.Helper()
+	ctx, cancel := context.WithTimeout(context.Background(), RPCTimeout+timeout)
+	defer cancel()
+	ret, events, err := dut.EpollWaitWithErrno(ctx, epfd, maxevents, timeout)
+	if ret < 0 {
+		dut.t.Fatalf("failed to epoll_wait: %s", err)
+	}
+	return events
+}
+
+// EpollWaitWithErrno calls epoll_wait on the DUT, waiting up to timeout on the
+// DUT. A negative timeout waits indefinitely.
+func (dut *DUT) EpollWaitWithErrno(ctx context.Context, epfd, maxevents int32, timeout time.Duration) (int32, []*pb.EpollEvent, error) {
+	dut.t.Helper()
+	req := pb.EpollWaitRequest{
+		Epfd:          epfd,
+		Maxevents:     maxevents,
+		TimeoutMillis: timeoutMillis(timeout),
+	}
+	resp, err := dut.posixServer.EpollWait(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call EpollWait: %s", err)
+	}
+	return resp.GetRet(), resp.GetEvents(), syscall.Errno(resp.GetErrno_())
+}
+
 // Fcntl calls fcntl on the DUT and causes a fatal test failure if it
 // doesn't succeed. If more control over the timeout or error handling is
 // needed, use FcntlWithErrno.
@@ -448,6 +565,49 @@ func (dut *DUT) ListenWithErrno(ctx context.Context, sockfd, backlog int32) (int
 	return resp.GetRet(), syscall.Errno(resp.GetErrno_())
 }
 
+// Poll calls poll on the DUT, waiting up to timeout on the DUT, and causes a
+// fatal test failure if it doesn't succeed. timeout must not be negative. It
+// returns pfds with Revents set. If more control over the timeout or error
+// handling is needed, use PollWithErrno.
+func (dut *DUT) Poll(pfds []unix.PollFd, timeout time.Duration) []unix.PollFd {
+	dut.t.Helper()
+	ctx, cancel := context.WithTimeout(context.Background(), RPCTimeout+timeout)
+	defer cancel()
+	ret, result, err := dut.PollWithErrno(ctx, pfds, timeout)
+	if ret < 0 {
+		dut.t.Fatalf("failed to poll: %s", err)
+	}
+	return result
+}
+
+// PollWithErrno calls poll on the DUT, waiting up to timeout on the DUT. A
+// negative timeout waits indefinitely.
+func (dut *DUT) PollWithErrno(ctx context.Context, pfds []unix.PollFd, timeout time.Duration) (int32, []unix.PollFd, error) {
+	dut.t.Helper()
+	req := pb.PollRequest{
+		TimeoutMillis: timeoutMillis(timeout),
+	}
+	for _, pfd := range pfds {
+		req.Pfds = append(req.Pfds, &pb.PollFd{
+			Fd:     pfd.Fd,
+			Events: uint32(pfd.Events),
+		})
+	}
+	resp, err := dut.posixServer.Poll(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call Poll: %s", err)
+	}
+	var result []unix.PollFd
+	for _, pfd := range resp.GetPfds() {
+		result = append(result, unix.PollFd{
+			Fd:      pfd.GetFd(),
+			Events:  int16(pfd.GetEvents()),
+			Revents: int16(pfd.GetRevents()),
+		})
+	}
+	return resp.GetRet(), result, syscall.Errno(resp.GetErrno_())
+}
+
 // Send calls send on the DUT and causes a fatal test failure if it doesn't
 // succeed. If more control over the timeout or error handling is needed, use
 // SendWithErrno.
@@ -477,6 +637,68 @@ func (dut *DUT) SendWithErrno(ctx context.Context, sockfd int32, buf []byte, fla
 	return resp.GetRet(), syscall.Errno(resp.GetErrno_())
 }
 
+// SendMmsgWithErrno calls sendmmsg on the DUT with msgs, and returns the
+// number of messages sent and the bytes sent for each of them.
+func (dut *DUT) SendMmsgWithErrno(ctx context.Context, sockfd int32, msgs []*pb.Msghdr, flags int32) (int32, []uint32, error) {
+	dut.t.Helper()
+	req := pb.SendMmsgRequest{
+		Sockfd: sockfd,
+		Msgs:   msgs,
+		Flags:  flags,
+	}
+	resp, err := dut.posixServer.SendMmsg(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call SendMmsg: %s", err)
+	}
+	return resp.GetRet(), resp.GetMsgLens(), syscall.Errno(resp.GetErrno_())
+}
+
+// SendMsgWithErrno calls sendmsg on the DUT with msg, whose iovecs and control
+// messages, such as UDP_SEGMENT, are passed through as given.
+func (dut *DUT) SendMsgWithErrno(ctx context.Context, sockfd int32, msg *pb.Msghdr, flags int32) (int32, error) {
+	dut.t.Helper()
+	req := pb.SendMsgRequest{
+		Sockfd: sockfd,
+		Msg:    msg,
+		Flags:  flags,
+	}
+	resp, err := dut.posixServer.SendMsg(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call SendMsg: %s", err)
+	}
+	return resp.GetRet(), syscall.Errno(resp.GetErrno_())
+}
+
+// SendStream calls send on the DUT with each of bufs in turn, in a single
+// streaming RPC, stopping at the first failure. It returns the total number of
+// bytes sent and the errno of the last send.
+func (dut *DUT) SendStream(ctx context.Context, sockfd int32, bufs [][]byte, flags int32) (int64, error) {
+	dut.t.Helper()
+	stream, err := dut.posixServer.SendStream(ctx)
+	if err != nil {
+		dut.t.Fatalf("failed to call SendStream: %s", err)
+	}
+	req := pb.SendRequest{
+		Sockfd: sockfd,
+		Flags:  flags,
+	}
+	for _, buf := range bufs {
+		req.Buf = buf
+		if err := stream.Send(&req); err == io.EOF {
+			// The server stopped after a failed send; CloseAndRecv returns
+			// the result.
+			break
+		} else if err != nil {
+			dut.t.Fatalf("failed to send to SendStream: %s", err)
+		}
+	}
+	resp, err := stream.CloseAndRecv()
+	if err != nil {
+		dut.t.Fatalf("failed to close SendStream: %s", err)
+	}
+	return resp.GetBytes(), syscall.Errno(resp.GetErrno_())
+}
+
 // SendTo calls sendto on the DUT and causes a fatal test failure if it doesn't
 // succeed. If more control over the timeout or error handling is needed, use
 // SendToWithErrno.
@@ -656,3 +878,77 @@ func (dut *DUT) RecvWithErrno(ctx context.Context, sockfd, len, flags int32) (in
 	}
 	return resp.GetRet(), resp.GetBuf(), syscall.Errno(resp.GetErrno_())
 }
+
+// RecvStream calls recv on the DUT count times, or until it fails or returns
+// 0 if count is 0, in a single streaming RPC. It calls cb with the result of
+// each recv, and stops early if cb returns false.
+func (dut *DUT) RecvStream(ctx context.Context, sockfd, len, flags, count int32, cb func(ret int32, buf []byte, err error) bool) {
+	dut.t.Helper()
+	ctx, cancel := context.WithCancel(ctx)
+	defer cancel()
+	req := pb.RecvStreamRequest{
+		Sockfd: sockfd,
+		Len:    len,
+		Flags:  flags,
+		Count:  count,
+	}
+	stream, err := dut.posixServer.RecvStream(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call RecvStream: %s", err)
+	}
+	for {
+		resp, err := stream.Recv()
+		if err == io.EOF {
+			return
+		}
+		if err != nil {
+			dut.t.Fatalf("failed to receive from RecvStream: %s", err)
+		}
+		if !cb(resp.GetRet(), resp.GetBuf(), syscall.Errno(resp.GetErrno_())) {
+			return
+		}
+	}
+}
+
+// RecvMmsgWithErrno calls recvmmsg on the DUT for up to vlen messages, each
+// received into iovecs of iovLens bytes and a control buffer of controllen
+// bytes. A nil timeout waits indefinitely.
+func (dut *DUT) RecvMmsgWithErrno(ctx context.Context, sockfd, vlen int32, iovLens []int32, controllen, flags int32, timeout *unix.Timeval) (int32, []*pb.Msghdr, error) {
+	dut.t.Helper()
+	req := pb.RecvMmsgRequest{
+		Sockfd:     sockfd,
+		Vlen:       vlen,
+		IovLens:    iovLens,
+		Controllen: controllen,
+		Flags:      flags,
+	}
+	if timeout != nil {
+		req.Timeout = &pb.Timeval{
+			Seconds:      timeout.Sec,
+			Microseconds: timeout.Usec,
+		}
+	}
+	resp, err := dut.posixServer.RecvMmsg(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call RecvMmsg: %s", err)
+	}
+	return resp.GetRet(), resp.GetMsgs(), syscall.Errno(resp.GetErrno_())
+}
+
+// RecvMsgWithErrno calls recvmsg on the DUT, receiving into iovecs of iovLens
+// bytes and a control buffer of controllen bytes, and returns the message
+// received, including control messages such as UDP_GRO.
+func (dut *DUT) RecvMsgWithErrno(ctx context.Context, sockfd int32, iovLens []int32, controllen, flags int32) (int32, *pb.Msghdr, error) {
+	dut.t.Helper()
+	req := pb.RecvMsgRequest{
+		Sockfd:     sockfd,
+		IovLens:    iovLens,
+		Controllen: controllen,
+		Flags:      flags,
+	}
+	resp, err := dut.posixServer.RecvMsg(ctx, &req)
+	if err != nil {
+		dut.t.Fatalf("failed to call RecvMsg: %s", err)
+	}
+	return resp.GetRet(), resp.GetMsg(), syscall.Errno(resp.GetErrno_())
+}
@@ -0,0 +1,124 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package tcp_rack_tlp_test
+
+import (
+	"bytes"
+	"flag"
+	"testing"
+	"time"
+
+	"golang.org/x/sys/unix"
+	"gvisor.dev/gvisor/pkg/tcpip/header"
+	"gvisor.dev/gvisor/pkg/tcpip/seqnum"
+	tb "gvisor.dev/gvisor/test/packetimpact/testbench"
+)
+
+func init() {
+	tb.RegisterFlags(flag.CommandLine)
+}
+
+// minRTO is the smallest retransmission timeout used by both Linux and
+// netstack. Tail losses that are repaired sooner than this were not repaired
+// by the retransmission timer.
+const minRTO = 200 * time.Millisecond
+
+// TestTailLossRecovery drops the last three segments of a flight sent by the
+// DUT and checks that the DUT sends a tail loss probe and, once the probe is
+// SACKed, retransmits the lost segments, all well within the minimum RTO.
+func TestTailLossRecovery(t *testing.T) {
+	const (
+		numSegments = 5
+		numLost     = 3
+		payloadSize = 100
+	)
+
+	dut := tb.NewDUT(t)
+	defer dut.TearDown()
+	listenFD, remotePort := dut.CreateListener(unix.SOCK_STREAM, unix.IPPROTO_TCP, 1)
+	defer dut.Close(listenFD)
+	conn := tb.NewTCPIPv4(t, tb.TCP{DstPort: &remotePort}, tb.TCP{SrcPort: &remotePort})
+	defer conn.Close()
+
+	// Negotiate SACK, which RACK-TLP depends on.
+	synOptions := make([]byte, 4)
+	header.EncodeNOP(synOptions[0:])
+	header.EncodeNOP(synOptions[1:])
+	header.EncodeSACKPermittedOption(synOptions[2:])
+	conn.Send(tb.TCP{Flags: tb.Uint8(header.TCPFlagSyn), Options: synOptions})
+	synAck, err := conn.Expect(tb.TCP{Flags: tb.Uint8(header.TCPFlagSyn | header.TCPFlagAck)}, time.Second)
+	if err != nil {
+		t.Fatalf("didn't get synack during handshake: %s", err)
+	}
+	if !header.ParseSynOptions(synAck.Options, true).SACKPermitted {
+		t.Fatalf("expected SACK permitted option in synack, got options %v", synAck.Options)
+	}
+	conn.Send(tb.TCP{Flags: tb.Uint8(header.TCPFlagAck)})
+	acceptFD, _ := dut.Accept(listenFD)
+	defer dut.Close(acceptFD)
+
+	dut.SetSockOptInt(acceptFD, unix.IPPROTO_TCP, unix.TCP_NODELAY, 1)
+
+	// Have the DUT send a series of distinct segments. Acknowledge the
+	// first ones right away, which gives the DUT its RTT samples, and treat
+	// the last numLost as lost.
+	firstLost := numSegments - numLost
+	var seqs [numSegments]seqnum.Value
+	var payloads [numSegments]*tb.Payload
+	for i := range payloads {
+		data := bytes.Repeat([]byte{byte('a' + i)}, payloadSize)
+		payloads[i] = &tb.Payload{Bytes: data}
+		seqs[i] = *conn.RemoteSeqNum()
+		dut.Send(acceptFD, data, 0)
+		if _, err := conn.ExpectData(&tb.TCP{SeqNum: tb.Uint32(uint32(seqs[i]))}, payloads[i], time.Second); err != nil {
+			t.Fatalf("expected segment %d: %s", i, err)
+		}
+		if i < firstLost {
+			conn.Send(tb.TCP{Flags: tb.Uint8(header.TCPFlagAck)})
+		}
+	}
+	start := time.Now()
+
+	// Without any further ACKs, the DUT should probe by retransmitting the
+	// last segment.
+	last := numSegments - 1
+	if _, err := conn.ExpectData(&tb.TCP{SeqNum: tb.Uint32(uint32(seqs[last]))}, payloads[last], minRTO); err != nil {
+		t.Fatalf("expected a tail loss probe before the RTO: %s", err)
+	}
+	t.Logf("tail loss probe after %s", time.Since(start))
+
+	// SACK the probe. Delay the SACK a little, so that the probe's RTT is
+	// no shorter than the DUT's earlier RTT samples and can't be mistaken
+	// for an ACK of the original transmission.
+	time.Sleep(10 * time.Millisecond)
+	// Two NOPs followed by a SACK option with a single block.
+	sackOptions := make([]byte, 12)
+	header.EncodeNOP(sackOptions[0:])
+	header.EncodeNOP(sackOptions[1:])
+	header.EncodeSACKBlocks([]header.SACKBlock{{seqs[last], seqs[last].Add(payloadSize)}}, sackOptions[2:])
+	conn.Send(tb.TCP{Flags: tb.Uint8(header.TCPFlagAck), AckNum: tb.Uint32(uint32(seqs[firstLost])), Options: sackOptions})
+
+	// A single SACK is short of the duplicate ACK threshold, but RACK
+	// infers that the remaining segments were lost from the delivery of the
+	// probe, so they should be retransmitted right away.
+	for i := firstLost; i < last; i++ {
+		if _, err := conn.ExpectData(&tb.TCP{SeqNum: tb.Uint32(uint32(seqs[i]))}, payloads[i], minRTO); err != nil {
+			t.Fatalf("expected retransmission of segment %d before the RTO: %s", i, err)
+		}
+	}
+	if elapsed := time.Since(start); elapsed >= 2*minRTO {
+		t.Errorf("took %s to recover from tail loss, want less than %s", elapsed, 2*minRTO)
+	}
+}
@@ -0,0 +1,125 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package tcp_rcv_buf_autotuning_test
+
+import (
+	"flag"
+	"testing"
+	"time"
+
+	"golang.org/x/sys/unix"
+	"gvisor.dev/gvisor/pkg/tcpip/header"
+	tb "gvisor.dev/gvisor/test/packetimpact/testbench"
+)
+
+func init() {
+	tb.RegisterFlags(flag.CommandLine)
+}
+
+// TestRcvBufAutoTuning emulates a bulk transfer to the DUT over a path with a
+// 50ms RTT, from a sender in slow start, and checks that the DUT grows its
+// advertised receive window as the application keeps up with the data.
+func TestRcvBufAutoTuning(t *testing.T) {
+	const (
+		rtt         = 50 * time.Millisecond
+		payloadSize = 1000
+		initialCwnd = 10
+		rounds      = 12
+	)
+
+	dut := tb.NewDUT(t)
+	defer dut.TearDown()
+	listenFD, remotePort := dut.CreateListener(unix.SOCK_STREAM, unix.IPPROTO_TCP, 1)
+	defer dut.Close(listenFD)
+	conn := tb.NewTCPIPv4(t, tb.TCP{DstPort: &remotePort}, tb.TCP{SrcPort: &remotePort})
+	defer conn.Close()
+
+	// Negotiate window scaling, so that the window can grow beyond 64KB,
+	// and timestamps, which the DUT may use to measure the RTT.
+	synOptions := make([]byte, 16)
+	synOptions[0], synOptions[1] = header.TCPOptionNOP, header.TCPOptionNOP
+	header.EncodeTSOption(currentTS(), 0, synOptions[2:])
+	synOptions[12] = header.TCPOptionNOP
+	header.EncodeWSOption(7, synOptions[13:])
+	conn.Send(tb.TCP{Flags: tb.Uint8(header.TCPFlagSyn), Options: synOptions})
+	synAck, err := conn.Expect(tb.TCP{Flags: tb.Uint8(header.TCPFlagSyn | header.TCPFlagAck)}, time.Second)
+	if err != nil {
+		t.Fatalf("didn't get synack during handshake: %s", err)
+	}
+	parsedSynOpts := header.ParseSynOptions(synAck.Options, true)
+	if !parsedSynOpts.TS || parsedSynOpts.WS < 0 {
+		t.Fatalf("expected TS and WS options from DUT, got %+v", parsedSynOpts)
+	}
+	wndShift := uint(parsedSynOpts.WS)
+	tsEcr := parsedSynOpts.TSVal
+	tsOptions := func() []byte {
+		options := make([]byte, 12)
+		options[0], options[1] = header.TCPOptionNOP, header.TCPOptionNOP
+		header.EncodeTSOption(currentTS(), tsEcr, options[2:])
+		return options
+	}
+	conn.Send(tb.TCP{Flags: tb.Uint8(header.TCPFlagAck), Options: tsOptions()})
+	acceptFD, _ := dut.Accept(listenFD)
+	defer dut.Close(acceptFD)
+
+	payload := make([]byte, payloadSize)
+	cwnd := initialCwnd
+	var initialWnd, wnd int
+	for i := 0; i < rounds; i++ {
+		// Send a flight of data, limited by the congestion window and
+		// the DUT's advertised window.
+		n := cwnd
+		if wnd != 0 && n > wnd/payloadSize {
+			n = wnd / payloadSize
+		}
+		for j := 0; j < n; j++ {
+			conn.Send(tb.TCP{Flags: tb.Uint8(header.TCPFlagAck), Options: tsOptions()}, &tb.Payload{Bytes: payload})
+		}
+
+		// The application reads all of it.
+		for want := n * payloadSize; want > 0; {
+			want -= len(dut.Recv(acceptFD, int32(want), 0))
+		}
+
+		// Elicit an ACK advertising the DUT's current window by sending
+		// a segment with an old sequence number.
+		conn.Drain()
+		conn.Send(tb.TCP{SeqNum: tb.Uint32(uint32(*conn.LocalSeqNum() - 1)), Flags: tb.Uint8(header.TCPFlagAck), Options: tsOptions()})
+		ack, err := conn.Expect(tb.TCP{Flags: tb.Uint8(header.TCPFlagAck)}, time.Second)
+		if err != nil {
+			t.Fatalf("expected an ACK in round %d: %s", i, err)
+		}
+		wnd = int(*ack.WindowSize) << wndShift
+		if i == 0 {
+			initialWnd = wnd
+		}
+		if opts := header.ParseTCPOptions(ack.Options); opts.TS {
+			tsEcr = opts.TSVal
+		}
+
+		// Wait out the rest of the round trip before sending the next,
+		// twice as large, flight.
+		cwnd *= 2
+		time.Sleep(rtt)
+	}
+
+	if wnd < 2*initialWnd {
+		t.Errorf("got advertised window %d after %d round trips, want at least twice the initial window %d", wnd, rounds, initialWnd)
+	}
+}
+
+func currentTS() uint32 {
+	return uint32(time.Now().UnixNano() / 1e6)
+}
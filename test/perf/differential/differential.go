@@ -0,0 +1,347 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Binary differential runs a benchmark binary from test/perf/linux natively
+// and in runsc on each of the given platforms, and reports the slowdown of
+// each benchmark relative to the native run.
+//
+// Usage:
+//
+//	differential [flags] path/to/benchmark_binary
+//
+// Sandboxed runs set TEST_ON_GVISOR like the syscall test runner, so
+// GvisorPlatform() in the benchmark binary returns the platform that the
+// results are tagged with.
+package main
+
+import (
+	"bytes"
+	"encoding/json"
+	"flag"
+	"fmt"
+	"io/ioutil"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"strings"
+	"syscall"
+	"text/tabwriter"
+
+	"gvisor.dev/gvisor/pkg/log"
+	"gvisor.dev/gvisor/pkg/test/testutil"
+	"gvisor.dev/gvisor/runsc/specutils"
+)
+
+var (
+	debug     = flag.Bool("debug", false, "enable debug logs")
+	platforms = flag.String("platforms", "ptrace,kvm", "comma-separated list of runsc platforms to compare against native")
+	overlay   = flag.Bool("overlay", false, "also run each platform with a writable tmpfs overlay")
+	filter    = flag.String("benchmark_filter", "all", "benchmarks to run")
+	minTime   = flag.Float64("benchmark_min_time", 0, "minimum time per benchmark, in seconds; 0 uses the binary's default")
+	runscPath = flag.String("runsc", "", "path to runsc binary")
+)
+
+// config is a configuration to run the benchmarks in.
+type config struct {
+	// platform is the runsc platform, or "native" to run on the host. It is
+	// the value returned by GvisorPlatform() in the benchmark binary.
+	platform string
+
+	// overlay wraps the root filesystem with a writable tmpfs overlay.
+	overlay bool
+}
+
+const native = "native"
+
+// String returns the name of the configuration, as used in the report.
+func (c config) String() string {
+	if c.overlay {
+		return c.platform + "_overlay"
+	}
+	return c.platform
+}
+
+// result is a single benchmark result in the benchmark JSON output.
+type result struct {
+	Name          string  `json:"name"`
+	RunType       string  `json:"run_type"`
+	ErrorOccurred bool    `json:"error_occurred"`
+	RealTime      float64 `json:"real_time"`
+	TimeUnit      string  `json:"time_unit"`
+}
+
+// nanoseconds returns the real time of r in nanoseconds.
+func (r result) nanoseconds() (float64, error) {
+	switch r.TimeUnit {
+	case "ns":
+		return r.RealTime, nil
+	case "us":
+		return r.RealTime * 1e3, nil
+	case "ms":
+		return r.RealTime * 1e6, nil
+	default:
+		return 0, fmt.Errorf("unknown time unit %q for %s", r.TimeUnit, r.Name)
+	}
+}
+
+// benchmarkArgs returns the arguments passed to the benchmark binary.
+func benchmarkArgs() []string {
+	args := []string{
+		"--benchmark_format=json",
+		"--benchmark_filter=" + *filter,
+		"--gtest_filter=",
+	}
+	if *minTime > 0 {
+		args = append(args, fmt.Sprintf("--benchmark_min_time=%g", *minTime))
+	}
+	return args
+}
+
+// filterEnv returns an environment with the blacklisted variables removed.
+func filterEnv(env, blacklist []string) []string {
+	var out []string
+	for _, kv := range env {
+		ok := true
+		for _, k := range blacklist {
+			if strings.HasPrefix(kv, k+"=") {
+				ok = false
+				break
+			}
+		}
+		if ok {
+			out = append(out, kv)
+		}
+	}
+	return out
+}
+
+// baseEnv returns the environment for the benchmark binary, with TEST_TMPDIR
+// set to tmpDir.
+func baseEnv(tmpDir string) []string {
+	// Remove env variables that cause the binary to write output files, or
+	// to interpret test sharding.
+	env := filterEnv(os.Environ(), []string{
+		"GUNIT_OUTPUT", "TEST_PREMATURE_EXIT_FILE", "XML_OUTPUT_FILE",
+		"TEST_SHARD_INDEX", "TEST_TOTAL_SHARDS", "GTEST_SHARD_INDEX", "GTEST_TOTAL_SHARDS",
+		"TEST_TMPDIR", "TEST_ON_GVISOR",
+	})
+	return append(env, "TEST_TMPDIR="+tmpDir)
+}
+
+// runNative runs the benchmarks on the host, and returns their JSON output.
+func runNative(testBin string) ([]byte, error) {
+	tmpDir, err := ioutil.TempDir(testutil.TmpDir(), "")
+	if err != nil {
+		return nil, fmt.Errorf("could not create temp dir: %v", err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	var stdout bytes.Buffer
+	cmd := exec.Command(testBin, benchmarkArgs()...)
+	cmd.Env = baseEnv(tmpDir)
+	cmd.Stdout = &stdout
+	cmd.Stderr = os.Stderr
+	if err := cmd.Run(); err != nil {
+		return nil, err
+	}
+	return stdout.Bytes(), nil
+}
+
+// runRunsc runs the benchmarks in runsc with configuration c, and returns
+// their JSON output.
+func runRunsc(testBin string, c config) ([]byte, error) {
+	spec := testutil.NewSpecWithArgs(append([]string{testBin}, benchmarkArgs()...)...)
+	spec.Root.Readonly = false
+	spec.Mounts = nil
+
+	// Use a gofer-backed directory as TEST_TMPDIR, as the syscall test
+	// runner does by default.
+	tmpDir, err := ioutil.TempDir(testutil.TmpDir(), "")
+	if err != nil {
+		return nil, fmt.Errorf("could not create temp dir: %v", err)
+	}
+	defer os.RemoveAll(tmpDir)
+	if err := os.Chmod(tmpDir, 0777); err != nil {
+		return nil, fmt.Errorf("could not chmod temp dir: %v", err)
+	}
+	spec.Process.Env = append(baseEnv(tmpDir), "TEST_ON_GVISOR="+c.platform, "GVISOR_NETWORK=none", "GVISOR_VFS=VFS1")
+
+	bundleDir, cleanup, err := testutil.SetupBundleDir(spec)
+	if err != nil {
+		return nil, fmt.Errorf("SetupBundleDir failed: %v", err)
+	}
+	defer cleanup()
+
+	rootDir, cleanup, err := testutil.SetupRootDir()
+	if err != nil {
+		return nil, fmt.Errorf("SetupRootDir failed: %v", err)
+	}
+	defer cleanup()
+
+	id := testutil.RandomContainerID()
+	log.Infof("Running %s in container %q with configuration %s", testBin, id, c)
+	args := []string{
+		"-root", rootDir,
+		"-network", "none",
+		"-log-format=text",
+		"-TESTONLY-unsafe-nonroot=true",
+		"-platform", c.platform,
+		"-file-access", "exclusive",
+	}
+	if c.overlay {
+		args = append(args, "-overlay")
+	}
+	if *debug {
+		args = append(args, "-debug")
+	}
+	args = append(args, "run", "--bundle", bundleDir, id)
+
+	// Current process doesn't have CAP_SYS_ADMIN, create user namespace and
+	// run as root inside that namespace to get it.
+	var stdout bytes.Buffer
+	cmd := exec.Command(*runscPath, args...)
+	cmd.SysProcAttr = &syscall.SysProcAttr{
+		Cloneflags: syscall.CLONE_NEWUSER | syscall.CLONE_NEWNS,
+		UidMappings: []syscall.SysProcIDMap{
+			{ContainerID: 0, HostID: os.Getuid(), Size: 1},
+		},
+		GidMappings: []syscall.SysProcIDMap{
+			{ContainerID: 0, HostID: os.Getgid(), Size: 1},
+		},
+		GidMappingsEnableSetgroups: false,
+		Credential: &syscall.Credential{
+			Uid: 0,
+			Gid: 0,
+		},
+	}
+	cmd.Stdout = &stdout
+	cmd.Stderr = os.Stderr
+	if err := cmd.Run(); err != nil {
+		return nil, err
+	}
+	return stdout.Bytes(), nil
+}
+
+// parseResults parses benchmark JSON output, and returns the real time in
+// nanoseconds of each benchmark that ran successfully, along with the
+// benchmark names in the order they ran.
+func parseResults(out []byte) (map[string]float64, []string, error) {
+	var parsed struct {
+		Benchmarks []result `json:"benchmarks"`
+	}
+	if err := json.Unmarshal(out, &parsed); err != nil {
+		return nil, nil, fmt.Errorf("could not parse benchmark output: %v", err)
+	}
+	times := make(map[string]float64)
+	var names []string
+	for _, r := range parsed.Benchmarks {
+		if r.ErrorOccurred || (r.RunType != "" && r.RunType != "iteration") {
+			continue
+		}
+		ns, err := r.nanoseconds()
+		if err != nil {
+			return nil, nil, err
+		}
+		times[r.Name] = ns
+		names = append(names, r.Name)
+	}
+	return times, names, nil
+}
+
+func fatalf(s string, args ...interface{}) {
+	fmt.Fprintf(os.Stderr, s+"\n", args...)
+	os.Exit(1)
+}
+
+func main() {
+	flag.Parse()
+	if flag.NArg() != 1 {
+		fatalf("benchmark binary must be provided")
+	}
+	testBin, err := filepath.Abs(flag.Args()[0])
+	if err != nil {
+		fatalf("Abs() failed: %v", err)
+	}
+
+	log.SetLevel(log.Info)
+	if *debug {
+		log.SetLevel(log.Debug)
+	}
+
+	configs := []config{{platform: native}}
+	for _, p := range strings.Split(*platforms, ",") {
+		if p == "" {
+			continue
+		}
+		configs = append(configs, config{platform: p})
+		if *overlay {
+			configs = append(configs, config{platform: p, overlay: true})
+		}
+	}
+	if len(configs) > 1 && *runscPath == "" {
+		if err := testutil.ConfigureExePath(); err != nil {
+			fatalf("ConfigureExePath() failed: %v", err)
+		}
+		*runscPath = specutils.ExePath
+	}
+
+	// Benchmarks are reported in the order they ran natively.
+	var names []string
+	results := make([]map[string]float64, len(configs))
+	for i, c := range configs {
+		var out []byte
+		if c.platform == native {
+			out, err = runNative(testBin)
+		} else {
+			out, err = runRunsc(testBin, c)
+		}
+		if err != nil {
+			fatalf("running %s with configuration %s failed: %v", testBin, c, err)
+		}
+		var ran []string
+		results[i], ran, err = parseResults(out)
+		if err != nil {
+			fatalf("configuration %s: %v", c, err)
+		}
+		if c.platform == native {
+			names = ran
+		}
+	}
+
+	w := tabwriter.NewWriter(os.Stdout, 0, 8, 2, ' ', tabwriter.AlignRight)
+	fmt.Fprint(w, "benchmark\tnative (ns)\t")
+	for _, c := range configs[1:] {
+		fmt.Fprintf(w, "%s (ns)\t%s slowdown\t", c, c)
+	}
+	fmt.Fprintln(w)
+	for _, name := range names {
+		base := results[0][name]
+		fmt.Fprintf(w, "%s\t%.1f\t", name, base)
+		for i := range configs[1:] {
+			t, ok := results[i+1][name]
+			if !ok {
+				fmt.Fprint(w, "-\t-\t")
+				continue
+			}
+			fmt.Fprintf(w, "%.1f\t", t)
+			if base > 0 {
+				fmt.Fprintf(w, "%.2fx\t", t/base)
+			} else {
+				fmt.Fprint(w, "-\t")
+			}
+		}
+		fmt.Fprintln(w)
+	}
+	w.Flush()
+}
@@ -0,0 +1,154 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <asm/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/multiprocess_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+#if defined(__x86_64__)
+
+// Size of each coroutine's fake TLS block. The FS base points to the middle
+// of the block, since x86-64 TLS variables live below the thread pointer.
+constexpr size_t kTLSBlockSize = 64 << 10;
+
+inline uint64_t ReadFSBase() {
+  uint64_t base;
+  asm volatile("rdfsbase %0" : "=r"(base));
+  return base;
+}
+
+inline void WriteFSBase(uint64_t base) {
+  asm volatile("wrfsbase %0" : : "r"(base) : "memory");
+}
+
+// Reads the thread pointer stored at the start of the TCB, as TLS accesses do.
+inline uint64_t ReadThreadPointer() {
+  uint64_t tp;
+  asm volatile("movq %%fs:0, %0" : "=r"(tp));
+  return tp;
+}
+
+// Returns true if wrfsbase may be used from user mode.
+bool FSGSBaseEnabled() {
+  const auto status = InForkedProcess([] {
+    WriteFSBase(ReadFSBase());
+    _exit(0);
+  });
+  return status.ok() && status.ValueOrDie() == 0;
+}
+
+// TLSBlock is a coroutine's TLS block.
+class TLSBlock {
+ public:
+  TLSBlock() : data_(new char[kTLSBlockSize]()) {
+    // As with a real TCB, the thread pointer points to itself.
+    uint64_t* tcb = reinterpret_cast<uint64_t*>(base());
+    *tcb = base();
+  }
+
+  uint64_t base() const {
+    return reinterpret_cast<uint64_t>(data_.get() + kTLSBlockSize / 2);
+  }
+
+ private:
+  std::unique_ptr<char[]> data_;
+};
+
+// BM_CoroutineSwitchArchPrctl measures a switch to a coroutine and back, as
+// performed by green thread runtimes that give each coroutine its own TLS,
+// using arch_prctl(ARCH_SET_FS). Compare with BM_CoroutineSwitchWrFSBase.
+void BM_CoroutineSwitchArchPrctl(benchmark::State& state) {
+  const uint64_t orig = ReadThreadPointer();
+  TLSBlock coroutine;
+  const uint64_t base = coroutine.base();
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    // Nothing may use TLS while FS points to the coroutine's block. syscall(3)
+    // only touches TLS (errno) on failure.
+    long ret = syscall(SYS_arch_prctl, ARCH_SET_FS, base);
+    const uint64_t tp = ReadThreadPointer();
+    ret |= syscall(SYS_arch_prctl, ARCH_SET_FS, orig);
+    TEST_CHECK(ret == 0 && tp == base);
+  }
+}
+
+BENCHMARK(BM_CoroutineSwitchArchPrctl);
+
+// BM_CoroutineSwitchWrFSBase is BM_CoroutineSwitchArchPrctl using wrfsbase,
+// which does not trap where FSGSBASE is enabled.
+void BM_CoroutineSwitchWrFSBase(benchmark::State& state) {
+  if (!FSGSBaseEnabled()) {
+    state.SkipWithError("FSGSBASE is not enabled");
+    return;
+  }
+  const uint64_t orig = ReadFSBase();
+  TLSBlock coroutine;
+  const uint64_t base = coroutine.base();
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    WriteFSBase(base);
+    const uint64_t tp = ReadThreadPointer();
+    WriteFSBase(orig);
+    TEST_CHECK(tp == base);
+  }
+}
+
+BENCHMARK(BM_CoroutineSwitchWrFSBase);
+
+// BM_CoroutineSwitchWrFSBaseSyscall is BM_CoroutineSwitchWrFSBase with a
+// syscall made by the coroutine, which checks that the FS base written with
+// wrfsbase is preserved across entries to the kernel.
+void BM_CoroutineSwitchWrFSBaseSyscall(benchmark::State& state) {
+  if (!FSGSBaseEnabled()) {
+    state.SkipWithError("FSGSBASE is not enabled");
+    return;
+  }
+  const uint64_t orig = ReadFSBase();
+  TLSBlock coroutine;
+  const uint64_t base = coroutine.base();
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    WriteFSBase(base);
+    syscall(SYS_getpid);
+    const uint64_t tp = ReadThreadPointer();
+    WriteFSBase(orig);
+    TEST_CHECK(tp == base);
+  }
+}
+
+BENCHMARK(BM_CoroutineSwitchWrFSBaseSyscall);
+
+#endif  // defined(__x86_64__)
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
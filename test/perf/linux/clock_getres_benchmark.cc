@@ -12,27 +12,43 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <sys/syscall.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 
 namespace gvisor {
 namespace testing {
 
 namespace {
 
-// clock_getres(1) is very nearly a no-op syscall, but it does require copying
+// clock_getres(2) is very nearly a no-op syscall, but it does require copying
 // out to a userspace struct. It thus provides a nice small copy-out benchmark.
 void BM_ClockGetRes(benchmark::State& state) {
   struct timespec ts;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
-    clock_getres(CLOCK_MONOTONIC, &ts);
+    syscall(SYS_clock_getres, CLOCK_MONOTONIC, &ts);
   }
 }
 
 BENCHMARK(BM_ClockGetRes);
 
+// The libc clock_getres() is answered by the VDSO.
+void BM_VDSOClockGetRes(benchmark::State& state) {
+  const clockid_t clock = state.range(0);
+  struct timespec ts;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    clock_getres(clock, &ts);
+  }
+}
+
+BENCHMARK(BM_VDSOClockGetRes)->Arg(CLOCK_MONOTONIC)->Arg(CLOCK_REALTIME);
+
 }  // namespace
 
 }  // namespace testing
@@ -13,12 +13,26 @@
 // limitations under the License.
 
 #include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <sys/auxv.h>
 #include <time.h>
 
+#include <atomic>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/fs_util.h"
+#include "test/util/test_util.h"
+#include "vdso/vdso_time.h"
 
 namespace gvisor {
 namespace testing {
@@ -30,6 +44,7 @@ void BM_ClockGettimeThreadCPUTime(benchmark::State& state) {
   ASSERT_EQ(0, pthread_getcpuclockid(pthread_self(), &clockid));
   struct timespec tp;
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     clock_gettime(clockid, &tp);
   }
@@ -37,6 +52,39 @@ void BM_ClockGettimeThreadCPUTime(benchmark::State& state) {
 
 BENCHMARK(BM_ClockGettimeThreadCPUTime);
 
+// CPULabel returns the vendor and family of the first CPU in /proc/cpuinfo.
+//
+// The sandbox VDSO picks a cycle clock implementation based on the CPU family
+// (see vdsoCycleClockMode in pkg/sentry/kernel), so results are labelled to
+// allow comparison across hosts.
+std::string CPULabel() {
+  auto contents = GetContents("/proc/cpuinfo");
+  if (!contents.ok()) {
+    return "";
+  }
+  std::string vendor;
+  std::string family;
+  for (absl::string_view line :
+       absl::StrSplit(contents.ValueOrDie(), '\n')) {
+    std::vector<absl::string_view> kv =
+        absl::StrSplit(line, absl::MaxSplits(':', 1));
+    if (kv.size() != 2) {
+      continue;
+    }
+    absl::string_view key = absl::StripAsciiWhitespace(kv[0]);
+    absl::string_view value = absl::StripAsciiWhitespace(kv[1]);
+    if (key == "vendor_id" && vendor.empty()) {
+      vendor = std::string(value);
+    } else if (key == "cpu family" && family.empty()) {
+      family = std::string(value);
+    }
+  }
+  if (family.empty()) {
+    return vendor;
+  }
+  return vendor + " family " + family;
+}
+
 void BM_VDSOClockGettime(benchmark::State& state) {
   const clockid_t clock = state.range(0);
   struct timespec tp;
@@ -47,12 +95,175 @@ void BM_VDSOClockGettime(benchmark::State& state) {
     clock_gettime(clock, &tp);
   }
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     clock_gettime(clock, &tp);
   }
+
+  state.SetLabel(CPULabel());
+}
+
+BENCHMARK(BM_VDSOClockGettime)
+    ->Arg(CLOCK_MONOTONIC)
+    ->Arg(CLOCK_REALTIME)
+    ->Arg(CLOCK_MONOTONIC_COARSE)
+    ->Arg(CLOCK_REALTIME_COARSE)
+    ->Arg(CLOCK_TAI);
+
+// BM_VDSOClockGettimeContended reads a clock from every CPU at once.
+//
+// The sandbox kernel updates the VDSO parameters about once per second, so the
+// minimum time covers several updates, each of which invalidates the cache
+// lines read by all threads.
+void BM_VDSOClockGettimeContended(benchmark::State& state) {
+  const clockid_t clock = state.range(0);
+  struct timespec tp;
+  absl::Time start = absl::Now();
+
+  // Don't benchmark the calibration phase.
+  while (absl::Now() < start + absl::Milliseconds(2100)) {
+    clock_gettime(clock, &tp);
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    clock_gettime(clock, &tp);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_VDSOClockGettimeContended)
+    ->Arg(CLOCK_MONOTONIC)
+    ->Arg(CLOCK_REALTIME)
+    ->ThreadPerCpu()
+    ->MinTime(5)
+    ->UseRealTime();
+
+// SandboxParams returns the sandbox VDSO parameter page, which is mapped just
+// before the VDSO, or nullptr when not running in the sandbox.
+const void* SandboxParams() {
+  if (!IsRunningOnGvisor()) {
+    return nullptr;
+  }
+  uintptr_t vdso = getauxval(AT_SYSINFO_EHDR);
+  if (vdso == 0) {
+    return nullptr;
+  }
+  return reinterpret_cast<const void*>(vdso - kPageSize);
+}
+
+// next_pinned_cpu is used to give each thread of BM_VDSOClockGettimeScaling a
+// different CPU.
+std::atomic<int> next_pinned_cpu;
+
+// BM_VDSOClockGettimeScaling reads a clock from many threads, using a test
+// build of the VDSO timekeeping code on the live sandbox parameter page. It
+// reports the number of seqcount read retries per clock read, which are caused
+// by the sandbox kernel updating the parameters.
+//
+// If pin is set, each thread is pinned to a different CPU.
+void BM_VDSOClockGettimeScaling(benchmark::State& state, bool pin) {
+  const void* params = SandboxParams();
+  if (params == nullptr) {
+    state.SkipWithError("requires the sandbox VDSO");
+    return;
+  }
+  static const bool params_set = [params] {
+    vdso::SetParamsForTest(params);
+    return true;
+  }();
+  (void)params_set;
+
+  cpu_set_t old_cpus;
+  if (pin) {
+    ASSERT_THAT(sched_getaffinity(0, sizeof(old_cpus), &old_cpus),
+                SyscallSucceeds());
+    // Pick the nth allowed CPU for the nth thread.
+    int n = next_pinned_cpu.fetch_add(1) % CPU_COUNT(&old_cpus);
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &old_cpus) && n-- == 0) {
+        CPU_SET(cpu, &cpus);
+        break;
+      }
+    }
+    ASSERT_THAT(sched_setaffinity(0, sizeof(cpus), &cpus), SyscallSucceeds());
+  }
+
+  int (*read_clock)(struct timespec*) = state.range(0) == CLOCK_REALTIME
+                                            ? vdso::ClockRealtime
+                                            : vdso::ClockMonotonic;
+  struct timespec tp;
+  absl::Time start = absl::Now();
+
+  // Don't benchmark the calibration phase.
+  while (absl::Now() < start + absl::Milliseconds(2100)) {
+    read_clock(&tp);
+  }
+
+  uint64_t start_retries = vdso::SeqcountRetriesForTest();
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    read_clock(&tp);
+  }
+  state.counters["retries"] =
+      benchmark::Counter(vdso::SeqcountRetriesForTest() - start_retries,
+                         benchmark::Counter::kAvgIterations);
+
+  if (pin) {
+    // Threads may be reused by later benchmarks.
+    ASSERT_THAT(sched_setaffinity(0, sizeof(old_cpus), &old_cpus),
+                SyscallSucceeds());
+  }
+}
+
+BENCHMARK_CAPTURE(BM_VDSOClockGettimeScaling, unpinned, false)
+    ->Arg(CLOCK_MONOTONIC)
+    ->Arg(CLOCK_REALTIME)
+    ->ThreadRange(1, NumCPUs())
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_VDSOClockGettimeScaling, pinned, true)
+    ->Arg(CLOCK_MONOTONIC)
+    ->Arg(CLOCK_REALTIME)
+    ->ThreadRange(1, NumCPUs())
+    ->UseRealTime();
+
+// The sandbox VDSO converts cycles to nanoseconds on every clock read. These
+// benchmarks compare computing the multiplier from the frequency on each call
+// (a 64-bit division) against using a multiplier and shift precomputed by the
+// sandbox kernel. See cycles_to_ns in vdso/vdso_time.cc.
+constexpr uint64_t kNsecsPerSec = 1000000000UL;
+constexpr uint64_t kFrequency = 2593992000UL;
+
+void BM_CyclesToNsDivide(benchmark::State& state) {
+  uint64_t frequency = kFrequency;
+  uint64_t cycles = kFrequency / 3;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(frequency);
+    uint64_t mult = (kNsecsPerSec << 32) / frequency;
+    benchmark::DoNotOptimize(((unsigned __int128)cycles * mult) >> 32);
+  }
+}
+
+BENCHMARK(BM_CyclesToNsDivide);
+
+void BM_CyclesToNsMultShift(benchmark::State& state) {
+  uint64_t mult = (kNsecsPerSec << 32) / kFrequency;
+  uint64_t shift = 32;
+  uint64_t cycles = kFrequency / 3;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mult);
+    benchmark::DoNotOptimize(shift);
+    benchmark::DoNotOptimize(((unsigned __int128)cycles * mult) >> shift);
+  }
 }
 
-BENCHMARK(BM_VDSOClockGettime)->Arg(CLOCK_MONOTONIC)->Arg(CLOCK_REALTIME);
+BENCHMARK(BM_CyclesToNsMultShift);
 
 }  // namespace
 
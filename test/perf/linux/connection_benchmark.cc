@@ -0,0 +1,185 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of the request and response exchanged on each connection.
+constexpr int kMessageSize = 64;
+
+// Server accepts connections on loopback, reads a request, writes a response
+// and closes the connection, like an HTTP/1.0 server.
+class Server {
+ public:
+  // Creates a server with NumCPUs() accept threads. If reuseport is set, each
+  // thread has its own SO_REUSEPORT listener on the same port; otherwise all
+  // threads accept from one listener.
+  explicit Server(bool reuseport) {
+    const int nthreads = NumCPUs();
+    const int nlisteners = reuseport ? nthreads : 1;
+    for (int i = 0; i < nlisteners; i++) {
+      FileDescriptor listener =
+          Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP).ValueOrDie();
+      if (reuseport) {
+        TEST_PCHECK(setsockopt(listener.get(), SOL_SOCKET, SO_REUSEPORT,
+                               &kSockOptOn, sizeof(kSockOptOn)) == 0);
+      }
+      TEST_PCHECK(bind(listener.get(), reinterpret_cast<sockaddr*>(&addr_),
+                       sizeof(addr_)) == 0);
+      socklen_t addrlen = sizeof(addr_);
+      TEST_PCHECK(getsockname(listener.get(),
+                              reinterpret_cast<sockaddr*>(&addr_),
+                              &addrlen) == 0);
+      TEST_PCHECK(listen(listener.get(), SOMAXCONN) == 0);
+      listeners_.push_back(std::move(listener));
+    }
+
+    for (int i = 0; i < nthreads; i++) {
+      const int fd = listeners_[i % nlisteners].get();
+      threads_.push_back(absl::make_unique<ScopedThread>([fd] { Serve(fd); }));
+    }
+  }
+
+  const sockaddr_in& addr() const { return addr_; }
+
+ private:
+  static void Serve(int listener) {
+    char buf[kMessageSize];
+    while (true) {
+      int fd = accept(listener, nullptr, nullptr);
+      if (fd < 0) {
+        TEST_PCHECK(errno == EINTR || errno == ECONNABORTED);
+        continue;
+      }
+      FileDescriptor conn(fd);
+      if (ReadFd(conn.get(), buf, sizeof(buf)) > 0) {
+        WriteFd(conn.get(), buf, sizeof(buf));
+      }
+    }
+  }
+
+  // The listening address. The port is picked when the first listener binds.
+  sockaddr_in addr_ = {AF_INET, 0, {htonl(INADDR_LOOPBACK)}};
+  std::vector<FileDescriptor> listeners_;
+  std::vector<std::unique_ptr<ScopedThread>> threads_;
+};
+
+Server& GetServer(bool reuseport) {
+  // Servers are created only once throughout the lifetime of the process. Use
+  // dynamically allocated objects (that are never deleted) since the accept
+  // threads never exit.
+  if (reuseport) {
+    static Server* const server = new Server(true);
+    return *server;
+  }
+  static Server* const server = new Server(false);
+  return *server;
+}
+
+// BM_ConnectionChurn measures the rate of short-lived connections. Each
+// benchmark thread is a client that repeatedly connects, writes a request,
+// reads the response until the server closes the connection, and closes its
+// end. state.range(0) selects a single shared listener (0) or one
+// SO_REUSEPORT listener per server thread (1).
+//
+// p99_us is the 99th percentile connection latency, averaged across client
+// threads.
+void BM_ConnectionChurn(benchmark::State& state) {
+  const Server& server = GetServer(state.range(0));
+  const sockaddr_in addr = server.addr();
+  char buf[kMessageSize] = {};
+  std::vector<absl::Duration> latencies;
+
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    const absl::Time start = absl::Now();
+    FileDescriptor conn =
+        ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    TEST_PCHECK(RetryEINTR(connect)(conn.get(),
+                                    reinterpret_cast<const sockaddr*>(&addr),
+                                    sizeof(addr)) == 0);
+    TEST_PCHECK(WriteFd(conn.get(), buf, sizeof(buf)) == sizeof(buf));
+    int n;
+    while ((n = ReadFd(conn.get(), buf, sizeof(buf))) > 0) {
+    }
+    TEST_PCHECK(n == 0);
+    conn.reset();
+    latencies.push_back(absl::Now() - start);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  if (!latencies.empty()) {
+    auto p99 = latencies.begin() + latencies.size() * 99 / 100;
+    std::nth_element(latencies.begin(), p99, latencies.end());
+    state.counters["p99_us"] = benchmark::Counter(
+        absl::ToDoubleMicroseconds(*p99), benchmark::Counter::kAvgThreads);
+  }
+}
+
+BENCHMARK(BM_ConnectionChurn)
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 256)
+    ->UseRealTime();
+
+// BM_SocketPairCreate measures the cost of creating and destroying a
+// connected pair with a SocketPairKind creator, including listener setup when
+// the listener is not persistent.
+void BM_SocketPairCreate(benchmark::State& state,
+                         Creator<SocketPair> creator) {
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    std::unique_ptr<SocketPair> pair = ASSERT_NO_ERRNO_AND_VALUE(creator());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_SocketPairCreate, listener,
+                  TCPAcceptBindSocketPairCreator(AF_INET, SOCK_STREAM, 0,
+                                                 false))
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_SocketPairCreate, persistent_listener,
+                  TCPAcceptBindPersistentListenerSocketPairCreator(
+                      AF_INET, SOCK_STREAM, 0, false))
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
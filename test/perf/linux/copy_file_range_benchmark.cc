@@ -0,0 +1,117 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// How each file is copied.
+enum Method {
+  kCopyFileRange = 0,
+  kSendfile = 1,
+  kReadWrite = 2,
+};
+
+// Buffer size used by the read/write method, like cp(1).
+constexpr size_t kReadWriteBufferSize = 128 << 10;
+
+// CopyFile copies size bytes from in to out, from and to offset 0, using
+// method.
+void CopyFile(int in, int out, int64_t size, int method,
+              std::vector<char>* buf) {
+  int64_t total = 0;
+  while (total < size) {
+    ssize_t n;
+    switch (method) {
+      case kCopyFileRange: {
+        loff_t in_off = total;
+        loff_t out_off = total;
+        n = syscall(SYS_copy_file_range, in, &in_off, out, &out_off,
+                    size - total, 0);
+        break;
+      }
+      case kSendfile: {
+        off_t in_off = total;
+        TEST_PCHECK(lseek(out, total, SEEK_SET) == total);
+        n = sendfile(out, in, &in_off, size - total);
+        break;
+      }
+      default:
+        n = pread(in, buf->data(), buf->size(), total);
+        TEST_PCHECK(n > 0);
+        TEST_PCHECK(pwrite(out, buf->data(), n, total) == n);
+        break;
+    }
+    TEST_PCHECK(n > 0);
+    total += n;
+  }
+}
+
+// BM_CopyFile measures the throughput of copying a file of state.range(1)
+// bytes to another file, using the method given by state.range(0).
+void BM_CopyFile(benchmark::State& state) {
+  const int method = state.range(0);
+  const int64_t size = state.range(1);
+
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  FileDescriptor in = ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_RDWR));
+  FileDescriptor out =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_WRONLY));
+
+  std::vector<char> buf(kReadWriteBufferSize);
+  RandomizeBuffer(buf.data(), buf.size());
+  for (int64_t off = 0; off < size; off += buf.size()) {
+    TEST_PCHECK(PwriteFd(in.get(), buf.data(), buf.size(), off) == buf.size());
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    CopyFile(in.get(), out.get(), size, method, &buf);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size);
+}
+
+void CopyFileArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"method", "size"});
+  for (int method : {kCopyFileRange, kSendfile, kReadWrite}) {
+    for (int64_t size = 1 << 20; size <= 256 << 20; size <<= 4) {
+      bench->Args({method, size});
+    }
+  }
+}
+
+BENCHMARK(BM_CopyFile)->Apply(CopyFileArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
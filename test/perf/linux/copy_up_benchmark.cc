@@ -0,0 +1,81 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Sparse 1GB files, which are in the lower layer of an overlay root
+// filesystem. Each is used by one benchmark, since only the first
+// modification of a lower file copies it up.
+constexpr char kChmodFile[] = "test/perf/linux/copy_up_chmod_data";
+constexpr char kWriteFile[] = "test/perf/linux/copy_up_write_data";
+
+// BM_FirstChmod measures the first chmod of a 1GB lower file, which copies up
+// only the file's metadata.
+void BM_FirstChmod(benchmark::State& state) {
+  const std::string path = RunfilePath(kChmodFile);
+  struct stat st;
+  TEST_PCHECK(stat(path.c_str(), &st) == 0);
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    // Keep the file's mode, so that the file is unchanged outside of an
+    // overlay.
+    TEST_PCHECK(chmod(path.c_str(), st.st_mode & 07777) == 0);
+  }
+}
+
+BENCHMARK(BM_FirstChmod)->Iterations(1)->UseRealTime();
+
+// BM_FirstWrite measures the first open for writing of, and write to, a 1GB
+// lower file, which copies up the file's content.
+void BM_FirstWrite(benchmark::State& state) {
+  const std::string path = RunfilePath(kWriteFile);
+  if (access(path.c_str(), W_OK) != 0) {
+    state.SkipWithError("lower file is not writable");
+    return;
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    const int fd = open(path.c_str(), O_WRONLY);
+    TEST_PCHECK(fd >= 0);
+    // Write a zero over a hole, so that the file's content is unchanged
+    // outside of an overlay.
+    const char zero = 0;
+    TEST_PCHECK(pwrite(fd, &zero, 1, 0) == 1);
+    TEST_PCHECK(close(fd) == 0);
+  }
+}
+
+BENCHMARK(BM_FirstWrite)->Iterations(1)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
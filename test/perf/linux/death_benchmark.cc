@@ -12,11 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <pthread.h>
 #include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT(build/c++11)
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
 #include "test/util/logging.h"
+#include "test/util/test_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -30,6 +38,82 @@ TEST(DeathTest, ZeroEqualsOne) {
   EXPECT_EXIT({ TEST_CHECK(0 == 1); }, ::testing::KilledBySignal(SIGABRT), "");
 }
 
+// Stack size of each thread started by BM_ExitGroup's child.
+constexpr size_t kThreadStackSize = 64 << 10;
+
+void* BlockForever(void*) {
+  while (true) {
+    pause();
+  }
+  return nullptr;
+}
+
+// BM_ExitGroup measures how long a process with state.range(0) threads and
+// state.range(1) MB of resident memory takes to exit, from when it is told to
+// call exit_group(2) until its parent's wait(2) returns.
+void BM_ExitGroup(benchmark::State& state) {
+  const int threads = state.range(0);
+  const size_t rss = static_cast<size_t>(state.range(1)) << 20;
+
+  for (auto _ : state) {
+    int ready[2], go[2];
+    TEST_PCHECK(pipe(ready) == 0);
+    TEST_PCHECK(pipe(go) == 0);
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+      close(ready[0]);
+      close(go[1]);
+      if (rss != 0) {
+        void* addr = mmap(nullptr, rss, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        TEST_PCHECK(addr != MAP_FAILED);
+        memset(addr, 1, rss);
+      }
+      pthread_attr_t attr;
+      TEST_CHECK(pthread_attr_init(&attr) == 0);
+      TEST_CHECK(pthread_attr_setstacksize(&attr, kThreadStackSize) == 0);
+      for (int i = 1; i < threads; i++) {
+        pthread_t thread;
+        TEST_CHECK(pthread_create(&thread, &attr, BlockForever, nullptr) == 0);
+      }
+      char c = 0;
+      TEST_PCHECK(WriteFd(ready[1], &c, 1) == 1);
+      TEST_PCHECK(ReadFd(go[0], &c, 1) == 1);
+      _exit(0);
+    }
+    TEST_PCHECK(pid > 0);
+    close(ready[1]);
+    close(go[0]);
+
+    char c;
+    TEST_PCHECK(ReadFd(ready[0], &c, 1) == 1);
+    const auto start = std::chrono::steady_clock::now();
+    TEST_PCHECK(WriteFd(go[1], &c, 1) == 1);
+    int status;
+    TEST_PCHECK(RetryEINTR(waitpid)(pid, &status, 0) == pid);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    state.SetIterationTime(
+        std::chrono::duration_cast<std::chrono::duration<double>>(elapsed)
+            .count());
+
+    close(ready[0]);
+    close(go[1]);
+  }
+}
+
+void ExitGroupArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"threads", "rss_mb"});
+  for (int threads : {1, 64, 2048}) {
+    for (int rss_mb : {0, 1024}) {
+      bench->Args({threads, rss_mb});
+    }
+  }
+}
+
+BENCHMARK(BM_ExitGroup)->Apply(ExitGroupArgs)->UseManualTime();
+
 }  // namespace
 
 }  // namespace testing
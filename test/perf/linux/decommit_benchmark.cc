@@ -0,0 +1,121 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// How long to wait for freed memory to be returned to the host.
+constexpr absl::Duration kSettleTime = absl::Milliseconds(100);
+
+// UsedMemory returns MemTotal - MemFree from /proc/meminfo, in bytes.
+//
+// In gVisor, this is the memory committed in the sandbox's memory file, which
+// includes memory freed by the application but not yet returned to the host.
+// On Linux, it is system-wide, so the results are only indicative.
+uint64_t UsedMemory() {
+  std::string meminfo = GetContents("/proc/meminfo").ValueOrDie();
+  uint64_t total_kb = 0, free_kb = 0;
+  for (absl::string_view line : absl::StrSplit(meminfo, '\n')) {
+    std::vector<absl::string_view> parts =
+        absl::StrSplit(line, ' ', absl::SkipEmpty());
+    if (parts.size() != 3) {
+      continue;
+    }
+    if (parts[0] == "MemTotal:") {
+      TEST_CHECK(absl::SimpleAtoi(parts[1], &total_kb));
+    } else if (parts[0] == "MemFree:") {
+      TEST_CHECK(absl::SimpleAtoi(parts[1], &free_kb));
+    }
+  }
+  return (total_kb - free_kb) * 1024;
+}
+
+// Touch writes to every page of [addr, addr+size).
+void Touch(void* addr, size_t size) {
+  char* p = static_cast<char*>(addr);
+  for (size_t i = 0; i < size; i += kPageSize) {
+    p[i] = 1;
+  }
+}
+
+// BM_MapTouchUnmap measures the time to map, populate and unmap an anonymous
+// region of state.range(0) MB, split into mappings of state.range(1) KB to
+// produce many separately freed ranges. It reports the memory that remains
+// committed immediately after the unmap, and kSettleTime later.
+void BM_MapTouchUnmap(benchmark::State& state) {
+  const size_t size = state.range(0) << 20;
+  const size_t chunk = state.range(1) << 10;
+
+  uint64_t retained = 0;
+  uint64_t settled = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t before = UsedMemory();
+    state.ResumeTiming();
+
+    std::vector<Mapping> mappings;
+    for (size_t off = 0; off < size; off += chunk) {
+      mappings.push_back(
+          MmapAnon(chunk, PROT_READ | PROT_WRITE, MAP_PRIVATE).ValueOrDie());
+      Touch(mappings.back().ptr(), chunk);
+    }
+    mappings.clear();
+
+    state.PauseTiming();
+    const uint64_t after = UsedMemory();
+    retained += after > before ? after - before : 0;
+    absl::SleepFor(kSettleTime);
+    const uint64_t later = UsedMemory();
+    settled += later > before ? later - before : 0;
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) * state.iterations());
+  state.counters["retained_bytes"] = benchmark::Counter(
+      static_cast<double>(retained), benchmark::Counter::kAvgIterations);
+  state.counters["settled_bytes"] = benchmark::Counter(
+      static_cast<double>(settled), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_MapTouchUnmap)
+    ->ArgPair(64, 64 << 10)
+    ->ArgPair(256, 256 << 10)
+    ->ArgPair(256, 64)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
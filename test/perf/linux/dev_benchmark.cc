@@ -0,0 +1,79 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// BM_DevZeroMapPrivate measures mapping state.range(0) bytes of /dev/zero
+// privately, as allocators that predate MAP_ANONYMOUS do, reading one byte of
+// every page, dirtying one page in 16, and unmapping it.
+void BM_DevZeroMapPrivate(benchmark::State& state) {
+  const size_t size = state.range(0);
+  const FileDescriptor fd = Open("/dev/zero", O_RDWR).ValueOrDie();
+  const size_t page_size = getpagesize();
+
+  for (auto _ : state) {
+    void* addr =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd.get(), 0);
+    TEST_PCHECK(addr != MAP_FAILED);
+    volatile char* p = static_cast<volatile char*>(addr);
+    for (size_t i = 0; i < size; i += page_size) {
+      TEST_CHECK(p[i] == 0);
+      if ((i / page_size) % 16 == 0) {
+        p[i] = 1;
+      }
+    }
+    TEST_PCHECK(munmap(addr, size) == 0);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size);
+}
+
+BENCHMARK(BM_DevZeroMapPrivate)->Range(1 << 16, 1 << 26)->UseRealTime();
+
+// BM_DevUrandomRead measures reading state.range(0) bytes at a time from
+// /dev/urandom.
+void BM_DevUrandomRead(benchmark::State& state) {
+  const size_t size = state.range(0);
+  const FileDescriptor fd = Open("/dev/urandom", O_RDONLY).ValueOrDie();
+  std::vector<char> buf(size);
+
+  for (auto _ : state) {
+    TEST_PCHECK(read(fd.get(), buf.data(), size) ==
+                static_cast<ssize_t>(size));
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size);
+}
+
+BENCHMARK(BM_DevUrandomRead)->Range(1 << 6, 1 << 24)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -21,12 +21,16 @@
 #include <cstdlib>
 #include <ctime>
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/memory/memory.h"
 #include "absl/time/time.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/epoll_util.h"
 #include "test/util/file_descriptor.h"
+#include "test/util/rlimit_util.h"
 #include "test/util/test_util.h"
 #include "test/util/thread_util.h"
 
@@ -36,8 +40,8 @@ namespace testing {
 namespace {
 
 // Returns a new eventfd.
-PosixErrorOr<FileDescriptor> NewEventFD() {
-  int fd = eventfd(0, /* flags = */ 0);
+PosixErrorOr<FileDescriptor> NewEventFD(int flags = 0) {
+  int fd = eventfd(0, flags);
   MaybeSave();
   if (fd < 0) {
     return PosixError(errno, "eventfd");
@@ -60,6 +64,7 @@ void BM_EpollTimeout(benchmark::State& state) {
   struct epoll_event result[kFDsPerEpoll];
   int timeout_ms = state.range(0);
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     EXPECT_EQ(0, epoll_wait(epollfd.get(), result, kFDsPerEpoll, timeout_ms));
   }
@@ -85,6 +90,7 @@ void BM_EpollAllEvents(benchmark::State& state) {
 
   std::vector<struct epoll_event> result(fds_per_epoll);
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     EXPECT_EQ(fds_per_epoll,
               epoll_wait(epollfd.get(), result.data(), fds_per_epoll, 0));
@@ -93,6 +99,179 @@ void BM_EpollAllEvents(benchmark::State& state) {
 
 BENCHMARK(BM_EpollAllEvents)->Range(2, 1024);
 
+// BM_EpollIdleFDs measures epoll_wait with state.range(0) registered eventfds
+// of which only state.range(1) are ready. The cost should scale with the
+// number of ready fds, not the number registered.
+void BM_EpollIdleFDs(benchmark::State& state) {
+  const int registered = state.range(0);
+  const int active = state.range(1);
+  constexpr uint64_t kEventVal = 5;
+
+  auto rlimit_or = ScopedSetSoftRlimit(RLIMIT_NOFILE, registered + 64);
+  if (!rlimit_or.ok()) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  auto rlimit = std::move(rlimit_or).ValueOrDie();
+
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  std::vector<FileDescriptor> eventfds;
+  for (int i = 0; i < registered; i++) {
+    eventfds.push_back(ASSERT_NO_ERRNO_AND_VALUE(NewEventFD()));
+    ASSERT_NO_ERRNO(
+        RegisterEpollFD(epollfd.get(), eventfds[i].get(), EPOLLIN, 0));
+  }
+
+  // Spread the active fds over the registered ones.
+  for (int i = 0; i < active; i++) {
+    ASSERT_THAT(WriteFd(eventfds[i * (registered / active)].get(), &kEventVal,
+                        sizeof(kEventVal)),
+                SyscallSucceedsWithValue(sizeof(kEventVal)));
+  }
+
+  std::vector<struct epoll_event> result(active);
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    EXPECT_EQ(active, epoll_wait(epollfd.get(), result.data(), active, 0));
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(active) * state.iterations());
+}
+
+void IdleFDsArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"registered", "active"});
+  for (int registered : {1 << 10, 1 << 14, 100000}) {
+    for (int active : {1, 16}) {
+      bench->Args({registered, active});
+    }
+  }
+}
+
+BENCHMARK(BM_EpollIdleFDs)->Apply(IdleFDsArgs);
+
+// BM_EpollExclusiveWake measures the latency of waking one of state.range(0)
+// threads, each blocked in epoll_wait on its own epoll instance watching the
+// same eventfd. state.range(1) selects whether the eventfd is registered with
+// EPOLLEXCLUSIVE. Without EPOLLEXCLUSIVE every waiter is woken, and all but
+// one find nothing to do, so the latency grows with the number of waiters.
+void BM_EpollExclusiveWake(benchmark::State& state) {
+  const int waiters = state.range(0);
+  const int events = EPOLLIN | (state.range(1) ? EPOLLEXCLUSIVE : 0);
+  constexpr uint64_t kEventVal = 1;
+  constexpr uint64_t kEventData = 0;
+  constexpr uint64_t kDoneData = 1;
+
+  FileDescriptor event =
+      ASSERT_NO_ERRNO_AND_VALUE(NewEventFD(EFD_NONBLOCK));
+  FileDescriptor ack = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+  // done is never read, so once written all waiters see it.
+  FileDescriptor done = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+
+  std::vector<std::unique_ptr<ScopedThread>> threads;
+  for (int i = 0; i < waiters; i++) {
+    threads.push_back(absl::make_unique<ScopedThread>([&] {
+      auto epollfd = NewEpollFD().ValueOrDie();
+      TEST_CHECK(RegisterEpollFD(epollfd.get(), event.get(), events,
+                                 kEventData)
+                     .ok());
+      TEST_CHECK(
+          RegisterEpollFD(epollfd.get(), done.get(), EPOLLIN, kDoneData).ok());
+      while (true) {
+        struct epoll_event result[2];
+        int n = RetryEINTR(epoll_wait)(epollfd.get(), result, 2, -1);
+        TEST_PCHECK(n > 0);
+        for (int j = 0; j < n; j++) {
+          if (result[j].data.u64 == kDoneData) {
+            return;
+          }
+        }
+        // Only one woken waiter consumes the event.
+        uint64_t val;
+        if (ReadFd(event.get(), &val, sizeof(val)) == sizeof(val)) {
+          TEST_PCHECK(WriteFd(ack.get(), &kEventVal, sizeof(kEventVal)) ==
+                      sizeof(kEventVal));
+        } else {
+          TEST_PCHECK(errno == EAGAIN);
+        }
+      }
+    }));
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(WriteFd(event.get(), &kEventVal, sizeof(kEventVal)) ==
+                sizeof(kEventVal));
+    uint64_t val;
+    TEST_PCHECK(ReadFd(ack.get(), &val, sizeof(val)) == sizeof(val));
+  }
+
+  TEST_PCHECK(WriteFd(done.get(), &kEventVal, sizeof(kEventVal)) ==
+              sizeof(kEventVal));
+  threads.clear();
+}
+
+void ExclusiveWakeArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"waiters", "exclusive"});
+  for (int exclusive = 0; exclusive <= 1; exclusive++) {
+    for (int waiters = 1; waiters <= 64; waiters *= 4) {
+      bench->Args({waiters, exclusive});
+    }
+  }
+}
+
+BENCHMARK(BM_EpollExclusiveWake)->Apply(ExclusiveWakeArgs)->UseRealTime();
+
+// Modes of BM_EpollRearm.
+enum class Trigger {
+  kLevel,
+  kEdge,
+  // Like kLevel, but with EPOLLONESHOT, which must be rearmed with
+  // EPOLL_CTL_MOD after each event.
+  kOneshot,
+};
+
+// BM_EpollRearm measures one event cycle on an eventfd: signal it, collect the
+// event, consume it and, for EPOLLONESHOT, rearm it.
+void BM_EpollRearm(benchmark::State& state, Trigger trigger) {
+  constexpr uint64_t kEventVal = 1;
+  int events = EPOLLIN;
+  switch (trigger) {
+    case Trigger::kLevel:
+      break;
+    case Trigger::kEdge:
+      events |= EPOLLET;
+      break;
+    case Trigger::kOneshot:
+      events |= EPOLLONESHOT;
+      break;
+  }
+
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD(EFD_NONBLOCK));
+  ASSERT_NO_ERRNO(RegisterEpollFD(epollfd.get(), eventfd.get(), events, 0));
+
+  struct epoll_event result;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(WriteFd(eventfd.get(), &kEventVal, sizeof(kEventVal)) ==
+                sizeof(kEventVal));
+    TEST_CHECK(epoll_wait(epollfd.get(), &result, 1, 0) == 1);
+    uint64_t val;
+    TEST_PCHECK(ReadFd(eventfd.get(), &val, sizeof(val)) == sizeof(val));
+    if (trigger == Trigger::kOneshot) {
+      struct epoll_event event = {};
+      event.events = events;
+      TEST_PCHECK(epoll_ctl(epollfd.get(), EPOLL_CTL_MOD, eventfd.get(),
+                            &event) == 0);
+    }
+  }
+}
+
+BENCHMARK_CAPTURE(BM_EpollRearm, level, Trigger::kLevel);
+BENCHMARK_CAPTURE(BM_EpollRearm, edge, Trigger::kEdge);
+BENCHMARK_CAPTURE(BM_EpollRearm, oneshot, Trigger::kOneshot);
+
 }  // namespace
 
 }  // namespace testing
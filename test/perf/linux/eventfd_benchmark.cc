@@ -0,0 +1,124 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// BM_EventfdWriteRead measures a write to an eventfd followed by a read of it
+// on the same thread, with no waiters to wake.
+void BM_EventfdWriteRead(benchmark::State& state) {
+  const int fd = eventfd(0, state.range(0) ? EFD_SEMAPHORE : 0);
+  TEST_PCHECK(fd >= 0);
+
+  uint64_t val = 1;
+  for (auto _ : state) {
+    TEST_PCHECK(WriteFd(fd, &val, sizeof(val)) == sizeof(val));
+    TEST_PCHECK(ReadFd(fd, &val, sizeof(val)) == sizeof(val));
+  }
+
+  close(fd);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_EventfdWriteRead)->Arg(0)->Arg(1);
+
+// BM_EventfdSemaphore measures the throughput of an EFD_SEMAPHORE eventfd used
+// as a work queue: another thread signals one item per write while this thread
+// consumes one item per read, blocking whenever it catches up.
+void BM_EventfdSemaphore(benchmark::State& state) {
+  const int fd = eventfd(0, EFD_SEMAPHORE);
+  TEST_PCHECK(fd >= 0);
+
+  ScopedThread t([&] {
+    const uint64_t val = 1;
+    for (int i = 0; i < state.max_iterations; i++) {
+      TEST_PCHECK(WriteFd(fd, &val, sizeof(val)) == sizeof(val));
+    }
+  });
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    uint64_t val;
+    TEST_PCHECK(ReadFd(fd, &val, sizeof(val)) == sizeof(val));
+    TEST_CHECK(val == 1);
+  }
+
+  t.Join();
+  close(fd);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_EventfdSemaphore)->UseRealTime();
+
+// BM_EventfdPingPong measures the latency of waking a thread blocked reading
+// an eventfd, as the round trip of a signal to another thread through one
+// eventfd and back through a second.
+void BM_EventfdPingPong(benchmark::State& state) {
+  const int ping = eventfd(0, 0);
+  TEST_PCHECK(ping >= 0);
+  const int pong = eventfd(0, 0);
+  TEST_PCHECK(pong >= 0);
+
+  // Writing kStop to ping stops the echoing thread.
+  constexpr uint64_t kStop = 2;
+  ScopedThread t([&] {
+    uint64_t val;
+    while (true) {
+      TEST_PCHECK(ReadFd(ping, &val, sizeof(val)) == sizeof(val));
+      if (val == kStop) {
+        return;
+      }
+      TEST_PCHECK(WriteFd(pong, &val, sizeof(val)) == sizeof(val));
+    }
+  });
+
+  LatencyHistogram latency;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    uint64_t val = 1;
+    const int64_t start = LatencyHistogram::Now();
+    TEST_PCHECK(WriteFd(ping, &val, sizeof(val)) == sizeof(val));
+    TEST_PCHECK(ReadFd(pong, &val, sizeof(val)) == sizeof(val));
+    latency.Record(LatencyHistogram::Now() - start);
+  }
+
+  TEST_PCHECK(WriteFd(ping, &kStop, sizeof(kStop)) == sizeof(kStop));
+  t.Join();
+
+  close(ping);
+  close(pong);
+  state.SetItemsProcessed(state.iterations());
+  latency.Report(state);
+}
+
+BENCHMARK(BM_EventfdPingPong)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,237 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/cleanup.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/multiprocess_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Statically linked workload.
+constexpr char kStaticWorkload[] = "test/perf/linux/exec_static_workload";
+
+// Dynamically linked, non-PIE workload that depends on the 32 synthetic
+// exec_lib_* shared libraries in addition to libc.
+constexpr char kDynamicWorkload[] = "test/perf/linux/exec_dynamic_workload";
+
+// Dynamically linked PIE workload that depends only on libc.
+constexpr char kPIEWorkload[] = "test/perf/linux/exec_pie_workload";
+
+// Ways of creating the child process.
+enum class Spawn {
+  // fork(2), via ForkAndExec.
+  kFork,
+
+  // clone(CLONE_VM | CLONE_VFORK), via SpawnAndExec.
+  kVfork,
+};
+
+// Exec runs workload at path to exit, creating it with spawn, and returns the
+// time from just before the child is created until the first instruction of
+// the workload's main.
+int64_t Exec(const std::string& path, const ExecveArray& argv,
+             const ExecveArray& envv, Spawn spawn) {
+  int pipe_fds[2];
+  TEST_PCHECK(pipe(pipe_fds) == 0);
+  FileDescriptor read_fd(pipe_fds[0]);
+  FileDescriptor write_fd(pipe_fds[1]);
+
+  // Send the workload's stdout to the pipe.
+  const auto remap_stdout = [&] {
+    if (dup2(pipe_fds[1], STDOUT_FILENO) < 0) {
+      _exit(errno);
+    }
+  };
+
+  pid_t child;
+  int execve_errno;
+  const int64_t start = LatencyHistogram::Now();
+  auto kill_or =
+      spawn == Spawn::kFork
+          ? ForkAndExec(path, argv, envv, remap_stdout, &child, &execve_errno)
+          : SpawnAndExec(path, argv, envv, remap_stdout, &child,
+                         &execve_errno);
+  TEST_CHECK(kill_or.ok());
+  Cleanup kill = std::move(kill_or).ValueOrDie();
+  TEST_CHECK(execve_errno == 0);
+  write_fd.reset();
+
+  int64_t main_ns;
+  TEST_PCHECK(ReadFd(read_fd.get(), &main_ns, sizeof(main_ns)) ==
+              sizeof(main_ns));
+
+  int status;
+  TEST_PCHECK(RetryEINTR(waitpid)(child, &status, 0) == child);
+  TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  kill.Release();
+  return main_ns - start;
+}
+
+// BM_Exec measures fork, execve of workload, and running it to exit. In
+// addition, it reports to_main_ns: the time from just before fork until the
+// first instruction of the workload's main, which covers loading and
+// relocating the binary and its shared libraries.
+void BM_Exec(benchmark::State& state, const char* workload) {
+  const std::string path = RunfilePath(workload);
+  const ExecveArray argv = {path};
+  const ExecveArray envv = {};
+
+  int64_t to_main_ns = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    to_main_ns += Exec(path, argv, envv, Spawn::kFork);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["to_main_ns"] =
+      benchmark::Counter(to_main_ns, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_CAPTURE(BM_Exec, static, kStaticWorkload)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Exec, dynamic_32_libs, kDynamicWorkload)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Exec, pie, kPIEWorkload)->UseRealTime();
+
+// BM_ExecModified is BM_Exec of a copy of the static workload whose
+// timestamps are updated before each exec, so that the loader can't reuse the
+// headers it parsed on a previous exec.
+void BM_ExecModified(benchmark::State& state) {
+  const std::string contents =
+      ASSERT_NO_ERRNO_AND_VALUE(GetContents(RunfilePath(kStaticWorkload)));
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(
+      TempPath::CreateFileWith(GetAbsoluteTestTmpdir(), contents, 0755));
+  const std::string path = file.path();
+  const FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path, O_RDONLY));
+  const ExecveArray argv = {path};
+  const ExecveArray envv = {};
+
+  int64_t to_main_ns = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(futimens(fd.get(), nullptr) == 0);
+    to_main_ns += Exec(path, argv, envv, Spawn::kFork);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["to_main_ns"] =
+      benchmark::Counter(to_main_ns, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ExecModified)->UseRealTime();
+
+// BM_ExecParentRSS is BM_Exec of the static workload from a parent with an
+// additional state.range(0) MB of resident, dirty anonymous memory, whose
+// page tables fork must copy but vfork need not.
+void BM_ExecParentRSS(benchmark::State& state, Spawn spawn) {
+  const std::string path = RunfilePath(kStaticWorkload);
+  const ExecveArray argv = {path};
+  const ExecveArray envv = {};
+
+  const size_t len = static_cast<size_t>(state.range(0)) << 20;
+  Mapping m;
+  if (len > 0) {
+    m = ASSERT_NO_ERRNO_AND_VALUE(
+        MmapAnon(len, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+    for (size_t off = 0; off < len; off += kPageSize) {
+      static_cast<char*>(m.ptr())[off] = 1;
+    }
+  }
+
+  int64_t to_main_ns = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    to_main_ns += Exec(path, argv, envv, spawn);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["to_main_ns"] =
+      benchmark::Counter(to_main_ns, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_CAPTURE(BM_ExecParentRSS, fork, Spawn::kFork)
+    ->Arg(0)
+    ->Range(16, 1024)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ExecParentRSS, vfork, Spawn::kVfork)
+    ->Arg(0)
+    ->Range(16, 1024)
+    ->UseRealTime();
+
+// Versioned VDSO symbols that libc looks up during startup of every dynamically
+// linked process, and the version they are defined in.
+#if defined(__x86_64__)
+constexpr char kVDSOVersion[] = "LINUX_2.6";
+constexpr const char* kVDSOSymbols[] = {
+    "__vdso_clock_gettime", "__vdso_gettimeofday", "__vdso_time",
+    "__vdso_getcpu",        "__vdso_clock_getres",
+};
+#elif defined(__aarch64__)
+constexpr char kVDSOVersion[] = "LINUX_2.6.39";
+constexpr const char* kVDSOSymbols[] = {
+    "__kernel_clock_gettime",
+    "__kernel_gettimeofday",
+    "__kernel_clock_getres",
+};
+#endif
+
+// BM_VDSOSymbolLookup measures the dynamic linker's versioned lookup of the
+// VDSO symbols used by libc, which is part of to_main_ns of every dynamically
+// linked workload in BM_Exec. It isolates the cost that depends on the VDSO's
+// symbol hash table and versions from the rest of process startup.
+void BM_VDSOSymbolLookup(benchmark::State& state) {
+  void* vdso = dlopen("linux-vdso.so.1", RTLD_LAZY | RTLD_NOLOAD);
+  if (vdso == nullptr) {
+    state.SkipWithError("no VDSO");
+    return;
+  }
+
+  for (auto _ : state) {
+    for (const char* name : kVDSOSymbols) {
+      void* sym = dlvsym(vdso, name, kVDSOVersion);
+      TEST_CHECK(sym != nullptr);
+      benchmark::DoNotOptimize(sym);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          (sizeof(kVDSOSymbols) / sizeof(kVDSOSymbols[0])));
+}
+
+BENCHMARK(BM_VDSOSymbolLookup);
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,35 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A synthetic shared library loaded by exec_dynamic_workload. Each copy is
+// built with a distinct EXEC_LIB_ID, so that each exports its own symbols, and
+// has a pointer that needs a symbol lookup when the library is relocated.
+
+#ifndef EXEC_LIB_ID
+#error "EXEC_LIB_ID must be defined"
+#endif
+
+#define EXEC_LIB_CONCAT(a, b) a##b
+#define EXEC_LIB_SYMBOL(name, id) EXEC_LIB_CONCAT(name, id)
+
+extern "C" {
+
+int EXEC_LIB_SYMBOL(exec_lib_function_, EXEC_LIB_ID)(int x) {
+  return x + EXEC_LIB_ID;
+}
+
+int (*EXEC_LIB_SYMBOL(exec_lib_pointer_, EXEC_LIB_ID))(int) =
+    &EXEC_LIB_SYMBOL(exec_lib_function_, EXEC_LIB_ID);
+
+}  // extern "C"
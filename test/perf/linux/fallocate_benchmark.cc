@@ -0,0 +1,60 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// BM_CreateFallocateTruncate measures creating a file, allocating its
+// contents, truncating it and unlinking it, as done with scratch files by
+// builds in large tmpfs directories.
+void BM_CreateFallocateTruncate(benchmark::State& state) {
+  const off_t size = state.range(0);
+  const std::string path = NewTempAbsPath();
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    const int fd = open(path.c_str(), O_CREAT | O_RDWR, 0644);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(fallocate(fd, 0, 0, size) == 0);
+    TEST_PCHECK(ftruncate(fd, 0) == 0);
+    TEST_PCHECK(close(fd) == 0);
+    TEST_PCHECK(unlink(path.c_str()) == 0);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_CreateFallocateTruncate)
+    ->RangeMultiplier(32)
+    ->Range(1 << 20, 1 << 30)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,118 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Sets a POSIX record lock of the given type on the single byte at off.
+int SetByteLock(int fd, short type, off_t off) {
+  struct flock fl = {};
+  fl.l_type = type;
+  fl.l_whence = SEEK_SET;
+  fl.l_start = off;
+  fl.l_len = 1;
+  return fcntl(fd, F_SETLK, &fl);
+}
+
+// BM_FcntlLock measures taking and releasing a write lock on one byte of a
+// file on which each of state.range(0) other processes holds state.range(1)
+// write locks, and repeatedly takes and releases one more, all on disjoint
+// ranges. This is the pattern of databases that lock individual records.
+void BM_FcntlLock(benchmark::State& state) {
+  const int procs = state.range(0);
+  const int ranges = state.range(1);
+
+  auto path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path.path(), O_RDWR));
+
+  // Children report that they hold their locks through ready. Locks are
+  // spaced out so that they are not merged.
+  int ready[2];
+  TEST_PCHECK(pipe(ready) == 0);
+  std::vector<pid_t> children;
+  for (int i = 0; i < procs; i++) {
+    const off_t base = 2 * i * (ranges + 1);
+    const pid_t pid = fork();
+    if (pid == 0) {
+      for (int j = 0; j < ranges; j++) {
+        TEST_PCHECK(SetByteLock(fd.get(), F_WRLCK, base + 2 * j) == 0);
+      }
+      char c = 0;
+      TEST_PCHECK(WriteFd(ready[1], &c, 1) == 1);
+      const off_t off = base + 2 * ranges;
+      while (true) {
+        TEST_PCHECK(SetByteLock(fd.get(), F_WRLCK, off) == 0);
+        TEST_PCHECK(SetByteLock(fd.get(), F_UNLCK, off) == 0);
+      }
+    }
+    TEST_PCHECK(pid > 0);
+    children.push_back(pid);
+  }
+  for (int i = 0; i < procs; i++) {
+    char c;
+    TEST_PCHECK(ReadFd(ready[0], &c, 1) == 1);
+  }
+
+  const off_t off = 2 * procs * (ranges + 1);
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(SetByteLock(fd.get(), F_WRLCK, off) == 0);
+    TEST_PCHECK(SetByteLock(fd.get(), F_UNLCK, off) == 0);
+  }
+
+  for (pid_t pid : children) {
+    TEST_PCHECK(kill(pid, SIGKILL) == 0);
+    int status;
+    TEST_PCHECK(RetryEINTR(waitpid)(pid, &status, 0) == pid);
+  }
+  close(ready[0]);
+  close(ready[1]);
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void FcntlLockArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"procs", "ranges"});
+  for (int procs : {0, 1, 4, 16}) {
+    for (int ranges : {1, 64, 4096}) {
+      bench->Args({procs, ranges});
+    }
+  }
+}
+
+BENCHMARK(BM_FcntlLock)->Apply(FcntlLockArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
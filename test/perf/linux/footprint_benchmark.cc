@@ -0,0 +1,207 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/rlimit_util.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// UsedMemory returns MemTotal - MemFree from /proc/meminfo, in bytes.
+//
+// In gVisor, this is the sentry's accounting of its memory file, which backs
+// application memory as well as memory the sentry allocates on behalf of tasks
+// and files. On Linux it is system-wide, so results are noisy and should be
+// read as an upper bound.
+uint64_t UsedMemory() {
+  const std::string meminfo = GetContents("/proc/meminfo").ValueOrDie();
+  uint64_t total_kb = 0, free_kb = 0;
+  for (absl::string_view line : absl::StrSplit(meminfo, '\n')) {
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(line, ' ', absl::SkipEmpty());
+    if (fields.size() < 2) {
+      continue;
+    }
+    if (fields[0] == "MemTotal:") {
+      TEST_CHECK(absl::SimpleAtoi(fields[1], &total_kb));
+    } else if (fields[0] == "MemFree:") {
+      TEST_CHECK(absl::SimpleAtoi(fields[1], &free_kb));
+    }
+  }
+  TEST_CHECK(total_kb > 0);
+  return (total_kb - free_kb) * 1024;
+}
+
+// ResidentMemory returns the resident set size of this process, in bytes.
+uint64_t ResidentMemory() {
+  const std::string statm = GetContents("/proc/self/statm").ValueOrDie();
+  std::vector<absl::string_view> fields =
+      absl::StrSplit(statm, ' ', absl::SkipEmpty());
+  uint64_t pages;
+  TEST_CHECK(fields.size() >= 2 && absl::SimpleAtoi(fields[1], &pages));
+  return pages * kPageSize;
+}
+
+// Objects created by BM_Footprint.
+enum class Object {
+  // Threads blocked on a futex.
+  kIdleThread,
+
+  // Single page anonymous mappings, never touched.
+  kMapping,
+
+  // eventfds.
+  kFD,
+
+  // Unconnected TCP sockets.
+  kSocket,
+};
+
+// Objects holds the objects created by one iteration of BM_Footprint.
+struct Objects {
+  absl::Notification release;
+  std::vector<std::unique_ptr<ScopedThread>> threads;
+  std::vector<Mapping> mappings;
+  std::vector<FileDescriptor> fds;
+
+  ~Objects() { release.Notify(); }
+};
+
+// Create adds n objects of kind object to objects.
+void Create(Object object, int n, Objects* objects) {
+  for (int i = 0; i < n; i++) {
+    switch (object) {
+      case Object::kIdleThread: {
+        absl::Notification* release = &objects->release;
+        objects->threads.push_back(absl::make_unique<ScopedThread>(
+            [release] { release->WaitForNotification(); }));
+        break;
+      }
+      case Object::kMapping: {
+        // Alternate protections so that adjacent mappings are not merged
+        // into a single VMA.
+        const int prot = i % 2 ? PROT_READ : PROT_READ | PROT_WRITE;
+        objects->mappings.push_back(
+            MmapAnon(kPageSize, prot, MAP_PRIVATE).ValueOrDie());
+        break;
+      }
+      case Object::kFD: {
+        const int fd = eventfd(0, 0);
+        TEST_PCHECK(fd >= 0);
+        objects->fds.emplace_back(fd);
+        break;
+      }
+      case Object::kSocket: {
+        const int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        TEST_PCHECK(fd >= 0);
+        objects->fds.emplace_back(fd);
+        break;
+      }
+    }
+  }
+}
+
+// BM_Footprint creates state.range(0) objects of kind object per iteration,
+// and reports the marginal memory used per object:
+//
+//   bytes_per_object: growth of used memory in /proc/meminfo.
+//   rss_per_object: growth of this process's resident set size.
+//
+// The reported time is the time to create and destroy each object.
+void BM_Footprint(benchmark::State& state, Object object) {
+  const int n = state.range(0);
+
+  auto rlimit_or = ScopedSetSoftRlimit(RLIMIT_NOFILE, n + 64);
+  if (!rlimit_or.ok()) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  auto rlimit = std::move(rlimit_or).ValueOrDie();
+
+  int64_t used = 0;
+  int64_t rss = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto objects = absl::make_unique<Objects>();
+    // Don't count the vectors themselves.
+    objects->threads.reserve(n);
+    objects->mappings.reserve(n);
+    objects->fds.reserve(n);
+    const int64_t used_before = UsedMemory();
+    const int64_t rss_before = ResidentMemory();
+    state.ResumeTiming();
+
+    Create(object, n, objects.get());
+
+    state.PauseTiming();
+    used += UsedMemory() - used_before;
+    rss += ResidentMemory() - rss_before;
+    state.ResumeTiming();
+
+    objects.reset();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(n) * state.iterations());
+  if (state.iterations() > 0) {
+    const double objects = static_cast<double>(n) * state.iterations();
+    state.counters["bytes_per_object"] = used / objects;
+    state.counters["rss_per_object"] = rss / objects;
+  }
+}
+
+BENCHMARK_CAPTURE(BM_Footprint, idle_thread, Object::kIdleThread)
+    ->Range(64, 4096)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Footprint, mapping, Object::kMapping)
+    ->Range(64, 16384)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Footprint, fd, Object::kFD)
+    ->Range(64, 16384)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Footprint, socket, Object::kSocket)
+    ->Range(64, 16384)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
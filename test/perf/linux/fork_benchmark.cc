@@ -12,17 +12,39 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "absl/synchronization/barrier.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/cleanup.h"
 #include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
 #include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
 #include "test/util/test_util.h"
 #include "test/util/thread_util.h"
 
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
 namespace gvisor {
 namespace testing {
 
@@ -47,6 +69,7 @@ int busy(int max) {
 }
 
 void BM_CPUBoundUniprocess(benchmark::State& state) {
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     busy(kBusyMax);
   }
@@ -64,6 +87,7 @@ void BM_CPUBoundAsymmetric(benchmark::State& state) {
     _exit(0);
   }
   ASSERT_THAT(child, SyscallSucceeds());
+  ScopedRusageCounters rusage(state);
   ASSERT_TRUE(state.KeepRunningBatch(max));
 
   int status;
@@ -87,6 +111,7 @@ void BM_CPUBoundSymmetric(benchmark::State& state) {
     ASSERT_FALSE(state.KeepRunning());
   });
 
+  ScopedRusageCounters rusage(state);
   const int processes = state.range(0);
   for (int i = 0; i < processes; i++) {
     size_t cur = (state.max_iterations + (processes - 1)) / processes;
@@ -131,6 +156,188 @@ void SwitchChild(int readfd, int writefd) {
   }
 }
 
+// Placement of the members of a ProcessSwitch/ThreadSwitch ring on CPUs.
+enum class Placement {
+  // No CPU affinity; the scheduler places members.
+  kAny,
+
+  // All members on the same CPU, so every wakeup is local.
+  kSameCore,
+
+  // Members on different CPUs that share a last level cache.
+  kSameLLC,
+
+  // Consecutive members on different NUMA nodes.
+  kCrossNUMA,
+
+  // Each member on its own CPU, as in thread-per-core runtimes.
+  kOwnCore,
+};
+
+// ParseCPUList parses a sysfs CPU list, like "0-3,8,10-11".
+PosixErrorOr<std::vector<int>> ParseCPUList(absl::string_view list) {
+  std::vector<int> cpus;
+  for (absl::string_view range :
+       absl::StrSplit(absl::StripAsciiWhitespace(list), ',',
+                      absl::SkipEmpty())) {
+    std::vector<absl::string_view> bounds = absl::StrSplit(range, '-');
+    int first, last;
+    if (bounds.size() > 2 || !absl::SimpleAtoi(bounds[0], &first) ||
+        !absl::SimpleAtoi(bounds.back(), &last) || first > last) {
+      return PosixError(EINVAL, absl::StrCat("bad CPU list: ", list));
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// ReadCPUList reads a sysfs CPU list file, keeping only the CPUs in allowed.
+PosixErrorOr<std::vector<int>> ReadCPUList(const std::string& path,
+                                           const cpu_set_t& allowed) {
+  ASSIGN_OR_RETURN_ERRNO(std::string contents, GetContents(path));
+  ASSIGN_OR_RETURN_ERRNO(std::vector<int> cpus, ParseCPUList(contents));
+  cpus.erase(std::remove_if(cpus.begin(), cpus.end(),
+                            [&](int cpu) {
+                              return cpu >= CPU_SETSIZE ||
+                                     !CPU_ISSET(cpu, &allowed);
+                            }),
+             cpus.end());
+  return cpus;
+}
+
+// LLCCPUs returns the allowed CPUs that share the last level cache of cpu.
+PosixErrorOr<std::vector<int>> LLCCPUs(int cpu, const cpu_set_t& allowed) {
+  const std::string cache =
+      absl::StrCat("/sys/devices/system/cpu/cpu", cpu, "/cache");
+  int max_level = 0;
+  std::string shared;
+  for (int i = 0;; i++) {
+    const std::string index = absl::StrCat(cache, "/index", i);
+    ASSIGN_OR_RETURN_ERRNO(bool exists, Exists(index));
+    if (!exists) {
+      break;
+    }
+    ASSIGN_OR_RETURN_ERRNO(std::string level_str,
+                           GetContents(JoinPath(index, "level")));
+    int level;
+    if (!absl::SimpleAtoi(absl::StripAsciiWhitespace(level_str), &level)) {
+      return PosixError(EINVAL, absl::StrCat("bad cache level: ", level_str));
+    }
+    if (level > max_level) {
+      max_level = level;
+      shared = JoinPath(index, "shared_cpu_list");
+    }
+  }
+  if (shared.empty()) {
+    return PosixError(ENOENT, absl::StrCat("no cache topology in ", cache));
+  }
+  return ReadCPUList(shared, allowed);
+}
+
+// NUMANodeCPUs returns the allowed CPUs of each NUMA node that has any.
+PosixErrorOr<std::vector<std::vector<int>>> NUMANodeCPUs(
+    const cpu_set_t& allowed) {
+  std::vector<std::vector<int>> nodes;
+  for (int i = 0;; i++) {
+    const std::string cpulist =
+        absl::StrCat("/sys/devices/system/node/node", i, "/cpulist");
+    ASSIGN_OR_RETURN_ERRNO(bool exists, Exists(cpulist));
+    if (!exists) {
+      break;
+    }
+    ASSIGN_OR_RETURN_ERRNO(std::vector<int> cpus,
+                           ReadCPUList(cpulist, allowed));
+    if (!cpus.empty()) {
+      nodes.push_back(std::move(cpus));
+    }
+  }
+  return nodes;
+}
+
+// PlacementCPUs returns the CPU for each of n ring members with placement, or
+// an empty vector for Placement::kAny. Members wrap around the available CPUs
+// if there are fewer CPUs than members.
+PosixErrorOr<std::vector<int>> PlacementCPUs(Placement placement, int n) {
+  if (placement == Placement::kAny) {
+    return std::vector<int>();
+  }
+
+  cpu_set_t allowed;
+  RETURN_ERROR_IF_SYSCALL_FAIL(
+      sched_getaffinity(/*pid=*/0, sizeof(allowed), &allowed));
+  int first = 0;
+  while (first < CPU_SETSIZE && !CPU_ISSET(first, &allowed)) {
+    first++;
+  }
+
+  std::vector<int> cpus;
+  switch (placement) {
+    case Placement::kAny:
+      break;
+    case Placement::kSameCore:
+      cpus.assign(n, first);
+      break;
+    case Placement::kSameLLC: {
+      ASSIGN_OR_RETURN_ERRNO(std::vector<int> llc, LLCCPUs(first, allowed));
+      if (llc.size() < 2) {
+        return PosixError(ENOENT, "fewer than 2 CPUs share the LLC");
+      }
+      for (int i = 0; i < n; i++) {
+        cpus.push_back(llc[i % llc.size()]);
+      }
+      break;
+    }
+    case Placement::kCrossNUMA: {
+      ASSIGN_OR_RETURN_ERRNO(auto nodes, NUMANodeCPUs(allowed));
+      if (nodes.size() < 2) {
+        return PosixError(ENOENT, "fewer than 2 NUMA nodes");
+      }
+      for (int i = 0; i < n; i++) {
+        const std::vector<int>& node = nodes[i % nodes.size()];
+        cpus.push_back(node[(i / nodes.size()) % node.size()]);
+      }
+      break;
+    }
+    case Placement::kOwnCore: {
+      std::vector<int> all;
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+          all.push_back(cpu);
+        }
+      }
+      if (all.size() < static_cast<size_t>(n)) {
+        return PosixError(ENOENT, "fewer CPUs than members");
+      }
+      cpus.assign(all.begin(), all.begin() + n);
+      break;
+    }
+  }
+  return cpus;
+}
+
+// PinToCPU sets the affinity of the calling thread to cpu.
+PosixError PinToCPU(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  RETURN_ERROR_IF_SYSCALL_FAIL(sched_setaffinity(/*pid=*/0, sizeof(set), &set));
+  return NoError();
+}
+
+// PinSelf pins the calling thread to cpu, and returns a Cleanup that restores
+// its original affinity.
+PosixErrorOr<Cleanup> PinSelf(int cpu) {
+  cpu_set_t orig;
+  RETURN_ERROR_IF_SYSCALL_FAIL(
+      sched_getaffinity(/*pid=*/0, sizeof(orig), &orig));
+  RETURN_IF_ERRNO(PinToCPU(cpu));
+  return Cleanup([orig] {
+    TEST_PCHECK(sched_setaffinity(/*pid=*/0, sizeof(orig), &orig) == 0);
+  });
+}
+
 // Send bytes in a loop through a series of pipes, each passing through a
 // different process.
 //
@@ -145,12 +352,20 @@ void SwitchChild(int readfd, int writefd) {
 //    * <---------- *
 //  Proc 3        Proc 2
 //
-// This exercises context switching through multiple processes.
-void BM_ProcessSwitch(benchmark::State& state) {
+// This exercises context switching through multiple processes, with the
+// processes placed on CPUs according to placement.
+void BM_ProcessSwitch(benchmark::State& state, Placement placement) {
   // Code below assumes there are at least two processes.
   const int num_processes = state.range(0);
   ASSERT_GE(num_processes, 2);
 
+  auto cpus_or = PlacementCPUs(placement, num_processes);
+  if (!cpus_or.ok()) {
+    state.SkipWithError(cpus_or.error().ToString().c_str());
+    return;
+  }
+  const std::vector<int> cpus = cpus_or.ValueOrDie();
+
   std::vector<pid_t> children;
   auto child_cleanup = Cleanup([&] {
     for (const pid_t child : children) {
@@ -186,6 +401,7 @@ void BM_ProcessSwitch(benchmark::State& state) {
     // std::vector isn't safe to use from the fork child.
     FileDescriptor* read_array = read_fds.data();
     FileDescriptor* write_array = write_fds.data();
+    const int cpu = cpus.empty() ? -1 : cpus[i];
 
     pid_t child = fork();
     if (!child) {
@@ -199,6 +415,10 @@ void BM_ProcessSwitch(benchmark::State& state) {
         }
       }
 
+      if (cpu >= 0) {
+        TEST_CHECK(PinToCPU(cpu).ok());
+      }
+
       SwitchChild(read_fd, write_fd);
       _exit(0);
     }
@@ -213,24 +433,53 @@ void BM_ProcessSwitch(benchmark::State& state) {
   const int write_index = 1;
   const int write_fd = write_fds[write_index].get();
 
+  // Pin this thread only now, so that the others do not inherit its affinity.
+  Cleanup unpin;
+  if (!cpus.empty()) {
+    unpin = ASSERT_NO_ERRNO_AND_VALUE(PinSelf(cpus[0]));
+  }
+
   // Kick start the loop.
   char buf = 'a';
   ASSERT_THAT(WriteFd(write_fd, &buf, 1), SyscallSucceedsWithValue(1));
 
+  LatencyHistogram latency;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
+    const int64_t start = LatencyHistogram::Now();
     ASSERT_THAT(ReadFd(read_fd, &buf, 1), SyscallSucceedsWithValue(1));
     ASSERT_THAT(WriteFd(write_fd, &buf, 1), SyscallSucceedsWithValue(1));
+    latency.Record(LatencyHistogram::Now() - start);
   }
+  latency.Report(state);
 }
 
-BENCHMARK(BM_ProcessSwitch)->Range(2, 16)->UseRealTime();
-
-// Equivalent to BM_ThreadSwitch using threads instead of processes.
-void BM_ThreadSwitch(benchmark::State& state) {
+BENCHMARK_CAPTURE(BM_ProcessSwitch, any, Placement::kAny)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessSwitch, same_core, Placement::kSameCore)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessSwitch, same_llc, Placement::kSameLLC)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessSwitch, cross_numa, Placement::kCrossNUMA)
+    ->Range(2, 16)
+    ->UseRealTime();
+
+// Equivalent to BM_ProcessSwitch using threads instead of processes.
+void BM_ThreadSwitch(benchmark::State& state, Placement placement) {
   // Code below assumes there are at least two threads.
   const int num_threads = state.range(0);
   ASSERT_GE(num_threads, 2);
 
+  auto cpus_or = PlacementCPUs(placement, num_threads);
+  if (!cpus_or.ok()) {
+    state.SkipWithError(cpus_or.error().ToString().c_str());
+    return;
+  }
+  const std::vector<int> cpus = cpus_or.ValueOrDie();
+
   // Must come after threads, as the FDs must be closed before the children
   // will exit.
   std::vector<std::unique_ptr<ScopedThread>> threads;
@@ -256,11 +505,16 @@ void BM_ThreadSwitch(benchmark::State& state) {
     const int write_index = (i + 1) % num_threads;
     const int write_fd = write_fds[write_index].release();
 
-    threads.emplace_back(std::make_unique<ScopedThread>([read_fd, write_fd] {
-      FileDescriptor read(read_fd);
-      FileDescriptor write(write_fd);
-      SwitchChild(read.get(), write.get());
-    }));
+    const int cpu = cpus.empty() ? -1 : cpus[i];
+    threads.emplace_back(
+        std::make_unique<ScopedThread>([read_fd, write_fd, cpu] {
+          FileDescriptor read(read_fd);
+          FileDescriptor write(write_fd);
+          if (cpu >= 0) {
+            TEST_CHECK(PinToCPU(cpu).ok());
+          }
+          SwitchChild(read.get(), write.get());
+        }));
   }
 
   // Read from current pipe index (0), write to next (1).
@@ -270,10 +524,17 @@ void BM_ThreadSwitch(benchmark::State& state) {
   const int write_index = 1;
   const int write_fd = write_fds[write_index].get();
 
+  // Pin this thread only now, so that the others do not inherit its affinity.
+  Cleanup unpin;
+  if (!cpus.empty()) {
+    unpin = ASSERT_NO_ERRNO_AND_VALUE(PinSelf(cpus[0]));
+  }
+
   // Kick start the loop.
   char buf = 'a';
   ASSERT_THAT(WriteFd(write_fd, &buf, 1), SyscallSucceedsWithValue(1));
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     ASSERT_THAT(ReadFd(read_fd, &buf, 1), SyscallSucceedsWithValue(1));
     ASSERT_THAT(WriteFd(write_fd, &buf, 1), SyscallSucceedsWithValue(1));
@@ -283,11 +544,26 @@ void BM_ThreadSwitch(benchmark::State& state) {
   // to exit its loop and close its FDs, and so on until all threads exit.
 }
 
-BENCHMARK(BM_ThreadSwitch)->Range(2, 16)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ThreadSwitch, any, Placement::kAny)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ThreadSwitch, same_core, Placement::kSameCore)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ThreadSwitch, same_llc, Placement::kSameLLC)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ThreadSwitch, cross_numa, Placement::kCrossNUMA)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ThreadSwitch, own_core, Placement::kOwnCore)
+    ->Range(2, 16)
+    ->UseRealTime();
 
 void BM_ThreadStart(benchmark::State& state) {
   const int num_threads = state.range(0);
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     state.PauseTiming();
 
@@ -320,11 +596,50 @@ void BM_ThreadStart(benchmark::State& state) {
 
 BENCHMARK(BM_ThreadStart)->Range(1, 2048)->UseRealTime();
 
-// Benchmark the complete fork + exit + wait.
+// Benchmark sustained thread creation and exit, as in a thread-per-request
+// server: state.range(0) threads are kept alive, and each iteration joins the
+// oldest and starts a new one. Unlike BM_ThreadStart, this measures the steady
+// state in which exited threads are continually replaced.
+void BM_ThreadChurn(benchmark::State& state) {
+  const int num_threads = state.range(0);
+
+  std::deque<std::unique_ptr<ScopedThread>> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<ScopedThread>([] {}));
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    threads.front()->Join();
+    threads.pop_front();
+    threads.push_back(std::make_unique<ScopedThread>([] {}));
+  }
+
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+}
+
+BENCHMARK(BM_ThreadChurn)->Range(1, 256)->UseRealTime();
+
+// Benchmark the complete fork + exit + wait, with state.range(1) bytes of
+// populated private anonymous memory in the parent, as in a prefork server.
+// Since the child shares the parent's memory copy-on-write, the cost of fork
+// should not depend on the parent's RSS.
 void BM_ProcessLifecycle(benchmark::State& state) {
   const int num_procs = state.range(0);
+  const size_t rss = state.range(1);
+
+  Mapping m;
+  if (rss > 0) {
+    m = MmapAnon(rss, PROT_READ | PROT_WRITE, MAP_PRIVATE).ValueOrDie();
+    for (size_t off = 0; off < rss; off += kPageSize) {
+      reinterpret_cast<volatile char*>(m.ptr())[off] = 42;
+    }
+  }
 
   std::vector<pid_t> pids(num_procs);
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     for (size_t i = 0; i < num_procs; ++i) {
       int pid = fork();
@@ -342,7 +657,142 @@ void BM_ProcessLifecycle(benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_ProcessLifecycle)->Range(1, 512)->UseRealTime();
+BENCHMARK(BM_ProcessLifecycle)->Ranges({{1, 512}, {0, 0}})->UseRealTime();
+BENCHMARK(BM_ProcessLifecycle)
+    ->RangeMultiplier(8)
+    ->Ranges({{1, 1}, {1 << 20, int64_t{8} << 30}})
+    ->UseRealTime();
+
+// Benchmark vfork + exit + wait, with state.range(0) bytes of populated
+// private anonymous memory in the parent. The child borrows the parent's
+// address space rather than sharing it copy-on-write, so unlike
+// BM_ProcessLifecycle, the cost should not depend on the parent's RSS even
+// before the child exits. BM_ExecParentRSS in exec_benchmark.cc covers vfork
+// followed by execve.
+void BM_VforkLifecycle(benchmark::State& state) {
+  const size_t rss = state.range(0);
+
+  Mapping m;
+  if (rss > 0) {
+    m = MmapAnon(rss, PROT_READ | PROT_WRITE, MAP_PRIVATE).ValueOrDie();
+    for (size_t off = 0; off < rss; off += kPageSize) {
+      reinterpret_cast<volatile char*>(m.ptr())[off] = 42;
+    }
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    const pid_t pid = vfork();
+    if (pid == 0) {
+      _exit(0);
+    }
+    TEST_PCHECK(pid > 0);
+    TEST_PCHECK(RetryEINTR(waitpid)(pid, nullptr, 0) == pid);
+  }
+}
+
+BENCHMARK(BM_VforkLifecycle)
+    ->Arg(0)
+    ->RangeMultiplier(8)
+    ->Range(1 << 20, int64_t{8} << 30)
+    ->UseRealTime();
+
+// Ways in which BM_ReapProcesses waits for its children.
+enum class Reap {
+  // waitpid(2) for each child in turn.
+  kWaitpid,
+
+  // waitid(P_ALL) for whichever child exits next.
+  kWaitidAll,
+
+  // epoll_wait(2) on a pidfd for each child, then waitpid(2) for each child
+  // whose pidfd is readable, as an event-driven process supervisor would.
+  kPidfdEpoll,
+};
+
+// Benchmark fork + exit + reap of state.range(0) children at a time, as a
+// process supervisor reaping many short-lived children would. Based on
+// BM_ProcessLifecycle.
+void BM_ReapProcesses(benchmark::State& state, Reap how) {
+  const int num_procs = state.range(0);
+
+  if (how == Reap::kPidfdEpoll) {
+    const int fd = syscall(SYS_pidfd_open, getpid(), 0);
+    if (fd < 0 && errno == ENOSYS) {
+      state.SkipWithError("pidfd_open is not supported");
+      return;
+    }
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(close(fd) == 0);
+  }
+
+  const FileDescriptor epfd(epoll_create1(EPOLL_CLOEXEC));
+  TEST_PCHECK(epfd.get() >= 0);
+  std::vector<pid_t> pids(num_procs);
+  std::vector<struct epoll_event> events(num_procs);
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (int i = 0; i < num_procs; ++i) {
+      const pid_t pid = fork();
+      if (pid == 0) {
+        _exit(0);
+      }
+      TEST_PCHECK(pid > 0);
+      pids[i] = pid;
+      if (how == Reap::kPidfdEpoll) {
+        const int pidfd = syscall(SYS_pidfd_open, pid, 0);
+        TEST_PCHECK(pidfd >= 0);
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = static_cast<uint64_t>(pid) << 32 | pidfd;
+        TEST_PCHECK(epoll_ctl(epfd.get(), EPOLL_CTL_ADD, pidfd, &ev) == 0);
+      }
+    }
+
+    switch (how) {
+      case Reap::kWaitpid:
+        for (const pid_t pid : pids) {
+          TEST_PCHECK(RetryEINTR(waitpid)(pid, nullptr, 0) == pid);
+        }
+        break;
+      case Reap::kWaitidAll:
+        for (int i = 0; i < num_procs; ++i) {
+          siginfo_t info;
+          TEST_PCHECK(RetryEINTR(waitid)(P_ALL, 0, &info, WEXITED) == 0);
+        }
+        break;
+      case Reap::kPidfdEpoll:
+        for (int left = num_procs; left > 0;) {
+          const int n =
+              RetryEINTR(epoll_wait)(epfd.get(), events.data(), left, -1);
+          TEST_PCHECK(n > 0);
+          for (int i = 0; i < n; ++i) {
+            const pid_t pid = events[i].data.u64 >> 32;
+            const int pidfd = events[i].data.u64 & 0xffffffff;
+            TEST_PCHECK(RetryEINTR(waitpid)(pid, nullptr, WNOHANG) == pid);
+            // Closing the pidfd removes it from the epoll set.
+            TEST_PCHECK(close(pidfd) == 0);
+          }
+          left -= n;
+        }
+        break;
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(num_procs) *
+                          state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_ReapProcesses, waitpid, Reap::kWaitpid)
+    ->Range(1, 512)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReapProcesses, waitid_all, Reap::kWaitidAll)
+    ->Range(1, 512)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReapProcesses, pidfd_epoll, Reap::kPidfdEpoll)
+    ->Range(1, 512)
+    ->UseRealTime();
 
 }  // namespace
 
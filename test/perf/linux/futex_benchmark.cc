@@ -13,18 +13,27 @@
 // limitations under the License.
 
 #include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include <atomic>
 #include <cerrno>
 #include <cstdint>
 #include <cstdlib>
+#include <climits>
 #include <ctime>
+#include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/memory/memory.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/logging.h"
+#include "test/util/test_util.h"
 #include "test/util/thread_util.h"
 
 namespace gvisor {
@@ -61,6 +70,7 @@ inline int FutexWake(std::atomic<int32_t>* v, int32_t count) {
 void BM_FutexWakeNop(benchmark::State& state) {
   std::atomic<int32_t> v(0);
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     TEST_PCHECK(FutexWake(&v, 1) == 0);
   }
@@ -73,6 +83,7 @@ BENCHMARK(BM_FutexWakeNop)->MinTime(5);
 void BM_FutexWaitNop(benchmark::State& state) {
   std::atomic<int32_t> v(0);
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     TEST_PCHECK(FutexWait(&v, 1) == -1 && errno == EAGAIN);
   }
@@ -88,6 +99,7 @@ void BM_FutexWaitMonotonicTimeout(benchmark::State& state) {
   std::atomic<int32_t> v(0);
   auto ts = absl::ToTimespec(absl::Nanoseconds(timeout_ns));
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     TEST_PCHECK(FutexWaitMonotonicTimeout(&v, 0, &ts) == -1 &&
                 errno == ETIMEDOUT);
@@ -110,6 +122,7 @@ void BM_FutexWaitMonotonicDeadline(benchmark::State& state) {
   std::atomic<int32_t> v(0);
   struct timespec ts = {};
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     TEST_PCHECK(FutexWaitMonotonicDeadline(&v, 0, &ts) == -1 &&
                 errno == ETIMEDOUT);
@@ -124,6 +137,7 @@ void BM_FutexWaitRealtimeDeadline(benchmark::State& state) {
   std::atomic<int32_t> v(0);
   struct timespec ts = {};
 
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     TEST_PCHECK(FutexWaitRealtimeDeadline(&v, 0, &ts) == -1 &&
                 errno == ETIMEDOUT);
@@ -172,7 +186,10 @@ void BM_FutexRoundtripDelayed(benchmark::State& state) {
       FutexWake(&v, 1);
     }
   });
+  LatencyHistogram latency;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
+    const int64_t start = LatencyHistogram::Now();
     SpinNanos(kBeforeWakeDelayNs + delay_ns);
     v.store(1, std::memory_order_release);
     FutexWake(&v, 1);
@@ -180,7 +197,9 @@ void BM_FutexRoundtripDelayed(benchmark::State& state) {
     while (v.load(std::memory_order_acquire) == 1) {
       FutexWait(&v, 1);
     }
+    latency.Record(LatencyHistogram::Now() - start);
   }
+  latency.Report(state);
 }
 
 BENCHMARK(BM_FutexRoundtripDelayed)
@@ -192,6 +211,282 @@ BENCHMARK(BM_FutexRoundtripDelayed)
     ->Arg(50)
     ->Arg(100);
 
+inline int FutexCmpRequeue(std::atomic<int32_t>* v, int32_t wake,
+                           int32_t requeue, std::atomic<int32_t>* target,
+                           int32_t val) {
+  return syscall(SYS_futex, v, FUTEX_CMP_REQUEUE_PRIVATE, wake, requeue,
+                 target, val);
+}
+
+inline int FutexLockPI(std::atomic<int32_t>* v) {
+  return syscall(SYS_futex, v, FUTEX_LOCK_PI_PRIVATE, 0, nullptr);
+}
+
+inline int FutexUnlockPI(std::atomic<int32_t>* v) {
+  return syscall(SYS_futex, v, FUTEX_UNLOCK_PI_PRIVATE);
+}
+
+// Lock and Unlock implement the three-state futex mutex from Drepper's
+// "Futexes Are Tricky": 0 is unlocked, 1 is locked and 2 is locked with
+// possible waiters.
+void Lock(std::atomic<int32_t>* v) {
+  int32_t c = 0;
+  if (v->compare_exchange_strong(c, 1, std::memory_order_acquire)) {
+    return;
+  }
+  if (c != 2) {
+    c = v->exchange(2, std::memory_order_acquire);
+  }
+  while (c != 0) {
+    FutexWait(v, 2);
+    c = v->exchange(2, std::memory_order_acquire);
+  }
+}
+
+// LockContended is like Lock, but always marks the mutex as possibly having
+// waiters. Threads woken from a condition variable must use it, since waiters
+// requeued onto the mutex futex did not mark it themselves.
+void LockContended(std::atomic<int32_t>* v) {
+  while (v->exchange(2, std::memory_order_acquire) != 0) {
+    FutexWait(v, 2);
+  }
+}
+
+void Unlock(std::atomic<int32_t>* v) {
+  if (v->fetch_sub(1, std::memory_order_release) != 1) {
+    v->store(0, std::memory_order_release);
+    FutexWake(v, 1);
+  }
+}
+
+// LockPI and UnlockPI implement a priority-inheritance mutex, where the futex
+// word holds the owner's TID and the kernel takes over under contention.
+void LockPI(std::atomic<int32_t>* v, int32_t tid) {
+  int32_t c = 0;
+  if (v->compare_exchange_strong(c, tid, std::memory_order_acquire)) {
+    return;
+  }
+  TEST_PCHECK(RetryEINTR(FutexLockPI)(v) == 0);
+}
+
+void UnlockPI(std::atomic<int32_t>* v, int32_t tid) {
+  int32_t c = tid;
+  if (v->compare_exchange_strong(c, 0, std::memory_order_release)) {
+    return;
+  }
+  TEST_PCHECK(FutexUnlockPI(v) == 0);
+}
+
+// Mutex kinds for BM_FutexMutexContended.
+enum class MutexKind {
+  kFutex,
+  kPI,
+};
+
+// BM_FutexMutexContended measures the throughput of all benchmark threads
+// locking and unlocking a single futex-based mutex. The critical section is
+// empty, so this is dominated by futex wait and wake under contention.
+void BM_FutexMutexContended(benchmark::State& state, MutexKind kind) {
+  // Shared by all benchmark threads. It is always unlocked between runs.
+  static std::atomic<int32_t> mu(0);
+  const int32_t tid = syscall(SYS_gettid);
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    switch (kind) {
+      case MutexKind::kFutex:
+        Lock(&mu);
+        Unlock(&mu);
+        break;
+      case MutexKind::kPI:
+        LockPI(&mu, tid);
+        UnlockPI(&mu, tid);
+        break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_FutexMutexContended, futex, MutexKind::kFutex)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_FutexMutexContended, pi, MutexKind::kPI)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+// SentryFutexBucket mirrors bucketIndexForAddr in pkg/sentry/kernel/futex,
+// which maps private futexes to one of 1024 buckets. Linux hashes futexes with
+// a random seed, so addresses chosen with this only collide under gVisor.
+uintptr_t SentryFutexBucket(const void* ptr) {
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return ((addr >> 2) + (addr >> 12) + (addr >> 22) + (addr >> 32) +
+          (addr >> 42)) %
+         1024;
+}
+
+// Futex layouts for BM_FutexBucketContended.
+enum class Layout {
+  // All threads use one futex.
+  kSameFutex,
+  // Each thread uses its own futex, all in the same sentry bucket.
+  kSameBucket,
+  // Each thread uses its own futex in its own sentry bucket.
+  kDistinct,
+};
+
+constexpr int kMaxFutexThreads = 64;
+
+// FutexForThread returns the futex used by the i'th thread with layout.
+std::atomic<int32_t>* FutexForThread(Layout layout, int i) {
+  // Large enough to hold kMaxFutexThreads futexes hashing to the same bucket,
+  // which recur roughly every page.
+  static constexpr int kFutexes = (kMaxFutexThreads + 1) * 4096 / 4;
+  static std::atomic<int32_t>* const futexes =
+      new std::atomic<int32_t>[kFutexes]();
+
+  switch (layout) {
+    case Layout::kSameFutex:
+      return &futexes[0];
+    case Layout::kSameBucket: {
+      const uintptr_t bucket = SentryFutexBucket(&futexes[0]);
+      for (int j = 0; j < kFutexes; j++) {
+        if (SentryFutexBucket(&futexes[j]) == bucket && i-- == 0) {
+          return &futexes[j];
+        }
+      }
+      TEST_CHECK_MSG(false, "not enough colliding futexes");
+      return nullptr;
+    }
+    case Layout::kDistinct:
+      // Adjacent words map to adjacent buckets; keep them on separate cache
+      // lines as well.
+      return &futexes[i * 16];
+  }
+  return nullptr;
+}
+
+// BM_FutexBucketContended measures the throughput of all benchmark threads
+// issuing FUTEX_WAKE with no waiters, which only takes the futex's bucket
+// lock, to expose contention between unrelated futexes in the same bucket.
+void BM_FutexBucketContended(benchmark::State& state, Layout layout) {
+  static std::atomic<int> next_thread(0);
+  std::atomic<int32_t>* v = FutexForThread(
+      layout, next_thread.fetch_add(1) % kMaxFutexThreads);
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(FutexWake(v, 1) == 0);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_FutexBucketContended, same_futex, Layout::kSameFutex)
+    ->ThreadRange(1, kMaxFutexThreads)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_FutexBucketContended, same_bucket, Layout::kSameBucket)
+    ->ThreadRange(1, kMaxFutexThreads)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_FutexBucketContended, distinct, Layout::kDistinct)
+    ->ThreadRange(1, kMaxFutexThreads)
+    ->UseRealTime();
+
+// Broadcast strategies for BM_FutexBroadcast.
+enum class Broadcast {
+  // Wake all waiters on the condition futex, which then contend on the mutex.
+  kWakeAll,
+  // Wake one waiter and requeue the rest onto the mutex futex, as
+  // pthread_cond_broadcast does, so they are woken one at a time as the mutex
+  // is released.
+  kCmpRequeue,
+};
+
+// BM_FutexBroadcast measures the latency of waking state.range(0) threads
+// waiting on a condition variable until all of them have reacquired the
+// associated mutex.
+void BM_FutexBroadcast(benchmark::State& state, Broadcast broadcast) {
+  const int waiters = state.range(0);
+  std::atomic<int32_t> mu(0);
+  std::atomic<int32_t> cond(0);
+  std::atomic<int> waiting(0);
+  std::atomic<int> passed(0);
+  std::atomic<bool> done(false);
+
+  std::vector<std::unique_ptr<ScopedThread>> threads;
+  for (int i = 0; i < waiters; i++) {
+    threads.push_back(absl::make_unique<ScopedThread>([&] {
+      while (true) {
+        Lock(&mu);
+        const int32_t seq = cond.load(std::memory_order_relaxed);
+        waiting.fetch_add(1, std::memory_order_relaxed);
+        Unlock(&mu);
+        while (cond.load(std::memory_order_acquire) == seq) {
+          FutexWait(&cond, seq);
+        }
+        if (done.load()) {
+          return;
+        }
+        LockContended(&mu);
+        passed.fetch_add(1, std::memory_order_relaxed);
+        Unlock(&mu);
+      }
+    }));
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    while (waiting.load() != waiters) {
+      sched_yield();
+    }
+    waiting.store(0);
+    passed.store(0);
+    state.ResumeTiming();
+
+    Lock(&mu);
+    const int32_t seq = cond.fetch_add(1) + 1;
+    switch (broadcast) {
+      case Broadcast::kWakeAll:
+        FutexWake(&cond, INT_MAX);
+        break;
+      case Broadcast::kCmpRequeue:
+        // Requeued waiters must be woken by Unlock, so mark the mutex
+        // contended.
+        if (FutexCmpRequeue(&cond, 1, INT_MAX, &mu, seq) > 1) {
+          mu.store(2);
+        }
+        break;
+    }
+    Unlock(&mu);
+
+    while (passed.load() != waiters) {
+      sched_yield();
+    }
+  }
+
+  while (waiting.load() != waiters) {
+    sched_yield();
+  }
+  done.store(true);
+  cond.fetch_add(1);
+  FutexWake(&cond, INT_MAX);
+  threads.clear();
+
+  state.SetItemsProcessed(static_cast<int64_t>(waiters) * state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_FutexBroadcast, wake_all, Broadcast::kWakeAll)
+    ->Range(1, 64)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_FutexBroadcast, cmp_requeue, Broadcast::kCmpRequeue)
+    ->Range(1, 64)
+    ->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
@@ -16,8 +16,12 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/file_descriptor.h"
 #include "test/util/fs_util.h"
 #include "test/util/temp_path.h"
@@ -40,9 +44,16 @@ namespace {
 
 constexpr int kBufferSize = 65536;
 
-PosixErrorOr<TempPath> CreateDirectory(int count,
+// ParentDir returns the directory in which benchmarked directories are
+// created. Under runsc, the test temporary directory is backed by the gofer
+// unless the test runs with tmpfs, while /dev/shm is always backed by tmpfs.
+std::string ParentDir(bool shm) {
+  return shm ? "/dev/shm" : GetAbsoluteTestTmpdir();
+}
+
+PosixErrorOr<TempPath> CreateDirectory(const std::string& parent, int count,
                                        std::vector<std::string>* files) {
-  ASSIGN_OR_RETURN_ERRNO(TempPath dir, TempPath::CreateDir());
+  ASSIGN_OR_RETURN_ERRNO(TempPath dir, TempPath::CreateDirIn(parent));
 
   ASSIGN_OR_RETURN_ERRNO(FileDescriptor dfd,
                          Open(dir.path(), O_RDONLY | O_DIRECTORY));
@@ -69,9 +80,10 @@ PosixError CleanupDirectory(const TempPath& dir,
   return NoError();
 }
 
-// Creates a directory containing `files` files, and reads all the directory
-// entries from the directory using a single FD.
-void BM_GetdentsSameFD(benchmark::State& state) {
+// Creates a directory containing `files` files in the test temporary directory
+// or in /dev/shm if shm is true, and reads all the directory entries from the
+// directory using a single FD.
+void BM_GetdentsSameFD(benchmark::State& state, bool shm) {
   // Create directory with given files.
   const int count = state.range(0);
 
@@ -82,7 +94,12 @@ void BM_GetdentsSameFD(benchmark::State& state) {
   // extreme benchmarks.
   TempPath dir;
   std::vector<std::string> files;
-  dir = ASSERT_NO_ERRNO_AND_VALUE(CreateDirectory(count, &files));
+  auto dir_or = CreateDirectory(ParentDir(shm), count, &files);
+  if (!dir_or.ok()) {
+    state.SkipWithError(dir_or.error().ToString().c_str());
+    return;
+  }
+  dir = std::move(dir_or).ValueOrDie();
 
   FileDescriptor fd =
       ASSERT_NO_ERRNO_AND_VALUE(Open(dir.path(), O_RDONLY | O_DIRECTORY));
@@ -90,6 +107,7 @@ void BM_GetdentsSameFD(benchmark::State& state) {
 
   // We read all directory entries on each iteration, but report this as a
   // "batch" iteration so that reported times are per file.
+  ScopedRusageCounters rusage(state);
   while (state.KeepRunningBatch(count)) {
     ASSERT_THAT(lseek(fd.get(), 0, SEEK_SET), SyscallSucceeds());
 
@@ -105,11 +123,16 @@ void BM_GetdentsSameFD(benchmark::State& state) {
   state.SetItemsProcessed(state.iterations());
 }
 
-BENCHMARK(BM_GetdentsSameFD)->Range(1, 1 << 16)->UseRealTime();
+BENCHMARK_CAPTURE(BM_GetdentsSameFD, tmpdir, false)
+    ->Range(1, 1 << 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_GetdentsSameFD, shm, true)
+    ->Range(1, 1 << 16)
+    ->UseRealTime();
 
-// Creates a directory containing `files` files, and reads all the directory
-// entries from the directory using a new FD each time.
-void BM_GetdentsNewFD(benchmark::State& state) {
+// Like BM_GetdentsSameFD, but reads all the directory entries from the
+// directory using a new FD each time.
+void BM_GetdentsNewFD(benchmark::State& state, bool shm) {
   // Create directory with given files.
   const int count = state.range(0);
 
@@ -120,11 +143,17 @@ void BM_GetdentsNewFD(benchmark::State& state) {
   // extreme benchmarks.
   TempPath dir;
   std::vector<std::string> files;
-  dir = ASSERT_NO_ERRNO_AND_VALUE(CreateDirectory(count, &files));
+  auto dir_or = CreateDirectory(ParentDir(shm), count, &files);
+  if (!dir_or.ok()) {
+    state.SkipWithError(dir_or.error().ToString().c_str());
+    return;
+  }
+  dir = std::move(dir_or).ValueOrDie();
   char buffer[kBufferSize];
 
   // We read all directory entries on each iteration, but report this as a
   // "batch" iteration so that reported times are per file.
+  ScopedRusageCounters rusage(state);
   while (state.KeepRunningBatch(count)) {
     FileDescriptor fd =
         ASSERT_NO_ERRNO_AND_VALUE(Open(dir.path(), O_RDONLY | O_DIRECTORY));
@@ -141,7 +170,12 @@ void BM_GetdentsNewFD(benchmark::State& state) {
   state.SetItemsProcessed(state.iterations());
 }
 
-BENCHMARK(BM_GetdentsNewFD)->Range(1, 1 << 12)->UseRealTime();
+BENCHMARK_CAPTURE(BM_GetdentsNewFD, tmpdir, false)
+    ->Range(1, 1 << 12)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_GetdentsNewFD, shm, true)
+    ->Range(1, 1 << 12)
+    ->UseRealTime();
 
 }  // namespace
 
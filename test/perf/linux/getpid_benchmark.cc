@@ -12,11 +12,26 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/audit.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <stdint.h>
+#include <sys/prctl.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/platform_util.h"
+#include "test/util/thread_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -24,6 +39,7 @@ namespace testing {
 namespace {
 
 void BM_Getpid(benchmark::State& state) {
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     syscall(SYS_getpid);
   }
@@ -31,6 +47,118 @@ void BM_Getpid(benchmark::State& state) {
 
 BENCHMARK(BM_Getpid);
 
+#if defined(__x86_64__)
+
+// BM_GetpidInt80 measures getpid(2) through the 32-bit int 0x80 entry path,
+// which 64-bit processes may also use. Compare with BM_Getpid.
+void BM_GetpidInt80(benchmark::State& state) {
+  if (PlatformSupport32Bit() != PlatformSupport::Allowed) {
+    state.SkipWithError("32-bit syscalls are not supported");
+    return;
+  }
+  // getpid is syscall 20 in the i386 table.
+  constexpr int kGetpid32 = 20;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    int ret;
+    asm volatile("int $0x80"
+                 : "=a"(ret)
+                 : "a"(kGetpid32)
+                 : "memory", "r8", "r9", "r10", "r11");
+    benchmark::DoNotOptimize(ret);
+  }
+}
+
+BENCHMARK(BM_GetpidInt80);
+
+#endif  // defined(__x86_64__)
+
+// Whether syscalls are recorded in gVisor's syscall trace buffer.
+enum class Trace {
+  kOff,
+  kOn,
+};
+
+// BM_GetpidTrace measures the overhead of syscall tracing on getpid(2).
+// Syscalls are recorded while /dev/syscall_trace is open.
+void BM_GetpidTrace(benchmark::State& state, Trace trace) {
+  FileDescriptor fd;
+  if (trace == Trace::kOn) {
+    auto fd_or = Open("/dev/syscall_trace", O_RDONLY);
+    if (!fd_or.ok()) {
+      state.SkipWithError("requires gVisor's syscall trace buffer");
+      return;
+    }
+    fd = std::move(fd_or).ValueOrDie();
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    syscall(SYS_getpid);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_GetpidTrace, off, Trace::kOff);
+BENCHMARK_CAPTURE(BM_GetpidTrace, on, Trace::kOn);
+
+// Installs a seccomp-bpf filter of exactly len instructions (len >= 6) in the
+// calling thread. The filter has the shape of a typical allowlist: it checks
+// the architecture, then compares the syscall number against a chain of
+// syscalls that are never made, then allows everything else.
+void ApplyAllowlistFilter(int len) {
+  std::vector<struct sock_filter> filter = {
+      // A = seccomp_data.arch
+      BPF_STMT(BPF_LD | BPF_ABS | BPF_W, 4),
+#if defined(__x86_64__)
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, AUDIT_ARCH_X86_64, 1, 0),
+#elif defined(__aarch64__)
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, AUDIT_ARCH_AARCH64, 1, 0),
+#else
+#error "Unknown architecture"
+#endif
+      BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_KILL),
+      // A = seccomp_data.nr
+      BPF_STMT(BPF_LD | BPF_ABS | BPF_W, 0),
+  };
+  // Pad to an odd number of remaining instructions, then fill all but the
+  // last with comparisons against syscall numbers that do not exist.
+  if ((len - filter.size()) % 2 == 0) {
+    filter.push_back(BPF_STMT(BPF_LD | BPF_ABS | BPF_W, 0));
+  }
+  for (uint32_t nr = 10000; filter.size() < static_cast<size_t>(len) - 1;
+       nr++) {
+    filter.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, nr, 0, 1));
+    filter.push_back(BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | EPERM));
+  }
+  filter.push_back(BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW));
+  TEST_CHECK(filter.size() == static_cast<size_t>(len));
+
+  struct sock_fprog prog;
+  prog.len = filter.size();
+  prog.filter = filter.data();
+  TEST_PCHECK(prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0);
+  TEST_PCHECK(prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog, 0, 0) == 0);
+}
+
+// BM_GetpidSeccomp measures getpid(2) with a seccomp-bpf filter of
+// state.range(0) instructions installed, or none if it is 0.
+void BM_GetpidSeccomp(benchmark::State& state) {
+  // Seccomp filters can't be removed, so install the filter in a thread of
+  // its own (without SECCOMP_FILTER_FLAG_TSYNC) to leave other benchmarks
+  // unaffected.
+  ScopedThread([&] {
+    if (state.range(0) > 0) {
+      ApplyAllowlistFilter(state.range(0));
+    }
+    ScopedRusageCounters rusage(state);
+    for (auto _ : state) {
+      syscall(SYS_getpid);
+    }
+  });
+}
+
+BENCHMARK(BM_GetpidSeccomp)->Arg(0)->Arg(50)->Arg(300);
+
 }  // namespace
 
 }  // namespace testing
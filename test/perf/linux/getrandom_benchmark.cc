@@ -0,0 +1,49 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// BM_Getrandom measures getrandom(2) of state.range(0) bytes, as used to
+// generate keys and nonces. Compare with BM_Getpid for the cost of the
+// syscall itself.
+void BM_Getrandom(benchmark::State& state) {
+  const int size = state.range(0);
+  std::vector<char> buf(size);
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(syscall(SYS_getrandom, buf.data(), size, 0) == size);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_Getrandom)->Range(16, 4096)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
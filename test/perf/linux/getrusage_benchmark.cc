@@ -0,0 +1,101 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of each read(2) of /proc/meminfo.
+constexpr size_t kReadSize = 4096;
+
+// ManyTouchedVMAs creates a mapping of the given number of pages, all of which
+// are faulted in, and each of which is a separate vma since adjacent pages
+// have different protections. Returns an error if the system's limit on vmas
+// is exceeded.
+PosixErrorOr<Mapping> ManyTouchedVMAs(int pages) {
+  ASSIGN_OR_RETURN_ERRNO(Mapping m, MmapAnon(pages * kPageSize,
+                                             PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE));
+  char* const p = reinterpret_cast<char*>(m.ptr());
+  for (int i = 0; i < pages; i++) {
+    p[i * kPageSize] = 1;
+  }
+  for (int i = 0; i < pages; i += 2) {
+    if (mprotect(p + i * kPageSize, kPageSize, PROT_READ) != 0) {
+      return PosixError(errno, "mprotect");
+    }
+  }
+  return std::move(m);
+}
+
+// BM_Getrusage measures getrusage(RUSAGE_SELF), as polled by monitoring
+// agents, while the process has state.range(0) faulted-in mappings.
+void BM_Getrusage(benchmark::State& state) {
+  auto m = ManyTouchedVMAs(state.range(0));
+  if (!m.ok()) {
+    state.SkipWithError("too many mappings");
+    return;
+  }
+
+  struct rusage ru;
+  for (auto _ : state) {
+    TEST_PCHECK(getrusage(RUSAGE_SELF, &ru) == 0);
+  }
+}
+
+BENCHMARK(BM_Getrusage)->Arg(1000)->Arg(100000)->UseRealTime();
+
+// BM_ReadProcMeminfo measures reading /proc/meminfo, as polled by monitoring
+// agents, while the process has state.range(0) faulted-in mappings.
+void BM_ReadProcMeminfo(benchmark::State& state) {
+  auto m = ManyTouchedVMAs(state.range(0));
+  if (!m.ok()) {
+    state.SkipWithError("too many mappings");
+    return;
+  }
+
+  std::vector<char> buf(kReadSize);
+  for (auto _ : state) {
+    const FileDescriptor fd = Open("/proc/meminfo", O_RDONLY).ValueOrDie();
+    int n;
+    while ((n = read(fd.get(), buf.data(), buf.size())) > 0) {
+    }
+    TEST_PCHECK(n == 0);
+  }
+}
+
+BENCHMARK(BM_ReadProcMeminfo)->Arg(1000)->Arg(100000)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
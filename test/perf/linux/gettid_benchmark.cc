@@ -18,6 +18,7 @@
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -25,6 +26,7 @@ namespace testing {
 namespace {
 
 void BM_Gettid(benchmark::State& state) {
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     syscall(SYS_gettid);
   }
@@ -0,0 +1,116 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// ReadEvents reads from the inotify fd until n events have been received.
+void ReadEvents(int fd, int n, std::vector<char>& buf) {
+  while (n > 0) {
+    const ssize_t len = ReadFd(fd, buf.data(), buf.size());
+    TEST_PCHECK(len > 0);
+    for (ssize_t off = 0; off < len;) {
+      const struct inotify_event* ev =
+          reinterpret_cast<const struct inotify_event*>(buf.data() + off);
+      off += sizeof(*ev) + ev->len;
+      n--;
+    }
+  }
+}
+
+// BM_InotifyWatchers measures the time from modifying files to reading the
+// resulting events with state.range(0) directories watched, as by file sync
+// daemons and build watchers. Each iteration modifies state.range(1) files in
+// distinct watched directories and reads the events back. With a batch of one,
+// the time per item is the event latency. With a single watch, the events of
+// a batch are coalesced into one.
+void BM_InotifyWatchers(benchmark::State& state) {
+  const int watches = state.range(0);
+  const int batch = state.range(1);
+
+  const TempPath root = TempPath::CreateDir().ValueOrDie();
+  std::vector<TempPath> dirs;
+  std::vector<FileDescriptor> files;
+  for (int i = 0; i < watches; i++) {
+    dirs.emplace_back(TempPath::CreateDirIn(root.path()).ValueOrDie());
+    files.emplace_back(Open(JoinPath(dirs.back().path(), "file"),
+                            O_CREAT | O_WRONLY, 0644)
+                           .ValueOrDie());
+  }
+
+  const int fd = inotify_init1(IN_CLOEXEC);
+  TEST_PCHECK(fd >= 0);
+  for (const TempPath& dir : dirs) {
+    if (inotify_add_watch(fd, dir.path().c_str(), IN_MODIFY) < 0) {
+      // Linux limits watches with fs.inotify.max_user_watches.
+      state.SkipWithError(
+          absl::StrCat("inotify_add_watch failed: ", strerror(errno)).c_str());
+      close(fd);
+      return;
+    }
+  }
+
+  std::vector<char> buf(batch * (sizeof(struct inotify_event) + NAME_MAX + 1));
+  char c = 'a';
+  int next = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (int i = 0; i < batch; i++) {
+      TEST_PCHECK(pwrite(files[next].get(), &c, 1, 0) == 1);
+      next = (next + 1) % watches;
+    }
+    ReadEvents(fd, std::min(batch, watches), buf);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(batch) * state.iterations());
+
+  close(fd);
+}
+
+void WatcherArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"watches", "batch"});
+  for (int watches : {1, 64, 4096}) {
+    for (int batch : {1, 64}) {
+      benchmark->Args({watches, batch});
+    }
+  }
+}
+
+BENCHMARK(BM_InotifyWatchers)->Apply(&WatcherArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,375 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+#ifndef SYS_io_uring_setup
+#define SYS_io_uring_setup 425
+#define SYS_io_uring_enter 426
+#define SYS_io_uring_register 427
+#endif
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// These benchmarks read the same files as BM_Read and BM_RandRead, but submit
+// a batch of reads with a single io_uring_enter(2) per iteration. They are
+// compared against BM_IOUringBaseline, which issues the same batch as
+// individual preads.
+
+// The file read at random positions, as in BM_RandRead.
+const uint64_t kFileSize = 1ULL << 30;
+
+// How many bytes to write at once to initialize the file used to read from.
+const uint32_t kWriteSize = 65536;
+
+// Largest benchmarked read unit.
+const uint32_t kMaxRead = 1UL << 16;
+
+// Largest benchmarked submission queue depth.
+const uint32_t kMaxDepth = 256;
+
+TempPath CreateFile(uint64_t file_size) {
+  auto path = TempPath::CreateFile().ValueOrDie();
+  FileDescriptor fd = Open(path.path(), O_WRONLY).ValueOrDie();
+
+  // Try to minimize syscalls by using maximum size writev() requests.
+  std::vector<char> buffer(kWriteSize);
+  RandomizeBuffer(buffer.data(), buffer.size());
+  const std::vector<std::vector<struct iovec>> iovecs_list =
+      GenerateIovecs(file_size, buffer.data(), buffer.size());
+  for (const auto& iovecs : iovecs_list) {
+    TEST_CHECK(writev(fd.get(), iovecs.data(), iovecs.size()) >= 0);
+  }
+
+  return path;
+}
+
+// Global test state, initialized once per process lifetime.
+struct GlobalState {
+  // Read at random offsets, as in BM_RandRead.
+  const TempPath random_file;
+
+  // Read at offset 0, as in BM_Read.
+  const TempPath small_file;
+
+  GlobalState(TempPath random, TempPath small)
+      : random_file(std::move(random)), small_file(std::move(small)) {}
+};
+
+GlobalState& GetGlobalState() {
+  // This gets created only once throughout the lifetime of the process.
+  // Use a dynamically allocated object (that is never deleted) to avoid order
+  // of destruction of static storage variables issues.
+  static GlobalState* const state = new GlobalState(
+      CreateFile(kFileSize + kMaxRead), CreateFile(kMaxRead));
+  return *state;
+}
+
+// IOUring is a minimal io_uring instance, set up with the raw system calls so
+// that the benchmarks do not depend on liburing.
+class IOUring {
+ public:
+  // Create returns a new IOUring with at least entries submission queue
+  // entries.
+  static PosixErrorOr<std::unique_ptr<IOUring>> Create(unsigned entries) {
+    struct io_uring_params params = {};
+    int fd = syscall(SYS_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      return PosixError(errno, "io_uring_setup");
+    }
+    auto ring = absl::WrapUnique(new IOUring(FileDescriptor(fd)));
+
+    // Map each region separately, which works whether or not the kernel
+    // supports IORING_FEAT_SINGLE_MMAP.
+    ASSIGN_OR_RETURN_ERRNO(
+        ring->sq_mapping_,
+        Mmap(nullptr, params.sq_off.array + params.sq_entries * sizeof(__u32),
+             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+             IORING_OFF_SQ_RING));
+    ASSIGN_OR_RETURN_ERRNO(
+        ring->cq_mapping_,
+        Mmap(nullptr,
+             params.cq_off.cqes +
+                 params.cq_entries * sizeof(struct io_uring_cqe),
+             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+             IORING_OFF_CQ_RING));
+    ASSIGN_OR_RETURN_ERRNO(
+        ring->sqes_mapping_,
+        Mmap(nullptr, params.sq_entries * sizeof(struct io_uring_sqe),
+             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+             IORING_OFF_SQES));
+
+    char* sq = static_cast<char*>(ring->sq_mapping_.ptr());
+    ring->sq_tail_ = reinterpret_cast<__u32*>(sq + params.sq_off.tail);
+    ring->sq_mask_ = *reinterpret_cast<__u32*>(sq + params.sq_off.ring_mask);
+    ring->sq_array_ = reinterpret_cast<__u32*>(sq + params.sq_off.array);
+    ring->sqes_ =
+        static_cast<struct io_uring_sqe*>(ring->sqes_mapping_.ptr());
+
+    char* cq = static_cast<char*>(ring->cq_mapping_.ptr());
+    ring->cq_head_ = reinterpret_cast<__u32*>(cq + params.cq_off.head);
+    ring->cq_tail_ = reinterpret_cast<__u32*>(cq + params.cq_off.tail);
+    ring->cq_mask_ = *reinterpret_cast<__u32*>(cq + params.cq_off.ring_mask);
+    ring->cqes_ =
+        reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    return std::move(ring);
+  }
+
+  // RegisterBuffers registers iovecs for use by IORING_OP_READ_FIXED.
+  PosixError RegisterBuffers(const std::vector<struct iovec>& iovecs) {
+    return Register(IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size());
+  }
+
+  // RegisterFile registers fd as fixed file 0.
+  PosixError RegisterFile(int fd) {
+    return Register(IORING_REGISTER_FILES, &fd, 1);
+  }
+
+  // NextSQE returns the next free submission queue entry, zeroed. The entry is
+  // submitted by the next call to SubmitAndWait.
+  struct io_uring_sqe* NextSQE() {
+    __u32 index = pending_tail_++ & sq_mask_;
+    sq_array_[index] = index;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+  }
+
+  // SubmitAndWait submits all entries returned by NextSQE and waits for them
+  // to complete. It returns false if any of them did not return want.
+  bool SubmitAndWait(__s32 want) {
+    unsigned count = pending_tail_ - submitted_tail_;
+    __atomic_store_n(sq_tail_, pending_tail_, __ATOMIC_RELEASE);
+    submitted_tail_ = pending_tail_;
+    if (syscall(SYS_io_uring_enter, fd_.get(), count, count,
+                IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+      return false;
+    }
+
+    bool ok = true;
+    __u32 head = *cq_head_;
+    for (unsigned i = 0; i < count; i++) {
+      TEST_CHECK(head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE));
+      if (cqes_[head & cq_mask_].res != want) {
+        ok = false;
+      }
+      head++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return ok;
+  }
+
+ private:
+  explicit IOUring(FileDescriptor fd) : fd_(std::move(fd)) {}
+
+  PosixError Register(unsigned opcode, const void* arg, unsigned nr_args) {
+    if (syscall(SYS_io_uring_register, fd_.get(), opcode, arg, nr_args) < 0) {
+      return PosixError(errno, "io_uring_register");
+    }
+    return NoError();
+  }
+
+  FileDescriptor fd_;
+
+  Mapping sq_mapping_;
+  Mapping cq_mapping_;
+  Mapping sqes_mapping_;
+
+  __u32* sq_tail_ = nullptr;
+  __u32 sq_mask_ = 0;
+  __u32* sq_array_ = nullptr;
+  struct io_uring_sqe* sqes_ = nullptr;
+
+  __u32* cq_head_ = nullptr;
+  __u32* cq_tail_ = nullptr;
+  __u32 cq_mask_ = 0;
+  struct io_uring_cqe* cqes_ = nullptr;
+
+  // pending_tail_ is the tail of the submission queue including entries
+  // returned by NextSQE, and submitted_tail_ is the tail known to the kernel.
+  __u32 pending_tail_ = 0;
+  __u32 submitted_tail_ = 0;
+};
+
+// Modes of BM_IOUring.
+enum class Mode {
+  // IORING_OP_READV into unregistered buffers.
+  kRead,
+
+  // IORING_OP_READ_FIXED into buffers registered with
+  // IORING_REGISTER_BUFFERS.
+  kFixedBuffers,
+
+  // IORING_OP_READV on a file registered with IORING_REGISTER_FILES.
+  kFixedFiles,
+};
+
+// BM_IOUring reads state.range(1) (the queue depth) blocks of state.range(0)
+// bytes per iteration, at random offsets if state.range(2) is set and at
+// offset 0 otherwise.
+void BM_IOUring(benchmark::State& state, Mode mode) {
+  const int size = state.range(0);
+  const int depth = state.range(1);
+  const bool random = state.range(2);
+
+  GlobalState& global_state = GetGlobalState();
+  const TempPath& file =
+      random ? global_state.random_file : global_state.small_file;
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+
+  auto ring_or = IOUring::Create(depth);
+  if (!ring_or.ok()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  std::unique_ptr<IOUring> ring = std::move(ring_or).ValueOrDie();
+
+  std::vector<char> buf(static_cast<size_t>(size) * depth);
+  std::vector<struct iovec> iovecs(depth);
+  for (int i = 0; i < depth; i++) {
+    iovecs[i].iov_base = &buf[static_cast<size_t>(i) * size];
+    iovecs[i].iov_len = size;
+  }
+
+  switch (mode) {
+    case Mode::kRead:
+      break;
+    case Mode::kFixedBuffers:
+      ASSERT_NO_ERRNO(ring->RegisterBuffers(iovecs));
+      break;
+    case Mode::kFixedFiles:
+      ASSERT_NO_ERRNO(ring->RegisterFile(fd.get()));
+      break;
+  }
+
+  unsigned int seed = 1;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (int i = 0; i < depth; i++) {
+      struct io_uring_sqe* sqe = ring->NextSQE();
+      sqe->fd = fd.get();
+      sqe->off = random ? rand_r(&seed) % kFileSize : 0;
+      switch (mode) {
+        case Mode::kRead:
+          sqe->opcode = IORING_OP_READV;
+          sqe->addr = reinterpret_cast<__u64>(&iovecs[i]);
+          sqe->len = 1;
+          break;
+        case Mode::kFixedBuffers:
+          sqe->opcode = IORING_OP_READ_FIXED;
+          sqe->addr = reinterpret_cast<__u64>(iovecs[i].iov_base);
+          sqe->len = size;
+          sqe->buf_index = i;
+          break;
+        case Mode::kFixedFiles:
+          sqe->opcode = IORING_OP_READV;
+          sqe->flags = IOSQE_FIXED_FILE;
+          sqe->fd = 0;
+          sqe->addr = reinterpret_cast<__u64>(&iovecs[i]);
+          sqe->len = 1;
+          break;
+      }
+    }
+    TEST_CHECK(ring->SubmitAndWait(size));
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(depth) *
+                          static_cast<int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<int64_t>(size) * depth *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+// BM_IOUringBaseline reads the same blocks as BM_IOUring with one pread per
+// block.
+void BM_IOUringBaseline(benchmark::State& state) {
+  const int size = state.range(0);
+  const int depth = state.range(1);
+  const bool random = state.range(2);
+
+  GlobalState& global_state = GetGlobalState();
+  const TempPath& file =
+      random ? global_state.random_file : global_state.small_file;
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+  std::vector<char> buf(static_cast<size_t>(size) * depth);
+
+  unsigned int seed = 1;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (int i = 0; i < depth; i++) {
+      TEST_CHECK(PreadFd(fd.get(), &buf[static_cast<size_t>(i) * size], size,
+                         random ? rand_r(&seed) % kFileSize : 0) == size);
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(depth) *
+                          static_cast<int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<int64_t>(size) * depth *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+void IOUringArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"size", "depth", "random"});
+  for (int random = 0; random <= 1; random++) {
+    for (int size = 1 << 12; size <= static_cast<int>(kMaxRead); size <<= 4) {
+      for (int depth = 1; depth <= static_cast<int>(kMaxDepth); depth <<= 2) {
+        bench->Args({size, depth, random});
+      }
+    }
+  }
+}
+
+BENCHMARK_CAPTURE(BM_IOUring, read, Mode::kRead)
+    ->Apply(IOUringArgs)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_IOUring, fixed_buffers, Mode::kFixedBuffers)
+    ->Apply(IOUringArgs)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_IOUring, fixed_files, Mode::kFixedFiles)
+    ->Apply(IOUringArgs)
+    ->UseRealTime();
+
+BENCHMARK(BM_IOUringBaseline)->Apply(IOUringArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
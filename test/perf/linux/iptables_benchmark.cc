@@ -0,0 +1,164 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Netfilter headers require some headers to preceed them.
+// clang-format off
+#include <netinet/in.h>
+#include <stddef.h>
+// clang-format on
+
+#include <linux/capability.h>
+#include <linux/netfilter/x_tables.h>
+#include <linux/netfilter_ipv4.h>
+#include <linux/netfilter_ipv4/ip_tables.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/ip_socket_test_util.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/capability_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr char kFilterTable[] = "filter";
+
+// Size of a rule with a standard target, which accepts the packet.
+constexpr size_t kStandardEntrySize =
+    sizeof(struct ipt_entry) + sizeof(struct xt_standard_target);
+
+// Size of the rule with the error target that ends every table.
+constexpr size_t kErrorEntrySize =
+    sizeof(struct ipt_entry) + sizeof(struct xt_error_target);
+
+// AddAcceptEntry writes a rule accepting packets to dst, or any packet if dst
+// is INADDR_ANY, at *offset in entries and advances *offset past it.
+void AddAcceptEntry(char* entries, size_t* offset, in_addr_t dst) {
+  struct ipt_entry* entry =
+      reinterpret_cast<struct ipt_entry*>(entries + *offset);
+  entry->target_offset = sizeof(*entry);
+  entry->next_offset = kStandardEntrySize;
+  if (dst != INADDR_ANY) {
+    entry->ip.dst.s_addr = dst;
+    entry->ip.dmsk.s_addr = htonl(0xffffffff);
+  }
+  struct xt_standard_target* target =
+      reinterpret_cast<struct xt_standard_target*>(entry->elems);
+  target->target.u.user.target_size = sizeof(*target);
+  target->verdict = -NF_ACCEPT - 1;
+  *offset += kStandardEntrySize;
+}
+
+// ReplaceFilterTable replaces the filter table with one that accepts all
+// packets, but whose OUTPUT chain first walks n rules that each accept
+// packets to a single 10.0.0.0/8 address. Such rules never match loopback
+// traffic, like the per-service rules of unrelated services.
+PosixError ReplaceFilterTable(int n) {
+  const size_t entries_size = (3 + n) * kStandardEntrySize + kErrorEntrySize;
+  std::vector<char> buf(sizeof(struct ipt_replace) + entries_size);
+  struct ipt_replace* replace =
+      reinterpret_cast<struct ipt_replace*>(buf.data());
+  strncpy(replace->name, kFilterTable, sizeof(replace->name));
+  replace->valid_hooks = (1 << NF_IP_LOCAL_IN) | (1 << NF_IP_FORWARD) |
+                         (1 << NF_IP_LOCAL_OUT);
+  replace->num_entries = 4 + n;
+  replace->size = entries_size;
+  std::vector<struct xt_counters> counters(replace->num_entries);
+  replace->num_counters = replace->num_entries;
+  replace->counters = counters.data();
+
+  char* entries = reinterpret_cast<char*>(replace->entries);
+  size_t offset = 0;
+  replace->hook_entry[NF_IP_LOCAL_IN] = offset;
+  replace->underflow[NF_IP_LOCAL_IN] = offset;
+  AddAcceptEntry(entries, &offset, INADDR_ANY);
+  replace->hook_entry[NF_IP_FORWARD] = offset;
+  replace->underflow[NF_IP_FORWARD] = offset;
+  AddAcceptEntry(entries, &offset, INADDR_ANY);
+  replace->hook_entry[NF_IP_LOCAL_OUT] = offset;
+  for (int i = 0; i < n; i++) {
+    AddAcceptEntry(entries, &offset, htonl(0x0a000000 | i));
+  }
+  replace->underflow[NF_IP_LOCAL_OUT] = offset;
+  AddAcceptEntry(entries, &offset, INADDR_ANY);
+
+  struct ipt_entry* error =
+      reinterpret_cast<struct ipt_entry*>(entries + offset);
+  error->target_offset = sizeof(*error);
+  error->next_offset = kErrorEntrySize;
+  struct xt_error_target* target =
+      reinterpret_cast<struct xt_error_target*>(error->elems);
+  target->target.u.user.target_size = sizeof(*target);
+  strncpy(target->target.u.user.name, XT_ERROR_TARGET,
+          sizeof(target->target.u.user.name));
+  strncpy(target->errorname, XT_ERROR_TARGET, sizeof(target->errorname));
+
+  ASSIGN_OR_RETURN_ERRNO(FileDescriptor fd,
+                         Socket(AF_INET, SOCK_RAW, IPPROTO_ICMP));
+  RETURN_ERROR_IF_SYSCALL_FAIL(setsockopt(fd.get(), SOL_IP, IPT_SO_SET_REPLACE,
+                                          buf.data(), buf.size()));
+  return NoError();
+}
+
+// BM_IPTablesOutputRules measures the round trip time of a 1-byte message
+// over a loopback TCP connection while the OUTPUT chain holds state.range(0)
+// non-matching single destination rules, as installed by kube-proxy for each
+// service.
+void BM_IPTablesOutputRules(benchmark::State& state) {
+  if (!HaveCapability(CAP_NET_ADMIN).ValueOrDie() ||
+      !HaveCapability(CAP_NET_RAW).ValueOrDie()) {
+    state.SkipWithError("CAP_NET_ADMIN and CAP_NET_RAW required");
+    return;
+  }
+  const int n = state.range(0);
+  TEST_CHECK(ReplaceFilterTable(n).ok());
+
+  auto sockets = IPv4TCPAcceptBindSocketPair(0).Create().ValueOrDie();
+  char c = 'a';
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(write(sockets->first_fd(), &c, 1) == 1);
+    TEST_PCHECK(read(sockets->second_fd(), &c, 1) == 1);
+    TEST_PCHECK(write(sockets->second_fd(), &c, 1) == 1);
+    TEST_PCHECK(read(sockets->first_fd(), &c, 1) == 1);
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  TEST_CHECK(ReplaceFilterTable(0).ok());
+}
+
+BENCHMARK(BM_IPTablesOutputRules)
+    ->ArgName("rules")
+    ->Arg(0)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -12,16 +12,39 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
+#include <linux/memfd.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
 #include <stdlib.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/ipc.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <random>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/cleanup.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
 #include "test/util/logging.h"
 #include "test/util/memory_util.h"
 #include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
 #include "test/util/test_util.h"
+#include "test/util/thread_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -34,46 +57,293 @@ namespace {
 // include/linux/mm.h:DEFAULT_MAX_MAP_COUNT = 65530.
 constexpr size_t kMaxVMAs = 64001;
 
+// Kinds of mappings for the benchmarks parameterized by MapMode.
+enum class MapMode {
+  // MAP_PRIVATE | MAP_ANONYMOUS.
+  kAnon,
+
+  // MAP_PRIVATE | MAP_ANONYMOUS with MADV_HUGEPAGE.
+  kHugePage,
+
+  // MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE.
+  kPopulate,
+
+  // MAP_SHARED of a regular file.
+  kFileShared,
+
+  // MAP_SHARED of a memfd, as shared between processes by in-memory
+  // databases.
+  kMemfd,
+
+  // MAP_SHARED of a memfd created with MFD_HUGETLB.
+  kMemfdHugeTLB,
+
+  // A SysV shared memory segment created with SHM_HUGETLB, attached with
+  // shmat(2).
+  kShmHugeTLB,
+};
+
+// Huge page size for the HugeTLB modes.
+constexpr size_t kHugePageSize = 2 << 20;
+
+// MapLength returns the length of a mapping of len bytes with mode, which is
+// rounded up to huge pages for the HugeTLB modes.
+size_t MapLength(MapMode mode, size_t len) {
+  if (mode == MapMode::kMemfdHugeTLB || mode == MapMode::kShmHugeTLB) {
+    return (len + kHugePageSize - 1) & ~(kHugePageSize - 1);
+  }
+  return len;
+}
+
+// MapFile is the file or shared memory segment backing kFileShared, memfd and
+// shm mappings. It is empty for other modes.
+struct MapFile {
+  TempPath path;
+  FileDescriptor fd;
+  int shm_id = -1;
+  Cleanup shm_cleanup;
+};
+
+// NewMapFile returns the file to map with mode, sized to hold len bytes. It
+// fails if the HugeTLB modes are not supported, as on hosts without reserved
+// huge pages.
+PosixErrorOr<MapFile> NewMapFile(MapMode mode, size_t len) {
+  MapFile file;
+  switch (mode) {
+    case MapMode::kFileShared: {
+      ASSIGN_OR_RETURN_ERRNO(file.path, TempPath::CreateFile());
+      ASSIGN_OR_RETURN_ERRNO(file.fd, Open(file.path.path(), O_RDWR));
+      break;
+    }
+    case MapMode::kMemfd:
+    case MapMode::kMemfdHugeTLB: {
+      const int fd =
+          syscall(__NR_memfd_create, "mapping_benchmark",
+                  mode == MapMode::kMemfdHugeTLB ? MFD_HUGETLB : 0);
+      if (fd < 0) {
+        return PosixError(errno, "memfd_create");
+      }
+      file.fd = FileDescriptor(fd);
+      break;
+    }
+    case MapMode::kShmHugeTLB: {
+      const int id = shmget(IPC_PRIVATE, MapLength(mode, len),
+                            IPC_CREAT | SHM_HUGETLB | 0600);
+      if (id < 0) {
+        return PosixError(errno, "shmget");
+      }
+      file.shm_id = id;
+      file.shm_cleanup = Cleanup([id] { shmctl(id, IPC_RMID, nullptr); });
+      break;
+    }
+    default:
+      break;
+  }
+  if (file.fd.get() >= 0) {
+    RETURN_ERROR_IF_SYSCALL_FAIL(
+        ftruncate(file.fd.get(), MapLength(mode, len)));
+  }
+  return file;
+}
+
+// MapPages maps len bytes as described by mode.
+void* MapPages(MapMode mode, size_t len, const MapFile& file) {
+  if (mode == MapMode::kShmHugeTLB) {
+    void* addr = shmat(file.shm_id, nullptr, 0);
+    TEST_CHECK_MSG(addr != reinterpret_cast<void*>(-1), "shmat failed");
+    return addr;
+  }
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  int fd = -1;
+  switch (mode) {
+    case MapMode::kAnon:
+    case MapMode::kHugePage:
+    case MapMode::kShmHugeTLB:
+      break;
+    case MapMode::kPopulate:
+      flags |= MAP_POPULATE;
+      break;
+    case MapMode::kFileShared:
+    case MapMode::kMemfd:
+    case MapMode::kMemfdHugeTLB:
+      flags = MAP_SHARED;
+      fd = file.fd.get();
+      break;
+  }
+  void* addr =
+      mmap(0, MapLength(mode, len), PROT_READ | PROT_WRITE, flags, fd, 0);
+  TEST_CHECK_MSG(addr != MAP_FAILED, "mmap failed");
+  if (mode == MapMode::kHugePage) {
+    // Best effort: this fails if transparent huge pages are not configured,
+    // in which case the mapping behaves like kAnon.
+    madvise(addr, len, MADV_HUGEPAGE);
+  }
+  return addr;
+}
+
+// UnmapPages unmaps the len bytes at addr mapped by MapPages.
+void UnmapPages(MapMode mode, void* addr, size_t len) {
+  if (mode == MapMode::kShmHugeTLB) {
+    TEST_CHECK_MSG(shmdt(addr) == 0, "shmdt failed");
+    return;
+  }
+  TEST_CHECK_MSG(munmap(addr, MapLength(mode, len)) == 0, "munmap failed");
+}
+
+// TouchPages writes to each page in [addr, addr+len).
+void TouchPages(void* addr, size_t len) {
+  char* c = reinterpret_cast<char*>(addr);
+  char* end = c + len;
+  while (c < end) {
+    *c = 42;
+    c += kPageSize;
+  }
+}
+
+// PageFaults returns the number of page faults taken by this process. gVisor
+// does not currently report page faults in getrusage(2), so this is always 0
+// in the sandbox.
+int64_t PageFaults() {
+  struct rusage ru;
+  TEST_PCHECK(getrusage(RUSAGE_SELF, &ru) == 0);
+  return ru.ru_minflt + ru.ru_majflt;
+}
+
 // Map then unmap pages without touching them.
-void BM_MapUnmap(benchmark::State& state) {
+void BM_MapUnmap(benchmark::State& state, MapMode mode) {
   // Number of pages to map.
   const int pages = state.range(0);
+  auto file_or = NewMapFile(mode, pages * kPageSize);
+  if (!file_or.ok()) {
+    state.SkipWithError(file_or.error().ToString().c_str());
+    return;
+  }
+  const MapFile file = std::move(file_or).ValueOrDie();
 
+  ScopedRusageCounters rusage(state);
   while (state.KeepRunning()) {
-    void* addr = mmap(0, pages * kPageSize, PROT_READ | PROT_WRITE,
-                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    TEST_CHECK_MSG(addr != MAP_FAILED, "mmap failed");
+    void* addr = MapPages(mode, pages * kPageSize, file);
 
-    int ret = munmap(addr, pages * kPageSize);
-    TEST_CHECK_MSG(ret == 0, "munmap failed");
+    UnmapPages(mode, addr, pages * kPageSize);
   }
 }
 
-BENCHMARK(BM_MapUnmap)->Range(1, 1 << 17)->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapUnmap, anon, MapMode::kAnon)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapUnmap, hugepage, MapMode::kHugePage)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapUnmap, populate, MapMode::kPopulate)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapUnmap, file_shared, MapMode::kFileShared)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
 
 // Map, touch, then unmap pages.
-void BM_MapTouchUnmap(benchmark::State& state) {
+void BM_MapTouchUnmap(benchmark::State& state, MapMode mode) {
   // Number of pages to map.
   const int pages = state.range(0);
+  auto file_or = NewMapFile(mode, pages * kPageSize);
+  if (!file_or.ok()) {
+    state.SkipWithError(file_or.error().ToString().c_str());
+    return;
+  }
+  const MapFile file = std::move(file_or).ValueOrDie();
 
+  const int64_t faults = PageFaults();
+  ScopedRusageCounters rusage(state);
   while (state.KeepRunning()) {
-    void* addr = mmap(0, pages * kPageSize, PROT_READ | PROT_WRITE,
-                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    TEST_CHECK_MSG(addr != MAP_FAILED, "mmap failed");
+    void* addr = MapPages(mode, pages * kPageSize, file);
 
-    char* c = reinterpret_cast<char*>(addr);
-    char* end = c + pages * kPageSize;
-    while (c < end) {
-      *c = 42;
-      c += kPageSize;
-    }
+    TouchPages(addr, pages * kPageSize);
+
+    UnmapPages(mode, addr, pages * kPageSize);
+  }
+
+  state.SetBytesProcessed(kPageSize * pages * state.iterations());
+  state.counters["faults"] = benchmark::Counter(
+      PageFaults() - faults, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_CAPTURE(BM_MapTouchUnmap, anon, MapMode::kAnon)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapTouchUnmap, hugepage, MapMode::kHugePage)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapTouchUnmap, populate, MapMode::kPopulate)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapTouchUnmap, file_shared, MapMode::kFileShared)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapTouchUnmap, memfd, MapMode::kMemfd)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapTouchUnmap, memfd_hugetlb, MapMode::kMemfdHugeTLB)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapTouchUnmap, shm_hugetlb, MapMode::kShmHugeTLB)
+    ->Range(1, 1 << 17)
+    ->UseRealTime();
+
+// Measures only the first touch of each page of a fresh mapping, excluding
+// mmap and munmap, for regions of up to 4GB. For kPopulate this measures
+// touching already populated pages. For modes backed by a file or shared
+// memory segment, only the first iteration allocates its pages; later ones
+// measure faults on pages that are already allocated, as when another process
+// maps them.
+void BM_FirstTouch(benchmark::State& state, MapMode mode) {
+  const size_t len = static_cast<size_t>(state.range(0)) << 20;
+  auto file_or = NewMapFile(mode, len);
+  if (!file_or.ok()) {
+    state.SkipWithError(file_or.error().ToString().c_str());
+    return;
+  }
+  const MapFile file = std::move(file_or).ValueOrDie();
+
+  int64_t faults = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    void* addr = MapPages(mode, len, file);
+
+    const int64_t start_faults = PageFaults();
+    auto start = std::chrono::steady_clock::now();
+    TouchPages(addr, len);
+    auto end = std::chrono::steady_clock::now();
+    faults += PageFaults() - start_faults;
+    state.SetIterationTime(
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count());
 
-    int ret = munmap(addr, pages * kPageSize);
-    TEST_CHECK_MSG(ret == 0, "munmap failed");
+    UnmapPages(mode, addr, len);
   }
+
+  state.SetBytesProcessed(len * state.iterations());
+  state.counters["faults"] =
+      benchmark::Counter(faults, benchmark::Counter::kIsRate);
+}
+
+// Region size in MB.
+void FirstTouchArgs(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(8)->Range(8, 4 << 10)->UseManualTime();
 }
 
-BENCHMARK(BM_MapTouchUnmap)->Range(1, 1 << 17)->UseRealTime();
+BENCHMARK_CAPTURE(BM_FirstTouch, anon, MapMode::kAnon)->Apply(FirstTouchArgs);
+BENCHMARK_CAPTURE(BM_FirstTouch, hugepage, MapMode::kHugePage)
+    ->Apply(FirstTouchArgs);
+BENCHMARK_CAPTURE(BM_FirstTouch, populate, MapMode::kPopulate)
+    ->Apply(FirstTouchArgs);
+BENCHMARK_CAPTURE(BM_FirstTouch, file_shared, MapMode::kFileShared)
+    ->Apply(FirstTouchArgs);
+BENCHMARK_CAPTURE(BM_FirstTouch, memfd, MapMode::kMemfd)
+    ->Apply(FirstTouchArgs);
+BENCHMARK_CAPTURE(BM_FirstTouch, memfd_hugetlb, MapMode::kMemfdHugeTLB)
+    ->Apply(FirstTouchArgs);
+BENCHMARK_CAPTURE(BM_FirstTouch, shm_hugetlb, MapMode::kShmHugeTLB)
+    ->Apply(FirstTouchArgs);
 
 // Map and touch many pages, unmapping all at once.
 //
@@ -83,6 +353,7 @@ void BM_MapTouchMany(benchmark::State& state) {
   // Number of pages to map.
   const int page_count = state.range(0);
 
+  ScopedRusageCounters rusage(state);
   while (state.KeepRunning()) {
     std::vector<void*> pages;
 
@@ -108,6 +379,61 @@ void BM_MapTouchMany(benchmark::State& state) {
 
 BENCHMARK(BM_MapTouchMany)->Range(1, 1 << 12)->UseRealTime();
 
+// Ways in which BM_TeardownMany changes its mapping.
+enum class TeardownOp {
+  // Unmap the whole mapping.
+  kMunmap,
+
+  // Remove write permission from the whole mapping.
+  kMprotect,
+};
+
+// BM_TeardownMany measures a single munmap(2) or mprotect(2) of a touched
+// mapping split into state.range(0) vmas, excluding setup, as when a heap with
+// many vmas is torn down.
+void BM_TeardownMany(benchmark::State& state, TeardownOp op) {
+  const int vmas = state.range(0);
+  const size_t len = vmas * kPageSize;
+
+  for (auto _ : state) {
+    void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    TEST_CHECK_MSG(addr != MAP_FAILED, "mmap failed");
+    char* c = reinterpret_cast<char*>(addr);
+    for (int i = 0; i < vmas; i++) {
+      c[i * kPageSize] = 42;
+      // Alternate protections so that no two adjacent pages share a vma.
+      if (i % 2) {
+        TEST_PCHECK(mprotect(c + i * kPageSize, kPageSize, PROT_READ) == 0);
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (op == TeardownOp::kMunmap) {
+      TEST_PCHECK(munmap(addr, len) == 0);
+    } else {
+      TEST_PCHECK(mprotect(addr, len, PROT_READ) == 0);
+    }
+    auto end = std::chrono::steady_clock::now();
+    state.SetIterationTime(
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count());
+
+    if (op == TeardownOp::kMprotect) {
+      TEST_PCHECK(munmap(addr, len) == 0);
+    }
+  }
+
+  state.SetBytesProcessed(len * state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_TeardownMany, munmap, TeardownOp::kMunmap)
+    ->Range(1, 1 << 12)
+    ->UseManualTime();
+BENCHMARK_CAPTURE(BM_TeardownMany, mprotect, TeardownOp::kMprotect)
+    ->Range(1, 1 << 12)
+    ->UseManualTime();
+
 void BM_PageFault(benchmark::State& state) {
   // Map the region in which we will take page faults. To ensure that each page
   // fault maps only a single page, each page we touch must correspond to a
@@ -138,6 +464,7 @@ void BM_PageFault(benchmark::State& state) {
   // "Start" at the end of the mapped region to force the mapped region to be
   // reset, since we mapped it with MAP_POPULATE.
   size_t cur_page = mapped_pages;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     if (cur_page >= mapped_pages) {
       // We've reached the end of our mapped region and have to reset it to
@@ -157,6 +484,389 @@ void BM_PageFault(benchmark::State& state) {
 
 BENCHMARK(BM_PageFault)->UseRealTime();
 
+// Ways in which BM_UserfaultRoundTrip's handler provides missing pages.
+enum class UserfaultResolve {
+  // UFFDIO_COPY from a buffer, as when serving pages of a snapshot.
+  kCopy,
+
+  // UFFDIO_ZEROPAGE.
+  kZeropage,
+};
+
+// Number of pages in the BM_UserfaultRoundTrip mapping.
+constexpr size_t kUserfaultPages = 4096;
+
+// BM_UserfaultRoundTrip measures the latency of page faults on memory
+// registered with userfaultfd(2), as for BM_PageFault. Each fault is reported
+// to a handler thread, which reads it and provides the missing page as given by
+// resolve, waking the faulting thread.
+void BM_UserfaultRoundTrip(benchmark::State& state, UserfaultResolve resolve) {
+  const int fd = syscall(__NR_userfaultfd, O_CLOEXEC);
+  if (fd < 0) {
+    state.SkipWithError("userfaultfd unavailable");
+    return;
+  }
+  const FileDescriptor uffd(fd);
+  struct uffdio_api api = {};
+  api.api = UFFD_API;
+  TEST_PCHECK(ioctl(uffd.get(), UFFDIO_API, &api) == 0);
+
+  Mapping m = MmapAnon(kUserfaultPages * kPageSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE)
+                  .ValueOrDie();
+  struct uffdio_register reg = {};
+  reg.range.start = m.addr();
+  reg.range.len = m.len();
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  TEST_PCHECK(ioctl(uffd.get(), UFFDIO_REGISTER, &reg) == 0);
+
+  const FileDescriptor stop(eventfd(0, EFD_CLOEXEC));
+  TEST_PCHECK(stop.get() >= 0);
+  const std::vector<char> src(kPageSize, 1);
+  ScopedThread handler([&] {
+    struct pollfd pfds[2] = {{uffd.get(), POLLIN, 0}, {stop.get(), POLLIN, 0}};
+    while (true) {
+      TEST_PCHECK(RetryEINTR(poll)(pfds, 2, -1) > 0);
+      if (pfds[1].revents) {
+        return;
+      }
+      struct uffd_msg msg;
+      TEST_PCHECK(read(uffd.get(), &msg, sizeof(msg)) == sizeof(msg));
+      const uint64_t page = msg.arg.pagefault.address & ~(kPageSize - 1);
+      if (resolve == UserfaultResolve::kCopy) {
+        struct uffdio_copy copy = {};
+        copy.dst = page;
+        copy.src = reinterpret_cast<uint64_t>(src.data());
+        copy.len = kPageSize;
+        TEST_PCHECK(ioctl(uffd.get(), UFFDIO_COPY, &copy) == 0);
+      } else {
+        struct uffdio_zeropage zero = {};
+        zero.range.start = page;
+        zero.range.len = kPageSize;
+        TEST_PCHECK(ioctl(uffd.get(), UFFDIO_ZEROPAGE, &zero) == 0);
+      }
+    }
+  });
+
+  size_t cur_page = kUserfaultPages;
+  for (auto _ : state) {
+    if (cur_page >= kUserfaultPages) {
+      // Make all pages missing again.
+      state.PauseTiming();
+      TEST_PCHECK(madvise(m.ptr(), m.len(), MADV_DONTNEED) == 0);
+      cur_page = 0;
+      state.ResumeTiming();
+    }
+    const char c =
+        reinterpret_cast<volatile char*>(m.ptr())[cur_page * kPageSize];
+    benchmark::DoNotOptimize(c);
+    cur_page++;
+  }
+
+  const uint64_t val = 1;
+  TEST_PCHECK(write(stop.get(), &val, sizeof(val)) == sizeof(val));
+  handler.Join();
+}
+
+BENCHMARK_CAPTURE(BM_UserfaultRoundTrip, copy, UserfaultResolve::kCopy)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_UserfaultRoundTrip, zeropage, UserfaultResolve::kZeropage)
+    ->UseRealTime();
+
+// Orders in which BM_FaultAround touches the pages of a mapping.
+enum class TouchPattern {
+  kSequential,
+  kReverse,
+  kRandom,
+  // Every kFaultAroundStride'th page, then the pages after those, and so on.
+  kStrided,
+};
+
+// Number of pages in each BM_FaultAround mapping.
+constexpr size_t kFaultAroundPages = 4096;
+
+// Distance between consecutive pages touched by TouchPattern::kStrided, in
+// pages. This is larger than Linux's default fault_around_bytes.
+constexpr size_t kFaultAroundStride = 32;
+
+// TouchOrder returns the page indices of a kFaultAroundPages mapping in the
+// order given by pattern.
+std::vector<size_t> TouchOrder(TouchPattern pattern) {
+  std::vector<size_t> order;
+  switch (pattern) {
+    case TouchPattern::kSequential:
+    case TouchPattern::kReverse:
+    case TouchPattern::kRandom:
+      for (size_t i = 0; i < kFaultAroundPages; i++) {
+        order.push_back(i);
+      }
+      if (pattern == TouchPattern::kReverse) {
+        std::reverse(order.begin(), order.end());
+      } else if (pattern == TouchPattern::kRandom) {
+        std::shuffle(order.begin(), order.end(), std::mt19937(1));
+      }
+      break;
+    case TouchPattern::kStrided:
+      for (size_t start = 0; start < kFaultAroundStride; start++) {
+        for (size_t i = start; i < kFaultAroundPages;
+             i += kFaultAroundStride) {
+          order.push_back(i);
+        }
+      }
+      break;
+  }
+  return order;
+}
+
+// ResidentPages returns this process' resident set size in pages.
+int64_t ResidentPages() {
+  const std::string statm = GetContents("/proc/self/statm").ValueOrDie();
+  const std::vector<std::string> fields = absl::StrSplit(statm, ' ');
+  int64_t resident;
+  TEST_CHECK(fields.size() > 1 && absl::SimpleAtoi(fields[1], &resident));
+  return resident;
+}
+
+// FaultAroundMapping maps kFaultAroundPages, either anonymous or from file if
+// it is valid.
+void* FaultAroundMapping(const FileDescriptor& file) {
+  const size_t len = kFaultAroundPages * kPageSize;
+  void* addr = file.get() < 0
+                   ? mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+                   : mmap(nullptr, len, PROT_READ, MAP_PRIVATE, file.get(), 0);
+  TEST_CHECK_MSG(addr != MAP_FAILED, "mmap failed");
+  return addr;
+}
+
+// TouchPage takes the first-touch fault on page i of addr. Anonymous pages are
+// written, since Linux maps read faults on them to the shared zero page. File
+// pages are read, since Linux only faults around on read faults.
+inline void TouchPage(void* addr, size_t i, bool file) {
+  volatile char* c = reinterpret_cast<volatile char*>(addr) + i * kPageSize;
+  if (file) {
+    const char v = *c;
+    benchmark::DoNotOptimize(v);
+  } else {
+    *c = 42;
+  }
+}
+
+// BM_FaultAround measures the cost per page of first touches over a fresh
+// mapping in the order given by pattern. state.range(0) selects an anonymous
+// (0) or file-backed (1) mapping.
+//
+// Before timing, a calibration pass checks the resident set size around each
+// touch to report pages_per_fault, the average number of pages populated by
+// each touch that faulted. This uses RSS rather than mincore(2), since the
+// sandbox reports all mapped pages as resident and Linux reports page cache
+// residency for file mappings.
+void BM_FaultAround(benchmark::State& state, TouchPattern pattern) {
+  const bool file = state.range(0);
+  const std::vector<size_t> order = TouchOrder(pattern);
+  const size_t len = kFaultAroundPages * kPageSize;
+
+  TempPath path;
+  FileDescriptor fd;
+  if (file) {
+    path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+        GetAbsoluteTestTmpdir(), std::string(len, 'a'),
+        TempPath::kDefaultFileMode));
+    fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path.path(), O_RDONLY));
+  }
+
+  int64_t faults = 0;
+  int64_t populated = 0;
+  void* addr = FaultAroundMapping(fd);
+  for (size_t i : order) {
+    const int64_t before = ResidentPages();
+    TouchPage(addr, i, file);
+    const int64_t after = ResidentPages();
+    if (after > before) {
+      faults++;
+      populated += after - before;
+    }
+  }
+  TEST_CHECK_MSG(munmap(addr, len) == 0, "munmap failed");
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    addr = FaultAroundMapping(fd);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i : order) {
+      TouchPage(addr, i, file);
+    }
+    auto end = std::chrono::steady_clock::now();
+    state.SetIterationTime(
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count());
+
+    TEST_CHECK_MSG(munmap(addr, len) == 0, "munmap failed");
+  }
+
+  state.SetItemsProcessed(kFaultAroundPages * state.iterations());
+  if (faults > 0) {
+    state.counters["pages_per_fault"] =
+        static_cast<double>(populated) / static_cast<double>(faults);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_FaultAround, sequential, TouchPattern::kSequential)
+    ->Arg(0)
+    ->Arg(1)
+    ->UseManualTime();
+BENCHMARK_CAPTURE(BM_FaultAround, reverse, TouchPattern::kReverse)
+    ->Arg(0)
+    ->Arg(1)
+    ->UseManualTime();
+BENCHMARK_CAPTURE(BM_FaultAround, random, TouchPattern::kRandom)
+    ->Arg(0)
+    ->Arg(1)
+    ->UseManualTime();
+BENCHMARK_CAPTURE(BM_FaultAround, strided, TouchPattern::kStrided)
+    ->Arg(0)
+    ->Arg(1)
+    ->UseManualTime();
+
+// BM_TouchFreeRefault measures the alloc/free/refault cycle of memory
+// allocators that return unused pages to the system with madvise(2) and reuse
+// them later: each iteration touches state.range(0) pages of a private
+// anonymous mapping, then frees them with advice. Unlike BM_MapTouchUnmap, the
+// mapping is kept across iterations. "rss_pages" is the resident set size
+// sampled after each free, which stays high after MADV_FREE until memory
+// pressure reclaims the pages.
+void BM_TouchFreeRefault(benchmark::State& state, int advice) {
+  const int pages = state.range(0);
+  const size_t len = pages * kPageSize;
+  void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  TEST_CHECK_MSG(addr != MAP_FAILED, "mmap failed");
+
+  int64_t rss = 0;
+  const int64_t faults = PageFaults();
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TouchPages(addr, len);
+    TEST_PCHECK(madvise(addr, len, advice) == 0);
+
+    state.PauseTiming();
+    rss += ResidentPages();
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(len * state.iterations());
+  state.counters["faults"] = benchmark::Counter(
+      PageFaults() - faults, benchmark::Counter::kIsRate);
+  state.counters["rss_pages"] =
+      benchmark::Counter(rss, benchmark::Counter::kAvgIterations);
+
+  TEST_CHECK_MSG(munmap(addr, len) == 0, "munmap failed");
+}
+
+BENCHMARK_CAPTURE(BM_TouchFreeRefault, dontneed, MADV_DONTNEED)
+    ->Range(1, 1 << 15)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_TouchFreeRefault, free, MADV_FREE)
+    ->Range(1, 1 << 15)
+    ->UseRealTime();
+
+enum class LockMode {
+  // The mapping isn't locked.
+  kNone,
+
+  // The mapping is locked with mlock(2) after it is created.
+  kMlock,
+
+  // The mapping is created with MAP_LOCKED.
+  kMapLocked,
+};
+
+// BM_FirstTouchLatency measures first touches of each of state.range(0) pages
+// of a fresh private anonymous mapping, locked according to mode, as a
+// latency-sensitive service does after locking its heap. Mapping and locking
+// aren't timed. If locking populates the mapping, the touches don't fault, so
+// "max_touch_ns", the slowest touch observed, stays close to the average.
+void BM_FirstTouchLatency(benchmark::State& state, LockMode mode) {
+  const int pages = state.range(0);
+  const size_t len = pages * kPageSize;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (mode == LockMode::kMapLocked) {
+    flags |= MAP_LOCKED;
+  }
+
+  std::chrono::steady_clock::duration max_touch{};
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (addr == MAP_FAILED) {
+      state.SkipWithError("mmap failed");
+      return;
+    }
+    if (mode == LockMode::kMlock && mlock(addr, len) != 0) {
+      state.SkipWithError("mlock failed; check RLIMIT_MEMLOCK");
+      TEST_CHECK_MSG(munmap(addr, len) == 0, "munmap failed");
+      return;
+    }
+
+    std::chrono::steady_clock::duration total{};
+    for (int i = 0; i < pages; i++) {
+      auto start = std::chrono::steady_clock::now();
+      TouchPage(addr, i, /*file=*/false);
+      auto touch = std::chrono::steady_clock::now() - start;
+      total += touch;
+      max_touch = std::max(max_touch, touch);
+    }
+    state.SetIterationTime(
+        std::chrono::duration_cast<std::chrono::duration<double>>(total)
+            .count());
+
+    TEST_CHECK_MSG(munmap(addr, len) == 0, "munmap failed");
+  }
+
+  state.SetItemsProcessed(pages * state.iterations());
+  state.counters["max_touch_ns"] =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(max_touch).count();
+}
+
+BENCHMARK_CAPTURE(BM_FirstTouchLatency, none, LockMode::kNone)
+    ->Range(1, 1 << 12)
+    ->UseManualTime();
+BENCHMARK_CAPTURE(BM_FirstTouchLatency, mlock, LockMode::kMlock)
+    ->Range(1, 1 << 12)
+    ->UseManualTime();
+BENCHMARK_CAPTURE(BM_FirstTouchLatency, map_locked, LockMode::kMapLocked)
+    ->Range(1, 1 << 12)
+    ->UseManualTime();
+
+// Number of brk(2) calls made per iteration of BM_BrkIncrement.
+constexpr int kBrkIncrements = 1 << 20;
+
+// BM_BrkIncrement measures growing the heap by state.range(0) bytes at a time,
+// as a simple allocator that calls sbrk for each small allocation would. Each
+// iteration makes kBrkIncrements calls, then returns the heap to where it
+// started.
+void BM_BrkIncrement(benchmark::State& state) {
+  const uintptr_t increment = state.range(0);
+  const uintptr_t start = static_cast<uintptr_t>(syscall(SYS_brk, 0));
+
+  for (auto _ : state) {
+    uintptr_t brk = start;
+    for (int i = 0; i < kBrkIncrements; i++) {
+      brk += increment;
+      TEST_CHECK_MSG(static_cast<uintptr_t>(syscall(SYS_brk, brk)) == brk,
+                     "brk failed");
+    }
+    TEST_CHECK_MSG(static_cast<uintptr_t>(syscall(SYS_brk, start)) == start,
+                   "brk failed");
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          kBrkIncrements);
+}
+
+BENCHMARK(BM_BrkIncrement)->Arg(16)->Arg(64)->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
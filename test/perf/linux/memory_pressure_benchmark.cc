@@ -0,0 +1,101 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/sysinfo.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of the file read by BM_ReadUnderPressure.
+constexpr size_t kFileSize = 64 << 20;
+
+// Size of each read.
+constexpr size_t kReadSize = 1 << 20;
+
+// The largest anonymous footprint the benchmark creates, so that it doesn't
+// exhaust the memory of hosts without a memory limit.
+constexpr uint64_t kMaxFootprint = uint64_t{8} << 30;
+
+// BM_ReadUnderPressure measures the throughput of reading a file while
+// state.range(0) percent of the total memory (as reported by sysinfo(2),
+// which in gVisor is the container's memory limit) is allocated by the
+// application, i.e. as the workload approaches its memory limit.
+//
+// Cached file contents compete with the application's own memory, so in
+// sandboxes run with --oom-threshold below the allocated percentage, the file
+// is reread from the gofer after the cache is evicted.
+void BM_ReadUnderPressure(benchmark::State& state) {
+  struct sysinfo info;
+  TEST_PCHECK(sysinfo(&info) == 0);
+  const uint64_t total = static_cast<uint64_t>(info.totalram) * info.mem_unit;
+  const uint64_t footprint = total / 100 * state.range(0);
+  if (footprint > kMaxFootprint) {
+    state.SkipWithError("total memory too large");
+    return;
+  }
+
+  const std::string contents(kFileSize, 'a');
+  auto path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path.path(), O_RDONLY));
+
+  // Populate the footprint, so that it is resident while the file is read.
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(footprint, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* p = static_cast<char*>(m.ptr());
+  for (uint64_t off = 0; off < footprint; off += kPageSize) {
+    p[off] = 1;
+  }
+
+  std::vector<char> buf(kReadSize);
+  for (auto _ : state) {
+    for (size_t off = 0; off < kFileSize; off += kReadSize) {
+      TEST_CHECK(PreadFd(fd.get(), buf.data(), kReadSize, off) == kReadSize);
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(kFileSize) *
+                          static_cast<int64_t>(state.iterations()));
+  state.counters["footprint_bytes"] = static_cast<double>(footprint);
+}
+
+BENCHMARK(BM_ReadUnderPressure)
+    ->Arg(25)
+    ->Arg(50)
+    ->Arg(75)
+    ->Arg(90)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,221 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+#ifndef SYS_getdents64
+#if defined(__x86_64__)
+#define SYS_getdents64 217
+#elif defined(__aarch64__)
+#define SYS_getdents64 217
+#else
+#error "Unknown architecture"
+#endif
+#endif  // SYS_getdents64
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr int kBufferSize = 65536;
+
+// Directories shared by all benchmark threads, so that they contend on the
+// same directory dentries. Each thread uses its own file names, and removes
+// its files when done, so the directories are empty between runs.
+struct SharedDirs {
+  TempPath a;
+  TempPath b;
+  FileDescriptor a_fd;
+  FileDescriptor b_fd;
+};
+
+SharedDirs& GetSharedDirs() {
+  // This gets created only once throughout the lifetime of the process. Use a
+  // dynamically allocated object (that is never deleted) to avoid order of
+  // destruction of static storage variables issues.
+  static SharedDirs* const dirs = [] {
+    auto* dirs = new SharedDirs;
+    dirs->a = TempPath::CreateDir().ValueOrDie();
+    dirs->b = TempPath::CreateDir().ValueOrDie();
+    dirs->a_fd = Open(dirs->a.path(), O_RDONLY | O_DIRECTORY).ValueOrDie();
+    dirs->b_fd = Open(dirs->b.path(), O_RDONLY | O_DIRECTORY).ValueOrDie();
+    return dirs;
+  }();
+  return *dirs;
+}
+
+void CreateFiles(int dfd, const std::vector<std::string>& names) {
+  for (const auto& name : names) {
+    TEST_PCHECK(mknodat(dfd, name.c_str(), S_IFREG | 0644, 0) == 0);
+  }
+}
+
+void UnlinkFiles(int dfd, const std::vector<std::string>& names) {
+  for (const auto& name : names) {
+    TEST_PCHECK(unlinkat(dfd, name.c_str(), 0) == 0);
+  }
+}
+
+// Operations measured by BM_Metadata.
+enum class MetadataOp {
+  kCreate,
+  kStat,
+  // Rename files to a new name in the same directory.
+  kRename,
+  // Rename files to the same name in another directory.
+  kRenameCrossDir,
+  kReaddir,
+  kUnlink,
+};
+
+// BM_Metadata measures op over state.range(0) files, split across all
+// benchmark threads in a directory they share. Reported times are per file;
+// for kReaddir, each thread reads every entry of the shared directory.
+void BM_Metadata(benchmark::State& state, MetadataOp op) {
+  // Identifies this thread's files. Unique across runs so that a slow
+  // cleanup from a previous run cannot collide.
+  static std::atomic<int> next_thread(0);
+  const int thread = next_thread.fetch_add(1);
+  const int count = std::max(1, static_cast<int>(state.range(0)) /
+                                    state.threads);
+
+  SharedDirs& dirs = GetSharedDirs();
+  std::vector<std::string> names;
+  std::vector<std::string> renamed;
+  for (int i = 0; i < count; i++) {
+    names.push_back(absl::StrCat(thread, "-", i));
+    renamed.push_back(absl::StrCat(thread, "-", i, "-renamed"));
+  }
+
+  if (op != MetadataOp::kCreate) {
+    CreateFiles(dirs.a_fd.get(), names);
+  }
+
+  // For kRename and kRenameCrossDir, files alternate between two locations.
+  bool moved = false;
+  const int batch = op == MetadataOp::kReaddir ? count * state.threads : count;
+  char buffer[kBufferSize];
+  ScopedRusageCounters rusage(state);
+  while (state.KeepRunningBatch(batch)) {
+    switch (op) {
+      case MetadataOp::kCreate:
+        CreateFiles(dirs.a_fd.get(), names);
+        state.PauseTiming();
+        UnlinkFiles(dirs.a_fd.get(), names);
+        state.ResumeTiming();
+        break;
+      case MetadataOp::kStat:
+        for (const auto& name : names) {
+          struct stat st;
+          TEST_PCHECK(fstatat(dirs.a_fd.get(), name.c_str(), &st, 0) == 0);
+        }
+        break;
+      case MetadataOp::kRename: {
+        const auto& from = moved ? renamed : names;
+        const auto& to = moved ? names : renamed;
+        for (int i = 0; i < count; i++) {
+          TEST_PCHECK(renameat(dirs.a_fd.get(), from[i].c_str(),
+                               dirs.a_fd.get(), to[i].c_str()) == 0);
+        }
+        moved = !moved;
+        break;
+      }
+      case MetadataOp::kRenameCrossDir: {
+        const int from = moved ? dirs.b_fd.get() : dirs.a_fd.get();
+        const int to = moved ? dirs.a_fd.get() : dirs.b_fd.get();
+        for (const auto& name : names) {
+          TEST_PCHECK(renameat(from, name.c_str(), to, name.c_str()) == 0);
+        }
+        moved = !moved;
+        break;
+      }
+      case MetadataOp::kReaddir: {
+        FileDescriptor fd =
+            ASSERT_NO_ERRNO_AND_VALUE(Open(dirs.a.path(), O_RDONLY));
+        int ret;
+        do {
+          ret = syscall(SYS_getdents64, fd.get(), buffer, kBufferSize);
+          TEST_PCHECK(ret >= 0);
+        } while (ret > 0);
+        break;
+      }
+      case MetadataOp::kUnlink:
+        UnlinkFiles(dirs.a_fd.get(), names);
+        state.PauseTiming();
+        CreateFiles(dirs.a_fd.get(), names);
+        state.ResumeTiming();
+        break;
+    }
+  }
+
+  switch (op) {
+    case MetadataOp::kCreate:
+      break;
+    case MetadataOp::kRename:
+      UnlinkFiles(dirs.a_fd.get(), moved ? renamed : names);
+      break;
+    case MetadataOp::kRenameCrossDir:
+      UnlinkFiles(moved ? dirs.b_fd.get() : dirs.a_fd.get(), names);
+      break;
+    default:
+      UnlinkFiles(dirs.a_fd.get(), names);
+      break;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void MetadataArgs(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(10)
+      ->Range(1000, 1000 * 1000)
+      ->ThreadRange(1, 8)
+      ->UseRealTime();
+}
+
+BENCHMARK_CAPTURE(BM_Metadata, create, MetadataOp::kCreate)
+    ->Apply(MetadataArgs);
+BENCHMARK_CAPTURE(BM_Metadata, stat, MetadataOp::kStat)->Apply(MetadataArgs);
+BENCHMARK_CAPTURE(BM_Metadata, rename, MetadataOp::kRename)
+    ->Apply(MetadataArgs);
+BENCHMARK_CAPTURE(BM_Metadata, rename_cross_dir, MetadataOp::kRenameCrossDir)
+    ->Apply(MetadataArgs);
+BENCHMARK_CAPTURE(BM_Metadata, readdir, MetadataOp::kReaddir)
+    ->Apply(MetadataArgs);
+BENCHMARK_CAPTURE(BM_Metadata, unlink, MetadataOp::kUnlink)
+    ->Apply(MetadataArgs);
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
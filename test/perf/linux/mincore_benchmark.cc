@@ -0,0 +1,73 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Distance between touched pages in the sparse mapping. Touching a page may
+// make the whole huge page around it resident, so this is kept large enough
+// that the largest mapping stays cheap to populate.
+constexpr uint64_t kTouchStride = uint64_t{4} << 30;
+
+// BM_MincoreSparse measures mincore(2) over an anonymous mapping of
+// state.range(0) bytes, of which one page per kTouchStride bytes has been
+// touched, like a huge mapped file that has only been read in a few places.
+void BM_MincoreSparse(benchmark::State& state) {
+  const uint64_t size = state.range(0);
+  // Always a multiple of the page size, since size is.
+  const uint64_t pages = size / kPageSize;
+
+  Mapping m = MmapAnon(size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_NORESERVE)
+                  .ValueOrDie();
+  for (uint64_t off = 0; off < size; off += kTouchStride) {
+    reinterpret_cast<volatile char*>(m.ptr())[off] = 1;
+  }
+
+  // The vector is itself large (one byte per page), so map it rather than
+  // allocate it.
+  Mapping vec =
+      MmapAnon(pages, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_NORESERVE)
+          .ValueOrDie();
+
+  for (auto _ : state) {
+    TEST_PCHECK(mincore(m.ptr(), size, static_cast<unsigned char*>(
+                                           vec.ptr())) == 0);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size);
+}
+
+BENCHMARK(BM_MincoreSparse)
+    ->RangeMultiplier(32)
+    ->Range(int64_t{1} << 30, int64_t{1} << 40)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
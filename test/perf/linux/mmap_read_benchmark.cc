@@ -0,0 +1,179 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Ways of reading a file for BM_MmapRead.
+enum class ReadMode {
+  // pread(2) the whole file into a buffer, as in BM_Read.
+  kRead,
+
+  // mmap(2) the file and read one byte of each page.
+  kMmap,
+
+  // Like kMmap, with MADV_SEQUENTIAL.
+  kMmapSequential,
+
+  // Like kMmap, with MADV_WILLNEED.
+  kMmapWillNeed,
+};
+
+// BM_MmapRead reads a file of state.range(0) bytes, created as in BM_Read, on
+// each iteration using mode. The mmap modes map the file, advise it, touch
+// each page and unmap it on every iteration, so they include the cost of
+// faulting in the page cache pages, but not of copying them.
+void BM_MmapRead(benchmark::State& state, ReadMode mode) {
+  const int size = state.range(0);
+  const std::string contents(size, 0);
+  auto path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path.path(), O_RDONLY));
+
+  std::vector<char> buf(mode == ReadMode::kRead ? size : 0);
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    if (mode == ReadMode::kRead) {
+      TEST_CHECK(PreadFd(fd.get(), buf.data(), buf.size(), 0) == size);
+      continue;
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd.get(), 0);
+    TEST_PCHECK(addr != MAP_FAILED);
+    if (mode == ReadMode::kMmapSequential) {
+      TEST_PCHECK(madvise(addr, size, MADV_SEQUENTIAL) == 0);
+    } else if (mode == ReadMode::kMmapWillNeed) {
+      TEST_PCHECK(madvise(addr, size, MADV_WILLNEED) == 0);
+    }
+    const char* c = static_cast<const char*>(addr);
+    char sum = 0;
+    for (int off = 0; off < size; off += kPageSize) {
+      sum += c[off];
+    }
+    benchmark::DoNotOptimize(sum);
+    TEST_PCHECK(munmap(addr, size) == 0);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_CAPTURE(BM_MmapRead, read, ReadMode::kRead)
+    ->Range(4096, 1 << 26)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MmapRead, mmap, ReadMode::kMmap)
+    ->Range(4096, 1 << 26)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MmapRead, mmap_sequential, ReadMode::kMmapSequential)
+    ->Range(4096, 1 << 26)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MmapRead, mmap_willneed, ReadMode::kMmapWillNeed)
+    ->Range(4096, 1 << 26)
+    ->UseRealTime();
+
+// Ways of writing a file back for BM_WriteBack.
+enum class WriteMode {
+  // pwrite(2) the whole file, then fdatasync(2).
+  kWrite,
+
+  // Write one byte of each page of a MAP_SHARED mapping, then msync(2) with
+  // MS_SYNC.
+  kMsync,
+};
+
+// BM_WriteBack dirties a file of state.range(0) bytes and writes it back to
+// storage on each iteration using mode. In addition, it reports sync_ns: the
+// time spent in fdatasync or msync per iteration.
+void BM_WriteBack(benchmark::State& state, WriteMode mode) {
+  const int size = state.range(0);
+  const std::string contents(size, 0);
+  auto path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path.path(), O_RDWR));
+
+  std::vector<char> buf(mode == WriteMode::kWrite ? size : 0);
+  char* addr = nullptr;
+  if (mode == WriteMode::kMsync) {
+    void* m =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+    TEST_PCHECK(m != MAP_FAILED);
+    addr = static_cast<char*>(m);
+  }
+
+  int64_t sync_ns = 0;
+  char value = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    // Change the contents on every iteration so that every page is dirtied.
+    value++;
+    int64_t start;
+    switch (mode) {
+      case WriteMode::kWrite:
+        memset(buf.data(), value, buf.size());
+        TEST_CHECK(PwriteFd(fd.get(), buf.data(), buf.size(), 0) == size);
+        start = LatencyHistogram::Now();
+        TEST_PCHECK(fdatasync(fd.get()) == 0);
+        break;
+      case WriteMode::kMsync:
+        for (int off = 0; off < size; off += kPageSize) {
+          addr[off] = value;
+        }
+        start = LatencyHistogram::Now();
+        TEST_PCHECK(msync(addr, size, MS_SYNC) == 0);
+        break;
+    }
+    sync_ns += LatencyHistogram::Now() - start;
+  }
+
+  if (addr != nullptr) {
+    TEST_PCHECK(munmap(addr, size) == 0);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+  state.counters["sync_ns"] =
+      benchmark::Counter(sync_ns, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_CAPTURE(BM_WriteBack, write, WriteMode::kWrite)
+    ->Range(4096, 1 << 26)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_WriteBack, msync, WriteMode::kMsync)
+    ->Range(4096, 1 << 26)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,117 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <linux/memfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Maximum number of bytes populated in the moved region, so that the largest
+// regions can be benchmarked without that much memory.
+constexpr size_t kMaxPopulated = 256 << 20;
+
+enum class RemapMode {
+  // MAP_PRIVATE | MAP_ANONYMOUS, as used by malloc for large allocations.
+  kAnon,
+
+  // MAP_SHARED of a memfd.
+  kMemfd,
+};
+
+// TouchStride returns the distance between populated pages in a region of
+// size bytes.
+size_t TouchStride(size_t size) {
+  return std::max<size_t>(kPageSize, size / (kMaxPopulated / kPageSize));
+}
+
+// TouchPages writes to every stride bytes of [addr, addr+size).
+void TouchPages(void* addr, size_t size, size_t stride) {
+  for (size_t off = 0; off < size; off += stride) {
+    reinterpret_cast<volatile char*>(addr)[off] = 42;
+  }
+}
+
+// BM_MremapMove measures moving a populated region of state.range(0) bytes
+// with mremap(2), as realloc does when a large allocation can't grow in
+// place, and touching it again afterwards. If the move remaps the region's
+// existing memory, the cost of both is independent of the region's size,
+// aside from faults on the touched pages if the platform doesn't carry
+// mappings over. Up to kMaxPopulated bytes of the region are populated, spread
+// evenly across it.
+void BM_MremapMove(benchmark::State& state, RemapMode mode) {
+  const size_t size = state.range(0);
+  const size_t stride = TouchStride(size);
+
+  FileDescriptor memfd;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+  if (mode == RemapMode::kMemfd) {
+    const int fd = syscall(__NR_memfd_create, "mremap_benchmark", 0);
+    TEST_PCHECK(fd >= 0);
+    memfd = FileDescriptor(fd);
+    TEST_PCHECK(ftruncate(memfd.get(), size) == 0);
+    flags = MAP_SHARED;
+  }
+
+  // Reserve space for the region and the destination of its moves, then
+  // move the region back and forth between the two halves.
+  Mapping reserved =
+      MmapAnon(2 * size, PROT_NONE, MAP_PRIVATE | MAP_NORESERVE).ValueOrDie();
+  char* const addrs[2] = {static_cast<char*>(reserved.ptr()),
+                          static_cast<char*>(reserved.ptr()) + size};
+  TEST_PCHECK(mmap(addrs[0], size, PROT_READ | PROT_WRITE, flags | MAP_FIXED,
+                   memfd.get(), 0) == addrs[0]);
+  TouchPages(addrs[0], size, stride);
+
+  int cur = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    void* const addr = Mremap(addrs[cur], size, size,
+                              MREMAP_MAYMOVE | MREMAP_FIXED, addrs[1 - cur])
+                           .ValueOrDie();
+    cur = 1 - cur;
+    TouchPages(addr, size, stride);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) * state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_MremapMove, anon, RemapMode::kAnon)
+    ->RangeMultiplier(4)
+    ->Range(1 << 20, int64_t{16} << 30)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MremapMove, memfd, RemapMode::kMemfd)
+    ->RangeMultiplier(4)
+    ->Range(1 << 20, int64_t{16} << 30)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,113 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// BM_MulticastFanOut measures how fast a datagram sent to a multicast group
+// over loopback is delivered to state.range(0) subscribers, all bound to the
+// same port. Each iteration sends one datagram of state.range(1) bytes and
+// receives it on every subscriber.
+void BM_MulticastFanOut(benchmark::State& state) {
+  const int subscribers = state.range(0);
+  const int size = state.range(1);
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  struct ip_mreq group = {};
+  group.imr_multiaddr.s_addr = inet_addr(kMulticastAddress);
+  group.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+
+  std::vector<FileDescriptor> fds;
+  for (int i = 0; i < subscribers; i++) {
+    FileDescriptor fd = Socket(AF_INET, SOCK_DGRAM, 0).ValueOrDie();
+    TEST_PCHECK(setsockopt(fd.get(), SOL_SOCKET, SO_REUSEPORT, &kSockOptOn,
+                           sizeof(kSockOptOn)) == 0);
+    // The first subscriber picks the port; the rest share it.
+    TEST_PCHECK(bind(fd.get(), reinterpret_cast<struct sockaddr*>(&addr),
+                     sizeof(addr)) == 0);
+    socklen_t addrlen = sizeof(addr);
+    TEST_PCHECK(getsockname(fd.get(), reinterpret_cast<struct sockaddr*>(&addr),
+                            &addrlen) == 0);
+    TEST_PCHECK(setsockopt(fd.get(), IPPROTO_IP, IP_ADD_MEMBERSHIP, &group,
+                           sizeof(group)) == 0);
+    fds.push_back(std::move(fd));
+  }
+
+  // Bind the sender to loopback, which makes it the default multicast send
+  // interface.
+  FileDescriptor sender = Socket(AF_INET, SOCK_DGRAM, 0).ValueOrDie();
+  struct sockaddr_in sender_addr = {};
+  sender_addr.sin_family = AF_INET;
+  sender_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  TEST_PCHECK(bind(sender.get(),
+                   reinterpret_cast<struct sockaddr*>(&sender_addr),
+                   sizeof(sender_addr)) == 0);
+
+  struct sockaddr_in dst = {};
+  dst.sin_family = AF_INET;
+  dst.sin_addr.s_addr = inet_addr(kMulticastAddress);
+  dst.sin_port = addr.sin_port;
+
+  std::vector<char> buf(size);
+  for (auto _ : state) {
+    TEST_PCHECK(sendto(sender.get(), buf.data(), buf.size(), 0,
+                       reinterpret_cast<struct sockaddr*>(&dst),
+                       sizeof(dst)) == size);
+    for (const FileDescriptor& fd : fds) {
+      TEST_PCHECK(RetryEINTR(recv)(fd.get(), buf.data(), buf.size(), 0) ==
+                  size);
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          subscribers);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          subscribers * size);
+}
+
+void FanOutArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"subscribers", "size"});
+  for (int subscribers : {1, 8, 64, 256}) {
+    for (int size : {64, 1400}) {
+      bench->Args({subscribers, size});
+    }
+  }
+}
+
+BENCHMARK(BM_MulticastFanOut)->Apply(FanOutArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
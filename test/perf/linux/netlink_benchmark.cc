@@ -0,0 +1,132 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <linux/capability.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/socket_netlink_route_util.h"
+#include "test/syscalls/linux/socket_netlink_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/capability_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr uint32_t kSeq = 12345;
+
+// AddLoopbackAddrs ensures that the loopback interface has at least the n
+// addresses 10.2.0.0 through 10.2.0.n-1, so that dumps of addresses and local
+// routes grow with n.
+PosixError AddLoopbackAddrs(int n) {
+  ASSIGN_OR_RETURN_ERRNO(Link lo, LoopbackLink());
+  for (int i = 0; i < n; i++) {
+    struct in_addr addr;
+    addr.s_addr = htonl(0x0a020000 | i);
+    PosixError err = LinkAddLocalAddr(lo.index, AF_INET, /*prefixlen=*/32,
+                                      &addr, sizeof(addr));
+    // Linux fails with EEXIST if the address was added by an earlier run.
+    if (!err.ok() &&
+        !::testing::Value(err, PosixErrorIs(EEXIST, ::testing::_))) {
+      return err;
+    }
+  }
+  return NoError();
+}
+
+// Dump sends a dump request of the given type on fd and reads the response
+// with recvmsg(2) buffers of buf.size() bytes until NLMSG_DONE. It returns the
+// number of messages received.
+int Dump(const FileDescriptor& fd, uint16_t type, std::vector<char>& buf) {
+  struct request {
+    struct nlmsghdr hdr;
+    struct rtgenmsg rgm;
+  };
+  struct request req = {};
+  req.hdr.nlmsg_len = sizeof(req);
+  req.hdr.nlmsg_type = type;
+  req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  req.hdr.nlmsg_seq = kSeq;
+  req.rgm.rtgen_family = AF_UNSPEC;
+  TEST_PCHECK(RetryEINTR(send)(fd.get(), &req, sizeof(req), 0) == sizeof(req));
+
+  int messages = 0;
+  while (true) {
+    int len = RetryEINTR(recv)(fd.get(), buf.data(), buf.size(), 0);
+    TEST_PCHECK(len > 0);
+    for (struct nlmsghdr* hdr = reinterpret_cast<struct nlmsghdr*>(buf.data());
+         NLMSG_OK(hdr, len); hdr = NLMSG_NEXT(hdr, len)) {
+      if (hdr->nlmsg_type == NLMSG_DONE) {
+        return messages;
+      }
+      TEST_CHECK(hdr->nlmsg_type != NLMSG_ERROR);
+      messages++;
+    }
+  }
+}
+
+// BM_NetlinkDump measures RTM_GETLINK, RTM_GETADDR and RTM_GETROUTE dumps, as
+// polled by container network agents, read with buffers of state.range(2)
+// bytes. state.range(1) loopback addresses are added first if possible.
+void BM_NetlinkDump(benchmark::State& state) {
+  const uint16_t type = state.range(0);
+  const int addrs = state.range(1);
+  if (addrs > 0) {
+    if (!HaveCapability(CAP_NET_ADMIN).ValueOrDie()) {
+      state.SkipWithError("CAP_NET_ADMIN required");
+      return;
+    }
+    TEST_CHECK(AddLoopbackAddrs(addrs).ok());
+  }
+
+  FileDescriptor fd = NetlinkBoundSocket(NETLINK_ROUTE).ValueOrDie();
+  std::vector<char> buf(state.range(2));
+
+  int64_t messages = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    messages += Dump(fd, type, buf);
+  }
+  state.SetItemsProcessed(messages);
+}
+
+void DumpArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"type", "addrs", "buf"});
+  for (int type : {RTM_GETLINK, RTM_GETADDR, RTM_GETROUTE}) {
+    for (int addrs : {0, 256}) {
+      for (int buf : {4 << 10, 32 << 10}) {
+        benchmark->Args({type, addrs, buf});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_NetlinkDump)->Apply(&DumpArgs);
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,69 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <linux/capability.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/capability_util.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// BM_UnshareNet measures the cost of creating a network namespace that is
+// never used for networking.
+void BM_UnshareNet(benchmark::State& state) {
+  if (!HaveCapability(CAP_SYS_ADMIN).ValueOrDie()) {
+    state.SkipWithError("CAP_SYS_ADMIN required");
+    return;
+  }
+
+  for (auto _ : state) {
+    TEST_PCHECK(unshare(CLONE_NEWNET) == 0);
+  }
+}
+
+BENCHMARK(BM_UnshareNet)->UseRealTime();
+
+// BM_UnshareNetSocket measures the cost of creating a network namespace and
+// then a socket in it, which is what a sandboxed process that goes on to
+// use the network pays.
+void BM_UnshareNetSocket(benchmark::State& state) {
+  if (!HaveCapability(CAP_SYS_ADMIN).ValueOrDie()) {
+    state.SkipWithError("CAP_SYS_ADMIN required");
+    return;
+  }
+
+  for (auto _ : state) {
+    TEST_PCHECK(unshare(CLONE_NEWNET) == 0);
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(close(fd) == 0);
+  }
+}
+
+BENCHMARK(BM_UnshareNetSocket)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
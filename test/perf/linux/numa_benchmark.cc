@@ -0,0 +1,189 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+#define MPOL_INTERLEAVE 3
+#define MPOL_F_MEMS_ALLOWED (1 << 2)
+
+// Size of the buffer read by each thread.
+constexpr size_t kBufferSize = 64 << 20;
+
+enum class Placement {
+  // Each thread reads memory bound to the node it runs on.
+  kLocal,
+
+  // Each thread reads memory bound to the next node.
+  kRemote,
+
+  // Each thread reads memory interleaved across all nodes.
+  kInterleave,
+};
+
+// AllowedNodes returns the NUMA nodes from which this process may allocate
+// memory.
+std::vector<int> AllowedNodes() {
+  uint64_t nodemask[16] = {};
+  TEST_PCHECK(syscall(SYS_get_mempolicy, nullptr, nodemask,
+                      sizeof(nodemask) * 8 + 1, nullptr,
+                      MPOL_F_MEMS_ALLOWED) == 0);
+  std::vector<int> nodes;
+  for (int node = 0; node < static_cast<int>(sizeof(nodemask) * 8); node++) {
+    if (nodemask[node / 64] & (uint64_t{1} << (node % 64))) {
+      nodes.push_back(node);
+    }
+  }
+  return nodes;
+}
+
+// NodeCPUs returns the set of CPUs on the given node. If the CPUs can't be
+// determined (as in gVisor, which doesn't expose per-node sysfs directories),
+// it returns all CPUs on which the caller may run.
+cpu_set_t NodeCPUs(int node) {
+  cpu_set_t cpus;
+  TEST_PCHECK(sched_getaffinity(0, sizeof(cpus), &cpus) == 0);
+  auto contents = GetContents(
+      absl::StrCat("/sys/devices/system/node/node", node, "/cpulist"));
+  if (!contents.ok()) {
+    return cpus;
+  }
+  cpu_set_t node_cpus;
+  CPU_ZERO(&node_cpus);
+  for (absl::string_view range :
+       absl::StrSplit(contents.ValueOrDie(), ',', absl::SkipWhitespace())) {
+    std::vector<absl::string_view> bounds = absl::StrSplit(range, '-');
+    int first, last;
+    TEST_CHECK(absl::SimpleAtoi(bounds[0], &first));
+    last = first;
+    if (bounds.size() > 1) {
+      TEST_CHECK(absl::SimpleAtoi(bounds[1], &last));
+    }
+    for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &cpus)) {
+        CPU_SET(cpu, &node_cpus);
+      }
+    }
+  }
+  if (CPU_COUNT(&node_cpus) == 0) {
+    return cpus;
+  }
+  return node_cpus;
+}
+
+// ReadBuffer reads every word of [addr, addr+size).
+void ReadBuffer(const void* addr, size_t size) {
+  const uint64_t* words = static_cast<const uint64_t*>(addr);
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size / sizeof(uint64_t); i++) {
+    sum += words[i];
+  }
+  benchmark::DoNotOptimize(sum);
+}
+
+// BM_NUMABandwidth measures the aggregate read bandwidth of one thread per
+// NUMA node, each pinned to the CPUs of its node and reading its own buffer
+// placed with mbind(2) according to placement. On hosts with a single node,
+// placement has no effect, so the benchmark is skipped.
+void BM_NUMABandwidth(benchmark::State& state, Placement placement) {
+  const std::vector<int> nodes = AllowedNodes();
+  if (nodes.size() < 2) {
+    state.SkipWithError("requires at least 2 NUMA nodes");
+    return;
+  }
+
+  uint64_t all_nodes = 0;
+  for (int node : nodes) {
+    if (node < 64) {
+      all_nodes |= uint64_t{1} << node;
+    }
+  }
+
+  std::vector<Mapping> buffers;
+  std::vector<cpu_set_t> cpus;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    const int node = nodes[i];
+    const int mem_node =
+        placement == Placement::kRemote ? nodes[(i + 1) % nodes.size()] : node;
+    if (mem_node >= 64) {
+      state.SkipWithError("NUMA node above 63");
+      return;
+    }
+    // Populate the buffer so that its pages are placed before measurement.
+    // MmapAnon can only bind to a single node, so interleaved buffers are
+    // bound and populated here.
+    MmapAnonOptions options;
+    if (placement != Placement::kInterleave) {
+      options.populate = true;
+      options.numa_node = mem_node;
+    }
+    Mapping m =
+        MmapAnon(kBufferSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, options)
+            .ValueOrDie();
+    if (placement == Placement::kInterleave) {
+      TEST_PCHECK(syscall(SYS_mbind, m.ptr(), m.len(), MPOL_INTERLEAVE,
+                          &all_nodes, sizeof(all_nodes) * 8 + 1, 0) == 0);
+      memset(m.ptr(), 1, m.len());
+    }
+    buffers.push_back(std::move(m));
+    cpus.push_back(NodeCPUs(node));
+  }
+
+  // Workers are pinned to their node's CPUs rather than to single CPUs.
+  WorkerPool pool(buffers.size(), /*pin=*/false);
+  pool.Run([&](int i) {
+    TEST_PCHECK(sched_setaffinity(0, sizeof(cpus[i]), &cpus[i]) == 0);
+  });
+
+  for (auto _ : state) {
+    pool.Run([&](int i) { ReadBuffer(buffers[i].ptr(), buffers[i].len()); });
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(kBufferSize) * buffers.size() *
+                          state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_NUMABandwidth, local, Placement::kLocal)->UseRealTime();
+BENCHMARK_CAPTURE(BM_NUMABandwidth, remote, Placement::kRemote)->UseRealTime();
+BENCHMARK_CAPTURE(BM_NUMABandwidth, interleave, Placement::kInterleave)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -22,6 +22,7 @@
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/fs_util.h"
 #include "test/util/logging.h"
 #include "test/util/temp_path.h"
@@ -40,6 +41,7 @@ void BM_Open(benchmark::State& state) {
   }
 
   unsigned int seed = 1;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     const int chosen = rand_r(&seed) % size;
     int fd = open(cache[chosen].path().c_str(), O_RDONLY);
@@ -50,6 +52,43 @@ void BM_Open(benchmark::State& state) {
 
 BENCHMARK(BM_Open)->Range(1, 128)->UseRealTime();
 
+// Largest number of files used by BM_OpenShared.
+constexpr int kMaxSharedFiles = 128;
+
+const std::vector<TempPath>& GetSharedFiles() {
+  // This gets created only once throughout the lifetime of the process. Use a
+  // dynamically allocated object (that is never deleted) to avoid order of
+  // destruction of static storage variables issues.
+  static const std::vector<TempPath>* const files = [] {
+    auto* files = new std::vector<TempPath>;
+    for (int i = 0; i < kMaxSharedFiles; i++) {
+      files->push_back(TempPath::CreateFile().ValueOrDie());
+    }
+    return files;
+  }();
+  return *files;
+}
+
+// Like BM_Open, but with every benchmark thread opening the same set of files.
+void BM_OpenShared(benchmark::State& state) {
+  const int size = state.range(0);
+  const std::vector<TempPath>& files = GetSharedFiles();
+
+  unsigned int seed = 1;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    const int chosen = rand_r(&seed) % size;
+    int fd = open(files[chosen].path().c_str(), O_RDONLY);
+    TEST_CHECK(fd != -1);
+    close(fd);
+  }
+}
+
+BENCHMARK(BM_OpenShared)
+    ->Range(1, kMaxSharedFiles)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
@@ -0,0 +1,153 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <linux/capability.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/capability_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Number of datagrams sent per iteration. Only the last one of each batch is
+// of interest to the capturing application.
+constexpr int kBatch = 64;
+
+// BoundUDPSocket returns a UDP socket bound to an ephemeral loopback port,
+// and stores the address in *addr.
+FileDescriptor BoundUDPSocket(struct sockaddr_in* addr) {
+  FileDescriptor fd = Socket(AF_INET, SOCK_DGRAM, 0).ValueOrDie();
+  *addr = {};
+  addr->sin_family = AF_INET;
+  addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  TEST_PCHECK(bind(fd.get(), reinterpret_cast<struct sockaddr*>(addr),
+                   sizeof(*addr)) == 0);
+  socklen_t addrlen = sizeof(*addr);
+  TEST_PCHECK(getsockname(fd.get(), reinterpret_cast<struct sockaddr*>(addr),
+                          &addrlen) == 0);
+  return fd;
+}
+
+// DstPort returns the UDP destination port of an IPv4 packet, or 0 if it
+// isn't a UDP packet.
+uint16_t DstPort(const char* pkt, size_t len) {
+  const struct iphdr* ip = reinterpret_cast<const struct iphdr*>(pkt);
+  if (len < sizeof(*ip) || ip->protocol != IPPROTO_UDP ||
+      len < ip->ihl * 4 + sizeof(struct udphdr)) {
+    return 0;
+  }
+  const struct udphdr* udp =
+      reinterpret_cast<const struct udphdr*>(pkt + ip->ihl * 4);
+  return udp->dest;
+}
+
+// BM_PacketCapture measures the rate at which UDP traffic can flow over
+// loopback while a packet socket captures one datagram in kBatch, to a single
+// port. With state.range(0) == 0, the capturing application reads every
+// packet and discards the ones it doesn't want; otherwise, it attaches a
+// socket filter that selects the packets it wants before they are queued.
+void BM_PacketCapture(benchmark::State& state) {
+  if (!HaveCapability(CAP_NET_RAW).ValueOrDie()) {
+    state.SkipWithError("CAP_NET_RAW required");
+    return;
+  }
+  const bool filter = state.range(0) != 0;
+
+  struct sockaddr_in other_addr, wanted_addr;
+  FileDescriptor other = BoundUDPSocket(&other_addr);
+  FileDescriptor wanted = BoundUDPSocket(&wanted_addr);
+  FileDescriptor sender = Socket(AF_INET, SOCK_DGRAM, 0).ValueOrDie();
+
+  // Cooked packet sockets receive packets starting at the network header.
+  FileDescriptor capture =
+      Socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_IP)).ValueOrDie();
+  struct sockaddr_ll ll = {};
+  ll.sll_family = AF_PACKET;
+  ll.sll_protocol = htons(ETH_P_IP);
+  ll.sll_ifindex = if_nametoindex("lo");
+  TEST_CHECK(ll.sll_ifindex != 0);
+  TEST_PCHECK(bind(capture.get(), reinterpret_cast<struct sockaddr*>(&ll),
+                   sizeof(ll)) == 0);
+
+  if (filter) {
+    // udp dst port wanted_addr.sin_port.
+    struct sock_filter insns[] = {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, offsetof(struct iphdr, protocol)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 4),
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, offsetof(struct udphdr, dest)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohs(wanted_addr.sin_port), 0,
+                 1),
+        BPF_STMT(BPF_RET | BPF_K, 0xffff),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+    struct sock_fprog prog = {};
+    prog.len = sizeof(insns) / sizeof(insns[0]);
+    prog.filter = insns;
+    TEST_PCHECK(setsockopt(capture.get(), SOL_SOCKET, SO_ATTACH_FILTER, &prog,
+                           sizeof(prog)) == 0);
+  }
+
+  char buf[64] = {};
+  char pkt[256];
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (int i = 0; i < kBatch; i++) {
+      const bool last = i == kBatch - 1;
+      const struct sockaddr_in* dst = last ? &wanted_addr : &other_addr;
+      TEST_PCHECK(sendto(sender.get(), buf, sizeof(buf), 0,
+                         reinterpret_cast<const struct sockaddr*>(dst),
+                         sizeof(*dst)) == sizeof(buf));
+      TEST_PCHECK(recv(last ? wanted.get() : other.get(), buf, sizeof(buf),
+                       0) == sizeof(buf));
+    }
+
+    // Read captured packets until the wanted one turns up.
+    for (;;) {
+      ssize_t n = recv(capture.get(), pkt, sizeof(pkt), 0);
+      TEST_PCHECK(n >= 0);
+      if (DstPort(pkt, n) == wanted_addr.sin_port) {
+        break;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+BENCHMARK(BM_PacketCapture)->ArgName("filter")->Arg(0)->Arg(1)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -12,15 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <cerrno>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
 #include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/temp_path.h"
 #include "test/util/test_util.h"
 #include "test/util/thread_util.h"
 
@@ -45,8 +54,12 @@ void BM_Pipe(benchmark::State& state) {
     }
   });
 
+  LatencyHistogram latency;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
+    const int64_t start = LatencyHistogram::Now();
     TEST_CHECK(ReadFd(fds[0], rbuf.data(), rbuf.size()) == size);
+    latency.Record(LatencyHistogram::Now() - start);
   }
 
   t.Join();
@@ -56,9 +69,170 @@ void BM_Pipe(benchmark::State& state) {
 
   state.SetBytesProcessed(static_cast<int64_t>(size) *
                           static_cast<int64_t>(state.iterations()));
+  latency.Report(state);
 }
 
-BENCHMARK(BM_Pipe)->Range(1, 1 << 20)->UseRealTime();
+BENCHMARK(BM_Pipe)->Range(1, 1 << 20)->ThreadRange(1, 4)->UseRealTime();
+
+// BM_PipePingPong measures the round trip time of a 1-byte message written to
+// one pipe and echoed back through a second pipe by another thread.
+void BM_PipePingPong(benchmark::State& state) {
+  int ping[2];
+  int pong[2];
+  TEST_CHECK(pipe(ping) == 0);
+  TEST_CHECK(pipe(pong) == 0);
+
+  ScopedThread t([&] {
+    char c;
+    while (true) {
+      const ssize_t n = ReadFd(ping[0], &c, 1);
+      TEST_PCHECK(n >= 0);
+      if (n == 0) {
+        // The writer closed the pipe.
+        return;
+      }
+      TEST_PCHECK(WriteFd(pong[1], &c, 1) == 1);
+    }
+  });
+
+  char c = 'a';
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(WriteFd(ping[1], &c, 1) == 1);
+    TEST_PCHECK(ReadFd(pong[0], &c, 1) == 1);
+  }
+
+  close(ping[1]);
+  t.Join();
+
+  close(ping[0]);
+  close(pong[0]);
+  close(pong[1]);
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PipePingPong)->UseRealTime();
+
+// BM_PipeSplice measures the throughput of state.range(0)-byte chunks written
+// to one pipe and moved to a second pipe with splice(2), or duplicated to it
+// with tee(2) and then discarded from the first with splice(2), before being
+// read from the second pipe. Compare with BM_Pipe at the same sizes.
+void BM_PipeSplice(benchmark::State& state, bool tee) {
+  int src[2];
+  int dst[2];
+  TEST_CHECK(pipe(src) == 0);
+  TEST_CHECK(pipe(dst) == 0);
+  const int null_fd = open("/dev/null", O_WRONLY);
+  TEST_CHECK(null_fd >= 0);
+
+  const int size = state.range(0);
+  // Best effort; splice in smaller chunks if the pipes cannot grow.
+  fcntl(src[1], F_SETPIPE_SZ, size);
+  fcntl(dst[1], F_SETPIPE_SZ, size);
+
+  std::vector<char> wbuf(size);
+  std::vector<char> rbuf(size);
+  RandomizeBuffer(wbuf.data(), size);
+
+  ScopedThread t([&] {
+    auto const fd = src[1];
+    for (int i = 0; i < state.max_iterations; i++) {
+      TEST_CHECK(WriteFd(fd, wbuf.data(), wbuf.size()) == size);
+    }
+  });
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (int done = 0; done < size;) {
+      int n;
+      if (tee) {
+        n = RetryEINTR(::tee)(src[0], dst[1], size - done, 0);
+        TEST_PCHECK(n > 0);
+        TEST_PCHECK(RetryEINTR(splice)(src[0], nullptr, null_fd, nullptr, n,
+                                       0) == n);
+      } else {
+        n = RetryEINTR(splice)(src[0], nullptr, dst[1], nullptr, size - done,
+                               0);
+        TEST_PCHECK(n > 0);
+      }
+      TEST_CHECK(ReadFd(dst[0], rbuf.data() + done, n) == n);
+      done += n;
+    }
+  }
+
+  t.Join();
+
+  close(null_fd);
+  close(src[0]);
+  close(src[1]);
+  close(dst[0]);
+  close(dst[1]);
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_CAPTURE(BM_PipeSplice, splice, false)
+    ->Range(64 << 10, 1 << 20)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PipeSplice, tee, true)
+    ->Range(64 << 10, 1 << 20)
+    ->UseRealTime();
+
+// BM_VmspliceToFile measures the throughput of state.range(0)-byte chunks
+// moved from a page-aligned buffer into a pipe, with vmsplice(2) if vmsplice
+// is true and write(2) otherwise, and then from the pipe to the start of a
+// file with splice(2).
+void BM_VmspliceToFile(benchmark::State& state, bool vmsplice) {
+  int fds[2];
+  TEST_CHECK(pipe(fds) == 0);
+
+  const int size = state.range(0);
+  // Best effort; move smaller chunks if the pipe cannot grow.
+  fcntl(fds[1], F_SETPIPE_SZ, size);
+
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(size, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const buf = static_cast<char*>(m.ptr());
+  RandomizeBuffer(buf, size);
+
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(
+      TempPath::CreateFileIn(GetAbsoluteTestTmpdir()));
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_WRONLY));
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    loff_t off = 0;
+    for (int done = 0; done < size;) {
+      int n;
+      if (vmsplice) {
+        struct iovec iov = {buf + done, static_cast<size_t>(size - done)};
+        n = RetryEINTR(::vmsplice)(fds[1], &iov, 1, SPLICE_F_GIFT);
+      } else {
+        n = RetryEINTR(write)(fds[1], buf + done, size - done);
+      }
+      TEST_PCHECK(n > 0);
+      TEST_PCHECK(RetryEINTR(splice)(fds[0], nullptr, fd.get(), &off, n, 0) ==
+                  n);
+      done += n;
+    }
+  }
+
+  close(fds[0]);
+  close(fds[1]);
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_CAPTURE(BM_VmspliceToFile, vmsplice, true)
+    ->Range(4 << 10, 1 << 20)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_VmspliceToFile, write, false)
+    ->Range(4 << 10, 1 << 20)
+    ->UseRealTime();
 
 }  // namespace
 
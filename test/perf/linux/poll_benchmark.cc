@@ -0,0 +1,125 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/rlimit_util.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Returns a new eventfd.
+PosixErrorOr<FileDescriptor> NewEventFD() {
+  int fd = eventfd(0, 0);
+  MaybeSave();
+  if (fd < 0) {
+    return PosixError(errno, "eventfd");
+  }
+  return FileDescriptor(fd);
+}
+
+// Returns count new eventfds, of which only the last is readable.
+std::vector<FileDescriptor> NewEventFDs(int count) {
+  constexpr uint64_t kEventVal = 1;
+  std::vector<FileDescriptor> eventfds;
+  for (int i = 0; i < count; i++) {
+    eventfds.push_back(NewEventFD().ValueOrDie());
+  }
+  TEST_PCHECK(WriteFd(eventfds.back().get(), &kEventVal, sizeof(kEventVal)) ==
+              sizeof(kEventVal));
+  return eventfds;
+}
+
+// BM_Poll measures poll(2) on state.range(0) eventfds, of which only the last
+// is readable, as in the loop of a server that polls all of its connections.
+// The timeout is non-zero, so the files must be registered with for events
+// even though the call never blocks.
+void BM_Poll(benchmark::State& state) {
+  const int nfds = state.range(0);
+  auto rlimit_or = ScopedSetSoftRlimit(RLIMIT_NOFILE, nfds + 64);
+  if (!rlimit_or.ok()) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  auto rlimit = std::move(rlimit_or).ValueOrDie();
+
+  std::vector<FileDescriptor> eventfds = NewEventFDs(nfds);
+  std::vector<struct pollfd> pfds;
+  for (const auto& fd : eventfds) {
+    struct pollfd pfd = {};
+    pfd.fd = fd.get();
+    pfd.events = POLLIN;
+    pfds.push_back(pfd);
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(poll(pfds.data(), pfds.size(), 1000) == 1);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(nfds) * state.iterations());
+}
+
+BENCHMARK(BM_Poll)->Range(16, 16384)->UseRealTime();
+
+// BM_Select is the equivalent of BM_Poll for select(2), which is limited to
+// FD_SETSIZE file descriptors.
+void BM_Select(benchmark::State& state) {
+  const int nfds = state.range(0);
+  std::vector<FileDescriptor> eventfds = NewEventFDs(nfds);
+  int maxfd = 0;
+  fd_set fds;
+  FD_ZERO(&fds);
+  for (const auto& fd : eventfds) {
+    if (fd.get() >= FD_SETSIZE) {
+      state.SkipWithError("file descriptor exceeds FD_SETSIZE");
+      return;
+    }
+    FD_SET(fd.get(), &fds);
+    maxfd = std::max(maxfd, fd.get());
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    fd_set readfds = fds;
+    struct timeval timeout = {};
+    timeout.tv_sec = 1;
+    TEST_PCHECK(select(maxfd + 1, &readfds, nullptr, nullptr, &timeout) == 1);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(nfds) * state.iterations());
+}
+
+BENCHMARK(BM_Select)->Arg(16)->Arg(128)->Arg(960)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
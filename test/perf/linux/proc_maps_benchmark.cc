@@ -0,0 +1,96 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/proc_util.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of each read(2), as used by buffered readers such as fgets(3).
+constexpr size_t kReadSize = 4096;
+
+// ManyVMAs creates a mapping of the given number of pages, each of which is a
+// separate vma since adjacent pages have different protections.
+Mapping ManyVMAs(int pages) {
+  Mapping m = MmapAnon(pages * kPageSize, PROT_READ, MAP_PRIVATE).ValueOrDie();
+  for (int i = 0; i < pages; i += 2) {
+    TEST_PCHECK(mprotect(reinterpret_cast<char*>(m.ptr()) + i * kPageSize,
+                         kPageSize, PROT_NONE) == 0);
+  }
+  return m;
+}
+
+// BM_ReadProcMaps measures reading the given file in /proc/self, in kReadSize
+// chunks as a monitoring agent would, while the process has at least
+// state.range(0) vmas.
+void BM_ReadProcMaps(benchmark::State& state, const char* name) {
+  const int vmas = state.range(0);
+  const Mapping m = ManyVMAs(vmas);
+  const std::string path = absl::StrCat("/proc/self/", name);
+
+  // Count the vmas that are actually present.
+  const std::vector<ProcMapsEntry> entries =
+      ParseProcMaps(GetContents("/proc/self/maps").ValueOrDie()).ValueOrDie();
+  TEST_CHECK(entries.size() >= static_cast<size_t>(vmas));
+
+  std::vector<char> buf(kReadSize);
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    const FileDescriptor fd = Open(path, O_RDONLY).ValueOrDie();
+    int n;
+    while ((n = read(fd.get(), buf.data(), buf.size())) > 0) {
+      bytes += n;
+    }
+    TEST_PCHECK(n == 0);
+  }
+
+  state.SetBytesProcessed(bytes);
+  state.counters["vmas"] = entries.size();
+}
+
+BENCHMARK_CAPTURE(BM_ReadProcMaps, maps, "maps")
+    ->RangeMultiplier(4)
+    ->Range(16, 1 << 15)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReadProcMaps, smaps, "smaps")
+    ->RangeMultiplier(4)
+    ->Range(16, 1 << 15)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReadProcMaps, smaps_rollup, "smaps_rollup")
+    ->RangeMultiplier(4)
+    ->Range(16, 1 << 15)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
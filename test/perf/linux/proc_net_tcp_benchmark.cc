@@ -0,0 +1,174 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/socket_netlink_util.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of each read(2), as used by buffered readers such as fgets(3).
+constexpr size_t kReadSize = 4096;
+
+// Connections holds the given number of established loopback TCP
+// connections, each of which is two sockets.
+class Connections {
+ public:
+  explicit Connections(int n) {
+    listener_ = Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP).ValueOrDie();
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_PCHECK(bind(listener_.get(),
+                     reinterpret_cast<struct sockaddr*>(&addr),
+                     sizeof(addr)) == 0);
+    socklen_t addrlen = sizeof(addr);
+    TEST_PCHECK(getsockname(listener_.get(),
+                            reinterpret_cast<struct sockaddr*>(&addr),
+                            &addrlen) == 0);
+    TEST_PCHECK(listen(listener_.get(), SOMAXCONN) == 0);
+
+    for (int i = 0; i < n; i++) {
+      FileDescriptor client =
+          Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP).ValueOrDie();
+      TEST_PCHECK(connect(client.get(),
+                          reinterpret_cast<struct sockaddr*>(&addr),
+                          sizeof(addr)) == 0);
+      const int server = accept(listener_.get(), nullptr, nullptr);
+      TEST_PCHECK(server >= 0);
+      fds_.push_back(std::move(client));
+      fds_.emplace_back(server);
+    }
+  }
+
+ private:
+  FileDescriptor listener_;
+  std::vector<FileDescriptor> fds_;
+};
+
+// Raises the open file limit to allow the given number of connections.
+// Returns false if the hard limit is too low.
+bool RaiseFileLimit(int connections) {
+  struct rlimit rl;
+  TEST_PCHECK(getrlimit(RLIMIT_NOFILE, &rl) == 0);
+  // Two sockets per connection, plus some slack for other files.
+  const rlim_t want = 2 * connections + 64;
+  if (rl.rlim_cur >= want) {
+    return true;
+  }
+  if (rl.rlim_max < want) {
+    return false;
+  }
+  rl.rlim_cur = want;
+  TEST_PCHECK(setrlimit(RLIMIT_NOFILE, &rl) == 0);
+  return true;
+}
+
+// BM_ReadProcNetTCP measures reading /proc/net/tcp in kReadSize chunks, as
+// monitoring agents do, with state.range(0) open connections.
+void BM_ReadProcNetTCP(benchmark::State& state) {
+  const int connections = state.range(0);
+  if (!RaiseFileLimit(connections)) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  const Connections conns(connections);
+
+  std::vector<char> buf(kReadSize);
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    const FileDescriptor fd = Open("/proc/net/tcp", O_RDONLY).ValueOrDie();
+    int n;
+    while ((n = read(fd.get(), buf.data(), buf.size())) > 0) {
+      bytes += n;
+    }
+    TEST_PCHECK(n == 0);
+  }
+
+  state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(BM_ReadProcNetTCP)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 14)
+    ->UseRealTime();
+
+// BM_SockDiagDump measures dumping all IPv4 TCP sockets with sock_diag, as
+// ss(8) does, with state.range(0) open connections.
+void BM_SockDiagDump(benchmark::State& state) {
+  const int connections = state.range(0);
+  if (!RaiseFileLimit(connections)) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  const Connections conns(connections);
+  const FileDescriptor fd = NetlinkBoundSocket(NETLINK_SOCK_DIAG).ValueOrDie();
+
+  struct {
+    struct nlmsghdr hdr;
+    struct inet_diag_req_v2 req;
+  } req = {};
+  req.hdr.nlmsg_len = sizeof(req);
+  req.hdr.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+  req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  req.req.sdiag_family = AF_INET;
+  req.req.sdiag_protocol = IPPROTO_TCP;
+  req.req.idiag_states = ~0U;
+
+  int64_t sockets = 0;
+  for (auto _ : state) {
+    TEST_CHECK(NetlinkRequestResponse(
+                   fd, &req, sizeof(req),
+                   [&](const struct nlmsghdr* hdr) {
+                     if (hdr->nlmsg_type == SOCK_DIAG_BY_FAMILY) {
+                       sockets++;
+                     }
+                   },
+                   false)
+                   .ok());
+  }
+
+  state.SetItemsProcessed(sockets);
+}
+
+BENCHMARK(BM_SockDiagDump)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 14)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
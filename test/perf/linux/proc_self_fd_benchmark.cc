@@ -0,0 +1,214 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+#ifndef SYS_close_range
+#define SYS_close_range 436
+#endif
+
+// First fd of the table filled by each benchmark, chosen to be above any fds
+// inherited from the benchmark runner.
+constexpr int kBaseFD = 1000;
+
+// Size of the buffer passed to getdents64.
+constexpr int kDentsSize = 32 << 10;
+
+// Raises RLIMIT_NOFILE to allow fds up to kBaseFD + n, returning false if
+// that isn't possible.
+bool RaiseFileLimit(int n) {
+  struct rlimit rl;
+  TEST_PCHECK(getrlimit(RLIMIT_NOFILE, &rl) == 0);
+  const rlim_t want = kBaseFD + n;
+  if (rl.rlim_cur >= want) {
+    return true;
+  }
+  if (rl.rlim_max < want) {
+    return false;
+  }
+  rl.rlim_cur = want;
+  TEST_PCHECK(setrlimit(RLIMIT_NOFILE, &rl) == 0);
+  return true;
+}
+
+// ManyFDs dups a file to fds [kBaseFD, kBaseFD + n) for its lifetime.
+class ManyFDs {
+ public:
+  explicit ManyFDs(int n) : n_(n) {
+    fd_ = Open("/dev/null", O_RDONLY).ValueOrDie();
+    Fill();
+  }
+
+  ~ManyFDs() { Clear(); }
+
+  // Fill opens all of the fds.
+  void Fill() {
+    for (int i = 0; i < n_; i++) {
+      TEST_PCHECK(dup2(fd_.get(), kBaseFD + i) == kBaseFD + i);
+    }
+  }
+
+  // Clear closes all of the fds.
+  void Clear() {
+    for (int i = 0; i < n_; i++) {
+      close(kBaseFD + i);
+    }
+  }
+
+ private:
+  const int n_;
+  FileDescriptor fd_;
+};
+
+// BM_ListProcSelfFD measures listing /proc/self/fd, as done by process
+// supervisors and by programs that close inherited fds, with state.range(0)
+// open fds.
+void BM_ListProcSelfFD(benchmark::State& state) {
+  const int n = state.range(0);
+  if (!RaiseFileLimit(n)) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  const ManyFDs fds(n);
+
+  std::vector<char> buf(kDentsSize);
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    const int dirfd = open("/proc/self/fd", O_RDONLY | O_DIRECTORY);
+    TEST_PCHECK(dirfd >= 0);
+    long ret;
+    while ((ret = syscall(SYS_getdents64, dirfd, buf.data(), buf.size())) >
+           0) {
+    }
+    TEST_PCHECK(ret == 0);
+    TEST_PCHECK(close(dirfd) == 0);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(n) * state.iterations());
+}
+
+BENCHMARK(BM_ListProcSelfFD)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 17)
+    ->UseRealTime();
+
+// BM_ReadlinkProcSelfFD measures readlink of entries in /proc/self/fd with
+// state.range(0) open fds.
+void BM_ReadlinkProcSelfFD(benchmark::State& state) {
+  const int n = state.range(0);
+  if (!RaiseFileLimit(n)) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  const ManyFDs fds(n);
+
+  std::vector<std::string> paths;
+  for (int i = 0; i < n; i++) {
+    paths.push_back(absl::StrCat("/proc/self/fd/", kBaseFD + i));
+  }
+
+  char target[PATH_MAX];
+  int i = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(readlink(paths[i].c_str(), target, sizeof(target)) > 0);
+    if (++i == n) {
+      i = 0;
+    }
+  }
+}
+
+BENCHMARK(BM_ReadlinkProcSelfFD)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 17)
+    ->UseRealTime();
+
+// BM_CloseLoop measures opening state.range(0) fds and closing them one at a
+// time, as done before exec by programs that can't use close_range(2).
+void BM_CloseLoop(benchmark::State& state) {
+  const int n = state.range(0);
+  if (!RaiseFileLimit(n)) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  ManyFDs fds(n);
+  fds.Clear();
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    fds.Fill();
+    for (int i = 0; i < n; i++) {
+      TEST_PCHECK(close(kBaseFD + i) == 0);
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(n) * state.iterations());
+}
+
+BENCHMARK(BM_CloseLoop)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 17)
+    ->UseRealTime();
+
+// BM_CloseRange is BM_CloseLoop using a single close_range(2).
+void BM_CloseRange(benchmark::State& state) {
+  const int n = state.range(0);
+  if (!RaiseFileLimit(n)) {
+    state.SkipWithError("RLIMIT_NOFILE too low");
+    return;
+  }
+  ManyFDs fds(n);
+  fds.Clear();
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    fds.Fill();
+    if (syscall(SYS_close_range, kBaseFD, ~0U, 0) != 0) {
+      state.SkipWithError("close_range not supported");
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(n) * state.iterations());
+}
+
+BENCHMARK(BM_CloseRange)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 17)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
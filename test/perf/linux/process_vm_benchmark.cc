@@ -0,0 +1,120 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/ptrace.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Ways in which BM_ReadRemote reads another process' memory.
+enum class RemoteRead {
+  // process_vm_readv(2).
+  kProcessVM,
+
+  // pread(2) of /proc/[pid]/mem.
+  kProcMem,
+
+  // PTRACE_PEEKDATA, one word at a time.
+  kPeekData,
+};
+
+// BM_ReadRemote measures reading state.range(0) bytes of a stopped tracee's
+// memory, as a sampling profiler or crash reporter would.
+void BM_ReadRemote(benchmark::State& state, RemoteRead how) {
+  const size_t len = state.range(0);
+  Mapping m = MmapAnon(len, PROT_READ | PROT_WRITE, MAP_PRIVATE).ValueOrDie();
+  memset(m.ptr(), 1, len);
+
+  pid_t child = fork();
+  if (child == 0) {
+    TEST_PCHECK(ptrace(PTRACE_TRACEME, 0, 0, 0) == 0);
+    TEST_PCHECK(raise(SIGSTOP) == 0);
+    _exit(0);
+  }
+  TEST_PCHECK(child > 0);
+  int status;
+  TEST_PCHECK(waitpid(child, &status, 0) == child);
+  TEST_CHECK(WIFSTOPPED(status) && WSTOPSIG(status) == SIGSTOP);
+
+  const FileDescriptor mem =
+      Open(absl::StrCat("/proc/", child, "/mem"), O_RDONLY).ValueOrDie();
+  std::vector<char> buf(len);
+
+  for (auto _ : state) {
+    switch (how) {
+      case RemoteRead::kProcessVM: {
+        struct iovec local = {buf.data(), len};
+        struct iovec remote = {m.ptr(), len};
+        TEST_PCHECK(process_vm_readv(child, &local, 1, &remote, 1, 0) ==
+                    static_cast<ssize_t>(len));
+        break;
+      }
+      case RemoteRead::kProcMem:
+        TEST_PCHECK(pread(mem.get(), buf.data(), len, m.addr()) ==
+                    static_cast<ssize_t>(len));
+        break;
+      case RemoteRead::kPeekData:
+        for (size_t off = 0; off < len; off += sizeof(long)) {
+          errno = 0;
+          long word = ptrace(PTRACE_PEEKDATA, child, m.addr() + off, 0);
+          TEST_PCHECK(errno == 0);
+          memcpy(buf.data() + off, &word, sizeof(word));
+        }
+        break;
+    }
+  }
+
+  TEST_PCHECK(kill(child, SIGKILL) == 0);
+  TEST_PCHECK(waitpid(child, &status, 0) == child);
+
+  state.SetBytesProcessed(static_cast<int64_t>(len) * state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_ReadRemote, process_vm, RemoteRead::kProcessVM)
+    ->RangeMultiplier(8)
+    ->Range(64, 8 << 20)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReadRemote, proc_mem, RemoteRead::kProcMem)
+    ->RangeMultiplier(8)
+    ->Range(64, 8 << 20)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReadRemote, peekdata, RemoteRead::kPeekData)
+    ->RangeMultiplier(8)
+    ->Range(64, 1 << 20)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,113 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <signal.h>
+#include <sys/ptrace.h>
+#include <sys/syscall.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// PTRACE_GET_SYSCALL_INFO is not defined until Linux 5.3.
+constexpr auto kPtraceGetSyscallInfo = static_cast<__ptrace_request>(0x420e);
+
+// Large enough for any struct ptrace_syscall_info.
+struct SyscallInfoBuffer {
+  uint64_t data[16];
+};
+
+// How the tracer inspects each syscall-stop.
+enum Inspect {
+  kInspectNone = 0,
+  kInspectGetRegs = 1,
+  kInspectGetSyscallInfo = 2,
+};
+
+// BM_TracedGetpid measures the cost of a getpid(2) made by a tracee under a
+// strace-like tracer. The tracer resumes the tracee with PTRACE_SYSCALL, waits
+// for each syscall-enter-stop and syscall-exit-stop, and, depending on
+// state.range(0), inspects the tracee at each stop with PTRACE_GETREGS or
+// PTRACE_GET_SYSCALL_INFO. Each iteration is one traced syscall, i.e. two
+// stops.
+void BM_TracedGetpid(benchmark::State& state) {
+  const int inspect = state.range(0);
+
+  const pid_t child = fork();
+  if (child == 0) {
+    TEST_PCHECK(ptrace(PTRACE_TRACEME, 0, 0, 0) == 0);
+    TEST_PCHECK(raise(SIGSTOP) == 0);
+    // Run until the tracer kills us.
+    while (true) {
+      syscall(SYS_getpid);
+    }
+  }
+  TEST_PCHECK(child > 0);
+
+  int status;
+  TEST_PCHECK(RetryEINTR(waitpid)(child, &status, 0) == child);
+  TEST_CHECK(WIFSTOPPED(status) && WSTOPSIG(status) == SIGSTOP);
+  TEST_PCHECK(ptrace(PTRACE_SETOPTIONS, child, 0,
+                     PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL) == 0);
+
+  struct user_regs_struct regs;
+  SyscallInfoBuffer info;
+  for (auto _ : state) {
+    // Syscall-enter-stop, then syscall-exit-stop.
+    for (int i = 0; i < 2; i++) {
+      TEST_PCHECK(ptrace(PTRACE_SYSCALL, child, 0, 0) == 0);
+      TEST_PCHECK(RetryEINTR(waitpid)(child, &status, 0) == child);
+      TEST_CHECK(WIFSTOPPED(status) && WSTOPSIG(status) == (SIGTRAP | 0x80));
+      switch (inspect) {
+        case kInspectGetRegs:
+          TEST_PCHECK(ptrace(PTRACE_GETREGS, child, 0, &regs) == 0);
+          break;
+        case kInspectGetSyscallInfo:
+          TEST_PCHECK(ptrace(kPtraceGetSyscallInfo, child, sizeof(info),
+                             &info) > 0);
+          break;
+      }
+    }
+  }
+
+  TEST_PCHECK(kill(child, SIGKILL) == 0);
+  TEST_PCHECK(RetryEINTR(waitpid)(child, &status, 0) == child);
+  TEST_CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TracedGetpid)
+    ->ArgName("inspect")
+    ->Arg(kInspectNone)
+    ->Arg(kInspectGetRegs)
+    ->Arg(kInspectGetSyscallInfo)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
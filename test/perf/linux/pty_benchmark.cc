@@ -0,0 +1,131 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/pty_util.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Modes of BM_Pty.
+enum class Mode {
+  // Write to the slave and read from the master with default termios, as a
+  // program writing its output to a terminal does. Output processing
+  // translates each "\n" to "\r\n".
+  kOutputCooked,
+
+  // Write to the slave and read from the master, with the slave in raw mode.
+  kOutputRaw,
+
+  // Write to the master and read from the slave, with the slave in raw mode,
+  // as a program reading input from a terminal emulator does.
+  kInputRaw,
+};
+
+constexpr int kLineLength = 80;
+
+// Clears O_NONBLOCK on fd.
+void SetBlocking(int fd) {
+  const int flags = fcntl(fd, F_GETFL);
+  TEST_PCHECK(flags >= 0);
+  TEST_PCHECK(fcntl(fd, F_SETFL, flags & ~O_NONBLOCK) == 0);
+}
+
+// BM_Pty measures the throughput of state.range(0)-byte writes of
+// kLineLength-byte lines through a pseudoterminal in the given mode. Compare
+// with BM_Pipe at the same sizes.
+void BM_Pty(benchmark::State& state, Mode mode) {
+  FileDescriptor master =
+      ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/ptmx", O_RDWR | O_NONBLOCK));
+  FileDescriptor slave = ASSERT_NO_ERRNO_AND_VALUE(OpenSlave(master));
+  SetBlocking(master.get());
+  SetBlocking(slave.get());
+
+  if (mode != Mode::kOutputCooked) {
+    struct termios t;
+    TEST_PCHECK(tcgetattr(slave.get(), &t) == 0);
+    cfmakeraw(&t);
+    TEST_PCHECK(tcsetattr(slave.get(), TCSANOW, &t) == 0);
+  }
+
+  const int wfd = mode == Mode::kInputRaw ? master.get() : slave.get();
+  const int rfd = mode == Mode::kInputRaw ? slave.get() : master.get();
+
+  const int size = state.range(0);
+  std::vector<char> wbuf(size, 'x');
+  int lines = 0;
+  for (int i = kLineLength - 1; i < size; i += kLineLength) {
+    wbuf[i] = '\n';
+    lines++;
+  }
+  // The number of bytes read for each write.
+  const int64_t expected = size + (mode == Mode::kOutputCooked ? lines : 0);
+
+  ScopedThread t([&] {
+    for (int i = 0; i < state.max_iterations; i++) {
+      TEST_CHECK(WriteFd(wfd, wbuf.data(), wbuf.size()) == size);
+    }
+  });
+
+  std::vector<char> rbuf(std::max(size, 4096));
+  int64_t pending = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    // Reads are not aligned with writes, so carry over any excess.
+    pending += expected;
+    while (pending > 0) {
+      // Not ReadFd, which waits for the whole buffer.
+      const ssize_t n = RetryEINTR(read)(rfd, rbuf.data(), rbuf.size());
+      TEST_PCHECK(n > 0);
+      pending -= n;
+    }
+  }
+
+  t.Join();
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_CAPTURE(BM_Pty, output_cooked, Mode::kOutputCooked)
+    ->Range(1 << 10, 1 << 20)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Pty, output_raw, Mode::kOutputRaw)
+    ->Range(1 << 10, 1 << 20)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Pty, input_raw, Mode::kInputRaw)
+    ->Range(1 << 10, 1 << 20)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -13,15 +13,31 @@
 // limitations under the License.
 
 #include <fcntl.h>
+#include <linux/aio_abi.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <random>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "absl/random/random.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
 #include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
 #include "test/util/temp_path.h"
 #include "test/util/test_util.h"
 
@@ -59,7 +75,12 @@ TempPath CreateFile(uint64_t file_size) {
 // Global test state, initialized once per process lifetime.
 struct GlobalState {
   const TempPath tmpfile;
-  explicit GlobalState(TempPath tfile) : tmpfile(std::move(tfile)) {}
+
+  // Range of random read offsets.
+  const uint64_t size;
+
+  GlobalState(TempPath tfile, uint64_t size)
+      : tmpfile(std::move(tfile)), size(size) {}
 };
 
 GlobalState& GetGlobalState() {
@@ -70,29 +91,209 @@ GlobalState& GetGlobalState() {
       // The actual file size is the maximum random seek range (kFileSize) + the
       // maximum read size so we can read that number of bytes at the end of the
       // file.
-      new GlobalState(CreateFile(kFileSize + kMaxRead));
+      new GlobalState(CreateFile(kFileSize + kMaxRead), kFileSize);
   return *state;
 }
 
-void BM_RandRead(benchmark::State& state) {
+// TotalMemory returns MemTotal from /proc/meminfo, in bytes. In gVisor, this
+// is the memory available to the sandbox.
+uint64_t TotalMemory() {
+  const std::string meminfo = GetContents("/proc/meminfo").ValueOrDie();
+  for (absl::string_view line : absl::StrSplit(meminfo, '\n')) {
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(line, ' ', absl::SkipEmpty());
+    uint64_t total_kb;
+    if (fields.size() >= 2 && fields[0] == "MemTotal:" &&
+        absl::SimpleAtoi(fields[1], &total_kb)) {
+      return total_kb * 1024;
+    }
+  }
+  TEST_CHECK_MSG(false, "MemTotal not found in /proc/meminfo");
+  return 0;
+}
+
+// GetLargeState returns global test state with a file 25% larger than memory,
+// so that most reads miss the page cache, or nullptr if there is not enough
+// disk space for it.
+GlobalState* GetLargeState() {
+  // See GetGlobalState.
+  static GlobalState* const state = []() -> GlobalState* {
+    const uint64_t size = TotalMemory() / 4 * 5;
+    struct statvfs st;
+    TEST_PCHECK(statvfs(GetAbsoluteTestTmpdir().c_str(), &st) == 0);
+    if (static_cast<uint64_t>(st.f_bavail) * st.f_frsize < size + kMaxRead) {
+      return nullptr;
+    }
+    return new GlobalState(CreateFile(size + kMaxRead), size);
+  }();
+  return state;
+}
+
+// Modes of BM_RandRead.
+enum class Mode {
+  // Read from a file that fits in the page cache.
+  kWarm,
+
+  // Like kWarm, but drop the file from the page cache after every iteration.
+  //
+  // Note that gVisor implements POSIX_FADV_DONTNEED as a no-op, in which case
+  // this is the same as kWarm.
+  kCold,
+
+  // Like kWarm, but open the file with O_DIRECT, bypassing the page cache.
+  // Reads are aligned to the logical block size.
+  kDirect,
+
+  // Read from a file larger than memory.
+  kLarge,
+};
+
+// Alignment of O_DIRECT reads.
+constexpr uint64_t kDirectAlignment = 4096;
+
+void BM_RandRead(benchmark::State& state, Mode mode) {
   const int size = state.range(0);
 
-  GlobalState& global_state = GetGlobalState();
-  FileDescriptor fd =
-      ASSERT_NO_ERRNO_AND_VALUE(Open(global_state.tmpfile.path(), O_RDONLY));
-  std::vector<char> buf(size);
+  GlobalState* global_state =
+      mode == Mode::kLarge ? GetLargeState() : &GetGlobalState();
+  if (global_state == nullptr) {
+    state.SkipWithError("not enough disk space for a file larger than memory");
+    return;
+  }
+  auto fd_or = Open(global_state->tmpfile.path(),
+                    mode == Mode::kDirect ? O_RDONLY | O_DIRECT : O_RDONLY);
+  if (mode == Mode::kDirect && !fd_or.ok()) {
+    state.SkipWithError("O_DIRECT is not supported");
+    return;
+  }
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(std::move(fd_or));
+  if (mode == Mode::kCold) {
+    // Dirty pages are not dropped by POSIX_FADV_DONTNEED.
+    TEST_PCHECK(fdatasync(fd.get()) == 0);
+  }
+
+  // O_DIRECT requires an aligned buffer.
+  Mapping buf = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(size, PROT_READ | PROT_WRITE, MAP_PRIVATE));
 
-  unsigned int seed = 1;
+  std::mt19937_64 gen(1);
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
-    TEST_CHECK(PreadFd(fd.get(), buf.data(), buf.size(),
-                       rand_r(&seed) % kFileSize) == size);
+    uint64_t offset = absl::Uniform<uint64_t>(gen, 0, global_state->size);
+    if (mode == Mode::kDirect) {
+      offset &= ~(kDirectAlignment - 1);
+    }
+    TEST_CHECK(PreadFd(fd.get(), buf.ptr(), size, offset) == size);
+    if (mode == Mode::kCold) {
+      state.PauseTiming();
+      // Drop the whole file, including any pages read ahead.
+      TEST_CHECK(posix_fadvise(fd.get(), 0, 0, POSIX_FADV_DONTNEED) == 0);
+      state.ResumeTiming();
+    }
   }
 
   state.SetBytesProcessed(static_cast<int64_t>(size) *
                           static_cast<int64_t>(state.iterations()));
 }
 
-BENCHMARK(BM_RandRead)->Range(1, kMaxRead)->UseRealTime();
+BENCHMARK_CAPTURE(BM_RandRead, warm, Mode::kWarm)
+    ->Range(1, kMaxRead)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_RandRead, cold, Mode::kCold)
+    ->Range(1, kMaxRead)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_RandRead, direct, Mode::kDirect)
+    ->Range(kDirectAlignment, kMaxRead)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_RandRead, larger_than_memory, Mode::kLarge)
+    ->Range(1, kMaxRead)
+    ->UseRealTime();
+
+// BM_AIORandRead is like BM_RandRead, but submits state.range(1) reads of
+// state.range(0) bytes at once with io_submit(2) and waits for all of them,
+// as done by databases using Linux AIO. A queue depth of 1 is comparable to
+// BM_RandRead.
+void BM_AIORandRead(benchmark::State& state, Mode mode) {
+  const int size = state.range(0);
+  const int depth = state.range(1);
+
+  GlobalState* global_state =
+      mode == Mode::kLarge ? GetLargeState() : &GetGlobalState();
+  if (global_state == nullptr) {
+    state.SkipWithError("not enough disk space for a file larger than memory");
+    return;
+  }
+  auto fd_or = Open(global_state->tmpfile.path(),
+                    mode == Mode::kDirect ? O_RDONLY | O_DIRECT : O_RDONLY);
+  if (mode == Mode::kDirect && !fd_or.ok()) {
+    state.SkipWithError("O_DIRECT is not supported");
+    return;
+  }
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(std::move(fd_or));
+
+  aio_context_t ctx = 0;
+  TEST_PCHECK(syscall(__NR_io_setup, depth, &ctx) == 0);
+
+  // O_DIRECT requires aligned buffers.
+  Mapping buf = ASSERT_NO_ERRNO_AND_VALUE(MmapAnon(
+      static_cast<size_t>(size) * depth, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  std::vector<struct iocb> cbs(depth);
+  std::vector<struct iocb*> cbps(depth);
+  std::vector<struct io_event> events(depth);
+  for (int i = 0; i < depth; i++) {
+    cbs[i].aio_fildes = fd.get();
+    cbs[i].aio_lio_opcode = IOCB_CMD_PREAD;
+    cbs[i].aio_buf = buf.addr() + static_cast<uint64_t>(size) * i;
+    cbs[i].aio_nbytes = size;
+    cbps[i] = &cbs[i];
+  }
+
+  std::mt19937_64 gen(1);
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (int i = 0; i < depth; i++) {
+      uint64_t offset = absl::Uniform<uint64_t>(gen, 0, global_state->size);
+      if (mode == Mode::kDirect) {
+        offset &= ~(kDirectAlignment - 1);
+      }
+      cbs[i].aio_offset = offset;
+    }
+    TEST_PCHECK(syscall(__NR_io_submit, ctx, depth, cbps.data()) == depth);
+    int done = 0;
+    while (done < depth) {
+      const int n = syscall(__NR_io_getevents, ctx, depth - done, depth - done,
+                            events.data(), nullptr);
+      TEST_PCHECK(n > 0);
+      for (int i = 0; i < n; i++) {
+        TEST_CHECK(events[i].res == size);
+      }
+      done += n;
+    }
+  }
+
+  TEST_PCHECK(syscall(__NR_io_destroy, ctx) == 0);
+  state.SetBytesProcessed(static_cast<int64_t>(size) * depth *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+void AIOArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"size", "depth"});
+  for (int size : {4 << 10, 64 << 10, 1 << 20}) {
+    for (int depth = 1; depth <= 64; depth *= 4) {
+      benchmark->Args({size, depth});
+    }
+  }
+}
+
+BENCHMARK_CAPTURE(BM_AIORandRead, warm, Mode::kWarm)
+    ->Apply(&AIOArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_AIORandRead, direct, Mode::kDirect)
+    ->Apply(&AIOArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_AIORandRead, larger_than_memory, Mode::kLarge)
+    ->Apply(&AIOArgs)
+    ->UseRealTime();
 
 }  // namespace
 
@@ -14,13 +14,22 @@
 
 #include <fcntl.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
 #include "test/util/fs_util.h"
 #include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
 #include "test/util/temp_path.h"
 #include "test/util/test_util.h"
 
@@ -29,7 +38,70 @@ namespace testing {
 
 namespace {
 
-void BM_Read(benchmark::State& state) {
+// Modes of BM_Read.
+enum class Mode {
+  // Read the same file contents on every iteration, which are in the page
+  // cache after the first.
+  kWarm,
+
+  // Drop the file's pages from the page cache after every iteration.
+  //
+  // Note that gVisor implements POSIX_FADV_DONTNEED as a no-op, in which case
+  // this is the same as kWarm.
+  kCold,
+
+  // Open the file with O_DIRECT, bypassing the page cache.
+  kDirect,
+};
+
+void BM_Read(benchmark::State& state, Mode mode) {
+  const int size = state.range(0);
+  const std::string contents(size, 0);
+  auto path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode));
+
+  auto fd_or =
+      Open(path.path(), mode == Mode::kDirect ? O_RDONLY | O_DIRECT : O_RDONLY);
+  if (mode == Mode::kDirect && !fd_or.ok()) {
+    state.SkipWithError("O_DIRECT is not supported");
+    return;
+  }
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(std::move(fd_or));
+  if (mode == Mode::kCold) {
+    // Dirty pages are not dropped by POSIX_FADV_DONTNEED.
+    TEST_PCHECK(fdatasync(fd.get()) == 0);
+  }
+
+  // O_DIRECT requires an aligned buffer.
+  Mapping buf = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(size, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(PreadFd(fd.get(), buf.ptr(), size, 0) == size);
+    if (mode == Mode::kCold) {
+      state.PauseTiming();
+      TEST_CHECK(posix_fadvise(fd.get(), 0, size, POSIX_FADV_DONTNEED) == 0);
+      state.ResumeTiming();
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_CAPTURE(BM_Read, warm, Mode::kWarm)->Range(1, 1 << 26)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Read, cold, Mode::kCold)->Range(1, 1 << 26)->UseRealTime();
+
+// O_DIRECT reads must be a multiple of the logical block size.
+BENCHMARK_CAPTURE(BM_Read, direct, Mode::kDirect)
+    ->Range(4096, 1 << 26)
+    ->UseRealTime();
+
+// BM_ReadThreads is BM_Read in warm mode, run by multiple threads in the same
+// process, each reading its own file descriptor. Since the threads share a
+// file descriptor table but no files, throughput should scale linearly with
+// the number of threads.
+void BM_ReadThreads(benchmark::State& state) {
   const int size = state.range(0);
   const std::string contents(size, 0);
   auto path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
@@ -38,14 +110,159 @@ void BM_Read(benchmark::State& state) {
 
   std::vector<char> buf(size);
   for (auto _ : state) {
-    TEST_CHECK(PreadFd(fd.get(), buf.data(), buf.size(), 0) == size);
+    TEST_CHECK(PreadFd(fd.get(), buf.data(), size, 0) == size);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_ReadThreads)->Arg(1)->Arg(4096)->ThreadRange(1, 64)->UseRealTime();
+
+// Hints given by BM_ReadSequential before reading a file.
+enum class Hint {
+  // No hint.
+  kNone,
+
+  // posix_fadvise(POSIX_FADV_WILLNEED) on the whole file.
+  kWillNeed,
+
+  // readahead(2) of the whole file.
+  kReadahead,
+};
+
+// BM_ReadSequential measures reading a newly written file from start to end
+// with reads of state.range(0) bytes each, as done by cp, tar and checksum
+// tools, after giving the given hint. The file is written again, and dropped
+// from the page cache, before every iteration, so that reads miss the cache
+// and are served by readahead.
+void BM_ReadSequential(benchmark::State& state, Hint hint) {
+  constexpr int kFileSize = 16 << 20;
+  const int chunk = state.range(0);
+  const std::string contents(kFileSize, 'a');
+  std::vector<char> buf(chunk);
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+        GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode));
+    FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path.path(), O_RDONLY));
+    // Dirty pages are not dropped by POSIX_FADV_DONTNEED.
+    TEST_PCHECK(fdatasync(fd.get()) == 0);
+    TEST_CHECK(posix_fadvise(fd.get(), 0, 0, POSIX_FADV_DONTNEED) == 0);
+    state.ResumeTiming();
+
+    switch (hint) {
+      case Hint::kNone:
+        break;
+      case Hint::kWillNeed:
+        TEST_CHECK(posix_fadvise(fd.get(), 0, 0, POSIX_FADV_WILLNEED) == 0);
+        break;
+      case Hint::kReadahead:
+        TEST_PCHECK(readahead(fd.get(), 0, kFileSize) == 0);
+        break;
+    }
+    for (int off = 0; off < kFileSize; off += chunk) {
+      TEST_CHECK(ReadFd(fd.get(), buf.data(), chunk) == chunk);
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(kFileSize) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+void SequentialChunkArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("chunk");
+  for (int chunk : {4 << 10, 64 << 10, 1 << 20}) {
+    benchmark->Arg(chunk);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_ReadSequential, none, Hint::kNone)
+    ->Apply(&SequentialChunkArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReadSequential, willneed, Hint::kWillNeed)
+    ->Apply(&SequentialChunkArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReadSequential, readahead, Hint::kReadahead)
+    ->Apply(&SequentialChunkArgs)
+    ->UseRealTime();
+
+// BM_ReadImageFile measures reading this benchmark's own binary, a file in the
+// container image rather than one written by the benchmark, from start to end
+// with reads of state.range(0) bytes each. With an overlay root, the binary is
+// in the read-only lower layer.
+void BM_ReadImageFile(benchmark::State& state) {
+  const int chunk = state.range(0);
+  const std::string path = ASSERT_NO_ERRNO_AND_VALUE(ProcessExePath(getpid()));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path, O_RDONLY));
+  struct stat st;
+  ASSERT_THAT(fstat(fd.get(), &st), SyscallSucceeds());
+  const int64_t size = st.st_size;
+
+  std::vector<char> buf(chunk);
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (int64_t off = 0; off < size; off += chunk) {
+      TEST_CHECK(PreadFd(fd.get(), buf.data(), chunk, off) ==
+                 std::min<int64_t>(chunk, size - off));
+    }
+  }
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_ReadImageFile)
+    ->ArgName("chunk")
+    ->Arg(4 << 10)
+    ->Arg(64 << 10)
+    ->Arg(1 << 20)
+    ->UseRealTime();
+
+// BM_MmapImageFile is like BM_ReadImageFile, but maps the binary and touches
+// every page of the mapping instead of reading it.
+void BM_MmapImageFile(benchmark::State& state) {
+  const std::string path = ASSERT_NO_ERRNO_AND_VALUE(ProcessExePath(getpid()));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path, O_RDONLY));
+  struct stat st;
+  ASSERT_THAT(fstat(fd.get(), &st), SyscallSucceeds());
+  const size_t size = st.st_size;
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+        Mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0));
+    const volatile char* const p = static_cast<const char*>(m.ptr());
+    for (size_t off = 0; off < size; off += kPageSize) {
+      benchmark::DoNotOptimize(p[off]);
+    }
   }
 
   state.SetBytesProcessed(static_cast<int64_t>(size) *
                           static_cast<int64_t>(state.iterations()));
 }
 
-BENCHMARK(BM_Read)->Range(1, 1 << 26)->UseRealTime();
+BENCHMARK(BM_MmapImageFile)->UseRealTime();
+
+// BM_ReadSync reads a small file and then syncs it, as applications that
+// fdatasync(2) files they have only read do. With relatime semantics (the
+// default), only the first read updates atime, so the sync has no attributes
+// to write back, and each iteration makes no gofer RPCs if the gofer donated a
+// host file descriptor.
+void BM_ReadSync(benchmark::State& state) {
+  auto path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), "x", TempPath::kDefaultFileMode));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(path.path(), O_RDONLY));
+
+  char c;
+  for (auto _ : state) {
+    TEST_CHECK(PreadFd(fd.get(), &c, 1, 0) == 1);
+    TEST_PCHECK(fdatasync(fd.get()) == 0);
+  }
+}
+
+BENCHMARK(BM_ReadSync)->UseRealTime();
 
 }  // namespace
 
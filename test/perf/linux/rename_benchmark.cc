@@ -0,0 +1,62 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Writes a temporary file and renames it over its final name, as build tools
+// do to update outputs atomically. Each thread updates its own file in a
+// shared directory, so the renames of different threads are independent.
+void BM_WriteTempRename(benchmark::State& state) {
+  const std::string contents(state.range(0), 'x');
+  const std::string path = NewTempAbsPath();
+  const std::string temp_path = path + ".tmp";
+
+  for (auto _ : state) {
+    const int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(WriteFd(fd, contents.data(), contents.size()) ==
+                static_cast<ssize_t>(contents.size()));
+    TEST_PCHECK(close(fd) == 0);
+    TEST_PCHECK(rename(temp_path.c_str(), path.c_str()) == 0);
+  }
+
+  TEST_PCHECK(unlink(path.c_str()) == 0);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WriteTempRename)
+    ->Arg(0)
+    ->Arg(4096)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
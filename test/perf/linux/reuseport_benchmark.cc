@@ -0,0 +1,271 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Number of UDP sockets that BM_ReuseportRecv sends from. Each has its own
+// source port, so that their datagrams hash to different listeners.
+constexpr int kSenders = 64;
+
+// Size of each datagram sent by BM_ReuseportRecv.
+constexpr int kDatagramSize = 64;
+
+// How long to wait for data in flight after a benchmark run.
+constexpr absl::Duration kDrainTimeout = absl::Seconds(10);
+
+// Listeners is a group of SO_REUSEPORT sockets bound to the same loopback
+// port, each served by its own thread, which counts the connections it
+// accepts (SOCK_STREAM) or the datagrams it receives (SOCK_DGRAM).
+class Listeners {
+ public:
+  Listeners(int type, int n)
+      : type_(type), counts_(absl::make_unique<std::atomic<int64_t>[]>(n)) {
+    for (int i = 0; i < n; i++) {
+      FileDescriptor fd =
+          Socket(AF_INET, type | SOCK_NONBLOCK, 0).ValueOrDie();
+      TEST_PCHECK(setsockopt(fd.get(), SOL_SOCKET, SO_REUSEPORT, &kSockOptOn,
+                             sizeof(kSockOptOn)) == 0);
+      TEST_PCHECK(bind(fd.get(), reinterpret_cast<sockaddr*>(&addr_),
+                       sizeof(addr_)) == 0);
+      socklen_t addrlen = sizeof(addr_);
+      TEST_PCHECK(getsockname(fd.get(), reinterpret_cast<sockaddr*>(&addr_),
+                              &addrlen) == 0);
+      if (type == SOCK_STREAM) {
+        TEST_PCHECK(listen(fd.get(), SOMAXCONN) == 0);
+      }
+      fds_.push_back(std::move(fd));
+      counts_[i] = 0;
+    }
+    for (int i = 0; i < n; i++) {
+      threads_.push_back(
+          absl::make_unique<ScopedThread>([this, i] { Serve(i); }));
+    }
+  }
+
+  ~Listeners() {
+    stop_.store(true);
+    threads_.clear();
+  }
+
+  const sockaddr_in& addr() const { return addr_; }
+
+  // Counts returns the connections accepted or datagrams received by each
+  // listener.
+  std::vector<int64_t> Counts() const {
+    std::vector<int64_t> counts;
+    for (size_t i = 0; i < fds_.size(); i++) {
+      counts.push_back(counts_[i].load());
+    }
+    return counts;
+  }
+
+  // Total returns the sum of Counts.
+  int64_t Total() const {
+    int64_t total = 0;
+    for (int64_t count : Counts()) {
+      total += count;
+    }
+    return total;
+  }
+
+ private:
+  void Serve(int i) {
+    const int fd = fds_[i].get();
+    char buf[kDatagramSize];
+    while (!stop_.load()) {
+      struct pollfd pfd = {fd, POLLIN, 0};
+      if (RetryEINTR(poll)(&pfd, 1, 10) <= 0) {
+        continue;
+      }
+      while (true) {
+        int ret;
+        if (type_ == SOCK_STREAM) {
+          ret = accept(fd, nullptr, nullptr);
+          if (ret >= 0) {
+            close(ret);
+          }
+        } else {
+          ret = recv(fd, buf, sizeof(buf), 0);
+        }
+        if (ret < 0) {
+          TEST_PCHECK(errno == EAGAIN || errno == EINTR ||
+                      errno == ECONNABORTED);
+          break;
+        }
+        counts_[i]++;
+      }
+    }
+  }
+
+  const int type_;
+
+  // The bound address. The port is picked when the first socket binds.
+  sockaddr_in addr_ = {AF_INET, 0, {htonl(INADDR_LOOPBACK)}};
+  std::vector<FileDescriptor> fds_;
+  std::unique_ptr<std::atomic<int64_t>[]> counts_;
+  std::atomic<bool> stop_{false};
+
+  // Declared last, so that the threads are joined before the sockets close.
+  std::vector<std::unique_ptr<ScopedThread>> threads_;
+};
+
+// WaitForTotal waits until listeners have counted want items, or their total
+// stops growing for kDrainTimeout, and returns the total.
+int64_t WaitForTotal(const Listeners& listeners, int64_t want) {
+  int64_t total = listeners.Total();
+  absl::Time progress = absl::Now();
+  while (total < want && absl::Now() - progress < kDrainTimeout) {
+    absl::SleepFor(absl::Milliseconds(1));
+    const int64_t now = listeners.Total();
+    if (now != total) {
+      total = now;
+      progress = absl::Now();
+    }
+  }
+  return total;
+}
+
+// ReportDistribution reports how evenly counts are spread across listeners:
+//
+//   max_over_mean: the busiest listener's count over the mean count; 1 is a
+//     perfectly even spread, and n a spread where one of n listeners gets
+//     everything.
+//   cv: coefficient of variation of the counts.
+void ReportDistribution(benchmark::State& state,
+                        const std::vector<int64_t>& counts) {
+  double sum = 0;
+  double max = 0;
+  for (int64_t count : counts) {
+    sum += count;
+    max = std::max(max, static_cast<double>(count));
+  }
+  const double mean = sum / counts.size();
+  if (mean == 0) {
+    return;
+  }
+  double variance = 0;
+  for (int64_t count : counts) {
+    variance += (count - mean) * (count - mean);
+  }
+  variance /= counts.size();
+  state.counters["max_over_mean"] = max / mean;
+  state.counters["cv"] = std::sqrt(variance) / mean;
+}
+
+// BM_ReuseportAccept measures how TCP connections to state.range(0)
+// SO_REUSEPORT listeners, each with its own accept thread, are spread across
+// them, and the aggregate accept rate. Each iteration connects and resets
+// one connection from the benchmark thread, so that no ports are left in
+// TIME-WAIT.
+void BM_ReuseportAccept(benchmark::State& state) {
+  Listeners listeners(SOCK_STREAM, state.range(0));
+  const sockaddr_in addr = listeners.addr();
+  const struct linger linger = {1, 0};
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    FileDescriptor conn =
+        ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    TEST_PCHECK(RetryEINTR(connect)(conn.get(),
+                                    reinterpret_cast<const sockaddr*>(&addr),
+                                    sizeof(addr)) == 0);
+    TEST_PCHECK(setsockopt(conn.get(), SOL_SOCKET, SO_LINGER, &linger,
+                           sizeof(linger)) == 0);
+  }
+  const int64_t accepted = WaitForTotal(listeners, state.iterations());
+  if (accepted < static_cast<int64_t>(state.iterations())) {
+    state.SkipWithError("connections were not accepted");
+    return;
+  }
+
+  state.SetItemsProcessed(accepted);
+  ReportDistribution(state, listeners.Counts());
+}
+
+// BM_ReuseportRecv measures how UDP datagrams from kSenders source ports to
+// state.range(0) SO_REUSEPORT sockets, each with its own receive thread, are
+// spread across them, and the aggregate receive rate. Each iteration sends one
+// datagram. It also reports the fraction of datagrams dropped as loss_ratio.
+void BM_ReuseportRecv(benchmark::State& state) {
+  Listeners listeners(SOCK_DGRAM, state.range(0));
+  const sockaddr_in addr = listeners.addr();
+
+  std::vector<FileDescriptor> senders;
+  for (int i = 0; i < kSenders; i++) {
+    senders.push_back(
+        ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)));
+    TEST_PCHECK(connect(senders.back().get(),
+                        reinterpret_cast<const sockaddr*>(&addr),
+                        sizeof(addr)) == 0);
+  }
+
+  char buf[kDatagramSize] = {};
+  int i = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_PCHECK(RetryEINTR(send)(senders[i].get(), buf, sizeof(buf), 0) ==
+                sizeof(buf));
+    i = (i + 1) % kSenders;
+  }
+  const int64_t received = WaitForTotal(listeners, state.iterations());
+
+  state.SetItemsProcessed(received);
+  state.counters["loss_ratio"] =
+      1 - static_cast<double>(received) / state.iterations();
+  ReportDistribution(state, listeners.Counts());
+}
+
+// ListenerArgs runs with 1 to NumCPUs() listeners.
+void ListenerArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("listeners");
+  for (int n = 1; n < NumCPUs(); n *= 2) {
+    benchmark->Arg(n);
+  }
+  benchmark->Arg(NumCPUs());
+}
+
+BENCHMARK(BM_ReuseportAccept)->Apply(&ListenerArgs)->UseRealTime();
+BENCHMARK(BM_ReuseportRecv)->Apply(&ListenerArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
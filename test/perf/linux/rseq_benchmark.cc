@@ -0,0 +1,132 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/rseq/test.h"
+#include "test/util/cleanup.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/multiprocess_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Standalone rseq binary, which implements the benchmarked critical sections.
+// The benchmarks cannot run in this binary, because libc may already have
+// registered rseq.
+constexpr char kRseqBinary[] = "test/syscalls/linux/rseq/rseq";
+
+// Critical sections committed by each thread per iteration.
+constexpr int kOpsPerThread = 1 << 20;
+
+// BM_Rseq runs benchmark, one of the rseq binary's per-CPU benchmarks, with
+// state.range(0) threads. Each iteration is one run of the binary, timed by
+// the binary itself to exclude exec and thread creation. It reports commits
+// per second as items_per_second, and the fraction of critical sections that
+// were aborted as abort_ratio.
+void BM_Rseq(benchmark::State& state, const char* benchmark) {
+  const int threads = state.range(0);
+  const std::string path = RunfilePath(kRseqBinary);
+  const ExecveArray argv = {path, benchmark, absl::StrCat(threads),
+                            absl::StrCat(kOpsPerThread)};
+  const ExecveArray envv = {};
+
+  int64_t commits = 0;
+  int64_t aborts = 0;
+  for (auto _ : state) {
+    int pipe_fds[2];
+    TEST_PCHECK(pipe(pipe_fds) == 0);
+    FileDescriptor read_fd(pipe_fds[0]);
+    FileDescriptor write_fd(pipe_fds[1]);
+
+    // Send the binary's stdout to the pipe.
+    const auto remap_stdout = [&] {
+      if (dup2(pipe_fds[1], STDOUT_FILENO) < 0) {
+        _exit(errno);
+      }
+    };
+
+    pid_t child;
+    int execve_errno;
+    Cleanup kill = ASSERT_NO_ERRNO_AND_VALUE(
+        ForkAndExec(path, argv, envv, remap_stdout, &child, &execve_errno));
+    ASSERT_EQ(execve_errno, 0);
+    write_fd.reset();
+
+    std::string output;
+    char buf[64];
+    int n;
+    while ((n = ReadFd(read_fd.get(), buf, sizeof(buf))) > 0) {
+      output.append(buf, n);
+    }
+    TEST_PCHECK(n == 0);
+
+    int status;
+    TEST_PCHECK(RetryEINTR(waitpid)(child, &status, 0) == child);
+    kill.Release();
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      // Most likely, rseq is not supported.
+      state.SkipWithError(
+          absl::StrCat("rseq benchmark failed with status ", status).c_str());
+      return;
+    }
+
+    // "<commits> <aborts> <elapsed ns>\n"
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(output, absl::ByAnyChar(" \n"), absl::SkipEmpty());
+    int64_t run_commits, run_aborts, elapsed_ns;
+    TEST_CHECK(fields.size() == 3);
+    TEST_CHECK(absl::SimpleAtoi(fields[0], &run_commits) &&
+               absl::SimpleAtoi(fields[1], &run_aborts) &&
+               absl::SimpleAtoi(fields[2], &elapsed_ns));
+    commits += run_commits;
+    aborts += run_aborts;
+    state.SetIterationTime(elapsed_ns / 1e9);
+  }
+
+  state.SetItemsProcessed(commits);
+  if (commits + aborts > 0) {
+    state.counters["abort_ratio"] =
+        static_cast<double>(aborts) / static_cast<double>(commits + aborts);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_Rseq, percpu_counter, kRseqBenchPerCPUCounter)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseManualTime();
+BENCHMARK_CAPTURE(BM_Rseq, percpu_freelist, kRseqBenchPerCPUFreelist)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseManualTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
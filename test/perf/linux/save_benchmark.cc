@@ -0,0 +1,265 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/cleanup.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/rlimit_util.h"
+#include "test/util/save_util.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Kinds of state saved by BM_Save.
+enum class WorkingSet {
+  // state.range(0) MB of anonymous memory, of which state.range(1) percent is
+  // dirtied between saves.
+  kMemory,
+
+  // Like kMemory, with random contents, which the checkpoint's compression
+  // cannot shrink.
+  kRandomMemory,
+
+  // state.range(0) regular files, each with one page of data, held open.
+  kFiles,
+
+  // state.range(0) connected Unix domain socket pairs, each with one page of
+  // data queued.
+  kSockets,
+};
+
+// Size of the data in each file or socket.
+constexpr int kDataSize = 4096;
+
+// IsDirtyPage returns true if page i of a kMemory working set is dirtied
+// between saves, spreading dirty_pct percent of pages evenly over it.
+bool IsDirtyPage(size_t i, int dirty_pct) {
+  return i % 100 < static_cast<size_t>(dirty_pct);
+}
+
+// BM_Save measures a co-operative save and restore cycle, as performed by
+// MaybeSave, with the given working set. MaybeSave does not return until the
+// sandbox has been saved and restored, so the save and restore times are not
+// reported separately; nor are the bytes written, which are not visible to
+// the application. Instead, it reports:
+//
+//   working_set_bytes: the size of the application data in the working set.
+//   dirty_bytes: the application data written between consecutive saves.
+//
+// so that the cost can be compared against what an incremental save would
+// need to write.
+//
+// This requires GVISOR_COOPERATIVE_SAVE_TEST.
+void BM_Save(benchmark::State& state, WorkingSet set) {
+  if (!IsCooperativeSaveEnabled()) {
+    state.SkipWithError("co-operative save is not enabled");
+    return;
+  }
+
+  const int n = state.range(0);
+
+  Cleanup rlimit;
+  Mapping memory;
+  std::vector<TempPath> paths;
+  std::vector<FileDescriptor> fds;
+  int64_t working_set = 0;
+  int64_t dirty = 0;
+  switch (set) {
+    case WorkingSet::kMemory:
+    case WorkingSet::kRandomMemory: {
+      const size_t len = static_cast<size_t>(n) << 20;
+      memory = ASSERT_NO_ERRNO_AND_VALUE(
+          MmapAnon(len, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+      if (set == WorkingSet::kRandomMemory) {
+        RandomizeBuffer(memory.ptr(), len);
+      } else {
+        memset(memory.ptr(), 1, len);
+      }
+      working_set = len;
+      for (size_t i = 0; i < len / kPageSize; i++) {
+        if (IsDirtyPage(i, state.range(1))) {
+          dirty += kPageSize;
+        }
+      }
+      break;
+    }
+    case WorkingSet::kFiles: {
+      auto rlimit_or = ScopedSetSoftRlimit(RLIMIT_NOFILE, n + 64);
+      if (!rlimit_or.ok()) {
+        state.SkipWithError("RLIMIT_NOFILE too low");
+        return;
+      }
+      rlimit = std::move(rlimit_or).ValueOrDie();
+      const std::string contents(kDataSize, 'a');
+      for (int i = 0; i < n; i++) {
+        paths.push_back(ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+            GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode)));
+        fds.push_back(
+            ASSERT_NO_ERRNO_AND_VALUE(Open(paths.back().path(), O_RDWR)));
+      }
+      working_set = static_cast<int64_t>(n) * kDataSize;
+      break;
+    }
+    case WorkingSet::kSockets: {
+      auto rlimit_or = ScopedSetSoftRlimit(RLIMIT_NOFILE, 2 * n + 64);
+      if (!rlimit_or.ok()) {
+        state.SkipWithError("RLIMIT_NOFILE too low");
+        return;
+      }
+      rlimit = std::move(rlimit_or).ValueOrDie();
+      const std::string data(kDataSize, 'a');
+      for (int i = 0; i < n; i++) {
+        int sv[2];
+        TEST_PCHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+        fds.emplace_back(sv[0]);
+        fds.emplace_back(sv[1]);
+        TEST_PCHECK(WriteFd(sv[0], data.data(), data.size()) == kDataSize);
+      }
+      working_set = static_cast<int64_t>(n) * kDataSize;
+      break;
+    }
+  }
+
+  char value = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    if (dirty > 0) {
+      state.PauseTiming();
+      value++;
+      const size_t pages = memory.len() / kPageSize;
+      for (size_t i = 0; i < pages; i++) {
+        if (IsDirtyPage(i, state.range(1))) {
+          static_cast<char*>(memory.ptr())[i * kPageSize] = value;
+        }
+      }
+      state.ResumeTiming();
+    }
+    MaybeSave();
+  }
+
+  state.counters["working_set_bytes"] = working_set;
+  state.counters["dirty_bytes"] = dirty;
+}
+
+void MemoryArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"mb", "dirty_pct"});
+  for (int mb : {16, 256, 1024}) {
+    for (int dirty_pct : {0, 10, 100}) {
+      benchmark->Args({mb, dirty_pct});
+    }
+  }
+}
+
+BENCHMARK_CAPTURE(BM_Save, memory, WorkingSet::kMemory)
+    ->Apply(&MemoryArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Save, random_memory, WorkingSet::kRandomMemory)
+    ->Apply(&MemoryArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Save, files, WorkingSet::kFiles)
+    ->Range(16, 4096)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Save, sockets, WorkingSet::kSockets)
+    ->Range(16, 4096)
+    ->UseRealTime();
+
+// BM_RestoreLatency measures how soon the application can make progress after
+// a co-operative save and restore cycle with state.range(0) MB of dirty
+// anonymous memory. Each iteration rewrites the memory, then times MaybeSave,
+// the first syscall after it returns, and a read of every page. It reports:
+//
+//   save_restore_ns: the time spent in MaybeSave.
+//   first_syscall_ns: the latency of the first syscall after restore.
+//   touch_ns: the time to read one byte of every page after restore.
+//
+// With eager restore, memory is loaded before MaybeSave returns, so
+// save_restore_ns grows with the working set and touch_ns stays small. With
+// lazy restore, the cost moves to touch_ns, as pages are faulted in from the
+// image, while first_syscall_ns should stay flat.
+//
+// This requires GVISOR_COOPERATIVE_SAVE_TEST.
+void BM_RestoreLatency(benchmark::State& state) {
+  if (!IsCooperativeSaveEnabled()) {
+    state.SkipWithError("co-operative save is not enabled");
+    return;
+  }
+
+  const size_t len = static_cast<size_t>(state.range(0)) << 20;
+  const Mapping memory = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(len, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const mem = static_cast<char*>(memory.ptr());
+
+  int64_t save_restore_ns = 0;
+  int64_t first_syscall_ns = 0;
+  int64_t touch_ns = 0;
+  char value = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    // Zero pages are dropped on save, so write a non-zero value.
+    value = value == 'z' ? 'a' : 'z';
+    memset(mem, value, len);
+
+    const int64_t start = LatencyHistogram::Now();
+    MaybeSave();
+    const int64_t restored = LatencyHistogram::Now();
+    syscall(SYS_getpid);
+    const int64_t first_syscall = LatencyHistogram::Now();
+    char sum = 0;
+    for (size_t off = 0; off < len; off += kPageSize) {
+      sum += mem[off];
+    }
+    benchmark::DoNotOptimize(sum);
+    const int64_t touched = LatencyHistogram::Now();
+
+    save_restore_ns += restored - start;
+    first_syscall_ns += first_syscall - restored;
+    touch_ns += touched - first_syscall;
+    state.SetIterationTime((touched - start) / 1e9);
+  }
+
+  state.counters["save_restore_ns"] =
+      benchmark::Counter(save_restore_ns, benchmark::Counter::kAvgIterations);
+  state.counters["first_syscall_ns"] =
+      benchmark::Counter(first_syscall_ns, benchmark::Counter::kAvgIterations);
+  state.counters["touch_ns"] =
+      benchmark::Counter(touch_ns, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_RestoreLatency)->Range(16, 4096)->UseManualTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
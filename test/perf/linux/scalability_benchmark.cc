@@ -0,0 +1,139 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Workloads of BM_Scalability. Each thread works independently of the others,
+// so throughput should scale linearly with the number of threads up to the
+// number of CPUs; anything less indicates that the sandbox serializes
+// independent tasks.
+enum Workload {
+  // A loop that makes no syscalls and touches no shared memory, as in
+  // ConcurrencyTest.SingleProcessMultithreaded.
+  kCPU,
+
+  // A loop of cheap syscalls, which exercises the sentry's syscall path.
+  kSyscall,
+
+  // A loop of writes over a private buffer larger than typical per-core
+  // caches.
+  kMemory,
+
+  kNumWorkloads,
+};
+
+// The fraction of linear scaling below which a run is flagged as sub-linear.
+constexpr double kMinEfficiency = 0.75;
+
+// Single-thread throughput of each workload, in iterations per second, as
+// measured by the most recent single-thread run.
+double single_thread_rate[kNumWorkloads];
+
+// Do some CPU-bound busy-work.
+int Busy() {
+  // Prevent the compiler from optimizing this work away.
+  volatile int count = 0;
+  for (int i = 0; i < 1000; i++) {
+    count += i;
+  }
+  return count;
+}
+
+// BM_Scalability measures the throughput of the given workload run by each
+// thread. Besides the usual rates, it reports:
+//
+// speedup:    total throughput relative to the single-thread run.
+// efficiency: speedup divided by the number of threads.
+// sublinear:  the fraction of threads whose throughput is below
+//             kMinEfficiency of the single-thread run; non-zero values flag
+//             sub-linear scaling.
+//
+// The speedup curve is read across the thread counts of each workload.
+void BM_Scalability(benchmark::State& state, Workload workload) {
+  constexpr int kMemoryBytes = 8 << 20;
+  std::vector<char> buf(workload == kMemory ? kMemoryBytes : 0);
+  int64_t offset = 0;
+
+  const int64_t start = LatencyHistogram::Now();
+  for (auto _ : state) {
+    switch (workload) {
+      case kCPU:
+        benchmark::DoNotOptimize(Busy());
+        break;
+      case kSyscall:
+        syscall(SYS_getppid);
+        break;
+      case kMemory:
+        // Write one byte per cache line of a 4 KB block.
+        for (int i = 0; i < 4096; i += 64) {
+          buf[offset + i]++;
+        }
+        offset = (offset + 4096) % kMemoryBytes;
+        benchmark::ClobberMemory();
+        break;
+      default:
+        break;
+    }
+  }
+  const int64_t elapsed = LatencyHistogram::Now() - start;
+
+  state.SetItemsProcessed(state.iterations());
+  if (elapsed <= 0) {
+    return;
+  }
+  const double rate = state.iterations() * 1e9 / elapsed;
+  if (state.threads == 1) {
+    single_thread_rate[workload] = rate;
+  }
+  const double base = single_thread_rate[workload];
+  if (base <= 0) {
+    return;
+  }
+  // Counters are summed across threads by default, and averaged with
+  // kAvgThreads.
+  state.counters["speedup"] = benchmark::Counter(rate / base);
+  state.counters["efficiency"] =
+      benchmark::Counter(rate / base, benchmark::Counter::kAvgThreads);
+  state.counters["sublinear"] = benchmark::Counter(
+      rate / base < kMinEfficiency, benchmark::Counter::kAvgThreads);
+}
+
+BENCHMARK_CAPTURE(BM_Scalability, cpu, kCPU)
+    ->DenseThreadRange(1, NumCPUs())
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Scalability, syscall, kSyscall)
+    ->DenseThreadRange(1, NumCPUs())
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Scalability, memory, kMemory)
+    ->DenseThreadRange(1, NumCPUs())
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -12,11 +12,25 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <dlfcn.h>
 #include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
 #include "test/util/test_util.h"
+#include "test/util/thread_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -24,12 +38,133 @@ namespace testing {
 namespace {
 
 void BM_Sched_yield(benchmark::State& state) {
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    TEST_CHECK(sched_yield() == 0);
+  }
+}
+
+// Oversubscribed registers b with more threads than there are CPUs, so that
+// sched_yield(2) has other threads to run.
+void Oversubscribed(benchmark::internal::Benchmark* b) {
+  const int cpus = std::max(1u, std::thread::hardware_concurrency());
+  for (int threads = 2 * cpus; threads <= 2000; threads *= 4) {
+    b->Threads(threads);
+  }
+}
+
+// A single thread never has another thread to yield to.
+BENCHMARK(BM_Sched_yield)->Threads(1)->UseRealTime();
+BENCHMARK(BM_Sched_yield)->Apply(Oversubscribed)->UseRealTime();
+
+// VDSOSchedYield returns the sandbox VDSO's sched_yield, or nullptr if there
+// is no such function.
+//
+// libc never calls sched_yield in the VDSO, so applications that want to use
+// it look it up themselves.
+using SchedYieldFn = int (*)();
+SchedYieldFn VDSOSchedYield() {
+  void* vdso = dlopen("linux-vdso.so.1", RTLD_LAZY | RTLD_NOLOAD);
+  if (vdso == nullptr) {
+    return nullptr;
+  }
+#if defined(__x86_64__)
+  return reinterpret_cast<SchedYieldFn>(dlsym(vdso, "__vdso_sched_yield"));
+#elif defined(__aarch64__)
+  return reinterpret_cast<SchedYieldFn>(dlsym(vdso, "__kernel_sched_yield"));
+#else
+  return nullptr;
+#endif
+}
+
+// Yield using the VDSO, which returns without trapping to the sandbox kernel
+// if no task is waiting to run.
+void BM_VDSOSchedYield(benchmark::State& state) {
+  SchedYieldFn vdso_sched_yield = VDSOSchedYield();
+  if (vdso_sched_yield == nullptr) {
+    state.SkipWithError("requires the sandbox VDSO");
+    return;
+  }
+
+  ScopedRusageCounters rusage(state);
   for (auto ignored : state) {
+    TEST_CHECK(vdso_sched_yield() == 0);
+  }
+}
+
+BENCHMARK(BM_VDSOSchedYield)->Threads(1)->UseRealTime();
+BENCHMARK(BM_VDSOSchedYield)->Apply(Oversubscribed)->UseRealTime();
+
+// BM_YieldSwitch measures switches between state.range(0) tasks that all run
+// on the caller's CPU and do nothing but yield, so that each yield switches to
+// another task with as little other work as possible. If processes is true,
+// the tasks are processes and every switch is also an address space switch;
+// the difference from the equivalent threads is the cost of that switch,
+// which is otherwise hidden by the wakeups of BM_ProcessSwitch.
+void BM_YieldSwitch(benchmark::State& state, bool processes) {
+  const int num_tasks = state.range(0);
+
+  // Pin to the current CPU. Other tasks inherit the affinity.
+  cpu_set_t old_cpus;
+  TEST_PCHECK(sched_getaffinity(0, sizeof(old_cpus), &old_cpus) == 0);
+  const int cpu = sched_getcpu();
+  TEST_PCHECK(cpu >= 0);
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  TEST_PCHECK(sched_setaffinity(0, sizeof(cpus), &cpus) == 0);
+
+  // stop must be shared with child processes.
+  Mapping m = MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_SHARED)
+                  .ValueOrDie();
+  std::atomic<bool>* stop = new (m.ptr()) std::atomic<bool>(false);
+  auto yield_until_stopped = [stop] {
+    while (!stop->load(std::memory_order_relaxed)) {
+      sched_yield();
+    }
+  };
+
+  std::vector<pid_t> children;
+  std::vector<std::unique_ptr<ScopedThread>> threads;
+  for (int i = 1; i < num_tasks; i++) {
+    if (!processes) {
+      threads.push_back(std::make_unique<ScopedThread>(yield_until_stopped));
+      continue;
+    }
+    const pid_t child = fork();
+    if (child == 0) {
+      yield_until_stopped();
+      _exit(0);
+    }
+    TEST_PCHECK(child > 0);
+    children.push_back(child);
+  }
+
+  for (auto _ : state) {
     TEST_CHECK(sched_yield() == 0);
   }
+
+  stop->store(true);
+  threads.clear();
+  for (const pid_t child : children) {
+    int status;
+    TEST_PCHECK(RetryEINTR(waitpid)(child, &status, 0) == child);
+    TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+  TEST_PCHECK(sched_setaffinity(0, sizeof(old_cpus), &old_cpus) == 0);
+
+  // Each of the caller's yields lets every other task run once, so items are
+  // switches.
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_tasks);
 }
 
-BENCHMARK(BM_Sched_yield)->ThreadRange(1, 2000)->UseRealTime();
+BENCHMARK_CAPTURE(BM_YieldSwitch, processes, true)
+    ->Range(2, 32)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_YieldSwitch, threads, false)
+    ->Range(2, 32)
+    ->UseRealTime();
 
 }  // namespace
 
@@ -0,0 +1,94 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// BM_PassFDs measures the cost of passing state.range(0) file descriptors over
+// a unix stream socket pair in one SCM_RIGHTS control message. Each iteration
+// sends one message carrying the same descriptor state.range(0) times,
+// receives it, and closes the received descriptors.
+void BM_PassFDs(benchmark::State& state) {
+  const int nfds = state.range(0);
+
+  int sockets[2];
+  TEST_PCHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+  FileDescriptor send_socket(sockets[0]), recv_socket(sockets[1]);
+  const int fd = open("/dev/null", O_RDONLY);
+  TEST_PCHECK(fd >= 0);
+  FileDescriptor passed(fd);
+
+  const std::vector<int> send_fds(nfds, passed.get());
+  std::vector<char> send_control(CMSG_SPACE(nfds * sizeof(int)));
+  std::vector<char> recv_control(send_control.size());
+  char data = 'a';
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    struct iovec iov = {&data, sizeof(data)};
+    struct msghdr send_hdr = {};
+    send_hdr.msg_iov = &iov;
+    send_hdr.msg_iovlen = 1;
+    send_hdr.msg_control = send_control.data();
+    send_hdr.msg_controllen = send_control.size();
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&send_hdr);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(nfds * sizeof(int));
+    memcpy(CMSG_DATA(cmsg), send_fds.data(), nfds * sizeof(int));
+    TEST_PCHECK(RetryEINTR(sendmsg)(send_socket.get(), &send_hdr, 0) == 1);
+
+    struct msghdr recv_hdr = {};
+    recv_hdr.msg_iov = &iov;
+    recv_hdr.msg_iovlen = 1;
+    recv_hdr.msg_control = recv_control.data();
+    recv_hdr.msg_controllen = recv_control.size();
+    TEST_PCHECK(RetryEINTR(recvmsg)(recv_socket.get(), &recv_hdr, 0) == 1);
+    TEST_CHECK((recv_hdr.msg_flags & MSG_CTRUNC) == 0);
+
+    cmsg = CMSG_FIRSTHDR(&recv_hdr);
+    TEST_CHECK(cmsg != nullptr && cmsg->cmsg_type == SCM_RIGHTS &&
+               cmsg->cmsg_len == CMSG_LEN(nfds * sizeof(int)));
+    const int* recv_fds = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+    for (int i = 0; i < nfds; i++) {
+      TEST_PCHECK(close(recv_fds[i]) == 0);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * nfds);
+}
+
+// 253 is SCM_MAX_FD, the most descriptors Linux accepts in one message.
+BENCHMARK(BM_PassFDs)->ArgName("fds")->Arg(1)->Arg(16)->Arg(253)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
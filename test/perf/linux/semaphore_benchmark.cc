@@ -0,0 +1,102 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <sys/ipc.h>
+#include <sys/sem.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Number of semaphores in the set. Only the first 2*state.range(0) are used;
+// the rest make the set as large as those of database servers, which keep one
+// semaphore per backend process.
+constexpr int kSems = 1024;
+
+// BM_SemopPingPong measures semop(2) contention on one large set.
+//
+// Each of state.range(0) child processes owns two semaphores in the set. It
+// waits on the first one and then posts to the second one, forever. Each
+// iteration, the parent posts to every child's first semaphore with one
+// batched semop, and waits for every child's second semaphore with another.
+void BM_SemopPingPong(benchmark::State& state) {
+  const int children = state.range(0);
+
+  const int id = semget(IPC_PRIVATE, kSems, 0600 | IPC_CREAT);
+  TEST_PCHECK(id >= 0);
+
+  std::vector<pid_t> pids;
+  for (int i = 0; i < children; i++) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      struct sembuf wait = {};
+      wait.sem_num = 2 * i;
+      wait.sem_op = -1;
+      struct sembuf post = {};
+      post.sem_num = 2 * i + 1;
+      post.sem_op = 1;
+      // Run until the parent removes the set.
+      while (true) {
+        if (semop(id, &wait, 1) < 0 || semop(id, &post, 1) < 0) {
+          _exit(errno == EIDRM || errno == EINVAL ? 0 : 1);
+        }
+      }
+    }
+    TEST_PCHECK(pid > 0);
+    pids.push_back(pid);
+  }
+
+  std::vector<struct sembuf> posts(children);
+  std::vector<struct sembuf> waits(children);
+  for (int i = 0; i < children; i++) {
+    posts[i].sem_num = 2 * i;
+    posts[i].sem_op = 1;
+    waits[i].sem_num = 2 * i + 1;
+    waits[i].sem_op = -1;
+  }
+
+  for (auto _ : state) {
+    TEST_PCHECK(semop(id, posts.data(), posts.size()) == 0);
+    TEST_PCHECK(RetryEINTR(semop)(id, waits.data(), waits.size()) == 0);
+  }
+
+  TEST_PCHECK(semctl(id, 0, IPC_RMID) == 0);
+  for (const pid_t pid : pids) {
+    int status;
+    TEST_PCHECK(RetryEINTR(waitpid)(pid, &status, 0) == pid);
+    TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          children);
+}
+
+BENCHMARK(BM_SemopPingPong)->Range(1, 64)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
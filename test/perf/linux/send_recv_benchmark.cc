@@ -17,13 +17,19 @@
 #include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
+#include <atomic>
 #include <cstring>
+#include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/memory/memory.h"
 #include "absl/synchronization/notification.h"
 #include "benchmark/benchmark.h"
 #include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/file_descriptor.h"
 #include "test/util/logging.h"
 #include "test/util/posix_error.h"
@@ -78,8 +84,12 @@ void BM_Recvmsg(benchmark::State& state) {
   });
 
   int64_t bytes_received = 0;
+  LatencyHistogram latency;
+  ScopedRusageCounters rusage(state);
   for (auto ignored : state) {
+    const int64_t start = LatencyHistogram::Now();
     int n = recvmsg(recv_socket.get(), recv_msg.header(), 0);
+    latency.Record(LatencyHistogram::Now() - start);
     TEST_CHECK(n > 0);
     bytes_received += n;
   }
@@ -88,6 +98,7 @@ void BM_Recvmsg(benchmark::State& state) {
   recv_socket.reset();
 
   state.SetBytesProcessed(bytes_received);
+  latency.Report(state);
 }
 
 BENCHMARK(BM_Recvmsg)->UseRealTime();
@@ -106,6 +117,7 @@ void BM_Sendmsg(benchmark::State& state) {
   });
 
   int64_t bytes_sent = 0;
+  ScopedRusageCounters rusage(state);
   for (auto ignored : state) {
     int n = sendmsg(send_socket.get(), send_msg.header(), 0);
     TEST_CHECK(n > 0);
@@ -134,6 +146,7 @@ void BM_Recvfrom(benchmark::State& state) {
   });
 
   int bytes_received = 0;
+  ScopedRusageCounters rusage(state);
   for (auto ignored : state) {
     int n = recvfrom(recv_socket.get(), recv_buffer, kMessageSize, 0, nullptr,
                      nullptr);
@@ -164,6 +177,7 @@ void BM_Sendto(benchmark::State& state) {
   });
 
   int64_t bytes_sent = 0;
+  ScopedRusageCounters rusage(state);
   for (auto ignored : state) {
     int n = sendto(send_socket.get(), send_buffer, kMessageSize, 0, nullptr, 0);
     TEST_CHECK(n > 0);
@@ -245,6 +259,7 @@ void BM_RecvmsgWithControlBuf(benchmark::State& state) {
   });
 
   int64_t bytes_received = 0;
+  ScopedRusageCounters rusage(state);
   for (auto ignored : state) {
     int n = recvmsg(recv_socket.get(), recv_msg.header(), 0);
     TEST_CHECK(n > 0);
@@ -322,6 +337,7 @@ void BM_SendmsgTCP(benchmark::State& state) {
 
   int64_t bytes_sent = 0;
   int ncalls = 0;
+  ScopedRusageCounters rusage(state);
   for (auto ignored : state) {
     int sent = 0;
     while (true) {
@@ -366,6 +382,471 @@ void Args(benchmark::internal::Benchmark* benchmark) {
 
 BENCHMARK(BM_SendmsgTCP)->Apply(&Args)->UseRealTime();
 
+// BM_BulkTCP measures end-to-end bulk transfer throughput over a loopback TCP
+// connection whose MSS is clamped to state.range(0) bytes (0 leaves the
+// default MSS). Each iteration writes state.range(1) bytes, and the benchmark
+// only finishes once the receiver has read all of them.
+//
+// The stack processes one segment at a time unless it segments in bulk on send
+// (GSO) and coalesces on receive (GRO), so without offloads throughput falls
+// with the MSS. Comparing small MSS runs to the default MSS run, and runs with
+// runsc --gro and --software-gso enabled and disabled, shows how much of the
+// per-segment cost the offloads remove.
+void BM_BulkTCP(benchmark::State& state) {
+  const int mss = state.range(0);
+  const int chunk = state.range(1);
+
+  FileDescriptor listen_socket =
+      ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+  sockaddr_storage addr = ASSERT_NO_ERRNO_AND_VALUE(InetLoopbackAddr(AF_INET));
+  socklen_t addrlen = sizeof(struct sockaddr_in);
+  if (mss) {
+    ASSERT_THAT(setsockopt(listen_socket.get(), IPPROTO_TCP, TCP_MAXSEG, &mss,
+                           sizeof(mss)),
+                SyscallSucceeds());
+  }
+  ASSERT_THAT(bind(listen_socket.get(),
+                   reinterpret_cast<struct sockaddr*>(&addr), addrlen),
+              SyscallSucceeds());
+  ASSERT_THAT(listen(listen_socket.get(), SOMAXCONN), SyscallSucceeds());
+  ASSERT_THAT(getsockname(listen_socket.get(),
+                          reinterpret_cast<struct sockaddr*>(&addr), &addrlen),
+              SyscallSucceeds());
+
+  FileDescriptor send_socket =
+      ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+  if (mss) {
+    ASSERT_THAT(setsockopt(send_socket.get(), IPPROTO_TCP, TCP_MAXSEG, &mss,
+                           sizeof(mss)),
+                SyscallSucceeds());
+  }
+  ASSERT_THAT(
+      RetryEINTR(connect)(send_socket.get(),
+                          reinterpret_cast<struct sockaddr*>(&addr), addrlen),
+      SyscallSucceeds());
+  FileDescriptor recv_socket =
+      ASSERT_NO_ERRNO_AND_VALUE(Accept(listen_socket.get(), nullptr, nullptr));
+
+  // The receiver reads until the sender shuts down its end.
+  std::atomic<int64_t> bytes_received{0};
+  ScopedThread t([&recv_socket, &bytes_received, chunk] {
+    std::vector<char> buf(chunk);
+    while (true) {
+      int n = RetryEINTR(read)(recv_socket.get(), buf.data(), buf.size());
+      TEST_PCHECK(n >= 0);
+      if (n == 0) {
+        return;
+      }
+      bytes_received += n;
+    }
+  });
+
+  std::vector<char> buf(chunk, 'a');
+  int64_t bytes_sent = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    int sent = 0;
+    while (sent < chunk) {
+      int n = RetryEINTR(write)(send_socket.get(), buf.data() + sent,
+                                chunk - sent);
+      TEST_PCHECK(n > 0);
+      sent += n;
+    }
+    bytes_sent += sent;
+  }
+  ASSERT_THAT(shutdown(send_socket.get(), SHUT_WR), SyscallSucceeds());
+  t.Join();
+
+  TEST_CHECK(bytes_received.load() == bytes_sent);
+  state.SetBytesProcessed(bytes_sent);
+}
+
+void BulkArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"mss", "chunk"});
+  for (int mss : {536, 1460, 0}) {
+    for (int chunk = 64 << 10; chunk <= 4 << 20; chunk *= 4) {
+      benchmark->Args({mss, chunk});
+    }
+  }
+}
+
+BENCHMARK(BM_BulkTCP)->Apply(&BulkArgs)->UseRealTime();
+
+// StreamPair returns a connected pair of stream sockets: a UNIX domain socket
+// pair if domain is AF_UNIX, and a TCP connection over loopback otherwise.
+void StreamPair(int domain, FileDescriptor* a, FileDescriptor* b) {
+  if (domain == AF_UNIX) {
+    int sockets[2];
+    ASSERT_THAT(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets),
+                SyscallSucceeds());
+    *a = FileDescriptor(sockets[0]);
+    *b = FileDescriptor(sockets[1]);
+    return;
+  }
+
+  FileDescriptor listen_socket =
+      ASSERT_NO_ERRNO_AND_VALUE(Socket(domain, SOCK_STREAM, IPPROTO_TCP));
+  sockaddr_storage addr = ASSERT_NO_ERRNO_AND_VALUE(InetLoopbackAddr(domain));
+  socklen_t addrlen = domain == AF_INET ? sizeof(struct sockaddr_in)
+                                        : sizeof(struct sockaddr_in6);
+  ASSERT_THAT(bind(listen_socket.get(),
+                   reinterpret_cast<struct sockaddr*>(&addr), addrlen),
+              SyscallSucceeds());
+  ASSERT_THAT(listen(listen_socket.get(), SOMAXCONN), SyscallSucceeds());
+  ASSERT_THAT(getsockname(listen_socket.get(),
+                          reinterpret_cast<struct sockaddr*>(&addr), &addrlen),
+              SyscallSucceeds());
+
+  *a = ASSERT_NO_ERRNO_AND_VALUE(Socket(domain, SOCK_STREAM, IPPROTO_TCP));
+  ASSERT_THAT(RetryEINTR(connect)(
+                  a->get(), reinterpret_cast<struct sockaddr*>(&addr), addrlen),
+              SyscallSucceeds());
+  *b = ASSERT_NO_ERRNO_AND_VALUE(Accept(listen_socket.get(), nullptr, nullptr));
+
+  constexpr int kOne = 1;
+  for (const FileDescriptor* fd : {a, b}) {
+    ASSERT_THAT(setsockopt(fd->get(), IPPROTO_TCP, TCP_NODELAY, &kOne,
+                           sizeof(kOne)),
+                SyscallSucceeds());
+  }
+}
+
+// BM_StreamPingPong measures the round trip latency of state.range(1)-byte
+// messages echoed over a stream socket pair in domain state.range(0).
+//
+// Comparing AF_INET to AF_UNIX shows the cost of loopback TCP over the
+// equivalent UNIX domain socket, and comparing AF_INET runs with runsc
+// --tcp-loopback-inline enabled and disabled shows how much of that cost is
+// the handoff of each segment to a TCP processor goroutine.
+void BM_StreamPingPong(benchmark::State& state) {
+  const int domain = state.range(0);
+  const int size = state.range(1);
+
+  FileDescriptor client, server;
+  ASSERT_NO_FATAL_FAILURE(StreamPair(domain, &client, &server));
+
+  // The server echoes messages until the client shuts down its end.
+  ScopedThread t([&server, size] {
+    std::vector<char> buf(size);
+    while (true) {
+      int n = RetryEINTR(read)(server.get(), buf.data(), buf.size());
+      TEST_PCHECK(n >= 0);
+      if (n == 0) {
+        return;
+      }
+      TEST_PCHECK(WriteFd(server.get(), buf.data(), n) == n);
+    }
+  });
+
+  std::vector<char> buf(size, 'a');
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    TEST_PCHECK(WriteFd(client.get(), buf.data(), size) == size);
+    TEST_PCHECK(ReadFd(client.get(), buf.data(), size) == size);
+  }
+  ASSERT_THAT(shutdown(client.get(), SHUT_WR), SyscallSucceeds());
+  t.Join();
+
+  state.SetBytesProcessed(2 * static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+void PingPongArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"domain", "size"});
+  for (int domain : {AF_UNIX, AF_INET}) {
+    for (int size : {1, 1024, 16 << 10}) {
+      benchmark->Args({domain, size});
+    }
+  }
+}
+
+BENCHMARK(BM_StreamPingPong)->Apply(&PingPongArgs)->UseRealTime();
+
+// UDPPair returns a pair of UDP sockets on the loopback interface, with the
+// first connected to the second.
+PosixErrorOr<std::pair<FileDescriptor, FileDescriptor>> UDPPair() {
+  ASSIGN_OR_RETURN_ERRNO(FileDescriptor recv_socket,
+                         Socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+  ASSIGN_OR_RETURN_ERRNO(sockaddr_storage addr, InetLoopbackAddr(AF_INET));
+  socklen_t addrlen = sizeof(struct sockaddr_in);
+  RETURN_ERROR_IF_SYSCALL_FAIL(
+      bind(recv_socket.get(), reinterpret_cast<struct sockaddr*>(&addr),
+           addrlen));
+  RETURN_ERROR_IF_SYSCALL_FAIL(
+      getsockname(recv_socket.get(), reinterpret_cast<struct sockaddr*>(&addr),
+                  &addrlen));
+
+  ASSIGN_OR_RETURN_ERRNO(FileDescriptor send_socket,
+                         Socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+  RETURN_ERROR_IF_SYSCALL_FAIL(
+      connect(send_socket.get(), reinterpret_cast<struct sockaddr*>(&addr),
+              addrlen));
+  return std::make_pair(std::move(send_socket), std::move(recv_socket));
+}
+
+// MessageBatch is a batch of kMessageSize messages for sendmmsg and recvmmsg.
+class MessageBatch {
+ public:
+  MessageBatch(int byte, int n) : buffer_(n * kMessageSize, byte), iov_(n) {
+    hdrs_.resize(n);
+    for (int i = 0; i < n; i++) {
+      iov_[i].iov_base = &buffer_[i * kMessageSize];
+      iov_[i].iov_len = kMessageSize;
+      hdrs_[i].msg_hdr.msg_iov = &iov_[i];
+      hdrs_[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  struct mmsghdr* headers() {
+    return hdrs_.data();
+  }
+
+ private:
+  std::vector<char> buffer_;
+  std::vector<struct iovec> iov_;
+  std::vector<struct mmsghdr> hdrs_;
+};
+
+// DrainUntil reads from fd until notification is notified. Waiting for data
+// with a timeout ensures that it notices the notification even if the peer
+// has stopped sending.
+void DrainUntil(int fd, struct mmsghdr* hdrs, int n,
+                absl::Notification* notification) {
+  while (!notification->HasBeenNotified()) {
+    struct pollfd poll_fd = {fd, POLLIN, 0};
+    if (RetryEINTR(poll)(&poll_fd, 1, 10) > 0) {
+      recvmmsg(fd, hdrs, n, MSG_DONTWAIT, nullptr);
+    }
+  }
+}
+
+// BM_Sendmmsg measures the sendmmsg throughput of UDP datagrams, with
+// state.range(0) messages per call.
+void BM_Sendmmsg(benchmark::State& state) {
+  auto sockets = ASSERT_NO_ERRNO_AND_VALUE(UDPPair());
+  FileDescriptor send_socket = std::move(sockets.first);
+  FileDescriptor recv_socket = std::move(sockets.second);
+  const int batch = state.range(0);
+  absl::Notification notification;
+  MessageBatch send_msgs('a', batch), recv_msgs(0, batch);
+
+  ScopedThread t([&recv_msgs, &recv_socket, &notification, batch] {
+    DrainUntil(recv_socket.get(), recv_msgs.headers(), batch, &notification);
+  });
+
+  int64_t messages_sent = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    int n = sendmmsg(send_socket.get(), send_msgs.headers(), batch, 0);
+    TEST_CHECK(n > 0);
+    messages_sent += n;
+  }
+
+  notification.Notify();
+  t.Join();
+
+  state.SetItemsProcessed(messages_sent);
+  state.SetBytesProcessed(messages_sent * kMessageSize);
+}
+
+BENCHMARK(BM_Sendmmsg)->RangeMultiplier(4)->Range(1, 1024)->UseRealTime();
+
+// BM_Recvmmsg measures the recvmmsg throughput of UDP datagrams, with up to
+// state.range(0) messages per call.
+void BM_Recvmmsg(benchmark::State& state) {
+  auto sockets = ASSERT_NO_ERRNO_AND_VALUE(UDPPair());
+  FileDescriptor send_socket = std::move(sockets.first);
+  FileDescriptor recv_socket = std::move(sockets.second);
+  const int batch = state.range(0);
+  absl::Notification notification;
+  MessageBatch send_msgs('a', batch), recv_msgs(0, batch);
+
+  ScopedThread t([&send_msgs, &send_socket, &notification, batch] {
+    while (!notification.HasBeenNotified()) {
+      sendmmsg(send_socket.get(), send_msgs.headers(), batch, 0);
+    }
+  });
+
+  int64_t messages_received = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    // MSG_WAITFORONE returns whatever has been queued once the first message
+    // arrives, since the sender may drop datagrams when the receive buffer is
+    // full.
+    int n = recvmmsg(recv_socket.get(), recv_msgs.headers(), batch,
+                     MSG_WAITFORONE, nullptr);
+    TEST_CHECK(n > 0);
+    messages_received += n;
+  }
+
+  notification.Notify();
+  t.Join();
+
+  state.SetItemsProcessed(messages_received);
+  state.SetBytesProcessed(messages_received * kMessageSize);
+}
+
+BENCHMARK(BM_Recvmmsg)->RangeMultiplier(4)->Range(1, 1024)->UseRealTime();
+
+// Number of messages each sender passes to sendmmsg in BM_RecvmmsgManyToOne.
+constexpr int kManyToOneBatch = 64;
+
+// BM_RecvmmsgManyToOne measures the recvmmsg throughput of one UDP socket
+// receiving kMessageSize datagrams from state.range(0) sender threads, each
+// with its own socket and sending kManyToOneBatch datagrams per sendmmsg call.
+// All senders contend with each other and with the receiver on the receiving
+// socket's queue.
+void BM_RecvmmsgManyToOne(benchmark::State& state) {
+  const int nsenders = state.range(0);
+  FileDescriptor recv_socket =
+      ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+  sockaddr_storage addr = ASSERT_NO_ERRNO_AND_VALUE(InetLoopbackAddr(AF_INET));
+  socklen_t addrlen = sizeof(struct sockaddr_in);
+  ASSERT_THAT(bind(recv_socket.get(),
+                   reinterpret_cast<struct sockaddr*>(&addr), addrlen),
+              SyscallSucceeds());
+  ASSERT_THAT(getsockname(recv_socket.get(),
+                          reinterpret_cast<struct sockaddr*>(&addr), &addrlen),
+              SyscallSucceeds());
+
+  absl::Notification notification;
+  std::atomic<int64_t> messages_sent{0};
+  std::vector<FileDescriptor> send_sockets;
+  std::vector<std::unique_ptr<ScopedThread>> senders;
+  for (int i = 0; i < nsenders; i++) {
+    send_sockets.push_back(
+        ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)));
+    const int fd = send_sockets.back().get();
+    ASSERT_THAT(
+        connect(fd, reinterpret_cast<struct sockaddr*>(&addr), addrlen),
+        SyscallSucceeds());
+    senders.push_back(absl::make_unique<ScopedThread>(
+        [fd, &notification, &messages_sent] {
+          MessageBatch send_msgs('a', kManyToOneBatch);
+          while (!notification.HasBeenNotified()) {
+            int n = sendmmsg(fd, send_msgs.headers(), kManyToOneBatch,
+                             MSG_DONTWAIT);
+            if (n > 0) {
+              messages_sent += n;
+            }
+          }
+        }));
+  }
+
+  MessageBatch recv_msgs(0, kManyToOneBatch);
+  int64_t messages_received = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    int n = recvmmsg(recv_socket.get(), recv_msgs.headers(), kManyToOneBatch,
+                     MSG_WAITFORONE, nullptr);
+    TEST_CHECK(n > 0);
+    messages_received += n;
+  }
+
+  notification.Notify();
+  senders.clear();
+
+  state.SetItemsProcessed(messages_received);
+  state.SetBytesProcessed(messages_received * kMessageSize);
+  state.counters["loss_ratio"] =
+      1 - static_cast<double>(messages_received) / messages_sent.load();
+}
+
+void ManyToOneArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("senders");
+  for (int n = 1; n < NumCPUs(); n *= 2) {
+    benchmark->Arg(n);
+  }
+  benchmark->Arg(NumCPUs());
+}
+
+BENCHMARK(BM_RecvmmsgManyToOne)->Apply(&ManyToOneArgs)->UseRealTime();
+
+// Total bytes transferred per readv/writev iteration.
+constexpr uint64_t kVectorSize = 64 << 10;
+
+// BM_Writev measures writev throughput on a stream socket with kVectorSize
+// bytes split into state.range(0) byte fragments.
+void BM_Writev(benchmark::State& state) {
+  int sockets[2];
+  TEST_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+  FileDescriptor send_socket(sockets[0]), recv_socket(sockets[1]);
+  absl::Notification notification;
+
+  const int fragment_size = state.range(0);
+  std::vector<char> send_buffer(fragment_size, 'a');
+  const std::vector<std::vector<struct iovec>> iovecs_list =
+      GenerateIovecs(kVectorSize, send_buffer.data(), send_buffer.size());
+
+  ScopedThread t([&recv_socket, &notification] {
+    std::vector<char> recv_buffer(kVectorSize);
+    while (!notification.HasBeenNotified()) {
+      if (read(recv_socket.get(), recv_buffer.data(), recv_buffer.size()) <=
+          0) {
+        break;
+      }
+    }
+  });
+
+  int64_t bytes_sent = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    for (const auto& iovecs : iovecs_list) {
+      int n = writev(send_socket.get(), iovecs.data(), iovecs.size());
+      TEST_CHECK(n > 0);
+      bytes_sent += n;
+    }
+  }
+
+  notification.Notify();
+  send_socket.reset();
+
+  state.SetBytesProcessed(bytes_sent);
+}
+
+BENCHMARK(BM_Writev)->Range(64, 4096)->UseRealTime();
+
+// BM_Readv measures readv throughput on a stream socket into kVectorSize
+// bytes split into state.range(0) byte fragments.
+void BM_Readv(benchmark::State& state) {
+  int sockets[2];
+  TEST_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+  FileDescriptor send_socket(sockets[0]), recv_socket(sockets[1]);
+  absl::Notification notification;
+
+  const int fragment_size = state.range(0);
+  std::vector<char> recv_buffer(fragment_size);
+  const std::vector<std::vector<struct iovec>> iovecs_list =
+      GenerateIovecs(kVectorSize, recv_buffer.data(), recv_buffer.size());
+
+  ScopedThread t([&send_socket, &notification] {
+    std::vector<char> send_buffer(kVectorSize, 'a');
+    while (!notification.HasBeenNotified()) {
+      if (write(send_socket.get(), send_buffer.data(), send_buffer.size()) <=
+          0) {
+        break;
+      }
+    }
+  });
+
+  int64_t bytes_received = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    for (const auto& iovecs : iovecs_list) {
+      int n = readv(recv_socket.get(), iovecs.data(), iovecs.size());
+      TEST_CHECK(n > 0);
+      bytes_received += n;
+    }
+  }
+
+  notification.Notify();
+  recv_socket.reset();
+
+  state.SetBytesProcessed(bytes_received);
+}
+
+BENCHMARK(BM_Readv)->Range(64, 4096)->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
@@ -19,6 +19,7 @@
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/logging.h"
 #include "test/util/temp_path.h"
 #include "test/util/test_util.h"
@@ -44,6 +45,7 @@ void BM_SeqWrite(benchmark::State& state) {
 
   // Start writes at offset 0.
   uint64_t offset = 0;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     TEST_CHECK(PwriteFd(fd.get(), buf.data(), buf.size(), offset) ==
                buf.size());
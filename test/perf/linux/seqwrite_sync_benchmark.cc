@@ -0,0 +1,122 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// The size at which the test file is truncated to start over, outside of the
+// timed region.
+constexpr off_t kMaxFile = 256 << 20;
+
+// How BM_AppendSync syncs the file.
+enum class Sync {
+  // fsync(2).
+  kFsync,
+
+  // fdatasync(2).
+  kFdatasync,
+
+  // sync_file_range(SYNC_FILE_RANGE_WRITE) of the records appended since the
+  // last sync, which starts writing them back without waiting, as done by
+  // storage engines to smooth out the cost of a later fsync.
+  kSyncFileRange,
+};
+
+// BM_AppendSync measures appending state.range(0)-byte records to a file, as
+// done by write-ahead logs and log-structured storage, syncing it after every
+// state.range(1) records.
+void BM_AppendSync(benchmark::State& state, Sync sync) {
+  const int size = state.range(0);
+  const int interval = state.range(1);
+  auto f = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(f.path(), O_WRONLY | O_APPEND));
+
+  std::vector<char> buf(size);
+  RandomizeBuffer(buf.data(), buf.size());
+
+  off_t offset = 0;
+  off_t synced = 0;
+  int64_t records = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(WriteFd(fd.get(), buf.data(), buf.size()) == size);
+    offset += size;
+    if (++records % interval == 0) {
+      switch (sync) {
+        case Sync::kFsync:
+          TEST_PCHECK(fsync(fd.get()) == 0);
+          break;
+        case Sync::kFdatasync:
+          TEST_PCHECK(fdatasync(fd.get()) == 0);
+          break;
+        case Sync::kSyncFileRange:
+          TEST_PCHECK(sync_file_range(fd.get(), synced, offset - synced,
+                                      SYNC_FILE_RANGE_WRITE) == 0);
+          break;
+      }
+      synced = offset;
+    }
+    if (offset >= kMaxFile) {
+      state.PauseTiming();
+      TEST_PCHECK(ftruncate(fd.get(), 0) == 0);
+      offset = 0;
+      synced = 0;
+      state.ResumeTiming();
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+void AppendSyncArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"size", "interval"});
+  for (int size : {64, 512, 4096}) {
+    for (int interval : {1, 16, 256}) {
+      benchmark->Args({size, interval});
+    }
+  }
+}
+
+BENCHMARK_CAPTURE(BM_AppendSync, fsync, Sync::kFsync)
+    ->Apply(&AppendSyncArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_AppendSync, fdatasync, Sync::kFdatasync)
+    ->Apply(&AppendSyncArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_AppendSync, sync_file_range, Sync::kSyncFileRange)
+    ->Apply(&AppendSyncArgs)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
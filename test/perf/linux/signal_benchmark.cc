@@ -13,10 +13,18 @@
 // limitations under the License.
 
 #include <signal.h>
+#include <stdint.h>
 #include <string.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/logging.h"
 #include "test/util/test_util.h"
 
@@ -33,15 +41,44 @@ void FixupHandler(int sig, siginfo_t* si, void* void_ctx) {
   ctx->uc_mcontext.gregs[REG_RAX] = reinterpret_cast<greg_t>(&dataval);
 }
 
+// SetupAltStack installs an alternate signal stack if use_altstack is set,
+// as the Go runtime does for all of its handlers. It returns the previous
+// alternate stack.
+stack_t SetupAltStack(bool use_altstack, std::vector<char>* mem) {
+  stack_t old_stack = {};
+  if (use_altstack) {
+    mem->resize(SIGSTKSZ);
+    stack_t stack = {};
+    stack.ss_sp = mem->data();
+    stack.ss_size = mem->size();
+    TEST_CHECK(sigaltstack(&stack, &old_stack) == 0);
+  }
+  return old_stack;
+}
+
+void RestoreAltStack(bool use_altstack, const stack_t& old_stack) {
+  if (use_altstack) {
+    TEST_CHECK(sigaltstack(&old_stack, nullptr) == 0);
+  }
+}
+
+// BM_FaultSignalFixup measures a fault, signal delivery and sigreturn.
+//
+// If state.range(0) is set, the handler runs on an alternate signal stack.
 void BM_FaultSignalFixup(benchmark::State& state) {
+  const bool use_altstack = state.range(0);
+  std::vector<char> altstack;
+  stack_t old_stack = SetupAltStack(use_altstack, &altstack);
+
   // Set up the signal handler.
   struct sigaction sa = {};
   sigemptyset(&sa.sa_mask);
   sa.sa_sigaction = FixupHandler;
-  sa.sa_flags = SA_SIGINFO;
+  sa.sa_flags = SA_SIGINFO | (use_altstack ? SA_ONSTACK : 0);
   TEST_CHECK(sigaction(SIGSEGV, &sa, nullptr) == 0);
 
   // Fault, fault, fault.
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     // Trigger the segfault.
     asm volatile(
@@ -51,9 +88,152 @@ void BM_FaultSignalFixup(benchmark::State& state) {
         :
         : "rax");
   }
+
+  RestoreAltStack(use_altstack, old_stack);
+}
+
+BENCHMARK(BM_FaultSignalFixup)->Arg(0)->Arg(1)->UseRealTime();
+
+void NopHandler(int sig, siginfo_t* si, void* void_ctx) {}
+
+// BM_SignalRoundTrip measures delivery of a signal sent by a thread to itself
+// and the return from its handler, without a fault.
+//
+// If state.range(0) is set, the handler runs on an alternate signal stack.
+void BM_SignalRoundTrip(benchmark::State& state) {
+  const bool use_altstack = state.range(0);
+  std::vector<char> altstack;
+  stack_t old_stack = SetupAltStack(use_altstack, &altstack);
+
+  struct sigaction sa = {};
+  sigemptyset(&sa.sa_mask);
+  sa.sa_sigaction = NopHandler;
+  sa.sa_flags = SA_SIGINFO | (use_altstack ? SA_ONSTACK : 0);
+  struct sigaction old_sa;
+  TEST_CHECK(sigaction(SIGUSR1, &sa, &old_sa) == 0);
+
+  const pid_t pid = getpid();
+  const pid_t tid = syscall(SYS_gettid);
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    // The signal is delivered before tgkill returns to userspace.
+    TEST_CHECK(syscall(SYS_tgkill, pid, tid, SIGUSR1) == 0);
+  }
+
+  TEST_CHECK(sigaction(SIGUSR1, &old_sa, nullptr) == 0);
+  RestoreAltStack(use_altstack, old_stack);
+}
+
+BENCHMARK(BM_SignalRoundTrip)->Arg(0)->Arg(1)->UseRealTime();
+
+int64_t NowNanos() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// handler_entered is the time at which TimestampHandler last ran.
+volatile int64_t handler_entered;
+
+void TimestampHandler(int sig, siginfo_t* si, void* void_ctx) {
+  handler_entered = NowNanos();
+}
+
+// BM_TgkillLatency measures the time from a thread sending a signal to itself
+// with tgkill(2) to the signal's handler being entered. The mean is reported
+// as the latency_ns counter.
+void BM_TgkillLatency(benchmark::State& state) {
+  struct sigaction sa = {};
+  sigemptyset(&sa.sa_mask);
+  sa.sa_sigaction = TimestampHandler;
+  sa.sa_flags = SA_SIGINFO;
+  struct sigaction old_sa;
+  TEST_CHECK(sigaction(SIGUSR1, &sa, &old_sa) == 0);
+
+  const pid_t pid = getpid();
+  const pid_t tid = syscall(SYS_gettid);
+  int64_t latency = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    const int64_t sent = NowNanos();
+    TEST_CHECK(syscall(SYS_tgkill, pid, tid, SIGUSR1) == 0);
+    latency += handler_entered - sent;
+  }
+
+  TEST_CHECK(sigaction(SIGUSR1, &old_sa, nullptr) == 0);
+  state.counters["latency_ns"] =
+      benchmark::Counter(latency, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_TgkillLatency)->UseRealTime();
+
+// Ways in which BM_DrainQueuedSignals dequeues signals.
+enum class Drain {
+  // read(2) of a signalfd with room for every queued signal.
+  kSignalfd,
+
+  // sigtimedwait(2) with a zero timeout, one signal at a time.
+  kSigtimedwait,
+};
+
+// kDrainSignals is the number of realtime signals over which
+// BM_DrainQueuedSignals spreads its queued signals, so that no signal's queue
+// overflows.
+constexpr int kDrainSignals = 8;
+
+// BM_DrainQueuedSignals measures queueing state.range(0) blocked realtime
+// signals and then dequeueing all of them, as an event loop handling a burst
+// of signals would.
+void BM_DrainQueuedSignals(benchmark::State& state, Drain how) {
+  const int count = state.range(0);
+  sigset_t set;
+  sigemptyset(&set);
+  for (int i = 0; i < kDrainSignals; i++) {
+    sigaddset(&set, SIGRTMIN + i);
+  }
+  sigset_t old_set;
+  TEST_PCHECK(sigprocmask(SIG_BLOCK, &set, &old_set) == 0);
+  const int fd = signalfd(-1, &set, SFD_NONBLOCK);
+  TEST_PCHECK(fd >= 0);
+  std::vector<struct signalfd_siginfo> buf(count);
+  const struct timespec zero = {};
+
+  const pid_t pid = getpid();
+  const pid_t tid = syscall(SYS_gettid);
+  for (auto _ : state) {
+    for (int i = 0; i < count; i++) {
+      TEST_PCHECK(syscall(SYS_tgkill, pid, tid,
+                          SIGRTMIN + i % kDrainSignals) == 0);
+    }
+    switch (how) {
+      case Drain::kSignalfd:
+        for (int left = count; left > 0;) {
+          const ssize_t n = read(fd, buf.data(), buf.size() * sizeof(buf[0]));
+          TEST_PCHECK(n > 0);
+          left -= n / sizeof(buf[0]);
+        }
+        break;
+      case Drain::kSigtimedwait:
+        for (int i = 0; i < count; i++) {
+          TEST_PCHECK(sigtimedwait(&set, nullptr, &zero) > 0);
+        }
+        break;
+    }
+  }
+
+  TEST_PCHECK(close(fd) == 0);
+  TEST_PCHECK(sigprocmask(SIG_SETMASK, &old_set, nullptr) == 0);
+  state.SetItemsProcessed(static_cast<int64_t>(count) * state.iterations());
 }
 
-BENCHMARK(BM_FaultSignalFixup)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DrainQueuedSignals, signalfd, Drain::kSignalfd)
+    ->RangeMultiplier(4)
+    ->Range(1, 256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_DrainQueuedSignals, sigtimedwait, Drain::kSigtimedwait)
+    ->RangeMultiplier(4)
+    ->Range(1, 256)
+    ->UseRealTime();
 
 }  // namespace
 
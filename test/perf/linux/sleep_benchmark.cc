@@ -12,13 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <dlfcn.h>
 #include <errno.h>
+#include <stdint.h>
+#include <sys/prctl.h>
 #include <sys/syscall.h>
 #include <time.h>
 #include <unistd.h>
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/logging.h"
 
 namespace gvisor {
@@ -26,15 +30,34 @@ namespace testing {
 
 namespace {
 
-// Sleep for 'param' nanoseconds.
+int64_t NowNanos() {
+  struct timespec ts;
+  TEST_PCHECK(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Sleep for state.range(0) nanoseconds with a timer slack of state.range(1)
+// nanoseconds (see prctl(2), PR_SET_TIMERSLACK), or the default slack if
+// state.range(1) is 0. The mean time by which each sleep overran is reported
+// as the jitter_ns counter.
 void BM_Sleep(benchmark::State& state) {
   const int nanoseconds = state.range(0);
+  const int slack = state.range(1);
+
+  const int old_slack = prctl(PR_GET_TIMERSLACK);
+  TEST_PCHECK(old_slack >= 0);
+  if (slack != 0) {
+    TEST_PCHECK(prctl(PR_SET_TIMERSLACK, slack) == 0);
+  }
 
+  int64_t late = 0;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     struct timespec ts;
     ts.tv_sec = 0;
     ts.tv_nsec = nanoseconds;
 
+    const int64_t start = NowNanos();
     int ret;
     do {
       ret = syscall(SYS_nanosleep, &ts, &ts);
@@ -42,16 +65,88 @@ void BM_Sleep(benchmark::State& state) {
         TEST_CHECK(errno == EINTR);
       }
     } while (ret < 0);
+    late += NowNanos() - start - nanoseconds;
+  }
+
+  TEST_PCHECK(prctl(PR_SET_TIMERSLACK, old_slack) == 0);
+  state.counters["jitter_ns"] =
+      benchmark::Counter(late, benchmark::Counter::kAvgIterations);
+}
+
+void SleepArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"ns", "slack"});
+  for (int nanoseconds : {
+           0,
+           1,
+           1000,              // 1us
+           1000 * 1000,       // 1ms
+           10 * 1000 * 1000,  // 10ms
+           50 * 1000 * 1000,  // 50ms
+       }) {
+    for (int slack : {
+             0,            // Default slack.
+             1,            // Minimum slack.
+             1000 * 1000,  // 1ms
+         }) {
+      bench->Args({nanoseconds, slack});
+    }
+  }
+}
+
+BENCHMARK(BM_Sleep)->Apply(SleepArgs)->UseRealTime();
+
+// VDSONanosleep returns the sandbox VDSO's nanosleep, or nullptr if there is
+// no such function.
+//
+// libc never calls nanosleep in the VDSO, so applications that want to use it
+// look it up themselves.
+using NanosleepFn = int (*)(const struct timespec*, struct timespec*);
+NanosleepFn VDSONanosleep() {
+  void* vdso = dlopen("linux-vdso.so.1", RTLD_LAZY | RTLD_NOLOAD);
+  if (vdso == nullptr) {
+    return nullptr;
+  }
+#if defined(__x86_64__)
+  return reinterpret_cast<NanosleepFn>(dlsym(vdso, "__vdso_nanosleep"));
+#elif defined(__aarch64__)
+  return reinterpret_cast<NanosleepFn>(dlsym(vdso, "__kernel_nanosleep"));
+#else
+  return nullptr;
+#endif
+}
+
+// Sleep for 'param' nanoseconds using the VDSO, which spins rather than trap
+// to the sandbox kernel for short sleeps if --vdso-spin-sleep is set.
+void BM_VDSOSleep(benchmark::State& state) {
+  const int nanoseconds = state.range(0);
+  NanosleepFn vdso_nanosleep = VDSONanosleep();
+  if (vdso_nanosleep == nullptr) {
+    state.SkipWithError("requires the sandbox VDSO");
+    return;
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    struct timespec ts;
+    ts.tv_sec = 0;
+    ts.tv_nsec = nanoseconds;
+
+    int ret;
+    do {
+      // Like the system call, this returns a negated errno.
+      ret = vdso_nanosleep(&ts, &ts);
+      TEST_CHECK(ret == 0 || ret == -EINTR);
+    } while (ret < 0);
   }
 }
 
-BENCHMARK(BM_Sleep)
+BENCHMARK(BM_VDSOSleep)
     ->Arg(0)
     ->Arg(1)
     ->Arg(1000)              // 1us
+    ->Arg(10 * 1000)         // 10us
+    ->Arg(50 * 1000)         // 50us
     ->Arg(1000 * 1000)       // 1ms
-    ->Arg(10 * 1000 * 1000)  // 10ms
-    ->Arg(50 * 1000 * 1000)  // 50ms
     ->UseRealTime();
 
 }  // namespace
@@ -0,0 +1,304 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/flags/flag.h"
+#include "absl/random/random.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/epoll_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+ABSL_FLAG(std::string, soup_mix,
+          "open=1,stat=4,read=8,write=4,epoll_wait=4,futex=4,mmap=1",
+          "comma-separated op=weight list for BM_SyscallSoup; ops are open, "
+          "stat, read, write, epoll_wait, futex and mmap");
+ABSL_FLAG(std::string, soup_profile, "",
+          "file with the BM_SyscallSoup mix, overriding --soup_mix; either "
+          "'op weight' lines, or the summary table of strace -c, in which "
+          "case syscalls are weighted by their call counts");
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Operations replayed by BM_SyscallSoup.
+enum Op {
+  kOpen,
+  kStat,
+  kRead,
+  kWrite,
+  kEpollWait,
+  kFutex,
+  kMmap,
+  kNumOps,
+};
+
+constexpr const char* kOpNames[kNumOps] = {
+    "open", "stat", "read", "write", "epoll_wait", "futex", "mmap",
+};
+
+// Number of files shared by all threads for open and stat.
+constexpr int kSharedFiles = 64;
+
+// Size of each read and write.
+constexpr int kIOSize = 4096;
+
+// Size of each thread's file used for reads and writes.
+constexpr int kFileSize = 1 << 20;
+
+// OpForName returns the op for name, which is either an op name or a syscall
+// that maps to it, or kNumOps if there is no such op.
+Op OpForName(absl::string_view name) {
+  for (int op = 0; op < kNumOps; op++) {
+    if (name == kOpNames[op]) {
+      return static_cast<Op>(op);
+    }
+  }
+  if (name == "openat" || name == "creat") {
+    return kOpen;
+  }
+  if (name == "fstat" || name == "lstat" || name == "newfstatat" ||
+      name == "statx") {
+    return kStat;
+  }
+  if (name == "pread64" || name == "readv" || name == "preadv") {
+    return kRead;
+  }
+  if (name == "pwrite64" || name == "writev" || name == "pwritev") {
+    return kWrite;
+  }
+  if (name == "epoll_pwait") {
+    return kEpollWait;
+  }
+  if (name == "munmap") {
+    return kMmap;
+  }
+  return kNumOps;
+}
+
+// ParseMix parses an op=weight list.
+PosixErrorOr<std::vector<double>> ParseMix(absl::string_view mix) {
+  std::vector<double> weights(kNumOps, 0);
+  for (absl::string_view entry : absl::StrSplit(mix, ',', absl::SkipEmpty())) {
+    std::vector<absl::string_view> parts = absl::StrSplit(entry, '=');
+    const Op op = OpForName(parts[0]);
+    double weight;
+    if (parts.size() != 2 || op == kNumOps ||
+        !absl::SimpleAtod(parts[1], &weight) || weight < 0) {
+      return PosixError(EINVAL, absl::StrCat("bad mix entry: ", entry));
+    }
+    weights[op] += weight;
+  }
+  return weights;
+}
+
+// ParseProfile parses a profile file. Lines are either "op weight", or rows of
+// the strace -c summary table:
+//
+//   % time     seconds  usecs/call     calls    errors syscall
+//   ------ ----------- ----------- --------- --------- ----------------
+//    45.12    0.001234          12       100           read
+//
+// Syscalls that do not map to an op are ignored.
+PosixErrorOr<std::vector<double>> ParseProfile(const std::string& path) {
+  ASSIGN_OR_RETURN_ERRNO(std::string contents, GetContents(path));
+  std::vector<double> weights(kNumOps, 0);
+  for (absl::string_view line : absl::StrSplit(contents, '\n')) {
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(line, absl::ByAnyChar(" \t"), absl::SkipEmpty());
+    if (fields.empty()) {
+      continue;
+    }
+    const Op op = OpForName(fields.back());
+    double weight;
+    if (fields.size() == 2 && OpForName(fields[0]) != kNumOps) {
+      // "op weight".
+      if (!absl::SimpleAtod(fields[1], &weight) || weight < 0) {
+        return PosixError(EINVAL, absl::StrCat("bad profile line: ", line));
+      }
+      weights[OpForName(fields[0])] += weight;
+    } else if ((fields.size() == 5 || fields.size() == 6) && op != kNumOps &&
+               absl::SimpleAtod(fields[3], &weight)) {
+      // strace -c row; calls is the fourth column.
+      weights[op] += weight;
+    }
+  }
+  return weights;
+}
+
+// Mix returns the op weights given by --soup_profile or --soup_mix.
+PosixErrorOr<std::vector<double>> Mix() {
+  const std::string profile = absl::GetFlag(FLAGS_soup_profile);
+  ASSIGN_OR_RETURN_ERRNO(std::vector<double> weights,
+                         profile.empty()
+                             ? ParseMix(absl::GetFlag(FLAGS_soup_mix))
+                             : ParseProfile(profile));
+  for (double weight : weights) {
+    if (weight > 0) {
+      return weights;
+    }
+  }
+  return PosixError(EINVAL, "mix has no ops");
+}
+
+// Files shared by all benchmark threads for open and stat.
+struct SharedFiles {
+  TempPath dir;
+  std::vector<std::string> paths;
+};
+
+const SharedFiles& GetSharedFiles() {
+  // This gets created only once throughout the lifetime of the process. Use a
+  // dynamically allocated object (that is never deleted) to avoid order of
+  // destruction of static storage variables issues.
+  static const SharedFiles* const files = [] {
+    auto* files = new SharedFiles;
+    files->dir = TempPath::CreateDir().ValueOrDie();
+    for (int i = 0; i < kSharedFiles; i++) {
+      const std::string path = JoinPath(files->dir.path(), absl::StrCat(i));
+      TEST_CHECK(CreateWithContents(path, "").ok());
+      files->paths.push_back(path);
+    }
+    return files;
+  }();
+  return *files;
+}
+
+// BM_SyscallSoup replays a weighted random mix of ops on each thread, as given
+// by --soup_mix or --soup_profile. Each iteration is one op. In addition to
+// ops/sec, it reports latency percentiles for each op in the mix.
+//
+// Each thread reads and writes its own file, waits on its own epoll instance
+// with a readable eventfd, and wakes its own futex with no waiters. All threads
+// open and stat the same set of files.
+//
+// Each run lasts at least 10 seconds, so that the mix reaches a steady state.
+void BM_SyscallSoup(benchmark::State& state) {
+  auto weights_or = Mix();
+  if (!weights_or.ok()) {
+    state.SkipWithError(weights_or.error().ToString().c_str());
+    return;
+  }
+  const std::vector<double> weights = weights_or.ValueOrDie();
+
+  const SharedFiles& shared = GetSharedFiles();
+
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), std::string(kFileSize, 'a'),
+      TempPath::kDefaultFileMode));
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDWR));
+
+  const FileDescriptor epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  const int efd = eventfd(1, 0);
+  TEST_PCHECK(efd >= 0);
+  const FileDescriptor event(efd);
+  ASSERT_NO_ERRNO(RegisterEpollFD(epollfd.get(), event.get(), EPOLLIN, 0));
+
+  std::atomic<int32_t> futex_word(0);
+  std::vector<char> buf(kIOSize, 'b');
+
+  absl::BitGen gen;
+  std::discrete_distribution<int> pick(weights.begin(), weights.end());
+  std::vector<LatencyHistogram> latency(kNumOps);
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    const int op = pick(gen);
+    const int64_t start = LatencyHistogram::Now();
+    switch (op) {
+      case kOpen: {
+        const std::string& path = shared.paths[absl::Uniform(
+            gen, 0, static_cast<int>(shared.paths.size()))];
+        const int ofd = open(path.c_str(), O_RDONLY);
+        TEST_PCHECK(ofd >= 0);
+        TEST_PCHECK(close(ofd) == 0);
+        break;
+      }
+      case kStat: {
+        const std::string& path = shared.paths[absl::Uniform(
+            gen, 0, static_cast<int>(shared.paths.size()))];
+        struct stat st;
+        TEST_PCHECK(stat(path.c_str(), &st) == 0);
+        break;
+      }
+      case kRead: {
+        const off_t off = absl::Uniform(gen, 0, kFileSize / kIOSize) * kIOSize;
+        TEST_PCHECK(pread(fd.get(), buf.data(), kIOSize, off) == kIOSize);
+        break;
+      }
+      case kWrite: {
+        const off_t off = absl::Uniform(gen, 0, kFileSize / kIOSize) * kIOSize;
+        TEST_PCHECK(pwrite(fd.get(), buf.data(), kIOSize, off) == kIOSize);
+        break;
+      }
+      case kEpollWait: {
+        struct epoll_event event;
+        TEST_PCHECK(epoll_wait(epollfd.get(), &event, 1, 0) == 1);
+        break;
+      }
+      case kFutex:
+        TEST_PCHECK(syscall(SYS_futex, &futex_word, FUTEX_WAKE_PRIVATE, 1,
+                            nullptr, nullptr, 0) == 0);
+        break;
+      case kMmap: {
+        void* addr = mmap(nullptr, kPageSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        TEST_PCHECK(addr != MAP_FAILED);
+        // Fault in the page.
+        *static_cast<volatile char*>(addr) = 1;
+        TEST_PCHECK(munmap(addr, kPageSize) == 0);
+        break;
+      }
+    }
+    latency[op].Record(LatencyHistogram::Now() - start);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  for (int op = 0; op < kNumOps; op++) {
+    latency[op].Report(state, absl::StrCat(kOpNames[op], "_"));
+  }
+}
+
+BENCHMARK(BM_SyscallSoup)->ThreadRange(1, 16)->MinTime(10)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
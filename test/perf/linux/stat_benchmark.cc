@@ -16,10 +16,16 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/fs_util.h"
+#include "test/util/logging.h"
 #include "test/util/temp_path.h"
 #include "test/util/test_util.h"
 
@@ -49,6 +55,7 @@ void BM_Stat(benchmark::State& state) {
       ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileIn(dir_path));
 
   struct stat st;
+  ScopedRusageCounters rusage(state);
   for (auto _ : state) {
     ASSERT_THAT(stat(file.path().c_str(), &st), SyscallSucceeds());
   }
@@ -56,6 +63,141 @@ void BM_Stat(benchmark::State& state) {
 
 BENCHMARK(BM_Stat)->Range(1, 100)->UseRealTime();
 
+// Number of directories that BM_StatCold creates, which must be well beyond
+// the number of unreferenced dentries that the sentry caches for a gofer
+// filesystem.
+constexpr int kColdDirs = 8192;
+
+// Like BM_Stat, but with a file in each of enough distinct directory
+// hierarchies that they can't all be cached, stat'd in turn so that every path
+// walk misses the dentry cache, as it would the first time each path is used.
+void BM_StatCold(benchmark::State& state) {
+  const int depth = state.range(0);
+  const int trees = std::max(kColdDirs / depth, 2);
+  const TempPath top_dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+
+  std::vector<std::string> files;
+  for (int tree = 0; tree < trees; tree++) {
+    std::string dir_path = JoinPath(top_dir.path(), absl::StrCat(tree));
+    ASSERT_NO_ERRNO(Mkdir(dir_path, 0755));
+    for (int i = 1; i < depth; i++) {
+      // Named like BM_Stat's directories for the same reason.
+      dir_path = JoinPath(dir_path, absl::StrCat(i));
+      ASSERT_NO_ERRNO(Mkdir(dir_path, 0755));
+    }
+    const std::string file = JoinPath(dir_path, "file");
+    ASSERT_NO_ERRNO(CreateWithContents(file, ""));
+    files.push_back(file);
+  }
+
+  struct stat st;
+  size_t next = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    ASSERT_THAT(stat(files[next].c_str(), &st), SyscallSucceeds());
+    next = (next + 1) % files.size();
+  }
+}
+
+BENCHMARK(BM_StatCold)->Range(1, 100)->UseRealTime();
+
+// Deepest directory in SharedTree.
+constexpr int kMaxDepth = 100;
+
+// SharedTree is a chain of kMaxDepth nested directories with a file in each,
+// shared by all benchmark threads so that they walk the same dentries.
+class SharedTree {
+ public:
+  SharedTree() : top_dir_(TempPath::CreateDir().ValueOrDie()) {
+    std::string dir_path = top_dir_.path();
+    for (int depth = 1; depth <= kMaxDepth; depth++) {
+      // Named like BM_Stat's directories, but kept short for the same reason.
+      dir_path = JoinPath(dir_path, absl::StrCat(depth));
+      TEST_CHECK(Mkdir(dir_path, 0755).ok());
+      const std::string file = JoinPath(dir_path, "file");
+      TEST_CHECK(CreateWithContents(file, "").ok());
+      files_.push_back(file);
+      missing_.push_back(JoinPath(dir_path, "missing"));
+    }
+  }
+
+  // File returns the path of the file in the directory depth levels deep.
+  const std::string& File(int depth) const { return files_[depth - 1]; }
+
+  // Missing returns a nonexistent path in the directory depth levels deep.
+  const std::string& Missing(int depth) const { return missing_[depth - 1]; }
+
+ private:
+  const TempPath top_dir_;
+  std::vector<std::string> files_;
+  std::vector<std::string> missing_;
+};
+
+const SharedTree& GetSharedTree() {
+  // This gets created only once throughout the lifetime of the process. Use a
+  // dynamically allocated object (that is never deleted) to avoid order of
+  // destruction of static storage variables issues.
+  static const SharedTree* const tree = new SharedTree();
+  return *tree;
+}
+
+// Like BM_Stat, but with every benchmark thread stat'ing the same file.
+void BM_StatShared(benchmark::State& state) {
+  const std::string& path = GetSharedTree().File(state.range(0));
+
+  struct stat st;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(stat(path.c_str(), &st) == 0);
+  }
+}
+
+BENCHMARK(BM_StatShared)
+    ->Range(1, kMaxDepth)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+// Like BM_StatShared, but for a nonexistent file, which measures negative
+// lookups at the end of the path walk.
+void BM_StatNegative(benchmark::State& state) {
+  const std::string& path = GetSharedTree().Missing(state.range(0));
+
+  struct stat st;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(stat(path.c_str(), &st) == -1 && errno == ENOENT);
+  }
+}
+
+BENCHMARK(BM_StatNegative)
+    ->Range(1, kMaxDepth)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+// BM_StatProbe stats state.range(0) distinct nonexistent names in a directory
+// per iteration, like an interpreter probing its search path for a module
+// under every suffix. Repeated misses should be answered from the negative
+// dentries cached by the first iteration.
+void BM_StatProbe(benchmark::State& state) {
+  const int probes = state.range(0);
+  const TempPath dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  std::vector<std::string> paths;
+  for (int i = 0; i < probes; i++) {
+    paths.push_back(JoinPath(dir.path(), absl::StrCat("module", i, ".py")));
+  }
+
+  struct stat st;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    for (const std::string& path : paths) {
+      TEST_CHECK(stat(path.c_str(), &st) == -1 && errno == ENOENT);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(probes) * state.iterations());
+}
+
+BENCHMARK(BM_StatProbe)->ArgName("probes")->Range(1, 1024)->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
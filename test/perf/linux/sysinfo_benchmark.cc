@@ -0,0 +1,123 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <dlfcn.h>
+#include <sys/resource.h>
+#include <sys/sysinfo.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// The benchmarks below are of system information queries made on hot paths
+// by language runtimes. Each of the system calls costs about as much as
+// BM_Getpid in getpid_benchmark, which is the cost of a trap.
+
+void BM_Sysinfo(benchmark::State& state) {
+  struct sysinfo info;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(sysinfo(&info) == 0);
+  }
+}
+
+BENCHMARK(BM_Sysinfo);
+
+void BM_Uname(benchmark::State& state) {
+  struct utsname name;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(uname(&name) == 0);
+  }
+}
+
+BENCHMARK(BM_Uname);
+
+void BM_Getrlimit(benchmark::State& state) {
+  struct rlimit rl;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(getrlimit(RLIMIT_NOFILE, &rl) == 0);
+  }
+}
+
+BENCHMARK(BM_Getrlimit);
+
+// BM_SysconfNprocessorsOnln measures sysconf(_SC_NPROCESSORS_ONLN), which
+// glibc answers by reading /sys/devices/system/cpu/online, or with
+// sched_getaffinity(2) if that fails.
+void BM_SysconfNprocessorsOnln(benchmark::State& state) {
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(sysconf(_SC_NPROCESSORS_ONLN) > 0);
+  }
+}
+
+BENCHMARK(BM_SysconfNprocessorsOnln);
+
+// VDSOGetNprocs returns the sandbox VDSO's get_nprocs, or nullptr if there is
+// no such function.
+//
+// libc never calls get_nprocs in the VDSO, so applications that want to use
+// it look it up themselves.
+using GetNprocsFn = int (*)();
+GetNprocsFn VDSOGetNprocs() {
+  void* vdso = dlopen("linux-vdso.so.1", RTLD_LAZY | RTLD_NOLOAD);
+  if (vdso == nullptr) {
+    return nullptr;
+  }
+#if defined(__x86_64__)
+  return reinterpret_cast<GetNprocsFn>(dlsym(vdso, "__vdso_get_nprocs"));
+#elif defined(__aarch64__)
+  return reinterpret_cast<GetNprocsFn>(dlsym(vdso, "__kernel_get_nprocs"));
+#else
+  return nullptr;
+#endif
+}
+
+// BM_VDSOGetNprocs is BM_SysconfNprocessorsOnln using the VDSO, which reads
+// the number of CPUs from the parameter page without trapping to the sandbox
+// kernel.
+void BM_VDSOGetNprocs(benchmark::State& state) {
+  GetNprocsFn vdso_get_nprocs = VDSOGetNprocs();
+  if (vdso_get_nprocs == nullptr) {
+    state.SkipWithError("requires the sandbox VDSO");
+    return;
+  }
+  if (vdso_get_nprocs() != sysconf(_SC_NPROCESSORS_ONLN)) {
+    state.SkipWithError("VDSO get_nprocs disagrees with sysconf");
+    return;
+  }
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(vdso_get_nprocs() > 0);
+  }
+}
+
+BENCHMARK(BM_VDSOGetNprocs);
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,195 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/ip_socket_test_util.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of each write making up a response.
+constexpr int kWriteSize = 64;
+
+// How the responder coalesces its small writes.
+enum WriteMode {
+  // Nagle's algorithm, the default.
+  kNagle,
+  // TCP_NODELAY, so that every write is sent immediately.
+  kNoDelay,
+  // TCP_NODELAY, with MSG_MORE set on all but the last write.
+  kMore,
+  // TCP_CORK, released after the last write.
+  kCork,
+};
+
+// TcpOutSegs returns the Tcp OutSegs counter from /proc/net/snmp, or 0 if it
+// is not available.
+uint64_t TcpOutSegs() {
+  auto contents = GetContents("/proc/net/snmp");
+  if (!contents.ok()) {
+    return 0;
+  }
+  // /proc/net/snmp prints a line of headers followed by a line of metrics.
+  std::vector<std::string> lines = absl::StrSplit(contents.ValueOrDie(), '\n');
+  for (size_t i = 0; i + 1 < lines.size(); i += 2) {
+    if (!absl::StartsWith(lines[i], "Tcp:")) {
+      continue;
+    }
+    std::vector<std::string> fields =
+        absl::StrSplit(lines[i], ' ', absl::SkipWhitespace());
+    std::vector<std::string> values =
+        absl::StrSplit(lines[i + 1], ' ', absl::SkipWhitespace());
+    for (size_t j = 1; j < fields.size() && j < values.size(); j++) {
+      uint64_t val;
+      if (fields[j] == "OutSegs" && absl::SimpleAtoi(values[j], &val)) {
+        return val;
+      }
+    }
+  }
+  return 0;
+}
+
+void SetSockOpt(int fd, int name, int value) {
+  TEST_PCHECK(setsockopt(fd, IPPROTO_TCP, name, &value, sizeof(value)) == 0);
+}
+
+// BM_TCPSmallWrites measures the latency of a 1-byte request over a loopback
+// TCP connection answered with state.range(1) writes of kWriteSize bytes each,
+// as written by RPC and HTTP servers emitting headers and body separately.
+// state.range(0) is the WriteMode of the responder. The "segs" counter is the
+// number of TCP segments sent by the stack per request, including ACKs.
+void BM_TCPSmallWrites(benchmark::State& state) {
+  const int mode = state.range(0);
+  const int writes = state.range(1);
+  const int response_size = writes * kWriteSize;
+
+  auto sockets = IPv4TCPAcceptBindSocketPair(0).Create().ValueOrDie();
+  const int client_fd = sockets->first_fd();
+  const int server_fd = sockets->second_fd();
+  SetSockOpt(client_fd, TCP_NODELAY, 1);
+  if (mode != kNagle) {
+    SetSockOpt(server_fd, TCP_NODELAY, 1);
+  }
+
+  uint64_t segs = 0;
+  {
+    ScopedThread responder([server_fd, mode, writes] {
+      std::vector<char> buf(kWriteSize, 'a');
+      char c;
+      while (true) {
+        const ssize_t n = ReadFd(server_fd, &c, 1);
+        TEST_PCHECK(n >= 0);
+        if (n == 0) {
+          // The client shut down.
+          return;
+        }
+        if (mode == kCork) {
+          SetSockOpt(server_fd, TCP_CORK, 1);
+        }
+        for (int i = 0; i < writes; i++) {
+          const int flags = (mode == kMore && i < writes - 1) ? MSG_MORE : 0;
+          TEST_PCHECK(RetryEINTR(send)(server_fd, buf.data(), buf.size(),
+                                       flags) == kWriteSize);
+        }
+        if (mode == kCork) {
+          SetSockOpt(server_fd, TCP_CORK, 0);
+        }
+      }
+    });
+
+    std::vector<char> response(response_size);
+    char c = 'a';
+    const uint64_t segs_before = TcpOutSegs();
+    ScopedRusageCounters rusage(state);
+    for (auto _ : state) {
+      TEST_PCHECK(WriteFd(client_fd, &c, 1) == 1);
+      TEST_PCHECK(ReadFd(client_fd, response.data(), response_size) ==
+                  response_size);
+    }
+    segs = TcpOutSegs() - segs_before;
+    TEST_PCHECK(shutdown(client_fd, SHUT_WR) == 0);
+  }
+
+  state.counters["segs"] =
+      benchmark::Counter(segs, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations());
+}
+
+void SmallWriteArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"mode", "writes"});
+  for (int mode : {kNagle, kNoDelay, kMore, kCork}) {
+    for (int writes : {2, 8, 32}) {
+      benchmark->Args({mode, writes});
+    }
+  }
+}
+
+BENCHMARK(BM_TCPSmallWrites)->Apply(&SmallWriteArgs)->UseRealTime();
+
+// BM_TCPNotsentLowat measures the throughput of a bulk transfer over a
+// loopback TCP connection with TCP_NOTSENT_LOWAT set to state.range(0) on the
+// sender, or unset if it is 0. A low limit keeps little data queued in the
+// sender, as used by HTTP/2 servers to reprioritize streams, at the cost of
+// more wakeups.
+void BM_TCPNotsentLowat(benchmark::State& state) {
+  const int lowat = state.range(0);
+  auto sockets = IPv4TCPAcceptBindSocketPair(0).Create().ValueOrDie();
+  if (lowat != 0) {
+    SetSockOpt(sockets->first_fd(), TCP_NOTSENT_LOWAT, lowat);
+  }
+
+  const TransferChunking chunking = {16 << 10};
+  constexpr uint64_t kBytes = 16 << 20;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(TransferBulk(sockets->first_fd(), sockets->second_fd(), kBytes,
+                            chunking)
+                   .ValueOrDie() == kBytes);
+  }
+
+  state.SetBytesProcessed(kBytes * state.iterations());
+}
+
+BENCHMARK(BM_TCPNotsentLowat)
+    ->ArgName("lowat")
+    ->Arg(0)
+    ->Arg(16 << 10)
+    ->Arg(128 << 10)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
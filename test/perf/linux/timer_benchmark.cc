@@ -0,0 +1,209 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <signal.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/logging.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// ArmedTimers creates and arms count POSIX timers that do not expire during
+// the benchmark, as a server with a timer per connection would have, and
+// deletes them when destroyed.
+//
+// POSIX timers are used rather than timerfds so that the count is not limited
+// by RLIMIT_NOFILE.
+class ArmedTimers {
+ public:
+  explicit ArmedTimers(int count) {
+    struct sigevent sev = {};
+    sev.sigev_notify = SIGEV_NONE;
+    for (int i = 0; i < count; i++) {
+      int timerid;
+      TEST_PCHECK(syscall(SYS_timer_create, CLOCK_MONOTONIC, &sev, &timerid) ==
+                  0);
+      // Spread deadlines over an hour or more in the future.
+      struct itimerspec its = {};
+      its.it_value.tv_sec = 3600 + i % 3600;
+      its.it_value.tv_nsec = (i * 7919) % 1000000000;
+      TEST_PCHECK(syscall(SYS_timer_settime, timerid, 0, &its, nullptr) == 0);
+      timers_.push_back(timerid);
+    }
+  }
+
+  ~ArmedTimers() {
+    for (int timerid : timers_) {
+      TEST_PCHECK(syscall(SYS_timer_delete, timerid) == 0);
+    }
+  }
+
+ private:
+  std::vector<int> timers_;
+};
+
+// Arms and disarms a timerfd while state.range(0) other timers are armed.
+void BM_TimerArm(benchmark::State& state) {
+  ArmedTimers armed(state.range(0));
+  const int fd = timerfd_create(CLOCK_MONOTONIC, 0);
+  TEST_PCHECK(fd >= 0);
+
+  struct itimerspec arm = {};
+  arm.it_value.tv_sec = 60;
+  const struct itimerspec disarm = {};
+  for (auto _ : state) {
+    TEST_PCHECK(timerfd_settime(fd, 0, &arm, nullptr) == 0);
+    TEST_PCHECK(timerfd_settime(fd, 0, &disarm, nullptr) == 0);
+  }
+
+  TEST_PCHECK(close(fd) == 0);
+}
+
+BENCHMARK(BM_TimerArm)
+    ->Arg(0)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->UseRealTime();
+
+int64_t NowNanos() {
+  struct timespec ts;
+  TEST_PCHECK(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Measures how late a timerfd expires after its deadline while
+// state.range(0) other timers are armed. The mean lateness is reported as
+// the jitter_ns counter.
+void BM_TimerExpiry(benchmark::State& state) {
+  constexpr int64_t kTimeoutNanos = 1000000;  // 1ms
+
+  ArmedTimers armed(state.range(0));
+  const int fd = timerfd_create(CLOCK_MONOTONIC, 0);
+  TEST_PCHECK(fd >= 0);
+
+  int64_t late = 0;
+  for (auto _ : state) {
+    const int64_t start = NowNanos();
+    struct itimerspec its = {};
+    its.it_value.tv_nsec = kTimeoutNanos;
+    TEST_PCHECK(timerfd_settime(fd, 0, &its, nullptr) == 0);
+    uint64_t expirations;
+    TEST_PCHECK(read(fd, &expirations, sizeof(expirations)) ==
+                sizeof(expirations));
+    late += NowNanos() - start - kTimeoutNanos;
+  }
+
+  TEST_PCHECK(close(fd) == 0);
+  state.counters["jitter_ns"] =
+      benchmark::Counter(late, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_TimerExpiry)
+    ->Arg(0)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->UseRealTime();
+
+// Number of SIGPROFs received by ProfHandler.
+std::atomic<int64_t> prof_samples;
+
+void ProfHandler(int sig) {
+  prof_samples.fetch_add(1, std::memory_order_relaxed);
+}
+
+int64_t ProcessCPUNanos() {
+  struct timespec ts;
+  TEST_PCHECK(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Spins for a fixed amount of work without making syscalls, as the code
+// sampled by a CPU profiler would.
+void Spin() {
+  for (int i = 0; i < 10000; i++) {
+    benchmark::DoNotOptimize(i);
+  }
+}
+
+// Spins with ITIMER_PROF set to expire at state.range(0) Hz (or not at all
+// if 0), as CPU profilers such as gperftools do.
+//
+// sample_ratio is the number of SIGPROFs received per second of CPU time used,
+// divided by the requested rate. Profilers weight each sample by the timer
+// interval, so profiles are only accurate if this is close to 1.
+// samples_per_iter is the number of SIGPROFs received per iteration; the
+// per-sample overhead is the increase in time per iteration from the 0 Hz run,
+// divided by samples_per_iter.
+void BM_ProfTimer(benchmark::State& state) {
+  const int hz = state.range(0);
+
+  struct sigaction sa = {};
+  sa.sa_handler = ProfHandler;
+  sa.sa_flags = SA_RESTART;
+  struct sigaction old_sa;
+  TEST_PCHECK(sigaction(SIGPROF, &sa, &old_sa) == 0);
+
+  struct itimerval itv = {};
+  if (hz != 0) {
+    itv.it_interval.tv_usec = 1000000 / hz;
+    itv.it_value = itv.it_interval;
+  }
+  prof_samples.store(0);
+  const int64_t cpu_start = ProcessCPUNanos();
+  TEST_PCHECK(setitimer(ITIMER_PROF, &itv, nullptr) == 0);
+
+  for (auto _ : state) {
+    Spin();
+  }
+
+  const struct itimerval disarm = {};
+  TEST_PCHECK(setitimer(ITIMER_PROF, &disarm, nullptr) == 0);
+  const int64_t cpu_nanos = ProcessCPUNanos() - cpu_start;
+  const int64_t samples = prof_samples.load();
+  TEST_PCHECK(sigaction(SIGPROF, &old_sa, nullptr) == 0);
+
+  state.counters["samples_per_iter"] =
+      benchmark::Counter(samples, benchmark::Counter::kAvgIterations);
+  if (hz != 0 && cpu_nanos > 0) {
+    state.counters["sample_ratio"] =
+        static_cast<double>(samples) * 1e9 / cpu_nanos / hz;
+  }
+}
+
+BENCHMARK(BM_ProfTimer)
+    ->Arg(0)
+    ->Arg(100)
+    ->Arg(250)
+    ->Arg(1000)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
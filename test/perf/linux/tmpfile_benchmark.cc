@@ -0,0 +1,92 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Both benchmarks create a file with its full contents under its final name
+// without ever exposing a partially written file, and then remove it so that
+// the next iteration can create it again.
+
+// BM_WriteTempRename writes a named temporary file and renames it.
+void BM_WriteTempRename(benchmark::State& state) {
+  const std::string contents(state.range(0), 'x');
+  const std::string path = NewTempAbsPath();
+  const std::string temp_path = path + ".tmp";
+
+  for (auto _ : state) {
+    const int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(WriteFd(fd, contents.data(), contents.size()) ==
+                static_cast<ssize_t>(contents.size()));
+    TEST_PCHECK(close(fd) == 0);
+    TEST_PCHECK(rename(temp_path.c_str(), path.c_str()) == 0);
+    TEST_PCHECK(unlink(path.c_str()) == 0);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WriteTempRename)->Arg(0)->Arg(4096)->UseRealTime();
+
+// BM_TmpfileLink writes an unnamed file created with O_TMPFILE and gives it
+// its name with linkat(2).
+void BM_TmpfileLink(benchmark::State& state) {
+  const std::string contents(state.range(0), 'x');
+  const std::string dir = GetAbsoluteTestTmpdir();
+  const std::string path = NewTempAbsPath();
+
+  const int probe = open(dir.c_str(), O_TMPFILE | O_WRONLY, 0644);
+  if (probe < 0 && errno == EOPNOTSUPP) {
+    state.SkipWithError("O_TMPFILE not supported");
+    return;
+  }
+  TEST_PCHECK(probe >= 0);
+  TEST_PCHECK(close(probe) == 0);
+
+  for (auto _ : state) {
+    const int fd = open(dir.c_str(), O_TMPFILE | O_WRONLY, 0644);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(WriteFd(fd, contents.data(), contents.size()) ==
+                static_cast<ssize_t>(contents.size()));
+    TEST_PCHECK(linkat(AT_FDCWD, absl::StrCat("/proc/self/fd/", fd).c_str(),
+                       AT_FDCWD, path.c_str(), AT_SYMLINK_FOLLOW) == 0);
+    TEST_PCHECK(close(fd) == 0);
+    TEST_PCHECK(unlink(path.c_str()) == 0);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TmpfileLink)->Arg(0)->Arg(4096)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
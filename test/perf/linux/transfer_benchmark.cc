@@ -0,0 +1,101 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/socket.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/ip_socket_test_util.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/syscalls/linux/unix_domain_socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Bytes transferred by each iteration of BM_TransferBulk.
+constexpr uint64_t kTransferBytes = 64 << 20;
+
+// Socket pairs compared by BM_TransferBulk.
+std::vector<SocketPairKind> TransferSocketPairs() {
+  return {
+      UnixDomainSocketPair(SOCK_STREAM),
+      UnixDomainSocketPair(SOCK_SEQPACKET),
+      UnixDomainSocketPair(SOCK_DGRAM),
+      IPv4TCPAcceptBindSocketPair(0),
+      IPv6TCPAcceptBindSocketPair(0),
+      IPv4UDPBidirectionalBindSocketPair(0),
+  };
+}
+
+// BM_TransferBulk streams kTransferBytes through a socket pair of the given
+// kind on each iteration, using TransferBulk with chunks of state.range(0)
+// bytes, written with writev(2) of state.range(1)-byte iovecs, or write(2) if
+// state.range(1) is 0. It reports the bytes received per second, and for
+// datagram sockets, the fraction of bytes dropped as loss_ratio.
+//
+// Running this benchmark on the native, netstack and hostinet platforms
+// compares their throughput for each kind.
+void BM_TransferBulk(benchmark::State& state, const SocketPairKind& kind) {
+  auto sockets = ASSERT_NO_ERRNO_AND_VALUE(kind.Create());
+  const TransferChunking chunking = {static_cast<size_t>(state.range(0)),
+                                     static_cast<size_t>(state.range(1))};
+
+  uint64_t received = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    received += ASSERT_NO_ERRNO_AND_VALUE(TransferBulk(
+        sockets->first_fd(), sockets->second_fd(), kTransferBytes, chunking));
+  }
+
+  state.SetBytesProcessed(received);
+  const uint64_t sent = kTransferBytes * state.iterations();
+  state.counters["loss_ratio"] =
+      static_cast<double>(sent - received) / static_cast<double>(sent);
+}
+
+void TransferArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"chunk", "iov"});
+  // Chunks stay below the maximum UDP datagram size.
+  for (int chunk : {1 << 10, 1 << 13, 1 << 15}) {
+    for (int iov : {0, 512}) {
+      benchmark->Args({chunk, iov});
+    }
+  }
+}
+
+// Registers BM_TransferBulk for each of TransferSocketPairs.
+const bool kTransferBenchmarksRegistered = [] {
+  for (const SocketPairKind& kind : TransferSocketPairs()) {
+    benchmark::RegisterBenchmark(
+        ("BM_TransferBulk/" + kind.description).c_str(),
+        [kind](benchmark::State& state) { BM_TransferBulk(state, kind); })
+        ->Apply(&TransferArgs)
+        ->UseRealTime();
+  }
+  return true;
+}();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,261 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <linux/capability.h>
+#include <linux/if_arp.h>
+#include <linux/if_ether.h>
+#include <linux/if_tun.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <sys/ioctl.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/socket_netlink_route_util.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/capability_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr char kDevNetTun[] = "/dev/net/tun";
+constexpr char kTapName[] = "tapbench0";
+
+// The tap device has address kTapAddr (kMacA), and packets written to it come
+// from kPeerAddr (kMacB).
+constexpr char kTapAddr[] = "10.0.0.1";
+constexpr char kPeerAddr[] = "10.0.0.2";
+constexpr uint8_t kMacA[ETH_ALEN] = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
+constexpr uint8_t kMacB[ETH_ALEN] = {0xBB, 0xBB, 0xBB, 0xBB, 0xBB, 0xBB};
+
+// Size of struct virtio_net_hdr, which precedes each packet if the device has
+// IFF_VNET_HDR set.
+constexpr int kVirtioNetHdrSize = 10;
+
+// Size of the payload of each ICMP echo request.
+constexpr int kPayloadSize = 64;
+
+struct ping_pkt {
+  struct ethhdr eth;
+  struct iphdr ip;
+  struct icmphdr icmp;
+  char payload[kPayloadSize];
+} __attribute__((packed));
+
+struct arp_pkt {
+  struct ethhdr eth;
+  struct arphdr arp;
+  uint8_t arp_sha[ETH_ALEN];
+  uint8_t arp_spa[4];
+  uint8_t arp_tha[ETH_ALEN];
+  uint8_t arp_tpa[4];
+} __attribute__((packed));
+
+// Tap is a tap device with kTapAddr assigned, opened with IFF_NO_PI and,
+// if vnet_hdr is set, IFF_VNET_HDR.
+class Tap {
+ public:
+  static PosixErrorOr<Tap> Open(bool vnet_hdr) {
+    ASSIGN_OR_RETURN_ERRNO(FileDescriptor fd,
+                           gvisor::testing::Open(kDevNetTun, O_RDWR));
+    struct ifreq ifr = {};
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    if (vnet_hdr) {
+      ifr.ifr_flags |= IFF_VNET_HDR;
+    }
+    strncpy(ifr.ifr_name, kTapName, IFNAMSIZ);
+    RETURN_ERROR_IF_SYSCALL_FAIL(ioctl(fd.get(), TUNSETIFF, &ifr));
+
+    ASSIGN_OR_RETURN_ERRNO(std::vector<Link> links, DumpLinks());
+    int index = -1;
+    for (const Link& link : links) {
+      if (link.name == kTapName) {
+        index = link.index;
+      }
+    }
+    if (index < 0) {
+      return PosixError(ENOENT, "tap interface not found");
+    }
+    struct in_addr addr;
+    inet_pton(AF_INET, kTapAddr, &addr);
+    RETURN_IF_ERRNO(LinkAddLocalAddr(index, AF_INET, /*prefixlen=*/24, &addr,
+                                     sizeof(addr)));
+    if (!IsRunningOnGvisor()) {
+      // gVisor doesn't support setting MAC addresses, and creates interfaces
+      // up.
+      RETURN_IF_ERRNO(LinkSetMacAddr(index, kMacA, sizeof(kMacA)));
+      RETURN_IF_ERRNO(LinkChangeFlags(index, IFF_UP, IFF_UP));
+    }
+    return Tap(std::move(fd), vnet_hdr ? kVirtioNetHdrSize : 0);
+  }
+
+  int fd() const { return fd_.get(); }
+
+  // Frame returns packet prefixed with a zeroed virtio_net_hdr if the device
+  // expects one.
+  std::string Frame(const void* packet, size_t size) const {
+    std::string frame(hdr_size_, 0);
+    frame.append(static_cast<const char*>(packet), size);
+    return frame;
+  }
+
+  // Packet returns the part of a frame read from the device that follows the
+  // virtio_net_hdr, if any.
+  const char* Packet(const char* frame) const { return frame + hdr_size_; }
+
+  // Write writes frame to the device.
+  void Write(const std::string& frame) const {
+    TEST_PCHECK(write(fd_.get(), frame.data(), frame.size()) ==
+                static_cast<ssize_t>(frame.size()));
+  }
+
+ private:
+  Tap(FileDescriptor fd, int hdr_size)
+      : fd_(std::move(fd)), hdr_size_(hdr_size) {}
+
+  FileDescriptor fd_;
+  int hdr_size_;
+};
+
+// PingRequest returns an ICMP echo request from kPeerAddr to kTapAddr.
+ping_pkt PingRequest() {
+  ping_pkt pkt = {};
+  memcpy(pkt.eth.h_dest, kMacA, sizeof(pkt.eth.h_dest));
+  memcpy(pkt.eth.h_source, kMacB, sizeof(pkt.eth.h_source));
+  pkt.eth.h_proto = htons(ETH_P_IP);
+
+  pkt.ip.ihl = 5;
+  pkt.ip.version = 4;
+  pkt.ip.tot_len = htons(sizeof(pkt.ip) + sizeof(pkt.icmp) + kPayloadSize);
+  pkt.ip.id = 1;
+  pkt.ip.frag_off = htons(IP_DF);
+  pkt.ip.ttl = 64;
+  pkt.ip.protocol = IPPROTO_ICMP;
+  inet_pton(AF_INET, kTapAddr, &pkt.ip.daddr);
+  inet_pton(AF_INET, kPeerAddr, &pkt.ip.saddr);
+  pkt.ip.check = IPChecksum(pkt.ip);
+
+  pkt.icmp.type = ICMP_ECHO;
+  pkt.icmp.un.echo.id = 1;
+  pkt.icmp.un.echo.sequence = 1;
+  pkt.icmp.checksum = ICMPChecksum(pkt.icmp, pkt.payload, kPayloadSize);
+  return pkt;
+}
+
+// ArpReply returns an ARP reply announcing kPeerAddr at kMacB.
+arp_pkt ArpReply() {
+  arp_pkt pkt = {};
+  memcpy(pkt.eth.h_dest, kMacA, sizeof(pkt.eth.h_dest));
+  memcpy(pkt.eth.h_source, kMacB, sizeof(pkt.eth.h_source));
+  pkt.eth.h_proto = htons(ETH_P_ARP);
+
+  pkt.arp.ar_hrd = htons(ARPHRD_ETHER);
+  pkt.arp.ar_pro = htons(ETH_P_IP);
+  pkt.arp.ar_hln = ETH_ALEN;
+  pkt.arp.ar_pln = 4;
+  pkt.arp.ar_op = htons(ARPOP_REPLY);
+  memcpy(pkt.arp_sha, kMacB, sizeof(pkt.arp_sha));
+  inet_pton(AF_INET, kPeerAddr, pkt.arp_spa);
+  memcpy(pkt.arp_tha, kMacA, sizeof(pkt.arp_tha));
+  inet_pton(AF_INET, kTapAddr, pkt.arp_tpa);
+  return pkt;
+}
+
+// BM_TapWrite measures the rate at which ICMP echo requests written to a tap
+// device are injected into the network stack. Replies are not read; the device
+// drops them once its queue is full. state.range(0) selects IFF_VNET_HDR.
+void BM_TapWrite(benchmark::State& state) {
+  if (!HaveCapability(CAP_NET_ADMIN).ValueOrDie()) {
+    state.SkipWithError("CAP_NET_ADMIN required");
+    return;
+  }
+  Tap tap = Tap::Open(state.range(0)).ValueOrDie();
+  const arp_pkt arp = ArpReply();
+  tap.Write(tap.Frame(&arp, sizeof(arp)));
+  const ping_pkt ping = PingRequest();
+  const std::string frame = tap.Frame(&ping, sizeof(ping));
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    tap.Write(frame);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TapWrite)->ArgName("vnet_hdr")->Arg(0)->Arg(1)->UseRealTime();
+
+// BM_TapPingPong measures the round trip rate of ICMP echo requests written to
+// a tap device and their replies read back from it. state.range(0) selects
+// IFF_VNET_HDR.
+void BM_TapPingPong(benchmark::State& state) {
+  if (!HaveCapability(CAP_NET_ADMIN).ValueOrDie()) {
+    state.SkipWithError("CAP_NET_ADMIN required");
+    return;
+  }
+  Tap tap = Tap::Open(state.range(0)).ValueOrDie();
+  const arp_pkt arp = ArpReply();
+  const std::string arp_frame = tap.Frame(&arp, sizeof(arp));
+  tap.Write(arp_frame);
+  const ping_pkt ping = PingRequest();
+  const std::string frame = tap.Frame(&ping, sizeof(ping));
+
+  char buf[kVirtioNetHdrSize + sizeof(ping_pkt) + 64];
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    tap.Write(frame);
+    while (true) {
+      const int n = read(tap.fd(), buf, sizeof(buf));
+      TEST_PCHECK(n >= 0);
+      const char* packet = tap.Packet(buf);
+      if (n < packet - buf + static_cast<int>(sizeof(struct ethhdr))) {
+        continue;
+      }
+      const struct ethhdr* eth = reinterpret_cast<const struct ethhdr*>(packet);
+      if (eth->h_proto == htons(ETH_P_ARP)) {
+        // The stack may still ask for kPeerAddr, and drop the request.
+        tap.Write(arp_frame);
+        tap.Write(frame);
+        continue;
+      }
+      if (n >= packet - buf + static_cast<int>(sizeof(ping_pkt)) &&
+          eth->h_proto == htons(ETH_P_IP)) {
+        const ping_pkt* reply = reinterpret_cast<const ping_pkt*>(packet);
+        if (reply->ip.protocol == IPPROTO_ICMP &&
+            reply->icmp.type == ICMP_ECHOREPLY) {
+          break;
+        }
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TapPingPong)->ArgName("vnet_hdr")->Arg(0)->Arg(1)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,238 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/synchronization/notification.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/syscalls/linux/unix_domain_socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Unix stream socket pairs compared by the benchmarks below. The gofer pair
+// is connected through a host socket served by the gofer, as used by
+// sidecars talking to the sandboxed application; it is only available when
+// running under runsc with a socket at /socket.
+std::vector<SocketPairKind> UnixStreamSocketPairs() {
+  return {
+      UnixDomainSocketPair(SOCK_STREAM),
+      AbstractBoundUnixDomainSocketPair(SOCK_STREAM),
+      FilesystemBoundUnixDomainSocketPair(SOCK_STREAM),
+      SocketpairGoferUnixDomainSocketPair(SOCK_STREAM),
+  };
+}
+
+// BM_UnixPingPong measures the round trip time of a state.range(0)-byte
+// message written to one end of a socket pair of the given kind and echoed
+// back by a thread reading the other end.
+void BM_UnixPingPong(benchmark::State& state, const SocketPairKind& kind) {
+  auto sockets_or = kind.Create();
+  if (!sockets_or.ok()) {
+    state.SkipWithError(sockets_or.error().ToString().c_str());
+    return;
+  }
+  std::unique_ptr<SocketPair> sockets = std::move(sockets_or).ValueOrDie();
+  const int size = state.range(0);
+  std::vector<char> buf(size, 'a');
+
+  {
+    const int echo_fd = sockets->second_fd();
+    ScopedThread echo([echo_fd, size] {
+      std::vector<char> echo_buf(size);
+      while (true) {
+        const ssize_t n = ReadFd(echo_fd, echo_buf.data(), size);
+        TEST_PCHECK(n >= 0);
+        if (n < size) {
+          // The writer shut down.
+          return;
+        }
+        TEST_PCHECK(WriteFd(echo_fd, echo_buf.data(), size) == size);
+      }
+    });
+
+    ScopedRusageCounters rusage(state);
+    for (auto _ : state) {
+      TEST_PCHECK(WriteFd(sockets->first_fd(), buf.data(), size) == size);
+      TEST_PCHECK(ReadFd(sockets->first_fd(), buf.data(), size) == size);
+    }
+    TEST_PCHECK(shutdown(sockets->first_fd(), SHUT_WR) == 0);
+  }
+
+  state.SetBytesProcessed(2 * static_cast<int64_t>(size) * state.iterations());
+}
+
+// BM_UnixStream measures the throughput of writing state.range(0)-byte
+// messages to one end of a socket pair of the given kind while they are read
+// from the other end, using TransferBulk.
+void BM_UnixStream(benchmark::State& state, const SocketPairKind& kind) {
+  auto sockets_or = kind.Create();
+  if (!sockets_or.ok()) {
+    state.SkipWithError(sockets_or.error().ToString().c_str());
+    return;
+  }
+  std::unique_ptr<SocketPair> sockets = std::move(sockets_or).ValueOrDie();
+  const TransferChunking chunking = {static_cast<size_t>(state.range(0))};
+  // Transfer at least 64 messages and 16MB per iteration.
+  const uint64_t bytes =
+      std::max(static_cast<uint64_t>(state.range(0)) * 64, uint64_t{16} << 20);
+
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(TransferBulk(sockets->first_fd(), sockets->second_fd(), bytes,
+                            chunking)
+                   .ValueOrDie() == bytes);
+  }
+
+  state.SetBytesProcessed(bytes * state.iterations());
+}
+
+void MessageSizeArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("size");
+  for (int size = 64; size <= 1 << 20; size <<= 2) {
+    benchmark->Arg(size);
+  }
+}
+
+// Registers BM_UnixPingPong and BM_UnixStream for each of
+// UnixStreamSocketPairs.
+const bool kUnixBenchmarksRegistered = [] {
+  for (const SocketPairKind& kind : UnixStreamSocketPairs()) {
+    benchmark::RegisterBenchmark(
+        ("BM_UnixPingPong/" + kind.description).c_str(),
+        [kind](benchmark::State& state) { BM_UnixPingPong(state, kind); })
+        ->Apply(&MessageSizeArgs)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(
+        ("BM_UnixStream/" + kind.description).c_str(),
+        [kind](benchmark::State& state) { BM_UnixStream(state, kind); })
+        ->Apply(&MessageSizeArgs)
+        ->UseRealTime();
+  }
+  return true;
+}();
+
+// Size of the datagrams sent by BM_UnixDgramManyToOne, about that of a
+// syslog(3) message.
+constexpr int kDgramSize = 128;
+
+// BM_UnixDgramManyToOne measures the throughput of one filesystem-bound unix
+// datagram socket (as /dev/log is) receiving kDgramSize datagrams from
+// state.range(0) writer threads, each with its own socket connected to it.
+// The reader receives up to state.range(1) datagrams per call, with recv for
+// 1 and recvmmsg otherwise. All writers contend with each other and with the
+// reader on the reading socket's queue.
+void BM_UnixDgramManyToOne(benchmark::State& state) {
+  const int nwriters = state.range(0);
+  const int batch = state.range(1);
+  std::unique_ptr<SocketPair> sockets = ASSERT_NO_ERRNO_AND_VALUE(
+      FilesystemUnboundUnixDomainSocketPair(SOCK_DGRAM).Create());
+  ASSERT_THAT(bind(sockets->first_fd(), sockets->first_addr(),
+                   sockets->first_addr_size()),
+              SyscallSucceeds());
+
+  absl::Notification notification;
+  std::atomic<int64_t> messages_sent{0};
+  std::vector<FileDescriptor> write_sockets;
+  std::vector<std::unique_ptr<ScopedThread>> writers;
+  for (int i = 0; i < nwriters; i++) {
+    write_sockets.push_back(
+        ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_UNIX, SOCK_DGRAM, 0)));
+    const int fd = write_sockets.back().get();
+    ASSERT_THAT(
+        connect(fd, sockets->first_addr(), sockets->first_addr_size()),
+        SyscallSucceeds());
+    writers.push_back(
+        absl::make_unique<ScopedThread>([fd, &notification, &messages_sent] {
+          char buf[kDgramSize] = {};
+          // Writers don't block, so that they notice the notification once
+          // the reader stops draining the queue.
+          while (!notification.HasBeenNotified()) {
+            if (send(fd, buf, sizeof(buf), MSG_DONTWAIT) == sizeof(buf)) {
+              messages_sent++;
+            }
+          }
+        }));
+  }
+
+  std::vector<char> buf(batch * kDgramSize);
+  std::vector<struct iovec> iovs(batch);
+  std::vector<struct mmsghdr> hdrs(batch);
+  for (int i = 0; i < batch; i++) {
+    iovs[i].iov_base = &buf[i * kDgramSize];
+    iovs[i].iov_len = kDgramSize;
+    hdrs[i].msg_hdr.msg_iov = &iovs[i];
+    hdrs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int64_t messages_received = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    if (batch == 1) {
+      TEST_PCHECK(recv(sockets->first_fd(), buf.data(), kDgramSize, 0) ==
+                  kDgramSize);
+      messages_received++;
+    } else {
+      // MSG_WAITFORONE returns whatever has been queued once the first
+      // datagram arrives.
+      const int n = recvmmsg(sockets->first_fd(), hdrs.data(), batch,
+                             MSG_WAITFORONE, nullptr);
+      TEST_PCHECK(n > 0);
+      messages_received += n;
+    }
+  }
+
+  notification.Notify();
+  writers.clear();
+
+  state.SetItemsProcessed(messages_received);
+  state.SetBytesProcessed(messages_received * kDgramSize);
+  state.counters["sent"] = benchmark::Counter(
+      static_cast<double>(messages_sent.load()), benchmark::Counter::kIsRate);
+}
+
+void ManyToOneArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"writers", "batch"});
+  for (int batch : {1, 64}) {
+    for (int n = 1; n < 256; n *= 4) {
+      benchmark->Args({n, batch});
+    }
+    benchmark->Args({256, batch});
+  }
+}
+
+BENCHMARK(BM_UnixDgramManyToOne)->Apply(&ManyToOneArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
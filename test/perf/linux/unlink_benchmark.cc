@@ -18,6 +18,7 @@
 
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
 #include "test/util/fs_util.h"
 #include "test/util/temp_path.h"
 #include "test/util/test_util.h"
@@ -35,6 +36,7 @@ void BM_Unlink(benchmark::State& state) {
   // We unlink all files on each iteration, but report this as a "batch"
   // iteration so that reported times are per file.
   TempPath dir;
+  ScopedRusageCounters rusage(state);
   while (state.KeepRunningBatch(file_count)) {
     state.PauseTiming();
     // N.B. dir is declared outside the loop so that destruction of the previous
@@ -0,0 +1,105 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/time.h>
+#include <time.h>
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/logging.h"
+#include "test/util/proc_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+#if defined(__x86_64__)
+
+constexpr uint64_t kVsyscallGettimeofdayEntry = 0xffffffffff600000;
+constexpr uint64_t kVsyscallTimeEntry = 0xffffffffff600400;
+
+// Returns true if vsyscalls can be benchmarked, and otherwise marks state as
+// skipped.
+bool CheckVsyscall(benchmark::State& state) {
+  auto enabled = IsVsyscallEnabled();
+  if (!enabled.ok() || !enabled.ValueOrDie()) {
+    state.SkipWithError("vsyscall is not enabled");
+    return false;
+  }
+  return true;
+}
+
+// BM_VsyscallTime measures time(2) through the legacy vsyscall page, as called
+// by old statically linked binaries. Compare with BM_VdsoTime.
+void BM_VsyscallTime(benchmark::State& state) {
+  if (!CheckVsyscall(state)) {
+    return;
+  }
+  auto vsyscall_time =
+      reinterpret_cast<time_t (*)(time_t*)>(kVsyscallTimeEntry);
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vsyscall_time(nullptr));
+  }
+}
+
+BENCHMARK(BM_VsyscallTime);
+
+// BM_VsyscallGettimeofday measures gettimeofday(2) through the legacy vsyscall
+// page. Compare with BM_VdsoGettimeofday.
+void BM_VsyscallGettimeofday(benchmark::State& state) {
+  if (!CheckVsyscall(state)) {
+    return;
+  }
+  auto vsyscall_gettimeofday = reinterpret_cast<int (*)(
+      struct timeval*, struct timezone*)>(kVsyscallGettimeofdayEntry);
+  struct timeval tv;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(vsyscall_gettimeofday(&tv, nullptr) == 0);
+  }
+}
+
+BENCHMARK(BM_VsyscallGettimeofday);
+
+#endif  // defined(__x86_64__)
+
+// BM_VdsoTime measures time(2) through libc, which uses __vdso_time.
+void BM_VdsoTime(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(time(nullptr));
+  }
+}
+
+BENCHMARK(BM_VdsoTime);
+
+// BM_VdsoGettimeofday measures gettimeofday(2) through libc, which uses
+// __vdso_gettimeofday.
+void BM_VdsoGettimeofday(benchmark::State& state) {
+  struct timeval tv;
+  for (auto _ : state) {
+    TEST_CHECK(gettimeofday(&tv, nullptr) == 0);
+  }
+}
+
+BENCHMARK(BM_VdsoGettimeofday);
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,87 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/stat.h>
+#include <sys/xattr.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Number of directories in the tree walked by BM_XattrTreeWalk.
+constexpr int kDirs = 16;
+
+constexpr char kUserXattr[] = "user.test";
+
+// BM_XattrTreeWalk walks a tree of kDirs directories holding state.range(0)
+// files each, and queries the extended attributes of every entry the way
+// label-aware archivers and rsync -X do: a getxattr of a security label that
+// is usually absent, a getxattr of a user attribute that is set if supported,
+// and a listxattr. The user attribute is set before timing where supported.
+void BM_XattrTreeWalk(benchmark::State& state) {
+  const int files = state.range(0);
+  const TempPath root = TempPath::CreateDir().ValueOrDie();
+  for (int i = 0; i < kDirs; i++) {
+    const std::string dir = JoinPath(root.path(), absl::StrCat(i));
+    TEST_CHECK(Mkdir(dir, 0755).ok());
+    for (int j = 0; j < files; j++) {
+      const std::string file = JoinPath(dir, absl::StrCat(j));
+      TEST_CHECK(CreateWithContents(file, "").ok());
+      // Best effort; the filesystem may not support user xattrs.
+      lsetxattr(file.c_str(), kUserXattr, "1", 1, 0);
+    }
+  }
+
+  char buf[256];
+  int64_t entries = 0;
+  ScopedRusageCounters rusage(state);
+  for (auto _ : state) {
+    TEST_CHECK(WalkTree(root.path(), /*recursive=*/true,
+                        [&](absl::string_view path, const struct stat&) {
+                          const std::string p(path);
+                          lgetxattr(p.c_str(), "security.selinux", buf,
+                                    sizeof(buf));
+                          lgetxattr(p.c_str(), kUserXattr, buf, sizeof(buf));
+                          llistxattr(p.c_str(), buf, sizeof(buf));
+                          entries++;
+                        })
+                   .ok());
+  }
+  state.SetItemsProcessed(entries);
+}
+
+BENCHMARK(BM_XattrTreeWalk)
+    ->ArgName("files")
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
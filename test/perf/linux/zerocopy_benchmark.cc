@@ -0,0 +1,284 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "test/syscalls/linux/ip_socket_test_util.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/benchmark_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Modes of BM_Zerocopy.
+enum class Mode {
+  // send(2) from a user buffer. This is the copy-based baseline.
+  kCopy,
+
+  // sendfile(2) from a file.
+  kSendfile,
+
+  // splice(2) from a pipe filled with vmsplice(2).
+  kSplice,
+
+  // send(2) with MSG_ZEROCOPY, reaping completions from the error queue.
+  kMsgZerocopy,
+};
+
+// Largest chunk passed to a single splice or vmsplice call.
+constexpr int kPipeSize = 1 << 20;
+
+// CPUTime returns the CPU time used by all threads of the process.
+absl::Duration CPUTime() {
+  struct rusage ru;
+  TEST_CHECK(getrusage(RUSAGE_SELF, &ru) == 0);
+  return absl::DurationFromTimeval(ru.ru_utime) +
+         absl::DurationFromTimeval(ru.ru_stime);
+}
+
+// ZerocopyCompletions reaps MSG_ZEROCOPY completions from fd's error queue.
+// It returns the number of sends completed, and adds the number of those for
+// which the kernel fell back to copying to *copied.
+int64_t ZerocopyCompletions(int fd, int64_t* copied) {
+  int64_t completed = 0;
+  while (true) {
+    char control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+    struct msghdr msg = {};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      TEST_CHECK(errno == EAGAIN);
+      return completed;
+    }
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      auto* err = reinterpret_cast<struct sock_extended_err*>(CMSG_DATA(cmsg));
+      if (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      // Completions are reported as the inclusive range of send counters
+      // [ee_info, ee_data].
+      int64_t n = err->ee_data - err->ee_info + 1;
+      completed += n;
+      if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        *copied += n;
+      }
+    }
+  }
+}
+
+// BM_Zerocopy sends state.range(0) bytes per iteration over a loopback TCP
+// connection using mode. In addition to bytes/sec, it reports the CPU time
+// used per byte by the whole process, including the receiving thread.
+void BM_Zerocopy(benchmark::State& state, Mode mode) {
+  const int buf_size = state.range(0);
+
+  auto sockets =
+      ASSERT_NO_ERRNO_AND_VALUE(IPv4TCPAcceptBindSocketPair(0).Create());
+  FileDescriptor send_socket(sockets->release_first_fd());
+  FileDescriptor recv_socket(sockets->release_second_fd());
+
+  std::vector<char> buf(buf_size, 'a');
+  FileDescriptor file;
+  TempPath path;
+  FileDescriptor pipe_read, pipe_write;
+  switch (mode) {
+    case Mode::kCopy:
+      break;
+    case Mode::kSendfile: {
+      path = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+          GetAbsoluteTestTmpdir(), absl::string_view(buf.data(), buf.size()),
+          TempPath::kDefaultFileMode));
+      file = ASSERT_NO_ERRNO_AND_VALUE(Open(path.path(), O_RDONLY));
+      break;
+    }
+    case Mode::kSplice: {
+      int fds[2];
+      ASSERT_THAT(pipe(fds), SyscallSucceeds());
+      pipe_read = FileDescriptor(fds[0]);
+      pipe_write = FileDescriptor(fds[1]);
+      // Best effort; splice in smaller chunks if the pipe cannot grow.
+      fcntl(pipe_write.get(), F_SETPIPE_SZ, kPipeSize);
+      break;
+    }
+    case Mode::kMsgZerocopy: {
+      int one = 1;
+      if (setsockopt(send_socket.get(), SOL_SOCKET, SO_ZEROCOPY, &one,
+                     sizeof(one)) < 0) {
+        state.SkipWithError("SO_ZEROCOPY is not supported");
+        return;
+      }
+      break;
+    }
+  }
+
+  ScopedThread t([&recv_socket, buf_size] {
+    std::vector<char> recv_buf(std::min(buf_size, kPipeSize));
+    while (read(recv_socket.get(), recv_buf.data(), recv_buf.size()) > 0) {
+    }
+  });
+
+  int64_t zerocopy_sent = 0;
+  int64_t zerocopy_completed = 0;
+  int64_t zerocopy_copied = 0;
+  const absl::Duration start = CPUTime();
+  ScopedRusageCounters rusage(state);
+  for (auto ignored : state) {
+    int64_t sent = 0;
+    switch (mode) {
+      case Mode::kCopy:
+        while (sent < buf_size) {
+          int n = send(send_socket.get(), buf.data() + sent, buf_size - sent,
+                       0);
+          TEST_CHECK(n > 0);
+          sent += n;
+        }
+        break;
+      case Mode::kSendfile: {
+        off_t offset = 0;
+        while (sent < buf_size) {
+          int n = sendfile(send_socket.get(), file.get(), &offset,
+                           buf_size - sent);
+          TEST_CHECK(n > 0);
+          sent += n;
+        }
+        break;
+      }
+      case Mode::kSplice:
+        while (sent < buf_size) {
+          struct iovec iov = {buf.data() + sent,
+                              static_cast<size_t>(
+                                  std::min<int64_t>(buf_size - sent,
+                                                    kPipeSize))};
+          int in = vmsplice(pipe_write.get(), &iov, 1, 0);
+          TEST_CHECK(in > 0);
+          for (int out = 0; out < in;) {
+            int n = splice(pipe_read.get(), nullptr, send_socket.get(),
+                           nullptr, in - out, SPLICE_F_MOVE);
+            TEST_CHECK(n > 0);
+            out += n;
+          }
+          sent += in;
+        }
+        break;
+      case Mode::kMsgZerocopy:
+        while (sent < buf_size) {
+          int n = send(send_socket.get(), buf.data() + sent, buf_size - sent,
+                       MSG_ZEROCOPY);
+          if (n < 0 && errno == ENOBUFS) {
+            // Too many outstanding completions; reap them and retry.
+            zerocopy_completed +=
+                ZerocopyCompletions(send_socket.get(), &zerocopy_copied);
+            continue;
+          }
+          TEST_CHECK(n > 0);
+          sent += n;
+          zerocopy_sent++;
+        }
+        zerocopy_completed +=
+            ZerocopyCompletions(send_socket.get(), &zerocopy_copied);
+        break;
+    }
+  }
+
+  // buf must outlive all outstanding zerocopy sends.
+  while (zerocopy_completed < zerocopy_sent) {
+    struct pollfd poll_fd = {send_socket.get(), 0, 0};
+    TEST_CHECK(RetryEINTR(poll)(&poll_fd, 1, 1000) > 0);
+    zerocopy_completed +=
+        ZerocopyCompletions(send_socket.get(), &zerocopy_copied);
+  }
+  const absl::Duration cpu = CPUTime() - start;
+
+  send_socket.reset();
+  t.Join();
+
+  const int64_t bytes = static_cast<int64_t>(buf_size) * state.iterations();
+  state.SetBytesProcessed(bytes);
+  if (bytes > 0) {
+    state.counters["cpu_ns_per_byte"] =
+        absl::ToDoubleNanoseconds(cpu) / static_cast<double>(bytes);
+  }
+  if (mode == Mode::kMsgZerocopy && zerocopy_sent > 0) {
+    // Fraction of zerocopy sends for which the kernel copied anyway, which
+    // is typical for loopback delivery.
+    state.counters["copied"] = static_cast<double>(zerocopy_copied) /
+                               static_cast<double>(zerocopy_sent);
+  }
+}
+
+// Args matches the buffer sizes of BM_SendmsgTCP.
+void Args(benchmark::internal::Benchmark* benchmark) {
+  for (int buf_size = 1024; buf_size <= 256 << 20; buf_size *= 2) {
+    benchmark->Arg(buf_size);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_Zerocopy, copy, Mode::kCopy)
+    ->Apply(&Args)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_Zerocopy, sendfile, Mode::kSendfile)
+    ->Apply(&Args)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_Zerocopy, splice, Mode::kSplice)
+    ->Apply(&Args)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_Zerocopy, msg_zerocopy, Mode::kMsgZerocopy)
+    ->Apply(&Args)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
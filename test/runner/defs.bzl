@@ -1,6 +1,7 @@
 """Defines a rule for syscall test targets."""
 
 load("//tools:defs.bzl", "default_platform", "loopback", "platforms")
+load("//tools/vm:defs.bzl", "vm_test")
 
 def _runner_test_impl(ctx):
     # Generate a runner binary.
@@ -15,7 +16,7 @@ def _runner_test_impl(ctx):
         "exec %s %s %s\n" % (
             ctx.files.runner[0].short_path,
             " ".join(ctx.attr.runner_args),
-            ctx.files.test[0].short_path,
+            " ".join([f.short_path for f in ctx.files.test + ctx.files.tests]),
         ),
     ])
     ctx.actions.write(runner, runner_content, is_executable = True)
@@ -24,10 +25,10 @@ def _runner_test_impl(ctx):
     runfiles = ctx.runfiles(
         transitive_files = depset(transitive = [
             target.data_runfiles.files
-            for target in (ctx.attr.runner, ctx.attr.test)
+            for target in [ctx.attr.runner, ctx.attr.test] + ctx.attr.tests
             if hasattr(target, "data_runfiles")
         ]),
-        files = ctx.files.runner + ctx.files.test,
+        files = ctx.files.runner + ctx.files.test + ctx.files.tests,
         collect_default = True,
         collect_data = True,
     )
@@ -38,9 +39,8 @@ _runner_test = rule(
         "runner": attr.label(
             default = "//test/runner:runner",
         ),
-        "test": attr.label(
-            mandatory = True,
-        ),
+        "test": attr.label(),
+        "tests": attr.label_list(),
         "runner_args": attr.string_list(),
         "data": attr.label_list(
             allow_files = True,
@@ -235,3 +235,75 @@ def syscall_test(
             file_access = "shared",
             vfs2 = True,
         )
+
+def syscall_test_group(
+        name,
+        tests,
+        platform = default_platform,
+        shard_count = 5,
+        size = "medium",
+        tags = None):
+    """syscall_test_group runs several syscall tests in a single sandbox.
+
+    Starting a sandbox takes longer than running most test cases, so this is
+    much faster than running the syscall_test targets of the same tests. Test
+    cases only get their own TEST_TMPDIR (see --reuse-sandbox in runner.go), so
+    only group tests that don't change other sandbox state, e.g. mounts or the
+    hostname. The group is manual, since its tests also have their own targets.
+
+    Args:
+      name: the name of the group.
+      tests: the test targets.
+      platform: the platform to run on.
+      shard_count: shards for defined tests.
+      size: the defined test size.
+      tags: starting test tags.
+    """
+    if tags == None:
+        tags = []
+    _runner_test(
+        name = name,
+        tests = tests,
+        runner_args = [
+            "--platform=" + platform,
+            "--reuse-sandbox=True",
+        ],
+        data = [loopback],
+        size = size,
+        tags = tags + platforms[platform] + [
+            "runsc_" + platform,
+            "requires-net:loopback",
+            "manual",
+        ],
+        shard_count = shard_count,
+    )
+
+def syscall_vm_test(name, platform, **kwargs):
+    """syscall_vm_test runs a package's syscall tests for a platform in a VM.
+
+    It must be called after all syscall_test targets in the package. Only the
+    default variant of each test is run (no overlay, shared file access, VFS2
+    or host networking), so that the results are comparable with the same
+    tests run directly on the host.
+
+    Args:
+      name: the name of the VM test.
+      platform: the platform whose tests are run, or "native".
+      **kwargs: additional vm_test arguments, e.g. image or machine.
+    """
+
+    # The runner brings its own runsc, so nothing needs to be installed.
+    installers = kwargs.pop("installers", [])
+    full_platform = platform if platform == "native" else "runsc_" + platform
+    targets = [
+        ":" + rule["name"]
+        for rule in native.existing_rules().values()
+        if rule["kind"] == "_runner_test" and
+           rule["name"].endswith("_" + full_platform)
+    ]
+    vm_test(
+        name = name,
+        installers = installers,
+        targets = sorted(targets),
+        **kwargs
+    )
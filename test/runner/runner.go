@@ -25,6 +25,7 @@ import (
 	"os/signal"
 	"path/filepath"
 	"strings"
+	"sync"
 	"syscall"
 	"testing"
 	"time"
@@ -50,9 +51,13 @@ var (
 	parallel   = flag.Bool("parallel", false, "run tests in parallel")
 	runscPath  = flag.String("runsc", "", "path to runsc binary")
 
-	addUDSTree = flag.Bool("add-uds-tree", false, "expose a tree of UDS utilities for use in tests")
+	addUDSTree   = flag.Bool("add-uds-tree", false, "expose a tree of UDS utilities for use in tests")
+	reuseSandbox = flag.Bool("reuse-sandbox", false, "run all test cases in a single sandbox instead of one sandbox per test case")
 )
 
+// sandbox runs all test cases, if --reuse-sandbox is set.
+var sandbox *sharedSandbox
+
 // runTestCaseNative runs the test case directly on the host machine.
 func runTestCaseNative(testBin string, tc gtest.TestCase, t *testing.T) {
 	// These tests might be running in parallel, so make sure they have a
@@ -110,31 +115,11 @@ func runTestCaseNative(testBin string, tc gtest.TestCase, t *testing.T) {
 	}
 }
 
-// runRunsc runs spec in runsc in a standard test configuration.
+// runscArgs returns the global runsc flags for the sandbox running name.
 //
 // runsc logs will be saved to a path in TEST_UNDECLARED_OUTPUTS_DIR.
-//
-// Returns an error if the sandboxed application exits non-zero.
-func runRunsc(tc gtest.TestCase, spec *specs.Spec) error {
-	bundleDir, cleanup, err := testutil.SetupBundleDir(spec)
-	if err != nil {
-		return fmt.Errorf("SetupBundleDir failed: %v", err)
-	}
-	defer cleanup()
-
-	rootDir, cleanup, err := testutil.SetupRootDir()
-	if err != nil {
-		return fmt.Errorf("SetupRootDir failed: %v", err)
-	}
-	defer cleanup()
-
-	name := tc.FullName()
-	id := testutil.RandomContainerID()
-	log.Infof("Running test %q in container %q", name, id)
-	specutils.LogSpec(spec)
-
+func runscArgs(name string) ([]string, error) {
 	args := []string{
-		"-root", rootDir,
 		"-network", *network,
 		"-log-format=text",
 		"-TESTONLY-unsafe-nonroot=true",
@@ -163,11 +148,11 @@ func runRunsc(tc gtest.TestCase, spec *specs.Spec) error {
 	if outDir, ok := syscall.Getenv("TEST_UNDECLARED_OUTPUTS_DIR"); ok {
 		tdir := filepath.Join(outDir, strings.Replace(name, "/", "_", -1))
 		if err := os.MkdirAll(tdir, 0755); err != nil {
-			return fmt.Errorf("could not create test dir: %v", err)
+			return nil, fmt.Errorf("could not create test dir: %v", err)
 		}
 		debugLogDir, err := ioutil.TempDir(tdir, "runsc")
 		if err != nil {
-			return fmt.Errorf("could not create temp dir: %v", err)
+			return nil, fmt.Errorf("could not create temp dir: %v", err)
 		}
 		debugLogDir += "/"
 		log.Infof("runsc logs: %s", debugLogDir)
@@ -178,11 +163,14 @@ func runRunsc(tc gtest.TestCase, spec *specs.Spec) error {
 		// better place for these messages.
 		args = append(args, "-log=/dev/null")
 	}
+	return args, nil
+}
 
+// runscCommand returns a command running runsc with args.
+func runscCommand(args ...string) *exec.Cmd {
 	// Current process doesn't have CAP_SYS_ADMIN, create user namespace and run
 	// as root inside that namespace to get it.
-	rArgs := append(args, "run", "--bundle", bundleDir, id)
-	cmd := exec.Command(*runscPath, rArgs...)
+	cmd := exec.Command(*runscPath, args...)
 	cmd.SysProcAttr = &syscall.SysProcAttr{
 		Cloneflags: syscall.CLONE_NEWUSER | syscall.CLONE_NEWNS,
 		// Set current user/group as root inside the namespace.
@@ -200,6 +188,13 @@ func runRunsc(tc gtest.TestCase, spec *specs.Spec) error {
 	}
 	cmd.Stdout = os.Stdout
 	cmd.Stderr = os.Stderr
+	return cmd
+}
+
+// runWithStacks runs cmd, which runs test name in container id. If the runner
+// gets SIGTERM (e.g. because the test timed out), the sandbox stacks are
+// dumped and the sandbox is sent SIGTERM too. args are the global runsc flags.
+func runWithStacks(cmd *exec.Cmd, name, id string, args []string) error {
 	sig := make(chan os.Signal, 1)
 	signal.Notify(sig, syscall.SIGTERM)
 	go func() {
@@ -236,7 +231,7 @@ func runRunsc(tc gtest.TestCase, spec *specs.Spec) error {
 		cmd.Run()
 	}()
 
-	err = cmd.Run()
+	err := cmd.Run()
 
 	signal.Stop(sig)
 	close(sig)
@@ -244,6 +239,140 @@ func runRunsc(tc gtest.TestCase, spec *specs.Spec) error {
 	return err
 }
 
+// runRunsc runs spec in runsc in a standard test configuration.
+//
+// Returns an error if the sandboxed application exits non-zero.
+func runRunsc(tc gtest.TestCase, spec *specs.Spec) error {
+	bundleDir, cleanup, err := testutil.SetupBundleDir(spec)
+	if err != nil {
+		return fmt.Errorf("SetupBundleDir failed: %v", err)
+	}
+	defer cleanup()
+
+	rootDir, cleanup, err := testutil.SetupRootDir()
+	if err != nil {
+		return fmt.Errorf("SetupRootDir failed: %v", err)
+	}
+	defer cleanup()
+
+	name := tc.FullName()
+	id := testutil.RandomContainerID()
+	log.Infof("Running test %q in container %q", name, id)
+	specutils.LogSpec(spec)
+
+	args, err := runscArgs(name)
+	if err != nil {
+		return err
+	}
+	args = append([]string{"-root", rootDir}, args...)
+
+	rArgs := append(args, "run", "--bundle", bundleDir, id)
+	return runWithStacks(runscCommand(rArgs...), name, id, args)
+}
+
+// sharedSandbox is a sandbox that is started once and runs every test case,
+// with --reuse-sandbox. This saves starting a sandbox per test case, which
+// dominates the run time of small tests.
+//
+// Each test case runs in a new process (with runsc exec) and gets an empty
+// TEST_TMPDIR, which is removed when it exits. Other state, such as mounts or
+// the hostname, is shared between test cases, so this should only be used for
+// tests that don't change it.
+type sharedSandbox struct {
+	// id is the container ID of the sandbox.
+	id string
+
+	// args are the global runsc flags for the sandbox.
+	args []string
+
+	// tmpDir is the directory in the sandbox that TEST_TMPDIR of each test
+	// case is created in.
+	tmpDir string
+
+	// initStdin is the write end of the stdin of the sandbox's init
+	// process, which waits for its stdin to be closed. It is never closed
+	// explicitly: the sandbox exits when the runner does.
+	initStdin *os.File
+
+	// mu protects next.
+	mu sync.Mutex
+
+	// next is the index of the next test case, used to name its
+	// TEST_TMPDIR.
+	next int
+}
+
+// startSharedSandbox starts a sandbox to run test cases in.
+func startSharedSandbox() (*sharedSandbox, error) {
+	// The init process only waits for the runner to exit. The files it
+	// uses are cleaned up with TEST_TMPDIR once the test is done.
+	spec, tmpDir, _, err := newTestSpec([]string{"/bin/sh", "-c", "read -r _"})
+	if err != nil {
+		return nil, err
+	}
+	bundleDir, _, err := testutil.SetupBundleDir(spec)
+	if err != nil {
+		return nil, fmt.Errorf("SetupBundleDir failed: %v", err)
+	}
+	rootDir, _, err := testutil.SetupRootDir()
+	if err != nil {
+		return nil, fmt.Errorf("SetupRootDir failed: %v", err)
+	}
+
+	s := &sharedSandbox{
+		id:     testutil.RandomContainerID(),
+		tmpDir: tmpDir,
+	}
+	log.Infof("Running all tests in container %q", s.id)
+	specutils.LogSpec(spec)
+
+	args, err := runscArgs("sandbox")
+	if err != nil {
+		return nil, err
+	}
+	s.args = append([]string{"-root", rootDir}, args...)
+
+	r, w, err := os.Pipe()
+	if err != nil {
+		return nil, err
+	}
+	defer r.Close()
+	s.initStdin = w
+
+	cmd := runscCommand(append(s.args, "create", "--bundle", bundleDir, s.id)...)
+	cmd.Stdin = r
+	if err := cmd.Run(); err != nil {
+		return nil, fmt.Errorf("runsc create failed: %v", err)
+	}
+	if err := runscCommand(append(s.args, "start", s.id)...).Run(); err != nil {
+		return nil, fmt.Errorf("runsc start failed: %v", err)
+	}
+	return s, nil
+}
+
+// run runs test case tc of testBin in the sandbox.
+//
+// Returns an error if the test case exits non-zero.
+func (s *sharedSandbox) run(testBin string, tc gtest.TestCase) error {
+	s.mu.Lock()
+	n := s.next
+	s.next++
+	s.mu.Unlock()
+
+	// Test cases may run in parallel, and must not see each other's
+	// files, so give each its own TEST_TMPDIR. Some tests (e.g., sticky)
+	// access it from other users, so make it world-accessible.
+	tmpDir := filepath.Join(s.tmpDir, fmt.Sprintf("case%d", n))
+	const script = `mkdir -m 0777 "$TEST_TMPDIR" || exit; "$@"; rc=$?; rm -rf "$TEST_TMPDIR"; exit $rc`
+
+	name := tc.FullName()
+	log.Infof("Running test %q in container %q", name, s.id)
+	eArgs := append([]string{}, s.args...)
+	eArgs = append(eArgs, "exec", "-env", "TEST_TMPDIR="+tmpDir, s.id, "/bin/sh", "-c", script, "sh", testBin)
+	eArgs = append(eArgs, tc.Args()...)
+	return runWithStacks(runscCommand(eArgs...), name, s.id, s.args)
+}
+
 // setupUDSTree updates the spec to expose a UDS tree for gofer socket testing.
 func setupUDSTree(spec *specs.Spec) (cleanup func(), err error) {
 	socketDir, cleanup, err := uds.CreateSocketTree("/tmp")
@@ -292,11 +421,23 @@ func setupUDSTree(spec *specs.Spec) (cleanup func(), err error) {
 	return cleanup, nil
 }
 
-// runsTestCaseRunsc runs the test case in runsc.
-func runTestCaseRunsc(testBin string, tc gtest.TestCase, t *testing.T) {
-	// Run a new container with the test executable and filter for the
-	// given test suite and name.
-	spec := testutil.NewSpecWithArgs(append([]string{testBin}, tc.Args()...)...)
+// newTestSpec returns the spec of a container running argv in the test
+// configuration, and the TEST_TMPDIR it sets. cleanup must be called once the
+// container has exited.
+func newTestSpec(argv []string) (spec *specs.Spec, testTmpDir string, cleanup func(), err error) {
+	var cleanups []func()
+	cleanup = func() {
+		for i := len(cleanups) - 1; i >= 0; i-- {
+			cleanups[i]()
+		}
+	}
+	defer func() {
+		if err != nil {
+			cleanup()
+		}
+	}()
+
+	spec = testutil.NewSpecWithArgs(argv...)
 
 	// Mark the root as writeable, as some tests attempt to
 	// write to the rootfs, and expect EACCES, not EROFS.
@@ -304,7 +445,7 @@ func runTestCaseRunsc(testBin string, tc gtest.TestCase, t *testing.T) {
 
 	// Test spec comes with pre-defined mounts that we don't want. Reset it.
 	spec.Mounts = nil
-	testTmpDir := "/tmp"
+	testTmpDir = "/tmp"
 	if *useTmpfs {
 		// Forces '/tmp' to be mounted as tmpfs, otherwise test that rely on
 		// features only available in gVisor's internal tmpfs may fail.
@@ -322,12 +463,12 @@ func runTestCaseRunsc(testBin string, tc gtest.TestCase, t *testing.T) {
 		// users, so make sure it is world-accessible.
 		tmpDir, err := ioutil.TempDir(testutil.TmpDir(), "")
 		if err != nil {
-			t.Fatalf("could not create temp dir: %v", err)
+			return nil, "", nil, fmt.Errorf("could not create temp dir: %v", err)
 		}
-		defer os.RemoveAll(tmpDir)
+		cleanups = append(cleanups, func() { os.RemoveAll(tmpDir) })
 
 		if err := os.Chmod(tmpDir, 0777); err != nil {
-			t.Fatalf("could not chmod temp dir: %v", err)
+			return nil, "", nil, fmt.Errorf("could not chmod temp dir: %v", err)
 		}
 
 		// "/tmp" is not replaced with a tmpfs mount inside the sandbox
@@ -370,13 +511,33 @@ func runTestCaseRunsc(testBin string, tc gtest.TestCase, t *testing.T) {
 	spec.Process.Env = env
 
 	if *addUDSTree {
-		cleanup, err := setupUDSTree(spec)
+		udsCleanup, err := setupUDSTree(spec)
 		if err != nil {
-			t.Fatalf("error creating UDS tree: %v", err)
+			return nil, "", nil, fmt.Errorf("error creating UDS tree: %v", err)
 		}
-		defer cleanup()
+		cleanups = append(cleanups, udsCleanup)
 	}
 
+	return spec, testTmpDir, cleanup, nil
+}
+
+// runsTestCaseRunsc runs the test case in runsc.
+func runTestCaseRunsc(testBin string, tc gtest.TestCase, t *testing.T) {
+	if sandbox != nil {
+		if err := sandbox.run(testBin, tc); err != nil {
+			t.Errorf("test %q failed with error %v, want nil", tc.FullName(), err)
+		}
+		return
+	}
+
+	// Run a new container with the test executable and filter for the
+	// given test suite and name.
+	spec, _, cleanup, err := newTestSpec(append([]string{testBin}, tc.Args()...))
+	if err != nil {
+		t.Fatalf("%v", err)
+	}
+	defer cleanup()
+
 	if err := runRunsc(tc, spec); err != nil {
 		t.Errorf("test %q failed with error %v, want nil", tc.FullName(), err)
 	}
@@ -411,10 +572,9 @@ func matchString(a, b string) (bool, error) {
 
 func main() {
 	flag.Parse()
-	if flag.NArg() != 1 {
+	if flag.NArg() == 0 {
 		fatalf("test must be provided")
 	}
-	testBin := flag.Args()[0] // Only argument.
 
 	log.SetLevel(log.Info)
 	if *debug {
@@ -445,9 +605,25 @@ func main() {
 	}
 
 	// Get all test cases in each binary.
-	testCases, err := gtest.ParseTestCases(testBin, true)
-	if err != nil {
-		fatalf("ParseTestCases(%q) failed: %v", testBin, err)
+	type binaryTestCase struct {
+		testBin string
+		tc      gtest.TestCase
+	}
+	var testCases []binaryTestCase
+	for _, testBin := range flag.Args() {
+		binTestCases, err := gtest.ParseTestCases(testBin, true)
+		if err != nil {
+			fatalf("ParseTestCases(%q) failed: %v", testBin, err)
+		}
+
+		// Resolve the absolute path for the binary.
+		testBin, err = filepath.Abs(testBin)
+		if err != nil {
+			fatalf("Abs() failed: %v", err)
+		}
+		for _, tc := range binTestCases {
+			testCases = append(testCases, binaryTestCase{testBin, tc})
+		}
 	}
 
 	// Get subset of tests corresponding to shard.
@@ -456,19 +632,24 @@ func main() {
 		fatalf("TestsForShard() failed: %v", err)
 	}
 
-	// Resolve the absolute path for the binary.
-	testBin, err = filepath.Abs(testBin)
-	if err != nil {
-		fatalf("Abs() failed: %v", err)
+	if *reuseSandbox && *platform != "native" && len(indices) > 0 {
+		sandbox, err = startSharedSandbox()
+		if err != nil {
+			fatalf("starting sandbox failed: %v", err)
+		}
 	}
 
 	// Run the tests.
 	var tests []testing.InternalTest
 	for _, tci := range indices {
-		// Capture tc.
-		tc := testCases[tci]
+		// Capture testBin and tc.
+		testBin, tc := testCases[tci].testBin, testCases[tci].tc
+		name := fmt.Sprintf("%s_%s", tc.Suite, tc.Name)
+		if flag.NArg() > 1 {
+			name = filepath.Base(testBin) + "_" + name
+		}
 		tests = append(tests, testing.InternalTest{
-			Name: fmt.Sprintf("%s_%s", tc.Suite, tc.Name),
+			Name: name,
 			F: func(t *testing.T) {
 				if *parallel {
 					t.Parallel()
@@ -0,0 +1,143 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+#ifndef SYS_close_range
+#define SYS_close_range 436
+#endif
+
+#ifndef CLOSE_RANGE_UNSHARE
+#define CLOSE_RANGE_UNSHARE (1U << 1)
+#endif
+
+#ifndef CLOSE_RANGE_CLOEXEC
+#define CLOSE_RANGE_CLOEXEC (1U << 2)
+#endif
+
+// First fd used by tests, chosen to be well above any fds inherited from the
+// test runner.
+constexpr int kBaseFD = 1000;
+
+int CloseRange(unsigned int first, unsigned int last, unsigned int flags) {
+  return syscall(SYS_close_range, first, last, flags);
+}
+
+// Dups fd to kBaseFD + i for each i in [0, n), and returns the new fds.
+std::vector<int> DupToRange(const FileDescriptor& fd, int n) {
+  std::vector<int> fds;
+  for (int i = 0; i < n; i++) {
+    const int nfd = dup2(fd.get(), kBaseFD + i);
+    TEST_PCHECK(nfd == kBaseFD + i);
+    fds.push_back(nfd);
+  }
+  return fds;
+}
+
+bool IsOpen(int fd) { return fcntl(fd, F_GETFD) >= 0; }
+
+TEST(CloseRangeTest, ClosesRange) {
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_RDONLY));
+  std::vector<int> fds = DupToRange(fd, 10);
+
+  ASSERT_THAT(CloseRange(fds[2], fds[7], 0), SyscallSucceeds());
+
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(IsOpen(fds[i]), i < 2 || i > 7) << "fd " << fds[i];
+  }
+  EXPECT_TRUE(IsOpen(fd.get()));
+
+  ASSERT_THAT(CloseRange(kBaseFD, kBaseFD + 9, 0), SyscallSucceeds());
+}
+
+TEST(CloseRangeTest, ClosesToEnd) {
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_RDONLY));
+  std::vector<int> fds = DupToRange(fd, 10);
+
+  ASSERT_THAT(CloseRange(fds[0], ~0U, 0), SyscallSucceeds());
+
+  for (int i = 0; i < 10; i++) {
+    EXPECT_FALSE(IsOpen(fds[i])) << "fd " << fds[i];
+  }
+  EXPECT_TRUE(IsOpen(fd.get()));
+}
+
+TEST(CloseRangeTest, EmptyRangeSucceeds) {
+  ASSERT_THAT(CloseRange(kBaseFD, kBaseFD + 100, 0), SyscallSucceeds());
+}
+
+TEST(CloseRangeTest, LowestFreeFDReused) {
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_RDONLY));
+  std::vector<int> fds = DupToRange(fd, 10);
+
+  ASSERT_THAT(CloseRange(fds[3], fds[9], 0), SyscallSucceeds());
+  EXPECT_THAT(fcntl(fd.get(), F_DUPFD, kBaseFD),
+              SyscallSucceedsWithValue(fds[3]));
+
+  ASSERT_THAT(CloseRange(kBaseFD, kBaseFD + 9, 0), SyscallSucceeds());
+}
+
+TEST(CloseRangeTest, Cloexec) {
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_RDONLY));
+  std::vector<int> fds = DupToRange(fd, 4);
+
+  ASSERT_THAT(CloseRange(fds[1], fds[2], CLOSE_RANGE_CLOEXEC),
+              SyscallSucceeds());
+
+  EXPECT_THAT(fcntl(fds[0], F_GETFD), SyscallSucceedsWithValue(0));
+  EXPECT_THAT(fcntl(fds[1], F_GETFD), SyscallSucceedsWithValue(FD_CLOEXEC));
+  EXPECT_THAT(fcntl(fds[2], F_GETFD), SyscallSucceedsWithValue(FD_CLOEXEC));
+  EXPECT_THAT(fcntl(fds[3], F_GETFD), SyscallSucceedsWithValue(0));
+
+  ASSERT_THAT(CloseRange(kBaseFD, kBaseFD + 3, 0), SyscallSucceeds());
+}
+
+TEST(CloseRangeTest, Unshare) {
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_RDONLY));
+  std::vector<int> fds = DupToRange(fd, 4);
+
+  ASSERT_THAT(CloseRange(fds[0], fds[3], CLOSE_RANGE_UNSHARE),
+              SyscallSucceeds());
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_FALSE(IsOpen(fds[i])) << "fd " << fds[i];
+  }
+}
+
+TEST(CloseRangeTest, InvalidArguments) {
+  EXPECT_THAT(CloseRange(kBaseFD + 1, kBaseFD, 0),
+              SyscallFailsWithErrno(EINVAL));
+  EXPECT_THAT(CloseRange(kBaseFD, kBaseFD + 1, 1U << 0),
+              SyscallFailsWithErrno(EINVAL));
+  EXPECT_THAT(CloseRange(kBaseFD, kBaseFD + 1, 1U << 3),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
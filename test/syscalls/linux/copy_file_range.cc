@@ -0,0 +1,209 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// glibc doesn't provide copy_file_range until 2.27.
+ssize_t CopyFileRange(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out,
+                      size_t len, unsigned int flags) {
+  return syscall(SYS_copy_file_range, fd_in, off_in, fd_out, off_out, len,
+                 flags);
+}
+
+constexpr char kData[] = "The quick brown fox jumps over the lazy dog.";
+constexpr size_t kDataSize = sizeof(kData) - 1;
+
+TEST(CopyFileRangeTest, CopyWithOffsets) {
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), kData, TempPath::kDefaultFileMode));
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor inf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_RDONLY));
+  const FileDescriptor outf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_WRONLY));
+
+  // Copy the second half of the data to the start of the output file.
+  loff_t in_off = kDataSize / 2;
+  loff_t out_off = 0;
+  constexpr size_t kCopySize = kDataSize - kDataSize / 2;
+  EXPECT_THAT(CopyFileRange(inf.get(), &in_off, outf.get(), &out_off,
+                            kCopySize, 0),
+              SyscallSucceedsWithValue(kCopySize));
+  EXPECT_EQ(in_off, kDataSize);
+  EXPECT_EQ(out_off, kCopySize);
+
+  // The file offsets are unchanged.
+  EXPECT_THAT(lseek(inf.get(), 0, SEEK_CUR), SyscallSucceedsWithValue(0));
+  EXPECT_THAT(lseek(outf.get(), 0, SEEK_CUR), SyscallSucceedsWithValue(0));
+
+  EXPECT_EQ(ASSERT_NO_ERRNO_AND_VALUE(GetContents(out_file.path())),
+            std::string(kData + kDataSize / 2, kCopySize));
+}
+
+TEST(CopyFileRangeTest, CopyWithFileOffsets) {
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), kData, TempPath::kDefaultFileMode));
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor inf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_RDONLY));
+  const FileDescriptor outf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_WRONLY));
+
+  // Copy the data in two parts, advancing the file offsets.
+  EXPECT_THAT(CopyFileRange(inf.get(), nullptr, outf.get(), nullptr, 10, 0),
+              SyscallSucceedsWithValue(10));
+  EXPECT_THAT(CopyFileRange(inf.get(), nullptr, outf.get(), nullptr,
+                            kDataSize, 0),
+              SyscallSucceedsWithValue(kDataSize - 10));
+  EXPECT_THAT(lseek(inf.get(), 0, SEEK_CUR),
+              SyscallSucceedsWithValue(kDataSize));
+  EXPECT_THAT(lseek(outf.get(), 0, SEEK_CUR),
+              SyscallSucceedsWithValue(kDataSize));
+
+  // At the end of the input file, nothing is copied.
+  EXPECT_THAT(CopyFileRange(inf.get(), nullptr, outf.get(), nullptr,
+                            kDataSize, 0),
+              SyscallSucceedsWithValue(0));
+
+  EXPECT_EQ(ASSERT_NO_ERRNO_AND_VALUE(GetContents(out_file.path())), kData);
+}
+
+TEST(CopyFileRangeTest, CopyLargeFile) {
+  // Large enough to take several passes through any copy buffer.
+  constexpr size_t kSize = 8 << 20;
+  std::vector<char> data(kSize);
+  RandomizeBuffer(data.data(), data.size());
+
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), absl::string_view(data.data(), data.size()),
+      TempPath::kDefaultFileMode));
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor inf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_RDONLY));
+  const FileDescriptor outf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_WRONLY));
+
+  size_t total = 0;
+  while (total < kSize) {
+    ssize_t n;
+    ASSERT_THAT(n = CopyFileRange(inf.get(), nullptr, outf.get(), nullptr,
+                                  kSize - total, 0),
+                SyscallSucceeds());
+    ASSERT_GT(n, 0);
+    total += n;
+  }
+
+  EXPECT_EQ(ASSERT_NO_ERRNO_AND_VALUE(GetContents(out_file.path())),
+            std::string(data.data(), data.size()));
+}
+
+TEST(CopyFileRangeTest, ZeroLength) {
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), kData, TempPath::kDefaultFileMode));
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor inf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_RDONLY));
+  const FileDescriptor outf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_WRONLY));
+
+  EXPECT_THAT(CopyFileRange(inf.get(), nullptr, outf.get(), nullptr, 0, 0),
+              SyscallSucceedsWithValue(0));
+}
+
+TEST(CopyFileRangeTest, InvalidFlags) {
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor inf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_RDONLY));
+  const FileDescriptor outf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_WRONLY));
+
+  EXPECT_THAT(CopyFileRange(inf.get(), nullptr, outf.get(), nullptr, 1, 1),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(CopyFileRangeTest, WrongAccessModes) {
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor inf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_WRONLY));
+  const FileDescriptor outf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_RDONLY));
+
+  EXPECT_THAT(CopyFileRange(inf.get(), nullptr, outf.get(), nullptr, 1, 0),
+              SyscallFailsWithErrno(EBADF));
+}
+
+TEST(CopyFileRangeTest, AppendOutputFails) {
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), kData, TempPath::kDefaultFileMode));
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor inf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_RDONLY));
+  const FileDescriptor outf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_WRONLY | O_APPEND));
+
+  EXPECT_THAT(CopyFileRange(inf.get(), nullptr, outf.get(), nullptr,
+                            kDataSize, 0),
+              SyscallFailsWithErrno(EBADF));
+}
+
+TEST(CopyFileRangeTest, OverlappingRangesFail) {
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), kData, TempPath::kDefaultFileMode));
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDWR));
+
+  loff_t in_off = 0;
+  loff_t out_off = 4;
+  EXPECT_THAT(CopyFileRange(fd.get(), &in_off, fd.get(), &out_off, 8, 0),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(CopyFileRangeTest, PipeFails) {
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), kData, TempPath::kDefaultFileMode));
+  const FileDescriptor inf =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  EXPECT_THAT(CopyFileRange(inf.get(), nullptr, wfd.get(), nullptr,
+                            kDataSize, 0),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
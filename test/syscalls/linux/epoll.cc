@@ -24,12 +24,20 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "test/util/epoll_util.h"
 #include "test/util/eventfd_util.h"
 #include "test/util/file_descriptor.h"
 #include "test/util/posix_error.h"
 #include "test/util/test_util.h"
+#include "test/util/thread_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -422,6 +430,75 @@ TEST(EpollTest, CloseFile) {
               SyscallSucceedsWithValue(0));
 }
 
+TEST(EpollTest, ExclusiveInvalid) {
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto epollfd1 = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+
+  struct epoll_event event;
+  event.data.u64 = kMagicConstant;
+
+  // EPOLLEXCLUSIVE can't be combined with EPOLLONESHOT.
+  event.events = EPOLLIN | EPOLLEXCLUSIVE | EPOLLONESHOT;
+  EXPECT_THAT(epoll_ctl(epollfd.get(), EPOLL_CTL_ADD, eventfd.get(), &event),
+              SyscallFailsWithErrno(EINVAL));
+
+  // EPOLLEXCLUSIVE can't be applied to epoll instances.
+  event.events = EPOLLIN | EPOLLEXCLUSIVE;
+  EXPECT_THAT(epoll_ctl(epollfd.get(), EPOLL_CTL_ADD, epollfd1.get(), &event),
+              SyscallFailsWithErrno(EINVAL));
+
+  // EPOLL_CTL_MOD can't add EPOLLEXCLUSIVE...
+  ASSERT_NO_ERRNO(
+      RegisterEpollFD(epollfd.get(), eventfd.get(), EPOLLIN, kMagicConstant));
+  EXPECT_THAT(epoll_ctl(epollfd.get(), EPOLL_CTL_MOD, eventfd.get(), &event),
+              SyscallFailsWithErrno(EINVAL));
+
+  // ... or modify an exclusive registration.
+  ASSERT_THAT(epoll_ctl(epollfd.get(), EPOLL_CTL_DEL, eventfd.get(), nullptr),
+              SyscallSucceeds());
+  ASSERT_THAT(epoll_ctl(epollfd.get(), EPOLL_CTL_ADD, eventfd.get(), &event),
+              SyscallSucceeds());
+  event.events = EPOLLIN;
+  EXPECT_THAT(epoll_ctl(epollfd.get(), EPOLL_CTL_MOD, eventfd.get(), &event),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(EpollTest, ExclusiveWakesOne_NoRandomSave) {
+  constexpr int kWaiters = 4;
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+
+  // Each waiter has its own epoll instance watching the same eventfd, as in
+  // a server with a listening socket shared between worker threads.
+  std::vector<FileDescriptor> epollfds;
+  for (int i = 0; i < kWaiters; i++) {
+    epollfds.push_back(ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD()));
+    ASSERT_NO_ERRNO(RegisterEpollFD(epollfds[i].get(), eventfd.get(),
+                                    EPOLLIN | EPOLLEXCLUSIVE, kMagicConstant));
+  }
+
+  std::atomic<int> woken(0);
+  std::vector<std::unique_ptr<ScopedThread>> threads;
+  for (int i = 0; i < kWaiters; i++) {
+    int epfd = epollfds[i].get();
+    threads.push_back(absl::make_unique<ScopedThread>([&woken, epfd] {
+      struct epoll_event result;
+      int n = RetryEINTR(epoll_wait)(epfd, &result, 1, 2000);
+      TEST_PCHECK(n >= 0);
+      woken += n;
+    }));
+  }
+
+  // Give the waiters time to block, then make the eventfd readable. The
+  // event is not consumed, but only one waiter should be woken.
+  absl::SleepFor(absl::Milliseconds(500));
+  uint64_t val = 1;
+  ASSERT_THAT(WriteFd(eventfd.get(), &val, sizeof(val)),
+              SyscallSucceedsWithValue(sizeof(val)));
+  threads.clear();
+  EXPECT_EQ(woken, 1);
+}
+
 }  // namespace
 
 }  // namespace testing
@@ -167,6 +167,34 @@ TEST(ExecTest, Basic) {
             absl::StrCat(RunfilePath(kBasicWorkload), "\n"));
 }
 
+TEST(ExecTest, SpawnEmptyPath) {
+  int execve_errno;
+  ASSERT_NO_ERRNO_AND_VALUE(SpawnAndExec("", {}, {}, nullptr, &execve_errno));
+  EXPECT_EQ(execve_errno, ENOENT);
+}
+
+TEST(ExecTest, SpawnBasic) {
+  // Discard the workload's output.
+  const auto remap_stderr = [] {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0 || dup2(fd, 2) < 0) {
+      _exit(errno);
+    }
+  };
+
+  pid_t child;
+  int execve_errno;
+  Cleanup kill = ASSERT_NO_ERRNO_AND_VALUE(
+      SpawnAndExec(RunfilePath(kBasicWorkload), {RunfilePath(kBasicWorkload)},
+                   {}, remap_stderr, &child, &execve_errno));
+  ASSERT_EQ(execve_errno, 0);
+
+  int status;
+  ASSERT_THAT(RetryEINTR(waitpid)(child, &status, 0), SyscallSucceeds());
+  EXPECT_EQ(status, ArgEnvExitStatus(0, 0));
+  kill.Release();
+}
+
 TEST(ExecTest, OneArg) {
   CheckExec(RunfilePath(kBasicWorkload), {RunfilePath(kBasicWorkload), "1"}, {},
             ArgEnvExitStatus(1, 0),
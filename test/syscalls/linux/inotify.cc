@@ -26,6 +26,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -842,6 +843,40 @@ TEST(Inotify, CoalesceEvents) {
            Event(IN_CLOSE_NOWRITE, wd, file2_name)}));
 }
 
+// Events past max_queued_events are dropped, and the last queued event is
+// replaced by IN_Q_OVERFLOW.
+TEST(Inotify, QueueOverflow_NoRandomSave) {
+  int max_events = 16384;
+  if (!IsRunningOnGvisor()) {
+    const std::string contents = ASSERT_NO_ERRNO_AND_VALUE(
+        GetContents("/proc/sys/fs/inotify/max_queued_events"));
+    ASSERT_TRUE(absl::SimpleAtoi(contents, &max_events));
+  }
+  // Keep the test short on hosts with a raised limit.
+  SKIP_IF(max_events > 1 << 16);
+
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(InotifyInit1(IN_NONBLOCK));
+  const int wd = ASSERT_NO_ERRNO_AND_VALUE(
+      InotifyAddWatch(fd.get(), file.path(), IN_OPEN | IN_CLOSE_NOWRITE));
+
+  // Opening and closing the file alternates between two events, which are
+  // never coalesced.
+  for (int i = 0; i < max_events / 2 + 1; i++) {
+    const FileDescriptor file_fd =
+        ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+  }
+
+  const std::vector<Event> events =
+      ASSERT_NO_ERRNO_AND_VALUE(DrainEvents(fd.get()));
+  ASSERT_EQ(events.size(), static_cast<size_t>(max_events));
+  EXPECT_EQ(events.front().wd, wd);
+  EXPECT_EQ(events.front().mask, IN_OPEN);
+  EXPECT_EQ(events.back().wd, -1);
+  EXPECT_EQ(events.back().mask, IN_Q_OVERFLOW);
+}
+
 TEST(Inotify, ClosingInotifyFdWithoutRemovingWatchesWorks) {
   const TempPath root = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
   const FileDescriptor fd =
@@ -136,6 +136,69 @@ TEST(MadviseDontneedTest, IgnoresPermissions) {
   EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_DONTNEED), SyscallSucceeds());
 }
 
+TEST(MadviseFreeTest, WriteCancelsFree) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), 1, m.len());
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_FREE), SyscallSucceeds());
+
+  *reinterpret_cast<volatile char*>(m.ptr()) = 2;
+  auto const v = m.view();
+  // The page may have been freed before the write, in which case the rest of
+  // it is zero. Either way, the write makes its contents stable again.
+  char const c = v[1];
+  EXPECT_TRUE(c == 0 || c == 1) << "unexpected byte " << int{c};
+  EXPECT_EQ(v[0], 2);
+  for (size_t i = 1; i < kPageSize; i++) {
+    ASSERT_EQ(v[i], c) << "at offset " << i;
+  }
+}
+
+TEST(MadviseFreeTest, DoesNotModifyCOWAnonPageInParent) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), 2, m.len());
+
+  // Free the page in a child process, which shares it with the parent.
+  pid_t pid = fork();
+  if (pid == 0) {
+    TEST_PCHECK(madvise(m.ptr(), m.len(), MADV_FREE) == 0);
+    _exit(0);
+  }
+
+  ASSERT_THAT(pid, SyscallSucceeds());
+
+  int status = 0;
+  ASSERT_THAT(waitpid(-1, &status, 0), SyscallSucceedsWithValue(pid));
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  ExpectAllMappingBytes(m, 2);
+}
+
+TEST(MadviseFreeTest, SharedAnonFails) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_SHARED));
+  memset(m.ptr(), 3, m.len());
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_FREE),
+              SyscallFailsWithErrno(EINVAL));
+  ExpectAllMappingBytes(m, 3);
+}
+
+TEST(MadviseColdTest, PreservesContents) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), 4, m.len());
+  for (int advice : {MADV_COLD, MADV_PAGEOUT}) {
+    int const ret = madvise(m.ptr(), m.len(), advice);
+    if (ret < 0 && errno == EINVAL) {
+      // Linux before 5.4 doesn't support these.
+      GTEST_SKIP();
+    }
+    ASSERT_THAT(ret, SyscallSucceeds());
+    ExpectAllMappingBytes(m, 4);
+  }
+}
+
 TEST(MadviseDontforkTest, AddressLength) {
   auto m =
       ASSERT_NO_ERRNO_AND_VALUE(MmapAnon(kPageSize, PROT_NONE, MAP_PRIVATE));
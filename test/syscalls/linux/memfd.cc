@@ -552,6 +552,34 @@ TEST(MemfdTest, MultipleWritableAndNonWritableRefsToSameFileRegion) {
   m2.reset();
 }
 
+// Memfds created with MFD_HUGETLB can be mapped and shared like other memfds.
+TEST(MemfdTest, HugetlbMmap) {
+  constexpr size_t kHugePageSize = 2 << 20;
+  auto memfd_or = MemfdCreate(kMemfdName, MFD_HUGETLB);
+  // Linux fails if hugetlbfs is not available.
+  SKIP_IF(!IsRunningOnGvisor() && !memfd_or.ok());
+  const FileDescriptor memfd = ASSERT_NO_ERRNO_AND_VALUE(std::move(memfd_or));
+  ASSERT_THAT(ftruncate(memfd.get(), 2 * kHugePageSize), SyscallSucceeds());
+
+  auto m1_or = Mmap(nullptr, 2 * kHugePageSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, memfd.get(), 0);
+  // Linux fails if no huge pages are reserved.
+  SKIP_IF(!IsRunningOnGvisor() && !m1_or.ok());
+  const Mapping m1 = ASSERT_NO_ERRNO_AND_VALUE(std::move(m1_or));
+  const Mapping m2 = ASSERT_NO_ERRNO_AND_VALUE(Mmap(
+      nullptr, 2 * kHugePageSize, PROT_READ, MAP_SHARED, memfd.get(), 0));
+
+  // Write to a page in each huge page via m1, and read it back via m2.
+  for (size_t offset : {kPageSize, kHugePageSize + 3 * kPageSize}) {
+    std::vector<char> buf(kPageSize);
+    RandomizeBuffer(buf.data(), buf.size());
+    memcpy(static_cast<char*>(m1.ptr()) + offset, buf.data(), buf.size());
+    EXPECT_EQ(
+        memcmp(static_cast<char*>(m2.ptr()) + offset, buf.data(), buf.size()),
+        0);
+  }
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace gvisor
@@ -22,7 +22,9 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
 #include "test/util/fs_util.h"
+#include "test/util/memory_util.h"
 #include "test/util/posix_error.h"
+#include "test/util/save_util.h"
 #include "test/util/test_util.h"
 
 namespace gvisor {
@@ -94,6 +96,118 @@ TEST(MemoryAccounting, AnonAccountingPreservedOnSaveRestore) {
   EXPECT_THAT(anon_after_sr, EquivalentWithin(anon_after_alloc, 0.03));
 }
 
+// Number of incremental saves in each chain of deltas.
+constexpr int kDeltaChainLength = 8;
+
+// PageValue returns the byte expected at the start of page i after round
+// rounds of DirtyPages. Each round rewrites a different subset of pages, so
+// that every delta in the chain contributes the latest value of some pages
+// and leaves others to earlier checkpoints.
+char PageValue(uint64_t i, int round) {
+  int last = 0;
+  for (int r = 1; r <= round; r++) {
+    if (i % (r + 1) == 0) {
+      last = r;
+    }
+  }
+  return 'a' + last;
+}
+
+// DirtyPages performs round round of writes to the pages of m.
+void DirtyPages(const Mapping& m, int round) {
+  char* mem = static_cast<char*>(m.ptr());
+  for (uint64_t i = 0; i < m.len() / kPageSize; i++) {
+    if (i % (round + 1) == 0) {
+      mem[i * kPageSize] = 'a' + round;
+    }
+  }
+}
+
+// VerifyPages checks that every page of m holds its value after round rounds.
+void VerifyPages(const Mapping& m, int round) {
+  const char* mem = static_cast<const char*>(m.ptr());
+  for (uint64_t i = 0; i < m.len() / kPageSize; i++) {
+    ASSERT_EQ(mem[i * kPageSize], PageValue(i, round))
+        << "page " << i << " after round " << round;
+  }
+}
+
+TEST(MemoryAccounting, ContentsPreservedAcrossIncrementalSaves) {
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(Megabytes(64), PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  DirtyPages(m, 0);
+  MaybeSave(SaveKind::kFull);
+
+  for (int round = 1; round <= kDeltaChainLength; round++) {
+    DirtyPages(m, round);
+    MaybeSave(SaveKind::kIncremental);
+    ASSERT_NO_FATAL_FAILURE(VerifyPages(m, round));
+  }
+
+  // A full save in the middle of the chain starts a new one.
+  MaybeSave(SaveKind::kFull);
+  ASSERT_NO_FATAL_FAILURE(VerifyPages(m, kDeltaChainLength));
+  for (int round = kDeltaChainLength + 1; round <= 2 * kDeltaChainLength;
+       round++) {
+    DirtyPages(m, round);
+    MaybeSave(SaveKind::kIncremental);
+    ASSERT_NO_FATAL_FAILURE(VerifyPages(m, round));
+  }
+}
+
+TEST(MemoryAccounting, DecommittedPagesStayZeroAcrossIncrementalSaves) {
+  const uint64_t len = Megabytes(16);
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(len, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), 'a', len);
+  MaybeSave(SaveKind::kFull);
+
+  // Pages dropped after the base checkpoint must not be restored from it.
+  ASSERT_THAT(madvise(m.ptr(), len / 2, MADV_DONTNEED), SyscallSucceeds());
+  MaybeSave(SaveKind::kIncremental);
+  MaybeSave(SaveKind::kIncremental);
+
+  const char* mem = static_cast<const char*>(m.ptr());
+  for (uint64_t off = 0; off < len; off += kPageSize) {
+    ASSERT_EQ(mem[off], off < len / 2 ? 0 : 'a') << "offset " << off;
+  }
+
+  // Likewise for memory unmapped after the base checkpoint, which is likely
+  // to be reused by the next mapping.
+  m.reset();
+  MaybeSave(SaveKind::kIncremental);
+  m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(len, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  MaybeSave(SaveKind::kIncremental);
+  mem = static_cast<const char*>(m.ptr());
+  for (uint64_t off = 0; off < len; off += kPageSize) {
+    ASSERT_EQ(mem[off], 0) << "offset " << off;
+  }
+}
+
+TEST(MemoryAccounting, AnonAccountingPreservedOnIncrementalSaves) {
+  // See AnonAccountingPreservedOnSaveRestore.
+  SKIP_IF(!IsRunningOnGvisor());
+
+  const uint64_t map_bytes = Megabytes(256);
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(map_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  DirtyPages(m, 0);
+  MaybeSave(SaveKind::kFull);
+
+  const uint64_t anon_after_alloc =
+      ASSERT_NO_ERRNO_AND_VALUE(AnonUsageFromMeminfo());
+  for (int round = 1; round <= kDeltaChainLength; round++) {
+    DirtyPages(m, round);
+    MaybeSave(SaveKind::kIncremental);
+  }
+
+  // Restoring a chain of deltas must not count a page once per delta.
+  const uint64_t anon_after_sr =
+      ASSERT_NO_ERRNO_AND_VALUE(AnonUsageFromMeminfo());
+  EXPECT_THAT(anon_after_sr, EquivalentWithin(anon_after_alloc, 0.03));
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace gvisor
@@ -50,6 +50,52 @@ TEST(MincoreTest, DirtyAnonPagesAreResident) {
   EXPECT_EQ(kTestPageCount, CountSetLSBs(vec));
 }
 
+TEST(MincoreTest, UntouchedAnonPagesAreNotResident) {
+  // Large enough that the mapping isn't populated eagerly.
+  constexpr size_t kTestPageCount = 4096;
+  auto const kTestMappingBytes = kTestPageCount * kPageSize;
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kTestMappingBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+
+  std::vector<unsigned char> vec(kTestPageCount, 0xff);
+  ASSERT_THAT(mincore(m.ptr(), kTestMappingBytes, vec.data()),
+              SyscallSucceeds());
+  EXPECT_EQ(0, CountSetLSBs(vec));
+}
+
+TEST(MincoreTest, SparselyTouchedAnonPages) {
+  constexpr size_t kTestPageCount = 4096;
+  auto const kTestMappingBytes = kTestPageCount * kPageSize;
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kTestMappingBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  // Touch the first and last pages only. Neighboring pages may be made
+  // resident along with them, e.g. by transparent huge pages.
+  static_cast<char*>(m.ptr())[0] = 1;
+  static_cast<char*>(m.ptr())[kTestMappingBytes - 1] = 1;
+
+  std::vector<unsigned char> vec(kTestPageCount, 0);
+  ASSERT_THAT(mincore(m.ptr(), kTestMappingBytes, vec.data()),
+              SyscallSucceeds());
+  EXPECT_EQ(1, vec.front() & 1);
+  EXPECT_EQ(1, vec.back() & 1);
+  EXPECT_LT(CountSetLSBs(vec), kTestPageCount);
+}
+
+TEST(MincoreTest, UnmappedPagesFail) {
+  // Map three pages and unmap the second, then try to mincore all three.
+  constexpr size_t kTestPageCount = 3;
+  auto const kTestMappingBytes = kTestPageCount * kPageSize;
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kTestMappingBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_THAT(
+      munmap(reinterpret_cast<void*>(m.addr() + kPageSize), kPageSize),
+      SyscallSucceeds());
+
+  std::vector<unsigned char> vec(kTestPageCount, 0);
+  EXPECT_THAT(mincore(m.ptr(), kTestMappingBytes, vec.data()),
+              SyscallFailsWithErrno(ENOMEM));
+}
+
 TEST(MincoreTest, UnalignedAddressFails) {
   // Map and touch two pages, then try to mincore the second half of the first
   // page + the first half of the second page. Both pages are mapped, but
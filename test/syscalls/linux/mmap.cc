@@ -167,6 +167,23 @@ TEST_F(MMapTest, MapDevZeroPrivate) {
       SyscallSucceeds());
 }
 
+TEST_F(MMapTest, MapDevZeroPrivateAtOffset) {
+  // Private mappings of /dev/zero behave like anonymous mappings, so the
+  // offset doesn't matter.
+  const FileDescriptor dev_zero =
+      ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/zero", O_RDWR));
+
+  ASSERT_THAT(Map(0, kPageSize * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                  dev_zero.get(), kPageSize * 4),
+              SyscallSucceeds());
+
+  std::string buf_zero(kPageSize * 2, 0x00);
+  std::string buf_ones(kPageSize * 2, 0xFF);
+  EXPECT_THAT(addr_, EqualsMemory(buf_zero));
+  memcpy(addr_, buf_ones.data(), kPageSize * 2);
+  EXPECT_THAT(addr_, EqualsMemory(buf_ones));
+}
+
 TEST_F(MMapTest, MapDevZeroNoPersistence) {
   // This test will verify that two independent mappings of /dev/zero do not
   // appear to reference the same "backed file."
@@ -17,16 +17,19 @@
 #include <stdio.h>
 #include <sys/mount.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
 #include <unistd.h>
 
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "test/util/capability_util.h"
 #include "test/util/file_descriptor.h"
@@ -226,6 +229,33 @@ TEST(MountTest, MountTmpfsMagicValIgnored) {
       Mount("", dir.path(), "tmpfs", MS_MGC_VAL, "mode=0700", 0));
 }
 
+TEST(MountTest, MountTmpfsSize) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_ADMIN)));
+  // VFS2 tmpfs ignores the size option.
+  SKIP_IF(IsRunningOnGvisor() && !IsRunningWithVFS1());
+
+  const size_t kSize = 4 * kPageSize;
+  auto const dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  auto const mount = ASSERT_NO_ERRNO_AND_VALUE(Mount(
+      "", dir.path(), "tmpfs", 0, "size=" + std::to_string(kSize), 0));
+
+  struct statfs st;
+  ASSERT_THAT(statfs(dir.path().c_str(), &st), SyscallSucceeds());
+  EXPECT_EQ(st.f_blocks * st.f_bsize, kSize);
+
+  auto const fd = ASSERT_NO_ERRNO_AND_VALUE(
+      Open(JoinPath(dir.path(), "foo"), O_CREAT | O_RDWR, 0666));
+  ASSERT_THAT(fallocate(fd.get(), 0, 0, kSize), SyscallSucceeds());
+  EXPECT_THAT(fallocate(fd.get(), 0, kSize, kPageSize),
+              SyscallFailsWithErrno(ENOSPC));
+  char c = 0;
+  EXPECT_THAT(pwrite(fd.get(), &c, 1, kSize), SyscallFailsWithErrno(ENOSPC));
+
+  // Truncating the file frees its space.
+  ASSERT_THAT(ftruncate(fd.get(), 0), SyscallSucceeds());
+  EXPECT_THAT(fallocate(fd.get(), 0, 0, kSize), SyscallSucceeds());
+}
+
 // Passing nullptr to data is equivalent to "".
 TEST(MountTest, NullData) {
   SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_ADMIN)));
@@ -287,6 +317,55 @@ TEST(MountTest, MountNoAtime) {
   EXPECT_EQ(before, after);
 }
 
+// Reads file twice, with a delay before the second read, and returns the
+// atimes after each read.
+PosixErrorOr<std::pair<absl::Time, absl::Time>> ATimesAfterReads(
+    const std::string& file) {
+  ASSIGN_OR_RETURN_ERRNO(auto fd, Open(file, O_RDONLY));
+  char buf[100];
+  if (pread(fd.get(), buf, sizeof(buf), 0) == -1) {
+    return PosixError(errno, "pread failed");
+  }
+  ASSIGN_OR_RETURN_ERRNO(absl::Time const first, ATime(file));
+
+  // Make sure that an atime update on the second read would be visible.
+  absl::SleepFor(absl::Seconds(1));
+  if (pread(fd.get(), buf, sizeof(buf), 0) == -1) {
+    return PosixError(errno, "pread failed");
+  }
+  ASSIGN_OR_RETURN_ERRNO(absl::Time const second, ATime(file));
+  return std::make_pair(first, second);
+}
+
+TEST(MountTest, MountRelatimeByDefault) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_ADMIN)));
+
+  auto const dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  auto const mount = ASSERT_NO_ERRNO_AND_VALUE(
+      Mount("", dir.path(), "tmpfs", 0, "mode=0777", 0));
+  auto const file = ASSERT_NO_ERRNO_AND_VALUE(
+      TempPath::CreateFileWith(dir.path(), "contents", 0777));
+
+  // The file was modified after it was last accessed, so the first read
+  // updates atime, but the second doesn't.
+  auto const atimes = ASSERT_NO_ERRNO_AND_VALUE(ATimesAfterReads(file.path()));
+  EXPECT_EQ(atimes.first, atimes.second);
+}
+
+TEST(MountTest, MountStrictAtime) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_ADMIN)));
+
+  auto const dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  auto const mount = ASSERT_NO_ERRNO_AND_VALUE(
+      Mount("", dir.path(), "tmpfs", MS_STRICTATIME, "mode=0777", 0));
+  auto const file = ASSERT_NO_ERRNO_AND_VALUE(
+      TempPath::CreateFileWith(dir.path(), "contents", 0777));
+
+  // Every read updates atime.
+  auto const atimes = ASSERT_NO_ERRNO_AND_VALUE(ATimesAfterReads(file.path()));
+  EXPECT_GT(atimes.second, atimes.first);
+}
+
 TEST(MountTest, MountNoExec) {
   SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_ADMIN)));
 
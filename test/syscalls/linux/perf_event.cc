@@ -0,0 +1,277 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <linux/perf_event.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// PerfEventOpen opens an event described by attr counting the calling thread.
+PosixErrorOr<FileDescriptor> PerfEventOpen(struct perf_event_attr* attr) {
+  int fd = syscall(__NR_perf_event_open, attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+  MaybeSave();
+  if (fd < 0) {
+    return PosixError(errno, "perf_event_open");
+  }
+  return FileDescriptor(fd);
+}
+
+// SoftwareEvent returns the attributes of a disabled software event.
+struct perf_event_attr SoftwareEvent(uint64_t config) {
+  struct perf_event_attr attr = {};
+  attr.type = PERF_TYPE_SOFTWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return attr;
+}
+
+// PerfEventUnavailable returns true if unprivileged users may not count
+// software events on the host, as is the case with perf_event_paranoid > 2 or
+// in containers whose seccomp policy blocks perf_event_open(2).
+bool PerfEventUnavailable() {
+  struct perf_event_attr attr = SoftwareEvent(PERF_COUNT_SW_TASK_CLOCK);
+  int fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0) {
+    return errno == EACCES || errno == EPERM || errno == ENOSYS;
+  }
+  close(fd);
+  return false;
+}
+
+absl::Duration ThreadCPUTime() {
+  struct timespec ts;
+  TEST_PCHECK(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0);
+  return absl::DurationFromTimespec(ts);
+}
+
+// SpinCPU busy-loops until the calling thread has used d of CPU time.
+void SpinCPU(absl::Duration d) {
+  const absl::Duration start = ThreadCPUTime();
+  while (ThreadCPUTime() - start < d) {
+  }
+}
+
+uint64_t ReadCount(const FileDescriptor& fd) {
+  uint64_t count = 0;
+  TEST_PCHECK(read(fd.get(), &count, sizeof(count)) == sizeof(count));
+  return count;
+}
+
+TEST(PerfEventTest, InvalidFlags) {
+  SKIP_IF(PerfEventUnavailable());
+  struct perf_event_attr attr = SoftwareEvent(PERF_COUNT_SW_TASK_CLOCK);
+  EXPECT_THAT(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 1 << 10),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(PerfEventTest, UnknownSoftwareEvent) {
+  SKIP_IF(PerfEventUnavailable());
+  struct perf_event_attr attr = SoftwareEvent(1000);
+  EXPECT_THAT(PerfEventOpen(&attr), PosixErrorIs(ENOENT, ::testing::_));
+}
+
+TEST(PerfEventTest, AttrTooBig) {
+  SKIP_IF(PerfEventUnavailable());
+  std::vector<uint64_t> buf(2 * kPageSize / sizeof(uint64_t));
+  auto* attr = reinterpret_cast<struct perf_event_attr*>(buf.data());
+  *attr = SoftwareEvent(PERF_COUNT_SW_TASK_CLOCK);
+  attr->size = kPageSize + 8;
+  EXPECT_THAT(PerfEventOpen(attr), PosixErrorIs(E2BIG, ::testing::_));
+  // The size that the kernel supports is written back.
+  EXPECT_GE(attr->size, PERF_ATTR_SIZE_VER0);
+  EXPECT_LT(attr->size, kPageSize);
+}
+
+TEST(PerfEventTest, TaskClockCountsWhileEnabled) {
+  SKIP_IF(PerfEventUnavailable());
+  struct perf_event_attr attr = SoftwareEvent(PERF_COUNT_SW_TASK_CLOCK);
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  const FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(PerfEventOpen(&attr));
+
+  struct {
+    uint64_t value;
+    uint64_t time_enabled;
+    uint64_t time_running;
+  } values = {};
+  SpinCPU(absl::Milliseconds(20));
+  ASSERT_THAT(read(fd.get(), &values, sizeof(values)),
+              SyscallSucceedsWithValue(sizeof(values)));
+  EXPECT_EQ(values.value, 0);
+
+  ASSERT_THAT(ioctl(fd.get(), PERF_EVENT_IOC_ENABLE, 0), SyscallSucceeds());
+  SpinCPU(absl::Milliseconds(100));
+  ASSERT_THAT(ioctl(fd.get(), PERF_EVENT_IOC_DISABLE, 0), SyscallSucceeds());
+
+  ASSERT_THAT(read(fd.get(), &values, sizeof(values)),
+              SyscallSucceedsWithValue(sizeof(values)));
+  // CPU time is measured at CPU clock ticks in gVisor.
+  EXPECT_GE(values.value, absl::ToInt64Nanoseconds(absl::Milliseconds(50)));
+  EXPECT_GE(values.time_enabled,
+            absl::ToInt64Nanoseconds(absl::Milliseconds(50)));
+  EXPECT_EQ(values.time_running, values.time_enabled);
+
+  // A buffer too small for read_format is rejected.
+  uint64_t small[2];
+  EXPECT_THAT(read(fd.get(), small, sizeof(small)),
+              SyscallFailsWithErrno(ENOSPC));
+
+  // The count doesn't change while the event is disabled.
+  SpinCPU(absl::Milliseconds(50));
+  uint64_t again[3];
+  ASSERT_THAT(read(fd.get(), again, sizeof(again)),
+              SyscallSucceedsWithValue(sizeof(again)));
+  EXPECT_EQ(again[0], values.value);
+}
+
+TEST(PerfEventTest, ContextSwitchesReset) {
+  SKIP_IF(PerfEventUnavailable());
+  struct perf_event_attr attr = SoftwareEvent(PERF_COUNT_SW_CONTEXT_SWITCHES);
+  attr.disabled = 0;
+  const FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(PerfEventOpen(&attr));
+
+  for (int i = 0; i < 10; i++) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_GE(ReadCount(fd), 10);
+
+  ASSERT_THAT(ioctl(fd.get(), PERF_EVENT_IOC_RESET, 0), SyscallSucceeds());
+  EXPECT_LT(ReadCount(fd), 10);
+}
+
+TEST(PerfEventTest, PageFaults) {
+  SKIP_IF(PerfEventUnavailable());
+  struct perf_event_attr attr = SoftwareEvent(PERF_COUNT_SW_PAGE_FAULTS);
+  attr.disabled = 0;
+  const FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(PerfEventOpen(&attr));
+
+  const uint64_t before = ReadCount(fd);
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(16 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  for (uintptr_t addr = m.addr(); addr < m.endaddr(); addr += kPageSize) {
+    *reinterpret_cast<volatile char*>(addr) = 1;
+  }
+  // gVisor may map more than one page per fault.
+  EXPECT_GT(ReadCount(fd), before);
+}
+
+TEST(PerfEventTest, ID) {
+  SKIP_IF(PerfEventUnavailable());
+  struct perf_event_attr attr = SoftwareEvent(PERF_COUNT_SW_TASK_CLOCK);
+  attr.read_format = PERF_FORMAT_ID;
+  const FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(PerfEventOpen(&attr));
+
+  uint64_t id = 0;
+  ASSERT_THAT(ioctl(fd.get(), PERF_EVENT_IOC_ID, &id), SyscallSucceeds());
+  uint64_t values[2] = {};
+  ASSERT_THAT(read(fd.get(), values, sizeof(values)),
+              SyscallSucceedsWithValue(sizeof(values)));
+  EXPECT_EQ(values[1], id);
+}
+
+TEST(PerfEventTest, MmapSize) {
+  SKIP_IF(PerfEventUnavailable());
+  struct perf_event_attr attr = SoftwareEvent(PERF_COUNT_SW_TASK_CLOCK);
+  attr.sample_period = 1000000;
+  const FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(PerfEventOpen(&attr));
+
+  // The data area must be a power of 2 pages.
+  EXPECT_THAT(Mmap(nullptr, 4 * kPageSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd.get(), 0),
+              PosixErrorIs(EINVAL, ::testing::_));
+  EXPECT_NO_ERRNO(Mmap(nullptr, 3 * kPageSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd.get(), 0));
+}
+
+TEST(PerfEventTest, TaskClockSamples) {
+  SKIP_IF(PerfEventUnavailable());
+  struct perf_event_attr attr = SoftwareEvent(PERF_COUNT_SW_TASK_CLOCK);
+  attr.sample_period = absl::ToInt64Nanoseconds(absl::Milliseconds(1));
+  attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_PERIOD;
+  attr.wakeup_events = 1;
+  const FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(PerfEventOpen(&attr));
+
+  constexpr int kDataPages = 8;
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      Mmap(nullptr, (1 + kDataPages) * kPageSize, PROT_READ | PROT_WRITE,
+           MAP_SHARED, fd.get(), 0));
+  auto* page =
+      reinterpret_cast<volatile struct perf_event_mmap_page*>(m.ptr());
+  EXPECT_EQ(static_cast<uint64_t>(page->data_head), 0);
+
+  ASSERT_THAT(ioctl(fd.get(), PERF_EVENT_IOC_ENABLE, 0), SyscallSucceeds());
+  SpinCPU(absl::Milliseconds(200));
+  ASSERT_THAT(ioctl(fd.get(), PERF_EVENT_IOC_DISABLE, 0), SyscallSucceeds());
+
+  struct pollfd pfd = {fd.get(), POLLIN, 0};
+  EXPECT_THAT(RetryEINTR(poll)(&pfd, 1, 0), SyscallSucceedsWithValue(1));
+
+  const uint64_t head = page->data_head;
+  __sync_synchronize();
+  ASSERT_GT(head, 0);
+
+  struct sample {
+    struct perf_event_header header;
+    uint64_t ip;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t period;
+  };
+  ASSERT_GE(head, sizeof(struct sample));
+  uint64_t data_offset = page->data_offset;
+  if (data_offset == 0) {
+    // Older kernels don't report the data area's location.
+    data_offset = kPageSize;
+  }
+  struct sample s;
+  memcpy(&s, reinterpret_cast<char*>(m.addr() + data_offset), sizeof(s));
+  EXPECT_EQ(s.header.type, PERF_RECORD_SAMPLE);
+  EXPECT_EQ(s.header.size, sizeof(s));
+  EXPECT_EQ(s.pid, getpid());
+  EXPECT_EQ(s.tid, syscall(__NR_gettid));
+  EXPECT_NE(s.ip, 0);
+  EXPECT_GE(s.period, attr.sample_period);
+
+  // Consuming all records leaves nothing to read.
+  page->data_tail = head;
+  EXPECT_THAT(RetryEINTR(poll)(&pfd, 1, 0), SyscallSucceedsWithValue(0));
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
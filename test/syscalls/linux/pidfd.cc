@@ -0,0 +1,171 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// PidfdOpen returns a new pidfd referring to the process pid.
+PosixErrorOr<FileDescriptor> PidfdOpen(pid_t pid) {
+  int fd = syscall(SYS_pidfd_open, pid, 0);
+  MaybeSave();
+  if (fd < 0) {
+    return PosixError(errno, "pidfd_open");
+  }
+  return FileDescriptor(fd);
+}
+
+// PidfdUnavailable returns true if the host kernel predates pidfd_open(2)
+// (Linux 5.3).
+bool PidfdUnavailable() {
+  int fd = syscall(SYS_pidfd_open, getpid(), 0);
+  if (fd < 0) {
+    return errno == ENOSYS;
+  }
+  close(fd);
+  return false;
+}
+
+// ForkAndWaitForPipe forks a child process that exits when the write end of
+// a pipe is closed. It returns the child's PID and the write end of the pipe.
+PosixErrorOr<std::pair<pid_t, FileDescriptor>> ForkAndWaitForPipe() {
+  int fds[2];
+  RETURN_ERROR_IF_SYSCALL_FAIL(pipe(fds));
+  FileDescriptor rfd(fds[0]);
+  FileDescriptor wfd(fds[1]);
+  pid_t child = fork();
+  if (child == 0) {
+    wfd.reset();
+    char c;
+    TEST_PCHECK(read(rfd.get(), &c, 1) == 0);
+    _exit(0);
+  }
+  RETURN_ERROR_IF_SYSCALL_FAIL(child);
+  return std::make_pair(child, std::move(wfd));
+}
+
+TEST(PidfdTest, InvalidArguments) {
+  SKIP_IF(PidfdUnavailable());
+
+  EXPECT_THAT(syscall(SYS_pidfd_open, getpid(), 1),
+              SyscallFailsWithErrno(EINVAL));
+  EXPECT_THAT(syscall(SYS_pidfd_open, 0, 0), SyscallFailsWithErrno(EINVAL));
+  EXPECT_THAT(syscall(SYS_pidfd_open, -1, 0), SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(PidfdTest, NonLeaderThread) {
+  SKIP_IF(PidfdUnavailable());
+
+  ScopedThread t([] {
+    EXPECT_THAT(syscall(SYS_pidfd_open, gettid(), 0),
+                SyscallFailsWithErrno(EINVAL));
+  });
+}
+
+TEST(PidfdTest, CloseOnExec) {
+  SKIP_IF(PidfdUnavailable());
+
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  EXPECT_THAT(fcntl(pidfd.get(), F_GETFD),
+              SyscallSucceedsWithValue(FD_CLOEXEC));
+}
+
+TEST(PidfdTest, ReadableWhenProcessExits) {
+  SKIP_IF(PidfdUnavailable());
+
+  auto child_and_pipe = ASSERT_NO_ERRNO_AND_VALUE(ForkAndWaitForPipe());
+  const pid_t child = child_and_pipe.first;
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(child));
+
+  // The child is still running.
+  struct pollfd pfd = {pidfd.get(), POLLIN, 0};
+  EXPECT_THAT(poll(&pfd, 1, 0), SyscallSucceedsWithValue(0));
+
+  // Let the child exit, and wait for it.
+  child_and_pipe.second.reset();
+  EXPECT_THAT(RetryEINTR(poll)(&pfd, 1, -1), SyscallSucceedsWithValue(1));
+  EXPECT_EQ(pfd.revents & POLLIN, POLLIN);
+
+  // The exited child is a zombie until reaped.
+  int status;
+  ASSERT_THAT(RetryEINTR(waitpid)(child, &status, WNOHANG),
+              SyscallSucceedsWithValue(child));
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << status;
+
+  // The pidfd remains readable after the child is reaped.
+  pfd.revents = 0;
+  EXPECT_THAT(poll(&pfd, 1, 0), SyscallSucceedsWithValue(1));
+}
+
+TEST(PidfdTest, Epoll) {
+  SKIP_IF(PidfdUnavailable());
+
+  auto child_and_pipe = ASSERT_NO_ERRNO_AND_VALUE(ForkAndWaitForPipe());
+  const pid_t child = child_and_pipe.first;
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(child));
+
+  const FileDescriptor epfd(epoll_create1(EPOLL_CLOEXEC));
+  ASSERT_GE(epfd.get(), 0);
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.u64 = child;
+  ASSERT_THAT(epoll_ctl(epfd.get(), EPOLL_CTL_ADD, pidfd.get(), &ev),
+              SyscallSucceeds());
+  EXPECT_THAT(epoll_wait(epfd.get(), &ev, 1, 0), SyscallSucceedsWithValue(0));
+
+  child_and_pipe.second.reset();
+  ASSERT_THAT(RetryEINTR(epoll_wait)(epfd.get(), &ev, 1, -1),
+              SyscallSucceedsWithValue(1));
+  EXPECT_EQ(ev.data.u64, child);
+  EXPECT_EQ(ev.events & EPOLLIN, EPOLLIN);
+
+  int status;
+  ASSERT_THAT(RetryEINTR(waitpid)(child, &status, 0),
+              SyscallSucceedsWithValue(child));
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << status;
+}
+
+TEST(PidfdTest, NotReadable) {
+  SKIP_IF(PidfdUnavailable());
+
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  char c;
+  EXPECT_THAT(read(pidfd.get(), &c, 1), SyscallFailsWithErrno(EINVAL));
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -213,6 +213,41 @@ TEST(PrctlTest, RootDumpability) {
               SyscallFailsWithErrno(EINVAL));
 }
 
+TEST(PrctlTest, SetGetTimerSlack) {
+  int before;
+  ASSERT_THAT(before = prctl(PR_GET_TIMERSLACK), SyscallSucceeds());
+  auto cleanup = Cleanup([before] {
+    ASSERT_THAT(prctl(PR_SET_TIMERSLACK, before), SyscallSucceeds());
+  });
+
+  EXPECT_THAT(prctl(PR_SET_TIMERSLACK, 12345), SyscallSucceeds());
+  EXPECT_THAT(prctl(PR_GET_TIMERSLACK), SyscallSucceedsWithValue(12345));
+
+  // 0 resets the slack to its default, which is the slack inherited when the
+  // thread was created.
+  EXPECT_THAT(prctl(PR_SET_TIMERSLACK, 0), SyscallSucceeds());
+  EXPECT_THAT(prctl(PR_GET_TIMERSLACK), SyscallSucceedsWithValue(before));
+}
+
+// A new thread inherits both its timer slack and its default timer slack from
+// the thread that created it.
+TEST(PrctlTest, TimerSlackInheritedByThread) {
+  int before;
+  ASSERT_THAT(before = prctl(PR_GET_TIMERSLACK), SyscallSucceeds());
+  auto cleanup = Cleanup([before] {
+    ASSERT_THAT(prctl(PR_SET_TIMERSLACK, before), SyscallSucceeds());
+  });
+
+  constexpr int kSlack = 1234567;
+  ASSERT_THAT(prctl(PR_SET_TIMERSLACK, kSlack), SyscallSucceeds());
+  ScopedThread([] {
+    EXPECT_THAT(prctl(PR_GET_TIMERSLACK), SyscallSucceedsWithValue(kSlack));
+    EXPECT_THAT(prctl(PR_SET_TIMERSLACK, 1), SyscallSucceeds());
+    EXPECT_THAT(prctl(PR_SET_TIMERSLACK, 0), SyscallSucceeds());
+    EXPECT_THAT(prctl(PR_GET_TIMERSLACK), SyscallSucceedsWithValue(kSlack));
+  });
+}
+
 }  // namespace
 
 }  // namespace testing
@@ -2103,6 +2103,82 @@ TEST(Proc, PidTidIOAccounting) {
   noop.Join();
 }
 
+// Returns the number of times syscall sysno has been executed, according to
+// the gVisor-specific syscall_stats file at path.
+PosixErrorOr<uint64_t> SyscallStatsCount(const std::string& path, int sysno) {
+  ASSIGN_OR_RETURN_ERRNO(std::string contents, GetContents(path));
+  std::vector<std::string> lines = absl::StrSplit(contents, '\n');
+  if (lines.empty() || lines[0] != "sysno name count sentry_ns") {
+    return PosixError(EINVAL, absl::StrCat("bad header in ", path));
+  }
+  for (size_t i = 1; i < lines.size(); i++) {
+    if (lines[i].empty()) {
+      continue;
+    }
+    std::vector<std::string> fields = absl::StrSplit(lines[i], ' ');
+    int line_sysno;
+    uint64_t count, sentry_ns;
+    if (fields.size() != 4 || !absl::SimpleAtoi(fields[0], &line_sysno) ||
+        !absl::SimpleAtoi(fields[2], &count) ||
+        !absl::SimpleAtoi(fields[3], &sentry_ns) || count == 0) {
+      return PosixError(EINVAL, absl::StrCat("bad line in ", path, ": ",
+                                             lines[i]));
+    }
+    if (line_sysno == sysno) {
+      return count;
+    }
+  }
+  return 0;
+}
+
+TEST(ProcSyscallStats, CountsTaskSyscalls) {
+  SKIP_IF(!IsRunningOnGvisor());
+
+  constexpr int kCalls = 10;
+  const std::string path =
+      absl::StrCat("/proc/self/task/", syscall(SYS_gettid), "/syscall_stats");
+  const uint64_t before =
+      ASSERT_NO_ERRNO_AND_VALUE(SyscallStatsCount(path, SYS_getppid));
+  for (int i = 0; i < kCalls; i++) {
+    syscall(SYS_getppid);
+  }
+  EXPECT_EQ(ASSERT_NO_ERRNO_AND_VALUE(SyscallStatsCount(path, SYS_getppid)),
+            before + kCalls);
+}
+
+TEST(ProcSyscallStats, ThreadGroupIncludesAllThreads) {
+  SKIP_IF(!IsRunningOnGvisor());
+
+  constexpr int kCalls = 10;
+  const std::string tg_path = "/proc/self/syscall_stats";
+  const std::string task_path =
+      absl::StrCat("/proc/self/task/", syscall(SYS_gettid), "/syscall_stats");
+  const uint64_t tg_before =
+      ASSERT_NO_ERRNO_AND_VALUE(SyscallStatsCount(tg_path, SYS_getppid));
+  const uint64_t task_before =
+      ASSERT_NO_ERRNO_AND_VALUE(SyscallStatsCount(task_path, SYS_getppid));
+
+  absl::Notification done;
+  absl::Notification checked;
+  ScopedThread t([&] {
+    for (int i = 0; i < kCalls; i++) {
+      syscall(SYS_getppid);
+    }
+    done.Notify();
+    // Stay alive until the thread group's statistics have been read, since
+    // only live threads are included.
+    checked.WaitForNotification();
+  });
+  done.WaitForNotification();
+
+  EXPECT_GE(ASSERT_NO_ERRNO_AND_VALUE(SyscallStatsCount(tg_path, SYS_getppid)),
+            tg_before + kCalls);
+  EXPECT_EQ(
+      ASSERT_NO_ERRNO_AND_VALUE(SyscallStatsCount(task_path, SYS_getppid)),
+      task_before);
+  checked.Notify();
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace gvisor
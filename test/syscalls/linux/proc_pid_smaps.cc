@@ -14,6 +14,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <iostream>
@@ -21,7 +22,9 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
@@ -402,6 +405,27 @@ TEST(ProcPidSmapsTest, PrivateAnon) {
   }
 }
 
+TEST(ProcPidSmapsTest, PrivateAnonHugePages) {
+  constexpr size_t kHugePageSize = 2 << 20;
+
+  // Map with MAP_POPULATE so we get some RSS, and large enough to contain a
+  // hugepage-aligned hugepage wherever it's placed.
+  Mapping const m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kHugePageSize, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_POPULATE));
+  auto const entries = ASSERT_NO_ERRNO_AND_VALUE(ReadProcSelfSmaps());
+  auto const entry =
+      ASSERT_NO_ERRNO_AND_VALUE(FindUniqueSmapsEntry(entries, m.addr()));
+
+  // Whether transparent hugepages are used depends on the host, but they can
+  // only back anonymous memory in whole hugepages.
+  if (entry.anon_huge_pages_kb) {
+    ASSERT_TRUE(entry.anonymous_kb);
+    EXPECT_LE(entry.anon_huge_pages_kb.value(), entry.anonymous_kb.value());
+    EXPECT_EQ(entry.anon_huge_pages_kb.value() % (kHugePageSize / 1024), 0);
+  }
+}
+
 TEST(ProcPidSmapsTest, SharedReadOnlyFile) {
   size_t const kFileSize = kPageSize;
 
@@ -462,6 +486,44 @@ TEST(ProcPidSmapsTest, GvisorFields) {
   }
 }
 
+TEST(ProcPidSmapsRollupTest, Fields) {
+  // smaps_rollup was added in Linux 4.14.
+  SKIP_IF(!IsRunningOnGvisor() &&
+          access("/proc/self/smaps_rollup", R_OK) != 0);
+
+  // Map with MAP_POPULATE so we get some RSS.
+  Mapping const m = ASSERT_NO_ERRNO_AND_VALUE(MmapAnon(
+      16 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_POPULATE));
+  std::string const contents =
+      ASSERT_NO_ERRNO_AND_VALUE(GetContents("/proc/self/smaps_rollup"));
+
+  std::vector<absl::string_view> lines =
+      absl::StrSplit(contents, '\n', absl::SkipEmpty());
+  ASSERT_FALSE(lines.empty());
+  EXPECT_TRUE(absl::EndsWith(lines[0], "[rollup]")) << lines[0];
+  absl::flat_hash_map<std::string, size_t> fields_kb;
+  for (size_t i = 1; i < lines.size(); i++) {
+    std::pair<absl::string_view, absl::string_view> parts =
+        absl::StrSplit(lines[i], absl::MaxSplits(':', 1));
+    fields_kb[std::string(parts.first)] =
+        ASSERT_NO_ERRNO_AND_VALUE(SmapsValueKb(parts.second));
+  }
+
+  for (auto const& name : {"Rss", "Pss", "Shared_Clean", "Shared_Dirty",
+                           "Private_Clean", "Private_Dirty", "Referenced",
+                           "Anonymous", "Swap", "Locked"}) {
+    EXPECT_TRUE(fields_kb.contains(name)) << name;
+  }
+  EXPECT_LE(fields_kb["Anonymous"], fields_kb["Rss"]);
+  EXPECT_EQ(fields_kb["Shared_Clean"] + fields_kb["Shared_Dirty"] +
+                fields_kb["Private_Clean"] + fields_kb["Private_Dirty"],
+            fields_kb["Rss"]);
+  if (IsRunningOnGvisor()) {
+    // Pages can't be swapped out in gVisor, so our mapping must be counted.
+    EXPECT_GE(fields_kb["Rss"], m.len() / 1024);
+  }
+}
+
 }  // namespace
 
 }  // namespace testing
@@ -0,0 +1,178 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr char kPattern = 'g';
+
+TEST(ProcessVMTest, ReadSelf) {
+  std::vector<char> src(3 * kPageSize, kPattern);
+  std::vector<char> dst(src.size());
+  struct iovec local = {dst.data(), dst.size()};
+  struct iovec remote = {src.data(), src.size()};
+  EXPECT_THAT(process_vm_readv(getpid(), &local, 1, &remote, 1, 0),
+              SyscallSucceedsWithValue(src.size()));
+  EXPECT_EQ(src, dst);
+}
+
+TEST(ProcessVMTest, WriteSelf) {
+  std::vector<char> src(3 * kPageSize, kPattern);
+  std::vector<char> dst(src.size());
+  struct iovec local = {src.data(), src.size()};
+  struct iovec remote = {dst.data(), dst.size()};
+  EXPECT_THAT(process_vm_writev(getpid(), &local, 1, &remote, 1, 0),
+              SyscallSucceedsWithValue(src.size()));
+  EXPECT_EQ(src, dst);
+}
+
+TEST(ProcessVMTest, ScattersAcrossIovecs) {
+  char src[] = "0123456789";
+  char a[3] = {}, b[7] = {};
+  struct iovec local[] = {{a, sizeof(a)}, {b, sizeof(b)}};
+  struct iovec remote[] = {{src, 5}, {src + 5, 5}};
+  EXPECT_THAT(process_vm_readv(getpid(), local, 2, remote, 2, 0),
+              SyscallSucceedsWithValue(10));
+  EXPECT_EQ(0, memcmp(a, "012", 3));
+  EXPECT_EQ(0, memcmp(b, "3456789", 7));
+}
+
+TEST(ProcessVMTest, InvalidFlags) {
+  char buf;
+  struct iovec iov = {&buf, 1};
+  EXPECT_THAT(process_vm_readv(getpid(), &iov, 1, &iov, 1, 1),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(ProcessVMTest, NoSuchProcess) {
+  pid_t child = fork();
+  if (child == 0) {
+    _exit(0);
+  }
+  ASSERT_THAT(child, SyscallSucceeds());
+  int status;
+  ASSERT_THAT(waitpid(child, &status, 0), SyscallSucceedsWithValue(child));
+
+  char buf;
+  struct iovec iov = {&buf, 1};
+  EXPECT_THAT(process_vm_readv(child, &iov, 1, &iov, 1, 0),
+              SyscallFailsWithErrno(ESRCH));
+}
+
+// A remote fault after some bytes have been transferred results in a short
+// transfer rather than an error.
+TEST(ProcessVMTest, PartialRemoteFault) {
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), kPattern, kPageSize);
+  ASSERT_THAT(munmap(reinterpret_cast<char*>(m.ptr()) + kPageSize, kPageSize),
+              SyscallSucceeds());
+
+  std::vector<char> dst(2 * kPageSize);
+  struct iovec local = {dst.data(), dst.size()};
+  struct iovec remote = {m.ptr(), 2 * kPageSize};
+  EXPECT_THAT(process_vm_readv(getpid(), &local, 1, &remote, 1, 0),
+              SyscallSucceedsWithValue(kPageSize));
+
+  // A fault before any bytes are transferred is an error.
+  remote.iov_base = reinterpret_cast<char*>(m.ptr()) + kPageSize;
+  remote.iov_len = kPageSize;
+  EXPECT_THAT(process_vm_readv(getpid(), &local, 1, &remote, 1, 0),
+              SyscallFailsWithErrno(EFAULT));
+}
+
+TEST(ProcessVMTest, WriteReadOnlyFails) {
+  Mapping m =
+      ASSERT_NO_ERRNO_AND_VALUE(MmapAnon(kPageSize, PROT_READ, MAP_PRIVATE));
+  char buf[16] = {};
+  struct iovec local = {buf, sizeof(buf)};
+  struct iovec remote = {m.ptr(), sizeof(buf)};
+  EXPECT_THAT(process_vm_writev(getpid(), &local, 1, &remote, 1, 0),
+              SyscallFailsWithErrno(EFAULT));
+}
+
+// Reads and writes memory in a child process, including memory shared with
+// the parent copy-on-write.
+TEST(ProcessVMTest, Child) {
+  std::vector<char> buf(2 * kPageSize, kPattern);
+
+  int ready[2], done[2];
+  ASSERT_THAT(pipe(ready), SyscallSucceeds());
+  ASSERT_THAT(pipe(done), SyscallSucceeds());
+  pid_t child = fork();
+  if (child == 0) {
+    // Change the first page, then wait for the parent to write the second.
+    memset(buf.data(), 'c', kPageSize);
+    char c = 0;
+    TEST_PCHECK(write(ready[1], &c, 1) == 1);
+    TEST_PCHECK(read(done[0], &c, 1) == 1);
+    for (size_t i = kPageSize; i < buf.size(); i++) {
+      TEST_CHECK(buf[i] == 'p');
+    }
+    _exit(0);
+  }
+  ASSERT_THAT(child, SyscallSucceeds());
+  char c;
+  ASSERT_THAT(read(ready[0], &c, 1), SyscallSucceedsWithValue(1));
+
+  std::vector<char> got(buf.size());
+  struct iovec local = {got.data(), got.size()};
+  struct iovec remote = {buf.data(), buf.size()};
+  ASSERT_THAT(process_vm_readv(child, &local, 1, &remote, 1, 0),
+              SyscallSucceedsWithValue(buf.size()));
+  for (size_t i = 0; i < got.size(); i++) {
+    ASSERT_EQ(got[i], i < kPageSize ? 'c' : kPattern) << i;
+  }
+
+  std::vector<char> src(kPageSize, 'p');
+  local = {src.data(), src.size()};
+  remote = {buf.data() + kPageSize, kPageSize};
+  ASSERT_THAT(process_vm_writev(child, &local, 1, &remote, 1, 0),
+              SyscallSucceedsWithValue(kPageSize));
+  // The write must not be visible in the parent.
+  EXPECT_EQ(buf[kPageSize], kPattern);
+
+  ASSERT_THAT(write(done[1], &c, 1), SyscallSucceedsWithValue(1));
+  int status;
+  ASSERT_THAT(waitpid(child, &status, 0), SyscallSucceedsWithValue(child));
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+      << "status = " << status;
+
+  for (int fd : {ready[0], ready[1], done[0], done[1]}) {
+    close(fd);
+  }
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
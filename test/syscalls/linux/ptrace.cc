@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <elf.h>
+#include <linux/audit.h>
 #include <signal.h>
 #include <stddef.h>
 #include <sys/ptrace.h>
@@ -62,6 +63,30 @@ constexpr auto kPtraceSysemu = static_cast<__ptrace_request>(31);
 // PTRACE_EVENT_STOP").
 constexpr int kPtraceEventStop = 128;
 
+// PTRACE_GET_SYSCALL_INFO and struct ptrace_syscall_info are not defined until
+// Linux 5.3, and may be missing from the build environment's headers.
+constexpr auto kPtraceGetSyscallInfo = static_cast<__ptrace_request>(0x420e);
+constexpr uint8_t kPtraceSyscallInfoEntry = 1;
+constexpr uint8_t kPtraceSyscallInfoExit = 2;
+
+struct PtraceSyscallInfo {
+  uint8_t op;
+  uint8_t pad[3];
+  uint32_t arch;
+  uint64_t instruction_pointer;
+  uint64_t stack_pointer;
+  union {
+    struct {
+      uint64_t nr;
+      uint64_t args[6];
+    } entry;
+    struct {
+      int64_t rval;
+      uint8_t is_error;
+    } exit;
+  };
+};
+
 // Sends sig to the current process with tgkill(2).
 //
 // glibc's raise(2) may change the signal mask before sending the signal. These
@@ -933,6 +958,89 @@ TEST(PtraceTest, Sysemu_PokeUser) {
       << " status " << status;
 }
 
+TEST(PtraceTest, GetSyscallInfo) {
+  pid_t const child_pid = fork();
+  if (child_pid == 0) {
+    // In child process.
+
+    // Enable tracing, then raise SIGSTOP and expect our parent to suppress it.
+    TEST_PCHECK(ptrace(PTRACE_TRACEME, 0, 0, 0) == 0);
+    RaiseSignal(SIGSTOP);
+
+    TEST_PCHECK(syscall(SYS_getpid) == getpid());
+    _exit(0);
+  }
+  // In parent process.
+  ASSERT_THAT(child_pid, SyscallSucceeds());
+
+  // Wait for the child to send itself SIGSTOP and enter signal-delivery-stop.
+  int status;
+  ASSERT_THAT(waitpid(child_pid, &status, 0),
+              SyscallSucceedsWithValue(child_pid));
+  EXPECT_TRUE(WIFSTOPPED(status) && WSTOPSIG(status) == SIGSTOP)
+      << " status " << status;
+
+  // Outside of a syscall-stop, only the common fields are returned.
+  struct PtraceSyscallInfo info = {};
+  ASSERT_THAT(ptrace(kPtraceGetSyscallInfo, child_pid, sizeof(info), &info),
+              SyscallSucceedsWithValue(offsetof(PtraceSyscallInfo, entry)));
+  EXPECT_EQ(info.op, 0);
+
+  ASSERT_THAT(ptrace(PTRACE_SETOPTIONS, child_pid, 0, PTRACE_O_TRACESYSGOOD),
+              SyscallSucceeds());
+
+  // Suppress the SIGSTOP and wait for the child to enter syscall-enter-stop
+  // for getpid.
+  ASSERT_THAT(ptrace(PTRACE_SYSCALL, child_pid, 0, 0), SyscallSucceeds());
+  ASSERT_THAT(waitpid(child_pid, &status, 0),
+              SyscallSucceedsWithValue(child_pid));
+  ASSERT_TRUE(WIFSTOPPED(status) && WSTOPSIG(status) == (SIGTRAP | 0x80))
+      << " status " << status;
+
+  info = {};
+  ASSERT_THAT(ptrace(kPtraceGetSyscallInfo, child_pid, sizeof(info), &info),
+              SyscallSucceedsWithValue(offsetof(PtraceSyscallInfo, entry) +
+                                       sizeof(info.entry)));
+  EXPECT_EQ(info.op, kPtraceSyscallInfoEntry);
+  EXPECT_EQ(info.arch, AUDIT_ARCH_X86_64);
+  EXPECT_EQ(info.entry.nr, SYS_getpid);
+  EXPECT_NE(info.instruction_pointer, 0);
+  EXPECT_NE(info.stack_pointer, 0);
+
+  // Continue to syscall-exit-stop.
+  ASSERT_THAT(ptrace(PTRACE_SYSCALL, child_pid, 0, 0), SyscallSucceeds());
+  ASSERT_THAT(waitpid(child_pid, &status, 0),
+              SyscallSucceedsWithValue(child_pid));
+  ASSERT_TRUE(WIFSTOPPED(status) && WSTOPSIG(status) == (SIGTRAP | 0x80))
+      << " status " << status;
+
+  info = {};
+  ASSERT_THAT(ptrace(kPtraceGetSyscallInfo, child_pid, sizeof(info), &info),
+              SyscallSucceedsWithValue(offsetof(PtraceSyscallInfo, exit) +
+                                       offsetof(decltype(info.exit), is_error) +
+                                       sizeof(info.exit.is_error)));
+  EXPECT_EQ(info.op, kPtraceSyscallInfoExit);
+  EXPECT_EQ(info.exit.rval, child_pid);
+  EXPECT_EQ(info.exit.is_error, 0);
+
+  // A short buffer receives a truncated copy, but the full size is still
+  // returned.
+  uint8_t op = 0xff;
+  ASSERT_THAT(ptrace(kPtraceGetSyscallInfo, child_pid, sizeof(op), &op),
+              SyscallSucceedsWithValue(offsetof(PtraceSyscallInfo, exit) +
+                                       offsetof(decltype(info.exit), is_error) +
+                                       sizeof(info.exit.is_error)));
+  EXPECT_EQ(op, kPtraceSyscallInfoExit);
+
+  ASSERT_THAT(ptrace(PTRACE_DETACH, child_pid, 0, 0), SyscallSucceeds());
+
+  // The child should exit normally.
+  ASSERT_THAT(waitpid(child_pid, &status, 0),
+              SyscallSucceedsWithValue(child_pid));
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+      << " status " << status;
+}
+
 // This test also cares about syscall-exit-stop.
 TEST(PtraceTest, ERESTART_NoRandomSave) {
   constexpr int kSigno = SIGUSR1;
@@ -13,9 +13,11 @@
 // limitations under the License.
 
 #include <linux/capability.h>
+#include <linux/filter.h>
 #include <netinet/in.h>
 #include <netinet/ip.h>
 #include <netinet/ip_icmp.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -416,6 +418,110 @@ TEST_F(RawSocketICMPTest, BindConnectSendAndReceive) {
   ASSERT_NO_FATAL_FAILURE(ExpectICMPSuccess(icmp));
 }
 
+// A socket filter only queues the packets it accepts.
+TEST_F(RawSocketICMPTest, FilterSelectsEchoReplies) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_NET_RAW)));
+
+  // Accept ICMP echo replies and drop everything else.
+  struct sock_filter insns[] = {
+      // X = IP header length.
+      BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),
+      // A = ICMP type.
+      BPF_STMT(BPF_LD | BPF_B | BPF_IND, 0),
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ICMP_ECHOREPLY, 0, 1),
+      BPF_STMT(BPF_RET | BPF_K, 0xffff),
+      BPF_STMT(BPF_RET | BPF_K, 0),
+  };
+  struct sock_fprog prog = {};
+  prog.len = ABSL_ARRAYSIZE(insns);
+  prog.filter = insns;
+  ASSERT_THAT(setsockopt(s_, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)),
+              SyscallSucceeds());
+
+  struct icmphdr icmp;
+  icmp.type = ICMP_ECHO;
+  icmp.code = 0;
+  icmp.checksum = 0;
+  icmp.un.echo.sequence = 2021;
+  icmp.un.echo.id = 11;
+  icmp.checksum = ICMPChecksum(icmp, NULL, 0);
+  ASSERT_NO_FATAL_FAILURE(SendEmptyICMP(icmp));
+
+  // Only the reply is received.
+  char recv_buf[kEmptyICMPSize];
+  struct sockaddr_in src;
+  ASSERT_NO_FATAL_FAILURE(
+      ReceiveICMP(recv_buf, sizeof(recv_buf), sizeof(struct icmphdr), &src));
+  struct icmphdr* recvd_icmp =
+      reinterpret_cast<struct icmphdr*>(recv_buf + sizeof(struct iphdr));
+  EXPECT_EQ(recvd_icmp->type, ICMP_ECHOREPLY);
+  EXPECT_EQ(recvd_icmp->un.echo.id, icmp.un.echo.id);
+
+  struct pollfd pfd = {s_, POLLIN, 0};
+  EXPECT_THAT(RetryEINTR(poll)(&pfd, 1, 100), SyscallSucceedsWithValue(0));
+
+  // Once the filter is detached, both the request and reply are received.
+  int opt = 0;
+  ASSERT_THAT(setsockopt(s_, SOL_SOCKET, SO_DETACH_FILTER, &opt, sizeof(opt)),
+              SyscallSucceeds());
+  ASSERT_NO_FATAL_FAILURE(SendEmptyICMP(icmp));
+  ASSERT_NO_FATAL_FAILURE(ExpectICMPSuccess(icmp));
+}
+
+// A socket filter can truncate the packets it accepts.
+TEST_F(RawSocketICMPTest, FilterTruncates) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_NET_RAW)));
+
+  // Keep the IP header and the ICMP type, code and checksum.
+  constexpr size_t kSnapLen = sizeof(struct iphdr) + 4;
+  struct sock_filter insns[] = {
+      BPF_STMT(BPF_RET | BPF_K, kSnapLen),
+  };
+  struct sock_fprog prog = {};
+  prog.len = ABSL_ARRAYSIZE(insns);
+  prog.filter = insns;
+  ASSERT_THAT(setsockopt(s_, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)),
+              SyscallSucceeds());
+
+  struct icmphdr icmp;
+  icmp.type = ICMP_ECHO;
+  icmp.code = 0;
+  icmp.checksum = 0;
+  icmp.un.echo.sequence = 2021;
+  icmp.un.echo.id = 12;
+  icmp.checksum = ICMPChecksum(icmp, NULL, 0);
+  ASSERT_NO_FATAL_FAILURE(SendEmptyICMP(icmp));
+
+  char recv_buf[kEmptyICMPSize];
+  for (int i = 0; i < 2; i++) {
+    EXPECT_THAT(RetryEINTR(recv)(s_, recv_buf, sizeof(recv_buf), 0),
+                SyscallSucceedsWithValue(kSnapLen));
+  }
+}
+
+// Detaching a filter fails if there is none.
+TEST_F(RawSocketICMPTest, DetachFilterWithoutFilter) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_NET_RAW)));
+
+  int opt = 0;
+  EXPECT_THAT(setsockopt(s_, SOL_SOCKET, SO_DETACH_FILTER, &opt, sizeof(opt)),
+              SyscallFailsWithErrno(ENOENT));
+}
+
+// Programs that don't end with a return are rejected.
+TEST_F(RawSocketICMPTest, AttachInvalidFilter) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_NET_RAW)));
+
+  struct sock_filter insns[] = {
+      BPF_STMT(BPF_LD | BPF_W | BPF_LEN, 0),
+  };
+  struct sock_fprog prog = {};
+  prog.len = ABSL_ARRAYSIZE(insns);
+  prog.filter = insns;
+  EXPECT_THAT(setsockopt(s_, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)),
+              SyscallFailsWithErrno(EINVAL));
+}
+
 void RawSocketICMPTest::ExpectICMPSuccess(const struct icmphdr& icmp) {
   // We're going to receive both the echo request and reply, but the order is
   // indeterminate.
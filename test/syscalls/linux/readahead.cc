@@ -15,6 +15,8 @@
 #include <errno.h>
 #include <fcntl.h>
 
+#include <string>
+
 #include "gtest/gtest.h"
 #include "test/util/file_descriptor.h"
 #include "test/util/temp_path.h"
@@ -49,6 +51,28 @@ TEST(ReadaheadTest, ValidOffset) {
                                                SyscallFailsWithErrno(EINVAL)));
 }
 
+TEST(ReadaheadTest, ReadAfterReadahead) {
+  std::string contents(1 << 20, 0);
+  for (size_t i = 0; i < contents.size(); i++) {
+    contents[i] = i % 251;
+  }
+  const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode));
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file.path(), O_RDONLY));
+
+  // See above.
+  EXPECT_THAT(readahead(fd.get(), 4096, contents.size()),
+              AnyOf(SyscallSucceedsWithValue(0), SyscallFailsWithErrno(EINVAL)));
+
+  // Reads must return the file's contents, whether or not they were read
+  // ahead.
+  std::string buf(contents.size(), 0);
+  ASSERT_THAT(ReadFd(fd.get(), &buf[0], buf.size()),
+              SyscallSucceedsWithValue(buf.size()));
+  EXPECT_EQ(buf, contents);
+}
+
 TEST(ReadaheadTest, PastEnd) {
   constexpr char kData[] = "123";
   const TempPath in_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
@@ -19,6 +19,9 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "test/syscalls/linux/rseq/test.h"
 #include "test/syscalls/linux/rseq/uapi.h"
@@ -85,13 +88,15 @@ PosixErrorOr<bool> RSeqSupported() {
 
 constexpr char kRseqBinary[] = "test/syscalls/linux/rseq/rseq";
 
-void RunChildTest(std::string test_case, int want_status) {
+void RunChildTest(std::string test_case, int want_status,
+                  std::vector<std::string> args = {}) {
   std::string path = RunfilePath(kRseqBinary);
+  args.insert(args.begin(), {path, test_case});
 
   pid_t child_pid = -1;
   int execve_errno = 0;
-  auto cleanup = ASSERT_NO_ERRNO_AND_VALUE(
-      ForkAndExec(path, {path, test_case}, {}, &child_pid, &execve_errno));
+  auto cleanup = ASSERT_NO_ERRNO_AND_VALUE(ForkAndExec(
+      path, ExecveArray(args), {}, &child_pid, &execve_errno));
 
   ASSERT_GT(child_pid, 0);
   ASSERT_EQ(execve_errno, 0);
@@ -192,6 +197,22 @@ TEST(RseqTest, InvalidAbortClearsCS) {
   RunChildTest(kRseqTestInvalidAbortClearsCS, 0);
 }
 
+// Per-CPU counter increments from multiple threads are neither lost nor
+// duplicated.
+TEST(RseqTest, PerCPUCounter) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(RSeqSupported()));
+
+  RunChildTest(kRseqBenchPerCPUCounter, 0, {"4", "100000"});
+}
+
+// Per-CPU freelist pushes and pops from multiple threads neither lose nor
+// duplicate nodes.
+TEST(RseqTest, PerCPUFreelist) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(RSeqSupported()));
+
+  RunChildTest(kRseqBenchPerCPUFreelist, 0, {"4", "100000"});
+}
+
 }  // namespace
 
 }  // namespace testing
@@ -20,6 +20,11 @@
 
 constexpr uint32_t kRseqSignature = 0x90909090;
 
+// Layout of the per-CPU data used by the rseq_percpu_* critical sections,
+// which hardcode these values.
+constexpr int kRseqPerCPUSlots = 1024;
+constexpr int kRseqPerCPUSlotSize = 64;
+
 extern "C" {
 
 extern void rseq_loop(struct rseq* r, struct rseq_cs* cs);
@@ -34,6 +39,25 @@ extern void* rseq_getpid_start;
 extern void* rseq_getpid_post_commit;
 extern void* rseq_getpid_abort;
 
+// Per-CPU critical sections. percpu points to kRseqPerCPUSlots slots of
+// kRseqPerCPUSlotSize bytes: a counter followed by a freelist head.
+extern int rseq_percpu_inc(struct rseq* r, struct rseq_cs* cs, void* percpu);
+extern void* rseq_percpu_inc_start;
+extern void* rseq_percpu_inc_post_commit;
+extern void* rseq_percpu_inc_abort;
+
+extern int rseq_percpu_pop(struct rseq* r, struct rseq_cs* cs, void* percpu,
+                           void** node);
+extern void* rseq_percpu_pop_start;
+extern void* rseq_percpu_pop_post_commit;
+extern void* rseq_percpu_pop_abort;
+
+extern int rseq_percpu_push(struct rseq* r, struct rseq_cs* cs, void* percpu,
+                            void* node);
+extern void* rseq_percpu_push_start;
+extern void* rseq_percpu_push_post_commit;
+extern void* rseq_percpu_push_abort;
+
 }  // extern "C"
 
 #endif  // GVISOR_TEST_SYSCALLS_LINUX_RSEQ_CRITICAL_H_
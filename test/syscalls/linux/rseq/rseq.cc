@@ -308,12 +308,271 @@ int TestInvalidAbortClearsCS() {
   return 0;
 };
 
+// Benchmarks.
+//
+// Each benchmark thread registers rseq and commits a fixed number of per-CPU
+// critical sections, counting those that abort. The threads are real threads
+// (see clone_thread), so they share the per-CPU data below as tcmalloc's
+// per-CPU caches would.
+
+constexpr int kMaxBenchThreads = 64;
+constexpr int kBenchStackSize = 64 << 10;
+
+// Per-CPU slot accessed by the rseq_percpu_* critical sections.
+struct alignas(kRseqPerCPUSlotSize) PerCPU {
+  uint64_t counter;
+  void* head;
+};
+static_assert(sizeof(PerCPU) == kRseqPerCPUSlotSize, "bad PerCPU layout");
+
+PerCPU percpu[kRseqPerCPUSlots];
+
+// Freelist node; the link is the first word, as rseq_percpu_* expect.
+struct Node {
+  Node* next;
+};
+
+struct alignas(16) BenchStack {
+  char bytes[kBenchStackSize];
+};
+
+struct BenchThread {
+  struct rseq r;
+  BenchStack* stack;
+
+  // Number of critical sections to commit.
+  uint64_t ops;
+  uint64_t commits;
+  uint64_t aborts;
+
+  // Set if rseq registration failed.
+  bool failed;
+
+  // Freelist node held by this thread, if any.
+  Node* node;
+};
+
+BenchStack bench_stacks[kMaxBenchThreads];
+BenchThread bench_threads[kMaxBenchThreads];
+Node bench_nodes[kMaxBenchThreads];
+
+struct rseq_cs inc_cs;
+struct rseq_cs pop_cs;
+struct rseq_cs push_cs;
+
+bool bench_freelist;
+
+// Number of threads that have registered rseq, and that have finished.
+int bench_ready;
+int bench_done;
+
+// Set once all threads are ready.
+bool bench_go;
+
+void InitCS(struct rseq_cs* cs, void* start, void* post_commit, void* abort) {
+  cs->version = 0;
+  cs->flags = 0;
+  cs->start_ip = reinterpret_cast<uint64_t>(start);
+  cs->post_commit_offset = reinterpret_cast<uint64_t>(post_commit) -
+                           reinterpret_cast<uint64_t>(start);
+  cs->abort_ip = reinterpret_cast<uint64_t>(abort);
+}
+
+// Increments per-CPU counters.
+void RunCounter(BenchThread* t) {
+  while (t->commits < t->ops) {
+    if (rseq_percpu_inc(&t->r, &inc_cs, percpu) == 0) {
+      t->commits++;
+    } else {
+      t->aborts++;
+    }
+  }
+}
+
+// Alternately pushes the thread's node onto a per-CPU freelist, and pops a
+// node off of one, as a per-CPU allocator would on free and malloc.
+void RunFreelist(BenchThread* t) {
+  void* node = t->node;
+  while (t->commits < t->ops) {
+    int ret;
+    if (node != nullptr) {
+      ret = rseq_percpu_push(&t->r, &push_cs, percpu, node);
+      if (ret == 0) {
+        node = nullptr;
+      }
+    } else {
+      // If the list is empty, because a migration moved this thread away from
+      // the CPU it pushed to, node remains nullptr and the pop is retried.
+      ret = rseq_percpu_pop(&t->r, &pop_cs, percpu, &node);
+    }
+    if (ret == 0) {
+      t->commits++;
+    } else {
+      t->aborts++;
+    }
+  }
+  t->node = static_cast<Node*>(node);
+}
+
+void BenchThreadMain(void* arg) {
+  BenchThread* t = static_cast<BenchThread*>(arg);
+  if (int ret = sys_rseq(&t->r, sizeof(t->r), 0, kRseqSignature);
+      sys_errno(ret) != 0) {
+    t->failed = true;
+  }
+  __atomic_add_fetch(&bench_ready, 1, __ATOMIC_RELEASE);
+  while (!__atomic_load_n(&bench_go, __ATOMIC_ACQUIRE)) {
+    sys_sched_yield();
+  }
+
+  if (!t->failed) {
+    if (bench_freelist) {
+      RunFreelist(t);
+    } else {
+      RunCounter(t);
+    }
+  }
+
+  __atomic_add_fetch(&bench_done, 1, __ATOMIC_RELEASE);
+}
+
+// Parses a decimal integer.
+bool ParseUint(const char* s, uint64_t* v) {
+  if (*s == '\0') {
+    return false;
+  }
+  *v = 0;
+  for (; *s != '\0'; s++) {
+    if (*s < '0' || *s > '9') {
+      return false;
+    }
+    *v = *v * 10 + (*s - '0');
+  }
+  return true;
+}
+
+// Appends the decimal representation of v to buf at *pos.
+void AppendUint(char* buf, int* pos, uint64_t v) {
+  char digits[20];
+  int n = 0;
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v != 0);
+  while (n > 0) {
+    buf[(*pos)++] = digits[--n];
+  }
+}
+
+// Runs the benchmark name with threads_arg threads, each committing ops_arg
+// critical sections.
+int Bench(const char* name, const char* threads_arg, const char* ops_arg) {
+  uint64_t threads, ops;
+  if (!ParseUint(threads_arg, &threads) || threads < 1 ||
+      threads > kMaxBenchThreads || !ParseUint(ops_arg, &ops) || ops < 1) {
+    return 2;
+  }
+
+  InitCS(&inc_cs, &rseq_percpu_inc_start, &rseq_percpu_inc_post_commit,
+         &rseq_percpu_inc_abort);
+  InitCS(&pop_cs, &rseq_percpu_pop_start, &rseq_percpu_pop_post_commit,
+         &rseq_percpu_pop_abort);
+  InitCS(&push_cs, &rseq_percpu_push_start, &rseq_percpu_push_post_commit,
+         &rseq_percpu_push_abort);
+  bench_freelist = strcmp(name, kRseqBenchPerCPUFreelist) == 0;
+
+  for (uint64_t i = 0; i < threads; i++) {
+    BenchThread* t = &bench_threads[i];
+    t->ops = ops;
+    t->node = &bench_nodes[i];
+    t->stack = &bench_stacks[i];
+  }
+
+  // This thread runs bench_threads[0].
+  for (uint64_t i = 1; i < threads; i++) {
+    BenchThread* t = &bench_threads[i];
+    clone_thread(&t->stack->bytes[kBenchStackSize], BenchThreadMain, t);
+  }
+  while (__atomic_load_n(&bench_ready, __ATOMIC_ACQUIRE) !=
+         static_cast<int>(threads - 1)) {
+    sys_sched_yield();
+  }
+
+  const int64_t start = sys_clock_gettime_ns();
+  __atomic_store_n(&bench_go, true, __ATOMIC_RELEASE);
+  BenchThreadMain(&bench_threads[0]);
+  while (__atomic_load_n(&bench_done, __ATOMIC_ACQUIRE) !=
+         static_cast<int>(threads)) {
+    sys_sched_yield();
+  }
+  const int64_t elapsed = sys_clock_gettime_ns() - start;
+
+  uint64_t commits = 0, aborts = 0;
+  uint64_t held = 0;
+  for (uint64_t i = 0; i < threads; i++) {
+    if (bench_threads[i].failed) {
+      return 1;
+    }
+    commits += bench_threads[i].commits;
+    aborts += bench_threads[i].aborts;
+    if (bench_threads[i].node != nullptr) {
+      held++;
+    }
+  }
+
+  // Check that no critical section committed twice, or lost an update.
+  if (bench_freelist) {
+    uint64_t listed = 0;
+    for (int i = 0; i < kRseqPerCPUSlots; i++) {
+      for (Node* n = static_cast<Node*>(percpu[i].head); n != nullptr;
+           n = n->next) {
+        if (++listed > threads) {
+          return 1;
+        }
+      }
+    }
+    if (listed + held != threads) {
+      return 1;
+    }
+  } else {
+    uint64_t sum = 0;
+    for (int i = 0; i < kRseqPerCPUSlots; i++) {
+      sum += percpu[i].counter;
+    }
+    if (sum != commits) {
+      return 1;
+    }
+  }
+
+  char buf[64];
+  int pos = 0;
+  AppendUint(buf, &pos, commits);
+  buf[pos++] = ' ';
+  AppendUint(buf, &pos, aborts);
+  buf[pos++] = ' ';
+  AppendUint(buf, &pos, elapsed);
+  buf[pos++] = '\n';
+  if (sys_write(1, buf, pos) != pos) {
+    return 1;
+  }
+  return 0;
+}
+
 // Exit codes:
 //  0 - Pass
 //  1 - Fail
 //  2 - Missing argument
 //  3 - Unknown test case
 extern "C" int main(int argc, char** argv, char** envp) {
+  if (argc >= 2 && (strcmp(argv[1], kRseqBenchPerCPUCounter) == 0 ||
+                    strcmp(argv[1], kRseqBenchPerCPUFreelist) == 0)) {
+    // Usage: rseq <benchmark> <threads> <ops>
+    if (argc != 4) {
+      return 2;
+    }
+    return Bench(argv[1], argv[2], argv[3]);
+  }
+
   if (argc != 2) {
     // Usage: rseq <test case>
     return 2;
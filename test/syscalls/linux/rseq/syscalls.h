@@ -19,9 +19,15 @@
 
 // Syscall numbers.
 #if defined(__x86_64__)
+constexpr int kWrite = 1;
+constexpr int kSchedYield = 24;
 constexpr int kGetpid = 39;
+constexpr int kClockGettime = 228;
 constexpr int kExitGroup = 231;
 #elif defined(__aarch64__)
+constexpr int kWrite = 64;
+constexpr int kClockGettime = 113;
+constexpr int kSchedYield = 124;
 constexpr int kGetpid = 172;
 constexpr int kExitGroup = 94;
 #else
@@ -62,6 +68,26 @@ static inline void sys_exit_group(int status) {
 static inline int sys_getpid() {
   return static_cast<int>(raw_syscall(kGetpid));
 }
+static inline int64_t sys_write(int fd, const void* buf, size_t count) {
+  return static_cast<int64_t>(raw_syscall(kWrite, fd, buf, count));
+}
+static inline void sys_sched_yield() { raw_syscall(kSchedYield); }
+
+// Returns CLOCK_MONOTONIC in nanoseconds.
+static inline int64_t sys_clock_gettime_ns() {
+  constexpr int kClockMonotonic = 1;
+  struct {
+    int64_t tv_sec;
+    int64_t tv_nsec;
+  } ts = {};
+  raw_syscall(kClockGettime, kClockMonotonic, &ts);
+  return ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Starts a thread sharing this thread's address space, files and signal
+// handlers, which runs fn(arg) on the stack ending at stack_top, which must be
+// 16-byte aligned, and then exits. Implemented in start_*.S.
+extern "C" void clone_thread(void* stack_top, void (*fn)(void*), void* arg);
 
 }  // namespace testing
 }  // namespace gvisor
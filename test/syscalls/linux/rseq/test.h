@@ -37,6 +37,14 @@ inline constexpr char kRseqTestAbortClearsCS[] = "abort-clears-cs";
 inline constexpr char kRseqTestInvalidAbortClearsCS[] =
     "invalid-abort-clears-cs";
 
+// Benchmarks supported by rseq binary. These take two additional arguments:
+// the number of threads and the number of committed critical sections per
+// thread. On success, they write "<commits> <aborts> <elapsed ns>\n" to
+// stdout.
+
+inline constexpr char kRseqBenchPerCPUCounter[] = "bench-percpu-counter";
+inline constexpr char kRseqBenchPerCPUFreelist[] = "bench-percpu-freelist";
+
 }  // namespace testing
 }  // namespace gvisor
 
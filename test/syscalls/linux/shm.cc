@@ -503,6 +503,29 @@ TEST(ShmTest, NoDestructionOfAttachedSegmentWithMultipleRmid) {
   ASSERT_NO_ERRNO(Shmdt(addr2));
 }
 
+// SHM_HUGETLB segments report their requested size and can be shared between
+// attachments.
+TEST(ShmTest, Hugetlb) {
+  constexpr size_t kHugePageSize = 2 << 20;
+  const size_t kSize = kHugePageSize + kPageSize;
+  auto shm_or = Shmget(IPC_PRIVATE, kSize, IPC_CREAT | SHM_HUGETLB | 0777);
+  // Linux fails if no huge pages are reserved, or without CAP_IPC_LOCK.
+  SKIP_IF(!IsRunningOnGvisor() && !shm_or.ok());
+  const ShmSegment shm = ASSERT_NO_ERRNO_AND_VALUE(std::move(shm_or));
+  struct shmid_ds attr;
+  ASSERT_NO_ERRNO(Shmctl(shm.id(), IPC_STAT, &attr));
+  EXPECT_EQ(attr.shm_segsz, kSize);
+
+  char* addr = ASSERT_NO_ERRNO_AND_VALUE(Shmat(shm.id(), nullptr, 0));
+  char* addr2 = ASSERT_NO_ERRNO_AND_VALUE(Shmat(shm.id(), nullptr, 0));
+  addr[0] = 'x';
+  addr[kSize - 1] = 'y';
+  EXPECT_EQ(addr2[0], 'x');
+  EXPECT_EQ(addr2[kSize - 1], 'y');
+  ASSERT_NO_ERRNO(Shmdt(addr));
+  ASSERT_NO_ERRNO(Shmdt(addr2));
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace gvisor
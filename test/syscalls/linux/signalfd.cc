@@ -307,6 +307,65 @@ TEST_P(SignalfdTest, Poll) {
               SyscallSucceedsWithValue(sizeof(rbuf)));
 }
 
+TEST(Signalfd, ReadReturnsAllPendingSignals) {
+  constexpr int kCount = 3;
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, kSigno);
+  sigaddset(&mask, kSignoMax);
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewSignalFD(&mask, SFD_NONBLOCK));
+
+  // Queue several instances of a realtime signal, and one standard signal.
+  const auto scoped_sigmask =
+      ASSERT_NO_ERRNO_AND_VALUE(ScopedSignalMask(SIG_BLOCK, mask));
+  for (int i = 0; i < kCount; i++) {
+    ASSERT_THAT(tgkill(getpid(), gettid(), kSignoMax), SyscallSucceeds());
+  }
+  ASSERT_THAT(tgkill(getpid(), gettid(), kSigno), SyscallSucceeds());
+
+  // A single read with room for more signals than are pending should return
+  // all of them, standard signals first.
+  struct signalfd_siginfo rbuf[kCount + 4];
+  ASSERT_THAT(read(fd.get(), rbuf, sizeof(rbuf)),
+              SyscallSucceedsWithValue((kCount + 1) * sizeof(rbuf[0])));
+  EXPECT_EQ(rbuf[0].ssi_signo, kSigno);
+  for (int i = 1; i <= kCount; i++) {
+    EXPECT_EQ(rbuf[i].ssi_signo, kSignoMax);
+  }
+
+  EXPECT_THAT(read(fd.get(), rbuf, sizeof(rbuf)),
+              SyscallFailsWithErrno(EWOULDBLOCK));
+}
+
+TEST(Signalfd, ReadReturnsOnlySignalsThatFit) {
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, kSignoMax);
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewSignalFD(&mask, SFD_NONBLOCK));
+
+  const auto scoped_sigmask =
+      ASSERT_NO_ERRNO_AND_VALUE(ScopedSignalMask(SIG_BLOCK, kSignoMax));
+  ASSERT_THAT(tgkill(getpid(), gettid(), kSignoMax), SyscallSucceeds());
+  ASSERT_THAT(tgkill(getpid(), gettid(), kSignoMax), SyscallSucceeds());
+
+  // A buffer too small for a single signalfd_siginfo is rejected without
+  // dequeueing anything.
+  char small[sizeof(struct signalfd_siginfo) - 1];
+  EXPECT_THAT(read(fd.get(), small, sizeof(small)),
+              SyscallFailsWithErrno(EINVAL));
+
+  // A buffer with room for one and a half signals gets one signal at a time.
+  char buf[sizeof(struct signalfd_siginfo) * 3 / 2];
+  EXPECT_THAT(read(fd.get(), buf, sizeof(buf)),
+              SyscallSucceedsWithValue(sizeof(struct signalfd_siginfo)));
+  EXPECT_THAT(read(fd.get(), buf, sizeof(buf)),
+              SyscallSucceedsWithValue(sizeof(struct signalfd_siginfo)));
+  EXPECT_THAT(read(fd.get(), buf, sizeof(buf)),
+              SyscallFailsWithErrno(EWOULDBLOCK));
+}
+
 std::string PrintSigno(::testing::TestParamInfo<int> info) {
   switch (info.param) {
     case kSigno:
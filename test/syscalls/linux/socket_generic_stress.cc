@@ -12,14 +12,32 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <errno.h>
+#include <netinet/in.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
+#include <sys/resource.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "test/syscalls/linux/ip_socket_test_util.h"
 #include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/cleanup.h"
+#include "test/util/epoll_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/posix_error.h"
+#include "test/util/rlimit_util.h"
 #include "test/util/test_util.h"
 
 namespace gvisor {
@@ -79,5 +97,218 @@ INSTANTIATE_TEST_SUITE_P(
         SetSockOpt(SOL_SOCKET, SO_REUSEADDR, &kSockOptOn)(
             DualStackTCPAcceptBindPersistentListenerSocketPair(0))));
 
+// How connections are closed by ConcurrentConnectStressTest.
+enum class CloseMode {
+  // The connecting side resets the connection with SO_LINGER, so that neither
+  // end enters TIME-WAIT.
+  kReset,
+
+  // The connecting side closes first and enters TIME-WAIT, holding its
+  // ephemeral port.
+  kClientClose,
+
+  // The accepting side closes first and enters TIME-WAIT.
+  kServerClose,
+};
+
+std::string CloseModeName(CloseMode mode) {
+  switch (mode) {
+    case CloseMode::kReset:
+      return "Reset";
+    case CloseMode::kClientClose:
+      return "ClientClose";
+    case CloseMode::kServerClose:
+      return "ServerClose";
+  }
+  return "Unknown";
+}
+
+// Addresses that a ConcurrentConnectStressTest listens on and connects to.
+struct ListenerConnector {
+  TestAddress listener;
+  TestAddress connector;
+};
+
+using ConcurrentConnectStressTest =
+    ::testing::TestWithParam<std::tuple<ListenerConnector, CloseMode>>;
+
+// SetPort sets the port of addr, which is an AF_INET or AF_INET6 address.
+void SetPort(sockaddr_storage* addr, uint16_t port) {
+  if (addr->ss_family == AF_INET) {
+    reinterpret_cast<sockaddr_in*>(addr)->sin_port = port;
+  } else {
+    reinterpret_cast<sockaddr_in6*>(addr)->sin6_port = port;
+  }
+}
+
+// Concurrent65kTimes makes 65k TCP connections, keeping kInFlight of them
+// connecting or closing at once through a single epoll event loop, and
+// reports the connection rate as the connections_per_second property. In
+// CloseMode::kClientClose, connect may fail with EADDRNOTAVAIL once the
+// ephemeral ports are held in TIME-WAIT; such connections are retried, and
+// counted in the port_exhaustions property.
+TEST_P(ConcurrentConnectStressTest, Concurrent65kTimes) {
+  constexpr int kConnections = 1 << 16;
+  constexpr int kInFlight = 2048;
+  constexpr int kMaxEvents = 256;
+
+  const TestAddress& listener = std::get<0>(GetParam()).listener;
+  const TestAddress& connector = std::get<0>(GetParam()).connector;
+  const CloseMode mode = std::get<1>(GetParam());
+
+  // Each connection in flight may hold a socket on both ends.
+  auto rlimit_or = ScopedSetSoftRlimit(RLIMIT_NOFILE, 2 * kInFlight + 64);
+  if (!rlimit_or.ok()) {
+    GTEST_SKIP() << "RLIMIT_NOFILE too low: " << rlimit_or.error();
+  }
+  const Cleanup rlimit = std::move(rlimit_or).ValueOrDie();
+
+  const FileDescriptor listen_fd = ASSERT_NO_ERRNO_AND_VALUE(
+      Socket(listener.family(), SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP));
+  sockaddr_storage listen_addr = listener.addr;
+  ASSERT_THAT(bind(listen_fd.get(), reinterpret_cast<sockaddr*>(&listen_addr),
+                   listener.addr_len),
+              SyscallSucceeds());
+  ASSERT_THAT(listen(listen_fd.get(), kInFlight), SyscallSucceeds());
+  socklen_t addrlen = listener.addr_len;
+  ASSERT_THAT(getsockname(listen_fd.get(),
+                          reinterpret_cast<sockaddr*>(&listen_addr), &addrlen),
+              SyscallSucceeds());
+  sockaddr_storage conn_addr = connector.addr;
+  SetPort(&conn_addr, reinterpret_cast<sockaddr_in*>(&listen_addr)->sin_port);
+
+  const FileDescriptor epoll_fd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  ASSERT_NO_ERRNO(RegisterEpollFD(epoll_fd.get(), listen_fd.get(), EPOLLIN,
+                                  listen_fd.get()));
+
+  // Connecting sockets, and in kServerClose, connected sockets waiting for
+  // end of file, keyed by fd.
+  std::unordered_map<int, FileDescriptor> clients;
+  // Accepted sockets waiting for end of file, except in kServerClose.
+  std::unordered_map<int, FileDescriptor> servers;
+
+  int started = 0;
+  int completed = 0;
+  int exhaustions = 0;
+  epoll_event events[kMaxEvents];
+  const absl::Time start = absl::Now();
+  while (completed < kConnections) {
+    // Top up the connections in flight. A connection is in flight until both
+    // ends are closed.
+    while (started < kConnections &&
+           static_cast<int>(clients.size() + servers.size()) < kInFlight) {
+      FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(
+          Socket(connector.family(), SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP));
+      int ret = connect(fd.get(), reinterpret_cast<sockaddr*>(&conn_addr),
+                        connector.addr_len);
+      if (ret < 0 && errno == EADDRNOTAVAIL &&
+          mode == CloseMode::kClientClose) {
+        // Out of ephemeral ports; retry once connections in flight finish, or
+        // TIME-WAIT sockets expire.
+        exhaustions++;
+        if (clients.empty()) {
+          absl::SleepFor(absl::Milliseconds(10));
+        }
+        break;
+      }
+      ASSERT_TRUE(ret == 0 || errno == EINPROGRESS)
+          << "connect failed: " << strerror(errno);
+      ASSERT_NO_ERRNO(
+          RegisterEpollFD(epoll_fd.get(), fd.get(), EPOLLOUT, fd.get()));
+      const int key = fd.get();
+      clients.emplace(key, std::move(fd));
+      started++;
+    }
+    if (clients.empty() && servers.empty()) {
+      continue;
+    }
+
+    int n;
+    ASSERT_THAT(
+        n = RetryEINTR(epoll_wait)(epoll_fd.get(), events, kMaxEvents, 10000),
+        SyscallSucceeds());
+    ASSERT_GT(n, 0) << "no progress with " << clients.size()
+                    << " connections in flight";
+
+    for (int i = 0; i < n; i++) {
+      const int fd = events[i].data.u64;
+
+      if (fd == listen_fd.get()) {
+        int accepted;
+        while ((accepted = accept4(listen_fd.get(), nullptr, nullptr,
+                                   SOCK_NONBLOCK)) >= 0) {
+          if (mode == CloseMode::kServerClose) {
+            close(accepted);
+            continue;
+          }
+          ASSERT_NO_ERRNO(
+              RegisterEpollFD(epoll_fd.get(), accepted, EPOLLIN, accepted));
+          servers.emplace(accepted, FileDescriptor(accepted));
+        }
+        ASSERT_EQ(errno, EAGAIN) << "accept4 failed: " << strerror(errno);
+        continue;
+      }
+
+      auto server = servers.find(fd);
+      if (server != servers.end()) {
+        // The client has closed or reset the connection.
+        servers.erase(server);
+        continue;
+      }
+
+      auto client = clients.find(fd);
+      ASSERT_NE(client, clients.end());
+      if (events[i].events & EPOLLOUT) {
+        int err;
+        socklen_t optlen = sizeof(err);
+        ASSERT_THAT(getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &optlen),
+                    SyscallSucceeds());
+        ASSERT_EQ(err, 0) << "connect failed: " << strerror(err);
+
+        if (mode == CloseMode::kServerClose) {
+          // Wait for the server to close first.
+          epoll_event event = {};
+          event.events = EPOLLIN;
+          event.data.u64 = fd;
+          ASSERT_THAT(epoll_ctl(epoll_fd.get(), EPOLL_CTL_MOD, fd, &event),
+                      SyscallSucceeds());
+          continue;
+        }
+        if (mode == CloseMode::kReset) {
+          const struct linger linger = {1, 0};
+          ASSERT_THAT(
+              setsockopt(fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger)),
+              SyscallSucceeds());
+        }
+      }
+      clients.erase(client);
+      completed++;
+    }
+  }
+  const absl::Duration elapsed = absl::Now() - start;
+
+  const double rate = kConnections / absl::ToDoubleSeconds(elapsed);
+  std::cout << "connections/sec: " << rate
+            << ", port exhaustions: " << exhaustions << std::endl;
+  RecordProperty("connections_per_second", static_cast<int>(rate));
+  RecordProperty("port_exhaustions", exhaustions);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllTCPSockets, ConcurrentConnectStressTest,
+    ::testing::Combine(
+        ::testing::Values(ListenerConnector{V4Loopback(), V4Loopback()},
+                          ListenerConnector{V6Loopback(), V6Loopback()},
+                          ListenerConnector{V6Any(), V4MappedLoopback()}),
+        ::testing::Values(CloseMode::kReset, CloseMode::kClientClose,
+                          CloseMode::kServerClose)),
+    [](const ::testing::TestParamInfo<
+        ConcurrentConnectStressTest::ParamType>& info) {
+      const ListenerConnector& addrs = std::get<0>(info.param);
+      return absl::StrCat("Listen", addrs.listener.description, "_Connect",
+                          addrs.connector.description, "_",
+                          CloseModeName(std::get<1>(info.param)));
+    });
+
 }  // namespace testing
 }  // namespace gvisor
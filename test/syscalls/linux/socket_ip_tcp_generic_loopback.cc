@@ -25,15 +25,19 @@ namespace gvisor {
 namespace testing {
 namespace {
 
+// Number of connected pairs kept ready for each kind.
+constexpr int kPoolSize = 4;
+
 std::vector<SocketPairKind> GetSocketPairs() {
   return ApplyVecToVec<SocketPairKind>(
       std::vector<Middleware>{
           NoOp, SetSockOpt(IPPROTO_TCP, TCP_NODELAY, &kSockOptOn)},
-      std::vector<SocketPairKind>{
-          IPv6TCPAcceptBindSocketPair(0),
-          IPv4TCPAcceptBindSocketPair(0),
-          DualStackTCPAcceptBindSocketPair(0),
-      });
+      ApplyVec<SocketPairKind>(Pooled(kPoolSize),
+                               std::vector<SocketPairKind>{
+                                   IPv6TCPAcceptBindSocketPair(0),
+                                   IPv4TCPAcceptBindSocketPair(0),
+                                   DualStackTCPAcceptBindSocketPair(0),
+                               }));
 }
 
 INSTANTIATE_TEST_SUITE_P(
@@ -43,6 +43,7 @@ namespace {
 
 constexpr uint32_t kSeq = 12345;
 
+using ::testing::_;
 using ::testing::AnyOf;
 using ::testing::Eq;
 
@@ -449,6 +450,53 @@ TEST(NetlinkRouteTest, GetAddrDump) {
       false));
 }
 
+// GetAddrDumpLarge tests that an RTM_GETADDR dump larger than the reader's
+// buffer is split into datagrams that fit in it.
+TEST(NetlinkRouteTest, GetAddrDumpLarge) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_NET_ADMIN)));
+
+  Link loopback_link = ASSERT_NO_ERRNO_AND_VALUE(LoopbackLink());
+
+  // Each RTM_NEWADDR message is at least 40 bytes, so the dump is several
+  // times larger than the 4096-byte buffer used by NetlinkRequestResponse.
+  constexpr int kAddrs = 256;
+  for (int i = 0; i < kAddrs; i++) {
+    struct in_addr addr;
+    addr.s_addr = htonl(0x0a010000 | i);  // 10.1.0.i.
+    // Linux fails with EEXIST if the address was added by an earlier run.
+    ASSERT_THAT(LinkAddLocalAddr(loopback_link.index, AF_INET,
+                                 /*prefixlen=*/32, &addr, sizeof(addr)),
+                AnyOf(IsPosixErrorOkMatcher(), PosixErrorIs(EEXIST, _)));
+  }
+
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NetlinkBoundSocket(NETLINK_ROUTE));
+
+  struct request {
+    struct nlmsghdr hdr;
+    struct rtgenmsg rgm;
+  };
+
+  struct request req = {};
+  req.hdr.nlmsg_len = sizeof(req);
+  req.hdr.nlmsg_type = RTM_GETADDR;
+  req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  req.hdr.nlmsg_seq = kSeq;
+  req.rgm.rtgen_family = AF_INET;
+
+  // NetlinkRequestResponse fails if a datagram is truncated.
+  int count = 0;
+  ASSERT_NO_ERRNO(NetlinkRequestResponse(
+      fd, &req, sizeof(req),
+      [&](const struct nlmsghdr* hdr) {
+        if (hdr->nlmsg_type == RTM_NEWADDR) {
+          count++;
+        }
+      },
+      false));
+  EXPECT_GE(count, kAddrs);
+}
+
 TEST(NetlinkRouteTest, LookupAll) {
   struct ifaddrs* if_addr_list = nullptr;
   auto cleanup = Cleanup([&if_addr_list]() { freeifaddrs(if_addr_list); });
@@ -0,0 +1,143 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/syscalls/linux/socket_netlink_util.h"
+#include "test/syscalls/linux/socket_test_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/test_util.h"
+
+// Tests for NETLINK_SOCK_DIAG sockets.
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+struct InetDiagRequest {
+  struct nlmsghdr hdr;
+  struct inet_diag_req_v2 req;
+};
+
+constexpr uint32_t kSeq = 12345;
+
+// Returns a bound and listening IPv4 TCP socket, and its address.
+PosixErrorOr<FileDescriptor> ListeningSocket(struct sockaddr_in* addr) {
+  ASSIGN_OR_RETURN_ERRNO(FileDescriptor fd,
+                         Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+  *addr = {};
+  addr->sin_family = AF_INET;
+  addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  RETURN_ERROR_IF_SYSCALL_FAIL(bind(
+      fd.get(), reinterpret_cast<struct sockaddr*>(addr), sizeof(*addr)));
+  socklen_t addrlen = sizeof(*addr);
+  RETURN_ERROR_IF_SYSCALL_FAIL(getsockname(
+      fd.get(), reinterpret_cast<struct sockaddr*>(addr), &addrlen));
+  RETURN_ERROR_IF_SYSCALL_FAIL(listen(fd.get(), 1));
+  return std::move(fd);
+}
+
+// Dumps listening IPv4 TCP sockets, calling fn on each response message.
+PosixError DumpListening(
+    const FileDescriptor& fd,
+    const std::function<void(const struct inet_diag_msg* msg)>& fn) {
+  InetDiagRequest req = {};
+  req.hdr.nlmsg_len = sizeof(req);
+  req.hdr.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+  req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  req.hdr.nlmsg_seq = kSeq;
+  req.req.sdiag_family = AF_INET;
+  req.req.sdiag_protocol = IPPROTO_TCP;
+  req.req.idiag_states = 1 << TCP_LISTEN;
+
+  return NetlinkRequestResponse(
+      fd, &req, sizeof(req),
+      [&](const struct nlmsghdr* hdr) {
+        if (hdr->nlmsg_type != SOCK_DIAG_BY_FAMILY) {
+          return;
+        }
+        fn(reinterpret_cast<const struct inet_diag_msg*>(NLMSG_DATA(hdr)));
+      },
+      false);
+}
+
+TEST(NetlinkSockDiagTest, DumpListeningTCP) {
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NetlinkBoundSocket(NETLINK_SOCK_DIAG));
+
+  struct sockaddr_in addr;
+  const FileDescriptor listener =
+      ASSERT_NO_ERRNO_AND_VALUE(ListeningSocket(&addr));
+  struct stat st;
+  ASSERT_THAT(fstat(listener.get(), &st), SyscallSucceeds());
+
+  int found = 0;
+  ASSERT_NO_ERRNO(DumpListening(fd, [&](const struct inet_diag_msg* msg) {
+    EXPECT_EQ(msg->idiag_family, AF_INET);
+    EXPECT_EQ(msg->idiag_state, TCP_LISTEN);
+    if (msg->id.idiag_sport != addr.sin_port ||
+        msg->id.idiag_src[0] != addr.sin_addr.s_addr) {
+      return;
+    }
+    EXPECT_EQ(msg->idiag_inode, st.st_ino);
+    EXPECT_EQ(msg->idiag_uid, getuid());
+    found++;
+  }));
+  EXPECT_EQ(found, 1);
+}
+
+// Dumps larger than the socket's receive buffer are delivered in full.
+TEST(NetlinkSockDiagTest, DumpManySockets) {
+  constexpr int kSockets = 1000;
+
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NetlinkBoundSocket(NETLINK_SOCK_DIAG));
+
+  std::vector<FileDescriptor> listeners;
+  std::vector<in_port_t> ports;
+  for (int i = 0; i < kSockets; i++) {
+    struct sockaddr_in addr;
+    listeners.push_back(ASSERT_NO_ERRNO_AND_VALUE(ListeningSocket(&addr)));
+    ports.push_back(addr.sin_port);
+  }
+
+  int found = 0;
+  ASSERT_NO_ERRNO(DumpListening(fd, [&](const struct inet_diag_msg* msg) {
+    for (in_port_t port : ports) {
+      if (msg->id.idiag_sport == port) {
+        found++;
+        return;
+      }
+    }
+  }));
+  EXPECT_EQ(found, kSockets);
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
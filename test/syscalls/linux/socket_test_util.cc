@@ -18,11 +18,16 @@
 #include <poll.h>
 #include <sys/socket.h>
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/types/optional.h"
 #include "test/util/file_descriptor.h"
@@ -528,15 +533,93 @@ Creator<SocketPair> UDPUnboundSocketPairCreator(int domain, int type,
   };
 }
 
+namespace {
+
+Creator<SocketPair> ReversedCreator(Creator<SocketPair> creator) {
+  return [creator]() -> PosixErrorOr<std::unique_ptr<ReversedSocketPair>> {
+    ASSIGN_OR_RETURN_ERRNO(auto creator_value, creator());
+    return absl::make_unique<ReversedSocketPair>(std::move(creator_value));
+  };
+}
+
+}  // namespace
+
 SocketPairKind Reversed(SocketPairKind const& base) {
-  auto const& creator = base.creator;
   return SocketPairKind{
       absl::StrCat("reversed ", base.description), base.domain, base.type,
-      base.protocol,
-      [creator]() -> PosixErrorOr<std::unique_ptr<ReversedSocketPair>> {
-        ASSIGN_OR_RETURN_ERRNO(auto creator_value, creator());
-        return absl::make_unique<ReversedSocketPair>(std::move(creator_value));
-      }};
+      base.protocol, ReversedCreator(base.creator),
+      base.unpooled ? ReversedCreator(base.unpooled) : nullptr};
+}
+
+namespace {
+
+// SocketPairPool is the pool of SocketPairs behind a Pooled SocketPairKind.
+class SocketPairPool {
+ public:
+  SocketPairPool(Creator<SocketPair> creator, size_t size)
+      : creator_(std::move(creator)), size_(size) {}
+
+  // Get returns a pair from the pool, or a new pair if the pool is empty.
+  PosixErrorOr<std::unique_ptr<SocketPair>> Get() {
+    std::unique_ptr<SocketPair> pair;
+    {
+      absl::MutexLock l(&mu_);
+      if (!started_) {
+        started_ = true;
+        // The pool is never destroyed (see Pooled), so neither is its
+        // thread.
+        new ScopedThread([this] { Fill(); });
+      }
+      if (!pairs_.empty()) {
+        pair = std::move(pairs_.front());
+        pairs_.pop_front();
+      }
+    }
+    if (pair) {
+      return pair;
+    }
+    return creator_();
+  }
+
+ private:
+  // Fill keeps the pool full until a pair cannot be created, after which all
+  // pairs are created directly by Get.
+  void Fill() {
+    while (true) {
+      mu_.LockWhen(absl::Condition(this, &SocketPairPool::NeedsPair));
+      mu_.Unlock();
+      auto pair_or = creator_();
+      if (!pair_or.ok()) {
+        return;
+      }
+      absl::MutexLock l(&mu_);
+      pairs_.push_back(std::move(pair_or).ValueOrDie());
+    }
+  }
+
+  bool NeedsPair() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return pairs_.size() < size_;
+  }
+
+  const Creator<SocketPair> creator_;
+  const size_t size_;
+
+  absl::Mutex mu_;
+  bool started_ ABSL_GUARDED_BY(mu_) = false;
+  std::deque<std::unique_ptr<SocketPair>> pairs_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+Middleware Pooled(int size) {
+  return [=](SocketPairKind const& base) {
+    // Kinds are usually test parameters, which are copied freely and live
+    // until exit, so the pool is shared by all copies and never deleted.
+    SocketPairPool* pool = new SocketPairPool(base.creator, size);
+    return SocketPairKind{
+        absl::StrCat("pooled ", base.description), base.domain, base.type,
+        base.protocol, [pool] { return pool->Get(); }, base.creator};
+  };
 }
 
 Creator<FileDescriptor> UnboundSocketCreator(int domain, int type,
@@ -579,12 +662,149 @@ void TransferTest(int fd1, int fd2) {
   EXPECT_EQ(0, memcmp(buf1, buf2, sizeof(buf1)));
 }
 
-// Initializes the given buffer with random data.
-void RandomizeBuffer(char* ptr, size_t len) {
-  uint32_t seed = time(nullptr);
-  for (size_t i = 0; i < len; ++i) {
-    ptr[i] = static_cast<char>(rand_r(&seed));
+namespace {
+
+// WriteChunk writes one chunk of the data sent by TransferBulk. It returns
+// the number of bytes written, which is less than chunking.chunk_size only on
+// a datagram socket that truncated the chunk.
+PosixErrorOr<size_t> WriteChunk(int fd, const TransferChunking& chunking,
+                                const std::vector<char>& buf, bool stream) {
+  size_t written = 0;
+  if (chunking.iov_size == 0) {
+    while (written < chunking.chunk_size) {
+      ssize_t n;
+      RETURN_ERROR_IF_SYSCALL_FAIL(
+          n = RetryEINTR(write)(fd, buf.data() + written,
+                                chunking.chunk_size - written));
+      written += n;
+      if (!stream) {
+        break;
+      }
+    }
+    return written;
   }
+
+  // GenerateIovecs points every iovec at the start of buf, so byte i of the
+  // chunk is buf[i % iov_size].
+  for (auto& iovs : GenerateIovecs(chunking.chunk_size,
+                                   const_cast<char*>(buf.data()),
+                                   chunking.iov_size)) {
+    size_t len = 0;
+    for (const auto& iov : iovs) {
+      len += iov.iov_len;
+    }
+    ssize_t n;
+    RETURN_ERROR_IF_SYSCALL_FAIL(n =
+                                     RetryEINTR(writev)(fd, iovs.data(),
+                                                        iovs.size()));
+    written += n;
+    if (!stream) {
+      continue;
+    }
+    // Finish a short writev one piece at a time.
+    for (size_t done = n; done < len;) {
+      const size_t off = written % chunking.iov_size;
+      RETURN_ERROR_IF_SYSCALL_FAIL(
+          n = RetryEINTR(write)(
+              fd, buf.data() + off,
+              std::min(chunking.iov_size - off, len - done)));
+      done += n;
+      written += n;
+    }
+  }
+  return written;
+}
+
+}  // namespace
+
+PosixErrorOr<uint64_t> TransferBulk(int fd1, int fd2, uint64_t bytes,
+                                    TransferChunking chunking) {
+  if (chunking.chunk_size == 0) {
+    return PosixError(EINVAL, "chunk_size must be non-zero");
+  }
+  int type;
+  socklen_t typelen = sizeof(type);
+  RETURN_ERROR_IF_SYSCALL_FAIL(
+      getsockopt(fd2, SOL_SOCKET, SO_TYPE, &type, &typelen));
+  const bool stream = type == SOCK_STREAM;
+
+  // Byte i of each chunk is buf[i % buf.size()].
+  std::vector<char> buf(chunking.iov_size ? chunking.iov_size
+                                          : chunking.chunk_size);
+  RandomizeBuffer(buf.data(), buf.size());
+
+  std::atomic<bool> done(false);
+  PosixError write_error = NoError();
+  ScopedThread writer([&] {
+    for (uint64_t sent = 0; sent < bytes; sent += chunking.chunk_size) {
+      TransferChunking chunk = chunking;
+      chunk.chunk_size = std::min<uint64_t>(chunking.chunk_size, bytes - sent);
+      auto written = WriteChunk(fd1, chunk, buf, stream);
+      if (!written.ok()) {
+        write_error = written.error();
+        break;
+      }
+    }
+    done.store(true);
+  });
+
+  // Datagram sockets may drop data, so stop reading once the writer is done
+  // and nothing more arrives. After a mismatch, keep reading so that the
+  // writer does not block.
+  constexpr int kDrainTimeoutMs = 10;
+  std::vector<char> rbuf(chunking.chunk_size);
+  uint64_t received = 0;
+  PosixError read_error = NoError();
+  while (received < bytes) {
+    if (!stream) {
+      struct pollfd pfd = {fd2, POLLIN, 0};
+      const bool writer_done = done.load();
+      const int ret = RetryEINTR(poll)(&pfd, 1, kDrainTimeoutMs);
+      if (ret < 0) {
+        read_error = PosixError(errno, "poll");
+        break;
+      }
+      if (ret == 0) {
+        if (writer_done) {
+          break;
+        }
+        continue;
+      }
+    }
+    const ssize_t n = RetryEINTR(read)(fd2, rbuf.data(), rbuf.size());
+    if (n < 0) {
+      read_error = PosixError(errno, "read");
+      break;
+    }
+    if (n == 0 && stream) {
+      read_error = PosixError(
+          EPIPE, absl::StrCat("end of file after ", received, " bytes"));
+      break;
+    }
+    // Stream data continues the current chunk, while each datagram starts a
+    // new one.
+    const uint64_t start = stream ? received % chunking.chunk_size : 0;
+    for (ssize_t i = 0; i < n && read_error.ok();) {
+      const uint64_t pos = (start + i) % chunking.chunk_size;
+      const size_t off = pos % buf.size();
+      // The pattern restarts at the end of buf and at the end of the chunk.
+      const size_t len = std::min<uint64_t>(
+          {static_cast<uint64_t>(n - i), buf.size() - off,
+           chunking.chunk_size - pos});
+      if (memcmp(rbuf.data() + i, buf.data() + off, len) != 0) {
+        read_error = PosixError(
+            EIO, absl::StrCat("data mismatch in bytes ", received + i, "-",
+                              received + i + len));
+      }
+      i += len;
+    }
+    received += n;
+  }
+
+  writer.Join();
+  RETURN_IF_ERRNO(write_error);
+  RETURN_IF_ERRNO(read_error);
+  return received;
 }
 
 size_t CalculateUnixSockAddrLen(const char* sun_path) {
@@ -835,23 +1055,39 @@ TestAddress V6Loopback() {
 }
 
 // Checksum computes the internet checksum of a buffer.
-uint16_t Checksum(uint16_t* buf, ssize_t buf_size) {
-  // Add up the 16-bit values in the buffer.
-  uint32_t total = 0;
-  for (unsigned int i = 0; i < buf_size; i += sizeof(*buf)) {
-    total += *buf;
-    buf++;
+uint16_t Checksum(const void* buf, size_t buf_size) {
+  const char* p = static_cast<const char*>(buf);
+
+  // Add up the buffer 32 bits at a time. The one's complement sum of 32-bit
+  // words, folded to 16 bits, is the one's complement sum of the 16-bit words
+  // they contain, and a 64-bit total can't overflow.
+  uint64_t total = 0;
+  for (; buf_size >= sizeof(uint32_t); buf_size -= sizeof(uint32_t)) {
+    uint32_t word;
+    memcpy(&word, p, sizeof(word));
+    total += word;
+    p += sizeof(word);
+  }
+  if (buf_size >= sizeof(uint16_t)) {
+    uint16_t word;
+    memcpy(&word, p, sizeof(word));
+    total += word;
+    p += sizeof(word);
+    buf_size -= sizeof(word);
   }
 
-  // If buf has an odd size, add the remaining byte.
-  if (buf_size % 2) {
-    total += *(reinterpret_cast<unsigned char*>(buf) - 1);
+  // If buf has an odd size, add the remaining byte, padded with zero to a
+  // 16-bit word in network byte order.
+  if (buf_size) {
+    uint16_t word = 0;
+    memcpy(&word, p, 1);
+    total += word;
   }
 
   // This carries any bits past the lower 16 until everything fits in 16 bits.
   while (total >> 16) {
     uint16_t lower = total & 0xffff;
-    uint16_t upper = total >> 16;
+    uint64_t upper = total >> 16;
     total = lower + upper;
   }
 
@@ -859,7 +1095,7 @@ uint16_t Checksum(uint16_t* buf, ssize_t buf_size) {
 }
 
 uint16_t IPChecksum(struct iphdr ip) {
-  return Checksum(reinterpret_cast<uint16_t*>(&ip), sizeof(ip));
+  return Checksum(&ip, sizeof(ip));
 }
 
 // The pseudo-header defined in RFC 768 for calculating the UDP checksum.
@@ -886,7 +1122,7 @@ uint16_t UDPChecksum(struct iphdr iphdr, struct udphdr udphdr,
   memcpy(buf + sizeof(phdr), &udphdr, sizeof(udphdr));
   memcpy(buf + sizeof(phdr) + sizeof(udphdr), payload, payload_len);
 
-  uint16_t csum = Checksum(reinterpret_cast<uint16_t*>(buf), buf_size);
+  uint16_t csum = Checksum(buf, buf_size);
   free(buf);
   return csum;
 }
@@ -898,7 +1134,7 @@ uint16_t ICMPChecksum(struct icmphdr icmphdr, const char* payload,
   memcpy(buf, &icmphdr, sizeof(icmphdr));
   memcpy(buf + sizeof(icmphdr), payload, payload_len);
 
-  uint16_t csum = Checksum(reinterpret_cast<uint16_t*>(buf), buf_size);
+  uint16_t csum = Checksum(buf, buf_size);
   free(buf);
   return csum;
 }
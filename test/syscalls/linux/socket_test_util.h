@@ -305,6 +305,10 @@ struct SocketPairKind {
   int protocol;
   Creator<SocketPair> creator;
 
+  // If creator hands out socket pairs from a pool (see Pooled), unpooled
+  // creates them directly; otherwise it is empty.
+  Creator<SocketPair> unpooled;
+
   // Create creates a socket pair of this kind.
   PosixErrorOr<std::unique_ptr<SocketPair>> Create() const { return creator(); }
 };
@@ -363,12 +367,15 @@ std::vector<SocketPairKind> IncludeReversals(std::vector<SocketPairKind> vec);
 // A Middleware is a function wraps a SocketPairKind.
 using Middleware = std::function<SocketPairKind(SocketPairKind)>;
 
-// Reversed returns a SocketPairKind that represents SocketPairs created by
-// flipping the file descriptors provided by another SocketPair.
+// SetSockOpt returns a Middleware that sets the given socket option on both
+// sockets of each SocketPair created.
+//
+// Pooled pairs are not used: the option is always set on a pair as soon as it
+// has been connected, as if the kind were not pooled.
 template <typename T>
 Middleware SetSockOpt(int level, int optname, T* value) {
   return [=](SocketPairKind const& base) {
-    auto const& creator = base.creator;
+    auto const& creator = base.unpooled ? base.unpooled : base.creator;
     return SocketPairKind{
         absl::StrCat("setsockopt(", level, ", ", optname, ", ", *value, ") ",
                      base.description),
@@ -389,6 +396,17 @@ Middleware SetSockOpt(int level, int optname, T* value) {
   };
 }
 
+// Pooled returns a Middleware that hands out SocketPairs from a pool of up to
+// size pairs, which are created ahead of time on a background thread, so that
+// tests do not wait for connection setup. If the pool is empty, a pair is
+// created directly. Each pair is handed out at most once. Reversals of a
+// pooled kind share its pool.
+//
+// The background thread starts on the first Create and runs alongside the
+// tests, so only pool kinds whose tests do not depend on the number of open
+// sockets or ephemeral ports in use.
+Middleware Pooled(int size);
+
 constexpr int kSockOptOn = 1;
 constexpr int kSockOptOff = 0;
 
@@ -400,8 +418,24 @@ SocketPairKind NoOp(SocketPairKind const& base);
 // ASSERT_NO_FATAL_FAILURE().
 void TransferTest(int fd1, int fd2);
 
-// Fills [buf, buf+len) with random bytes.
-void RandomizeBuffer(char* buf, size_t len);
+// TransferChunking describes how TransferBulk writes its data.
+struct TransferChunking {
+  // Bytes written by each write(2) or writev(2). For datagram sockets, this is
+  // the size of each datagram, and must fit in one.
+  size_t chunk_size;
+
+  // If non-zero, each chunk is written with writev(2), using the iovecs
+  // returned by GenerateIovecs for iov_size-byte pieces of one buffer.
+  // Otherwise, each chunk is written with write(2).
+  size_t iov_size = 0;
+};
+
+// TransferBulk writes bytes bytes to fd1 on another thread, split as given by
+// chunking, reads them from fd2, and checks their contents. It returns the
+// number of bytes read, which is bytes for stream sockets, but may be less
+// for datagram sockets that drop data, such as UDP.
+PosixErrorOr<uint64_t> TransferBulk(int fd1, int fd2, uint64_t bytes,
+                                    TransferChunking chunking);
 
 // Base test fixture for tests that operate on pairs of connected sockets.
 class SocketPairTest : public ::testing::TestWithParam<SocketPairKind> {
@@ -439,9 +473,6 @@ SocketKind SimpleSocket(int fam, int type, int proto);
 ssize_t SendLargeSendMsg(const std::unique_ptr<SocketPair>& sockets,
                          size_t size, bool reader);
 
-// Initializes the given buffer with random data.
-void RandomizeBuffer(char* ptr, size_t len);
-
 enum class AddressFamily { kIpv4 = 1, kIpv6 = 2, kDualStack = 3 };
 enum class SocketType { kUdp = 1, kTcp = 2 };
 
@@ -13,9 +13,13 @@
 // limitations under the License.
 
 #include <stdio.h>
+#include <string.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "test/syscalls/linux/socket_test_util.h"
 #include "test/syscalls/linux/unix_domain_socket_test_util.h"
@@ -165,6 +169,53 @@ TEST_P(UnboundDgramUnixSocketPairTest, SendtoWithoutConnectPassCreds) {
   EXPECT_THAT(getpid(), SyscallSucceedsWithValue(creds.pid));
 }
 
+TEST_P(UnboundDgramUnixSocketPairTest, RecvmmsgFromManySenders) {
+  auto sockets = ASSERT_NO_ERRNO_AND_VALUE(NewSocketPair());
+  ASSERT_THAT(bind(sockets->first_fd(), sockets->first_addr(),
+                   sockets->first_addr_size()),
+              SyscallSucceeds());
+
+  // Sender i sends i+1 bytes of 'a'+i.
+  constexpr int kSenders = 4;
+  std::vector<FileDescriptor> senders;
+  for (int i = 0; i < kSenders; i++) {
+    senders.push_back(
+        ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_UNIX, SOCK_DGRAM, 0)));
+    char data[kSenders];
+    memset(data, 'a' + i, sizeof(data));
+    ASSERT_THAT(sendto(senders.back().get(), data, i + 1, 0,
+                       sockets->first_addr(), sockets->first_addr_size()),
+                SyscallSucceedsWithValue(i + 1));
+  }
+
+  // Receive all of them with one call, with room for one more. The last
+  // datagram doesn't fit in its buffer.
+  constexpr int kBufSize = kSenders - 1;
+  char bufs[kSenders + 1][kBufSize] = {};
+  struct iovec iovs[kSenders + 1];
+  struct mmsghdr hdrs[kSenders + 1] = {};
+  for (int i = 0; i < kSenders + 1; i++) {
+    iovs[i].iov_base = bufs[i];
+    iovs[i].iov_len = kBufSize;
+    hdrs[i].msg_hdr.msg_iov = &iovs[i];
+    hdrs[i].msg_hdr.msg_iovlen = 1;
+  }
+  ASSERT_THAT(RetryEINTR(recvmmsg)(sockets->first_fd(), hdrs, kSenders + 1,
+                                   MSG_DONTWAIT, nullptr),
+              SyscallSucceedsWithValue(kSenders));
+
+  for (int i = 0; i < kSenders; i++) {
+    SCOPED_TRACE(i);
+    const int len = std::min(i + 1, kBufSize);
+    EXPECT_EQ(hdrs[i].msg_len, static_cast<unsigned int>(len));
+    EXPECT_EQ(bufs[i][len - 1], 'a' + i);
+    EXPECT_EQ(hdrs[i].msg_hdr.msg_flags, i + 1 > kBufSize ? MSG_TRUNC : 0);
+  }
+  EXPECT_THAT(RetryEINTR(recvmmsg)(sockets->first_fd(), hdrs, kSenders + 1,
+                                   MSG_DONTWAIT, nullptr),
+              SyscallFailsWithErrno(EAGAIN));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     AllUnixDomainSockets, UnboundDgramUnixSocketPairTest,
     ::testing::ValuesIn(VecCat<SocketPairKind>(
@@ -0,0 +1,146 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for /dev/syscall_trace, gVisor's syscall trace buffer. See
+// pkg/sentry/kernel/syscalltrace for the layout.
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+#include "test/util/capability_util.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/memory_util.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr char kSyscallTracePath[] = "/dev/syscall_trace";
+constexpr uint32_t kMagic = 0x74737667;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t rings;
+  uint32_t entries_per_ring;
+  uint32_t entry_size;
+  uint32_t header_size;
+};
+
+struct Entry {
+  uint64_t seq;
+  int64_t start_ns;
+  int64_t duration_ns;
+  int64_t rval;
+  uint32_t sysno;
+  int32_t tid;
+  int32_t errno_;
+};
+
+int64_t MonotonicNanos() {
+  struct timespec ts;
+  TEST_PCHECK(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+TEST(SyscallTraceTest, RequiresReadOnly) {
+  SKIP_IF(!IsRunningOnGvisor());
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_ADMIN)));
+
+  EXPECT_THAT(open(kSyscallTracePath, O_RDWR), SyscallFailsWithErrno(EACCES));
+
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(kSyscallTracePath, O_RDONLY));
+  EXPECT_THAT(reinterpret_cast<intptr_t>(mmap(nullptr, kPageSize,
+                                              PROT_READ | PROT_WRITE,
+                                              MAP_SHARED, fd.get(), 0)),
+              SyscallFailsWithErrno(EACCES));
+}
+
+TEST(SyscallTraceTest, RequiresCapSysAdmin) {
+  SKIP_IF(!IsRunningOnGvisor());
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_ADMIN)));
+
+  // Capabilities are per-thread, so drop CAP_SYS_ADMIN only in a new thread.
+  ScopedThread([] {
+    EXPECT_NO_ERRNO(SetCapability(CAP_SYS_ADMIN, false));
+    EXPECT_THAT(open(kSyscallTracePath, O_RDONLY),
+                SyscallFailsWithErrno(EPERM));
+  });
+}
+
+TEST(SyscallTraceTest, RecordsSyscalls) {
+  SKIP_IF(!IsRunningOnGvisor());
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_ADMIN)));
+
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(kSyscallTracePath, O_RDONLY));
+  Mapping header_mapping = ASSERT_NO_ERRNO_AND_VALUE(
+      Mmap(nullptr, kPageSize, PROT_READ, MAP_SHARED, fd.get(), 0));
+  const Header header = *static_cast<const Header*>(header_mapping.ptr());
+  ASSERT_EQ(header.magic, kMagic);
+  ASSERT_EQ(header.version, 1);
+  ASSERT_GT(header.rings, 0);
+  ASSERT_GE(header.entry_size, sizeof(Entry));
+
+  const size_t size = header.header_size + static_cast<size_t>(header.rings) *
+                                               header.entries_per_ring *
+                                               header.entry_size;
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      Mmap(nullptr, size, PROT_READ, MAP_SHARED, fd.get(), 0));
+
+  constexpr int kCalls = 10;
+  const pid_t tid = syscall(SYS_gettid);
+  const pid_t ppid = getppid();
+  const int64_t before = MonotonicNanos();
+  for (int i = 0; i < kCalls; i++) {
+    syscall(SYS_getppid);
+  }
+  const int64_t after = MonotonicNanos();
+
+  int found = 0;
+  const char* rings = static_cast<const char*>(m.ptr()) + header.header_size;
+  for (size_t i = 0; i < static_cast<size_t>(header.rings) *
+                             header.entries_per_ring;
+       i++) {
+    const Entry* e =
+        reinterpret_cast<const Entry*>(rings + i * header.entry_size);
+    const uint64_t seq =
+        reinterpret_cast<const std::atomic<uint64_t>*>(&e->seq)->load();
+    if (seq == 0 || e->sysno != SYS_getppid || e->tid != tid ||
+        e->start_ns < before || e->start_ns > after) {
+      continue;
+    }
+    EXPECT_EQ(e->errno_, 0);
+    EXPECT_EQ(e->rval, ppid);
+    EXPECT_GE(e->duration_ns, 0);
+    found++;
+  }
+  EXPECT_EQ(found, kCalls);
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
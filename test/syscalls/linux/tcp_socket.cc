@@ -561,6 +561,65 @@ TEST_P(TcpSocketTest, SetNoDelay) {
   EXPECT_EQ(get, kSockOptOff);
 }
 
+TEST_P(TcpSocketTest, NotsentLowatDefault) {
+  int get = -1;
+  socklen_t get_len = sizeof(get);
+  EXPECT_THAT(getsockopt(s_, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &get, &get_len),
+              SyscallSucceedsWithValue(0));
+  EXPECT_EQ(get_len, sizeof(get));
+  EXPECT_EQ(get, 0);
+}
+
+TEST_P(TcpSocketTest, SetNotsentLowat) {
+  constexpr int kLowat = 16 << 10;
+  ASSERT_THAT(
+      setsockopt(s_, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &kLowat, sizeof(kLowat)),
+      SyscallSucceeds());
+
+  int get = -1;
+  socklen_t get_len = sizeof(get);
+  EXPECT_THAT(getsockopt(s_, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &get, &get_len),
+              SyscallSucceedsWithValue(0));
+  EXPECT_EQ(get_len, sizeof(get));
+  EXPECT_EQ(get, kLowat);
+}
+
+// Test that a socket with unsent data beyond TCP_NOTSENT_LOWAT is not writable
+// even though its send buffer has room.
+TEST_P(TcpSocketTest, PollWithNotsentLowatBlocks) {
+  int opts;
+  ASSERT_THAT(opts = fcntl(s_, F_GETFL), SyscallSucceeds());
+  ASSERT_THAT(fcntl(s_, F_SETFL, opts | O_NONBLOCK), SyscallSucceeds());
+
+  // Keep the receive window small so that data stays unsent, while the send
+  // buffer has plenty of room.
+  int buf_sz = 1 << 12;
+  EXPECT_THAT(setsockopt(t_, SOL_SOCKET, SO_RCVBUF, &buf_sz, sizeof(buf_sz)),
+              SyscallSucceeds());
+  buf_sz = 1 << 20;
+  EXPECT_THAT(setsockopt(s_, SOL_SOCKET, SO_SNDBUF, &buf_sz, sizeof(buf_sz)),
+              SyscallSucceeds());
+  constexpr int kLowat = 1;
+  ASSERT_THAT(
+      setsockopt(s_, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &kLowat, sizeof(kLowat)),
+      SyscallSucceeds());
+
+  // Write until we receive an error, which must happen long before the send
+  // buffer is full.
+  std::vector<char> buf(1 << 10);
+  int64_t written = 0;
+  ssize_t n;
+  while ((n = RetryEINTR(send)(s_, buf.data(), buf.size(), 0)) != -1) {
+    written += n;
+    ASSERT_LT(written, 1 << 20);
+    usleep(1000);  // 1ms.
+  }
+  ASSERT_EQ(errno, EWOULDBLOCK);
+
+  struct pollfd poll_fd = {s_, POLLOUT, 0};
+  EXPECT_THAT(RetryEINTR(poll)(&poll_fd, 1, 10), SyscallSucceedsWithValue(0));
+}
+
 #ifndef TCP_INQ
 #define TCP_INQ 36
 #endif
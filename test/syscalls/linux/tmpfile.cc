@@ -0,0 +1,153 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr char kData[] = "tmpfile";
+constexpr size_t kDataSize = sizeof(kData) - 1;
+
+// OpenTmpfile creates an unnamed file in dir with open(O_TMPFILE | flags).
+PosixErrorOr<FileDescriptor> OpenTmpfile(const std::string& dir, int flags) {
+  int fd = open(dir.c_str(), O_TMPFILE | flags, 0644);
+  if (fd < 0) {
+    return PosixError(errno, absl::StrCat("open ", dir, " O_TMPFILE"));
+  }
+  return FileDescriptor(fd);
+}
+
+// TmpfileSupported returns false if the filesystem containing dir doesn't
+// support O_TMPFILE.
+bool TmpfileSupported(const std::string& dir) {
+  int fd = open(dir.c_str(), O_TMPFILE | O_RDWR, 0644);
+  if (fd < 0) {
+    return errno != EOPNOTSUPP;
+  }
+  TEST_PCHECK(close(fd) == 0);
+  return true;
+}
+
+TEST(TmpfileTest, CreatesUnlinkedFile) {
+  const TempPath dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  SKIP_IF(!TmpfileSupported(dir.path()));
+
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(OpenTmpfile(dir.path(), O_RDWR));
+
+  struct stat st;
+  ASSERT_THAT(fstat(fd.get(), &st), SyscallSucceeds());
+  EXPECT_TRUE(S_ISREG(st.st_mode));
+  EXPECT_EQ(st.st_nlink, 0);
+  EXPECT_EQ(st.st_size, 0);
+
+  ASSERT_THAT(WriteFd(fd.get(), kData, kDataSize),
+              SyscallSucceedsWithValue(kDataSize));
+  char buf[kDataSize];
+  ASSERT_THAT(PreadFd(fd.get(), buf, kDataSize, 0),
+              SyscallSucceedsWithValue(kDataSize));
+  EXPECT_EQ(std::string(buf, kDataSize), kData);
+
+  // The file doesn't appear in the directory.
+  EXPECT_TRUE(ASSERT_NO_ERRNO_AND_VALUE(ListDir(dir.path(), true)).empty());
+}
+
+TEST(TmpfileTest, LinkMaterializesFile) {
+  const TempPath dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  SKIP_IF(!TmpfileSupported(dir.path()));
+
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(OpenTmpfile(dir.path(), O_WRONLY));
+  ASSERT_THAT(WriteFd(fd.get(), kData, kDataSize),
+              SyscallSucceedsWithValue(kDataSize));
+
+  const std::string path = JoinPath(dir.path(), "file");
+  ASSERT_THAT(linkat(AT_FDCWD, absl::StrCat("/proc/self/fd/", fd.get()).c_str(),
+                     AT_FDCWD, path.c_str(), AT_SYMLINK_FOLLOW),
+              SyscallSucceeds());
+
+  struct stat st;
+  ASSERT_THAT(fstat(fd.get(), &st), SyscallSucceeds());
+  EXPECT_EQ(st.st_nlink, 1);
+  EXPECT_EQ(ASSERT_NO_ERRNO_AND_VALUE(GetContents(path)), kData);
+}
+
+TEST(TmpfileTest, ExclPreventsLink) {
+  const TempPath dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  SKIP_IF(!TmpfileSupported(dir.path()));
+
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(OpenTmpfile(dir.path(), O_RDWR | O_EXCL));
+
+  const std::string path = JoinPath(dir.path(), "file");
+  EXPECT_THAT(linkat(AT_FDCWD, absl::StrCat("/proc/self/fd/", fd.get()).c_str(),
+                     AT_FDCWD, path.c_str(), AT_SYMLINK_FOLLOW),
+              SyscallFailsWithErrno(ENOENT));
+}
+
+TEST(TmpfileTest, UmaskApplies) {
+  const TempPath dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  SKIP_IF(!TmpfileSupported(dir.path()));
+
+  const mode_t old_umask = umask(0022);
+  int fd;
+  ASSERT_THAT(fd = open(dir.path().c_str(), O_TMPFILE | O_RDWR, 0666),
+              SyscallSucceeds());
+  umask(old_umask);
+  const FileDescriptor tmp(fd);
+
+  struct stat st;
+  ASSERT_THAT(fstat(tmp.get(), &st), SyscallSucceeds());
+  EXPECT_EQ(st.st_mode & 0777, 0644);
+}
+
+TEST(TmpfileTest, InvalidFlags) {
+  const TempPath dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  SKIP_IF(!TmpfileSupported(dir.path()));
+
+  // O_TMPFILE requires a writable access mode.
+  EXPECT_THAT(open(dir.path().c_str(), O_TMPFILE | O_RDONLY, 0644),
+              SyscallFailsWithErrno(EINVAL));
+  // O_TMPFILE can't be combined with O_CREAT.
+  EXPECT_THAT(open(dir.path().c_str(), O_TMPFILE | O_CREAT | O_RDWR, 0644),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(TmpfileTest, NotADirectory) {
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  SKIP_IF(!TmpfileSupported(GetAbsoluteTestTmpdir()));
+
+  EXPECT_THAT(open(file.path().c_str(), O_TMPFILE | O_RDWR, 0644),
+              SyscallFailsWithErrno(ENOTDIR));
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -44,6 +44,10 @@ constexpr int kIPLen = 4;
 constexpr const char kDevNetTun[] = "/dev/net/tun";
 constexpr const char kTapName[] = "tap0";
 
+// Size of struct virtio_net_hdr. linux/virtio_net.h can't be included from
+// C++, since it uses "class" as a field name.
+constexpr size_t kVirtioNetHdrSize = 10;
+
 constexpr const uint8_t kMacA[ETH_ALEN] = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
 constexpr const uint8_t kMacB[ETH_ALEN] = {0xBB, 0xBB, 0xBB, 0xBB, 0xBB, 0xBB};
 
@@ -257,12 +261,13 @@ TEST_F(TuntapTest, WriteToDownDevice) {
 }
 
 PosixErrorOr<FileDescriptor> OpenAndAttachTap(
-    const std::string& dev_name, const std::string& dev_ipv4_addr) {
+    const std::string& dev_name, const std::string& dev_ipv4_addr,
+    int flags = IFF_TAP) {
   // Interface creation.
   ASSIGN_OR_RETURN_ERRNO(FileDescriptor fd, Open(kDevNetTun, O_RDWR));
 
   struct ifreq ifr_set = {};
-  ifr_set.ifr_flags = IFF_TAP;
+  ifr_set.ifr_flags = flags;
   strncpy(ifr_set.ifr_name, dev_name.c_str(), IFNAMSIZ);
   if (ioctl(fd.get(), TUNSETIFF, &ifr_set) < 0) {
     return PosixError(errno);
@@ -398,5 +403,51 @@ TEST_F(TuntapTest, SendUdpTriggersArpResolution) {
   }
 }
 
+TEST_F(TuntapTest, MultiQueue) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_NET_ADMIN)));
+
+  std::vector<FileDescriptor> fds;
+  for (int i = 0; i < 2; i++) {
+    FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(kDevNetTun, O_RDWR));
+    struct ifreq ifr_set = {};
+    ifr_set.ifr_flags = IFF_TAP | IFF_MULTI_QUEUE;
+    strncpy(ifr_set.ifr_name, kTapName, IFNAMSIZ);
+    ASSERT_THAT(ioctl(fd.get(), TUNSETIFF, &ifr_set),
+                SyscallSucceedsWithValue(0));
+
+    struct ifreq ifr_get = {};
+    ASSERT_THAT(ioctl(fd.get(), TUNGETIFF, &ifr_get),
+                SyscallSucceedsWithValue(0));
+    EXPECT_EQ(ifr_get.ifr_flags & IFF_MULTI_QUEUE, IFF_MULTI_QUEUE);
+    EXPECT_STREQ(ifr_get.ifr_name, kTapName);
+    fds.push_back(std::move(fd));
+  }
+}
+
+TEST_F(TuntapTest, VnetHdrWrite) {
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_NET_ADMIN)));
+
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(
+      OpenAndAttachTap(kTapName, "10.0.0.1", IFF_TAP | IFF_VNET_HDR));
+
+  struct ifreq ifr_get = {};
+  ASSERT_THAT(ioctl(fd.get(), TUNGETIFF, &ifr_get),
+              SyscallSucceedsWithValue(0));
+  EXPECT_EQ(ifr_get.ifr_flags & IFF_VNET_HDR, IFF_VNET_HDR);
+
+  // The virtio_net_hdr follows the packet information header. A zeroed header
+  // describes a packet that is not a GSO packet.
+  std::string arp_rep = CreateArpPacket(kMacB, "10.0.0.2", kMacA, "10.0.0.1");
+  std::string pkt(sizeof(pihdr) + kVirtioNetHdrSize, 0);
+  memcpy(&pkt[0], arp_rep.data(), sizeof(pihdr));
+  pkt.append(arp_rep.substr(sizeof(pihdr)));
+  EXPECT_THAT(write(fd.get(), pkt.data(), pkt.size()),
+              SyscallSucceedsWithValue(pkt.size()));
+
+  // A packet too short to hold the virtio_net_hdr is rejected.
+  EXPECT_THAT(write(fd.get(), pkt.data(), sizeof(pihdr) + 1),
+              SyscallFailsWithErrno(EINVAL));
+}
+
 }  // namespace testing
 }  // namespace gvisor
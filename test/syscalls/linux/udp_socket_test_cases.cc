@@ -660,6 +660,56 @@ TEST_P(UdpSocketTest, SendToAddressOtherThanConnected) {
               SyscallSucceedsWithValue(sizeof(buf)));
 }
 
+TEST_P(UdpSocketTest, SendmmsgRecvmmsgWaitForOne) {
+  ASSERT_THAT(bind(t_, addr_[0], addrlen_), SyscallSucceeds());
+
+  // Send datagrams of different sizes to t_ with one sendmmsg.
+  constexpr int kSent = 3;
+  constexpr int kSizes[kSent] = {1, 100, 512};
+  char buf[512];
+  RandomizeBuffer(buf, sizeof(buf));
+  struct iovec send_iovs[kSent];
+  struct mmsghdr send_msgs[kSent] = {};
+  for (int i = 0; i < kSent; i++) {
+    send_iovs[i] = {buf, static_cast<size_t>(kSizes[i])};
+    send_msgs[i].msg_hdr.msg_name = addr_[0];
+    send_msgs[i].msg_hdr.msg_namelen = addrlen_;
+    send_msgs[i].msg_hdr.msg_iov = &send_iovs[i];
+    send_msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  ASSERT_THAT(RetryEINTR(sendmmsg)(s_, send_msgs, kSent, 0),
+              SyscallSucceedsWithValue(kSent));
+
+  struct sockaddr_storage s_addr;
+  socklen_t s_addrlen = sizeof(s_addr);
+  ASSERT_THAT(getsockname(s_, reinterpret_cast<sockaddr*>(&s_addr), &s_addrlen),
+              SyscallSucceeds());
+
+  // Ask for more datagrams than were sent. MSG_WAITFORONE returns the
+  // datagrams that are queued once the first one has been received.
+  constexpr int kRecv = 8;
+  char received[kRecv][sizeof(buf)];
+  struct sockaddr_storage senders[kRecv];
+  struct iovec recv_iovs[kRecv];
+  struct mmsghdr recv_msgs[kRecv] = {};
+  for (int i = 0; i < kRecv; i++) {
+    recv_iovs[i] = {received[i], sizeof(received[i])};
+    recv_msgs[i].msg_hdr.msg_name = &senders[i];
+    recv_msgs[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+    recv_msgs[i].msg_hdr.msg_iov = &recv_iovs[i];
+    recv_msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  ASSERT_THAT(
+      RetryEINTR(recvmmsg)(t_, recv_msgs, kRecv, MSG_WAITFORONE, nullptr),
+      SyscallSucceedsWithValue(kSent));
+  for (int i = 0; i < kSent; i++) {
+    EXPECT_EQ(recv_msgs[i].msg_len, kSizes[i]);
+    EXPECT_EQ(memcmp(buf, received[i], kSizes[i]), 0);
+    EXPECT_EQ(recv_msgs[i].msg_hdr.msg_namelen, s_addrlen);
+    EXPECT_EQ(memcmp(&senders[i], &s_addr, s_addrlen), 0);
+  }
+}
+
 TEST_P(UdpSocketTest, ZerolengthWriteAllowed) {
   // TODO(gvisor.dev/issue/1202): Hostinet does not support zero length writes.
   SKIP_IF(IsRunningWithHostinet());
@@ -0,0 +1,309 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// NewUserfaultfd returns a new userfaultfd that has completed the UFFDIO_API
+// handshake.
+PosixErrorOr<FileDescriptor> NewUserfaultfd(int flags) {
+  int fd = syscall(__NR_userfaultfd, flags);
+  MaybeSave();
+  if (fd < 0) {
+    return PosixError(errno, "userfaultfd");
+  }
+  FileDescriptor uffd(fd);
+  struct uffdio_api api = {};
+  api.api = UFFD_API;
+  RETURN_ERROR_IF_SYSCALL_FAIL(ioctl(uffd.get(), UFFDIO_API, &api));
+  return std::move(uffd);
+}
+
+// UserfaultfdUnavailable returns true if userfaultfd is disabled for
+// unprivileged users on the host, as it is by default on recent Linux.
+bool UserfaultfdUnavailable() {
+  int fd = syscall(__NR_userfaultfd, 0);
+  if (fd < 0) {
+    return errno == EPERM || errno == ENOSYS;
+  }
+  close(fd);
+  return false;
+}
+
+// Register registers m with uffd for missing page faults.
+PosixError Register(const FileDescriptor& uffd, const Mapping& m) {
+  struct uffdio_register reg = {};
+  reg.range.start = m.addr();
+  reg.range.len = m.len();
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  RETURN_ERROR_IF_SYSCALL_FAIL(ioctl(uffd.get(), UFFDIO_REGISTER, &reg));
+  if ((reg.ioctls & (1 << _UFFDIO_COPY)) == 0) {
+    return PosixError(EINVAL, "UFFDIO_COPY not supported on range");
+  }
+  return NoError();
+}
+
+// ReadFault waits for and reads a page fault message from uffd.
+PosixErrorOr<struct uffd_msg> ReadFault(const FileDescriptor& uffd) {
+  struct pollfd pfd = {uffd.get(), POLLIN, 0};
+  RETURN_ERROR_IF_SYSCALL_FAIL(RetryEINTR(poll)(&pfd, 1, -1));
+  struct uffd_msg msg;
+  int n;
+  RETURN_ERROR_IF_SYSCALL_FAIL(n = read(uffd.get(), &msg, sizeof(msg)));
+  if (n != sizeof(msg)) {
+    return PosixError(EINVAL, "short read");
+  }
+  return msg;
+}
+
+TEST(UserfaultfdTest, InvalidFlags) {
+  SKIP_IF(UserfaultfdUnavailable());
+  EXPECT_THAT(syscall(__NR_userfaultfd, O_RDONLY | O_TRUNC),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, Api) {
+  SKIP_IF(UserfaultfdUnavailable());
+  FileDescriptor uffd(syscall(__NR_userfaultfd, O_CLOEXEC));
+  ASSERT_GE(uffd.get(), 0);
+
+  // Other ioctls fail before the handshake.
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  struct uffdio_register reg = {};
+  reg.range.start = m.addr();
+  reg.range.len = m.len();
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  EXPECT_THAT(ioctl(uffd.get(), UFFDIO_REGISTER, &reg),
+              SyscallFailsWithErrno(EINVAL));
+
+  struct uffdio_api api = {};
+  api.api = UFFD_API + 1;
+  EXPECT_THAT(ioctl(uffd.get(), UFFDIO_API, &api),
+              SyscallFailsWithErrno(EINVAL));
+
+  api.api = UFFD_API;
+  ASSERT_THAT(ioctl(uffd.get(), UFFDIO_API, &api), SyscallSucceeds());
+  EXPECT_NE(api.ioctls & (1ULL << _UFFDIO_REGISTER), 0);
+  EXPECT_NE(api.ioctls & (1ULL << _UFFDIO_UNREGISTER), 0);
+
+  // The handshake can only be done once.
+  EXPECT_THAT(ioctl(uffd.get(), UFFDIO_API, &api),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, ReadWithoutFaults) {
+  SKIP_IF(UserfaultfdUnavailable());
+  const FileDescriptor uffd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+  struct uffd_msg msg;
+  EXPECT_THAT(read(uffd.get(), &msg, sizeof(msg)),
+              SyscallFailsWithErrno(EAGAIN));
+  EXPECT_THAT(read(uffd.get(), &msg, sizeof(msg) - 1),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, RegisterUnaligned) {
+  SKIP_IF(UserfaultfdUnavailable());
+  const FileDescriptor uffd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  struct uffdio_register reg = {};
+  reg.range.start = m.addr() + 1;
+  reg.range.len = kPageSize;
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  EXPECT_THAT(ioctl(uffd.get(), UFFDIO_REGISTER, &reg),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, CopyResolvesReadFault) {
+  SKIP_IF(UserfaultfdUnavailable());
+  const FileDescriptor uffd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(uffd, m));
+
+  char* const page = reinterpret_cast<char*>(m.addr() + kPageSize);
+  char got = 0;
+  ScopedThread t([&] { got = *reinterpret_cast<volatile char*>(page + 7); });
+
+  const struct uffd_msg msg = ASSERT_NO_ERRNO_AND_VALUE(ReadFault(uffd));
+  EXPECT_EQ(msg.event, UFFD_EVENT_PAGEFAULT);
+  EXPECT_EQ(msg.arg.pagefault.address & ~(kPageSize - 1),
+            reinterpret_cast<uintptr_t>(page));
+  EXPECT_EQ(msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WRITE, 0);
+
+  std::vector<char> src(kPageSize, 'a');
+  struct uffdio_copy copy = {};
+  copy.dst = reinterpret_cast<uintptr_t>(page);
+  copy.src = reinterpret_cast<uintptr_t>(src.data());
+  copy.len = kPageSize;
+  ASSERT_THAT(ioctl(uffd.get(), UFFDIO_COPY, &copy), SyscallSucceeds());
+  EXPECT_EQ(copy.copy, static_cast<int64_t>(kPageSize));
+
+  t.Join();
+  EXPECT_EQ(got, 'a');
+
+  // The page is now present, so it can't be provided again.
+  copy.copy = 0;
+  EXPECT_THAT(ioctl(uffd.get(), UFFDIO_COPY, &copy),
+              SyscallFailsWithErrno(EEXIST));
+  EXPECT_EQ(copy.copy, -EEXIST);
+}
+
+TEST(UserfaultfdTest, ZeropageResolvesWriteFault) {
+  SKIP_IF(UserfaultfdUnavailable());
+  const FileDescriptor uffd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(uffd, m));
+
+  char* const page = reinterpret_cast<char*>(m.addr());
+  ScopedThread t([&] { *reinterpret_cast<volatile char*>(page + 1) = 'b'; });
+
+  const struct uffd_msg msg = ASSERT_NO_ERRNO_AND_VALUE(ReadFault(uffd));
+  EXPECT_EQ(msg.event, UFFD_EVENT_PAGEFAULT);
+  EXPECT_NE(msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WRITE, 0);
+
+  struct uffdio_zeropage zero = {};
+  zero.range.start = m.addr();
+  zero.range.len = kPageSize;
+  ASSERT_THAT(ioctl(uffd.get(), UFFDIO_ZEROPAGE, &zero), SyscallSucceeds());
+  EXPECT_EQ(zero.zeropage, static_cast<int64_t>(kPageSize));
+
+  t.Join();
+  EXPECT_EQ(page[0], 0);
+  EXPECT_EQ(page[1], 'b');
+}
+
+// Accesses by syscalls to missing pages are reported as for application
+// accesses.
+TEST(UserfaultfdTest, SyscallFault) {
+  SKIP_IF(UserfaultfdUnavailable());
+  const FileDescriptor uffd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(uffd, m));
+
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+  constexpr char kData[] = "userfaultfd";
+  ASSERT_THAT(write(wfd.get(), kData, sizeof(kData)),
+              SyscallSucceedsWithValue(sizeof(kData)));
+
+  ScopedThread t([&] {
+    EXPECT_THAT(read(rfd.get(), m.ptr(), sizeof(kData)),
+                SyscallSucceedsWithValue(sizeof(kData)));
+  });
+
+  const struct uffd_msg msg = ASSERT_NO_ERRNO_AND_VALUE(ReadFault(uffd));
+  EXPECT_EQ(msg.arg.pagefault.address & ~(kPageSize - 1), m.addr());
+
+  struct uffdio_zeropage zero = {};
+  zero.range.start = m.addr();
+  zero.range.len = kPageSize;
+  ASSERT_THAT(ioctl(uffd.get(), UFFDIO_ZEROPAGE, &zero), SyscallSucceeds());
+
+  t.Join();
+  EXPECT_EQ(memcmp(m.ptr(), kData, sizeof(kData)), 0);
+}
+
+// Pages that are present when the range is registered are not reported.
+TEST(UserfaultfdTest, PresentPagesNotReported) {
+  SKIP_IF(UserfaultfdUnavailable());
+  const FileDescriptor uffd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), 'c', kPageSize);
+  ASSERT_NO_ERRNO(Register(uffd, m));
+
+  EXPECT_EQ(reinterpret_cast<volatile char*>(m.ptr())[0], 'c');
+
+  // But they are after MADV_DONTNEED makes them missing.
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_DONTNEED), SyscallSucceeds());
+  ScopedThread t([&] { reinterpret_cast<volatile char*>(m.ptr())[0] = 'd'; });
+  ASSERT_NO_ERRNO(ReadFault(uffd));
+  struct uffdio_zeropage zero = {};
+  zero.range.start = m.addr();
+  zero.range.len = kPageSize;
+  ASSERT_THAT(ioctl(uffd.get(), UFFDIO_ZEROPAGE, &zero), SyscallSucceeds());
+  t.Join();
+}
+
+TEST(UserfaultfdTest, Unregister) {
+  SKIP_IF(UserfaultfdUnavailable());
+  const FileDescriptor uffd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(uffd, m));
+
+  struct uffdio_range range = {};
+  range.start = m.addr();
+  range.len = m.len();
+  ASSERT_THAT(ioctl(uffd.get(), UFFDIO_UNREGISTER, &range), SyscallSucceeds());
+
+  // Faults are handled normally.
+  reinterpret_cast<volatile char*>(m.ptr())[0] = 'e';
+  struct uffd_msg msg;
+  EXPECT_THAT(read(uffd.get(), &msg, sizeof(msg)),
+              SyscallFailsWithErrno(EAGAIN));
+}
+
+// Closing the userfaultfd unregisters its ranges.
+TEST(UserfaultfdTest, Close) {
+  SKIP_IF(UserfaultfdUnavailable());
+  FileDescriptor uffd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(uffd, m));
+  uffd.reset();
+
+  reinterpret_cast<volatile char*>(m.ptr())[0] = 'f';
+  EXPECT_EQ(reinterpret_cast<char*>(m.ptr())[0], 'f');
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
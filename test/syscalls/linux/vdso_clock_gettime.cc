@@ -27,6 +27,7 @@
 #include "absl/strings/numbers.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "test/util/save_util.h"
 #include "test/util/test_util.h"
 
 namespace gvisor {
@@ -42,6 +43,12 @@ std::string PrintClockId(::testing::TestParamInfo<clockid_t> info) {
       return "CLOCK_REALTIME";
     case CLOCK_BOOTTIME:
       return "CLOCK_BOOTTIME";
+    case CLOCK_MONOTONIC_COARSE:
+      return "CLOCK_MONOTONIC_COARSE";
+    case CLOCK_REALTIME_COARSE:
+      return "CLOCK_REALTIME_COARSE";
+    case CLOCK_TAI:
+      return "CLOCK_TAI";
     default:
       return absl::StrCat(info.param);
   }
@@ -99,7 +106,38 @@ TEST_P(CorrectVDSOClockTest, IsCorrect) {
 
 INSTANTIATE_TEST_SUITE_P(ClockGettime, CorrectVDSOClockTest,
                          ::testing::Values(CLOCK_MONOTONIC, CLOCK_REALTIME,
-                                           CLOCK_BOOTTIME),
+                                           CLOCK_BOOTTIME,
+                                           CLOCK_MONOTONIC_COARSE,
+                                           CLOCK_REALTIME_COARSE, CLOCK_TAI),
+                         PrintClockId);
+
+class MonotonicVDSOClockTest : public ::testing::TestWithParam<clockid_t> {};
+
+// Monotonic clocks must not go backwards across save/restore, whether read
+// through the VDSO or the syscall, including the first VDSO reads after
+// restore.
+TEST_P(MonotonicVDSOClockTest, MonotonicAcrossSave) {
+  struct timespec ts;
+  ASSERT_THAT(clock_gettime(GetParam(), &ts), SyscallSucceeds());
+  absl::Time before = absl::TimeFromTimespec(ts);
+
+  MaybeSave();
+
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_THAT(clock_gettime(GetParam(), &ts), SyscallSucceeds());
+    absl::Time vdso_time = absl::TimeFromTimespec(ts);
+    EXPECT_GE(vdso_time, before);
+
+    ASSERT_THAT(syscall(__NR_clock_gettime, GetParam(), &ts),
+                SyscallSucceeds());
+    absl::Time sys_time = absl::TimeFromTimespec(ts);
+    EXPECT_GE(sys_time, vdso_time);
+    before = sys_time;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(ClockGettime, MonotonicVDSOClockTest,
+                         ::testing::Values(CLOCK_MONOTONIC, CLOCK_BOOTTIME),
                          PrintClockId);
 
 }  // namespace
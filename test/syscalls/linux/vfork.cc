@@ -17,6 +17,7 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <string>
 #include <utility>
 
@@ -27,6 +28,7 @@
 #include "test/util/logging.h"
 #include "test/util/multiprocess_util.h"
 #include "test/util/test_util.h"
+#include "test/util/thread_util.h"
 #include "test/util/time_util.h"
 
 ABSL_FLAG(bool, vfork_test_child, false,
@@ -174,6 +176,36 @@ TEST(VforkTest, ExecedChildExitDoesntUnstopParent_NoRandomSave) {
   EXPECT_THAT(InForkedProcess(test), IsPosixErrorOkAndHolds(0));
 }
 
+// vfork suspends only the calling thread. The parent's other threads keep
+// running, in memory that the child shares rather than copies.
+TEST(VforkTest, OtherThreadsRunWhileParentStopped) {
+  const auto test = [] {
+    std::atomic<bool> done(false);
+    std::atomic<int64_t> count(0);
+    ScopedThread thread([&] {
+      while (!done.load()) {
+        count.fetch_add(1);
+      }
+    });
+
+    pid_t pid = vfork();
+    if (pid == 0) {
+      const int64_t before = count.load();
+      SleepSafe(kChildDelay / 10);
+      _exit(count.load() > before ? kChildExitCode : 1);
+    }
+    TEST_PCHECK_MSG(pid > 0, "vfork failed");
+    done.store(true);
+
+    int status = 0;
+    TEST_PCHECK(RetryEINTR(waitpid)(pid, &status, 0));
+    TEST_CHECK(WIFEXITED(status));
+    TEST_CHECK(WEXITSTATUS(status) == kChildExitCode);
+  };
+
+  EXPECT_THAT(InForkedProcess(test), IsPosixErrorOkAndHolds(0));
+}
+
 int RunChild() {
   SleepSafe(kChildDelay);
   return kChildExitCode;
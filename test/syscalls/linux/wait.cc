@@ -214,6 +214,28 @@ TEST_P(WaitAnyChildTest, CloneSIGCHLD) {
   EXPECT_THAT(WaitAny(0), IsPosixErrorOkAndHolds(child));
 }
 
+// Wait for many children that have all already exited, as a process
+// supervisor reaping a burst of exits would.
+TEST_P(WaitAnyChildTest, ManyForksAfterExit) {
+  constexpr int kChildren = 64;
+  std::vector<pid_t> children;
+  for (int i = 0; i < kChildren; i++) {
+    pid_t child;
+    ASSERT_THAT(child = ForkAndExit(0, 0), SyscallSucceeds());
+    children.push_back(child);
+  }
+
+  absl::SleepFor(absl::Seconds(1));
+
+  std::vector<pid_t> pids;
+  for (int i = 0; i < kChildren; i++) {
+    pids.push_back(ASSERT_NO_ERRNO_AND_VALUE(WaitAny(0)));
+  }
+  EXPECT_THAT(pids, ::testing::UnorderedElementsAreArray(children));
+  EXPECT_THAT(WaitAnyWithOptions(0, WNOHANG),
+              PosixErrorIs(ECHILD, ::testing::_));
+}
+
 // Wait for a child thread and process.
 TEST_P(WaitAnyChildTest, ForkAndClone) {
   pid_t process;
@@ -506,6 +528,44 @@ TEST_P(WaitSpecificChildTest, SiblingChildrenWNOTHREAD) {
   stop = true;
 }
 
+// Waiting for any child with __WNOTHREAD doesn't collect the exited child of
+// a sibling thread.
+TEST(WaitTest, AnyChildWNOTHREAD) {
+  absl::Mutex mu;
+  pid_t child;
+  bool ready = false;
+  bool stop = false;
+
+  ScopedThread t([&] {
+    absl::MutexLock ml(&mu);
+    EXPECT_THAT(child = ForkAndExit(0, 0), SyscallSucceeds());
+    ready = true;
+    mu.Await(absl::Condition(&stop));
+
+    // This thread can wait on child.
+    EXPECT_THAT(Wait4(-1, nullptr, __WNOTHREAD, nullptr),
+                SyscallSucceedsWithValue(child));
+  });
+
+  // N.B. This must be declared after ScopedThread, so it is destructed first,
+  // thus waking the thread.
+  absl::MutexLock ml(&mu);
+  mu.Await(absl::Condition(&ready));
+
+  // Wait for child to exit, without reaping it.
+  siginfo_t info;
+  ASSERT_THAT(Waitid(P_PID, child, &info, WEXITED | WNOWAIT),
+              SyscallSucceeds());
+
+  // This thread can't wait on child.
+  EXPECT_THAT(Wait4(-1, nullptr, __WNOTHREAD | WNOHANG, nullptr),
+              SyscallFailsWithErrno(ECHILD));
+
+  // Keep the sibling alive until after we've waited so the child isn't
+  // reparented.
+  stop = true;
+}
+
 // Wait for specific child to exit.
 // A non-CLONE_THREAD child which sends SIGCHLD upon exit behaves much like
 // a forked process.
@@ -0,0 +1,114 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/util/benchmark_util.h"
+
+#include <stdint.h>
+#include <sys/resource.h>
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "test/util/logging.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+struct rusage Rusage() {
+  struct rusage ru;
+  TEST_PCHECK(getrusage(RUSAGE_SELF, &ru) == 0);
+  return ru;
+}
+
+}  // namespace
+
+ScopedRusageCounters::ScopedRusageCounters(benchmark::State& state)
+    : state_(state), start_(Rusage()) {}
+
+ScopedRusageCounters::~ScopedRusageCounters() {
+  if (state_.iterations() == 0) {
+    // Skipped, or no iterations to average over.
+    return;
+  }
+  const struct rusage end = Rusage();
+  const auto flags = static_cast<benchmark::Counter::Flags>(
+      benchmark::Counter::kAvgIterations | benchmark::Counter::kAvgThreads);
+  state_.counters["minflt"] =
+      benchmark::Counter(end.ru_minflt - start_.ru_minflt, flags);
+  state_.counters["majflt"] =
+      benchmark::Counter(end.ru_majflt - start_.ru_majflt, flags);
+  state_.counters["nvcsw"] =
+      benchmark::Counter(end.ru_nvcsw - start_.ru_nvcsw, flags);
+  state_.counters["nivcsw"] =
+      benchmark::Counter(end.ru_nivcsw - start_.ru_nivcsw, flags);
+}
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kBuckets;
+
+int64_t LatencyHistogram::BucketMax(int bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const int shift = bucket / kSubBuckets - 1;
+  const uint64_t min = static_cast<uint64_t>(kSubBuckets + bucket % kSubBuckets)
+                       << shift;
+  const uint64_t max = min + ((uint64_t{1} << shift) - 1);
+  if (max > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+    return std::numeric_limits<int64_t>::max();
+  }
+  return max;
+}
+
+int64_t LatencyHistogram::Percentile(double q) const {
+  if (total_ == 0) {
+    return 0;
+  }
+  // The rank of the percentile, in [1, total_].
+  uint64_t rank = static_cast<uint64_t>(std::ceil(q * total_));
+  if (rank < 1) {
+    rank = 1;
+  } else if (rank > total_) {
+    rank = total_;
+  }
+  uint64_t seen = 0;
+  for (int i = 0; i < kBuckets; i++) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return BucketMax(i);
+    }
+  }
+  return BucketMax(kBuckets - 1);
+}
+
+void LatencyHistogram::Report(benchmark::State& state,
+                              const std::string& prefix) const {
+  if (total_ == 0) {
+    return;
+  }
+  state.counters[prefix + "p50_ns"] =
+      benchmark::Counter(Percentile(0.5), benchmark::Counter::kAvgThreads);
+  state.counters[prefix + "p99_ns"] =
+      benchmark::Counter(Percentile(0.99), benchmark::Counter::kAvgThreads);
+  state.counters[prefix + "p999_ns"] =
+      benchmark::Counter(Percentile(0.999), benchmark::Counter::kAvgThreads);
+}
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,132 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GVISOR_TEST_UTIL_BENCHMARK_UTIL_H_
+#define GVISOR_TEST_UTIL_BENCHMARK_UTIL_H_
+
+#include <stdint.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace gvisor {
+namespace testing {
+
+// ScopedRusageCounters samples getrusage(RUSAGE_SELF) when constructed and
+// destroyed, and reports the difference as per-iteration counters of state:
+//
+//   minflt, majflt: minor and major page faults.
+//   nvcsw, nivcsw: voluntary and involuntary context switches.
+//
+// The usage is for the whole process, including helper threads, so it should
+// be constructed immediately before the benchmark loop. Under ThreadRange, each
+// thread samples the same process, so the counters are averaged across
+// threads.
+//
+// Note that gVisor does not currently report page faults in getrusage(2).
+class ScopedRusageCounters {
+ public:
+  explicit ScopedRusageCounters(benchmark::State& state);
+  ~ScopedRusageCounters();
+
+  ScopedRusageCounters(const ScopedRusageCounters&) = delete;
+  ScopedRusageCounters& operator=(const ScopedRusageCounters&) = delete;
+
+ private:
+  benchmark::State& state_;
+  struct rusage start_;
+};
+
+// LatencyHistogram records latencies in log-linear buckets, like an HDR
+// histogram: values below 2^kSubBucketBits ns are exact, and larger values are
+// recorded with kSubBucketBits significant bits, for a relative error of at
+// most 1/2^kSubBucketBits. Recording does not allocate, so it is suitable for
+// use inside the benchmark loop:
+//
+//   LatencyHistogram latency;
+//   for (auto _ : state) {
+//     const int64_t start = LatencyHistogram::Now();
+//     ...
+//     latency.Record(LatencyHistogram::Now() - start);
+//   }
+//   latency.Report(state);
+//
+// Now() is clock_gettime(CLOCK_MONOTONIC), which is serviced by the VDSO on
+// both Linux and gVisor, so each sample adds two VDSO clock reads to the
+// measured iteration.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // One group of kSubBuckets for values below 2^kSubBucketBits, and one for
+  // each possible most significant bit above that.
+  static constexpr int kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram() : counts_(kBuckets) {}
+
+  // Now returns the current CLOCK_MONOTONIC time in nanoseconds.
+  static int64_t Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+
+  // Record adds a latency of ns nanoseconds. Negative values are recorded as
+  // zero.
+  void Record(int64_t ns) {
+    counts_[Bucket(ns < 0 ? 0 : static_cast<uint64_t>(ns))]++;
+    total_++;
+  }
+
+  // Count returns the number of recorded latencies.
+  uint64_t Count() const { return total_; }
+
+  // Percentile returns an upper bound, within the bucket precision, of the
+  // latency below which the fraction q of the recorded latencies fall. It
+  // returns 0 if nothing has been recorded.
+  int64_t Percentile(double q) const;
+
+  // Report sets the p50_ns, p99_ns and p999_ns counters of state, with each
+  // name preceded by prefix. Under ThreadRange, the percentiles are averaged
+  // across threads. Nothing is reported if nothing has been recorded.
+  void Report(benchmark::State& state, const std::string& prefix = "") const;
+
+ private:
+  static int Bucket(uint64_t v) {
+    if (v < kSubBuckets) {
+      return v;
+    }
+    // msb >= kSubBucketBits. Keep the kSubBucketBits bits below the most
+    // significant bit.
+    const int msb = 63 - __builtin_clzll(v);
+    const int shift = msb - kSubBucketBits;
+    return (shift + 1) * kSubBuckets +
+           static_cast<int>((v >> shift) - kSubBuckets);
+  }
+
+  // BucketMax returns the largest value recorded in bucket.
+  static int64_t BucketMax(int bucket);
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_ = 0;
+};
+
+}  // namespace testing
+}  // namespace gvisor
+
+#endif  // GVISOR_TEST_UTIL_BENCHMARK_UTIL_H_
@@ -0,0 +1,81 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/util/benchmark_util.h"
+
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram h;
+  EXPECT_EQ(h.Count(), 0);
+  EXPECT_EQ(h.Percentile(0.5), 0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram h;
+  for (int i = 1; i <= LatencyHistogram::kSubBuckets; i++) {
+    h.Record(i - 1);
+  }
+  EXPECT_EQ(h.Count(), LatencyHistogram::kSubBuckets);
+  EXPECT_EQ(h.Percentile(0), 0);
+  EXPECT_EQ(h.Percentile(0.5), LatencyHistogram::kSubBuckets / 2 - 1);
+  EXPECT_EQ(h.Percentile(1), LatencyHistogram::kSubBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, Negative) {
+  LatencyHistogram h;
+  h.Record(-5);
+  EXPECT_EQ(h.Percentile(1), 0);
+}
+
+TEST(LatencyHistogramTest, RelativeError) {
+  for (int64_t v = 1; v < (int64_t{1} << 40); v = v * 3 + 1) {
+    LatencyHistogram h;
+    h.Record(v);
+    const int64_t p = h.Percentile(0.5);
+    EXPECT_GE(p, v);
+    EXPECT_LE(p - v, v / LatencyHistogram::kSubBuckets) << v;
+  }
+}
+
+TEST(LatencyHistogramTest, Max) {
+  LatencyHistogram h;
+  h.Record(std::numeric_limits<int64_t>::max());
+  EXPECT_EQ(h.Percentile(1), std::numeric_limits<int64_t>::max());
+}
+
+TEST(LatencyHistogramTest, Tail) {
+  LatencyHistogram h;
+  for (int i = 0; i < 990; i++) {
+    h.Record(10);
+  }
+  for (int i = 0; i < 10; i++) {
+    h.Record(1000000);
+  }
+  EXPECT_EQ(h.Percentile(0.5), 10);
+  EXPECT_EQ(h.Percentile(0.99), 10);
+  EXPECT_GE(h.Percentile(0.999), 1000000);
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
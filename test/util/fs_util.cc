@@ -15,18 +15,27 @@
 #include "test/util/fs_util.h"
 
 #include <dirent.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+
 #include "gmock/gmock.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "test/util/cleanup.h"
 #include "test/util/file_descriptor.h"
 #include "test/util/posix_error.h"
+#include "test/util/thread_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -47,6 +56,46 @@ PosixError WriteContentsToFD(int fd, absl::string_view contents) {
   }
   return NoError();
 }
+
+// Bounds on the size of each read(2) by GetContentsFD.
+constexpr size_t kMinContentsReadSize = 16 * 1024;
+constexpr size_t kMaxContentsReadSize = 1 << 20;
+
+// ContentsSizeHint returns the number of bytes between the current offset of
+// fd and the end of the file, and sets *offset to the current offset, if fd is
+// a non-empty regular file. Otherwise, e.g. for pipes and /proc files, it
+// returns 0.
+size_t ContentsSizeHint(int fd, off_t* offset) {
+  struct stat st;
+  if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+    return 0;
+  }
+  *offset = lseek(fd, 0, SEEK_CUR);
+  if (*offset < 0 || *offset >= st.st_size) {
+    return 0;
+  }
+  return st.st_size - *offset;
+}
+
+// MmapContentsFD appends len bytes of fd from offset to output by mapping
+// them, and advances the file offset past them. It returns false, without
+// advancing the offset, if the file cannot be mapped.
+PosixErrorOr<bool> MmapContentsFD(int fd, off_t offset, size_t len,
+                                  std::string* output) {
+  const off_t page_size = sysconf(_SC_PAGESIZE);
+  const off_t start = offset & ~(page_size - 1);
+  const size_t map_len = len + (offset - start);
+  void* addr = mmap(nullptr, map_len, PROT_READ, MAP_PRIVATE, fd, start);
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+  output->append(static_cast<const char*>(addr) + (offset - start), len);
+  munmap(addr, map_len);
+  if (lseek(fd, offset + len, SEEK_SET) < 0) {
+    return PosixError(errno, "GetContentsFD lseek failure.");
+  }
+  return true;
+}
 }  // namespace
 
 namespace internal {
@@ -250,27 +299,89 @@ PosixErrorOr<std::string> GetContentsFD(int fd) {
   return ret;
 }
 
-PosixError GetContentsFD(int fd, std::string* output) {
-  // Keep reading until we hit an EOF or an error.
+PosixError GetContentsFD(int fd, std::string* output, bool use_mmap) {
+  off_t offset;
+  size_t remaining = ContentsSizeHint(fd, &offset);
+  if (remaining > 0) {
+    // Leave room for the final read, which finds EOF.
+    output->reserve(output->size() + remaining + kMinContentsReadSize);
+    if (use_mmap) {
+      ASSIGN_OR_RETURN_ERRNO(bool mapped,
+                             MmapContentsFD(fd, offset, remaining, output));
+      if (mapped) {
+        remaining = 0;
+      }
+    }
+  }
+
+  // Keep reading until we hit an EOF or an error. Read directly into output,
+  // in reads sized by the remaining length if it is known, or otherwise
+  // doubling.
+  size_t read_size = kMinContentsReadSize;
   while (true) {
-    char buf[16 * 1024] = {};  // Read in 16KB chunks.
-    int bytes_read = read(fd, buf, sizeof(buf));
+    if (remaining > 0) {
+      read_size = std::max(std::min(remaining, kMaxContentsReadSize),
+                           kMinContentsReadSize);
+    }
+    const size_t pos = output->size();
+    output->resize(pos + read_size);
+    ssize_t bytes_read = read(fd, &(*output)[pos], read_size);
     if (bytes_read < 0) {
+      output->resize(pos);
       if (errno == EINTR) {
         continue;
       }
       return PosixError(errno, "GetContentsFD read failure.");
     }
+    output->resize(pos + bytes_read);
 
     if (bytes_read == 0) {
       break;  // EOF.
     }
 
-    output->append(buf, bytes_read);
+    if (remaining > 0) {
+      remaining -= std::min(remaining, static_cast<size_t>(bytes_read));
+    } else {
+      read_size = std::min(read_size * 2, kMaxContentsReadSize);
+    }
   }
   return NoError();
 }
 
+PosixErrorOr<size_t> GetContentsInto(absl::string_view path,
+                                     absl::Span<char> buf) {
+  ASSIGN_OR_RETURN_ERRNO(auto fd, Open(std::string(path), O_RDONLY));
+  return GetContentsIntoFD(fd.get(), buf);
+}
+
+PosixErrorOr<size_t> GetContentsIntoFD(int fd, absl::Span<char> buf) {
+  size_t total = 0;
+  while (true) {
+    // Once buf is full, read one more byte to check for EOF.
+    char overflow;
+    char* dst = total < buf.size() ? buf.data() + total : &overflow;
+    size_t len = total < buf.size() ? buf.size() - total : 1;
+    ssize_t bytes_read = read(fd, dst, len);
+    if (bytes_read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return PosixError(errno, "GetContentsIntoFD read failure.");
+    }
+
+    if (bytes_read == 0) {
+      return total;  // EOF.
+    }
+
+    if (dst == &overflow) {
+      return PosixError(EOVERFLOW, absl::StrCat("GetContentsIntoFD fd: ", fd,
+                                                " contents exceed ",
+                                                buf.size(), " bytes."));
+    }
+    total += bytes_read;
+  }
+}
+
 PosixErrorOr<std::string> ReadLink(absl::string_view path) {
   char buf[PATH_MAX + 1] = {};
   int ret = readlink(std::string(path).c_str(), buf, PATH_MAX);
@@ -327,6 +438,180 @@ PosixError WalkTree(
   return NoError();
 }
 
+namespace {
+
+// ParallelWalker implements ParallelWalkTree.
+//
+// Each directory in the tree is a node, which is queued to be scanned once it
+// is found. A node is passed to the callback once it has been scanned and all
+// of its subdirectories have been passed to the callback, as tracked by
+// pending.
+class ParallelWalker {
+ public:
+  ParallelWalker(int max_threads,
+                 const std::function<void(absl::string_view, mode_t)>& cb)
+      : max_threads_(max_threads), cb_(cb) {}
+
+  // Walk walks the tree rooted at the directory open as dir with path.
+  PosixError Walk(std::string path, DIR* dir) {
+    auto* root = new Node{std::move(path), nullptr};
+    {
+      absl::MutexLock l(&mu_);
+      outstanding_++;
+    }
+    Scan(root, dir);
+    Work();
+    // Join helpers before returning, so that they no longer refer to this.
+    threads_.clear();
+    absl::MutexLock l(&mu_);
+    return error_;
+  }
+
+ private:
+  struct Node {
+    std::string path;
+    Node* parent;
+
+    // One for the scan of this directory, plus one for each subdirectory that
+    // has not yet been passed to the callback.
+    std::atomic<int> pending{1};
+  };
+
+  // Work scans queued nodes until every node has been scanned.
+  void Work() {
+    while (true) {
+      Node* node;
+      {
+        absl::MutexLock l(&mu_);
+        mu_.Await(absl::Condition(
+            +[](ParallelWalker* w) ABSL_EXCLUSIVE_LOCKS_REQUIRED(w->mu_) {
+              return !w->queue_.empty() || w->outstanding_ == 0;
+            },
+            this));
+        if (queue_.empty()) {
+          return;
+        }
+        node = queue_.front();
+        queue_.pop_front();
+      }
+
+      DIR* dir = opendir(node->path.c_str());
+      if (dir == nullptr) {
+        SetError(PosixError(errno, absl::StrCat("opendir ", node->path)));
+      }
+      Scan(node, dir);
+    }
+  }
+
+  // Scan passes the non-directory entries of node, open as dir if non-null,
+  // to the callback, and queues its subdirectories.
+  void Scan(Node* node, DIR* dir) {
+    if (dir != nullptr) {
+      ScanDir(node, dir);
+      closedir(dir);
+    }
+    Finish(node);
+
+    absl::MutexLock l(&mu_);
+    outstanding_--;
+  }
+
+  void ScanDir(Node* node, DIR* dir) {
+    while (true) {
+      // See WalkTree.
+      errno = 0;
+      struct dirent* dp = readdir(dir);
+      if (dp == nullptr) {
+        if (errno != 0) {
+          SetError(PosixError(errno, absl::StrCat("readdir ", node->path)));
+        }
+        return;
+      }
+
+      if (strcmp(dp->d_name, ".") == 0 || strcmp(dp->d_name, "..") == 0) {
+        continue;
+      }
+
+      auto full_path = JoinPath(node->path, dp->d_name);
+      mode_t type = DTTOIF(dp->d_type);
+      if (dp->d_type == DT_UNKNOWN) {
+        struct stat s;
+        if (fstatat(dirfd(dir), dp->d_name, &s, AT_SYMLINK_NOFOLLOW) < 0) {
+          SetError(PosixError(errno, absl::StrCat("fstatat ", full_path)));
+          continue;
+        }
+        type = s.st_mode & S_IFMT;
+      }
+
+      if (S_ISDIR(type)) {
+        node->pending++;
+        Push(new Node{std::move(full_path), node});
+      } else {
+        cb_(full_path, type);
+      }
+    }
+  }
+
+  // Push queues node to be scanned, starting another thread if there are
+  // fewer than max_threads_.
+  void Push(Node* node) {
+    absl::MutexLock l(&mu_);
+    outstanding_++;
+    queue_.push_back(node);
+    if (static_cast<int>(threads_.size()) + 1 < max_threads_) {
+      threads_.push_back(absl::make_unique<ScopedThread>([this] { Work(); }));
+    }
+  }
+
+  // Finish drops a pending reference on node, passing it to the callback and
+  // dropping a reference on its parent once none remain.
+  void Finish(Node* node) {
+    while (node != nullptr && --node->pending == 0) {
+      cb_(node->path, S_IFDIR);
+      Node* parent = node->parent;
+      delete node;
+      node = parent;
+    }
+  }
+
+  void SetError(PosixError error) {
+    absl::MutexLock l(&mu_);
+    if (error_.ok()) {
+      error_ = std::move(error);
+    }
+  }
+
+  const int max_threads_;
+  const std::function<void(absl::string_view, mode_t)>& cb_;
+
+  absl::Mutex mu_;
+
+  // Nodes found but not yet scanned.
+  std::deque<Node*> queue_ ABSL_GUARDED_BY(mu_);
+
+  // Nodes queued or being scanned.
+  int outstanding_ ABSL_GUARDED_BY(mu_) = 0;
+
+  // Helper threads. Modified by Push with mu_ held, and by Walk once no more
+  // nodes can be pushed, without mu_ since the helpers need it to exit.
+  std::vector<std::unique_ptr<ScopedThread>> threads_;
+
+  PosixError error_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+PosixError ParallelWalkTree(
+    absl::string_view path, int max_threads,
+    const std::function<void(absl::string_view, mode_t)>& cb) {
+  DIR* dir = opendir(std::string(path).c_str());
+  if (dir == nullptr) {
+    return PosixError(errno, absl::StrCat("opendir ", path));
+  }
+  ParallelWalker walker(std::max(max_threads, 1), cb);
+  return walker.Walk(std::string(path), dir);
+}
+
 PosixErrorOr<std::vector<std::string>> ListDir(absl::string_view abspath,
                                                bool skipdots) {
   std::vector<std::string> files;
@@ -362,6 +647,9 @@ PosixErrorOr<std::vector<std::string>> ListDir(absl::string_view abspath,
   return files;
 }
 
+// Maximum number of threads used by RecursivelyDelete.
+constexpr int kMaxDeleteThreads = 16;
+
 PosixError RecursivelyDelete(absl::string_view path, int* undeleted_dirs,
                              int* undeleted_files) {
   ASSIGN_OR_RETURN_ERRNO(bool exists, Exists(path));
@@ -379,20 +667,28 @@ PosixError RecursivelyDelete(absl::string_view path, int* undeleted_dirs,
     return status;
   }
 
-  return WalkTree(path, /*recursive=*/true,
-                  [&](absl::string_view absolute_path, const struct stat& s) {
-                    if (S_ISDIR(s.st_mode)) {
-                      auto rm_status = Rmdir(absolute_path);
-                      if (!rm_status.ok() && undeleted_dirs) {
-                        (*undeleted_dirs)++;
-                      }
-                    } else {
-                      auto delete_status = Delete(absolute_path);
-                      if (!delete_status.ok() && undeleted_files) {
-                        (*undeleted_files)++;
-                      }
-                    }
-                  });
+  std::atomic<int> dirs(0);
+  std::atomic<int> files(0);
+  auto status = ParallelWalkTree(
+      path, std::min<int>(sysconf(_SC_NPROCESSORS_ONLN), kMaxDeleteThreads),
+      [&](absl::string_view absolute_path, mode_t type) {
+        if (S_ISDIR(type)) {
+          if (!Rmdir(absolute_path).ok()) {
+            dirs++;
+          }
+        } else {
+          if (!Delete(absolute_path).ok()) {
+            files++;
+          }
+        }
+      });
+  if (undeleted_dirs) {
+    *undeleted_dirs += dirs;
+  }
+  if (undeleted_files) {
+    *undeleted_files += files;
+  }
+  return status;
 }
 
 PosixError RecursivelyCreateDir(absl::string_view path) {
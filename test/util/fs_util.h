@@ -21,6 +21,7 @@
 #include <unistd.h>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "test/util/file_descriptor.h"
 #include "test/util/posix_error.h"
 
@@ -91,13 +92,27 @@ PosixError GetContents(absl::string_view path, std::string* output);
 // Attempts to read the entire contents of the file or returns an error.
 PosixErrorOr<std::string> GetContents(absl::string_view path);
 
-// Attempts to read the entire contents of the provided fd into the provided
-// string or returns an error.
-PosixError GetContentsFD(int fd, std::string* output);
+// Attempts to read the entire contents of the provided fd, from its current
+// offset, into the provided string or returns an error.
+//
+// For regular files, the string is sized once from fstat(2). If use_mmap is
+// true, regular files are mapped and copied from the mapping rather than read,
+// falling back to read(2) if they cannot be mapped. The file must not be
+// truncated concurrently when use_mmap is true.
+PosixError GetContentsFD(int fd, std::string* output, bool use_mmap = false);
 
 // Attempts to read the entire contents of the provided fd or returns an error.
 PosixErrorOr<std::string> GetContentsFD(int fd);
 
+// Attempts to read the entire contents of the file into buf without allocating,
+// and returns the number of bytes read, or an error. Returns EOVERFLOW if the
+// contents do not fit in buf.
+PosixErrorOr<size_t> GetContentsInto(absl::string_view path,
+                                     absl::Span<char> buf);
+
+// Like GetContentsInto, but reads the provided fd from its current offset.
+PosixErrorOr<size_t> GetContentsIntoFD(int fd, absl::Span<char> buf);
+
 // Executes the readlink(2) system call or returns an error.
 PosixErrorOr<std::string> ReadLink(absl::string_view path);
 
@@ -112,6 +127,23 @@ PosixError WalkTree(
     absl::string_view path, bool recursive,
     const std::function<void(absl::string_view, const struct stat&)>& cb);
 
+// ParallelWalkTree is like WalkTree with recursive set, but walks
+// subdirectories concurrently from up to max_threads threads, including the
+// caller, so cb must be thread-safe. As in WalkTree, each directory is passed
+// to cb after everything beneath it.
+//
+// To avoid a stat per entry, cb is passed only the file type (the S_IFMT bits
+// of st_mode), which is taken from the directory entry where the filesystem
+// provides it, and otherwise from fstatat(2) on the directory fd. Symbolic
+// links are not followed.
+//
+// This method will return an error when it's unable to access the provided
+// path, or when the path is not a directory. Otherwise, it returns the first
+// error encountered in the tree, after walking the rest of it.
+PosixError ParallelWalkTree(
+    absl::string_view path, int max_threads,
+    const std::function<void(absl::string_view, mode_t)>& cb);
+
 // Returns the base filenames for all files under a given absolute path. If
 // skipdots is true the returned vector will not contain "." or "..". This
 // method does not walk the tree recursively it only returns the elements
@@ -122,6 +154,9 @@ PosixErrorOr<std::vector<std::string>> ListDir(absl::string_view abspath,
 // Attempt to recursively delete a directory or file. Returns an error and
 // the number of undeleted directories and files. If either
 // undeleted_dirs or undeleted_files is nullptr then it will not be used.
+//
+// Directories are deleted with ParallelWalkTree, using up to one thread per
+// CPU. Symbolic links are deleted rather than followed.
 PosixError RecursivelyDelete(absl::string_view path, int* undeleted_dirs,
                              int* undeleted_files);
 
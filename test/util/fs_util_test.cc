@@ -15,11 +15,19 @@
 #include "test/util/fs_util.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
 #include "test/util/posix_error.h"
 #include "test/util/temp_path.h"
 #include "test/util/test_util.h"
@@ -99,6 +107,173 @@ TEST(FsUtilTest, RecursivelyCreateAndDeletePartial) {
   ASSERT_THAT(Exists(JoinPath(Dirname(sub_path), "file")),
               IsPosixErrorOkAndHolds(true));
 }
+
+// CreateTree creates a tree under root with depth levels of fanout
+// subdirectories, each also with fanout files, and returns the paths of every
+// file and directory in it, excluding root.
+std::vector<std::string> CreateTree(const std::string& root, int depth,
+                                    int fanout) {
+  std::vector<std::string> paths;
+  for (int i = 0; i < fanout; i++) {
+    const std::string file = JoinPath(root, absl::StrCat("file", i));
+    TEST_CHECK(CreateWithContents(file, "").ok());
+    paths.push_back(file);
+    if (depth > 0) {
+      const std::string dir = JoinPath(root, absl::StrCat("dir", i));
+      TEST_CHECK(Mkdir(dir).ok());
+      paths.push_back(dir);
+      for (auto& path : CreateTree(dir, depth - 1, fanout)) {
+        paths.push_back(std::move(path));
+      }
+    }
+  }
+  return paths;
+}
+
+TEST(FsUtilTest, ParallelWalkTree) {
+  const TempPath root = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  std::vector<std::string> want = CreateTree(root.path(), 3, 4);
+  want.push_back(root.path());
+
+  absl::Mutex mu;
+  std::vector<std::string> got;
+  ASSERT_NO_ERRNO(ParallelWalkTree(
+      root.path(), 4, [&](absl::string_view path, mode_t type) {
+        absl::MutexLock l(&mu);
+        EXPECT_EQ(S_ISDIR(type), absl::StrContains(Basename(path), "dir") ||
+                                     path == root.path())
+            << path;
+        // Everything beneath a directory comes before it.
+        for (const auto& prev : got) {
+          EXPECT_FALSE(absl::StartsWith(path, absl::StrCat(prev, "/")))
+              << path << " after " << prev;
+        }
+        got.push_back(std::string(path));
+      }));
+  EXPECT_THAT(got, ::testing::UnorderedElementsAreArray(want));
+}
+
+TEST(FsUtilTest, ParallelWalkTreeNotDirectory) {
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  EXPECT_THAT(ParallelWalkTree(file.path(), 4,
+                               [](absl::string_view, mode_t) {
+                                 ADD_FAILURE() << "unexpected callback";
+                               }),
+              PosixErrorIs(ENOTDIR, ::testing::_));
+}
+
+TEST(FsUtilTest, RecursivelyDeleteTree) {
+  const TempPath root = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  const std::string base = JoinPath(root.path(), "base");
+  ASSERT_NO_ERRNO(Mkdir(base));
+  CreateTree(base, 3, 6);
+
+  int undeleted_dirs = 0;
+  int undeleted_files = 0;
+  ASSERT_NO_ERRNO(RecursivelyDelete(base, &undeleted_dirs, &undeleted_files));
+  EXPECT_EQ(undeleted_dirs, 0);
+  EXPECT_EQ(undeleted_files, 0);
+  ASSERT_THAT(Exists(base), IsPosixErrorOkAndHolds(false));
+}
+
+TEST(FsUtilTest, RecursivelyDeleteDoesNotFollowSymlinks) {
+  const TempPath root = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  const std::string target = JoinPath(root.path(), "target");
+  const std::string base = JoinPath(root.path(), "base");
+  ASSERT_NO_ERRNO(Mkdir(target));
+  ASSERT_NO_ERRNO(CreateWithContents(JoinPath(target, "file"), ""));
+  ASSERT_NO_ERRNO(Mkdir(base));
+  ASSERT_THAT(symlink(target.c_str(), JoinPath(base, "link").c_str()),
+              SyscallSucceeds());
+
+  ASSERT_NO_ERRNO(RecursivelyDelete(base, nullptr, nullptr));
+  ASSERT_THAT(Exists(base), IsPosixErrorOkAndHolds(false));
+  ASSERT_THAT(Exists(JoinPath(target, "file")), IsPosixErrorOkAndHolds(true));
+}
+
+// LargeContents returns contents spanning several reads by GetContentsFD.
+std::string LargeContents() {
+  std::string contents(3 * 1024 * 1024 + 17, 0);
+  for (size_t i = 0; i < contents.size(); i++) {
+    contents[i] = 'a' + i % 26;
+  }
+  return contents;
+}
+
+TEST(FsUtilTest, GetContentsLarge) {
+  const std::string contents = LargeContents();
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode));
+  ASSERT_THAT(GetContents(file.path()), IsPosixErrorOkAndHolds(contents));
+}
+
+TEST(FsUtilTest, GetContentsFDFromOffset) {
+  const std::string contents = LargeContents();
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), contents, TempPath::kDefaultFileMode));
+
+  for (bool use_mmap : {false, true}) {
+    SCOPED_TRACE(use_mmap ? "mmap" : "read");
+    const FileDescriptor fd =
+        ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+    // Start at an unaligned offset.
+    constexpr off_t kOffset = 4096 + 5;
+    ASSERT_THAT(lseek(fd.get(), kOffset, SEEK_SET),
+                SyscallSucceedsWithValue(kOffset));
+
+    std::string output = "prefix";
+    ASSERT_NO_ERRNO(GetContentsFD(fd.get(), &output, use_mmap));
+    EXPECT_EQ(output, "prefix" + contents.substr(kOffset));
+
+    // The file offset is at EOF, as for read(2).
+    EXPECT_THAT(lseek(fd.get(), 0, SEEK_CUR),
+                SyscallSucceedsWithValue(contents.size()));
+  }
+}
+
+TEST(FsUtilTest, GetContentsFDPipe) {
+  // Pipes have no size hint and cannot be mapped.
+  for (bool use_mmap : {false, true}) {
+    SCOPED_TRACE(use_mmap ? "mmap" : "read");
+    int fds[2];
+    ASSERT_THAT(pipe(fds), SyscallSucceeds());
+    FileDescriptor rfd(fds[0]);
+    FileDescriptor wfd(fds[1]);
+    ASSERT_THAT(WriteFd(wfd.get(), "hello", 5), SyscallSucceedsWithValue(5));
+    wfd.reset();
+
+    std::string output;
+    ASSERT_NO_ERRNO(GetContentsFD(rfd.get(), &output, use_mmap));
+    EXPECT_EQ(output, "hello");
+  }
+}
+
+TEST(FsUtilTest, GetContentsProc) {
+  // /proc files report a size of 0, so have no size hint.
+  const std::string contents =
+      ASSERT_NO_ERRNO_AND_VALUE(GetContents("/proc/self/maps"));
+  EXPECT_FALSE(contents.empty());
+  EXPECT_EQ(contents.back(), '\n');
+}
+
+TEST(FsUtilTest, GetContentsInto) {
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      GetAbsoluteTestTmpdir(), "hello", TempPath::kDefaultFileMode));
+
+  char buf[8];
+  ASSERT_THAT(GetContentsInto(file.path(), absl::MakeSpan(buf)),
+              IsPosixErrorOkAndHolds(5));
+  EXPECT_EQ(std::string(buf, 5), "hello");
+
+  // Exactly fits.
+  ASSERT_THAT(GetContentsInto(file.path(), absl::MakeSpan(buf, 5)),
+              IsPosixErrorOkAndHolds(5));
+  EXPECT_EQ(std::string(buf, 5), "hello");
+
+  EXPECT_THAT(GetContentsInto(file.path(), absl::MakeSpan(buf, 4)),
+              PosixErrorIs(EOVERFLOW, ::testing::_));
+}
+
 }  // namespace
 
 }  // namespace testing
@@ -19,6 +19,8 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
@@ -118,6 +120,65 @@ inline PosixErrorOr<Mapping> MmapAnon(size_t length, int prot, int flags) {
   return Mmap(nullptr, length, prot, flags | MAP_ANONYMOUS, -1, 0);
 }
 
+// Options for MmapAnon beyond those expressed by mmap's prot and flags.
+struct MmapAnonOptions {
+  // If true, back the mapping with huge pages (MAP_HUGETLB). length must be a
+  // multiple of the default huge page size.
+  bool huge_pages = false;
+
+  // If true, fault in the whole mapping before returning, so that callers
+  // don't measure page faults.
+  bool populate = false;
+
+  // If non-negative, bind the mapping to this NUMA node with
+  // mbind(MPOL_BIND) before it is populated.
+  int numa_node = -1;
+};
+
+// MmapAnon with options.
+inline PosixErrorOr<Mapping> MmapAnon(size_t length, int prot, int flags,
+                                      const MmapAnonOptions& options) {
+  if (options.huge_pages) {
+    flags |= MAP_HUGETLB;
+  }
+  if (options.numa_node < 0) {
+    if (options.populate) {
+      flags |= MAP_POPULATE;
+    }
+    return MmapAnon(length, prot, flags);
+  }
+  if (options.numa_node >= 64) {
+    return PosixError(EINVAL, "NUMA node above 63");
+  }
+
+  // MAP_POPULATE would allocate pages before mbind binds the mapping, so
+  // populate only after binding.
+  Mapping m;
+  ASSIGN_OR_RETURN_ERRNO(m, MmapAnon(length, prot, flags));
+  constexpr int kMpolBind = 2;
+  const uint64_t nodemask = uint64_t{1} << options.numa_node;
+  if (syscall(SYS_mbind, m.ptr(), m.len(), kMpolBind, &nodemask,
+              sizeof(nodemask) * 8 + 1, 0) != 0) {
+    return PosixError(errno, absl::StrFormat("mbind node %d",
+                                             options.numa_node));
+  }
+  if (options.populate) {
+    // Write faults allocate pages, unlike read faults on anonymous memory, so
+    // make the mapping temporarily writable if it isn't already.
+    const int rw = PROT_READ | PROT_WRITE;
+    if ((prot & rw) != rw) {
+      RETURN_ERROR_IF_SYSCALL_FAIL(mprotect(m.ptr(), m.len(), rw));
+    }
+    for (size_t off = 0; off < m.len(); off += kPageSize) {
+      reinterpret_cast<volatile char*>(m.ptr())[off] = 0;
+    }
+    if ((prot & rw) != rw) {
+      RETURN_ERROR_IF_SYSCALL_FAIL(mprotect(m.ptr(), m.len(), prot));
+    }
+  }
+  return m;
+}
+
 // Wrapper for mremap that returns a PosixErrorOr<>, since the return type of
 // void* isn't directly compatible with SyscallSucceeds.
 inline PosixErrorOr<void*> Mremap(void* old_address, size_t old_size,
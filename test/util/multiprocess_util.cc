@@ -18,6 +18,8 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <sched.h>
+#include <sys/mman.h>
 #include <sys/prctl.h>
 #include <unistd.h>
 
@@ -120,6 +122,50 @@ PosixErrorOr<Cleanup> ForkAndExecHelper(const std::function<void()>& exec_fn,
   return std::move(cleanup);
 }
 
+// Stack size for SpawnAndExec children, which only run fn and execve.
+constexpr size_t kSpawnStackSize = 64 << 10;
+
+struct SpawnArgs {
+  const char* filename;
+  char* const* argv;
+  char* const* envv;
+  const std::function<void()>* fn;
+  sigset_t old_mask;
+
+  // Set by the child if execve fails. The parent reads this after the child
+  // exits, since they share memory.
+  int execve_errno;
+};
+
+int SpawnChild(void* arg) {
+  SpawnArgs* args = static_cast<SpawnArgs*>(arg);
+
+  // Unlike the parent's memory, signal handlers are not shared. Reset them so
+  // that none runs in the child once signals are unblocked.
+  for (int sig = 1; sig < NSIG; sig++) {
+    struct sigaction sa;
+    if (sigaction(sig, nullptr, &sa) == 0 && sa.sa_handler != SIG_IGN &&
+        sa.sa_handler != SIG_DFL) {
+      sa.sa_handler = SIG_DFL;
+      sigaction(sig, &sa, nullptr);
+    }
+  }
+
+  // Clean ourself up in case the parent doesn't.
+  if (prctl(PR_SET_PDEATHSIG, SIGKILL)) {
+    _exit(3);
+  }
+
+  if (*args->fn) {
+    (*args->fn)();
+  }
+
+  sigprocmask(SIG_SETMASK, &args->old_mask, nullptr);
+  execve(args->filename, args->argv, args->envv);
+  args->execve_errno = errno;
+  _exit(1);
+}
+
 }  // namespace
 
 PosixErrorOr<Cleanup> ForkAndExec(const std::string& filename,
@@ -135,6 +181,52 @@ PosixErrorOr<Cleanup> ForkAndExec(const std::string& filename,
   return ForkAndExecHelper(exec_fn, fn, child, execve_errno);
 }
 
+PosixErrorOr<Cleanup> SpawnAndExec(const std::string& filename,
+                                   const ExecveArray& argv,
+                                   const ExecveArray& envv,
+                                   const std::function<void()>& fn,
+                                   pid_t* child, int* execve_errno) {
+  void* stack = mmap(nullptr, kSpawnStackSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+  if (stack == MAP_FAILED) {
+    return PosixError(errno, "mmap stack failed");
+  }
+  auto unmap_stack = Cleanup([stack] { munmap(stack, kSpawnStackSize); });
+
+  SpawnArgs args = {};
+  args.filename = filename.c_str();
+  args.argv = argv.get();
+  args.envv = envv.get();
+  args.fn = &fn;
+
+  // Block signals so that no handler runs in the child before it resets them.
+  sigset_t all;
+  sigfillset(&all);
+  if (sigprocmask(SIG_SETMASK, &all, &args.old_mask) < 0) {
+    return PosixError(errno, "sigprocmask failed");
+  }
+  pid_t pid = clone(SpawnChild, static_cast<char*>(stack) + kSpawnStackSize,
+                    CLONE_VM | CLONE_VFORK | SIGCHLD, &args);
+  const int clone_errno = errno;
+  sigprocmask(SIG_SETMASK, &args.old_mask, nullptr);
+  if (pid < 0) {
+    return PosixError(clone_errno, "clone failed");
+  }
+
+  // The child has exec'd or exited.
+  if (child) {
+    *child = pid;
+  }
+  if (execve_errno) {
+    *execve_errno = args.execve_errno;
+  }
+
+  return Cleanup([pid] {
+    kill(pid, SIGKILL);
+    RetryEINTR(waitpid)(pid, nullptr, 0);
+  });
+}
+
 PosixErrorOr<Cleanup> ForkAndExecveat(const int32_t dirfd,
                                       const std::string& pathname,
                                       const ExecveArray& argv,
@@ -103,6 +103,28 @@ inline PosixErrorOr<Cleanup> ForkAndExec(const std::string& filename,
       filename, argv, envv, [] {}, child, execve_errno);
 }
 
+// Equivalent to ForkAndExec, except that the child is created with
+// clone(CLONE_VM | CLONE_VFORK), as by posix_spawn, so that the parent's
+// address space is not copied. The calling thread is suspended until the child
+// execs or exits.
+//
+// fn runs in the child on a separate stack, but shares memory with the parent,
+// so it must not modify any memory other than its own locals. Signals are
+// blocked while it runs.
+PosixErrorOr<Cleanup> SpawnAndExec(const std::string& filename,
+                                   const ExecveArray& argv,
+                                   const ExecveArray& envv,
+                                   const std::function<void()>& fn,
+                                   pid_t* child, int* execve_errno);
+
+inline PosixErrorOr<Cleanup> SpawnAndExec(const std::string& filename,
+                                          const ExecveArray& argv,
+                                          const ExecveArray& envv,
+                                          pid_t* child, int* execve_errno) {
+  return SpawnAndExec(
+      filename, argv, envv, [] {}, child, execve_errno);
+}
+
 // Equivalent to ForkAndExec, except using dirfd and flags with execveat.
 PosixErrorOr<Cleanup> ForkAndExecveat(int32_t dirfd,
                                       const std::string& pathname,
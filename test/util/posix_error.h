@@ -172,7 +172,11 @@ PosixError PosixErrorOr<T>::error() const {
 
 template <typename T>
 int PosixErrorOr<T>::errno_value() const {
-  return error().errno_value();
+  // Avoid copying the error message, as error() would.
+  if (!absl::holds_alternative<PosixError>(value_)) {
+    return 0;
+  }
+  return absl::get<PosixError>(value_).errno_value();
 }
 
 template <typename T>
@@ -433,10 +437,22 @@ IsPosixErrorOkAndHolds(InnerMatcher&& inner_matcher) {
   }                                                                  \
   lhs = std::move(posixerroror).ValueOrDie()
 
+// EXPECT_NO_ERRNO and ASSERT_NO_ERRNO only construct a matcher, which
+// allocates, once expression has failed, so that they are cheap enough to use
+// in benchmark loops.
+#define POSIX_ERROR_IMPL_CHECK_OK_(check, expression)                      \
+  switch (0)                                                              \
+  case 0:                                                                 \
+  default:                                                                \
+    if (const auto& _posix_error_result = (expression);                   \
+        _posix_error_result.ok()) {                                       \
+    } else                                                                \
+      check(_posix_error_result, IsPosixErrorOkMatcher())
+
 #define EXPECT_NO_ERRNO(expression) \
-  EXPECT_THAT(expression, IsPosixErrorOkMatcher())
+  POSIX_ERROR_IMPL_CHECK_OK_(EXPECT_THAT, expression)
 #define ASSERT_NO_ERRNO(expression) \
-  ASSERT_THAT(expression, IsPosixErrorOkMatcher())
+  POSIX_ERROR_IMPL_CHECK_OK_(ASSERT_THAT, expression)
 
 #define ASSIGN_OR_RETURN_ERRNO(lhs, rexpr) \
   POSIX_ERROR_IMPL_ASSIGN_OR_RETURN_(      \
@@ -15,6 +15,9 @@
 #include "test/util/posix_error.h"
 
 #include <errno.h>
+#include <stdlib.h>
+
+#include <new>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -24,6 +27,9 @@ namespace testing {
 
 namespace {
 
+// Number of calls to operator new made by this thread.
+thread_local int allocations = 0;
+
 TEST(PosixErrorTest, PosixError) {
   auto err = PosixError(EAGAIN);
   EXPECT_THAT(err, PosixErrorIs(EAGAIN, ""));
@@ -40,7 +46,33 @@ TEST(PosixErrorTest, PosixErrorOrNullptr) {
   EXPECT_NO_ERRNO(err);
 }
 
+TEST(PosixErrorTest, NoErrnoDoesNotAllocate) {
+  const int before = allocations;
+  int sum = 0;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_NO_ERRNO(PosixErrorOr<int>(i));
+    EXPECT_NO_ERRNO(PosixErrorOr<int>(i));
+    sum += ASSERT_NO_ERRNO_AND_VALUE(PosixErrorOr<int>(i));
+  }
+  const int after = allocations;
+  EXPECT_EQ(after, before);
+  EXPECT_EQ(sum, 45);
+}
+
 }  // namespace
 
 }  // namespace testing
 }  // namespace gvisor
+
+void* operator new(size_t size) {
+  gvisor::testing::allocations++;
+  void* ptr = malloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
@@ -61,6 +61,8 @@ void DisableSave::reset() {
   }
 }
 
+bool IsCooperativeSaveEnabled() { return CooperativeSaveEnabled(); }
+
 namespace internal {
 bool ShouldSave() {
   return CooperativeSaveEnabled() && (save_disable.load() == 0);
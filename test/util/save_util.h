@@ -37,11 +37,30 @@ class DisableSave {
   bool reset_ = false;
 };
 
+// Kinds of co-operative save that may be requested by MaybeSave.
+enum class SaveKind {
+  // Save the entire sandbox.
+  kFull = 0,
+
+  // Save only the memory dirtied since the previous save, as a delta on top of
+  // the previous checkpoint. Restore replays the chain of deltas back to the
+  // most recent full save. If there is no previous save, or incremental saves
+  // are not supported, this is equivalent to kFull.
+  kIncremental = 1,
+};
+
 // May perform a co-operative save cycle.
 //
 // errno is guaranteed to be preserved.
 void MaybeSave();
 
+// Like MaybeSave, but requests a save of the given kind.
+void MaybeSave(SaveKind kind);
+
+// Returns true if the test runs under co-operative save, in which case
+// MaybeSave performs a save cycle outside of DisableSave scopes.
+bool IsCooperativeSaveEnabled();
+
 namespace internal {
 bool ShouldSave();
 }  // namespace internal
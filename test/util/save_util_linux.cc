@@ -31,14 +31,18 @@
 namespace gvisor {
 namespace testing {
 
-void MaybeSave() {
+void MaybeSave() { MaybeSave(SaveKind::kFull); }
+
+void MaybeSave(SaveKind kind) {
   if (internal::ShouldSave()) {
     int orig_errno = errno;
     // We use it to trigger saving the sentry state
     // when this syscall is called.
     // Notice: this needs to be a valid syscall
     // that is not used in any of the syscall tests.
-    syscall(SYS_TRIGGER_SAVE, nullptr, 0);
+    //
+    // The second argument selects the kind of save.
+    syscall(SYS_TRIGGER_SAVE, nullptr, static_cast<int>(kind));
     errno = orig_errno;
   }
 }
@@ -14,6 +14,8 @@
 
 #ifndef __linux__
 
+#include "test/util/save_util.h"
+
 namespace gvisor {
 namespace testing {
 
@@ -21,6 +23,10 @@ void MaybeSave() {
   // Saving is never available in a non-linux environment.
 }
 
+void MaybeSave(SaveKind kind) {
+  // Saving is never available in a non-linux environment.
+}
+
 }  // namespace testing
 }  // namespace gvisor
 
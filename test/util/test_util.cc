@@ -23,6 +23,7 @@
 #include <sys/utsname.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <ctime>
 #include <iostream>
 #include <vector>
@@ -37,6 +38,10 @@
 #include "test/util/fs_util.h"
 #include "test/util/posix_error.h"
 
+ABSL_FLAG(uint64_t, randomize_buffer_seed, 0,
+          "seed for RandomizeBuffer; if 0, a seed is picked and logged, so "
+          "that failures can be reproduced by passing it here");
+
 namespace gvisor {
 namespace testing {
 
@@ -190,14 +195,103 @@ PosixErrorOr<uint64_t> Links(const std::string& path) {
   return static_cast<uint64_t>(st.st_nlink);
 }
 
-void RandomizeBuffer(void* buffer, size_t len) {
-  struct timespec ts = {};
-  clock_gettime(CLOCK_MONOTONIC, &ts);
-  uint32_t seed = static_cast<uint32_t>(ts.tv_nsec);
-  char* const buf = static_cast<char*>(buffer);
-  for (size_t i = 0; i < len; i++) {
-    buf[i] = rand_r(&seed) % 255;
+namespace {
+
+// SplitMix64 advances *state and returns the next value. It is used to expand
+// a seed into xoshiro256** state.
+uint64_t SplitMix64(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+inline uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+// Xoshiro256Lanes is kLanes independent xoshiro256** generators, stored by
+// state word rather than by generator so that the compiler can vectorize
+// stepping all of them at once.
+class Xoshiro256Lanes {
+ public:
+  static constexpr int kLanes = 4;
+  static constexpr size_t kBlockSize = kLanes * sizeof(uint64_t);
+
+  explicit Xoshiro256Lanes(uint64_t seed) {
+    for (int i = 0; i < kLanes; i++) {
+      s0_[i] = SplitMix64(&seed);
+      s1_[i] = SplitMix64(&seed);
+      s2_[i] = SplitMix64(&seed);
+      s3_[i] = SplitMix64(&seed);
+    }
+  }
+
+  // Next writes the next kBlockSize random bytes to out.
+  void Next(uint64_t out[kLanes]) {
+    for (int i = 0; i < kLanes; i++) {
+      out[i] = Rotl(s1_[i] * 5, 7) * 9;
+      const uint64_t t = s1_[i] << 17;
+      s2_[i] ^= s0_[i];
+      s3_[i] ^= s1_[i];
+      s1_[i] ^= s2_[i];
+      s0_[i] ^= s3_[i];
+      s2_[i] ^= t;
+      s3_[i] = Rotl(s3_[i], 45);
+    }
   }
+
+ private:
+  uint64_t s0_[kLanes];
+  uint64_t s1_[kLanes];
+  uint64_t s2_[kLanes];
+  uint64_t s3_[kLanes];
+};
+
+constexpr int Xoshiro256Lanes::kLanes;
+constexpr size_t Xoshiro256Lanes::kBlockSize;
+
+// RandomizeBufferSeed returns the seed from which RandomizeBuffer derives the
+// seed of each call.
+uint64_t RandomizeBufferSeed() {
+  static const uint64_t seed = [] {
+    uint64_t seed = absl::GetFlag(FLAGS_randomize_buffer_seed);
+    if (seed == 0) {
+      struct timespec ts = {};
+      clock_gettime(CLOCK_REALTIME, &ts);
+      seed = static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+      seed ^= static_cast<uint64_t>(getpid()) << 32;
+      std::cerr << "RandomizeBuffer seed: " << seed
+                << " (pass --randomize_buffer_seed=" << seed
+                << " to reproduce)" << std::endl;
+    }
+    return seed;
+  }();
+  return seed;
+}
+
+}  // namespace
+
+void RandomizeBuffer(void* buffer, size_t len, uint64_t seed) {
+  Xoshiro256Lanes gen(seed);
+  char* buf = static_cast<char*>(buffer);
+  uint64_t block[Xoshiro256Lanes::kLanes];
+  while (len >= Xoshiro256Lanes::kBlockSize) {
+    gen.Next(block);
+    memcpy(buf, block, Xoshiro256Lanes::kBlockSize);
+    buf += Xoshiro256Lanes::kBlockSize;
+    len -= Xoshiro256Lanes::kBlockSize;
+  }
+  if (len > 0) {
+    gen.Next(block);
+    memcpy(buf, block, len);
+  }
+}
+
+void RandomizeBuffer(void* buffer, size_t len) {
+  // Each call gets its own stream, numbered in call order, so that a
+  // single-threaded test sees the same data in every call when rerun with the
+  // same seed.
+  static std::atomic<uint64_t> calls(0);
+  RandomizeBuffer(buffer, len, RandomizeBufferSeed() + calls.fetch_add(1));
 }
 
 std::vector<std::vector<struct iovec>> GenerateIovecs(uint64_t total_size,
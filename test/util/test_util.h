@@ -159,7 +159,9 @@
 // VecAppend takes an initial container and a variadic number of containers and
 // appends each to the initial container.
 //
-// RandomizeBuffer will use MTRandom to fill the given buffer with random bytes.
+// RandomizeBuffer fills the given buffer with random bytes. The data is
+// reproducible with --randomize_buffer_seed, or with the explicit seed
+// overload.
 //
 // GenerateIovecs will return the smallest number of iovec arrays for writing a
 // given total number of bytes to a file, each iovec array size up to IOV_MAX,
@@ -695,8 +697,15 @@ std::vector<T> VecCat(Args&&... args) {
   } while (false)
 
 // Fill the given buffer with random bytes.
+//
+// The bytes are derived from a seed that is logged on first use, and from the
+// number of preceding calls. Pass the logged seed to --randomize_buffer_seed to
+// reproduce the data of a failing run.
 void RandomizeBuffer(void* buffer, size_t len);
 
+// Fill the given buffer with random bytes determined only by seed.
+void RandomizeBuffer(void* buffer, size_t len, uint64_t seed);
+
 template <typename T>
 inline PosixErrorOr<T> Atoi(absl::string_view str) {
   T ret;
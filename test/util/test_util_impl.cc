@@ -13,16 +13,30 @@
 // limitations under the License.
 
 #include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 #include "test/util/logging.h"
 
 extern bool FLAGS_benchmark_list_tests;
 extern std::string FLAGS_benchmark_filter;
 
+ABSL_FLAG(int32_t, test_parallelism, 1,
+          "number of forked worker processes among which test cases are "
+          "sharded; 1 runs all test cases in this process");
+
 namespace gvisor {
 namespace testing {
 
@@ -39,13 +53,94 @@ void TestInit(int* argc, char*** argv) {
   TEST_CHECK(sigaction(SIGPIPE, &sa, nullptr) == 0);
 }
 
+namespace {
+
+// EnvInt returns the integer value of environment variable name, or def if it
+// is unset or invalid.
+int EnvInt(const char* name, int def) {
+  const char* value = getenv(name);
+  int i;
+  if (value == nullptr || !absl::SimpleAtoi(value, &i)) {
+    return def;
+  }
+  return i;
+}
+
+// RunTestsInParallel runs all tests in the given number of forked workers,
+// each running one gtest shard. If this process is itself a shard, each worker
+// runs a sub-shard of it. Each worker's output is printed in full once it
+// exits, in worker order.
+//
+// Workers do not write XML output, since they would overwrite each other's.
+int RunTestsInParallel(int workers) {
+  const int total_shards = EnvInt("GTEST_TOTAL_SHARDS", 1);
+  const int shard_index = EnvInt("GTEST_SHARD_INDEX", 0);
+
+  struct Worker {
+    pid_t pid;
+    FILE* output;
+  };
+  std::vector<Worker> running;
+
+  // Don't duplicate buffered output in every worker.
+  fflush(nullptr);
+  for (int i = 0; i < workers; i++) {
+    FILE* output = tmpfile();
+    TEST_PCHECK(output != nullptr);
+    const pid_t pid = fork();
+    TEST_PCHECK(pid >= 0);
+    if (pid == 0) {
+      TEST_PCHECK(dup2(fileno(output), STDOUT_FILENO) >= 0);
+      TEST_PCHECK(dup2(fileno(output), STDERR_FILENO) >= 0);
+      TEST_PCHECK(setenv("GTEST_TOTAL_SHARDS",
+                         absl::StrCat(total_shards * workers).c_str(), 1) == 0);
+      TEST_PCHECK(setenv("GTEST_SHARD_INDEX",
+                         absl::StrCat(shard_index * workers + i).c_str(),
+                         1) == 0);
+      TEST_PCHECK(unsetenv("XML_OUTPUT_FILE") == 0);
+      ::testing::GTEST_FLAG(output) = "";
+      const int ret = RUN_ALL_TESTS();
+      fflush(nullptr);
+      _exit(ret);
+    }
+    running.push_back({pid, output});
+  }
+
+  int ret = 0;
+  for (int i = 0; i < workers; i++) {
+    int status;
+    TEST_PCHECK(waitpid(running[i].pid, &status, 0) == running[i].pid);
+
+    std::cout << "[ WORKER   ] " << i << " of " << workers << std::endl;
+    rewind(running[i].output);
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), running[i].output)) > 0) {
+      std::cout.write(buf, n);
+    }
+    fclose(running[i].output);
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      std::cout << "[  FAILED  ] Worker " << i << " exited with status "
+                << status << std::endl;
+      ret = 1;
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
 int RunAllTests() {
   if (FLAGS_benchmark_list_tests || FLAGS_benchmark_filter != ".") {
     benchmark::RunSpecifiedBenchmarks();
     return 0;
-  } else {
-    return RUN_ALL_TESTS();
   }
+  const int workers = absl::GetFlag(FLAGS_test_parallelism);
+  if (workers > 1 && !::testing::GTEST_FLAG(list_tests)) {
+    return RunTestsInParallel(workers);
+  }
+  return RUN_ALL_TESTS();
 }
 
 }  // namespace testing
@@ -16,6 +16,7 @@
 
 #include <errno.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -163,6 +164,39 @@ TEST(RandomizeBuffer, Works) {
   EXPECT_NE(buffer, original);
 }
 
+TEST(RandomizeBuffer, CallsDiffer) {
+  std::vector<char> first(4096);
+  std::vector<char> second(4096);
+  RandomizeBuffer(first.data(), first.size());
+  RandomizeBuffer(second.data(), second.size());
+  EXPECT_NE(first, second);
+}
+
+TEST(RandomizeBuffer, SameSeed) {
+  std::vector<char> first(4096);
+  std::vector<char> second(4096);
+  RandomizeBuffer(first.data(), first.size(), 1);
+  RandomizeBuffer(second.data(), second.size(), 1);
+  EXPECT_EQ(first, second);
+
+  RandomizeBuffer(second.data(), second.size(), 2);
+  EXPECT_NE(first, second);
+}
+
+TEST(RandomizeBuffer, Tail) {
+  // The data for a given seed is a prefix of the data for a longer buffer,
+  // regardless of whether the length is a multiple of the block size.
+  std::vector<char> full(4096);
+  RandomizeBuffer(full.data(), full.size(), 1);
+  for (size_t len : {1, 7, 31, 33, 100}) {
+    SCOPED_TRACE(len);
+    std::vector<char> buffer(len + 1, 'z');
+    RandomizeBuffer(buffer.data(), len, 1);
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + len, full.begin()));
+    EXPECT_EQ(buffer[len], 'z');
+  }
+}
+
 // Enable comparison of vectors of iovec arrays for the following test.
 MATCHER_P(IovecsListEq, expected, "") {
   if (arg.size() != expected.size()) {
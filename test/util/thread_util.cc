@@ -0,0 +1,88 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/util/thread_util.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "test/util/logging.h"
+
+namespace gvisor {
+namespace testing {
+
+std::vector<int> AllowedCPUs() {
+  cpu_set_t set;
+  TEST_PCHECK(sched_getaffinity(0, sizeof(set), &set) == 0);
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+WorkerPool::WorkerPool(int n, bool pin) {
+  // Each barrier is shared by the workers and the caller of Run.
+  TEST_CHECK(pthread_barrier_init(&start_, nullptr, n + 1) == 0);
+  TEST_CHECK(pthread_barrier_init(&done_, nullptr, n + 1) == 0);
+
+  const std::vector<int> cpus = AllowedCPUs();
+  TEST_CHECK(!cpus.empty());
+  for (int i = 0; i < n; i++) {
+    const int cpu = pin ? cpus[i % cpus.size()] : -1;
+    threads_.push_back(
+        std::make_unique<ScopedThread>([this, i, cpu] { Work(i, cpu); }));
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  // fn_ is nullptr between calls to Run, so the workers exit.
+  pthread_barrier_wait(&start_);
+  threads_.clear();
+  TEST_CHECK(pthread_barrier_destroy(&start_) == 0);
+  TEST_CHECK(pthread_barrier_destroy(&done_) == 0);
+}
+
+void WorkerPool::Run(const std::function<void(int)>& fn) {
+  fn_ = &fn;
+  pthread_barrier_wait(&start_);
+  pthread_barrier_wait(&done_);
+  fn_ = nullptr;
+}
+
+void WorkerPool::Work(int i, int cpu) {
+  if (cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    TEST_PCHECK(sched_setaffinity(0, sizeof(set), &set) == 0);
+  }
+  while (true) {
+    pthread_barrier_wait(&start_);
+    if (fn_ == nullptr) {
+      return;
+    }
+    (*fn_)(i);
+    pthread_barrier_wait(&done_);
+  }
+}
+
+}  // namespace testing
+}  // namespace gvisor
@@ -16,13 +16,16 @@
 #define GVISOR_TEST_UTIL_THREAD_UTIL_H_
 
 #include <pthread.h>
+#include <sched.h>
 #ifdef __linux__
 #include <sys/syscall.h>
 #endif
 #include <unistd.h>
 
 #include <functional>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "test/util/logging.h"
 
@@ -83,6 +86,48 @@ class ScopedThread {
   void* retval_ = nullptr;
 };
 
+// AllowedCPUs returns the CPUs on which the calling thread may run.
+std::vector<int> AllowedCPUs();
+
+// WorkerPool is a fixed set of threads that repeatedly run a function
+// together, for benchmarks that measure contention between threads.
+//
+// Each call to Run releases all workers at once from a barrier, so that none
+// gets a head start while the others are still being scheduled, and returns
+// only once all of them have finished. Threads are created once, so their
+// creation isn't measured.
+class WorkerPool {
+ public:
+  // Starts n workers. If pin is true, worker i is pinned to the
+  // (i % AllowedCPUs().size())'th CPU on which the caller may run.
+  explicit WorkerPool(int n, bool pin = true);
+
+  WorkerPool(const WorkerPool& other) = delete;
+  WorkerPool& operator=(const WorkerPool& other) = delete;
+
+  // Stops and joins all workers.
+  ~WorkerPool();
+
+  // Calls fn(i) on each worker i and waits for all calls to return. Run is
+  // not thread-safe.
+  void Run(const std::function<void(int)>& fn);
+
+  // Returns the number of workers.
+  int size() const { return threads_.size(); }
+
+ private:
+  void Work(int i, int cpu);
+
+  pthread_barrier_t start_;
+  pthread_barrier_t done_;
+
+  // fn_ is the function being run, or nullptr if the workers should exit.
+  // It is only written while no worker is between start_ and done_.
+  const std::function<void(int)>* fn_ = nullptr;
+
+  std::vector<std::unique_ptr<ScopedThread>> threads_;
+};
+
 #ifdef __linux__
 inline pid_t gettid() { return syscall(SYS_gettid); }
 #endif
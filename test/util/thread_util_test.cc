@@ -0,0 +1,86 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/util/thread_util.h"
+
+#include <sched.h>
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/util/logging.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+TEST(WorkerPoolTest, RunCallsEachWorkerOnce) {
+  constexpr int kWorkers = 4;
+  WorkerPool pool(kWorkers, /*pin=*/false);
+  ASSERT_EQ(pool.size(), kWorkers);
+
+  std::vector<std::atomic<int>> calls(kWorkers);
+  for (int run = 1; run <= 3; run++) {
+    pool.Run([&](int i) { calls[i]++; });
+    for (int i = 0; i < kWorkers; i++) {
+      EXPECT_EQ(calls[i].load(), run) << i;
+    }
+  }
+}
+
+TEST(WorkerPoolTest, WorkersRunConcurrently) {
+  constexpr int kWorkers = 3;
+  WorkerPool pool(kWorkers, /*pin=*/false);
+
+  // Every worker waits for all the others, which deadlocks unless all of
+  // them run at the same time.
+  std::atomic<int> arrived(0);
+  pool.Run([&](int) {
+    arrived++;
+    while (arrived.load() < kWorkers) {
+      sched_yield();
+    }
+  });
+  EXPECT_EQ(arrived.load(), kWorkers);
+}
+
+TEST(WorkerPoolTest, WorkersArePinned) {
+  const std::vector<int> cpus = AllowedCPUs();
+  ASSERT_FALSE(cpus.empty());
+  const int workers = cpus.size() + 1;
+  WorkerPool pool(workers);
+
+  std::vector<int> got(workers, -1);
+  pool.Run([&](int i) {
+    cpu_set_t set;
+    TEST_PCHECK(sched_getaffinity(0, sizeof(set), &set) == 0);
+    if (CPU_COUNT(&set) == 1) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+          got[i] = cpu;
+        }
+      }
+    }
+  });
+  for (int i = 0; i < workers; i++) {
+    EXPECT_EQ(got[i], cpus[i % cpus.size()]) << i;
+  }
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,392 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package delta exports the results of the benchmarks in test/perf and
+// compares them between runs.
+//
+// A Run holds the results of one benchmark target (e.g.
+// //test/perf:getpid_benchmark_runsc_ptrace) at one commit, as parsed from its
+// Google Benchmark console output. Compare groups the results of several Runs
+// by target and benchmark and flags the benchmarks whose mean time per
+// iteration changed significantly between two sets of Runs.
+package delta
+
+import (
+	"bufio"
+	"fmt"
+	"io"
+	"math"
+	"path/filepath"
+	"regexp"
+	"sort"
+	"strconv"
+	"strings"
+)
+
+// Result is a single result line of a benchmark.
+type Result struct {
+	// Name is the full benchmark name, including arguments, e.g.
+	// "BM_CopyFile/method:0/size:1048576/real_time".
+	Name string `json:"name"`
+
+	// Time is the time per iteration, in nanoseconds. This is wall time
+	// for benchmarks using UseRealTime, and CPU time otherwise.
+	Time float64 `json:"time_ns"`
+
+	// CPUTime is the CPU time per iteration, in nanoseconds.
+	CPUTime float64 `json:"cpu_time_ns"`
+
+	// Iterations is the number of iterations the result was measured over.
+	Iterations int64 `json:"iterations"`
+}
+
+// Run is the exported result of a single run of a benchmark target.
+type Run struct {
+	// Commit is the commit the benchmarks were built at.
+	Commit string `json:"commit"`
+
+	// Target is the test target, without package, e.g.
+	// "getpid_benchmark_runsc_ptrace". It may be empty.
+	Target string `json:"target,omitempty"`
+
+	// Platform is the platform the benchmarks ran on, e.g. "ptrace", or
+	// "native" when they ran outside of the sandbox.
+	Platform string `json:"platform"`
+
+	// Overlay is true if the root filesystem was wrapped in a tmpfs
+	// overlay.
+	Overlay bool `json:"overlay"`
+
+	// Results are the benchmark results, in output order. When
+	// benchmarks are run with --benchmark_repetitions, each repetition is a
+	// separate Result with the same Name.
+	Results []Result `json:"results"`
+}
+
+// resultRE matches a Google Benchmark console result line, e.g.:
+//
+//	BM_Getpid                    1167 ns         1166 ns       600214
+var resultRE = regexp.MustCompile(`^(BM_\S+)\s+([0-9.e+]+) (ns|us|ms|s)\s+([0-9.e+]+) (ns|us|ms|s)\s+([0-9]+)\b`)
+
+// aggregateSuffixes are the suffixes of the aggregate lines printed when
+// benchmarks are repeated. These are derived from the other results, so they
+// are skipped.
+var aggregateSuffixes = []string{"_mean", "_median", "_stddev", "_cv"}
+
+// nanoseconds converts a value in unit to nanoseconds.
+func nanoseconds(value string, unit string) (float64, error) {
+	v, err := strconv.ParseFloat(value, 64)
+	if err != nil {
+		return 0, err
+	}
+	switch unit {
+	case "ns":
+		return v, nil
+	case "us":
+		return v * 1e3, nil
+	case "ms":
+		return v * 1e6, nil
+	case "s":
+		return v * 1e9, nil
+	default:
+		return 0, fmt.Errorf("unknown unit %q", unit)
+	}
+}
+
+// Parse parses Google Benchmark console output and returns its results. Lines
+// that are not benchmark results, such as the runner's or the sandbox's
+// output, are ignored.
+func Parse(r io.Reader) ([]Result, error) {
+	var results []Result
+	scanner := bufio.NewScanner(r)
+	scanner.Buffer(nil, 1<<20)
+next:
+	for scanner.Scan() {
+		m := resultRE.FindStringSubmatch(scanner.Text())
+		if m == nil {
+			continue
+		}
+		for _, suffix := range aggregateSuffixes {
+			if strings.HasSuffix(m[1], suffix) {
+				continue next
+			}
+		}
+		t, err := nanoseconds(m[2], m[3])
+		if err != nil {
+			return nil, fmt.Errorf("bad time in %q: %v", m[0], err)
+		}
+		cpu, err := nanoseconds(m[4], m[5])
+		if err != nil {
+			return nil, fmt.Errorf("bad CPU time in %q: %v", m[0], err)
+		}
+		iters, err := strconv.ParseInt(m[6], 10, 64)
+		if err != nil {
+			return nil, fmt.Errorf("bad iterations in %q: %v", m[0], err)
+		}
+		results = append(results, Result{
+			Name:       m[1],
+			Time:       t,
+			CPUTime:    cpu,
+			Iterations: iters,
+		})
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, err
+	}
+	return results, nil
+}
+
+// shardRE matches the directories bazel puts the logs of test shards and of
+// repeated runs (--runs_per_test) in.
+var shardRE = regexp.MustCompile(`^(shard_[0-9]+_of_[0-9]+_?)?(run_[0-9]+_of_[0-9]+)?$`)
+
+// InferTarget returns the target name, platform and overlay flag of a test log
+// path in bazel-testlogs, e.g.
+// "bazel-testlogs/test/perf/getpid_benchmark_runsc_kvm_overlay/test.log". The
+// names are those given by syscall_test in test/runner/defs.bzl. ok is false
+// if the path doesn't contain such a target name.
+func InferTarget(path string) (target, platform string, overlay, ok bool) {
+	dir := filepath.Dir(path)
+	for dir != "." && dir != string(filepath.Separator) {
+		base := filepath.Base(dir)
+		dir = filepath.Dir(dir)
+		if shardRE.MatchString(base) {
+			continue
+		}
+		if i := strings.LastIndex(base, "_runsc_"); i >= 0 {
+			flavor := strings.Split(base[i+len("_runsc_"):], "_")
+			platform = flavor[0]
+			for _, f := range flavor[1:] {
+				if f == "overlay" {
+					overlay = true
+				}
+			}
+			return base, platform, overlay, true
+		}
+		if strings.HasSuffix(base, "_native") {
+			return base, "native", false, true
+		}
+		return "", "", false, false
+	}
+	return "", "", false, false
+}
+
+// Key identifies a benchmark across runs.
+type Key struct {
+	// Target is the test target of the benchmark, or if unknown, its
+	// platform followed by "+overlay" if applicable.
+	Target string
+
+	// Name is the benchmark name.
+	Name string
+}
+
+// key returns the key of result r of run.
+func (run *Run) key(r *Result) Key {
+	target := run.Target
+	if target == "" {
+		target = run.Platform
+		if run.Overlay {
+			target += "+overlay"
+		}
+	}
+	return Key{Target: target, Name: r.Name}
+}
+
+// samples returns the time per iteration of each result of runs, by key.
+func samples(runs []*Run) map[Key][]float64 {
+	m := make(map[Key][]float64)
+	for _, run := range runs {
+		for i := range run.Results {
+			k := run.key(&run.Results[i])
+			m[k] = append(m[k], run.Results[i].Time)
+		}
+	}
+	return m
+}
+
+// Verdict is the outcome of the comparison of a benchmark.
+type Verdict int
+
+const (
+	// Unchanged means that the change is not significant.
+	Unchanged Verdict = iota
+
+	// Regression means that the benchmark became significantly slower.
+	Regression
+
+	// Improvement means that the benchmark became significantly faster.
+	Improvement
+
+	// Insufficient means that either side has fewer than two samples, so
+	// that no confidence interval can be computed.
+	Insufficient
+
+	// Missing means that the benchmark only has results on one side.
+	Missing
+)
+
+// String implements fmt.Stringer.String.
+func (v Verdict) String() string {
+	switch v {
+	case Unchanged:
+		return "~"
+	case Regression:
+		return "REGRESSION"
+	case Improvement:
+		return "improvement"
+	case Insufficient:
+		return "too few samples"
+	case Missing:
+		return "missing"
+	default:
+		return fmt.Sprintf("Verdict(%d)", int(v))
+	}
+}
+
+// Delta is the comparison of a benchmark between two sets of runs.
+type Delta struct {
+	Key
+
+	// Base and Test summarize the samples of each side.
+	Base, Test Summary
+
+	// Change is the relative change of the mean time, (Test-Base)/Base.
+	Change float64
+
+	// Low and High are the bounds of the confidence interval of Change.
+	Low, High float64
+
+	// Verdict is the outcome of the comparison.
+	Verdict Verdict
+}
+
+// Options controls Compare.
+type Options struct {
+	// Confidence is the confidence level of the intervals, e.g. 0.95.
+	Confidence float64
+
+	// Threshold is the smallest relative change that is flagged, e.g.
+	// 0.05. A change is only flagged if its whole confidence interval is
+	// beyond the threshold.
+	Threshold float64
+}
+
+// Compare compares the results of the base runs with those of the test runs,
+// and returns the comparison of each benchmark, sorted by key.
+//
+// Each result is a sample of the benchmark's time per iteration; the samples
+// of a benchmark come from all runs on each side, so the benchmark targets
+// should be run several times (or with --benchmark_repetitions) on each side.
+// The confidence interval of the change of the mean is computed with Welch's
+// t-test, which doesn't assume that both sides have the same variance.
+func Compare(base, test []*Run, opts Options) []Delta {
+	bs := samples(base)
+	ts := samples(test)
+	keys := make(map[Key]struct{})
+	for k := range bs {
+		keys[k] = struct{}{}
+	}
+	for k := range ts {
+		keys[k] = struct{}{}
+	}
+
+	deltas := make([]Delta, 0, len(keys))
+	for k := range keys {
+		d := Delta{
+			Key:  k,
+			Base: Summarize(bs[k]),
+			Test: Summarize(ts[k]),
+		}
+		d.compare(opts)
+		deltas = append(deltas, d)
+	}
+	sort.Slice(deltas, func(i, j int) bool {
+		if deltas[i].Target != deltas[j].Target {
+			return deltas[i].Target < deltas[j].Target
+		}
+		return deltas[i].Name < deltas[j].Name
+	})
+	return deltas
+}
+
+// compare fills in the change, confidence interval and verdict of d.
+func (d *Delta) compare(opts Options) {
+	if d.Base.N == 0 || d.Test.N == 0 {
+		d.Verdict = Missing
+		return
+	}
+	d.Change = (d.Test.Mean - d.Base.Mean) / d.Base.Mean
+	if d.Base.N < 2 || d.Test.N < 2 {
+		d.Verdict = Insufficient
+		return
+	}
+
+	// Welch's t-test: the standard error of the difference of the means,
+	// and the Welch–Satterthwaite approximation of its degrees of
+	// freedom.
+	vb := d.Base.Var / float64(d.Base.N)
+	vt := d.Test.Var / float64(d.Test.N)
+	se := math.Sqrt(vb + vt)
+	margin := 0.0
+	if se > 0 {
+		df := (vb + vt) * (vb + vt) /
+			(vb*vb/float64(d.Base.N-1) + vt*vt/float64(d.Test.N-1))
+		margin = studentTQuantile(1-(1-opts.Confidence)/2, df) * se
+	}
+	diff := d.Test.Mean - d.Base.Mean
+	d.Low = (diff - margin) / d.Base.Mean
+	d.High = (diff + margin) / d.Base.Mean
+
+	switch {
+	case d.Low > opts.Threshold:
+		d.Verdict = Regression
+	case d.High < -opts.Threshold:
+		d.Verdict = Improvement
+	default:
+		d.Verdict = Unchanged
+	}
+}
+
+// Summary summarizes a set of samples.
+type Summary struct {
+	// N is the number of samples.
+	N int
+
+	// Mean is their mean.
+	Mean float64
+
+	// Var is their unbiased sample variance. It is zero if N < 2.
+	Var float64
+}
+
+// Summarize returns the summary of samples.
+func Summarize(samples []float64) Summary {
+	s := Summary{N: len(samples)}
+	if s.N == 0 {
+		return s
+	}
+	for _, x := range samples {
+		s.Mean += x
+	}
+	s.Mean /= float64(s.N)
+	if s.N < 2 {
+		return s
+	}
+	for _, x := range samples {
+		s.Var += (x - s.Mean) * (x - s.Mean)
+	}
+	s.Var /= float64(s.N - 1)
+	return s
+}
@@ -0,0 +1,181 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package delta
+
+import (
+	"math"
+	"reflect"
+	"strings"
+	"testing"
+)
+
+const output = `[==========] Running 0 tests from 0 test suites.
+[==========] 0 tests from 0 test suites ran. (0 ms total)
+[  PASSED  ] 0 tests.
+2020-06-01T10:00:00+00:00
+Running /test/perf/linux/getpid_benchmark
+Run on (4 X 2200 MHz CPU s)
+---------------------------------------------------------------------
+Benchmark                           Time             CPU   Iterations
+---------------------------------------------------------------------
+BM_Getpid                        1167 ns         1166 ns       600214
+BM_Getpid                        1185 ns         1183 ns       600214
+BM_Getpid_mean                   1176 ns         1174 ns            2
+BM_CopyFile/method:0/size:1048576/real_time   2.50 ms   0.01 ms   280 bytes_per_second=400M/s
+`
+
+func TestParse(t *testing.T) {
+	got, err := Parse(strings.NewReader(output))
+	if err != nil {
+		t.Fatalf("Parse failed: %v", err)
+	}
+	want := []Result{
+		{Name: "BM_Getpid", Time: 1167, CPUTime: 1166, Iterations: 600214},
+		{Name: "BM_Getpid", Time: 1185, CPUTime: 1183, Iterations: 600214},
+		{Name: "BM_CopyFile/method:0/size:1048576/real_time", Time: 2.5e6, CPUTime: 1e4, Iterations: 280},
+	}
+	if !reflect.DeepEqual(got, want) {
+		t.Errorf("Parse got %+v, want %+v", got, want)
+	}
+}
+
+func TestInferTarget(t *testing.T) {
+	for _, tc := range []struct {
+		path     string
+		target   string
+		platform string
+		overlay  bool
+		ok       bool
+	}{
+		{
+			path:     "bazel-testlogs/test/perf/getpid_benchmark_runsc_ptrace/test.log",
+			target:   "getpid_benchmark_runsc_ptrace",
+			platform: "ptrace",
+			ok:       true,
+		},
+		{
+			path:     "bazel-testlogs/test/perf/read_benchmark_runsc_kvm_overlay/shard_2_of_5/test.log",
+			target:   "read_benchmark_runsc_kvm_overlay",
+			platform: "kvm",
+			overlay:  true,
+			ok:       true,
+		},
+		{
+			path:     "bazel-testlogs/test/perf/getpid_benchmark_runsc_ptrace/shard_1_of_5_run_3_of_10/test.log",
+			target:   "getpid_benchmark_runsc_ptrace",
+			platform: "ptrace",
+			ok:       true,
+		},
+		{
+			path:     "bazel-testlogs/test/perf/getpid_benchmark_native/test.log",
+			target:   "getpid_benchmark_native",
+			platform: "native",
+			ok:       true,
+		},
+		{
+			path: "logs/test.log",
+		},
+	} {
+		target, platform, overlay, ok := InferTarget(tc.path)
+		if target != tc.target || platform != tc.platform || overlay != tc.overlay || ok != tc.ok {
+			t.Errorf("InferTarget(%q) = %q, %q, %t, %t, want %q, %q, %t, %t", tc.path, target, platform, overlay, ok, tc.target, tc.platform, tc.overlay, tc.ok)
+		}
+	}
+}
+
+func TestStudentTQuantile(t *testing.T) {
+	// Values from a table of the t distribution.
+	for _, tc := range []struct {
+		p, df, want float64
+	}{
+		{p: 0.975, df: 1, want: 12.706},
+		{p: 0.975, df: 4, want: 2.776},
+		{p: 0.975, df: 30, want: 2.042},
+		{p: 0.995, df: 10, want: 3.169},
+		{p: 0.5, df: 7, want: 0},
+	} {
+		if got := studentTQuantile(tc.p, tc.df); math.Abs(got-tc.want) > 1e-3 {
+			t.Errorf("studentTQuantile(%v, %v) = %v, want %v", tc.p, tc.df, got, tc.want)
+		}
+	}
+}
+
+// runOf returns a run with one result for name and each of times.
+func runOf(name string, times ...float64) *Run {
+	run := &Run{Platform: "ptrace"}
+	for _, t := range times {
+		run.Results = append(run.Results, Result{Name: name, Time: t})
+	}
+	return run
+}
+
+func TestCompare(t *testing.T) {
+	opts := Options{Confidence: 0.95, Threshold: 0.02}
+	for _, tc := range []struct {
+		name string
+		base []*Run
+		test []*Run
+		want Verdict
+	}{
+		{
+			name: "regression",
+			base: []*Run{runOf("BM_A", 100, 101, 99), runOf("BM_A", 100, 102)},
+			test: []*Run{runOf("BM_A", 120, 119, 121), runOf("BM_A", 120, 122)},
+			want: Regression,
+		},
+		{
+			name: "improvement",
+			base: []*Run{runOf("BM_A", 100, 101, 99, 100)},
+			test: []*Run{runOf("BM_A", 80, 81, 79, 80)},
+			want: Improvement,
+		},
+		{
+			name: "noise",
+			base: []*Run{runOf("BM_A", 100, 130, 70, 100)},
+			test: []*Run{runOf("BM_A", 110, 140, 80, 110)},
+			want: Unchanged,
+		},
+		{
+			name: "below threshold",
+			base: []*Run{runOf("BM_A", 100, 100.1, 99.9)},
+			test: []*Run{runOf("BM_A", 101, 101.1, 100.9)},
+			want: Unchanged,
+		},
+		{
+			name: "single sample",
+			base: []*Run{runOf("BM_A", 100)},
+			test: []*Run{runOf("BM_A", 200)},
+			want: Insufficient,
+		},
+		{
+			name: "missing",
+			base: []*Run{runOf("BM_A", 100, 100)},
+			test: []*Run{runOf("BM_B", 100, 100)},
+			want: Missing,
+		},
+	} {
+		t.Run(tc.name, func(t *testing.T) {
+			deltas := Compare(tc.base, tc.test, opts)
+			if len(deltas) == 0 {
+				t.Fatalf("Compare returned no deltas")
+			}
+			for _, d := range deltas {
+				if d.Verdict != tc.want {
+					t.Errorf("%v: got verdict %v (change %v, interval [%v, %v]), want %v", d.Key, d.Verdict, d.Change, d.Low, d.High, tc.want)
+				}
+			}
+		})
+	}
+}
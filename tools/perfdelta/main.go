@@ -0,0 +1,229 @@
+// Copyright 2020 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Binary perfdelta exports the results of the test/perf benchmarks and reports
+// the significant changes between two commits.
+//
+// Run the benchmarks several times at each commit, and export the logs:
+//
+//	bazel test --runs_per_test=10 //test/perf:getpid_benchmark_runsc_ptrace
+//	perfdelta export -commit=$(git rev-parse HEAD) \
+//	    $(find bazel-testlogs/test/perf/ -name test.log) > new.json
+//
+// Then compare them with the results exported at the base commit:
+//
+//	perfdelta compare -base=old.json -test=new.json
+//
+// The target, platform and overlay flag of each log are inferred from its
+// path in bazel-testlogs, and may be overridden with flags. compare exits with
+// status 1 if any benchmark regressed.
+package main
+
+import (
+	"encoding/json"
+	"flag"
+	"fmt"
+	"io/ioutil"
+	"os"
+	"strings"
+	"text/tabwriter"
+
+	"gvisor.dev/gvisor/tools/perfdelta/delta"
+)
+
+// fileList is a flag that may be given several times.
+type fileList []string
+
+// String implements flag.Value.String.
+func (l *fileList) String() string {
+	return strings.Join(*l, ",")
+}
+
+// Set implements flag.Value.Set.
+func (l *fileList) Set(v string) error {
+	*l = append(*l, v)
+	return nil
+}
+
+func usage() {
+	fmt.Fprintf(os.Stderr, "usage: %s export [flags] LOG...\n", os.Args[0])
+	fmt.Fprintf(os.Stderr, "       %s compare -base=FILE... -test=FILE... [flags]\n", os.Args[0])
+	os.Exit(2)
+}
+
+func main() {
+	if len(os.Args) < 2 {
+		usage()
+	}
+	switch os.Args[1] {
+	case "export":
+		export(os.Args[2:])
+	case "compare":
+		compare(os.Args[2:])
+	default:
+		usage()
+	}
+}
+
+// export parses the given test logs and writes their runs to stdout as JSON.
+func export(args []string) {
+	fs := flag.NewFlagSet("export", flag.ExitOnError)
+	commit := fs.String("commit", "", "commit the benchmarks were built at")
+	target := fs.String("target", "", "test target, if not inferred from the log path")
+	platform := fs.String("platform", "", "platform, if not inferred from the log path")
+	overlay := fs.Bool("overlay", false, "overlay flag, if not inferred from the log path")
+	fs.Parse(args)
+	if fs.NArg() == 0 {
+		fmt.Fprintf(os.Stderr, "no logs given\n")
+		os.Exit(2)
+	}
+
+	runs := make([]*delta.Run, 0, fs.NArg())
+	for _, path := range fs.Args() {
+		f, err := os.Open(path)
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "%v\n", err)
+			os.Exit(1)
+		}
+		results, err := delta.Parse(f)
+		f.Close()
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "%s: %v\n", path, err)
+			os.Exit(1)
+		}
+		if len(results) == 0 {
+			// Not a benchmark log, or a shard without benchmarks.
+			continue
+		}
+
+		run := &delta.Run{
+			Commit:  *commit,
+			Results: results,
+		}
+		run.Target, run.Platform, run.Overlay, _ = delta.InferTarget(path)
+		if *target != "" {
+			run.Target = *target
+		}
+		if *platform != "" {
+			run.Platform = *platform
+			run.Overlay = *overlay
+		}
+		if run.Platform == "" {
+			fmt.Fprintf(os.Stderr, "%s: can't infer the platform, use -platform\n", path)
+			os.Exit(2)
+		}
+		runs = append(runs, run)
+	}
+
+	enc := json.NewEncoder(os.Stdout)
+	enc.SetIndent("", "  ")
+	if err := enc.Encode(runs); err != nil {
+		fmt.Fprintf(os.Stderr, "%v\n", err)
+		os.Exit(1)
+	}
+}
+
+// load reads the runs exported to each of files.
+func load(files []string) []*delta.Run {
+	var runs []*delta.Run
+	for _, path := range files {
+		data, err := ioutil.ReadFile(path)
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "%v\n", err)
+			os.Exit(1)
+		}
+		var r []*delta.Run
+		if err := json.Unmarshal(data, &r); err != nil {
+			fmt.Fprintf(os.Stderr, "%s: %v\n", path, err)
+			os.Exit(1)
+		}
+		runs = append(runs, r...)
+	}
+	return runs
+}
+
+// commits returns the distinct commits of runs, for the report header.
+func commits(runs []*delta.Run) string {
+	var cs []string
+	seen := make(map[string]bool)
+	for _, run := range runs {
+		if !seen[run.Commit] {
+			seen[run.Commit] = true
+			cs = append(cs, run.Commit)
+		}
+	}
+	return strings.Join(cs, ",")
+}
+
+// compare compares the base and test runs and writes a report to stdout.
+func compare(args []string) {
+	fs := flag.NewFlagSet("compare", flag.ExitOnError)
+	var baseFiles, testFiles fileList
+	fs.Var(&baseFiles, "base", "exported runs of the base commit; may be repeated")
+	fs.Var(&testFiles, "test", "exported runs of the tested commit; may be repeated")
+	confidence := fs.Float64("confidence", 0.95, "confidence level of the intervals")
+	threshold := fs.Float64("threshold", 0.05, "smallest relative change to flag")
+	all := fs.Bool("all", false, "report all benchmarks, not only those that changed")
+	asJSON := fs.Bool("json", false, "write the report as JSON")
+	fs.Parse(args)
+	if len(baseFiles) == 0 || len(testFiles) == 0 {
+		usage()
+	}
+	if *confidence <= 0 || *confidence >= 1 {
+		fmt.Fprintf(os.Stderr, "-confidence must be in (0, 1)\n")
+		os.Exit(2)
+	}
+
+	base := load(baseFiles)
+	test := load(testFiles)
+	deltas := delta.Compare(base, test, delta.Options{
+		Confidence: *confidence,
+		Threshold:  *threshold,
+	})
+
+	regressed := false
+	var reported []delta.Delta
+	for _, d := range deltas {
+		if d.Verdict == delta.Regression {
+			regressed = true
+		}
+		if *all || d.Verdict != delta.Unchanged {
+			reported = append(reported, d)
+		}
+	}
+
+	if *asJSON {
+		enc := json.NewEncoder(os.Stdout)
+		enc.SetIndent("", "  ")
+		if err := enc.Encode(reported); err != nil {
+			fmt.Fprintf(os.Stderr, "%v\n", err)
+			os.Exit(1)
+		}
+	} else {
+		fmt.Printf("base: %s\ntest: %s\n", commits(base), commits(test))
+		fmt.Printf("%d benchmarks, %.0f%% confidence intervals, threshold %.1f%%\n\n", len(deltas), *confidence*100, *threshold*100)
+		w := tabwriter.NewWriter(os.Stdout, 0, 8, 2, ' ', 0)
+		fmt.Fprintf(w, "target\tbenchmark\tbase (ns)\ttest (ns)\tdelta\tinterval\t\n")
+		for _, d := range reported {
+			fmt.Fprintf(w, "%s\t%s\t%.1f (n=%d)\t%.1f (n=%d)\t%+.1f%%\t[%+.1f%%, %+.1f%%]\t%v\n",
+				d.Target, d.Name, d.Base.Mean, d.Base.N, d.Test.Mean, d.Test.N,
+				d.Change*100, d.Low*100, d.High*100, d.Verdict)
+		}
+		w.Flush()
+	}
+
+	if regressed {
+		os.Exit(1)
+	}
+}
@@ -116,7 +116,8 @@ def _vm_test_impl(ctx):
         "export ZONE=$(%s)" % ctx.files.zone[0].short_path,
         "export USERNAME=%s" % ctx.attr.username,
         "export IMAGE=$(%s)" % ctx.files.image[0].short_path,
-        "export SUDO=%s" % "true" if ctx.attr.sudo else "false",
+        "export MACHINE=%s" % ctx.attr.machine,
+        "export SUDO=%s" % ("true" if ctx.attr.sudo else "false"),
         "%s %s" % (
             ctx.executable.executer.short_path,
             " ".join([
@@ -28,6 +28,9 @@ inline void memory_barrier(void) {
 inline void read_barrier(void) { barrier(); }
 inline void write_barrier(void) { barrier(); }
 
+// Hint to the CPU that this is a spin loop.
+inline void cpu_relax(void) { __asm__ __volatile__("pause" ::: "memory"); }
+
 #elif __aarch64__
 
 inline void memory_barrier(void) {
@@ -40,6 +43,9 @@ inline void write_barrier(void) {
   __asm__ __volatile__("dmb ishst" ::: "memory");
 }
 
+// Hint to the CPU that this is a spin loop.
+inline void cpu_relax(void) { __asm__ __volatile__("yield" ::: "memory"); }
+
 #else
 #error "unsupported architecture"
 #endif
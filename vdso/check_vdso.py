@@ -184,6 +184,107 @@ def CheckRelocs(vdso_path):
     Fatal("VDSO contains relocations: %s", output)
 
 
+# Functions that the VDSO must export, by readelf machine name. These must be
+# kept in sync with the VERSION sections of vdso_amd64.lds and vdso_arm64.lds.
+_EXPORTS = {
+    "Advanced Micro Devices X86-64": [
+        "__kernel_rt_sigreturn",
+        "__vdso_clock_getres",
+        "__vdso_clock_gettime",
+        "__vdso_clock_nanosleep",
+        "__vdso_clock_snapshot",
+        "__vdso_get_nprocs",
+        "__vdso_getcpu",
+        "__vdso_gettimeofday",
+        "__vdso_nanosleep",
+        "__vdso_sched_yield",
+        "__vdso_time",
+        "clock_getres",
+        "clock_gettime",
+        "getcpu",
+        "gettimeofday",
+        "time",
+    ],
+    "AArch64": [
+        "__kernel_clock_getres",
+        "__kernel_clock_gettime",
+        "__kernel_clock_nanosleep",
+        "__kernel_clock_snapshot",
+        "__kernel_get_nprocs",
+        "__kernel_gettimeofday",
+        "__kernel_nanosleep",
+        "__kernel_rt_sigreturn",
+        "__kernel_sched_yield",
+    ],
+}
+
+# Version of the exported functions, by readelf machine name. libc looks up
+# VDSO functions by these versions, as defined by the Linux VDSO of each
+# architecture.
+_VERSIONS = {
+    "Advanced Micro Devices X86-64": "LINUX_2.6",
+    "AArch64": "LINUX_2.6.39",
+}
+
+
+def CheckExports(vdso_path):
+  """Verifies that the VDSO exports the expected functions and versions.
+
+  The readelf line format looks like:
+
+  Symbol table '.dynsym' contains 11 entries:
+     Num:    Value          Size Type    Bind   Vis      Ndx Name
+       0: 0000000000000000     0 NOTYPE  LOCAL  DEFAULT  UND
+       1: ffffffffff701010    56 FUNC    WEAK   DEFAULT   10 clock_gettime@@LINUX_2.6
+
+  Args:
+    vdso_path: Path to VDSO binary.
+  """
+  output = subprocess.check_output(["readelf", "-hW", vdso_path]).decode()
+  m = re.search(r"^\s*Machine:\s+(.*?)\s*$", output, re.MULTILINE)
+  if not m:
+    Fatal("Unable to determine VDSO machine:\n%s" % output)
+  expected = _EXPORTS.get(m.group(1))
+  if expected is None:
+    Fatal("Unknown VDSO machine: %s", m.group(1))
+  version = _VERSIONS[m.group(1)]
+
+  output = subprocess.check_output(["readelf", "--dyn-syms", "-W",
+                                    vdso_path]).decode()
+  exported = set()
+  for line in output.split("\n"):
+    components = line.split()
+    if len(components) != 8 or components[3] != "FUNC":
+      continue
+    if components[6] == "UND":
+      continue
+    # Only the default version (@@) is found by unversioned lookups.
+    name, _, sym_version = components[7].partition("@@")
+    if sym_version == version:
+      exported.add(name)
+
+  missing = [name for name in expected if name not in exported]
+  if missing:
+    Fatal("VDSO does not export %s with version %s:\n%s", missing, version,
+          output)
+
+
+def CheckHash(vdso_path):
+  """Verifies that the VDSO has both GNU and SysV symbol hash tables.
+
+  Dynamic linkers that support it look up symbols with the GNU hash table,
+  which is faster, while older ones (and some language runtimes that parse the
+  VDSO themselves) only understand the SysV hash table.
+
+  Args:
+    vdso_path: Path to VDSO binary.
+  """
+  output = subprocess.check_output(["readelf", "-dW", vdso_path]).decode()
+  for tag in ("(HASH)", "(GNU_HASH)", "(VERSYM)", "(VERDEF)"):
+    if tag not in output:
+      Fatal("VDSO dynamic section has no %s entry:\n%s", tag, output)
+
+
 def main():
   parser = argparse.ArgumentParser(description="Verify VDSO ELF.")
   parser.add_argument("--vdso", required=True, help="Path to VDSO ELF")
@@ -195,6 +296,8 @@ def main():
 
   CheckSegments(args.vdso)
   CheckRelocs(args.vdso)
+  CheckExports(args.vdso)
+  CheckHash(args.vdso)
 
   if args.check_data:
     CheckData(args.vdso)
@@ -23,20 +23,55 @@ namespace vdso {
 
 #if __x86_64__
 
-// TODO(b/74613497): The appropriate barrier instruction to use with rdtsc on
-// x86_64 depends on the vendor. Intel processors can use lfence but AMD may
-// need mfence, depending on MSR_F10H_DECFG_LFENCE_SERIALIZE_BIT.
+// The appropriate way to order rdtsc with respect to prior loads depends on
+// the CPU. The sandbox kernel selects one of the implementations below in
+// params.cycle_clock_mode, which is passed to cycle_clock().
+//
+// These must be kept in sync with vdsoCycleClock* in
+// pkg/sentry/kernel/vdso_amd64.go.
+const uint64_t kCycleClockLFence = 0;
+const uint64_t kCycleClockMFence = 1;
+const uint64_t kCycleClockRDTSCP = 2;
 
-static inline uint64_t cycle_clock(void) {
+// lfence is sufficient on Intel, and on AMD where Linux sets
+// MSR_F10H_DECFG_LFENCE_SERIALIZE_BIT.
+static inline uint64_t cycle_clock_lfence(void) {
   uint32_t lo, hi;
   asm volatile("lfence" : : : "memory");
   asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
   return ((uint64_t)hi << 32) | lo;
 }
 
+static inline uint64_t cycle_clock_mfence(void) {
+  uint32_t lo, hi;
+  asm volatile("mfence" : : : "memory");
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+// rdtscp waits until all previous instructions have executed, so it needs no
+// separate fence.
+static inline uint64_t cycle_clock_rdtscp(void) {
+  uint32_t lo, hi, aux;
+  asm volatile("rdtscp" : "=a"(lo), "=d"(hi), "=c"(aux) : : "memory");
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static inline uint64_t cycle_clock(uint64_t mode) {
+  switch (mode) {
+    case kCycleClockRDTSCP:
+      return cycle_clock_rdtscp();
+    case kCycleClockMFence:
+      return cycle_clock_mfence();
+    default:
+      return cycle_clock_lfence();
+  }
+}
+
 #elif __aarch64__
 
-static inline uint64_t cycle_clock(void) {
+// There is only one implementation on arm64; mode is ignored.
+static inline uint64_t cycle_clock(uint64_t mode) {
   uint64_t val;
   asm volatile("mrs %0, CNTVCT_EL0" : "=r"(val)::"memory");
   return val;
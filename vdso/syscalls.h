@@ -14,8 +14,8 @@
 
 // System call support for the VDSO.
 //
-// Provides fallback system call interfaces for getcpu()
-// and clock_gettime().
+// Provides fallback system call interfaces for getcpu(), clock_gettime(),
+// clock_getres(), nanosleep() and clock_nanosleep().
 
 #ifndef VDSO_SYSCALLS_H_
 #define VDSO_SYSCALLS_H_
@@ -44,6 +44,43 @@ static inline int sys_clock_gettime(clockid_t clock, struct timespec* ts) {
   return num;
 }
 
+static inline int sys_clock_getres(clockid_t clock, struct timespec* ts) {
+  int num = __NR_clock_getres;
+  asm volatile("syscall\n"
+               : "+a"(num)
+               : "D"(clock), "S"(ts)
+               : "rcx", "r11", "memory");
+  return num;
+}
+
+static inline int sys_nanosleep(const struct timespec* req,
+                                struct timespec* rem) {
+  int num = __NR_nanosleep;
+  asm volatile("syscall\n"
+               : "+a"(num)
+               : "D"(req), "S"(rem)
+               : "rcx", "r11", "memory");
+  return num;
+}
+
+static inline int sys_clock_nanosleep(clockid_t clock, int flags,
+                                      const struct timespec* req,
+                                      struct timespec* rem) {
+  int num = __NR_clock_nanosleep;
+  register struct timespec* r10 asm("r10") = rem;
+  asm volatile("syscall\n"
+               : "+a"(num)
+               : "D"(clock), "S"(flags), "d"(req), "r"(r10)
+               : "rcx", "r11", "memory");
+  return num;
+}
+
+static inline int sys_sched_yield(void) {
+  int num = __NR_sched_yield;
+  asm volatile("syscall\n" : "+a"(num) : : "rcx", "r11", "memory");
+  return num;
+}
+
 static inline int sys_getcpu(unsigned* cpu, unsigned* node,
                              struct getcpu_cache* cache) {
   int num = __NR_getcpu;
@@ -87,6 +124,45 @@ static inline int sys_clock_getres(clockid_t _clkid, struct timespec* _ts) {
   return ret;
 }
 
+static inline int sys_nanosleep(const struct timespec* _req,
+                                struct timespec* _rem) {
+  register struct timespec* rem asm("x1") = _rem;
+  register const struct timespec* req asm("x0") = _req;
+  register long ret asm("x0");
+  register long nr asm("x8") = __NR_nanosleep;
+
+  asm volatile("svc #0\n"
+               : "=r"(ret)
+               : "r"(req), "r"(rem), "r"(nr)
+               : "memory");
+  return ret;
+}
+
+static inline int sys_clock_nanosleep(clockid_t _clkid, int _flags,
+                                      const struct timespec* _req,
+                                      struct timespec* _rem) {
+  register struct timespec* rem asm("x3") = _rem;
+  register const struct timespec* req asm("x2") = _req;
+  register int flags asm("x1") = _flags;
+  register clockid_t clkid asm("x0") = _clkid;
+  register long ret asm("x0");
+  register long nr asm("x8") = __NR_clock_nanosleep;
+
+  asm volatile("svc #0\n"
+               : "=r"(ret)
+               : "r"(clkid), "r"(flags), "r"(req), "r"(rem), "r"(nr)
+               : "memory");
+  return ret;
+}
+
+static inline int sys_sched_yield(void) {
+  register long ret asm("x0");
+  register long nr asm("x8") = __NR_sched_yield;
+
+  asm volatile("svc #0\n" : "=r"(ret) : "r"(nr) : "memory");
+  return ret;
+}
+
 static inline void sys_rt_sigreturn(void) {
   asm volatile("mov x8, #" __stringify(__NR_rt_sigreturn)" \n"
                "svc #0 \n");
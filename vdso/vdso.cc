@@ -16,37 +16,106 @@
 // points to the VDSO. All of the real work is done in vdso_time.cc
 
 #define _DEFAULT_SOURCE  // ensure glibc provides struct timezone.
+#include <stdint.h>
 #include <sys/time.h>
 #include <time.h>
 
 #include "vdso/syscalls.h"
 #include "vdso/vdso_time.h"
 
+// struct vdso_clock_snapshot is filled by __vdso_clock_snapshot (amd64) and
+// __kernel_clock_snapshot (arm64), which are gVisor extensions.
+//
+// realtime and monotonic are the values of CLOCK_REALTIME and CLOCK_MONOTONIC
+// at the same instant. cycles is the raw cycle counter (TSC on amd64,
+// CNTVCT_EL0 on arm64) read at that instant. If the sandbox kernel has not
+// yet calibrated its clocks, realtime and monotonic are read separately.
+//
+// This ABI must not change.
+struct vdso_clock_snapshot {
+  struct timespec realtime;
+  struct timespec monotonic;
+  uint64_t cycles;
+};
+
 namespace vdso {
 namespace {
 
 int __common_clock_gettime(clockid_t clock, struct timespec* ts) {
   int ret;
 
+  // The coarse clocks are served by the same (cheap) paths as their precise
+  // counterparts, as in the sandbox kernel. See getClock in
+  // pkg/sentry/syscalls/linux/sys_time.go.
   switch (clock) {
     case CLOCK_REALTIME:
+    case CLOCK_REALTIME_COARSE:
+    case CLOCK_TAI:
+      // CLOCK_TAI is an alias for CLOCK_REALTIME, as the TAI offset is
+      // always zero.
       ret = ClockRealtime(ts);
       break;
 
-    case CLOCK_BOOTTIME:
-      // Fallthrough, CLOCK_BOOTTIME is an alias for CLOCK_MONOTONIC
     case CLOCK_MONOTONIC:
+    case CLOCK_MONOTONIC_COARSE:
+    case CLOCK_MONOTONIC_RAW:
       ret = ClockMonotonic(ts);
       break;
 
+    case CLOCK_BOOTTIME:
+      ret = ClockBoottime(ts);
+      break;
+
+    case CLOCK_THREAD_CPUTIME_ID:
+      ret = ClockThreadCPUTime(clock, ts);
+      break;
+
     default:
-      ret = sys_clock_gettime(clock, ts);
+      if (clock < 0) {
+        // Dynamic CPU clocks, e.g. from pthread_getcpuclockid(3).
+        ret = ClockThreadCPUTime(clock, ts);
+      } else {
+        ret = sys_clock_gettime(clock, ts);
+      }
       break;
   }
 
   return ret;
 }
 
+int __common_clock_getres(clockid_t clock, struct timespec* res) {
+  int ret = 0;
+
+  switch (clock) {
+    case CLOCK_REALTIME:
+    case CLOCK_REALTIME_COARSE:
+    case CLOCK_TAI:
+    case CLOCK_MONOTONIC:
+    case CLOCK_MONOTONIC_COARSE:
+    case CLOCK_MONOTONIC_RAW:
+    case CLOCK_BOOTTIME: {
+      if (res == nullptr) {
+        return 0;
+      }
+
+      res->tv_sec = 0;
+      res->tv_nsec = 1;
+      break;
+    }
+
+    default:
+      ret = sys_clock_getres(clock, res);
+      break;
+  }
+
+  return ret;
+}
+
+int __common_clock_snapshot(struct vdso_clock_snapshot* snapshot) {
+  return ClockSnapshot(&snapshot->realtime, &snapshot->monotonic,
+                       &snapshot->cycles);
+}
+
 int __common_gettimeofday(struct timeval* tv, struct timezone* tz) {
   if (tv) {
     struct timespec ts;
@@ -71,7 +140,8 @@ int __common_gettimeofday(struct timeval* tv, struct timezone* tz) {
 
 // __kernel_rt_sigreturn() implements rt_sigreturn()
 extern "C" void __kernel_rt_sigreturn(unsigned long unused) {
-  // No optimizations yet, just make the real system call.
+  // The sandbox kernel must restore the full register state from the signal
+  // frame, so this always makes the real system call.
   sys_rt_sigreturn();
 }
 
@@ -84,6 +154,46 @@ extern "C" int __vdso_clock_gettime(clockid_t clock, struct timespec* ts) {
 extern "C" int clock_gettime(clockid_t clock, struct timespec* ts)
     __attribute__((weak, alias("__vdso_clock_gettime")));
 
+// __vdso_clock_getres() implements clock_getres()
+extern "C" int __vdso_clock_getres(clockid_t clock, struct timespec* res) {
+  return __common_clock_getres(clock, res);
+}
+extern "C" int clock_getres(clockid_t clock, struct timespec* res)
+    __attribute__((weak, alias("__vdso_clock_getres")));
+
+// __vdso_clock_snapshot() reads CLOCK_REALTIME, CLOCK_MONOTONIC and the cycle
+// counter at the same instant.
+extern "C" int __vdso_clock_snapshot(struct vdso_clock_snapshot* snapshot) {
+  return __common_clock_snapshot(snapshot);
+}
+
+// __vdso_clock_nanosleep() implements clock_nanosleep(), returning a negated
+// errno on failure like the system call. It spins for short sleeps if enabled
+// by the sandbox kernel.
+extern "C" int __vdso_clock_nanosleep(clockid_t clock, int flags,
+                                      const struct timespec* req,
+                                      struct timespec* rem) {
+  return ClockNanosleep(clock, flags, req, rem);
+}
+
+// __vdso_nanosleep() implements nanosleep(), returning a negated errno on
+// failure like the system call. It spins for short sleeps if enabled by the
+// sandbox kernel.
+extern "C" int __vdso_nanosleep(const struct timespec* req,
+                                struct timespec* rem) {
+  return Nanosleep(req, rem);
+}
+
+// __vdso_sched_yield() implements sched_yield(), returning a negated errno on
+// failure like the system call. It returns immediately, without trapping to
+// the sandbox kernel, if no task is waiting to run.
+extern "C" int __vdso_sched_yield() { return SchedYield(); }
+
+// __vdso_get_nprocs() returns the number of CPUs available to applications,
+// as returned by get_nprocs(3) and sysconf(_SC_NPROCESSORS_ONLN), or a
+// negated errno on failure.
+extern "C" int __vdso_get_nprocs() { return GetNprocs(); }
+
 // __vdso_gettimeofday() implements gettimeofday()
 extern "C" int __vdso_gettimeofday(struct timeval* tv, struct timezone* tz) {
   return __common_gettimeofday(tv, tz);
@@ -105,8 +215,7 @@ extern "C" time_t time(time_t* t) __attribute__((weak, alias("__vdso_time")));
 // __vdso_getcpu() implements getcpu()
 extern "C" long __vdso_getcpu(unsigned* cpu, unsigned* node,
                               struct getcpu_cache* cache) {
-  // No optimizations yet, just make the real system call.
-  return sys_getcpu(cpu, node, cache);
+  return GetCPU(cpu, node, cache);
 }
 extern "C" long getcpu(unsigned* cpu, unsigned* node,
                        struct getcpu_cache* cache)
@@ -119,6 +228,39 @@ extern "C" int __kernel_clock_gettime(clockid_t clock, struct timespec* ts) {
   return __common_clock_gettime(clock, ts);
 }
 
+// __kernel_clock_snapshot() reads CLOCK_REALTIME, CLOCK_MONOTONIC and the
+// cycle counter at the same instant.
+extern "C" int __kernel_clock_snapshot(struct vdso_clock_snapshot* snapshot) {
+  return __common_clock_snapshot(snapshot);
+}
+
+// __kernel_clock_nanosleep() implements clock_nanosleep(), returning a
+// negated errno on failure like the system call. It spins for short sleeps if
+// enabled by the sandbox kernel.
+extern "C" int __kernel_clock_nanosleep(clockid_t clock, int flags,
+                                        const struct timespec* req,
+                                        struct timespec* rem) {
+  return ClockNanosleep(clock, flags, req, rem);
+}
+
+// __kernel_nanosleep() implements nanosleep(), returning a negated errno on
+// failure like the system call. It spins for short sleeps if enabled by the
+// sandbox kernel.
+extern "C" int __kernel_nanosleep(const struct timespec* req,
+                                  struct timespec* rem) {
+  return Nanosleep(req, rem);
+}
+
+// __kernel_sched_yield() implements sched_yield(), returning a negated errno
+// on failure like the system call. It returns immediately, without trapping to
+// the sandbox kernel, if no task is waiting to run.
+extern "C" int __kernel_sched_yield() { return SchedYield(); }
+
+// __kernel_get_nprocs() returns the number of CPUs available to applications,
+// as returned by get_nprocs(3) and sysconf(_SC_NPROCESSORS_ONLN), or a
+// negated errno on failure.
+extern "C" int __kernel_get_nprocs() { return GetNprocs(); }
+
 // __kernel_gettimeofday() implements gettimeofday()
 extern "C" int __kernel_gettimeofday(struct timeval* tv, struct timezone* tz) {
   return __common_gettimeofday(tv, tz);
@@ -126,27 +268,7 @@ extern "C" int __kernel_gettimeofday(struct timeval* tv, struct timezone* tz) {
 
 // __kernel_clock_getres() implements clock_getres()
 extern "C" int __kernel_clock_getres(clockid_t clock, struct timespec* res) {
-  int ret = 0;
-
-  switch (clock) {
-    case CLOCK_REALTIME:
-    case CLOCK_MONOTONIC:
-    case CLOCK_BOOTTIME: {
-      if (res == nullptr) {
-        return 0;
-      }
-
-      res->tv_sec = 0;
-      res->tv_nsec = 1;
-      break;
-    }
-
-    default:
-      ret = sys_clock_getres(clock, res);
-      break;
-  }
-
-  return ret;
+  return __common_clock_getres(clock, res);
 }
 
 #else
@@ -14,6 +14,7 @@
 
 #include "vdso/vdso_time.h"
 
+#include <stddef.h>
 #include <stdint.h>
 #include <sys/time.h>
 #include <time.h>
@@ -28,21 +29,113 @@
 // This is similar to the VVAR page maintained by the normal Linux kernel for
 // its VDSO, but it has a different layout.
 //
+// The page is split into sections, each with its own sequence counter and on
+// its own cache line, so that an update to one clock does not invalidate the
+// cache lines read by users of the other.
+//
 // It must be kept in sync with VDSOParamPage in pkg/sentry/kernel/vdso.go.
-struct params {
+struct flags_params {
   uint64_t seq_count;
 
-  uint64_t monotonic_ready;
-  int64_t monotonic_base_cycles;
-  int64_t monotonic_base_ref;
-  uint64_t monotonic_frequency;
+  uint64_t getcpu_mode;
+  uint64_t getcpu_cpu;
 
-  uint64_t realtime_ready;
-  int64_t realtime_base_cycles;
-  int64_t realtime_base_ref;
-  uint64_t realtime_frequency;
+  uint64_t cycle_clock_mode;
+
+  uint64_t spin_sleep_max_ns;
+} __attribute__((aligned(64)));
+
+struct clock_params {
+  uint64_t seq_count;
+
+  uint64_t ready;
+  int64_t base_cycles;
+  int64_t base_ref;
+  uint64_t mult;
+  uint64_t shift;
+} __attribute__((aligned(64)));
+
+// sched_params.contended is a single word, so seq_count is unused.
+struct sched_params {
+  uint64_t seq_count;
+
+  uint64_t contended;
+} __attribute__((aligned(64)));
+
+// info_params is system information that is the same for all tasks.
+struct info_params {
+  uint64_t seq_count;
+
+  uint64_t cpus;
+
+  // thread_clock_epoch changes whenever the sandbox kernel is restored,
+  // invalidating all thread_clock records. It is 0 if the sandbox kernel does
+  // not publish thread_clock records.
+  uint64_t thread_clock_epoch;
+} __attribute__((aligned(64)));
+
+// timens_params are the offsets of the sandbox's CLOCK_MONOTONIC and
+// CLOCK_BOOTTIME from the monotonic clock described by params.monotonic, as
+// with the clock offsets of a Linux time namespace. They keep both clocks
+// continuous across save/restore. They only change while no tasks are running
+// (when the clocks are set), so seq_count is unused.
+struct timens_params {
+  uint64_t seq_count;
+
+  int64_t monotonic_offset;
+  int64_t boottime_offset;
+} __attribute__((aligned(64)));
+
+struct params {
+  struct flags_params flags;
+  struct clock_params monotonic;
+  struct clock_params realtime;
+  struct sched_params sched;
+  struct info_params info;
+  struct timens_params timens;
 };
 
+static_assert(offsetof(struct params, monotonic) == 64,
+              "params.monotonic must be on its own cache line");
+static_assert(offsetof(struct params, realtime) == 128,
+              "params.realtime must be on its own cache line");
+static_assert(offsetof(struct params, sched) == 192,
+              "params.sched must be on its own cache line");
+static_assert(offsetof(struct params, info) == 256,
+              "params.info must be on its own cache line");
+static_assert(offsetof(struct params, timens) == 320,
+              "params.timens must be on its own cache line");
+
+// struct thread_clock is a record of the CPU clock of one thread, which the
+// sandbox kernel maintains in the per-process page mapped just before the
+// parameter page.
+//
+// Each thread's record is found by its thread pointer, which the sandbox kernel
+// publishes in tls when it writes the record. A record is only written while
+// the thread it describes is executing in the sandbox kernel, so it needs no
+// sequence counter.
+//
+// It must be kept in sync with vdsoThreadClock in
+// pkg/sentry/kernel/vdso_thread_clock.go.
+struct thread_clock {
+  uint64_t tls;
+  uint64_t tid;
+  uint64_t epoch;
+
+  // The thread's CPU time was base_ns at base_cycles, and has advanced with
+  // the cycle counter since.
+  int64_t base_ns;
+  int64_t base_cycles;
+  uint64_t mult;
+  uint64_t shift;
+} __attribute__((aligned(64)));
+
+// kThreadClocks is the number of thread_clock records in the page.
+const int kThreadClocks = 4096 / sizeof(struct thread_clock);
+
+// kThreadClockProbes is the number of records that may hold a thread's clock.
+const int kThreadClockProbes = 4;
+
 // Returns a pointer to the global parameter page.
 //
 // This page lives in the page just before the VDSO binary itself. The linker
@@ -55,7 +148,19 @@ struct params {
 //
 // So instead, we use inline assembly with a construct that seems to have wide
 // compatibility across many toolchains.
-#if __x86_64__
+//
+// Test builds (see :vdso_time_for_test) run outside of the VDSO, and are given
+// the parameter page by SetParamsForTest instead.
+#if defined(VDSO_TEST_BUILD)
+
+static struct params* test_params = nullptr;
+static struct thread_clock* test_thread_clocks = nullptr;
+
+inline struct params* get_params() { return test_params; }
+
+inline struct thread_clock* get_thread_clocks() { return test_thread_clocks; }
+
+#elif __x86_64__
 
 inline struct params* get_params() {
   struct params* p = nullptr;
@@ -63,6 +168,12 @@ inline struct params* get_params() {
   return p;
 }
 
+inline struct thread_clock* get_thread_clocks() {
+  struct thread_clock* p = nullptr;
+  asm("leaq _thread_clocks(%%rip), %0" : "=r"(p) : :);
+  return p;
+}
+
 #elif __aarch64__
 
 inline struct params* get_params() {
@@ -71,6 +182,12 @@ inline struct params* get_params() {
   return p;
 }
 
+inline struct thread_clock* get_thread_clocks() {
+  struct thread_clock* p = nullptr;
+  asm("adr %0, _thread_clocks" : "=r"(p) : :);
+  return p;
+}
+
 #else
 #error "unsupported architecture"
 #endif
@@ -79,6 +196,43 @@ namespace vdso {
 
 const uint64_t kNsecsPerSec = 1000000000UL;
 
+// Possible values of params.getcpu_mode.
+//
+// These must be kept in sync with vdsoGetcpu* in pkg/sentry/kernel/vdso.go.
+const uint64_t kGetcpuSyscall = 0;
+const uint64_t kGetcpuFixed = 1;
+const uint64_t kGetcpuTSCAux = 2;
+
+#if defined(VDSO_TEST_BUILD)
+
+// seqcount_retries counts the read_seqcount_retry loops of this thread.
+static thread_local uint64_t seqcount_retries = 0;
+
+void SetParamsForTest(const void* params) {
+  test_params = static_cast<struct params*>(const_cast<void*>(params));
+}
+
+void SetThreadClocksForTest(const void* thread_clocks) {
+  test_thread_clocks = static_cast<struct thread_clock*>(
+      const_cast<void*>(thread_clocks));
+}
+
+uint64_t SeqcountRetriesForTest() { return seqcount_retries; }
+
+#endif  // VDSO_TEST_BUILD
+
+// seqcount_retry is read_seqcount_retry, which also counts retries in test
+// builds.
+inline int seqcount_retry(const uint64_t* s, uint64_t seq) {
+  int retry = read_seqcount_retry(s, seq);
+#if defined(VDSO_TEST_BUILD)
+  if (retry) {
+    seqcount_retries++;
+  }
+#endif
+  return retry;
+}
+
 inline struct timespec ns_to_timespec(uint64_t ns) {
   struct timespec ts;
   ts.tv_sec = ns / kNsecsPerSec;
@@ -86,74 +240,442 @@ inline struct timespec ns_to_timespec(uint64_t ns) {
   return ts;
 }
 
-inline uint64_t cycles_to_ns(uint64_t frequency, uint64_t cycles) {
-  uint64_t mult = (kNsecsPerSec << 32) / frequency;
-  return ((unsigned __int128)cycles * mult) >> 32;
+// cycles_to_ns converts cycles to nanoseconds using the multiplier and shift
+// precomputed by the sandbox kernel, avoiding a division on every clock read.
+inline uint64_t cycles_to_ns(uint64_t mult, uint64_t shift, uint64_t cycles) {
+  return ((unsigned __int128)cycles * mult) >> shift;
 }
 
-// ClockRealtime() is the VDSO implementation of clock_gettime(CLOCK_REALTIME).
-int ClockRealtime(struct timespec* ts) {
-  struct params* params = get_params();
+// cycle_clock_mode returns the cycle clock implementation selected by the
+// sandbox kernel.
+//
+// The mode is only changed while no tasks are running (when the clocks are
+// set), so it is read outside of the flags seqcount.
+inline uint64_t cycle_clock_mode(struct params* params) {
+  return params->flags.cycle_clock_mode;
+}
+
+// clock_ns() sets now_ns to the time of the clock described by clock, plus
+// offset, and returns false if the clock is not ready.
+inline bool clock_ns(struct params* params, struct clock_params* clock,
+                     int64_t offset, int64_t* now_ns) {
+  uint64_t mode = cycle_clock_mode(params);
   uint64_t seq;
   uint64_t ready;
   int64_t base_ref;
   int64_t base_cycles;
-  uint64_t frequency;
+  uint64_t mult;
+  uint64_t shift;
   int64_t now_cycles;
 
   do {
-    seq = read_seqcount_begin(&params->seq_count);
-    ready = params->realtime_ready;
-    base_ref = params->realtime_base_ref;
-    base_cycles = params->realtime_base_cycles;
-    frequency = params->realtime_frequency;
-    now_cycles = cycle_clock();
-  } while (read_seqcount_retry(&params->seq_count, seq));
+    seq = read_seqcount_begin(&clock->seq_count);
+    ready = clock->ready;
+    base_ref = clock->base_ref;
+    base_cycles = clock->base_cycles;
+    mult = clock->mult;
+    shift = clock->shift;
+    now_cycles = cycle_clock(mode);
+  } while (seqcount_retry(&clock->seq_count, seq));
 
   if (!ready) {
-    // The sandbox kernel ensures that we won't compute a time later than this
-    // once the params are ready.
-    return sys_clock_gettime(CLOCK_REALTIME, ts);
+    return false;
   }
 
   int64_t delta_cycles =
       (now_cycles < base_cycles) ? 0 : now_cycles - base_cycles;
-  int64_t now_ns = base_ref + cycles_to_ns(frequency, delta_cycles);
+  *now_ns = base_ref + cycles_to_ns(mult, shift, delta_cycles) + offset;
+  return true;
+}
+
+// clock_offset() returns the offset of clock_id from the clock described by
+// params.monotonic or params.realtime. See timens_params.
+inline int64_t clock_offset(struct params* params, clockid_t clock_id) {
+  switch (clock_id) {
+    case CLOCK_MONOTONIC:
+      return params->timens.monotonic_offset;
+    case CLOCK_BOOTTIME:
+      return params->timens.boottime_offset;
+    default:
+      return 0;
+  }
+}
+
+// read_clock() returns the time of clock_id, derived from the clock described
+// by clock, or falls back to the clock_gettime syscall for clock_id if the
+// clock is not ready.
+inline int read_clock(struct params* params, struct clock_params* clock,
+                      clockid_t clock_id, struct timespec* ts) {
+  int64_t now_ns;
+  if (!clock_ns(params, clock, clock_offset(params, clock_id), &now_ns)) {
+    // The sandbox kernel ensures that we won't compute a time later than this
+    // once the params are ready.
+    return sys_clock_gettime(clock_id, ts);
+  }
   *ts = ns_to_timespec(now_ns);
   return 0;
 }
 
+// ClockRealtime() is the VDSO implementation of clock_gettime(CLOCK_REALTIME).
+int ClockRealtime(struct timespec* ts) {
+  struct params* params = get_params();
+  return read_clock(params, &params->realtime, CLOCK_REALTIME, ts);
+}
+
 // ClockMonotonic() is the VDSO implementation of
 // clock_gettime(CLOCK_MONOTONIC).
 int ClockMonotonic(struct timespec* ts) {
   struct params* params = get_params();
-  uint64_t seq;
+  return read_clock(params, &params->monotonic, CLOCK_MONOTONIC, ts);
+}
+
+// ClockBoottime() is the VDSO implementation of clock_gettime(CLOCK_BOOTTIME).
+int ClockBoottime(struct timespec* ts) {
+  struct params* params = get_params();
+  return read_clock(params, &params->monotonic, CLOCK_BOOTTIME, ts);
+}
+
+// ClockSnapshot() reads CLOCK_REALTIME, CLOCK_MONOTONIC and the cycle counter
+// at a single instant: all three are derived from one cycle_clock() read in a
+// single seqcount read section.
+int ClockSnapshot(struct timespec* realtime, struct timespec* monotonic,
+                  uint64_t* cycles) {
+  struct params* params = get_params();
+  uint64_t mode = cycle_clock_mode(params);
+  uint64_t realtime_seq;
+  uint64_t monotonic_seq;
   uint64_t ready;
-  int64_t base_ref;
-  int64_t base_cycles;
-  uint64_t frequency;
+  int64_t realtime_base_ref;
+  int64_t realtime_base_cycles;
+  uint64_t realtime_mult;
+  uint64_t realtime_shift;
+  int64_t monotonic_base_ref;
+  int64_t monotonic_base_cycles;
+  uint64_t monotonic_mult;
+  uint64_t monotonic_shift;
   int64_t now_cycles;
 
+  // The sandbox kernel updates both clocks in overlapping write blocks, so
+  // checking both seqcounts after the reads gives a consistent snapshot.
   do {
-    seq = read_seqcount_begin(&params->seq_count);
-    ready = params->monotonic_ready;
-    base_ref = params->monotonic_base_ref;
-    base_cycles = params->monotonic_base_cycles;
-    frequency = params->monotonic_frequency;
-    now_cycles = cycle_clock();
-  } while (read_seqcount_retry(&params->seq_count, seq));
+    realtime_seq = read_seqcount_begin(&params->realtime.seq_count);
+    monotonic_seq = read_seqcount_begin(&params->monotonic.seq_count);
+    ready = params->realtime.ready && params->monotonic.ready;
+    realtime_base_ref = params->realtime.base_ref;
+    realtime_base_cycles = params->realtime.base_cycles;
+    realtime_mult = params->realtime.mult;
+    realtime_shift = params->realtime.shift;
+    monotonic_base_ref = params->monotonic.base_ref;
+    monotonic_base_cycles = params->monotonic.base_cycles;
+    monotonic_mult = params->monotonic.mult;
+    monotonic_shift = params->monotonic.shift;
+    now_cycles = cycle_clock(mode);
+  } while (seqcount_retry(&params->realtime.seq_count, realtime_seq) |
+           seqcount_retry(&params->monotonic.seq_count, monotonic_seq));
+
+  if (cycles) {
+    *cycles = now_cycles;
+  }
 
   if (!ready) {
-    // The sandbox kernel ensures that we won't compute a time later than this
-    // once the params are ready.
-    return sys_clock_gettime(CLOCK_MONOTONIC, ts);
+    // The clocks can't be read at the same instant, but they are still
+    // individually correct.
+    int ret = sys_clock_gettime(CLOCK_REALTIME, realtime);
+    if (ret) {
+      return ret;
+    }
+    return sys_clock_gettime(CLOCK_MONOTONIC, monotonic);
   }
 
-  int64_t delta_cycles =
-      (now_cycles < base_cycles) ? 0 : now_cycles - base_cycles;
-  int64_t now_ns = base_ref + cycles_to_ns(frequency, delta_cycles);
-  *ts = ns_to_timespec(now_ns);
+  int64_t delta_cycles = (now_cycles < realtime_base_cycles)
+                             ? 0
+                             : now_cycles - realtime_base_cycles;
+  int64_t now_ns = realtime_base_ref +
+                   cycles_to_ns(realtime_mult, realtime_shift, delta_cycles);
+  *realtime = ns_to_timespec(now_ns);
+
+  delta_cycles = (now_cycles < monotonic_base_cycles)
+                     ? 0
+                     : now_cycles - monotonic_base_cycles;
+  now_ns = monotonic_base_ref +
+           cycles_to_ns(monotonic_mult, monotonic_shift, delta_cycles) +
+           clock_offset(params, CLOCK_MONOTONIC);
+  *monotonic = ns_to_timespec(now_ns);
   return 0;
 }
 
+// thread_pointer returns the calling thread's thread pointer, which the psABI
+// of each architecture requires to be readable from user mode.
+inline uint64_t thread_pointer() {
+  uint64_t tp;
+#if __x86_64__
+  // The x86-64 TLS ABI stores the thread pointer at %fs:0.
+  asm volatile("movq %%fs:0, %0" : "=r"(tp));
+#elif __aarch64__
+  asm volatile("mrs %0, tpidr_el0" : "=r"(tp));
+#endif
+  return tp;
+}
+
+// thread_clock_slot returns the index of the probe'th record that may hold the
+// clock of the thread with thread pointer tls.
+//
+// It must be kept in sync with vdsoThreadClockSlot in
+// pkg/sentry/kernel/vdso_thread_clock.go.
+inline int thread_clock_slot(uint64_t tls, int probe) {
+  uint64_t hash = (tls >> 6) * 0x9e3779b97f4a7c15ULL;
+  return ((hash >> 58) + probe) & (kThreadClocks - 1);
+}
+
+// thread_clock_epoch returns the epoch of valid thread_clock records.
+inline uint64_t thread_clock_epoch(struct params* params) {
+  uint64_t seq;
+  uint64_t epoch;
+
+  do {
+    seq = read_seqcount_begin(&params->info.seq_count);
+    epoch = params->info.thread_clock_epoch;
+  } while (seqcount_retry(&params->info.seq_count, seq));
+
+  return epoch;
+}
+
+// is_own_thread_clock returns true if clock is the CPU clock of the thread
+// described by record.
+inline bool is_own_thread_clock(clockid_t clock, struct thread_clock* record) {
+  if (clock == CLOCK_THREAD_CPUTIME_ID) {
+    return true;
+  }
+  // A per-thread CPU clock, as returned by pthread_getcpuclockid(3), encodes
+  // the thread's ID. CPUCLOCK_VIRT (user time only) is not published.
+  const clockid_t kCPUClockPerThread = 4;
+  const clockid_t kCPUClockMask = 3;
+  const clockid_t kCPUClockVirt = 1;
+  if (clock >= 0 || (clock & kCPUClockPerThread) == 0 ||
+      (clock & kCPUClockMask) == kCPUClockVirt) {
+    return false;
+  }
+  pid_t tid = ~(clock >> 3);
+  return tid == 0 || static_cast<uint64_t>(tid) == record->tid;
+}
+
+// ClockThreadCPUTime() is the VDSO implementation of clock_gettime() for the
+// calling thread's CPU clock. It falls back to the system call if the sandbox
+// kernel has not published the thread's clock, which it starts doing when the
+// thread first reads the clock through the system call.
+int ClockThreadCPUTime(clockid_t clock, struct timespec* ts) {
+  struct params* params = get_params();
+  uint64_t epoch = thread_clock_epoch(params);
+
+  // The epoch is 0 unless the sandbox kernel publishes thread clocks, which it
+  // only does for applications that keep a thread pointer per thread.
+  if (epoch != 0) {
+    struct thread_clock* clocks = get_thread_clocks();
+    uint64_t tls = thread_pointer();
+    for (int probe = 0; tls != 0 && probe < kThreadClockProbes; probe++) {
+      struct thread_clock* record = &clocks[thread_clock_slot(tls, probe)];
+      if (record->tls != tls || record->epoch != epoch) {
+        continue;
+      }
+      if (!is_own_thread_clock(clock, record)) {
+        break;
+      }
+      int64_t now_cycles = cycle_clock(cycle_clock_mode(params));
+      int64_t delta_cycles = (now_cycles < record->base_cycles)
+                                 ? 0
+                                 : now_cycles - record->base_cycles;
+      *ts = ns_to_timespec(record->base_ns + cycles_to_ns(record->mult,
+                                                          record->shift,
+                                                          delta_cycles));
+      return 0;
+    }
+  }
+  return sys_clock_gettime(clock, ts);
+}
+
+// spin_sleep_max_ns returns the longest sleep that may be performed by
+// spinning, or 0 if sleeps must always trap to the sandbox kernel.
+inline uint64_t spin_sleep_max_ns(struct params* params) {
+  uint64_t seq;
+  uint64_t max_ns;
+
+  do {
+    seq = read_seqcount_begin(&params->flags.seq_count);
+    max_ns = params->flags.spin_sleep_max_ns;
+  } while (seqcount_retry(&params->flags.seq_count, seq));
+
+  return max_ns;
+}
+
+// spin_sleep() sleeps until clock reaches deadline_ns by spinning, or makes
+// the clock_nanosleep syscall for clock_id if the clock stops being ready.
+inline int spin_sleep(struct params* params, struct clock_params* clock,
+                      clockid_t clock_id, int64_t now_ns, int64_t deadline_ns,
+                      struct timespec* rem) {
+  int64_t offset = clock_offset(params, clock_id);
+  while (now_ns < deadline_ns) {
+    cpu_relax();
+    if (!clock_ns(params, clock, offset, &now_ns)) {
+      struct timespec deadline = ns_to_timespec(deadline_ns);
+      return sys_clock_nanosleep(clock_id, TIMER_ABSTIME, &deadline, rem);
+    }
+  }
+  return 0;
+}
+
+// timespec_to_ns() converts ts to nanoseconds. It returns false if ts is not
+// a valid timespec, or is too large to be represented.
+inline bool timespec_to_ns(const struct timespec* ts, int64_t* ns) {
+  if (ts == nullptr || ts->tv_sec < 0 || ts->tv_nsec < 0 ||
+      ts->tv_nsec >= static_cast<long>(kNsecsPerSec) ||
+      ts->tv_sec >= static_cast<time_t>(INT64_MAX / kNsecsPerSec)) {
+    return false;
+  }
+  *ns = ts->tv_sec * kNsecsPerSec + ts->tv_nsec;
+  return true;
+}
+
+// ClockNanosleep() is the VDSO implementation of clock_nanosleep(2).
+//
+// If the sandbox kernel allows it, short sleeps on CLOCK_REALTIME and
+// CLOCK_MONOTONIC are performed by spinning on the clock rather than by
+// trapping to the sandbox kernel. Signal handlers still run during a spinning
+// sleep, but they don't interrupt it.
+int ClockNanosleep(clockid_t clock_id, int flags, const struct timespec* req,
+                   struct timespec* rem) {
+  struct params* params = get_params();
+  struct clock_params* clock;
+  switch (clock_id) {
+    case CLOCK_REALTIME:
+      clock = &params->realtime;
+      break;
+    case CLOCK_MONOTONIC:
+      clock = &params->monotonic;
+      break;
+    default:
+      return sys_clock_nanosleep(clock_id, flags, req, rem);
+  }
+
+  // Leave invalid and long requests to the sandbox kernel.
+  uint64_t max_ns = spin_sleep_max_ns(params);
+  int64_t req_ns;
+  int64_t now_ns;
+  if (max_ns == 0 || !timespec_to_ns(req, &req_ns) ||
+      !clock_ns(params, clock, clock_offset(params, clock_id), &now_ns)) {
+    return sys_clock_nanosleep(clock_id, flags, req, rem);
+  }
+
+  int64_t deadline_ns;
+  if (flags & TIMER_ABSTIME) {
+    deadline_ns = req_ns;
+  } else if (req_ns <= static_cast<int64_t>(max_ns)) {
+    deadline_ns = now_ns + req_ns;
+  } else {
+    return sys_clock_nanosleep(clock_id, flags, req, rem);
+  }
+  if (deadline_ns - now_ns > static_cast<int64_t>(max_ns)) {
+    return sys_clock_nanosleep(clock_id, flags, req, rem);
+  }
+
+  return spin_sleep(params, clock, clock_id, now_ns, deadline_ns, rem);
+}
+
+// Nanosleep() is the VDSO implementation of nanosleep(2), which sleeps on
+// CLOCK_MONOTONIC.
+int Nanosleep(const struct timespec* req, struct timespec* rem) {
+  struct params* params = get_params();
+
+  // Leave invalid and long requests to the sandbox kernel.
+  uint64_t max_ns = spin_sleep_max_ns(params);
+  int64_t req_ns;
+  int64_t now_ns;
+  if (max_ns == 0 || !timespec_to_ns(req, &req_ns) ||
+      req_ns > static_cast<int64_t>(max_ns) ||
+      !clock_ns(params, &params->monotonic,
+                clock_offset(params, CLOCK_MONOTONIC), &now_ns)) {
+    return sys_nanosleep(req, rem);
+  }
+
+  return spin_sleep(params, &params->monotonic, CLOCK_MONOTONIC, now_ns,
+                    now_ns + req_ns, rem);
+}
+
+int SchedYield() {
+  struct params* params = get_params();
+  // The sandbox kernel samples contention periodically, so this is only a
+  // hint; yielding when no task is waiting to run has no effect anyway.
+  if (*static_cast<volatile uint64_t*>(&params->sched.contended) == 0) {
+    return 0;
+  }
+  return sys_sched_yield();
+}
+
+int GetNprocs() {
+  struct params* params = get_params();
+  uint64_t seq;
+  uint64_t cpus;
+
+  do {
+    seq = read_seqcount_begin(&params->info.seq_count);
+    cpus = params->info.cpus;
+  } while (seqcount_retry(&params->info.seq_count, seq));
+
+  if (cpus == 0) {
+    // The sandbox kernel has not published the system information yet.
+    return -ENOSYS;
+  }
+  return cpus;
+}
+
+#if __x86_64__
+
+// Linux stores the CPU number in the low 12 bits of IA32_TSC_AUX, and the NUMA
+// node in the remaining bits.
+const uint32_t kTSCAuxCPUMask = 0xfff;
+
+inline uint32_t tsc_aux() {
+  uint32_t lo, hi, aux;
+  asm volatile("rdtscp" : "=a"(lo), "=d"(hi), "=c"(aux));
+  return aux;
+}
+
+// GetCPU() is the VDSO implementation of getcpu(2).
+long GetCPU(unsigned* cpu, unsigned* node, struct getcpu_cache* cache) {
+  struct params* params = get_params();
+  uint64_t seq;
+  uint64_t mode;
+  uint64_t fixed_cpu;
+
+  do {
+    seq = read_seqcount_begin(&params->flags.seq_count);
+    mode = params->flags.getcpu_mode;
+    fixed_cpu = params->flags.getcpu_cpu;
+  } while (seqcount_retry(&params->flags.seq_count, seq));
+
+  unsigned now_cpu;
+  switch (mode) {
+    case kGetcpuFixed:
+      now_cpu = fixed_cpu;
+      break;
+
+    case kGetcpuTSCAux:
+      now_cpu = tsc_aux() & kTSCAuxCPUMask;
+      break;
+
+    default:
+      return sys_getcpu(cpu, node, cache);
+  }
+
+  if (cpu) {
+    *cpu = now_cpu;
+  }
+  // The sandbox kernel always reports node 0.
+  if (node) {
+    *node = 0;
+  }
+  return 0;
+}
+
+#endif  // __x86_64__
+
 }  // namespace vdso
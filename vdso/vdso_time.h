@@ -15,12 +15,42 @@
 #ifndef VDSO_VDSO_TIME_H_
 #define VDSO_VDSO_TIME_H_
 
+#include <stdint.h>
 #include <time.h>
 
 namespace vdso {
 
 int ClockRealtime(struct timespec* ts);
 int ClockMonotonic(struct timespec* ts);
+int ClockBoottime(struct timespec* ts);
+int ClockSnapshot(struct timespec* realtime, struct timespec* monotonic,
+                  uint64_t* cycles);
+int ClockThreadCPUTime(clockid_t clock, struct timespec* ts);
+int ClockNanosleep(clockid_t clock, int flags, const struct timespec* req,
+                   struct timespec* rem);
+int Nanosleep(const struct timespec* req, struct timespec* rem);
+int SchedYield();
+int GetNprocs();
+
+#if __x86_64__
+struct getcpu_cache;
+
+long GetCPU(unsigned* cpu, unsigned* node, struct getcpu_cache* cache);
+#endif
+
+#if defined(VDSO_TEST_BUILD)
+// SetParamsForTest sets the parameter page used by the functions above.
+void SetParamsForTest(const void* params);
+
+// SetThreadClocksForTest sets the thread clock page used by the functions
+// above.
+void SetThreadClocksForTest(const void* thread_clocks);
+
+// SeqcountRetriesForTest returns the number of times the calling thread has
+// retried a read of the parameter page because the sandbox kernel was
+// updating it.
+uint64_t SeqcountRetriesForTest();
+#endif  // VDSO_TEST_BUILD
 
 }  // namespace vdso
 